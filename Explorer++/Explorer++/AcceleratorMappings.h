@@ -63,6 +63,7 @@ const std::unordered_map<std::wstring, int> ACCELERATOR_MAPPINGS = {
 	{L"toggle_status_bar", IDM_VIEW_STATUSBAR},
 	{L"toggle_folders", IDM_VIEW_FOLDERS},
 	{L"toggle_display_window", IDM_VIEW_DISPLAYWINDOW},
+	{L"toggle_preview_pane", IDM_VIEW_PREVIEWPANE},
 	{L"toggle_address_bar", IDM_TOOLBARS_ADDRESSBAR},
 	{L"toggle_main_toolbar", IDM_TOOLBARS_MAINTOOLBAR},
 	{L"toggle_bookmarks_toolbar", IDM_TOOLBARS_BOOKMARKSTOOLBAR},
@@ -244,6 +245,7 @@ const std::unordered_map<std::wstring, int> ACCELERATOR_MAPPINGS = {
 
 	{L"bookmark_tab", IDM_BOOKMARKS_BOOKMARKTHISTAB},
 	{L"manage_bookmarks", IDM_BOOKMARKS_MANAGEBOOKMARKS},
+	{L"search_bookmarks", IDM_BOOKMARKS_SEARCH_BOOKMARKS},
 
 	{L"search", IDM_TOOLS_SEARCH},
 	{L"customize_colors", IDM_TOOLS_CUSTOMIZECOLORS},
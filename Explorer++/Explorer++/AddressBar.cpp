@@ -9,9 +9,12 @@
 #include "BrowserWindow.h"
 #include "CoreInterface.h"
 #include "NavigationHelper.h"
+#include "PathCompletionProvider.h"
+#include "PathCompletionSource.h"
 #include "RuntimeHelper.h"
 #include "ShellBrowser/ShellBrowserImpl.h"
 #include "ShellBrowser/ShellNavigationController.h"
+#include "ShellEnumeratorImpl.h"
 #include "Tab.h"
 #include "TabContainerImpl.h"
 #include "../Helper/Controls.h"
@@ -62,9 +65,7 @@ void AddressBar::Initialize(HWND parent)
 	m_windowSubclasses.push_back(
 		std::make_unique<WindowSubclass>(hEdit, std::bind_front(&AddressBar::EditSubclass, this)));
 
-	/* Turn on auto complete for the edit control within the combobox.
-	This will let the os complete paths as they are typed. */
-	SHAutoComplete(hEdit, SHACF_FILESYSTEM | SHACF_AUTOSUGGEST_FORCE_ON);
+	SetUpAutoComplete(hEdit);
 
 	m_windowSubclasses.push_back(std::make_unique<WindowSubclass>(parent,
 		std::bind_front(&AddressBar::ParentWndProc, this)));
@@ -84,6 +85,46 @@ void AddressBar::Initialize(HWND parent)
 	m_fontSetter.fontUpdatedSignal.AddObserver(std::bind(&AddressBar::OnFontOrDpiUpdated, this));
 }
 
+void AddressBar::SetUpAutoComplete(HWND edit)
+{
+	auto autoComplete = wil::CoCreateInstanceNoThrow<IAutoComplete2>(CLSID_AutoComplete);
+
+	if (!autoComplete)
+	{
+		// This will let the OS complete file system paths as they're typed, which is better than
+		// nothing.
+		SHAutoComplete(edit, SHACF_FILESYSTEM | SHACF_AUTOSUGGEST_FORCE_ON);
+		return;
+	}
+
+	// The autocomplete object may call into the source on a background thread, so any directory
+	// expansions are forwarded to the UI thread.
+	auto uiThreadScheduler = MakeUiThreadScheduler(m_app->GetRuntime());
+	auto source = winrt::make<PathCompletionSource>(m_app->GetPathCompletionProvider(),
+		[uiThreadScheduler, self = m_weakPtrFactory.GetWeakPtr()](const std::wstring &directory)
+		{
+			uiThreadScheduler(
+				[self, directory]()
+				{
+					if (self)
+					{
+						self->OnDirectoryExpanded(directory);
+					}
+				});
+		});
+
+	HRESULT hr = autoComplete->Init(edit, source.get(), nullptr, nullptr);
+
+	if (FAILED(hr))
+	{
+		SHAutoComplete(edit, SHACF_FILESYSTEM | SHACF_AUTOSUGGEST_FORCE_ON);
+		return;
+	}
+
+	autoComplete->SetOptions(ACO_AUTOSUGGEST | ACO_UPDOWNKEYDROPSLIST);
+	m_autoCompleteDropDown = autoComplete.try_query<IAutoCompleteDropDown>();
+}
+
 LRESULT AddressBar::ComboBoxSubclass(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam)
 {
 	switch (msg)
@@ -114,6 +155,7 @@ LRESULT AddressBar::EditSubclass(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lPar
 		break;
 
 	case WM_SETFOCUS:
+		m_app->GetPathCompletionProvider()->EnsureInitialized();
 		m_coreInterface->FocusChanged();
 		break;
 	}
@@ -356,3 +398,91 @@ void AddressBar::OnFontOrDpiUpdated()
 {
 	sizeUpdatedSignal.m_signal();
 }
+
+void AddressBar::OnDirectoryExpanded(const std::wstring &directory)
+{
+	if (!m_app->GetPathCompletionProvider()->ShouldEnumerateDirectory(directory))
+	{
+		return;
+	}
+
+	// Only the most recently entered directory is of interest, so any previous enumeration will be
+	// cancelled.
+	m_childFoldersStopSource = std::make_unique<ScopedStopSource>();
+
+	RetrieveChildFolders(m_weakPtrFactory.GetWeakPtr(), directory, m_hwnd, m_app->GetRuntime(),
+		m_childFoldersStopSource->GetToken());
+}
+
+concurrencpp::null_result AddressBar::RetrieveChildFolders(WeakPtr<AddressBar> self,
+	std::wstring directory, HWND embedder, Runtime *runtime, std::stop_token stopToken)
+{
+	co_await ResumeOnComStaThread(runtime);
+
+	PidlAbsolute pidlDirectory;
+	HRESULT hr = SHParseDisplayName(directory.c_str(), nullptr, PidlOutParam(pidlDirectory), 0,
+		nullptr);
+
+	if (FAILED(hr))
+	{
+		co_return;
+	}
+
+	ShellEnumeratorImpl shellEnumerator(embedder,
+		ShellEnumeratorImpl::HiddenItemsPolicy::ExcludeHidden);
+	std::vector<PidlChild> items;
+	hr = shellEnumerator.EnumerateDirectory(pidlDirectory.Raw(), items, stopToken);
+
+	if (FAILED(hr))
+	{
+		co_return;
+	}
+
+	std::vector<std::wstring> folders;
+
+	for (const auto &item : items)
+	{
+		if (stopToken.stop_requested())
+		{
+			co_return;
+		}
+
+		unique_pidl_absolute pidlItem(ILCombine(pidlDirectory.Raw(), item.Raw()));
+
+		SFGAOF attributes = SFGAO_FOLDER;
+		hr = GetItemAttributes(pidlItem.get(), &attributes);
+
+		if (FAILED(hr) || WI_IsFlagClear(attributes, SFGAO_FOLDER))
+		{
+			continue;
+		}
+
+		auto path = GetFolderPathForDisplay(pidlItem.get());
+
+		if (path)
+		{
+			folders.push_back(*path);
+		}
+	}
+
+	co_await ResumeOnUiThread(runtime);
+
+	if (stopToken.stop_requested() || !self)
+	{
+		co_return;
+	}
+
+	self->OnChildFoldersRetrieved(directory, folders);
+}
+
+void AddressBar::OnChildFoldersRetrieved(const std::wstring &directory,
+	const std::vector<std::wstring> &folders)
+{
+	m_app->GetPathCompletionProvider()->AddEnumeratedFolders(directory, folders);
+
+	// The autocomplete list will only be updated if the enumerator is explicitly reset.
+	if (m_autoCompleteDropDown)
+	{
+		m_autoCompleteDropDown->ResetEnumerator();
+	}
+}
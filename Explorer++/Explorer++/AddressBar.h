@@ -13,6 +13,7 @@
 #include "../Helper/WeakPtrFactory.h"
 #include "../Helper/WindowSubclass.h"
 #include <concurrencpp/concurrencpp.h>
+#include <wil/com.h>
 #include <memory>
 
 class App;
@@ -53,6 +54,7 @@ private:
 	LRESULT ParentWndProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam);
 
 	void Initialize(HWND parent);
+	void SetUpAutoComplete(HWND edit);
 	void OnEnterPressed();
 	void OnEscapePressed();
 	void OnBeginDrag();
@@ -67,6 +69,11 @@ private:
 	void UpdateTextAndIconInUI(std::wstring *text, int iconIndex);
 	void RevertTextInUI();
 	void OnFontOrDpiUpdated();
+	void OnDirectoryExpanded(const std::wstring &directory);
+	static concurrencpp::null_result RetrieveChildFolders(WeakPtr<AddressBar> self,
+		std::wstring directory, HWND embedder, Runtime *runtime, std::stop_token stopToken);
+	void OnChildFoldersRetrieved(const std::wstring &directory,
+		const std::vector<std::wstring> &folders);
 
 	App *const m_app;
 	BrowserWindow *const m_browserWindow;
@@ -81,5 +88,8 @@ private:
 
 	std::unique_ptr<ScopedStopSource> m_scopedStopSource;
 
+	wil::com_ptr_nothrow<IAutoCompleteDropDown> m_autoCompleteDropDown;
+	std::unique_ptr<ScopedStopSource> m_childFoldersStopSource;
+
 	WeakPtrFactory<AddressBar> m_weakPtrFactory;
 };
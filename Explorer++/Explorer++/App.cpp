@@ -37,7 +37,8 @@ App::App(const CommandLine::Settings *commandLineSettings) :
 	m_commandLineSettings(commandLineSettings),
 	m_runtime(std::make_unique<UIThreadExecutor>(),
 		std::make_unique<ComStaThreadPoolExecutor>(std::max(
-			static_cast<int>(std::thread::hardware_concurrency()), MIN_COM_STA_THREADPOOL_SIZE))),
+			static_cast<int>(std::thread::hardware_concurrency()), MIN_COM_STA_THREADPOOL_SIZE)),
+		std::make_unique<ComStaThreadPoolExecutor>(BACKGROUND_JOB_THREADPOOL_SIZE)),
 	m_featureList(commandLineSettings->featuresToEnable),
 	m_acceleratorManager(InitializeAcceleratorManager()),
 	m_cachedIcons(std::make_shared<CachedIcons>(MAX_CACHED_ICONS)),
@@ -51,6 +52,11 @@ App::App(const CommandLine::Settings *commandLineSettings) :
 	m_historyTracker(&m_historyModel, &m_navigationEvents),
 	m_frequentLocationsModel(&m_systemClock),
 	m_frequentLocationsTracker(&m_frequentLocationsModel, &m_navigationEvents),
+	m_pathCompletionProvider(&m_historyModel, &m_frequentLocationsModel, &m_bookmarkTree,
+		&m_systemClock),
+	m_pluginColumnRegistry(std::max(static_cast<int>(std::thread::hardware_concurrency()), 1)),
+	m_fileHashService(std::max(static_cast<int>(std::thread::hardware_concurrency()), 1)),
+	m_folderSnapshotCache(0),
 	m_uniqueGdiplusShutdown(CheckedGdiplusStartup()),
 	m_richEditLib(LoadSystemLibrary(
 		L"Msftedit.dll")), // This is needed for version 5 of the Rich Edit control.
@@ -120,6 +126,10 @@ void App::SetUpSession()
 	std::vector<WindowStorageData> windows;
 	LoadSettings(windows);
 
+	m_historyModel.SetMaxItems(m_config.maxGlobalHistoryItems);
+	m_folderSnapshotCache.SetMaxSizeInBytes(
+		static_cast<size_t>(m_config.folderSnapshotCacheSizeMB) * 1024 * 1024);
+
 	// This function may attempt to notify an existing process if the allowMultipleInstances config
 	// value is disabled. Therefore, this call needs to be made after the settings have been loaded.
 	// If the allowMultipleInstances setting is removed, this call can be made earlier.
@@ -133,6 +143,11 @@ void App::SetUpSession()
 		std::make_unique<IconResourceLoader>(m_config.iconSet, &m_darkModeManager);
 	SetUpLanguageResourceInstance();
 
+	if (m_config.indexFileNames)
+	{
+		m_fileNameIndexService.Start();
+	}
+
 	RestoreSession(windows);
 }
 
@@ -166,6 +181,7 @@ void App::LoadSettings(std::vector<WindowStorageData> &windows)
 	appStorage->LoadDialogStates();
 	appStorage->LoadDefaultColumns(m_config.globalFolderSettings.folderColumns);
 	appStorage->LoadFrequentLocations(&m_frequentLocationsModel);
+	appStorage->LoadPluginColumnSlots(&m_pluginColumnRegistry);
 
 	ValidateColumns(m_config.globalFolderSettings.folderColumns);
 }
@@ -212,6 +228,7 @@ void App::SaveSettings()
 	appStorage->SaveDialogStates();
 	appStorage->SaveDefaultColumns(m_config.globalFolderSettings.folderColumns);
 	appStorage->SaveFrequentLocations(&m_frequentLocationsModel);
+	appStorage->SavePluginColumnSlots(&m_pluginColumnRegistry);
 
 	appStorage->Commit();
 }
@@ -461,6 +478,41 @@ FrequentLocationsModel *App::GetFrequentLocationsModel()
 	return &m_frequentLocationsModel;
 }
 
+PathCompletionProvider *App::GetPathCompletionProvider()
+{
+	return &m_pathCompletionProvider;
+}
+
+Plugins::PluginColumnRegistry *App::GetPluginColumnRegistry()
+{
+	return &m_pluginColumnRegistry;
+}
+
+FileHashService *App::GetFileHashService()
+{
+	return &m_fileHashService;
+}
+
+FileNameIndexService *App::GetFileNameIndexService()
+{
+	return &m_fileNameIndexService;
+}
+
+FolderSnapshotCache *App::GetFolderSnapshotCache()
+{
+	return &m_folderSnapshotCache;
+}
+
+FolderPrefetchStats *App::GetFolderPrefetchStats()
+{
+	return &m_folderPrefetchStats;
+}
+
+SystemClock *App::GetSystemClock()
+{
+	return &m_systemClock;
+}
+
 void App::OnWillRemoveBrowser()
 {
 	if (m_browserList.GetSize() == 1 && !m_exitStarted)
@@ -548,6 +600,13 @@ void App::OnExitStarted()
 	m_saveSettingsTimer.cancel();
 	SaveSettings();
 
+	LOG(INFO) << "Folder prefetching: " << m_folderPrefetchStats.numStarted << " started, "
+			  << m_folderPrefetchStats.numHits << " hits, " << m_folderPrefetchStats.numPartialHits
+			  << " partial hits, " << m_folderPrefetchStats.numMisses << " misses (hit rate "
+			  << m_folderPrefetchStats.GetHitRate() << "), "
+			  << m_folderPrefetchStats.numCancelled << " cancelled, "
+			  << m_folderPrefetchStats.numDiscarded << " discarded";
+
 	m_exitStarted = true;
 }
 
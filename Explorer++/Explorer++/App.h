@@ -12,13 +12,19 @@
 #include "Config.h"
 #include "DarkModeManager.h"
 #include "FeatureList.h"
+#include "FileHashService.h"
+#include "FileNameIndexService.h"
 #include "FrequentLocationsModel.h"
 #include "FrequentLocationsTracker.h"
 #include "HistoryModel.h"
 #include "HistoryTracker.h"
 #include "ModelessDialogList.h"
+#include "PathCompletionProvider.h"
+#include "Plugins/PluginColumnRegistry.h"
 #include "ProcessManager.h"
 #include "Runtime.h"
+#include "ShellBrowser/FolderPrefetcher.h"
+#include "ShellBrowser/FolderSnapshotCache.h"
 #include "ShellBrowser/NavigationEvents.h"
 #include "ShellBrowser/ShellBrowserEvents.h"
 #include "TabEvents.h"
@@ -75,6 +81,13 @@ public:
 	ThemeManager *GetThemeManager();
 	HistoryModel *GetHistoryModel();
 	FrequentLocationsModel *GetFrequentLocationsModel();
+	PathCompletionProvider *GetPathCompletionProvider();
+	Plugins::PluginColumnRegistry *GetPluginColumnRegistry();
+	FileHashService *GetFileHashService();
+	FileNameIndexService *GetFileNameIndexService();
+	FolderSnapshotCache *GetFolderSnapshotCache();
+	FolderPrefetchStats *GetFolderPrefetchStats();
+	SystemClock *GetSystemClock();
 
 	void TryExit();
 	void SessionEnding();
@@ -86,6 +99,10 @@ private:
 
 	static constexpr int MIN_COM_STA_THREADPOOL_SIZE = 5;
 
+	// Long-running jobs (e.g. comparing folders, or finding duplicate files) are run on a separate
+	// pool, so that they can't hold up short tasks, like navigations, that run on the COM STA pool.
+	static constexpr int BACKGROUND_JOB_THREADPOOL_SIZE = 2;
+
 	void OnBrowserRemoved();
 	void SetUpSession();
 	void LoadSettings(std::vector<WindowStorageData> &windows);
@@ -133,6 +150,21 @@ private:
 	FrequentLocationsModel m_frequentLocationsModel;
 	FrequentLocationsTracker m_frequentLocationsTracker;
 
+	PathCompletionProvider m_pathCompletionProvider;
+
+	Plugins::PluginColumnRegistry m_pluginColumnRegistry;
+
+	FileHashService m_fileHashService;
+
+	// This is only started if indexing is enabled in the config.
+	FileNameIndexService m_fileNameIndexService;
+
+	// The size of this cache is set once the config has been loaded.
+	FolderSnapshotCache m_folderSnapshotCache;
+
+	// Each tab prefetches folders independently, but the counters are aggregated here.
+	FolderPrefetchStats m_folderPrefetchStats;
+
 	concurrencpp::timer m_saveSettingsTimer;
 
 	unique_gdiplus_shutdown m_uniqueGdiplusShutdown;
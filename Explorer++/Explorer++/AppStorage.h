@@ -13,6 +13,13 @@ class ApplicationModel;
 
 }
 
+namespace Plugins
+{
+
+class PluginColumnRegistry;
+
+}
+
 class BookmarkTree;
 class ColorRuleModel;
 struct Config;
@@ -33,6 +40,7 @@ public:
 	virtual void LoadDialogStates() = 0;
 	virtual void LoadDefaultColumns(FolderColumns &defaultColumns) = 0;
 	virtual void LoadFrequentLocations(FrequentLocationsModel *frequentLocationsModel) = 0;
+	virtual void LoadPluginColumnSlots(Plugins::PluginColumnRegistry *pluginColumnRegistry) = 0;
 
 	virtual void SaveConfig(const Config &config) = 0;
 	virtual void SaveWindows(const std::vector<WindowStorageData> &windows) = 0;
@@ -42,5 +50,7 @@ public:
 	virtual void SaveDialogStates() = 0;
 	virtual void SaveDefaultColumns(const FolderColumns &defaultColumns) = 0;
 	virtual void SaveFrequentLocations(const FrequentLocationsModel *frequentLocationsModel) = 0;
+	virtual void SavePluginColumnSlots(
+		const Plugins::PluginColumnRegistry *pluginColumnRegistry) = 0;
 	virtual void Commit() = 0;
 };
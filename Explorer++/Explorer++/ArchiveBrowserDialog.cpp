@@ -0,0 +1,821 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "stdafx.h"
+#include "ArchiveBrowserDialog.h"
+#include "App.h"
+#include "Config.h"
+#include "MainResource.h"
+#include "ResourceLoader.h"
+#include "RuntimeHelper.h"
+#include "../Helper/FileOperations.h"
+#include "../Helper/Helper.h"
+#include "../Helper/ShellHelper.h"
+#include "../Helper/StringHelper.h"
+#include "../Helper/WindowHelper.h"
+#include <fmt/format.h>
+#include <fmt/xchar.h>
+#include <glog/logging.h>
+#include <wil/resource.h>
+#include <algorithm>
+#include <filesystem>
+#include <thread>
+
+namespace
+{
+
+// The number of 100-nanosecond intervals between 1601-01-01 (the FILETIME epoch) and 1970-01-01.
+constexpr int64_t FILETIME_UNIX_EPOCH_DIFFERENCE = 116444736000000000;
+
+std::optional<FILETIME> ConvertToFileTime(std::chrono::sys_seconds time)
+{
+	int64_t ticks = (time.time_since_epoch().count() * 10'000'000) + FILETIME_UNIX_EPOCH_DIFFERENCE;
+
+	if (ticks < 0)
+	{
+		return std::nullopt;
+	}
+
+	FILETIME fileTime;
+	fileTime.dwLowDateTime = static_cast<DWORD>(ticks);
+	fileTime.dwHighDateTime = static_cast<DWORD>(static_cast<uint64_t>(ticks) >> 32);
+	return fileTime;
+}
+
+}
+
+ArchiveBrowserDialog *ArchiveBrowserDialog::Create(App *app, HWND parent,
+	const std::wstring &archivePath)
+{
+	return new ArchiveBrowserDialog(app, parent, archivePath);
+}
+
+ArchiveBrowserDialog::ArchiveBrowserDialog(App *app, HWND parent, const std::wstring &archivePath) :
+	ThemedDialog(app->GetResourceInstance(), IDD_ARCHIVE_BROWSER, parent,
+		BaseDialog::DialogSizingType::Both, app->GetThemeManager()),
+	m_app(app),
+	m_archivePath(archivePath),
+	m_persistentSettings(&ArchiveBrowserDialogPersistentSettings::GetInstance()),
+	m_weakPtrFactory(this)
+{
+}
+
+INT_PTR ArchiveBrowserDialog::OnInitDialog()
+{
+	std::wstring title = fmt::format(L"{} - {}",
+		std::filesystem::path(m_archivePath).filename().wstring(), GetWindowString(m_hDlg));
+	SetWindowText(m_hDlg, title.c_str());
+	SetDlgItemText(m_hDlg, IDC_ARCHIVE_BROWSER_PATH, m_archivePath.c_str());
+
+	HIMAGELIST smallImageList;
+	Shell_GetImageLists(nullptr, &smallImageList);
+	TreeView_SetImageList(GetDlgItem(m_hDlg, IDC_ARCHIVE_BROWSER_TREE), smallImageList,
+		TVSIL_NORMAL);
+
+	SetupListView();
+	UpdateControlStates();
+	SetStatusText(m_app->GetResourceLoader()->LoadString(IDS_ARCHIVE_BROWSER_OPENING));
+
+	m_persistentSettings->RestoreDialogPosition(m_hDlg, true);
+
+	OpenArchiveAsync(m_weakPtrFactory.GetWeakPtr(), m_archivePath, m_app->GetRuntime(),
+		m_stopSource.GetToken());
+
+	return TRUE;
+}
+
+wil::unique_hicon ArchiveBrowserDialog::GetDialogIcon(int iconWidth, int iconHeight) const
+{
+	UNREFERENCED_PARAMETER(iconWidth);
+	UNREFERENCED_PARAMETER(iconHeight);
+
+	return wil::unique_hicon(LoadIcon(GetModuleHandle(nullptr), MAKEINTRESOURCE(IDI_MAIN)));
+}
+
+std::vector<ResizableDialogControl> ArchiveBrowserDialog::GetResizableControls()
+{
+	std::vector<ResizableDialogControl> controls;
+	controls.emplace_back(GetDlgItem(m_hDlg, IDC_ARCHIVE_BROWSER_PATH), MovingType::None,
+		SizingType::Horizontal);
+	controls.emplace_back(GetDlgItem(m_hDlg, IDC_ARCHIVE_BROWSER_TREE), MovingType::None,
+		SizingType::Vertical);
+	controls.emplace_back(GetDlgItem(m_hDlg, IDC_ARCHIVE_BROWSER_LIST), MovingType::None,
+		SizingType::Both);
+	controls.emplace_back(GetDlgItem(m_hDlg, IDC_ARCHIVE_BROWSER_STATUS), MovingType::Vertical,
+		SizingType::Horizontal);
+	controls.emplace_back(GetDlgItem(m_hDlg, IDC_ARCHIVE_BROWSER_EXTRACT), MovingType::Both,
+		SizingType::None);
+	controls.emplace_back(GetDlgItem(m_hDlg, IDCANCEL), MovingType::Both, SizingType::None);
+	return controls;
+}
+
+void ArchiveBrowserDialog::SetupListView()
+{
+	HWND listView = GetDlgItem(m_hDlg, IDC_ARCHIVE_BROWSER_LIST);
+	ListView_SetExtendedListViewStyle(listView,
+		LVS_EX_LABELTIP | LVS_EX_FULLROWSELECT | LVS_EX_DOUBLEBUFFER);
+
+	HIMAGELIST smallImageList;
+	Shell_GetImageLists(nullptr, &smallImageList);
+	ListView_SetImageList(listView, smallImageList, LVSIL_SMALL);
+
+	int index = 0;
+
+	for (auto column : COLUMNS)
+	{
+		InsertColumn(column, index);
+		index++;
+	}
+}
+
+void ArchiveBrowserDialog::InsertColumn(const Column &column, int index)
+{
+	std::wstring columnText = GetColumnText(column.type);
+
+	RECT listViewRect;
+	HWND listView = GetDlgItem(m_hDlg, IDC_ARCHIVE_BROWSER_LIST);
+	[[maybe_unused]] auto res = GetClientRect(listView, &listViewRect);
+	assert(res);
+
+	LVCOLUMN lvColumn = {};
+	lvColumn.mask = LVCF_TEXT | LVCF_WIDTH | LVCF_FMT;
+	lvColumn.fmt = (column.type == ColumnType::Size || column.type == ColumnType::PackedSize)
+		? LVCFMT_RIGHT
+		: LVCFMT_LEFT;
+	lvColumn.pszText = columnText.data();
+	lvColumn.cx = static_cast<int>(column.percentageWidth * GetRectWidth(&listViewRect));
+	[[maybe_unused]] int insertedIndex = ListView_InsertColumn(listView, index, &lvColumn);
+	assert(insertedIndex == index);
+}
+
+std::wstring ArchiveBrowserDialog::GetColumnText(ColumnType columnType)
+{
+	UINT stringId;
+
+	switch (columnType)
+	{
+	case ArchiveBrowserDialog::ColumnType::Name:
+		stringId = IDS_ARCHIVE_BROWSER_COLUMN_NAME;
+		break;
+
+	case ArchiveBrowserDialog::ColumnType::Size:
+		stringId = IDS_ARCHIVE_BROWSER_COLUMN_SIZE;
+		break;
+
+	case ArchiveBrowserDialog::ColumnType::PackedSize:
+		stringId = IDS_ARCHIVE_BROWSER_COLUMN_PACKED_SIZE;
+		break;
+
+	case ArchiveBrowserDialog::ColumnType::Modified:
+		stringId = IDS_ARCHIVE_BROWSER_COLUMN_MODIFIED;
+		break;
+
+	default:
+		LOG(FATAL) << "Archive browser column type not found";
+		__assume(0);
+	}
+
+	return m_app->GetResourceLoader()->LoadString(stringId);
+}
+
+concurrencpp::null_result ArchiveBrowserDialog::OpenArchiveAsync(
+	WeakPtr<ArchiveBrowserDialog> self, std::wstring archivePath, Runtime *runtime,
+	std::stop_token stopToken)
+{
+	co_await ResumeOnComStaThread(runtime);
+
+	std::shared_ptr<const ZipArchive> archive;
+
+	if (auto source = ZipFileSource::Open(archivePath))
+	{
+		archive = ZipArchive::Open(std::move(source));
+	}
+
+	co_await ResumeOnUiThread(runtime);
+
+	if (stopToken.stop_requested() || !self)
+	{
+		co_return;
+	}
+
+	self->OnArchiveOpened(std::move(archive));
+}
+
+void ArchiveBrowserDialog::OnArchiveOpened(std::shared_ptr<const ZipArchive> archive)
+{
+	if (!archive)
+	{
+		SetStatusText(m_app->GetResourceLoader()->LoadString(IDS_ARCHIVE_BROWSER_OPEN_FAILED));
+		return;
+	}
+
+	m_archive = std::move(archive);
+
+	HWND treeView = GetDlgItem(m_hDlg, IDC_ARCHIVE_BROWSER_TREE);
+	HTREEITEM rootItem = InsertTreeItem(TVI_ROOT, ZipArchive::ROOT_ID);
+	TreeView_Expand(treeView, rootItem, TVE_EXPAND);
+
+	// This will result in the root folder being shown in the listview.
+	TreeView_SelectItem(treeView, rootItem);
+
+	UpdateControlStates();
+}
+
+HTREEITEM ArchiveBrowserDialog::InsertTreeItem(HTREEITEM parent, ZipArchive::EntryId folder)
+{
+	std::wstring text;
+	int iconIndex;
+
+	if (folder == ZipArchive::ROOT_ID)
+	{
+		text = std::filesystem::path(m_archivePath).filename().wstring();
+
+		SHFILEINFO shfi;
+		DWORD_PTR res = SHGetFileInfo(m_archivePath.c_str(), 0, &shfi, sizeof(shfi),
+			SHGFI_SYSICONINDEX);
+		iconIndex = res ? shfi.iIcon : 0;
+	}
+	else
+	{
+		const auto &entry = m_archive->GetEntry(folder);
+		text = entry.name;
+		iconIndex = GetEntryIconIndex(entry);
+	}
+
+	TVINSERTSTRUCT insertInfo = {};
+	insertInfo.hParent = parent;
+	insertInfo.hInsertAfter = TVI_LAST;
+	insertInfo.item.mask = TVIF_TEXT | TVIF_PARAM | TVIF_CHILDREN | TVIF_IMAGE | TVIF_SELECTEDIMAGE;
+	insertInfo.item.pszText = text.data();
+	insertInfo.item.lParam = folder;
+	insertInfo.item.iImage = iconIndex;
+	insertInfo.item.iSelectedImage = iconIndex;
+
+	// The children of each folder are only added when the folder is expanded.
+	insertInfo.item.cChildren = HasSubfolders(folder) ? 1 : 0;
+
+	return TreeView_InsertItem(GetDlgItem(m_hDlg, IDC_ARCHIVE_BROWSER_TREE), &insertInfo);
+}
+
+bool ArchiveBrowserDialog::HasSubfolders(ZipArchive::EntryId folder) const
+{
+	return std::ranges::any_of(m_archive->GetChildren(folder),
+		[this](auto child) { return m_archive->GetEntry(child).isFolder; });
+}
+
+void ArchiveBrowserDialog::OnTreeItemExpanding(const NMTREEVIEW *treeView)
+{
+	if (treeView->action != TVE_EXPAND
+		|| TreeView_GetChild(treeView->hdr.hwndFrom, treeView->itemNew.hItem))
+	{
+		return;
+	}
+
+	auto folder = static_cast<ZipArchive::EntryId>(treeView->itemNew.lParam);
+
+	// The children are sorted by name, so they can be inserted in order.
+	for (auto child : m_archive->GetChildren(folder))
+	{
+		if (m_archive->GetEntry(child).isFolder)
+		{
+			InsertTreeItem(treeView->itemNew.hItem, child);
+		}
+	}
+}
+
+void ArchiveBrowserDialog::OnTreeSelectionChanged(const NMTREEVIEW *treeView)
+{
+	if (!m_archive || !treeView->itemNew.hItem)
+	{
+		return;
+	}
+
+	ShowFolder(static_cast<ZipArchive::EntryId>(treeView->itemNew.lParam));
+}
+
+void ArchiveBrowserDialog::SelectFolderInTree(ZipArchive::EntryId folder)
+{
+	std::vector<ZipArchive::EntryId> ancestors;
+
+	for (auto current = folder; current != ZipArchive::ROOT_ID;
+		current = m_archive->GetEntry(current).parent)
+	{
+		ancestors.push_back(current);
+	}
+
+	HWND treeView = GetDlgItem(m_hDlg, IDC_ARCHIVE_BROWSER_TREE);
+	HTREEITEM item = TreeView_GetRoot(treeView);
+
+	// Each folder is expanded in turn, which ensures its children have been added to the tree.
+	for (auto itr = ancestors.rbegin(); itr != ancestors.rend() && item; ++itr)
+	{
+		TreeView_Expand(treeView, item, TVE_EXPAND);
+
+		HTREEITEM child = TreeView_GetChild(treeView, item);
+
+		for (; child; child = TreeView_GetNextSibling(treeView, child))
+		{
+			TVITEM tvItem = {};
+			tvItem.mask = TVIF_PARAM;
+			tvItem.hItem = child;
+			TreeView_GetItem(treeView, &tvItem);
+
+			if (static_cast<ZipArchive::EntryId>(tvItem.lParam) == *itr)
+			{
+				break;
+			}
+		}
+
+		item = child;
+	}
+
+	if (item)
+	{
+		TreeView_SelectItem(treeView, item);
+		TreeView_EnsureVisible(treeView, item);
+	}
+}
+
+void ArchiveBrowserDialog::ShowFolder(ZipArchive::EntryId folder)
+{
+	m_currentFolder = folder;
+
+	auto children = m_archive->GetChildren(folder);
+	m_visibleEntries.assign(children.begin(), children.end());
+	std::stable_partition(m_visibleEntries.begin(), m_visibleEntries.end(),
+		[this](auto id) { return m_archive->GetEntry(id).isFolder; });
+
+	// The listview is virtual, so only the number of items needs to be set. The text for each item
+	// is retrieved as it's displayed.
+	HWND listView = GetDlgItem(m_hDlg, IDC_ARCHIVE_BROWSER_LIST);
+	ListView_SetItemState(listView, -1, 0, LVIS_SELECTED | LVIS_FOCUSED);
+	ListView_SetItemCountEx(listView, static_cast<int>(m_visibleEntries.size()), 0);
+	InvalidateRect(listView, nullptr, true);
+
+	std::wstring path = m_archivePath;
+
+	if (folder != ZipArchive::ROOT_ID)
+	{
+		std::wstring entryPath = m_archive->GetEntryPath(folder);
+		std::replace(entryPath.begin(), entryPath.end(), '/', '\\');
+		path += L"\\" + entryPath;
+	}
+
+	SetDlgItemText(m_hDlg, IDC_ARCHIVE_BROWSER_PATH, path.c_str());
+
+	if (!m_extracting)
+	{
+		ShowFolderSummary();
+	}
+}
+
+void ArchiveBrowserDialog::OnListViewItemActivated(int index)
+{
+	if (index < 0 || index >= std::ssize(m_visibleEntries))
+	{
+		return;
+	}
+
+	auto id = m_visibleEntries[index];
+
+	if (m_archive->GetEntry(id).isFolder)
+	{
+		SelectFolderInTree(id);
+	}
+	else
+	{
+		OpenEntry(id);
+	}
+}
+
+void ArchiveBrowserDialog::OnListViewKeyDown(const NMLVKEYDOWN *keyDown)
+{
+	if (keyDown->wVKey == VK_BACK && m_archive && m_currentFolder != ZipArchive::ROOT_ID)
+	{
+		SelectFolderInTree(m_archive->GetEntry(m_currentFolder).parent);
+	}
+}
+
+std::vector<ZipArchive::EntryId> ArchiveBrowserDialog::GetSelectedEntries() const
+{
+	HWND listView = GetDlgItem(m_hDlg, IDC_ARCHIVE_BROWSER_LIST);
+	std::vector<ZipArchive::EntryId> selectedEntries;
+	int index = -1;
+
+	while ((index = ListView_GetNextItem(listView, index, LVNI_SELECTED)) != -1)
+	{
+		if (index < std::ssize(m_visibleEntries))
+		{
+			selectedEntries.push_back(m_visibleEntries[index]);
+		}
+	}
+
+	return selectedEntries;
+}
+
+void ArchiveBrowserDialog::OnExtract()
+{
+	if (!m_archive || m_extracting)
+	{
+		return;
+	}
+
+	// If nothing is selected, the entire contents of the current folder are extracted.
+	auto ids = GetSelectedEntries();
+
+	if (ids.empty())
+	{
+		ids = m_visibleEntries;
+	}
+
+	auto title = m_app->GetResourceLoader()->LoadString(IDS_ARCHIVE_BROWSER_SELECT_DESTINATION);
+
+	unique_pidl_absolute pidl;
+	BOOL res = FileOperations::CreateBrowseDialog(m_hDlg, title, wil::out_param(pidl));
+
+	if (!res)
+	{
+		return;
+	}
+
+	std::wstring destination;
+	HRESULT hr = GetDisplayName(pidl.get(), SHGDN_FORPARSING, destination);
+
+	if (FAILED(hr))
+	{
+		return;
+	}
+
+	StartExtraction(std::move(ids), destination, std::nullopt);
+}
+
+void ArchiveBrowserDialog::OpenEntry(ZipArchive::EntryId id)
+{
+	if (m_extracting)
+	{
+		return;
+	}
+
+	auto temporaryFolder = CreateTemporaryFolder();
+
+	if (!temporaryFolder)
+	{
+		MessageBox(m_hDlg,
+			m_app->GetResourceLoader()->LoadString(IDS_ARCHIVE_BROWSER_OPEN_ENTRY_FAILED).c_str(),
+			App::APP_NAME, MB_ICONWARNING | MB_OK);
+		return;
+	}
+
+	auto filePath = std::filesystem::path(*temporaryFolder) / m_archive->GetEntry(id).name;
+	StartExtraction({ id }, *temporaryFolder, filePath.wstring());
+}
+
+void ArchiveBrowserDialog::StartExtraction(std::vector<ZipArchive::EntryId> ids,
+	const std::wstring &destination, std::optional<std::wstring> fileToOpen)
+{
+	m_extracting = true;
+	m_numFilesExtracted = std::make_shared<std::atomic<size_t>>(0);
+
+	SetStatusText(fmt::format(
+		fmt::runtime(m_app->GetResourceLoader()->LoadString(IDS_ARCHIVE_BROWSER_EXTRACTING)),
+		fmt::arg(L"num_files", 0)));
+	SetTimer(m_hDlg, PROGRESS_TIMER_ID, PROGRESS_TIMER_ELAPSED, nullptr);
+	UpdateControlStates();
+
+	ExtractAsync(m_weakPtrFactory.GetWeakPtr(), m_archive, std::move(ids), destination,
+		std::move(fileToOpen), m_numFilesExtracted, m_app->GetRuntime(), m_stopSource.GetToken());
+}
+
+concurrencpp::null_result ArchiveBrowserDialog::ExtractAsync(WeakPtr<ArchiveBrowserDialog> self,
+	std::shared_ptr<const ZipArchive> archive, std::vector<ZipArchive::EntryId> ids,
+	std::wstring destination, std::optional<std::wstring> fileToOpen,
+	std::shared_ptr<std::atomic<size_t>> numFilesExtracted, Runtime *runtime,
+	std::stop_token stopToken)
+{
+	// Extracting a large archive can take a long time, so this runs alongside the other
+	// long-running jobs, rather than tying up one of the threads used for short tasks.
+	co_await ResumeOnBackgroundJobThread(runtime);
+
+	// Each thread reads from the archive using its own stream, so the files are extracted in
+	// parallel.
+	auto summary = ExtractZipEntries(*archive, ids, destination,
+		std::max(static_cast<int>(std::thread::hardware_concurrency()), 1), stopToken,
+		[&numFilesExtracted](const std::filesystem::path &path, const ZipEntry &entry)
+		{
+			SetExtractedFileTime(path, entry);
+			(*numFilesExtracted)++;
+		});
+
+	co_await ResumeOnUiThread(runtime);
+
+	if (stopToken.stop_requested() || !self)
+	{
+		co_return;
+	}
+
+	self->OnExtractionFinished(summary, fileToOpen);
+}
+
+void ArchiveBrowserDialog::SetExtractedFileTime(const std::filesystem::path &path,
+	const ZipEntry &entry)
+{
+	auto fileTime = ConvertToFileTime(GetZipEntryModifiedTime(entry));
+
+	if (!fileTime)
+	{
+		return;
+	}
+
+	wil::unique_hfile file(CreateFile(path.c_str(), FILE_WRITE_ATTRIBUTES,
+		FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING,
+		FILE_ATTRIBUTE_NORMAL, nullptr));
+
+	if (!file)
+	{
+		return;
+	}
+
+	SetFileTime(file.get(), nullptr, nullptr, &*fileTime);
+}
+
+void ArchiveBrowserDialog::OnExtractionFinished(const ZipExtractionSummary &summary,
+	const std::optional<std::wstring> &fileToOpen)
+{
+	m_extracting = false;
+	KillTimer(m_hDlg, PROGRESS_TIMER_ID);
+	UpdateControlStates();
+
+	if (fileToOpen)
+	{
+		ShowFolderSummary();
+
+		if (summary.numFilesExtracted == 1)
+		{
+			ShellExecute(m_hDlg, nullptr, fileToOpen->c_str(), nullptr, nullptr, SW_SHOWNORMAL);
+			return;
+		}
+
+		UINT stringId = IDS_ARCHIVE_BROWSER_OPEN_ENTRY_FAILED;
+
+		if (!summary.failures.empty())
+		{
+			switch (summary.failures[0].second)
+			{
+			case ZipExtractResult::Encrypted:
+				stringId = IDS_ARCHIVE_BROWSER_ENTRY_ENCRYPTED;
+				break;
+
+			case ZipExtractResult::UnsupportedMethod:
+				stringId = IDS_ARCHIVE_BROWSER_ENTRY_UNSUPPORTED;
+				break;
+
+			case ZipExtractResult::CorruptData:
+				stringId = IDS_ARCHIVE_BROWSER_ENTRY_CORRUPT;
+				break;
+			}
+		}
+
+		MessageBox(m_hDlg, m_app->GetResourceLoader()->LoadString(stringId).c_str(),
+			App::APP_NAME, MB_ICONWARNING | MB_OK);
+		return;
+	}
+
+	UINT stringId = summary.failures.empty() ? IDS_ARCHIVE_BROWSER_EXTRACTED
+											 : IDS_ARCHIVE_BROWSER_EXTRACTED_WITH_FAILURES;
+	SetStatusText(fmt::format(fmt::runtime(m_app->GetResourceLoader()->LoadString(stringId)),
+		fmt::arg(L"num_files", summary.numFilesExtracted),
+		fmt::arg(L"size", FormatSizeString(summary.numBytesExtracted)),
+		fmt::arg(L"num_failures", summary.failures.size())));
+}
+
+std::optional<std::wstring> ArchiveBrowserDialog::CreateTemporaryFolder()
+{
+	WCHAR tempPath[MAX_PATH + 1];
+	DWORD res = GetTempPath(static_cast<DWORD>(std::size(tempPath)), tempPath);
+
+	if (res == 0 || res > std::size(tempPath))
+	{
+		return std::nullopt;
+	}
+
+	// Each file that's opened is given its own folder, so that files with the same name (from
+	// different folders in the archive, or from different archives) don't conflict.
+	auto folder = std::filesystem::path(tempPath) / App::APP_NAME / L"Archives"
+		/ fmt::format(L"{}-{}", GetCurrentProcessId(),
+			std::chrono::steady_clock::now().time_since_epoch().count());
+
+	std::error_code error;
+	std::filesystem::create_directories(folder, error);
+
+	if (error)
+	{
+		return std::nullopt;
+	}
+
+	return folder.wstring();
+}
+
+void ArchiveBrowserDialog::SetStatusText(const std::wstring &text)
+{
+	SetDlgItemText(m_hDlg, IDC_ARCHIVE_BROWSER_STATUS, text.c_str());
+}
+
+void ArchiveBrowserDialog::ShowFolderSummary()
+{
+	auto numFolders = std::ranges::count_if(m_visibleEntries,
+		[this](auto id) { return m_archive->GetEntry(id).isFolder; });
+
+	SetStatusText(fmt::format(
+		fmt::runtime(m_app->GetResourceLoader()->LoadString(IDS_ARCHIVE_BROWSER_FOLDER_SUMMARY)),
+		fmt::arg(L"num_folders", numFolders),
+		fmt::arg(L"num_files", std::ssize(m_visibleEntries) - numFolders)));
+}
+
+void ArchiveBrowserDialog::UpdateControlStates()
+{
+	EnableWindow(GetDlgItem(m_hDlg, IDC_ARCHIVE_BROWSER_EXTRACT), m_archive && !m_extracting);
+}
+
+INT_PTR ArchiveBrowserDialog::OnCommand(WPARAM wParam, LPARAM lParam)
+{
+	UNREFERENCED_PARAMETER(lParam);
+
+	if (HIWORD(wParam) == 0 || HIWORD(wParam) == 1)
+	{
+		switch (LOWORD(wParam))
+		{
+		case IDC_ARCHIVE_BROWSER_EXTRACT:
+			OnExtract();
+			break;
+
+		case IDCANCEL:
+			DestroyWindow(m_hDlg);
+			break;
+		}
+	}
+
+	return 0;
+}
+
+INT_PTR ArchiveBrowserDialog::OnNotify(NMHDR *nmhdr)
+{
+	if (nmhdr->idFrom == IDC_ARCHIVE_BROWSER_LIST)
+	{
+		switch (nmhdr->code)
+		{
+		case LVN_GETDISPINFO:
+			OnGetDispInfo(reinterpret_cast<NMLVDISPINFO *>(nmhdr));
+			break;
+
+		case LVN_ITEMACTIVATE:
+			OnListViewItemActivated(reinterpret_cast<NMITEMACTIVATE *>(nmhdr)->iItem);
+			break;
+
+		case LVN_KEYDOWN:
+			OnListViewKeyDown(reinterpret_cast<NMLVKEYDOWN *>(nmhdr));
+			break;
+		}
+	}
+	else if (nmhdr->idFrom == IDC_ARCHIVE_BROWSER_TREE)
+	{
+		switch (nmhdr->code)
+		{
+		case TVN_ITEMEXPANDING:
+			OnTreeItemExpanding(reinterpret_cast<NMTREEVIEW *>(nmhdr));
+			break;
+
+		case TVN_SELCHANGED:
+			OnTreeSelectionChanged(reinterpret_cast<NMTREEVIEW *>(nmhdr));
+			break;
+		}
+	}
+
+	return 0;
+}
+
+INT_PTR ArchiveBrowserDialog::OnTimer(int timerId)
+{
+	if (timerId == PROGRESS_TIMER_ID && m_extracting)
+	{
+		SetStatusText(fmt::format(
+			fmt::runtime(m_app->GetResourceLoader()->LoadString(IDS_ARCHIVE_BROWSER_EXTRACTING)),
+			fmt::arg(L"num_files", m_numFilesExtracted->load())));
+	}
+
+	return 0;
+}
+
+void ArchiveBrowserDialog::OnGetDispInfo(NMLVDISPINFO *dispInfo)
+{
+	if (dispInfo->item.iItem >= std::ssize(m_visibleEntries))
+	{
+		return;
+	}
+
+	const auto &entry = m_archive->GetEntry(m_visibleEntries[dispInfo->item.iItem]);
+
+	if (WI_IsFlagSet(dispInfo->item.mask, LVIF_IMAGE))
+	{
+		dispInfo->item.iImage = GetEntryIconIndex(entry);
+	}
+
+	if (WI_IsFlagSet(dispInfo->item.mask, LVIF_TEXT))
+	{
+		assert(dispInfo->item.iSubItem >= 0 && dispInfo->item.iSubItem < std::ssize(COLUMNS));
+		auto text = GetEntryColumnText(entry, COLUMNS[dispInfo->item.iSubItem].type);
+		StringCchCopy(dispInfo->item.pszText, dispInfo->item.cchTextMax, text.c_str());
+	}
+}
+
+std::wstring ArchiveBrowserDialog::GetEntryColumnText(const ZipEntry &entry,
+	ColumnType columnType)
+{
+	switch (columnType)
+	{
+	case ArchiveBrowserDialog::ColumnType::Name:
+		return entry.name;
+
+	case ArchiveBrowserDialog::ColumnType::Size:
+		return entry.isFolder ? std::wstring() : FormatSizeString(entry.uncompressedSize);
+
+	case ArchiveBrowserDialog::ColumnType::PackedSize:
+		return entry.isFolder ? std::wstring() : FormatSizeString(entry.compressedSize);
+
+	case ArchiveBrowserDialog::ColumnType::Modified:
+		// Implied folders don't have an entry of their own, so they don't have a modification
+		// time.
+		return entry.isImplied ? std::wstring() : FormatModifiedTime(entry);
+
+	default:
+		LOG(FATAL) << "Archive browser column type not found";
+		__assume(0);
+	}
+}
+
+std::wstring ArchiveBrowserDialog::FormatModifiedTime(const ZipEntry &entry)
+{
+	auto fileTime = ConvertToFileTime(GetZipEntryModifiedTime(entry));
+
+	if (!fileTime)
+	{
+		return {};
+	}
+
+	TCHAR formattedTime[256];
+	BOOL res = CreateFileTimeString(&*fileTime, formattedTime, std::size(formattedTime),
+		m_app->GetConfig()->globalFolderSettings.showFriendlyDates);
+
+	if (!res)
+	{
+		return {};
+	}
+
+	return formattedTime;
+}
+
+int ArchiveBrowserDialog::GetEntryIconIndex(const ZipEntry &entry)
+{
+	// The icon is based only on the name and type of the entry, so the file doesn't need to exist.
+	SHFILEINFO shfi;
+	DWORD_PTR res = SHGetFileInfo(entry.name.c_str(),
+		entry.isFolder ? FILE_ATTRIBUTE_DIRECTORY : FILE_ATTRIBUTE_NORMAL, &shfi, sizeof(shfi),
+		SHGFI_USEFILEATTRIBUTES | SHGFI_SYSICONINDEX);
+
+	if (!res)
+	{
+		return 0;
+	}
+
+	return shfi.iIcon;
+}
+
+INT_PTR ArchiveBrowserDialog::OnClose()
+{
+	DestroyWindow(m_hDlg);
+	return 0;
+}
+
+void ArchiveBrowserDialog::SaveState()
+{
+	m_persistentSettings->SaveDialogPosition(m_hDlg);
+	m_persistentSettings->m_bStateSaved = TRUE;
+}
+
+INT_PTR ArchiveBrowserDialog::OnNcDestroy()
+{
+	delete this;
+
+	return 0;
+}
+
+ArchiveBrowserDialogPersistentSettings::ArchiveBrowserDialogPersistentSettings() :
+	DialogSettings(SETTINGS_KEY.c_str())
+{
+}
+
+ArchiveBrowserDialogPersistentSettings &ArchiveBrowserDialogPersistentSettings::GetInstance()
+{
+	static ArchiveBrowserDialogPersistentSettings persistentSettings;
+	return persistentSettings;
+}
@@ -0,0 +1,143 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#pragma once
+
+#include "ThemedDialog.h"
+#include "../Helper/DialogSettings.h"
+#include "../Helper/ScopedStopSource.h"
+#include "../Helper/WeakPtr.h"
+#include "../Helper/WeakPtrFactory.h"
+#include "../Helper/ZipArchive.h"
+#include <concurrencpp/concurrencpp.h>
+#include <atomic>
+#include <memory>
+#include <optional>
+#include <stop_token>
+#include <string>
+#include <vector>
+
+class App;
+class ArchiveBrowserDialog;
+class Runtime;
+
+class ArchiveBrowserDialogPersistentSettings : public DialogSettings
+{
+public:
+	static ArchiveBrowserDialogPersistentSettings &GetInstance();
+
+private:
+	friend ArchiveBrowserDialog;
+
+	static const inline std::wstring SETTINGS_KEY = L"ArchiveBrowser";
+
+	ArchiveBrowserDialogPersistentSettings();
+};
+
+// Shows the contents of a ZIP archive. The archive's central directory is read once, in the
+// background, after which any folder within the archive can be shown immediately. Items can be
+// extracted to a folder (with files extracted in parallel) and files can be opened directly, in
+// which case they're extracted to a temporary folder first.
+class ArchiveBrowserDialog : public ThemedDialog
+{
+public:
+	static ArchiveBrowserDialog *Create(App *app, HWND parent, const std::wstring &archivePath);
+
+private:
+	enum class ColumnType
+	{
+		Name,
+		Size,
+		PackedSize,
+		Modified
+	};
+
+	struct Column
+	{
+		ColumnType type;
+		float percentageWidth;
+	};
+
+	static inline const Column COLUMNS[] = { { ColumnType::Name, 0.42f },
+		{ ColumnType::Size, 0.16f }, { ColumnType::PackedSize, 0.16f },
+		{ ColumnType::Modified, 0.26f } };
+
+	static constexpr UINT_PTR PROGRESS_TIMER_ID = 1;
+	static constexpr UINT PROGRESS_TIMER_ELAPSED = 250;
+
+	ArchiveBrowserDialog(App *app, HWND parent, const std::wstring &archivePath);
+
+	INT_PTR OnInitDialog() override;
+	wil::unique_hicon GetDialogIcon(int iconWidth, int iconHeight) const override;
+	std::vector<ResizableDialogControl> GetResizableControls() override;
+	void SetupListView();
+	void InsertColumn(const Column &column, int index);
+	std::wstring GetColumnText(ColumnType columnType);
+
+	static concurrencpp::null_result OpenArchiveAsync(WeakPtr<ArchiveBrowserDialog> self,
+		std::wstring archivePath, Runtime *runtime, std::stop_token stopToken);
+	void OnArchiveOpened(std::shared_ptr<const ZipArchive> archive);
+
+	HTREEITEM InsertTreeItem(HTREEITEM parent, ZipArchive::EntryId folder);
+	bool HasSubfolders(ZipArchive::EntryId folder) const;
+	void OnTreeItemExpanding(const NMTREEVIEW *treeView);
+	void OnTreeSelectionChanged(const NMTREEVIEW *treeView);
+	void SelectFolderInTree(ZipArchive::EntryId folder);
+	void ShowFolder(ZipArchive::EntryId folder);
+
+	void OnListViewItemActivated(int index);
+	void OnListViewKeyDown(const NMLVKEYDOWN *keyDown);
+	std::vector<ZipArchive::EntryId> GetSelectedEntries() const;
+
+	void OnExtract();
+	void OpenEntry(ZipArchive::EntryId id);
+	void StartExtraction(std::vector<ZipArchive::EntryId> ids, const std::wstring &destination,
+		std::optional<std::wstring> fileToOpen);
+	static concurrencpp::null_result ExtractAsync(WeakPtr<ArchiveBrowserDialog> self,
+		std::shared_ptr<const ZipArchive> archive, std::vector<ZipArchive::EntryId> ids,
+		std::wstring destination, std::optional<std::wstring> fileToOpen,
+		std::shared_ptr<std::atomic<size_t>> numFilesExtracted, Runtime *runtime,
+		std::stop_token stopToken);
+	static void SetExtractedFileTime(const std::filesystem::path &path, const ZipEntry &entry);
+	void OnExtractionFinished(const ZipExtractionSummary &summary,
+		const std::optional<std::wstring> &fileToOpen);
+	std::optional<std::wstring> CreateTemporaryFolder();
+
+	void SetStatusText(const std::wstring &text);
+	void ShowFolderSummary();
+	void UpdateControlStates();
+
+	INT_PTR OnCommand(WPARAM wParam, LPARAM lParam) override;
+	INT_PTR OnNotify(NMHDR *nmhdr) override;
+	INT_PTR OnTimer(int timerId) override;
+	void OnGetDispInfo(NMLVDISPINFO *dispInfo);
+	std::wstring GetEntryColumnText(const ZipEntry &entry, ColumnType columnType);
+	std::wstring FormatModifiedTime(const ZipEntry &entry);
+	int GetEntryIconIndex(const ZipEntry &entry);
+	INT_PTR OnClose() override;
+	void SaveState() override;
+	INT_PTR OnNcDestroy() override;
+
+	App *const m_app;
+	const std::wstring m_archivePath;
+	ArchiveBrowserDialogPersistentSettings *m_persistentSettings;
+
+	// Closing the dialog stops the archive from being opened, as well as any extraction that's in
+	// progress.
+	ScopedStopSource m_stopSource;
+
+	// This is shared with any extractions that are running in the background, since they can
+	// outlive the dialog (until they notice that a stop has been requested).
+	std::shared_ptr<const ZipArchive> m_archive;
+
+	ZipArchive::EntryId m_currentFolder = ZipArchive::ROOT_ID;
+
+	// The children of the current folder, with folders listed first.
+	std::vector<ZipArchive::EntryId> m_visibleEntries;
+
+	bool m_extracting = false;
+	std::shared_ptr<std::atomic<size_t>> m_numFilesExtracted;
+
+	WeakPtrFactory<ArchiveBrowserDialog> m_weakPtrFactory;
+};
@@ -0,0 +1,631 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "stdafx.h"
+#include "BatchCommand.h"
+#include "ListingWalker.h"
+#include "../Helper/FileNameIndexWalker.h"
+#include "../Helper/FolderComparison.h"
+#include "../Helper/ParallelFor.h"
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <limits>
+#include <regex>
+#include <thread>
+
+namespace
+{
+
+// Files are hashed in batches, so that results can be written out in order while later files are
+// still being hashed.
+constexpr size_t HASH_BATCH_SIZE_PER_THREAD = 16;
+
+struct PathTotals
+{
+	uint64_t size = 0;
+	uint64_t numFiles = 0;
+	uint64_t numFolders = 0;
+};
+
+std::string ToUtf8(std::wstring_view text)
+{
+	std::string output;
+	ListingWriter::AppendUtf8(output, text);
+	return output;
+}
+
+void ReportError(std::ostream &error, const std::string &message, const std::wstring &path)
+{
+	error << message << ": " << ToUtf8(path) << "\n";
+}
+
+int GetNumThreads(const BatchCommand &command)
+{
+	if (command.numThreads > 0)
+	{
+		return command.numThreads;
+	}
+
+	return static_cast<int>(std::max(std::thread::hardware_concurrency(), 1u));
+}
+
+ListingFormat GetFormat(const BatchCommand &command)
+{
+	if (command.format)
+	{
+		return *command.format;
+	}
+
+	return command.type == BatchCommandType::Export ? ListingFormat::Csv : ListingFormat::Text;
+}
+
+bool IsFolder(const std::wstring &path)
+{
+	std::error_code error;
+	return std::filesystem::is_directory(path, error);
+}
+
+std::wstring GetTypeText(bool isFolder)
+{
+	return isFolder ? L"Folder" : L"File";
+}
+
+// Folders don't have a size, so nothing is shown for them.
+std::wstring GetSizeText(const FileNameIndexItem &item)
+{
+	return item.isFolder ? L"" : std::to_wstring(item.size);
+}
+
+std::wstring GetSizeText(const std::optional<FolderItemProperties> &properties)
+{
+	return (properties && !properties->isFolder) ? std::to_wstring(properties->size) : L"";
+}
+
+std::wstring GetComparisonStatusText(FolderComparisonStatus status)
+{
+	switch (status)
+	{
+	case FolderComparisonStatus::LeftOnly:
+		return L"left-only";
+
+	case FolderComparisonStatus::RightOnly:
+		return L"right-only";
+
+	case FolderComparisonStatus::LeftNewer:
+		return L"left-newer";
+
+	case FolderComparisonStatus::RightNewer:
+		return L"right-newer";
+
+	case FolderComparisonStatus::SizeDiffers:
+		return L"size-differs";
+
+	case FolderComparisonStatus::ContentDiffers:
+		return L"content-differs";
+
+	case FolderComparisonStatus::TypeDiffers:
+		return L"type-differs";
+
+	case FolderComparisonStatus::Identical:
+		return L"identical";
+	}
+
+	LOG(FATAL) << "Unknown folder comparison status";
+	return L"";
+}
+
+// Reads the folder (and, if requested, everything within it) into an in-memory index, so that the
+// index's filters can be used to select items. Subfolders are read in parallel. Returns null if a
+// stop was requested.
+std::unique_ptr<FileNameIndex> ReadIntoIndex(const std::wstring &rootPath, bool recursive,
+	int numThreads, std::stop_token stopToken)
+{
+	FileNameIndexFolderReader reader = ReadFolderForIndex;
+
+	if (!recursive)
+	{
+		// Subfolders are still added to the index, they're just left empty.
+		reader = [&rootPath](const std::wstring &path, std::vector<FileNameIndexItem> &items)
+		{ return path != rootPath || ReadFolderForIndex(path, items); };
+	}
+
+	auto data = BuildFileNameIndex({ rootPath }, reader, numThreads, stopToken);
+
+	if (!data)
+	{
+		return nullptr;
+	}
+
+	return FileNameIndex::Load(std::move(*data));
+}
+
+FileNameQuery BuildQuery(const BatchCommand &command, const std::wstring &rootPath, int numThreads)
+{
+	FileNameQuery query;
+	query.pattern = command.pattern;
+	query.matchType = command.matchType;
+	query.caseSensitive = command.caseSensitive;
+	query.itemTypes = command.itemTypes;
+	query.minSize = command.minSize;
+	query.maxSize = command.maxSize;
+	query.scopePath = GetFileNameIndexRootName(rootPath);
+	query.maxResults = std::numeric_limits<size_t>::max();
+	query.numThreads = numThreads;
+	return query;
+}
+
+void SortByPath(std::vector<FileNameQueryResult> &results)
+{
+	std::ranges::stable_sort(results,
+		[](const FileNameQueryResult &result1, const FileNameQueryResult &result2)
+		{ return CompareRelativePaths(result1.path, result2.path) < 0; });
+}
+
+void SortResults(std::vector<FileNameQueryResult> &results, BatchSortField field,
+	bool descending)
+{
+	switch (field)
+	{
+	case BatchSortField::Name:
+		// Query results are already ordered by name.
+		break;
+
+	case BatchSortField::Path:
+		SortByPath(results);
+		break;
+
+	case BatchSortField::Size:
+		std::ranges::stable_sort(results, {},
+			[](const FileNameQueryResult &result) { return result.item.size; });
+		break;
+
+	case BatchSortField::Modified:
+		std::ranges::stable_sort(results, {},
+			[](const FileNameQueryResult &result) { return result.item.lastWriteTime; });
+		break;
+	}
+
+	if (descending)
+	{
+		std::ranges::reverse(results);
+	}
+}
+
+std::optional<PathTotals> CalculateTotals(const std::wstring &path, int numThreads,
+	std::stop_token stopToken)
+{
+	std::error_code error;
+	auto status = std::filesystem::status(path, error);
+
+	if (error)
+	{
+		return std::nullopt;
+	}
+
+	PathTotals totals;
+
+	if (!std::filesystem::is_directory(status))
+	{
+		totals.size = std::filesystem::file_size(path, error);
+		totals.numFiles = 1;
+		return error ? std::nullopt : std::optional(totals);
+	}
+
+	// The items don't need to be stored anywhere, so each one is simply given a unique id.
+	FileNameIndex::ItemId nextId = 1;
+
+	bool completed = WalkFoldersForIndex({ { path, 0 } }, ReadFolderForIndex, numThreads,
+		stopToken,
+		[&totals, &nextId](FileNameIndex::ItemId parent, FileNameIndexItem item)
+		{
+			UNREFERENCED_PARAMETER(parent);
+
+			if (item.isFolder)
+			{
+				totals.numFolders++;
+			}
+			else
+			{
+				totals.numFiles++;
+				totals.size += item.size;
+			}
+
+			return nextId++;
+		});
+
+	if (!completed)
+	{
+		return std::nullopt;
+	}
+
+	return totals;
+}
+
+class FileSystemListingSource : public ListingSource
+{
+public:
+	bool EnumerateFolder(const std::wstring &path, std::vector<ListingEntry> &entries,
+		std::stop_token stopToken) override
+	{
+		UNREFERENCED_PARAMETER(stopToken);
+
+		std::vector<FileNameIndexItem> items;
+
+		if (!ReadFolderForIndex(path, items))
+		{
+			return false;
+		}
+
+		// Folders are listed first, as they are in the main listview.
+		std::ranges::sort(items,
+			[](const FileNameIndexItem &item1, const FileNameIndexItem &item2)
+			{
+				if (item1.isFolder != item2.isFolder)
+				{
+					return item1.isFolder;
+				}
+
+				return CompareRelativePaths(item1.name, item2.name) < 0;
+			});
+
+		for (const auto &item : items)
+		{
+			ListingEntry entry;
+			entry.path = (std::filesystem::path(path) / item.name).wstring();
+			entry.name = item.name;
+
+			// Links to folders are listed, but not followed, so that they can't result in a cycle.
+			entry.isFolder =
+				item.isFolder && !(item.attributes & FILE_NAME_INDEX_REPARSE_POINT_ATTRIBUTE);
+
+			entry.values = { item.name, GetTypeText(item.isFolder), GetSizeText(item),
+				FormatBatchTimestamp(item.lastWriteTime) };
+			entries.push_back(std::move(entry));
+		}
+
+		return true;
+	}
+};
+
+// The pattern is checked up front, so that an invalid pattern doesn't result in partial output.
+bool ValidatePattern(const BatchCommand &command, std::ostream &error)
+{
+	if (command.matchType != FileNameMatchType::Regex)
+	{
+		return true;
+	}
+
+	try
+	{
+		std::wregex regex(command.pattern);
+	}
+	catch (const std::regex_error &)
+	{
+		error << "Invalid regular expression: " << ToUtf8(command.pattern) << "\n";
+		return false;
+	}
+
+	return true;
+}
+
+ExitCode FinishWriting(ListingWriter &writer, std::ostream &error, ExitCode exitCode)
+{
+	if (!writer.Finish())
+	{
+		error << "The results couldn't be written\n";
+		return EXIT_CODE_ERROR;
+	}
+
+	return exitCode;
+}
+
+ExitCode RunListCommand(const BatchCommand &command, bool recursive, std::ostream &output,
+	std::ostream &error, std::stop_token stopToken)
+{
+	if (!ValidatePattern(command, error))
+	{
+		return EXIT_CODE_ERROR;
+	}
+
+	int numThreads = GetNumThreads(command);
+	ListingWriter writer(output, GetFormat(command), { L"Type", L"Size", L"Modified", L"Path" });
+	ExitCode exitCode = EXIT_CODE_NORMAL;
+
+	for (const auto &path : command.paths)
+	{
+		if (!IsFolder(path))
+		{
+			ReportError(error, "Not a folder", path);
+			exitCode = EXIT_CODE_ERROR;
+			continue;
+		}
+
+		auto index = ReadIntoIndex(path, recursive, numThreads, stopToken);
+
+		if (!index)
+		{
+			return EXIT_CODE_ERROR;
+		}
+
+		auto results = index->Query(BuildQuery(command, path, numThreads), stopToken);
+		SortResults(results, command.sortField, command.sortDescending);
+
+		for (const auto &result : results)
+		{
+			if (!writer.WriteItem({ GetTypeText(result.item.isFolder), GetSizeText(result.item),
+					FormatBatchTimestamp(result.item.lastWriteTime), result.path }))
+			{
+				return FinishWriting(writer, error, EXIT_CODE_ERROR);
+			}
+		}
+	}
+
+	return FinishWriting(writer, error, exitCode);
+}
+
+ExitCode RunSizeCommand(const BatchCommand &command, std::ostream &output, std::ostream &error,
+	std::stop_token stopToken)
+{
+	int numThreads = GetNumThreads(command);
+	ListingWriter writer(output, GetFormat(command), { L"Size", L"Files", L"Folders", L"Path" });
+	ExitCode exitCode = EXIT_CODE_NORMAL;
+
+	for (const auto &path : command.paths)
+	{
+		auto totals = CalculateTotals(path, numThreads, stopToken);
+
+		if (stopToken.stop_requested())
+		{
+			return EXIT_CODE_ERROR;
+		}
+
+		if (!totals)
+		{
+			ReportError(error, "Couldn't read", path);
+			exitCode = EXIT_CODE_ERROR;
+			continue;
+		}
+
+		if (!writer.WriteItem({ std::to_wstring(totals->size), std::to_wstring(totals->numFiles),
+				std::to_wstring(totals->numFolders), path }))
+		{
+			return FinishWriting(writer, error, EXIT_CODE_ERROR);
+		}
+	}
+
+	return FinishWriting(writer, error, exitCode);
+}
+
+ExitCode RunHashCommand(const BatchCommand &command, std::ostream &output, std::ostream &error,
+	std::stop_token stopToken)
+{
+	if (!ValidatePattern(command, error))
+	{
+		return EXIT_CODE_ERROR;
+	}
+
+	int numThreads = GetNumThreads(command);
+	ExitCode exitCode = EXIT_CODE_NORMAL;
+	std::vector<std::wstring> files;
+
+	for (const auto &path : command.paths)
+	{
+		if (!IsFolder(path))
+		{
+			files.push_back(path);
+			continue;
+		}
+
+		auto index = ReadIntoIndex(path, command.recursive, numThreads, stopToken);
+
+		if (!index)
+		{
+			return EXIT_CODE_ERROR;
+		}
+
+		auto query = BuildQuery(command, path, numThreads);
+		query.itemTypes = FileNameItemTypes::Files;
+
+		auto results = index->Query(query, stopToken);
+		SortByPath(results);
+
+		for (auto &result : results)
+		{
+			files.push_back(std::move(result.path));
+		}
+	}
+
+	ListingWriter writer(output, GetFormat(command), { L"Hash", L"Path" });
+	size_t batchSize = static_cast<size_t>(numThreads) * HASH_BATCH_SIZE_PER_THREAD;
+
+	for (size_t start = 0; start < files.size(); start += batchSize)
+	{
+		size_t count = std::min(batchSize, files.size() - start);
+		std::vector<std::optional<std::string>> hashes(count);
+
+		ParallelFor(count, numThreads, stopToken,
+			[&command, &files, &hashes, start, &stopToken](size_t index)
+			{ hashes[index] = HashFile(files[start + index], command.hashAlgorithm, stopToken); });
+
+		if (stopToken.stop_requested())
+		{
+			return EXIT_CODE_ERROR;
+		}
+
+		for (size_t i = 0; i < count; i++)
+		{
+			const auto &file = files[start + i];
+
+			if (!hashes[i])
+			{
+				ReportError(error, "Couldn't hash", file);
+				exitCode = EXIT_CODE_ERROR;
+				continue;
+			}
+
+			if (!writer.WriteItem({ std::wstring(hashes[i]->begin(), hashes[i]->end()), file }))
+			{
+				return FinishWriting(writer, error, EXIT_CODE_ERROR);
+			}
+		}
+	}
+
+	return FinishWriting(writer, error, exitCode);
+}
+
+ExitCode RunExportCommand(const BatchCommand &command, std::ostream &output, std::ostream &error,
+	std::stop_token stopToken)
+{
+	const auto &path = command.paths.at(0);
+
+	if (!IsFolder(path))
+	{
+		ReportError(error, "Not a folder", path);
+		return EXIT_CODE_ERROR;
+	}
+
+	std::vector<std::wstring> columnNames = { L"Name", L"Type", L"Size", L"Modified" };
+
+	if (command.recursive)
+	{
+		columnNames.insert(columnNames.begin(), L"Folder");
+	}
+
+	ListingWriter writer(output, GetFormat(command), std::move(columnNames));
+	FileSystemListingSource source;
+	ListingWalker walker(&source, &writer,
+		{ .recursive = command.recursive, .includeRelativeFolder = command.recursive });
+
+	switch (walker.Walk(path, stopToken))
+	{
+	case ListingWalker::Result::Completed:
+		return EXIT_CODE_NORMAL;
+
+	case ListingWalker::Result::Cancelled:
+		return EXIT_CODE_ERROR;
+
+	case ListingWalker::Result::WriteFailed:
+		error << "The results couldn't be written\n";
+		return EXIT_CODE_ERROR;
+	}
+
+	LOG(FATAL) << "Unknown listing walker result";
+	return EXIT_CODE_ERROR;
+}
+
+ExitCode RunCompareCommand(const BatchCommand &command, std::ostream &output,
+	std::ostream &error, std::stop_token stopToken)
+{
+	const auto &leftPath = command.paths.at(0);
+	const auto &rightPath = command.paths.at(1);
+
+	for (const auto &path : { leftPath, rightPath })
+	{
+		if (!IsFolder(path))
+		{
+			ReportError(error, "Not a folder", path);
+			return EXIT_CODE_ERROR;
+		}
+	}
+
+	FolderComparisonOptions options;
+	options.contentHashAlgorithm = command.compareContents;
+	options.numThreads = GetNumThreads(command);
+
+	auto entries = CompareFolders(leftPath, rightPath, options, stopToken);
+
+	if (!entries)
+	{
+		if (!stopToken.stop_requested())
+		{
+			error << "The folders couldn't be compared\n";
+		}
+
+		return EXIT_CODE_ERROR;
+	}
+
+	ListingWriter writer(output, GetFormat(command),
+		{ L"Status", L"Left Size", L"Right Size", L"Path" });
+	bool differencesFound = false;
+
+	for (const auto &entry : *entries)
+	{
+		bool isDifference = IsFolderComparisonDifference(entry.status);
+		differencesFound |= isDifference;
+
+		if (command.differencesOnly && !isDifference)
+		{
+			continue;
+		}
+
+		if (!writer.WriteItem({ GetComparisonStatusText(entry.status), GetSizeText(entry.left),
+				GetSizeText(entry.right), entry.relativePath }))
+		{
+			return FinishWriting(writer, error, EXIT_CODE_ERROR);
+		}
+	}
+
+	return FinishWriting(writer, error,
+		differencesFound ? EXIT_CODE_DIFFERENCES_FOUND : EXIT_CODE_NORMAL);
+}
+
+}
+
+ExitCode RunBatchCommand(const BatchCommand &command, std::ostream &output, std::ostream &error,
+	std::stop_token stopToken)
+{
+	switch (command.type)
+	{
+	case BatchCommandType::List:
+		return RunListCommand(command, command.recursive, output, error, stopToken);
+
+	case BatchCommandType::Search:
+		return RunListCommand(command, true, output, error, stopToken);
+
+	case BatchCommandType::Size:
+		return RunSizeCommand(command, output, error, stopToken);
+
+	case BatchCommandType::Hash:
+		return RunHashCommand(command, output, error, stopToken);
+
+	case BatchCommandType::Export:
+		return RunExportCommand(command, output, error, stopToken);
+
+	case BatchCommandType::Compare:
+		return RunCompareCommand(command, output, error, stopToken);
+	}
+
+	LOG(FATAL) << "Unknown batch command type";
+	return EXIT_CODE_ERROR;
+}
+
+std::wstring FormatBatchTimestamp(int64_t lastWriteTime)
+{
+	std::filesystem::file_time_type fileTime(
+		std::filesystem::file_time_type::duration{ lastWriteTime });
+
+#if __cpp_lib_chrono >= 201907L
+	auto systemTime = std::chrono::clock_cast<std::chrono::system_clock>(fileTime);
+#else
+	// Not every standard library supports clock_cast yet.
+	auto systemTime = std::filesystem::file_time_type::clock::to_sys(fileTime);
+#endif
+
+	auto seconds = std::chrono::floor<std::chrono::seconds>(systemTime);
+	auto days = std::chrono::floor<std::chrono::days>(seconds);
+	std::chrono::year_month_day date(days);
+	std::chrono::hh_mm_ss time(seconds - days);
+
+	// snprintf is used, rather than a stream, so that the output doesn't depend on the global
+	// locale.
+	char text[32];
+	std::snprintf(text, std::size(text), "%04d-%02u-%02uT%02d:%02d:%02dZ",
+		static_cast<int>(date.year()), static_cast<unsigned int>(date.month()),
+		static_cast<unsigned int>(date.day()), static_cast<int>(time.hours().count()),
+		static_cast<int>(time.minutes().count()), static_cast<int>(time.seconds().count()));
+
+	std::string_view textView(text);
+	return std::wstring(textView.begin(), textView.end());
+}
@@ -0,0 +1,90 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#pragma once
+
+#include "ExitCode.h"
+#include "ListingWriter.h"
+#include "../Helper/ContentHash.h"
+#include "../Helper/FileNameIndex.h"
+#include <cstdint>
+#include <optional>
+#include <ostream>
+#include <stop_token>
+#include <string>
+#include <vector>
+
+// Commands that are run from the command line without creating a window. They use the same
+// enumeration, matching and comparison code as the rest of the application and write their results
+// to a stream, so that they can be used in scripts (and to benchmark that code).
+enum class BatchCommandType
+{
+	// Lists the contents of a folder, optionally including subfolders.
+	List,
+
+	// Finds items within a folder (at any depth) whose names match a pattern.
+	Search,
+
+	// Calculates the total size of each path, along with the number of files and folders within it.
+	Size,
+
+	// Hashes each file (or each file within each folder).
+	Hash,
+
+	// Writes a folder listing in the same form as the directory listing export, with items written
+	// as each folder is read, rather than being collected first.
+	Export,
+
+	// Compares two folders.
+	Compare
+};
+
+enum class BatchSortField
+{
+	Name,
+	Path,
+	Size,
+	Modified
+};
+
+struct BatchCommand
+{
+	BatchCommandType type = BatchCommandType::List;
+	std::vector<std::wstring> paths;
+
+	// If not set, export commands write CSV and all other commands write text.
+	std::optional<ListingFormat> format;
+
+	bool recursive = false;
+
+	// Filters for the list, search and hash commands.
+	std::wstring pattern;
+	FileNameMatchType matchType = FileNameMatchType::Wildcard;
+	bool caseSensitive = false;
+	FileNameItemTypes itemTypes = FileNameItemTypes::All;
+	std::optional<uint64_t> minSize;
+	std::optional<uint64_t> maxSize;
+
+	// Used by the list and search commands.
+	BatchSortField sortField = BatchSortField::Name;
+	bool sortDescending = false;
+
+	HashAlgorithm hashAlgorithm = HashAlgorithm::Sha256;
+
+	// Used by the compare command. If set, files of the same size have their contents compared.
+	std::optional<HashAlgorithm> compareContents;
+	bool differencesOnly = false;
+
+	// If 0, a thread is used for each processor.
+	int numThreads = 0;
+};
+
+// Results are written to the output stream, while errors are written to the error stream. A folder
+// comparison that finds differences returns EXIT_CODE_DIFFERENCES_FOUND.
+ExitCode RunBatchCommand(const BatchCommand &command, std::ostream &output, std::ostream &error,
+	std::stop_token stopToken = {});
+
+// Converts a last write time, as stored by FileNameIndexItem, to an ISO 8601 UTC timestamp (e.g.
+// "2024-05-01T13:45:00Z").
+std::wstring FormatBatchTimestamp(int64_t lastWriteTime);
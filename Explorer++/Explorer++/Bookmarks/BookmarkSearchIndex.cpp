@@ -0,0 +1,278 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "stdafx.h"
+#include "Bookmarks/BookmarkSearchIndex.h"
+#include "Bookmarks/BookmarkItem.h"
+#include <glog/logging.h>
+#include <algorithm>
+#include <cwctype>
+
+namespace
+{
+
+// Dead entries will be left in place until there are at least this many of them.
+constexpr size_t MIN_DEAD_ENTRIES_BEFORE_COMPACTION = 1024;
+
+}
+
+void BookmarkSearchIndex::AddItem(BookmarkItem *bookmarkItem)
+{
+	if (auto itr = m_itemEntries.find(bookmarkItem); itr != m_itemEntries.end())
+	{
+		MarkEntryDead(itr->second);
+		m_itemEntries.erase(itr);
+	}
+
+	auto entryId = static_cast<EntryId>(m_entries.size());
+	m_entries.push_back(bookmarkItem);
+	m_itemEntries[bookmarkItem] = entryId;
+
+	IndexText(entryId, bookmarkItem->GetName(), false);
+
+	if (bookmarkItem->IsBookmark())
+	{
+		IndexText(entryId, bookmarkItem->GetLocation(), true);
+	}
+
+	CompactIfNecessary();
+}
+
+void BookmarkSearchIndex::UpdateItem(BookmarkItem *bookmarkItem)
+{
+	// Rather than attempting to work out which tokens have changed, the item is simply indexed
+	// again. The previous entry will be removed when the index is next compacted.
+	AddItem(bookmarkItem);
+}
+
+void BookmarkSearchIndex::RemoveItem(const BookmarkItem *bookmarkItem)
+{
+	auto itr = m_itemEntries.find(bookmarkItem);
+
+	if (itr == m_itemEntries.end())
+	{
+		return;
+	}
+
+	MarkEntryDead(itr->second);
+	m_itemEntries.erase(itr);
+
+	CompactIfNecessary();
+}
+
+void BookmarkSearchIndex::IndexText(EntryId entryId, std::wstring_view text, bool isLocation)
+{
+	Posting posting = (entryId << 1) | (isLocation ? 1 : 0);
+
+	for (const auto &tokenText : Tokenize(text))
+	{
+		TokenId tokenId = GetOrCreateToken(tokenText);
+		auto &postings = m_tokens[tokenId].postings;
+
+		// The same token can appear multiple times in a single piece of text, but only needs to be
+		// recorded once.
+		if (!postings.empty() && postings.back() == posting)
+		{
+			continue;
+		}
+
+		postings.push_back(posting);
+	}
+}
+
+BookmarkSearchIndex::TokenId BookmarkSearchIndex::GetOrCreateToken(const std::wstring &text)
+{
+	auto [itr, inserted] =
+		m_tokenIds.try_emplace(text, static_cast<TokenId>(m_tokens.size()));
+
+	if (inserted)
+	{
+		m_tokens.push_back({ text, {} });
+	}
+
+	return itr->second;
+}
+
+void BookmarkSearchIndex::MarkEntryDead(EntryId entryId)
+{
+	DCHECK(m_entries[entryId]);
+
+	m_entries[entryId] = nullptr;
+	m_numDeadEntries++;
+}
+
+void BookmarkSearchIndex::CompactIfNecessary()
+{
+	if (m_numDeadEntries < MIN_DEAD_ENTRIES_BEFORE_COMPACTION
+		|| m_numDeadEntries < m_entries.size() - m_numDeadEntries)
+	{
+		return;
+	}
+
+	std::vector<BookmarkItem *> liveItems;
+	liveItems.reserve(m_entries.size() - m_numDeadEntries);
+
+	for (auto *item : m_entries)
+	{
+		if (item)
+		{
+			liveItems.push_back(item);
+		}
+	}
+
+	m_entries.clear();
+	m_itemEntries.clear();
+	m_tokens.clear();
+	m_tokenIds.clear();
+	m_numDeadEntries = 0;
+
+	for (auto *item : liveItems)
+	{
+		AddItem(item);
+	}
+}
+
+std::vector<BookmarkItem *> BookmarkSearchIndex::Search(std::wstring_view query,
+	size_t maxResults) const
+{
+	auto terms = Tokenize(query);
+
+	if (terms.empty() || maxResults == 0)
+	{
+		return {};
+	}
+
+	// For each entry, this records the number of leading terms that have been matched so far. An
+	// entry only remains a candidate if it matched every previous term, so the intersection is
+	// performed without building any intermediate sets.
+	std::vector<uint16_t> numTermsMatched(m_entries.size(), 0);
+	std::vector<uint8_t> termQualities(m_entries.size(), MatchQuality::NoMatch);
+	std::vector<uint32_t> scores(m_entries.size(), 0);
+
+	for (size_t termIndex = 0; termIndex < terms.size(); termIndex++)
+	{
+		const auto &term = terms[termIndex];
+		bool allowSubstringMatch = term.size() >= MIN_SUBSTRING_TERM_LENGTH;
+
+		std::vector<TokenId> prefixMatches;
+		std::vector<TokenId> substringMatches;
+
+		for (TokenId tokenId = 0; tokenId < m_tokens.size(); tokenId++)
+		{
+			const auto &token = m_tokens[tokenId];
+
+			if (token.text.starts_with(term))
+			{
+				prefixMatches.push_back(tokenId);
+			}
+			else if (allowSubstringMatch && token.text.find(term) != std::wstring::npos)
+			{
+				substringMatches.push_back(tokenId);
+			}
+		}
+
+		auto processPostings = [&](const std::vector<TokenId> &matchingTokens, bool prefix)
+		{
+			for (TokenId tokenId : matchingTokens)
+			{
+				for (Posting posting : m_tokens[tokenId].postings)
+				{
+					EntryId entryId = posting >> 1;
+					bool isLocation = posting & 1;
+					uint8_t quality = isLocation
+						? (prefix ? MatchQuality::LocationPrefix : MatchQuality::LocationSubstring)
+						: (prefix ? MatchQuality::NamePrefix : MatchQuality::NameSubstring);
+
+					if (numTermsMatched[entryId] == termIndex)
+					{
+						numTermsMatched[entryId]++;
+						termQualities[entryId] = quality;
+						scores[entryId] += quality;
+					}
+					else if (numTermsMatched[entryId] == termIndex + 1
+						&& quality < termQualities[entryId])
+					{
+						scores[entryId] -= termQualities[entryId] - quality;
+						termQualities[entryId] = quality;
+					}
+				}
+			}
+		};
+
+		processPostings(prefixMatches, true);
+		processPostings(substringMatches, false);
+
+		if (prefixMatches.empty() && substringMatches.empty())
+		{
+			return {};
+		}
+	}
+
+	std::vector<EntryId> matchingEntries;
+
+	for (EntryId entryId = 0; entryId < m_entries.size(); entryId++)
+	{
+		if (numTermsMatched[entryId] == terms.size() && m_entries[entryId])
+		{
+			matchingEntries.push_back(entryId);
+		}
+	}
+
+	size_t numResults = std::min(maxResults, matchingEntries.size());
+
+	// Entries are ordered by score, then by the order in which they were indexed (which, for a
+	// freshly loaded tree, is the order in which they appear in the tree).
+	std::partial_sort(matchingEntries.begin(), matchingEntries.begin() + numResults,
+		matchingEntries.end(),
+		[&scores](EntryId first, EntryId second)
+		{
+			if (scores[first] != scores[second])
+			{
+				return scores[first] < scores[second];
+			}
+
+			return first < second;
+		});
+
+	std::vector<BookmarkItem *> results;
+	results.reserve(numResults);
+
+	for (size_t i = 0; i < numResults; i++)
+	{
+		results.push_back(m_entries[matchingEntries[i]]);
+	}
+
+	return results;
+}
+
+size_t BookmarkSearchIndex::GetNumItems() const
+{
+	return m_itemEntries.size();
+}
+
+std::vector<std::wstring> BookmarkSearchIndex::Tokenize(std::wstring_view text)
+{
+	std::vector<std::wstring> tokens;
+	std::wstring currentToken;
+
+	for (wchar_t c : text)
+	{
+		if (std::iswalnum(c))
+		{
+			currentToken.push_back(static_cast<wchar_t>(std::towlower(c)));
+		}
+		else if (!currentToken.empty())
+		{
+			tokens.push_back(std::move(currentToken));
+			currentToken.clear();
+		}
+	}
+
+	if (!currentToken.empty())
+	{
+		tokens.push_back(std::move(currentToken));
+	}
+
+	return tokens;
+}
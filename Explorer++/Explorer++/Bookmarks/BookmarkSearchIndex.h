@@ -0,0 +1,89 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#pragma once
+
+#include <boost/core/noncopyable.hpp>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+class BookmarkItem;
+
+// Maintains a token index over the names and locations of a set of bookmark items, so that
+// bookmarks can be searched without walking the entire tree.
+//
+// Text is lowercased and split into tokens at any character that isn't alphanumeric (e.g.
+// "https://example.com/Docs" produces "https", "example", "com" and "docs"). A query is split in
+// the same way and an item matches if every query term matches one of the item's tokens. Terms
+// match tokens by prefix and, for terms that are at least MIN_SUBSTRING_TERM_LENGTH characters
+// long, by substring as well.
+//
+// Each distinct token is stored once, along with a posting list of the items that contain it. That
+// means a substring search only has to scan the (comparatively small) set of distinct tokens, rather
+// than the text of every item.
+//
+// Removing an item only marks its entry as dead; dead entries are skipped when searching and the
+// index is compacted once they outnumber the live entries.
+class BookmarkSearchIndex : private boost::noncopyable
+{
+public:
+	static constexpr size_t MIN_SUBSTRING_TERM_LENGTH = 3;
+
+	// Adds a single item (not including its children). If the item is already indexed, it will be
+	// reindexed.
+	void AddItem(BookmarkItem *bookmarkItem);
+
+	// Should be called whenever the name or location of an indexed item changes.
+	void UpdateItem(BookmarkItem *bookmarkItem);
+
+	void RemoveItem(const BookmarkItem *bookmarkItem);
+
+	// Returns up to maxResults matching items, with the best matches first. Items whose name
+	// matches are ranked above items whose location matches and prefix matches are ranked above
+	// substring matches.
+	std::vector<BookmarkItem *> Search(std::wstring_view query, size_t maxResults) const;
+
+	size_t GetNumItems() const;
+
+	static std::vector<std::wstring> Tokenize(std::wstring_view text);
+
+private:
+	using EntryId = uint32_t;
+	using TokenId = uint32_t;
+
+	// Each posting is an entry ID, shifted left by one, with the low bit set if the token came
+	// from the item's location, rather than its name.
+	using Posting = uint32_t;
+
+	// Lower values indicate better matches.
+	enum MatchQuality : uint8_t
+	{
+		NamePrefix = 0,
+		NameSubstring = 1,
+		LocationPrefix = 2,
+		LocationSubstring = 3,
+		NoMatch = 4
+	};
+
+	struct Token
+	{
+		std::wstring text;
+		std::vector<Posting> postings;
+	};
+
+	void IndexText(EntryId entryId, std::wstring_view text, bool isLocation);
+	TokenId GetOrCreateToken(const std::wstring &text);
+	void MarkEntryDead(EntryId entryId);
+	void CompactIfNecessary();
+
+	// Each entry is null once it's dead.
+	std::vector<BookmarkItem *> m_entries;
+	std::unordered_map<const BookmarkItem *, EntryId> m_itemEntries;
+	std::vector<Token> m_tokens;
+	std::unordered_map<std::wstring, TokenId> m_tokenIds;
+	size_t m_numDeadEntries = 0;
+};
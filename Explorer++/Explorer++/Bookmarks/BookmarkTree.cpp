@@ -31,6 +31,13 @@ BookmarkTree::BookmarkTree() :
 		std::nullopt);
 	m_otherBookmarks = otherBookmarksFolder.get();
 	m_root.AddChild(std::move(otherBookmarksFolder));
+
+	// The permanent folders can be looked up by ID, but aren't included in search results.
+	for (auto *permanentFolder :
+		{ &m_root, m_bookmarksToolbar, m_bookmarksMenu, m_otherBookmarks })
+	{
+		m_itemsById[permanentFolder->GetGUID()] = permanentFolder;
+	}
 }
 
 BookmarkItem *BookmarkTree::GetRoot()
@@ -96,6 +103,8 @@ BookmarkItem *BookmarkTree::AddBookmarkItem(BookmarkItem *parent,
 	}
 
 	BookmarkItem *rawBookmarkItem = parent->AddChild(std::move(bookmarkItem), index);
+	IndexItemRecursive(rawBookmarkItem);
+
 	bookmarkItemAddedSignal.m_signal(*rawBookmarkItem, index);
 
 	return rawBookmarkItem;
@@ -149,6 +158,8 @@ void BookmarkTree::RemoveBookmarkItem(BookmarkItem *bookmarkItem)
 
 	std::wstring guid = bookmarkItem->GetGUID();
 
+	UnindexItemRecursive(bookmarkItem);
+
 	size_t childIndex = parent->GetChildIndex(bookmarkItem);
 	parent->RemoveChild(childIndex);
 	bookmarkItemRemovedSignal.m_signal(guid);
@@ -157,9 +168,53 @@ void BookmarkTree::RemoveBookmarkItem(BookmarkItem *bookmarkItem)
 void BookmarkTree::OnBookmarkItemUpdated(BookmarkItem &bookmarkItem,
 	BookmarkItem::PropertyType propertyType)
 {
+	if (propertyType == BookmarkItem::PropertyType::Name
+		|| propertyType == BookmarkItem::PropertyType::Location)
+	{
+		m_searchIndex.UpdateItem(&bookmarkItem);
+	}
+
 	bookmarkItemUpdatedSignal.m_signal(bookmarkItem, propertyType);
 }
 
+void BookmarkTree::IndexItemRecursive(BookmarkItem *bookmarkItem)
+{
+	bookmarkItem->VisitRecursively(
+		[this](BookmarkItem *currentItem)
+		{
+			m_itemsById[currentItem->GetGUID()] = currentItem;
+			m_searchIndex.AddItem(currentItem);
+		});
+}
+
+void BookmarkTree::UnindexItemRecursive(BookmarkItem *bookmarkItem)
+{
+	bookmarkItem->VisitRecursively(
+		[this](BookmarkItem *currentItem)
+		{
+			m_itemsById.erase(currentItem->GetGUID());
+			m_searchIndex.RemoveItem(currentItem);
+		});
+}
+
+BookmarkItem *BookmarkTree::GetBookmarkItemById(std::wstring_view guid)
+{
+	auto itr = m_itemsById.find(std::wstring(guid));
+
+	if (itr == m_itemsById.end())
+	{
+		return nullptr;
+	}
+
+	return itr->second;
+}
+
+std::vector<BookmarkItem *> BookmarkTree::SearchBookmarks(std::wstring_view query,
+	size_t maxResults) const
+{
+	return m_searchIndex.Search(query, maxResults);
+}
+
 bool BookmarkTree::CanAddChildren(const BookmarkItem *bookmarkItem) const
 {
 	return bookmarkItem != &m_root;
@@ -5,8 +5,10 @@
 #pragma once
 
 #include "Bookmarks/BookmarkItem.h"
+#include "Bookmarks/BookmarkSearchIndex.h"
 #include "SignalWrapper.h"
 #include <tchar.h>
+#include <unordered_map>
 
 class BookmarkTree
 {
@@ -29,6 +31,14 @@ public:
 	void MoveBookmarkItem(BookmarkItem *bookmarkItem, BookmarkItem *newParent, size_t index);
 	void RemoveBookmarkItem(BookmarkItem *bookmarkItem);
 
+	// Returns the item with the specified GUID, or null if there's no such item in the tree. This
+	// is a constant-time lookup.
+	BookmarkItem *GetBookmarkItemById(std::wstring_view guid);
+
+	// Searches the names and locations of the items in the tree. The permanent folders are never
+	// returned. See BookmarkSearchIndex for details on how items are matched.
+	std::vector<BookmarkItem *> SearchBookmarks(std::wstring_view query, size_t maxResults) const;
+
 	// Signals
 	SignalWrapper<BookmarkTree, void(BookmarkItem &bookmarkItem, size_t index)>
 		bookmarkItemAddedSignal;
@@ -51,9 +61,14 @@ private:
 	static inline const TCHAR *OTHER_FOLDER_GUID = _T("00000000-0000-0000-0000-000000000004");
 
 	void OnBookmarkItemUpdated(BookmarkItem &bookmarkItem, BookmarkItem::PropertyType propertyType);
+	void IndexItemRecursive(BookmarkItem *bookmarkItem);
+	void UnindexItemRecursive(BookmarkItem *bookmarkItem);
 
 	BookmarkItem m_root;
 	BookmarkItem *m_bookmarksToolbar;
 	BookmarkItem *m_bookmarksMenu;
 	BookmarkItem *m_otherBookmarks;
+
+	std::unordered_map<std::wstring, BookmarkItem *> m_itemsById;
+	BookmarkSearchIndex m_searchIndex;
 };
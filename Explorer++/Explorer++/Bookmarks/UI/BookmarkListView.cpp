@@ -19,6 +19,7 @@
 #include "../Helper/HeaderHelper.h"
 #include "../Helper/ListViewHelper.h"
 #include "../Helper/MenuHelper.h"
+#include "../Helper/ScopedRedrawDisabler.h"
 #include "../Helper/WindowHelper.h"
 #include <boost/range/adaptor/filtered.hpp>
 #include <boost/range/adaptor/indexed.hpp>
@@ -254,7 +255,15 @@ void BookmarkListView::NavigateToBookmarkFolder(BookmarkItem *bookmarkFolder,
 	DCHECK(bookmarkFolder->IsFolder());
 
 	m_currentBookmarkFolder = bookmarkFolder;
+	m_showingSearchResults = false;
 
+	InsertFolderItems(bookmarkFolder);
+
+	m_navigationCompletedSignal(bookmarkFolder, entry);
+}
+
+void BookmarkListView::InsertFolderItems(BookmarkItem *bookmarkFolder)
+{
 	ListView_DeleteAllItems(m_hListView);
 
 	int position = 0;
@@ -265,8 +274,38 @@ void BookmarkListView::NavigateToBookmarkFolder(BookmarkItem *bookmarkFolder,
 
 		position++;
 	}
+}
 
-	m_navigationCompletedSignal(bookmarkFolder, entry);
+void BookmarkListView::ShowSearchResults(const RawBookmarkItems &searchResults)
+{
+	ScopedRedrawDisabler redrawDisabler(m_hListView);
+
+	m_showingSearchResults = true;
+
+	ListView_DeleteAllItems(m_hListView);
+
+	int position = 0;
+
+	for (auto *bookmarkItem : searchResults)
+	{
+		InsertBookmarkItemIntoListView(bookmarkItem, position);
+
+		position++;
+	}
+}
+
+void BookmarkListView::ClearSearchResults()
+{
+	if (!m_showingSearchResults)
+	{
+		return;
+	}
+
+	ScopedRedrawDisabler redrawDisabler(m_hListView);
+
+	m_showingSearchResults = false;
+
+	InsertFolderItems(m_currentBookmarkFolder);
 }
 
 boost::signals2::connection BookmarkListView::AddNavigationCompletedObserver(
@@ -998,7 +1037,7 @@ void BookmarkListView::ToggleColumn(BookmarkHelper::ColumnType columnType)
 
 void BookmarkListView::OnBookmarkItemAdded(BookmarkItem &bookmarkItem, size_t index)
 {
-	if (bookmarkItem.GetParent() == m_currentBookmarkFolder)
+	if (!m_showingSearchResults && bookmarkItem.GetParent() == m_currentBookmarkFolder)
 	{
 		InsertBookmarkItemIntoListView(&bookmarkItem, static_cast<int>(index));
 	}
@@ -1007,12 +1046,18 @@ void BookmarkListView::OnBookmarkItemAdded(BookmarkItem &bookmarkItem, size_t in
 void BookmarkListView::OnBookmarkItemUpdated(BookmarkItem &bookmarkItem,
 	BookmarkItem::PropertyType propertyType)
 {
-	if (bookmarkItem.GetParent() != m_currentBookmarkFolder)
+	if (!m_showingSearchResults && bookmarkItem.GetParent() != m_currentBookmarkFolder)
 	{
 		return;
 	}
 
 	auto index = GetBookmarkItemIndex(&bookmarkItem);
+
+	if (m_showingSearchResults && !index)
+	{
+		return;
+	}
+
 	CHECK(index);
 
 	BookmarkHelper::ColumnType columnType = MapPropertyTypeToColumnType(propertyType);
@@ -1033,6 +1078,12 @@ void BookmarkListView::OnBookmarkItemMoved(BookmarkItem *bookmarkItem,
 {
 	UNREFERENCED_PARAMETER(oldIndex);
 
+	// Search results aren't tied to a particular folder, so moving an item has no effect on them.
+	if (m_showingSearchResults)
+	{
+		return;
+	}
+
 	if (oldParent == m_currentBookmarkFolder)
 	{
 		RemoveBookmarkItem(bookmarkItem);
@@ -1046,6 +1097,21 @@ void BookmarkListView::OnBookmarkItemMoved(BookmarkItem *bookmarkItem,
 
 void BookmarkListView::OnBookmarkItemPreRemoval(BookmarkItem &bookmarkItem)
 {
+	if (m_showingSearchResults)
+	{
+		// Any of the descendants of the item might also be shown in the search results.
+		bookmarkItem.VisitRecursively(
+			[this](BookmarkItem *currentItem)
+			{
+				if (auto index = GetBookmarkItemIndex(currentItem))
+				{
+					ListView_DeleteItem(m_hListView, *index);
+				}
+			});
+
+		return;
+	}
+
 	if (bookmarkItem.GetParent() == m_currentBookmarkFolder)
 	{
 		RemoveBookmarkItem(&bookmarkItem);
@@ -1077,19 +1143,14 @@ std::optional<int> BookmarkListView::GetBookmarkItemIndex(const BookmarkItem *bo
 
 std::optional<int> BookmarkListView::GetBookmarkItemIndexUsingGuid(std::wstring_view guid) const
 {
-	int numItems = ListView_GetItemCount(m_hListView);
+	const BookmarkItem *bookmarkItem = m_bookmarkTree->GetBookmarkItemById(guid);
 
-	for (int i = 0; i < numItems; i++)
+	if (!bookmarkItem)
 	{
-		const BookmarkItem *bookmarkItem = GetBookmarkItemFromListView(i);
-
-		if (bookmarkItem->GetGUID() == guid)
-		{
-			return i;
-		}
+		return std::nullopt;
 	}
 
-	return std::nullopt;
+	return GetBookmarkItemIndex(bookmarkItem);
 }
 
 BookmarkHelper::ColumnType BookmarkListView::MapPropertyTypeToColumnType(
@@ -44,6 +44,11 @@ public:
 		const BookmarkNavigationCompletedSignal::slot_type &observer,
 		boost::signals2::connect_position position = boost::signals2::at_back) override;
 
+	// Replaces the contents of the listview with the specified items, which can come from any
+	// folder. The current folder is left unchanged, so that ClearSearchResults() can return to it.
+	void ShowSearchResults(const RawBookmarkItems &searchResults);
+	void ClearSearchResults();
+
 	std::optional<int> GetLastSelectedItemIndex() const;
 	RawBookmarkItems GetSelectedBookmarkItems();
 	void SelectItem(const BookmarkItem *bookmarkItem);
@@ -74,6 +79,7 @@ private:
 	static bool IsColumnActive(const Column &column);
 	std::optional<BookmarkHelper::ColumnType> GetColumnTypeByIndex(int index) const;
 
+	void InsertFolderItems(BookmarkItem *bookmarkFolder);
 	int InsertBookmarkItemIntoListView(BookmarkItem *bookmarkItem, int position);
 	void OnBookmarkIconAvailable(std::wstring_view guid, int iconIndex);
 	std::wstring GetBookmarkItemColumnInfo(const BookmarkItem *bookmarkItem,
@@ -141,6 +147,7 @@ private:
 	std::vector<Column> m_columns;
 
 	BookmarkItem *m_currentBookmarkFolder = nullptr;
+	bool m_showingSearchResults = false;
 	BookmarkHelper::ColumnType m_sortColumn;
 	bool m_sortAscending;
 	std::optional<BookmarkHelper::ColumnType> m_previousSortColumn;
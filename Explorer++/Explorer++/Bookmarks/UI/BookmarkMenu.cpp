@@ -30,6 +30,10 @@ LRESULT BookmarkMenu::ParentWindowSubclass(HWND hwnd, UINT msg, WPARAM wParam, L
 {
 	switch (msg)
 	{
+	case WM_INITMENUPOPUP:
+		OnInitMenuPopup(reinterpret_cast<HMENU>(wParam));
+		break;
+
 	case WM_MENURBUTTONUP:
 	{
 		POINT pt;
@@ -54,6 +58,16 @@ LRESULT BookmarkMenu::ParentWindowSubclass(HWND hwnd, UINT msg, WPARAM wParam, L
 	return DefSubclassProc(hwnd, msg, wParam, lParam);
 }
 
+void BookmarkMenu::OnInitMenuPopup(HMENU menu)
+{
+	if (!m_activeMenu)
+	{
+		return;
+	}
+
+	m_menuBuilder.BuildPendingSubmenu(m_parentWindow, menu, MAX_ID, *m_menuImages, *m_menuInfo);
+}
+
 void BookmarkMenu::OnMenuRightButtonUp(HMENU menu, int index, const POINT &pt)
 {
 	// The bookmark context menu can be shown on top of this menu, so the menu item that was
@@ -263,10 +277,12 @@ BOOL BookmarkMenu::ShowMenu(BookmarkItem *bookmarkItem, const POINT &pt,
 
 	m_activeMenu = menu.get();
 	m_menuInfo = &menuInfo;
+	m_menuImages = &menuImages;
 
 	UINT cmd = TrackPopupMenu(menu.get(), TPM_LEFTALIGN | TPM_RETURNCMD, pt.x, pt.y, 0,
 		m_parentWindow, nullptr);
 
+	m_menuImages = nullptr;
 	m_menuInfo = nullptr;
 	m_activeMenu = nullptr;
 	m_dropTarget = nullptr;
@@ -38,6 +38,7 @@ private:
 
 	LRESULT ParentWindowSubclass(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam);
 
+	void OnInitMenuPopup(HMENU menu);
 	void OnMenuRightButtonUp(HMENU menu, int index, const POINT &pt);
 	void OnMenuMiddleButtonUp(const POINT &pt, bool isCtrlKeyDown, bool isShiftKeyDown);
 
@@ -53,6 +54,7 @@ private:
 
 	HMENU m_activeMenu = nullptr;
 	BookmarkMenuBuilder::MenuInfo *m_menuInfo = nullptr;
+	std::vector<wil::unique_hbitmap> *m_menuImages = nullptr;
 	winrt::com_ptr<IDropTarget> m_dropTarget;
 
 	std::vector<std::unique_ptr<WindowSubclass>> m_windowSubclasses;
@@ -30,6 +30,36 @@ BOOL BookmarkMenuBuilder::BuildMenu(HWND parentWindow, HMENU menu, BookmarkItem
 	m_menuIdRange = menuIdRange;
 	m_idCounter = menuIdRange.startId;
 
+	return BuildMenuWithIcons(parentWindow, menu, bookmarkItem, startPosition, menuImages,
+		menuInfo, true, includePredicate);
+}
+
+bool BookmarkMenuBuilder::BuildPendingSubmenu(HWND parentWindow, HMENU subMenu, UINT endId,
+	std::vector<wil::unique_hbitmap> &menuImages, MenuInfo &menuInfo)
+{
+	auto itr = menuInfo.pendingSubmenus.find(subMenu);
+
+	if (itr == menuInfo.pendingSubmenus.end())
+	{
+		return false;
+	}
+
+	BookmarkItem *bookmarkFolder = itr->second;
+	menuInfo.pendingSubmenus.erase(itr);
+
+	m_menuIdRange = { menuInfo.nextMenuId, endId };
+	m_idCounter = menuInfo.nextMenuId;
+
+	BuildMenuWithIcons(parentWindow, subMenu, bookmarkFolder, 0, menuImages, menuInfo, false,
+		nullptr);
+
+	return true;
+}
+
+BOOL BookmarkMenuBuilder::BuildMenuWithIcons(HWND parentWindow, HMENU menu,
+	BookmarkItem *bookmarkItem, int startPosition, std::vector<wil::unique_hbitmap> &menuImages,
+	MenuInfo &menuInfo, bool applyIncludePredicate, IncludePredicate includePredicate)
+{
 	auto &dpiCompat = DpiCompatibility::GetInstance();
 	UINT dpi = dpiCompat.GetDpiForWindow(parentWindow);
 	int iconWidth = dpiCompat.GetSystemMetricsForDpi(SM_CXSMICON, dpi);
@@ -39,7 +69,7 @@ BOOL BookmarkMenuBuilder::BuildMenu(HWND parentWindow, HMENU menu, BookmarkItem
 		iconHeight);
 
 	BOOL res = BuildMenu(menu, bookmarkItem, startPosition, bookmarkIconManager, menuImages,
-		menuInfo, true, includePredicate);
+		menuInfo, applyIncludePredicate, includePredicate);
 	menuInfo.nextMenuId = m_idCounter;
 
 	return res;
@@ -159,9 +189,9 @@ BOOL BookmarkMenuBuilder::AddBookmarkFolderToMenu(HMENU menu, BookmarkItem *book
 	AddIconToMenuItem(menu, position, bookmarkItem, bookmarkIconManager, menuImages);
 
 	menuInfo.itemIdMap.insert({ id, { bookmarkItem, MenuItemType::BookmarkItem } });
+	menuInfo.pendingSubmenus.insert({ subMenu, bookmarkItem });
 
-	return BuildMenu(subMenu, bookmarkItem, 0, bookmarkIconManager, menuImages, menuInfo, false,
-		nullptr);
+	return res;
 }
 
 BOOL BookmarkMenuBuilder::AddBookmarkToMenu(HMENU menu, BookmarkItem *bookmarkItem, int position,
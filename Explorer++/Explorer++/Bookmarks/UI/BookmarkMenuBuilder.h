@@ -56,6 +56,11 @@ public:
 		// Can be used to retrieve items, based on their ID.
 		ItemIdMap itemIdMap;
 
+		// The contents of each submenu are only built when the submenu is about to be shown (i.e.
+		// in response to WM_INITMENUPOPUP), since most submenus will never be opened. This maps
+		// each submenu that hasn't been built yet to its associated folder.
+		std::unordered_map<HMENU, BookmarkItem *> pendingSubmenus;
+
 		UINT nextMenuId;
 	};
 
@@ -67,7 +72,16 @@ public:
 		std::vector<wil::unique_hbitmap> &menuImages, MenuInfo &menuInfo,
 		IncludePredicate includePredicate = nullptr);
 
+	// If the specified submenu is one of the pending submenus in menuInfo, builds its contents,
+	// allocating IDs from menuInfo.nextMenuId up to (but not including) endId. Returns false if the
+	// submenu isn't pending.
+	bool BuildPendingSubmenu(HWND parentWindow, HMENU subMenu, UINT endId,
+		std::vector<wil::unique_hbitmap> &menuImages, MenuInfo &menuInfo);
+
 private:
+	BOOL BuildMenuWithIcons(HWND parentWindow, HMENU menu, BookmarkItem *bookmarkItem,
+		int startPosition, std::vector<wil::unique_hbitmap> &menuImages, MenuInfo &menuInfo,
+		bool applyIncludePredicate, IncludePredicate includePredicate);
 	BOOL BuildMenu(HMENU menu, BookmarkItem *bookmarkItem, int startPosition,
 		BookmarkIconManager &bookmarkIconManager, std::vector<wil::unique_hbitmap> &menuImages,
 		MenuInfo &menuInfo, bool applyIncludePredicate, IncludePredicate includePredicate);
@@ -33,6 +33,8 @@ BookmarksMainMenu::BookmarksMainMenu(App *app, BrowserWindow *browserWindow,
 {
 	m_connections.push_back(coreInterface->AddMainMenuPreShowObserver(
 		std::bind_front(&BookmarksMainMenu::OnMainMenuPreShow, this)));
+	m_connections.push_back(coreInterface->AddMainMenuSubMenuPreShowObserver(
+		std::bind_front(&BookmarksMainMenu::OnMainMenuSubMenuPreShow, this)));
 	m_connections.push_back(coreInterface->AddGetMenuItemHelperTextObserver(
 		std::bind_front(&BookmarksMainMenu::MaybeGetMenuItemHelperText, this)));
 	m_connections.push_back(coreInterface->AddMainMenuItemMiddleClickedObserver(
@@ -68,6 +70,12 @@ void BookmarksMainMenu::OnMainMenuPreShow(HMENU mainMenu)
 	m_menuInfo = menuInfo;
 }
 
+void BookmarksMainMenu::OnMainMenuSubMenuPreShow(HMENU subMenu)
+{
+	m_menuBuilder.BuildPendingSubmenu(m_coreInterface->GetMainWindow(), subMenu,
+		m_menuIdRange.endId, m_menuImages, m_menuInfo);
+}
+
 wil::unique_hmenu BookmarksMainMenu::BuildMainBookmarksMenu(
 	std::vector<wil::unique_hbitmap> &menuImages, BookmarkMenuBuilder::MenuInfo &menuInfo)
 {
@@ -94,10 +102,16 @@ wil::unique_hmenu BookmarksMainMenu::BuildMainBookmarksMenu(
 	ResourceHelper::SetMenuItemImage(menu.get(), IDM_BOOKMARKS_MANAGEBOOKMARKS,
 		m_iconResourceLoader, Icon::Bookmarks, dpi, menuImages);
 
+	// It's not possible to host an edit control directly within a menu, so this item opens the
+	// manage bookmarks dialog, with the search field focused.
+	std::wstring searchBookmarksText = ResourceHelper::LoadString(
+		m_coreInterface->GetResourceInstance(), IDS_MANAGE_BOOKMARKS_DEFAULT_SEARCH_TEXT);
+	MenuHelper::AddStringItem(menu.get(), IDM_BOOKMARKS_SEARCH_BOOKMARKS, searchBookmarksText, 3,
+		TRUE);
+
 	AddBookmarkItemsToMenu(menu.get(), m_menuIdRange, GetMenuItemCount(menu.get()), menuImages,
 		menuInfo);
-	AddOtherBookmarksToMenu(menu.get(), { menuInfo.nextMenuId, m_menuIdRange.endId },
-		GetMenuItemCount(menu.get()), menuImages, menuInfo);
+	AddOtherBookmarksToMenu(menu.get(), GetMenuItemCount(menu.get()), menuInfo);
 
 	UpdateMenuAcceleratorStrings(menu.get(), m_app->GetAcceleratorManager());
 
@@ -121,9 +135,8 @@ void BookmarksMainMenu::AddBookmarkItemsToMenu(HMENU menu,
 		menuIdRange, position, menuImages, menuInfo);
 }
 
-void BookmarksMainMenu::AddOtherBookmarksToMenu(HMENU menu,
-	const BookmarkMenuBuilder::MenuIdRange &menuIdRange, int position,
-	std::vector<wil::unique_hbitmap> &menuImages, BookmarkMenuBuilder::MenuInfo &menuInfo)
+void BookmarksMainMenu::AddOtherBookmarksToMenu(HMENU menu, int position,
+	BookmarkMenuBuilder::MenuInfo &menuInfo)
 {
 	BookmarkItem *otherBookmarksFolder = m_bookmarkTree->GetOtherBookmarksFolder();
 
@@ -135,9 +148,10 @@ void BookmarksMainMenu::AddOtherBookmarksToMenu(HMENU menu,
 	MenuHelper::AddSeparator(menu, position++, TRUE);
 
 	// Note that as DestroyMenu is recursive, this menu will be destroyed when its parent menu is.
+	// As with the other bookmark folders, the contents of the menu will only be built when it's
+	// opened.
 	wil::unique_hmenu subMenu(CreatePopupMenu());
-	m_menuBuilder.BuildMenu(m_coreInterface->GetMainWindow(), subMenu.get(), otherBookmarksFolder,
-		menuIdRange, 0, menuImages, menuInfo);
+	menuInfo.pendingSubmenus.insert({ subMenu.get(), otherBookmarksFolder });
 
 	auto otherBookmarksId = menuInfo.nextMenuId++;
 	MenuHelper::AddSubMenuItem(menu, otherBookmarksId, otherBookmarksFolder->GetName(),
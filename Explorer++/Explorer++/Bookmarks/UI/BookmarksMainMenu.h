@@ -30,13 +30,13 @@ public:
 
 private:
 	void OnMainMenuPreShow(HMENU mainMenu);
+	void OnMainMenuSubMenuPreShow(HMENU subMenu);
 	wil::unique_hmenu BuildMainBookmarksMenu(std::vector<wil::unique_hbitmap> &menuImages,
 		BookmarkMenuBuilder::MenuInfo &menuInfo);
 	void AddBookmarkItemsToMenu(HMENU menu, const BookmarkMenuBuilder::MenuIdRange &menuIdRange,
 		int position, std::vector<wil::unique_hbitmap> &menuImages,
 		BookmarkMenuBuilder::MenuInfo &menuInfo);
-	void AddOtherBookmarksToMenu(HMENU menu, const BookmarkMenuBuilder::MenuIdRange &menuIdRange,
-		int position, std::vector<wil::unique_hbitmap> &menuImages,
+	void AddOtherBookmarksToMenu(HMENU menu, int position,
 		BookmarkMenuBuilder::MenuInfo &menuInfo);
 	std::optional<std::wstring> MaybeGetMenuItemHelperText(HMENU menu, UINT id);
 	bool OnMenuItemMiddleClicked(const POINT &pt, bool isCtrlKeyDown, bool isShiftKeyDown);
@@ -18,6 +18,7 @@
 #include "../Helper/DpiCompatibility.h"
 #include "../Helper/ListViewHelper.h"
 #include "../Helper/MenuHelper.h"
+#include "../Helper/WindowHelper.h"
 #include "../Helper/WindowSubclass.h"
 #include <glog/logging.h>
 
@@ -52,6 +53,7 @@ ManageBookmarksDialog::~ManageBookmarksDialog()
 INT_PTR ManageBookmarksDialog::OnInitDialog()
 {
 	SetupToolbar();
+	SetupSearchEdit();
 	SetupTreeView();
 	SetupListView();
 
@@ -69,6 +71,7 @@ INT_PTR ManageBookmarksDialog::OnInitDialog()
 void ManageBookmarksDialog::AddDynamicControls()
 {
 	CreateToolbar();
+	CreateSearchEdit();
 }
 
 std::vector<ResizableDialogControl> ManageBookmarksDialog::GetResizableControls()
@@ -79,6 +82,7 @@ std::vector<ResizableDialogControl> ManageBookmarksDialog::GetResizableControls(
 	controls.emplace_back(GetDlgItem(m_hDlg, IDC_MANAGEBOOKMARKS_LISTVIEW), MovingType::None,
 		SizingType::Both);
 	controls.emplace_back(GetDlgItem(m_hDlg, IDOK), MovingType::Both, SizingType::None);
+	controls.emplace_back(m_searchEdit, MovingType::Horizontal, SizingType::None);
 	return controls;
 }
 
@@ -99,6 +103,23 @@ void ManageBookmarksDialog::CreateToolbar()
 			| TBSTYLE_EX_HIDECLIPPEDBUTTONS);
 }
 
+void ManageBookmarksDialog::CreateSearchEdit()
+{
+	RECT rcListView;
+	GetWindowRect(GetDlgItem(m_hDlg, IDC_MANAGEBOOKMARKS_LISTVIEW), &rcListView);
+	MapWindowPoints(HWND_DESKTOP, m_hDlg, reinterpret_cast<LPPOINT>(&rcListView), 2);
+
+	// The search field sits to the right of the toolbar, aligned with the right edge of the
+	// listview. The horizontal position needs to be set here, since it's used as the starting
+	// position when the dialog is resized. The vertical position is set in SetupToolbar(), once the
+	// height of the toolbar is known.
+	int width = GetRectWidth(&rcListView) / 3;
+	m_searchEdit = CreateWindowEx(WS_EX_CLIENTEDGE, WC_EDIT, L"",
+		WS_VISIBLE | WS_CHILD | WS_TABSTOP | ES_AUTOHSCROLL, rcListView.right - width, 0, width, 0,
+		m_hDlg, reinterpret_cast<HMENU>(IDC_MANAGEBOOKMARKS_SEARCH), GetModuleHandle(nullptr),
+		nullptr);
+}
+
 void ManageBookmarksDialog::SetupToolbar()
 {
 	m_windowSubclasses.push_back(std::make_unique<WindowSubclass>(m_toolbarParent,
@@ -164,17 +185,31 @@ void ManageBookmarksDialog::SetupToolbar()
 	GetWindowRect(GetDlgItem(m_hDlg, IDC_MANAGEBOOKMARKS_TREEVIEW), &rcTreeView);
 	MapWindowPoints(HWND_DESKTOP, m_hDlg, reinterpret_cast<LPPOINT>(&rcTreeView), 2);
 
-	RECT rcListView;
-	GetWindowRect(GetDlgItem(m_hDlg, IDC_MANAGEBOOKMARKS_LISTVIEW), &rcListView);
-	MapWindowPoints(HWND_DESKTOP, m_hDlg, reinterpret_cast<LPPOINT>(&rcListView), 2);
-
 	auto dwButtonSize = static_cast<DWORD>(SendMessage(m_hToolbar, TB_GETBUTTONSIZE, 0, 0));
 
-	SetWindowPos(m_toolbarParent, nullptr, rcTreeView.left,
-		(rcTreeView.top - HIWORD(dwButtonSize)) / 2, rcListView.right - rcTreeView.left,
-		HIWORD(dwButtonSize), 0);
-	SetWindowPos(m_hToolbar, nullptr, 0, 0, rcListView.right - rcTreeView.left,
+	RECT rcSearchEdit;
+	GetWindowRect(m_searchEdit, &rcSearchEdit);
+	MapWindowPoints(HWND_DESKTOP, m_hDlg, reinterpret_cast<LPPOINT>(&rcSearchEdit), 2);
+
+	int toolbarWidth = rcSearchEdit.left - rcTreeView.left;
+	int top = (rcTreeView.top - HIWORD(dwButtonSize)) / 2;
+
+	SetWindowPos(m_toolbarParent, nullptr, rcTreeView.left, top, toolbarWidth,
 		HIWORD(dwButtonSize), 0);
+	SetWindowPos(m_hToolbar, nullptr, 0, 0, toolbarWidth, HIWORD(dwButtonSize), 0);
+	SetWindowPos(m_searchEdit, m_toolbarParent, rcSearchEdit.left, top,
+		GetRectWidth(&rcSearchEdit), HIWORD(dwButtonSize), 0);
+}
+
+void ManageBookmarksDialog::SetupSearchEdit()
+{
+	// Controls created dynamically don't inherit the dialog font.
+	SendMessage(m_searchEdit, WM_SETFONT, SendMessage(m_hDlg, WM_GETFONT, 0, 0), FALSE);
+
+	std::wstring cueBannerText = ResourceHelper::LoadString(GetResourceInstance(),
+		IDS_MANAGE_BOOKMARKS_DEFAULT_SEARCH_TEXT);
+	SendMessage(m_searchEdit, EM_SETCUEBANNER, TRUE,
+		reinterpret_cast<LPARAM>(cueBannerText.c_str()));
 }
 
 void ManageBookmarksDialog::SetupTreeView()
@@ -269,6 +304,12 @@ INT_PTR ManageBookmarksDialog::OnCommand(WPARAM wParam, LPARAM lParam)
 {
 	UNREFERENCED_PARAMETER(lParam);
 
+	if (LOWORD(wParam) == IDC_MANAGEBOOKMARKS_SEARCH && HIWORD(wParam) == EN_CHANGE)
+	{
+		OnSearchTextChanged();
+		return 0;
+	}
+
 	if (HIWORD(wParam) == 0 || HIWORD(wParam) == 1)
 	{
 		return HandleMenuOrAccelerator(wParam);
@@ -737,6 +778,9 @@ void ManageBookmarksDialog::OnListViewNavigation(BookmarkItem *bookmarkFolder,
 	m_currentBookmarkFolder = bookmarkFolder;
 	m_bookmarkTreeView->SelectFolder(bookmarkFolder->GetGUID());
 
+	// Navigating replaces any search results, so the search text is no longer relevant.
+	SetWindowText(m_searchEdit, L"");
+
 	UpdateToolbarState();
 }
 
@@ -747,6 +791,20 @@ void ManageBookmarksDialog::UpdateToolbarState()
 		m_navigationController->CanGoForward());
 }
 
+void ManageBookmarksDialog::OnSearchTextChanged()
+{
+	std::wstring searchText = GetWindowString(m_searchEdit);
+
+	if (searchText.empty())
+	{
+		m_bookmarkListView->ClearSearchResults();
+		return;
+	}
+
+	m_bookmarkListView->ShowSearchResults(
+		m_bookmarkTree->SearchBookmarks(searchText, MAX_SEARCH_RESULTS));
+}
+
 void ManageBookmarksDialog::OnOk()
 {
 	DestroyWindow(m_hDlg);
@@ -74,13 +74,17 @@ private:
 	static const int TOOLBAR_ID_ORGANIZE = 10002;
 	static const int TOOLBAR_ID_VIEWS = 10003;
 
+	static constexpr size_t MAX_SEARCH_RESULTS = 500;
+
 	ManageBookmarksDialog &operator=(const ManageBookmarksDialog &mbd);
 
 	void AddDynamicControls() override;
 	std::vector<ResizableDialogControl> GetResizableControls() override;
 
 	void CreateToolbar();
+	void CreateSearchEdit();
 	void SetupToolbar();
+	void SetupSearchEdit();
 	void SetupTreeView();
 	void SetupListView();
 
@@ -91,6 +95,8 @@ private:
 
 	void UpdateToolbarState();
 
+	void OnSearchTextChanged();
+
 	LRESULT HandleMenuOrAccelerator(WPARAM wParam);
 
 	void OnTbnDropDown(NMTOOLBAR *nmtb);
@@ -119,6 +125,8 @@ private:
 	wil::unique_himagelist m_imageListToolbar;
 	IconImageListMapping m_imageListToolbarMappings;
 
+	HWND m_searchEdit;
+
 	BrowserWindow *m_browserWindow = nullptr;
 	CoreInterface *m_coreInterface = nullptr;
 	const IconResourceLoader *const m_iconResourceLoader;
@@ -91,7 +91,18 @@ const boost::bimap<ColumnType, std::wstring> COLUMN_TYPE_NAME_MAPPINGS = MakeBim
 	{ ColumnType::MediaPublisher, L"MediaPublisher" },
 	{ ColumnType::MediaWriter, L"MediaWriter" },
 	{ ColumnType::MediaYear, L"MediaYear" },
-	{ ColumnType::PrinterModel, L"PrinterModel" }
+	{ ColumnType::PrinterModel, L"PrinterModel" },
+	{ ColumnType::PluginColumn1, L"PluginColumn1" },
+	{ ColumnType::PluginColumn2, L"PluginColumn2" },
+	{ ColumnType::PluginColumn3, L"PluginColumn3" },
+	{ ColumnType::PluginColumn4, L"PluginColumn4" },
+	{ ColumnType::PluginColumn5, L"PluginColumn5" },
+	{ ColumnType::PluginColumn6, L"PluginColumn6" },
+	{ ColumnType::PluginColumn7, L"PluginColumn7" },
+	{ ColumnType::PluginColumn8, L"PluginColumn8" },
+	{ ColumnType::HashCrc32, L"HashCrc32" },
+	{ ColumnType::HashXxHash64, L"HashXxHash64" },
+	{ ColumnType::HashSha256, L"HashSha256" }
 });
 // clang-format on
 
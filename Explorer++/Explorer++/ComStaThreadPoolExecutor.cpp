@@ -4,6 +4,7 @@
 
 #include "stdafx.h"
 #include "ComStaThreadPoolExecutor.h"
+#include "../Helper/Tracing.h"
 
 ComStaThreadPoolExecutor::ComStaThreadPoolExecutor(int numThreads) :
 	concurrencpp::derivable_executor<ComStaThreadPoolExecutor>("ComStaThreadPoolExecutor")
@@ -41,6 +42,9 @@ void ComStaThreadPoolExecutor::enqueue(std::span<concurrencpp::task> tasks)
 		m_queue.emplace(std::move(task));
 	}
 
+	GetTraceRecorder().RecordCounter("executor", "ComStaQueueLength",
+		static_cast<int64_t>(m_queue.size()));
+
 	lock.unlock();
 
 	// Note that this will only wake a single thread, which is problematic if multiple tasks are
@@ -85,6 +89,8 @@ void ComStaThreadPoolExecutor::ThreadMain()
 {
 	auto comInitialization = wil::CoInitializeEx_failfast(COINIT_APARTMENTTHREADED);
 
+	GetTraceRecorder().SetCurrentThreadName("COM STA thread pool");
+
 	// This will force the system to create the message queue.
 	MSG msg;
 	PeekMessage(&msg, nullptr, WM_USER, WM_USER, PM_NOREMOVE);
@@ -148,6 +154,7 @@ bool ComStaThreadPoolExecutor::RunTask()
 
 	lock.unlock();
 
+	TRACE_SCOPE("executor", "ComStaRunTask");
 	task();
 
 	return true;
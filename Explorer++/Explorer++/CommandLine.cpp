@@ -36,6 +36,73 @@ bool lexical_cast(const std::string &input, std::wstring &output)
 
 }
 
+namespace
+{
+
+// Batch commands are run without creating a window, so these options are all specific to those
+// commands.
+void AddOutputOptions(CLI::App *command, BatchCommand &batchCommand)
+{
+	command
+		->add_option("--format", batchCommand.format,
+			"The output format. Defaults to text (or csv for the export command).")
+		->transform(CLI::CheckedTransformer(CLI::TransformPairs<ListingFormat>{
+			{ "text", ListingFormat::Text }, { "csv", ListingFormat::Csv },
+			{ "tsv", ListingFormat::Tsv }, { "json", ListingFormat::JsonLines },
+			{ "xml", ListingFormat::Xml } }));
+
+	command
+		->add_option("--threads", batchCommand.numThreads,
+			"The number of threads to use. Defaults to one per processor.")
+		->check(CLI::NonNegativeNumber);
+}
+
+void AddFilterOptions(CLI::App *command, BatchCommand &batchCommand)
+{
+	command->add_option("--pattern", batchCommand.pattern,
+		"Only include items whose names match this pattern");
+
+	command
+		->add_option("--match", batchCommand.matchType,
+			"How the pattern is matched. Multiple wildcard patterns can be separated by ':' "
+			"(e.g. \"*.h:*.cpp\").")
+		->transform(CLI::CheckedTransformer(CLI::TransformPairs<FileNameMatchType>{
+			{ "substring", FileNameMatchType::Substring },
+			{ "wildcard", FileNameMatchType::Wildcard }, { "regex", FileNameMatchType::Regex } }));
+
+	command->add_flag("--case-sensitive", batchCommand.caseSensitive,
+		"Match the pattern case-sensitively");
+
+	command->add_option("--type", batchCommand.itemTypes, "The types of items to include")
+		->transform(CLI::CheckedTransformer(CLI::TransformPairs<FileNameItemTypes>{
+			{ "all", FileNameItemTypes::All }, { "files", FileNameItemTypes::Files },
+			{ "folders", FileNameItemTypes::Folders } }));
+
+	command->add_option("--min-size", batchCommand.minSize,
+		"Only include files at least this size, in bytes");
+	command->add_option("--max-size", batchCommand.maxSize,
+		"Only include files at most this size, in bytes");
+}
+
+void AddSortOptions(CLI::App *command, BatchCommand &batchCommand)
+{
+	command->add_option("--sort", batchCommand.sortField, "The field to sort by")
+		->transform(CLI::CheckedTransformer(CLI::TransformPairs<BatchSortField>{
+			{ "name", BatchSortField::Name }, { "path", BatchSortField::Path },
+			{ "size", BatchSortField::Size }, { "modified", BatchSortField::Modified } }));
+
+	command->add_flag("--descending", batchCommand.sortDescending, "Sort in descending order");
+}
+
+CLI::CheckedTransformer MakeHashAlgorithmTransformer()
+{
+	return CLI::CheckedTransformer(CLI::TransformPairs<HashAlgorithm>{
+		{ "crc32", HashAlgorithm::Crc32 }, { "xxhash64", HashAlgorithm::XxHash64 },
+		{ "sha256", HashAlgorithm::Sha256 } });
+}
+
+}
+
 namespace CommandLine
 {
 
@@ -86,6 +153,9 @@ std::variant<Settings, ExitInfo> Parse(const std::wstring &commandLine)
 		settings.pasteSymLinksDestination);
 
 	app.add_flag("--enable-logging", settings.enableLogging, "Enable logging");
+	app.add_flag("--enable-tracing", settings.enableTracing,
+		"Start recording a performance trace. The trace can be saved by stopping the recording "
+		"from the Tools menu.");
 
 	std::map<std::string, Feature> featureMap;
 
@@ -127,6 +197,78 @@ std::variant<Settings, ExitInfo> Parse(const std::wstring &commandLine)
 		"Directories to open. Paths with spaces should be enclosed in double quotes (e.g. "
 		R"("C:\path with spaces").)");
 
+	// Each of the batch commands is run instead of opening a window, so only one can be specified.
+	// The commands are grouped under a single "batch" command, so that the command names don't
+	// prevent folders with the same names (e.g. "list" or "compare") from being opened.
+	BatchCommand batchCommand;
+	std::wstring singleFolder;
+	std::wstring rightFolder;
+
+	auto batchCommands =
+		app.add_subcommand("batch", "Run one of the batch commands, without opening a window");
+	batchCommands->require_subcommand(1);
+
+	auto listCommand = batchCommands->add_subcommand("list", "List the contents of folders");
+	listCommand->add_option("folders", batchCommand.paths, "The folders to list")->required();
+	listCommand->add_flag("-r,--recursive", batchCommand.recursive,
+		"Include the contents of subfolders");
+	AddFilterOptions(listCommand, batchCommand);
+	AddSortOptions(listCommand, batchCommand);
+	AddOutputOptions(listCommand, batchCommand);
+
+	auto searchCommand = batchCommands->add_subcommand("search",
+		"Search a folder and its subfolders for matching items");
+	searchCommand->add_option("folder", singleFolder, "The folder to search")->required();
+	searchCommand->add_option("pattern", batchCommand.pattern, "The pattern to search for")
+		->required();
+	AddFilterOptions(searchCommand, batchCommand);
+	AddSortOptions(searchCommand, batchCommand);
+	AddOutputOptions(searchCommand, batchCommand);
+
+	auto sizeCommand = batchCommands->add_subcommand("size",
+		"Calculate the total size of files and folders, along with the number of items they "
+		"contain");
+	sizeCommand->add_option("paths", batchCommand.paths, "The files and folders to measure")
+		->required();
+	AddOutputOptions(sizeCommand, batchCommand);
+
+	auto hashCommand = batchCommands->add_subcommand("hash", "Calculate the hashes of files");
+	hashCommand->add_option("paths", batchCommand.paths,
+		"The files to hash. For a folder, each file within it is hashed.")
+		->required();
+	hashCommand->add_option("--algorithm", batchCommand.hashAlgorithm, "The hash algorithm")
+		->transform(MakeHashAlgorithmTransformer());
+	hashCommand->add_flag("-r,--recursive", batchCommand.recursive,
+		"Include files within subfolders");
+	AddFilterOptions(hashCommand, batchCommand);
+	AddOutputOptions(hashCommand, batchCommand);
+
+	auto exportCommand = batchCommands->add_subcommand("export",
+		"Export a folder listing, in the same form as the directory listing export");
+	exportCommand->add_option("folder", singleFolder, "The folder to export")->required();
+	exportCommand->add_flag("-r,--recursive", batchCommand.recursive,
+		"Include the contents of subfolders");
+	AddOutputOptions(exportCommand, batchCommand);
+
+	auto compareCommand = batchCommands->add_subcommand("compare",
+		"Compare two folders. Exits with a code of " + std::to_string(EXIT_CODE_DIFFERENCES_FOUND)
+			+ " if there are differences.");
+	compareCommand->add_option("left", singleFolder, "The first folder")->required();
+	compareCommand->add_option("right", rightFolder, "The second folder")->required();
+	compareCommand
+		->add_option("--content", batchCommand.compareContents,
+			"Compare the contents of files that have the same size, using this hash algorithm")
+		->transform(MakeHashAlgorithmTransformer());
+	compareCommand->add_flag("--differences-only", batchCommand.differencesOnly,
+		"Only include items that differ");
+	AddOutputOptions(compareCommand, batchCommand);
+
+	const std::vector<std::pair<CLI::App *, BatchCommandType>> batchCommandTypes = {
+		{ listCommand, BatchCommandType::List }, { searchCommand, BatchCommandType::Search },
+		{ sizeCommand, BatchCommandType::Size }, { hashCommand, BatchCommandType::Hash },
+		{ exportCommand, BatchCommandType::Export }, { compareCommand, BatchCommandType::Compare }
+	};
+
 	auto splitResult = CommandLineSplitter::Split(wstrToUtf8Str(commandLine));
 
 	if (!splitResult.succeeded)
@@ -155,6 +297,28 @@ std::variant<Settings, ExitInfo> Parse(const std::wstring &commandLine)
 		return ExitInfo{ app.exit(e) };
 	}
 
+	for (const auto &[command, type] : batchCommandTypes)
+	{
+		if (!command->parsed())
+		{
+			continue;
+		}
+
+		batchCommand.type = type;
+
+		if (!singleFolder.empty())
+		{
+			batchCommand.paths.push_back(singleFolder);
+		}
+
+		if (!rightFolder.empty())
+		{
+			batchCommand.paths.push_back(rightFolder);
+		}
+
+		settings.batchCommand = batchCommand;
+	}
+
 	return settings;
 }
 
@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include "BatchCommand.h"
 #include "CrashHandlerHelper.h"
 #include "Feature.h"
 #include "ShellChangeNotificationType.h"
@@ -17,6 +18,7 @@ namespace CommandLine
 struct Settings
 {
 	bool enableLogging = false;
+	bool enableTracing = false;
 	std::set<Feature> featuresToEnable;
 	std::optional<ShellChangeNotificationType> shellChangeNotificationType;
 	std::wstring language;
@@ -29,6 +31,9 @@ struct Settings
 	std::optional<std::wstring> pasteSymLinksDestination;
 	std::vector<std::wstring> filesToSelect;
 	std::vector<std::wstring> directories;
+
+	// If set, this command is run and the application then exits, without creating a window.
+	std::optional<BatchCommand> batchCommand;
 };
 
 struct ExitInfo
@@ -0,0 +1,635 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "stdafx.h"
+#include "CompareFoldersDialog.h"
+#include "App.h"
+#include "Config.h"
+#include "FileHashService.h"
+#include "MainResource.h"
+#include "ResourceLoader.h"
+#include "RuntimeHelper.h"
+#include "../Helper/FileOperations.h"
+#include "../Helper/Helper.h"
+#include "../Helper/StringHelper.h"
+#include "../Helper/WindowHelper.h"
+#include <fmt/format.h>
+#include <fmt/xchar.h>
+#include <glog/logging.h>
+#include <algorithm>
+
+CompareFoldersDialog *CompareFoldersDialog::Create(App *app, HWND parent,
+	const std::wstring &leftPath, const std::wstring &rightPath)
+{
+	return new CompareFoldersDialog(app, parent, leftPath, rightPath);
+}
+
+CompareFoldersDialog::CompareFoldersDialog(App *app, HWND parent, const std::wstring &leftPath,
+	const std::wstring &rightPath) :
+	ThemedDialog(app->GetResourceInstance(), IDD_COMPARE_FOLDERS, parent,
+		BaseDialog::DialogSizingType::Both, app->GetThemeManager()),
+	m_app(app),
+	m_initialLeftPath(leftPath),
+	m_initialRightPath(rightPath),
+	m_persistentSettings(&CompareFoldersDialogPersistentSettings::GetInstance()),
+	m_weakPtrFactory(this)
+{
+}
+
+INT_PTR CompareFoldersDialog::OnInitDialog()
+{
+	SetDlgItemText(m_hDlg, IDC_COMPARE_FOLDERS_LEFT, m_initialLeftPath.c_str());
+	SetDlgItemText(m_hDlg, IDC_COMPARE_FOLDERS_RIGHT, m_initialRightPath.c_str());
+
+	SetupListView();
+	SetupComboBoxes();
+	UpdateSyncControls();
+
+	m_persistentSettings->RestoreDialogPosition(m_hDlg, true);
+
+	HWND focusControl = m_initialRightPath.empty()
+		? GetDlgItem(m_hDlg, IDC_COMPARE_FOLDERS_RIGHT)
+		: GetDlgItem(m_hDlg, IDC_COMPARE_FOLDERS_COMPARE);
+	SendMessage(m_hDlg, WM_NEXTDLGCTL, reinterpret_cast<WPARAM>(focusControl), true);
+
+	return FALSE;
+}
+
+wil::unique_hicon CompareFoldersDialog::GetDialogIcon(int iconWidth, int iconHeight) const
+{
+	UNREFERENCED_PARAMETER(iconWidth);
+	UNREFERENCED_PARAMETER(iconHeight);
+
+	return wil::unique_hicon(LoadIcon(GetModuleHandle(nullptr), MAKEINTRESOURCE(IDI_MAIN)));
+}
+
+std::vector<ResizableDialogControl> CompareFoldersDialog::GetResizableControls()
+{
+	std::vector<ResizableDialogControl> controls;
+	controls.emplace_back(GetDlgItem(m_hDlg, IDC_COMPARE_FOLDERS_LEFT), MovingType::None,
+		SizingType::Horizontal);
+	controls.emplace_back(GetDlgItem(m_hDlg, IDC_COMPARE_FOLDERS_RIGHT), MovingType::None,
+		SizingType::Horizontal);
+	controls.emplace_back(GetDlgItem(m_hDlg, IDC_COMPARE_FOLDERS_COMPARE),
+		MovingType::Horizontal, SizingType::None);
+	controls.emplace_back(GetDlgItem(m_hDlg, IDC_COMPARE_FOLDERS_FILTER_LABEL),
+		MovingType::Horizontal, SizingType::None);
+	controls.emplace_back(GetDlgItem(m_hDlg, IDC_COMPARE_FOLDERS_FILTER), MovingType::Horizontal,
+		SizingType::None);
+	controls.emplace_back(GetDlgItem(m_hDlg, IDC_COMPARE_FOLDERS_LIST), MovingType::None,
+		SizingType::Both);
+	controls.emplace_back(GetDlgItem(m_hDlg, IDC_COMPARE_FOLDERS_STATUS), MovingType::Vertical,
+		SizingType::Horizontal);
+	controls.emplace_back(GetDlgItem(m_hDlg, IDC_COMPARE_FOLDERS_SYNC_LABEL),
+		MovingType::Vertical, SizingType::None);
+	controls.emplace_back(GetDlgItem(m_hDlg, IDC_COMPARE_FOLDERS_SYNC_DIRECTION),
+		MovingType::Vertical, SizingType::None);
+	controls.emplace_back(GetDlgItem(m_hDlg, IDC_COMPARE_FOLDERS_DELETE_EXTRA),
+		MovingType::Vertical, SizingType::None);
+	controls.emplace_back(GetDlgItem(m_hDlg, IDC_COMPARE_FOLDERS_PREVIEW), MovingType::Vertical,
+		SizingType::None);
+	controls.emplace_back(GetDlgItem(m_hDlg, IDC_COMPARE_FOLDERS_SYNC), MovingType::Vertical,
+		SizingType::None);
+	controls.emplace_back(GetDlgItem(m_hDlg, IDCANCEL), MovingType::Both, SizingType::None);
+	return controls;
+}
+
+void CompareFoldersDialog::SetupListView()
+{
+	HWND listView = GetDlgItem(m_hDlg, IDC_COMPARE_FOLDERS_LIST);
+	ListView_SetExtendedListViewStyle(listView,
+		LVS_EX_LABELTIP | LVS_EX_FULLROWSELECT | LVS_EX_DOUBLEBUFFER);
+
+	int index = 0;
+
+	for (auto column : COLUMNS)
+	{
+		InsertColumn(column, index);
+		index++;
+	}
+}
+
+void CompareFoldersDialog::InsertColumn(const Column &column, int index)
+{
+	std::wstring columnText = GetColumnText(column.type);
+
+	RECT listViewRect;
+	HWND listView = GetDlgItem(m_hDlg, IDC_COMPARE_FOLDERS_LIST);
+	[[maybe_unused]] auto res = GetClientRect(listView, &listViewRect);
+	assert(res);
+
+	LVCOLUMN lvColumn = {};
+	lvColumn.mask = LVCF_TEXT | LVCF_WIDTH;
+	lvColumn.pszText = columnText.data();
+	lvColumn.cx = static_cast<int>(column.percentageWidth * GetRectWidth(&listViewRect));
+	[[maybe_unused]] int insertedIndex = ListView_InsertColumn(listView, index, &lvColumn);
+	assert(insertedIndex == index);
+}
+
+std::wstring CompareFoldersDialog::GetColumnText(ColumnType columnType)
+{
+	UINT stringId;
+
+	switch (columnType)
+	{
+	case CompareFoldersDialog::ColumnType::Path:
+		stringId = IDS_COMPARE_FOLDERS_COLUMN_PATH;
+		break;
+
+	case CompareFoldersDialog::ColumnType::Status:
+		stringId = IDS_COMPARE_FOLDERS_COLUMN_STATUS;
+		break;
+
+	case CompareFoldersDialog::ColumnType::LeftSize:
+		stringId = IDS_COMPARE_FOLDERS_COLUMN_LEFT_SIZE;
+		break;
+
+	case CompareFoldersDialog::ColumnType::LeftModified:
+		stringId = IDS_COMPARE_FOLDERS_COLUMN_LEFT_MODIFIED;
+		break;
+
+	case CompareFoldersDialog::ColumnType::RightSize:
+		stringId = IDS_COMPARE_FOLDERS_COLUMN_RIGHT_SIZE;
+		break;
+
+	case CompareFoldersDialog::ColumnType::RightModified:
+		stringId = IDS_COMPARE_FOLDERS_COLUMN_RIGHT_MODIFIED;
+		break;
+
+	default:
+		LOG(FATAL) << "Compare folders column type not found";
+		__assume(0);
+	}
+
+	return m_app->GetResourceLoader()->LoadString(stringId);
+}
+
+void CompareFoldersDialog::SetupComboBoxes()
+{
+	HWND filterComboBox = GetDlgItem(m_hDlg, IDC_COMPARE_FOLDERS_FILTER);
+
+	for (UINT stringId : { IDS_COMPARE_FOLDERS_FILTER_ALL, IDS_COMPARE_FOLDERS_FILTER_DIFFERENCES,
+			 IDS_COMPARE_FOLDERS_FILTER_LEFT_ONLY, IDS_COMPARE_FOLDERS_FILTER_RIGHT_ONLY })
+	{
+		ComboBox_AddString(filterComboBox,
+			m_app->GetResourceLoader()->LoadString(stringId).c_str());
+	}
+
+	ComboBox_SetCurSel(filterComboBox, static_cast<int>(Filter::Differences));
+
+	HWND directionComboBox = GetDlgItem(m_hDlg, IDC_COMPARE_FOLDERS_SYNC_DIRECTION);
+
+	// The strings are added in the same order as the SyncDirection values, so that the selected
+	// index can be converted directly.
+	for (UINT stringId : { IDS_COMPARE_FOLDERS_SYNC_LEFT_TO_RIGHT,
+			 IDS_COMPARE_FOLDERS_SYNC_RIGHT_TO_LEFT, IDS_COMPARE_FOLDERS_SYNC_TWO_WAY })
+	{
+		ComboBox_AddString(directionComboBox,
+			m_app->GetResourceLoader()->LoadString(stringId).c_str());
+	}
+
+	ComboBox_SetCurSel(directionComboBox, static_cast<int>(SyncDirection::LeftToRight));
+}
+
+void CompareFoldersDialog::OnCompare()
+{
+	StartComparison(GetWindowString(GetDlgItem(m_hDlg, IDC_COMPARE_FOLDERS_LEFT)),
+		GetWindowString(GetDlgItem(m_hDlg, IDC_COMPARE_FOLDERS_RIGHT)));
+}
+
+void CompareFoldersDialog::StartComparison(const std::wstring &leftPath,
+	const std::wstring &rightPath)
+{
+	FolderComparisonOptions options;
+	options.numThreads = m_app->GetFileHashService()->GetNumThreads();
+	options.cache = m_app->GetFileHashService()->GetCache();
+
+	if (IsDlgButtonChecked(m_hDlg, IDC_COMPARE_FOLDERS_COMPARE_CONTENTS) == BST_CHECKED)
+	{
+		options.contentHashAlgorithm = HashAlgorithm::XxHash64;
+	}
+
+	// Starting a new comparison cancels any comparison that's still running.
+	m_stopSource = std::make_unique<ScopedStopSource>();
+	m_comparing = true;
+
+	m_entries.clear();
+	m_visibleEntries.clear();
+	ListView_SetItemCountEx(GetDlgItem(m_hDlg, IDC_COMPARE_FOLDERS_LIST), 0, 0);
+
+	m_comparedLeftPath = leftPath;
+	m_comparedRightPath = rightPath;
+
+	SetStatusText(m_app->GetResourceLoader()->LoadString(IDS_COMPARE_FOLDERS_COMPARING));
+	UpdateSyncControls();
+
+	CompareFoldersAsync(m_weakPtrFactory.GetWeakPtr(), leftPath, rightPath, options,
+		m_app->GetRuntime(), m_stopSource->GetToken());
+}
+
+concurrencpp::null_result CompareFoldersDialog::CompareFoldersAsync(
+	WeakPtr<CompareFoldersDialog> self, std::wstring leftPath, std::wstring rightPath,
+	FolderComparisonOptions options, Runtime *runtime, std::stop_token stopToken)
+{
+	co_await ResumeOnBackgroundJobThread(runtime);
+
+	auto entries = CompareFolders(leftPath, rightPath, options, stopToken);
+
+	co_await ResumeOnUiThread(runtime);
+
+	if (stopToken.stop_requested() || !self)
+	{
+		co_return;
+	}
+
+	self->OnComparisonFinished(std::move(entries));
+}
+
+void CompareFoldersDialog::OnComparisonFinished(
+	std::optional<std::vector<FolderComparisonEntry>> entries)
+{
+	m_comparing = false;
+
+	if (!entries)
+	{
+		SetStatusText(m_app->GetResourceLoader()->LoadString(IDS_COMPARE_FOLDERS_FAILED));
+		UpdateSyncControls();
+		return;
+	}
+
+	m_entries = std::move(*entries);
+
+	auto numDifferences = std::ranges::count_if(m_entries,
+		[](const auto &entry) { return IsFolderComparisonDifference(entry.status); });
+	SetStatusText(fmt::format(
+		fmt::runtime(m_app->GetResourceLoader()->LoadString(IDS_COMPARE_FOLDERS_FINISHED)),
+		fmt::arg(L"num_items", m_entries.size()), fmt::arg(L"num_differences", numDifferences)));
+
+	ApplyFilter();
+	UpdateSyncControls();
+}
+
+void CompareFoldersDialog::ApplyFilter()
+{
+	auto filter = static_cast<Filter>(
+		ComboBox_GetCurSel(GetDlgItem(m_hDlg, IDC_COMPARE_FOLDERS_FILTER)));
+
+	m_visibleEntries.clear();
+
+	for (size_t i = 0; i < m_entries.size(); i++)
+	{
+		if (FilterEntry(m_entries[i], filter))
+		{
+			m_visibleEntries.push_back(i);
+		}
+	}
+
+	// The listview is virtual, so only the number of items needs to be set. The text for each item
+	// is retrieved as it's displayed.
+	HWND listView = GetDlgItem(m_hDlg, IDC_COMPARE_FOLDERS_LIST);
+	ListView_SetItemCountEx(listView, static_cast<int>(m_visibleEntries.size()), 0);
+	InvalidateRect(listView, nullptr, true);
+}
+
+bool CompareFoldersDialog::FilterEntry(const FolderComparisonEntry &entry, Filter filter)
+{
+	switch (filter)
+	{
+	case Filter::All:
+		return true;
+
+	case Filter::Differences:
+		return IsFolderComparisonDifference(entry.status);
+
+	case Filter::LeftOnly:
+		return entry.status == FolderComparisonStatus::LeftOnly;
+
+	case Filter::RightOnly:
+		return entry.status == FolderComparisonStatus::RightOnly;
+
+	default:
+		LOG(FATAL) << "Compare folders filter not found";
+		__assume(0);
+	}
+}
+
+void CompareFoldersDialog::SetStatusText(const std::wstring &text)
+{
+	SetDlgItemText(m_hDlg, IDC_COMPARE_FOLDERS_STATUS, text.c_str());
+}
+
+void CompareFoldersDialog::UpdateSyncControls()
+{
+	bool canSync = !m_comparing && !m_entries.empty();
+	EnableWindow(GetDlgItem(m_hDlg, IDC_COMPARE_FOLDERS_PREVIEW), canSync);
+	EnableWindow(GetDlgItem(m_hDlg, IDC_COMPARE_FOLDERS_SYNC), canSync);
+
+	auto direction = static_cast<SyncDirection>(
+		ComboBox_GetCurSel(GetDlgItem(m_hDlg, IDC_COMPARE_FOLDERS_SYNC_DIRECTION)));
+
+	// Extra items are always copied in a two-way sync, so there's nothing to delete.
+	EnableWindow(GetDlgItem(m_hDlg, IDC_COMPARE_FOLDERS_DELETE_EXTRA),
+		direction != SyncDirection::TwoWay);
+}
+
+std::optional<std::vector<SyncAction>> CompareFoldersDialog::BuildPlan()
+{
+	SyncOptions options;
+	options.direction = static_cast<SyncDirection>(
+		ComboBox_GetCurSel(GetDlgItem(m_hDlg, IDC_COMPARE_FOLDERS_SYNC_DIRECTION)));
+	options.deleteExtraneousItems =
+		(IsDlgButtonChecked(m_hDlg, IDC_COMPARE_FOLDERS_DELETE_EXTRA) == BST_CHECKED);
+
+	auto plan = BuildSyncPlan(m_entries, options);
+
+	if (plan.empty())
+	{
+		MessageBox(m_hDlg,
+			m_app->GetResourceLoader()->LoadString(IDS_COMPARE_FOLDERS_IN_SYNC).c_str(),
+			App::APP_NAME, MB_ICONINFORMATION | MB_OK);
+		return std::nullopt;
+	}
+
+	return plan;
+}
+
+std::wstring CompareFoldersDialog::BuildPlanSummary(const std::vector<SyncAction> &plan)
+{
+	auto countActions = [&plan](SyncActionType type)
+	{ return std::ranges::count(plan, type, &SyncAction::type); };
+
+	return fmt::format(
+		fmt::runtime(m_app->GetResourceLoader()->LoadString(IDS_COMPARE_FOLDERS_PLAN_SUMMARY)),
+		fmt::arg(L"num_copies", countActions(SyncActionType::Copy)),
+		fmt::arg(L"num_deletions", countActions(SyncActionType::Delete)),
+		fmt::arg(L"num_conflicts", countActions(SyncActionType::Conflict)));
+}
+
+// Shows the actions that would be carried out, without making any changes.
+void CompareFoldersDialog::OnPreview()
+{
+	auto plan = BuildPlan();
+
+	if (!plan)
+	{
+		return;
+	}
+
+	std::vector<SyncAction> previewPlan(plan->begin(),
+		plan->begin() + std::min(plan->size(), MAX_PREVIEW_ACTIONS));
+	std::wstring text = BuildPlanSummary(*plan) + L"\n\n" + FormatSyncPlan(previewPlan);
+
+	if (plan->size() > previewPlan.size())
+	{
+		text += fmt::format(
+			fmt::runtime(
+				m_app->GetResourceLoader()->LoadString(IDS_COMPARE_FOLDERS_PLAN_TRUNCATED)),
+			fmt::arg(L"num_actions", plan->size() - previewPlan.size()));
+	}
+
+	MessageBox(m_hDlg, text.c_str(), App::APP_NAME, MB_ICONINFORMATION | MB_OK);
+}
+
+void CompareFoldersDialog::OnSync()
+{
+	auto plan = BuildPlan();
+
+	if (!plan)
+	{
+		return;
+	}
+
+	std::wstring confirmation = BuildPlanSummary(*plan) + L"\n\n"
+		+ m_app->GetResourceLoader()->LoadString(IDS_COMPARE_FOLDERS_SYNC_CONFIRMATION);
+	int res = MessageBox(m_hDlg, confirmation.c_str(), App::APP_NAME,
+		MB_ICONQUESTION | MB_YESNO | MB_DEFBUTTON2);
+
+	if (res != IDYES)
+	{
+		return;
+	}
+
+	HRESULT hr =
+		FileOperations::PerformSyncPlan(m_hDlg, m_comparedLeftPath, m_comparedRightPath, *plan);
+
+	if (FAILED(hr) && hr != HRESULT_FROM_WIN32(ERROR_CANCELLED))
+	{
+		MessageBox(m_hDlg,
+			m_app->GetResourceLoader()->LoadString(IDS_COMPARE_FOLDERS_SYNC_FAILED).c_str(),
+			App::APP_NAME, MB_ICONWARNING | MB_OK);
+	}
+
+	// The folders have (at least partially) changed, so the results are refreshed.
+	StartComparison(m_comparedLeftPath, m_comparedRightPath);
+}
+
+INT_PTR CompareFoldersDialog::OnCommand(WPARAM wParam, LPARAM lParam)
+{
+	UNREFERENCED_PARAMETER(lParam);
+
+	if (HIWORD(wParam) == CBN_SELCHANGE)
+	{
+		switch (LOWORD(wParam))
+		{
+		case IDC_COMPARE_FOLDERS_FILTER:
+			ApplyFilter();
+			break;
+
+		case IDC_COMPARE_FOLDERS_SYNC_DIRECTION:
+			UpdateSyncControls();
+			break;
+		}
+	}
+	else if (HIWORD(wParam) == 0 || HIWORD(wParam) == 1)
+	{
+		switch (LOWORD(wParam))
+		{
+		case IDC_COMPARE_FOLDERS_COMPARE:
+			OnCompare();
+			break;
+
+		case IDC_COMPARE_FOLDERS_PREVIEW:
+			OnPreview();
+			break;
+
+		case IDC_COMPARE_FOLDERS_SYNC:
+			OnSync();
+			break;
+
+		case IDCANCEL:
+			DestroyWindow(m_hDlg);
+			break;
+		}
+	}
+
+	return 0;
+}
+
+INT_PTR CompareFoldersDialog::OnNotify(NMHDR *nmhdr)
+{
+	if (nmhdr->idFrom == IDC_COMPARE_FOLDERS_LIST && nmhdr->code == LVN_GETDISPINFO)
+	{
+		OnGetDispInfo(reinterpret_cast<NMLVDISPINFO *>(nmhdr));
+	}
+
+	return 0;
+}
+
+void CompareFoldersDialog::OnGetDispInfo(NMLVDISPINFO *dispInfo)
+{
+	if (WI_IsFlagClear(dispInfo->item.mask, LVIF_TEXT)
+		|| dispInfo->item.iItem >= std::ssize(m_visibleEntries))
+	{
+		return;
+	}
+
+	assert(dispInfo->item.iSubItem >= 0 && dispInfo->item.iSubItem < std::ssize(COLUMNS));
+	auto columnType = COLUMNS[dispInfo->item.iSubItem].type;
+
+	const auto &entry = m_entries[m_visibleEntries[dispInfo->item.iItem]];
+	auto text = GetEntryColumnText(entry, columnType);
+	StringCchCopy(dispInfo->item.pszText, dispInfo->item.cchTextMax, text.c_str());
+}
+
+std::wstring CompareFoldersDialog::GetEntryColumnText(const FolderComparisonEntry &entry,
+	ColumnType columnType)
+{
+	switch (columnType)
+	{
+	case CompareFoldersDialog::ColumnType::Path:
+		return entry.relativePath;
+
+	case CompareFoldersDialog::ColumnType::Status:
+		return GetStatusText(entry.status);
+
+	case CompareFoldersDialog::ColumnType::LeftSize:
+		return FormatSize(entry.left);
+
+	case CompareFoldersDialog::ColumnType::LeftModified:
+		return FormatLastWriteTime(entry.left);
+
+	case CompareFoldersDialog::ColumnType::RightSize:
+		return FormatSize(entry.right);
+
+	case CompareFoldersDialog::ColumnType::RightModified:
+		return FormatLastWriteTime(entry.right);
+
+	default:
+		LOG(FATAL) << "Compare folders column type not found";
+		__assume(0);
+	}
+}
+
+std::wstring CompareFoldersDialog::GetStatusText(FolderComparisonStatus status)
+{
+	UINT stringId;
+
+	switch (status)
+	{
+	case FolderComparisonStatus::LeftOnly:
+		stringId = IDS_COMPARE_FOLDERS_STATUS_LEFT_ONLY;
+		break;
+
+	case FolderComparisonStatus::RightOnly:
+		stringId = IDS_COMPARE_FOLDERS_STATUS_RIGHT_ONLY;
+		break;
+
+	case FolderComparisonStatus::LeftNewer:
+		stringId = IDS_COMPARE_FOLDERS_STATUS_LEFT_NEWER;
+		break;
+
+	case FolderComparisonStatus::RightNewer:
+		stringId = IDS_COMPARE_FOLDERS_STATUS_RIGHT_NEWER;
+		break;
+
+	case FolderComparisonStatus::SizeDiffers:
+		stringId = IDS_COMPARE_FOLDERS_STATUS_SIZE_DIFFERS;
+		break;
+
+	case FolderComparisonStatus::ContentDiffers:
+		stringId = IDS_COMPARE_FOLDERS_STATUS_CONTENT_DIFFERS;
+		break;
+
+	case FolderComparisonStatus::TypeDiffers:
+		stringId = IDS_COMPARE_FOLDERS_STATUS_TYPE_DIFFERS;
+		break;
+
+	case FolderComparisonStatus::Identical:
+		stringId = IDS_COMPARE_FOLDERS_STATUS_IDENTICAL;
+		break;
+
+	default:
+		LOG(FATAL) << "Folder comparison status not found";
+		__assume(0);
+	}
+
+	return m_app->GetResourceLoader()->LoadString(stringId);
+}
+
+std::wstring CompareFoldersDialog::FormatSize(const std::optional<FolderItemProperties> &properties)
+{
+	if (!properties || properties->isFolder)
+	{
+		return {};
+	}
+
+	return FormatSizeString(properties->size);
+}
+
+std::wstring CompareFoldersDialog::FormatLastWriteTime(
+	const std::optional<FolderItemProperties> &properties)
+{
+	if (!properties)
+	{
+		return {};
+	}
+
+	// On Windows, file_time_type has the same epoch and resolution as a FILETIME.
+	auto ticks = static_cast<uint64_t>(properties->lastWriteTime.time_since_epoch().count());
+
+	FILETIME fileTime;
+	fileTime.dwLowDateTime = static_cast<DWORD>(ticks);
+	fileTime.dwHighDateTime = static_cast<DWORD>(ticks >> 32);
+
+	TCHAR formattedTime[256];
+	BOOL res = CreateFileTimeString(&fileTime, formattedTime, std::size(formattedTime),
+		m_app->GetConfig()->globalFolderSettings.showFriendlyDates);
+
+	if (!res)
+	{
+		return {};
+	}
+
+	return formattedTime;
+}
+
+INT_PTR CompareFoldersDialog::OnClose()
+{
+	DestroyWindow(m_hDlg);
+	return 0;
+}
+
+void CompareFoldersDialog::SaveState()
+{
+	m_persistentSettings->SaveDialogPosition(m_hDlg);
+	m_persistentSettings->m_bStateSaved = TRUE;
+}
+
+INT_PTR CompareFoldersDialog::OnNcDestroy()
+{
+	delete this;
+
+	return 0;
+}
+
+CompareFoldersDialogPersistentSettings::CompareFoldersDialogPersistentSettings() :
+	DialogSettings(SETTINGS_KEY.c_str())
+{
+}
+
+CompareFoldersDialogPersistentSettings &CompareFoldersDialogPersistentSettings::GetInstance()
+{
+	static CompareFoldersDialogPersistentSettings persistentSettings;
+	return persistentSettings;
+}
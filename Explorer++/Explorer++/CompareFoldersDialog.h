@@ -0,0 +1,136 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#pragma once
+
+#include "ThemedDialog.h"
+#include "../Helper/DialogSettings.h"
+#include "../Helper/FolderComparison.h"
+#include "../Helper/ScopedStopSource.h"
+#include "../Helper/WeakPtr.h"
+#include "../Helper/WeakPtrFactory.h"
+#include <concurrencpp/concurrencpp.h>
+#include <memory>
+#include <optional>
+#include <stop_token>
+#include <string>
+#include <vector>
+
+class App;
+class CompareFoldersDialog;
+class Runtime;
+
+class CompareFoldersDialogPersistentSettings : public DialogSettings
+{
+public:
+	static CompareFoldersDialogPersistentSettings &GetInstance();
+
+private:
+	friend CompareFoldersDialog;
+
+	static const inline std::wstring SETTINGS_KEY = L"CompareFolders";
+
+	CompareFoldersDialogPersistentSettings();
+};
+
+// Compares two folders (including their subfolders) and shows the differences. The folders can
+// then be synchronized, either in one direction, or in both.
+class CompareFoldersDialog : public ThemedDialog
+{
+public:
+	static CompareFoldersDialog *Create(App *app, HWND parent, const std::wstring &leftPath,
+		const std::wstring &rightPath);
+
+private:
+	enum class ColumnType
+	{
+		Path,
+		Status,
+		LeftSize,
+		LeftModified,
+		RightSize,
+		RightModified
+	};
+
+	struct Column
+	{
+		ColumnType type;
+		float percentageWidth;
+	};
+
+	// These values are used as indexes into the filter combo box, so their order matters.
+	enum class Filter
+	{
+		All,
+		Differences,
+		LeftOnly,
+		RightOnly
+	};
+
+	static inline const Column COLUMNS[] = { { ColumnType::Path, 0.34f },
+		{ ColumnType::Status, 0.14f }, { ColumnType::LeftSize, 0.1f },
+		{ ColumnType::LeftModified, 0.16f }, { ColumnType::RightSize, 0.1f },
+		{ ColumnType::RightModified, 0.16f } };
+
+	// The maximum number of actions that are listed when previewing a sync.
+	static constexpr size_t MAX_PREVIEW_ACTIONS = 40;
+
+	CompareFoldersDialog(App *app, HWND parent, const std::wstring &leftPath,
+		const std::wstring &rightPath);
+
+	INT_PTR OnInitDialog() override;
+	wil::unique_hicon GetDialogIcon(int iconWidth, int iconHeight) const override;
+	std::vector<ResizableDialogControl> GetResizableControls() override;
+	void SetupListView();
+	void InsertColumn(const Column &column, int index);
+	std::wstring GetColumnText(ColumnType columnType);
+	void SetupComboBoxes();
+
+	void OnCompare();
+	void StartComparison(const std::wstring &leftPath, const std::wstring &rightPath);
+	static concurrencpp::null_result CompareFoldersAsync(WeakPtr<CompareFoldersDialog> self,
+		std::wstring leftPath, std::wstring rightPath, FolderComparisonOptions options,
+		Runtime *runtime, std::stop_token stopToken);
+	void OnComparisonFinished(std::optional<std::vector<FolderComparisonEntry>> entries);
+	void ApplyFilter();
+	bool FilterEntry(const FolderComparisonEntry &entry, Filter filter);
+	void SetStatusText(const std::wstring &text);
+	void UpdateSyncControls();
+
+	std::optional<std::vector<SyncAction>> BuildPlan();
+	std::wstring BuildPlanSummary(const std::vector<SyncAction> &plan);
+	void OnPreview();
+	void OnSync();
+
+	INT_PTR OnCommand(WPARAM wParam, LPARAM lParam) override;
+	INT_PTR OnNotify(NMHDR *nmhdr) override;
+	void OnGetDispInfo(NMLVDISPINFO *dispInfo);
+	std::wstring GetEntryColumnText(const FolderComparisonEntry &entry, ColumnType columnType);
+	std::wstring GetStatusText(FolderComparisonStatus status);
+	std::wstring FormatSize(const std::optional<FolderItemProperties> &properties);
+	std::wstring FormatLastWriteTime(const std::optional<FolderItemProperties> &properties);
+	INT_PTR OnClose() override;
+	void SaveState() override;
+	INT_PTR OnNcDestroy() override;
+
+	App *const m_app;
+	const std::wstring m_initialLeftPath;
+	const std::wstring m_initialRightPath;
+	CompareFoldersDialogPersistentSettings *m_persistentSettings;
+
+	std::unique_ptr<ScopedStopSource> m_stopSource;
+	bool m_comparing = false;
+
+	// The results of the last comparison, along with the folders that were compared. The folders
+	// are stored separately from the edit controls, since the text in those controls can change
+	// after the comparison has finished.
+	std::vector<FolderComparisonEntry> m_entries;
+	std::wstring m_comparedLeftPath;
+	std::wstring m_comparedRightPath;
+
+	// The indexes (into m_entries) of the entries that are currently shown.
+	std::vector<size_t> m_visibleEntries;
+
+	WeakPtrFactory<CompareFoldersDialog> m_weakPtrFactory;
+};
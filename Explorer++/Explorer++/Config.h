@@ -49,6 +49,7 @@ struct Config
 	bool dualPane = false;
 	bool showStatusBar = true;
 	ValueWrapper<bool> showDisplayWindow = true;
+	ValueWrapper<bool> showPreviewPane = false;
 	bool alwaysOpenNewTab = false;
 	bool openNewTabNextToCurrent = false;
 	bool treeViewDelayEnabled = false;
@@ -56,7 +57,7 @@ struct Config
 	bool showTaskbarThumbnails = false;
 	ValueWrapper<bool> useFullRowSelect = false;
 	bool showFilePreviews = true;
-	bool allowMultipleInstances = true;
+	ValueWrapper<bool> allowMultipleInstances = true;
 	bool doubleClickTabClose = true;
 	ValueWrapper<bool> useLargeToolbarIcons = false;
 	bool handleZipFiles = false;
@@ -101,6 +102,34 @@ struct Config
 	ValueWrapper<bool> extendTabControl = false;
 	bool openTabsInForeground = false;
 
+	// The number of minutes a tab can remain in the background before it releases its items and
+	// becomes dormant. A value of 0 means that background tabs are never released. This only has an
+	// effect when the DormantTabs feature is enabled.
+	UINT dormantTabTimeoutMinutes = 30;
+
+	// The maximum number of back/forward entries retained by each tab and the maximum number of
+	// items retained in the global history. A value of 0 means that there is no limit.
+	UINT maxHistoryEntriesPerTab = 500;
+	UINT maxGlobalHistoryItems = 5000;
+
+	// The amount of memory, in MB, that can be used to store snapshots of previously visited
+	// folders, which allow those folders to be shown immediately when they're visited again. A
+	// value of 0 disables snapshots.
+	UINT folderSnapshotCacheSizeMB = 64;
+
+	// Whether folders that are likely to be navigated to (e.g. the folder under the mouse) are
+	// enumerated in the background ahead of time.
+	bool prefetchFolders = true;
+
+	// Whether the names of the files and folders on the fixed drives are indexed in the
+	// background, so that they can be searched instantly. Building the index involves walking
+	// every fixed drive, so this is opt-in.
+	bool indexFileNames = false;
+
+	// Whether .zip files are opened in the built-in archive browser. This takes precedence over
+	// handleZipFiles, so it's opt-in, to leave the existing behavior for .zip files unchanged.
+	bool openZipFilesInArchiveBrowser = false;
+
 	// Treeview
 	bool checkPinnedToNamespaceTreeProperty = false;
 	ValueWrapper<bool> showQuickAccessInTreeView = true;
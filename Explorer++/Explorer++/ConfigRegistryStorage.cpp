@@ -40,6 +40,8 @@ void LoadFromKey(HKEY settingsKey, Config &config)
 		config.globalFolderSettings.showFriendlyDates);
 	RegistrySettings::Read32BitValueFromRegistry(settingsKey, L"ShowDisplayWindow",
 		config.showDisplayWindow);
+	RegistrySettings::Read32BitValueFromRegistry(settingsKey, L"ShowPreviewPane",
+		config.showPreviewPane);
 	RegistrySettings::Read32BitValueFromRegistry(settingsKey, L"ShowFolderSizes",
 		config.globalFolderSettings.showFolderSizes);
 	RegistrySettings::Read32BitValueFromRegistry(settingsKey, L"DisableFolderSizesNetworkRemovable",
@@ -131,6 +133,20 @@ void LoadFromKey(HKEY settingsKey, Config &config)
 
 	RegistrySettings::Read32BitValueFromRegistry(settingsKey, L"OpenTabsInForeground",
 		config.openTabsInForeground);
+	RegistrySettings::Read32BitValueFromRegistry(settingsKey, L"DormantTabTimeoutMinutes",
+		config.dormantTabTimeoutMinutes);
+	RegistrySettings::Read32BitValueFromRegistry(settingsKey, L"MaxHistoryEntriesPerTab",
+		config.maxHistoryEntriesPerTab);
+	RegistrySettings::Read32BitValueFromRegistry(settingsKey, L"MaxGlobalHistoryItems",
+		config.maxGlobalHistoryItems);
+	RegistrySettings::Read32BitValueFromRegistry(settingsKey, L"FolderSnapshotCacheSizeMB",
+		config.folderSnapshotCacheSizeMB);
+	RegistrySettings::Read32BitValueFromRegistry(settingsKey, L"PrefetchFolders",
+		config.prefetchFolders);
+	RegistrySettings::Read32BitValueFromRegistry(settingsKey, L"IndexFileNames",
+		config.indexFileNames);
+	RegistrySettings::Read32BitValueFromRegistry(settingsKey, L"OpenZipFilesInArchiveBrowser",
+		config.openZipFilesInArchiveBrowser);
 	RegistrySettings::Read32BitValueFromRegistry(settingsKey, L"DisplayMixedFilesAndFolders",
 		config.globalFolderSettings.displayMixedFilesAndFolders);
 	RegistrySettings::Read32BitValueFromRegistry(settingsKey, L"UseNaturalSortOrder",
@@ -241,6 +257,7 @@ void SaveToKey(HKEY settingsKey, const Config &config)
 	RegistrySettings::SaveDword(settingsKey, L"ShowFriendlyDates",
 		config.globalFolderSettings.showFriendlyDates);
 	RegistrySettings::SaveDword(settingsKey, L"ShowDisplayWindow", config.showDisplayWindow.get());
+	RegistrySettings::SaveDword(settingsKey, L"ShowPreviewPane", config.showPreviewPane.get());
 	RegistrySettings::SaveDword(settingsKey, L"ShowFolderSizes",
 		config.globalFolderSettings.showFolderSizes);
 	RegistrySettings::SaveDword(settingsKey, L"DisableFolderSizesNetworkRemovable",
@@ -259,7 +276,7 @@ void SaveToKey(HKEY settingsKey, const Config &config)
 	RegistrySettings::SaveDword(settingsKey, L"ShowUserNameTitleBar",
 		config.showUserNameInTitleBar.get());
 	RegistrySettings::SaveDword(settingsKey, L"AllowMultipleInstances",
-		config.allowMultipleInstances);
+		config.allowMultipleInstances.get());
 	RegistrySettings::SaveDword(settingsKey, L"OneClickActivate",
 		config.globalFolderSettings.oneClickActivate.get());
 	RegistrySettings::SaveDword(settingsKey, L"OneClickActivateHoverTime",
@@ -292,6 +309,18 @@ void SaveToKey(HKEY settingsKey, const Config &config)
 	RegistrySettings::SaveDword(settingsKey, L"IconTheme", config.iconSet);
 	RegistrySettings::SaveDword(settingsKey, L"Language", config.language);
 	RegistrySettings::SaveDword(settingsKey, L"OpenTabsInForeground", config.openTabsInForeground);
+	RegistrySettings::SaveDword(settingsKey, L"DormantTabTimeoutMinutes",
+		config.dormantTabTimeoutMinutes);
+	RegistrySettings::SaveDword(settingsKey, L"MaxHistoryEntriesPerTab",
+		config.maxHistoryEntriesPerTab);
+	RegistrySettings::SaveDword(settingsKey, L"MaxGlobalHistoryItems",
+		config.maxGlobalHistoryItems);
+	RegistrySettings::SaveDword(settingsKey, L"FolderSnapshotCacheSizeMB",
+		config.folderSnapshotCacheSizeMB);
+	RegistrySettings::SaveDword(settingsKey, L"PrefetchFolders", config.prefetchFolders);
+	RegistrySettings::SaveDword(settingsKey, L"IndexFileNames", config.indexFileNames);
+	RegistrySettings::SaveDword(settingsKey, L"OpenZipFilesInArchiveBrowser",
+		config.openZipFilesInArchiveBrowser);
 	RegistrySettings::SaveDword(settingsKey, L"DisplayMixedFilesAndFolders",
 		config.globalFolderSettings.displayMixedFilesAndFolders);
 	RegistrySettings::SaveDword(settingsKey, L"UseNaturalSortOrder",
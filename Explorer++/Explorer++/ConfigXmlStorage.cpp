@@ -186,6 +186,7 @@ void LoadFromNode(IXMLDOMNode *settingsNode, Config &config)
 	GetBoolSetting(settingsNode, L"ShowBookmarksToolbar", config.showBookmarksToolbar);
 	GetBoolSetting(settingsNode, L"ShowDrivesToolbar", config.showDrivesToolbar);
 	GetBoolSetting(settingsNode, L"ShowDisplayWindow", config.showDisplayWindow);
+	GetBoolSetting(settingsNode, L"ShowPreviewPane", config.showPreviewPane);
 	GetBoolSetting(settingsNode, L"ShowExtensions", config.globalFolderSettings.showExtensions);
 	GetBoolSetting(settingsNode, L"ShowFilePreviews", config.showFilePreviews);
 	GetBoolSetting(settingsNode, L"ShowFolders", config.showFolders);
@@ -237,6 +238,14 @@ void LoadFromNode(IXMLDOMNode *settingsNode, Config &config)
 	GetBoolSetting(settingsNode, L"UseNaturalSortOrder",
 		config.globalFolderSettings.useNaturalSortOrder);
 	GetBoolSetting(settingsNode, L"OpenTabsInForeground", config.openTabsInForeground);
+	GetIntSetting(settingsNode, L"DormantTabTimeoutMinutes", config.dormantTabTimeoutMinutes);
+	GetIntSetting(settingsNode, L"MaxHistoryEntriesPerTab", config.maxHistoryEntriesPerTab);
+	GetIntSetting(settingsNode, L"MaxGlobalHistoryItems", config.maxGlobalHistoryItems);
+	GetIntSetting(settingsNode, L"FolderSnapshotCacheSizeMB", config.folderSnapshotCacheSizeMB);
+	GetBoolSetting(settingsNode, L"PrefetchFolders", config.prefetchFolders);
+	GetBoolSetting(settingsNode, L"IndexFileNames", config.indexFileNames);
+	GetBoolSetting(settingsNode, L"OpenZipFilesInArchiveBrowser",
+		config.openZipFilesInArchiveBrowser);
 
 	if (bool sortAscending;
 		GetBoolSetting(settingsNode, L"SortAscendingGlobal", sortAscending) == S_OK)
@@ -272,7 +281,7 @@ void LoadFromNode(IXMLDOMNode *settingsNode, Config &config)
 void SaveToNode(IXMLDOMDocument *xmlDocument, IXMLDOMElement *settingsNode, const Config &config)
 {
 	XMLSettings::WriteStandardSetting(xmlDocument, settingsNode, SETTING_NODE_NAME,
-		L"AllowMultipleInstances", XMLSettings::EncodeBoolValue(config.allowMultipleInstances));
+		L"AllowMultipleInstances", XMLSettings::EncodeBoolValue(config.allowMultipleInstances.get()));
 	XMLSettings::WriteStandardSetting(xmlDocument, settingsNode, SETTING_NODE_NAME,
 		L"AlwaysOpenInNewTab", XMLSettings::EncodeBoolValue(config.alwaysOpenNewTab));
 	XMLSettings::WriteStandardSetting(xmlDocument, settingsNode, SETTING_NODE_NAME,
@@ -392,6 +401,8 @@ void SaveToNode(IXMLDOMDocument *xmlDocument, IXMLDOMElement *settingsNode, cons
 		L"ShowDrivesToolbar", XMLSettings::EncodeBoolValue(config.showDrivesToolbar.get()));
 	XMLSettings::WriteStandardSetting(xmlDocument, settingsNode, SETTING_NODE_NAME,
 		L"ShowDisplayWindow", XMLSettings::EncodeBoolValue(config.showDisplayWindow.get()));
+	XMLSettings::WriteStandardSetting(xmlDocument, settingsNode, SETTING_NODE_NAME,
+		L"ShowPreviewPane", XMLSettings::EncodeBoolValue(config.showPreviewPane.get()));
 	XMLSettings::WriteStandardSetting(xmlDocument, settingsNode, SETTING_NODE_NAME,
 		L"ShowExtensions",
 		XMLSettings::EncodeBoolValue(config.globalFolderSettings.showExtensions));
@@ -467,6 +478,22 @@ void SaveToNode(IXMLDOMDocument *xmlDocument, IXMLDOMElement *settingsNode, cons
 		XMLSettings::EncodeBoolValue(config.globalFolderSettings.useNaturalSortOrder));
 	XMLSettings::WriteStandardSetting(xmlDocument, settingsNode, SETTING_NODE_NAME,
 		L"OpenTabsInForeground", XMLSettings::EncodeBoolValue(config.openTabsInForeground));
+	XMLSettings::WriteStandardSetting(xmlDocument, settingsNode, SETTING_NODE_NAME,
+		L"DormantTabTimeoutMinutes", XMLSettings::EncodeIntValue(config.dormantTabTimeoutMinutes));
+	XMLSettings::WriteStandardSetting(xmlDocument, settingsNode, SETTING_NODE_NAME,
+		L"MaxHistoryEntriesPerTab", XMLSettings::EncodeIntValue(config.maxHistoryEntriesPerTab));
+	XMLSettings::WriteStandardSetting(xmlDocument, settingsNode, SETTING_NODE_NAME,
+		L"MaxGlobalHistoryItems", XMLSettings::EncodeIntValue(config.maxGlobalHistoryItems));
+	XMLSettings::WriteStandardSetting(xmlDocument, settingsNode, SETTING_NODE_NAME,
+		L"FolderSnapshotCacheSizeMB",
+		XMLSettings::EncodeIntValue(config.folderSnapshotCacheSizeMB));
+	XMLSettings::WriteStandardSetting(xmlDocument, settingsNode, SETTING_NODE_NAME,
+		L"PrefetchFolders", XMLSettings::EncodeBoolValue(config.prefetchFolders));
+	XMLSettings::WriteStandardSetting(xmlDocument, settingsNode, SETTING_NODE_NAME,
+		L"IndexFileNames", XMLSettings::EncodeBoolValue(config.indexFileNames));
+	XMLSettings::WriteStandardSetting(xmlDocument, settingsNode, SETTING_NODE_NAME,
+		L"OpenZipFilesInArchiveBrowser",
+		XMLSettings::EncodeBoolValue(config.openZipFilesInArchiveBrowser));
 	XMLSettings::WriteStandardSetting(xmlDocument, settingsNode, SETTING_NODE_NAME,
 		L"GroupSortDirectionGlobal",
 		XMLSettings::EncodeIntValue(config.defaultFolderSettings.groupSortDirection));
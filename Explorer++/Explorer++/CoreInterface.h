@@ -32,6 +32,7 @@ struct FirstSuccessfulRequestCombiner
 };
 
 using MainMenuPreShowSignal = boost::signals2::signal<void(HMENU mainMenu)>;
+using MainMenuSubMenuPreShowSignal = boost::signals2::signal<void(HMENU subMenu)>;
 using MainMenuItemRightClickedSignal =
 	boost::signals2::signal<bool(HMENU menu, int index, const POINT &pt),
 		FirstSuccessfulRequestCombiner<bool>>;
@@ -99,6 +100,8 @@ public:
 
 	virtual boost::signals2::connection AddMainMenuPreShowObserver(
 		const MainMenuPreShowSignal::slot_type &observer) = 0;
+	virtual boost::signals2::connection AddMainMenuSubMenuPreShowObserver(
+		const MainMenuSubMenuPreShowSignal::slot_type &observer) = 0;
 	virtual boost::signals2::connection AddMainMenuItemMiddleClickedObserver(
 		const MainMenuItemMiddleClickedSignal::slot_type &observer) = 0;
 	virtual boost::signals2::connection AddMainMenuItemRightClickedObserver(
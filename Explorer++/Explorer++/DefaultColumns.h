@@ -60,7 +60,22 @@ static const Column_t REAL_FOLDER_DEFAULT_COLUMNS[] ={
 	{ColumnType::MediaProducer, FALSE, DEFAULT_COLUMN_WIDTH},
 	{ColumnType::MediaPublisher, FALSE, DEFAULT_COLUMN_WIDTH},
 	{ColumnType::MediaWriter, FALSE, DEFAULT_COLUMN_WIDTH},
-	{ColumnType::MediaYear, FALSE, DEFAULT_COLUMN_WIDTH}
+	{ColumnType::MediaYear, FALSE, DEFAULT_COLUMN_WIDTH},
+
+	// These columns are only shown once a plugin has registered a column in the corresponding
+	// slot.
+	{ColumnType::PluginColumn1, FALSE, DEFAULT_COLUMN_WIDTH},
+	{ColumnType::PluginColumn2, FALSE, DEFAULT_COLUMN_WIDTH},
+	{ColumnType::PluginColumn3, FALSE, DEFAULT_COLUMN_WIDTH},
+	{ColumnType::PluginColumn4, FALSE, DEFAULT_COLUMN_WIDTH},
+	{ColumnType::PluginColumn5, FALSE, DEFAULT_COLUMN_WIDTH},
+	{ColumnType::PluginColumn6, FALSE, DEFAULT_COLUMN_WIDTH},
+	{ColumnType::PluginColumn7, FALSE, DEFAULT_COLUMN_WIDTH},
+	{ColumnType::PluginColumn8, FALSE, DEFAULT_COLUMN_WIDTH},
+
+	{ColumnType::HashCrc32, FALSE, DEFAULT_COLUMN_WIDTH},
+	{ColumnType::HashXxHash64, FALSE, DEFAULT_COLUMN_WIDTH},
+	{ColumnType::HashSha256, FALSE, DEFAULT_COLUMN_WIDTH}
 };
 
 static const Column_t MY_COMPUTER_DEFAULT_COLUMNS[] = {
@@ -7,8 +7,10 @@
 #include "Bookmarks/UI/AddBookmarkDialog.h"
 #include "Bookmarks/UI/ManageBookmarksDialog.h"
 #include "ColorRuleEditorDialog.h"
+#include "CompareFoldersDialog.h"
 #include "CustomizeColorsDialog.h"
 #include "DestroyFilesDialog.h"
+#include "DuplicateFilesDialog.h"
 #include "DialogHelper.h"
 #include "DisplayColoursDialog.h"
 #include "FilterDialog.h"
@@ -56,7 +58,9 @@ DialogSettings *const DIALOG_SETTINGS[] = {
 	&ManageBookmarksDialogPersistentSettings::GetInstance(),
 	&DisplayColoursDialogPersistentSettings::GetInstance(),
 	&UpdateCheckDialogPersistentSettings::GetInstance(),
-	&SearchTabsDialogPersistentSettings::GetInstance()
+	&SearchTabsDialogPersistentSettings::GetInstance(),
+	&DuplicateFilesDialogPersistentSettings::GetInstance(),
+	&CompareFoldersDialogPersistentSettings::GetInstance()
 };
 // clang-format on
 
@@ -0,0 +1,234 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "stdafx.h"
+#include "DirectoryListingExport.h"
+#include "App.h"
+#include "ListingWalker.h"
+#include "MainResource.h"
+#include "ResourceHelper.h"
+#include "RuntimeHelper.h"
+#include <fmt/format.h>
+#include <fmt/xchar.h>
+#include <wil/com.h>
+#include <wil/resource.h>
+#include <filesystem>
+#include <fstream>
+
+namespace DirectoryListingExport
+{
+
+namespace
+{
+
+constexpr DWORD INCLUDE_SUBFOLDERS_CONTROL_ID = 1;
+
+struct FileType
+{
+	ListingFormat format;
+	UINT nameStringId;
+	const wchar_t *spec;
+	const wchar_t *extension;
+};
+
+// The order here determines the order in which the types are shown in the save dialog.
+constexpr FileType FILE_TYPES[] = {
+	{ ListingFormat::Csv, IDS_DIRECTORY_LISTING_FORMAT_CSV, L"*.csv", L"csv" },
+	{ ListingFormat::Tsv, IDS_DIRECTORY_LISTING_FORMAT_TSV, L"*.tsv", L"tsv" },
+	{ ListingFormat::JsonLines, IDS_DIRECTORY_LISTING_FORMAT_JSON_LINES, L"*.jsonl", L"jsonl" },
+	{ ListingFormat::Xml, IDS_DIRECTORY_LISTING_FORMAT_XML, L"*.xml", L"xml" }
+};
+
+ListingWalker::Result WriteListing(const ExportParams &params, HWND owner,
+	const std::wstring &progressTitle, const std::wstring &progressTemplate,
+	std::stop_token stopToken)
+{
+	std::ofstream stream(std::filesystem::path(params.destination.path),
+		std::ios::binary | std::ios::trunc);
+
+	if (!stream)
+	{
+		return ListingWalker::Result::WriteFailed;
+	}
+
+	ListingWriter writer(stream, params.destination.format, params.columnNames);
+	ShellListingSource source(owner, params.columns, params.folderSettings,
+		params.globalFolderSettings);
+	ListingWalker walker(&source, &writer,
+		{ .recursive = params.destination.recursive,
+			.includeRelativeFolder = params.destination.recursive });
+
+	// The progress dialog runs on its own thread, so it remains responsive while the listing is
+	// being written here.
+	wil::com_ptr_nothrow<IProgressDialog> progressDialog;
+	HRESULT hr = CoCreateInstance(CLSID_ProgressDialog, nullptr, CLSCTX_INPROC_SERVER,
+		IID_PPV_ARGS(&progressDialog));
+
+	if (SUCCEEDED(hr))
+	{
+		progressDialog->SetTitle(progressTitle.c_str());
+		progressDialog->StartProgressDialog(owner, nullptr,
+			PROGDLG_MODELESS | PROGDLG_MARQUEEPROGRESS | PROGDLG_NOMINIMIZE, nullptr);
+	}
+
+	std::stop_source cancelSource;
+	std::stop_callback stopCallback(stopToken, [&cancelSource] { cancelSource.request_stop(); });
+
+	auto result = walker.Walk(params.rootPath, cancelSource.get_token(),
+		[&progressDialog, &progressTemplate, &cancelSource](const ListingWalker::Progress &progress)
+		{
+			if (!progressDialog)
+			{
+				return;
+			}
+
+			if (progressDialog->HasUserCancelled())
+			{
+				cancelSource.request_stop();
+				return;
+			}
+
+			auto progressText = fmt::format(fmt::runtime(progressTemplate),
+				fmt::arg(L"num_items", progress.numItems));
+			progressDialog->SetLine(1, progressText.c_str(), FALSE, nullptr);
+			progressDialog->SetLine(2, progress.currentFolder.c_str(), TRUE, nullptr);
+		});
+
+	if (progressDialog)
+	{
+		progressDialog->StopProgressDialog();
+	}
+
+	if (result != ListingWalker::Result::Completed)
+	{
+		stream.close();
+
+		std::error_code error;
+		std::filesystem::remove(std::filesystem::path(params.destination.path), error);
+	}
+
+	return result;
+}
+
+}
+
+std::optional<Destination> PromptForDestination(HWND owner, HINSTANCE resourceInstance,
+	const std::wstring &initialDirectory)
+{
+	wil::com_ptr_nothrow<IFileSaveDialog> dialog;
+	HRESULT hr = CoCreateInstance(CLSID_FileSaveDialog, nullptr, CLSCTX_INPROC_SERVER,
+		IID_PPV_ARGS(&dialog));
+
+	if (FAILED(hr))
+	{
+		return std::nullopt;
+	}
+
+	std::vector<std::wstring> fileTypeNames;
+	std::vector<COMDLG_FILTERSPEC> fileTypeSpecs;
+
+	for (const auto &fileType : FILE_TYPES)
+	{
+		fileTypeNames.push_back(
+			ResourceHelper::LoadString(resourceInstance, fileType.nameStringId));
+	}
+
+	for (size_t i = 0; i < std::size(FILE_TYPES); i++)
+	{
+		fileTypeSpecs.push_back({ fileTypeNames[i].c_str(), FILE_TYPES[i].spec });
+	}
+
+	dialog->SetFileTypes(static_cast<UINT>(fileTypeSpecs.size()), fileTypeSpecs.data());
+	dialog->SetFileTypeIndex(1);
+	dialog->SetDefaultExtension(FILE_TYPES[0].extension);
+
+	auto fileName =
+		ResourceHelper::LoadString(resourceInstance, IDS_GENERAL_DIRECTORY_LISTING_FILENAME);
+	dialog->SetFileName(fileName.c_str());
+
+	wil::com_ptr_nothrow<IShellItem> initialFolder;
+	hr = SHCreateItemFromParsingName(initialDirectory.c_str(), nullptr,
+		IID_PPV_ARGS(&initialFolder));
+
+	if (SUCCEEDED(hr))
+	{
+		dialog->SetFolder(initialFolder.get());
+	}
+
+	auto customize = dialog.try_query<IFileDialogCustomize>();
+
+	if (customize)
+	{
+		auto includeSubfoldersText =
+			ResourceHelper::LoadString(resourceInstance, IDS_DIRECTORY_LISTING_INCLUDE_SUBFOLDERS);
+		customize->AddCheckButton(INCLUDE_SUBFOLDERS_CONTROL_ID, includeSubfoldersText.c_str(),
+			FALSE);
+	}
+
+	hr = dialog->Show(owner);
+
+	if (FAILED(hr))
+	{
+		return std::nullopt;
+	}
+
+	wil::com_ptr_nothrow<IShellItem> result;
+	hr = dialog->GetResult(&result);
+
+	if (FAILED(hr))
+	{
+		return std::nullopt;
+	}
+
+	wil::unique_cotaskmem_string path;
+	hr = result->GetDisplayName(SIGDN_FILESYSPATH, &path);
+
+	if (FAILED(hr))
+	{
+		return std::nullopt;
+	}
+
+	UINT fileTypeIndex;
+	hr = dialog->GetFileTypeIndex(&fileTypeIndex);
+
+	// The file type index is 1-based.
+	if (FAILED(hr) || fileTypeIndex < 1 || fileTypeIndex > std::size(FILE_TYPES))
+	{
+		fileTypeIndex = 1;
+	}
+
+	BOOL recursive = FALSE;
+
+	if (customize)
+	{
+		customize->GetCheckButtonState(INCLUDE_SUBFOLDERS_CONTROL_ID, &recursive);
+	}
+
+	return Destination{ path.get(), FILE_TYPES[fileTypeIndex - 1].format, recursive == TRUE };
+}
+
+concurrencpp::null_result ExportAsync(ExportParams params, HWND owner, HINSTANCE resourceInstance,
+	const Runtime *runtime, std::stop_token stopToken)
+{
+	auto progressTitle =
+		ResourceHelper::LoadString(resourceInstance, IDS_DIRECTORY_LISTING_PROGRESS_TITLE);
+	auto progressTemplate =
+		ResourceHelper::LoadString(resourceInstance, IDS_DIRECTORY_LISTING_PROGRESS);
+
+	co_await ResumeOnBackgroundJobThread(runtime);
+
+	auto result = WriteListing(params, owner, progressTitle, progressTemplate, stopToken);
+
+	co_await ResumeOnUiThread(runtime);
+
+	if (result != ListingWalker::Result::WriteFailed || stopToken.stop_requested())
+	{
+		co_return;
+	}
+
+	auto message = ResourceHelper::LoadString(resourceInstance, IDS_DIRECTORY_LISTING_SAVE_FAILED);
+	MessageBox(owner, message.c_str(), App::APP_NAME, MB_ICONWARNING | MB_OK);
+}
+
+}
@@ -0,0 +1,53 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#pragma once
+
+#include "ListingWriter.h"
+#include "ShellListingSource.h"
+#include "ShellBrowser/FolderSettings.h"
+#include <concurrencpp/concurrencpp.h>
+#include <optional>
+#include <stop_token>
+#include <string>
+#include <vector>
+
+class Runtime;
+
+namespace DirectoryListingExport
+{
+
+struct Destination
+{
+	std::wstring path;
+	ListingFormat format;
+	bool recursive;
+};
+
+struct ExportParams
+{
+	std::wstring rootPath;
+	Destination destination;
+
+	// The names of the columns in the output. When the export is recursive, this should begin with
+	// the name of the relative folder column.
+	std::vector<std::wstring> columnNames;
+
+	std::vector<ShellListingSource::Column> columns;
+	FolderSettings folderSettings;
+	GlobalFolderSettings globalFolderSettings;
+};
+
+// Asks the user where the listing should be saved, the format to use and whether subfolders should
+// be included. Returns an empty value if the user cancels.
+std::optional<Destination> PromptForDestination(HWND owner, HINSTANCE resourceInstance,
+	const std::wstring &initialDirectory);
+
+// Writes the listing on a background thread, showing a progress dialog that allows the export to
+// be cancelled. The export will also be cancelled if a stop is requested via the stop token. If the
+// export doesn't complete, the partially written file is removed.
+concurrencpp::null_result ExportAsync(ExportParams params, HWND owner, HINSTANCE resourceInstance,
+	const Runtime *runtime, std::stop_token stopToken);
+
+}
@@ -0,0 +1,370 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "stdafx.h"
+#include "DuplicateFilesDialog.h"
+#include "App.h"
+#include "CoreInterface.h"
+#include "FileHashService.h"
+#include "MainResource.h"
+#include "ResourceLoader.h"
+#include "RuntimeHelper.h"
+#include "TabContainerImpl.h"
+#include "../Helper/ScopedRedrawDisabler.h"
+#include "../Helper/StringHelper.h"
+#include "../Helper/WindowHelper.h"
+#include <fmt/format.h>
+#include <fmt/xchar.h>
+#include <glog/logging.h>
+
+DuplicateFilesDialog *DuplicateFilesDialog::Create(App *app, HWND parent,
+	CoreInterface *coreInterface, const std::wstring &rootPath)
+{
+	return new DuplicateFilesDialog(app, parent, coreInterface, rootPath);
+}
+
+DuplicateFilesDialog::DuplicateFilesDialog(App *app, HWND parent, CoreInterface *coreInterface,
+	const std::wstring &rootPath) :
+	ThemedDialog(app->GetResourceInstance(), IDD_DUPLICATE_FILES, parent,
+		BaseDialog::DialogSizingType::Both, app->GetThemeManager()),
+	m_app(app),
+	m_coreInterface(coreInterface),
+	m_rootPath(rootPath),
+	m_persistentSettings(&DuplicateFilesDialogPersistentSettings::GetInstance()),
+	m_weakPtrFactory(this)
+{
+}
+
+INT_PTR DuplicateFilesDialog::OnInitDialog()
+{
+	SetupListView();
+
+	m_persistentSettings->RestoreDialogPosition(m_hDlg, true);
+
+	StartSearch();
+
+	return TRUE;
+}
+
+wil::unique_hicon DuplicateFilesDialog::GetDialogIcon(int iconWidth, int iconHeight) const
+{
+	UNREFERENCED_PARAMETER(iconWidth);
+	UNREFERENCED_PARAMETER(iconHeight);
+
+	return wil::unique_hicon(LoadIcon(GetModuleHandle(nullptr), MAKEINTRESOURCE(IDI_MAIN)));
+}
+
+std::vector<ResizableDialogControl> DuplicateFilesDialog::GetResizableControls()
+{
+	std::vector<ResizableDialogControl> controls;
+	controls.emplace_back(GetDlgItem(m_hDlg, IDC_DUPLICATE_FILES_STATUS), MovingType::None,
+		SizingType::Horizontal);
+	controls.emplace_back(GetDlgItem(m_hDlg, IDC_DUPLICATE_FILES_LIST), MovingType::None,
+		SizingType::Both);
+	controls.emplace_back(GetDlgItem(m_hDlg, IDC_DUPLICATE_FILES_STOP), MovingType::Both,
+		SizingType::None);
+	controls.emplace_back(GetDlgItem(m_hDlg, IDCANCEL), MovingType::Both, SizingType::None);
+	return controls;
+}
+
+void DuplicateFilesDialog::SetupListView()
+{
+	HWND listView = GetDlgItem(m_hDlg, IDC_DUPLICATE_FILES_LIST);
+	ListView_SetExtendedListViewStyle(listView,
+		LVS_EX_LABELTIP | LVS_EX_FULLROWSELECT | LVS_EX_DOUBLEBUFFER);
+	ListView_EnableGroupView(listView, true);
+
+	int index = 0;
+
+	for (auto column : COLUMNS)
+	{
+		InsertColumn(column, index);
+		index++;
+	}
+}
+
+void DuplicateFilesDialog::InsertColumn(const Column &column, int index)
+{
+	std::wstring columnText = GetColumnText(column.type);
+
+	RECT listViewRect;
+	HWND listView = GetDlgItem(m_hDlg, IDC_DUPLICATE_FILES_LIST);
+	[[maybe_unused]] auto res = GetClientRect(listView, &listViewRect);
+	assert(res);
+
+	LVCOLUMN lvColumn = {};
+	lvColumn.mask = LVCF_TEXT | LVCF_WIDTH;
+	lvColumn.pszText = columnText.data();
+	lvColumn.cx = static_cast<int>(column.percentageWidth * GetRectWidth(&listViewRect));
+	[[maybe_unused]] int insertedIndex = ListView_InsertColumn(listView, index, &lvColumn);
+	assert(insertedIndex == index);
+}
+
+std::wstring DuplicateFilesDialog::GetColumnText(ColumnType columnType)
+{
+	UINT stringId;
+
+	switch (columnType)
+	{
+	case DuplicateFilesDialog::ColumnType::Name:
+		stringId = IDS_DUPLICATE_FILES_COLUMN_NAME;
+		break;
+
+	case DuplicateFilesDialog::ColumnType::Folder:
+		stringId = IDS_DUPLICATE_FILES_COLUMN_FOLDER;
+		break;
+
+	case DuplicateFilesDialog::ColumnType::Size:
+		stringId = IDS_DUPLICATE_FILES_COLUMN_SIZE;
+		break;
+
+	default:
+		LOG(FATAL) << "Duplicate files column type not found";
+		__assume(0);
+	}
+
+	return m_app->GetResourceLoader()->LoadString(stringId);
+}
+
+void DuplicateFilesDialog::StartSearch()
+{
+	DuplicateFinder::Options options;
+	options.numThreads = m_app->GetFileHashService()->GetNumThreads();
+	options.cache = m_app->GetFileHashService()->GetCache();
+	m_finder = std::make_shared<DuplicateFinder>(options);
+
+	m_stopSource = std::make_unique<ScopedStopSource>();
+	m_searching = true;
+
+	SetStatusText(
+		fmt::format(fmt::runtime(m_app->GetResourceLoader()->LoadString(
+						IDS_DUPLICATE_FILES_STATUS_FINDING_FILES)),
+			fmt::arg(L"folder", m_rootPath)));
+	SetTimer(m_hDlg, PROGRESS_TIMER_ID, PROGRESS_TIMER_INTERVAL, nullptr);
+
+	FindDuplicatesAsync(m_weakPtrFactory.GetWeakPtr(), m_rootPath, m_finder, m_app->GetRuntime(),
+		m_stopSource->GetToken());
+}
+
+concurrencpp::null_result DuplicateFilesDialog::FindDuplicatesAsync(
+	WeakPtr<DuplicateFilesDialog> self, std::wstring rootPath,
+	std::shared_ptr<DuplicateFinder> finder, Runtime *runtime, std::stop_token stopToken)
+{
+	co_await ResumeOnBackgroundJobThread(runtime);
+
+	auto files = CollectDuplicateFinderFiles(rootPath, stopToken);
+	auto groups = finder->Find(std::move(files), stopToken);
+
+	co_await ResumeOnUiThread(runtime);
+
+	if (stopToken.stop_requested() || !self)
+	{
+		co_return;
+	}
+
+	self->OnSearchFinished(std::move(groups));
+}
+
+void DuplicateFilesDialog::OnSearchFinished(std::optional<std::vector<DuplicateGroup>> groups)
+{
+	// The search can only return an empty value if it was stopped, in which case this method won't
+	// be called.
+	CHECK(groups);
+
+	KillTimer(m_hDlg, PROGRESS_TIMER_ID);
+	m_searching = false;
+	EnableWindow(GetDlgItem(m_hDlg, IDC_DUPLICATE_FILES_STOP), false);
+
+	ShowResults(*groups);
+}
+
+void DuplicateFilesDialog::StopSearch()
+{
+	if (!m_searching)
+	{
+		return;
+	}
+
+	m_stopSource.reset();
+
+	KillTimer(m_hDlg, PROGRESS_TIMER_ID);
+	m_searching = false;
+	EnableWindow(GetDlgItem(m_hDlg, IDC_DUPLICATE_FILES_STOP), false);
+
+	SetStatusText(m_app->GetResourceLoader()->LoadString(IDS_DUPLICATE_FILES_STATUS_STOPPED));
+}
+
+void DuplicateFilesDialog::UpdateProgress()
+{
+	auto progress = m_finder->GetProgress();
+
+	// Until the files have been collected, the finder won't have started, so the initial status
+	// text is left in place.
+	if (progress.stage == DuplicateFinder::Stage::GroupingBySize)
+	{
+		return;
+	}
+
+	SetStatusText(fmt::format(fmt::runtime(m_app->GetResourceLoader()->LoadString(
+								  IDS_DUPLICATE_FILES_STATUS_COMPARING)),
+		fmt::arg(L"num_files", progress.numFilesHashed),
+		fmt::arg(L"bytes_read", FormatSizeString(progress.numBytesRead))));
+}
+
+void DuplicateFilesDialog::ShowResults(const std::vector<DuplicateGroup> &groups)
+{
+	HWND listView = GetDlgItem(m_hDlg, IDC_DUPLICATE_FILES_LIST);
+	ScopedRedrawDisabler redrawDisabler(listView);
+
+	uint64_t wastedSize = 0;
+	int itemIndex = 0;
+	int groupId = 0;
+
+	for (const auto &group : groups)
+	{
+		AddGroup(group, groupId, itemIndex);
+		wastedSize += group.size * (group.paths.size() - 1);
+		groupId++;
+	}
+
+	SetStatusText(fmt::format(fmt::runtime(m_app->GetResourceLoader()->LoadString(
+								  IDS_DUPLICATE_FILES_STATUS_FINISHED)),
+		fmt::arg(L"num_groups", groups.size()),
+		fmt::arg(L"wasted_size", FormatSizeString(wastedSize))));
+}
+
+void DuplicateFilesDialog::AddGroup(const DuplicateGroup &group, int groupId, int &itemIndex)
+{
+	HWND listView = GetDlgItem(m_hDlg, IDC_DUPLICATE_FILES_LIST);
+	std::wstring sizeText = FormatSizeString(group.size);
+
+	std::wstring header = fmt::format(fmt::runtime(m_app->GetResourceLoader()->LoadString(
+										  IDS_DUPLICATE_FILES_GROUP_HEADER)),
+		fmt::arg(L"num_files", group.paths.size()), fmt::arg(L"size", sizeText));
+
+	LVGROUP lvGroup;
+	lvGroup.cbSize = sizeof(LVGROUP);
+	lvGroup.mask = LVGF_HEADER | LVGF_GROUPID | LVGF_STATE;
+	lvGroup.state = LVGS_COLLAPSIBLE;
+	lvGroup.stateMask = 0;
+	lvGroup.pszHeader = header.data();
+	lvGroup.iGroupId = groupId;
+	ListView_InsertGroup(listView, -1, &lvGroup);
+
+	for (const auto &path : group.paths)
+	{
+		std::wstring name = path.filename().wstring();
+		std::wstring folder = path.parent_path().wstring();
+
+		LVITEM item = {};
+		item.mask = LVIF_TEXT | LVIF_PARAM | LVIF_GROUPID;
+		item.iItem = itemIndex;
+		item.iSubItem = 0;
+		item.pszText = name.data();
+		item.iGroupId = groupId;
+		item.lParam = m_itemPaths.size();
+		int finalIndex = ListView_InsertItem(listView, &item);
+
+		ListView_SetItemText(listView, finalIndex, 1, folder.data());
+		ListView_SetItemText(listView, finalIndex, 2, sizeText.data());
+
+		m_itemPaths.push_back(path);
+		itemIndex++;
+	}
+}
+
+void DuplicateFilesDialog::SetStatusText(const std::wstring &text)
+{
+	SetDlgItemText(m_hDlg, IDC_DUPLICATE_FILES_STATUS, text.c_str());
+}
+
+INT_PTR DuplicateFilesDialog::OnTimer(int timerId)
+{
+	if (timerId == PROGRESS_TIMER_ID)
+	{
+		UpdateProgress();
+	}
+
+	return 0;
+}
+
+INT_PTR DuplicateFilesDialog::OnCommand(WPARAM wParam, LPARAM lParam)
+{
+	UNREFERENCED_PARAMETER(lParam);
+
+	if (HIWORD(wParam) == 0 || HIWORD(wParam) == 1)
+	{
+		switch (LOWORD(wParam))
+		{
+		case IDC_DUPLICATE_FILES_STOP:
+			StopSearch();
+			break;
+
+		case IDCANCEL:
+			DestroyWindow(m_hDlg);
+			break;
+		}
+	}
+
+	return 0;
+}
+
+INT_PTR DuplicateFilesDialog::OnNotify(NMHDR *nmhdr)
+{
+	if (nmhdr->idFrom == IDC_DUPLICATE_FILES_LIST && nmhdr->code == NM_DBLCLK)
+	{
+		OnListViewDoubleClick(reinterpret_cast<NMITEMACTIVATE *>(nmhdr));
+	}
+
+	return 0;
+}
+
+void DuplicateFilesDialog::OnListViewDoubleClick(const NMITEMACTIVATE *itemActivate)
+{
+	if (itemActivate->iItem == -1)
+	{
+		return;
+	}
+
+	LVITEM lvItem;
+	lvItem.mask = LVIF_PARAM;
+	lvItem.iItem = itemActivate->iItem;
+	lvItem.iSubItem = 0;
+	BOOL res = ListView_GetItem(itemActivate->hdr.hwndFrom, &lvItem);
+	CHECK(res);
+
+	const auto &path = m_itemPaths.at(lvItem.lParam);
+	m_coreInterface->GetTabContainerImpl()->CreateNewTab(path.parent_path().wstring(),
+		TabSettings(_selected = true));
+}
+
+INT_PTR DuplicateFilesDialog::OnClose()
+{
+	DestroyWindow(m_hDlg);
+	return 0;
+}
+
+void DuplicateFilesDialog::SaveState()
+{
+	m_persistentSettings->SaveDialogPosition(m_hDlg);
+	m_persistentSettings->m_bStateSaved = TRUE;
+}
+
+INT_PTR DuplicateFilesDialog::OnNcDestroy()
+{
+	delete this;
+
+	return 0;
+}
+
+DuplicateFilesDialogPersistentSettings::DuplicateFilesDialogPersistentSettings() :
+	DialogSettings(SETTINGS_KEY.c_str())
+{
+}
+
+DuplicateFilesDialogPersistentSettings &DuplicateFilesDialogPersistentSettings::GetInstance()
+{
+	static DuplicateFilesDialogPersistentSettings persistentSettings;
+	return persistentSettings;
+}
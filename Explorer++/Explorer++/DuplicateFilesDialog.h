@@ -0,0 +1,109 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#pragma once
+
+#include "ThemedDialog.h"
+#include "../Helper/DialogSettings.h"
+#include "../Helper/DuplicateFinder.h"
+#include "../Helper/ScopedStopSource.h"
+#include "../Helper/WeakPtr.h"
+#include "../Helper/WeakPtrFactory.h"
+#include <concurrencpp/concurrencpp.h>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <stop_token>
+#include <string>
+#include <vector>
+
+class App;
+class CoreInterface;
+class DuplicateFilesDialog;
+class Runtime;
+
+class DuplicateFilesDialogPersistentSettings : public DialogSettings
+{
+public:
+	static DuplicateFilesDialogPersistentSettings &GetInstance();
+
+private:
+	friend DuplicateFilesDialog;
+
+	static const inline std::wstring SETTINGS_KEY = L"DuplicateFiles";
+
+	DuplicateFilesDialogPersistentSettings();
+};
+
+// Finds files with identical content within a folder (and its subfolders). The search runs in the
+// background, with the results shown once it completes, grouped by content.
+class DuplicateFilesDialog : public ThemedDialog
+{
+public:
+	static DuplicateFilesDialog *Create(App *app, HWND parent, CoreInterface *coreInterface,
+		const std::wstring &rootPath);
+
+private:
+	enum class ColumnType
+	{
+		Name,
+		Folder,
+		Size
+	};
+
+	struct Column
+	{
+		ColumnType type;
+		float percentageWidth;
+	};
+
+	static inline const Column COLUMNS[] = { { ColumnType::Name, 0.3f },
+		{ ColumnType::Folder, 0.5f }, { ColumnType::Size, 0.2f } };
+
+	static constexpr UINT_PTR PROGRESS_TIMER_ID = 1;
+	static constexpr UINT PROGRESS_TIMER_INTERVAL = 200;
+
+	DuplicateFilesDialog(App *app, HWND parent, CoreInterface *coreInterface,
+		const std::wstring &rootPath);
+
+	INT_PTR OnInitDialog() override;
+	wil::unique_hicon GetDialogIcon(int iconWidth, int iconHeight) const override;
+	std::vector<ResizableDialogControl> GetResizableControls() override;
+	void SetupListView();
+	void InsertColumn(const Column &column, int index);
+	std::wstring GetColumnText(ColumnType columnType);
+
+	void StartSearch();
+	static concurrencpp::null_result FindDuplicatesAsync(WeakPtr<DuplicateFilesDialog> self,
+		std::wstring rootPath, std::shared_ptr<DuplicateFinder> finder, Runtime *runtime,
+		std::stop_token stopToken);
+	void OnSearchFinished(std::optional<std::vector<DuplicateGroup>> groups);
+	void StopSearch();
+	void UpdateProgress();
+	void ShowResults(const std::vector<DuplicateGroup> &groups);
+	void AddGroup(const DuplicateGroup &group, int groupId, int &itemIndex);
+	void SetStatusText(const std::wstring &text);
+
+	INT_PTR OnTimer(int timerId) override;
+	INT_PTR OnCommand(WPARAM wParam, LPARAM lParam) override;
+	INT_PTR OnNotify(NMHDR *nmhdr) override;
+	void OnListViewDoubleClick(const NMITEMACTIVATE *itemActivate);
+	INT_PTR OnClose() override;
+	void SaveState() override;
+	INT_PTR OnNcDestroy() override;
+
+	App *const m_app;
+	CoreInterface *const m_coreInterface;
+	const std::wstring m_rootPath;
+	DuplicateFilesDialogPersistentSettings *m_persistentSettings;
+
+	std::shared_ptr<DuplicateFinder> m_finder;
+	std::unique_ptr<ScopedStopSource> m_stopSource;
+	bool m_searching = false;
+
+	// Maps each listview item (via its lParam) to the file it represents.
+	std::vector<std::filesystem::path> m_itemPaths;
+
+	WeakPtrFactory<DuplicateFilesDialog> m_weakPtrFactory;
+};
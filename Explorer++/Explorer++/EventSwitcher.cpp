@@ -13,7 +13,7 @@
 #include "ShellTreeView/ShellTreeView.h"
 #include "TabContainerImpl.h"
 
-void Explorerplusplus::OnCopyItemPath() const
+void Explorerplusplus::OnCopyItemPath()
 {
 	HWND hFocus;
 
@@ -29,7 +29,7 @@ void Explorerplusplus::OnCopyItemPath() const
 	}
 }
 
-void Explorerplusplus::OnCopyUniversalPaths() const
+void Explorerplusplus::OnCopyUniversalPaths()
 {
 	HWND hFocus;
 
@@ -92,7 +92,7 @@ void Explorerplusplus::OnFileDelete(bool permanent)
 	}
 }
 
-void Explorerplusplus::OnSetFileAttributes() const
+void Explorerplusplus::OnSetFileAttributes()
 {
 	HWND hFocus;
 
@@ -9,5 +9,8 @@ enum ExitCode : int
 	EXIT_CODE_NORMAL,
 	EXIT_CODE_NORMAL_EXISTING_PROCESS,
 	EXIT_CODE_NORMAL_CRASH_HANDLER,
-	EXIT_CODE_ERROR
+	EXIT_CODE_ERROR,
+
+	// Returned by a batch folder comparison when the folders differ.
+	EXIT_CODE_DIFFERENCES_FOUND
 };
@@ -30,12 +30,14 @@
 #include "../Helper/ClipboardHelper.h"
 #include "../Helper/DropHandler.h"
 #include "../Helper/FileActionHandler.h"
+#include "../Helper/ScopedStopSource.h"
 #include "../Helper/ShellContextMenu.h"
 #include "../Helper/WeakPtr.h"
 #include "../Helper/WeakPtrFactory.h"
 #include <boost/signals2.hpp>
 #include <concurrencpp/concurrencpp.h>
 #include <wil/resource.h>
+#include <future>
 #include <optional>
 
 /* Sent when a folder size calculation has finished. */
@@ -49,9 +51,11 @@ class BookmarksMainMenu;
 class BookmarksToolbar;
 class BrowserTracker;
 class CachedIcons;
+class CompactPathList;
 struct Config;
 class DisplayWindow;
 class DrivesToolbar;
+class FilePreviewPane;
 class FrequentLocationsMenu;
 class HistoryMenu;
 class HolderWindow;
@@ -145,6 +149,9 @@ private:
 	static constexpr int TREEVIEW_MINIMUM_WIDTH = 70_px;
 	static constexpr double TREEVIEW_MAXIMUM_WIDTH_PERCENTAGE = 0.8;
 
+	static constexpr int PREVIEW_PANE_MINIMUM_WIDTH = 100_px;
+	static constexpr double PREVIEW_PANE_MAXIMUM_WIDTH_PERCENTAGE = 0.6;
+
 	// Main rebar band IDs. These are used to load and save data, so the values shouldn't be
 	// changed.
 	static const UINT REBAR_BAND_ID_MAIN_TOOLBAR = 0;
@@ -245,11 +252,11 @@ private:
 	/* Main menu handlers. */
 	void OnNewTab();
 	bool OnCloseTab();
-	void OnSaveDirectoryListing() const;
+	void OnSaveDirectoryListing();
 	void OnCloneWindow();
-	void OnCopyItemPath() const;
-	void OnCopyUniversalPaths() const;
-	void OnSetFileAttributes() const;
+	void OnCopyItemPath();
+	void OnCopyUniversalPaths();
+	void OnSetFileAttributes();
 	void OnFileDelete(bool permanent);
 	void OnFileRename();
 	void OnShowFileProperties() const;
@@ -274,10 +281,14 @@ private:
 	void OnSplitFile();
 	void OnDestroyFiles();
 	void OnSearch();
+	void OnManageBookmarks(bool focusSearch);
 	void OnCustomizeColors();
 	void OnRunScript();
 	void OnShowOptions();
 	void OnSearchTabs();
+	void OnFindDuplicateFiles();
+	void OnCompareFolders();
+	void OnRecordTrace();
 	void OnOpenOnlineDocumentation();
 	void OnCheckForUpdates();
 	void OnAbout();
@@ -299,14 +310,16 @@ private:
 	void OnShowListViewContextMenu(const POINT &ptScreen);
 	void OnListViewBackgroundRClick(POINT *pCursorPos);
 	void OnListViewItemRClick(POINT *pCursorPos);
-	void OnListViewCopyItemPath() const;
-	void OnListViewCopyUniversalPaths() const;
+	void OnListViewCopyItemPath();
+	void OnListViewCopyUniversalPaths();
+	std::shared_ptr<CompactPathList> GetSelectedListViewItemPaths() const;
+	void CopyPathsToClipboard(std::shared_future<std::shared_ptr<const CompactPathList>> paths);
 	void OnListViewSetFileAttributes() const;
 	void OnListViewPaste();
 
 	/* TreeView private message handlers. */
 	void OnTreeViewCopyItemPath() const;
-	void OnTreeViewSetFileAttributes() const;
+	void OnTreeViewSetFileAttributes();
 	void OnTreeViewCopyUniversalPaths() const;
 
 	/* Tab backing. */
@@ -339,6 +352,8 @@ private:
 	UiTheming *GetUiTheming() override;
 	AcceleratorUpdater *GetAccleratorUpdater() override;
 	Plugins::PluginCommandManager *GetPluginCommandManager() override;
+	Runtime *GetRuntime() override;
+	Plugins::PluginColumnRegistry *GetPluginColumnRegistry() override;
 
 	/* Plugins. */
 	void InitializePlugins();
@@ -420,6 +435,7 @@ private:
 	void OpenItem(PCIDLIST_ABSOLUTE pidlItem, OpenFolderDisposition openFolderDisposition) override;
 
 	void OpenShortcutItem(PCIDLIST_ABSOLUTE pidlItem, OpenFolderDisposition openFolderDisposition);
+	bool MaybeOpenInArchiveBrowser(PCIDLIST_ABSOLUTE pidlItem);
 	bool ShouldOpenContainerFile(PCIDLIST_ABSOLUTE pidlItem);
 
 	void OpenFolderItem(PCIDLIST_ABSOLUTE pidlItem,
@@ -468,6 +484,12 @@ private:
 	void UpdateDisplayWindowForOneFile(const Tab &tab);
 	void UpdateDisplayWindowForMultipleFiles(const Tab &tab);
 
+	// Preview pane
+	void CreatePreviewPane();
+	void OnShowPreviewPaneUpdated(bool showPreviewPane);
+	void OnPreviewPaneHolderResized(int newWidth);
+	void UpdatePreviewPane(const Tab &tab);
+
 	/* Columns. */
 	void CopyColumnInfoToClipboard();
 
@@ -498,9 +520,12 @@ private:
 		std::function<std::unique_ptr<MenuBase>(MenuView *menuView)> menuCreator);
 	boost::signals2::connection AddMainMenuPreShowObserver(
 		const MainMenuPreShowSignal::slot_type &observer) override;
+	boost::signals2::connection AddMainMenuSubMenuPreShowObserver(
+		const MainMenuSubMenuPreShowSignal::slot_type &observer) override;
 	wil::unique_hmenu BuildViewsMenu() override;
 	void AddViewModesToMenu(HMENU menu, UINT startPosition, BOOL byPosition);
 	void OnInitMenu(HMENU menu);
+	void OnInitMenuPopup(HMENU menu, bool isWindowMenu);
 	void OnExitMenuLoop(bool shortcutMenu);
 	bool MaybeHandleMainMenuItemSelection(UINT id);
 	boost::signals2::connection AddMainMenuItemMiddleClickedObserver(
@@ -568,9 +593,14 @@ private:
 	wil::com_ptr_nothrow<IImageList> m_mainMenuSystemImageList;
 	std::vector<wil::unique_hbitmap> m_mainMenuImages;
 	MainMenuPreShowSignal m_mainMenuPreShowSignal;
+	MainMenuSubMenuPreShowSignal m_mainMenuSubMenuPreShowSignal;
 	MainMenuItemMiddleClickedSignal m_mainMenuItemMiddleClickedSignal;
 	MainMenuItemRightClickedSignal m_mainMenuItemRightClickedSignal;
 	bool m_mainMenuShowing = false;
+
+	// The data object most recently used to copy item paths to the clipboard. The text is only
+	// rendered when it's pasted.
+	wil::com_ptr_nothrow<IDataObject> m_pathsClipboardDataObject;
 	GetMenuItemHelperTextSignal m_getMenuItemHelperTextSignal;
 	std::vector<MainMenuSubMenu> m_mainMenuSubMenus;
 
@@ -582,6 +612,11 @@ private:
 	ShellTreeView *m_shellTreeView = nullptr;
 	int m_treeViewWidth = LayoutDefaults::DEFAULT_TREEVIEW_WIDTH;
 
+	// Preview pane
+	HolderWindow *m_previewPaneHolder = nullptr;
+	FilePreviewPane *m_filePreviewPane = nullptr;
+	int m_previewPaneWidth = LayoutDefaults::DEFAULT_PREVIEW_PANE_WIDTH;
+
 	std::unique_ptr<BrowserPane> m_browserPane;
 
 	/* Tabs. */
@@ -612,6 +647,10 @@ private:
 	std::vector<std::unique_ptr<WindowSubclass>> m_windowSubclasses;
 	std::vector<boost::signals2::scoped_connection> m_connections;
 
+	// Used to cancel any directory listing exports that are still running when the window is
+	// destroyed.
+	ScopedStopSource m_directoryListingStopSource;
+
 	/* Bookmarks. */
 	std::unique_ptr<BookmarksMainMenu> m_bookmarksMainMenu;
 	BookmarksToolbar *m_bookmarksToolbar;
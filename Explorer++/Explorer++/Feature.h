@@ -20,6 +20,11 @@ BETTER_ENUM(Feature, int,
 
 	// When enabled, directory enumeration will be performed on a background thread, rather than the
 	// main thread.
-	BackgroundThreadEnumeration
+	BackgroundThreadEnumeration,
+
+	// When enabled, tabs restored at startup that aren't selected will remain dormant (i.e. they
+	// won't enumerate their folder) until they're first selected. Tabs that remain in the
+	// background for long enough will also release their items and worker threads.
+	DormantTabs
 )
 // clang-format on
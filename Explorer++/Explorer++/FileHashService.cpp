@@ -0,0 +1,31 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "stdafx.h"
+#include "FileHashService.h"
+
+FileHashService::FileHashService(int numThreads) : m_threadPool(numThreads)
+{
+}
+
+std::optional<std::string> FileHashService::GetFileHash(const std::wstring &path,
+	HashAlgorithm algorithm, uint64_t size, int64_t lastWriteTime, std::stop_token stopToken)
+{
+	return HashFileWithCache(&m_cache, { path, algorithm, size, lastWriteTime }, stopToken);
+}
+
+FileHashCache *FileHashService::GetCache()
+{
+	return &m_cache;
+}
+
+ctpl::thread_pool &FileHashService::GetThreadPool()
+{
+	return m_threadPool;
+}
+
+int FileHashService::GetNumThreads()
+{
+	return m_threadPool.size();
+}
@@ -0,0 +1,39 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#pragma once
+
+#include "../Helper/ContentHash.h"
+#include "../Helper/FileHashCache.h"
+#include "../ThirdParty/CTPL/cpl_stl.h"
+#include <boost/core/noncopyable.hpp>
+#include <optional>
+#include <stop_token>
+#include <string>
+
+// Calculates file hashes for the hash columns and the duplicate file finder. Hashes are cached
+// between uses (keyed by path, size and modification time), so a file that appears in several
+// tabs, or that's shown again after navigating back to a folder, is only read once.
+//
+// Hashing a large file can take a long time, so the work is done on a thread pool that's shared
+// by all tabs, rather than on a tab's column thread, where it would hold up every other column.
+class FileHashService : private boost::noncopyable
+{
+public:
+	// The thread pool will be created with the specified number of threads.
+	FileHashService(int numThreads);
+
+	// Returns the hash of the file, reading the file on the calling thread if the hash isn't
+	// cached. Returns an empty value if the file couldn't be read, or a stop was requested.
+	std::optional<std::string> GetFileHash(const std::wstring &path, HashAlgorithm algorithm,
+		uint64_t size, int64_t lastWriteTime, std::stop_token stopToken = {});
+
+	FileHashCache *GetCache();
+	ctpl::thread_pool &GetThreadPool();
+	int GetNumThreads();
+
+private:
+	FileHashCache m_cache;
+	ctpl::thread_pool m_threadPool;
+};
@@ -0,0 +1,560 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "stdafx.h"
+#include "FileNameIndexService.h"
+#include "Storage.h"
+#include "../Helper/FileNameIndexWalker.h"
+#include <glog/logging.h>
+#include <algorithm>
+#include <filesystem>
+#include <format>
+#include <iterator>
+#include <utility>
+
+namespace
+{
+
+constexpr UINT WATCH_FLAGS = FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_DIR_NAME
+	| FILE_NOTIFY_CHANGE_ATTRIBUTES | FILE_NOTIFY_CHANGE_SIZE | FILE_NOTIFY_CHANGE_LAST_WRITE;
+
+int GetNumThreads()
+{
+	return std::max(static_cast<int>(std::thread::hardware_concurrency()), 1);
+}
+
+std::vector<std::wstring> GetFixedDrives()
+{
+	std::vector<std::wstring> drives;
+	DWORD driveMask = GetLogicalDrives();
+
+	for (wchar_t letter = L'A'; letter <= L'Z'; letter++)
+	{
+		if (WI_IsFlagClear(driveMask, 1 << (letter - L'A')))
+		{
+			continue;
+		}
+
+		auto drive = std::format(L"{}:\\", letter);
+
+		if (GetDriveType(drive.c_str()) == DRIVE_FIXED)
+		{
+			drives.push_back(drive);
+		}
+	}
+
+	return drives;
+}
+
+int64_t FileTimeToInt64(const FILETIME &fileTime)
+{
+	ULARGE_INTEGER value = { fileTime.dwLowDateTime, fileTime.dwHighDateTime };
+	return static_cast<int64_t>(value.QuadPart);
+}
+
+FileNameIndexItem BuildItem(std::wstring name, DWORD attributes, DWORD sizeHigh, DWORD sizeLow,
+	const FILETIME &lastWriteTime)
+{
+	FileNameIndexItem item;
+	item.name = std::move(name);
+	item.isFolder = WI_IsFlagSet(attributes, FILE_ATTRIBUTE_DIRECTORY);
+	item.attributes = attributes;
+	item.lastWriteTime = FileTimeToInt64(lastWriteTime);
+
+	if (!item.isFolder)
+	{
+		ULARGE_INTEGER size = { sizeLow, sizeHigh };
+		item.size = size.QuadPart;
+	}
+
+	return item;
+}
+
+// Walking an entire drive generates a lot of I/O, so the walk is done at background priority, which
+// lowers the I/O priority as well. The walk uses its own set of threads, which is why the priority
+// is set here, the first time each thread reads a folder.
+void EnterBackgroundMode()
+{
+	thread_local bool inBackgroundMode = false;
+
+	if (!inBackgroundMode)
+	{
+		SetThreadPriority(GetCurrentThread(), THREAD_MODE_BACKGROUND_BEGIN);
+		inBackgroundMode = true;
+	}
+}
+
+// This is used instead of ReadFolderForIndex(), since it retrieves each item's attributes and is
+// significantly faster.
+bool ReadFolder(const std::wstring &path, std::vector<FileNameIndexItem> &items)
+{
+	auto searchPath = std::filesystem::path(path) / L"*";
+	WIN32_FIND_DATA findData;
+	wil::unique_hfind findHandle(FindFirstFileEx(searchPath.c_str(), FindExInfoBasic, &findData,
+		FindExSearchNameMatch, nullptr, FIND_FIRST_EX_LARGE_FETCH));
+
+	if (!findHandle)
+	{
+		return false;
+	}
+
+	do
+	{
+		if (lstrcmp(findData.cFileName, L".") == 0 || lstrcmp(findData.cFileName, L"..") == 0)
+		{
+			continue;
+		}
+
+		items.push_back(BuildItem(findData.cFileName, findData.dwFileAttributes,
+			findData.nFileSizeHigh, findData.nFileSizeLow, findData.ftLastWriteTime));
+	} while (FindNextFile(findHandle.get(), &findData));
+
+	return true;
+}
+
+bool ReadFolderInBackground(const std::wstring &path, std::vector<FileNameIndexItem> &items)
+{
+	EnterBackgroundMode();
+	return ReadFolder(path, items);
+}
+
+bool WriteIndexFile(const std::wstring &path, const std::vector<std::byte> &data)
+{
+	std::error_code error;
+	std::filesystem::create_directories(std::filesystem::path(path).parent_path(), error);
+
+	wil::unique_hfile file(CreateFile(path.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS,
+		FILE_ATTRIBUTE_NORMAL, nullptr));
+
+	if (!file)
+	{
+		return false;
+	}
+
+	size_t offset = 0;
+
+	while (offset < data.size())
+	{
+		auto chunkSize =
+			static_cast<DWORD>(std::min<size_t>(data.size() - offset, 64 * 1024 * 1024));
+		DWORD numBytesWritten;
+		BOOL res =
+			WriteFile(file.get(), data.data() + offset, chunkSize, &numBytesWritten, nullptr);
+
+		if (!res || numBytesWritten != chunkSize)
+		{
+			return false;
+		}
+
+		offset += chunkSize;
+	}
+
+	return true;
+}
+
+// Replaces the file at the path with the temporary file that was written alongside it.
+bool ReplaceIndexFile(const std::wstring &path)
+{
+	return MoveFileEx((path + L".tmp").c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING);
+}
+
+std::optional<WIN32_FILE_ATTRIBUTE_DATA> GetPathAttributes(const std::wstring &path)
+{
+	WIN32_FILE_ATTRIBUTE_DATA attributeData;
+
+	if (!GetFileAttributesEx(path.c_str(), GetFileExInfoStandard, &attributeData))
+	{
+		return std::nullopt;
+	}
+
+	return attributeData;
+}
+
+// Adds, updates or removes the item at the path, based on its current attributes (which will be
+// empty if the item no longer exists). Returns true if the item is a folder that's just been added.
+// A folder that's been moved (or copied) in will already have contents and no notifications will
+// be generated for them, so they need to be walked separately.
+bool UpdateItem(FileNameIndex &index, const std::wstring &path,
+	const std::optional<WIN32_FILE_ATTRIBUTE_DATA> &attributeData)
+{
+	auto existingId = index.FindItem(path);
+
+	if (!attributeData)
+	{
+		if (existingId)
+		{
+			index.RemoveItem(*existingId);
+		}
+
+		return false;
+	}
+
+	std::filesystem::path fsPath(path);
+	auto parentId = index.FindItem(fsPath.parent_path().native());
+
+	if (!parentId)
+	{
+		return false;
+	}
+
+	bool wasFolder = existingId && index.GetItem(*existingId).isFolder;
+
+	auto item = BuildItem(fsPath.filename().native(), attributeData->dwFileAttributes,
+		attributeData->nFileSizeHigh, attributeData->nFileSizeLow, attributeData->ftLastWriteTime);
+	bool isFolder = item.isFolder;
+	bool isReparsePoint = WI_IsFlagSet(item.attributes, FILE_ATTRIBUTE_REPARSE_POINT);
+	index.AddItem(*parentId, std::move(item));
+
+	return isFolder && !wasFolder && !isReparsePoint;
+}
+
+// The items within a folder, gathered without touching the index. Each item's parent is either 0
+// (for items directly within the folder) or the position of the parent in the list, plus one.
+using FolderContents = std::vector<std::pair<FileNameIndex::ItemId, FileNameIndexItem>>;
+
+FolderContents ReadFolderContents(const std::wstring &path)
+{
+	FolderContents contents;
+	WalkFoldersForIndex({ { path, 0 } }, ReadFolder, 1, {},
+		[&contents](FileNameIndex::ItemId parent, FileNameIndexItem item)
+		{
+			contents.emplace_back(parent, std::move(item));
+			return static_cast<FileNameIndex::ItemId>(contents.size());
+		});
+	return contents;
+}
+
+void MergeFolderContents(FileNameIndex &index, const std::wstring &path, FolderContents contents)
+{
+	auto folderId = index.FindItem(path);
+
+	// The folder may have been removed (or replaced) while its contents were being read.
+	if (!folderId || !index.GetItem(*folderId).isFolder)
+	{
+		return;
+	}
+
+	std::vector<FileNameIndex::ItemId> ids;
+	ids.reserve(contents.size() + 1);
+	ids.push_back(*folderId);
+
+	for (auto &[parent, item] : contents)
+	{
+		ids.push_back(index.AddItem(ids[parent], std::move(item)));
+	}
+}
+
+// Brings the item at the path up to date in an index that isn't shared with any other thread.
+void SyncPath(FileNameIndex &index, const std::wstring &path)
+{
+	if (UpdateItem(index, path, GetPathAttributes(path)))
+	{
+		MergeFolderContents(index, path, ReadFolderContents(path));
+	}
+}
+
+bool RootsMatch(const FileNameIndex &index, const std::vector<std::wstring> &rootPaths)
+{
+	std::vector<std::wstring> expectedRootPaths;
+	std::ranges::transform(rootPaths, std::back_inserter(expectedRootPaths),
+		GetFileNameIndexRootName);
+
+	auto indexedRootPaths = index.GetRootPaths();
+	std::ranges::sort(expectedRootPaths);
+	std::ranges::sort(indexedRootPaths);
+
+	return indexedRootPaths == expectedRootPaths;
+}
+
+}
+
+struct FileNameIndexService::MappedFile
+{
+	wil::unique_hfile file;
+	wil::unique_handle mapping;
+	wil::unique_mapview_ptr<std::byte> view;
+	size_t size = 0;
+};
+
+FileNameIndexService::FileNameIndexService() = default;
+
+FileNameIndexService::~FileNameIndexService()
+{
+	// Releasing the monitor waits for its thread to exit, so no more change notifications will be
+	// received after this.
+	StopWatching();
+
+	if (m_rebuildThread.joinable())
+	{
+		m_rebuildThread.request_stop();
+		m_rebuildThread.join();
+	}
+
+	SaveChanges();
+}
+
+void FileNameIndexService::Start()
+{
+	m_rootPaths = GetFixedDrives();
+
+	if (LoadSavedIndex())
+	{
+		StartWatching();
+		return;
+	}
+
+	// This is set before watching starts, so that every change made during the rebuild is
+	// recorded.
+	m_rebuilding = true;
+	StartWatching();
+
+	m_rebuildThread = std::jthread(std::bind_front(&FileNameIndexService::RebuildIndex, this));
+}
+
+// Returns true if the saved index was loaded and can be used without being rebuilt.
+bool FileNameIndexService::LoadSavedIndex()
+{
+	auto indexFilePath = Storage::GetFileNameIndexFilePath();
+
+	if (!indexFilePath)
+	{
+		return false;
+	}
+
+	auto mappedFile = std::make_unique<MappedFile>();
+	mappedFile->file.reset(CreateFile(indexFilePath->c_str(), GENERIC_READ, FILE_SHARE_READ,
+		nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr));
+
+	if (!mappedFile->file)
+	{
+		return false;
+	}
+
+	LARGE_INTEGER fileSize;
+
+	if (!GetFileSizeEx(mappedFile->file.get(), &fileSize) || fileSize.QuadPart == 0
+		|| static_cast<uint64_t>(fileSize.QuadPart) > SIZE_MAX)
+	{
+		return false;
+	}
+
+	mappedFile->mapping.reset(
+		CreateFileMapping(mappedFile->file.get(), nullptr, PAGE_READONLY, 0, 0, nullptr));
+
+	if (!mappedFile->mapping)
+	{
+		return false;
+	}
+
+	mappedFile->view.reset(
+		static_cast<std::byte *>(MapViewOfFile(mappedFile->mapping.get(), FILE_MAP_READ, 0, 0, 0)));
+
+	if (!mappedFile->view)
+	{
+		return false;
+	}
+
+	mappedFile->size = static_cast<size_t>(fileSize.QuadPart);
+
+	auto index = FileNameIndex::Load(
+		std::span<const std::byte>(mappedFile->view.get(), mappedFile->size));
+
+	if (!index)
+	{
+		LOG(WARNING) << "Saved filename index is invalid and will be rebuilt";
+		return false;
+	}
+
+	// An index that doesn't cover the current set of drives can still be queried while it's being
+	// rebuilt.
+	bool rootsMatch = RootsMatch(*index, m_rootPaths);
+
+	if (!rootsMatch)
+	{
+		LOG(INFO) << "Indexed drives have changed; the filename index will be rebuilt";
+	}
+
+	std::unique_lock lock(m_mutex);
+	m_mappedFile = std::move(mappedFile);
+	m_index = std::move(index);
+
+	return rootsMatch;
+}
+
+void FileNameIndexService::StartWatching()
+{
+	HRESULT hr = CreateDirectoryMonitor(&m_directoryMonitor);
+
+	if (FAILED(hr))
+	{
+		m_directoryMonitor = nullptr;
+		return;
+	}
+
+	for (size_t i = 0; i < m_rootPaths.size(); i++)
+	{
+		auto *watchData = static_cast<WatchData *>(malloc(sizeof(WatchData)));
+		watchData->service = this;
+		watchData->rootIndex = i;
+
+		// If the drive can't be watched, the monitor will free the data. Changes within the drive
+		// will then only be picked up when the index is next rebuilt.
+		m_directoryMonitor->WatchDirectory(m_rootPaths[i].c_str(), WATCH_FLAGS,
+			OnDirectoryChangedStub, TRUE, watchData);
+	}
+}
+
+void FileNameIndexService::StopWatching()
+{
+	if (m_directoryMonitor)
+	{
+		m_directoryMonitor->Release();
+		m_directoryMonitor = nullptr;
+	}
+}
+
+void FileNameIndexService::RebuildIndex(std::stop_token stopToken)
+{
+	auto data = BuildFileNameIndex(m_rootPaths, ReadFolderInBackground, GetNumThreads(), stopToken);
+
+	if (!data)
+	{
+		return;
+	}
+
+	// The new index is written to a temporary file, since the existing file is still mapped into
+	// memory at this point.
+	auto indexFilePath = Storage::GetFileNameIndexFilePath();
+	bool written = false;
+
+	if (indexFilePath)
+	{
+		written = WriteIndexFile(*indexFilePath + L".tmp", *data);
+	}
+
+	auto index = FileNameIndex::Load(std::move(*data));
+	CHECK(index);
+
+	// The new index isn't shared with anything else yet, so changes made during the walk can be
+	// applied to it without holding the lock. That matters, since applying a change can involve
+	// walking a folder that's been moved in.
+	std::unique_lock lock(m_mutex);
+
+	while (!m_pathsChangedDuringRebuild.empty())
+	{
+		auto changedPaths = std::exchange(m_pathsChangedDuringRebuild, {});
+		lock.unlock();
+
+		for (const auto &path : changedPaths)
+		{
+			SyncPath(*index, path);
+		}
+
+		lock.lock();
+	}
+
+	m_rebuilding = false;
+
+	m_index = std::move(index);
+	m_mappedFile.reset();
+
+	LOG(INFO) << "Filename index rebuilt (" << m_index->GetNumItems() << " items)";
+
+	lock.unlock();
+
+	// Any changes made after the walk (including those applied above) are saved on exit.
+	if (written)
+	{
+		ReplaceIndexFile(*indexFilePath);
+	}
+}
+
+void FileNameIndexService::SaveChanges()
+{
+	if (!m_index || m_index->GetNumChanges() == 0)
+	{
+		return;
+	}
+
+	auto indexFilePath = Storage::GetFileNameIndexFilePath();
+
+	if (!indexFilePath || !WriteIndexFile(*indexFilePath + L".tmp", m_index->Serialize()))
+	{
+		return;
+	}
+
+	// The existing file may still be mapped into memory, in which case it can't be replaced.
+	m_index.reset();
+	m_mappedFile.reset();
+
+	ReplaceIndexFile(*indexFilePath);
+}
+
+void FileNameIndexService::OnDirectoryChangedStub(const TCHAR *fileName, DWORD action, void *data)
+{
+	UNREFERENCED_PARAMETER(action);
+
+	auto *watchData = static_cast<WatchData *>(data);
+	watchData->service->OnDirectoryChanged(watchData->rootIndex, fileName);
+}
+
+void FileNameIndexService::OnDirectoryChanged(size_t rootIndex, const std::wstring &fileName)
+{
+	// Every type of change is handled in the same way, by checking the current state of the item.
+	// For example, a rename generates one notification for the old name (which no longer exists
+	// and so will be removed) and one for the new name (which will be added).
+	auto path = (std::filesystem::path(m_rootPaths[rootIndex]) / fileName).native();
+	auto attributeData = GetPathAttributes(path);
+
+	std::unique_lock lock(m_mutex);
+
+	if (m_rebuilding)
+	{
+		m_pathsChangedDuringRebuild.push_back(path);
+	}
+
+	if (!m_index || !UpdateItem(*m_index, path, attributeData))
+	{
+		return;
+	}
+
+	// The contents of a folder that's been moved in are read without holding the lock, since the
+	// folder could be arbitrarily large and queries would otherwise be blocked until the walk
+	// finished. The contents are then merged into whichever index is current at that point.
+	lock.unlock();
+
+	auto contents = ReadFolderContents(path);
+
+	lock.lock();
+
+	if (m_index)
+	{
+		MergeFolderContents(*m_index, path, std::move(contents));
+	}
+}
+
+bool FileNameIndexService::IsReady() const
+{
+	std::shared_lock lock(m_mutex);
+	return m_index != nullptr;
+}
+
+bool FileNameIndexService::IsFolderIndexed(const std::wstring &path) const
+{
+	std::shared_lock lock(m_mutex);
+	return m_index && m_index->FindItem(path).has_value();
+}
+
+std::optional<std::vector<FileNameQueryResult>> FileNameIndexService::Query(
+	const FileNameQuery &query, std::stop_token stopToken) const
+{
+	std::shared_lock lock(m_mutex);
+
+	if (!m_index)
+	{
+		return std::nullopt;
+	}
+
+	return m_index->Query(query, stopToken);
+}
@@ -0,0 +1,87 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#pragma once
+
+#include "../Helper/FileNameIndex.h"
+#include "../Helper/iDirectoryMonitor.h"
+#include <boost/core/noncopyable.hpp>
+#include <memory>
+#include <optional>
+#include <shared_mutex>
+#include <stop_token>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Maintains an index of the names of every file and folder on the fixed drives, which allows
+// searches (including searches across every drive) to return results almost immediately.
+//
+// The index from the previous session is saved to disk and mapped back into memory at startup, so
+// it can be queried straight away. Walking every drive is expensive, so the index is only rebuilt
+// (in the background) if there's no saved index, or the saved index can't be used (because it's
+// invalid or the set of drives has changed). While the application is running, changes are picked
+// up from directory change notifications and applied to the index as they occur, with the changes
+// saved back to disk on exit. Changes made while the application isn't running won't be reflected
+// in the index until it's next rebuilt.
+//
+// All methods are safe to call from any thread.
+class FileNameIndexService : private boost::noncopyable
+{
+public:
+	FileNameIndexService();
+	~FileNameIndexService();
+
+	void Start();
+
+	// Returns true once there's an index available to query (either the saved index or a freshly
+	// built one).
+	bool IsReady() const;
+
+	// Returns true if the folder is within one of the indexed drives.
+	bool IsFolderIndexed(const std::wstring &path) const;
+
+	// Returns an empty value if the index isn't ready yet. Throws std::regex_error if the pattern
+	// is an invalid regular expression.
+	std::optional<std::vector<FileNameQueryResult>> Query(const FileNameQuery &query,
+		std::stop_token stopToken = {}) const;
+
+private:
+	struct MappedFile;
+
+	// Passed to the directory monitor, which frees the data using free(), so this needs to be
+	// allocated using malloc().
+	struct WatchData
+	{
+		FileNameIndexService *service;
+		size_t rootIndex;
+	};
+
+	static void OnDirectoryChangedStub(const TCHAR *fileName, DWORD action, void *data);
+
+	bool LoadSavedIndex();
+	void StartWatching();
+	void StopWatching();
+	void RebuildIndex(std::stop_token stopToken);
+	void SaveChanges();
+	void OnDirectoryChanged(size_t rootIndex, const std::wstring &fileName);
+
+	std::vector<std::wstring> m_rootPaths;
+
+	mutable std::shared_mutex m_mutex;
+
+	// The saved index is used in place, so the mapping needs to outlive the index loaded from it.
+	std::unique_ptr<MappedFile> m_mappedFile;
+	std::unique_ptr<FileNameIndex> m_index;
+
+	// Changes that occur while the index is being rebuilt are applied to the existing index and
+	// recorded here, so that they can be applied to the new index once it's been built.
+	bool m_rebuilding = false;
+	std::vector<std::wstring> m_pathsChangedDuringRebuild;
+
+	IDirectoryMonitor *m_directoryMonitor = nullptr;
+
+	// This is declared last, so that the thread is stopped before anything it uses is destroyed.
+	std::jthread m_rebuildThread;
+};
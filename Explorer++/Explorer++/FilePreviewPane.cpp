@@ -0,0 +1,1123 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "stdafx.h"
+#include "FilePreviewPane.h"
+#include "App.h"
+#include "DarkModeManager.h"
+#include "MainFontSetter.h"
+#include "MainResource.h"
+#include "ResourceLoader.h"
+#include "RuntimeHelper.h"
+#include "../Helper/DpiCompatibility.h"
+#include "../Helper/LineIndex.h"
+#include "../Helper/MappedFile.h"
+#include "../Helper/MappedFileSearch.h"
+#include "../Helper/StringHelper.h"
+#include "../Helper/WindowHelper.h"
+#include "../Helper/WindowSubclass.h"
+#include <fmt/format.h>
+#include <fmt/xchar.h>
+#include <glog/logging.h>
+#include <algorithm>
+#include <thread>
+
+namespace
+{
+
+std::wstring GetEncodingName(TextEncoding encoding)
+{
+	switch (encoding)
+	{
+	case TextEncoding::Utf8:
+		return L"UTF-8";
+
+	case TextEncoding::Utf16LE:
+		return L"UTF-16 LE";
+
+	case TextEncoding::Utf16BE:
+		return L"UTF-16 BE";
+
+	case TextEncoding::Ansi:
+		return L"ANSI";
+
+	default:
+		LOG(FATAL) << "Text encoding not found";
+		__assume(0);
+	}
+}
+
+// Expands tabs and replaces any other control characters, since they would otherwise be drawn as
+// boxes.
+std::wstring FormatLineForDisplay(const std::wstring &line, int tabWidth)
+{
+	std::wstring formattedLine;
+	formattedLine.reserve(line.size());
+
+	for (wchar_t character : line)
+	{
+		if (character == '\t')
+		{
+			formattedLine.append(tabWidth - (formattedLine.size() % tabWidth), ' ');
+		}
+		else if (character < 0x20)
+		{
+			formattedLine.push_back(' ');
+		}
+		else
+		{
+			formattedLine.push_back(character);
+		}
+	}
+
+	return formattedLine;
+}
+
+// Parses text like "4D 5A 90" or "4d5a90". Returns an empty value if the text isn't a sequence of
+// hex bytes.
+std::optional<std::vector<std::byte>> ParseHexBytes(const std::wstring &text)
+{
+	std::wstring digits;
+
+	for (wchar_t character : text)
+	{
+		if (iswspace(character))
+		{
+			continue;
+		}
+
+		if (!iswxdigit(character))
+		{
+			return std::nullopt;
+		}
+
+		digits.push_back(character);
+	}
+
+	if (digits.empty() || digits.size() % 2 != 0)
+	{
+		return std::nullopt;
+	}
+
+	std::vector<std::byte> bytes;
+
+	for (size_t i = 0; i < digits.size(); i += 2)
+	{
+		bytes.push_back(static_cast<std::byte>(std::stoi(digits.substr(i, 2), nullptr, 16)));
+	}
+
+	return bytes;
+}
+
+}
+
+FilePreviewPane *FilePreviewPane::Create(HWND parent, App *app)
+{
+	return new FilePreviewPane(parent, app);
+}
+
+FilePreviewPane::FilePreviewPane(HWND parent, App *app) :
+	m_hwnd(CreatePreviewWindow(parent, this)),
+	m_app(app),
+	m_backgroundResults(MakeUiThreadScheduler(app->GetRuntime()),
+		std::bind_front(&FilePreviewPane::ProcessBackgroundResult, this)),
+	m_threadPool(2)
+{
+	m_searchEdit = CreateWindowEx(WS_EX_CLIENTEDGE, WC_EDIT, L"",
+		WS_CHILD | WS_VISIBLE | WS_TABSTOP | ES_AUTOHSCROLL, 0, 0, 0, 0, m_hwnd, nullptr,
+		GetModuleHandle(nullptr), nullptr);
+	Edit_SetCueBannerText(m_searchEdit,
+		m_app->GetResourceLoader()->LoadString(IDS_PREVIEW_PANE_SEARCH_CUE).c_str());
+	m_searchEditFontSetter = std::make_unique<MainFontSetter>(m_searchEdit, m_app->GetConfig());
+
+	m_windowSubclasses.push_back(std::make_unique<WindowSubclass>(m_searchEdit,
+		std::bind_front(&FilePreviewPane::SearchEditSubclass, this)));
+
+	CreateViewFont();
+
+	m_initialized = true;
+
+	UpdateLayout();
+}
+
+FilePreviewPane::~FilePreviewPane()
+{
+	CancelBackgroundWork();
+	m_threadPool.clear_queue();
+}
+
+HWND FilePreviewPane::CreatePreviewWindow(HWND parent, FilePreviewPane *previewPane)
+{
+	RegisterPreviewWindowClass();
+
+	return CreateWindowEx(WS_EX_CONTROLPARENT, CLASS_NAME, L"",
+		WS_CHILD | WS_VISIBLE | WS_VSCROLL | WS_CLIPCHILDREN, 0, 0, 0, 0, parent, nullptr,
+		GetModuleHandle(nullptr), previewPane);
+}
+
+ATOM FilePreviewPane::RegisterPreviewWindowClass()
+{
+	WNDCLASS wc;
+	wc.style = CS_HREDRAW | CS_VREDRAW;
+	wc.lpfnWndProc = WndProcStub;
+	wc.cbClsExtra = 0;
+	wc.cbWndExtra = sizeof(FilePreviewPane *);
+	wc.hInstance = GetModuleHandle(nullptr);
+	wc.hIcon = nullptr;
+	wc.hCursor = LoadCursor(nullptr, IDC_ARROW);
+	wc.hbrBackground = nullptr;
+	wc.lpszMenuName = nullptr;
+	wc.lpszClassName = CLASS_NAME;
+
+	return RegisterClass(&wc);
+}
+
+LRESULT CALLBACK FilePreviewPane::WndProcStub(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam)
+{
+	auto *previewPane = reinterpret_cast<FilePreviewPane *>(GetWindowLongPtr(hwnd, GWLP_USERDATA));
+
+	switch (msg)
+	{
+	case WM_CREATE:
+	{
+		auto *createInfo = reinterpret_cast<CREATESTRUCT *>(lParam);
+		previewPane = reinterpret_cast<FilePreviewPane *>(createInfo->lpCreateParams);
+
+		SetWindowLongPtr(hwnd, GWLP_USERDATA, reinterpret_cast<LONG_PTR>(previewPane));
+	}
+	break;
+
+	case WM_NCDESTROY:
+		SetWindowLongPtr(hwnd, GWLP_USERDATA, 0);
+		delete previewPane;
+		return 0;
+	}
+
+	if (previewPane)
+	{
+		return previewPane->WndProc(hwnd, msg, wParam, lParam);
+	}
+	else
+	{
+		return DefWindowProc(hwnd, msg, wParam, lParam);
+	}
+}
+
+LRESULT FilePreviewPane::WndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam)
+{
+	if (!m_initialized)
+	{
+		return DefWindowProc(hwnd, msg, wParam, lParam);
+	}
+
+	switch (msg)
+	{
+	case WM_SIZE:
+		UpdateLayout();
+		UpdateScrollBar();
+		break;
+
+	case WM_ERASEBKGND:
+		return 1;
+
+	case WM_PAINT:
+		OnPaint();
+		return 0;
+
+	case WM_VSCROLL:
+		OnVScroll(LOWORD(wParam));
+		return 0;
+
+	case WM_MOUSEWHEEL:
+		OnMouseWheel(GET_WHEEL_DELTA_WPARAM(wParam));
+		return 0;
+
+	case WM_LBUTTONDOWN:
+		SetFocus(m_hwnd);
+		break;
+
+	case WM_GETDLGCODE:
+		return DLGC_WANTARROWS;
+
+	case WM_KEYDOWN:
+		if (OnKeyDown(static_cast<UINT>(wParam)))
+		{
+			return 0;
+		}
+		break;
+
+	case WM_CONTEXTMENU:
+		OnContextMenu({ GET_X_LPARAM(lParam), GET_Y_LPARAM(lParam) });
+		return 0;
+
+	case WM_COMMAND:
+		if (reinterpret_cast<HWND>(lParam) == m_searchEdit && HIWORD(wParam) == EN_CHANGE)
+		{
+			// The next search should start from the current position, rather than from the
+			// previous match.
+			m_match.reset();
+			InvalidateRect(m_hwnd, nullptr, false);
+		}
+		break;
+
+	case WM_TIMER:
+		OnTimer(wParam);
+		break;
+
+	case WM_DPICHANGED_AFTERPARENT:
+		CreateViewFont();
+		UpdateLayout();
+		UpdateScrollBar();
+		InvalidateRect(m_hwnd, nullptr, false);
+		break;
+	}
+
+	return DefWindowProc(hwnd, msg, wParam, lParam);
+}
+
+LRESULT FilePreviewPane::SearchEditSubclass(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam)
+{
+	switch (msg)
+	{
+	case WM_KEYDOWN:
+		if (wParam == VK_RETURN)
+		{
+			StartSearch();
+			return 0;
+		}
+		break;
+
+	case WM_CHAR:
+		// Prevents the edit control from beeping when enter is pressed.
+		if (wParam == VK_RETURN)
+		{
+			return 0;
+		}
+		break;
+	}
+
+	return DefSubclassProc(hwnd, msg, wParam, lParam);
+}
+
+void FilePreviewPane::CreateViewFont()
+{
+	int fontHeight = DpiCompatibility::GetInstance().PointsToPixels(m_hwnd, FONT_POINT_SIZE);
+	m_font.reset(CreateFont(-fontHeight, 0, 0, 0, FW_NORMAL, false, false, false, DEFAULT_CHARSET,
+		OUT_DEFAULT_PRECIS, CLIP_DEFAULT_PRECIS, DEFAULT_QUALITY, FIXED_PITCH | FF_MODERN,
+		L"Consolas"));
+
+	auto hdc = wil::GetDC(m_hwnd);
+	auto selectFont = wil::SelectObject(hdc.get(), m_font.get());
+
+	TEXTMETRIC textMetrics;
+	GetTextMetrics(hdc.get(), &textMetrics);
+	m_rowHeight = textMetrics.tmHeight;
+	m_charWidth = textMetrics.tmAveCharWidth;
+}
+
+void FilePreviewPane::UpdateLayout()
+{
+	RECT clientRect;
+	GetClientRect(m_hwnd, &clientRect);
+
+	SetWindowPos(m_searchEdit, nullptr, 0, 0, GetRectWidth(&clientRect),
+		DpiCompatibility::GetInstance().ScaleValue(m_hwnd, SEARCH_EDIT_HEIGHT),
+		SWP_NOZORDER | SWP_NOMOVE);
+}
+
+RECT FilePreviewPane::GetContentRect() const
+{
+	RECT contentRect;
+	GetClientRect(m_hwnd, &contentRect);
+	contentRect.top = DpiCompatibility::GetInstance().ScaleValue(m_hwnd, SEARCH_EDIT_HEIGHT);
+	contentRect.bottom = std::max(contentRect.top, contentRect.bottom - m_rowHeight);
+	return contentRect;
+}
+
+RECT FilePreviewPane::GetStatusRect() const
+{
+	RECT statusRect;
+	GetClientRect(m_hwnd, &statusRect);
+	statusRect.top = GetContentRect().bottom;
+	return statusRect;
+}
+
+void FilePreviewPane::OnPaint()
+{
+	PAINTSTRUCT ps;
+	BeginPaint(m_hwnd, &ps);
+
+	auto selectFont = wil::SelectObject(ps.hdc, m_font.get());
+	SetBkColor(ps.hdc, GetBackgroundColor());
+	SetTextColor(ps.hdc, GetTextColor());
+
+	RECT contentRect = GetContentRect();
+
+	switch (m_fileState)
+	{
+	case FileState::None:
+		PaintMessage(ps.hdc, contentRect,
+			m_app->GetResourceLoader()->LoadString(IDS_PREVIEW_PANE_NO_FILE));
+		break;
+
+	case FileState::Opening:
+		PaintMessage(ps.hdc, contentRect,
+			m_app->GetResourceLoader()->LoadString(IDS_PREVIEW_PANE_OPENING));
+		break;
+
+	case FileState::OpenFailed:
+		PaintMessage(ps.hdc, contentRect,
+			m_app->GetResourceLoader()->LoadString(IDS_PREVIEW_PANE_OPEN_FAILED));
+		break;
+
+	case FileState::Open:
+		if (m_viewMode == ViewMode::Text)
+		{
+			PaintTextRows(ps.hdc, contentRect);
+		}
+		else
+		{
+			PaintHexRows(ps.hdc, contentRect);
+		}
+		break;
+	}
+
+	PaintStatus(ps.hdc);
+
+	EndPaint(m_hwnd, &ps);
+}
+
+void FilePreviewPane::PaintMessage(HDC hdc, const RECT &contentRect, const std::wstring &message)
+{
+	wil::unique_hbrush backgroundBrush(CreateSolidBrush(GetBackgroundColor()));
+	FillRect(hdc, &contentRect, backgroundBrush.get());
+
+	RECT textRect = contentRect;
+	InflateRect(&textRect,
+		-DpiCompatibility::GetInstance().ScaleValue(m_hwnd, TEXT_HORIZONTAL_PADDING), 0);
+	textRect.top += m_rowHeight;
+	DrawText(hdc, message.c_str(), -1, &textRect, DT_CENTER | DT_WORDBREAK | DT_NOPREFIX);
+}
+
+void FilePreviewPane::PaintTextRows(HDC hdc, const RECT &contentRect)
+{
+	int padding = DpiCompatibility::GetInstance().ScaleValue(m_hwnd, TEXT_HORIZONTAL_PADDING);
+	size_t unitSize = GetCodeUnitSize(m_detectedEncoding.encoding);
+	auto lines = m_lineIndex->GetLines(m_topRow, static_cast<size_t>(GetNumVisibleRows()) + 1,
+		*m_reader);
+	int y = contentRect.top;
+
+	for (const auto &line : lines)
+	{
+		size_t displayedSize = static_cast<size_t>(
+			std::min<uint64_t>(line.length, MAX_DISPLAYED_LINE_SIZE));
+		displayedSize -= displayedSize % unitSize;
+
+		auto text = FormatLineForDisplay(
+			DecodeText(m_reader->Read(line.offset, displayedSize), m_detectedEncoding.encoding),
+			TAB_WIDTH);
+
+		// The line that contains the current match is highlighted, in the same way as a selected
+		// row.
+		bool containsMatch = m_match && m_match->offset >= line.offset
+			&& m_match->offset <= line.offset + line.length;
+
+		if (containsMatch)
+		{
+			SetBkColor(hdc, GetSysColor(COLOR_HIGHLIGHT));
+			SetTextColor(hdc, GetSysColor(COLOR_HIGHLIGHTTEXT));
+		}
+
+		RECT rowRect = { contentRect.left, y, contentRect.right, y + m_rowHeight };
+		ExtTextOut(hdc, rowRect.left + padding, y, ETO_OPAQUE | ETO_CLIPPED, &rowRect, text.c_str(),
+			static_cast<UINT>(text.size()), nullptr);
+
+		if (containsMatch)
+		{
+			SetBkColor(hdc, GetBackgroundColor());
+			SetTextColor(hdc, GetTextColor());
+		}
+
+		y += m_rowHeight;
+	}
+
+	RECT remainingRect = { contentRect.left, y, contentRect.right, contentRect.bottom };
+	ExtTextOut(hdc, 0, 0, ETO_OPAQUE, &remainingRect, nullptr, 0, nullptr);
+}
+
+void FilePreviewPane::PaintHexRows(HDC hdc, const RECT &contentRect)
+{
+	int padding = DpiCompatibility::GetInstance().ScaleValue(m_hwnd, TEXT_HORIZONTAL_PADDING);
+	uint64_t fileSize = m_file->GetSize();
+
+	// Offsets are shown with at least 8 digits, with more used for files larger than 4 GiB.
+	size_t offsetDigits = std::max<size_t>(8, fmt::format(L"{:X}", fileSize).size());
+
+	// Each row is laid out as:
+	// [offset]  [8 bytes]  [8 bytes]  [characters]
+	auto getHexColumn = [offsetDigits](size_t index)
+	{ return offsetDigits + 2 + (index * 3) + (index >= HEX_BYTES_PER_ROW / 2 ? 1 : 0); };
+	auto getCharacterColumn = [offsetDigits](size_t index)
+	{ return offsetDigits + 2 + (HEX_BYTES_PER_ROW * 3) + 2 + index; };
+
+	uint64_t endRow = std::min(GetNumRows(), m_topRow + GetNumVisibleRows() + 1);
+	int y = contentRect.top;
+
+	for (uint64_t row = m_topRow; row < endRow; row++)
+	{
+		uint64_t rowOffset = row * HEX_BYTES_PER_ROW;
+		auto data = m_reader->Read(rowOffset, HEX_BYTES_PER_ROW);
+
+		std::wstring text = fmt::format(L"{:0{}X}", rowOffset, offsetDigits);
+		text.resize(getCharacterColumn(HEX_BYTES_PER_ROW), ' ');
+
+		for (size_t i = 0; i < data.size(); i++)
+		{
+			auto value = std::to_integer<unsigned char>(data[i]);
+			auto hex = fmt::format(L"{:02X}", value);
+			text.replace(getHexColumn(i), 2, hex);
+			text[getCharacterColumn(i)] =
+				(value >= 0x20 && value < 0x7F) ? static_cast<wchar_t>(value) : L'.';
+		}
+
+		text.resize(getCharacterColumn(data.size()));
+
+		RECT rowRect = { contentRect.left, y, contentRect.right, y + m_rowHeight };
+		ExtTextOut(hdc, rowRect.left + padding, y, ETO_OPAQUE | ETO_CLIPPED, &rowRect, text.c_str(),
+			static_cast<UINT>(text.size()), nullptr);
+
+		// Bytes that are part of the current match are highlighted in both the hex and character
+		// columns.
+		if (m_match && m_match->offset < rowOffset + data.size()
+			&& m_match->offset + m_match->size > rowOffset)
+		{
+			SetBkColor(hdc, GetSysColor(COLOR_HIGHLIGHT));
+			SetTextColor(hdc, GetSysColor(COLOR_HIGHLIGHTTEXT));
+
+			size_t start = static_cast<size_t>(std::max(m_match->offset, rowOffset) - rowOffset);
+			size_t end = static_cast<size_t>(
+				std::min(m_match->offset + m_match->size, rowOffset + data.size()) - rowOffset);
+
+			auto drawHighlight = [hdc, &text, &rowRect, padding, y, this](size_t column,
+									 size_t length)
+			{
+				ExtTextOut(hdc, rowRect.left + padding + static_cast<int>(column) * m_charWidth, y,
+					ETO_CLIPPED, &rowRect, text.c_str() + column, static_cast<UINT>(length),
+					nullptr);
+			};
+
+			for (size_t i = start; i < end; i++)
+			{
+				drawHighlight(getHexColumn(i), 2);
+				drawHighlight(getCharacterColumn(i), 1);
+			}
+
+			SetBkColor(hdc, GetBackgroundColor());
+			SetTextColor(hdc, GetTextColor());
+		}
+
+		y += m_rowHeight;
+	}
+
+	RECT remainingRect = { contentRect.left, y, contentRect.right, contentRect.bottom };
+	ExtTextOut(hdc, 0, 0, ETO_OPAQUE, &remainingRect, nullptr, 0, nullptr);
+}
+
+void FilePreviewPane::PaintStatus(HDC hdc)
+{
+	RECT statusRect = GetStatusRect();
+	int padding = DpiCompatibility::GetInstance().ScaleValue(m_hwnd, TEXT_HORIZONTAL_PADDING);
+
+	auto *darkModeManager = m_app->GetDarkModeManager();
+	SetBkColor(hdc,
+		darkModeManager->IsDarkModeEnabled() ? DarkModeManager::BACKGROUND_COLOR
+											 : GetSysColor(COLOR_BTNFACE));
+	SetTextColor(hdc,
+		darkModeManager->IsDarkModeEnabled() ? DarkModeManager::TEXT_COLOR
+											 : GetSysColor(COLOR_BTNTEXT));
+
+	auto text = GetStatusText();
+	ExtTextOut(hdc, statusRect.left + padding, statusRect.top, ETO_OPAQUE | ETO_CLIPPED,
+		&statusRect, text.c_str(), static_cast<UINT>(text.size()), nullptr);
+}
+
+std::wstring FilePreviewPane::GetStatusText() const
+{
+	if (m_fileState != FileState::Open)
+	{
+		return {};
+	}
+
+	if (m_statusMessage)
+	{
+		return *m_statusMessage;
+	}
+
+	if (m_viewMode == ViewMode::Hex)
+	{
+		return fmt::format(
+			fmt::runtime(m_app->GetResourceLoader()->LoadString(IDS_PREVIEW_PANE_HEX_STATUS)),
+			fmt::arg(L"size", FormatSizeString(m_file->GetSize())));
+	}
+
+	auto encodingName = GetEncodingName(m_detectedEncoding.encoding);
+
+	if (!m_lineIndex->IsComplete())
+	{
+		uint64_t fileSize = std::max<uint64_t>(m_file->GetSize(), 1);
+		return fmt::format(fmt::runtime(m_app->GetResourceLoader()->LoadString(
+							   IDS_PREVIEW_PANE_TEXT_STATUS_INDEXING)),
+			fmt::arg(L"encoding", encodingName),
+			fmt::arg(L"num_lines", m_lineIndex->GetNumLines()),
+			fmt::arg(L"percent", m_lineIndex->GetNumBytesScanned() * 100 / fileSize));
+	}
+
+	return fmt::format(
+		fmt::runtime(m_app->GetResourceLoader()->LoadString(IDS_PREVIEW_PANE_TEXT_STATUS)),
+		fmt::arg(L"encoding", encodingName), fmt::arg(L"num_lines", m_lineIndex->GetNumLines()));
+}
+
+COLORREF FilePreviewPane::GetBackgroundColor() const
+{
+	return m_app->GetDarkModeManager()->IsDarkModeEnabled() ? DarkModeManager::BACKGROUND_COLOR
+															: GetSysColor(COLOR_WINDOW);
+}
+
+COLORREF FilePreviewPane::GetTextColor() const
+{
+	return m_app->GetDarkModeManager()->IsDarkModeEnabled() ? DarkModeManager::TEXT_COLOR
+															: GetSysColor(COLOR_WINDOWTEXT);
+}
+
+void FilePreviewPane::OnVScroll(int scrollRequest)
+{
+	uint64_t numVisibleRows = std::max<uint64_t>(GetNumVisibleRows(), 1);
+
+	switch (scrollRequest)
+	{
+	case SB_LINEUP:
+		ScrollToRow(m_topRow > 0 ? m_topRow - 1 : 0);
+		break;
+
+	case SB_LINEDOWN:
+		ScrollToRow(m_topRow + 1);
+		break;
+
+	case SB_PAGEUP:
+		ScrollToRow(m_topRow > numVisibleRows ? m_topRow - numVisibleRows : 0);
+		break;
+
+	case SB_PAGEDOWN:
+		ScrollToRow(m_topRow + numVisibleRows);
+		break;
+
+	case SB_TOP:
+		ScrollToRow(0);
+		break;
+
+	case SB_BOTTOM:
+		ScrollToRow(GetMaxTopRow());
+		break;
+
+	case SB_THUMBTRACK:
+	case SB_THUMBPOSITION:
+	{
+		// The position included in WM_VSCROLL is only 16 bits, so the full position needs to be
+		// retrieved.
+		SCROLLINFO scrollInfo = {};
+		scrollInfo.cbSize = sizeof(scrollInfo);
+		scrollInfo.fMask = SIF_TRACKPOS;
+		GetScrollInfo(m_hwnd, SB_VERT, &scrollInfo);
+		ScrollToRow(ScrollPositionToRow(scrollInfo.nTrackPos));
+	}
+	break;
+	}
+}
+
+void FilePreviewPane::OnMouseWheel(short delta)
+{
+	UINT linesPerNotch = 3;
+	SystemParametersInfo(SPI_GETWHEELSCROLLLINES, 0, &linesPerNotch, 0);
+
+	m_wheelDelta += delta;
+	int notches = m_wheelDelta / WHEEL_DELTA;
+	m_wheelDelta %= WHEEL_DELTA;
+
+	if (notches == 0)
+	{
+		return;
+	}
+
+	uint64_t numRows = (linesPerNotch == WHEEL_PAGESCROLL)
+		? std::max<uint64_t>(GetNumVisibleRows(), 1)
+		: linesPerNotch;
+	uint64_t distance = numRows * static_cast<uint64_t>(std::abs(notches));
+
+	if (notches > 0)
+	{
+		ScrollToRow(m_topRow > distance ? m_topRow - distance : 0);
+	}
+	else
+	{
+		ScrollToRow(m_topRow + distance);
+	}
+}
+
+bool FilePreviewPane::OnKeyDown(UINT key)
+{
+	switch (key)
+	{
+	case VK_UP:
+		OnVScroll(SB_LINEUP);
+		return true;
+
+	case VK_DOWN:
+		OnVScroll(SB_LINEDOWN);
+		return true;
+
+	case VK_PRIOR:
+		OnVScroll(SB_PAGEUP);
+		return true;
+
+	case VK_NEXT:
+		OnVScroll(SB_PAGEDOWN);
+		return true;
+
+	case VK_HOME:
+		OnVScroll(SB_TOP);
+		return true;
+
+	case VK_END:
+		OnVScroll(SB_BOTTOM);
+		return true;
+	}
+
+	return false;
+}
+
+void FilePreviewPane::OnContextMenu(POINT ptScreen)
+{
+	if (m_fileState != FileState::Open)
+	{
+		return;
+	}
+
+	if (ptScreen.x == -1 && ptScreen.y == -1)
+	{
+		ptScreen = { 0, 0 };
+		ClientToScreen(m_hwnd, &ptScreen);
+	}
+
+	wil::unique_hmenu menu(CreatePopupMenu());
+	AppendMenu(menu.get(), MF_STRING, TextViewMenuItemId,
+		m_app->GetResourceLoader()->LoadString(IDS_PREVIEW_PANE_TEXT_VIEW).c_str());
+	AppendMenu(menu.get(), MF_STRING, HexViewMenuItemId,
+		m_app->GetResourceLoader()->LoadString(IDS_PREVIEW_PANE_HEX_VIEW).c_str());
+	CheckMenuRadioItem(menu.get(), TextViewMenuItemId, HexViewMenuItemId,
+		m_viewMode == ViewMode::Text ? TextViewMenuItemId : HexViewMenuItemId, MF_BYCOMMAND);
+
+	int selectedId = TrackPopupMenu(menu.get(), TPM_LEFTALIGN | TPM_RETURNCMD, ptScreen.x,
+		ptScreen.y, 0, m_hwnd, nullptr);
+
+	switch (selectedId)
+	{
+	case TextViewMenuItemId:
+		SetViewMode(ViewMode::Text);
+		break;
+
+	case HexViewMenuItemId:
+		SetViewMode(ViewMode::Hex);
+		break;
+	}
+}
+
+void FilePreviewPane::OnTimer(UINT_PTR timerId)
+{
+	if (timerId != INDEX_PROGRESS_TIMER_ID)
+	{
+		return;
+	}
+
+	if (!m_lineIndex || m_lineIndex->IsComplete())
+	{
+		KillTimer(m_hwnd, INDEX_PROGRESS_TIMER_ID);
+	}
+
+	if (m_viewMode == ViewMode::Text)
+	{
+		UpdateScrollBar();
+		InvalidateRect(m_hwnd, nullptr, false);
+	}
+}
+
+uint64_t FilePreviewPane::GetNumRows() const
+{
+	if (m_fileState != FileState::Open)
+	{
+		return 0;
+	}
+
+	if (m_viewMode == ViewMode::Text)
+	{
+		return m_lineIndex->GetNumLines();
+	}
+
+	return (m_file->GetSize() + HEX_BYTES_PER_ROW - 1) / HEX_BYTES_PER_ROW;
+}
+
+uint64_t FilePreviewPane::GetNumVisibleRows() const
+{
+	RECT contentRect = GetContentRect();
+
+	if (m_rowHeight == 0)
+	{
+		return 0;
+	}
+
+	return static_cast<uint64_t>(GetRectHeight(&contentRect) / m_rowHeight);
+}
+
+uint64_t FilePreviewPane::GetMaxTopRow() const
+{
+	uint64_t numRows = GetNumRows();
+	uint64_t numVisibleRows = GetNumVisibleRows();
+	return numRows > numVisibleRows ? numRows - numVisibleRows : 0;
+}
+
+// Returns the offset of the data shown at the top of the view.
+uint64_t FilePreviewPane::GetTopRowOffset()
+{
+	if (m_viewMode == ViewMode::Hex)
+	{
+		return m_topRow * HEX_BYTES_PER_ROW;
+	}
+
+	auto lines = m_lineIndex->GetLines(m_topRow, 1, *m_reader);
+	return lines.empty() ? m_detectedEncoding.bomSize : lines[0].offset;
+}
+
+std::optional<uint64_t> FilePreviewPane::GetRowForOffset(uint64_t offset)
+{
+	if (m_viewMode == ViewMode::Hex)
+	{
+		return offset / HEX_BYTES_PER_ROW;
+	}
+
+	return m_lineIndex->GetLineForOffset(offset, *m_reader);
+}
+
+void FilePreviewPane::ScrollToRow(uint64_t row)
+{
+	row = std::min(row, GetMaxTopRow());
+
+	if (row == m_topRow)
+	{
+		return;
+	}
+
+	m_topRow = row;
+
+	SetScrollPos(m_hwnd, SB_VERT, RowToScrollPosition(m_topRow), true);
+
+	RECT contentRect = GetContentRect();
+	InvalidateRect(m_hwnd, &contentRect, false);
+}
+
+void FilePreviewPane::UpdateScrollBar()
+{
+	uint64_t numRows = GetNumRows();
+	uint64_t maxTopRow = GetMaxTopRow();
+
+	// While the line index is being built, the number of lines only ever increases, so the top row
+	// remains valid.
+	m_topRow = std::min(m_topRow, maxTopRow);
+
+	SCROLLINFO scrollInfo = {};
+	scrollInfo.cbSize = sizeof(scrollInfo);
+	scrollInfo.fMask = SIF_RANGE | SIF_PAGE | SIF_POS;
+	scrollInfo.nMin = 0;
+
+	if (maxTopRow <= MAX_SCROLL_POSITION)
+	{
+		scrollInfo.nMax = static_cast<int>(numRows > 0 ? numRows - 1 : 0);
+		scrollInfo.nPage = static_cast<UINT>(GetNumVisibleRows());
+	}
+	else
+	{
+		scrollInfo.nMax = MAX_SCROLL_POSITION + SCALED_SCROLL_PAGE_SIZE - 1;
+		scrollInfo.nPage = SCALED_SCROLL_PAGE_SIZE;
+	}
+
+	scrollInfo.nPos = RowToScrollPosition(m_topRow);
+	SetScrollInfo(m_hwnd, SB_VERT, &scrollInfo, true);
+}
+
+int FilePreviewPane::RowToScrollPosition(uint64_t row) const
+{
+	uint64_t maxTopRow = GetMaxTopRow();
+
+	if (maxTopRow <= MAX_SCROLL_POSITION)
+	{
+		return static_cast<int>(row);
+	}
+
+	return static_cast<int>(static_cast<double>(row) / maxTopRow * MAX_SCROLL_POSITION);
+}
+
+uint64_t FilePreviewPane::ScrollPositionToRow(int position) const
+{
+	uint64_t maxTopRow = GetMaxTopRow();
+
+	if (maxTopRow <= MAX_SCROLL_POSITION)
+	{
+		return static_cast<uint64_t>(position);
+	}
+
+	return static_cast<uint64_t>(static_cast<double>(position) / MAX_SCROLL_POSITION * maxTopRow);
+}
+
+void FilePreviewPane::SetViewMode(ViewMode viewMode)
+{
+	if (viewMode == m_viewMode)
+	{
+		return;
+	}
+
+	// The view stays at the same position within the file.
+	uint64_t topRowOffset = GetTopRowOffset();
+
+	m_viewMode = viewMode;
+	m_topRow = 0;
+
+	if (m_viewMode == ViewMode::Text)
+	{
+		EnsureLineIndex();
+	}
+
+	m_topRow = GetRowForOffset(topRowOffset).value_or(0);
+
+	UpdateScrollBar();
+	InvalidateRect(m_hwnd, nullptr, false);
+}
+
+// The line index is only built once the text view is shown, since it isn't needed when a binary
+// file is only ever viewed as hex.
+void FilePreviewPane::EnsureLineIndex()
+{
+	if (m_lineIndex)
+	{
+		return;
+	}
+
+	m_lineIndex = std::make_shared<LineIndex>(m_file, m_detectedEncoding.encoding,
+		m_detectedEncoding.bomSize);
+
+	m_threadPool.push(
+		[lineIndex = m_lineIndex, stopToken = m_stopSource.get_token()](int id)
+		{
+			UNREFERENCED_PARAMETER(id);
+
+			lineIndex->Build(stopToken);
+		});
+
+	SetTimer(m_hwnd, INDEX_PROGRESS_TIMER_ID, INDEX_PROGRESS_TIMER_ELAPSED, nullptr);
+}
+
+void FilePreviewPane::StartSearch()
+{
+	if (m_fileState != FileState::Open || m_searching)
+	{
+		return;
+	}
+
+	auto searchText = GetWindowString(m_searchEdit);
+
+	if (searchText.empty())
+	{
+		return;
+	}
+
+	MappedFileSearchOptions options;
+	std::vector<std::byte> pattern;
+
+	// In the hex view, the search text is treated as a sequence of bytes, provided it's in that
+	// format.
+	auto hexBytes = (m_viewMode == ViewMode::Hex) ? ParseHexBytes(searchText) : std::nullopt;
+
+	if (hexBytes)
+	{
+		pattern = std::move(*hexBytes);
+	}
+	else
+	{
+		pattern = EncodeText(searchText, m_detectedEncoding.encoding);
+		options.caseSensitive = false;
+		options.alignment = GetCodeUnitSize(m_detectedEncoding.encoding);
+		options.alignmentBase = m_detectedEncoding.bomSize;
+	}
+
+	if (pattern.empty())
+	{
+		return;
+	}
+
+	uint64_t startOffset = m_match ? m_match->offset + 1 : GetTopRowOffset();
+
+	m_searching = true;
+	m_statusMessage = m_app->GetResourceLoader()->LoadString(IDS_PREVIEW_PANE_SEARCHING);
+	RECT statusRect = GetStatusRect();
+	InvalidateRect(m_hwnd, &statusRect, false);
+
+	m_threadPool.push(
+		[sender = m_backgroundResults.GetSender(), file = m_file, pattern = std::move(pattern),
+			options, startOffset, stopToken = m_stopSource.get_token()](int id)
+		{
+			UNREFERENCED_PARAMETER(id);
+
+			int numThreads = static_cast<int>(std::max(std::thread::hardware_concurrency(), 1u));
+			auto offset = SearchMappedFile(*file, pattern, startOffset, file->GetSize(), options,
+				numThreads, stopToken);
+
+			// If there's no match after the start offset, the search wraps around to the start of
+			// the file.
+			if (!offset && startOffset > 0)
+			{
+				offset = SearchMappedFile(*file, pattern, 0, startOffset, options, numThreads,
+					stopToken);
+			}
+
+			sender.Send(SearchResult{ offset, pattern.size() });
+		});
+}
+
+void FilePreviewPane::SetFile(const std::optional<std::wstring> &path)
+{
+	if (path == m_path)
+	{
+		return;
+	}
+
+	CancelBackgroundWork();
+
+	m_path = path;
+	m_file.reset();
+	m_reader.reset();
+	m_lineIndex.reset();
+	m_detectedEncoding = {};
+	m_topRow = 0;
+	m_searching = false;
+	m_match.reset();
+	m_statusMessage.reset();
+	KillTimer(m_hwnd, INDEX_PROGRESS_TIMER_ID);
+
+	if (path)
+	{
+		m_fileState = FileState::Opening;
+
+		// Opening the file can block (e.g. if it's on a network share), so it's done in the
+		// background.
+		m_threadPool.push(
+			[sender = m_backgroundResults.GetSender(), filePath = *path](int id)
+			{
+				UNREFERENCED_PARAMETER(id);
+
+				OpenedFile openedFile;
+				openedFile.file = MappedFile::Open(filePath);
+
+				if (openedFile.file)
+				{
+					auto view = openedFile.file->MapView(0, ENCODING_SAMPLE_SIZE);
+
+					if (view)
+					{
+						openedFile.detectedEncoding = DetectTextEncoding(view->GetData());
+					}
+				}
+
+				sender.Send(std::move(openedFile));
+			});
+	}
+	else
+	{
+		m_fileState = FileState::None;
+	}
+
+	UpdateScrollBar();
+	InvalidateRect(m_hwnd, nullptr, false);
+}
+
+void FilePreviewPane::CancelBackgroundWork()
+{
+	m_stopSource.request_stop();
+	m_stopSource = {};
+	m_backgroundResults.Invalidate();
+}
+
+void FilePreviewPane::ProcessBackgroundResult(BackgroundResult &&result)
+{
+	if (auto *openedFile = std::get_if<OpenedFile>(&result))
+	{
+		OnFileOpened(std::move(*openedFile));
+	}
+	else if (auto *searchResult = std::get_if<SearchResult>(&result))
+	{
+		OnSearchCompleted(*searchResult);
+	}
+}
+
+void FilePreviewPane::OnFileOpened(OpenedFile &&openedFile)
+{
+	if (!openedFile.file)
+	{
+		m_fileState = FileState::OpenFailed;
+		InvalidateRect(m_hwnd, nullptr, false);
+		return;
+	}
+
+	m_fileState = FileState::Open;
+	m_file = std::move(openedFile.file);
+	m_reader = std::make_unique<MappedFileReader>(m_file);
+	m_detectedEncoding = openedFile.detectedEncoding;
+	m_viewMode = m_detectedEncoding.isBinary ? ViewMode::Hex : ViewMode::Text;
+
+	if (m_viewMode == ViewMode::Text)
+	{
+		EnsureLineIndex();
+	}
+
+	UpdateScrollBar();
+	InvalidateRect(m_hwnd, nullptr, false);
+}
+
+void FilePreviewPane::OnSearchCompleted(const SearchResult &searchResult)
+{
+	m_searching = false;
+
+	if (!searchResult.offset)
+	{
+		m_statusMessage = m_app->GetResourceLoader()->LoadString(IDS_PREVIEW_PANE_NOT_FOUND);
+		InvalidateRect(m_hwnd, nullptr, false);
+		return;
+	}
+
+	m_match = Match{ *searchResult.offset, searchResult.patternSize };
+	m_statusMessage = fmt::format(
+		fmt::runtime(m_app->GetResourceLoader()->LoadString(IDS_PREVIEW_PANE_MATCH_FOUND)),
+		fmt::arg(L"offset", *searchResult.offset));
+
+	// In the text view, the match may be in a part of the file that hasn't been indexed yet, in
+	// which case the view can't scroll to it.
+	if (auto row = GetRowForOffset(*searchResult.offset))
+	{
+		uint64_t numVisibleRows = GetNumVisibleRows();
+		ScrollToRow(*row > numVisibleRows / 2 ? *row - numVisibleRows / 2 : 0);
+	}
+
+	InvalidateRect(m_hwnd, nullptr, false);
+}
+
+HWND FilePreviewPane::GetHWND() const
+{
+	return m_hwnd;
+}
@@ -0,0 +1,189 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#pragma once
+
+#include "Literals.h"
+#include "../Helper/ResultChannel.h"
+#include "../Helper/TextEncoding.h"
+#include "../ThirdParty/CTPL/cpl_stl.h"
+#include <boost/core/noncopyable.hpp>
+#include <wil/resource.h>
+#include <memory>
+#include <optional>
+#include <stop_token>
+#include <string>
+#include <variant>
+#include <vector>
+
+class App;
+class LineIndex;
+class MainFontSetter;
+class MappedFile;
+class MappedFileReader;
+class WindowSubclass;
+
+// Previews the contents of a file, either as text or as hex. The file is memory-mapped, with only
+// a few bounded windows mapped at a time and only the visible rows read, so scrolling is
+// independent of the size of the file. In the text view, lines are indexed on a background thread
+// and the view grows as the index is built.
+class FilePreviewPane : private boost::noncopyable
+{
+public:
+	static FilePreviewPane *Create(HWND parent, App *app);
+
+	HWND GetHWND() const;
+
+	// Shows the specified file. If no file is provided, the pane will be cleared.
+	void SetFile(const std::optional<std::wstring> &path);
+
+private:
+	static constexpr WCHAR CLASS_NAME[] = L"FilePreviewPane";
+
+	static constexpr int SEARCH_EDIT_HEIGHT = 24_px;
+	static constexpr int TEXT_HORIZONTAL_PADDING = 4_px;
+	static constexpr int FONT_POINT_SIZE = 10;
+	static constexpr int TAB_WIDTH = 4;
+
+	// The amount of data that's examined to determine the encoding of the file.
+	static constexpr size_t ENCODING_SAMPLE_SIZE = 64 * 1024;
+
+	// Lines can be arbitrarily long, so only the start of each line is read and displayed.
+	static constexpr size_t MAX_DISPLAYED_LINE_SIZE = 4096;
+
+	static constexpr size_t HEX_BYTES_PER_ROW = 16;
+
+	// Scroll bar positions are ints, so for files with more rows than this, the scroll position is
+	// scaled, rather than mapping directly to a row.
+	static constexpr int MAX_SCROLL_POSITION = 1'000'000'000;
+	static constexpr int SCALED_SCROLL_PAGE_SIZE = MAX_SCROLL_POSITION / 100;
+
+	static constexpr UINT_PTR INDEX_PROGRESS_TIMER_ID = 1;
+	static constexpr UINT INDEX_PROGRESS_TIMER_ELAPSED = 200;
+
+	enum class ViewMode
+	{
+		Text,
+		Hex
+	};
+
+	enum class FileState
+	{
+		None,
+		Opening,
+		OpenFailed,
+		Open
+	};
+
+	enum MenuItemId
+	{
+		TextViewMenuItemId = 1,
+		HexViewMenuItemId
+	};
+
+	struct OpenedFile
+	{
+		std::shared_ptr<MappedFile> file;
+		DetectedTextEncoding detectedEncoding;
+	};
+
+	struct SearchResult
+	{
+		std::optional<uint64_t> offset;
+		size_t patternSize;
+	};
+
+	struct Match
+	{
+		uint64_t offset;
+		size_t size;
+	};
+
+	using BackgroundResult = std::variant<OpenedFile, SearchResult>;
+
+	FilePreviewPane(HWND parent, App *app);
+	~FilePreviewPane();
+
+	static HWND CreatePreviewWindow(HWND parent, FilePreviewPane *previewPane);
+	static ATOM RegisterPreviewWindowClass();
+	static LRESULT CALLBACK WndProcStub(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam);
+	LRESULT WndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam);
+	LRESULT SearchEditSubclass(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam);
+
+	void CreateViewFont();
+	void UpdateLayout();
+	RECT GetContentRect() const;
+	RECT GetStatusRect() const;
+
+	void OnPaint();
+	void PaintMessage(HDC hdc, const RECT &contentRect, const std::wstring &message);
+	void PaintTextRows(HDC hdc, const RECT &contentRect);
+	void PaintHexRows(HDC hdc, const RECT &contentRect);
+	void PaintStatus(HDC hdc);
+	std::wstring GetStatusText() const;
+	COLORREF GetBackgroundColor() const;
+	COLORREF GetTextColor() const;
+
+	void OnVScroll(int scrollRequest);
+	void OnMouseWheel(short delta);
+	bool OnKeyDown(UINT key);
+	void OnContextMenu(POINT ptScreen);
+	void OnTimer(UINT_PTR timerId);
+
+	uint64_t GetNumRows() const;
+	uint64_t GetNumVisibleRows() const;
+	uint64_t GetMaxTopRow() const;
+	uint64_t GetTopRowOffset();
+	std::optional<uint64_t> GetRowForOffset(uint64_t offset);
+	void ScrollToRow(uint64_t row);
+	void UpdateScrollBar();
+	int RowToScrollPosition(uint64_t row) const;
+	uint64_t ScrollPositionToRow(int position) const;
+
+	void SetViewMode(ViewMode viewMode);
+	void EnsureLineIndex();
+	void StartSearch();
+
+	void CancelBackgroundWork();
+	void ProcessBackgroundResult(BackgroundResult &&result);
+	void OnFileOpened(OpenedFile &&openedFile);
+	void OnSearchCompleted(const SearchResult &searchResult);
+
+	// The window is created in the initializer list, so messages will be dispatched before the
+	// constructor has finished running. This is declared first, so that it always has a valid
+	// value and those messages can be ignored.
+	bool m_initialized = false;
+
+	const HWND m_hwnd;
+	App *const m_app;
+	HWND m_searchEdit = nullptr;
+	std::unique_ptr<MainFontSetter> m_searchEditFontSetter;
+	std::vector<std::unique_ptr<WindowSubclass>> m_windowSubclasses;
+
+	wil::unique_hfont m_font;
+	int m_rowHeight = 0;
+	int m_charWidth = 0;
+	int m_wheelDelta = 0;
+
+	std::optional<std::wstring> m_path;
+	FileState m_fileState = FileState::None;
+	std::shared_ptr<MappedFile> m_file;
+	std::unique_ptr<MappedFileReader> m_reader;
+	std::shared_ptr<LineIndex> m_lineIndex;
+	DetectedTextEncoding m_detectedEncoding;
+	ViewMode m_viewMode = ViewMode::Text;
+	uint64_t m_topRow = 0;
+
+	bool m_searching = false;
+	std::optional<Match> m_match;
+	std::optional<std::wstring> m_statusMessage;
+
+	// Requested whenever the file changes, so that any work for the previous file stops early.
+	std::stop_source m_stopSource;
+	ResultChannel<BackgroundResult> m_backgroundResults;
+
+	// This is declared last, so that the threads are stopped before anything they use is
+	// destroyed.
+	ctpl::thread_pool m_threadPool;
+};
@@ -0,0 +1,84 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "stdafx.h"
+#include "FolderPrefetchPredictor.h"
+#include "FrequentLocationsModel.h"
+#include "HistoryModel.h"
+#include <algorithm>
+
+namespace
+{
+
+struct Successor
+{
+	PidlAbsolute pidl;
+	int count;
+};
+
+}
+
+std::vector<PidlAbsolute> PredictNextFolders(const PidlAbsolute &currentFolder,
+	const HistoryModel *historyModel, const FrequentLocationsModel *frequentLocationsModel,
+	size_t maxPredictions)
+{
+	// History items are ordered from most to least recent, so the item visited directly after the
+	// item at index i is the item at index i - 1. As this list is iterated from most to least
+	// recent, successors with the same count will end up ordered by how recently they were used.
+	const auto &historyItems = historyModel->GetHistoryItems();
+	std::vector<Successor> successors;
+
+	for (size_t i = 1; i < historyItems.size(); i++)
+	{
+		if (historyItems[i] != currentFolder || historyItems[i - 1] == currentFolder)
+		{
+			continue;
+		}
+
+		auto itr = std::ranges::find(successors, historyItems[i - 1], &Successor::pidl);
+
+		if (itr != successors.end())
+		{
+			itr->count++;
+		}
+		else
+		{
+			successors.push_back({ historyItems[i - 1], 1 });
+		}
+	}
+
+	std::ranges::stable_sort(successors, std::ranges::greater{}, &Successor::count);
+
+	std::vector<PidlAbsolute> predictions;
+
+	for (const auto &successor : successors)
+	{
+		if (predictions.size() == maxPredictions)
+		{
+			return predictions;
+		}
+
+		predictions.push_back(successor.pidl);
+	}
+
+	for (const auto &visit : frequentLocationsModel->GetVisits())
+	{
+		if (predictions.size() == maxPredictions)
+		{
+			break;
+		}
+
+		const auto &location = visit.GetLocation();
+
+		if (!ILIsParent(currentFolder.Raw(), location.Raw(), TRUE)
+			|| std::ranges::find(predictions, location) != predictions.end())
+		{
+			continue;
+		}
+
+		predictions.push_back(location);
+	}
+
+	return predictions;
+}
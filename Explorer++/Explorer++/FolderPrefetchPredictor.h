@@ -0,0 +1,19 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#pragma once
+
+#include "../Helper/PidlHelper.h"
+#include <vector>
+
+class FrequentLocationsModel;
+class HistoryModel;
+
+// Returns the folders that are most likely to be navigated to next from the current folder, with
+// the most likely folder first. Folders that have previously been navigated to directly after the
+// current folder (as recorded in the global history) are ranked first, by the number of times that
+// happened. They're followed by the most frequently visited folders within the current folder.
+std::vector<PidlAbsolute> PredictNextFolders(const PidlAbsolute &currentFolder,
+	const HistoryModel *historyModel, const FrequentLocationsModel *frequentLocationsModel,
+	size_t maxPredictions);
@@ -5,15 +5,18 @@
 #include "stdafx.h"
 #include "FrequentLocationsModel.h"
 
-FrequentLocationsModel::FrequentLocationsModel(SystemClock *systemClock) :
-	m_systemClock(systemClock)
+FrequentLocationsModel::FrequentLocationsModel(SystemClock *systemClock, size_t maxLocations) :
+	m_systemClock(systemClock),
+	m_maxLocations(maxLocations)
 {
+	DCHECK_GT(m_maxLocations, 0u);
 }
 
 void FrequentLocationsModel::SetLocationVisits(const std::vector<LocationVisitInfo> &locationVisits)
 {
 	m_locationVisits.clear();
 	m_locationVisits.insert(locationVisits.begin(), locationVisits.end());
+	TrimLocations(m_maxLocations);
 	m_locationsChangedSignal();
 }
 
@@ -24,6 +27,9 @@ void FrequentLocationsModel::RegisterLocationVisit(const PidlAbsolute &pidl)
 
 	if (itr == locationIndex.end())
 	{
+		// Make room for the new location.
+		TrimLocations(m_maxLocations - 1);
+
 		locationIndex.emplace(pidl, 1, m_systemClock->Now());
 	}
 	else
@@ -35,6 +41,16 @@ void FrequentLocationsModel::RegisterLocationVisit(const PidlAbsolute &pidl)
 	m_locationsChangedSignal();
 }
 
+void FrequentLocationsModel::TrimLocations(size_t maxLocations)
+{
+	auto &visitsIndex = m_locationVisits.get<ByVisits>();
+
+	while (visitsIndex.size() > maxLocations)
+	{
+		visitsIndex.erase(std::prev(visitsIndex.end()));
+	}
+}
+
 const FrequentLocationsModel::ByVisitsIndex &FrequentLocationsModel::GetVisits() const
 {
 	return m_locationVisits.get<ByVisits>();
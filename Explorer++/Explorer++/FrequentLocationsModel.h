@@ -61,7 +61,12 @@ public:
 
 	using ByVisitsIndex = LocationVisits::index<ByVisits>::type;
 
-	FrequentLocationsModel(SystemClock *systemClock);
+	// Only the most frequently visited locations are saved, so there's little point in retaining an
+	// unlimited number of locations in memory. Once this limit is reached, the least frequently
+	// visited location will be removed whenever a new location is added.
+	static constexpr size_t DEFAULT_MAX_LOCATIONS = 1000;
+
+	FrequentLocationsModel(SystemClock *systemClock, size_t maxLocations = DEFAULT_MAX_LOCATIONS);
 
 	void SetLocationVisits(const std::vector<LocationVisitInfo> &locationVisits);
 	void RegisterLocationVisit(const PidlAbsolute &pidl);
@@ -70,7 +75,10 @@ public:
 		const LocationsChangedSignal::slot_type &observer);
 
 private:
+	void TrimLocations(size_t maxLocations);
+
 	SystemClock *const m_systemClock;
+	const size_t m_maxLocations;
 	LocationVisits m_locationVisits;
 	LocationsChangedSignal m_locationsChangedSignal;
 };
@@ -15,11 +15,13 @@
 #include "SortMenuBuilder.h"
 #include "TabContainerImpl.h"
 #include "../Helper/MenuHelper.h"
+#include "../Helper/Tracing.h"
 
 void Explorerplusplus::UpdateWindowStates(const Tab &tab)
 {
 	UpdateStatusBarText(tab);
 	UpdateDisplayWindow(tab);
+	UpdatePreviewPane(tab);
 }
 
 /*
@@ -77,6 +79,8 @@ void Explorerplusplus::SetProgramMenuItemStates(HMENU hProgramMenu)
 	MenuHelper::CheckItem(hProgramMenu, IDM_VIEW_STATUSBAR, m_config->showStatusBar);
 	MenuHelper::CheckItem(hProgramMenu, IDM_VIEW_FOLDERS, m_config->showFolders.get());
 	MenuHelper::CheckItem(hProgramMenu, IDM_VIEW_DISPLAYWINDOW, m_config->showDisplayWindow.get());
+	MenuHelper::CheckItem(hProgramMenu, IDM_VIEW_PREVIEWPANE, m_config->showPreviewPane.get());
+	MenuHelper::CheckItem(hProgramMenu, IDM_TOOLS_RECORDTRACE, GetTraceRecorder().IsEnabled());
 	MenuHelper::CheckItem(hProgramMenu, IDM_TOOLBARS_ADDRESSBAR, m_config->showAddressBar.get());
 	MenuHelper::CheckItem(hProgramMenu, IDM_TOOLBARS_MAINTOOLBAR, m_config->showMainToolbar.get());
 	MenuHelper::CheckItem(hProgramMenu, IDM_TOOLBARS_BOOKMARKSTOOLBAR,
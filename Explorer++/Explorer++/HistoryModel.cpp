@@ -15,9 +15,27 @@ void HistoryModel::AddHistoryItem(const PidlAbsolute &pidl)
 	}
 
 	m_historyItems.push_front(pidl);
+	TrimItems();
+
 	m_historyChangedSignal();
 }
 
+void HistoryModel::SetMaxItems(size_t maxItems)
+{
+	m_maxItems = maxItems;
+	TrimItems();
+}
+
+void HistoryModel::TrimItems()
+{
+	if (m_maxItems == 0 || m_historyItems.size() <= m_maxItems)
+	{
+		return;
+	}
+
+	m_historyItems.resize(m_maxItems);
+}
+
 const std::deque<PidlAbsolute> &HistoryModel::GetHistoryItems() const
 {
 	return m_historyItems;
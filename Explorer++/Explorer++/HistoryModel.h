@@ -16,6 +16,10 @@ public:
 
 	void AddHistoryItem(const PidlAbsolute &pidl);
 
+	// Limits the number of items that are retained, with the oldest items being removed first. A
+	// value of 0 means that the number of items isn't limited.
+	void SetMaxItems(size_t maxItems);
+
 	// Returns the set of history items, with more recent items appearing first.
 	const std::deque<PidlAbsolute> &GetHistoryItems() const;
 
@@ -23,6 +27,9 @@ public:
 		const HistoryChangedSignal::slot_type &observer);
 
 private:
+	void TrimItems();
+
 	std::deque<PidlAbsolute> m_historyItems;
+	size_t m_maxItems = 0;
 	HistoryChangedSignal m_historyChangedSignal;
 };
@@ -18,17 +18,20 @@
 
 HolderWindow *HolderWindow::Create(HWND parent, const std::wstring &caption, DWORD style,
 	const std::wstring &closeButtonTooltip, const Config *config,
-	const IconResourceLoader *iconResourceLoader, const DarkModeManager *darkModeManager)
+	const IconResourceLoader *iconResourceLoader, const DarkModeManager *darkModeManager,
+	ResizeEdge resizeEdge)
 {
 	return new HolderWindow(parent, caption, style, closeButtonTooltip, config, iconResourceLoader,
-		darkModeManager);
+		darkModeManager, resizeEdge);
 }
 
 HolderWindow::HolderWindow(HWND parent, const std::wstring &caption, DWORD style,
 	const std::wstring &closeButtonTooltip, const Config *config,
-	const IconResourceLoader *iconResourceLoader, const DarkModeManager *darkModeManager) :
+	const IconResourceLoader *iconResourceLoader, const DarkModeManager *darkModeManager,
+	ResizeEdge resizeEdge) :
 	m_hwnd(CreateHolderWindow(parent, caption, style)),
 	m_darkModeManager(darkModeManager),
+	m_resizeEdge(resizeEdge),
 	m_sizingCursor(LoadCursor(nullptr, IDC_SIZEWE))
 {
 	LOGFONT systemFont = GetDefaultSystemFontScaledToWindow(m_hwnd);
@@ -283,10 +286,13 @@ void HolderWindow::UpdateLayout(int width, int height)
 
 	if (m_contentChild)
 	{
+		// The padding leaves space next to the resize edge, so that a resize can be started.
 		auto contentHorizontalPadding =
-			dpiCompatibility.ScaleValue(m_hwnd, CONTENT_SECTION_RIGHT_PADDING);
-		deferInfo = DeferWindowPos(deferInfo, m_contentChild, nullptr, 0, captionSectionHeight,
-			width - contentHorizontalPadding, height - captionSectionHeight, SWP_NOZORDER);
+			dpiCompatibility.ScaleValue(m_hwnd, CONTENT_SECTION_EDGE_PADDING);
+		int contentLeft = (m_resizeEdge == ResizeEdge::Left) ? contentHorizontalPadding : 0;
+		deferInfo = DeferWindowPos(deferInfo, m_contentChild, nullptr, contentLeft,
+			captionSectionHeight, width - contentHorizontalPadding,
+			height - captionSectionHeight, SWP_NOZORDER);
 	}
 
 	[[maybe_unused]] auto res = EndDeferWindowPos(deferInfo);
@@ -330,7 +336,8 @@ void HolderWindow::OnLButtonDown(const POINT &pt)
 
 		RECT clientRect;
 		GetClientRect(m_hwnd, &clientRect);
-		m_resizeDistanceToEdge = clientRect.right - pt.x;
+		m_resizeDistanceToEdge =
+			(m_resizeEdge == ResizeEdge::Left) ? pt.x - clientRect.left : clientRect.right - pt.x;
 
 		SetCapture(m_hwnd);
 	}
@@ -351,7 +358,18 @@ int HolderWindow::OnMouseMove(const POINT &pt)
 		RECT clientRect;
 		GetClientRect(m_hwnd, &clientRect);
 
-		int newWidth = std::max(pt.x + m_resizeDistanceToEdge.value(), 0L);
+		int newWidth;
+
+		if (m_resizeEdge == ResizeEdge::Left)
+		{
+			// The right edge of the window stays fixed, so the width is based on how far the
+			// cursor is from that edge.
+			newWidth = std::max(clientRect.right - pt.x + m_resizeDistanceToEdge.value(), 0L);
+		}
+		else
+		{
+			newWidth = std::max(pt.x + m_resizeDistanceToEdge.value(), 0L);
+		}
 
 		if (m_resizedCallback)
 		{
@@ -378,7 +396,7 @@ bool HolderWindow::OnSetCursor(HWND target)
 	if (IsCursorInResizeStartRange(ptCursor))
 	{
 		// Without this, the cursor would switch back and forth between the sizing cursor and arrow
-		// cursor when near the right edge of the window.
+		// cursor when near the resize edge of the window.
 		SetCursor(m_sizingCursor);
 		return true;
 	}
@@ -394,6 +412,11 @@ bool HolderWindow::IsCursorInResizeStartRange(const POINT &ptCursor)
 	InflateRect(&clientRect,
 		-DpiCompatibility::GetInstance().ScaleValue(m_hwnd, RESIZE_START_RANGE), 0);
 
+	if (m_resizeEdge == ResizeEdge::Left)
+	{
+		return ptCursor.x < clientRect.left;
+	}
+
 	return ptCursor.x >= clientRect.right;
 }
 
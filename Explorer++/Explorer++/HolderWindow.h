@@ -20,9 +20,19 @@ public:
 	using ResizedCallback = std::function<void(int newWidth)>;
 	using CloseButtonClickedCallback = std::function<void()>;
 
+	// The edge of the window that can be dragged to resize it. A window placed on the left side of
+	// its parent is resized from the right edge, while a window placed on the right side is resized
+	// from the left edge.
+	enum class ResizeEdge
+	{
+		Right,
+		Left
+	};
+
 	static HolderWindow *Create(HWND parent, const std::wstring &caption, DWORD style,
 		const std::wstring &closeButtonTooltip, const Config *config,
-		const IconResourceLoader *iconResourceLoader, const DarkModeManager *darkModeManager);
+		const IconResourceLoader *iconResourceLoader, const DarkModeManager *darkModeManager,
+		ResizeEdge resizeEdge = ResizeEdge::Right);
 
 	HWND GetHWND() const;
 	void SetContentChild(HWND contentChild);
@@ -35,16 +45,17 @@ private:
 	static constexpr int CAPTION_SECTION_HORIZONTAL_PADDING = 4_px;
 	static constexpr int CAPTION_SECTION_VERTICAL_PADDING = 1_px;
 
-	static constexpr int CONTENT_SECTION_RIGHT_PADDING = 4_px;
+	static constexpr int CONTENT_SECTION_EDGE_PADDING = 4_px;
 
 	static constexpr int CLOSE_BUTTON_ID = 1;
 
-	// A resize can be started if the cursor is this many pixels from the right edge of the window.
+	// A resize can be started if the cursor is this many pixels from the resize edge of the window.
 	static constexpr int RESIZE_START_RANGE = 6_px;
 
 	HolderWindow(HWND parent, const std::wstring &caption, DWORD style,
 		const std::wstring &closeButtonTooltip, const Config *config,
-		const IconResourceLoader *iconResourceLoader, const DarkModeManager *darkModeManager);
+		const IconResourceLoader *iconResourceLoader, const DarkModeManager *darkModeManager,
+		ResizeEdge resizeEdge);
 	HWND CreateHolderWindow(HWND parent, const std::wstring &caption, DWORD style);
 	static ATOM RegisterHolderWindowClass();
 
@@ -76,6 +87,7 @@ private:
 
 	const HWND m_hwnd;
 	const DarkModeManager *const m_darkModeManager;
+	const ResizeEdge m_resizeEdge;
 	HWND m_contentChild = nullptr;
 	HFONT m_font = nullptr;
 	wil::unique_hfont m_defaultFont = nullptr;
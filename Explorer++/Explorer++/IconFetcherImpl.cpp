@@ -4,21 +4,25 @@
 
 #include "stdafx.h"
 #include "IconFetcherImpl.h"
+#include "RuntimeHelper.h"
 #include "../Helper/CachedIcons.h"
-#include "../Helper/WindowSubclass.h"
+#include "../Helper/Tracing.h"
 
-IconFetcherImpl::IconFetcherImpl(HWND hwnd, CachedIcons *cachedIcons) :
-	m_hwnd(hwnd),
+IconFetcherImpl::IconFetcherImpl(const Runtime *runtime, CachedIcons *cachedIcons) :
 	m_cachedIcons(cachedIcons),
-	m_iconThreadPool(1, std::bind(CoInitializeEx, nullptr, COINIT_APARTMENTTHREADED),
+	m_iconThreadPool(
+		1,
+		[]
+		{
+			CoInitializeEx(nullptr, COINIT_APARTMENTTHREADED);
+			GetTraceRecorder().SetCurrentThreadName("Icon thread");
+		},
 		CoUninitialize),
-	m_iconResultIDCounter(0)
+	m_iconResults(MakeUiThreadScheduler(runtime),
+		std::bind_front(&IconFetcherImpl::ProcessIconResult, this))
 {
 	FAIL_FAST_IF_FAILED(GetDefaultFileIconIndex(m_defaultFileIconIndex));
 	FAIL_FAST_IF_FAILED(GetDefaultFolderIconIndex(m_defaultFolderIconIndex));
-
-	m_windowSubclasses.push_back(std::make_unique<WindowSubclass>(hwnd,
-		std::bind_front(&IconFetcherImpl::OwnerWindowSubclass, this)));
 }
 
 IconFetcherImpl::~IconFetcherImpl()
@@ -26,28 +30,15 @@ IconFetcherImpl::~IconFetcherImpl()
 	m_iconThreadPool.clear_queue();
 }
 
-LRESULT IconFetcherImpl::OwnerWindowSubclass(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam)
-{
-	switch (msg)
-	{
-	case WM_APP_ICON_RESULT_READY:
-		ProcessIconResult(static_cast<int>(wParam));
-		return 0;
-		break;
-	}
-
-	return DefSubclassProc(hwnd, msg, wParam, lParam);
-}
-
 void IconFetcherImpl::QueueIconTask(std::wstring_view path, Callback callback)
 {
-	int iconResultID = m_iconResultIDCounter++;
-
-	auto iconResult = m_iconThreadPool.push(
-		[this, iconResultID, copiedPath = std::wstring(path)](int id) -> std::optional<IconResult>
+	m_iconThreadPool.push(
+		[sender = m_iconResults.GetSender(), copiedPath = std::wstring(path), callback](int id)
 		{
 			UNREFERENCED_PARAMETER(id);
 
+			TRACE_SCOPE("icons", "FindIcon");
+
 			// SHGetFileInfo will fail for non-filesystem paths that are passed in
 			// as strings. For example, attempting to retrieve the icon for the
 			// recycle bin will fail if you pass the parsing path (i.e.
@@ -60,44 +51,38 @@ void IconFetcherImpl::QueueIconTask(std::wstring_view path, Callback callback)
 
 			if (FAILED(hr))
 			{
-				return std::nullopt;
+				return;
 			}
 
 			auto iconInfo = FindIconAsync(pidl.get());
 
 			if (!iconInfo)
 			{
-				return std::nullopt;
+				// Icon lookup failed.
+				return;
 			}
 
 			IconResult result;
 			result.iconIndex = iconInfo->iconIndex;
 			result.overlayIndex = iconInfo->overlayIndex;
 			result.path = copiedPath;
-
-			PostMessage(m_hwnd, WM_APP_ICON_RESULT_READY, iconResultID, 0);
-
-			return result;
+			result.callback = callback;
+			sender.Send(std::move(result));
 		});
-
-	FutureResult futureResult;
-	futureResult.callback = callback;
-	futureResult.iconResult = std::move(iconResult);
-	m_iconResults.insert({ iconResultID, std::move(futureResult) });
 }
 
 void IconFetcherImpl::QueueIconTask(PCIDLIST_ABSOLUTE pidl, Callback callback)
 {
-	int iconResultID = m_iconResultIDCounter++;
-
 	BasicItemInfo basicItemInfo;
 	basicItemInfo.pidl.reset(ILCloneFull(pidl));
 
-	auto iconResult = m_iconThreadPool.push(
-		[this, iconResultID, basicItemInfo](int id) -> std::optional<IconResult>
+	m_iconThreadPool.push(
+		[sender = m_iconResults.GetSender(), basicItemInfo, callback](int id)
 		{
 			UNREFERENCED_PARAMETER(id);
 
+			TRACE_SCOPE("icons", "FindIcon");
+
 			// It's important that pidl is updated. Otherwise, the icon that's retrieved may be the
 			// original icon.
 			PidlAbsolute updatedPidl;
@@ -118,7 +103,8 @@ void IconFetcherImpl::QueueIconTask(PCIDLIST_ABSOLUTE pidl, Callback callback)
 
 			if (!iconInfo)
 			{
-				return std::nullopt;
+				// Icon lookup failed.
+				return;
 			}
 
 			IconResult result;
@@ -133,15 +119,9 @@ void IconFetcherImpl::QueueIconTask(PCIDLIST_ABSOLUTE pidl, Callback callback)
 				result.path = filePath;
 			}
 
-			PostMessage(m_hwnd, WM_APP_ICON_RESULT_READY, iconResultID, 0);
-
-			return result;
+			result.callback = callback;
+			sender.Send(std::move(result));
 		});
-
-	FutureResult futureResult;
-	futureResult.callback = callback;
-	futureResult.iconResult = std::move(iconResult);
-	m_iconResults.insert({ iconResultID, std::move(futureResult) });
 }
 
 std::optional<ShellIconInfo> IconFetcherImpl::FindIconAsync(PCIDLIST_ABSOLUTE pidl)
@@ -162,36 +142,20 @@ std::optional<ShellIconInfo> IconFetcherImpl::FindIconAsync(PCIDLIST_ABSOLUTE pi
 	return ExtractShellIconParts(shfi.iIcon);
 }
 
-void IconFetcherImpl::ProcessIconResult(int iconResultId)
+void IconFetcherImpl::ProcessIconResult(const IconResult &result)
 {
-	auto itr = m_iconResults.find(iconResultId);
-
-	if (itr == m_iconResults.end())
-	{
-		return;
-	}
-
-	auto &futureResult = itr->second;
-	auto result = futureResult.iconResult.get();
-
-	if (!result)
-	{
-		// Icon lookup failed.
-		return;
-	}
-
-	if (!result->path.empty())
+	if (!result.path.empty())
 	{
-		m_cachedIcons->AddOrUpdateIcon(result->path, result->iconIndex);
+		m_cachedIcons->AddOrUpdateIcon(result.path, result.iconIndex);
 	}
 
-	futureResult.callback(result->iconIndex, result->overlayIndex);
+	result.callback(result.iconIndex, result.overlayIndex);
 }
 
 void IconFetcherImpl::ClearQueue()
 {
 	m_iconThreadPool.clear_queue();
-	m_iconResults.clear();
+	m_iconResults.Invalidate();
 }
 
 int IconFetcherImpl::GetCachedIconIndexOrDefault(const std::wstring &itemPath,
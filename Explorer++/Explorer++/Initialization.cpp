@@ -42,6 +42,7 @@ void Explorerplusplus::Initialize(const WindowStorageData *storageData)
 	InitializeDisplayWindow();
 	InitializeTabs();
 	CreateFolderControls();
+	CreatePreviewPane();
 
 	/* All child windows MUST be resized before
 	any listview changes take place. If auto arrange
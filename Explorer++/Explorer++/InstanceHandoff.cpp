@@ -0,0 +1,565 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "stdafx.h"
+#include "InstanceHandoff.h"
+#include "../Helper/LocalPipe.h"
+#include <algorithm>
+#include <utility>
+
+namespace
+{
+
+// "EXPH", when written out as a little-endian value.
+constexpr uint32_t PAYLOAD_MAGIC = 0x48505845;
+
+constexpr uint16_t FLAG_JUMPLIST_NEW_TAB = 0x1;
+
+// A connected client should send its request immediately, so there's no need to wait long for it.
+// This also limits how long a misbehaving client can hold up other clients.
+constexpr std::chrono::milliseconds SERVER_IO_TIMEOUT(500);
+
+class PayloadWriter
+{
+public:
+	explicit PayloadWriter(size_t expectedSize = 0)
+	{
+		m_data.reserve(expectedSize);
+	}
+
+	void WriteUInt8(uint8_t value)
+	{
+		m_data.push_back(static_cast<std::byte>(value));
+	}
+
+	void WriteUInt16(uint16_t value)
+	{
+		WriteUInt8(static_cast<uint8_t>(value));
+		WriteUInt8(static_cast<uint8_t>(value >> 8));
+	}
+
+	void WriteUInt32(uint32_t value)
+	{
+		WriteUInt16(static_cast<uint16_t>(value));
+		WriteUInt16(static_cast<uint16_t>(value >> 16));
+	}
+
+	void WriteString(const std::wstring &value)
+	{
+		std::vector<uint16_t> codeUnits;
+		codeUnits.reserve(value.size());
+
+		for (wchar_t character : value)
+		{
+			auto codePoint = static_cast<uint32_t>(character);
+
+			// This can only happen when wchar_t is 32 bits, in which case, the character needs to
+			// be encoded as a surrogate pair.
+			if (codePoint > 0xFFFF)
+			{
+				codePoint -= 0x10000;
+				codeUnits.push_back(static_cast<uint16_t>(0xD800 + (codePoint >> 10)));
+				codeUnits.push_back(static_cast<uint16_t>(0xDC00 + (codePoint & 0x3FF)));
+			}
+			else
+			{
+				codeUnits.push_back(static_cast<uint16_t>(codePoint));
+			}
+		}
+
+		WriteUInt32(static_cast<uint32_t>(codeUnits.size()));
+
+		for (uint16_t codeUnit : codeUnits)
+		{
+			WriteUInt16(codeUnit);
+		}
+	}
+
+	void WriteBytes(std::span<const std::byte> data)
+	{
+		m_data.insert(m_data.end(), data.begin(), data.end());
+	}
+
+	std::vector<std::byte> TakeData()
+	{
+		return std::move(m_data);
+	}
+
+private:
+	std::vector<std::byte> m_data;
+};
+
+class PayloadReader
+{
+public:
+	explicit PayloadReader(std::span<const std::byte> data) : m_data(data)
+	{
+	}
+
+	bool ReadUInt8(uint8_t &value)
+	{
+		if (m_data.empty())
+		{
+			return false;
+		}
+
+		value = static_cast<uint8_t>(m_data[0]);
+		m_data = m_data.subspan(1);
+		return true;
+	}
+
+	bool ReadUInt16(uint16_t &value)
+	{
+		uint8_t low;
+		uint8_t high;
+
+		if (!ReadUInt8(low) || !ReadUInt8(high))
+		{
+			return false;
+		}
+
+		value = static_cast<uint16_t>(low | (high << 8));
+		return true;
+	}
+
+	bool ReadUInt32(uint32_t &value)
+	{
+		uint16_t low;
+		uint16_t high;
+
+		if (!ReadUInt16(low) || !ReadUInt16(high))
+		{
+			return false;
+		}
+
+		value = static_cast<uint32_t>(low) | (static_cast<uint32_t>(high) << 16);
+		return true;
+	}
+
+	bool ReadString(std::wstring &value)
+	{
+		uint32_t numCodeUnits;
+
+		if (!ReadUInt32(numCodeUnits) || numCodeUnits > m_data.size() / 2)
+		{
+			return false;
+		}
+
+		value.clear();
+		value.reserve(numCodeUnits);
+
+		for (uint32_t i = 0; i < numCodeUnits; i++)
+		{
+			uint16_t codeUnit = 0;
+			ReadUInt16(codeUnit);
+
+			// When wchar_t is 32 bits, surrogate pairs need to be combined. An unpaired surrogate
+			// is kept as-is, since it's valid within a Windows path.
+			if constexpr (sizeof(wchar_t) > 2)
+			{
+				uint16_t nextCodeUnit;
+
+				if (codeUnit >= 0xD800 && codeUnit <= 0xDBFF && i + 1 < numCodeUnits
+					&& PeekUInt16(nextCodeUnit) && nextCodeUnit >= 0xDC00
+					&& nextCodeUnit <= 0xDFFF)
+				{
+					ReadUInt16(nextCodeUnit);
+					i++;
+
+					value.push_back(static_cast<wchar_t>(
+						0x10000 + ((codeUnit - 0xD800) << 10) + (nextCodeUnit - 0xDC00)));
+					continue;
+				}
+			}
+
+			value.push_back(static_cast<wchar_t>(codeUnit));
+		}
+
+		return true;
+	}
+
+	size_t GetRemainingSize() const
+	{
+		return m_data.size();
+	}
+
+private:
+	bool PeekUInt16(uint16_t &value) const
+	{
+		PayloadReader copy(m_data);
+		return copy.ReadUInt16(value);
+	}
+
+	std::span<const std::byte> m_data;
+};
+
+bool ReadExact(LocalPipeConnection &connection, std::span<std::byte> data,
+	std::chrono::steady_clock::time_point deadline)
+{
+	while (!data.empty())
+	{
+		auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+			deadline - std::chrono::steady_clock::now());
+
+		if (remaining.count() <= 0)
+		{
+			return false;
+		}
+
+		size_t numBytesRead = connection.Read(data, remaining);
+
+		if (numBytesRead == 0)
+		{
+			return false;
+		}
+
+		data = data.subspan(numBytesRead);
+	}
+
+	return true;
+}
+
+}
+
+std::vector<std::byte> EncodeInstanceHandoffRequest(const InstanceHandoffRequest &request,
+	uint16_t version)
+{
+	PayloadWriter writer;
+	writer.WriteUInt32(PAYLOAD_MAGIC);
+	writer.WriteUInt16(version);
+	writer.WriteUInt16(request.jumplistNewTab ? FLAG_JUMPLIST_NEW_TAB : 0);
+	writer.WriteUInt32(static_cast<uint32_t>(request.directories.size()));
+
+	for (const auto &directory : request.directories)
+	{
+		writer.WriteString(directory);
+	}
+
+	return writer.TakeData();
+}
+
+InstanceHandoffStatus DecodeInstanceHandoffRequest(std::span<const std::byte> payload,
+	InstanceHandoffRequest &request)
+{
+	PayloadReader reader(payload);
+
+	uint32_t magic;
+	uint16_t version;
+
+	if (!reader.ReadUInt32(magic) || magic != PAYLOAD_MAGIC || !reader.ReadUInt16(version))
+	{
+		return InstanceHandoffStatus::Malformed;
+	}
+
+	// Later versions may change the layout of everything that follows the version, so nothing
+	// else can be interpreted.
+	if (version != INSTANCE_HANDOFF_PROTOCOL_VERSION)
+	{
+		return InstanceHandoffStatus::UnsupportedVersion;
+	}
+
+	uint16_t flags;
+	uint32_t numDirectories;
+
+	// Each directory takes up at least 4 bytes, which allows an invalid count to be detected
+	// before any memory is allocated.
+	if (!reader.ReadUInt16(flags) || !reader.ReadUInt32(numDirectories)
+		|| numDirectories > reader.GetRemainingSize() / 4)
+	{
+		return InstanceHandoffStatus::Malformed;
+	}
+
+	InstanceHandoffRequest decodedRequest;
+	decodedRequest.jumplistNewTab = (flags & FLAG_JUMPLIST_NEW_TAB) != 0;
+	decodedRequest.directories.resize(numDirectories);
+
+	for (auto &directory : decodedRequest.directories)
+	{
+		if (!reader.ReadString(directory))
+		{
+			return InstanceHandoffStatus::Malformed;
+		}
+	}
+
+	if (reader.GetRemainingSize() != 0)
+	{
+		return InstanceHandoffStatus::Malformed;
+	}
+
+	request = std::move(decodedRequest);
+
+	return InstanceHandoffStatus::Accepted;
+}
+
+std::vector<std::byte> EncodeInstanceHandoffResponse(InstanceHandoffStatus status)
+{
+	PayloadWriter writer;
+	writer.WriteUInt32(PAYLOAD_MAGIC);
+	writer.WriteUInt16(INSTANCE_HANDOFF_PROTOCOL_VERSION);
+	writer.WriteUInt8(static_cast<uint8_t>(status));
+	return writer.TakeData();
+}
+
+std::optional<InstanceHandoffStatus> DecodeInstanceHandoffResponse(
+	std::span<const std::byte> payload)
+{
+	PayloadReader reader(payload);
+
+	uint32_t magic;
+	uint16_t version;
+	uint8_t status;
+
+	// The response layout is the same in every version, so the version isn't checked. That allows
+	// a client to find out that its version isn't supported.
+	if (!reader.ReadUInt32(magic) || magic != PAYLOAD_MAGIC || !reader.ReadUInt16(version)
+		|| !reader.ReadUInt8(status) || reader.GetRemainingSize() != 0
+		|| status > static_cast<uint8_t>(InstanceHandoffStatus::Malformed))
+	{
+		return std::nullopt;
+	}
+
+	return static_cast<InstanceHandoffStatus>(status);
+}
+
+bool WriteInstanceHandoffFrame(LocalPipeConnection &connection, std::span<const std::byte> payload,
+	std::chrono::milliseconds timeout)
+{
+	if (payload.size() > INSTANCE_HANDOFF_MAX_FRAME_SIZE)
+	{
+		return false;
+	}
+
+	// The size and payload are written together, so that the frame is sent in a single write.
+	PayloadWriter writer(sizeof(uint32_t) + payload.size());
+	writer.WriteUInt32(static_cast<uint32_t>(payload.size()));
+	writer.WriteBytes(payload);
+
+	return connection.Write(writer.TakeData(), timeout);
+}
+
+std::optional<std::vector<std::byte>> ReadInstanceHandoffFrame(LocalPipeConnection &connection,
+	std::chrono::milliseconds timeout)
+{
+	auto deadline = std::chrono::steady_clock::now() + timeout;
+
+	std::byte sizeData[4];
+
+	if (!ReadExact(connection, sizeData, deadline))
+	{
+		return std::nullopt;
+	}
+
+	uint32_t payloadSize;
+	PayloadReader(sizeData).ReadUInt32(payloadSize);
+
+	if (payloadSize > INSTANCE_HANDOFF_MAX_FRAME_SIZE)
+	{
+		return std::nullopt;
+	}
+
+	std::vector<std::byte> payload(payloadSize);
+
+	if (!ReadExact(connection, payload, deadline))
+	{
+		return std::nullopt;
+	}
+
+	return payload;
+}
+
+std::wstring GetInstanceHandoffPipeName(const std::wstring &instanceName, uint32_t sessionId)
+{
+	return L"Explorer++Handoff-" + instanceName + L"-" + std::to_wstring(sessionId);
+}
+
+std::optional<InstanceHandoffStatus> SendInstanceHandoffRequest(const std::wstring &pipeName,
+	const InstanceHandoffRequest &request, std::chrono::milliseconds timeout,
+	std::function<void(uint32_t serverProcessId)> onConnected)
+{
+	auto deadline = std::chrono::steady_clock::now() + timeout;
+	auto connection = LocalPipeConnection::Connect(pipeName, timeout);
+
+	if (!connection)
+	{
+		return std::nullopt;
+	}
+
+	if (onConnected)
+	{
+		onConnected(connection->GetPeerProcessId());
+	}
+
+	auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+		deadline - std::chrono::steady_clock::now());
+
+	if (remaining.count() <= 0
+		|| !WriteInstanceHandoffFrame(*connection, EncodeInstanceHandoffRequest(request),
+			remaining))
+	{
+		return std::nullopt;
+	}
+
+	remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+		deadline - std::chrono::steady_clock::now());
+
+	if (remaining.count() <= 0)
+	{
+		return std::nullopt;
+	}
+
+	auto response = ReadInstanceHandoffFrame(*connection, remaining);
+
+	if (!response)
+	{
+		return std::nullopt;
+	}
+
+	return DecodeInstanceHandoffResponse(*response);
+}
+
+InstanceHandoffBatcher::InstanceHandoffBatcher(const InstanceHandoffTiming &timing) :
+	m_timing(timing)
+{
+}
+
+void InstanceHandoffBatcher::Add(InstanceHandoffRequest request, Clock::time_point now)
+{
+	if (m_pendingRequests.empty())
+	{
+		m_firstRequestTime = now;
+	}
+
+	m_lastRequestTime = now;
+	m_pendingRequests.push_back(std::move(request));
+}
+
+std::optional<InstanceHandoffBatcher::Clock::time_point> InstanceHandoffBatcher::GetDeadline()
+	const
+{
+	if (m_pendingRequests.empty())
+	{
+		return std::nullopt;
+	}
+
+	return std::min(m_firstRequestTime + m_timing.maxDelay,
+		m_lastRequestTime + m_timing.quietPeriod);
+}
+
+std::vector<InstanceHandoffRequest> InstanceHandoffBatcher::TakeBatchIfDue(Clock::time_point now)
+{
+	auto deadline = GetDeadline();
+
+	if (!deadline || now < *deadline)
+	{
+		return {};
+	}
+
+	return std::exchange(m_pendingRequests, {});
+}
+
+std::unique_ptr<InstanceHandoffServer> InstanceHandoffServer::Create(const std::wstring &pipeName,
+	RequestFilter requestFilter, BatchCallback batchCallback, const InstanceHandoffTiming &timing)
+{
+	auto pipeServer = LocalPipeServer::Create(pipeName);
+
+	if (!pipeServer)
+	{
+		return nullptr;
+	}
+
+	return std::unique_ptr<InstanceHandoffServer>(new InstanceHandoffServer(std::move(pipeServer),
+		std::move(requestFilter), std::move(batchCallback), timing));
+}
+
+InstanceHandoffServer::InstanceHandoffServer(std::unique_ptr<LocalPipeServer> pipeServer,
+	RequestFilter requestFilter, BatchCallback batchCallback,
+	const InstanceHandoffTiming &timing) :
+	m_pipeServer(std::move(pipeServer)),
+	m_requestFilter(std::move(requestFilter)),
+	m_batchCallback(std::move(batchCallback)),
+	m_batcher(timing),
+	m_acceptThread(std::bind_front(&InstanceHandoffServer::AcceptConnections, this)),
+	m_deliveryThread(std::bind_front(&InstanceHandoffServer::DeliverBatches, this))
+{
+}
+
+InstanceHandoffServer::~InstanceHandoffServer()
+{
+	m_pipeServer->Stop();
+
+	// The threads need to be joined here, before any of the members they use are destroyed.
+	m_deliveryThread.request_stop();
+	m_deliveryThread.join();
+	m_acceptThread.join();
+}
+
+void InstanceHandoffServer::AcceptConnections()
+{
+	while (auto connection = m_pipeServer->Accept())
+	{
+		HandleConnection(*connection);
+	}
+}
+
+void InstanceHandoffServer::HandleConnection(LocalPipeConnection &connection)
+{
+	auto payload = ReadInstanceHandoffFrame(connection, SERVER_IO_TIMEOUT);
+
+	if (!payload)
+	{
+		return;
+	}
+
+	InstanceHandoffRequest request;
+	auto status = DecodeInstanceHandoffRequest(*payload, request);
+
+	if (status == InstanceHandoffStatus::Accepted && m_requestFilter && !m_requestFilter(request))
+	{
+		status = InstanceHandoffStatus::Declined;
+	}
+
+	// The request is queued before being acknowledged, so that it will still be handled if the
+	// client gives up waiting for the response.
+	if (status == InstanceHandoffStatus::Accepted)
+	{
+		std::scoped_lock lock(m_mutex);
+		m_batcher.Add(std::move(request), InstanceHandoffBatcher::Clock::now());
+		m_requestAddedCondition.notify_one();
+	}
+
+	WriteInstanceHandoffFrame(connection, EncodeInstanceHandoffResponse(status),
+		SERVER_IO_TIMEOUT);
+}
+
+void InstanceHandoffServer::DeliverBatches(std::stop_token stopToken)
+{
+	std::unique_lock lock(m_mutex);
+
+	while (!stopToken.stop_requested())
+	{
+		auto deadline = m_batcher.GetDeadline();
+
+		if (!deadline)
+		{
+			m_requestAddedCondition.wait(lock, stopToken,
+				[this] { return m_batcher.GetDeadline().has_value(); });
+			continue;
+		}
+
+		// Requests that arrive while waiting can only push the deadline back, so it's sufficient to
+		// wait until the current deadline and then check again.
+		m_requestAddedCondition.wait_until(lock, stopToken, *deadline, [] { return false; });
+
+		auto batch = m_batcher.TakeBatchIfDue(InstanceHandoffBatcher::Clock::now());
+
+		if (batch.empty())
+		{
+			continue;
+		}
+
+		lock.unlock();
+		m_batchCallback(std::move(batch));
+		lock.lock();
+	}
+}
@@ -0,0 +1,169 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#pragma once
+
+#include <boost/core/noncopyable.hpp>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+class LocalPipeConnection;
+class LocalPipeServer;
+
+// When a new process is started while an existing instance is running (e.g. when a folder is
+// opened from Windows Explorer), the new process can hand its command line off to the existing
+// instance and exit. That's done over a pipe owned by the existing instance, with the existing
+// instance acknowledging each request as soon as it's been queued. The items are then opened
+// on the existing instance's UI thread, without the new process having to wait.
+struct InstanceHandoffRequest
+{
+	// If empty, the default folder is opened.
+	std::vector<std::wstring> directories;
+
+	// Set when the process was started from the "new tab" jump list task. Those requests are
+	// always handled by an existing instance, even if multiple instances are allowed.
+	bool jumplistNewTab = false;
+
+	bool operator==(const InstanceHandoffRequest &) const = default;
+};
+
+enum class InstanceHandoffStatus : uint8_t
+{
+	// The request has been queued and will be handled by the existing instance.
+	Accepted = 0,
+
+	// The existing instance won't handle the request (e.g. because multiple instances are
+	// allowed), so the new process should continue starting up.
+	Declined = 1,
+
+	// The request used a version of the protocol the existing instance doesn't understand.
+	UnsupportedVersion = 2,
+
+	Malformed = 3
+};
+
+inline constexpr uint16_t INSTANCE_HANDOFF_PROTOCOL_VERSION = 1;
+
+// Larger frames are rejected, so that a misbehaving client can't cause a large allocation.
+inline constexpr uint32_t INSTANCE_HANDOFF_MAX_FRAME_SIZE = 1024 * 1024;
+
+// Each message is sent as a frame consisting of a 32-bit little-endian payload size, followed by
+// the payload. Both requests and responses start with a magic value and the protocol version.
+// Strings are always written as UTF-16LE, regardless of the size of wchar_t.
+std::vector<std::byte> EncodeInstanceHandoffRequest(const InstanceHandoffRequest &request,
+	uint16_t version = INSTANCE_HANDOFF_PROTOCOL_VERSION);
+
+// Returns Accepted if the request was decoded successfully.
+InstanceHandoffStatus DecodeInstanceHandoffRequest(std::span<const std::byte> payload,
+	InstanceHandoffRequest &request);
+
+std::vector<std::byte> EncodeInstanceHandoffResponse(InstanceHandoffStatus status);
+std::optional<InstanceHandoffStatus> DecodeInstanceHandoffResponse(
+	std::span<const std::byte> payload);
+
+bool WriteInstanceHandoffFrame(LocalPipeConnection &connection, std::span<const std::byte> payload,
+	std::chrono::milliseconds timeout);
+
+// Returns nullopt if a complete frame isn't received before the timeout, or if the frame is too
+// large.
+std::optional<std::vector<std::byte>> ReadInstanceHandoffFrame(LocalPipeConnection &connection,
+	std::chrono::milliseconds timeout);
+
+// The pipe is specific to the session, so that instances running in different sessions (e.g. for
+// different users) are independent.
+std::wstring GetInstanceHandoffPipeName(const std::wstring &instanceName, uint32_t sessionId);
+
+// Sends a request to the instance that owns the pipe and waits for it to be acknowledged. Returns
+// nullopt if no instance owns the pipe, or the request couldn't be completed within the timeout.
+// Once connected, onConnected is called with the ID of the process that owns the pipe.
+std::optional<InstanceHandoffStatus> SendInstanceHandoffRequest(const std::wstring &pipeName,
+	const InstanceHandoffRequest &request, std::chrono::milliseconds timeout,
+	std::function<void(uint32_t serverProcessId)> onConnected = nullptr);
+
+struct InstanceHandoffTiming
+{
+	// A batch is released once no further requests have arrived within this period...
+	std::chrono::milliseconds quietPeriod = std::chrono::milliseconds(30);
+
+	// ...or once the oldest request in the batch has been waiting this long, whichever comes
+	// first.
+	std::chrono::milliseconds maxDelay = std::chrono::milliseconds(200);
+};
+
+// Opening several items from Windows Explorer at once starts a separate process for each item.
+// This groups requests that arrive in quick succession, so that they can be handled together
+// (e.g. with the window only being activated once). Times are passed in explicitly, which keeps
+// this class independent of the clock.
+class InstanceHandoffBatcher
+{
+public:
+	using Clock = std::chrono::steady_clock;
+
+	explicit InstanceHandoffBatcher(const InstanceHandoffTiming &timing = {});
+
+	void Add(InstanceHandoffRequest request, Clock::time_point now);
+
+	// Returns nullopt if there are no pending requests.
+	std::optional<Clock::time_point> GetDeadline() const;
+
+	// Returns the pending requests, in the order they were added, if the deadline has been
+	// reached. Otherwise, returns an empty vector.
+	std::vector<InstanceHandoffRequest> TakeBatchIfDue(Clock::time_point now);
+
+private:
+	const InstanceHandoffTiming m_timing;
+	std::vector<InstanceHandoffRequest> m_pendingRequests;
+	Clock::time_point m_firstRequestTime;
+	Clock::time_point m_lastRequestTime;
+};
+
+// Listens for requests on a background thread. Accepted requests are batched and then passed to
+// the batch callback, on a second background thread.
+class InstanceHandoffServer : private boost::noncopyable
+{
+public:
+	// Returns whether the request should be accepted.
+	using RequestFilter = std::function<bool(const InstanceHandoffRequest &request)>;
+
+	using BatchCallback = std::function<void(std::vector<InstanceHandoffRequest> batch)>;
+
+	// Returns null if the pipe couldn't be created (e.g. because another instance already owns
+	// it).
+	static std::unique_ptr<InstanceHandoffServer> Create(const std::wstring &pipeName,
+		RequestFilter requestFilter, BatchCallback batchCallback,
+		const InstanceHandoffTiming &timing = {});
+
+	// Requests that have been accepted, but not yet passed to the batch callback, are discarded.
+	~InstanceHandoffServer();
+
+private:
+	InstanceHandoffServer(std::unique_ptr<LocalPipeServer> pipeServer,
+		RequestFilter requestFilter, BatchCallback batchCallback,
+		const InstanceHandoffTiming &timing);
+
+	void AcceptConnections();
+	void HandleConnection(LocalPipeConnection &connection);
+	void DeliverBatches(std::stop_token stopToken);
+
+	const std::unique_ptr<LocalPipeServer> m_pipeServer;
+	const RequestFilter m_requestFilter;
+	const BatchCallback m_batchCallback;
+
+	std::mutex m_mutex;
+	std::condition_variable_any m_requestAddedCondition;
+	InstanceHandoffBatcher m_batcher;
+
+	std::jthread m_acceptThread;
+	std::jthread m_deliveryThread;
+};
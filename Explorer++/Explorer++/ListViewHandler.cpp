@@ -11,6 +11,7 @@
 #include "MainToolbar.h"
 #include "NewMenuClient.h"
 #include "ResourceHelper.h"
+#include "Runtime.h"
 #include "ServiceProvider.h"
 #include "SetFileAttributesDialog.h"
 #include "ShellBrowser/Columns.h"
@@ -21,8 +22,9 @@
 #include "SortMenuBuilder.h"
 #include "TabContainerImpl.h"
 #include "ViewModeHelper.h"
-#include "../Helper/BulkClipboardWriter.h"
 #include "../Helper/ClipboardHelper.h"
+#include "../Helper/CompactPathList.h"
+#include "../Helper/DragDropHelper.h"
 #include "../Helper/DropHandler.h"
 #include "../Helper/Helper.h"
 #include "../Helper/ListViewHelper.h"
@@ -31,6 +33,7 @@
 #include "../Helper/ShellHelper.h"
 #include "../Helper/WinRTBaseWrapper.h"
 #include <wil/com.h>
+#include <future>
 
 LRESULT CALLBACK Explorerplusplus::ListViewProcStub(HWND hwnd, UINT uMsg, WPARAM wParam,
 	LPARAM lParam, UINT_PTR uIdSubclass, DWORD_PTR dwRefData)
@@ -346,64 +349,103 @@ void Explorerplusplus::OnListViewDoubleClick(const NMITEMACTIVATE *eventInfo)
 	}
 }
 
-void Explorerplusplus::OnListViewCopyItemPath() const
+void Explorerplusplus::OnListViewCopyItemPath()
 {
-	if (ListView_GetSelectedCount(m_hActiveListView) == 0)
+	auto paths = GetSelectedListViewItemPaths();
+
+	if (paths->IsEmpty())
 	{
 		return;
 	}
 
-	std::wstring strItemPaths;
-	int iItem = -1;
+	std::promise<std::shared_ptr<const CompactPathList>> pathsPromise;
+	pathsPromise.set_value(paths);
+	CopyPathsToClipboard(pathsPromise.get_future().share());
+}
 
-	while ((iItem = ListView_GetNextItem(m_hActiveListView, iItem, LVNI_SELECTED)) != -1)
-	{
-		std::wstring fullFilename = m_pActiveShellBrowser->GetItemFullName(iItem);
+void Explorerplusplus::OnListViewCopyUniversalPaths()
+{
+	auto paths = GetSelectedListViewItemPaths();
 
-		strItemPaths += fullFilename + std::wstring(_T("\r\n"));
+	if (paths->IsEmpty())
+	{
+		return;
 	}
 
-	strItemPaths = strItemPaths.substr(0, strItemPaths.size() - 2);
+	// Retrieving the universal name for a path on a network drive can be slow, so the names are
+	// resolved in the background. The text will only need to be waited on if it's pasted before
+	// all the names have been resolved. The future returned by std::async can't be used here,
+	// since its destructor waits for the task to finish, which would block whichever thread
+	// released the last reference to the clipboard data object. Resolving the names can hang on
+	// an unresponsive network drive, so the work is run alongside the other long-running jobs.
+	std::promise<std::shared_ptr<const CompactPathList>> universalPathsPromise;
+	auto universalPaths = universalPathsPromise.get_future().share();
+
+	m_app->GetRuntime()->GetBackgroundJobExecutor()->post(
+		[paths, universalPathsPromise = std::move(universalPathsPromise)]() mutable
+		{
+			auto resolvedPaths = std::make_shared<CompactPathList>();
+			resolvedPaths->Reserve(paths->GetCount(), paths->GetJoinedLength(L""));
+
+			for (size_t i = 0; i < paths->GetCount(); i++)
+			{
+				std::wstring fullFilename(paths->GetPath(i));
+
+				TCHAR szBuffer[1024];
+
+				DWORD dwBufferSize = std::size(szBuffer);
+				auto *puni = reinterpret_cast<UNIVERSAL_NAME_INFO *>(&szBuffer);
+				DWORD dwRet = WNetGetUniversalName(fullFilename.c_str(),
+					UNIVERSAL_NAME_INFO_LEVEL, reinterpret_cast<LPVOID>(puni), &dwBufferSize);
+
+				if (dwRet == NO_ERROR)
+				{
+					resolvedPaths->Add(puni->lpUniversalName);
+				}
+				else
+				{
+					resolvedPaths->Add(fullFilename);
+				}
+			}
+
+			universalPathsPromise.set_value(resolvedPaths);
+		});
 
-	BulkClipboardWriter clipboardWriter;
-	clipboardWriter.WriteText(strItemPaths);
+	CopyPathsToClipboard(universalPaths);
 }
 
-void Explorerplusplus::OnListViewCopyUniversalPaths() const
+std::shared_ptr<CompactPathList> Explorerplusplus::GetSelectedListViewItemPaths() const
 {
-	if (ListView_GetSelectedCount(m_hActiveListView) == 0)
-	{
-		return;
-	}
-
-	std::wstring strUniversalPaths;
+	auto paths = std::make_shared<CompactPathList>();
 	int iItem = -1;
 
 	while ((iItem = ListView_GetNextItem(m_hActiveListView, iItem, LVNI_SELECTED)) != -1)
 	{
-		std::wstring fullFilename = m_pActiveShellBrowser->GetItemFullName(iItem);
+		paths->Add(m_pActiveShellBrowser->GetItemFullName(iItem));
+	}
 
-		TCHAR szBuffer[1024];
+	return paths;
+}
 
-		DWORD dwBufferSize = std::size(szBuffer);
-		auto *puni = reinterpret_cast<UNIVERSAL_NAME_INFO *>(&szBuffer);
-		DWORD dwRet = WNetGetUniversalName(fullFilename.c_str(), UNIVERSAL_NAME_INFO_LEVEL,
-			reinterpret_cast<LPVOID>(puni), &dwBufferSize);
+void Explorerplusplus::CopyPathsToClipboard(
+	std::shared_future<std::shared_ptr<const CompactPathList>> paths)
+{
+	wil::com_ptr_nothrow<IDataObject> dataObject;
+	HRESULT hr = CreateDataObjectForPaths(paths, PathDataFormats::Text, &dataObject);
 
-		if (dwRet == NO_ERROR)
-		{
-			strUniversalPaths += puni->lpUniversalName + std::wstring(_T("\r\n"));
-		}
-		else
-		{
-			strUniversalPaths += fullFilename + std::wstring(_T("\r\n"));
-		}
+	if (FAILED(hr))
+	{
+		return;
 	}
 
-	strUniversalPaths = strUniversalPaths.substr(0, strUniversalPaths.size() - 2);
+	hr = OleSetClipboard(dataObject.get());
+
+	if (FAILED(hr))
+	{
+		return;
+	}
 
-	BulkClipboardWriter clipboardWriter;
-	clipboardWriter.WriteText(strUniversalPaths);
+	m_pathsClipboardDataObject = dataObject;
 }
 
 void Explorerplusplus::OnListViewSetFileAttributes() const
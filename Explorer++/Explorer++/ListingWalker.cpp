@@ -0,0 +1,115 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "stdafx.h"
+#include "ListingWalker.h"
+#include "ListingWriter.h"
+#include <algorithm>
+
+ListingWalker::ListingWalker(ListingSource *source, ListingWriter *writer,
+	const Options &options) :
+	m_source(source),
+	m_writer(writer),
+	m_options(options)
+{
+}
+
+ListingWalker::Result ListingWalker::Walk(const std::wstring &rootPath, std::stop_token stopToken,
+	ProgressCallback progressCallback)
+{
+	m_progress = {};
+
+	// This is used as a stack, so the folders that need to be visited next are at the end.
+	std::vector<PendingFolder> pendingFolders;
+	pendingFolders.push_back({ rootPath, L"" });
+
+	while (!pendingFolders.empty())
+	{
+		if (stopToken.stop_requested())
+		{
+			return Result::Cancelled;
+		}
+
+		PendingFolder folder = std::move(pendingFolders.back());
+		pendingFolders.pop_back();
+
+		auto result = WriteFolder(folder, pendingFolders, stopToken);
+
+		if (result != Result::Completed)
+		{
+			return result;
+		}
+
+		if (progressCallback)
+		{
+			progressCallback(m_progress);
+		}
+	}
+
+	if (!m_writer->Finish())
+	{
+		return Result::WriteFailed;
+	}
+
+	return Result::Completed;
+}
+
+ListingWalker::Result ListingWalker::WriteFolder(const PendingFolder &folder,
+	std::vector<PendingFolder> &pendingFolders, std::stop_token stopToken)
+{
+	m_progress.currentFolder = folder.path;
+
+	std::vector<ListingEntry> entries;
+
+	if (!m_source->EnumerateFolder(folder.path, entries, stopToken))
+	{
+		if (stopToken.stop_requested())
+		{
+			return Result::Cancelled;
+		}
+
+		// A folder that can't be read (e.g. because access is denied) shouldn't prevent the rest of
+		// the listing from being written.
+		m_progress.numFoldersSkipped++;
+		return Result::Completed;
+	}
+
+	m_progress.numFolders++;
+
+	size_t firstSubfolderIndex = pendingFolders.size();
+
+	for (auto &entry : entries)
+	{
+		if (m_options.includeRelativeFolder)
+		{
+			entry.values.insert(entry.values.begin(), folder.relativePath);
+		}
+
+		if (!m_writer->WriteItem(entry.values))
+		{
+			return Result::WriteFailed;
+		}
+
+		m_progress.numItems++;
+
+		if (m_options.recursive && entry.isFolder)
+		{
+			std::wstring relativePath = folder.relativePath.empty()
+				? entry.name
+				: folder.relativePath + L"\\" + entry.name;
+			pendingFolders.push_back({ std::move(entry.path), std::move(relativePath) });
+		}
+	}
+
+	// The subfolders were added in listing order, but are popped from the end, so they need to be
+	// reversed for the first subfolder to be visited first.
+	std::reverse(pendingFolders.begin() + firstSubfolderIndex, pendingFolders.end());
+
+	return Result::Completed;
+}
+
+const ListingWalker::Progress &ListingWalker::GetProgress() const
+{
+	return m_progress;
+}
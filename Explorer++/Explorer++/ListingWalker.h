@@ -0,0 +1,94 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#pragma once
+
+#include <functional>
+#include <stop_token>
+#include <string>
+#include <vector>
+
+class ListingWriter;
+
+struct ListingEntry
+{
+	// The path is used to enumerate the item if it's a folder and the walk is recursive.
+	std::wstring path;
+	std::wstring name;
+	bool isFolder = false;
+
+	// The text for each of the columns being exported.
+	std::vector<std::wstring> values;
+};
+
+// Provides the contents of each folder visited by ListingWalker.
+class ListingSource
+{
+public:
+	virtual ~ListingSource() = default;
+
+	// Retrieves the immediate children of the specified folder, in the order they should appear in
+	// the listing. Returns false if the folder couldn't be enumerated.
+	virtual bool EnumerateFolder(const std::wstring &path, std::vector<ListingEntry> &entries,
+		std::stop_token stopToken) = 0;
+};
+
+// Walks a folder (and optionally its subfolders) and writes an entry for each item found. The
+// contents of each folder are written together, with subfolders visited once their parent has been
+// written (in the same order as they appear in the parent). Only the contents of a single folder
+// and the list of folders still to be visited are held in memory at any one time, so the size of
+// the tree being walked doesn't affect the amount of memory used.
+class ListingWalker
+{
+public:
+	enum class Result
+	{
+		Completed,
+		Cancelled,
+		WriteFailed
+	};
+
+	struct Options
+	{
+		bool recursive = false;
+
+		// If set, each row will begin with the path of the containing folder, relative to the root
+		// folder. That's necessary for a recursive listing to be useful, since otherwise there's no
+		// way of telling which folder an item is in.
+		bool includeRelativeFolder = false;
+	};
+
+	struct Progress
+	{
+		size_t numItems = 0;
+		size_t numFolders = 0;
+		size_t numFoldersSkipped = 0;
+		std::wstring currentFolder;
+	};
+
+	using ProgressCallback = std::function<void(const Progress &progress)>;
+
+	ListingWalker(ListingSource *source, ListingWriter *writer, const Options &options);
+
+	// The progress callback is invoked once each folder has been written.
+	Result Walk(const std::wstring &rootPath, std::stop_token stopToken,
+		ProgressCallback progressCallback = nullptr);
+
+	const Progress &GetProgress() const;
+
+private:
+	struct PendingFolder
+	{
+		std::wstring path;
+		std::wstring relativePath;
+	};
+
+	Result WriteFolder(const PendingFolder &folder, std::vector<PendingFolder> &pendingFolders,
+		std::stop_token stopToken);
+
+	ListingSource *const m_source;
+	ListingWriter *const m_writer;
+	const Options m_options;
+	Progress m_progress;
+};
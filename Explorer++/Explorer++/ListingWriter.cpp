@@ -0,0 +1,445 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "stdafx.h"
+#include "ListingWriter.h"
+#include <algorithm>
+
+namespace
+{
+
+constexpr char32_t REPLACEMENT_CHARACTER = 0xFFFD;
+
+bool IsHighSurrogate(char32_t codeUnit)
+{
+	return codeUnit >= 0xD800 && codeUnit <= 0xDBFF;
+}
+
+bool IsLowSurrogate(char32_t codeUnit)
+{
+	return codeUnit >= 0xDC00 && codeUnit <= 0xDFFF;
+}
+
+void AppendCodePoint(std::string &output, char32_t codePoint)
+{
+	if (codePoint > 0x10FFFF || (codePoint >= 0xD800 && codePoint <= 0xDFFF))
+	{
+		codePoint = REPLACEMENT_CHARACTER;
+	}
+
+	if (codePoint < 0x80)
+	{
+		output.push_back(static_cast<char>(codePoint));
+	}
+	else if (codePoint < 0x800)
+	{
+		output.push_back(static_cast<char>(0xC0 | (codePoint >> 6)));
+		output.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+	}
+	else if (codePoint < 0x10000)
+	{
+		output.push_back(static_cast<char>(0xE0 | (codePoint >> 12)));
+		output.push_back(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F)));
+		output.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+	}
+	else
+	{
+		output.push_back(static_cast<char>(0xF0 | (codePoint >> 18)));
+		output.push_back(static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F)));
+		output.push_back(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F)));
+		output.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+	}
+}
+
+bool IsValidXmlCharacter(wchar_t character)
+{
+	auto codeUnit = static_cast<char32_t>(character);
+
+	if (codeUnit < 0x20)
+	{
+		return codeUnit == '\t' || codeUnit == '\n' || codeUnit == '\r';
+	}
+
+	return codeUnit != 0xFFFE && codeUnit != 0xFFFF;
+}
+
+}
+
+ListingWriter::ListingWriter(std::ostream &stream, ListingFormat format,
+	std::vector<std::wstring> columnNames, size_t bufferSize) :
+	m_stream(stream),
+	m_format(format),
+	m_columnNames(std::move(columnNames)),
+	m_bufferSize(std::max(bufferSize, size_t{ 1 }))
+{
+	m_buffer.reserve(m_bufferSize);
+
+	WriteHeader();
+}
+
+void ListingWriter::WriteHeader()
+{
+	switch (m_format)
+	{
+	case ListingFormat::Csv:
+		m_buffer += "\xEF\xBB\xBF";
+		WriteDelimitedRow(m_columnNames, ',');
+		break;
+
+	case ListingFormat::Tsv:
+		m_buffer += "\xEF\xBB\xBF";
+		WriteDelimitedRow(m_columnNames, '\t');
+		break;
+
+	case ListingFormat::JsonLines:
+		break;
+
+	case ListingFormat::Xml:
+		m_buffer += "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\r\n<listing>\r\n";
+		break;
+
+	case ListingFormat::Text:
+		break;
+	}
+}
+
+bool ListingWriter::WriteItem(const std::vector<std::wstring> &values)
+{
+	DCHECK(!m_finished);
+	DCHECK_EQ(values.size(), m_columnNames.size());
+
+	if (m_failed)
+	{
+		return false;
+	}
+
+	switch (m_format)
+	{
+	case ListingFormat::Csv:
+		WriteDelimitedRow(values, ',');
+		break;
+
+	case ListingFormat::Tsv:
+		WriteDelimitedRow(values, '\t');
+		break;
+
+	case ListingFormat::JsonLines:
+		m_buffer += '{';
+
+		for (size_t i = 0; i < values.size(); i++)
+		{
+			if (i > 0)
+			{
+				m_buffer += ',';
+			}
+
+			AppendJsonString(m_columnNames[i]);
+			m_buffer += ':';
+			AppendJsonString(values[i]);
+		}
+
+		m_buffer += "}\n";
+		break;
+
+	case ListingFormat::Xml:
+		m_buffer += "\t<item>\r\n";
+
+		for (size_t i = 0; i < values.size(); i++)
+		{
+			m_buffer += "\t\t<value name=\"";
+			AppendXmlText(m_columnNames[i]);
+			m_buffer += "\">";
+			AppendXmlText(values[i]);
+			m_buffer += "</value>\r\n";
+		}
+
+		m_buffer += "\t</item>\r\n";
+		break;
+
+	case ListingFormat::Text:
+		for (size_t i = 0; i < values.size(); i++)
+		{
+			if (i > 0)
+			{
+				m_buffer += "  ";
+			}
+
+			AppendUtf8(m_buffer, values[i]);
+		}
+
+		m_buffer += '\n';
+		break;
+	}
+
+	m_numItemsWritten++;
+
+	return FlushIfNecessary();
+}
+
+bool ListingWriter::Finish()
+{
+	DCHECK(!m_finished);
+	m_finished = true;
+
+	if (m_failed)
+	{
+		return false;
+	}
+
+	if (m_format == ListingFormat::Xml)
+	{
+		m_buffer += "</listing>\r\n";
+	}
+
+	if (!Flush())
+	{
+		return false;
+	}
+
+	m_stream.flush();
+	return !m_stream.fail();
+}
+
+size_t ListingWriter::GetNumItemsWritten() const
+{
+	return m_numItemsWritten;
+}
+
+size_t ListingWriter::GetPeakBufferSize() const
+{
+	return std::max(m_peakBufferSize, m_buffer.size());
+}
+
+void ListingWriter::WriteDelimitedRow(const std::vector<std::wstring> &values, wchar_t delimiter)
+{
+	for (size_t i = 0; i < values.size(); i++)
+	{
+		if (i > 0)
+		{
+			m_buffer += static_cast<char>(delimiter);
+		}
+
+		if (delimiter == '\t')
+		{
+			AppendTsvField(values[i]);
+		}
+		else
+		{
+			AppendCsvField(values[i]);
+		}
+	}
+
+	m_buffer += "\r\n";
+}
+
+void ListingWriter::AppendCsvField(std::wstring_view value)
+{
+	bool needsQuotes = value.find_first_of(L",\"\r\n") != std::wstring_view::npos
+		|| (!value.empty() && (value.front() == ' ' || value.back() == ' '));
+
+	if (!needsQuotes)
+	{
+		AppendUtf8(m_buffer, value);
+		return;
+	}
+
+	m_buffer += '"';
+
+	size_t start = 0;
+	size_t quote;
+
+	while ((quote = value.find('"', start)) != std::wstring_view::npos)
+	{
+		AppendUtf8(m_buffer, value.substr(start, quote + 1 - start));
+		m_buffer += '"';
+		start = quote + 1;
+	}
+
+	AppendUtf8(m_buffer, value.substr(start));
+	m_buffer += '"';
+}
+
+void ListingWriter::AppendTsvField(std::wstring_view value)
+{
+	size_t start = 0;
+	size_t special;
+
+	while ((special = value.find_first_of(L"\t\r\n\\", start)) != std::wstring_view::npos)
+	{
+		AppendUtf8(m_buffer, value.substr(start, special - start));
+
+		switch (value[special])
+		{
+		case '\t':
+			m_buffer += "\\t";
+			break;
+
+		case '\r':
+			m_buffer += "\\r";
+			break;
+
+		case '\n':
+			m_buffer += "\\n";
+			break;
+
+		default:
+			m_buffer += "\\\\";
+			break;
+		}
+
+		start = special + 1;
+	}
+
+	AppendUtf8(m_buffer, value.substr(start));
+}
+
+void ListingWriter::AppendJsonString(std::wstring_view value)
+{
+	static constexpr char HEX_DIGITS[] = "0123456789abcdef";
+
+	m_buffer += '"';
+
+	size_t start = 0;
+
+	for (size_t i = 0; i < value.size(); i++)
+	{
+		auto character = static_cast<char32_t>(value[i]);
+
+		if (character >= 0x20 && character != '"' && character != '\\')
+		{
+			continue;
+		}
+
+		AppendUtf8(m_buffer, value.substr(start, i - start));
+		start = i + 1;
+
+		switch (character)
+		{
+		case '"':
+			m_buffer += "\\\"";
+			break;
+
+		case '\\':
+			m_buffer += "\\\\";
+			break;
+
+		case '\n':
+			m_buffer += "\\n";
+			break;
+
+		case '\r':
+			m_buffer += "\\r";
+			break;
+
+		case '\t':
+			m_buffer += "\\t";
+			break;
+
+		default:
+			m_buffer += "\\u00";
+			m_buffer += HEX_DIGITS[character >> 4];
+			m_buffer += HEX_DIGITS[character & 0xF];
+			break;
+		}
+	}
+
+	AppendUtf8(m_buffer, value.substr(start));
+	m_buffer += '"';
+}
+
+void ListingWriter::AppendXmlText(std::wstring_view value)
+{
+	size_t start = 0;
+
+	for (size_t i = 0; i < value.size(); i++)
+	{
+		wchar_t character = value[i];
+		bool valid = IsValidXmlCharacter(character);
+
+		if (valid && character != '&' && character != '<' && character != '>' && character != '"')
+		{
+			continue;
+		}
+
+		AppendUtf8(m_buffer, value.substr(start, i - start));
+		start = i + 1;
+
+		// Characters that can't be represented in XML 1.0 (even when escaped) are dropped.
+		if (!valid)
+		{
+			continue;
+		}
+
+		switch (character)
+		{
+		case '&':
+			m_buffer += "&amp;";
+			break;
+
+		case '<':
+			m_buffer += "&lt;";
+			break;
+
+		case '>':
+			m_buffer += "&gt;";
+			break;
+
+		default:
+			m_buffer += "&quot;";
+			break;
+		}
+	}
+
+	AppendUtf8(m_buffer, value.substr(start));
+}
+
+void ListingWriter::AppendUtf8(std::string &output, std::wstring_view text)
+{
+	for (size_t i = 0; i < text.size(); i++)
+	{
+		auto codeUnit = static_cast<char32_t>(text[i]);
+
+		if constexpr (sizeof(wchar_t) == 2)
+		{
+			if (IsHighSurrogate(codeUnit) && i + 1 < text.size()
+				&& IsLowSurrogate(static_cast<char32_t>(text[i + 1])))
+			{
+				auto lowSurrogate = static_cast<char32_t>(text[i + 1]);
+				codeUnit = 0x10000 + ((codeUnit - 0xD800) << 10) + (lowSurrogate - 0xDC00);
+				i++;
+			}
+		}
+
+		AppendCodePoint(output, codeUnit);
+	}
+}
+
+bool ListingWriter::FlushIfNecessary()
+{
+	if (m_buffer.size() < m_bufferSize)
+	{
+		return true;
+	}
+
+	return Flush();
+}
+
+bool ListingWriter::Flush()
+{
+	m_peakBufferSize = std::max(m_peakBufferSize, m_buffer.size());
+
+	if (!m_buffer.empty())
+	{
+		m_stream.write(m_buffer.data(), static_cast<std::streamsize>(m_buffer.size()));
+		m_buffer.clear();
+	}
+
+	if (m_stream.fail())
+	{
+		m_failed = true;
+		return false;
+	}
+
+	return true;
+}
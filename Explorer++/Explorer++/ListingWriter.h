@@ -0,0 +1,84 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#pragma once
+
+#include <boost/core/noncopyable.hpp>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+enum class ListingFormat
+{
+	Csv,
+	Tsv,
+	JsonLines,
+	Xml,
+	Text
+};
+
+// Writes a directory listing to a stream, one item at a time. Output is encoded as UTF-8 and
+// accumulated in a buffer of a fixed size, which is flushed to the stream whenever it fills up. The
+// amount of memory used is therefore independent of the number of items written.
+//
+// The formats are:
+//
+// - CSV: RFC 4180, with a header row containing the column names. Fields are quoted only when
+//   necessary.
+// - TSV: A header row, followed by one line per item. Since fields can't be quoted, tabs, line
+//   breaks and backslashes within values are escaped as \t, \n, \r and \\.
+// - JSON Lines: One JSON object per item, keyed by column name.
+// - XML: A single <listing> element containing one <item> element per item.
+// - Text: One line per item, with values separated by two spaces and no header. This is intended
+//   for console output, so values are written as-is.
+//
+// The CSV and TSV formats begin with a byte order mark, since that's what allows spreadsheet
+// applications to detect that the file is UTF-8 encoded.
+class ListingWriter : private boost::noncopyable
+{
+public:
+	static constexpr size_t DEFAULT_BUFFER_SIZE = 64 * 1024;
+
+	ListingWriter(std::ostream &stream, ListingFormat format,
+		std::vector<std::wstring> columnNames, size_t bufferSize = DEFAULT_BUFFER_SIZE);
+
+	// Writes a single item. The number of values should match the number of columns. Returns false
+	// if the stream couldn't be written to.
+	bool WriteItem(const std::vector<std::wstring> &values);
+
+	// Writes any closing markup and flushes the remaining output to the stream. No further items
+	// should be written once this has been called.
+	bool Finish();
+
+	size_t GetNumItemsWritten() const;
+
+	// Returns the largest amount of data that has been buffered before being written to the stream.
+	size_t GetPeakBufferSize() const;
+
+	// Appends the UTF-8 encoding of the text to the output. On Windows, wchar_t is a UTF-16 code
+	// unit, while elsewhere it's a full code point; both are handled here. Unpaired surrogates
+	// (which can appear in Windows file names) are replaced with U+FFFD.
+	static void AppendUtf8(std::string &output, std::wstring_view text);
+
+private:
+	void WriteHeader();
+	void WriteDelimitedRow(const std::vector<std::wstring> &values, wchar_t delimiter);
+	void AppendCsvField(std::wstring_view value);
+	void AppendTsvField(std::wstring_view value);
+	void AppendJsonString(std::wstring_view value);
+	void AppendXmlText(std::wstring_view value);
+	bool FlushIfNecessary();
+	bool Flush();
+
+	std::ostream &m_stream;
+	const ListingFormat m_format;
+	const std::vector<std::wstring> m_columnNames;
+	const size_t m_bufferSize;
+	std::string m_buffer;
+	size_t m_peakBufferSize = 0;
+	size_t m_numItemsWritten = 0;
+	bool m_failed = false;
+	bool m_finished = false;
+};
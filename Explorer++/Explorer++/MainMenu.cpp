@@ -312,6 +312,24 @@ void Explorerplusplus::OnInitMenu(HMENU menu)
 	}
 }
 
+boost::signals2::connection Explorerplusplus::AddMainMenuSubMenuPreShowObserver(
+	const MainMenuSubMenuPreShowSignal::slot_type &observer)
+{
+	return m_mainMenuSubMenuPreShowSignal.connect(observer);
+}
+
+void Explorerplusplus::OnInitMenuPopup(HMENU menu, bool isWindowMenu)
+{
+	// This allows the contents of a submenu to be built only when the submenu is actually about to
+	// be shown.
+	if (isWindowMenu || !m_mainMenuShowing)
+	{
+		return;
+	}
+
+	m_mainMenuSubMenuPreShowSignal(menu);
+}
+
 void Explorerplusplus::OnExitMenuLoop(bool shortcutMenu)
 {
 	if (!shortcutMenu)
@@ -6,17 +6,22 @@
 #include "Explorer++.h"
 #include "AboutDialog.h"
 #include "App.h"
+#include "Bookmarks/UI/ManageBookmarksDialog.h"
+#include "CompareFoldersDialog.h"
 #include "Config.h"
 #include "CustomizeColorsDialog.h"
 #include "DestroyFilesDialog.h"
+#include "DirectoryListingExport.h"
 #include "DisplayColoursDialog.h"
 #include "DisplayWindow/DisplayWindow.h"
+#include "DuplicateFilesDialog.h"
 #include "FileProgressSink.h"
 #include "FilterDialog.h"
 #include "MainResource.h"
 #include "MergeFilesDialog.h"
 #include "ModelessDialogHelper.h"
 #include "OptionsDialog.h"
+#include "Plugins/PluginColumnRegistry.h"
 #include "ResourceHelper.h"
 #include "ScriptingDialog.h"
 #include "SearchDialog.h"
@@ -25,12 +30,14 @@
 #include "ShellBrowser/ShellNavigationController.h"
 #include "SplitFileDialog.h"
 #include "TabContainerImpl.h"
+#include "TraceExport.h"
 #include "UpdateCheckDialog.h"
 #include "WildcardSelectDialog.h"
 #include "../Helper/Helper.h"
 #include "../Helper/ListViewHelper.h"
 #include "../Helper/ProcessHelper.h"
 #include "../Helper/ShellHelper.h"
+#include "../Helper/Tracing.h"
 #include <wil/com.h>
 
 void Explorerplusplus::OnChangeDisplayColors()
@@ -114,10 +121,37 @@ void Explorerplusplus::OnSearch()
 
 			return new SearchDialog(m_app->GetResourceInstance(), m_hContainer,
 				m_app->GetThemeManager(), currentDirectory, this, this,
-				GetActivePane()->GetTabContainerImpl(), m_app->GetIconResourceLoader());
+				GetActivePane()->GetTabContainerImpl(), m_app->GetIconResourceLoader(),
+				m_app->GetFileNameIndexService());
 		});
 }
 
+void Explorerplusplus::OnManageBookmarks(bool focusSearch)
+{
+	auto *modelessDialogList = m_app->GetModelessDialogList();
+
+	CreateOrSwitchToModelessDialog(modelessDialogList, L"ManageBookmarksDialog",
+		[this]
+		{
+			return new ManageBookmarksDialog(m_app->GetResourceInstance(), m_hContainer,
+				m_app->GetThemeManager(), this, this, m_app->GetIconResourceLoader(),
+				&m_iconFetcher, m_app->GetBookmarkTree());
+		});
+
+	if (!focusSearch)
+	{
+		return;
+	}
+
+	HWND dialog = modelessDialogList->MaybeGetDialogById(L"ManageBookmarksDialog");
+
+	if (dialog)
+	{
+		SendMessage(dialog, WM_NEXTDLGCTL,
+			reinterpret_cast<WPARAM>(GetDlgItem(dialog, IDC_MANAGEBOOKMARKS_SEARCH)), TRUE);
+	}
+}
+
 void Explorerplusplus::OnCustomizeColors()
 {
 	CustomizeColorsDialog customizeColorsDialog(m_app->GetResourceInstance(), m_hContainer,
@@ -151,6 +185,62 @@ void Explorerplusplus::OnSearchTabs()
 		[this] { return SearchTabsDialog::Create(m_app, m_hContainer, this); });
 }
 
+void Explorerplusplus::OnFindDuplicateFiles()
+{
+	CreateOrSwitchToModelessDialog(m_app->GetModelessDialogList(), L"DuplicateFilesDialog",
+		[this]
+		{
+			return DuplicateFilesDialog::Create(m_app, m_hContainer, this,
+				m_pActiveShellBrowser->GetDirectory());
+		});
+}
+
+void Explorerplusplus::OnCompareFolders()
+{
+	CreateOrSwitchToModelessDialog(m_app->GetModelessDialogList(), L"CompareFoldersDialog",
+		[this]
+		{
+			// The folder in the next tab is used as the initial right-hand folder, since that's the
+			// most likely other folder to be of interest.
+			const auto *tabContainer = GetActivePane()->GetTabContainerImpl();
+			std::wstring rightPath;
+
+			if (tabContainer->GetNumTabs() > 1)
+			{
+				int nextIndex =
+					(tabContainer->GetSelectedTabIndex() + 1) % tabContainer->GetNumTabs();
+				rightPath =
+					tabContainer->GetTabByIndex(nextIndex).GetShellBrowserImpl()->GetDirectory();
+			}
+
+			return CompareFoldersDialog::Create(m_app, m_hContainer,
+				m_pActiveShellBrowser->GetDirectory(), rightPath);
+		});
+}
+
+void Explorerplusplus::OnRecordTrace()
+{
+	auto &recorder = GetTraceRecorder();
+
+	if (!recorder.IsEnabled())
+	{
+		recorder.Start();
+		return;
+	}
+
+	recorder.Stop();
+
+	auto path = TraceExport::PromptForDestination(m_hContainer, m_app->GetResourceInstance());
+
+	if (!path)
+	{
+		return;
+	}
+
+	TraceExport::SaveAsync(&recorder, *path, m_hContainer, m_app->GetResourceInstance(),
+		m_app->GetRuntime());
+}
+
 void Explorerplusplus::OnOpenOnlineDocumentation()
 {
 	ShellExecute(nullptr, L"open", App::DOCUMENTATION_URL, nullptr, nullptr, SW_SHOWNORMAL);
@@ -169,22 +259,59 @@ void Explorerplusplus::OnAbout()
 	aboutDialog.ShowModalDialog();
 }
 
-void Explorerplusplus::OnSaveDirectoryListing() const
+void Explorerplusplus::OnSaveDirectoryListing()
 {
-	TCHAR fileName[MAX_PATH];
-	LoadString(m_app->GetResourceInstance(), IDS_GENERAL_DIRECTORY_LISTING_FILENAME, fileName,
-		std::size(fileName));
-	StringCchCat(fileName, std::size(fileName), _T(".txt"));
-
 	std::wstring directory = m_pActiveShellBrowser->GetDirectory();
 
-	BOOL bSaveNameRetrieved =
-		GetFileNameFromUser(m_hContainer, fileName, std::size(fileName), directory.c_str());
+	auto destination = DirectoryListingExport::PromptForDestination(m_hContainer,
+		m_app->GetResourceInstance(), directory);
 
-	if (bSaveNameRetrieved)
+	if (!destination)
 	{
-		FileOperations::SaveDirectoryListing(directory, fileName);
+		return;
 	}
+
+	DirectoryListingExport::ExportParams params;
+	params.rootPath = directory;
+	params.destination = *destination;
+	params.folderSettings = m_pActiveShellBrowser->GetFolderSettings();
+	params.globalFolderSettings = m_config->globalFolderSettings;
+
+	if (destination->recursive)
+	{
+		params.columnNames.push_back(ResourceHelper::LoadString(m_app->GetResourceInstance(),
+			IDS_DIRECTORY_LISTING_COLUMN_FOLDER));
+	}
+
+	// The listing contains the same columns as the current view, in the same order.
+	for (const auto &column : m_pActiveShellBrowser->GetCurrentColumns())
+	{
+		if (!column.checked)
+		{
+			continue;
+		}
+
+		std::shared_ptr<Plugins::PluginColumnEvaluator> pluginEvaluator;
+
+		if (IsPluginColumn(column.type))
+		{
+			const auto *pluginColumn = m_app->GetPluginColumnRegistry()->GetColumn(column.type);
+
+			if (!pluginColumn)
+			{
+				continue;
+			}
+
+			pluginEvaluator = pluginColumn->evaluator;
+		}
+
+		params.columns.push_back({ column.type, pluginEvaluator });
+		params.columnNames.push_back(m_pActiveShellBrowser->GetColumnName(column.type));
+	}
+
+	DirectoryListingExport::ExportAsync(std::move(params), m_hContainer,
+		m_app->GetResourceInstance(), m_app->GetRuntime(),
+		m_directoryListingStopSource.GetToken());
 }
 
 void Explorerplusplus::OnCreateNewFolder()
@@ -12,7 +12,6 @@
 #include "ApplicationToolbarView.h"
 #include "Bookmarks/UI/BookmarksMainMenu.h"
 #include "Bookmarks/UI/BookmarksToolbar.h"
-#include "Bookmarks/UI/ManageBookmarksDialog.h"
 #include "Bookmarks/UI/Views/BookmarksToolbarView.h"
 #include "ClipboardOperations.h"
 #include "Config.h"
@@ -27,7 +26,6 @@
 #include "MainToolbar.h"
 #include "MainToolbarButtons.h"
 #include "MenuRanges.h"
-#include "ModelessDialogHelper.h"
 #include "ShellBrowser/ShellBrowserImpl.h"
 #include "ShellBrowser/SortModes.h"
 #include "ShellBrowser/ViewModes.h"
@@ -63,6 +61,10 @@ LRESULT Explorerplusplus::WindowProcedure(HWND hwnd, UINT msg, WPARAM wParam, LP
 		OnInitMenu(reinterpret_cast<HMENU>(wParam));
 		break;
 
+	case WM_INITMENUPOPUP:
+		OnInitMenuPopup(reinterpret_cast<HMENU>(wParam), HIWORD(lParam));
+		break;
+
 	case WM_EXITMENULOOP:
 		OnExitMenuLoop(wParam);
 		break;
@@ -95,6 +97,7 @@ LRESULT Explorerplusplus::WindowProcedure(HWND hwnd, UINT msg, WPARAM wParam, LP
 			Tab &selectedTab = GetActivePane()->GetTabContainerImpl()->GetSelectedTab();
 
 			UpdateDisplayWindow(selectedTab);
+			UpdatePreviewPane(selectedTab);
 			UpdateStatusBarText(selectedTab);
 			m_mainToolbar->UpdateToolbarButtonStates();
 
@@ -470,6 +473,10 @@ LRESULT Explorerplusplus::HandleMenuOrToolbarButtonOrAccelerator(HWND hwnd, int
 		m_config->showDisplayWindow = !m_config->showDisplayWindow.get();
 		break;
 
+	case IDM_VIEW_PREVIEWPANE:
+		m_config->showPreviewPane = !m_config->showPreviewPane.get();
+		break;
+
 	case IDM_DISPLAYWINDOW_VERTICAL:
 		m_config->displayWindowVertical = !m_config->displayWindowVertical;
 		ApplyDisplayWindowPosition();
@@ -826,6 +833,50 @@ LRESULT Explorerplusplus::HandleMenuOrToolbarButtonOrAccelerator(HWND hwnd, int
 		OnSortBy(SortMode::MediaYear);
 		break;
 
+	case IDM_SORTBY_PLUGIN_COLUMN_1:
+		OnSortBy(SortMode::PluginColumn1);
+		break;
+
+	case IDM_SORTBY_PLUGIN_COLUMN_2:
+		OnSortBy(SortMode::PluginColumn2);
+		break;
+
+	case IDM_SORTBY_PLUGIN_COLUMN_3:
+		OnSortBy(SortMode::PluginColumn3);
+		break;
+
+	case IDM_SORTBY_PLUGIN_COLUMN_4:
+		OnSortBy(SortMode::PluginColumn4);
+		break;
+
+	case IDM_SORTBY_PLUGIN_COLUMN_5:
+		OnSortBy(SortMode::PluginColumn5);
+		break;
+
+	case IDM_SORTBY_PLUGIN_COLUMN_6:
+		OnSortBy(SortMode::PluginColumn6);
+		break;
+
+	case IDM_SORTBY_PLUGIN_COLUMN_7:
+		OnSortBy(SortMode::PluginColumn7);
+		break;
+
+	case IDM_SORTBY_PLUGIN_COLUMN_8:
+		OnSortBy(SortMode::PluginColumn8);
+		break;
+
+	case IDM_SORTBY_HASH_CRC32:
+		OnSortBy(SortMode::HashCrc32);
+		break;
+
+	case IDM_SORTBY_HASH_XXHASH64:
+		OnSortBy(SortMode::HashXxHash64);
+		break;
+
+	case IDM_SORTBY_HASH_SHA256:
+		OnSortBy(SortMode::HashSha256);
+		break;
+
 	case IDM_GROUPBY_NAME:
 		OnGroupBy(SortMode::Name);
 		break;
@@ -1074,6 +1125,50 @@ LRESULT Explorerplusplus::HandleMenuOrToolbarButtonOrAccelerator(HWND hwnd, int
 		OnGroupBy(SortMode::MediaYear);
 		break;
 
+	case IDM_GROUPBY_PLUGIN_COLUMN_1:
+		OnGroupBy(SortMode::PluginColumn1);
+		break;
+
+	case IDM_GROUPBY_PLUGIN_COLUMN_2:
+		OnGroupBy(SortMode::PluginColumn2);
+		break;
+
+	case IDM_GROUPBY_PLUGIN_COLUMN_3:
+		OnGroupBy(SortMode::PluginColumn3);
+		break;
+
+	case IDM_GROUPBY_PLUGIN_COLUMN_4:
+		OnGroupBy(SortMode::PluginColumn4);
+		break;
+
+	case IDM_GROUPBY_PLUGIN_COLUMN_5:
+		OnGroupBy(SortMode::PluginColumn5);
+		break;
+
+	case IDM_GROUPBY_PLUGIN_COLUMN_6:
+		OnGroupBy(SortMode::PluginColumn6);
+		break;
+
+	case IDM_GROUPBY_PLUGIN_COLUMN_7:
+		OnGroupBy(SortMode::PluginColumn7);
+		break;
+
+	case IDM_GROUPBY_PLUGIN_COLUMN_8:
+		OnGroupBy(SortMode::PluginColumn8);
+		break;
+
+	case IDM_GROUPBY_HASH_CRC32:
+		OnGroupBy(SortMode::HashCrc32);
+		break;
+
+	case IDM_GROUPBY_HASH_XXHASH64:
+		OnGroupBy(SortMode::HashXxHash64);
+		break;
+
+	case IDM_GROUPBY_HASH_SHA256:
+		OnGroupBy(SortMode::HashSha256);
+		break;
+
 	case IDM_GROUP_BY_NONE:
 		OnGroupByNone();
 		break;
@@ -1256,13 +1351,11 @@ LRESULT Explorerplusplus::HandleMenuOrToolbarButtonOrAccelerator(HWND hwnd, int
 
 	case MainToolbarButton::Bookmarks:
 	case IDM_BOOKMARKS_MANAGEBOOKMARKS:
-		CreateOrSwitchToModelessDialog(m_app->GetModelessDialogList(), L"ManageBookmarksDialog",
-			[this, hwnd]
-			{
-				return new ManageBookmarksDialog(m_app->GetResourceInstance(), hwnd,
-					m_app->GetThemeManager(), this, this, m_app->GetIconResourceLoader(),
-					&m_iconFetcher, m_app->GetBookmarkTree());
-			});
+		OnManageBookmarks(false);
+		break;
+
+	case IDM_BOOKMARKS_SEARCH_BOOKMARKS:
+		OnManageBookmarks(true);
 		break;
 
 	case MainToolbarButton::Search:
@@ -1270,6 +1363,18 @@ LRESULT Explorerplusplus::HandleMenuOrToolbarButtonOrAccelerator(HWND hwnd, int
 		OnSearch();
 		break;
 
+	case IDM_TOOLS_FIND_DUPLICATE_FILES:
+		OnFindDuplicateFiles();
+		break;
+
+	case IDM_TOOLS_COMPARE_FOLDERS:
+		OnCompareFolders();
+		break;
+
+	case IDM_TOOLS_RECORDTRACE:
+		OnRecordTrace();
+		break;
+
 	case IDM_TOOLS_CUSTOMIZECOLORS:
 		OnCustomizeColors();
 		break;
@@ -6,6 +6,7 @@
 #include "Explorer++.h"
 #include "AddressBar.h"
 #include "App.h"
+#include "ArchiveBrowserDialog.h"
 #include "BrowserTracker.h"
 #include "ColorRule.h"
 #include "Config.h"
@@ -16,6 +17,7 @@
 #include "MainRebarView.h"
 #include "MainResource.h"
 #include "MainToolbar.h"
+#include "ModelessDialogHelper.h"
 #include "Plugins/PluginManager.h"
 #include "ResourceHelper.h"
 #include "ShellBrowser/NavigateParams.h"
@@ -82,6 +84,11 @@ void Explorerplusplus::OpenItem(PCIDLIST_ABSOLUTE pidlItem,
 		// - .search-ms
 		// - .zip
 
+		if (MaybeOpenInArchiveBrowser(pidlItem))
+		{
+			return;
+		}
+
 		if (ShouldOpenContainerFile(pidlItem))
 		{
 			OpenFolderItem(pidlItem, openFolderDisposition);
@@ -155,6 +162,40 @@ void Explorerplusplus::OpenShortcutItem(PCIDLIST_ABSOLUTE pidlItem,
 	}
 }
 
+// Opens .zip files in the built-in archive browser, if that's enabled. Returns true if the item was
+// opened.
+bool Explorerplusplus::MaybeOpenInArchiveBrowser(PCIDLIST_ABSOLUTE pidlItem)
+{
+	if (!m_config->openZipFilesInArchiveBrowser)
+	{
+		return false;
+	}
+
+	// The archive browser reads the file directly, so this only applies to archives in the
+	// filesystem (and not, for example, to an archive within another archive).
+	SFGAOF attributes = SFGAO_FILESYSTEM;
+	HRESULT hr = GetItemAttributes(pidlItem, &attributes);
+
+	if (FAILED(hr) || WI_IsFlagClear(attributes, SFGAO_FILESYSTEM))
+	{
+		return false;
+	}
+
+	std::wstring parsingPath;
+	hr = GetDisplayName(pidlItem, SHGDN_FORPARSING, parsingPath);
+
+	if (FAILED(hr) || lstrcmpi(PathFindExtension(parsingPath.c_str()), L".zip") != 0)
+	{
+		return false;
+	}
+
+	CreateOrSwitchToModelessDialog(m_app->GetModelessDialogList(),
+		L"ArchiveBrowserDialog:" + parsingPath, [this, parsingPath]
+		{ return ArchiveBrowserDialog::Create(m_app, m_hContainer, parsingPath); });
+
+	return true;
+}
+
 // Returns true if the specified container file should be opened as a folder. If false, the file
 // should be opened via the shell.
 bool Explorerplusplus::ShouldOpenContainerFile(PCIDLIST_ABSOLUTE pidlItem)
@@ -326,6 +367,11 @@ void Explorerplusplus::UpdateLayout()
 		dpiCompatibility.ScaleValue(m_displayWindow->GetHWND(), DISPLAY_WINDOW_MINIMUM_WIDTH));
 	m_displayWindowHeight = std::max(m_displayWindowHeight,
 		dpiCompatibility.ScaleValue(m_displayWindow->GetHWND(), DISPLAY_WINDOW_MINIMUM_HEIGHT));
+	m_previewPaneWidth = std::clamp(m_previewPaneWidth,
+		dpiCompatibility.ScaleValue(m_previewPaneHolder->GetHWND(), PREVIEW_PANE_MINIMUM_WIDTH),
+		std::max(static_cast<int>(PREVIEW_PANE_MAXIMUM_WIDTH_PERCENTAGE * mainWindowWidth),
+			dpiCompatibility.ScaleValue(m_previewPaneHolder->GetHWND(),
+				PREVIEW_PANE_MINIMUM_WIDTH)));
 
 	auto rebarHeight = m_mainRebarView->GetHeight();
 	SetWindowPos(m_mainRebarView->GetHWND(), nullptr, 0, 0, mainWindowWidth, rebarHeight,
@@ -352,6 +398,15 @@ void Explorerplusplus::UpdateLayout()
 		}
 	}
 
+	// The preview pane is shown to the left of the display window, when the display window is
+	// vertical.
+	int previewPaneLeft = mainWindowWidth - indentRight - m_previewPaneWidth;
+
+	if (m_config->showPreviewPane.get())
+	{
+		indentRight += m_previewPaneWidth;
+	}
+
 	if (m_config->showFolders.get())
 	{
 		indentLeft = m_treeViewWidth;
@@ -447,6 +502,12 @@ void Explorerplusplus::UpdateLayout()
 	SetWindowPos(m_treeViewHolder->GetHWND(), nullptr, 0, holderTop, m_treeViewWidth, holderHeight,
 		SWP_NOZORDER);
 
+	/* <---- Preview pane ----> */
+
+	SetWindowPos(m_previewPaneHolder->GetHWND(), nullptr, previewPaneLeft, holderTop,
+		m_previewPaneWidth, holderHeight,
+		(m_config->showPreviewPane.get() ? SWP_SHOWWINDOW : SWP_HIDEWINDOW) | SWP_NOZORDER);
+
 	/* <---- Display window ----> */
 
 	UINT displayWindowShowFlags =
@@ -531,6 +592,14 @@ int Explorerplusplus::OnDestroy()
 	// Therefore, all slots are disconnected here.
 	m_focusChangedSignal.disconnect_all_slots();
 
+	if (m_pathsClipboardDataObject
+		&& OleIsCurrentClipboard(m_pathsClipboardDataObject.get()) == S_OK)
+	{
+		// The copied paths won't have been rendered yet, so that needs to be done now, in order
+		// for them to remain on the clipboard once the application has exited.
+		OleFlushClipboard();
+	}
+
 	if (m_SHChangeNotifyID != 0)
 	{
 		SHChangeNotifyDeregister(m_SHChangeNotifyID);
@@ -735,8 +804,7 @@ void Explorerplusplus::CopyColumnInfoToClipboard()
 	{
 		if (column.checked)
 		{
-			auto columnName = ResourceHelper::LoadString(m_app->GetResourceInstance(),
-				ShellBrowserImpl::LookupColumnNameStringIndex(column.type));
+			auto columnName = m_pActiveShellBrowser->GetColumnName(column.type);
 			strColumnInfo += columnName + L"\t";
 
 			nActiveColumns++;
@@ -157,6 +157,17 @@ public:
 		Navigate(entry);
 	}
 
+	// Limits the number of entries that are retained. Once the limit is exceeded, the oldest back
+	// entries will be removed, followed by the most distant forward entries. The current entry is
+	// never removed. A value of 0 means that the number of entries isn't limited.
+	void SetMaxEntries(int maxEntries)
+	{
+		DCHECK_GE(maxEntries, 0);
+
+		m_maxEntries = maxEntries;
+		TrimEntries();
+	}
+
 protected:
 	virtual void Navigate(const HistoryEntryType *entry) = 0;
 
@@ -168,6 +179,8 @@ protected:
 		m_entries.push_back(std::move(entry));
 		m_currentEntry++;
 
+		TrimEntries();
+
 		return m_currentEntry;
 	}
 
@@ -194,6 +207,25 @@ protected:
 	}
 
 private:
+	void TrimEntries()
+	{
+		if (m_maxEntries == 0 || GetNumHistoryEntries() <= m_maxEntries)
+		{
+			return;
+		}
+
+		int numBackEntriesToRemove =
+			std::min(GetNumHistoryEntries() - m_maxEntries, m_currentEntry);
+		m_entries.erase(m_entries.begin(), m_entries.begin() + numBackEntriesToRemove);
+		m_currentEntry -= numBackEntriesToRemove;
+
+		if (GetNumHistoryEntries() > m_maxEntries)
+		{
+			m_entries.resize(m_maxEntries);
+		}
+	}
+
 	std::vector<std::unique_ptr<HistoryEntryType>> m_entries;
 	int m_currentEntry;
+	int m_maxEntries = 0;
 };
@@ -0,0 +1,520 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "stdafx.h"
+#include "PathCompletionIndex.h"
+#include <glog/logging.h>
+#include <algorithm>
+#include <cmath>
+#include <cwctype>
+#include <numbers>
+#include <queue>
+
+namespace
+{
+
+// The clock is only checked periodically while querying, since retrieving the current time isn't
+// free.
+constexpr int QUERY_STEPS_BETWEEN_TIME_CHECKS = 64;
+
+bool IsPathSeparator(wchar_t c)
+{
+	return c == '\\' || c == '/';
+}
+
+}
+
+float PathCompletionIndex::CalculateFrecency(double weight, SystemClock::TimePoint time)
+{
+	DCHECK_GT(weight, 0);
+
+	auto halfLives = std::chrono::duration<double>(time.time_since_epoch())
+		/ std::chrono::duration<double>(FRECENCY_HALF_LIFE);
+	return static_cast<float>(std::log(weight) + (halfLives * std::numbers::ln2));
+}
+
+float PathCompletionIndex::CombineScores(float score1, float score2)
+{
+	if (score1 == NO_SCORE)
+	{
+		return score2;
+	}
+	else if (score2 == NO_SCORE)
+	{
+		return score1;
+	}
+
+	// log(e^a + e^b), calculated in a way that avoids overflow.
+	float maxScore = std::max(score1, score2);
+	float minScore = std::min(score1, score2);
+	return maxScore + std::log1p(std::exp(minScore - maxScore));
+}
+
+void PathCompletionIndex::SetSourceScore(std::wstring_view path, Source source, float score)
+{
+	DCHECK_NE(score, NO_SCORE);
+
+	NodeId nodeId = GetOrCreateNode(path);
+	auto &node = m_nodes[nodeId];
+
+	if (node.entry == NO_ENTRY)
+	{
+		Entry entry = { nodeId, NO_SCORE, {} };
+		entry.sourceScores.fill(NO_SCORE);
+
+		if (m_freeEntries.empty())
+		{
+			node.entry = static_cast<EntryId>(m_entries.size());
+			m_entries.push_back(entry);
+		}
+		else
+		{
+			node.entry = m_freeEntries.back();
+			m_freeEntries.pop_back();
+			m_entries[node.entry] = entry;
+		}
+	}
+
+	m_entries[node.entry].sourceScores[static_cast<size_t>(source)] = score;
+	UpdateEntryScore(nodeId);
+}
+
+void PathCompletionIndex::AddToSourceScore(std::wstring_view path, Source source, float score)
+{
+	auto existingScore = GetSourceScore(path, source);
+	SetSourceScore(path, source, existingScore ? CombineScores(*existingScore, score) : score);
+}
+
+std::optional<float> PathCompletionIndex::GetSourceScore(std::wstring_view path,
+	Source source) const
+{
+	const auto *entry = MaybeGetEntry(path);
+
+	if (!entry || entry->sourceScores[static_cast<size_t>(source)] == NO_SCORE)
+	{
+		return std::nullopt;
+	}
+
+	return entry->sourceScores[static_cast<size_t>(source)];
+}
+
+void PathCompletionIndex::ClearSourceScore(std::wstring_view path, Source source)
+{
+	NodeId nodeId = FindNode(path);
+
+	if (nodeId == NO_NODE || m_nodes[nodeId].entry == NO_ENTRY)
+	{
+		return;
+	}
+
+	auto &entry = m_entries[m_nodes[nodeId].entry];
+	entry.sourceScores[static_cast<size_t>(source)] = NO_SCORE;
+
+	if (std::ranges::all_of(entry.sourceScores, [](float score) { return score == NO_SCORE; }))
+	{
+		RemoveEntry(nodeId);
+		return;
+	}
+
+	UpdateEntryScore(nodeId);
+}
+
+void PathCompletionIndex::UpdateEntryScore(NodeId nodeId)
+{
+	auto &entry = m_entries[m_nodes[nodeId].entry];
+	float previousScore = entry.score;
+
+	entry.score = NO_SCORE;
+
+	for (float sourceScore : entry.sourceScores)
+	{
+		entry.score = CombineScores(entry.score, sourceScore);
+	}
+
+	if (entry.score >= previousScore)
+	{
+		// Raising the score of an entry can only ever raise the maximum score of the nodes above
+		// it, so there's no need to look at any sibling nodes.
+		for (NodeId currentId = nodeId;
+			currentId != NO_NODE && m_nodes[currentId].maxSubtreeScore < entry.score;
+			currentId = m_nodes[currentId].parent)
+		{
+			m_nodes[currentId].maxSubtreeScore = entry.score;
+		}
+	}
+	else
+	{
+		PropagateMaxScore(nodeId);
+	}
+}
+
+void PathCompletionIndex::RemoveEntry(NodeId nodeId)
+{
+	auto &node = m_nodes[nodeId];
+	m_freeEntries.push_back(node.entry);
+	node.entry = NO_ENTRY;
+
+	PropagateMaxScore(nodeId);
+	MaybeRemoveNode(nodeId);
+}
+
+// Recalculates the maximum subtree score for the specified node and each of its ancestors, stopping
+// once a node's score doesn't change.
+void PathCompletionIndex::PropagateMaxScore(NodeId nodeId)
+{
+	for (NodeId currentId = nodeId; currentId != NO_NODE; currentId = m_nodes[currentId].parent)
+	{
+		auto &node = m_nodes[currentId];
+		float maxScore = (node.entry == NO_ENTRY) ? NO_SCORE : m_entries[node.entry].score;
+
+		for (NodeId childId : node.children)
+		{
+			maxScore = std::max(maxScore, m_nodes[childId].maxSubtreeScore);
+		}
+
+		if (maxScore == node.maxSubtreeScore && currentId != nodeId)
+		{
+			break;
+		}
+
+		node.maxSubtreeScore = maxScore;
+	}
+}
+
+// Removes the node (and any ancestors) if the node no longer serves any purpose.
+void PathCompletionIndex::MaybeRemoveNode(NodeId nodeId)
+{
+	while (nodeId != ROOT_NODE_ID)
+	{
+		auto &node = m_nodes[nodeId];
+
+		if (node.entry != NO_ENTRY || !node.children.empty())
+		{
+			break;
+		}
+
+		NodeId parentId = node.parent;
+		auto &siblings = m_nodes[parentId].children;
+		siblings.erase(std::ranges::find(siblings, nodeId));
+
+		// Note that the node's name is left in the pool. Removing paths is expected to be
+		// relatively rare, so the wasted space isn't significant.
+		node = Node();
+		m_freeNodes.push_back(nodeId);
+
+		nodeId = parentId;
+	}
+}
+
+std::vector<PathCompletionIndex::Match> PathCompletionIndex::Query(std::wstring_view text,
+	size_t maxResults, std::chrono::microseconds timeBudget) const
+{
+	std::optional<std::chrono::steady_clock::time_point> deadline;
+
+	if (timeBudget != std::chrono::microseconds::max())
+	{
+		deadline = std::chrono::steady_clock::now() + timeBudget;
+	}
+
+	// Everything up to the final separator has to match a path exactly, while the text after the
+	// final separator can match the start of any name in that directory.
+	NodeId directoryId = ROOT_NODE_ID;
+	std::wstring_view partialName = text;
+	auto separatorItr = std::find_if(text.rbegin(), text.rend(), IsPathSeparator);
+
+	if (separatorItr != text.rend())
+	{
+		auto separatorIndex = std::distance(separatorItr, text.rend()) - 1;
+		directoryId = FindNode(text.substr(0, separatorIndex));
+		partialName = text.substr(separatorIndex + 1);
+	}
+
+	if (directoryId == NO_NODE || maxResults == 0)
+	{
+		return {};
+	}
+
+	struct Candidate
+	{
+		float score;
+		NodeId nodeId;
+
+		// If this is false, the candidate represents the subtree rooted at the node. Otherwise, it
+		// represents the path stored at the node.
+		bool isEntry;
+
+		bool operator<(const Candidate &other) const
+		{
+			// Candidates with the highest score are processed first. The remaining comparisons
+			// ensure that results are ordered consistently when scores are equal.
+			if (score != other.score)
+			{
+				return score < other.score;
+			}
+
+			if (isEntry != other.isEntry)
+			{
+				return !isEntry;
+			}
+
+			return nodeId > other.nodeId;
+		}
+	};
+
+	std::priority_queue<Candidate> candidates;
+	const auto &directoryChildren = m_nodes[directoryId].children;
+	auto itr = std::lower_bound(directoryChildren.begin(), directoryChildren.end(), partialName,
+		[this](NodeId childId, std::wstring_view name)
+		{ return CompareNames(GetNodeName(childId), name) < 0; });
+
+	for (; itr != directoryChildren.end() && NameStartsWith(GetNodeName(*itr), partialName); ++itr)
+	{
+		candidates.push({ m_nodes[*itr].maxSubtreeScore, *itr, false });
+	}
+
+	std::vector<Match> matches;
+	int numSteps = 0;
+
+	while (!candidates.empty() && matches.size() < maxResults)
+	{
+		if (deadline && (++numSteps % QUERY_STEPS_BETWEEN_TIME_CHECKS) == 0
+			&& std::chrono::steady_clock::now() >= *deadline)
+		{
+			break;
+		}
+
+		auto candidate = candidates.top();
+		candidates.pop();
+
+		if (candidate.isEntry)
+		{
+			matches.emplace_back(GetNodePath(candidate.nodeId), candidate.score);
+			continue;
+		}
+
+		const auto &node = m_nodes[candidate.nodeId];
+
+		if (node.entry != NO_ENTRY)
+		{
+			candidates.push({ m_entries[node.entry].score, candidate.nodeId, true });
+		}
+
+		for (NodeId childId : node.children)
+		{
+			candidates.push({ m_nodes[childId].maxSubtreeScore, childId, false });
+		}
+	}
+
+	return matches;
+}
+
+bool PathCompletionIndex::ContainsPath(std::wstring_view path) const
+{
+	return MaybeGetEntry(path) != nullptr;
+}
+
+size_t PathCompletionIndex::GetNumPaths() const
+{
+	return m_entries.size() - m_freeEntries.size();
+}
+
+const PathCompletionIndex::Entry *PathCompletionIndex::MaybeGetEntry(std::wstring_view path) const
+{
+	NodeId nodeId = FindNode(path);
+
+	if (nodeId == NO_NODE || m_nodes[nodeId].entry == NO_ENTRY)
+	{
+		return nullptr;
+	}
+
+	return &m_entries[m_nodes[nodeId].entry];
+}
+
+// Splits a path into its components. Any trailing separators are ignored (so that "C:\" and "C:"
+// refer to the same item), but leading separators are retained, since they're significant (e.g.
+// in a UNC path like "\\server\share").
+std::vector<std::wstring_view> PathCompletionIndex::SplitPath(std::wstring_view path)
+{
+	while (path.size() > 1 && IsPathSeparator(path.back()))
+	{
+		path.remove_suffix(1);
+	}
+
+	std::vector<std::wstring_view> components;
+
+	if (path.empty())
+	{
+		return components;
+	}
+
+	size_t start = 0;
+
+	for (size_t i = 0; i <= path.size(); i++)
+	{
+		if (i == path.size() || IsPathSeparator(path[i]))
+		{
+			components.push_back(path.substr(start, i - start));
+			start = i + 1;
+		}
+	}
+
+	return components;
+}
+
+int PathCompletionIndex::CompareNames(std::wstring_view name1, std::wstring_view name2)
+{
+	size_t commonLength = std::min(name1.size(), name2.size());
+
+	for (size_t i = 0; i < commonLength; i++)
+	{
+		auto c1 = std::towlower(name1[i]);
+		auto c2 = std::towlower(name2[i]);
+
+		if (c1 != c2)
+		{
+			return (c1 < c2) ? -1 : 1;
+		}
+	}
+
+	if (name1.size() == name2.size())
+	{
+		return 0;
+	}
+
+	return (name1.size() < name2.size()) ? -1 : 1;
+}
+
+bool PathCompletionIndex::NameStartsWith(std::wstring_view name, std::wstring_view prefix)
+{
+	return name.size() >= prefix.size() && CompareNames(name.substr(0, prefix.size()), prefix) == 0;
+}
+
+std::wstring_view PathCompletionIndex::GetNodeName(NodeId nodeId) const
+{
+	const auto &node = m_nodes[nodeId];
+	return std::wstring_view(m_namePool).substr(node.nameOffset, node.nameLength);
+}
+
+std::wstring PathCompletionIndex::GetNodePath(NodeId nodeId) const
+{
+	std::vector<std::wstring_view> components;
+
+	for (NodeId currentId = nodeId; currentId != ROOT_NODE_ID;
+		currentId = m_nodes[currentId].parent)
+	{
+		components.push_back(GetNodeName(currentId));
+	}
+
+	std::wstring path;
+
+	for (auto itr = components.rbegin(); itr != components.rend(); ++itr)
+	{
+		if (itr != components.rbegin())
+		{
+			path += '\\';
+		}
+
+		path += *itr;
+	}
+
+	// A drive root like "C:" is shown as "C:\", since that's the way the path would normally be
+	// written.
+	if (components.size() == 1 && path.ends_with(':'))
+	{
+		path += '\\';
+	}
+
+	return path;
+}
+
+PathCompletionIndex::NodeId PathCompletionIndex::FindNode(std::wstring_view path) const
+{
+	NodeId nodeId = ROOT_NODE_ID;
+
+	for (auto component : SplitPath(path))
+	{
+		nodeId = FindChild(nodeId, component);
+
+		if (nodeId == NO_NODE)
+		{
+			break;
+		}
+	}
+
+	return nodeId;
+}
+
+PathCompletionIndex::NodeId PathCompletionIndex::FindChild(NodeId parentId,
+	std::wstring_view name) const
+{
+	const auto &children = m_nodes[parentId].children;
+	auto itr = std::lower_bound(children.begin(), children.end(), name,
+		[this](NodeId childId, std::wstring_view name)
+		{ return CompareNames(GetNodeName(childId), name) < 0; });
+
+	if (itr == children.end() || CompareNames(GetNodeName(*itr), name) != 0)
+	{
+		return NO_NODE;
+	}
+
+	return *itr;
+}
+
+PathCompletionIndex::NodeId PathCompletionIndex::GetOrCreateNode(std::wstring_view path)
+{
+	auto components = SplitPath(path);
+	CHECK(!components.empty());
+
+	NodeId nodeId = ROOT_NODE_ID;
+
+	for (auto component : components)
+	{
+		nodeId = GetOrCreateChild(nodeId, component);
+	}
+
+	return nodeId;
+}
+
+PathCompletionIndex::NodeId PathCompletionIndex::GetOrCreateChild(NodeId parentId,
+	std::wstring_view name)
+{
+	auto &children = m_nodes[parentId].children;
+	auto itr = std::lower_bound(children.begin(), children.end(), name,
+		[this](NodeId childId, std::wstring_view name)
+		{ return CompareNames(GetNodeName(childId), name) < 0; });
+
+	if (itr != children.end() && CompareNames(GetNodeName(*itr), name) == 0)
+	{
+		return *itr;
+	}
+
+	auto insertionIndex = std::distance(children.begin(), itr);
+
+	Node node;
+	node.nameOffset = static_cast<uint32_t>(m_namePool.size());
+	node.nameLength = static_cast<uint32_t>(name.size());
+	node.parent = parentId;
+	m_namePool.append(name);
+
+	NodeId nodeId;
+
+	if (m_freeNodes.empty())
+	{
+		nodeId = static_cast<NodeId>(m_nodes.size());
+		m_nodes.push_back(std::move(node));
+	}
+	else
+	{
+		nodeId = m_freeNodes.back();
+		m_freeNodes.pop_back();
+		m_nodes[nodeId] = std::move(node);
+	}
+
+	// Note that m_nodes may have been reallocated above, so the children vector needs to be
+	// retrieved again.
+	auto &updatedChildren = m_nodes[parentId].children;
+	updatedChildren.insert(updatedChildren.begin() + insertionIndex, nodeId);
+
+	return nodeId;
+}
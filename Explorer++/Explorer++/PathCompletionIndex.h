@@ -0,0 +1,133 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#pragma once
+
+#include "../Helper/SystemClock.h"
+#include <boost/core/noncopyable.hpp>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Stores a set of paths in a trie (with one node per path component) and allows the paths that
+// begin with a particular piece of text to be retrieved, ranked by frecency.
+//
+// Each path can be contributed by several sources (e.g. it may be both bookmarked and in the
+// history). Each source assigns a score to the path and the overall score for the path is the
+// combination of those individual scores.
+//
+// Scores are stored in the log domain, relative to a fixed epoch. A visit with weight w at time t
+// has a score of log(w) + (t - epoch) * ln(2) / FRECENCY_HALF_LIFE. Because every score decays at
+// the same rate, the relative order of two scores never changes as time passes, so scores never
+// need to be recalculated. Combining two scores is equivalent to adding the underlying (linear)
+// values together.
+//
+// Each node also records the highest score in its subtree, which allows the best matches to be
+// found without visiting every path under the matching nodes.
+class PathCompletionIndex : private boost::noncopyable
+{
+public:
+	enum class Source
+	{
+		EnumeratedFolder,
+		History,
+		FrequentLocation,
+		Bookmark,
+
+		Count
+	};
+
+	struct Match
+	{
+		std::wstring path;
+		float score;
+	};
+
+	static constexpr auto FRECENCY_HALF_LIFE = std::chrono::days(30);
+
+	static float CalculateFrecency(double weight, SystemClock::TimePoint time);
+	static float CombineScores(float score1, float score2);
+
+	// Sets the score that the specified source assigns to the path, adding the path to the index if
+	// necessary.
+	void SetSourceScore(std::wstring_view path, Source source, float score);
+
+	// Equivalent to calling SetSourceScore() with the combination of the existing score and the
+	// provided score.
+	void AddToSourceScore(std::wstring_view path, Source source, float score);
+
+	std::optional<float> GetSourceScore(std::wstring_view path, Source source) const;
+
+	// Removes the contribution from the specified source. Once a path has no remaining sources, it
+	// will be removed from the index.
+	void ClearSourceScore(std::wstring_view path, Source source);
+
+	// Returns up to maxResults paths that begin with the specified text (compared
+	// case-insensitively), with the highest scoring paths first. The search will stop once the
+	// time budget has been exhausted, in which case the best matches found up to that point will
+	// be returned.
+	std::vector<Match> Query(std::wstring_view text, size_t maxResults,
+		std::chrono::microseconds timeBudget = std::chrono::microseconds::max()) const;
+
+	bool ContainsPath(std::wstring_view path) const;
+	size_t GetNumPaths() const;
+
+private:
+	using NodeId = uint32_t;
+	using EntryId = uint32_t;
+	using SourceScores = std::array<float, static_cast<size_t>(Source::Count)>;
+
+	static constexpr NodeId ROOT_NODE_ID = 0;
+	static constexpr EntryId NO_ENTRY = UINT32_MAX;
+	static constexpr NodeId NO_NODE = UINT32_MAX;
+	static constexpr float NO_SCORE = -std::numeric_limits<float>::infinity();
+
+	// The name of each node is stored in a shared pool, which substantially reduces the amount of
+	// memory used when there are a large number of nodes.
+	struct Node
+	{
+		uint32_t nameOffset = 0;
+		uint32_t nameLength = 0;
+		NodeId parent = NO_NODE;
+		EntryId entry = NO_ENTRY;
+		float maxSubtreeScore = NO_SCORE;
+
+		// Sorted by name (case-insensitively).
+		std::vector<NodeId> children;
+	};
+
+	struct Entry
+	{
+		NodeId node;
+		float score;
+		SourceScores sourceScores;
+	};
+
+	static std::vector<std::wstring_view> SplitPath(std::wstring_view path);
+	static int CompareNames(std::wstring_view name1, std::wstring_view name2);
+	static bool NameStartsWith(std::wstring_view name, std::wstring_view prefix);
+
+	std::wstring_view GetNodeName(NodeId nodeId) const;
+	std::wstring GetNodePath(NodeId nodeId) const;
+	NodeId FindNode(std::wstring_view path) const;
+	NodeId FindChild(NodeId parentId, std::wstring_view name) const;
+	NodeId GetOrCreateNode(std::wstring_view path);
+	NodeId GetOrCreateChild(NodeId parentId, std::wstring_view name);
+	const Entry *MaybeGetEntry(std::wstring_view path) const;
+	void UpdateEntryScore(NodeId nodeId);
+	void RemoveEntry(NodeId nodeId);
+	void PropagateMaxScore(NodeId nodeId);
+	void MaybeRemoveNode(NodeId nodeId);
+
+	std::vector<Node> m_nodes = { Node() };
+	std::vector<NodeId> m_freeNodes;
+	std::vector<Entry> m_entries;
+	std::vector<EntryId> m_freeEntries;
+	std::wstring m_namePool;
+};
@@ -0,0 +1,220 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "stdafx.h"
+#include "PathCompletionProvider.h"
+#include "Bookmarks/BookmarkTree.h"
+#include "FrequentLocationsModel.h"
+#include "HistoryModel.h"
+#include "../Helper/ShellHelper.h"
+#include "../Helper/SystemClock.h"
+#include <boost/algorithm/string/case_conv.hpp>
+
+PathCompletionProvider::PathCompletionProvider(HistoryModel *historyModel,
+	FrequentLocationsModel *frequentLocationsModel, BookmarkTree *bookmarkTree,
+	SystemClock *systemClock) :
+	m_historyModel(historyModel),
+	m_frequentLocationsModel(frequentLocationsModel),
+	m_bookmarkTree(bookmarkTree),
+	m_systemClock(systemClock)
+{
+}
+
+void PathCompletionProvider::EnsureInitialized()
+{
+	if (m_initialized)
+	{
+		return;
+	}
+
+	m_initialized = true;
+
+	{
+		std::unique_lock lock(m_mutex);
+
+		// Each entry in the history is also recorded as a visit in the frequent locations model
+		// (which additionally contains visits from previous sessions), so the existing history
+		// items don't need to be added here. New history items will be added as they're created.
+		for (const auto &locationVisit : m_frequentLocationsModel->GetVisits())
+		{
+			auto path = GetFolderPathForDisplay(locationVisit.GetLocation().Raw());
+
+			if (!path)
+			{
+				continue;
+			}
+
+			m_index.SetSourceScore(*path, PathCompletionIndex::Source::FrequentLocation,
+				PathCompletionIndex::CalculateFrecency(locationVisit.GetNumVisits(),
+					locationVisit.GetLastVisitTime()));
+		}
+	}
+
+	OnBookmarkItemAdded(*m_bookmarkTree->GetRoot());
+
+	m_connections.push_back(m_historyModel->AddHistoryChangedObserver(
+		std::bind(&PathCompletionProvider::OnHistoryChanged, this)));
+
+	m_connections.push_back(m_bookmarkTree->bookmarkItemAddedSignal.AddObserver(
+		[this](BookmarkItem &bookmarkItem, size_t index)
+		{
+			UNREFERENCED_PARAMETER(index);
+
+			OnBookmarkItemAdded(bookmarkItem);
+		}));
+	m_connections.push_back(m_bookmarkTree->bookmarkItemUpdatedSignal.AddObserver(
+		std::bind_front(&PathCompletionProvider::OnBookmarkItemUpdated, this)));
+	m_connections.push_back(m_bookmarkTree->bookmarkItemPreRemovalSignal.AddObserver(
+		std::bind_front(&PathCompletionProvider::OnBookmarkItemPreRemoval, this)));
+}
+
+std::vector<std::wstring> PathCompletionProvider::GetCompletions(std::wstring_view text,
+	size_t maxResults) const
+{
+	std::shared_lock lock(m_mutex);
+	auto matches = m_index.Query(text, maxResults, QUERY_TIME_BUDGET);
+	lock.unlock();
+
+	std::vector<std::wstring> completions;
+	completions.reserve(matches.size());
+
+	for (auto &match : matches)
+	{
+		completions.push_back(std::move(match.path));
+	}
+
+	return completions;
+}
+
+bool PathCompletionProvider::ShouldEnumerateDirectory(const std::wstring &directory) const
+{
+	auto itr = m_enumeratedDirectories.find(boost::algorithm::to_lower_copy(directory));
+
+	if (itr == m_enumeratedDirectories.end())
+	{
+		return true;
+	}
+
+	return std::chrono::steady_clock::now() - itr->second
+		>= DIRECTORY_ENUMERATION_REFRESH_INTERVAL;
+}
+
+void PathCompletionProvider::AddEnumeratedFolders(const std::wstring &directory,
+	const std::vector<std::wstring> &folders)
+{
+	m_enumeratedDirectories[boost::algorithm::to_lower_copy(directory)] =
+		std::chrono::steady_clock::now();
+
+	auto score = PathCompletionIndex::CalculateFrecency(ENUMERATED_FOLDER_WEIGHT,
+		m_systemClock->Now());
+
+	std::unique_lock lock(m_mutex);
+
+	for (const auto &folder : folders)
+	{
+		m_index.SetSourceScore(folder, PathCompletionIndex::Source::EnumeratedFolder, score);
+	}
+}
+
+void PathCompletionProvider::OnHistoryChanged()
+{
+	const auto &historyItems = m_historyModel->GetHistoryItems();
+
+	if (historyItems.empty())
+	{
+		return;
+	}
+
+	auto path = GetFolderPathForDisplay(historyItems.front().Raw());
+
+	if (!path)
+	{
+		return;
+	}
+
+	std::unique_lock lock(m_mutex);
+	m_index.AddToSourceScore(*path, PathCompletionIndex::Source::History,
+		PathCompletionIndex::CalculateFrecency(HISTORY_VISIT_WEIGHT, m_systemClock->Now()));
+}
+
+void PathCompletionProvider::OnBookmarkItemAdded(BookmarkItem &bookmarkItem)
+{
+	// When a folder is added, its children are added along with it, but no separate notifications
+	// are sent for those children.
+	bookmarkItem.VisitRecursively(
+		[this](BookmarkItem *currentItem)
+		{
+			if (currentItem->IsBookmark())
+			{
+				AddBookmarkLocation(currentItem->GetGUID(), currentItem->GetLocation());
+			}
+		});
+}
+
+void PathCompletionProvider::OnBookmarkItemUpdated(BookmarkItem &bookmarkItem,
+	BookmarkItem::PropertyType propertyType)
+{
+	if (propertyType != BookmarkItem::PropertyType::Location)
+	{
+		return;
+	}
+
+	RemoveBookmarkLocation(bookmarkItem.GetGUID());
+	AddBookmarkLocation(bookmarkItem.GetGUID(), bookmarkItem.GetLocation());
+}
+
+void PathCompletionProvider::OnBookmarkItemPreRemoval(BookmarkItem &bookmarkItem)
+{
+	bookmarkItem.VisitRecursively(
+		[this](BookmarkItem *currentItem)
+		{
+			if (currentItem->IsBookmark())
+			{
+				RemoveBookmarkLocation(currentItem->GetGUID());
+			}
+		});
+}
+
+void PathCompletionProvider::AddBookmarkLocation(const std::wstring &guid,
+	const std::wstring &location)
+{
+	if (location.empty())
+	{
+		return;
+	}
+
+	m_bookmarkLocations[guid] = location;
+
+	if (m_bookmarkLocationCounts[location]++ > 0)
+	{
+		return;
+	}
+
+	std::unique_lock lock(m_mutex);
+	m_index.SetSourceScore(location, PathCompletionIndex::Source::Bookmark,
+		PathCompletionIndex::CalculateFrecency(BOOKMARK_WEIGHT, m_systemClock->Now()));
+}
+
+void PathCompletionProvider::RemoveBookmarkLocation(const std::wstring &guid)
+{
+	auto itr = m_bookmarkLocations.find(guid);
+
+	if (itr == m_bookmarkLocations.end())
+	{
+		return;
+	}
+
+	auto location = itr->second;
+	m_bookmarkLocations.erase(itr);
+
+	if (--m_bookmarkLocationCounts[location] > 0)
+	{
+		return;
+	}
+
+	m_bookmarkLocationCounts.erase(location);
+
+	std::unique_lock lock(m_mutex);
+	m_index.ClearSourceScore(location, PathCompletionIndex::Source::Bookmark);
+}
@@ -0,0 +1,89 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#pragma once
+
+#include "Bookmarks/BookmarkItem.h"
+#include "PathCompletionIndex.h"
+#include <boost/core/noncopyable.hpp>
+#include <boost/signals2.hpp>
+#include <chrono>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class BookmarkTree;
+class FrequentLocationsModel;
+class HistoryModel;
+class SystemClock;
+
+// Provides completions for paths entered in the address bar. Completions are drawn from the
+// history, frequent locations, bookmarks and from any folders whose children have been enumerated.
+//
+// With the exception of GetCompletions(), the methods here should only be called on the UI thread.
+class PathCompletionProvider : private boost::noncopyable
+{
+public:
+	// Each query will stop once this amount of time has passed, which ensures that retrieving
+	// completions won't noticeably delay typing, however large the index is.
+	static constexpr auto QUERY_TIME_BUDGET = std::chrono::milliseconds(10);
+
+	PathCompletionProvider(HistoryModel *historyModel,
+		FrequentLocationsModel *frequentLocationsModel, BookmarkTree *bookmarkTree,
+		SystemClock *systemClock);
+
+	// The index is only built the first time this is called (which happens when the address bar is
+	// first used), so that there's no startup cost if completions are never needed.
+	void EnsureInitialized();
+
+	// Returns the best completions for the specified text, with the best completions first. This
+	// can be safely called from any thread.
+	std::vector<std::wstring> GetCompletions(std::wstring_view text, size_t maxResults) const;
+
+	// Returns true if the child folders of the specified directory should be retrieved (i.e. they
+	// haven't been retrieved recently).
+	bool ShouldEnumerateDirectory(const std::wstring &directory) const;
+
+	void AddEnumeratedFolders(const std::wstring &directory,
+		const std::vector<std::wstring> &folders);
+
+private:
+	// The weights assigned to each type of item. A bookmark, for example, is treated as being
+	// worth the same as several recent visits.
+	static constexpr double HISTORY_VISIT_WEIGHT = 1;
+	static constexpr double BOOKMARK_WEIGHT = 5;
+	static constexpr double ENUMERATED_FOLDER_WEIGHT = 0.1;
+
+	static constexpr auto DIRECTORY_ENUMERATION_REFRESH_INTERVAL = std::chrono::minutes(1);
+
+	void OnHistoryChanged();
+	void OnBookmarkItemAdded(BookmarkItem &bookmarkItem);
+	void OnBookmarkItemUpdated(BookmarkItem &bookmarkItem,
+		BookmarkItem::PropertyType propertyType);
+	void OnBookmarkItemPreRemoval(BookmarkItem &bookmarkItem);
+	void AddBookmarkLocation(const std::wstring &guid, const std::wstring &location);
+	void RemoveBookmarkLocation(const std::wstring &guid);
+
+	HistoryModel *const m_historyModel;
+	FrequentLocationsModel *const m_frequentLocationsModel;
+	BookmarkTree *const m_bookmarkTree;
+	SystemClock *const m_systemClock;
+
+	// The index is read on background threads, so it's protected by this mutex.
+	mutable std::shared_mutex m_mutex;
+	PathCompletionIndex m_index;
+
+	bool m_initialized = false;
+
+	// Maps each bookmark GUID to the bookmark's location, along with the number of bookmarks that
+	// refer to each location.
+	std::unordered_map<std::wstring, std::wstring> m_bookmarkLocations;
+	std::unordered_map<std::wstring, int> m_bookmarkLocationCounts;
+
+	std::unordered_map<std::wstring, std::chrono::steady_clock::time_point>
+		m_enumeratedDirectories;
+
+	std::vector<boost::signals2::scoped_connection> m_connections;
+};
@@ -0,0 +1,92 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "stdafx.h"
+#include "PathCompletionSource.h"
+#include "PathCompletionProvider.h"
+
+PathCompletionSource::PathCompletionSource(const PathCompletionProvider *pathCompletionProvider,
+	DirectoryExpandedCallback directoryExpandedCallback) :
+	m_pathCompletionProvider(pathCompletionProvider),
+	m_directoryExpandedCallback(directoryExpandedCallback)
+{
+}
+
+IFACEMETHODIMP PathCompletionSource::Next(ULONG numElements, LPOLESTR *elements,
+	ULONG *numElementsFetched)
+{
+	if (!elements || (numElements > 1 && !numElementsFetched))
+	{
+		return E_INVALIDARG;
+	}
+
+	std::scoped_lock lock(m_mutex);
+
+	ULONG numFetched = 0;
+
+	while (numFetched < numElements && m_position < m_completions.size())
+	{
+		HRESULT hr = SHStrDup(m_completions[m_position].c_str(), &elements[numFetched]);
+
+		if (FAILED(hr))
+		{
+			break;
+		}
+
+		numFetched++;
+		m_position++;
+	}
+
+	if (numElementsFetched)
+	{
+		*numElementsFetched = numFetched;
+	}
+
+	return (numFetched == numElements) ? S_OK : S_FALSE;
+}
+
+IFACEMETHODIMP PathCompletionSource::Skip(ULONG numElements)
+{
+	std::scoped_lock lock(m_mutex);
+
+	size_t numSkipped =
+		std::min(static_cast<size_t>(numElements), m_completions.size() - m_position);
+	m_position += numSkipped;
+
+	return (numSkipped == numElements) ? S_OK : S_FALSE;
+}
+
+// This is called each time the system is about to enumerate the completions. Querying the provider
+// here (rather than when the root changes) means that any folders enumerated since the last query
+// will be included.
+IFACEMETHODIMP PathCompletionSource::Reset()
+{
+	std::scoped_lock lock(m_mutex);
+
+	m_completions = m_pathCompletionProvider->GetCompletions(m_root, MAX_COMPLETIONS);
+	m_position = 0;
+
+	return S_OK;
+}
+
+IFACEMETHODIMP PathCompletionSource::Clone(IEnumString **enumString)
+{
+	UNREFERENCED_PARAMETER(enumString);
+
+	return E_NOTIMPL;
+}
+
+IFACEMETHODIMP PathCompletionSource::Expand(PCWSTR root)
+{
+	std::wstring updatedRoot = root ? root : L"";
+
+	{
+		std::scoped_lock lock(m_mutex);
+		m_root = updatedRoot;
+	}
+
+	m_directoryExpandedCallback(updatedRoot);
+
+	return S_OK;
+}
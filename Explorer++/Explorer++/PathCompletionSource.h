@@ -0,0 +1,51 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#pragma once
+
+#include "../Helper/WinRTBaseWrapper.h"
+#include <ShlObj.h>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+class PathCompletionProvider;
+
+// Supplies the strings shown by the system autocomplete object. The system will call into this
+// class on a background thread, so the completions are retrieved from PathCompletionProvider (which
+// is safe to query from any thread), rather than from any UI-thread state.
+class PathCompletionSource : public winrt::implements<PathCompletionSource, IEnumString, IACList>
+{
+public:
+	// Called (on an arbitrary thread) whenever the user enters a path separator. The directory
+	// that's passed in is the text entered up to, and including, the separator.
+	using DirectoryExpandedCallback = std::function<void(const std::wstring &directory)>;
+
+	PathCompletionSource(const PathCompletionProvider *pathCompletionProvider,
+		DirectoryExpandedCallback directoryExpandedCallback);
+
+	// IEnumString
+	IFACEMETHODIMP Next(ULONG numElements, LPOLESTR *elements, ULONG *numElementsFetched);
+	IFACEMETHODIMP Skip(ULONG numElements);
+	IFACEMETHODIMP Reset();
+	IFACEMETHODIMP Clone(IEnumString **enumString);
+
+	// IACList
+	IFACEMETHODIMP Expand(PCWSTR root);
+
+private:
+	// The system filters the completions based on the text that's been entered after the last
+	// separator, so this needs to be large enough to include a reasonable number of items from
+	// the current directory.
+	static constexpr size_t MAX_COMPLETIONS = 500;
+
+	const PathCompletionProvider *const m_pathCompletionProvider;
+	const DirectoryExpandedCallback m_directoryExpandedCallback;
+
+	std::mutex m_mutex;
+	std::wstring m_root;
+	std::vector<std::wstring> m_completions;
+	size_t m_position = 0;
+};
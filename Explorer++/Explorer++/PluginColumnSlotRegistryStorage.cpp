@@ -0,0 +1,99 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "stdafx.h"
+#include "PluginColumnSlotRegistryStorage.h"
+#include "Plugins/PluginColumnRegistry.h"
+#include "../Helper/RegistrySettings.h"
+#include <wil/registry.h>
+
+namespace
+{
+
+constexpr wchar_t PLUGIN_COLUMN_SLOTS_KEY_PATH[] = L"PluginColumnSlots";
+
+constexpr wchar_t SETTING_KEY[] = L"Key";
+constexpr wchar_t SETTING_SLOT[] = L"Slot";
+
+void LoadFromKey(HKEY pluginColumnSlotsKey, Plugins::PluginColumnRegistry *registry)
+{
+	Plugins::PluginColumnRegistry::SlotAssignments slotAssignments;
+	wil::unique_hkey childKey;
+	int index = 0;
+
+	while (SUCCEEDED(wil::reg::open_unique_key_nothrow(pluginColumnSlotsKey,
+		std::to_wstring(index).c_str(), childKey)))
+	{
+		std::wstring key;
+		auto keyRes = RegistrySettings::ReadString(childKey.get(), SETTING_KEY, key);
+
+		int slot;
+		auto slotRes = RegistrySettings::Read32BitValueFromRegistry(childKey.get(), SETTING_SLOT,
+			slot);
+
+		if (keyRes == ERROR_SUCCESS && slotRes == ERROR_SUCCESS)
+		{
+			slotAssignments[key] = slot;
+		}
+
+		index++;
+	}
+
+	registry->SetSlotAssignments(slotAssignments);
+}
+
+void SaveToKey(HKEY pluginColumnSlotsKey, const Plugins::PluginColumnRegistry *registry)
+{
+	int index = 0;
+
+	for (const auto &[key, slot] : registry->GetSlotAssignments())
+	{
+		wil::unique_hkey childKey;
+		HRESULT hr = wil::reg::create_unique_key_nothrow(pluginColumnSlotsKey,
+			std::to_wstring(index).c_str(), childKey, wil::reg::key_access::readwrite);
+
+		if (SUCCEEDED(hr))
+		{
+			RegistrySettings::SaveString(childKey.get(), SETTING_KEY, key);
+			RegistrySettings::SaveDword(childKey.get(), SETTING_SLOT, slot);
+
+			index++;
+		}
+	}
+}
+
+}
+
+namespace PluginColumnSlotRegistryStorage
+{
+
+void Load(HKEY applicationKey, Plugins::PluginColumnRegistry *registry)
+{
+	wil::unique_hkey pluginColumnSlotsKey;
+	HRESULT hr = wil::reg::open_unique_key_nothrow(applicationKey, PLUGIN_COLUMN_SLOTS_KEY_PATH,
+		pluginColumnSlotsKey, wil::reg::key_access::read);
+
+	if (FAILED(hr))
+	{
+		return;
+	}
+
+	LoadFromKey(pluginColumnSlotsKey.get(), registry);
+}
+
+void Save(HKEY applicationKey, const Plugins::PluginColumnRegistry *registry)
+{
+	wil::unique_hkey pluginColumnSlotsKey;
+	HRESULT hr = wil::reg::create_unique_key_nothrow(applicationKey, PLUGIN_COLUMN_SLOTS_KEY_PATH,
+		pluginColumnSlotsKey, wil::reg::key_access::readwrite);
+
+	if (FAILED(hr))
+	{
+		return;
+	}
+
+	SaveToKey(pluginColumnSlotsKey.get(), registry);
+}
+
+}
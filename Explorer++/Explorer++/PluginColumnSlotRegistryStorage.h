@@ -0,0 +1,20 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#pragma once
+
+namespace Plugins
+{
+
+class PluginColumnRegistry;
+
+}
+
+namespace PluginColumnSlotRegistryStorage
+{
+
+void Load(HKEY applicationKey, Plugins::PluginColumnRegistry *registry);
+void Save(HKEY applicationKey, const Plugins::PluginColumnRegistry *registry);
+
+}
@@ -0,0 +1,115 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "stdafx.h"
+#include "PluginColumnSlotXmlStorage.h"
+#include "Plugins/PluginColumnRegistry.h"
+#include "../Helper/XMLSettings.h"
+#include <wil/com.h>
+
+namespace
+{
+
+constexpr wchar_t PLUGIN_COLUMN_SLOTS_NODE_NAME[] = L"PluginColumnSlots";
+constexpr wchar_t PLUGIN_COLUMN_SLOT_NODE_NAME[] = L"PluginColumnSlot";
+
+constexpr wchar_t SETTING_KEY[] = L"Key";
+constexpr wchar_t SETTING_SLOT[] = L"Slot";
+
+void LoadFromNode(IXMLDOMNode *pluginColumnSlotsNode, Plugins::PluginColumnRegistry *registry)
+{
+	wil::com_ptr_nothrow<IXMLDOMNodeList> pluginColumnSlotNodes;
+	auto queryString = wil::make_bstr_nothrow(PLUGIN_COLUMN_SLOT_NODE_NAME);
+	HRESULT hr = pluginColumnSlotsNode->selectNodes(queryString.get(), &pluginColumnSlotNodes);
+
+	if (hr != S_OK)
+	{
+		return;
+	}
+
+	Plugins::PluginColumnRegistry::SlotAssignments slotAssignments;
+	wil::com_ptr_nothrow<IXMLDOMNode> childNode;
+
+	while (pluginColumnSlotNodes->nextNode(&childNode) == S_OK)
+	{
+		wil::com_ptr_nothrow<IXMLDOMNamedNodeMap> attributeMap;
+		hr = childNode->get_attributes(&attributeMap);
+
+		if (hr != S_OK)
+		{
+			continue;
+		}
+
+		std::wstring key;
+		HRESULT keyHr = XMLSettings::GetStringFromMap(attributeMap.get(), SETTING_KEY, key);
+
+		int slot;
+		HRESULT slotHr = XMLSettings::GetIntFromMap(attributeMap.get(), SETTING_SLOT, slot);
+
+		if (keyHr == S_OK && slotHr == S_OK)
+		{
+			slotAssignments[key] = slot;
+		}
+	}
+
+	registry->SetSlotAssignments(slotAssignments);
+}
+
+void SaveToNode(IXMLDOMDocument *xmlDocument, IXMLDOMElement *pluginColumnSlotsNode,
+	const Plugins::PluginColumnRegistry *registry)
+{
+	for (const auto &[key, slot] : registry->GetSlotAssignments())
+	{
+		wil::com_ptr_nothrow<IXMLDOMElement> pluginColumnSlotNode;
+		auto nodeName = wil::make_bstr_nothrow(PLUGIN_COLUMN_SLOT_NODE_NAME);
+		HRESULT hr = xmlDocument->createElement(nodeName.get(), &pluginColumnSlotNode);
+
+		if (hr == S_OK)
+		{
+			XMLSettings::AddAttributeToNode(xmlDocument, pluginColumnSlotNode.get(), SETTING_KEY,
+				key);
+			XMLSettings::AddAttributeToNode(xmlDocument, pluginColumnSlotNode.get(), SETTING_SLOT,
+				XMLSettings::EncodeIntValue(slot));
+			XMLSettings::AppendChildToParent(pluginColumnSlotNode.get(), pluginColumnSlotsNode);
+		}
+	}
+}
+
+}
+
+namespace PluginColumnSlotXmlStorage
+{
+
+void Load(IXMLDOMNode *rootNode, Plugins::PluginColumnRegistry *registry)
+{
+	wil::com_ptr_nothrow<IXMLDOMNode> pluginColumnSlotsNode;
+	auto queryString = wil::make_bstr_nothrow(PLUGIN_COLUMN_SLOTS_NODE_NAME);
+	HRESULT hr = rootNode->selectSingleNode(queryString.get(), &pluginColumnSlotsNode);
+
+	if (hr != S_OK)
+	{
+		return;
+	}
+
+	LoadFromNode(pluginColumnSlotsNode.get(), registry);
+}
+
+void Save(IXMLDOMDocument *xmlDocument, IXMLDOMNode *rootNode,
+	const Plugins::PluginColumnRegistry *registry)
+{
+	wil::com_ptr_nothrow<IXMLDOMElement> pluginColumnSlotsNode;
+	auto nodeName = wil::make_bstr_nothrow(PLUGIN_COLUMN_SLOTS_NODE_NAME);
+	HRESULT hr = xmlDocument->createElement(nodeName.get(), &pluginColumnSlotsNode);
+
+	if (hr != S_OK)
+	{
+		return;
+	}
+
+	SaveToNode(xmlDocument, pluginColumnSlotsNode.get(), registry);
+
+	XMLSettings::AppendChildToParent(pluginColumnSlotsNode.get(), rootNode);
+}
+
+}
@@ -0,0 +1,23 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#pragma once
+
+#include <msxml.h>
+
+namespace Plugins
+{
+
+class PluginColumnRegistry;
+
+}
+
+namespace PluginColumnSlotXmlStorage
+{
+
+void Load(IXMLDOMNode *rootNode, Plugins::PluginColumnRegistry *registry);
+void Save(IXMLDOMDocument *xmlDocument, IXMLDOMNode *rootNode,
+	const Plugins::PluginColumnRegistry *registry);
+
+}
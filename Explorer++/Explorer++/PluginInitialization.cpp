@@ -26,7 +26,7 @@ void Explorerplusplus::InitializePlugins()
 	processDirectoryPath.append(PLUGIN_FOLDER_NAME);
 
 	m_pluginManager = std::make_unique<Plugins::PluginManager>(this);
-	m_pluginManager->loadAllPlugins(processDirectoryPath);
-
-	UpdateMenuAcceleratorStrings(GetMenu(m_hContainer), m_app->GetAcceleratorManager());
+	m_pluginManager->loadAllPlugins(processDirectoryPath,
+		[this]
+		{ UpdateMenuAcceleratorStrings(GetMenu(m_hContainer), m_app->GetAcceleratorManager()); });
 }
@@ -4,6 +4,7 @@
 
 #include "stdafx.h"
 #include "Explorer++.h"
+#include "App.h"
 
 TabContainerImpl *Explorerplusplus::GetTabContainerImpl()
 {
@@ -29,3 +30,13 @@ Plugins::PluginCommandManager *Explorerplusplus::GetPluginCommandManager()
 {
 	return &m_pluginCommandManager;
 }
+
+Runtime *Explorerplusplus::GetRuntime()
+{
+	return m_app->GetRuntime();
+}
+
+Plugins::PluginColumnRegistry *Explorerplusplus::GetPluginColumnRegistry()
+{
+	return m_app->GetPluginColumnRegistry();
+}
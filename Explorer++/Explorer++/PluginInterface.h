@@ -6,6 +6,7 @@
 
 class AcceleratorUpdater;
 class CoreInterface;
+class Runtime;
 class TabContainerImpl;
 class TabEvents;
 class UiTheming;
@@ -14,6 +15,7 @@ namespace Plugins
 {
 
 class PluginCommandManager;
+class PluginColumnRegistry;
 class PluginMenuManager;
 
 }
@@ -30,4 +32,6 @@ public:
 	virtual UiTheming *GetUiTheming() = 0;
 	virtual AcceleratorUpdater *GetAccleratorUpdater() = 0;
 	virtual Plugins::PluginCommandManager *GetPluginCommandManager() = 0;
+	virtual Runtime *GetRuntime() = 0;
+	virtual Plugins::PluginColumnRegistry *GetPluginColumnRegistry() = 0;
 };
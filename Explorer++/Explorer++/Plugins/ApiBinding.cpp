@@ -4,7 +4,9 @@
 
 #include "stdafx.h"
 #include "Plugins/ApiBinding.h"
+#include "Plugins/ColumnsApi.h"
 #include "Plugins/CommandApi/Events/CommandInvoked.h"
+#include "Plugins/LuaPlugin.h"
 #include "Plugins/MenuApi.h"
 #include "Plugins/PluginMenuManager.h"
 #include "Plugins/TabsApi/Events/TabCreated.h"
@@ -19,60 +21,74 @@
 #include "UiTheming.h"
 #include <sol/sol.hpp>
 
-void BindTabsAPI(sol::state &state, CoreInterface *coreInterface, TabEvents *tabEvents,
+void BindTabsAPI(Plugins::LuaPlugin &plugin, CoreInterface *coreInterface, TabEvents *tabEvents,
 	TabContainerImpl *tabContainerImpl);
-void BindMenuApi(sol::state &state, Plugins::PluginMenuManager *pluginMenuManager);
-void BindUiApi(sol::state &state, UiTheming *uiTheming);
-void BindCommandApi(int pluginId, sol::state &state,
+void BindMenuApi(Plugins::LuaPlugin &plugin, Plugins::PluginMenuManager *pluginMenuManager);
+void BindUiApi(Plugins::LuaPlugin &plugin, UiTheming *uiTheming);
+void BindCommandApi(Plugins::LuaPlugin &plugin,
 	Plugins::PluginCommandManager *pluginCommandManager);
+void BindColumnsApi(Plugins::LuaPlugin &plugin,
+	Plugins::PluginColumnRegistry *pluginColumnRegistry);
+template <typename Object, typename Class, typename Return, typename... Args>
+auto InvokeOnUiThread(Plugins::LuaPlugin &plugin, Return (Class::*method)(Args...),
+	std::shared_ptr<Object> object);
 template <typename T>
-void BindObserverMethods(sol::state &state, sol::table &parentTable,
+void BindObserverMethods(Plugins::LuaPlugin &plugin, sol::table &parentTable,
 	const std::string &observerTableName, const std::shared_ptr<T> &object);
 template <typename T>
 void AddEnum(sol::state &state, sol::table &parentTable, const std::string &name);
 sol::table MarkTableReadOnly(sol::state &state, sol::table &table);
 int deny(lua_State *state);
 
-void Plugins::BindAllApiMethods(int pluginId, sol::state &state, PluginInterface *pluginInterface)
+void Plugins::BindAllApiMethods(LuaPlugin &plugin, PluginInterface *pluginInterface)
 {
-	BindTabsAPI(state, pluginInterface->GetCoreInterface(), pluginInterface->GetTabEvents(),
+	BindTabsAPI(plugin, pluginInterface->GetCoreInterface(), pluginInterface->GetTabEvents(),
 		pluginInterface->GetTabContainerImpl());
-	BindMenuApi(state, pluginInterface->GetPluginMenuManager());
-	BindUiApi(state, pluginInterface->GetUiTheming());
-	BindCommandApi(pluginId, state, pluginInterface->GetPluginCommandManager());
+	BindMenuApi(plugin, pluginInterface->GetPluginMenuManager());
+	BindUiApi(plugin, pluginInterface->GetUiTheming());
+	BindCommandApi(plugin, pluginInterface->GetPluginCommandManager());
+	BindColumnsApi(plugin, pluginInterface->GetPluginColumnRegistry());
 }
 
-void BindTabsAPI(sol::state &state, CoreInterface *coreInterface, TabEvents *tabEvents,
+void BindTabsAPI(Plugins::LuaPlugin &plugin, CoreInterface *coreInterface, TabEvents *tabEvents,
 	TabContainerImpl *tabContainerImpl)
 {
+	sol::state &state = plugin.GetLuaState();
+
 	std::shared_ptr<Plugins::TabsApi> tabsApi =
 		std::make_shared<Plugins::TabsApi>(coreInterface, tabContainerImpl);
 
 	sol::table tabsTable = state.create_named_table("tabs");
 	sol::table tabsMetaTable = MarkTableReadOnly(state, tabsTable);
 
-	tabsMetaTable.set_function("getAll", &Plugins::TabsApi::getAll, tabsApi);
-	tabsMetaTable.set_function("get", &Plugins::TabsApi::get, tabsApi);
-	tabsMetaTable.set_function("create", &Plugins::TabsApi::create, tabsApi);
-	tabsMetaTable.set_function("update", &Plugins::TabsApi::update, tabsApi);
-	tabsMetaTable.set_function("refresh", &Plugins::TabsApi::refresh, tabsApi);
-	tabsMetaTable.set_function("move", &Plugins::TabsApi::move, tabsApi);
-	tabsMetaTable.set_function("close", &Plugins::TabsApi::close, tabsApi);
+	tabsMetaTable.set_function("getAll",
+		InvokeOnUiThread(plugin, &Plugins::TabsApi::getAll, tabsApi));
+	tabsMetaTable.set_function("get", InvokeOnUiThread(plugin, &Plugins::TabsApi::get, tabsApi));
+	tabsMetaTable.set_function("create",
+		InvokeOnUiThread(plugin, &Plugins::TabsApi::create, tabsApi));
+	tabsMetaTable.set_function("update",
+		InvokeOnUiThread(plugin, &Plugins::TabsApi::update, tabsApi));
+	tabsMetaTable.set_function("refresh",
+		InvokeOnUiThread(plugin, &Plugins::TabsApi::refresh, tabsApi));
+	tabsMetaTable.set_function("move", InvokeOnUiThread(plugin, &Plugins::TabsApi::move, tabsApi));
+	tabsMetaTable.set_function("close",
+		InvokeOnUiThread(plugin, &Plugins::TabsApi::close, tabsApi));
 
 	std::shared_ptr<Plugins::TabCreated> tabCreated =
-		std::make_shared<Plugins::TabCreated>(tabEvents);
-	BindObserverMethods(state, tabsMetaTable, "onCreated", tabCreated);
+		std::make_shared<Plugins::TabCreated>(&plugin, tabEvents);
+	BindObserverMethods(plugin, tabsMetaTable, "onCreated", tabCreated);
 
-	std::shared_ptr<Plugins::TabMoved> tabMoved = std::make_shared<Plugins::TabMoved>(tabEvents);
-	BindObserverMethods(state, tabsMetaTable, "onMoved", tabMoved);
+	std::shared_ptr<Plugins::TabMoved> tabMoved =
+		std::make_shared<Plugins::TabMoved>(&plugin, tabEvents);
+	BindObserverMethods(plugin, tabsMetaTable, "onMoved", tabMoved);
 
 	std::shared_ptr<Plugins::TabUpdated> tabUpdated =
-		std::make_shared<Plugins::TabUpdated>(tabEvents);
-	BindObserverMethods(state, tabsMetaTable, "onUpdated", tabUpdated);
+		std::make_shared<Plugins::TabUpdated>(&plugin, tabEvents);
+	BindObserverMethods(plugin, tabsMetaTable, "onUpdated", tabUpdated);
 
 	std::shared_ptr<Plugins::TabRemoved> tabRemoved =
-		std::make_shared<Plugins::TabRemoved>(tabEvents);
-	BindObserverMethods(state, tabsMetaTable, "onRemoved", tabRemoved);
+		std::make_shared<Plugins::TabRemoved>(&plugin, tabEvents);
+	BindObserverMethods(plugin, tabsMetaTable, "onRemoved", tabRemoved);
 
 	// clang-format off
 	tabsMetaTable.new_usertype<Plugins::TabsApi::FolderSettings>("FolderSettings",
@@ -93,51 +109,94 @@ void BindTabsAPI(sol::state &state, CoreInterface *coreInterface, TabEvents *tab
 	AddEnum<SortMode>(state, tabsMetaTable, "SortMode");
 }
 
-void BindMenuApi(sol::state &state, Plugins::PluginMenuManager *pluginMenuManager)
+void BindMenuApi(Plugins::LuaPlugin &plugin, Plugins::PluginMenuManager *pluginMenuManager)
 {
+	sol::state &state = plugin.GetLuaState();
+
 	std::shared_ptr<Plugins::MenuApi> menuApi =
-		std::make_shared<Plugins::MenuApi>(pluginMenuManager);
+		std::make_shared<Plugins::MenuApi>(&plugin, pluginMenuManager);
 
 	sol::table menuTable = state.create_named_table("menu");
 	sol::table metaTable = MarkTableReadOnly(state, menuTable);
 
-	metaTable.set_function("create", &Plugins::MenuApi::create, menuApi);
-	metaTable.set_function("remove", &Plugins::MenuApi::remove, menuApi);
+	metaTable.set_function("create", InvokeOnUiThread(plugin, &Plugins::MenuApi::create, menuApi));
+	metaTable.set_function("remove", InvokeOnUiThread(plugin, &Plugins::MenuApi::remove, menuApi));
 }
 
-void BindUiApi(sol::state &state, UiTheming *uiTheming)
+void BindUiApi(Plugins::LuaPlugin &plugin, UiTheming *uiTheming)
 {
+	sol::state &state = plugin.GetLuaState();
+
 	std::shared_ptr<Plugins::UiApi> uiApi = std::make_shared<Plugins::UiApi>(uiTheming);
 
 	sol::table uiTable = state.create_named_table("ui");
 	sol::table metaTable = MarkTableReadOnly(state, uiTable);
 
-	metaTable.set_function("setListViewColors", &Plugins::UiApi::setListViewColors, uiApi);
-	metaTable.set_function("setTreeViewColors", &Plugins::UiApi::setTreeViewColors, uiApi);
+	metaTable.set_function("setListViewColors",
+		InvokeOnUiThread(plugin, &Plugins::UiApi::setListViewColors, uiApi));
+	metaTable.set_function("setTreeViewColors",
+		InvokeOnUiThread(plugin, &Plugins::UiApi::setTreeViewColors, uiApi));
 }
 
-void BindCommandApi(int pluginId, sol::state &state,
+void BindCommandApi(Plugins::LuaPlugin &plugin,
 	Plugins::PluginCommandManager *pluginCommandManager)
 {
+	sol::state &state = plugin.GetLuaState();
+
 	sol::table commandsTable = state.create_named_table("commands");
 	sol::table commandsMetaTable = MarkTableReadOnly(state, commandsTable);
 
 	std::shared_ptr<Plugins::CommandInvoked> commandInvoked =
-		std::make_shared<Plugins::CommandInvoked>(pluginCommandManager, pluginId);
-	BindObserverMethods(state, commandsMetaTable, "onCommand", commandInvoked);
+		std::make_shared<Plugins::CommandInvoked>(&plugin, pluginCommandManager);
+	BindObserverMethods(plugin, commandsMetaTable, "onCommand", commandInvoked);
+}
+
+void BindColumnsApi(Plugins::LuaPlugin &plugin,
+	Plugins::PluginColumnRegistry *pluginColumnRegistry)
+{
+	sol::state &state = plugin.GetLuaState();
+
+	std::shared_ptr<Plugins::ColumnsApi> columnsApi =
+		std::make_shared<Plugins::ColumnsApi>(&plugin, pluginColumnRegistry);
+
+	sol::table columnsTable = state.create_named_table("columns");
+	sol::table metaTable = MarkTableReadOnly(state, columnsTable);
+
+	metaTable.set_function("register",
+		InvokeOnUiThread(plugin, &Plugins::ColumnsApi::registerColumn, columnsApi));
+	metaTable.set_function("unregister",
+		InvokeOnUiThread(plugin, &Plugins::ColumnsApi::unregisterColumn, columnsApi));
+}
+
+// The API objects interact with the UI, so each API method is invoked on the UI thread, rather than
+// the plugin thread. Any Lua objects passed to the method are accessed while the plugin thread is
+// blocked, so that's safe. Values returned by the method are converted to Lua values once control
+// has returned to the plugin thread.
+template <typename Object, typename Class, typename Return, typename... Args>
+auto InvokeOnUiThread(Plugins::LuaPlugin &plugin, Return (Class::*method)(Args...),
+	std::shared_ptr<Object> object)
+{
+	return [uiThreadInvoker = plugin.GetUiThreadInvoker(), method, object = std::move(object)](
+			   Args... args) -> Return
+	{
+		return uiThreadInvoker->Invoke([&]() -> Return
+			{ return ((*object).*method)(std::forward<Args>(args)...); });
+	};
 }
 
 template <typename T>
-void BindObserverMethods(sol::state &state, sol::table &parentTable,
+void BindObserverMethods(Plugins::LuaPlugin &plugin, sol::table &parentTable,
 	const std::string &observerTableName, const std::shared_ptr<T> &object)
 {
 	static_assert(std::is_base_of<Plugins::Event, T>::value, "T must inherit from Plugins::Event");
 
 	sol::table observerTable = parentTable.create_named(observerTableName);
-	sol::table observerMetaTable = MarkTableReadOnly(state, observerTable);
+	sol::table observerMetaTable = MarkTableReadOnly(plugin.GetLuaState(), observerTable);
 
-	observerMetaTable.set_function("addListener", &T::addObserver, object);
-	observerMetaTable.set_function("removeListener", &T::removeObserver, object);
+	observerMetaTable.set_function("addListener",
+		InvokeOnUiThread(plugin, &T::addObserver, object));
+	observerMetaTable.set_function("removeListener",
+		InvokeOnUiThread(plugin, &T::removeObserver, object));
 }
 
 // This is used instead of the new_enum function provided by Sol, as
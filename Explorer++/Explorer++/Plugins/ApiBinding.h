@@ -9,5 +9,7 @@
 
 namespace Plugins
 {
-void BindAllApiMethods(int pluginId, sol::state &state, PluginInterface *pluginInterface);
+class LuaPlugin;
+
+void BindAllApiMethods(LuaPlugin &plugin, PluginInterface *pluginInterface);
 }
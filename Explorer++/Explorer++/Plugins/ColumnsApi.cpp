@@ -0,0 +1,124 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "stdafx.h"
+#include "Plugins/ColumnsApi.h"
+#include "Plugins/LuaPlugin.h"
+#include "Plugins/PluginColumnRegistry.h"
+#include "../Helper/StringHelper.h"
+#include <sol/sol.hpp>
+#include <filesystem>
+
+namespace Plugins
+{
+
+namespace ColumnConstants
+{
+
+constexpr char ID[] = "id";
+constexpr char NAME[] = "name";
+constexpr char DESCRIPTION[] = "description";
+constexpr char SORT_AS[] = "sortAs";
+constexpr char CALLBACK_FUNCTION[] = "callback";
+
+constexpr wchar_t SORT_AS_TEXT[] = L"text";
+constexpr wchar_t SORT_AS_NUMBER[] = L"number";
+
+}
+
+ColumnsApi::ColumnsApi(LuaPlugin *plugin, PluginColumnRegistry *pluginColumnRegistry) :
+	m_plugin(plugin),
+	m_pluginColumnRegistry(pluginColumnRegistry)
+{
+}
+
+ColumnsApi::~ColumnsApi()
+{
+	for (const auto &key : m_registeredColumnKeys)
+	{
+		m_pluginColumnRegistry->UnregisterColumn(key);
+	}
+}
+
+bool ColumnsApi::registerColumn(sol::table properties)
+{
+	sol::optional<std::wstring> id = properties[ColumnConstants::ID];
+	sol::optional<std::wstring> name = properties[ColumnConstants::NAME];
+	sol::optional<sol::protected_function> callback =
+		properties[ColumnConstants::CALLBACK_FUNCTION];
+
+	if (!id || id->empty() || !name || name->empty() || !callback)
+	{
+		return false;
+	}
+
+	auto key = buildColumnKey(*id);
+
+	if (m_registeredColumnKeys.contains(key))
+	{
+		return false;
+	}
+
+	auto sortType = PluginColumnSortType::Text;
+	sol::optional<std::wstring> sortAs = properties[ColumnConstants::SORT_AS];
+
+	if (sortAs && *sortAs == ColumnConstants::SORT_AS_NUMBER)
+	{
+		sortType = PluginColumnSortType::Number;
+	}
+	else if (sortAs && *sortAs != ColumnConstants::SORT_AS_TEXT)
+	{
+		return false;
+	}
+
+	auto bytecode = PluginColumnEvaluator::DumpFunction(*callback);
+
+	if (!bytecode)
+	{
+		LOG(WARNING) << "Column \"" << wstrToUtf8Str(*id)
+					 << "\" can't be registered, as its callback refers to local variables";
+		return false;
+	}
+
+	PluginColumnDefinition definition;
+	definition.key = key;
+	definition.name = *name;
+	definition.description = properties.get_or<std::wstring>(ColumnConstants::DESCRIPTION, L"");
+	definition.evaluator = std::make_shared<PluginColumnEvaluator>(std::move(*bytecode),
+		m_plugin->GetManifest().libraries, sortType,
+		LuaPlugin::GetHandlerLimits(m_plugin->GetManifest()));
+
+	if (!m_pluginColumnRegistry->RegisterColumn(definition))
+	{
+		return false;
+	}
+
+	m_registeredColumnKeys.insert(key);
+
+	return true;
+}
+
+void ColumnsApi::unregisterColumn(const std::wstring &id)
+{
+	auto key = buildColumnKey(id);
+	auto itr = m_registeredColumnKeys.find(key);
+
+	if (itr == m_registeredColumnKeys.end())
+	{
+		return;
+	}
+
+	m_pluginColumnRegistry->UnregisterColumn(key);
+	m_registeredColumnKeys.erase(itr);
+}
+
+// The key needs to remain the same each time the plugin is loaded, so it's based on the name of
+// the plugin's directory, rather than the plugin ID.
+std::wstring ColumnsApi::buildColumnKey(const std::wstring &id) const
+{
+	auto directoryName = std::filesystem::path(m_plugin->GetDirectory()).filename().wstring();
+	return directoryName + L"/" + id;
+}
+
+}
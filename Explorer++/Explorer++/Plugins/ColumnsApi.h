@@ -0,0 +1,35 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#pragma once
+
+#include <sol/forward.hpp>
+#include <string>
+#include <unordered_set>
+
+namespace Plugins
+{
+
+class LuaPlugin;
+class PluginColumnRegistry;
+
+class ColumnsApi
+{
+public:
+	ColumnsApi(LuaPlugin *plugin, PluginColumnRegistry *pluginColumnRegistry);
+	~ColumnsApi();
+
+	bool registerColumn(sol::table properties);
+	void unregisterColumn(const std::wstring &id);
+
+private:
+	std::wstring buildColumnKey(const std::wstring &id) const;
+
+	LuaPlugin *m_plugin;
+	PluginColumnRegistry *m_pluginColumnRegistry;
+
+	std::unordered_set<std::wstring> m_registeredColumnKeys;
+};
+
+}
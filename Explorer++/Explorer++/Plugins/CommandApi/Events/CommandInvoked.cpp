@@ -6,29 +6,28 @@
 #include "Plugins/CommandApi/Events/CommandInvoked.h"
 #include <sol/sol.hpp>
 
-Plugins::CommandInvoked::CommandInvoked(PluginCommandManager *pluginCommandManager, int pluginId) :
-	m_pluginCommandManager(pluginCommandManager),
-	m_pluginId(pluginId)
+Plugins::CommandInvoked::CommandInvoked(LuaPlugin *plugin,
+	PluginCommandManager *pluginCommandManager) :
+	Event(plugin),
+	m_pluginCommandManager(pluginCommandManager)
 {
 }
 
 boost::signals2::connection Plugins::CommandInvoked::connectObserver(
-	sol::protected_function observer, sol::this_state state)
+	const LuaPlugin::Callback &observer)
 {
-	UNREFERENCED_PARAMETER(state);
-
 	return m_pluginCommandManager->AddCommandInvokedObserver(
 		[this, observer](int pluginId, const std::wstring &name)
 		{ onCommandInvoked(pluginId, name, observer); });
 }
 
 void Plugins::CommandInvoked::onCommandInvoked(int pluginId, const std::wstring &name,
-	sol::protected_function observer)
+	const LuaPlugin::Callback &observer)
 {
-	if (pluginId != m_pluginId)
+	if (pluginId != getPlugin()->GetId())
 	{
 		return;
 	}
 
-	observer(name);
+	invokeObserver(observer, name);
 }
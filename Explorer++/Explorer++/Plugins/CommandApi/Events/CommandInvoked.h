@@ -12,16 +12,15 @@ namespace Plugins
 class CommandInvoked : public Event
 {
 public:
-	CommandInvoked(PluginCommandManager *pluginCommandManager, int pluginId);
+	CommandInvoked(LuaPlugin *plugin, PluginCommandManager *pluginCommandManager);
 
 protected:
-	boost::signals2::connection connectObserver(sol::protected_function observer,
-		sol::this_state state) override;
+	boost::signals2::connection connectObserver(const LuaPlugin::Callback &observer) override;
 
 private:
-	void onCommandInvoked(int pluginId, const std::wstring &name, sol::protected_function observer);
+	void onCommandInvoked(int pluginId, const std::wstring &name,
+		const LuaPlugin::Callback &observer);
 
 	PluginCommandManager *m_pluginCommandManager;
-	int m_pluginId;
 };
 }
@@ -6,7 +6,7 @@
 #include "Plugins/Event.h"
 #include <sol/sol.hpp>
 
-Plugins::Event::Event() : m_connectionIdCounter(1)
+Plugins::Event::Event(LuaPlugin *plugin) : m_plugin(plugin), m_connectionIdCounter(1)
 {
 }
 
@@ -18,14 +18,14 @@ Plugins::Event::~Event()
 	}
 }
 
-int Plugins::Event::addObserver(sol::protected_function observer, sol::this_state state)
+int Plugins::Event::addObserver(sol::protected_function observer)
 {
 	if (!observer)
 	{
 		return -1;
 	}
 
-	auto connection = connectObserver(observer, state);
+	auto connection = connectObserver(m_plugin->WrapCallback(std::move(observer)));
 
 	int id = m_connectionIdCounter++;
 	m_connections.insert(std::make_pair(id, connection));
@@ -46,3 +46,8 @@ void Plugins::Event::removeObserver(int id)
 
 	m_connections.erase(itr);
 }
+
+Plugins::LuaPlugin *Plugins::Event::getPlugin() const
+{
+	return m_plugin;
+}
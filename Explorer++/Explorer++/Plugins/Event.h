@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include "Plugins/LuaPlugin.h"
 #include <boost/signals2.hpp>
 #include <sol/forward.hpp>
 #include <unordered_map>
@@ -13,17 +14,27 @@ namespace Plugins
 class Event
 {
 public:
-	Event();
+	Event(LuaPlugin *plugin);
 	virtual ~Event();
 
-	int addObserver(sol::protected_function observer, sol::this_state state);
+	int addObserver(sol::protected_function observer);
 	void removeObserver(int id);
 
 protected:
-	virtual boost::signals2::connection connectObserver(sol::protected_function observer,
-		sol::this_state state) = 0;
+	virtual boost::signals2::connection connectObserver(const LuaPlugin::Callback &observer) = 0;
+
+	LuaPlugin *getPlugin() const;
+
+	// Observers are invoked asynchronously, on the plugin thread, so
+	// the arguments passed here should be plain values.
+	template <typename... Args>
+	void invokeObserver(const LuaPlugin::Callback &observer, Args... args)
+	{
+		m_plugin->InvokeCallback(observer, std::move(args)...);
+	}
 
 private:
+	LuaPlugin *const m_plugin;
 	int m_connectionIdCounter;
 	std::unordered_map<int, boost::signals2::connection> m_connections;
 };
@@ -0,0 +1,147 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "stdafx.h"
+#include "Plugins/LuaExecutionBudget.h"
+#include <sol/sol.hpp>
+
+namespace
+{
+
+// The address of this variable is used as a unique key in the Lua registry.
+const char budgetRegistryKey = 0;
+
+const char *GetOutcomeMessage(Plugins::LuaExecutionBudget::Outcome outcome)
+{
+	switch (outcome)
+	{
+	case Plugins::LuaExecutionBudget::Outcome::InstructionLimitExceeded:
+		return "The instruction limit for this call has been exceeded.";
+
+	case Plugins::LuaExecutionBudget::Outcome::TimeoutExceeded:
+		return "The time limit for this call has been exceeded.";
+
+	case Plugins::LuaExecutionBudget::Outcome::Aborted:
+		return "The plugin is being unloaded.";
+
+	default:
+		DCHECK(false);
+		return "";
+	}
+}
+
+}
+
+namespace Plugins
+{
+
+LuaExecutionBudget::LuaExecutionBudget(lua_State *state) : m_state(state)
+{
+	lua_pushlightuserdata(m_state, this);
+	lua_rawsetp(m_state, LUA_REGISTRYINDEX, &budgetRegistryKey);
+
+	lua_sethook(m_state, OnHook, LUA_MASKCOUNT, HOOK_INSTRUCTION_INTERVAL);
+}
+
+LuaExecutionBudget::~LuaExecutionBudget()
+{
+	lua_sethook(m_state, nullptr, 0, 0);
+
+	lua_pushnil(m_state);
+	lua_rawsetp(m_state, LUA_REGISTRYINDEX, &budgetRegistryKey);
+}
+
+LuaExecutionBudget::Outcome LuaExecutionBudget::Run(const Limits &limits,
+	const std::function<bool()> &function)
+{
+	CHECK(!m_running);
+
+	m_running = true;
+	m_instructionsRemaining = limits.maxInstructions;
+	m_instructionsExecuted = 0;
+	m_deadline = std::chrono::steady_clock::now() + limits.timeout;
+	m_exceededOutcome.reset();
+
+	bool succeeded = function();
+
+	m_running = false;
+
+	if (m_exceededOutcome)
+	{
+		return *m_exceededOutcome;
+	}
+
+	return succeeded ? Outcome::Completed : Outcome::Failed;
+}
+
+void LuaExecutionBudget::RequestAbort()
+{
+	m_abortRequested = true;
+}
+
+uint64_t LuaExecutionBudget::GetLastInstructionCount() const
+{
+	return m_instructionsExecuted;
+}
+
+void LuaExecutionBudget::OnHook(lua_State *state, lua_Debug *debug)
+{
+	UNREFERENCED_PARAMETER(debug);
+
+	lua_rawgetp(state, LUA_REGISTRYINDEX, &budgetRegistryKey);
+	auto *budget = static_cast<LuaExecutionBudget *>(lua_touserdata(state, -1));
+	lua_pop(state, 1);
+
+	if (!budget)
+	{
+		return;
+	}
+
+	auto outcome = budget->CheckLimits();
+
+	if (!outcome)
+	{
+		return;
+	}
+
+	luaL_error(state, "%s", GetOutcomeMessage(*outcome));
+}
+
+std::optional<LuaExecutionBudget::Outcome> LuaExecutionBudget::CheckLimits()
+{
+	if (!m_running)
+	{
+		return std::nullopt;
+	}
+
+	m_instructionsExecuted += HOOK_INSTRUCTION_INTERVAL;
+
+	// Once a limit has been exceeded, the same error will be raised each time the hook runs, which
+	// prevents the Lua code from simply catching the error and continuing.
+	if (m_exceededOutcome)
+	{
+		return m_exceededOutcome;
+	}
+
+	if (m_abortRequested)
+	{
+		m_exceededOutcome = Outcome::Aborted;
+	}
+	else if (m_instructionsRemaining <= HOOK_INSTRUCTION_INTERVAL)
+	{
+		m_exceededOutcome = Outcome::InstructionLimitExceeded;
+	}
+	else if (std::chrono::steady_clock::now() >= m_deadline)
+	{
+		m_exceededOutcome = Outcome::TimeoutExceeded;
+	}
+	else
+	{
+		m_instructionsRemaining -= HOOK_INSTRUCTION_INTERVAL;
+	}
+
+	return m_exceededOutcome;
+}
+
+}
@@ -0,0 +1,80 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#pragma once
+
+#include <boost/core/noncopyable.hpp>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <optional>
+
+struct lua_Debug;
+struct lua_State;
+
+namespace Plugins
+{
+
+// Limits the amount of work that Lua code can perform within a single call into a Lua state, so
+// that a plugin that loops forever (or is simply very slow) can't tie up the thread it runs on.
+//
+// The limits are enforced through a count hook, which is invoked after every
+// HOOK_INSTRUCTION_INTERVAL instructions. Once a limit has been exceeded, the hook raises a Lua
+// error, which unwinds the call. The error will continue to be raised if the Lua code attempts to
+// catch it.
+class LuaExecutionBudget : private boost::noncopyable
+{
+public:
+	static constexpr int HOOK_INSTRUCTION_INTERVAL = 1000;
+
+	struct Limits
+	{
+		uint64_t maxInstructions;
+		std::chrono::milliseconds timeout;
+	};
+
+	enum class Outcome
+	{
+		Completed,
+
+		// The Lua code raised an error unrelated to the budget.
+		Failed,
+
+		InstructionLimitExceeded,
+		TimeoutExceeded,
+		Aborted
+	};
+
+	LuaExecutionBudget(lua_State *state);
+	~LuaExecutionBudget();
+
+	// Invokes the provided function, with the specified limits applied to any Lua code that's run
+	// on the state while the function is executing. The function should return true if the Lua
+	// code it invoked ran successfully. Calls can't be nested.
+	Outcome Run(const Limits &limits, const std::function<bool()> &function);
+
+	// Causes the current call (and any subsequent calls) to be stopped as soon as possible. Unlike
+	// the other methods here, this can be called from any thread.
+	void RequestAbort();
+
+	// Returns the number of instructions run during the most recent call. This is accurate to
+	// within HOOK_INSTRUCTION_INTERVAL instructions.
+	uint64_t GetLastInstructionCount() const;
+
+private:
+	static void OnHook(lua_State *state, lua_Debug *debug);
+
+	std::optional<Outcome> CheckLimits();
+
+	lua_State *const m_state;
+	bool m_running = false;
+	uint64_t m_instructionsRemaining = 0;
+	uint64_t m_instructionsExecuted = 0;
+	std::chrono::steady_clock::time_point m_deadline;
+	std::optional<Outcome> m_exceededOutcome;
+	std::atomic_bool m_abortRequested = false;
+};
+
+}
@@ -4,21 +4,66 @@
 
 #include "stdafx.h"
 #include "Plugins/LuaPlugin.h"
+#include "ComStaThreadPoolExecutor.h"
 #include "Plugins/ApiBinding.h"
+#include "Runtime.h"
+#include "RuntimeHelper.h"
+#include "../Helper/StringHelper.h"
 #include <sol/sol.hpp>
+#include <filesystem>
 
 int Plugins::LuaPlugin::idCounter = 1;
 
 inline int onPanic(lua_State *L);
 
 Plugins::LuaPlugin::LuaPlugin(const std::wstring &directory, const Manifest &manifest,
-	PluginInterface *pluginInterface) :
+	PluginInterface *pluginInterface, ThreadingModel threadingModel) :
 	m_directory(directory),
 	m_manifest(manifest),
 	m_lua(onPanic),
-	m_id(idCounter++)
+	m_id(idCounter++),
+	m_runtime(pluginInterface->GetRuntime()),
+	m_uiThreadInvoker(m_runtime),
+	m_budget(m_lua.lua_state()),
+	m_handlerLimits(GetHandlerLimits(manifest))
 {
-	BindAllApiMethods(m_id, m_lua, pluginInterface);
+	if (threadingModel == ThreadingModel::BackgroundThread)
+	{
+		m_executor = std::make_shared<ComStaThreadPoolExecutor>(1);
+	}
+
+	BindAllApiMethods(*this, pluginInterface);
+}
+
+Plugins::LuaPlugin::~LuaPlugin()
+{
+	// The plugin thread may be waiting on the UI thread, or running a long script. Both of those
+	// are stopped here, so that the thread can be shut down without the UI thread having to wait
+	// on the plugin.
+	m_uiThreadInvoker.Shutdown();
+	m_budget.RequestAbort();
+
+	if (m_executor)
+	{
+		m_executor->shutdown();
+	}
+}
+
+Plugins::LuaExecutionBudget::Limits Plugins::LuaPlugin::GetHandlerLimits(const Manifest &manifest)
+{
+	auto limits = DEFAULT_HANDLER_LIMITS;
+
+	if (manifest.executionLimits.maxInstructions)
+	{
+		limits.maxInstructions = *manifest.executionLimits.maxInstructions;
+	}
+
+	if (manifest.executionLimits.timeout)
+	{
+		limits.timeout = *manifest.executionLimits.timeout;
+	}
+
+	return limits;
 }
 
 int Plugins::LuaPlugin::GetId() const
@@ -41,6 +86,171 @@ sol::state &Plugins::LuaPlugin::GetLuaState()
 	return m_lua;
 }
 
+Plugins::UiThreadInvoker *Plugins::LuaPlugin::GetUiThreadInvoker()
+{
+	return &m_uiThreadInvoker;
+}
+
+Plugins::LuaPlugin::Stats Plugins::LuaPlugin::GetStats() const
+{
+	std::scoped_lock lock(m_statsMutex);
+	return m_stats;
+}
+
+void Plugins::LuaPlugin::Load(const std::filesystem::path &scriptPath,
+	std::function<void(LoadResult result)> callback)
+{
+	RunOnPluginThread(
+		[this, scriptPath, callback = std::move(callback)]
+		{
+			auto start = std::chrono::steady_clock::now();
+			auto result = LoadResult::Loaded;
+
+			try
+			{
+				auto outcome = m_budget.Run(LOAD_LIMITS,
+					[this, &scriptPath]
+					{
+						return m_lua.safe_script_file(scriptPath.string(), sol::script_pass_on_error)
+							.valid();
+					});
+
+				// An error can be raised for something simple like a Lua script trying to use a
+				// variable that doesn't exist. The assumption here is that since the panic handler
+				// wasn't called, the Lua state is still usable.
+				if (outcome != LuaExecutionBudget::Outcome::Completed)
+				{
+					result = LoadResult::LoadedWithErrors;
+				}
+			}
+			catch (const LuaPanicException &)
+			{
+				// If a panic has occurred, the Lua state is irretrievably broken. It's not safe to
+				// attempt to continue to use it.
+				m_panicked = true;
+				result = LoadResult::Failed;
+			}
+
+			{
+				std::scoped_lock lock(m_statsMutex);
+				m_stats.loadTime = std::chrono::duration_cast<std::chrono::microseconds>(
+					std::chrono::steady_clock::now() - start);
+			}
+
+			RunOnUiThread([callback, result] { callback(result); });
+		});
+}
+
+Plugins::LuaPlugin::Callback Plugins::LuaPlugin::WrapCallback(sol::protected_function callback)
+{
+	auto *ownedCallback = new sol::protected_function(std::move(callback));
+
+	if (!m_executor)
+	{
+		return Callback(ownedCallback);
+	}
+
+	// The final reference to the callback may be released on the UI thread (e.g. when a signal
+	// connection is removed). Releasing the function modifies the Lua state, so that's deferred to
+	// the plugin thread.
+	return Callback(ownedCallback,
+		[weakExecutor = std::weak_ptr<concurrencpp::executor>(m_executor)](
+			sol::protected_function *function)
+		{
+			if (auto executor = weakExecutor.lock())
+			{
+				try
+				{
+					executor->post([function] { delete function; });
+					return;
+				}
+				catch (const concurrencpp::errors::runtime_shutdown &)
+				{
+				}
+			}
+
+			// The plugin is being unloaded, so the Lua state is about to be destroyed anyway.
+			function->abandon();
+			delete function;
+		});
+}
+
+void Plugins::LuaPlugin::RunHandler(std::function<bool()> handler)
+{
+	RunOnPluginThread(
+		[this, handler = std::move(handler)]
+		{
+			if (m_panicked)
+			{
+				return;
+			}
+
+			auto start = std::chrono::steady_clock::now();
+			auto outcome = LuaExecutionBudget::Outcome::Failed;
+
+			try
+			{
+				outcome = m_budget.Run(m_handlerLimits, handler);
+			}
+			catch (const LuaPanicException &)
+			{
+				m_panicked = true;
+			}
+
+			auto duration = std::chrono::duration_cast<std::chrono::microseconds>(
+				std::chrono::steady_clock::now() - start);
+
+			if (outcome == LuaExecutionBudget::Outcome::InstructionLimitExceeded
+				|| outcome == LuaExecutionBudget::Outcome::TimeoutExceeded)
+			{
+				LOG(WARNING) << "Plugin \"" << wstrToUtf8Str(m_manifest.name)
+							 << "\" exceeded its execution limits in a handler";
+			}
+
+			std::scoped_lock lock(m_statsMutex);
+			m_stats.handlerTime += duration;
+			m_stats.numHandlerCalls++;
+
+			if (outcome == LuaExecutionBudget::Outcome::Failed)
+			{
+				m_stats.numHandlerErrors++;
+			}
+			else if (outcome != LuaExecutionBudget::Outcome::Completed)
+			{
+				m_stats.numLimitsExceeded++;
+			}
+		});
+}
+
+void Plugins::LuaPlugin::RunOnPluginThread(std::function<void()> task)
+{
+	if (!m_executor)
+	{
+		task();
+		return;
+	}
+
+	try
+	{
+		m_executor->post(std::move(task));
+	}
+	catch (const concurrencpp::errors::runtime_shutdown &)
+	{
+		// The plugin is being unloaded, so there's nothing that needs to be done with the task.
+	}
+}
+
+void Plugins::LuaPlugin::RunOnUiThread(std::function<void()> task)
+{
+	if (!m_executor)
+	{
+		task();
+		return;
+	}
+
+	MakeUiThreadScheduler(m_runtime)(std::move(task));
+}
+
 inline int onPanic(lua_State *L)
 {
 	UNREFERENCED_PARAMETER(L);
@@ -5,32 +5,142 @@
 #pragma once
 
 #include "PluginInterface.h"
+#include "Plugins/LuaExecutionBudget.h"
 #include "Plugins/Manifest.h"
+#include "Plugins/UiThreadInvoker.h"
 #include <sol/forward.hpp>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+
+class Runtime;
+
+namespace concurrencpp
+{
+class executor;
+}
+
+namespace std
+{
+namespace filesystem
+{
+class path;
+}
+}
 
 namespace Plugins
 {
 // Wraps a Lua state object and binds in all plugin API methods
 // during construction.
+//
+// When using the BackgroundThread threading model, all Lua code for
+// the plugin runs on a dedicated thread. API methods are invoked on
+// the UI thread (via the UiThreadInvoker) and callbacks registered by
+// the plugin are invoked asynchronously, on the plugin thread. Each
+// call into the plugin is subject to an execution budget.
 class LuaPlugin
 {
 public:
+	// A Lua function registered by the plugin. Copying this doesn't
+	// touch the Lua state, so it can be freely copied on the UI
+	// thread. The function itself will be released on the plugin
+	// thread.
+	using Callback = std::shared_ptr<sol::protected_function>;
+
+	enum class ThreadingModel
+	{
+		UiThread,
+		BackgroundThread
+	};
+
+	enum class LoadResult
+	{
+		Loaded,
+
+		// The script raised an error or exceeded its budget. The
+		// plugin remains loaded, since it may have set up some of its
+		// functionality before the error occurred.
+		LoadedWithErrors,
+
+		// The Lua state panicked and is no longer usable.
+		Failed
+	};
+
+	struct Stats
+	{
+		std::chrono::microseconds loadTime = {};
+		std::chrono::microseconds handlerTime = {};
+		int numHandlerCalls = 0;
+		int numHandlerErrors = 0;
+		int numLimitsExceeded = 0;
+	};
+
+	static constexpr LuaExecutionBudget::Limits LOAD_LIMITS = { 100'000'000,
+		std::chrono::seconds(5) };
+	static constexpr LuaExecutionBudget::Limits DEFAULT_HANDLER_LIMITS = { 10'000'000,
+		std::chrono::seconds(1) };
+
 	LuaPlugin(const std::wstring &directory, const Manifest &manifest,
-		PluginInterface *pluginInterface);
+		PluginInterface *pluginInterface,
+		ThreadingModel threadingModel = ThreadingModel::UiThread);
+	~LuaPlugin();
 
 	int GetId() const;
 	std::wstring GetDirectory() const;
 	Plugins::Manifest GetManifest() const;
 	sol::state &GetLuaState();
+	UiThreadInvoker *GetUiThreadInvoker();
+	Stats GetStats() const;
+
+	// Runs the specified script on the plugin thread. The callback
+	// will be invoked on the UI thread once the script has finished.
+	void Load(const std::filesystem::path &scriptPath,
+		std::function<void(LoadResult result)> callback);
+
+	Callback WrapCallback(sol::protected_function callback);
+
+	// Asynchronously invokes the callback on the plugin thread. The
+	// arguments are copied, so they should be plain C++ values, rather
+	// than Lua objects.
+	template <typename CallbackType, typename... Args>
+	void InvokeCallback(CallbackType callback, Args... args)
+	{
+		RunHandler([callback = std::move(callback), ... args = std::move(args)]()
+			{ return (*callback)(args...).valid(); });
+	}
+
+	// Runs the handler on the plugin thread, subject to the handler
+	// limits. The handler should return true if it ran successfully.
+	void RunHandler(std::function<bool()> handler);
+
+	static LuaExecutionBudget::Limits GetHandlerLimits(const Manifest &manifest);
 
 private:
 	static int idCounter;
 
+	void RunOnPluginThread(std::function<void()> task);
+	void RunOnUiThread(std::function<void()> task);
+
 	std::wstring m_directory;
 	Manifest m_manifest;
 
 	sol::state m_lua;
 	const int m_id;
+
+	const Runtime *const m_runtime;
+	UiThreadInvoker m_uiThreadInvoker;
+
+	// This is declared after the Lua state, since it needs to be
+	// destroyed before the state.
+	LuaExecutionBudget m_budget;
+	const LuaExecutionBudget::Limits m_handlerLimits;
+	bool m_panicked = false;
+
+	std::shared_ptr<concurrencpp::executor> m_executor;
+
+	mutable std::mutex m_statsMutex;
+	Stats m_stats;
 };
 
 class LuaPanicException : public std::runtime_error
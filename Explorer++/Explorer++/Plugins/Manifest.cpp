@@ -52,6 +52,11 @@ void Plugins::from_json(const nlohmann::json &json, Manifest &manifest)
 	{
 		json.at("shortcut_keys").get_to(manifest.shortcutKeys);
 	}
+
+	if (json.count("execution_limits") != 0)
+	{
+		json.at("execution_limits").get_to(manifest.executionLimits);
+	}
 }
 
 void Plugins::from_json(const nlohmann::json &json, Command &command)
@@ -95,6 +100,19 @@ void Plugins::from_json(const nlohmann::json &json, PluginAccelerator &pluginAcc
 	pluginAccelerator.accelerator = parseAccelerator(pluginAccelerator.acceleratorString);
 }
 
+void Plugins::from_json(const nlohmann::json &json, ExecutionLimits &executionLimits)
+{
+	if (json.count("max_instructions") != 0)
+	{
+		executionLimits.maxInstructions = json.at("max_instructions").get<uint64_t>();
+	}
+
+	if (json.count("timeout_ms") != 0)
+	{
+		executionLimits.timeout = std::chrono::milliseconds(json.at("timeout_ms").get<int>());
+	}
+}
+
 std::optional<Plugins::Manifest> Plugins::parseManifest(const std::filesystem::path &manifestPath)
 {
 	std::ifstream inputStream(manifestPath.wstring());
@@ -7,6 +7,8 @@
 #include "Accelerator.h"
 #include <nlohmann/json.hpp>
 #include <sol/sol.hpp>
+#include <chrono>
+#include <cstdint>
 #include <optional>
 
 namespace std
@@ -39,6 +41,13 @@ struct Command
 	std::wstring description;
 };
 
+// Overrides the limits applied each time one of the plugin's callbacks is invoked.
+struct ExecutionLimits
+{
+	std::optional<uint64_t> maxInstructions;
+	std::optional<std::chrono::milliseconds> timeout;
+};
+
 struct Manifest
 {
 	std::wstring name;
@@ -51,6 +60,7 @@ struct Manifest
 	std::vector<sol::lib> libraries;
 	std::vector<Command> commands;
 	std::vector<PluginShortcutKey> shortcutKeys;
+	ExecutionLimits executionLimits;
 };
 
 NLOHMANN_JSON_SERIALIZE_ENUM(sol::lib,
@@ -71,6 +81,7 @@ void from_json(const nlohmann::json &json, Manifest &manifest);
 void from_json(const nlohmann::json &json, Command &command);
 void from_json(const nlohmann::json &json, PluginShortcutKey &shortcutKey);
 void from_json(const nlohmann::json &json, PluginAccelerator &pluginAccelerator);
+void from_json(const nlohmann::json &json, ExecutionLimits &executionLimits);
 
 std::optional<Manifest> parseManifest(const std::filesystem::path &manifestPath);
 }
@@ -6,7 +6,8 @@
 #include "Plugins/MenuApi.h"
 #include <sol/sol.hpp>
 
-Plugins::MenuApi::MenuApi(PluginMenuManager *pluginMenuManager) :
+Plugins::MenuApi::MenuApi(LuaPlugin *plugin, PluginMenuManager *pluginMenuManager) :
+	m_plugin(plugin),
 	m_pluginMenuManager(pluginMenuManager)
 {
 	m_connections.emplace_back(m_pluginMenuManager->AddMenuClickedObserver(
@@ -31,7 +32,8 @@ std::optional<int> Plugins::MenuApi::create(const std::wstring &text,
 		return menuItemId;
 	}
 
-	m_pluginMenuItems.insert(std::make_pair(*menuItemId, callback));
+	m_pluginMenuItems.insert(
+		std::make_pair(*menuItemId, m_plugin->WrapCallback(std::move(callback))));
 
 	return menuItemId;
 }
@@ -59,5 +61,5 @@ void Plugins::MenuApi::onMenuItemClicked(int menuItemId)
 		return;
 	}
 
-	itr->second();
+	m_plugin->InvokeCallback(itr->second);
 }
@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include "Plugins/LuaPlugin.h"
 #include "Plugins/PluginMenuManager.h"
 #include <boost/signals2.hpp>
 #include <sol/forward.hpp>
@@ -15,7 +16,7 @@ namespace Plugins
 class MenuApi
 {
 public:
-	MenuApi(PluginMenuManager *pluginMenuManager);
+	MenuApi(LuaPlugin *plugin, PluginMenuManager *pluginMenuManager);
 	~MenuApi();
 
 	std::optional<int> create(const std::wstring &text, sol::protected_function callback);
@@ -24,10 +25,11 @@ public:
 private:
 	void onMenuItemClicked(int menuItemId);
 
+	LuaPlugin *m_plugin;
 	PluginMenuManager *m_pluginMenuManager;
 
 	std::vector<boost::signals2::scoped_connection> m_connections;
 
-	std::unordered_map<int, sol::protected_function> m_pluginMenuItems;
+	std::unordered_map<int, LuaPlugin::Callback> m_pluginMenuItems;
 };
 }
@@ -0,0 +1,298 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "stdafx.h"
+#include "Plugins/PluginColumnEvaluator.h"
+#include "../Helper/StringHelper.h"
+#include "../ThirdParty/CTPL/cpl_stl.h"
+#include <wil/resource.h>
+#include <algorithm>
+#include <cwchar>
+#include <format>
+#include <future>
+
+namespace Plugins
+{
+
+struct PluginColumnEvaluator::IsolatedState
+{
+	IsolatedState() : budget(lua.lua_state())
+	{
+	}
+
+	// The budget and function both need to be destroyed before the state, which is why they're
+	// declared after it.
+	sol::state lua;
+	LuaExecutionBudget budget;
+	sol::protected_function function;
+};
+
+PluginColumnEvaluator::PluginColumnEvaluator(std::string bytecode,
+	std::vector<sol::lib> libraries, PluginColumnSortType sortType,
+	const LuaExecutionBudget::Limits &limits) :
+	m_bytecode(std::move(bytecode)),
+	m_libraries(std::move(libraries)),
+	m_sortType(sortType),
+	m_limits(limits)
+{
+}
+
+PluginColumnEvaluator::~PluginColumnEvaluator() = default;
+
+std::optional<std::string> PluginColumnEvaluator::DumpFunction(
+	const sol::protected_function &function)
+{
+	lua_State *state = function.lua_state();
+	int originalTop = lua_gettop(state);
+	auto restoreStack = wil::scope_exit([state, originalTop] { lua_settop(state, originalTop); });
+
+	function.push();
+
+	if (!lua_isfunction(state, -1) || lua_iscfunction(state, -1))
+	{
+		return std::nullopt;
+	}
+
+	// When the bytecode is loaded, the first upvalue (if any) will be set to the global
+	// environment of the new state. That's only the correct value if the upvalue is _ENV. Any
+	// other upvalue would be left as nil, which almost certainly isn't what the function expects.
+	for (int i = 1;; i++)
+	{
+		const char *name = lua_getupvalue(state, -1, i);
+
+		if (!name)
+		{
+			break;
+		}
+
+		lua_pop(state, 1);
+
+		if (i > 1 || std::string_view(name) != "_ENV")
+		{
+			return std::nullopt;
+		}
+	}
+
+	std::string bytecode;
+	int res = lua_dump(
+		state,
+		[](lua_State *L, const void *data, size_t size, void *userData)
+		{
+			UNREFERENCED_PARAMETER(L);
+
+			static_cast<std::string *>(userData)->append(static_cast<const char *>(data), size);
+			return 0;
+		},
+		&bytecode, 0);
+
+	if (res != 0)
+	{
+		return std::nullopt;
+	}
+
+	return bytecode;
+}
+
+PluginColumnSortType PluginColumnEvaluator::GetSortType() const
+{
+	return m_sortType;
+}
+
+PluginColumnValue PluginColumnEvaluator::Evaluate(const std::wstring &path)
+{
+	auto state = AcquireState();
+
+	if (!state)
+	{
+		return {};
+	}
+
+	PluginColumnValue value;
+
+	try
+	{
+		std::optional<sol::protected_function_result> result;
+		auto outcome = state->budget.Run(m_limits,
+			[&state, &result, &path]
+			{
+				result.emplace(state->function(wstrToUtf8Str(path)));
+				return result->valid();
+			});
+
+		if (outcome == LuaExecutionBudget::Outcome::Completed)
+		{
+			value = ConvertResult(*result);
+		}
+	}
+	catch (const sol::error &)
+	{
+		// A panic leaves the state unusable, so it's simply discarded.
+		std::scoped_lock lock(m_mutex);
+		m_numStates--;
+		return {};
+	}
+
+	ReleaseState(std::move(state));
+
+	return value;
+}
+
+std::vector<PluginColumnValue> PluginColumnEvaluator::EvaluateBatch(
+	const std::vector<std::wstring> &paths, ctpl::thread_pool &threadPool)
+{
+	CHECK_GT(threadPool.size(), 0);
+
+	std::vector<PluginColumnValue> values(paths.size());
+
+	if (paths.empty())
+	{
+		return values;
+	}
+
+	size_t numChunks = std::min(paths.size(), threadPool.size() * CHUNKS_PER_THREAD);
+	size_t chunkSize = (paths.size() + numChunks - 1) / numChunks;
+
+	std::vector<std::future<void>> futures;
+
+	for (size_t start = 0; start < paths.size(); start += chunkSize)
+	{
+		size_t end = std::min(start + chunkSize, paths.size());
+
+		futures.push_back(threadPool.push(
+			[this, &paths, &values, start, end](int id)
+			{
+				UNREFERENCED_PARAMETER(id);
+
+				for (size_t i = start; i < end; i++)
+				{
+					values[i] = Evaluate(paths[i]);
+				}
+			}));
+	}
+
+	for (auto &future : futures)
+	{
+		future.get();
+	}
+
+	return values;
+}
+
+size_t PluginColumnEvaluator::GetNumStates() const
+{
+	std::scoped_lock lock(m_mutex);
+	return m_numStates;
+}
+
+std::unique_ptr<PluginColumnEvaluator::IsolatedState> PluginColumnEvaluator::AcquireState()
+{
+	{
+		std::scoped_lock lock(m_mutex);
+
+		if (!m_idleStates.empty())
+		{
+			auto state = std::move(m_idleStates.back());
+			m_idleStates.pop_back();
+			return state;
+		}
+	}
+
+	// Creating a state involves loading the bytecode, so that's done without holding the lock.
+	auto state = CreateState();
+
+	if (!state)
+	{
+		return nullptr;
+	}
+
+	std::scoped_lock lock(m_mutex);
+	m_numStates++;
+
+	return state;
+}
+
+void PluginColumnEvaluator::ReleaseState(std::unique_ptr<IsolatedState> state)
+{
+	std::scoped_lock lock(m_mutex);
+	m_idleStates.push_back(std::move(state));
+}
+
+std::unique_ptr<PluginColumnEvaluator::IsolatedState> PluginColumnEvaluator::CreateState() const
+{
+	auto state = std::make_unique<IsolatedState>();
+
+	for (auto library : m_libraries)
+	{
+		// See PluginManager::registerPlugin() for an explanation of why std::move is used here.
+		state->lua.open_libraries(std::move(library));
+	}
+
+	auto loadResult = state->lua.load(std::string_view(m_bytecode), "column",
+		sol::load_mode::binary);
+
+	if (!loadResult.valid())
+	{
+		return nullptr;
+	}
+
+	state->function = loadResult.get<sol::protected_function>();
+
+	return state;
+}
+
+PluginColumnValue PluginColumnEvaluator::ConvertResult(
+	const sol::protected_function_result &result) const
+{
+	PluginColumnValue value;
+
+	if (result.return_count() == 0)
+	{
+		return value;
+	}
+
+	sol::object object = result.get<sol::object>();
+
+	switch (object.get_type())
+	{
+	case sol::type::number:
+	{
+		auto number = object.as<double>();
+		value.text = std::format(L"{}", number);
+
+		if (m_sortType == PluginColumnSortType::Number)
+		{
+			value.number = number;
+		}
+	}
+	break;
+
+	case sol::type::string:
+	{
+		value.text = utf8StrToWstr(object.as<std::string>());
+
+		if (m_sortType == PluginColumnSortType::Number && !value.text.empty())
+		{
+			wchar_t *end;
+			double number = std::wcstod(value.text.c_str(), &end);
+
+			if (*end == '\0')
+			{
+				value.number = number;
+			}
+		}
+	}
+	break;
+
+	case sol::type::boolean:
+		value.text = object.as<bool>() ? L"true" : L"false";
+		break;
+
+	default:
+		break;
+	}
+
+	return value;
+}
+
+}
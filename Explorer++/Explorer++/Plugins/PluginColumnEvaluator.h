@@ -0,0 +1,88 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#pragma once
+
+#include "Plugins/LuaExecutionBudget.h"
+#include "Plugins/PluginColumnValue.h"
+#include <boost/core/noncopyable.hpp>
+#include <sol/sol.hpp>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace ctpl
+{
+class thread_pool;
+}
+
+namespace Plugins
+{
+
+// Evaluates a column function registered by a plugin. The column function maps an item path to a
+// value.
+//
+// The function isn't run within the plugin's own Lua state, since that state is only ever used from
+// the plugin thread. Instead, the function is transferred as Lua bytecode and loaded into a set of
+// isolated Lua states. A state is only ever used by a single thread at a time, so several items can
+// be evaluated concurrently, with the number of states growing to match the number of threads
+// performing evaluations.
+//
+// As the function is loaded into a fresh state, it can only refer to global values set up by the
+// standard libraries. Functions that capture local upvalues are rejected by DumpFunction().
+//
+// This class is thread-safe.
+class PluginColumnEvaluator : private boost::noncopyable
+{
+public:
+	PluginColumnEvaluator(std::string bytecode, std::vector<sol::lib> libraries,
+		PluginColumnSortType sortType, const LuaExecutionBudget::Limits &limits);
+	~PluginColumnEvaluator();
+
+	// Dumps the provided Lua function to bytecode, suitable for passing to the constructor. Returns
+	// an empty value if the function can't be transferred to another state (e.g. because it's a C
+	// function, or because it captures local variables).
+	static std::optional<std::string> DumpFunction(const sol::protected_function &function);
+
+	PluginColumnSortType GetSortType() const;
+
+	// Evaluates the column for a single item. If the function fails (e.g. because it raised an
+	// error or exceeded its execution limits), an empty value will be returned.
+	PluginColumnValue Evaluate(const std::wstring &path);
+
+	// Evaluates the column for each of the specified items, splitting the work across the threads
+	// in the pool. This blocks until every item has been evaluated. The returned values are in the
+	// same order as the paths.
+	std::vector<PluginColumnValue> EvaluateBatch(const std::vector<std::wstring> &paths,
+		ctpl::thread_pool &threadPool);
+
+	// Returns the number of isolated states that have been created, which is also the maximum
+	// number of concurrent evaluations that have taken place.
+	size_t GetNumStates() const;
+
+private:
+	struct IsolatedState;
+
+	// Each thread in the pool is given several chunks, so that the work remains balanced if some
+	// items take longer to evaluate than others.
+	static constexpr size_t CHUNKS_PER_THREAD = 4;
+
+	std::unique_ptr<IsolatedState> AcquireState();
+	void ReleaseState(std::unique_ptr<IsolatedState> state);
+	std::unique_ptr<IsolatedState> CreateState() const;
+	PluginColumnValue ConvertResult(const sol::protected_function_result &result) const;
+
+	const std::string m_bytecode;
+	const std::vector<sol::lib> m_libraries;
+	const PluginColumnSortType m_sortType;
+	const LuaExecutionBudget::Limits m_limits;
+
+	mutable std::mutex m_mutex;
+	std::vector<std::unique_ptr<IsolatedState>> m_idleStates;
+	size_t m_numStates = 0;
+};
+
+}
@@ -0,0 +1,236 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "stdafx.h"
+#include "Plugins/PluginColumnRegistry.h"
+#include "../Helper/StringHelper.h"
+#include <algorithm>
+
+namespace Plugins
+{
+
+PluginColumnRegistry::PluginColumnRegistry(int numThreads) : m_threadPool(numThreads)
+{
+}
+
+bool PluginColumnRegistry::RegisterColumn(const PluginColumnDefinition &definition)
+{
+	auto [itr, inserted] = m_registrations.try_emplace(definition.key);
+	auto &registration = itr->second;
+
+	if (inserted)
+	{
+		registration.definition = definition;
+	}
+	else if (registration.definition.name != definition.name)
+	{
+		return false;
+	}
+
+	registration.numReferences++;
+
+	if (registration.slot || !m_assignSlotsImmediately)
+	{
+		return true;
+	}
+
+	if (AssignSlot(registration))
+	{
+		m_columnsChangedSignal();
+	}
+
+	return true;
+}
+
+void PluginColumnRegistry::UnregisterColumn(const std::wstring &key)
+{
+	auto itr = m_registrations.find(key);
+
+	if (itr == m_registrations.end())
+	{
+		return;
+	}
+
+	auto &registration = itr->second;
+	registration.numReferences--;
+
+	if (registration.numReferences > 0)
+	{
+		return;
+	}
+
+	bool hadSlot = registration.slot.has_value();
+
+	if (hadSlot)
+	{
+		m_slots[*registration.slot] = nullptr;
+	}
+
+	m_registrations.erase(itr);
+
+	if (hadSlot)
+	{
+		m_columnsChangedSignal();
+	}
+}
+
+void PluginColumnRegistry::AssignPendingSlots()
+{
+	m_assignSlotsImmediately = true;
+
+	bool anyAssigned = false;
+
+	for (auto &[key, registration] : m_registrations)
+	{
+		if (!registration.slot && AssignSlot(registration))
+		{
+			anyAssigned = true;
+		}
+	}
+
+	if (anyAssigned)
+	{
+		m_columnsChangedSignal();
+	}
+}
+
+void PluginColumnRegistry::SetSlotAssignments(const SlotAssignments &slotAssignments)
+{
+	m_slotAssignments.clear();
+
+	for (const auto &[key, slot] : slotAssignments)
+	{
+		if (slot < 0 || slot >= NUM_PLUGIN_COLUMNS || IsSlotReservedForOtherKey(slot, key))
+		{
+			continue;
+		}
+
+		m_slotAssignments[key] = slot;
+	}
+}
+
+const PluginColumnRegistry::SlotAssignments &PluginColumnRegistry::GetSlotAssignments() const
+{
+	return m_slotAssignments;
+}
+
+bool PluginColumnRegistry::AssignSlot(Registration &registration)
+{
+	const auto &key = registration.definition.key;
+	auto slot = FindSlotForKey(key);
+
+	if (!slot)
+	{
+		LOG(WARNING) << "No plugin column slots remaining for column \"" << wstrToUtf8Str(key)
+					 << "\"";
+		return false;
+	}
+
+	// If the slot was reserved for a different column, that column will lose its reservation.
+	std::erase_if(m_slotAssignments,
+		[&key, slot](const auto &entry) { return entry.second == *slot && entry.first != key; });
+	m_slotAssignments[key] = *slot;
+
+	m_slots[*slot] = &registration;
+	registration.slot = *slot;
+
+	return true;
+}
+
+std::optional<int> PluginColumnRegistry::FindSlotForKey(const std::wstring &key) const
+{
+	auto savedItr = m_slotAssignments.find(key);
+
+	if (savedItr != m_slotAssignments.end() && !m_slots[savedItr->second])
+	{
+		return savedItr->second;
+	}
+
+	std::optional<int> firstFreeSlot;
+
+	for (int i = 0; i < NUM_PLUGIN_COLUMNS; i++)
+	{
+		if (m_slots[i])
+		{
+			continue;
+		}
+
+		if (!IsSlotReservedForOtherKey(i, key))
+		{
+			return i;
+		}
+
+		if (!firstFreeSlot)
+		{
+			firstFreeSlot = i;
+		}
+	}
+
+	// Every free slot is reserved for a column that isn't currently registered. In that case, one
+	// of the reservations will be given up.
+	return firstFreeSlot;
+}
+
+bool PluginColumnRegistry::IsSlotReservedForOtherKey(int slot, const std::wstring &key) const
+{
+	return std::any_of(m_slotAssignments.begin(), m_slotAssignments.end(),
+		[slot, &key](const auto &entry) { return entry.second == slot && entry.first != key; });
+}
+
+const PluginColumnDefinition *PluginColumnRegistry::GetColumn(ColumnType columnType) const
+{
+	if (!IsPluginColumn(columnType))
+	{
+		return nullptr;
+	}
+
+	const auto *registration = m_slots[GetPluginColumnSlot(columnType)];
+
+	if (!registration)
+	{
+		return nullptr;
+	}
+
+	return &registration->definition;
+}
+
+std::optional<ColumnType> PluginColumnRegistry::GetColumnType(const std::wstring &key) const
+{
+	auto itr = m_registrations.find(key);
+
+	if (itr == m_registrations.end() || !itr->second.slot)
+	{
+		return std::nullopt;
+	}
+
+	return GetPluginColumnType(*itr->second.slot);
+}
+
+std::vector<ColumnType> PluginColumnRegistry::GetAssignedColumnTypes() const
+{
+	std::vector<ColumnType> columnTypes;
+
+	for (int i = 0; i < NUM_PLUGIN_COLUMNS; i++)
+	{
+		if (m_slots[i])
+		{
+			columnTypes.push_back(GetPluginColumnType(i));
+		}
+	}
+
+	return columnTypes;
+}
+
+ctpl::thread_pool &PluginColumnRegistry::GetThreadPool()
+{
+	return m_threadPool;
+}
+
+boost::signals2::connection PluginColumnRegistry::AddColumnsChangedObserver(
+	const ColumnsChangedSignal::slot_type &observer)
+{
+	return m_columnsChangedSignal.connect(observer);
+}
+
+}
@@ -0,0 +1,113 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#pragma once
+
+#include "Plugins/PluginColumnEvaluator.h"
+#include "ShellBrowser/Columns.h"
+#include "../ThirdParty/CTPL/cpl_stl.h"
+#include <boost/core/noncopyable.hpp>
+#include <boost/signals2.hpp>
+#include <array>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace Plugins
+{
+
+struct PluginColumnDefinition
+{
+	// Uniquely identifies the column. This should remain the same each time the plugin is loaded.
+	std::wstring key;
+
+	std::wstring name;
+	std::wstring description;
+	std::shared_ptr<PluginColumnEvaluator> evaluator;
+};
+
+// Maps the columns registered by plugins to the plugin column slots in ColumnType.
+//
+// The same column can be registered multiple times (e.g. when a plugin is loaded in several
+// windows). In that case, each registration shares the same slot and the column remains registered
+// until every registration has been removed.
+//
+// Since the slot a column is assigned is what gets saved with the column settings, it's important
+// that each column is assigned the same slot from one session to the next. The slot assigned to
+// each key is therefore recorded and saved along with the column settings (see
+// GetSlotAssignments()). When a column is registered again, it will be given the slot it was
+// previously assigned. A slot remains reserved for its column even once the column has been
+// unregistered (e.g. because the plugin was removed), unless there are no other slots free.
+//
+// Plugins are loaded in parallel, so the order in which columns are registered isn't fixed. Slots
+// are only assigned once AssignPendingSlots() is called (once all plugins have loaded), at which
+// point any columns without a saved slot are assigned slots in order of their keys. Any column
+// registered after that point is assigned a slot immediately.
+//
+// The methods in this class should only be called on the UI thread. The exception is the thread
+// pool, which is used to evaluate columns and can be used from any thread.
+class PluginColumnRegistry : private boost::noncopyable
+{
+public:
+	using ColumnsChangedSignal = boost::signals2::signal<void()>;
+
+	// Maps each column key to the slot it was assigned.
+	using SlotAssignments = std::map<std::wstring, int>;
+
+	// The thread pool will be created with the specified number of threads.
+	PluginColumnRegistry(int numThreads);
+
+	// Returns false if a column with the same key, but a different name, has already been
+	// registered.
+	bool RegisterColumn(const PluginColumnDefinition &definition);
+	void UnregisterColumn(const std::wstring &key);
+	void AssignPendingSlots();
+
+	// The saved assignments should be set before any columns are registered. Invalid entries (e.g.
+	// those that refer to a slot that doesn't exist) will be ignored.
+	void SetSlotAssignments(const SlotAssignments &slotAssignments);
+	const SlotAssignments &GetSlotAssignments() const;
+
+	// Returns the column assigned to the specified slot, or null if the slot is unused.
+	const PluginColumnDefinition *GetColumn(ColumnType columnType) const;
+	std::optional<ColumnType> GetColumnType(const std::wstring &key) const;
+	std::vector<ColumnType> GetAssignedColumnTypes() const;
+
+	ctpl::thread_pool &GetThreadPool();
+
+	// Invoked whenever a column is assigned a slot, or a slot is released.
+	boost::signals2::connection AddColumnsChangedObserver(
+		const ColumnsChangedSignal::slot_type &observer);
+
+private:
+	struct Registration
+	{
+		PluginColumnDefinition definition;
+		int numReferences = 0;
+		std::optional<int> slot;
+	};
+
+	bool AssignSlot(Registration &registration);
+	std::optional<int> FindSlotForKey(const std::wstring &key) const;
+	bool IsSlotReservedForOtherKey(int slot, const std::wstring &key) const;
+
+	// This is ordered by key, which is what allows pending columns to be assigned slots in a
+	// consistent order.
+	std::map<std::wstring, Registration> m_registrations;
+	std::array<const Registration *, NUM_PLUGIN_COLUMNS> m_slots = {};
+	bool m_assignSlotsImmediately = false;
+
+	// This includes the slots assigned to columns that are no longer registered, so that those
+	// slots can be kept for the columns if they're registered again. Each slot appears at most
+	// once.
+	SlotAssignments m_slotAssignments;
+
+	ctpl::thread_pool m_threadPool;
+
+	ColumnsChangedSignal m_columnsChangedSignal;
+};
+
+}
@@ -0,0 +1,31 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#pragma once
+
+#include <optional>
+#include <string>
+
+namespace Plugins
+{
+
+enum class PluginColumnSortType
+{
+	Text,
+	Number
+};
+
+struct PluginColumnValue
+{
+	std::wstring text;
+
+	// This is only set for numeric columns, when the column function returned a number (or a
+	// string that could be converted to a number).
+	std::optional<double> number;
+
+	// This is only used in tests.
+	bool operator==(const PluginColumnValue &) const = default;
+};
+
+}
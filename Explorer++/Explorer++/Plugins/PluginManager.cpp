@@ -6,7 +6,9 @@
 #include "Plugins/PluginManager.h"
 #include "AcceleratorUpdater.h"
 #include "Plugins/Manifest.h"
+#include "Plugins/PluginColumnRegistry.h"
 #include "Plugins/PluginCommandManager.h"
+#include "../Helper/StringHelper.h"
 #include <sol/forward.hpp>
 #include <filesystem>
 
@@ -20,8 +22,28 @@ Plugins::PluginManager::PluginManager(PluginInterface *pluginInterface) :
 {
 }
 
-void Plugins::PluginManager::loadAllPlugins(const std::filesystem::path &pluginDirectory)
+Plugins::PluginManager::~PluginManager()
 {
+	for (const auto &report : getPluginReports())
+	{
+		LOG(INFO) << "Plugin \"" << wstrToUtf8Str(report.name) << "\" ran "
+				  << report.stats.numHandlerCalls << " handlers in "
+				  << report.stats.handlerTime.count() << "us ("
+				  << report.stats.numHandlerErrors << " errors, "
+				  << report.stats.numLimitsExceeded << " exceeded limits)";
+	}
+}
+
+void Plugins::PluginManager::loadAllPlugins(const std::filesystem::path &pluginDirectory,
+	std::function<void()> allPluginsLoadedCallback)
+{
+	m_allPluginsLoadedCallback = std::move(allPluginsLoadedCallback);
+
+	// This acts as an additional pending load, which ensures that the
+	// callback won't be invoked until all the plugins have at least
+	// been started.
+	m_numPendingLoads++;
+
 	std::error_code error;
 
 	/* TODO: Ideally, any error would be logged somewhere. For now, it's
@@ -39,6 +61,8 @@ void Plugins::PluginManager::loadAllPlugins(const std::filesystem::path &pluginD
 			attemptToLoadPlugin(entry);
 		}
 	}
+
+	onPluginLoadFinished();
 }
 
 bool Plugins::PluginManager::attemptToLoadPlugin(const std::filesystem::path &directory)
@@ -57,7 +81,8 @@ bool Plugins::PluginManager::attemptToLoadPlugin(const std::filesystem::path &di
 bool Plugins::PluginManager::registerPlugin(const std::filesystem::path &directory,
 	const Manifest &manifest)
 {
-	auto plugin = std::make_unique<LuaPlugin>(directory.wstring(), manifest, m_pluginInterface);
+	auto plugin = std::make_unique<LuaPlugin>(directory.wstring(), manifest, m_pluginInterface,
+		LuaPlugin::ThreadingModel::BackgroundThread);
 
 	for (auto library : manifest.libraries)
 	{
@@ -75,47 +100,96 @@ bool Plugins::PluginManager::registerPlugin(const std::filesystem::path &directo
 	auto pluginFile = directory / manifest.file;
 
 	// There's a potential race issue here. The file could exist at this
-	// point, but not when used by the safe_script_file call below. That
-	// doesn't really matter though.
+	// point, but not when the script is loaded. That doesn't really
+	// matter though.
 	if (!std::filesystem::exists(pluginFile))
 	{
 		return false;
 	}
 
-	try
+	int pluginId = plugin->GetId();
+	m_numPendingLoads++;
+
+	// Loading the plugin even if there's an error can be potentially
+	// useful for users, as it means that the plugin might still offer
+	// some of its functionality (if that functionality was set up
+	// before the error occurred).
+	plugin->Load(pluginFile,
+		[self = m_weakPtrFactory.GetWeakPtr(), pluginId](LuaPlugin::LoadResult result)
+		{
+			if (!self)
+			{
+				return;
+			}
+
+			self->onPluginLoaded(pluginId, result);
+		});
+
+	m_plugins.push_back(std::move(plugin));
+
+	return true;
+}
+
+void Plugins::PluginManager::onPluginLoaded(int pluginId, LuaPlugin::LoadResult result)
+{
+	auto itr = std::find_if(m_plugins.begin(), m_plugins.end(),
+		[pluginId](const auto &plugin) { return plugin->GetId() == pluginId; });
+	CHECK(itr != m_plugins.end());
+
+	auto &plugin = *itr;
+	auto manifest = plugin->GetManifest();
+
+	LOG(INFO) << "Plugin \"" << wstrToUtf8Str(manifest.name) << "\" loaded in "
+			  << plugin->GetStats().loadTime.count() << "us"
+			  << (result == LuaPlugin::LoadResult::Loaded ? "" : " (with errors)");
+
+	if (result == LuaPlugin::LoadResult::Failed)
 	{
-		plugin->GetLuaState().safe_script_file(pluginFile.string());
+		// If a panic has occurred, the Lua state is irretrievably
+		// broken. It's not safe to attempt to continue to use it, so
+		// the plugin is simply destroyed.
+		m_plugins.erase(itr);
 	}
-	catch (const sol::error &)
+	else
 	{
-		// Ignore the error. An exception can be thrown for something
-		// simple like a Lua script trying to use a variable that
-		// doesn't exist. That definitely shouldn't result in the
-		// application being terminated because of an uncaught
-		// exception.
-		// The assumption here is that since the panic handler wasn't
-		// called, the Lua state is still usable. Loading the plugin
-		// even if there's an error can be potentially useful for users,
-		// as it means that the plugin might still offer some of its
-		// functionality (if that functionality was set up before the
-		// error occurred).
+		m_pluginInterface->GetAccleratorUpdater()->update(
+			convertPluginShortcutKeys(manifest.shortcutKeys));
+		m_pluginInterface->GetPluginCommandManager()->addCommands(pluginId, manifest.commands);
 	}
-	catch (const LuaPanicException &)
+
+	onPluginLoadFinished();
+}
+
+void Plugins::PluginManager::onPluginLoadFinished()
+{
+	DCHECK_GT(m_numPendingLoads, 0);
+	m_numPendingLoads--;
+
+	if (m_numPendingLoads > 0)
 	{
-		// If a panic has occurred, the Lua state is irretrievably
-		// broken. It's not safe to attempt to continue to use it.
-		// Returning here will ensure that the state is simply
-		// destroyed.
-		return false;
+		return;
 	}
 
-	m_pluginInterface->GetAccleratorUpdater()->update(
-		convertPluginShortcutKeys(manifest.shortcutKeys));
-	m_pluginInterface->GetPluginCommandManager()->addCommands(plugin->GetId(), manifest.commands);
+	// Columns registered while the plugins were loading are only assigned slots now, so that the
+	// slots don't depend on the order in which the plugins finished loading.
+	m_pluginInterface->GetPluginColumnRegistry()->AssignPendingSlots();
 
-	m_plugins.push_back(std::move(plugin));
+	if (m_allPluginsLoadedCallback)
+	{
+		m_allPluginsLoadedCallback();
+	}
+}
 
-	return true;
+std::vector<Plugins::PluginManager::PluginReport> Plugins::PluginManager::getPluginReports() const
+{
+	std::vector<PluginReport> reports;
+
+	for (const auto &plugin : m_plugins)
+	{
+		reports.push_back({ plugin->GetManifest().name, plugin->GetStats() });
+	}
+
+	return reports;
 }
 
 std::vector<ShortcutKey> convertPluginShortcutKeys(
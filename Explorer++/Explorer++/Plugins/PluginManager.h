@@ -6,6 +6,8 @@
 
 #include "PluginInterface.h"
 #include "Plugins/LuaPlugin.h"
+#include "../Helper/WeakPtrFactory.h"
+#include <functional>
 
 namespace std
 {
@@ -20,18 +22,38 @@ namespace Plugins
 class PluginManager
 {
 public:
+	struct PluginReport
+	{
+		std::wstring name;
+		LuaPlugin::Stats stats;
+	};
+
 	PluginManager(PluginInterface *pluginInterface);
+	~PluginManager();
+
+	// Each plugin is loaded on its own thread, so plugins are loaded
+	// in parallel. The callback will be invoked on the UI thread once
+	// every plugin has finished loading.
+	void loadAllPlugins(const std::filesystem::path &pluginDirectory,
+		std::function<void()> allPluginsLoadedCallback);
 
-	void loadAllPlugins(const std::filesystem::path &pluginDirectory);
+	std::vector<PluginReport> getPluginReports() const;
 
 private:
 	static const std::wstring MANIFEST_NAME;
 
 	bool attemptToLoadPlugin(const std::filesystem::path &directory);
 	bool registerPlugin(const std::filesystem::path &directory, const Manifest &manifest);
+	void onPluginLoaded(int pluginId, LuaPlugin::LoadResult result);
+	void onPluginLoadFinished();
 
 	PluginInterface *m_pluginInterface;
 
 	std::vector<std::unique_ptr<Plugins::LuaPlugin>> m_plugins;
+
+	int m_numPendingLoads = 0;
+	std::function<void()> m_allPluginsLoadedCallback;
+
+	WeakPtrFactory<PluginManager> m_weakPtrFactory{ this };
 };
 }
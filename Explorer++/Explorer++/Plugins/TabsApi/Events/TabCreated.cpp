@@ -11,15 +11,14 @@
 namespace Plugins
 {
 
-TabCreated::TabCreated(TabEvents *tabEvents) : m_tabEvents(tabEvents)
+TabCreated::TabCreated(LuaPlugin *plugin, TabEvents *tabEvents) :
+	Event(plugin),
+	m_tabEvents(tabEvents)
 {
 }
 
-boost::signals2::connection TabCreated::connectObserver(sol::protected_function observer,
-	sol::this_state state)
+boost::signals2::connection TabCreated::connectObserver(const LuaPlugin::Callback &observer)
 {
-	UNREFERENCED_PARAMETER(state);
-
 	return m_tabEvents->AddCreatedObserver(
 		[this, observer](const Tab &tab, bool selected)
 		{
@@ -30,10 +29,10 @@ boost::signals2::connection TabCreated::connectObserver(sol::protected_function
 		TabEventScope::Global());
 }
 
-void TabCreated::onTabCreated(const Tab &tab, sol::protected_function observer)
+void TabCreated::onTabCreated(const Tab &tab, const LuaPlugin::Callback &observer)
 {
 	TabsApi::Tab apiTab(tab);
-	observer(apiTab);
+	invokeObserver(observer, apiTab);
 }
 
 }
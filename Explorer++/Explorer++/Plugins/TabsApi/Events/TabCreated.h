@@ -15,14 +15,13 @@ namespace Plugins
 class TabCreated : public Event
 {
 public:
-	TabCreated(TabEvents *tabEvents);
+	TabCreated(LuaPlugin *plugin, TabEvents *tabEvents);
 
 protected:
-	boost::signals2::connection connectObserver(sol::protected_function observer,
-		sol::this_state state) override;
+	boost::signals2::connection connectObserver(const LuaPlugin::Callback &observer) override;
 
 private:
-	void onTabCreated(const Tab &tab, sol::protected_function observer);
+	void onTabCreated(const Tab &tab, const LuaPlugin::Callback &observer);
 
 	TabEvents *const m_tabEvents;
 };
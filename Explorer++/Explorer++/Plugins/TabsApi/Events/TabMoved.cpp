@@ -11,17 +11,17 @@
 namespace Plugins
 {
 
-TabMoved::TabMoved(TabEvents *tabEvents) : m_tabEvents(tabEvents)
+TabMoved::TabMoved(LuaPlugin *plugin, TabEvents *tabEvents) :
+	Event(plugin),
+	m_tabEvents(tabEvents)
 {
 }
 
-boost::signals2::connection TabMoved::connectObserver(sol::protected_function observer,
-	sol::this_state state)
+boost::signals2::connection TabMoved::connectObserver(const LuaPlugin::Callback &observer)
 {
-	UNREFERENCED_PARAMETER(state);
-
-	return m_tabEvents->AddMovedObserver([observer](const Tab &tab, int fromIndex, int toIndex)
-		{ observer(tab.GetId(), fromIndex, toIndex); }, TabEventScope::Global());
+	return m_tabEvents->AddMovedObserver(
+		[this, observer](const Tab &tab, int fromIndex, int toIndex)
+		{ invokeObserver(observer, tab.GetId(), fromIndex, toIndex); }, TabEventScope::Global());
 }
 
 }
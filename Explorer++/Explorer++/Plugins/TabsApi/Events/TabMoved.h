@@ -14,11 +14,10 @@ namespace Plugins
 class TabMoved : public Event
 {
 public:
-	TabMoved(TabEvents *tabEvents);
+	TabMoved(LuaPlugin *plugin, TabEvents *tabEvents);
 
 protected:
-	boost::signals2::connection connectObserver(sol::protected_function observer,
-		sol::this_state state) override;
+	boost::signals2::connection connectObserver(const LuaPlugin::Callback &observer) override;
 
 private:
 	TabEvents *const m_tabEvents;
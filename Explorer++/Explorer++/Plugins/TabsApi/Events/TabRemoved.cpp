@@ -11,16 +11,16 @@
 namespace Plugins
 {
 
-TabRemoved::TabRemoved(TabEvents *tabEvents) : m_tabEvents(tabEvents)
+TabRemoved::TabRemoved(LuaPlugin *plugin, TabEvents *tabEvents) :
+	Event(plugin),
+	m_tabEvents(tabEvents)
 {
 }
 
-boost::signals2::connection TabRemoved::connectObserver(sol::protected_function observer,
-	sol::this_state state)
+boost::signals2::connection TabRemoved::connectObserver(const LuaPlugin::Callback &observer)
 {
-	UNREFERENCED_PARAMETER(state);
-
-	return m_tabEvents->AddRemovedObserver([observer](const Tab &tab) { observer(tab.GetId()); },
+	return m_tabEvents->AddRemovedObserver(
+		[this, observer](const Tab &tab) { invokeObserver(observer, tab.GetId()); },
 		TabEventScope::Global());
 }
 
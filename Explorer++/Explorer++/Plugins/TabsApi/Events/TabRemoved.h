@@ -14,11 +14,10 @@ namespace Plugins
 class TabRemoved : public Event
 {
 public:
-	TabRemoved(TabEvents *tabEvents);
+	TabRemoved(LuaPlugin *plugin, TabEvents *tabEvents);
 
 protected:
-	boost::signals2::connection connectObserver(sol::protected_function observer,
-		sol::this_state state) override;
+	boost::signals2::connection connectObserver(const LuaPlugin::Callback &observer) override;
 
 private:
 	TabEvents *const m_tabEvents;
@@ -11,39 +11,47 @@
 namespace Plugins
 {
 
-TabUpdated::TabUpdated(TabEvents *tabEvents) : m_tabEvents(tabEvents)
+TabUpdated::TabUpdated(LuaPlugin *plugin, TabEvents *tabEvents) :
+	Event(plugin),
+	m_tabEvents(tabEvents)
 {
 }
 
-boost::signals2::connection TabUpdated::connectObserver(sol::protected_function observer,
-	sol::this_state state)
+boost::signals2::connection TabUpdated::connectObserver(const LuaPlugin::Callback &observer)
 {
 	return m_tabEvents->AddUpdatedObserver(
-		[this, observer, state](const Tab &tab, Tab::PropertyType propertyType)
-		{ onTabUpdated(observer, state, tab, propertyType); }, TabEventScope::Global());
+		[this, observer](const Tab &tab, Tab::PropertyType propertyType)
+		{ onTabUpdated(observer, tab, propertyType); }, TabEventScope::Global());
 }
 
-void TabUpdated::onTabUpdated(sol::protected_function observer, sol::this_state state,
-	const Tab &tab, Tab::PropertyType propertyType)
+void TabUpdated::onTabUpdated(const LuaPlugin::Callback &observer, const Tab &tab,
+	Tab::PropertyType propertyType)
 {
-	sol::state_view existingState = state;
-
-	sol::table changeInfo = existingState.create_table();
+	// The tab details are retrieved here, on the UI thread. The change table, on the other hand,
+	// is a Lua object, so it can only be built on the plugin thread.
+	int tabId = tab.GetId();
+	std::wstring name = tab.GetName();
+	Tab::LockState lockState = tab.GetLockState();
+	TabsApi::Tab tabData(tab);
 
-	switch (propertyType)
-	{
-	case Tab::PropertyType::Name:
-		changeInfo["name"] = tab.GetName();
-		break;
+	getPlugin()->RunHandler(
+		[plugin = getPlugin(), observer, tabId, propertyType, name, lockState, tabData]
+		{
+			sol::table changeInfo = plugin->GetLuaState().create_table();
 
-	case Tab::PropertyType::LockState:
-		changeInfo["lockState"] = tab.GetLockState();
-		break;
-	}
+			switch (propertyType)
+			{
+			case Tab::PropertyType::Name:
+				changeInfo["name"] = name;
+				break;
 
-	TabsApi::Tab tabData(tab);
+			case Tab::PropertyType::LockState:
+				changeInfo["lockState"] = lockState;
+				break;
+			}
 
-	observer(tab.GetId(), changeInfo, tabData);
+			return (*observer)(tabId, changeInfo, tabData).valid();
+		});
 }
 
 }
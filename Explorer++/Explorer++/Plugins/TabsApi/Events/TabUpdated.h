@@ -15,14 +15,13 @@ namespace Plugins
 class TabUpdated : public Event
 {
 public:
-	TabUpdated(TabEvents *tabEvents);
+	TabUpdated(LuaPlugin *plugin, TabEvents *tabEvents);
 
 protected:
-	boost::signals2::connection connectObserver(sol::protected_function observer,
-		sol::this_state state) override;
+	boost::signals2::connection connectObserver(const LuaPlugin::Callback &observer) override;
 
 private:
-	void onTabUpdated(sol::protected_function observer, sol::this_state state, const Tab &tab,
+	void onTabUpdated(const LuaPlugin::Callback &observer, const Tab &tab,
 		Tab::PropertyType propertyType);
 
 	TabEvents *const m_tabEvents;
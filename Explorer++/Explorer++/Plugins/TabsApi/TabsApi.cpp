@@ -13,18 +13,19 @@
 #include "ShellBrowser/ShellNavigationController.h"
 #include "ShellBrowser/SortModes.h"
 #include "TabContainerImpl.h"
+#include "../Helper/ShellHelper.h"
 #include <sol/sol.hpp>
 
-Plugins::TabsApi::FolderSettings::FolderSettings(const ShellBrowserImpl &shellBrowser)
+Plugins::TabsApi::FolderSettings::FolderSettings(const ::FolderSettings &folderSettings)
 {
-	sortMode = shellBrowser.GetSortMode();
-	groupMode = shellBrowser.GetGroupMode();
-	viewMode = shellBrowser.GetViewMode();
-	autoArrange = shellBrowser.GetAutoArrange();
-	sortDirection = shellBrowser.GetSortDirection();
-	groupSortDirection = shellBrowser.GetGroupSortDirection();
-	showInGroups = shellBrowser.GetShowInGroups();
-	showHidden = shellBrowser.GetShowHidden();
+	sortMode = folderSettings.sortMode;
+	groupMode = folderSettings.groupMode;
+	viewMode = folderSettings.viewMode;
+	autoArrange = folderSettings.autoArrange;
+	sortDirection = folderSettings.sortDirection;
+	groupSortDirection = folderSettings.groupSortDirection;
+	showInGroups = folderSettings.showInGroups;
+	showHidden = folderSettings.showHidden;
 }
 
 std::wstring Plugins::TabsApi::FolderSettings::toString()
@@ -42,10 +43,15 @@ std::wstring Plugins::TabsApi::FolderSettings::toString()
 }
 
 Plugins::TabsApi::Tab::Tab(const ::Tab &tabInternal) :
-	folderSettings(*tabInternal.GetShellBrowserImpl())
+	folderSettings(tabInternal.GetShellBrowser()->GetFolderSettings())
 {
+	// As with the tab name, the location is taken from the current entry, since a dormant tab won't
+	// have navigated to its folder yet.
+	auto *currentEntry =
+		tabInternal.GetShellBrowser()->GetNavigationController()->GetCurrentEntry();
+
 	id = tabInternal.GetId();
-	location = tabInternal.GetShellBrowserImpl()->GetDirectory();
+	location = GetDisplayNameWithFallback(currentEntry->GetPidl().Raw(), SHGDN_FORPARSING);
 	name = tabInternal.GetName();
 	locked = (tabInternal.GetLockState() == ::Tab::LockState::Locked);
 	addressLocked = (tabInternal.GetLockState() == ::Tab::LockState::AddressLocked);
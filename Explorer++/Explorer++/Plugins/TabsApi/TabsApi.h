@@ -12,7 +12,6 @@
 
 class CoreInterface;
 struct FolderSettings;
-class ShellBrowserImpl;
 class TabContainerImpl;
 struct TabSettings;
 
@@ -32,7 +31,7 @@ public:
 		bool showInGroups;
 		bool showHidden;
 
-		FolderSettings(const ShellBrowserImpl &shellBrowser);
+		FolderSettings(const ::FolderSettings &folderSettings);
 		std::wstring toString();
 	};
 
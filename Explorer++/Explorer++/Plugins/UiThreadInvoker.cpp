@@ -0,0 +1,117 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "stdafx.h"
+#include "Plugins/UiThreadInvoker.h"
+#include "Runtime.h"
+#include <stdexcept>
+
+namespace Plugins
+{
+
+UiThreadInvoker::UiThreadInvoker(const Runtime *runtime) : m_runtime(runtime)
+{
+}
+
+void UiThreadInvoker::InvokeInternal(const std::function<void()> &function)
+{
+	if (m_runtime->IsUiThread())
+	{
+		function();
+		return;
+	}
+
+	auto call = std::make_shared<PendingCall>();
+
+	{
+		std::scoped_lock lock(m_mutex);
+
+		if (m_shutDown)
+		{
+			throw std::runtime_error("The plugin is being unloaded.");
+		}
+
+		m_pendingCalls.insert(call);
+	}
+
+	try
+	{
+		// Note that the function is only referenced while this thread is waiting. If the call is
+		// cancelled, this thread will stop waiting, but the task will no longer run the function.
+		// Since both the task and Shutdown() run on the UI thread, the call can't be cancelled
+		// while the function is running.
+		m_runtime->GetUiThreadExecutor()->post(
+			[call, &function]
+			{
+				{
+					std::scoped_lock callLock(call->mutex);
+
+					if (call->cancelled)
+					{
+						return;
+					}
+				}
+
+				std::exception_ptr exception;
+
+				try
+				{
+					function();
+				}
+				catch (...)
+				{
+					exception = std::current_exception();
+				}
+
+				std::scoped_lock callLock(call->mutex);
+				call->completed = true;
+				call->exception = exception;
+				call->completedCondition.notify_one();
+			});
+	}
+	catch (const concurrencpp::errors::runtime_shutdown &)
+	{
+		std::scoped_lock callLock(call->mutex);
+		call->cancelled = true;
+	}
+
+	std::unique_lock callLock(call->mutex);
+	call->completedCondition.wait(callLock, [&call] { return call->completed || call->cancelled; });
+	bool completed = call->completed;
+	auto exception = call->exception;
+	callLock.unlock();
+
+	{
+		std::scoped_lock lock(m_mutex);
+		m_pendingCalls.erase(call);
+	}
+
+	if (!completed)
+	{
+		throw std::runtime_error("The plugin is being unloaded.");
+	}
+
+	if (exception)
+	{
+		std::rethrow_exception(exception);
+	}
+}
+
+void UiThreadInvoker::Shutdown()
+{
+	DCHECK(m_runtime->IsUiThread());
+
+	std::scoped_lock lock(m_mutex);
+
+	m_shutDown = true;
+
+	for (const auto &call : m_pendingCalls)
+	{
+		std::scoped_lock callLock(call->mutex);
+		call->cancelled = true;
+		call->completedCondition.notify_one();
+	}
+}
+
+}
@@ -0,0 +1,76 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#pragma once
+
+#include <boost/core/noncopyable.hpp>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <type_traits>
+#include <unordered_set>
+
+class Runtime;
+
+namespace Plugins
+{
+
+// Plugin code runs on a dedicated background thread, while the plugin API methods it calls
+// interact with UI objects. This class allows those methods to be synchronously run on the UI
+// thread. The plugin thread is blocked while the method runs, so the method can safely access the
+// plugin's Lua state.
+//
+// The UI thread must never wait on a plugin thread, since the plugin thread may itself be waiting
+// on the UI thread. Instead, Shutdown() should be called before the plugin thread is stopped, which
+// will release any call that's currently waiting.
+class UiThreadInvoker : private boost::noncopyable
+{
+public:
+	UiThreadInvoker(const Runtime *runtime);
+
+	// Runs the function on the UI thread and returns its result. Any exception thrown by the
+	// function will be rethrown here. An exception will also be thrown if the invoker is shut down
+	// before the function has run.
+	template <typename Function>
+	std::invoke_result_t<Function> Invoke(Function &&function)
+	{
+		using ResultType = std::invoke_result_t<Function>;
+
+		if constexpr (std::is_void_v<ResultType>)
+		{
+			InvokeInternal(function);
+		}
+		else
+		{
+			std::optional<ResultType> result;
+			InvokeInternal([&function, &result] { result.emplace(function()); });
+			return std::move(*result);
+		}
+	}
+
+	void Shutdown();
+
+private:
+	struct PendingCall
+	{
+		std::mutex mutex;
+		std::condition_variable completedCondition;
+		bool completed = false;
+		bool cancelled = false;
+		std::exception_ptr exception;
+	};
+
+	void InvokeInternal(const std::function<void()> &function);
+
+	const Runtime *const m_runtime;
+
+	std::mutex m_mutex;
+	std::unordered_set<std::shared_ptr<PendingCall>> m_pendingCalls;
+	bool m_shutDown = false;
+};
+
+}
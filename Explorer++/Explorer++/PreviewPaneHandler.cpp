@@ -0,0 +1,83 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "stdafx.h"
+#include "Explorer++.h"
+#include "App.h"
+#include "Config.h"
+#include "FilePreviewPane.h"
+#include "HolderWindow.h"
+#include "MainResource.h"
+#include "ResourceHelper.h"
+#include "ShellBrowser/ShellBrowserImpl.h"
+#include "TabContainerImpl.h"
+
+void Explorerplusplus::CreatePreviewPane()
+{
+	UINT holderStyle = WS_CHILD | WS_CLIPSIBLINGS | WS_CLIPCHILDREN;
+
+	if (m_config->showPreviewPane.get())
+	{
+		holderStyle |= WS_VISIBLE;
+	}
+
+	m_previewPaneHolder = HolderWindow::Create(m_hContainer,
+		ResourceHelper::LoadString(m_app->GetResourceInstance(), IDS_PREVIEW_PANE_TITLE),
+		holderStyle,
+		ResourceHelper::LoadString(m_app->GetResourceInstance(), IDS_HIDE_PREVIEW_PANE),
+		m_app->GetConfig(), m_app->GetIconResourceLoader(), m_app->GetDarkModeManager(),
+		HolderWindow::ResizeEdge::Left);
+	m_previewPaneHolder->SetCloseButtonClickedCallback(
+		[this] { m_config->showPreviewPane = false; });
+	m_previewPaneHolder->SetResizedCallback(
+		std::bind_front(&Explorerplusplus::OnPreviewPaneHolderResized, this));
+
+	m_filePreviewPane = FilePreviewPane::Create(m_previewPaneHolder->GetHWND(), m_app);
+	m_previewPaneHolder->SetContentChild(m_filePreviewPane->GetHWND());
+
+	m_connections.push_back(m_config->showPreviewPane.addObserver(
+		std::bind_front(&Explorerplusplus::OnShowPreviewPaneUpdated, this)));
+}
+
+void Explorerplusplus::OnShowPreviewPaneUpdated(bool showPreviewPane)
+{
+	UNREFERENCED_PARAMETER(showPreviewPane);
+
+	UpdateLayout();
+	UpdatePreviewPane(GetActivePane()->GetTabContainerImpl()->GetSelectedTab());
+}
+
+void Explorerplusplus::OnPreviewPaneHolderResized(int newWidth)
+{
+	m_previewPaneWidth = newWidth;
+
+	UpdateLayout();
+}
+
+void Explorerplusplus::UpdatePreviewPane(const Tab &tab)
+{
+	// The file is only mapped while the pane is visible, so that it isn't kept open unnecessarily.
+	if (!m_config->showPreviewPane.get())
+	{
+		m_filePreviewPane->SetFile(std::nullopt);
+		return;
+	}
+
+	const auto *shellBrowser = tab.GetShellBrowserImpl();
+	std::optional<std::wstring> path;
+
+	if (shellBrowser->GetNumSelected() == 1 && !shellBrowser->InVirtualFolder())
+	{
+		int selectedIndex = ListView_GetNextItem(shellBrowser->GetListView(), -1, LVNI_SELECTED);
+
+		if (selectedIndex != -1
+			&& WI_IsFlagClear(shellBrowser->GetItemFileFindData(selectedIndex).dwFileAttributes,
+				FILE_ATTRIBUTE_DIRECTORY))
+		{
+			path = shellBrowser->GetItemFullName(selectedIndex);
+		}
+	}
+
+	m_filePreviewPane->SetFile(path);
+}
@@ -14,6 +14,15 @@
 #include "VersionHelper.h"
 #include "../Helper/WindowSubclass.h"
 
+namespace
+{
+
+// The existing process acknowledges a request as soon as it's been queued, rather than once it's
+// been handled, so this only needs to cover a busy system.
+constexpr std::chrono::milliseconds HANDOFF_TIMEOUT(1000);
+
+}
+
 ProcessManager::ProcessManager(const BrowserList *browserList) : m_browserList(browserList)
 {
 }
@@ -35,17 +44,7 @@ bool ProcessManager::InitializeCurrentProcess(const CommandLine::Settings *comma
 
 	auto lock = mutex.acquire();
 
-	// Using the version number as the window name will mean that when attempting to find an
-	// existing window, only a window that's created by the current version will match. Running
-	// different versions simultaneously isn't a supported scenario, so the fact that
-	// allowMultipleInstances won't work in that situation isn't a bug.
-	auto windowName = VersionHelper::GetVersion().GetString();
-
-	if (!overriddenWindowName.empty())
-	{
-		CHECK(IsInTest());
-		windowName = overriddenWindowName;
-	}
+	auto windowName = GetWindowName(overriddenWindowName);
 
 	HWND existingWindow = FindWindowEx(HWND_MESSAGE, nullptr,
 		MessageWindowHelper::MESSAGE_CLASS_NAME, windowName.c_str());
@@ -58,7 +57,7 @@ bool ProcessManager::InitializeCurrentProcess(const CommandLine::Settings *comma
 			return false;
 		}
 
-		if (!config->allowMultipleInstances)
+		if (!config->allowMultipleInstances.get())
 		{
 			AttemptToNotifyExistingProcess(existingWindow, commandLineSettings->directories);
 			return false;
@@ -69,9 +68,74 @@ bool ProcessManager::InitializeCurrentProcess(const CommandLine::Settings *comma
 	m_messageWindowSubclass = std::make_unique<WindowSubclass>(m_messageWindow.get(),
 		std::bind_front(&ProcessManager::MessageWindowProc, this));
 
+	m_allowMultipleInstances = config->allowMultipleInstances.get();
+	m_allowMultipleInstancesConnection = config->allowMultipleInstances.addObserver(
+		[this](bool allowMultipleInstances)
+		{ m_allowMultipleInstances = allowMultipleInstances; });
+
+	// If multiple instances are allowed, another instance may already own the pipe, in which case
+	// this will fail. New processes will then only be able to hand off to the other instance.
+	m_handoffServer = InstanceHandoffServer::Create(GetHandoffPipeName(windowName),
+		std::bind_front(&ProcessManager::ShouldAcceptHandoffRequest, this),
+		std::bind_front(&ProcessManager::OnHandoffBatch, this));
+
 	return true;
 }
 
+bool ProcessManager::AttemptHandOffToExistingProcess(
+	const CommandLine::Settings *commandLineSettings, const std::wstring &overriddenWindowName)
+{
+	InstanceHandoffRequest request;
+	request.jumplistNewTab = commandLineSettings->jumplistNewTab;
+
+	// As with the WM_COPYDATA notification, the jump list task always opens the default folder.
+	if (!request.jumplistNewTab)
+	{
+		request.directories = commandLineSettings->directories;
+	}
+
+	auto status = SendInstanceHandoffRequest(
+		GetHandoffPipeName(GetWindowName(overriddenWindowName)), request, HANDOFF_TIMEOUT,
+		[](uint32_t serverProcessId)
+		{
+			// The existing process will activate its window once the request has been handled,
+			// which it's only allowed to do if this process grants it permission.
+			if (serverProcessId != 0)
+			{
+				AllowSetForegroundWindow(serverProcessId);
+			}
+		});
+
+	return status == InstanceHandoffStatus::Accepted;
+}
+
+std::wstring ProcessManager::GetWindowName(const std::wstring &overriddenWindowName)
+{
+	if (!overriddenWindowName.empty())
+	{
+		CHECK(IsInTest());
+		return overriddenWindowName;
+	}
+
+	// Using the version number as the window name will mean that when attempting to find an
+	// existing window, only a window that's created by the current version will match. Running
+	// different versions simultaneously isn't a supported scenario, so the fact that
+	// allowMultipleInstances won't work in that situation isn't a bug.
+	return VersionHelper::GetVersion().GetString();
+}
+
+std::wstring ProcessManager::GetHandoffPipeName(const std::wstring &windowName)
+{
+	DWORD sessionId;
+
+	if (!ProcessIdToSessionId(GetCurrentProcessId(), &sessionId))
+	{
+		sessionId = 0;
+	}
+
+	return GetInstanceHandoffPipeName(windowName, sessionId);
+}
+
 LRESULT ProcessManager::MessageWindowProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam)
 {
 	switch (msg)
@@ -79,6 +143,10 @@ LRESULT ProcessManager::MessageWindowProc(HWND hwnd, UINT msg, WPARAM wParam, LP
 	case WM_COPYDATA:
 		OnCopyData(reinterpret_cast<COPYDATASTRUCT *>(lParam));
 		return TRUE;
+
+	case WM_APP_HANDOFF_REQUESTS_QUEUED:
+		OnHandoffRequestsQueued();
+		return 0;
 	}
 
 	return DefSubclassProc(hwnd, msg, wParam, lParam);
@@ -136,3 +204,58 @@ void ProcessManager::AttemptToNotifyExistingProcess(HWND existingWindow,
 		SendMessage(existingWindow, WM_COPYDATA, NULL, reinterpret_cast<LPARAM>(&cds));
 	}
 }
+
+bool ProcessManager::ShouldAcceptHandoffRequest(const InstanceHandoffRequest &request) const
+{
+	// This mirrors the checks made by InitializeCurrentProcess(). A declined request results in
+	// the new process starting up normally.
+	return request.jumplistNewTab || !m_allowMultipleInstances;
+}
+
+void ProcessManager::OnHandoffBatch(std::vector<InstanceHandoffRequest> batch)
+{
+	{
+		std::scoped_lock lock(m_handoffRequestsMutex);
+		m_queuedHandoffRequests.insert(m_queuedHandoffRequests.end(),
+			std::make_move_iterator(batch.begin()), std::make_move_iterator(batch.end()));
+	}
+
+	// The requests have to be handled on the UI thread. If that thread is busy, multiple batches
+	// may be queued by the time it processes this message, in which case they'll all be handled
+	// together.
+	PostMessage(m_messageWindow.get(), WM_APP_HANDOFF_REQUESTS_QUEUED, 0, 0);
+}
+
+void ProcessManager::OnHandoffRequestsQueued()
+{
+	std::vector<InstanceHandoffRequest> requests;
+
+	{
+		std::scoped_lock lock(m_handoffRequestsMutex);
+		requests = std::exchange(m_queuedHandoffRequests, {});
+	}
+
+	auto *browser = m_browserList->GetLastActive();
+
+	if (!browser || requests.empty())
+	{
+		return;
+	}
+
+	for (const auto &request : requests)
+	{
+		if (request.directories.empty())
+		{
+			browser->OpenDefaultItem(OpenFolderDisposition::NewTabDefault);
+			continue;
+		}
+
+		for (const auto &directory : request.directories)
+		{
+			browser->OpenItem(directory, OpenFolderDisposition::NewTabDefault);
+		}
+	}
+
+	// The window is only activated once for the entire batch.
+	browser->Activate();
+}
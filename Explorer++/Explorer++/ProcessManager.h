@@ -4,9 +4,15 @@
 
 #pragma once
 
+#include "InstanceHandoff.h"
 #include <boost/core/noncopyable.hpp>
+#include <boost/signals2.hpp>
 #include <wil/resource.h>
+#include <atomic>
 #include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
 
 namespace CommandLine
 {
@@ -27,10 +33,26 @@ public:
 	bool InitializeCurrentProcess(const CommandLine::Settings *commandLineSettings,
 		const Config *config, const std::wstring &overriddenWindowName = L"");
 
+	// Attempts to hand the command line off to an existing process, over that process' handoff
+	// pipe. This doesn't depend on any of the application's state, so it can be called before the
+	// application has been initialized. Returns true if the existing process accepted the
+	// request, in which case the current process can exit.
+	static bool AttemptHandOffToExistingProcess(const CommandLine::Settings *commandLineSettings,
+		const std::wstring &overriddenWindowName = L"");
+
 private:
+	static constexpr UINT WM_APP_HANDOFF_REQUESTS_QUEUED = WM_APP + 1;
+
+	static std::wstring GetWindowName(const std::wstring &overriddenWindowName);
+	static std::wstring GetHandoffPipeName(const std::wstring &windowName);
+
 	LRESULT MessageWindowProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam);
 	void OnCopyData(const COPYDATASTRUCT *cds);
 
+	bool ShouldAcceptHandoffRequest(const InstanceHandoffRequest &request) const;
+	void OnHandoffBatch(std::vector<InstanceHandoffRequest> batch);
+	void OnHandoffRequestsQueued();
+
 	void AttemptToNotifyExistingProcess(HWND existingWindow,
 		const std::vector<std::wstring> &directories = {});
 
@@ -38,4 +60,16 @@ private:
 	bool m_initializationRun = false;
 	wil::unique_hwnd m_messageWindow;
 	std::unique_ptr<WindowSubclass> m_messageWindowSubclass;
+
+	// Handoff requests are checked on a background thread, so the value of the
+	// allowMultipleInstances setting is mirrored here.
+	std::atomic<bool> m_allowMultipleInstances = true;
+	boost::signals2::scoped_connection m_allowMultipleInstancesConnection;
+
+	std::mutex m_handoffRequestsMutex;
+	std::vector<InstanceHandoffRequest> m_queuedHandoffRequests;
+
+	// The server calls back into this class from its own threads, so it needs to be destroyed
+	// first.
+	std::unique_ptr<InstanceHandoffServer> m_handoffServer;
 };
@@ -11,6 +11,7 @@
 #include "DefaultColumnRegistryStorage.h"
 #include "DialogHelper.h"
 #include "FrequentLocationsRegistryStorage.h"
+#include "PluginColumnSlotRegistryStorage.h"
 #include "MainRebarStorage.h"
 #include "TabStorage.h"
 #include "WindowRegistryStorage.h"
@@ -61,6 +62,11 @@ void RegistryAppStorage::LoadFrequentLocations(FrequentLocationsModel *frequentL
 	FrequentLocationsRegistryStorage::Load(m_applicationKey.get(), frequentLocationsModel);
 }
 
+void RegistryAppStorage::LoadPluginColumnSlots(Plugins::PluginColumnRegistry *pluginColumnRegistry)
+{
+	PluginColumnSlotRegistryStorage::Load(m_applicationKey.get(), pluginColumnRegistry);
+}
+
 void RegistryAppStorage::SaveConfig(const Config &config)
 {
 	ConfigRegistryStorage::Save(m_applicationKey.get(), config);
@@ -101,6 +107,12 @@ void RegistryAppStorage::SaveFrequentLocations(const FrequentLocationsModel *fre
 	FrequentLocationsRegistryStorage::Save(m_applicationKey.get(), frequentLocationsModel);
 }
 
+void RegistryAppStorage::SavePluginColumnSlots(
+	const Plugins::PluginColumnRegistry *pluginColumnRegistry)
+{
+	PluginColumnSlotRegistryStorage::Save(m_applicationKey.get(), pluginColumnRegistry);
+}
+
 void RegistryAppStorage::Commit()
 {
 }
@@ -9,9 +9,11 @@
 using namespace std::chrono_literals;
 
 Runtime::Runtime(std::shared_ptr<concurrencpp::executor> uiThreadExecutor,
-	std::shared_ptr<concurrencpp::executor> comStaExecutor) :
+	std::shared_ptr<concurrencpp::executor> comStaExecutor,
+	std::shared_ptr<concurrencpp::executor> backgroundJobExecutor) :
 	m_uiThreadExecutor(uiThreadExecutor),
 	m_comStaExecutor(comStaExecutor),
+	m_backgroundJobExecutor(backgroundJobExecutor),
 	m_inlineExecutor(std::make_shared<concurrencpp::inline_executor>()),
 	m_timerQueue(std::make_shared<concurrencpp::timer_queue>(120s)),
 	m_uiThreadId(UniqueThreadId::GetForCurrentThread())
@@ -22,6 +24,7 @@ Runtime::~Runtime()
 {
 	m_uiThreadExecutor->shutdown();
 	m_comStaExecutor->shutdown();
+	m_backgroundJobExecutor->shutdown();
 	m_inlineExecutor->shutdown();
 	m_timerQueue->shutdown();
 }
@@ -36,6 +39,11 @@ std::shared_ptr<concurrencpp::executor> Runtime::GetComStaExecutor() const
 	return m_comStaExecutor;
 }
 
+std::shared_ptr<concurrencpp::executor> Runtime::GetBackgroundJobExecutor() const
+{
+	return m_backgroundJobExecutor;
+}
+
 std::shared_ptr<concurrencpp::inline_executor> Runtime::GetInlineExecutor() const
 {
 	return m_inlineExecutor;
@@ -14,11 +14,17 @@ class Runtime : private boost::noncopyable
 public:
 	// Initializes the Runtime instance. This should be called from the UI thread.
 	Runtime(std::shared_ptr<concurrencpp::executor> uiThreadExecutor,
-		std::shared_ptr<concurrencpp::executor> comStaExecutor);
+		std::shared_ptr<concurrencpp::executor> comStaExecutor,
+		std::shared_ptr<concurrencpp::executor> backgroundJobExecutor);
 	~Runtime();
 
 	std::shared_ptr<concurrencpp::executor> GetUiThreadExecutor() const;
 	std::shared_ptr<concurrencpp::executor> GetComStaExecutor() const;
+
+	// Used for jobs that can run for an extended period of time (e.g. anything that recursively
+	// walks a directory tree). The threads in this executor are COM STA threads.
+	std::shared_ptr<concurrencpp::executor> GetBackgroundJobExecutor() const;
+
 	std::shared_ptr<concurrencpp::inline_executor> GetInlineExecutor() const;
 	std::shared_ptr<concurrencpp::timer_queue> GetTimerQueue() const;
 	bool IsUiThread() const;
@@ -26,6 +32,7 @@ public:
 private:
 	const std::shared_ptr<concurrencpp::executor> m_uiThreadExecutor;
 	const std::shared_ptr<concurrencpp::executor> m_comStaExecutor;
+	const std::shared_ptr<concurrencpp::executor> m_backgroundJobExecutor;
 	const std::shared_ptr<concurrencpp::inline_executor> m_inlineExecutor;
 	const std::shared_ptr<concurrencpp::timer_queue> m_timerQueue;
 	const UniqueThreadId m_uiThreadId;
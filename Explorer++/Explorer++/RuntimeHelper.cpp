@@ -20,3 +20,24 @@
 {
 	co_await concurrencpp::resume_on(runtime->GetComStaExecutor());
 }
+
+[[nodiscard]] concurrencpp::lazy_result<void> ResumeOnBackgroundJobThread(const Runtime *runtime)
+{
+	co_await concurrencpp::resume_on(runtime->GetBackgroundJobExecutor());
+}
+
+std::function<void(std::function<void()> task)> MakeUiThreadScheduler(const Runtime *runtime)
+{
+	return [executor = runtime->GetUiThreadExecutor()](std::function<void()> task)
+	{
+		try
+		{
+			executor->post(std::move(task));
+		}
+		catch (const concurrencpp::errors::runtime_shutdown &)
+		{
+			// The application is shutting down, so there's nothing that needs to be done with the
+			// task.
+		}
+	};
+}
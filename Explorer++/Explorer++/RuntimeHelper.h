@@ -5,8 +5,15 @@
 #pragma once
 
 #include <concurrencpp/concurrencpp.h>
+#include <functional>
 
 class Runtime;
 
 [[nodiscard]] concurrencpp::lazy_result<void> ResumeOnUiThread(const Runtime *runtime);
 [[nodiscard]] concurrencpp::lazy_result<void> ResumeOnComStaThread(const Runtime *runtime);
+[[nodiscard]] concurrencpp::lazy_result<void> ResumeOnBackgroundJobThread(const Runtime *runtime);
+
+// Returns a function that can be called from any thread to schedule a task on the UI thread. This
+// is suitable for use as a ResultChannel scheduler. Tasks scheduled after the runtime has been shut
+// down are dropped.
+std::function<void(std::function<void()> task)> MakeUiThreadScheduler(const Runtime *runtime);
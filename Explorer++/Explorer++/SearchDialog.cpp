@@ -7,6 +7,7 @@
 #include "BrowserWindow.h"
 #include "CoreInterface.h"
 #include "DialogConstants.h"
+#include "FileNameIndexService.h"
 #include "IconResourceLoader.h"
 #include "MainResource.h"
 #include "ResourceHelper.h"
@@ -25,6 +26,7 @@
 #include "../Helper/XMLSettings.h"
 #include <algorithm>
 #include <regex>
+#include <thread>
 
 namespace NSearchDialog
 {
@@ -46,6 +48,7 @@ const TCHAR SearchDialogPersistentSettings::SETTING_COLUMN_WIDTH_2[] = _T("Colum
 const TCHAR SearchDialogPersistentSettings::SETTING_SEARCH_DIRECTORY_TEXT[] =
 	_T("SearchDirectoryText");
 const TCHAR SearchDialogPersistentSettings::SETTING_SEARCH_SUB_FOLDERS[] = _T("SearchSubFolders");
+const TCHAR SearchDialogPersistentSettings::SETTING_SEARCH_EVERYWHERE[] = _T("SearchEverywhere");
 const TCHAR SearchDialogPersistentSettings::SETTING_USE_REGULAR_EXPRESSIONS[] =
 	_T("UseRegularExpressions");
 const TCHAR SearchDialogPersistentSettings::SETTING_CASE_INSENSITIVE[] = _T("CaseInsensitive");
@@ -60,21 +63,24 @@ const TCHAR SearchDialogPersistentSettings::SETTING_PATTERN_LIST[] = _T("Pattern
 
 SearchDialog::SearchDialog(HINSTANCE resourceInstance, HWND hParent, ThemeManager *themeManager,
 	std::wstring_view searchDirectory, BrowserWindow *browserWindow, CoreInterface *coreInterface,
-	TabContainerImpl *tabContainerImpl, const IconResourceLoader *iconResourceLoader) :
+	TabContainerImpl *tabContainerImpl, const IconResourceLoader *iconResourceLoader,
+	FileNameIndexService *fileNameIndexService) :
 	ThemedDialog(resourceInstance, IDD_SEARCH, hParent, DialogSizingType::Both, themeManager),
 	m_searchDirectory(searchDirectory),
 	m_browserWindow(browserWindow),
 	m_coreInterface(coreInterface),
 	m_tabContainerImpl(tabContainerImpl),
 	m_iconResourceLoader(iconResourceLoader),
+	m_fileNameIndexService(fileNameIndexService),
 	m_bSearching(FALSE),
 	m_bStopSearching(FALSE),
 	m_pSearch(nullptr),
-	m_iInternalIndex(0),
 	m_iPreviousSelectedColumn(-1),
 	m_bSetSearchTimer(TRUE)
 {
 	m_persistentSettings = &SearchDialogPersistentSettings::GetInstance();
+
+	ApplyResultsSort();
 }
 
 SearchDialog::~SearchDialog()
@@ -129,6 +135,7 @@ INT_PTR SearchDialog::OnInitDialog()
 	lCheckDlgButton(m_hDlg, IDC_CHECK_READONLY, m_persistentSettings->m_bReadOnly);
 	lCheckDlgButton(m_hDlg, IDC_CHECK_SYSTEM, m_persistentSettings->m_bSystem);
 	lCheckDlgButton(m_hDlg, IDC_CHECK_SEARCHSUBFOLDERS, m_persistentSettings->m_bSearchSubFolders);
+	lCheckDlgButton(m_hDlg, IDC_CHECK_SEARCHEVERYWHERE, m_persistentSettings->m_bSearchEverywhere);
 	lCheckDlgButton(m_hDlg, IDC_CHECK_CASEINSENSITIVE, m_persistentSettings->m_bCaseInsensitive);
 	lCheckDlgButton(m_hDlg, IDC_CHECK_USEREGULAREXPRESSIONS,
 		m_persistentSettings->m_bUseRegularExpressions);
@@ -151,6 +158,8 @@ INT_PTR SearchDialog::OnInitDialog()
 	ComboBox::CreateNew(GetDlgItem(m_hDlg, IDC_COMBO_NAME));
 	ComboBox::CreateNew(GetDlgItem(m_hDlg, IDC_COMBO_DIRECTORY));
 
+	UpdateSearchLocationControls();
+
 	if (m_persistentSettings->m_bStateSaved)
 	{
 		/* These dummy values will be in use if these values
@@ -203,12 +212,22 @@ INT_PTR SearchDialog::OnCommand(WPARAM wParam, LPARAM lParam)
 {
 	UNREFERENCED_PARAMETER(lParam);
 
+	if (HIWORD(wParam) == CBN_EDITCHANGE && LOWORD(wParam) == IDC_COMBO_NAME)
+	{
+		OnNameEdited();
+		return 0;
+	}
+
 	switch (LOWORD(wParam))
 	{
 	case IDSEARCH:
 		OnSearch();
 		break;
 
+	case IDC_CHECK_SEARCHEVERYWHERE:
+		OnSearchEverywhereClicked();
+		break;
+
 	case IDC_BUTTON_DIRECTORY:
 	{
 		BROWSEINFO bi;
@@ -269,9 +288,12 @@ int CALLBACK NSearchDialog::BrowseCallbackProc(HWND hwnd, UINT uMsg, LPARAM lPar
 
 void SearchDialog::OnSearch()
 {
+	KillTimer(m_hDlg, INSTANT_SEARCH_TIMER_ID);
+	m_instantSearchPending = false;
+
 	if (!m_bSearching)
 	{
-		StartSearching();
+		StartSearching(true);
 	}
 	else
 	{
@@ -279,13 +301,65 @@ void SearchDialog::OnSearch()
 	}
 }
 
-void SearchDialog::StartSearching()
+void SearchDialog::OnSearchEverywhereClicked()
 {
+	UpdateSearchLocationControls();
+}
+
+void SearchDialog::UpdateSearchLocationControls()
+{
+	// The location is ignored when searching everywhere, since every indexed drive is searched.
+	bool searchEverywhere = IsDlgButtonChecked(m_hDlg, IDC_CHECK_SEARCHEVERYWHERE) == BST_CHECKED;
+	EnableWindow(GetDlgItem(m_hDlg, IDC_COMBO_DIRECTORY), !searchEverywhere);
+	EnableWindow(GetDlgItem(m_hDlg, IDC_BUTTON_DIRECTORY), !searchEverywhere);
+	EnableWindow(GetDlgItem(m_hDlg, IDC_CHECK_SEARCHSUBFOLDERS), !searchEverywhere);
+}
+
+void SearchDialog::OnNameEdited()
+{
+	if (IsDlgButtonChecked(m_hDlg, IDC_CHECK_SEARCHEVERYWHERE) != BST_CHECKED)
+	{
+		return;
+	}
+
+	// Searching everywhere only queries the index, so the results can be updated as the name is
+	// typed. The timer is reset on each change, so that a search isn't started for every
+	// character.
+	SetTimer(m_hDlg, INSTANT_SEARCH_TIMER_ID, INSTANT_SEARCH_TIMER_ELAPSED, nullptr);
+}
+
+void SearchDialog::OnInstantSearchTimer()
+{
+	KillTimer(m_hDlg, INSTANT_SEARCH_TIMER_ID);
+
+	if (m_bSearching)
+	{
+		// The new search will be started once the current one has finished.
+		m_instantSearchPending = true;
+		StopSearching();
+		return;
+	}
+
+	StartSearching(false);
+}
+
+void SearchDialog::StartSearching(bool saveHistory)
+{
+	BOOL bSearchEverywhere = IsDlgButtonChecked(m_hDlg, IDC_CHECK_SEARCHEVERYWHERE) == BST_CHECKED;
+
+	if (bSearchEverywhere && !m_fileNameIndexService->IsReady())
+	{
+		auto message =
+			ResourceHelper::LoadString(GetResourceInstance(), IDS_SEARCH_INDEX_NOT_READY);
+		SetDlgItemText(m_hDlg, IDC_STATIC_STATUS, message.c_str());
+		return;
+	}
+
 	ShowWindow(GetDlgItem(m_hDlg, IDC_LINK_STATUS), SW_HIDE);
 	ShowWindow(GetDlgItem(m_hDlg, IDC_STATIC_STATUS), SW_SHOW);
 
 	m_AwaitingSearchItems.clear();
-	m_SearchItemsMapInternal.clear();
+	m_resultsModel.Clear();
 
 	ListView_DeleteAllItems(GetDlgItem(m_hDlg, IDC_LISTVIEW_SEARCHRESULTS));
 
@@ -342,36 +416,30 @@ void SearchDialog::StartSearching()
 	}
 
 	m_pSearch = new Search(m_hDlg, szBaseDirectory, szSearchPattern, dwAttributes,
-		bUseRegularExpressions, bCaseInsensitive, bSearchSubFolders);
+		bUseRegularExpressions, bCaseInsensitive, bSearchSubFolders, bSearchEverywhere,
+		m_fileNameIndexService);
 	m_pSearch->AddRef();
 
 	/* Save the search directory and search pattern (only if they are not
-	the same as the most recent entry). */
-	BOOL bSaveEntry = FALSE;
-
-	if (m_persistentSettings->m_searchDirectories.empty()
-		|| lstrcmp(szBaseDirectory, m_persistentSettings->m_searchDirectories.begin()->c_str())
-			!= 0)
-	{
-		bSaveEntry = TRUE;
-	}
-
-	if (bSaveEntry)
-	{
-		SaveEntry(IDC_COMBO_DIRECTORY, m_persistentSettings->m_searchDirectories);
-	}
-
-	bSaveEntry = FALSE;
-
-	if (m_persistentSettings->m_searchPatterns.empty()
-		|| lstrcmp(szSearchPattern, m_persistentSettings->m_searchPatterns.begin()->c_str()) != 0)
-	{
-		bSaveEntry = TRUE;
-	}
+	the same as the most recent entry). Instant searches are started as the
+	name is typed, so they aren't saved. */
+	if (saveHistory)
+	{
+		if (!bSearchEverywhere
+			&& (m_persistentSettings->m_searchDirectories.empty()
+				|| lstrcmp(szBaseDirectory,
+					   m_persistentSettings->m_searchDirectories.begin()->c_str())
+					!= 0))
+		{
+			SaveEntry(IDC_COMBO_DIRECTORY, m_persistentSettings->m_searchDirectories);
+		}
 
-	if (bSaveEntry)
-	{
-		SaveEntry(IDC_COMBO_NAME, m_persistentSettings->m_searchPatterns);
+		if (m_persistentSettings->m_searchPatterns.empty()
+			|| lstrcmp(szSearchPattern, m_persistentSettings->m_searchPatterns.begin()->c_str())
+				!= 0)
+		{
+			SaveEntry(IDC_COMBO_NAME, m_persistentSettings->m_searchPatterns);
+		}
 	}
 
 	GetDlgItemText(m_hDlg, IDSEARCH, m_szSearchButton,
@@ -502,59 +570,49 @@ int CALLBACK NSearchDialog::SortResultsStub(LPARAM lParam1, LPARAM lParam2, LPAR
 
 int CALLBACK SearchDialog::SortResults(LPARAM lParam1, LPARAM lParam2)
 {
-	int iRes = 0;
+	auto index1 = m_resultsModel.GetItemIndex(static_cast<FolderModel::ItemId>(lParam1));
+	auto index2 = m_resultsModel.GetItemIndex(static_cast<FolderModel::ItemId>(lParam2));
 
-	switch (m_persistentSettings->m_SortMode)
+	if (index1 == index2)
 	{
-	case SearchDialogPersistentSettings::SortMode::Name:
-		iRes = SortResultsByName(lParam1, lParam2);
-		break;
-
-	case SearchDialogPersistentSettings::SortMode::Path:
-		iRes = SortResultsByPath(lParam1, lParam2);
-		break;
-	}
-
-	if (!m_persistentSettings->m_bSortAscending)
-	{
-		iRes = -iRes;
+		return 0;
 	}
 
-	return iRes;
+	return index1 < index2 ? -1 : 1;
 }
 
-int CALLBACK SearchDialog::SortResultsByName(LPARAM lParam1, LPARAM lParam2)
+FolderModel::Comparator SearchDialog::GetResultsComparator(
+	SearchDialogPersistentSettings::SortMode sortMode)
 {
-	auto itr1 = m_SearchItemsMapInternal.find(static_cast<int>(lParam1));
-	auto itr2 = m_SearchItemsMapInternal.find(static_cast<int>(lParam2));
-
-	TCHAR szFilename1[MAX_PATH];
-	TCHAR szFilename2[MAX_PATH];
+	switch (sortMode)
+	{
+	case SearchDialogPersistentSettings::SortMode::Name:
+		return [](const FolderModel::ItemView &item1, const FolderModel::ItemView &item2)
+		{
+			return StrCmpLogicalW(std::wstring(item1.GetDisplayName()).c_str(),
+				std::wstring(item2.GetDisplayName()).c_str());
+		};
 
-	StringCchCopy(szFilename1, std::size(szFilename1), itr1->second.c_str());
-	StringCchCopy(szFilename2, std::size(szFilename2), itr2->second.c_str());
+	case SearchDialogPersistentSettings::SortMode::Path:
+		return [](const FolderModel::ItemView &item1, const FolderModel::ItemView &item2)
+		{
+			std::wstring directory1(item1.GetParsingName());
+			std::wstring directory2(item2.GetParsingName());
+			PathRemoveFileSpec(directory1.data());
+			PathRemoveFileSpec(directory2.data());
 
-	PathStripPath(szFilename1);
-	PathStripPath(szFilename2);
+			return StrCmpLogicalW(directory1.c_str(), directory2.c_str());
+		};
+	}
 
-	return StrCmpLogicalW(szFilename1, szFilename2);
+	LOG(FATAL) << "Search sort mode not found";
+	__assume(0);
 }
 
-int CALLBACK SearchDialog::SortResultsByPath(LPARAM lParam1, LPARAM lParam2)
+void SearchDialog::ApplyResultsSort()
 {
-	auto itr1 = m_SearchItemsMapInternal.find(static_cast<int>(lParam1));
-	auto itr2 = m_SearchItemsMapInternal.find(static_cast<int>(lParam2));
-
-	TCHAR szPath1[MAX_PATH];
-	TCHAR szPath2[MAX_PATH];
-
-	StringCchCopy(szPath1, std::size(szPath1), itr1->second.c_str());
-	StringCchCopy(szPath2, std::size(szPath2), itr2->second.c_str());
-
-	PathRemoveFileSpec(szPath1);
-	PathRemoveFileSpec(szPath2);
-
-	return StrCmpLogicalW(szPath1, szPath2);
+	m_resultsModel.SetSort(GetResultsComparator(m_persistentSettings->m_SortMode),
+		!m_persistentSettings->m_bSortAscending);
 }
 
 void SearchDialog::UpdateMenuEntries(HMENU menu, PCIDLIST_ABSOLUTE pidlParent,
@@ -657,10 +715,11 @@ INT_PTR SearchDialog::OnNotify(NMHDR *pnmhdr)
 
 				if (bRet)
 				{
-					auto itr = m_SearchItemsMapInternal.find(static_cast<int>(lvItem.lParam));
-					CHECK(itr != m_SearchItemsMapInternal.end());
+					auto item =
+						m_resultsModel.GetItem(static_cast<FolderModel::ItemId>(lvItem.lParam));
+					std::wstring fullFileName(item.GetParsingName());
 
-					m_browserWindow->OpenItem(itr->second.c_str());
+					m_browserWindow->OpenItem(fullFileName.c_str());
 				}
 			}
 		}
@@ -694,11 +753,12 @@ INT_PTR SearchDialog::OnNotify(NMHDR *pnmhdr)
 
 				if (bRet)
 				{
-					auto itr = m_SearchItemsMapInternal.find(static_cast<int>(lvItem.lParam));
-					CHECK(itr != m_SearchItemsMapInternal.end());
+					auto item =
+						m_resultsModel.GetItem(static_cast<FolderModel::ItemId>(lvItem.lParam));
+					std::wstring fullFileName(item.GetParsingName());
 
 					unique_pidl_absolute pidlFull;
-					HRESULT hr = SHParseDisplayName(itr->second.c_str(), nullptr,
+					HRESULT hr = SHParseDisplayName(fullFileName.c_str(), nullptr,
 						wil::out_param(pidlFull), 0, nullptr);
 
 					if (hr == S_OK)
@@ -753,6 +813,10 @@ INT_PTR SearchDialog::OnNotify(NMHDR *pnmhdr)
 			== m_persistentSettings->m_SortMode)
 		{
 			m_persistentSettings->m_bSortAscending = !m_persistentSettings->m_bSortAscending;
+
+			// Only the direction has changed, so the model doesn't need to compare the items
+			// again.
+			m_resultsModel.SetSortDescending(!m_persistentSettings->m_bSortAscending);
 		}
 		else
 		{
@@ -760,6 +824,8 @@ INT_PTR SearchDialog::OnNotify(NMHDR *pnmhdr)
 				m_persistentSettings->m_Columns[pnmlv->iSubItem].sortMode;
 			m_persistentSettings->m_bSortAscending =
 				m_persistentSettings->m_Columns[pnmlv->iSubItem].bSortAscending;
+
+			ApplyResultsSort();
 		}
 
 		ListView_SortItems(GetDlgItem(m_hDlg, IDC_LISTVIEW_SEARCHRESULTS),
@@ -825,6 +891,12 @@ INT_PTR SearchDialog::OnPrivateMessage(UINT uMsg, WPARAM wParam, LPARAM lParam)
 		m_bSearching = FALSE;
 		m_bStopSearching = FALSE;
 		SetDlgItemText(m_hDlg, IDSEARCH, m_szSearchButton);
+
+		if (m_instantSearchPending)
+		{
+			m_instantSearchPending = false;
+			StartSearching(false);
+		}
 	}
 	break;
 
@@ -864,6 +936,12 @@ INT_PTR SearchDialog::OnPrivateMessage(UINT uMsg, WPARAM wParam, LPARAM lParam)
 		m_bSearching = FALSE;
 		m_bStopSearching = FALSE;
 		SetDlgItemText(m_hDlg, IDSEARCH, m_szSearchButton);
+
+		if (m_instantSearchPending)
+		{
+			m_instantSearchPending = false;
+			StartSearching(false);
+		}
 	}
 	break;
 	}
@@ -873,13 +951,18 @@ INT_PTR SearchDialog::OnPrivateMessage(UINT uMsg, WPARAM wParam, LPARAM lParam)
 
 INT_PTR SearchDialog::OnTimer(int iTimerID)
 {
+	if (iTimerID == INSTANT_SEARCH_TIMER_ID)
+	{
+		OnInstantSearchTimer();
+		return 0;
+	}
+
 	if (iTimerID != SEARCH_PROCESSITEMS_TIMER_ID)
 	{
 		return 1;
 	}
 
 	HWND hListView = GetDlgItem(m_hDlg, IDC_LISTVIEW_SEARCHRESULTS);
-	int nListViewItems = ListView_GetItemCount(hListView);
 
 	int nItems =
 		std::min(static_cast<int>(m_AwaitingSearchItems.size()), SEARCH_MAX_ITEMS_BATCH_PROCESS);
@@ -907,15 +990,17 @@ INT_PTR SearchDialog::OnTimer(int iTimerID)
 
 		SHGetFileInfo((LPCWSTR) pidl, 0, &shfi, sizeof(shfi), SHGFI_PIDL | SHGFI_SYSICONINDEX);
 
-		m_SearchItemsMapInternal.insert(
-			std::unordered_map<int, std::wstring>::value_type(m_iInternalIndex, fullFileName));
+		// Each result is inserted at the position the model places it at, so the results stay
+		// sorted as they're found.
+		auto id = m_resultsModel.InsertItem(
+			{ .parsingName = fullFileName, .displayName = fileName });
 
 		lvItem.mask = LVIF_IMAGE | LVIF_TEXT | LVIF_PARAM;
 		lvItem.pszText = fileName.data();
-		lvItem.iItem = nListViewItems + i;
+		lvItem.iItem = static_cast<int>(m_resultsModel.GetItemIndex(id));
 		lvItem.iSubItem = 0;
 		lvItem.iImage = shfi.iIcon;
-		lvItem.lParam = m_iInternalIndex++;
+		lvItem.lParam = id;
 		iIndex = ListView_InsertItem(hListView, &lvItem);
 
 		ListView_SetItemText(hListView, iIndex, 1, directory);
@@ -957,13 +1042,16 @@ DWORD WINAPI NSearchDialog::SearchThread(LPVOID pParam)
 }
 
 Search::Search(HWND hDlg, TCHAR *szBaseDirectory, TCHAR *szPattern, DWORD dwAttributes,
-	BOOL bUseRegularExpressions, BOOL bCaseInsensitive, BOOL bSearchSubFolders)
+	BOOL bUseRegularExpressions, BOOL bCaseInsensitive, BOOL bSearchSubFolders,
+	BOOL bSearchEverywhere, FileNameIndexService *fileNameIndexService)
 {
 	m_hDlg = hDlg;
 	m_dwAttributes = dwAttributes;
 	m_bUseRegularExpressions = bUseRegularExpressions;
 	m_bCaseInsensitive = bCaseInsensitive;
 	m_bSearchSubFolders = bSearchSubFolders;
+	m_bSearchEverywhere = bSearchEverywhere;
+	m_fileNameIndexService = fileNameIndexService;
 
 	StringCchCopy(m_szBaseDirectory, std::size(m_szBaseDirectory), szBaseDirectory);
 	StringCchCopy(m_szSearchPattern, std::size(m_szSearchPattern), szPattern);
@@ -1003,7 +1091,10 @@ void Search::StartSearching()
 		}
 	}
 
-	SearchDirectory(m_szBaseDirectory);
+	if (!SearchIndex())
+	{
+		SearchDirectory(m_szBaseDirectory);
+	}
 
 	SendMessage(m_hDlg, NSearchDialog::WM_APP_SEARCHFINISHED, 0,
 		MAKELPARAM(m_iFoldersFound, m_iFilesFound));
@@ -1011,6 +1102,83 @@ void Search::StartSearching()
 	Release();
 }
 
+/* Searches using the filename index, which is used whenever it
+covers the whole search. Returns false if the index can't be
+used, in which case the directory will be searched directly. */
+bool Search::SearchIndex()
+{
+	if (!m_bSearchEverywhere
+		&& (!m_bSearchSubFolders || !m_fileNameIndexService->IsFolderIndexed(m_szBaseDirectory)))
+	{
+		return false;
+	}
+
+	FileNameQuery query;
+	query.pattern = m_szSearchPattern;
+	query.matchType =
+		m_bUseRegularExpressions ? FileNameMatchType::Regex : FileNameMatchType::Wildcard;
+	query.caseSensitive = !m_bCaseInsensitive;
+	query.requiredAttributes = m_dwAttributes;
+	query.maxResults = INDEX_MAX_RESULTS;
+	query.numThreads = std::max(static_cast<int>(std::thread::hardware_concurrency()), 1);
+
+	if (!m_bSearchEverywhere)
+	{
+		query.scopePath = m_szBaseDirectory;
+	}
+
+	std::optional<std::vector<FileNameQueryResult>> results;
+
+	try
+	{
+		results = m_fileNameIndexService->Query(query, m_stopSource.get_token());
+	}
+	catch (const std::regex_error &)
+	{
+		/* The pattern has already been validated, though the
+		index may still treat it differently. */
+		return m_bSearchEverywhere;
+	}
+
+	if (!results)
+	{
+		return m_bSearchEverywhere;
+	}
+
+	for (const auto &result : *results)
+	{
+		if (m_stopSource.stop_requested())
+		{
+			break;
+		}
+
+		unique_pidl_absolute pidl;
+		HRESULT hr =
+			SHParseDisplayName(result.path.c_str(), nullptr, wil::out_param(pidl), 0, nullptr);
+
+		/* The index can be slightly out of date, so items that no
+		longer exist are skipped. */
+		if (FAILED(hr))
+		{
+			continue;
+		}
+
+		if (result.item.isFolder)
+		{
+			m_iFoldersFound++;
+		}
+		else
+		{
+			m_iFilesFound++;
+		}
+
+		PostMessage(m_hDlg, NSearchDialog::WM_APP_SEARCHITEMFOUND,
+			reinterpret_cast<WPARAM>(pidl.release()), 0);
+	}
+
+	return true;
+}
+
 void Search::SearchDirectory(const TCHAR *szDirectory)
 {
 	SendMessage(m_hDlg, NSearchDialog::WM_APP_SEARCHCHANGEDDIRECTORY,
@@ -1156,6 +1324,8 @@ void Search::StopSearching()
 	EnterCriticalSection(&m_csStop);
 	m_bStopSearching = TRUE;
 	LeaveCriticalSection(&m_csStop);
+
+	m_stopSource.request_stop();
 }
 
 void SearchDialog::SaveState()
@@ -1173,6 +1343,9 @@ void SearchDialog::SaveState()
 	m_persistentSettings->m_bSearchSubFolders =
 		IsDlgButtonChecked(m_hDlg, IDC_CHECK_SEARCHSUBFOLDERS) == BST_CHECKED;
 
+	m_persistentSettings->m_bSearchEverywhere =
+		IsDlgButtonChecked(m_hDlg, IDC_CHECK_SEARCHEVERYWHERE) == BST_CHECKED;
+
 	m_persistentSettings->m_bArchive = IsDlgButtonChecked(m_hDlg, IDC_CHECK_ARCHIVE) == BST_CHECKED;
 
 	m_persistentSettings->m_bHidden = IsDlgButtonChecked(m_hDlg, IDC_CHECK_HIDDEN) == BST_CHECKED;
@@ -1198,6 +1371,7 @@ SearchDialogPersistentSettings::SearchDialogPersistentSettings() :
 	m_searchDirectories(DialogConstants::DEFAULT_HISTORY_SIZE)
 {
 	m_bSearchSubFolders = TRUE;
+	m_bSearchEverywhere = FALSE;
 	m_bUseRegularExpressions = FALSE;
 	m_bCaseInsensitive = FALSE;
 	m_bArchive = FALSE;
@@ -1234,6 +1408,7 @@ void SearchDialogPersistentSettings::SaveExtraRegistrySettings(HKEY hKey)
 	RegistrySettings::SaveDword(hKey, SETTING_COLUMN_WIDTH_2, m_iColumnWidth2);
 	RegistrySettings::SaveString(hKey, SETTING_SEARCH_DIRECTORY_TEXT, m_searchPattern);
 	RegistrySettings::SaveDword(hKey, SETTING_SEARCH_SUB_FOLDERS, m_bSearchSubFolders);
+	RegistrySettings::SaveDword(hKey, SETTING_SEARCH_EVERYWHERE, m_bSearchEverywhere);
 	RegistrySettings::SaveDword(hKey, SETTING_USE_REGULAR_EXPRESSIONS, m_bUseRegularExpressions);
 	RegistrySettings::SaveDword(hKey, SETTING_CASE_INSENSITIVE, m_bCaseInsensitive);
 	RegistrySettings::SaveDword(hKey, SETTING_ARCHIVE, m_bArchive);
@@ -1259,6 +1434,8 @@ void SearchDialogPersistentSettings::LoadExtraRegistrySettings(HKEY hKey)
 	RegistrySettings::ReadString(hKey, SETTING_SEARCH_DIRECTORY_TEXT, m_searchPattern);
 	RegistrySettings::Read32BitValueFromRegistry(hKey, SETTING_SEARCH_SUB_FOLDERS,
 		m_bSearchSubFolders);
+	RegistrySettings::Read32BitValueFromRegistry(hKey, SETTING_SEARCH_EVERYWHERE,
+		m_bSearchEverywhere);
 	RegistrySettings::Read32BitValueFromRegistry(hKey, SETTING_USE_REGULAR_EXPRESSIONS,
 		m_bUseRegularExpressions);
 	RegistrySettings::Read32BitValueFromRegistry(hKey, SETTING_CASE_INSENSITIVE,
@@ -1293,6 +1470,8 @@ void SearchDialogPersistentSettings::SaveExtraXMLSettings(IXMLDOMDocument *pXMLD
 		m_searchPattern.c_str());
 	XMLSettings::AddAttributeToNode(pXMLDom, pParentNode, SETTING_SEARCH_SUB_FOLDERS,
 		XMLSettings::EncodeBoolValue(m_bSearchSubFolders));
+	XMLSettings::AddAttributeToNode(pXMLDom, pParentNode, SETTING_SEARCH_EVERYWHERE,
+		XMLSettings::EncodeBoolValue(m_bSearchEverywhere));
 	XMLSettings::AddAttributeToNode(pXMLDom, pParentNode, SETTING_USE_REGULAR_EXPRESSIONS,
 		XMLSettings::EncodeBoolValue(m_bUseRegularExpressions));
 	XMLSettings::AddAttributeToNode(pXMLDom, pParentNode, SETTING_CASE_INSENSITIVE,
@@ -1338,6 +1517,10 @@ void SearchDialogPersistentSettings::LoadExtraXMLSettings(BSTR bstrName, BSTR bs
 	{
 		m_bSearchSubFolders = XMLSettings::DecodeBoolValue(bstrValue);
 	}
+	else if (lstrcmpi(bstrName, SETTING_SEARCH_EVERYWHERE) == 0)
+	{
+		m_bSearchEverywhere = XMLSettings::DecodeBoolValue(bstrValue);
+	}
 	else if (lstrcmpi(bstrName, SETTING_USE_REGULAR_EXPRESSIONS) == 0)
 	{
 		m_bUseRegularExpressions = XMLSettings::DecodeBoolValue(bstrValue);
@@ -5,6 +5,7 @@
 #pragma once
 
 #include "ThemedDialog.h"
+#include "ShellBrowser/FolderModel.h"
 #include "../Helper/DialogSettings.h"
 #include "../Helper/ReferenceCount.h"
 #include "../Helper/ShellContextMenu.h"
@@ -13,12 +14,13 @@
 #include <objbase.h>
 #include <list>
 #include <regex>
+#include <stop_token>
 #include <string>
-#include <unordered_map>
 #include <vector>
 
 class BrowserWindow;
 class CoreInterface;
+class FileNameIndexService;
 class IconResourceLoader;
 class SearchDialog;
 class TabContainerImpl;
@@ -38,6 +40,7 @@ private:
 	static const TCHAR SETTING_COLUMN_WIDTH_2[];
 	static const TCHAR SETTING_SEARCH_DIRECTORY_TEXT[];
 	static const TCHAR SETTING_SEARCH_SUB_FOLDERS[];
+	static const TCHAR SETTING_SEARCH_EVERYWHERE[];
 	static const TCHAR SETTING_USE_REGULAR_EXPRESSIONS[];
 	static const TCHAR SETTING_CASE_INSENSITIVE[];
 	static const TCHAR SETTING_ARCHIVE[];
@@ -86,6 +89,7 @@ private:
 	boost::circular_buffer<std::wstring> m_searchPatterns;
 	boost::circular_buffer<std::wstring> m_searchDirectories;
 	BOOL m_bSearchSubFolders;
+	BOOL m_bSearchEverywhere;
 	BOOL m_bUseRegularExpressions;
 	BOOL m_bCaseInsensitive;
 	BOOL m_bArchive;
@@ -105,13 +109,17 @@ class Search : public ReferenceCount
 {
 public:
 	Search(HWND hDlg, TCHAR *szBaseDirectory, TCHAR *szPattern, DWORD dwAttributes,
-		BOOL bUseRegularExpressions, BOOL bCaseInsensitive, BOOL bSearchSubFolders);
+		BOOL bUseRegularExpressions, BOOL bCaseInsensitive, BOOL bSearchSubFolders,
+		BOOL bSearchEverywhere, FileNameIndexService *fileNameIndexService);
 	~Search();
 
 	void StartSearching();
 	void StopSearching();
 
 private:
+	static const size_t INDEX_MAX_RESULTS = 10000;
+
+	bool SearchIndex();
 	void SearchDirectory(const TCHAR *szDirectory);
 	void SearchDirectoryInternal(const TCHAR *szSearchDirectory,
 		std::list<std::wstring> *pSubFolderList);
@@ -124,11 +132,14 @@ private:
 	BOOL m_bUseRegularExpressions;
 	BOOL m_bCaseInsensitive;
 	BOOL m_bSearchSubFolders;
+	BOOL m_bSearchEverywhere;
+	FileNameIndexService *m_fileNameIndexService;
 
 	std::wregex m_rxPattern;
 
 	CRITICAL_SECTION m_csStop;
 	BOOL m_bStopSearching;
+	std::stop_source m_stopSource;
 
 	int m_iFoldersFound;
 	int m_iFilesFound;
@@ -140,13 +151,11 @@ public:
 	SearchDialog(HINSTANCE resourceInstance, HWND hParent, ThemeManager *themeManager,
 		std::wstring_view searchDirectory, BrowserWindow *browserWindow,
 		CoreInterface *coreInterface, TabContainerImpl *tabContainerImpl,
-		const IconResourceLoader *iconResourceLoader);
+		const IconResourceLoader *iconResourceLoader, FileNameIndexService *fileNameIndexService);
 	~SearchDialog();
 
-	/* Sorting methods. */
+	// Orders the listview items to match the display order of the results model.
 	int CALLBACK SortResults(LPARAM lParam1, LPARAM lParam2);
-	int CALLBACK SortResultsByName(LPARAM lParam1, LPARAM lParam2);
-	int CALLBACK SortResultsByPath(LPARAM lParam1, LPARAM lParam2);
 
 protected:
 	INT_PTR OnInitDialog() override;
@@ -165,17 +174,30 @@ private:
 	static const int SEARCH_PROCESSITEMS_TIMER_ELAPSED = 50;
 	static const int SEARCH_MAX_ITEMS_BATCH_PROCESS = 100;
 
+	// When searching everywhere, the search is rerun as the name is typed, once typing pauses for
+	// this long.
+	static const int INSTANT_SEARCH_TIMER_ID = 1;
+	static const int INSTANT_SEARCH_TIMER_ELAPSED = 150;
+
 	static const int OPEN_FILE_LOCATION_MENU_ITEM_ID = ShellContextMenu::MAX_SHELL_MENU_ID + 1;
 
 	std::vector<ResizableDialogControl> GetResizableControls() override;
 	void SaveState() override;
 
 	void OnSearch();
-	void StartSearching();
+	void OnSearchEverywhereClicked();
+	void OnNameEdited();
+	void OnInstantSearchTimer();
+	void UpdateSearchLocationControls();
+	void StartSearching(bool saveHistory);
 	void StopSearching();
 	void SaveEntry(int comboBoxId, boost::circular_buffer<std::wstring> &buffer);
 	void UpdateListViewHeader();
 
+	static FolderModel::Comparator GetResultsComparator(
+		SearchDialogPersistentSettings::SortMode sortMode);
+	void ApplyResultsSort();
+
 	// FileContextMenuHandler
 	void UpdateMenuEntries(HMENU menu, PCIDLIST_ABSOLUTE pidlParent,
 		const std::vector<PidlChild> &pidlItems, IContextMenu *contextMenu) override;
@@ -190,17 +212,23 @@ private:
 	CoreInterface *m_coreInterface = nullptr;
 	TabContainerImpl *m_tabContainerImpl = nullptr;
 	const IconResourceLoader *const m_iconResourceLoader;
+	FileNameIndexService *const m_fileNameIndexService;
 	wil::unique_hicon m_directoryIcon;
 	BOOL m_bSearching;
 	BOOL m_bStopSearching;
+
+	// Set when an instant search needs to be started once the current search has stopped.
+	bool m_instantSearchPending = false;
 	TCHAR m_szSearchButton[32];
 
 	Search *m_pSearch = nullptr;
 
 	/* Listview item information. */
 	std::list<PIDLIST_ABSOLUTE> m_AwaitingSearchItems;
-	std::unordered_map<int, std::wstring> m_SearchItemsMapInternal;
-	int m_iInternalIndex;
+
+	// The listview mirrors the display order of this model, with each listview item storing the
+	// ID of the corresponding result.
+	FolderModel m_resultsModel;
 	int m_iPreviousSelectedColumn;
 
 	BOOL m_bSetSearchTimer;
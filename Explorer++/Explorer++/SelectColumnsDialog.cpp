@@ -46,8 +46,7 @@ INT_PTR SelectColumnsDialog::OnInitDialog()
 
 	for (const auto &column : currentColumns)
 	{
-		std::wstring text = ResourceHelper::LoadString(GetResourceInstance(),
-			ShellBrowserImpl::LookupColumnNameStringIndex(column.type));
+		std::wstring text = m_shellBrowser->GetColumnName(column.type);
 
 		LVITEM lvItem;
 		lvItem.mask = LVIF_TEXT | LVIF_PARAM;
@@ -96,15 +95,10 @@ bool SelectColumnsDialog::CompareColumns(const Column_t &column1, const Column_t
 		return false;
 	}
 
-	TCHAR column1Text[64];
-	LoadString(GetResourceInstance(), ShellBrowserImpl::LookupColumnNameStringIndex(column1.type),
-		column1Text, std::size(column1Text));
+	std::wstring column1Text = m_shellBrowser->GetColumnName(column1.type);
+	std::wstring column2Text = m_shellBrowser->GetColumnName(column2.type);
 
-	TCHAR column2Text[64];
-	LoadString(GetResourceInstance(), ShellBrowserImpl::LookupColumnNameStringIndex(column2.type),
-		column2Text, std::size(column2Text));
-
-	int ret = StrCmpLogicalW(column1Text, column2Text);
+	int ret = StrCmpLogicalW(column1Text.c_str(), column2Text.c_str());
 
 	if (ret == -1)
 	{
@@ -292,13 +286,8 @@ void SelectColumnsDialog::OnLvnItemChanged(const NMLISTVIEW *pnmlv)
 		auto columnType =
 			ColumnType::_from_integral_nothrow(static_cast<ColumnType::_integral>(lvItem.lParam));
 		CHECK(columnType);
-		int iDescriptionStringIndex =
-			ShellBrowserImpl::LookupColumnDescriptionStringIndex(*columnType);
-
-		TCHAR szColumnDescription[128];
-		LoadString(GetResourceInstance(), iDescriptionStringIndex, szColumnDescription,
-			std::size(szColumnDescription));
-		SetDlgItemText(m_hDlg, IDC_COLUMNS_DESCRIPTION, szColumnDescription);
+		std::wstring columnDescription = m_shellBrowser->GetColumnDescription(*columnType);
+		SetDlgItemText(m_hDlg, IDC_COLUMNS_DESCRIPTION, columnDescription.c_str());
 	}
 }
 
@@ -247,6 +247,11 @@ void SetDefaultColumnsDialog::SaveCurrentColumnState(FolderType folderType)
 		tempColumns.push_back(column);
 	}
 
+	// Plugin columns aren't shown in this dialog, since the column a plugin column slot
+	// corresponds to depends on which plugins have been loaded. They're retained as-is.
+	std::copy_if(currentColumns.begin(), currentColumns.end(), std::back_inserter(tempColumns),
+		[](const Column_t &column) { return IsPluginColumn(column.type); });
+
 	currentColumns.swap(tempColumns);
 }
 
@@ -261,6 +266,11 @@ void SetDefaultColumnsDialog::SetupFolderColumns(FolderType folderType)
 
 	for (const auto &column : columns)
 	{
+		if (IsPluginColumn(column.type))
+		{
+			continue;
+		}
+
 		TCHAR szText[64];
 		LoadString(GetResourceInstance(),
 			ShellBrowserImpl::LookupColumnNameStringIndex(column.type), szText, std::size(szText));
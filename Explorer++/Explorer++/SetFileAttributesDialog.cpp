@@ -4,17 +4,30 @@
 
 #include "stdafx.h"
 #include "SetFileAttributesDialog.h"
+#include "App.h"
 #include "MainResource.h"
+#include "ResourceHelper.h"
+#include "RuntimeHelper.h"
+#include "../Helper/FileActionHandler.h"
+#include "../Helper/Helper.h"
 #include "../Helper/TimeHelper.h"
+#include "../Helper/Win32FileMetadataStore.h"
+#include <fmt/format.h>
+#include <fmt/xchar.h>
+#include <format>
 #include <list>
+#include <thread>
 
 const TCHAR SetFileAttributesDialogPersistentSettings::SETTINGS_KEY[] = _T("SetFileAttributes");
 
 SetFileAttributesDialog::SetFileAttributesDialog(HINSTANCE resourceInstance, HWND hParent,
-	ThemeManager *themeManager,
+	ThemeManager *themeManager, Runtime *runtime, FileActionHandler *fileActionHandler,
 	const std::list<NSetFileAttributesDialogExternal::SetFileAttributesInfo> &sfaiList) :
 	ThemedDialog(resourceInstance, IDD_SETFILEATTRIBUTES, hParent, DialogSizingType::None,
-		themeManager)
+		themeManager),
+	m_runtime(runtime),
+	m_fileActionHandler(fileActionHandler),
+	m_weakPtrFactory(this)
 {
 	assert(!sfaiList.empty());
 
@@ -210,20 +223,41 @@ INT_PTR SetFileAttributesDialog::OnNotify(NMHDR *pnmhdr)
 
 INT_PTR SetFileAttributesDialog::OnClose()
 {
-	EndDialog(m_hDlg, 0);
+	OnCancel();
 	return 0;
 }
 
 void SetFileAttributesDialog::OnOk()
 {
-	FILETIME *plw = nullptr;
-	FILETIME *plc = nullptr;
-	FILETIME *pla = nullptr;
-	FILETIME lastWriteTime;
-	FILETIME creationTime;
-	FILETIME accessTime;
-	DWORD allFileAttributes = FILE_ATTRIBUTE_NORMAL;
-	DWORD fileAttributes;
+	std::vector<std::filesystem::path> paths;
+
+	for (const auto &file : m_FileList)
+	{
+		paths.emplace_back(file.szFullFileName);
+	}
+
+	bool recursive = IsDlgButtonChecked(m_hDlg, IDC_SETFILEATTRIBUTES_RECURSIVE) == BST_CHECKED;
+
+	FileMetadataEditor::Options options;
+	options.numThreads = static_cast<int>(std::max(std::thread::hardware_concurrency(), 1u));
+	options.recursive = recursive;
+
+	auto store = std::make_shared<Win32FileMetadataStore>();
+	m_editor = std::make_shared<FileMetadataEditor>(store.get(), options);
+	m_applyingChanges = true;
+
+	EnableInputControls(false);
+	SendDlgItemMessage(m_hDlg, IDC_SETFILEATTRIBUTES_PROGRESS, PBM_SETRANGE32, 0,
+		static_cast<LPARAM>(paths.size()));
+	SetTimer(m_hDlg, PROGRESS_TIMER_ID, PROGRESS_TIMER_INTERVAL, nullptr);
+
+	ApplyChangesAsync(m_weakPtrFactory.GetWeakPtr(), std::move(paths), GetChanges(), store,
+		m_editor, m_runtime, m_stopSource.get_token());
+}
+
+FileMetadataChanges SetFileAttributesDialog::GetChanges()
+{
+	FileMetadataChanges changes;
 
 	if (m_bModificationDateEnabled)
 	{
@@ -236,8 +270,9 @@ void SetFileAttributesDialog::OnOk()
 
 		MergeDateTime(&localWrite, &localWriteDate, &localWriteTime);
 
+		FILETIME lastWriteTime;
 		LocalSystemTimeToFileTime(&localWrite, &lastWriteTime);
-		plw = &lastWriteTime;
+		changes.lastWriteTime = FileTimeToFileTimeType(lastWriteTime);
 	}
 
 	if (m_bCreationDateEnabled)
@@ -251,8 +286,9 @@ void SetFileAttributesDialog::OnOk()
 
 		MergeDateTime(&localCreation, &localCreationDate, &localCreationTime);
 
+		FILETIME creationTime;
 		LocalSystemTimeToFileTime(&localCreation, &creationTime);
-		plc = &creationTime;
+		changes.creationTime = FileTimeToFileTimeType(creationTime);
 	}
 
 	if (m_bAccessDateEnabled)
@@ -266,14 +302,15 @@ void SetFileAttributesDialog::OnOk()
 
 		MergeDateTime(&localAccess, &localAccessDate, &localAccessTime);
 
+		FILETIME accessTime;
 		LocalSystemTimeToFileTime(&localAccess, &accessTime);
-		pla = &accessTime;
+		changes.lastAccessTime = FileTimeToFileTimeType(accessTime);
 	}
 
-	/* Build up list of attributes. Add all positive
-	attributes (i.e. those that are active for all files).
-	Any attributes which are indeterminate will not change
-	(note that they are per-file). */
+	/* Checked attributes are applied to every item and unchecked
+	attributes are removed from every item. Any attributes which are
+	indeterminate will not change (i.e. if an item had the attribute
+	applied initially, it will still have it applied, and vice versa). */
 	for (auto &attribute : m_AttributeList)
 	{
 		attribute.uChecked = static_cast<UINT>(
@@ -281,45 +318,134 @@ void SetFileAttributesDialog::OnOk()
 
 		if (attribute.uChecked == BST_CHECKED)
 		{
-			allFileAttributes |= attribute.Attribute;
+			changes.attributesToSet |= attribute.Attribute;
+		}
+		else if (attribute.uChecked == BST_UNCHECKED)
+		{
+			changes.attributesToClear |= attribute.Attribute;
 		}
 	}
 
-	for (const auto &file : m_FileList)
+	return changes;
+}
+
+concurrencpp::null_result SetFileAttributesDialog::ApplyChangesAsync(
+	WeakPtr<SetFileAttributesDialog> self, std::vector<std::filesystem::path> paths,
+	FileMetadataChanges changes, std::shared_ptr<FileMetadataStore> store,
+	std::shared_ptr<FileMetadataEditor> editor, Runtime *runtime, std::stop_token stopToken)
+{
+	// The store is only passed in so that it stays alive for as long as the editor that references
+	// it.
+	UNREFERENCED_PARAMETER(store);
+
+	co_await ResumeOnBackgroundJobThread(runtime);
+
+	auto result = editor->Apply(paths, changes, stopToken);
+
+	co_await ResumeOnUiThread(runtime);
+
+	// Note that the result is still used if the operation was cancelled, since some of the items
+	// may have already been changed, and those changes should be undoable.
+	if (!self)
 	{
-		fileAttributes = allFileAttributes;
+		co_return;
+	}
 
-		for (const auto &attribute : m_AttributeList)
-		{
-			/* If the check box is indeterminate, this attribute will
-			stay the same (i.e. if a file had the attribute applied
-			initially, it will still have it applied, and vice versa). */
-			if (attribute.uChecked == BST_INDETERMINATE)
-			{
-				if (file.wfd.dwFileAttributes & attribute.Attribute)
-				{
-					fileAttributes |= attribute.Attribute;
-				}
-			}
-		}
+	self->OnChangesApplied(std::move(result));
+}
 
-		SetFileAttributes(file.szFullFileName, fileAttributes);
+void SetFileAttributesDialog::OnChangesApplied(FileMetadataEditResult result)
+{
+	KillTimer(m_hDlg, PROGRESS_TIMER_ID);
+	m_applyingChanges = false;
 
-		HANDLE hFile = CreateFile(file.szFullFileName, FILE_WRITE_ATTRIBUTES, 0, nullptr,
-			OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS, nullptr);
+	m_fileActionHandler->AddMetadataChange(std::move(result.journal));
 
-		if (hFile != INVALID_HANDLE_VALUE)
-		{
-			SetFileTime(hFile, plc, pla, plw);
-			CloseHandle(hFile);
-		}
+	if (!result.failures.empty())
+	{
+		ShowFailures(result.failures);
 	}
 
 	EndDialog(m_hDlg, 1);
 }
 
+void SetFileAttributesDialog::ShowFailures(const std::vector<FileMetadataFailure> &failures)
+{
+	std::wstring failureText;
+
+	for (size_t i = 0; i < std::min(failures.size(), MAX_LISTED_FAILURES); i++)
+	{
+		const auto &failure = failures[i];
+		auto errorMessage = GetLastErrorMessage(static_cast<DWORD>(failure.error.value()));
+
+		failureText += std::format(L"{}: {}\n", failure.path.wstring(),
+			errorMessage ? *errorMessage : std::to_wstring(failure.error.value()));
+	}
+
+	if (failures.size() > MAX_LISTED_FAILURES)
+	{
+		failureText += fmt::format(fmt::runtime(ResourceHelper::LoadString(GetResourceInstance(),
+									   IDS_SETFILEATTRIBUTES_FAILURES_TRUNCATED)),
+			fmt::arg(L"num_failures", failures.size() - MAX_LISTED_FAILURES));
+	}
+
+	std::wstring message = fmt::format(fmt::runtime(ResourceHelper::LoadString(
+										   GetResourceInstance(), IDS_SETFILEATTRIBUTES_FAILURES)),
+		fmt::arg(L"num_failures", failures.size()), fmt::arg(L"failures", failureText));
+
+	MessageBox(m_hDlg, message.c_str(), App::APP_NAME, MB_ICONWARNING | MB_OK);
+}
+
+void SetFileAttributesDialog::UpdateProgress()
+{
+	auto progress = m_editor->GetProgress();
+
+	// Until the full set of items is known, the progress bar is left empty.
+	if (progress.numItems == 0)
+	{
+		return;
+	}
+
+	HWND progressBar = GetDlgItem(m_hDlg, IDC_SETFILEATTRIBUTES_PROGRESS);
+	SendMessage(progressBar, PBM_SETRANGE32, 0, static_cast<LPARAM>(progress.numItems));
+	SendMessage(progressBar, PBM_SETPOS, static_cast<WPARAM>(progress.numItemsProcessed), 0);
+}
+
+INT_PTR SetFileAttributesDialog::OnTimer(int timerId)
+{
+	if (timerId == PROGRESS_TIMER_ID)
+	{
+		UpdateProgress();
+	}
+
+	return 0;
+}
+
+void SetFileAttributesDialog::EnableInputControls(bool enable)
+{
+	for (HWND child = GetWindow(m_hDlg, GW_CHILD); child; child = GetWindow(child, GW_HWNDNEXT))
+	{
+		int id = GetDlgCtrlID(child);
+
+		if (id != IDCANCEL && id != IDC_SETFILEATTRIBUTES_PROGRESS)
+		{
+			EnableWindow(child, enable);
+		}
+	}
+}
+
 void SetFileAttributesDialog::OnCancel()
 {
+	/* If changes are being applied, they'll stop shortly. The dialog
+	will then be closed once the items that were changed have been
+	recorded (so that the changes can be undone). */
+	if (m_applyingChanges)
+	{
+		m_stopSource.request_stop();
+		EnableWindow(GetDlgItem(m_hDlg, IDCANCEL), false);
+		return;
+	}
+
 	EndDialog(m_hDlg, 0);
 }
 
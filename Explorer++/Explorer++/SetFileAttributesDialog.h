@@ -6,7 +6,15 @@
 
 #include "ThemedDialog.h"
 #include "../Helper/DialogSettings.h"
+#include "../Helper/FileMetadataEditor.h"
+#include "../Helper/WeakPtr.h"
+#include "../Helper/WeakPtrFactory.h"
+#include <concurrencpp/concurrencpp.h>
+#include <filesystem>
 #include <list>
+#include <memory>
+#include <stop_token>
+#include <vector>
 
 namespace NSetFileAttributesDialogExternal
 {
@@ -17,6 +25,8 @@ struct SetFileAttributesInfo
 };
 }
 
+class FileActionHandler;
+class Runtime;
 class SetFileAttributesDialog;
 
 class SetFileAttributesDialogPersistentSettings : public DialogSettings
@@ -41,12 +51,14 @@ class SetFileAttributesDialog : public ThemedDialog
 {
 public:
 	SetFileAttributesDialog(HINSTANCE resourceInstance, HWND hParent, ThemeManager *themeManager,
+		Runtime *runtime, FileActionHandler *fileActionHandler,
 		const std::list<NSetFileAttributesDialogExternal::SetFileAttributesInfo> &sfaiList);
 
 protected:
 	INT_PTR OnInitDialog() override;
 	INT_PTR OnCommand(WPARAM wParam, LPARAM lParam) override;
 	INT_PTR OnNotify(NMHDR *pnmhdr) override;
+	INT_PTR OnTimer(int timerId) override;
 	INT_PTR OnClose() override;
 
 	void SaveState() override;
@@ -66,6 +78,13 @@ private:
 		Accessed
 	};
 
+	static constexpr UINT_PTR PROGRESS_TIMER_ID = 1;
+	static constexpr UINT PROGRESS_TIMER_INTERVAL = 100;
+
+	// The maximum number of failures that will be individually listed once the changes have been
+	// applied.
+	static constexpr size_t MAX_LISTED_FAILURES = 20;
+
 	void InitializeAttributesStructure();
 
 	void ResetButtonState(HWND hwnd, BOOL bReset);
@@ -74,8 +93,20 @@ private:
 	void InitializeDateFields();
 	void OnDateReset(DateTimeType dateTimeType);
 	void OnOk();
+	FileMetadataChanges GetChanges();
+	static concurrencpp::null_result ApplyChangesAsync(WeakPtr<SetFileAttributesDialog> self,
+		std::vector<std::filesystem::path> paths, FileMetadataChanges changes,
+		std::shared_ptr<FileMetadataStore> store, std::shared_ptr<FileMetadataEditor> editor,
+		Runtime *runtime, std::stop_token stopToken);
+	void OnChangesApplied(FileMetadataEditResult result);
+	void ShowFailures(const std::vector<FileMetadataFailure> &failures);
+	void UpdateProgress();
+	void EnableInputControls(bool enable);
 	void OnCancel();
 
+	Runtime *const m_runtime;
+	FileActionHandler *const m_fileActionHandler;
+
 	std::list<NSetFileAttributesDialogExternal::SetFileAttributesInfo> m_FileList;
 	std::list<Attribute_t> m_AttributeList;
 
@@ -88,4 +119,12 @@ private:
 	BOOL m_bModificationDateEnabled;
 	BOOL m_bCreationDateEnabled;
 	BOOL m_bAccessDateEnabled;
+
+	// The changes are applied in the background. While that's happening, the dialog stays open, so
+	// that the progress can be shown and the operation cancelled.
+	std::shared_ptr<FileMetadataEditor> m_editor;
+	std::stop_source m_stopSource;
+	bool m_applyingChanges = false;
+
+	WeakPtrFactory<SetFileAttributesDialog> m_weakPtrFactory;
 };
@@ -8,6 +8,9 @@
 #include "Config.h"
 #include "DocumentServiceProvider.h"
 #include "FeatureList.h"
+#include "FolderPrefetchPredictor.h"
+#include "FolderPrefetcher.h"
+#include "FolderSnapshotCache.h"
 #include "HistoryEntry.h"
 #include "IconFetcher.h"
 #include "ItemData.h"
@@ -22,6 +25,7 @@
 #include "../Helper/ListViewHelper.h"
 #include "../Helper/ScopedRedrawDisabler.h"
 #include "../Helper/ShellHelper.h"
+#include "../Helper/Tracing.h"
 #include "../Helper/WinRTBaseWrapper.h"
 #include "../Helper/WindowHelper.h"
 #include <wil/com.h>
@@ -33,6 +37,18 @@ void ShellBrowserImpl::OnNavigationStarted(const NavigationRequest *request)
 {
 	CHECK(request->GetShellBrowser() == this);
 
+	// A navigation can be started in a dormant browser without going through ActivateIfDormant()
+	// (e.g. when a plugin refreshes the tab). In that case, the browser will need its worker
+	// threads back.
+	ExitDormantState();
+
+	// By this point, the navigation has taken ownership of any prefetch for the target folder, so
+	// anything else being prefetched is no longer useful.
+	if (m_folderPrefetcher)
+	{
+		m_folderPrefetcher->CancelAll();
+	}
+
 	RecalcWindowCursor(m_hListView);
 }
 
@@ -87,15 +103,22 @@ void ShellBrowserImpl::PrepareToChangeFolders()
 void ShellBrowserImpl::ClearPendingResults()
 {
 	m_columnThreadPool.clear_queue();
-	m_columnResults.clear();
+	CancelPluginColumnTasks();
+	CancelHashColumnTasks();
+	m_columnResults.Invalidate();
 
 	m_iconFetcher->ClearQueue();
 
 	m_thumbnailThreadPool.clear_queue();
-	m_thumbnailResults.clear();
+	m_thumbnailResults.Invalidate();
 
 	m_infoTipsThreadPool.clear_queue();
-	m_infoTipResults.clear();
+	m_infoTipResults.Invalidate();
+
+	m_snapshotRevalidationStopSource = std::make_unique<ScopedStopSource>();
+
+	m_hoverPrefetchTimer.cancel();
+	m_hoverPrefetchItem.reset();
 }
 
 void ShellBrowserImpl::StoreCurrentlySelectedItems()
@@ -265,13 +288,15 @@ std::optional<int> ShellBrowserImpl::AddItemInternal(IShellFolder *shellFolder,
 		return std::nullopt;
 	}
 
-	return AddItemInternal(itemIndex, *itemInfo, setPosition);
+	return AddItemInternal(itemIndex, std::make_shared<const ItemInfo_t>(std::move(*itemInfo)),
+		setPosition);
 }
 
-int ShellBrowserImpl::AddItemInternal(int itemIndex, const ItemInfo_t &itemInfo, BOOL setPosition)
+int ShellBrowserImpl::AddItemInternal(int itemIndex, std::shared_ptr<const ItemInfo_t> itemInfo,
+	BOOL setPosition)
 {
 	int itemId = GenerateUniqueItemId();
-	m_itemInfoMap.insert({ itemId, itemInfo });
+	m_itemInfoMap.insert({ itemId, std::move(itemInfo) });
 
 	AwaitingAdd_t awaitingAdd;
 
@@ -294,13 +319,12 @@ int ShellBrowserImpl::AddItemInternal(int itemIndex, const ItemInfo_t &itemInfo,
 	return itemId;
 }
 
-std::optional<ShellBrowserImpl::ItemInfo_t> ShellBrowserImpl::GetItemInformation(
+std::optional<ItemInfo_t> ShellBrowserImpl::GetItemInformation(
 	IShellFolder *shellFolder, PCIDLIST_ABSOLUTE pidlDirectory, PCITEMID_CHILD pidlChild)
 {
 	ItemInfo_t itemInfo;
 
 	itemInfo.pidlComplete.TakeOwnership(ILCombine(pidlDirectory, pidlChild));
-	itemInfo.pridl = pidlChild;
 
 	std::wstring parsingName;
 	HRESULT hr = GetDisplayName(shellFolder, pidlChild, SHGDN_FORPARSING, parsingName);
@@ -359,7 +383,10 @@ std::optional<ShellBrowserImpl::ItemInfo_t> ShellBrowserImpl::GetItemInformation
 		return std::nullopt;
 	}
 
-	itemInfo.editingName = editingName;
+	if (editingName != displayName)
+	{
+		itemInfo.editingName = editingName;
+	}
 
 	if (PathIsRoot(parsingName.c_str()))
 	{
@@ -381,23 +408,30 @@ std::optional<ShellBrowserImpl::ItemInfo_t> ShellBrowserImpl::GetItemInformation
 
 	if (SUCCEEDED(hr))
 	{
-		itemInfo.wfd = wfd;
+		itemInfo.wfd = ItemFindData(wfd);
 		itemInfo.isFindDataValid = true;
 	}
-	else
+	else if (WI_IsFlagSet(attributes, SFGAO_FOLDER))
 	{
-		StringCchCopy(itemInfo.wfd.cFileName, std::size(itemInfo.wfd.cFileName),
-			displayName.c_str());
-
-		if (WI_IsFlagSet(attributes, SFGAO_FOLDER))
-		{
-			WI_SetFlag(itemInfo.wfd.dwFileAttributes, FILE_ATTRIBUTE_DIRECTORY);
-		}
+		WI_SetFlag(itemInfo.wfd.dwFileAttributes, FILE_ATTRIBUTE_DIRECTORY);
 	}
 
 	return itemInfo;
 }
 
+std::optional<BasicItemInfo_t> ShellBrowserImpl::GetBasicItemInformation(
+	IShellFolder *shellFolder, PCIDLIST_ABSOLUTE pidlDirectory, PCITEMID_CHILD pidlChild)
+{
+	auto itemInfo = GetItemInformation(shellFolder, pidlDirectory, pidlChild);
+
+	if (!itemInfo)
+	{
+		return std::nullopt;
+	}
+
+	return BuildBasicItemInfo(*itemInfo);
+}
+
 HRESULT ShellBrowserImpl::ExtractFindDataUsingPropertyStore(IShellFolder *shellFolder,
 	PCITEMID_CHILD pidlChild, WIN32_FIND_DATA &output)
 {
@@ -450,8 +484,13 @@ void ShellBrowserImpl::OnNavigationWillCommit(const NavigationRequest *request)
 	CHECK(request->GetShellBrowser() == this);
 
 	// The folder is going to change, so update the set of selected items before the current
-	// navigation entry changes.
-	StoreCurrentlySelectedItems();
+	// navigation entry changes. If no folder is currently shown (e.g. because the browser was
+	// dormant), the listview is empty and any previously stored selection should be retained.
+	if (m_navigationState == NavigationState::Committed)
+	{
+		StoreCurrentlySelectedItems();
+		SaveFolderSnapshot();
+	}
 
 	SetNavigationState(NavigationState::WillCommit);
 }
@@ -460,15 +499,26 @@ void ShellBrowserImpl::OnNavigationComitted(const NavigationRequest *request)
 {
 	CHECK(request->GetShellBrowser() == this);
 
+	TRACE_SCOPE("shell_browser", "ShellBrowserImpl::OnNavigationComitted");
+
 	ChangeFolders(request->GetNavigateParams().pidl);
 
 	NotifyShellOfNavigation(request->GetNavigateParams().pidl.Raw());
 
 	RecalcWindowCursor(m_hListView);
 
-	AddNavigationItems(request, request->GetItems());
+	if (request->GetSnapshot())
+	{
+		AddSnapshotItems(request, request->GetSnapshot());
+	}
+	else
+	{
+		AddNavigationItems(request, request->GetItems());
+	}
 
 	SetNavigationState(NavigationState::Committed);
+
+	PrefetchPredictedFolders();
 }
 
 void ShellBrowserImpl::AddNavigationItems(const NavigationRequest *request,
@@ -476,9 +526,14 @@ void ShellBrowserImpl::AddNavigationItems(const NavigationRequest *request,
 {
 	auto items = GetItemInformationFromPidls(request, itemPidls);
 
-	for (auto &item : items)
 	{
-		AddItemInternal(-1, item, FALSE);
+		TraceScope traceScope("shell_browser", "AddItems");
+		traceScope.SetArg("items", static_cast<int64_t>(items.size()));
+
+		for (auto &item : items)
+		{
+			AddItemInternal(-1, std::make_shared<const ItemInfo_t>(std::move(item)), FALSE);
+		}
 	}
 
 	ScopedRedrawDisabler redrawDisabler(m_hListView);
@@ -491,6 +546,12 @@ void ShellBrowserImpl::AddNavigationItems(const NavigationRequest *request,
 	/* Set the focus back to the first item. */
 	ListView_SetItemState(m_hListView, 0, LVIS_FOCUSED, LVIS_FOCUSED);
 
+	RestoreSelectionAfterNavigation(request);
+	StartDirectoryMonitoringIfNecessary();
+}
+
+void ShellBrowserImpl::RestoreSelectionAfterNavigation(const NavigationRequest *request)
+{
 	// A history entry should be created when the navigation is committed, so the current entry
 	// should always be for the current navigation.
 	auto *currentEntry = m_navigationController->GetCurrentEntry();
@@ -502,7 +563,10 @@ void ShellBrowserImpl::AddNavigationItems(const NavigationRequest *request,
 	{
 		SelectItems({ request->GetNavigateParams().originalPidl });
 	}
+}
 
+void ShellBrowserImpl::StartDirectoryMonitoringIfNecessary()
+{
 	if (m_config->shellChangeNotificationType == ShellChangeNotificationType::All
 		|| (m_config->shellChangeNotificationType == ShellChangeNotificationType::NonFilesystem
 			&& m_directoryState.virtualFolder))
@@ -511,7 +575,7 @@ void ShellBrowserImpl::AddNavigationItems(const NavigationRequest *request,
 	}
 }
 
-std::vector<ShellBrowserImpl::ItemInfo_t> ShellBrowserImpl::GetItemInformationFromPidls(
+std::vector<ItemInfo_t> ShellBrowserImpl::GetItemInformationFromPidls(
 	const NavigationRequest *request, const std::vector<PidlChild> &itemPidls)
 {
 	wil::com_ptr_nothrow<IShellFolder> shellFolder;
@@ -523,6 +587,9 @@ std::vector<ShellBrowserImpl::ItemInfo_t> ShellBrowserImpl::GetItemInformationFr
 		return {};
 	}
 
+	TraceScope traceScope("shell_browser", "GetItemInformation");
+	traceScope.SetArg("items", static_cast<int64_t>(itemPidls.size()));
+
 	std::vector<ItemInfo_t> items;
 
 	for (const auto &pidl : itemPidls)
@@ -550,6 +617,9 @@ void ShellBrowserImpl::InsertAwaitingItems()
 		return;
 	}
 
+	TraceScope traceScope("shell_browser", "InsertAwaitingItems");
+	traceScope.SetArg("items", static_cast<int64_t>(m_directoryState.awaitingAddList.size()));
+
 	/* Make the listview allocate space (for internal data structures)
 	for all the items at once, rather than individually.
 	Acts as a speed optimization. */
@@ -563,9 +633,45 @@ void ShellBrowserImpl::InsertAwaitingItems()
 	int nAdded = 0;
 	std::optional<int> itemToRename;
 
+	std::vector<int> awaitingInternalIndexes;
+	awaitingInternalIndexes.reserve(m_directoryState.awaitingAddList.size());
+
+	for (const auto &awaitingItem : m_directoryState.awaitingAddList)
+	{
+		awaitingInternalIndexes.push_back(awaitingItem.iItemInternal);
+	}
+
+	RequestSortAndGroupColumnValues(awaitingInternalIndexes);
+
+	// When showing items in groups, the group for each item is determined up front, in bulk.
+	// Group headers are then only updated once, after all the items have been inserted.
+	std::unordered_map<int, int> itemGroupIds;
+
+	if (m_folderSettings.showInGroups)
+	{
+		std::vector<int> internalIndexes;
+
+		for (const auto &awaitingItem : m_directoryState.awaitingAddList)
+		{
+			if (!IsFileFiltered(*m_itemInfoMap.at(awaitingItem.iItemInternal)))
+			{
+				internalIndexes.push_back(awaitingItem.iItemInternal);
+			}
+		}
+
+		auto groupInfos = DetermineItemGroupInfos(internalIndexes);
+
+		for (size_t i = 0; i < internalIndexes.size(); i++)
+		{
+			itemGroupIds[internalIndexes[i]] = GetOrCreateListViewGroup(groupInfos[i]);
+		}
+
+		m_deferGroupHeaderUpdates = true;
+	}
+
 	for (const auto &awaitingItem : m_directoryState.awaitingAddList)
 	{
-		const auto &itemInfo = m_itemInfoMap.at(awaitingItem.iItemInternal);
+		const auto &itemInfo = *m_itemInfoMap.at(awaitingItem.iItemInternal);
 
 		if (IsFileFiltered(itemInfo))
 		{
@@ -581,7 +687,7 @@ void ShellBrowserImpl::InsertAwaitingItems()
 
 		if (m_folderSettings.showInGroups)
 		{
-			int groupId = DetermineItemGroup(awaitingItem.iItemInternal);
+			int groupId = itemGroupIds.at(awaitingItem.iItemInternal);
 
 			lv.mask |= LVIF_GROUPID;
 			lv.iGroupId = groupId;
@@ -677,6 +783,12 @@ void ShellBrowserImpl::InsertAwaitingItems()
 		nAdded++;
 	}
 
+	if (m_deferGroupHeaderUpdates)
+	{
+		m_deferGroupHeaderUpdates = false;
+		UpdateChangedGroupHeaders();
+	}
+
 	if (m_folderSettings.autoArrange)
 	{
 		ListViewHelper::SetAutoArrange(m_hListView, true);
@@ -727,8 +839,8 @@ void ShellBrowserImpl::RemoveItem(int iItemInternal)
 
 	/* Take the file size of the removed file away from the total
 	directory size. */
-	ulFileSize.LowPart = m_itemInfoMap.at(iItemInternal).wfd.nFileSizeLow;
-	ulFileSize.HighPart = m_itemInfoMap.at(iItemInternal).wfd.nFileSizeHigh;
+	ulFileSize.LowPart = m_itemInfoMap.at(iItemInternal)->wfd.nFileSizeLow;
+	ulFileSize.HighPart = m_itemInfoMap.at(iItemInternal)->wfd.nFileSizeHigh;
 
 	m_directoryState.totalDirSize -= ulFileSize.QuadPart;
 
@@ -757,6 +869,8 @@ void ShellBrowserImpl::RemoveItem(int iItemInternal)
 	}
 
 	m_directoryState.filteredItemsList.erase(iItemInternal);
+	InvalidatePluginColumnValues(iItemInternal);
+	InvalidateHashColumnValues(iItemInternal);
 	m_itemInfoMap.erase(iItemInternal);
 
 	nItems = ListView_GetItemCount(m_hListView);
@@ -780,6 +894,11 @@ void ShellBrowserImpl::SetNavigationState(NavigationState navigationState)
 	{
 		CHECK(m_navigationState == NavigationState::WillCommit);
 	}
+	else if (navigationState == NavigationState::NoFolderShown)
+	{
+		// This only happens when a browser releases its items.
+		CHECK(m_navigationState == NavigationState::Committed);
+	}
 	else
 	{
 		CHECK(false);
@@ -787,3 +906,337 @@ void ShellBrowserImpl::SetNavigationState(NavigationState navigationState)
 
 	m_navigationState = navigationState;
 }
+
+bool ShellBrowserImpl::IsDormant() const
+{
+	return m_dormantNavigation.has_value();
+}
+
+void ShellBrowserImpl::EnterDormantState(const NavigateParams &pendingNavigation)
+{
+	m_dormantNavigation = pendingNavigation;
+
+	// The worker threads aren't needed until the browser is activated again, at which point
+	// they'll be recreated.
+	m_columnThreadPool.resize(0);
+	m_thumbnailThreadPool.resize(0);
+	m_infoTipsThreadPool.resize(0);
+	m_groupThreadPool.resize(0);
+
+	if (m_folderPrefetcher)
+	{
+		m_folderPrefetcher->CancelAll();
+	}
+}
+
+// Releases the items, icons, pending results and worker threads held by this browser, leaving it in
+// a dormant state. Returns false if the browser can't currently be released.
+bool ShellBrowserImpl::ReleaseResources()
+{
+	if (IsDormant() || m_navigationManager.HasAnyPendingNavigations())
+	{
+		return false;
+	}
+
+	if (m_navigationState == NavigationState::Committed)
+	{
+		// The selection will be restored when the browser is next activated.
+		StoreCurrentlySelectedItems();
+		SetNavigationState(NavigationState::NoFolderShown);
+	}
+
+	// This clears the listview and the item map, while still leaving the browser in the current
+	// folder, so that the tab continues to show the correct name, icon and tooltip.
+	auto *currentEntry = m_navigationController->GetCurrentEntry();
+	ChangeFolders(currentEntry->GetPidl());
+
+	EnterDormantState(NavigateParams::History(currentEntry));
+
+	return true;
+}
+
+void ShellBrowserImpl::ActivateIfDormant()
+{
+	if (!IsDormant())
+	{
+		return;
+	}
+
+	auto navigateParams = *m_dormantNavigation;
+
+	// The navigation is simply completing one that was deferred earlier, so it should always
+	// proceed in this tab, even if the tab is address locked.
+	navigateParams.overrideNavigationTargetMode = true;
+
+	ExitDormantState();
+	m_navigationController->Navigate(navigateParams);
+}
+
+void ShellBrowserImpl::ExitDormantState()
+{
+	if (!IsDormant())
+	{
+		return;
+	}
+
+	m_dormantNavigation.reset();
+
+	m_columnThreadPool.resize(1);
+	m_thumbnailThreadPool.resize(1);
+	m_infoTipsThreadPool.resize(1);
+}
+
+std::shared_ptr<const FolderSnapshot> ShellBrowserImpl::MaybeGetFolderSnapshot(
+	const NavigateParams &navigateParams)
+{
+	if (m_folderSnapshotCache->GetMaxSizeInBytes() == 0)
+	{
+		return nullptr;
+	}
+
+	auto snapshot = m_folderSnapshotCache->Find(navigateParams.pidl);
+
+	if (!snapshot || snapshot->includesHiddenItems != m_folderSettings.showHidden)
+	{
+		return nullptr;
+	}
+
+	return snapshot;
+}
+
+void ShellBrowserImpl::SaveFolderSnapshot()
+{
+	if (m_folderSnapshotCache->GetMaxSizeInBytes() == 0)
+	{
+		return;
+	}
+
+	// The items are shared with the snapshot, rather than being copied, so building the snapshot is
+	// cheap. If it turns out to be too large, the cache won't store it.
+	auto snapshot = std::make_shared<FolderSnapshot>();
+	snapshot->pidlDirectory = m_directoryState.pidlDirectory;
+	snapshot->includesHiddenItems = m_folderSettings.showHidden;
+
+	int numItems = ListView_GetItemCount(m_hListView);
+	snapshot->items.reserve(numItems + m_directoryState.filteredItemsList.size());
+
+	for (int i = 0; i < numItems; i++)
+	{
+		snapshot->items.push_back(m_itemInfoMap.at(GetItemInternalIndex(i)));
+	}
+
+	for (int internalIndex : m_directoryState.filteredItemsList)
+	{
+		snapshot->items.push_back(m_itemInfoMap.at(internalIndex));
+	}
+
+	snapshot->sortKeys = GetSortKeys();
+	snapshot->topIndex = ListView_GetTopIndex(m_hListView);
+	ListView_GetOrigin(m_hListView, &snapshot->viewOrigin);
+	snapshot->selectedItems = GetSelectedItemPidls();
+
+	m_folderSnapshotCache->Insert(std::move(snapshot));
+}
+
+std::vector<SortKey> ShellBrowserImpl::GetSortKeys() const
+{
+	std::vector<SortKey> sortKeys = { { m_folderSettings.sortMode,
+		m_folderSettings.sortDirection } };
+	std::ranges::copy(m_folderSettings.secondarySortKeys, std::back_inserter(sortKeys));
+	return sortKeys;
+}
+
+void ShellBrowserImpl::AddSnapshotItems(const NavigationRequest *request,
+	std::shared_ptr<const FolderSnapshot> snapshot)
+{
+	// The snapshot items are immutable, so they can be shared directly.
+	for (const auto &item : snapshot->items)
+	{
+		AddItemInternal(-1, item, FALSE);
+	}
+
+	ScopedRedrawDisabler redrawDisabler(m_hListView);
+
+	InsertAwaitingItems();
+
+	// The items were inserted in the order they were previously shown in, so if the sort order
+	// hasn't changed in the meantime, there's no need to sort them again. When items are shown in
+	// groups, the groups still need to be put in order.
+	if (snapshot->sortKeys != GetSortKeys() || m_folderSettings.showInGroups)
+	{
+		SortFolder();
+	}
+	else if (m_folderSettings.viewMode == +ViewMode::Details)
+	{
+		ApplyHeaderSortArrow();
+	}
+
+	ListView_SetItemState(m_hListView, 0, LVIS_FOCUSED, LVIS_FOCUSED);
+
+	// When going back, forward or up, the selection is set in the same way it would be if no
+	// snapshot were available. Otherwise, the folder is being revisited and the selection from the
+	// last visit is restored.
+	if (request->GetNavigateParams().navigationType == NavigationType::Normal)
+	{
+		SelectItems(snapshot->selectedItems);
+	}
+	else
+	{
+		RestoreSelectionAfterNavigation(request);
+	}
+
+	RestoreSnapshotScrollPosition(*snapshot);
+
+	StartDirectoryMonitoringIfNecessary();
+
+	RevalidateFolderSnapshot(m_weakPtrFactory.GetWeakPtr(), m_shellEnumerator, snapshot,
+		m_app->GetRuntime(), m_snapshotRevalidationStopSource->GetToken());
+}
+
+void ShellBrowserImpl::RestoreSnapshotScrollPosition(const FolderSnapshot &snapshot)
+{
+	if (m_folderSettings.viewMode == +ViewMode::Details
+		|| m_folderSettings.viewMode == +ViewMode::List)
+	{
+		int numItems = ListView_GetItemCount(m_hListView);
+
+		if (snapshot.topIndex <= 0 || snapshot.topIndex >= numItems)
+		{
+			return;
+		}
+
+		// Scrolling to the last item first means that ensuring the original top item is visible
+		// will leave that item at the start of the view.
+		ListView_EnsureVisible(m_hListView, numItems - 1, FALSE);
+		ListView_EnsureVisible(m_hListView, snapshot.topIndex, FALSE);
+	}
+	else
+	{
+		POINT origin = {};
+		ListView_GetOrigin(m_hListView, &origin);
+		ListView_Scroll(m_hListView, snapshot.viewOrigin.x - origin.x,
+			snapshot.viewOrigin.y - origin.y);
+	}
+}
+
+concurrencpp::null_result ShellBrowserImpl::RevalidateFolderSnapshot(
+	WeakPtr<ShellBrowserImpl> weakSelf, std::shared_ptr<const ShellEnumeratorImpl> shellEnumerator,
+	std::shared_ptr<const FolderSnapshot> snapshot, Runtime *runtime, std::stop_token stopToken)
+{
+	co_await ResumeOnComStaThread(runtime);
+
+	std::vector<PidlChild> currentItems;
+	HRESULT hr = shellEnumerator->EnumerateDirectory(snapshot->pidlDirectory.Raw(), currentItems,
+		stopToken);
+
+	// If the folder can no longer be enumerated (e.g. because it's been deleted), the change will
+	// be picked up through the standard directory monitoring.
+	if (FAILED(hr) || stopToken.stop_requested())
+	{
+		co_return;
+	}
+
+	wil::com_ptr_nothrow<IShellFolder> shellFolder;
+	hr = SHBindToObject(nullptr, snapshot->pidlDirectory.Raw(), nullptr,
+		IID_PPV_ARGS(&shellFolder));
+
+	if (FAILED(hr))
+	{
+		co_return;
+	}
+
+	auto diff = DiffFolderSnapshot(*snapshot, currentItems,
+		[&shellFolder](PCITEMID_CHILD pidl) -> std::optional<std::wstring>
+		{
+			std::wstring parsingName;
+
+			if (FAILED(GetDisplayName(shellFolder.get(), pidl, SHGDN_FORPARSING, parsingName)))
+			{
+				return std::nullopt;
+			}
+
+			return parsingName;
+		});
+
+	co_await ResumeOnUiThread(runtime);
+
+	if (stopToken.stop_requested() || !weakSelf)
+	{
+		co_return;
+	}
+
+	weakSelf->ApplyFolderSnapshotDiff(*snapshot, currentItems, diff);
+}
+
+void ShellBrowserImpl::ApplyFolderSnapshotDiff(const FolderSnapshot &snapshot,
+	const std::vector<PidlChild> &currentItems, const FolderSnapshotDiff &diff)
+{
+	if (diff.IsEmpty())
+	{
+		return;
+	}
+
+	if (diff.addedItems.size() + diff.removedItems.size() + diff.modifiedItems.size()
+		> MAX_INCREMENTAL_SNAPSHOT_CHANGES)
+	{
+		m_navigationController->Refresh();
+		return;
+	}
+
+	// Directory monitoring starts as soon as the snapshot is shown, so some of these changes may
+	// have already been applied. Each of the methods below can handle that.
+	for (auto snapshotIndex : diff.removedItems)
+	{
+		OnItemRemoved(snapshot.items[snapshotIndex]->pidlComplete.Raw());
+	}
+
+	for (const auto &[snapshotIndex, currentIndex] : diff.modifiedItems)
+	{
+		PidlAbsolute pidl;
+		pidl.TakeOwnership(
+			ILCombine(snapshot.pidlDirectory.Raw(), currentItems[currentIndex].Raw()));
+		UpdateItem(pidl.Raw());
+	}
+
+	for (auto currentIndex : diff.addedItems)
+	{
+		PidlAbsolute pidl;
+		pidl.TakeOwnership(
+			ILCombine(snapshot.pidlDirectory.Raw(), currentItems[currentIndex].Raw()));
+
+		if (GetItemInternalIndexForPidl(pidl.Raw()))
+		{
+			continue;
+		}
+
+		AddItem(pidl.Raw());
+	}
+}
+
+void ShellBrowserImpl::PrefetchFolder(const PidlAbsolute &pidl)
+{
+	if (!m_folderPrefetcher || IsDormant() || pidl == m_directoryState.pidlDirectory)
+	{
+		return;
+	}
+
+	m_folderPrefetcher->Prefetch(pidl);
+}
+
+std::shared_ptr<FolderPrefetch> ShellBrowserImpl::MaybeTakeFolderPrefetch(
+	const NavigateParams &navigateParams)
+{
+	return m_folderPrefetcher->TakePrefetch(navigateParams.pidl);
+}
+
+void ShellBrowserImpl::PrefetchPredictedFolders()
+{
+	if (!m_folderPrefetcher)
+	{
+		return;
+	}
+
+	auto predictions = PredictNextFolders(m_directoryState.pidlDirectory, m_app->GetHistoryModel(),
+		m_app->GetFrequentLocationsModel(), MAX_PREDICTED_PREFETCHES);
+	m_folderPrefetcher->Prefetch(predictions);
+}
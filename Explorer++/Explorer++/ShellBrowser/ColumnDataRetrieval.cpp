@@ -173,6 +173,13 @@ std::wstring GetColumnText(ColumnType columnType, const BasicItemInfo_t &basicIt
 	case ColumnType::MediaYear:
 		return GetMediaMetadataColumnText(basicItemInfo, MediaMetadataType::Year);
 
+	case ColumnType::HashCrc32:
+		return GetHashColumnText(basicItemInfo, HashAlgorithm::Crc32);
+	case ColumnType::HashXxHash64:
+		return GetHashColumnText(basicItemInfo, HashAlgorithm::XxHash64);
+	case ColumnType::HashSha256:
+		return GetHashColumnText(basicItemInfo, HashAlgorithm::Sha256);
+
 	default:
 		assert(false);
 		break;
@@ -1029,3 +1036,23 @@ BOOL GetDriveSpaceColumnRawData(const BasicItemInfo_t &itemInfo, bool TotalSize,
 
 	return res;
 }
+
+// The file is always hashed here, without using any cached value. Within the listview, hash columns
+// are retrieved through the hash service instead (see HashColumns.cpp).
+std::wstring GetHashColumnText(const BasicItemInfo_t &itemInfo, HashAlgorithm algorithm)
+{
+	if (!itemInfo.isFindDataValid
+		|| WI_IsFlagSet(itemInfo.wfd.dwFileAttributes, FILE_ATTRIBUTE_DIRECTORY))
+	{
+		return L"";
+	}
+
+	auto hash = HashFile(itemInfo.getFullPath(), algorithm, {});
+
+	if (!hash)
+	{
+		return L"";
+	}
+
+	return std::wstring(hash->begin(), hash->end());
+}
@@ -5,6 +5,7 @@
 #pragma once
 
 #include "Columns.h"
+#include "../Helper/ContentHash.h"
 #include <string>
 
 struct BasicItemInfo_t;
@@ -106,3 +107,4 @@ std::wstring GetSizeColumnText(const BasicItemInfo_t &itemInfo,
 	const GlobalFolderSettings &globalFolderSettings);
 std::wstring GetFolderSizeColumnText(const BasicItemInfo_t &itemInfo,
 	const GlobalFolderSettings &globalFolderSettings);
+std::wstring GetHashColumnText(const BasicItemInfo_t &itemInfo, HashAlgorithm algorithm);
@@ -7,49 +7,54 @@
 #include "ColumnDataRetrieval.h"
 #include "Columns.h"
 #include "Config.h"
+#include "HashColumns.h"
 #include "ItemData.h"
 #include "MainResource.h"
+#include "Plugins/PluginColumnRegistry.h"
 #include "ResourceHelper.h"
 #include "SortModes.h"
 #include "ViewModes.h"
+#include "../Helper/Helper.h"
+#include "../Helper/Tracing.h"
 #include <cassert>
 #include <list>
 
 void ShellBrowserImpl::QueueColumnTask(int itemInternalIndex, ColumnType columnType)
 {
-	int columnResultID = m_columnResultIDCounter++;
+	if (IsPluginColumn(columnType))
+	{
+		QueuePluginColumnTask(itemInternalIndex, columnType);
+		return;
+	}
+
+	if (IsHashColumn(columnType))
+	{
+		QueueHashColumnTask(itemInternalIndex, columnType);
+		return;
+	}
 
 	BasicItemInfo_t basicItemInfo = getBasicItemInfo(itemInternalIndex);
 	GlobalFolderSettings globalFolderSettings = m_config->globalFolderSettings;
 
-	auto result = m_columnThreadPool.push(
-		[listView = m_hListView, columnResultID, columnType, itemInternalIndex, basicItemInfo,
+	m_columnThreadPool.push(
+		[sender = m_columnResults.GetSender(), columnType, itemInternalIndex, basicItemInfo,
 			globalFolderSettings](int id)
 		{
 			UNREFERENCED_PARAMETER(id);
 
-			return GetColumnTextAsync(listView, columnResultID, columnType, itemInternalIndex,
-				basicItemInfo, globalFolderSettings);
-		});
+			TRACE_SCOPE("columns", "GetColumnText");
 
-	// The function call above might finish before this line runs,
-	// but that doesn't matter, as the results won't be processed
-	// until a message posted to the main thread has been handled
-	// (which can only occur after this function has returned).
-	m_columnResults.insert({ columnResultID, std::move(result) });
+			sender.Send(GetColumnTextAsync(columnType, itemInternalIndex, basicItemInfo,
+				globalFolderSettings));
+		});
 }
 
-ShellBrowserImpl::ColumnResult_t ShellBrowserImpl::GetColumnTextAsync(HWND listView,
-	int columnResultId, ColumnType columnType, int internalIndex,
-	const BasicItemInfo_t &basicItemInfo, const GlobalFolderSettings &globalFolderSettings)
+ShellBrowserImpl::ColumnResult_t ShellBrowserImpl::GetColumnTextAsync(ColumnType columnType,
+	int internalIndex, const BasicItemInfo_t &basicItemInfo,
+	const GlobalFolderSettings &globalFolderSettings)
 {
 	std::wstring columnText = GetColumnText(columnType, basicItemInfo, globalFolderSettings);
 
-	// This message may be delivered before this function has returned.
-	// That doesn't actually matter, since the message handler will
-	// simply wait for the result to be returned.
-	PostMessage(listView, WM_APP_COLUMN_RESULT_READY, columnResultId, 0);
-
 	ColumnResult_t result;
 	result.itemInternalIndex = internalIndex;
 	result.columnType = columnType;
@@ -58,13 +63,17 @@ ShellBrowserImpl::ColumnResult_t ShellBrowserImpl::GetColumnTextAsync(HWND listV
 	return result;
 }
 
-void ShellBrowserImpl::ProcessColumnResult(int columnResultId)
+void ShellBrowserImpl::ProcessColumnResult(const ColumnResult_t &result)
 {
-	auto itr = m_columnResults.find(columnResultId);
+	// Note that results for a previous folder will have already been discarded by the result
+	// channel.
+	if (IsPluginColumn(result.columnType) && !ProcessPluginColumnResult(result))
+	{
+		return;
+	}
 
-	if (itr == m_columnResults.end())
+	if (IsHashColumn(result.columnType) && !ProcessHashColumnResult(result))
 	{
-		// This result is for a previous folder. It can be ignored.
 		return;
 	}
 
@@ -73,8 +82,6 @@ void ShellBrowserImpl::ProcessColumnResult(int columnResultId)
 		return;
 	}
 
-	auto result = itr->second.get();
-
 	auto index = LocateItemByInternalIndex(result.itemInternalIndex);
 
 	if (!index)
@@ -94,8 +101,6 @@ void ShellBrowserImpl::ProcessColumnResult(int columnResultId)
 	auto columnText = std::make_unique<TCHAR[]>(result.columnText.size() + 1);
 	StringCchCopy(columnText.get(), result.columnText.size() + 1, result.columnText.c_str());
 	ListView_SetItemText(m_hListView, *index, *columnIndex, columnText.get());
-
-	m_columnResults.erase(itr);
 }
 
 std::optional<int> ShellBrowserImpl::GetColumnIndexByType(ColumnType columnType) const
@@ -144,6 +149,18 @@ std::optional<ColumnType> ShellBrowserImpl::GetColumnTypeByIndex(int index) cons
 	return *columnType;
 }
 
+bool ShellBrowserImpl::IsColumnShown(const Column_t &column) const
+{
+	return column.checked && IsColumnAvailable(column.type);
+}
+
+// Plugin columns are only available once a plugin has registered a column in the appropriate slot.
+// All other columns are always available.
+bool ShellBrowserImpl::IsColumnAvailable(ColumnType columnType) const
+{
+	return !IsPluginColumn(columnType) || m_pluginColumnRegistry->GetColumn(columnType);
+}
+
 void ShellBrowserImpl::AddFirstColumn()
 {
 	Column_t firstCheckedColumn = GetFirstCheckedColumn();
@@ -158,7 +175,7 @@ void ShellBrowserImpl::SetUpListViewColumns()
 
 	for (const Column_t &column : *m_pActiveColumns)
 	{
-		if (!column.checked)
+		if (!IsColumnShown(column))
 		{
 			continue;
 		}
@@ -185,8 +202,7 @@ void ShellBrowserImpl::SetUpListViewColumns()
 
 void ShellBrowserImpl::InsertColumn(ColumnType columnType, int columnIndex, int width)
 {
-	std::wstring columnText =
-		ResourceHelper::LoadString(m_resourceInstance, LookupColumnNameStringIndex(columnType));
+	std::wstring columnText = GetColumnName(columnType);
 
 	LV_COLUMN lvColumn;
 	lvColumn.mask = LVCF_TEXT | LVCF_WIDTH;
@@ -275,6 +291,11 @@ void ShellBrowserImpl::SetActiveColumnSet()
 
 SortMode ShellBrowserImpl::DetermineColumnSortMode(ColumnType columnType)
 {
+	if (IsPluginColumn(columnType))
+	{
+		return GetPluginSortMode(GetPluginColumnSlot(columnType));
+	}
+
 	switch (columnType)
 	{
 	case ColumnType::Name:
@@ -463,6 +484,15 @@ SortMode ShellBrowserImpl::DetermineColumnSortMode(ColumnType columnType)
 	case ColumnType::MediaYear:
 		return SortMode::MediaYear;
 
+	case ColumnType::HashCrc32:
+		return SortMode::HashCrc32;
+
+	case ColumnType::HashXxHash64:
+		return SortMode::HashXxHash64;
+
+	case ColumnType::HashSha256:
+		return SortMode::HashSha256;
+
 	default:
 		assert(false);
 		break;
@@ -664,6 +694,15 @@ int ShellBrowserImpl::LookupColumnNameStringIndex(ColumnType columnType)
 	case ColumnType::MediaYear:
 		return IDS_COLUMN_NAME_YEAR;
 
+	case ColumnType::HashCrc32:
+		return IDS_COLUMN_NAME_HASH_CRC32;
+
+	case ColumnType::HashXxHash64:
+		return IDS_COLUMN_NAME_HASH_XXHASH64;
+
+	case ColumnType::HashSha256:
+		return IDS_COLUMN_NAME_HASH_SHA256;
+
 	default:
 		assert(false);
 		break;
@@ -784,6 +823,15 @@ int ShellBrowserImpl::LookupColumnDescriptionStringIndex(ColumnType columnType)
 	case ColumnType::MediaBitrate:
 		return IDS_COLUMN_DESCRIPTION_BITRATE;
 
+	case ColumnType::HashCrc32:
+		return IDS_COLUMN_DESCRIPTION_HASH_CRC32;
+
+	case ColumnType::HashXxHash64:
+		return IDS_COLUMN_DESCRIPTION_HASH_XXHASH64;
+
+	case ColumnType::HashSha256:
+		return IDS_COLUMN_DESCRIPTION_HASH_SHA256;
+
 	default:
 		assert(false);
 		break;
@@ -792,6 +840,29 @@ int ShellBrowserImpl::LookupColumnDescriptionStringIndex(ColumnType columnType)
 	return 0;
 }
 
+std::wstring ShellBrowserImpl::GetColumnName(ColumnType columnType) const
+{
+	if (IsPluginColumn(columnType))
+	{
+		const auto *pluginColumn = m_pluginColumnRegistry->GetColumn(columnType);
+		return pluginColumn ? pluginColumn->name : L"";
+	}
+
+	return ResourceHelper::LoadString(m_resourceInstance, LookupColumnNameStringIndex(columnType));
+}
+
+std::wstring ShellBrowserImpl::GetColumnDescription(ColumnType columnType) const
+{
+	if (IsPluginColumn(columnType))
+	{
+		const auto *pluginColumn = m_pluginColumnRegistry->GetColumn(columnType);
+		return pluginColumn ? pluginColumn->description : L"";
+	}
+
+	return ResourceHelper::LoadString(m_resourceInstance,
+		LookupColumnDescriptionStringIndex(columnType));
+}
+
 void ShellBrowserImpl::ColumnClicked(int iClickedColumn)
 {
 	int iCurrentColumn = 0;
@@ -801,14 +872,18 @@ void ShellBrowserImpl::ColumnClicked(int iClickedColumn)
 	for (auto itr = m_pActiveColumns->begin(); itr != m_pActiveColumns->end(); itr++)
 	{
 		/* Only increment if this column is actually been shown. */
-		if (itr->checked)
+		if (IsColumnShown(*itr))
 		{
 			if (iCurrentColumn == iClickedColumn)
 			{
 				sortMode = DetermineColumnSortMode(itr->type);
 				columnType = itr->type;
 
-				if (m_previousSortColumn == columnType)
+				if (IsKeyDown(VK_CONTROL) && sortMode != m_folderSettings.sortMode)
+				{
+					UpdateSecondarySortKeys(sortMode);
+				}
+				else if (m_previousSortColumn == columnType)
 				{
 					m_folderSettings.sortDirection =
 						InvertSortDirection(m_folderSettings.sortDirection);
@@ -816,6 +891,8 @@ void ShellBrowserImpl::ColumnClicked(int iClickedColumn)
 				else
 				{
 					m_folderSettings.sortMode = sortMode;
+					std::erase_if(m_folderSettings.secondarySortKeys,
+						[sortMode](const auto &sortKey) { return sortKey.mode == sortMode; });
 				}
 
 				SortFolder();
@@ -828,6 +905,28 @@ void ShellBrowserImpl::ColumnClicked(int iClickedColumn)
 	}
 }
 
+// Ctrl-clicking a column adds it as a secondary sort key (in ascending order). Ctrl-clicking the
+// column again reverses the direction, while a third click removes the key.
+void ShellBrowserImpl::UpdateSecondarySortKeys(SortMode clickedSortMode)
+{
+	auto &secondarySortKeys = m_folderSettings.secondarySortKeys;
+	auto itr = std::find_if(secondarySortKeys.begin(), secondarySortKeys.end(),
+		[clickedSortMode](const auto &sortKey) { return sortKey.mode == clickedSortMode; });
+
+	if (itr == secondarySortKeys.end())
+	{
+		secondarySortKeys.push_back({ clickedSortMode, SortDirection::Ascending });
+	}
+	else if (itr->direction == +SortDirection::Ascending)
+	{
+		itr->direction = SortDirection::Descending;
+	}
+	else
+	{
+		secondarySortKeys.erase(itr);
+	}
+}
+
 void ShellBrowserImpl::ApplyHeaderSortArrow()
 {
 	HWND hHeader;
@@ -845,7 +944,7 @@ void ShellBrowserImpl::ApplyHeaderSortArrow()
 		for (auto itr = m_pActiveColumns->begin(); itr != m_pActiveColumns->end(); itr++)
 		{
 			/* Only increment if this column is actually been shown. */
-			if (itr->checked)
+			if (IsColumnShown(*itr))
 			{
 				if (m_previousSortColumn == itr->type)
 				{
@@ -880,7 +979,7 @@ void ShellBrowserImpl::ApplyHeaderSortArrow()
 	/* Find the index of the column representing the current sort mode. */
 	for (auto itr = m_pActiveColumns->begin(); itr != m_pActiveColumns->end(); itr++)
 	{
-		if (itr->checked)
+		if (IsColumnShown(*itr))
 		{
 			if (DetermineColumnSortMode(itr->type) == m_folderSettings.sortMode)
 			{
@@ -963,7 +1062,7 @@ void ShellBrowserImpl::SaveColumnWidths()
 	{
 		for (auto itr = pActiveColumns->begin(); itr != pActiveColumns->end(); itr++)
 		{
-			if (itr->checked)
+			if (IsColumnShown(*itr))
 			{
 				itr->width = ListView_GetColumnWidth(m_hListView, iColumn);
 
@@ -980,7 +1079,13 @@ std::vector<Column_t> ShellBrowserImpl::GetCurrentColumns()
 		SaveColumnWidths();
 	}
 
-	return *m_pActiveColumns;
+	// Plugin columns that haven't been registered can't be shown, so they're left out here. They
+	// remain in the active column set (see SetCurrentColumns()), so that they'll reappear once the
+	// plugin that provides them has been loaded.
+	std::vector<Column_t> columns;
+	std::copy_if(m_pActiveColumns->begin(), m_pActiveColumns->end(), std::back_inserter(columns),
+		[this](const Column_t &column) { return IsColumnAvailable(column.type); });
+	return columns;
 }
 
 void ShellBrowserImpl::SetCurrentColumns(const std::vector<Column_t> &columns)
@@ -1026,7 +1131,11 @@ void ShellBrowserImpl::SetCurrentColumns(const std::vector<Column_t> &columns)
 		}
 	}
 
-	*m_pActiveColumns = columns;
+	std::vector<Column_t> updatedColumns = columns;
+	std::copy_if(m_pActiveColumns->begin(), m_pActiveColumns->end(),
+		std::back_inserter(updatedColumns),
+		[this](const Column_t &column) { return !IsColumnAvailable(column.type); });
+	*m_pActiveColumns = updatedColumns;
 
 	// The folder will need to be re-sorted if the sorting column was removed.
 	if (sortFolder)
@@ -1050,7 +1159,7 @@ void ShellBrowserImpl::GetColumnInternal(ColumnType columnType, Column_t *pci) c
 Column_t ShellBrowserImpl::GetFirstCheckedColumn()
 {
 	auto itr = std::find_if(m_pActiveColumns->begin(), m_pActiveColumns->end(),
-		[](const Column_t &column) { return column.checked; });
+		[this](const Column_t &column) { return IsColumnShown(column); });
 
 	// There should always be at least one checked column.
 	CHECK(itr != m_pActiveColumns->end());
@@ -91,10 +91,52 @@ BETTER_ENUM(ColumnType, unsigned int,
 	MediaYear = 63,
 
 	/* Printer columns. */
-	PrinterModel = 64
+	PrinterModel = 64,
+
+	/* Plugin columns. */
+	PluginColumn1 = 65,
+	PluginColumn2 = 66,
+	PluginColumn3 = 67,
+	PluginColumn4 = 68,
+	PluginColumn5 = 69,
+	PluginColumn6 = 70,
+	PluginColumn7 = 71,
+	PluginColumn8 = 72,
+
+	/* Content hashes. */
+	HashCrc32 = 73,
+	HashXxHash64 = 74,
+	HashSha256 = 75
 )
 // clang-format on
 
+// Columns registered by plugins don't have fixed types. Instead, each registered column is
+// assigned one of the plugin column slots above.
+inline constexpr int NUM_PLUGIN_COLUMNS = 8;
+
+inline bool IsPluginColumn(ColumnType columnType)
+{
+	return columnType._to_integral() >= (+ColumnType::PluginColumn1)._to_integral()
+		&& columnType._to_integral() < (+ColumnType::PluginColumn1)._to_integral()
+			+ NUM_PLUGIN_COLUMNS;
+}
+
+inline int GetPluginColumnSlot(ColumnType columnType)
+{
+	return columnType._to_integral() - (+ColumnType::PluginColumn1)._to_integral();
+}
+
+inline ColumnType GetPluginColumnType(int slot)
+{
+	return ColumnType::_from_integral((+ColumnType::PluginColumn1)._to_integral() + slot);
+}
+
+inline bool IsHashColumn(ColumnType columnType)
+{
+	return columnType == +ColumnType::HashCrc32 || columnType == +ColumnType::HashXxHash64
+		|| columnType == +ColumnType::HashSha256;
+}
+
 struct Column_t
 {
 	ColumnType type;
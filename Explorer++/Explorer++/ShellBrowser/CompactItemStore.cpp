@@ -0,0 +1,323 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "stdafx.h"
+#include "CompactItemStore.h"
+#include <limits>
+
+CompactItemStore::ItemView::ItemView(const CompactItemStore *store, ItemId id) :
+	m_store(store),
+	m_id(id)
+{
+}
+
+CompactItemStore::ItemId CompactItemStore::ItemView::GetId() const
+{
+	return m_id;
+}
+
+std::span<const std::byte> CompactItemStore::ItemView::GetPidl() const
+{
+	const auto &pidlRef = m_store->m_pidls[m_id];
+	return { m_store->m_pidlSlab.data() + pidlRef.offset, pidlRef.length };
+}
+
+std::wstring_view CompactItemStore::ItemView::GetParsingName() const
+{
+	return m_store->GetString(m_store->m_names[m_id].parsingName);
+}
+
+std::wstring_view CompactItemStore::ItemView::GetDisplayName() const
+{
+	return m_store->GetString(m_store->m_names[m_id].displayName);
+}
+
+std::wstring_view CompactItemStore::ItemView::GetEditingName() const
+{
+	return m_store->GetString(m_store->m_names[m_id].editingName);
+}
+
+uint64_t CompactItemStore::ItemView::GetSize() const
+{
+	return m_store->m_sizes[m_id];
+}
+
+uint64_t CompactItemStore::ItemView::GetCreationTime() const
+{
+	return m_store->m_creationTimes[m_id];
+}
+
+uint64_t CompactItemStore::ItemView::GetLastAccessTime() const
+{
+	return m_store->m_lastAccessTimes[m_id];
+}
+
+uint64_t CompactItemStore::ItemView::GetLastWriteTime() const
+{
+	return m_store->m_lastWriteTimes[m_id];
+}
+
+uint32_t CompactItemStore::ItemView::GetAttributes() const
+{
+	return m_store->m_attributes[m_id];
+}
+
+CompactItemStore::ItemId CompactItemStore::AddItem(const ItemData &itemData)
+{
+	ItemId id;
+
+	if (!m_freeIds.empty())
+	{
+		id = m_freeIds.back();
+		m_freeIds.pop_back();
+	}
+	else
+	{
+		CHECK_LT(m_names.size(), std::numeric_limits<ItemId>::max());
+		id = static_cast<ItemId>(m_names.size());
+
+		m_names.emplace_back();
+		m_pidls.emplace_back();
+		m_sizes.emplace_back();
+		m_creationTimes.emplace_back();
+		m_lastAccessTimes.emplace_back();
+		m_lastWriteTimes.emplace_back();
+		m_attributes.emplace_back();
+		m_live.push_back(false);
+	}
+
+	SetItemData(id, itemData);
+	m_live[id] = true;
+	m_numItems++;
+
+	return id;
+}
+
+void CompactItemStore::UpdateItem(ItemId id, const ItemData &itemData)
+{
+	CHECK(HasItem(id));
+
+	ReleaseItemStorage(id);
+	SetItemData(id, itemData);
+
+	MaybeCompact();
+}
+
+void CompactItemStore::RemoveItem(ItemId id)
+{
+	CHECK(HasItem(id));
+
+	ReleaseItemStorage(id);
+	m_names[id] = {};
+	m_pidls[id] = {};
+	m_live[id] = false;
+	m_freeIds.push_back(id);
+	m_numItems--;
+
+	MaybeCompact();
+}
+
+void CompactItemStore::Clear()
+{
+	m_names.clear();
+	m_pidls.clear();
+	m_sizes.clear();
+	m_creationTimes.clear();
+	m_lastAccessTimes.clear();
+	m_lastWriteTimes.clear();
+	m_attributes.clear();
+	m_live.clear();
+	m_freeIds.clear();
+	m_numItems = 0;
+
+	m_stringArena.clear();
+	m_unusedStringChars = 0;
+
+	m_pidlSlab.clear();
+	m_unusedPidlBytes = 0;
+}
+
+bool CompactItemStore::HasItem(ItemId id) const
+{
+	return id < m_live.size() && m_live[id];
+}
+
+CompactItemStore::ItemView CompactItemStore::GetItem(ItemId id) const
+{
+	CHECK(HasItem(id));
+	return ItemView(this, id);
+}
+
+size_t CompactItemStore::GetNumItems() const
+{
+	return m_numItems;
+}
+
+void CompactItemStore::Compact()
+{
+	std::vector<wchar_t> newStringArena;
+	newStringArena.reserve(m_stringArena.size() - m_unusedStringChars);
+
+	std::vector<std::byte> newPidlSlab;
+	newPidlSlab.reserve(m_pidlSlab.size() - m_unusedPidlBytes);
+
+	auto copyString = [this, &newStringArena](StringRef ref)
+	{
+		StringRef newRef = { static_cast<uint32_t>(newStringArena.size()), ref.length };
+		newStringArena.insert(newStringArena.end(), m_stringArena.begin() + ref.offset,
+			m_stringArena.begin() + ref.offset + ref.length);
+		return newRef;
+	};
+
+	for (ItemId id = 0; id < m_names.size(); id++)
+	{
+		if (!m_live[id])
+		{
+			continue;
+		}
+
+		auto &names = m_names[id];
+		StringRef displayName = copyString(names.displayName);
+		StringRef parsingName = (names.parsingName == names.displayName)
+			? displayName
+			: copyString(names.parsingName);
+
+		StringRef editingName;
+
+		if (names.editingName == names.displayName)
+		{
+			editingName = displayName;
+		}
+		else if (names.editingName == names.parsingName)
+		{
+			editingName = parsingName;
+		}
+		else
+		{
+			editingName = copyString(names.editingName);
+		}
+
+		names = { parsingName, displayName, editingName };
+
+		auto &pidl = m_pidls[id];
+		PidlRef newPidl = { static_cast<uint32_t>(newPidlSlab.size()), pidl.length };
+		newPidlSlab.insert(newPidlSlab.end(), m_pidlSlab.begin() + pidl.offset,
+			m_pidlSlab.begin() + pidl.offset + pidl.length);
+		pidl = newPidl;
+	}
+
+	m_stringArena = std::move(newStringArena);
+	m_unusedStringChars = 0;
+
+	m_pidlSlab = std::move(newPidlSlab);
+	m_unusedPidlBytes = 0;
+}
+
+size_t CompactItemStore::GetMemoryUsage() const
+{
+	size_t perItemBytes = sizeof(NameRefs) + sizeof(PidlRef) + (4 * sizeof(uint64_t))
+		+ sizeof(uint32_t);
+
+	return (m_names.capacity() * perItemBytes) + (m_live.capacity() / 8)
+		+ (m_freeIds.capacity() * sizeof(ItemId)) + (m_stringArena.capacity() * sizeof(wchar_t))
+		+ m_pidlSlab.capacity();
+}
+
+CompactItemStore::StringRef CompactItemStore::AddString(std::wstring_view str)
+{
+	CHECK_LE(m_stringArena.size() + str.size(), std::numeric_limits<uint32_t>::max());
+
+	StringRef ref = { static_cast<uint32_t>(m_stringArena.size()),
+		static_cast<uint32_t>(str.size()) };
+	m_stringArena.insert(m_stringArena.end(), str.begin(), str.end());
+	return ref;
+}
+
+std::wstring_view CompactItemStore::GetString(StringRef ref) const
+{
+	return { m_stringArena.data() + ref.offset, ref.length };
+}
+
+CompactItemStore::NameRefs CompactItemStore::AddNames(const ItemData &itemData)
+{
+	// In most cases, the editing name will be the same as the display name. When extensions are
+	// shown, the parsing name will generally be the same as well. Therefore, each distinct name is
+	// only stored once.
+	NameRefs names;
+	names.displayName = AddString(itemData.displayName);
+
+	if (itemData.parsingName == itemData.displayName)
+	{
+		names.parsingName = names.displayName;
+	}
+	else
+	{
+		names.parsingName = AddString(itemData.parsingName);
+	}
+
+	if (itemData.editingName == itemData.displayName)
+	{
+		names.editingName = names.displayName;
+	}
+	else if (itemData.editingName == itemData.parsingName)
+	{
+		names.editingName = names.parsingName;
+	}
+	else
+	{
+		names.editingName = AddString(itemData.editingName);
+	}
+
+	return names;
+}
+
+CompactItemStore::PidlRef CompactItemStore::AddPidl(std::span<const std::byte> pidl)
+{
+	CHECK_LE(m_pidlSlab.size() + pidl.size(), std::numeric_limits<uint32_t>::max());
+
+	PidlRef ref = { static_cast<uint32_t>(m_pidlSlab.size()), static_cast<uint32_t>(pidl.size()) };
+	m_pidlSlab.insert(m_pidlSlab.end(), pidl.begin(), pidl.end());
+	return ref;
+}
+
+void CompactItemStore::SetItemData(ItemId id, const ItemData &itemData)
+{
+	m_names[id] = AddNames(itemData);
+	m_pidls[id] = AddPidl(itemData.pidl);
+	m_sizes[id] = itemData.size;
+	m_creationTimes[id] = itemData.creationTime;
+	m_lastAccessTimes[id] = itemData.lastAccessTime;
+	m_lastWriteTimes[id] = itemData.lastWriteTime;
+	m_attributes[id] = itemData.attributes;
+}
+
+void CompactItemStore::ReleaseItemStorage(ItemId id)
+{
+	const auto &names = m_names[id];
+	m_unusedStringChars += names.displayName.length;
+
+	if (names.parsingName != names.displayName)
+	{
+		m_unusedStringChars += names.parsingName.length;
+	}
+
+	if (names.editingName != names.displayName && names.editingName != names.parsingName)
+	{
+		m_unusedStringChars += names.editingName.length;
+	}
+
+	m_unusedPidlBytes += m_pidls[id].length;
+}
+
+void CompactItemStore::MaybeCompact()
+{
+	size_t unusedBytes = (m_unusedStringChars * sizeof(wchar_t)) + m_unusedPidlBytes;
+	size_t totalBytes = (m_stringArena.size() * sizeof(wchar_t)) + m_pidlSlab.size();
+
+	if (unusedBytes >= COMPACTION_MINIMUM_WASTE
+		&& unusedBytes >= (totalBytes / COMPACTION_WASTE_DIVISOR))
+	{
+		Compact();
+	}
+}
@@ -0,0 +1,147 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#pragma once
+
+#include <boost/core/noncopyable.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <vector>
+
+// Stores the information for the items in a folder using a compact, struct-of-arrays layout. Each
+// item is identified by a dense ID, which can be used to index into each of the arrays.
+//
+// The names for all items are stored in a single shared arena and names that are identical (e.g.
+// the display and editing names, which are the same for most items) are only stored once. Item
+// PIDLs are stored in a single slab and are referenced by offset. The size, times and attributes
+// for each item are stored as plain integers, rather than as part of a WIN32_FIND_DATA structure.
+//
+// This class is platform-neutral. PIDLs are treated as opaque blocks of bytes and times are
+// treated as opaque 64-bit values (e.g. a FILETIME converted to an integer).
+//
+// This is the item storage used by FolderModel. ShellBrowserImpl doesn't use it; its items are
+// still stored as ItemInfo_t, which is accessed directly throughout the listview, column and
+// thumbnail code.
+//
+// Note that this class isn't thread-safe.
+class CompactItemStore : private boost::noncopyable
+{
+public:
+	using ItemId = uint32_t;
+
+	// The data used to add or update an item.
+	struct ItemData
+	{
+		std::span<const std::byte> pidl;
+		std::wstring_view parsingName;
+		std::wstring_view displayName;
+		std::wstring_view editingName;
+		uint64_t size = 0;
+		uint64_t creationTime = 0;
+		uint64_t lastAccessTime = 0;
+		uint64_t lastWriteTime = 0;
+		uint32_t attributes = 0;
+	};
+
+	// A lightweight, non-owning view of a single item. The view (and any data retrieved from it)
+	// remains valid until the store is next modified.
+	class ItemView
+	{
+	public:
+		ItemView(const CompactItemStore *store, ItemId id);
+
+		ItemId GetId() const;
+		std::span<const std::byte> GetPidl() const;
+		std::wstring_view GetParsingName() const;
+		std::wstring_view GetDisplayName() const;
+		std::wstring_view GetEditingName() const;
+		uint64_t GetSize() const;
+		uint64_t GetCreationTime() const;
+		uint64_t GetLastAccessTime() const;
+		uint64_t GetLastWriteTime() const;
+		uint32_t GetAttributes() const;
+
+	private:
+		const CompactItemStore *m_store;
+		ItemId m_id;
+	};
+
+	ItemId AddItem(const ItemData &itemData);
+	void UpdateItem(ItemId id, const ItemData &itemData);
+	void RemoveItem(ItemId id);
+	void Clear();
+
+	bool HasItem(ItemId id) const;
+	ItemView GetItem(ItemId id) const;
+	size_t GetNumItems() const;
+
+	// Reclaims the space used by names and PIDLs that are no longer referenced. This is called
+	// automatically once the amount of unused space grows large enough, so it doesn't need to be
+	// called manually.
+	void Compact();
+
+	// Returns the approximate number of bytes allocated by the store.
+	size_t GetMemoryUsage() const;
+
+private:
+	// References a range of characters within the string arena. Names that are shared between
+	// the parsing, display and editing names use identical references. Note that the offset alone
+	// isn't enough to identify a shared name, since an empty name has the same offset as whichever
+	// name is added after it.
+	struct StringRef
+	{
+		uint32_t offset = 0;
+		uint32_t length = 0;
+
+		bool operator==(const StringRef &) const = default;
+	};
+
+	// References a range of bytes within the PIDL slab.
+	struct PidlRef
+	{
+		uint32_t offset = 0;
+		uint32_t length = 0;
+	};
+
+	struct NameRefs
+	{
+		StringRef parsingName;
+		StringRef displayName;
+		StringRef editingName;
+	};
+
+	// Compaction is triggered once at least this proportion of the arena/slab is unused.
+	static constexpr size_t COMPACTION_WASTE_DIVISOR = 2;
+	static constexpr size_t COMPACTION_MINIMUM_WASTE = 64 * 1024;
+
+	StringRef AddString(std::wstring_view str);
+	std::wstring_view GetString(StringRef ref) const;
+	NameRefs AddNames(const ItemData &itemData);
+	PidlRef AddPidl(std::span<const std::byte> pidl);
+	void SetItemData(ItemId id, const ItemData &itemData);
+	void ReleaseItemStorage(ItemId id);
+	void MaybeCompact();
+
+	// Per-item data, indexed by ItemId.
+	std::vector<NameRefs> m_names;
+	std::vector<PidlRef> m_pidls;
+	std::vector<uint64_t> m_sizes;
+	std::vector<uint64_t> m_creationTimes;
+	std::vector<uint64_t> m_lastAccessTimes;
+	std::vector<uint64_t> m_lastWriteTimes;
+	std::vector<uint32_t> m_attributes;
+	std::vector<bool> m_live;
+
+	// IDs of removed items, which will be reused by subsequent additions.
+	std::vector<ItemId> m_freeIds;
+	size_t m_numItems = 0;
+
+	std::vector<wchar_t> m_stringArena;
+	size_t m_unusedStringChars = 0;
+
+	std::vector<std::byte> m_pidlSlab;
+	size_t m_unusedPidlBytes = 0;
+};
@@ -401,14 +401,17 @@ void ShellBrowserImpl::UpdateItem(PCIDLIST_ABSOLUTE pidl, PCIDLIST_ABSOLUTE upda
 		return;
 	}
 
-	ULARGE_INTEGER oldFileSize = { m_itemInfoMap[*internalIndex].wfd.nFileSizeLow,
-		m_itemInfoMap[*internalIndex].wfd.nFileSizeHigh };
+	ULARGE_INTEGER oldFileSize = { m_itemInfoMap[*internalIndex]->wfd.nFileSizeLow,
+		m_itemInfoMap[*internalIndex]->wfd.nFileSizeHigh };
 	ULARGE_INTEGER newFileSize = { itemInfo->wfd.nFileSizeLow, itemInfo->wfd.nFileSizeHigh };
 
 	m_directoryState.totalDirSize += newFileSize.QuadPart - oldFileSize.QuadPart;
 
-	m_itemInfoMap[*internalIndex] = *itemInfo;
-	const ItemInfo_t &updatedItemInfo = m_itemInfoMap[*internalIndex];
+	m_itemInfoMap[*internalIndex] = std::make_shared<const ItemInfo_t>(std::move(*itemInfo));
+	InvalidatePluginColumnValues(*internalIndex);
+	InvalidateHashColumnValues(*internalIndex);
+	RequestSortAndGroupColumnValues({ *internalIndex });
+	const ItemInfo_t &updatedItemInfo = *m_itemInfoMap[*internalIndex];
 
 	auto itemIndex = LocateItemByInternalIndex(*internalIndex);
 
@@ -512,7 +515,7 @@ void ShellBrowserImpl::InvalidateAllColumnsForItem(int itemIndex)
 	}
 
 	auto numColumns = std::count_if(m_pActiveColumns->begin(), m_pActiveColumns->end(),
-		[](const Column_t &column) { return column.checked; });
+		[this](const Column_t &column) { return IsColumnShown(column); });
 
 	for (int i = 0; i < numColumns; i++)
 	{
@@ -116,8 +116,8 @@ int CALLBACK SortTemporaryStub(LPARAM lParam1, LPARAM lParam2, LPARAM lParamSort
 
 int CALLBACK ShellBrowserImpl::SortTemporary(LPARAM lParam1, LPARAM lParam2)
 {
-	return m_itemInfoMap.at(static_cast<int>(lParam1)).iRelativeSort
-		- m_itemInfoMap.at(static_cast<int>(lParam2)).iRelativeSort;
+	return m_relativeSortPositions.at(static_cast<int>(lParam1))
+		- m_relativeSortPositions.at(static_cast<int>(lParam2));
 }
 
 void ShellBrowserImpl::RepositionLocalFiles(const POINT *ppt)
@@ -190,7 +190,7 @@ void ShellBrowserImpl::RepositionLocalFiles(const POINT *ppt)
 				{
 					if (i == *index)
 					{
-						m_itemInfoMap.at((int) lvItem.lParam).iRelativeSort = iInsert;
+						m_relativeSortPositions[(int) lvItem.lParam] = iInsert;
 					}
 					else
 					{
@@ -199,7 +199,7 @@ void ShellBrowserImpl::RepositionLocalFiles(const POINT *ppt)
 							iSort++;
 						}
 
-						m_itemInfoMap.at((int) lvItem.lParam).iRelativeSort = iSort;
+						m_relativeSortPositions[(int) lvItem.lParam] = iSort;
 					}
 				}
 
@@ -207,6 +207,7 @@ void ShellBrowserImpl::RepositionLocalFiles(const POINT *ppt)
 			}
 
 			ListView_SortItems(m_hListView, SortTemporaryStub, (LPARAM) this);
+			m_relativeSortPositions.clear();
 		}
 		else
 		{
@@ -70,10 +70,10 @@ void ShellBrowserImpl::RemoveFilteredItems()
 	{
 		int internalIndex = GetItemInternalIndex(i);
 
-		if (!((m_itemInfoMap.at(internalIndex).wfd.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)
+		if (!((m_itemInfoMap.at(internalIndex)->wfd.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)
 				== FILE_ATTRIBUTE_DIRECTORY))
 		{
-			if (IsFilenameFiltered(m_itemInfoMap.at(internalIndex).displayName.c_str()))
+			if (IsFilenameFiltered(m_itemInfoMap.at(internalIndex)->displayName.c_str()))
 			{
 				RemoveFilteredItem(i, internalIndex);
 			}
@@ -87,7 +87,7 @@ void ShellBrowserImpl::RemoveFilteredItem(int iItem, int iItemInternal)
 {
 	ULARGE_INTEGER ulFileSize;
 
-	const auto &item = m_itemInfoMap.at(iItemInternal);
+	const auto &item = *m_itemInfoMap.at(iItemInternal);
 
 	if (ListView_GetItemState(m_hListView, iItem, LVIS_SELECTED) == LVIS_SELECTED)
 	{
@@ -126,12 +126,11 @@ BOOL ShellBrowserImpl::IsFilenameFiltered(const TCHAR *FileName) const
 
 void ShellBrowserImpl::UnfilterAllItems()
 {
-	for (int internalIndex : m_directoryState.filteredItemsList)
-	{
-		RestoreFilteredItem(internalIndex);
-	}
-
+	std::vector<int> internalIndexes(m_directoryState.filteredItemsList.begin(),
+		m_directoryState.filteredItemsList.end());
 	m_directoryState.filteredItemsList.clear();
+
+	RestoreFilteredItems(internalIndexes);
 	SendMessage(m_hOwner, WM_USER_UPDATEWINDOWS, 0, 0);
 }
 
@@ -157,3 +156,34 @@ void ShellBrowserImpl::RestoreFilteredItem(int internalIndex)
 
 	InsertAwaitingItems();
 }
+
+void ShellBrowserImpl::RestoreFilteredItems(std::vector<int> internalIndexes)
+{
+	// Items that are still filtered (e.g. hidden system files) are left out here, since they won't
+	// be inserted and the positions determined below assume that every item will be.
+	std::erase_if(internalIndexes,
+		[this](int internalIndex)
+		{
+			if (!IsFileFiltered(*m_itemInfoMap.at(internalIndex)))
+			{
+				return false;
+			}
+
+			m_directoryState.filteredItemsList.insert(internalIndex);
+			return true;
+		});
+
+	auto sortedPositions = DetermineItemSortedPositions(internalIndexes);
+
+	for (size_t i = 0; i < internalIndexes.size(); i++)
+	{
+		AwaitingAdd_t awaitingAdd;
+		awaitingAdd.iItem = sortedPositions[i];
+		awaitingAdd.bPosition = TRUE;
+		awaitingAdd.iAfter = sortedPositions[i] - 1;
+		awaitingAdd.iItemInternal = internalIndexes[i];
+		m_directoryState.awaitingAddList.push_back(awaitingAdd);
+	}
+
+	InsertAwaitingItems();
+}
@@ -0,0 +1,408 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "stdafx.h"
+#include "FolderModel.h"
+#include "SortedInsertion.h"
+#include <algorithm>
+#include <iterator>
+
+FolderModel::ItemId FolderModel::InsertItem(const ItemData &itemData)
+{
+	ItemId id = m_store.AddItem(itemData);
+	InitializeItemState(id);
+
+	size_t index = FindInsertIndex(id);
+	m_items.insert(m_items.begin() + index, id);
+
+	m_itemInsertedSignal(index, id);
+
+	return id;
+}
+
+std::vector<FolderModel::ItemId> FolderModel::InsertItems(std::span<const ItemData> items)
+{
+	std::vector<ItemId> ids;
+	ids.reserve(items.size());
+
+	for (const auto &itemData : items)
+	{
+		ItemId id = m_store.AddItem(itemData);
+		InitializeItemState(id);
+		ids.push_back(id);
+	}
+
+	if (ids.empty())
+	{
+		return ids;
+	}
+
+	auto isOrderedBefore = [this](ItemId id1, ItemId id2) { return IsOrderedBefore(id1, id2); };
+
+	// Only the new items need to be sorted. They can then be merged into the existing items in a
+	// single pass.
+	std::vector<ItemId> newItems = ids;
+	std::sort(newItems.begin(), newItems.end(), isOrderedBefore);
+
+	std::vector<ItemId> mergedItems;
+	mergedItems.reserve(m_items.size() + newItems.size());
+	std::merge(m_items.begin(), m_items.end(), newItems.begin(), newItems.end(),
+		std::back_inserter(mergedItems), isOrderedBefore);
+	m_items = std::move(mergedItems);
+
+	m_orderResetSignal();
+
+	return ids;
+}
+
+void FolderModel::RemoveItem(ItemId id)
+{
+	size_t index = GetItemIndex(id);
+	bool wasSelected = m_selectedStates[id];
+
+	if (wasSelected)
+	{
+		m_selectedStates[id] = false;
+		m_numSelectedItems--;
+	}
+
+	m_items.erase(m_items.begin() + index);
+	m_store.RemoveItem(id);
+
+	m_itemRemovedSignal(index, id);
+
+	if (wasSelected)
+	{
+		m_selectionChangedSignal();
+	}
+}
+
+void FolderModel::RemoveItems(std::span<const ItemId> ids)
+{
+	if (ids.empty())
+	{
+		return;
+	}
+
+	bool selectionChanged = false;
+
+	for (ItemId id : ids)
+	{
+		CHECK(HasItem(id));
+
+		if (m_selectedStates[id])
+		{
+			m_selectedStates[id] = false;
+			m_numSelectedItems--;
+			selectionChanged = true;
+		}
+
+		m_store.RemoveItem(id);
+	}
+
+	// The removed items are no longer in the store, so they can all be dropped from the display
+	// order in a single pass.
+	std::erase_if(m_items, [this](ItemId id) { return !m_store.HasItem(id); });
+
+	m_orderResetSignal();
+
+	if (selectionChanged)
+	{
+		m_selectionChangedSignal();
+	}
+}
+
+void FolderModel::UpdateItem(ItemId id, const ItemData &itemData)
+{
+	size_t oldIndex = GetItemIndex(id);
+
+	m_store.UpdateItem(id, itemData);
+
+	// Most updates (e.g. a change to an item's modification date, when sorting by name) don't
+	// affect the position of the item. In that case, the item can be left where it is.
+	bool inPosition = (oldIndex == 0 || IsOrderedBefore(m_items[oldIndex - 1], id))
+		&& (oldIndex + 1 == m_items.size() || IsOrderedBefore(id, m_items[oldIndex + 1]));
+
+	if (inPosition)
+	{
+		m_itemUpdatedSignal(oldIndex, id);
+		return;
+	}
+
+	m_items.erase(m_items.begin() + oldIndex);
+	m_itemRemovedSignal(oldIndex, id);
+
+	size_t newIndex = FindInsertIndex(id);
+	m_items.insert(m_items.begin() + newIndex, id);
+	m_itemInsertedSignal(newIndex, id);
+}
+
+void FolderModel::RenameItem(ItemId id, std::wstring_view parsingName,
+	std::wstring_view displayName, std::wstring_view editingName)
+{
+	auto item = GetItem(id);
+
+	// The existing data is copied, since it's stored within the item store and may be invalidated
+	// once the store is updated.
+	std::vector<std::byte> pidl(item.GetPidl().begin(), item.GetPidl().end());
+	std::wstring parsingNameCopy(parsingName);
+	std::wstring displayNameCopy(displayName);
+	std::wstring editingNameCopy(editingName);
+
+	ItemData itemData;
+	itemData.pidl = pidl;
+	itemData.parsingName = parsingNameCopy;
+	itemData.displayName = displayNameCopy;
+	itemData.editingName = editingNameCopy;
+	itemData.size = item.GetSize();
+	itemData.creationTime = item.GetCreationTime();
+	itemData.lastAccessTime = item.GetLastAccessTime();
+	itemData.lastWriteTime = item.GetLastWriteTime();
+	itemData.attributes = item.GetAttributes();
+	UpdateItem(id, itemData);
+}
+
+void FolderModel::Clear()
+{
+	bool hadSelection = m_numSelectedItems > 0;
+
+	m_store.Clear();
+	m_selectedStates.clear();
+	m_items.clear();
+	m_numSelectedItems = 0;
+
+	m_orderResetSignal();
+
+	if (hadSelection)
+	{
+		m_selectionChangedSignal();
+	}
+}
+
+bool FolderModel::HasItem(ItemId id) const
+{
+	return m_store.HasItem(id);
+}
+
+FolderModel::ItemView FolderModel::GetItem(ItemId id) const
+{
+	return m_store.GetItem(id);
+}
+
+size_t FolderModel::GetNumItems() const
+{
+	return m_store.GetNumItems();
+}
+
+FolderModel::ItemId FolderModel::GetItemAtIndex(size_t index) const
+{
+	CHECK_LT(index, m_items.size());
+	return m_items[index];
+}
+
+size_t FolderModel::GetItemIndex(ItemId id) const
+{
+	CHECK(HasItem(id));
+
+	auto itr = std::lower_bound(m_items.begin(), m_items.end(), id,
+		[this](ItemId id1, ItemId id2) { return IsOrderedBefore(id1, id2); });
+	CHECK(itr != m_items.end() && *itr == id);
+
+	return itr - m_items.begin();
+}
+
+void FolderModel::SetSort(Comparator comparator, bool descending)
+{
+	m_comparator = std::move(comparator);
+	m_sortDescending = descending;
+
+	SortItems();
+
+	m_orderResetSignal();
+}
+
+void FolderModel::SetSortDescending(bool descending)
+{
+	if (descending == m_sortDescending)
+	{
+		return;
+	}
+
+	m_sortDescending = descending;
+
+	// Since the display order is a strict total order, reversing the direction simply reverses the
+	// items.
+	std::reverse(m_items.begin(), m_items.end());
+
+	m_orderResetSignal();
+}
+
+void FolderModel::SelectItem(ItemId id, bool selected)
+{
+	CHECK(HasItem(id));
+
+	if (m_selectedStates[id] == selected)
+	{
+		return;
+	}
+
+	m_selectedStates[id] = selected;
+
+	if (selected)
+	{
+		m_numSelectedItems++;
+	}
+	else
+	{
+		m_numSelectedItems--;
+	}
+
+	m_selectionChangedSignal();
+}
+
+void FolderModel::SelectAll()
+{
+	if (m_numSelectedItems == m_items.size())
+	{
+		return;
+	}
+
+	for (ItemId id : m_items)
+	{
+		m_selectedStates[id] = true;
+	}
+
+	m_numSelectedItems = m_items.size();
+
+	m_selectionChangedSignal();
+}
+
+void FolderModel::ClearSelection()
+{
+	if (m_numSelectedItems == 0)
+	{
+		return;
+	}
+
+	std::fill(m_selectedStates.begin(), m_selectedStates.end(), false);
+	m_numSelectedItems = 0;
+
+	m_selectionChangedSignal();
+}
+
+bool FolderModel::IsSelected(ItemId id) const
+{
+	return HasItem(id) && m_selectedStates[id];
+}
+
+size_t FolderModel::GetNumSelectedItems() const
+{
+	return m_numSelectedItems;
+}
+
+std::vector<FolderModel::ItemId> FolderModel::GetSelectedItems() const
+{
+	std::vector<ItemId> selectedItems;
+	selectedItems.reserve(m_numSelectedItems);
+
+	for (ItemId id : m_items)
+	{
+		if (m_selectedStates[id])
+		{
+			selectedItems.push_back(id);
+		}
+	}
+
+	return selectedItems;
+}
+
+FolderModel::Snapshot FolderModel::CreateSnapshot() const
+{
+	Snapshot snapshot;
+	snapshot.items = m_items;
+	snapshot.selectedItems = GetSelectedItems();
+	return snapshot;
+}
+
+boost::signals2::connection FolderModel::AddItemInsertedObserver(
+	const ItemSignal::slot_type &observer)
+{
+	return m_itemInsertedSignal.connect(observer);
+}
+
+boost::signals2::connection FolderModel::AddItemRemovedObserver(
+	const ItemSignal::slot_type &observer)
+{
+	return m_itemRemovedSignal.connect(observer);
+}
+
+boost::signals2::connection FolderModel::AddItemUpdatedObserver(
+	const ItemSignal::slot_type &observer)
+{
+	return m_itemUpdatedSignal.connect(observer);
+}
+
+boost::signals2::connection FolderModel::AddOrderResetObserver(
+	const OrderResetSignal::slot_type &observer)
+{
+	return m_orderResetSignal.connect(observer);
+}
+
+boost::signals2::connection FolderModel::AddSelectionChangedObserver(
+	const SelectionChangedSignal::slot_type &observer)
+{
+	return m_selectionChangedSignal.connect(observer);
+}
+
+void FolderModel::InitializeItemState(ItemId id)
+{
+	if (id >= m_selectedStates.size())
+	{
+		m_selectedStates.resize(id + 1);
+	}
+
+	m_selectedStates[id] = false;
+}
+
+int FolderModel::CompareItems(ItemId id1, ItemId id2) const
+{
+	int result = 0;
+
+	if (m_comparator)
+	{
+		result = m_comparator(m_store.GetItem(id1), m_store.GetItem(id2));
+	}
+
+	if (result == 0)
+	{
+		if (id1 == id2)
+		{
+			return 0;
+		}
+
+		result = (id1 < id2) ? -1 : 1;
+	}
+
+	// The comparator can return any value, so the result is normalized before being inverted.
+	result = (result < 0) ? -1 : 1;
+
+	return m_sortDescending ? -result : result;
+}
+
+bool FolderModel::IsOrderedBefore(ItemId id1, ItemId id2) const
+{
+	return CompareItems(id1, id2) < 0;
+}
+
+size_t FolderModel::FindInsertIndex(ItemId id) const
+{
+	return SortedInsertion::FindInsertPosition(0, static_cast<int>(m_items.size()),
+		[this, id](int index) { return CompareItems(id, m_items[index]); });
+}
+
+void FolderModel::SortItems()
+{
+	std::sort(m_items.begin(), m_items.end(),
+		[this](ItemId id1, ItemId id2) { return IsOrderedBefore(id1, id2); });
+}
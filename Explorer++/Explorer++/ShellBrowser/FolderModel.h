@@ -0,0 +1,151 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#pragma once
+
+#include "CompactItemStore.h"
+#include <boost/core/noncopyable.hpp>
+#include <boost/signals2.hpp>
+#include <functional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// A window-free model of a list of items, which is used to back the search results. The model owns
+// the item data and maintains the sorted order in which the items should be displayed, along with
+// the set of selected items. Each change is reported through a signal, which allows a view to
+// mirror the model without implementing any of that logic itself.
+//
+// Filtering and grouping aren't handled here, since the main listview already applies those itself
+// (see Filtering.cpp and GroupManager.cpp).
+//
+// The display order is a strict total order: items are ordered by the sort comparator, with the
+// item ID being used to break any remaining ties. That means that the position of an item can
+// always be found using a binary search and that reversing the sort direction is equivalent to
+// reversing the order of the items.
+//
+// This class is platform-neutral. Like CompactItemStore, it isn't thread-safe.
+class FolderModel : private boost::noncopyable
+{
+public:
+	using ItemId = CompactItemStore::ItemId;
+	using ItemData = CompactItemStore::ItemData;
+	using ItemView = CompactItemStore::ItemView;
+
+	// Returns a value less than, equal to or greater than 0, depending on whether the first item
+	// should be shown before, at the same position as, or after the second item, when sorting in
+	// ascending order.
+	using Comparator = std::function<int(const ItemView &item1, const ItemView &item2)>;
+
+	// A copy of the state of the model, which can be retained (or passed to another thread)
+	// independently of the model.
+	struct Snapshot
+	{
+		// The items, in display order.
+		std::vector<ItemId> items;
+
+		// The selected items, in display order.
+		std::vector<ItemId> selectedItems;
+	};
+
+	// Signals whose parameters are the index of an item within the display order, along with the
+	// item's ID. When an item is removed, the index is the position the item previously occupied.
+	using ItemSignal = boost::signals2::signal<void(size_t index, ItemId id)>;
+
+	// Signals that the display order has been rebuilt (e.g. because the sort mode changed), in
+	// which case any view of the items needs to be refreshed in full.
+	using OrderResetSignal = boost::signals2::signal<void()>;
+
+	using SelectionChangedSignal = boost::signals2::signal<void()>;
+
+	// Items
+	ItemId InsertItem(const ItemData &itemData);
+
+	// Inserts the items in a single pass, which is significantly faster than inserting them
+	// one-by-one when there are a large number of items. A single order reset is signalled,
+	// rather than an insertion for each item.
+	std::vector<ItemId> InsertItems(std::span<const ItemData> items);
+
+	void RemoveItem(ItemId id);
+
+	// As with InsertItems(), this removes the items in a single pass and signals a single order
+	// reset.
+	void RemoveItems(std::span<const ItemId> ids);
+
+	// Updates the data for an item, moving it to its new position in the display order, if
+	// necessary.
+	void UpdateItem(ItemId id, const ItemData &itemData);
+
+	void RenameItem(ItemId id, std::wstring_view parsingName, std::wstring_view displayName,
+		std::wstring_view editingName);
+	void Clear();
+
+	bool HasItem(ItemId id) const;
+	ItemView GetItem(ItemId id) const;
+	size_t GetNumItems() const;
+
+	// Display order
+	ItemId GetItemAtIndex(size_t index) const;
+	size_t GetItemIndex(ItemId id) const;
+
+	// Sorting. Passing an empty comparator orders the items by ID (i.e. in the order they were
+	// inserted, unless an ID has been reused).
+	void SetSort(Comparator comparator, bool descending);
+
+	// Changing only the direction doesn't require the items to be compared again, so this is
+	// considerably cheaper than calling SetSort().
+	void SetSortDescending(bool descending);
+
+	// Selection
+	void SelectItem(ItemId id, bool selected);
+	void SelectAll();
+	void ClearSelection();
+	bool IsSelected(ItemId id) const;
+	size_t GetNumSelectedItems() const;
+
+	// Returns the selected items, in display order.
+	std::vector<ItemId> GetSelectedItems() const;
+
+	Snapshot CreateSnapshot() const;
+
+	boost::signals2::connection AddItemInsertedObserver(const ItemSignal::slot_type &observer);
+	boost::signals2::connection AddItemRemovedObserver(const ItemSignal::slot_type &observer);
+
+	// Called when an item's data changes, but its position within the display order doesn't.
+	boost::signals2::connection AddItemUpdatedObserver(const ItemSignal::slot_type &observer);
+
+	boost::signals2::connection AddOrderResetObserver(const OrderResetSignal::slot_type &observer);
+	boost::signals2::connection AddSelectionChangedObserver(
+		const SelectionChangedSignal::slot_type &observer);
+
+private:
+	void InitializeItemState(ItemId id);
+
+	// Compares two items using the complete display order.
+	int CompareItems(ItemId id1, ItemId id2) const;
+	bool IsOrderedBefore(ItemId id1, ItemId id2) const;
+
+	size_t FindInsertIndex(ItemId id) const;
+	void SortItems();
+
+	CompactItemStore m_store;
+
+	// Whether each item is selected, indexed by ItemId.
+	std::vector<bool> m_selectedStates;
+
+	// The items, in display order.
+	std::vector<ItemId> m_items;
+
+	size_t m_numSelectedItems = 0;
+
+	Comparator m_comparator;
+	bool m_sortDescending = false;
+
+	ItemSignal m_itemInsertedSignal;
+	ItemSignal m_itemRemovedSignal;
+	ItemSignal m_itemUpdatedSignal;
+	OrderResetSignal m_orderResetSignal;
+	SelectionChangedSignal m_selectionChangedSignal;
+};
@@ -0,0 +1,296 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "stdafx.h"
+#include "FolderPrefetcher.h"
+#include "ShellEnumerator.h"
+#include "../Helper/ShellHelper.h"
+#include "../Helper/Tracing.h"
+#include <wil/resource.h>
+#include <algorithm>
+#include <ranges>
+
+double FolderPrefetchStats::GetHitRate() const
+{
+	int numLookups = numHits + numPartialHits + numMisses;
+
+	if (numLookups == 0)
+	{
+		return 0;
+	}
+
+	return static_cast<double>(numHits + numPartialHits) / numLookups;
+}
+
+FolderPrefetcher::FolderPrefetcher(std::shared_ptr<const ShellEnumerator> shellEnumerator,
+	std::shared_ptr<concurrencpp::executor> enumerationExecutor,
+	std::shared_ptr<concurrencpp::executor> originalExecutor, SystemClock *systemClock,
+	FolderPrefetchStats *stats, const FolderPrefetchLimits &limits) :
+	m_shellEnumerator(shellEnumerator),
+	m_enumerationExecutor(enumerationExecutor),
+	m_originalExecutor(originalExecutor),
+	m_systemClock(systemClock),
+	m_stats(stats),
+	m_limits(limits),
+	m_weakPtrFactory(this)
+{
+}
+
+FolderPrefetcher::~FolderPrefetcher()
+{
+	CancelAll();
+}
+
+void FolderPrefetcher::Prefetch(const PidlAbsolute &pidl)
+{
+	Prefetch(std::vector<PidlAbsolute>{ pidl });
+}
+
+void FolderPrefetcher::Prefetch(const std::vector<PidlAbsolute> &pidls)
+{
+	RemoveExpiredResults();
+
+	// Each folder is placed at the front of the queue, so iterating in reverse leaves the highest
+	// priority folder at the very front.
+	for (const auto &pidl : pidls | std::views::reverse)
+	{
+		if (FindEntry(pidl) != m_entries.end())
+		{
+			continue;
+		}
+
+		std::erase(m_queue, pidl);
+		m_queue.push_front(pidl);
+	}
+
+	while (m_queue.size() > m_limits.maxQueuedPrefetches)
+	{
+		m_queue.pop_back();
+	}
+
+	StartQueuedPrefetches();
+}
+
+std::shared_ptr<FolderPrefetch> FolderPrefetcher::TakePrefetch(const PidlAbsolute &pidl)
+{
+	RemoveExpiredResults();
+
+	std::erase(m_queue, pidl);
+
+	auto itr = FindEntry(pidl);
+
+	if (itr == m_entries.end())
+	{
+		m_stats->numMisses++;
+		return nullptr;
+	}
+
+	if (itr->completionTime)
+	{
+		m_stats->numHits++;
+	}
+	else
+	{
+		m_stats->numPartialHits++;
+	}
+
+	auto prefetch = itr->prefetch;
+	m_entries.erase(itr);
+	return prefetch;
+}
+
+void FolderPrefetcher::CancelAll()
+{
+	for (const auto &entry : m_entries)
+	{
+		if (entry.completionTime)
+		{
+			m_stats->numDiscarded++;
+		}
+		else
+		{
+			entry.prefetch->stopSource.request_stop();
+			m_stats->numCancelled++;
+		}
+	}
+
+	m_entries.clear();
+	m_queue.clear();
+}
+
+size_t FolderPrefetcher::GetNumQueued() const
+{
+	return m_queue.size();
+}
+
+size_t FolderPrefetcher::GetNumInProgress() const
+{
+	return std::ranges::count_if(m_entries,
+		[](const auto &entry) { return !entry.completionTime.has_value(); });
+}
+
+size_t FolderPrefetcher::GetNumResults() const
+{
+	return m_entries.size() - GetNumInProgress();
+}
+
+void FolderPrefetcher::StartQueuedPrefetches()
+{
+	while (!m_queue.empty() && GetNumInProgress() < m_limits.maxConcurrentPrefetches)
+	{
+		auto pidl = m_queue.front();
+		m_queue.pop_front();
+
+		StartPrefetch(pidl);
+	}
+}
+
+void FolderPrefetcher::StartPrefetch(const PidlAbsolute &pidl)
+{
+	auto prefetch = std::make_shared<FolderPrefetch>();
+	prefetch->result = concurrencpp::shared_result<PrefetchedFolder>(EnumerateFolder(
+		m_shellEnumerator, m_enumerationExecutor, pidl, prefetch->stopSource.get_token()));
+
+	int id = m_idCounter++;
+	m_entries.push_back({ id, pidl, prefetch, std::nullopt });
+	m_stats->numStarted++;
+
+	WaitForPrefetch(m_weakPtrFactory.GetWeakPtr(), id, prefetch->result, m_originalExecutor);
+}
+
+concurrencpp::result<PrefetchedFolder> FolderPrefetcher::EnumerateFolder(
+	std::shared_ptr<const ShellEnumerator> shellEnumerator,
+	std::shared_ptr<concurrencpp::executor> enumerationExecutor, PidlAbsolute pidl,
+	std::stop_token stopToken)
+{
+	co_await concurrencpp::resume_on(enumerationExecutor);
+
+	PrefetchedFolder folder;
+	folder.pidlDirectory = pidl;
+
+	if (stopToken.stop_requested())
+	{
+		folder.hr = E_ABORT;
+		co_return folder;
+	}
+
+	{
+		TraceScope traceScope("navigation", "PrefetchFolder");
+
+		// The enumeration here is speculative, so it shouldn't compete for I/O with work the user
+		// is actually waiting on. Background mode is only applied for the duration of the
+		// enumeration, since the thread is shared with other tasks.
+		BOOL backgroundModeSet =
+			SetThreadPriority(GetCurrentThread(), THREAD_MODE_BACKGROUND_BEGIN);
+		auto restorePriority = wil::scope_exit(
+			[backgroundModeSet]
+			{
+				if (backgroundModeSet)
+				{
+					SetThreadPriority(GetCurrentThread(), THREAD_MODE_BACKGROUND_END);
+				}
+			});
+
+		// This mirrors the link handling in NavigationRequest, so that the results can be used
+		// directly by a navigation to the same folder.
+		unique_pidl_absolute targetPidl;
+		HRESULT hr = MaybeGetLinkTarget(pidl.Raw(), targetPidl);
+
+		if (SUCCEEDED(hr))
+		{
+			folder.pidlDirectory = targetPidl.get();
+		}
+
+		folder.hr = shellEnumerator->EnumerateDirectory(folder.pidlDirectory.Raw(), folder.items,
+			stopToken);
+
+		traceScope.SetArg("items", static_cast<int64_t>(folder.items.size()));
+	}
+
+	if (stopToken.stop_requested())
+	{
+		// A partial set of items is of no use.
+		folder.hr = E_ABORT;
+		folder.items.clear();
+	}
+
+	co_return folder;
+}
+
+concurrencpp::null_result FolderPrefetcher::WaitForPrefetch(WeakPtr<FolderPrefetcher> weakSelf,
+	int id, concurrencpp::shared_result<PrefetchedFolder> result,
+	std::shared_ptr<concurrencpp::executor> originalExecutor)
+{
+	co_await result;
+	co_await concurrencpp::resume_on(originalExecutor);
+
+	if (!weakSelf)
+	{
+		co_return;
+	}
+
+	weakSelf->OnPrefetchFinished(id);
+}
+
+void FolderPrefetcher::OnPrefetchFinished(int id)
+{
+	auto itr = std::ranges::find(m_entries, id, &Entry::id);
+
+	// If the entry no longer exists, the prefetch was either taken by a navigation, or cancelled.
+	if (itr != m_entries.end())
+	{
+		const auto &folder = itr->prefetch->result.get();
+
+		if (FAILED(folder.hr) || folder.items.size() > m_limits.maxItemsPerFolder)
+		{
+			// There's no point retaining this result, since a navigation will need to enumerate
+			// the folder itself.
+			m_entries.erase(itr);
+		}
+		else
+		{
+			itr->completionTime = m_systemClock->Now();
+			RemoveExcessResults();
+		}
+	}
+
+	StartQueuedPrefetches();
+}
+
+void FolderPrefetcher::RemoveExpiredResults()
+{
+	auto now = m_systemClock->Now();
+
+	auto numRemoved = std::erase_if(m_entries,
+		[this, now](const auto &entry)
+		{
+			return entry.completionTime
+				&& (now - *entry.completionTime) > m_limits.maxResultAge;
+		});
+	m_stats->numDiscarded += static_cast<int>(numRemoved);
+}
+
+void FolderPrefetcher::RemoveExcessResults()
+{
+	while (GetNumResults() > m_limits.maxResults)
+	{
+		auto oldestItr = std::ranges::min_element(m_entries,
+			[](const auto &entry1, const auto &entry2)
+			{
+				// Entries that are still in progress are ordered last, so that they're never
+				// selected here.
+				return entry1.completionTime.value_or(SystemClock::TimePoint::max())
+					< entry2.completionTime.value_or(SystemClock::TimePoint::max());
+			});
+
+		m_entries.erase(oldestItr);
+		m_stats->numDiscarded++;
+	}
+}
+
+std::vector<FolderPrefetcher::Entry>::iterator FolderPrefetcher::FindEntry(
+	const PidlAbsolute &pidl)
+{
+	return std::ranges::find(m_entries, pidl, &Entry::pidl);
+}
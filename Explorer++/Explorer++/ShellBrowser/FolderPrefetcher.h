@@ -0,0 +1,154 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#pragma once
+
+#include "../Helper/PidlHelper.h"
+#include "../Helper/SystemClock.h"
+#include "../Helper/WeakPtr.h"
+#include "../Helper/WeakPtrFactory.h"
+#include <boost/core/noncopyable.hpp>
+#include <concurrencpp/concurrencpp.h>
+#include <chrono>
+#include <deque>
+#include <memory>
+#include <optional>
+#include <stop_token>
+#include <vector>
+
+class ShellEnumerator;
+
+// The result of enumerating a folder ahead of a navigation.
+struct PrefetchedFolder
+{
+	// The folder that was enumerated. If the requested folder was a link (e.g. a symlink), this
+	// will be the link target, which is the same folder a navigation would enumerate.
+	PidlAbsolute pidlDirectory;
+
+	HRESULT hr = E_FAIL;
+	std::vector<PidlChild> items;
+};
+
+// A prefetch that's been handed over to a navigation. The enumeration may still be in progress, in
+// which case the navigation can wait for it to finish, rather than enumerating the folder again.
+struct FolderPrefetch
+{
+	concurrencpp::shared_result<PrefetchedFolder> result;
+
+	// Requesting a stop here will stop the enumeration.
+	std::stop_source stopSource;
+};
+
+// Counters used to track how effective prefetching is.
+struct FolderPrefetchStats
+{
+	int numStarted = 0;
+
+	// The number of prefetches that were stopped while in progress and the number of completed
+	// prefetches that were thrown away (because they expired or were evicted) without being used.
+	int numCancelled = 0;
+	int numDiscarded = 0;
+
+	// When a navigation starts, it will either find a completed prefetch for the target folder (a
+	// hit), a prefetch that's still in progress (a partial hit), or nothing (a miss).
+	int numHits = 0;
+	int numPartialHits = 0;
+	int numMisses = 0;
+
+	// Returns the proportion of navigations that were able to use a prefetch (whether complete or
+	// not).
+	double GetHitRate() const;
+};
+
+struct FolderPrefetchLimits
+{
+	size_t maxConcurrentPrefetches = 2;
+	size_t maxQueuedPrefetches = 8;
+	size_t maxResults = 8;
+
+	// Results for folders with more items than this won't be retained, so that the amount of
+	// memory used stays bounded.
+	size_t maxItemsPerFolder = 10000;
+
+	std::chrono::seconds maxResultAge = std::chrono::seconds(5);
+};
+
+// Enumerates folders that are likely to be navigated to in the background, so that the navigation
+// can use the results, rather than having to enumerate the folder once it starts.
+//
+// Because prefetching is speculative, the amount of work done is limited. Only a small number of
+// folders are enumerated at once (at background priority), only a small number of requests are
+// queued (with more recent requests taking priority) and results are only retained for a short
+// period of time, since they won't reflect any changes made to the folder after the enumeration.
+class FolderPrefetcher : private boost::noncopyable
+{
+public:
+	FolderPrefetcher(std::shared_ptr<const ShellEnumerator> shellEnumerator,
+		std::shared_ptr<concurrencpp::executor> enumerationExecutor,
+		std::shared_ptr<concurrencpp::executor> originalExecutor, SystemClock *systemClock,
+		FolderPrefetchStats *stats, const FolderPrefetchLimits &limits = {});
+	~FolderPrefetcher();
+
+	// Queues the folder to be enumerated. If the folder is already queued, it will be moved to the
+	// front of the queue. If it's already being enumerated (or has been enumerated), nothing will
+	// happen.
+	void Prefetch(const PidlAbsolute &pidl);
+
+	// Queues a set of folders, which should be ordered from highest to lowest priority. The
+	// folders will be placed at the front of the queue, ahead of any existing requests.
+	void Prefetch(const std::vector<PidlAbsolute> &pidls);
+
+	// This should be called when a navigation to the specified folder starts. If the folder has
+	// been (or is being) prefetched, ownership of the prefetch will be transferred to the caller.
+	std::shared_ptr<FolderPrefetch> TakePrefetch(const PidlAbsolute &pidl);
+
+	// Stops all in-progress prefetches, as well as discarding all queued requests and results.
+	void CancelAll();
+
+	size_t GetNumQueued() const;
+	size_t GetNumInProgress() const;
+	size_t GetNumResults() const;
+
+private:
+	struct Entry
+	{
+		int id;
+		PidlAbsolute pidl;
+		std::shared_ptr<FolderPrefetch> prefetch;
+
+		// Only set once the prefetch has successfully completed.
+		std::optional<SystemClock::TimePoint> completionTime;
+	};
+
+	static concurrencpp::result<PrefetchedFolder> EnumerateFolder(
+		std::shared_ptr<const ShellEnumerator> shellEnumerator,
+		std::shared_ptr<concurrencpp::executor> enumerationExecutor, PidlAbsolute pidl,
+		std::stop_token stopToken);
+	static concurrencpp::null_result WaitForPrefetch(WeakPtr<FolderPrefetcher> weakSelf, int id,
+		concurrencpp::shared_result<PrefetchedFolder> result,
+		std::shared_ptr<concurrencpp::executor> originalExecutor);
+
+	void StartQueuedPrefetches();
+	void StartPrefetch(const PidlAbsolute &pidl);
+	void OnPrefetchFinished(int id);
+	void RemoveExpiredResults();
+	void RemoveExcessResults();
+	std::vector<Entry>::iterator FindEntry(const PidlAbsolute &pidl);
+
+	const std::shared_ptr<const ShellEnumerator> m_shellEnumerator;
+	const std::shared_ptr<concurrencpp::executor> m_enumerationExecutor;
+	const std::shared_ptr<concurrencpp::executor> m_originalExecutor;
+	SystemClock *const m_systemClock;
+	FolderPrefetchStats *const m_stats;
+	const FolderPrefetchLimits m_limits;
+
+	// Queued requests, with the highest priority request at the front.
+	std::deque<PidlAbsolute> m_queue;
+
+	// Prefetches that are either in progress or have completed.
+	std::vector<Entry> m_entries;
+	int m_idCounter = 0;
+
+	WeakPtrFactory<FolderPrefetcher> m_weakPtrFactory;
+};
@@ -66,6 +66,11 @@ struct FolderSettings
 	bool autoArrange = true;
 	SortDirection sortDirection = SortDirection::Ascending;
 	SortDirection groupSortDirection = SortDirection::Ascending;
+
+	// Additional keys used to order items that are equal according to the primary sort mode (e.g.
+	// sort by type, then by date modified). Items that are still equal are ordered by name.
+	std::vector<SortKey> secondarySortKeys;
+
 	bool showInGroups = false;
 	bool showHidden = true;
 
@@ -0,0 +1,236 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "stdafx.h"
+#include "FolderSnapshotCache.h"
+#include <algorithm>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace
+{
+
+size_t GetPidlMemoryUsage(PCUIDLIST_RELATIVE pidl)
+{
+	return pidl ? ILGetSize(pidl) : 0;
+}
+
+size_t GetStringMemoryUsage(const std::wstring &str)
+{
+	return str.capacity() * sizeof(wchar_t);
+}
+
+// Child pidls are compared byte-for-byte here. Two pidls that are equivalent according to the
+// shell might still have different bytes, but that will only result in an item being refreshed
+// unnecessarily.
+std::string_view GetPidlBytes(PCITEMID_CHILD pidl)
+{
+	return { reinterpret_cast<const char *>(pidl), ILGetSize(pidl) };
+}
+
+}
+
+size_t FolderSnapshot::GetMemoryUsage() const
+{
+	size_t memoryUsage = sizeof(*this) + GetPidlMemoryUsage(pidlDirectory.Raw());
+
+	memoryUsage += items.capacity() * sizeof(std::shared_ptr<const ItemInfo_t>);
+
+	// Items may be shared with the browser that took the snapshot, but they're counted in full
+	// here, since they'll be kept alive by the snapshot once the browser moves on.
+	for (const auto &item : items)
+	{
+		memoryUsage += sizeof(ItemInfo_t);
+		memoryUsage += GetPidlMemoryUsage(item->pidlComplete.Raw());
+		memoryUsage += GetStringMemoryUsage(item->parsingName);
+		memoryUsage += GetStringMemoryUsage(item->displayName);
+
+		if (item->editingName)
+		{
+			memoryUsage += GetStringMemoryUsage(*item->editingName);
+		}
+	}
+
+	memoryUsage += sortKeys.capacity() * sizeof(SortKey);
+	memoryUsage += selectedItems.capacity() * sizeof(PidlAbsolute);
+
+	for (const auto &selectedItem : selectedItems)
+	{
+		memoryUsage += GetPidlMemoryUsage(selectedItem.Raw());
+	}
+
+	return memoryUsage;
+}
+
+bool FolderSnapshotDiff::IsEmpty() const
+{
+	return addedItems.empty() && removedItems.empty() && modifiedItems.empty();
+}
+
+FolderSnapshotDiff DiffFolderSnapshot(const FolderSnapshot &snapshot,
+	const std::vector<PidlChild> &currentItems, const FolderItemNameResolver &getParsingName)
+{
+	std::unordered_multimap<std::string_view, size_t> unmatchedSnapshotPidls;
+
+	for (size_t i = 0; i < snapshot.items.size(); i++)
+	{
+		unmatchedSnapshotPidls.emplace(GetPidlBytes(snapshot.items[i]->GetChildPidl()), i);
+	}
+
+	std::vector<size_t> unmatchedCurrentItems;
+
+	for (size_t i = 0; i < currentItems.size(); i++)
+	{
+		auto itr = unmatchedSnapshotPidls.find(GetPidlBytes(currentItems[i].Raw()));
+
+		if (itr == unmatchedSnapshotPidls.end())
+		{
+			unmatchedCurrentItems.push_back(i);
+			continue;
+		}
+
+		unmatchedSnapshotPidls.erase(itr);
+	}
+
+	std::unordered_map<std::wstring_view, size_t> unmatchedSnapshotNames;
+
+	for (const auto &[pidlBytes, index] : unmatchedSnapshotPidls)
+	{
+		unmatchedSnapshotNames.emplace(snapshot.items[index]->parsingName, index);
+	}
+
+	FolderSnapshotDiff diff;
+	std::unordered_set<size_t> modifiedSnapshotItems;
+
+	for (auto currentIndex : unmatchedCurrentItems)
+	{
+		auto parsingName = getParsingName(currentItems[currentIndex].Raw());
+
+		if (!parsingName)
+		{
+			diff.addedItems.push_back(currentIndex);
+			continue;
+		}
+
+		auto itr = unmatchedSnapshotNames.find(*parsingName);
+
+		if (itr == unmatchedSnapshotNames.end())
+		{
+			diff.addedItems.push_back(currentIndex);
+			continue;
+		}
+
+		diff.modifiedItems.emplace_back(itr->second, currentIndex);
+		modifiedSnapshotItems.insert(itr->second);
+		unmatchedSnapshotNames.erase(itr);
+	}
+
+	for (const auto &[pidlBytes, index] : unmatchedSnapshotPidls)
+	{
+		if (!modifiedSnapshotItems.contains(index))
+		{
+			diff.removedItems.push_back(index);
+		}
+	}
+
+	// The order in which items are removed doesn't otherwise matter, but sorting the indexes makes
+	// the result deterministic.
+	std::ranges::sort(diff.removedItems);
+	std::ranges::sort(diff.modifiedItems);
+
+	return diff;
+}
+
+FolderSnapshotCache::FolderSnapshotCache(size_t maxSizeInBytes) : m_maxSizeInBytes(maxSizeInBytes)
+{
+}
+
+std::shared_ptr<const FolderSnapshot> FolderSnapshotCache::Find(const PidlAbsolute &pidlDirectory)
+{
+	auto &directoryIndex = m_entries.get<ByDirectory>();
+	auto itr = directoryIndex.find(pidlDirectory);
+
+	if (itr == directoryIndex.end())
+	{
+		return nullptr;
+	}
+
+	m_entries.relocate(m_entries.begin(), m_entries.project<0>(itr));
+
+	return itr->snapshot;
+}
+
+void FolderSnapshotCache::Insert(std::shared_ptr<const FolderSnapshot> snapshot)
+{
+	Remove(snapshot->pidlDirectory);
+
+	size_t snapshotSize = snapshot->GetMemoryUsage();
+
+	if (snapshotSize > m_maxSizeInBytes)
+	{
+		return;
+	}
+
+	auto pidlDirectory = snapshot->pidlDirectory;
+	auto [itr, inserted] =
+		m_entries.push_front({ std::move(pidlDirectory), std::move(snapshot), snapshotSize });
+	DCHECK(inserted);
+
+	m_sizeInBytes += snapshotSize;
+
+	EvictEntries();
+}
+
+void FolderSnapshotCache::Remove(const PidlAbsolute &pidlDirectory)
+{
+	auto &directoryIndex = m_entries.get<ByDirectory>();
+	auto itr = directoryIndex.find(pidlDirectory);
+
+	if (itr == directoryIndex.end())
+	{
+		return;
+	}
+
+	m_sizeInBytes -= itr->sizeInBytes;
+	directoryIndex.erase(itr);
+}
+
+void FolderSnapshotCache::SetMaxSizeInBytes(size_t maxSizeInBytes)
+{
+	m_maxSizeInBytes = maxSizeInBytes;
+
+	// Unlike in Insert(), there's no guarantee here that the most recently used entry fits.
+	while (m_sizeInBytes > m_maxSizeInBytes)
+	{
+		m_sizeInBytes -= m_entries.back().sizeInBytes;
+		m_entries.pop_back();
+	}
+}
+
+size_t FolderSnapshotCache::GetMaxSizeInBytes() const
+{
+	return m_maxSizeInBytes;
+}
+
+void FolderSnapshotCache::EvictEntries()
+{
+	// The entry at the front is the one that was most recently inserted, which is never evicted
+	// here (Insert() has already checked that it fits).
+	while (m_sizeInBytes > m_maxSizeInBytes && m_entries.size() > 1)
+	{
+		m_sizeInBytes -= m_entries.back().sizeInBytes;
+		m_entries.pop_back();
+	}
+}
+
+size_t FolderSnapshotCache::GetSizeInBytes() const
+{
+	return m_sizeInBytes;
+}
+
+size_t FolderSnapshotCache::GetNumEntries() const
+{
+	return m_entries.size();
+}
@@ -0,0 +1,139 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#pragma once
+
+#include "ItemData.h"
+#include "SortModes.h"
+#include "../Helper/PidlHelper.h"
+#include <boost/core/noncopyable.hpp>
+#include <boost/multi_index/hashed_index.hpp>
+#include <boost/multi_index/member.hpp>
+#include <boost/multi_index/sequenced_index.hpp>
+#include <boost/multi_index_container.hpp>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+// A copy of the items shown in a folder, along with the state of the view, taken when the folder
+// is left. When the folder is visited again, the snapshot can be shown straight away, rather than
+// having to wait for the folder to be enumerated and for the details of each item to be retrieved.
+struct FolderSnapshot
+{
+	PidlAbsolute pidlDirectory;
+
+	// Whether hidden items were included when the folder was enumerated. A snapshot is only used
+	// when this matches the current setting.
+	bool includesHiddenItems = false;
+
+	// The items, in the order they were shown. Items that were filtered out come last. The items
+	// are shared with the browser that took the snapshot, which never modifies an item once added.
+	std::vector<std::shared_ptr<const ItemInfo_t>> items;
+
+	// The sort keys (primary key first) the items above were ordered by. If the keys are still the
+	// same when the snapshot is shown, the items don't need to be sorted again.
+	std::vector<SortKey> sortKeys;
+
+	// The index of the first visible item, used in the details and list views, along with the view
+	// origin, used in the other views.
+	int topIndex = 0;
+	POINT viewOrigin = {};
+
+	std::vector<PidlAbsolute> selectedItems;
+
+	// Returns the approximate amount of memory used by the snapshot.
+	size_t GetMemoryUsage() const;
+};
+
+// Describes how the items in a snapshot differ from the current contents of the folder.
+struct FolderSnapshotDiff
+{
+	// Indexes into the current set of items.
+	std::vector<size_t> addedItems;
+
+	// Indexes into the snapshot items.
+	std::vector<size_t> removedItems;
+
+	// Items that still exist, but have changed (e.g. because they were written to). Each pair holds
+	// the index of the item in the snapshot, followed by its index in the current set of items.
+	std::vector<std::pair<size_t, size_t>> modifiedItems;
+
+	bool IsEmpty() const;
+};
+
+// Returns the parsing name of the specified child item, or an empty value if the name can't be
+// retrieved.
+using FolderItemNameResolver = std::function<std::optional<std::wstring>(PCITEMID_CHILD pidl)>;
+
+// Compares the items in a snapshot with a fresh enumeration of the same folder. Items are first
+// matched by their child pidls. For filesystem items, the pidl includes the size and timestamps, so
+// an item whose pidl hasn't changed at all is assumed to be unchanged. Only the remaining items are
+// then matched by parsing name, so the name resolver is only invoked for items that are new or have
+// changed. Items whose name can't be resolved are treated as having been added.
+FolderSnapshotDiff DiffFolderSnapshot(const FolderSnapshot &snapshot,
+	const std::vector<PidlChild> &currentItems, const FolderItemNameResolver &getParsingName);
+
+// Caches folder snapshots, keyed by folder. The total size of the snapshots is bounded, with the
+// least recently used snapshots being evicted once the limit is exceeded.
+//
+// Snapshots are immutable once inserted, so a snapshot that's been retrieved remains valid (and
+// can be safely used on a background thread), even if it's later evicted or replaced. Note that the
+// cache itself isn't thread-safe.
+class FolderSnapshotCache : private boost::noncopyable
+{
+public:
+	explicit FolderSnapshotCache(size_t maxSizeInBytes);
+
+	// Returns the snapshot for the specified folder, marking it as the most recently used.
+	std::shared_ptr<const FolderSnapshot> Find(const PidlAbsolute &pidlDirectory);
+
+	// Adds the snapshot, replacing any existing snapshot for the same folder. If the snapshot is
+	// larger than the whole cache, it won't be stored.
+	void Insert(std::shared_ptr<const FolderSnapshot> snapshot);
+
+	void Remove(const PidlAbsolute &pidlDirectory);
+
+	// Snapshots are evicted as necessary to fit within the new limit. A limit of 0 means that
+	// nothing will be cached.
+	void SetMaxSizeInBytes(size_t maxSizeInBytes);
+	size_t GetMaxSizeInBytes() const;
+
+	size_t GetSizeInBytes() const;
+	size_t GetNumEntries() const;
+
+private:
+	struct Entry
+	{
+		PidlAbsolute pidlDirectory;
+		std::shared_ptr<const FolderSnapshot> snapshot;
+		size_t sizeInBytes;
+	};
+
+	struct ByDirectory
+	{
+	};
+
+	// clang-format off
+	using EntrySet = boost::multi_index_container<Entry,
+		boost::multi_index::indexed_by<
+			// Ordered from most to least recently used.
+			boost::multi_index::sequenced<>,
+
+			boost::multi_index::hashed_unique<
+				boost::multi_index::tag<ByDirectory>,
+				boost::multi_index::member<Entry, PidlAbsolute, &Entry::pidlDirectory>
+			>
+		>
+	>;
+	// clang-format on
+
+	void EvictEntries();
+
+	size_t m_maxSizeInBytes;
+	EntrySet m_entries;
+	size_t m_sizeInBytes = 0;
+};
@@ -13,6 +13,7 @@
 #include "../Helper/ScopedRedrawDisabler.h"
 #include "../Helper/ShellHelper.h"
 #include "../Helper/TimeHelper.h"
+#include "../Helper/Tracing.h"
 #include <boost/date_time/gregorian/gregorian.hpp>
 #include <boost/date_time/posix_time/posix_time.hpp>
 #include <boost/integer_traits.hpp>
@@ -22,6 +23,7 @@
 #include <propkey.h>
 #include <cassert>
 #include <format>
+#include <thread>
 
 namespace
 {
@@ -48,7 +50,7 @@ void ShellBrowserImpl::SetShowInGroups(bool showInGroups)
 	{
 		ListView_EnableGroupView(m_hListView, false);
 		ListView_RemoveAllGroups(m_hListView);
-		m_directoryState.groups.clear();
+		m_directoryState.groups.Clear();
 	}
 	else
 	{
@@ -64,86 +66,142 @@ int CALLBACK ShellBrowserImpl::GroupComparisonStub(int id1, int id2, void *data)
 
 int ShellBrowserImpl::GroupComparison(int id1, int id2)
 {
-	const auto &group1 = GetListViewGroupById(id1);
-	const auto &group2 = GetListViewGroupById(id2);
-	int comparisonResult = 0;
+	return m_directoryState.groups.CompareGroups(id1, id2, GetGroupOrder(),
+		m_folderSettings.groupSortDirection == +SortDirection::Descending);
+}
 
-	if (group1.relativeSortPosition == INT_MIN && group2.relativeSortPosition != INT_MIN)
+ItemGroupSet::Order ShellBrowserImpl::GetGroupOrder() const
+{
+	switch (m_folderSettings.groupMode)
 	{
-		comparisonResult = -1;
+	case SortMode::Size:
+	case SortMode::TotalSize:
+	case SortMode::Created:
+	case SortMode::DateModified:
+	case SortMode::Accessed:
+		return ItemGroupSet::Order::RelativePosition;
+
+	default:
+		return ItemGroupSet::Order::Name;
 	}
-	else if (group1.relativeSortPosition != INT_MIN && group2.relativeSortPosition == INT_MIN)
+}
+
+const ShellBrowserImpl::ListViewGroup &ShellBrowserImpl::GetListViewGroupById(int groupId) const
+{
+	return m_directoryState.groups.GetGroup(groupId);
+}
+
+int ShellBrowserImpl::DetermineItemGroup(int iItemInternal)
+{
+	if (IsPluginSortMode(m_folderSettings.groupMode))
 	{
-		comparisonResult = 1;
+		return GetOrCreateListViewGroup(DeterminePluginColumnGroupInfos({ iItemInternal })[0]);
 	}
-	else if (group1.relativeSortPosition == INT_MIN && group2.relativeSortPosition == INT_MIN)
+
+	if (IsHashSortMode(m_folderSettings.groupMode))
 	{
-		comparisonResult = 0;
+		return GetOrCreateListViewGroup(DetermineHashColumnGroupInfos({ iItemInternal })[0]);
 	}
-	else if (group1.relativeSortPosition == INT_MAX && group2.relativeSortPosition != INT_MAX)
+
+	return GetOrCreateListViewGroup(DetermineItemGroupInfo(getBasicItemInfo(iItemInternal)));
+}
+
+std::vector<ShellBrowserImpl::GroupInfo> ShellBrowserImpl::DetermineItemGroupInfos(
+	const std::vector<int> &internalIndexes) const
+{
+	TraceScope traceScope("shell_browser", "DetermineItemGroupInfos");
+	traceScope.SetArg("items", static_cast<int64_t>(internalIndexes.size()));
+
+	// Plugin columns are evaluated on their own thread pool.
+	if (IsPluginSortMode(m_folderSettings.groupMode))
 	{
-		comparisonResult = 1;
+		return DeterminePluginColumnGroupInfos(internalIndexes);
 	}
-	else if (group1.relativeSortPosition != INT_MAX && group2.relativeSortPosition == INT_MAX)
+
+	// Files are hashed on the hash service's thread pool.
+	if (IsHashSortMode(m_folderSettings.groupMode))
 	{
-		comparisonResult = -1;
+		return DetermineHashColumnGroupInfos(internalIndexes);
 	}
-	else if (group1.relativeSortPosition == INT_MAX && group2.relativeSortPosition == INT_MAX)
+
+	// Below this number of items, it's not worth starting any threads.
+	const size_t PARALLEL_THRESHOLD = 256;
+
+	// Determining an item's group can involve reading data from the file (e.g. version information
+	// or camera properties), so the work is split across several threads.
+	const size_t MAX_THREADS = 8;
+
+	std::vector<BasicItemInfo_t> basicItemInfos;
+	basicItemInfos.reserve(internalIndexes.size());
+
+	for (int internalIndex : internalIndexes)
+	{
+		basicItemInfos.push_back(getBasicItemInfo(internalIndex));
+	}
+
+	std::vector<std::optional<GroupInfo>> groupInfos(basicItemInfos.size());
+	size_t numThreads = std::min<size_t>(std::max(std::thread::hardware_concurrency(), 1u),
+		MAX_THREADS);
+
+	if (basicItemInfos.size() < PARALLEL_THRESHOLD || numThreads == 1)
 	{
-		comparisonResult = 0;
+		for (size_t i = 0; i < basicItemInfos.size(); i++)
+		{
+			groupInfos[i] = DetermineItemGroupInfo(basicItemInfos[i]);
+		}
 	}
 	else
 	{
-		switch (m_folderSettings.groupMode)
+		if (m_groupThreadPool.size() < static_cast<int>(numThreads))
 		{
-		case SortMode::Size:
-		case SortMode::TotalSize:
-		case SortMode::Created:
-		case SortMode::DateModified:
-		case SortMode::Accessed:
-			comparisonResult = GroupRelativePositionComparison(group1, group2);
-			break;
+			m_groupThreadPool.resize(static_cast<int>(numThreads));
+		}
 
-		default:
-			comparisonResult = GroupNameComparison(group1, group2);
-			break;
+		std::vector<std::future<void>> futures;
+		size_t chunkSize = (basicItemInfos.size() + numThreads - 1) / numThreads;
+
+		// Each chunk writes to a distinct range within groupInfos, so no synchronization is
+		// needed. Note that this method only reads from the object's state and the calling thread
+		// waits below for all the work to finish.
+		for (size_t start = 0; start < basicItemInfos.size(); start += chunkSize)
+		{
+			size_t end = std::min(start + chunkSize, basicItemInfos.size());
+
+			futures.push_back(m_groupThreadPool.push(
+				[this, &basicItemInfos, &groupInfos, start, end](int id)
+				{
+					UNREFERENCED_PARAMETER(id);
+
+					TraceScope traceScope("shell_browser", "DetermineItemGroupInfoChunk");
+					traceScope.SetArg("items", static_cast<int64_t>(end - start));
+
+					for (size_t i = start; i < end; i++)
+					{
+						groupInfos[i] = DetermineItemGroupInfo(basicItemInfos[i]);
+					}
+				}));
 		}
-	}
 
-	if (comparisonResult == 0)
-	{
-		comparisonResult = GroupNameComparison(group1, group2);
+		for (auto &future : futures)
+		{
+			future.get();
+		}
 	}
 
-	if (m_folderSettings.groupSortDirection == +SortDirection::Descending)
+	std::vector<GroupInfo> finalGroupInfos;
+	finalGroupInfos.reserve(groupInfos.size());
+
+	for (auto &groupInfo : groupInfos)
 	{
-		comparisonResult = -comparisonResult;
+		finalGroupInfos.push_back(std::move(*groupInfo));
 	}
 
-	return comparisonResult;
+	return finalGroupInfos;
 }
 
-int ShellBrowserImpl::GroupNameComparison(const ListViewGroup &group1, const ListViewGroup &group2)
+ShellBrowserImpl::GroupInfo ShellBrowserImpl::DetermineItemGroupInfo(
+	const BasicItemInfo_t &basicItemInfo) const
 {
-	return group1.name.compare(group2.name);
-}
-
-int ShellBrowserImpl::GroupRelativePositionComparison(const ListViewGroup &group1,
-	const ListViewGroup &group2)
-{
-	return group1.relativeSortPosition - group2.relativeSortPosition;
-}
-
-const ShellBrowserImpl::ListViewGroup ShellBrowserImpl::GetListViewGroupById(int groupId)
-{
-	auto itr = m_directoryState.groups.get<0>().find(groupId);
-	CHECK(itr != m_directoryState.groups.get<0>().end());
-	return *itr;
-}
-
-int ShellBrowserImpl::DetermineItemGroup(int iItemInternal)
-{
-	BasicItemInfo_t basicItemInfo = getBasicItemInfo(iItemInternal);
 	std::optional<GroupInfo> groupInfo;
 
 	switch (m_folderSettings.groupMode)
@@ -302,19 +360,18 @@ int ShellBrowserImpl::DetermineItemGroup(int iItemInternal)
 	if (!groupInfo)
 	{
 		groupInfo = GroupInfo(
-			ResourceHelper::LoadString(m_resourceInstance, IDS_GROUPBY_UNSPECIFIED), INT_MIN);
+			ResourceHelper::LoadString(m_resourceInstance, IDS_GROUPBY_UNSPECIFIED),
+			ItemGroupSet::POSITION_FIRST);
 	}
 
-	return GetOrCreateListViewGroup(*groupInfo);
+	return *groupInfo;
 }
 
 int ShellBrowserImpl::GetOrCreateListViewGroup(const GroupInfo &groupInfo)
 {
 	// Note that this will return an existing group, if a group already exists with the specified
 	// name.
-	auto &groupNameIndex = m_directoryState.groups.get<1>();
-	auto [group, inserted] = groupNameIndex.emplace(groupInfo);
-	return group->id;
+	return m_directoryState.groups.GetOrCreateGroup(groupInfo);
 }
 
 /* TODO: These groups have changed as of Windows Vista.*/
@@ -819,31 +876,53 @@ std::optional<ShellBrowserImpl::GroupInfo> ShellBrowserImpl::DetermineItemNetwor
 
 void ShellBrowserImpl::MoveItemsIntoGroups()
 {
-	LVITEM item;
-	int nItems;
-	int iGroupId;
-	int i = 0;
+	TRACE_SCOPE("shell_browser", "MoveItemsIntoGroups");
 
 	ScopedRedrawDisabler redrawDisabler(m_hListView);
 
 	ListView_RemoveAllGroups(m_hListView);
-	m_directoryState.groups.clear();
+	m_directoryState.groups.Clear();
 
 	ListView_EnableGroupView(m_hListView, true);
 
-	nItems = ListView_GetItemCount(m_hListView);
+	int numItems = ListView_GetItemCount(m_hListView);
+	std::vector<int> internalIndexes;
+	internalIndexes.reserve(numItems);
 
-	for (i = 0; i < nItems; i++)
+	for (int i = 0; i < numItems; i++)
 	{
-		item.mask = LVIF_PARAM;
-		item.iItem = i;
-		item.iSubItem = 0;
-		ListView_GetItem(m_hListView, &item);
+		internalIndexes.push_back(GetItemInternalIndex(i));
+	}
+
+	RequestSortAndGroupColumnValues(internalIndexes);
 
-		iGroupId = DetermineItemGroup((int) item.lParam);
+	// All items are bucketed in a single pass, so the final size of each group is known before any
+	// group is added to the listview.
+	auto groupIds = m_directoryState.groups.AddItems(DetermineItemGroupInfos(internalIndexes));
 
-		InsertItemIntoGroup(i, iGroupId);
+	// Since the final group order is known, each group can be appended directly, which avoids the
+	// comparisons that would otherwise be performed when inserting each group.
+	auto orderedGroupIds = m_directoryState.groups.GetNonEmptyGroupsInOrder(GetGroupOrder(),
+		m_folderSettings.groupSortDirection == +SortDirection::Descending);
+
+	for (int groupId : orderedGroupIds)
+	{
+		AppendGroupToListView(GetListViewGroupById(groupId));
 	}
+
+	for (int i = 0; i < numItems; i++)
+	{
+		LVITEM item;
+		item.mask = LVIF_GROUPID;
+		item.iItem = i;
+		item.iSubItem = 0;
+		item.iGroupId = groupIds[i];
+		ListView_SetItem(m_hListView, &item);
+	}
+
+	// The headers were generated with the final item counts above, so there's no need to update
+	// them again.
+	m_directoryState.groups.TakeChangedGroups();
 }
 
 void ShellBrowserImpl::InsertItemIntoGroup(int index, int groupId)
@@ -877,7 +956,7 @@ void ShellBrowserImpl::InsertItemIntoGroup(int index, int groupId)
 
 void ShellBrowserImpl::EnsureGroupExistsInListView(int groupId)
 {
-	ListViewGroup group = GetListViewGroupById(groupId);
+	const auto &group = GetListViewGroupById(groupId);
 
 	if (group.numItems == 0)
 	{
@@ -887,20 +966,39 @@ void ShellBrowserImpl::EnsureGroupExistsInListView(int groupId)
 
 void ShellBrowserImpl::InsertGroupIntoListView(const ListViewGroup &listViewGroup)
 {
-	std::wstring header = GenerateGroupHeader(listViewGroup);
+	std::wstring header;
 
 	LVINSERTGROUPSORTED lvigs;
-	lvigs.lvGroup.cbSize = sizeof(LVGROUP);
-	lvigs.lvGroup.mask = LVGF_HEADER | LVGF_GROUPID | LVGF_STATE;
-	lvigs.lvGroup.state = LVGS_COLLAPSIBLE;
-	lvigs.lvGroup.pszHeader = header.data();
-	lvigs.lvGroup.iGroupId = listViewGroup.id;
-	lvigs.lvGroup.stateMask = 0;
+	lvigs.lvGroup = BuildListViewGroup(listViewGroup, header);
 	lvigs.pfnGroupCompare = GroupComparisonStub;
 	lvigs.pvData = this;
 	ListView_InsertGroupSorted(m_hListView, &lvigs);
 }
 
+void ShellBrowserImpl::AppendGroupToListView(const ListViewGroup &listViewGroup)
+{
+	std::wstring header;
+	LVGROUP lvGroup = BuildListViewGroup(listViewGroup, header);
+	ListView_InsertGroup(m_hListView, -1, &lvGroup);
+}
+
+// Note that the returned structure references the header string, so the string needs to remain
+// valid for as long as the structure is used.
+LVGROUP ShellBrowserImpl::BuildListViewGroup(const ListViewGroup &listViewGroup,
+	std::wstring &header)
+{
+	header = GenerateGroupHeader(listViewGroup);
+
+	LVGROUP lvGroup;
+	lvGroup.cbSize = sizeof(LVGROUP);
+	lvGroup.mask = LVGF_HEADER | LVGF_GROUPID | LVGF_STATE;
+	lvGroup.state = LVGS_COLLAPSIBLE;
+	lvGroup.pszHeader = header.data();
+	lvGroup.iGroupId = listViewGroup.id;
+	lvGroup.stateMask = 0;
+	return lvGroup;
+}
+
 void ShellBrowserImpl::RemoveGroupFromListView(const ListViewGroup &listViewGroup)
 {
 	ListView_RemoveGroup(m_hListView, listViewGroup.id);
@@ -924,35 +1022,41 @@ std::wstring ShellBrowserImpl::GenerateGroupHeader(const ListViewGroup &listView
 
 void ShellBrowserImpl::OnItemRemovedFromGroup(int groupId)
 {
-	auto &groupIdIndex = m_directoryState.groups.get<0>();
-	auto itr = groupIdIndex.find(groupId);
-	CHECK(itr != groupIdIndex.end());
-
-	auto updatedGroup = *itr;
-	updatedGroup.numItems--;
-	m_directoryState.groups.replace(itr, updatedGroup);
+	bool groupEmpty = m_directoryState.groups.RemoveItem(groupId);
 
-	if (updatedGroup.numItems == 0)
+	if (groupEmpty)
 	{
-		RemoveGroupFromListView(updatedGroup);
+		RemoveGroupFromListView(GetListViewGroupById(groupId));
 	}
-	else
+
+	if (!m_deferGroupHeaderUpdates)
 	{
-		UpdateGroupHeader(updatedGroup);
+		UpdateChangedGroupHeaders();
 	}
 }
 
 void ShellBrowserImpl::OnItemAddedToGroup(int groupId)
 {
-	auto &groupIdIndex = m_directoryState.groups.get<0>();
-	auto itr = groupIdIndex.find(groupId);
-	CHECK(itr != groupIdIndex.end());
+	m_directoryState.groups.AddItem(groupId);
 
-	auto updatedGroup = *itr;
-	updatedGroup.numItems++;
-	m_directoryState.groups.replace(itr, updatedGroup);
+	if (!m_deferGroupHeaderUpdates)
+	{
+		UpdateChangedGroupHeaders();
+	}
+}
 
-	UpdateGroupHeader(updatedGroup);
+// Only the headers for groups whose item count has changed are updated.
+void ShellBrowserImpl::UpdateChangedGroupHeaders()
+{
+	for (int groupId : m_directoryState.groups.TakeChangedGroups())
+	{
+		const auto &group = GetListViewGroupById(groupId);
+
+		if (group.numItems > 0)
+		{
+			UpdateGroupHeader(group);
+		}
+	}
 }
 
 std::optional<int> ShellBrowserImpl::GetItemGroupId(int index)
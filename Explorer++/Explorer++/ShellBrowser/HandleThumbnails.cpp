@@ -6,6 +6,7 @@
 #include "ShellBrowserImpl.h"
 #include "ItemData.h"
 #include "ViewModes.h"
+#include "../Helper/Tracing.h"
 #include <wil/com.h>
 #include <thumbcache.h>
 #include <list>
@@ -32,7 +33,7 @@ void ShellBrowserImpl::SetupThumbnailsView(int shellImageListType)
 void ShellBrowserImpl::RemoveThumbnailsView()
 {
 	m_thumbnailThreadPool.clear_queue();
-	m_thumbnailResults.clear();
+	m_thumbnailResults.Invalidate();
 
 	InvalidateAllItemImages();
 
@@ -59,34 +60,30 @@ void ShellBrowserImpl::InvalidateAllItemImages()
 
 void ShellBrowserImpl::QueueThumbnailTask(int internalIndex)
 {
-	int thumbnailResultID = m_thumbnailResultIDCounter++;
-
 	BasicItemInfo_t basicItemInfo = getBasicItemInfo(internalIndex);
 
-	auto result = m_thumbnailThreadPool.push(
-		[listView = m_hListView, thumbnailResultID, internalIndex, basicItemInfo,
-			thumbnailSize = m_thumbnailItemWidth](int id) -> std::optional<ThumbnailResult_t>
+	m_thumbnailThreadPool.push(
+		[sender = m_thumbnailResults.GetSender(), internalIndex, basicItemInfo,
+			thumbnailSize = m_thumbnailItemWidth](int id)
 		{
 			UNREFERENCED_PARAMETER(id);
 
+			TRACE_SCOPE("thumbnails", "GetThumbnail");
+
 			auto bitmap = GetThumbnail(basicItemInfo.pidlComplete.get(), thumbnailSize,
 				WTS_EXTRACT | WTS_SCALETOREQUESTEDSIZE);
 
 			if (!bitmap)
 			{
-				return std::nullopt;
+				// Thumbnail lookup failed.
+				return;
 			}
 
-			PostMessage(listView, WM_APP_THUMBNAIL_RESULT_READY, thumbnailResultID, 0);
-
 			ThumbnailResult_t result;
 			result.itemInternalIndex = internalIndex;
 			result.bitmap = std::move(bitmap);
-
-			return result;
+			sender.Send(std::move(result));
 		});
-
-	m_thumbnailResults.insert({ thumbnailResultID, std::move(result) });
 }
 
 std::optional<int> ShellBrowserImpl::GetCachedThumbnailIndex(const ItemInfo_t &itemInfo)
@@ -145,31 +142,16 @@ wil::unique_hbitmap ShellBrowserImpl::GetThumbnail(PCIDLIST_ABSOLUTE pidl, UINT
 		reinterpret_cast<HBITMAP>(CopyImage(bitmap, IMAGE_BITMAP, 0, 0, LR_DEFAULTCOLOR)));
 }
 
-void ShellBrowserImpl::ProcessThumbnailResult(int thumbnailResultId)
+void ShellBrowserImpl::ProcessThumbnailResult(const ThumbnailResult_t &result)
 {
-	auto itr = m_thumbnailResults.find(thumbnailResultId);
-
-	if (itr == m_thumbnailResults.end())
-	{
-		return;
-	}
-
 	if (!IsThumbnailsViewMode(m_folderSettings.viewMode))
 	{
 		return;
 	}
 
-	auto result = itr->second.get();
-
-	if (!result)
-	{
-		// Thumbnail lookup failed.
-		return;
-	}
-
-	int imageIndex = GetExtractedThumbnail(result->bitmap.get());
+	int imageIndex = GetExtractedThumbnail(result.bitmap.get());
 
-	auto index = LocateItemByInternalIndex(result->itemInternalIndex);
+	auto index = LocateItemByInternalIndex(result.itemInternalIndex);
 
 	if (!index)
 	{
@@ -254,7 +236,7 @@ void ShellBrowserImpl::DrawIconThumbnailInternal(HDC hdcBacking, int iInternalIn
 	int iIconWidth;
 	int iIconHeight;
 
-	SHGetFileInfo((LPCTSTR) m_itemInfoMap.at(iInternalIndex).pidlComplete.Raw(), 0, &shfi,
+	SHGetFileInfo((LPCTSTR) m_itemInfoMap.at(iInternalIndex)->pidlComplete.Raw(), 0, &shfi,
 		sizeof(shfi), SHGFI_PIDL | SHGFI_SYSICONINDEX);
 
 	hIcon = ImageList_GetIcon(m_directoryState.thumbnailsShellImageList, shfi.iIcon, ILD_NORMAL);
@@ -0,0 +1,325 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "stdafx.h"
+#include "HashColumns.h"
+#include "FileHashService.h"
+#include "MainResource.h"
+#include "ResourceHelper.h"
+#include "ShellBrowserImpl.h"
+
+namespace
+{
+
+// Only files have a hash. Folders (and items that don't exist in the filesystem) are shown with an
+// empty value.
+bool CanHashItem(const ItemFindData &wfd, bool isFindDataValid)
+{
+	return isFindDataValid && !WI_IsFlagSet(wfd.dwFileAttributes, FILE_ATTRIBUTE_DIRECTORY);
+}
+
+uint64_t GetFindDataSize(const ItemFindData &wfd)
+{
+	return (static_cast<uint64_t>(wfd.nFileSizeHigh) << 32) | wfd.nFileSizeLow;
+}
+
+int64_t GetFindDataLastWriteTime(const ItemFindData &wfd)
+{
+	return static_cast<int64_t>(
+		(static_cast<uint64_t>(wfd.ftLastWriteTime.dwHighDateTime) << 32)
+		| wfd.ftLastWriteTime.dwLowDateTime);
+}
+
+std::wstring HashToColumnText(const std::optional<std::string> &hash)
+{
+	if (!hash)
+	{
+		return {};
+	}
+
+	// The hash only contains hexadecimal digits, so a direct conversion is safe here.
+	return std::wstring(hash->begin(), hash->end());
+}
+
+}
+
+HashAlgorithm GetHashColumnAlgorithm(ColumnType columnType)
+{
+	switch (columnType)
+	{
+	case ColumnType::HashCrc32:
+		return HashAlgorithm::Crc32;
+
+	case ColumnType::HashXxHash64:
+		return HashAlgorithm::XxHash64;
+
+	case ColumnType::HashSha256:
+		return HashAlgorithm::Sha256;
+
+	default:
+		LOG(FATAL) << "Not a hash column";
+		__assume(0);
+	}
+}
+
+HashAlgorithm GetHashSortModeAlgorithm(SortMode sortMode)
+{
+	switch (sortMode)
+	{
+	case SortMode::HashCrc32:
+		return HashAlgorithm::Crc32;
+
+	case SortMode::HashXxHash64:
+		return HashAlgorithm::XxHash64;
+
+	case SortMode::HashSha256:
+		return HashAlgorithm::Sha256;
+
+	default:
+		LOG(FATAL) << "Not a hash sort mode";
+		__assume(0);
+	}
+}
+
+ColumnType GetHashAlgorithmColumnType(HashAlgorithm algorithm)
+{
+	switch (algorithm)
+	{
+	case HashAlgorithm::Crc32:
+		return ColumnType::HashCrc32;
+
+	case HashAlgorithm::XxHash64:
+		return ColumnType::HashXxHash64;
+
+	case HashAlgorithm::Sha256:
+		return ColumnType::HashSha256;
+	}
+
+	LOG(FATAL) << "Unknown hash algorithm";
+	__assume(0);
+}
+
+SortMode GetHashAlgorithmSortMode(HashAlgorithm algorithm)
+{
+	switch (algorithm)
+	{
+	case HashAlgorithm::Crc32:
+		return SortMode::HashCrc32;
+
+	case HashAlgorithm::XxHash64:
+		return SortMode::HashXxHash64;
+
+	case HashAlgorithm::Sha256:
+		return SortMode::HashSha256;
+	}
+
+	LOG(FATAL) << "Unknown hash algorithm";
+	__assume(0);
+}
+
+void ShellBrowserImpl::QueueHashColumnTask(int itemInternalIndex, ColumnType columnType)
+{
+	auto algorithm = GetHashColumnAlgorithm(columnType);
+	const auto &values = m_directoryState.hashColumnValues[algorithm];
+	auto itr = values.find(itemInternalIndex);
+
+	if (itr != values.end())
+	{
+		// As with plugin columns, the cached value is delivered in the same way as any other
+		// result.
+		m_columnResults.GetSender().Send({ itemInternalIndex, columnType, itr->second });
+		return;
+	}
+
+	// The column text will be set once the file has been hashed.
+	RequestHashColumnValue(algorithm, itemInternalIndex);
+}
+
+// Starts hashing the specified item in the background, unless the value has already been
+// calculated or requested. Items that can't be hashed are given an empty value immediately.
+void ShellBrowserImpl::RequestHashColumnValue(HashAlgorithm algorithm, int internalIndex)
+{
+	auto &values = m_directoryState.hashColumnValues[algorithm];
+	auto &pendingValues = m_directoryState.pendingHashColumnValues[algorithm];
+
+	if (values.contains(internalIndex) || pendingValues.contains(internalIndex))
+	{
+		return;
+	}
+
+	const auto &itemInfo = *m_itemInfoMap.at(internalIndex);
+	auto columnType = GetHashAlgorithmColumnType(algorithm);
+
+	if (!CanHashItem(itemInfo.wfd, itemInfo.isFindDataValid))
+	{
+		values.emplace(internalIndex, L"");
+		m_columnResults.GetSender().Send({ internalIndex, columnType, L"" });
+		return;
+	}
+
+	int requestId = m_directoryState.nextColumnValueRequestId++;
+	pendingValues[internalIndex] = requestId;
+
+	m_fileHashService->GetThreadPool().push(
+		[sender = m_columnResults.GetSender(), fileHashService = m_fileHashService,
+			stopToken = m_hashColumnStopSource->GetToken(), path = itemInfo.parsingName,
+			size = GetFindDataSize(itemInfo.wfd),
+			lastWriteTime = GetFindDataLastWriteTime(itemInfo.wfd), algorithm, internalIndex,
+			columnType, requestId](int id)
+		{
+			UNREFERENCED_PARAMETER(id);
+
+			if (stopToken.stop_requested())
+			{
+				return;
+			}
+
+			auto hash =
+				fileHashService->GetFileHash(path, algorithm, size, lastWriteTime, stopToken);
+
+			if (stopToken.stop_requested())
+			{
+				return;
+			}
+
+			sender.Send(
+				{ internalIndex, columnType, HashToColumnText(hash), std::nullopt, requestId });
+		});
+}
+
+// Stores a hash that was calculated in the background. Returns false if the value is out of date
+// and should be ignored.
+bool ShellBrowserImpl::ProcessHashColumnResult(const ColumnResult_t &result)
+{
+	if (!result.requestId)
+	{
+		// This is a value that was already cached.
+		return true;
+	}
+
+	auto algorithm = GetHashColumnAlgorithm(result.columnType);
+	auto &pendingValues = m_directoryState.pendingHashColumnValues[algorithm];
+	auto itr = pendingValues.find(result.itemInternalIndex);
+
+	if (itr == pendingValues.end() || itr->second != *result.requestId)
+	{
+		// The item has been removed or updated since the value was requested.
+		return false;
+	}
+
+	pendingValues.erase(itr);
+	m_directoryState.hashColumnValues[algorithm].insert_or_assign(result.itemInternalIndex,
+		result.columnText);
+
+	if (pendingValues.empty())
+	{
+		OnColumnValuesRetrieved(GetHashAlgorithmSortMode(algorithm));
+	}
+
+	return true;
+}
+
+// Returns the hash column text for the specified item, or null if the file hasn't been hashed yet.
+const std::wstring *ShellBrowserImpl::GetHashColumnValue(HashAlgorithm algorithm,
+	int internalIndex) const
+{
+	auto valuesItr = m_directoryState.hashColumnValues.find(algorithm);
+
+	if (valuesItr == m_directoryState.hashColumnValues.end())
+	{
+		return nullptr;
+	}
+
+	auto itr = valuesItr->second.find(internalIndex);
+
+	if (itr == valuesItr->second.end())
+	{
+		return nullptr;
+	}
+
+	return &itr->second;
+}
+
+int ShellBrowserImpl::CompareHashColumnValues(SortMode sortMode, int internalIndex1,
+	int internalIndex2) const
+{
+	auto algorithm = GetHashSortModeAlgorithm(sortMode);
+	const auto *value1 = GetHashColumnValue(algorithm, internalIndex1);
+	const auto *value2 = GetHashColumnValue(algorithm, internalIndex2);
+
+	// Files that are still being hashed are kept together at one end. They'll be moved into
+	// position once all the files have been hashed.
+	if (!value1 || !value2)
+	{
+		return static_cast<int>(!value1) - static_cast<int>(!value2);
+	}
+
+	// Items without a hash are placed first, which keeps them together, rather than spread between
+	// the files.
+	int comparisonResult = value1->compare(*value2);
+	return (comparisonResult > 0) - (comparisonResult < 0);
+}
+
+// Grouping by a hash column places files with identical content in the same group, which makes
+// this a simple way of finding duplicates within a single folder.
+std::vector<ShellBrowserImpl::GroupInfo> ShellBrowserImpl::DetermineHashColumnGroupInfos(
+	const std::vector<int> &internalIndexes) const
+{
+	auto algorithm = GetHashSortModeAlgorithm(m_folderSettings.groupMode);
+
+	std::vector<GroupInfo> groupInfos;
+	groupInfos.reserve(internalIndexes.size());
+
+	for (int internalIndex : internalIndexes)
+	{
+		const auto *value = GetHashColumnValue(algorithm, internalIndex);
+
+		// Files that are still being hashed are temporarily placed in the unspecified group.
+		if (!value || value->empty())
+		{
+			groupInfos.emplace_back(
+				ResourceHelper::LoadString(m_resourceInstance, IDS_GROUPBY_UNSPECIFIED),
+				ItemGroupSet::POSITION_FIRST);
+			continue;
+		}
+
+		groupInfos.emplace_back(*value);
+	}
+
+	return groupInfos;
+}
+
+void ShellBrowserImpl::InvalidateHashColumnValues(int internalIndex)
+{
+	for (auto &[algorithm, values] : m_directoryState.hashColumnValues)
+	{
+		values.erase(internalIndex);
+	}
+
+	// Any value that's still pending is for the previous state of the item, so it will be ignored
+	// when it arrives. Handling a set of values that have all been retrieved can result in further
+	// values being requested, which is why that's done once the loop has finished.
+	std::vector<HashAlgorithm> retrievedAlgorithms;
+
+	for (auto &[algorithm, pendingValues] : m_directoryState.pendingHashColumnValues)
+	{
+		if (pendingValues.erase(internalIndex) > 0 && pendingValues.empty())
+		{
+			retrievedAlgorithms.push_back(algorithm);
+		}
+	}
+
+	for (auto algorithm : retrievedAlgorithms)
+	{
+		OnColumnValuesRetrieved(GetHashAlgorithmSortMode(algorithm));
+	}
+}
+
+void ShellBrowserImpl::CancelHashColumnTasks()
+{
+	// Replacing the stop source requests a stop on the previous source, so any files that are
+	// currently being hashed for this tab will stop being read.
+	m_hashColumnStopSource = std::make_unique<ScopedStopSource>();
+	m_directoryState.pendingHashColumnValues.clear();
+}
@@ -0,0 +1,16 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#pragma once
+
+#include "Columns.h"
+#include "SortModes.h"
+#include "../Helper/ContentHash.h"
+
+// Each hash column (and its corresponding sort mode) displays the hash of a file's content, as
+// calculated by one of the supported algorithms.
+HashAlgorithm GetHashColumnAlgorithm(ColumnType columnType);
+HashAlgorithm GetHashSortModeAlgorithm(SortMode sortMode);
+ColumnType GetHashAlgorithmColumnType(HashAlgorithm algorithm);
+SortMode GetHashAlgorithmSortMode(HashAlgorithm algorithm);
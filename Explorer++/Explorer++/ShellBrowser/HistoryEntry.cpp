@@ -7,7 +7,7 @@
 
 HistoryEntry::HistoryEntry(const PidlAbsolute &pidl, InitialNavigationType type) :
 	m_id(idCounter++),
-	m_pidl(pidl),
+	m_pidl(PidlInternTable::GetInstance().Intern(pidl.Raw())),
 	m_type(type)
 {
 }
@@ -19,7 +19,7 @@ int HistoryEntry::GetId() const
 
 const PidlAbsolute &HistoryEntry::GetPidl() const
 {
-	return m_pidl;
+	return *m_pidl;
 }
 
 bool HistoryEntry::IsInitialEntry() const
@@ -32,12 +32,17 @@ HistoryEntry::InitialNavigationType HistoryEntry::GetInitialNavigationType() con
 	return m_type;
 }
 
-const std::vector<PidlAbsolute> &HistoryEntry::GetSelectedItems() const
+std::vector<PidlAbsolute> HistoryEntry::GetSelectedItems() const
 {
-	return m_selectedItems;
+	return m_selectedItems.Unpack(m_pidl->Raw());
 }
 
 void HistoryEntry::SetSelectedItems(const std::vector<PidlAbsolute> &pidls)
 {
-	m_selectedItems = pidls;
+	m_selectedItems = PackedPidlList(m_pidl->Raw(), pidls);
+}
+
+size_t HistoryEntry::GetMemoryUsage() const
+{
+	return sizeof(*this) + m_selectedItems.GetSizeInBytes();
 }
@@ -4,7 +4,9 @@
 
 #pragma once
 
+#include "../Helper/PackedPidlList.h"
 #include "../Helper/PidlHelper.h"
+#include "../Helper/PidlInternTable.h"
 #include <boost/core/noncopyable.hpp>
 #include <vector>
 
@@ -32,14 +34,21 @@ public:
 	const PidlAbsolute &GetPidl() const;
 	bool IsInitialEntry() const;
 	InitialNavigationType GetInitialNavigationType() const;
-	const std::vector<PidlAbsolute> &GetSelectedItems() const;
+	std::vector<PidlAbsolute> GetSelectedItems() const;
 	void SetSelectedItems(const std::vector<PidlAbsolute> &pidls);
 
+	// Returns the approximate amount of memory used by this entry, not including the pidl, which
+	// is shared with any other entries for the same folder.
+	size_t GetMemoryUsage() const;
+
 private:
 	static inline int idCounter = 0;
 	const int m_id;
 
-	const PidlAbsolute m_pidl;
+	// A tab can build up a large number of history entries over time, many of which will refer to
+	// the same folders. The pidl is therefore shared via the intern table and the selected items
+	// are packed relative to that pidl.
+	const PidlInternTable::InternedPidl m_pidl;
 	const InitialNavigationType m_type;
-	std::vector<PidlAbsolute> m_selectedItems;
+	PackedPidlList m_selectedItems;
 };
@@ -6,6 +6,8 @@
 
 #include "../Helper/ShellHelper.h"
 #include <wil/resource.h>
+#include <optional>
+#include <string>
 
 struct BasicItemInfo_t
 {
@@ -41,3 +43,91 @@ struct BasicItemInfo_t
 		return fullPath;
 	}
 };
+
+// The parts of WIN32_FIND_DATA that are retained for each item in a folder. The name arrays make up
+// the bulk of WIN32_FIND_DATA (over 500 of its roughly 600 bytes) and largely duplicate the names
+// already stored for each item, so they're not kept. The member names match those in
+// WIN32_FIND_DATA, so that the fields can be accessed in the same way.
+struct ItemFindData
+{
+	ItemFindData() = default;
+
+	explicit ItemFindData(const WIN32_FIND_DATA &wfd) :
+		dwFileAttributes(wfd.dwFileAttributes),
+		ftCreationTime(wfd.ftCreationTime),
+		ftLastAccessTime(wfd.ftLastAccessTime),
+		ftLastWriteTime(wfd.ftLastWriteTime),
+		nFileSizeHigh(wfd.nFileSizeHigh),
+		nFileSizeLow(wfd.nFileSizeLow)
+	{
+	}
+
+	WIN32_FIND_DATA ToFindData(const TCHAR *fileName) const
+	{
+		WIN32_FIND_DATA wfd = {};
+		wfd.dwFileAttributes = dwFileAttributes;
+		wfd.ftCreationTime = ftCreationTime;
+		wfd.ftLastAccessTime = ftLastAccessTime;
+		wfd.ftLastWriteTime = ftLastWriteTime;
+		wfd.nFileSizeHigh = nFileSizeHigh;
+		wfd.nFileSizeLow = nFileSizeLow;
+		StringCchCopy(wfd.cFileName, std::size(wfd.cFileName), fileName);
+		return wfd;
+	}
+
+	DWORD dwFileAttributes = 0;
+	FILETIME ftCreationTime = {};
+	FILETIME ftLastAccessTime = {};
+	FILETIME ftLastWriteTime = {};
+	DWORD nFileSizeHigh = 0;
+	DWORD nFileSizeLow = 0;
+};
+
+struct ItemInfo_t
+{
+	PidlAbsolute pidlComplete;
+	ItemFindData wfd;
+	bool isFindDataValid;
+	std::wstring parsingName;
+	std::wstring displayName;
+
+	// The editing name is the same as the display name for the vast majority of items, so it's
+	// only stored separately when it differs. This can save a significant amount of memory in
+	// large folders.
+	std::optional<std::wstring> editingName;
+
+	/* These are only used for drives. They are
+	needed for when a drive is removed from the
+	system, in which case the drive name is needed
+	so that the removed drive can be found. */
+	BOOL bDrive;
+	TCHAR szDrive[4];
+
+	ItemInfo_t() : isFindDataValid(false), bDrive(FALSE)
+	{
+	}
+
+	// The child pidl is the last item in the complete pidl, so it isn't stored separately.
+	PCITEMID_CHILD GetChildPidl() const
+	{
+		return ILFindLastID(pidlComplete.Raw());
+	}
+
+	const std::wstring &GetEditingName() const
+	{
+		return editingName ? *editingName : displayName;
+	}
+
+	// Returns the name of the item within the filesystem (i.e. the name that would be returned in
+	// WIN32_FIND_DATA::cFileName). When the find data is valid, that's the last component of the
+	// parsing name. Otherwise, the display name is used.
+	const TCHAR *GetFileName() const
+	{
+		if (isFindDataValid)
+		{
+			return PathFindFileName(parsingName.c_str());
+		}
+
+		return displayName.c_str();
+	}
+};
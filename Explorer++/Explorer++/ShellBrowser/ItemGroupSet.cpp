@@ -0,0 +1,182 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "stdafx.h"
+#include "ItemGroupSet.h"
+
+int ItemGroupSet::GetOrCreateGroup(const GroupInfo &groupInfo)
+{
+	auto [itr, inserted] = m_groupNameIndex.try_emplace(groupInfo.name, m_groupIdCounter);
+
+	if (inserted)
+	{
+		int id = m_groupIdCounter++;
+		m_groups.emplace(id, Group{ id, groupInfo.name, groupInfo.relativeSortPosition, 0 });
+	}
+
+	return itr->second;
+}
+
+std::vector<int> ItemGroupSet::AddItems(const std::vector<GroupInfo> &groupInfos)
+{
+	std::vector<int> groupIds;
+	groupIds.reserve(groupInfos.size());
+
+	// Items in a folder are frequently already clustered by group (e.g. when grouping by name in a
+	// folder that's sorted by name), so the previous lookup is cached to avoid hashing the group
+	// name in that case.
+	const GroupInfo *previousGroupInfo = nullptr;
+	Group *previousGroup = nullptr;
+
+	for (const auto &groupInfo : groupInfos)
+	{
+		Group *group;
+
+		if (previousGroupInfo && previousGroupInfo->name == groupInfo.name)
+		{
+			group = previousGroup;
+		}
+		else
+		{
+			group = &GetGroupMutable(GetOrCreateGroup(groupInfo));
+		}
+
+		group->numItems++;
+		m_changedGroups.insert(group->id);
+		groupIds.push_back(group->id);
+
+		previousGroupInfo = &groupInfo;
+		previousGroup = group;
+	}
+
+	return groupIds;
+}
+
+bool ItemGroupSet::AddItem(int groupId)
+{
+	auto &group = GetGroupMutable(groupId);
+	group.numItems++;
+	m_changedGroups.insert(groupId);
+
+	return group.numItems == 1;
+}
+
+bool ItemGroupSet::RemoveItem(int groupId)
+{
+	auto &group = GetGroupMutable(groupId);
+	CHECK_GT(group.numItems, 0);
+	group.numItems--;
+	m_changedGroups.insert(groupId);
+
+	return group.numItems == 0;
+}
+
+const ItemGroupSet::Group &ItemGroupSet::GetGroup(int groupId) const
+{
+	const auto *group = MaybeGetGroup(groupId);
+	CHECK(group);
+	return *group;
+}
+
+const ItemGroupSet::Group *ItemGroupSet::MaybeGetGroup(int groupId) const
+{
+	auto itr = m_groups.find(groupId);
+
+	if (itr == m_groups.end())
+	{
+		return nullptr;
+	}
+
+	return &itr->second;
+}
+
+ItemGroupSet::Group &ItemGroupSet::GetGroupMutable(int groupId)
+{
+	auto itr = m_groups.find(groupId);
+	CHECK(itr != m_groups.end());
+	return itr->second;
+}
+
+size_t ItemGroupSet::GetNumGroups() const
+{
+	return m_groups.size();
+}
+
+void ItemGroupSet::Clear()
+{
+	// Note that the ID counter isn't reset, so that IDs for groups that have been removed won't
+	// be reused.
+	m_groups.clear();
+	m_groupNameIndex.clear();
+	m_changedGroups.clear();
+}
+
+int ItemGroupSet::CompareGroups(int groupId1, int groupId2, Order order, bool descending) const
+{
+	const auto &group1 = GetGroup(groupId1);
+	const auto &group2 = GetGroup(groupId2);
+	int comparisonResult = 0;
+
+	bool group1First = group1.relativeSortPosition == POSITION_FIRST;
+	bool group2First = group2.relativeSortPosition == POSITION_FIRST;
+	bool group1Last = group1.relativeSortPosition == POSITION_LAST;
+	bool group2Last = group2.relativeSortPosition == POSITION_LAST;
+
+	if (group1First != group2First)
+	{
+		comparisonResult = group1First ? -1 : 1;
+	}
+	else if (group1Last != group2Last)
+	{
+		comparisonResult = group1Last ? 1 : -1;
+	}
+	else if (!group1First && !group1Last && order == Order::RelativePosition)
+	{
+		if (group1.relativeSortPosition < group2.relativeSortPosition)
+		{
+			comparisonResult = -1;
+		}
+		else if (group1.relativeSortPosition > group2.relativeSortPosition)
+		{
+			comparisonResult = 1;
+		}
+	}
+
+	if (comparisonResult == 0)
+	{
+		comparisonResult = group1.name.compare(group2.name);
+	}
+
+	if (descending)
+	{
+		comparisonResult = -comparisonResult;
+	}
+
+	return comparisonResult;
+}
+
+std::vector<int> ItemGroupSet::GetNonEmptyGroupsInOrder(Order order, bool descending) const
+{
+	std::vector<int> groupIds;
+
+	for (const auto &[id, group] : m_groups)
+	{
+		if (group.numItems > 0)
+		{
+			groupIds.push_back(id);
+		}
+	}
+
+	std::sort(groupIds.begin(), groupIds.end(), [this, order, descending](int id1, int id2)
+		{ return CompareGroups(id1, id2, order, descending) < 0; });
+
+	return groupIds;
+}
+
+std::vector<int> ItemGroupSet::TakeChangedGroups()
+{
+	std::vector<int> changedGroups(m_changedGroups.begin(), m_changedGroups.end());
+	m_changedGroups.clear();
+	return changedGroups;
+}
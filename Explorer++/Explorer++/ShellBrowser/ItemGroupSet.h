@@ -0,0 +1,101 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#pragma once
+
+#include <climits>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+// Tracks the groups that the items in a folder are divided into, along with the number of items in
+// each group. Groups are identified by name; each distinct name maps to a single group ID.
+//
+// Items can be assigned in bulk, in which case every item is bucketed in a single pass, with the
+// final group order being calculated once. Groups whose item count changes are recorded, so that
+// only the affected group headers need to be updated.
+//
+// This class is platform-neutral; it doesn't interact with the listview directly.
+class ItemGroupSet
+{
+public:
+	// Determines how groups are ordered relative to each other.
+	enum class Order
+	{
+		// Groups are ordered by name.
+		Name,
+
+		// Groups are ordered by their relative sort position (e.g. size groups are ordered from
+		// smallest to largest), falling back to the name.
+		RelativePosition
+	};
+
+	// Items with this position will always appear first (when sorted in ascending order).
+	static constexpr int POSITION_FIRST = INT_MIN;
+
+	// Items with this position will always appear last (when sorted in ascending order).
+	static constexpr int POSITION_LAST = INT_MAX;
+
+	struct GroupInfo
+	{
+		std::wstring name;
+		int relativeSortPosition;
+
+		explicit GroupInfo(const std::wstring &name) : name(name), relativeSortPosition(0)
+		{
+		}
+
+		GroupInfo(const std::wstring &name, int relativeSortPosition) :
+			name(name),
+			relativeSortPosition(relativeSortPosition)
+		{
+		}
+	};
+
+	struct Group
+	{
+		int id;
+		std::wstring name;
+		int relativeSortPosition;
+		int numItems;
+	};
+
+	// Returns the ID of the group with the specified name, creating the group if necessary.
+	int GetOrCreateGroup(const GroupInfo &groupInfo);
+
+	// Assigns each of the provided items to a group and returns the resulting group IDs (in the
+	// same order). The item counts for each group are updated in the same pass.
+	std::vector<int> AddItems(const std::vector<GroupInfo> &groupInfos);
+
+	// Adds a single item to the specified group. Returns true if the group was previously empty.
+	bool AddItem(int groupId);
+
+	// Removes a single item from the specified group. Returns true if the group is now empty.
+	bool RemoveItem(int groupId);
+
+	const Group &GetGroup(int groupId) const;
+	const Group *MaybeGetGroup(int groupId) const;
+	size_t GetNumGroups() const;
+	void Clear();
+
+	// Compares two groups, returning a value less than, equal to or greater than 0, depending on
+	// whether the first group should be shown before, at the same position as, or after the
+	// second group.
+	int CompareGroups(int groupId1, int groupId2, Order order, bool descending) const;
+
+	// Returns the IDs of all non-empty groups, in the order they should be displayed.
+	std::vector<int> GetNonEmptyGroupsInOrder(Order order, bool descending) const;
+
+	// Returns the IDs of the groups whose item count has changed since this method was last called.
+	std::vector<int> TakeChangedGroups();
+
+private:
+	Group &GetGroupMutable(int groupId);
+
+	std::unordered_map<int, Group> m_groups;
+	std::unordered_map<std::wstring, int> m_groupNameIndex;
+	std::unordered_set<int> m_changedGroups;
+	int m_groupIdCounter = 0;
+};
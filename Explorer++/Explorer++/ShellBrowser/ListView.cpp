@@ -107,6 +107,14 @@ LRESULT ShellBrowserImpl::ListViewProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPAR
 		HANDLE_WM_RBUTTONDOWN(hwnd, wParam, lParam, OnRButtonDown);
 		break;
 
+	case WM_MOUSEMOVE:
+	{
+		POINT pt;
+		POINTSTOPOINT(pt, MAKEPOINTS(lParam));
+		OnListViewMouseMove(pt);
+	}
+	break;
+
 	case WM_MOUSEWHEEL:
 		if (OnMouseWheel(GET_X_LPARAM(lParam), GET_Y_LPARAM(lParam), GET_WHEEL_DELTA_WPARAM(wParam),
 				GET_KEYSTATE_WPARAM(wParam)))
@@ -126,17 +134,6 @@ LRESULT ShellBrowserImpl::ListViewProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPAR
 		OnClipboardUpdate();
 		return 0;
 
-	case WM_APP_COLUMN_RESULT_READY:
-		ProcessColumnResult(static_cast<int>(wParam));
-		break;
-
-	case WM_APP_THUMBNAIL_RESULT_READY:
-		ProcessThumbnailResult(static_cast<int>(wParam));
-		break;
-
-	case WM_APP_INFO_TIP_READY:
-		ProcessInfoTipResult(static_cast<int>(wParam));
-		break;
 	}
 
 	return DefSubclassProc(hwnd, uMsg, wParam, lParam);
@@ -239,6 +236,77 @@ bool ShellBrowserImpl::OnListViewLeftButtonDoubleClick(const POINT *pt)
 	return true;
 }
 
+void ShellBrowserImpl::OnListViewMouseMove(const POINT &pt)
+{
+	if (!m_folderPrefetcher)
+	{
+		return;
+	}
+
+	LVHITTESTINFO hitTestInfo = {};
+	hitTestInfo.pt = pt;
+	int index = ListView_HitTest(m_hListView, &hitTestInfo);
+
+	std::optional<int> internalIndex;
+
+	if (index != -1 && WI_IsAnyFlagSet(hitTestInfo.flags, LVHT_ONITEM))
+	{
+		internalIndex = GetItemInternalIndex(index);
+	}
+
+	if (internalIndex == m_hoverPrefetchItem)
+	{
+		return;
+	}
+
+	m_hoverPrefetchTimer.cancel();
+	m_hoverPrefetchItem = internalIndex;
+
+	if (!internalIndex)
+	{
+		return;
+	}
+
+	m_hoverPrefetchTimer = m_app->GetRuntime()->GetTimerQueue()->make_one_shot_timer(
+		static_cast<size_t>(HOVER_PREFETCH_DELAY.count()),
+		m_app->GetRuntime()->GetUiThreadExecutor(),
+		[weakSelf = m_weakPtrFactory.GetWeakPtr(), internalIndex = *internalIndex]
+		{
+			if (weakSelf)
+			{
+				weakSelf->OnHoverPrefetchTimer(internalIndex);
+			}
+		});
+}
+
+void ShellBrowserImpl::OnHoverPrefetchTimer(int internalIndex)
+{
+	if (m_hoverPrefetchItem != internalIndex)
+	{
+		return;
+	}
+
+	auto itr = m_itemInfoMap.find(internalIndex);
+
+	if (itr == m_itemInfoMap.end())
+	{
+		return;
+	}
+
+	// Items like zip files are folders, but are also streams. Enumerating them can be expensive,
+	// so they're excluded here.
+	SFGAOF attributes = SFGAO_FOLDER | SFGAO_STREAM;
+	HRESULT hr = GetItemAttributes(itr->second->pidlComplete.Raw(), &attributes);
+
+	if (FAILED(hr) || WI_IsFlagClear(attributes, SFGAO_FOLDER)
+		|| WI_IsFlagSet(attributes, SFGAO_STREAM))
+	{
+		return;
+	}
+
+	PrefetchFolder(itr->second->pidlComplete);
+}
+
 void ShellBrowserImpl::OnListViewMButtonDown(const POINT *pt)
 {
 	LV_HITTESTINFO ht;
@@ -387,7 +455,7 @@ void ShellBrowserImpl::OnListViewGetDisplayInfo(LPARAM lParam)
 	if (IsThumbnailsViewMode(m_folderSettings.viewMode)
 		&& (plvItem->mask & LVIF_IMAGE) == LVIF_IMAGE)
 	{
-		const ItemInfo_t &itemInfo = m_itemInfoMap.at(internalIndex);
+		const ItemInfo_t &itemInfo = *m_itemInfoMap.at(internalIndex);
 		auto cachedThumbnailIndex = GetCachedThumbnailIndex(itemInfo);
 
 		if (cachedThumbnailIndex)
@@ -416,7 +484,7 @@ void ShellBrowserImpl::OnListViewGetDisplayInfo(LPARAM lParam)
 
 	if ((plvItem->mask & LVIF_IMAGE) == LVIF_IMAGE)
 	{
-		const ItemInfo_t &itemInfo = m_itemInfoMap.at(internalIndex);
+		const ItemInfo_t &itemInfo = *m_itemInfoMap.at(internalIndex);
 		auto cachedIconIndex = m_cachedIcons->MaybeGetIconIndex(itemInfo.parsingName);
 
 		if (cachedIconIndex)
@@ -491,39 +559,40 @@ BOOL ShellBrowserImpl::OnListViewGetEmptyMarkup(NMLVEMPTYMARKUP *emptyMarkup)
 
 void ShellBrowserImpl::QueueInfoTipTask(int internalIndex, const std::wstring &existingInfoTip)
 {
-	int infoTipResultId = m_infoTipResultIDCounter++;
-
 	BasicItemInfo_t basicItemInfo = getBasicItemInfo(internalIndex);
 	Config configCopy = *m_config;
 	bool virtualFolder = InVirtualFolder();
 
-	auto result = m_infoTipsThreadPool.push(
-		[this, infoTipResultId, internalIndex, basicItemInfo, configCopy, virtualFolder,
-			existingInfoTip](int id)
+	m_infoTipsThreadPool.push(
+		[sender = m_infoTipResults.GetSender(), resourceInstance = m_resourceInstance,
+			internalIndex, basicItemInfo, configCopy, virtualFolder, existingInfoTip](int id)
 		{
 			UNREFERENCED_PARAMETER(id);
 
-			auto result = GetInfoTipAsync(m_hListView, infoTipResultId, internalIndex,
-				basicItemInfo, configCopy, m_resourceInstance, virtualFolder);
+			auto result = GetInfoTipAsync(internalIndex, basicItemInfo, configCopy,
+				resourceInstance, virtualFolder);
+
+			if (!result)
+			{
+				return;
+			}
 
 			// If the item name is truncated in the listview,
 			// existingInfoTip will contain that value. Therefore, it's
 			// important that the rest of the infotip is concatenated onto
 			// that value if it's there.
-			if (result && !existingInfoTip.empty())
+			if (!existingInfoTip.empty())
 			{
 				result->infoTip = existingInfoTip + L"\n" + result->infoTip;
 			}
 
-			return result;
+			sender.Send(std::move(*result));
 		});
-
-	m_infoTipResults.insert({ infoTipResultId, std::move(result) });
 }
 
-std::optional<ShellBrowserImpl::InfoTipResult> ShellBrowserImpl::GetInfoTipAsync(HWND listView,
-	int infoTipResultId, int internalIndex, const BasicItemInfo_t &basicItemInfo,
-	const Config &config, HINSTANCE resourceInstance, bool virtualFolder)
+std::optional<ShellBrowserImpl::InfoTipResult> ShellBrowserImpl::GetInfoTipAsync(
+	int internalIndex, const BasicItemInfo_t &basicItemInfo, const Config &config,
+	HINSTANCE resourceInstance, bool virtualFolder)
 {
 	std::wstring infoTip;
 
@@ -558,8 +627,6 @@ std::optional<ShellBrowserImpl::InfoTipResult> ShellBrowserImpl::GetInfoTipAsync
 		infoTip = std::format(L"{}: {}", dateModified, fileModificationText);
 	}
 
-	PostMessage(listView, WM_APP_INFO_TIP_READY, infoTipResultId, 0);
-
 	InfoTipResult result;
 	result.itemInternalIndex = internalIndex;
 	result.infoTip = infoTip;
@@ -567,24 +634,9 @@ std::optional<ShellBrowserImpl::InfoTipResult> ShellBrowserImpl::GetInfoTipAsync
 	return result;
 }
 
-void ShellBrowserImpl::ProcessInfoTipResult(int infoTipResultId)
+void ShellBrowserImpl::ProcessInfoTipResult(const InfoTipResult &result)
 {
-	auto itr = m_infoTipResults.find(infoTipResultId);
-
-	if (itr == m_infoTipResults.end())
-	{
-		return;
-	}
-
-	auto result = itr->second.get();
-	m_infoTipResults.erase(itr);
-
-	if (!result)
-	{
-		return;
-	}
-
-	auto index = LocateItemByInternalIndex(result->itemInternalIndex);
+	auto index = LocateItemByInternalIndex(result.itemInternalIndex);
 
 	if (!index)
 	{
@@ -592,7 +644,7 @@ void ShellBrowserImpl::ProcessInfoTipResult(int infoTipResultId)
 	}
 
 	TCHAR infoTipText[256];
-	StringCchCopy(infoTipText, std::size(infoTipText), result->infoTip.c_str());
+	StringCchCopy(infoTipText, std::size(infoTipText), result.infoTip.c_str());
 
 	LVSETINFOTIP infoTip;
 	infoTip.cbSize = sizeof(infoTip);
@@ -659,11 +711,11 @@ void ShellBrowserImpl::UpdateFileSelectionInfo(int internalIndex, BOOL selected)
 	ULARGE_INTEGER ulFileSize;
 	BOOL isFolder;
 
-	isFolder = (m_itemInfoMap.at(internalIndex).wfd.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)
+	isFolder = (m_itemInfoMap.at(internalIndex)->wfd.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)
 		== FILE_ATTRIBUTE_DIRECTORY;
 
-	ulFileSize.LowPart = m_itemInfoMap.at(internalIndex).wfd.nFileSizeLow;
-	ulFileSize.HighPart = m_itemInfoMap.at(internalIndex).wfd.nFileSizeHigh;
+	ulFileSize.LowPart = m_itemInfoMap.at(internalIndex)->wfd.nFileSizeLow;
+	ulFileSize.HighPart = m_itemInfoMap.at(internalIndex)->wfd.nFileSizeHigh;
 
 	if (selected)
 	{
@@ -767,16 +819,10 @@ void ShellBrowserImpl::OnListViewKeyDown(const NMLVKEYDOWN *lvKeyDown)
 	}
 }
 
-const ShellBrowserImpl::ItemInfo_t &ShellBrowserImpl::GetItemByIndex(int index) const
-{
-	int internalIndex = GetItemInternalIndex(index);
-	return m_itemInfoMap.at(internalIndex);
-}
-
-ShellBrowserImpl::ItemInfo_t &ShellBrowserImpl::GetItemByIndex(int index)
+const ItemInfo_t &ShellBrowserImpl::GetItemByIndex(int index) const
 {
 	int internalIndex = GetItemInternalIndex(index);
-	return m_itemInfoMap.at(internalIndex);
+	return *m_itemInfoMap.at(internalIndex);
 }
 
 int ShellBrowserImpl::GetItemInternalIndex(int item) const
@@ -847,7 +893,7 @@ void ShellBrowserImpl::OnListViewHeaderRightClick(const POINTS &cursorPos)
 		auto itr = std::find(commonColumns.begin(), commonColumns.end(), column.type);
 		bool inCommonColumns = (itr != commonColumns.end());
 
-		if (!column.checked && !inCommonColumns)
+		if (!IsColumnAvailable(column.type) || (!column.checked && !inCommonColumns))
 		{
 			continue;
 		}
@@ -856,8 +902,7 @@ void ShellBrowserImpl::OnListViewHeaderRightClick(const POINTS &cursorPos)
 		mii.cbSize = sizeof(mii);
 		mii.fMask = MIIM_STRING | MIIM_STATE | MIIM_ID;
 
-		std::wstring columnText = ResourceHelper::LoadString(m_resourceInstance,
-			LookupColumnNameStringIndex(column.type));
+		std::wstring columnText = GetColumnName(column.type);
 
 		if (column.checked)
 		{
@@ -992,7 +1037,7 @@ void ShellBrowserImpl::SetFileAttributesForSelection()
 		NSetFileAttributesDialogExternal::SetFileAttributesInfo sfai;
 
 		const ItemInfo_t &item = GetItemByIndex(index);
-		sfai.wfd = item.wfd;
+		sfai.wfd = item.wfd.ToFindData(item.GetFileName());
 		StringCchCopy(sfai.szFullFileName, std::size(sfai.szFullFileName),
 			item.parsingName.c_str());
 
@@ -1000,7 +1045,7 @@ void ShellBrowserImpl::SetFileAttributesForSelection()
 	}
 
 	SetFileAttributesDialog setFileAttributesDialog(m_resourceInstance, m_hListView,
-		m_app->GetThemeManager(), sfaiList);
+		m_app->GetThemeManager(), m_app->GetRuntime(), m_fileActionHandler, sfaiList);
 	setFileAttributesDialog.ShowModalDialog();
 }
 
@@ -1153,17 +1198,17 @@ BOOL ShellBrowserImpl::OnListViewBeginLabelEdit(const NMLVDISPINFO *dispInfo)
 			auto *extension = PathFindExtension(displayName.c_str());
 
 			if (*extension != '\0'
-				&& lstrcmp((item.editingName + extension).c_str(), displayName.c_str()) == 0)
+				&& lstrcmp((item.GetEditingName() + extension).c_str(), displayName.c_str()) == 0)
 			{
 				useEditingName = false;
 			}
 		}
 		else
 		{
-			auto *extension = PathFindExtension(item.editingName.c_str());
+			auto *extension = PathFindExtension(item.GetEditingName().c_str());
 
 			if (*extension != '\0'
-				&& lstrcmp((displayName + extension).c_str(), item.editingName.c_str()) == 0)
+				&& lstrcmp((displayName + extension).c_str(), item.GetEditingName().c_str()) == 0)
 			{
 				useEditingName = false;
 			}
@@ -1187,7 +1232,7 @@ BOOL ShellBrowserImpl::OnListViewBeginLabelEdit(const NMLVDISPINFO *dispInfo)
 	// nothing that needs to be changed if editing is canceled.
 	if (useEditingName)
 	{
-		SetWindowText(editControl, item.editingName.c_str());
+		SetWindowText(editControl, item.GetEditingName().c_str());
 	}
 
 	ItemNameEditControl::CreateNew(editControl, m_acceleratorManager,
@@ -1213,14 +1258,14 @@ BOOL ShellBrowserImpl::OnListViewEndLabelEdit(const NMLVDISPINFO *dispInfo)
 
 	const auto &item = GetItemByIndex(dispInfo->item.iItem);
 
-	if (newFilename == item.editingName)
+	if (newFilename == item.GetEditingName())
 	{
 		return FALSE;
 	}
 
 	if (!WI_IsFlagSet(item.wfd.dwFileAttributes, FILE_ATTRIBUTE_DIRECTORY))
 	{
-		auto *extension = PathFindExtension(item.wfd.cFileName);
+		auto *extension = PathFindExtension(item.GetFileName());
 
 		bool extensionHidden = !m_config->globalFolderSettings.showExtensions
 			|| (m_config->globalFolderSettings.hideLinkExtension
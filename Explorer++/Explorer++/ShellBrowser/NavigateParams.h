@@ -60,6 +60,12 @@ public:
 	// When navigating up, this will store the pidl of the previous item.
 	PidlAbsolute originalPidl;
 
+	// Indicates whether previously retrieved items can be used for the navigation. That is, if a
+	// snapshot of the target folder is available, the snapshot will be shown straight away, with
+	// the folder then being enumerated in the background. Similarly, if the target folder has been
+	// prefetched, the prefetched items will be used, instead of enumerating the folder again.
+	bool useCachedItems = true;
+
 	static NavigateParams Normal(PCIDLIST_ABSOLUTE pidl,
 		HistoryEntryType historyEntryType = HistoryEntryType::AddEntry)
 	{
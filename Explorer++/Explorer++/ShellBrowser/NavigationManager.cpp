@@ -28,15 +28,39 @@ NavigationManager::~NavigationManager() = default;
 
 void NavigationManager::StartNavigation(const NavigateParams &navigateParams)
 {
+	std::shared_ptr<const FolderSnapshot> snapshot;
+
+	if (m_snapshotProvider && navigateParams.useCachedItems)
+	{
+		snapshot = m_snapshotProvider(navigateParams);
+	}
+
+	std::shared_ptr<FolderPrefetch> prefetch;
+
+	if (m_prefetchProvider && navigateParams.useCachedItems && !snapshot)
+	{
+		prefetch = m_prefetchProvider(navigateParams);
+	}
+
 	auto navigationRequest = std::make_unique<NavigationRequest>(m_shellBrowser, m_navigationEvents,
 		static_cast<NavigationRequestDelegate *>(this), m_shellEnumerator, m_enumerationExecutor,
-		m_originalExecutor, navigateParams, m_scopedStopSource->GetToken());
+		m_originalExecutor, navigateParams, m_scopedStopSource->GetToken(), snapshot, prefetch);
 	auto *rawNavigationRequest = navigationRequest.get();
 	m_pendingNavigations.push_back(std::move(navigationRequest));
 
 	rawNavigationRequest->Start();
 }
 
+void NavigationManager::SetSnapshotProvider(SnapshotProvider snapshotProvider)
+{
+	m_snapshotProvider = snapshotProvider;
+}
+
+void NavigationManager::SetPrefetchProvider(PrefetchProvider prefetchProvider)
+{
+	m_prefetchProvider = prefetchProvider;
+}
+
 void NavigationManager::OnEnumerationCompleted(NavigationRequest *request)
 {
 	CommitNavigation(request);
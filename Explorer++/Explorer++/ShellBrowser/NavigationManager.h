@@ -8,8 +8,11 @@
 #include "../Helper/PidlHelper.h"
 #include <boost/signals2.hpp>
 #include <concurrencpp/concurrencpp.h>
+#include <functional>
 #include <memory>
 
+struct FolderPrefetch;
+struct FolderSnapshot;
 struct NavigateParams;
 class NavigationEvents;
 class NavigationRequest;
@@ -22,6 +25,16 @@ class ShellEnumerator;
 class NavigationManager : private NavigationRequestDelegate
 {
 public:
+	// Returns a snapshot of the folder being navigated to, or null if there's no snapshot, or one
+	// shouldn't be used.
+	using SnapshotProvider =
+		std::function<std::shared_ptr<const FolderSnapshot>(const NavigateParams &navigateParams)>;
+
+	// Returns the prefetch for the folder being navigated to, or null if the folder hasn't been
+	// prefetched.
+	using PrefetchProvider =
+		std::function<std::shared_ptr<FolderPrefetch>(const NavigateParams &navigateParams)>;
+
 	NavigationManager(const ShellBrowser *shellBrowser, NavigationEvents *navigationEvents,
 		std::shared_ptr<const ShellEnumerator> shellEnumerator,
 		std::shared_ptr<concurrencpp::executor> enumerationExecutor,
@@ -30,6 +43,15 @@ public:
 
 	void StartNavigation(const NavigateParams &navigateParams);
 
+	// If set, the provider will be queried each time a navigation starts. When a snapshot is
+	// returned, the navigation will commit without enumerating the folder.
+	void SetSnapshotProvider(SnapshotProvider snapshotProvider);
+
+	// If set, the provider will be queried each time a navigation starts that isn't using a
+	// snapshot. When a prefetch is returned, the navigation will use its results, rather than
+	// enumerating the folder itself.
+	void SetPrefetchProvider(PrefetchProvider prefetchProvider);
+
 	// Stops all in-progress navigations.
 	void StopLoading();
 
@@ -73,6 +95,8 @@ private:
 	const std::shared_ptr<const ShellEnumerator> m_shellEnumerator;
 	const std::shared_ptr<concurrencpp::executor> m_enumerationExecutor;
 	const std::shared_ptr<concurrencpp::executor> m_originalExecutor;
+	SnapshotProvider m_snapshotProvider;
+	PrefetchProvider m_prefetchProvider;
 
 	bool m_anyNavigationsCommitted = false;
 	std::vector<std::unique_ptr<NavigationRequest>> m_pendingNavigations;
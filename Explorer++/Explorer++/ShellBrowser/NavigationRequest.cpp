@@ -4,17 +4,21 @@
 
 #include "stdafx.h"
 #include "NavigationRequest.h"
+#include "FolderPrefetcher.h"
 #include "NavigationEvents.h"
 #include "NavigationRequestDelegate.h"
 #include "ShellEnumerator.h"
 #include "../Helper/ShellHelper.h"
+#include "../Helper/Tracing.h"
+#include <stop_token>
 
 NavigationRequest::NavigationRequest(const ShellBrowser *shellBrowser,
 	NavigationEvents *navigationEvents, NavigationRequestDelegate *delegate,
 	std::shared_ptr<const ShellEnumerator> shellEnumerator,
 	std::shared_ptr<concurrencpp::executor> enumerationExecutor,
 	std::shared_ptr<concurrencpp::executor> originalExecutor, const NavigateParams &navigateParams,
-	std::stop_token stopToken) :
+	std::stop_token stopToken, std::shared_ptr<const FolderSnapshot> snapshot,
+	std::shared_ptr<FolderPrefetch> prefetch) :
 	m_shellBrowser(shellBrowser),
 	m_navigationEvents(navigationEvents),
 	m_delegate(delegate),
@@ -22,12 +26,20 @@ NavigationRequest::NavigationRequest(const ShellBrowser *shellBrowser,
 	m_enumerationExecutor(enumerationExecutor),
 	m_originalExecutor(originalExecutor),
 	m_navigateParams(navigateParams),
-	m_stopToken(stopToken)
+	m_stopToken(stopToken),
+	m_snapshot(snapshot),
+	m_prefetch(prefetch),
+	m_traceId(GetTraceRecorder().NewId())
 {
 }
 
 void NavigationRequest::Start()
 {
+	TRACE_SCOPE("navigation", "NavigationRequest::Start");
+	GetTraceRecorder().RecordAsyncBegin("navigation", "Navigation", m_traceId);
+	GetTraceRecorder().RecordFlow(TraceEventType::FlowBegin, "navigation", "Navigation",
+		m_traceId);
+
 	SetState(State::Started);
 
 	StartInternal(m_weakPtrFactory.GetWeakPtr());
@@ -35,12 +47,17 @@ void NavigationRequest::Start()
 
 void NavigationRequest::Commit()
 {
+	TRACE_SCOPE("navigation", "NavigationRequest::Commit");
+	GetTraceRecorder().RecordFlow(TraceEventType::FlowEnd, "navigation", "Navigation", m_traceId);
+
 	SetState(State::WillCommit);
 	m_navigationEvents->NotifyWillCommit(this);
 
 	SetState(State::Committed);
 	m_navigationEvents->NotifyCommitted(this);
 
+	GetTraceRecorder().RecordAsyncEnd("navigation", "Navigation", m_traceId);
+
 	m_delegate->OnFinished(this);
 }
 
@@ -50,6 +67,8 @@ void NavigationRequest::Fail()
 
 	m_navigationEvents->NotifyFailed(this);
 
+	GetTraceRecorder().RecordAsyncEnd("navigation", "Navigation", m_traceId);
+
 	m_delegate->OnFinished(this);
 }
 
@@ -59,6 +78,8 @@ void NavigationRequest::Cancel()
 
 	m_navigationEvents->NotifyCancelled(this);
 
+	GetTraceRecorder().RecordAsyncEnd("navigation", "Navigation", m_traceId);
+
 	m_delegate->OnFinished(this);
 }
 
@@ -82,6 +103,11 @@ const std::vector<PidlChild> &NavigationRequest::GetItems() const
 	return m_items;
 }
 
+const std::shared_ptr<const FolderSnapshot> &NavigationRequest::GetSnapshot() const
+{
+	return m_snapshot;
+}
+
 bool NavigationRequest::Stopped() const
 {
 	return m_stopToken.stop_requested();
@@ -96,34 +122,93 @@ concurrencpp::null_result NavigationRequest::StartInternal(WeakPtr<NavigationReq
 	auto originalExecutor = weakSelf->m_originalExecutor;
 	auto navigateParams = weakSelf->m_navigateParams;
 	auto stopToken = weakSelf->m_stopToken;
+	bool useSnapshot = weakSelf->m_snapshot != nullptr;
+	auto prefetch = weakSelf->m_prefetch;
+	auto traceId = weakSelf->m_traceId;
 
 	weakSelf->m_navigationEvents->NotifyStarted(weakSelf.Get());
 
-	co_await concurrencpp::resume_on(enumerationExecutor);
-
-	// Note that although standard shortcuts (.lnk files) are currently handled outside this class,
-	// symlinks and virtual link objects aren't, so they will be handled here.
-	//
-	// Navigating to the target pidl is important for folders like the quick access folder. Although
-	// navigating directly to a recent/pinned folder works as expected, directory monitoring doesn't
-	// work. Presumably, that's because directory change notifications are only generated for the
-	// original (target) directory. To have things work correctly, the navigation needs to proceed
-	// to the original folder instead.
-	//
-	// Note that this call simply retrieves the target item, but doesn't attempt to resolve it. That
-	// matches the behavior of Explorer. For example, if a symlink to a directory is created and the
-	// target directory is then removed, Explorer will try to navigate to the target, without
-	// attempting to resolve the link.
-	unique_pidl_absolute targetPidl;
-	HRESULT hr = MaybeGetLinkTarget(navigateParams.pidl.Raw(), targetPidl);
-
-	if (SUCCEEDED(hr))
+	if (useSnapshot)
 	{
-		navigateParams.pidl = targetPidl.get();
+		// The items in the snapshot can be shown directly (with the folder being enumerated again
+		// in the background once the navigation has committed), so there's nothing to do here.
+		// The navigation still completes asynchronously, however, so that callers see the same
+		// sequence of events, regardless of whether a snapshot is used.
+		co_await concurrencpp::resume_on(originalExecutor);
+
+		if (!weakSelf)
+		{
+			co_return;
+		}
+
+		TRACE_SCOPE("navigation", "NavigationRequest::OnEnumerationFinished");
+		GetTraceRecorder().RecordFlow(TraceEventType::FlowStep, "navigation", "Navigation",
+			traceId);
+
+		weakSelf->SetState(State::EnumerationFinished);
+
+		if (stopToken.stop_requested())
+		{
+			weakSelf->m_delegate->OnEnumerationStopped(weakSelf.Get());
+			co_return;
+		}
+
+		weakSelf->m_delegate->OnEnumerationCompleted(weakSelf.Get());
+		co_return;
 	}
 
 	std::vector<PidlChild> items;
-	hr = shellEnumerator->EnumerateDirectory(navigateParams.pidl.Raw(), items, stopToken);
+	HRESULT hr;
+
+	if (prefetch)
+	{
+		// The folder has already been enumerated (or is in the process of being enumerated), in
+		// exactly the same way it would be below, so the results can be used directly. If this
+		// navigation is stopped, the prefetch is no longer useful, so it's stopped as well.
+		auto prefetchResult = prefetch->result;
+		std::stop_callback stopCallback(stopToken,
+			[stopSource = prefetch->stopSource]() mutable { stopSource.request_stop(); });
+
+		co_await prefetchResult;
+
+		const auto &prefetchedFolder = prefetchResult.get();
+		navigateParams.pidl = prefetchedFolder.pidlDirectory;
+		items = prefetchedFolder.items;
+		hr = prefetchedFolder.hr;
+	}
+	else
+	{
+		co_await concurrencpp::resume_on(enumerationExecutor);
+
+		TraceScope traceScope("navigation", "EnumerateDirectory");
+		GetTraceRecorder().RecordFlow(TraceEventType::FlowStep, "navigation", "Navigation",
+			traceId);
+
+		// Note that although standard shortcuts (.lnk files) are currently handled outside this
+		// class, symlinks and virtual link objects aren't, so they will be handled here.
+		//
+		// Navigating to the target pidl is important for folders like the quick access folder.
+		// Although navigating directly to a recent/pinned folder works as expected, directory
+		// monitoring doesn't work. Presumably, that's because directory change notifications are
+		// only generated for the original (target) directory. To have things work correctly, the
+		// navigation needs to proceed to the original folder instead.
+		//
+		// Note that this call simply retrieves the target item, but doesn't attempt to resolve
+		// it. That matches the behavior of Explorer. For example, if a symlink to a directory is
+		// created and the target directory is then removed, Explorer will try to navigate to the
+		// target, without attempting to resolve the link.
+		unique_pidl_absolute targetPidl;
+		hr = MaybeGetLinkTarget(navigateParams.pidl.Raw(), targetPidl);
+
+		if (SUCCEEDED(hr))
+		{
+			navigateParams.pidl = targetPidl.get();
+		}
+
+		hr = shellEnumerator->EnumerateDirectory(navigateParams.pidl.Raw(), items, stopToken);
+
+		traceScope.SetArg("items", static_cast<int64_t>(items.size()));
+	}
 
 	co_await concurrencpp::resume_on(originalExecutor);
 
@@ -132,6 +217,9 @@ concurrencpp::null_result NavigationRequest::StartInternal(WeakPtr<NavigationReq
 		co_return;
 	}
 
+	TRACE_SCOPE("navigation", "NavigationRequest::OnEnumerationFinished");
+	GetTraceRecorder().RecordFlow(TraceEventType::FlowStep, "navigation", "Navigation", traceId);
+
 	weakSelf->m_navigateParams = navigateParams;
 	weakSelf->m_items = items;
 	weakSelf->SetState(State::EnumerationFinished);
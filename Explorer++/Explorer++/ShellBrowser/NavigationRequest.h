@@ -10,8 +10,11 @@
 #include "../Helper/WeakPtrFactory.h"
 #include <boost/core/noncopyable.hpp>
 #include <concurrencpp/concurrencpp.h>
+#include <memory>
 #include <vector>
 
+struct FolderPrefetch;
+struct FolderSnapshot;
 class NavigationEvents;
 class NavigationRequestDelegate;
 class ShellBrowser;
@@ -37,7 +40,9 @@ public:
 		NavigationRequestDelegate *delegate, std::shared_ptr<const ShellEnumerator> shellEnumerator,
 		std::shared_ptr<concurrencpp::executor> enumerationExecutor,
 		std::shared_ptr<concurrencpp::executor> originalExecutor,
-		const NavigateParams &navigateParams, std::stop_token stopToken);
+		const NavigateParams &navigateParams, std::stop_token stopToken,
+		std::shared_ptr<const FolderSnapshot> snapshot = nullptr,
+		std::shared_ptr<FolderPrefetch> prefetch = nullptr);
 
 	void Start();
 	void Commit();
@@ -49,9 +54,14 @@ public:
 	const ShellBrowser *GetShellBrowser() const;
 
 	// This will return the set of enumerated items, to be used when the navigation is in the
-	// `WillCommit` or `Committed` state.
+	// `WillCommit` or `Committed` state. When the navigation is using a snapshot, no enumeration
+	// takes place and this will be empty.
 	const std::vector<PidlChild> &GetItems() const;
 
+	// If a snapshot of the target folder was provided, the navigation will skip the enumeration
+	// step and the items in the snapshot should be shown instead.
+	const std::shared_ptr<const FolderSnapshot> &GetSnapshot() const;
+
 	// Indicates whether the enumeration process was stopped early. Note that this is independent of
 	// whether the navigation is ultimately committed or cancelled. That is, it's up to the caller
 	// to decide whether a stopped enumeration should result in a cancellation or not.
@@ -74,9 +84,18 @@ private:
 	NavigateParams m_navigateParams;
 
 	std::stop_token m_stopToken;
+	const std::shared_ptr<const FolderSnapshot> m_snapshot;
+
+	// If the target folder was prefetched, the results of the prefetch will be used, instead of
+	// enumerating the folder again.
+	const std::shared_ptr<FolderPrefetch> m_prefetch;
 
 	State m_state = State::NotStarted;
 	std::vector<PidlChild> m_items;
 
+	// Identifies this navigation in traces, so that the work done on different threads can be
+	// linked together.
+	const uint64_t m_traceId;
+
 	WeakPtrFactory<NavigationRequest> m_weakPtrFactory{ this };
 };
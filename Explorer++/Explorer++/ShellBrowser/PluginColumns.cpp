@@ -0,0 +1,257 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "stdafx.h"
+#include "ShellBrowserImpl.h"
+#include "MainResource.h"
+#include "Plugins/PluginColumnRegistry.h"
+#include "ResourceHelper.h"
+#include "ShellNavigationController.h"
+#include "SortModes.h"
+#include "ViewModes.h"
+#include "../Helper/Tracing.h"
+#include <algorithm>
+
+void ShellBrowserImpl::QueuePluginColumnTask(int itemInternalIndex, ColumnType columnType)
+{
+	int slot = GetPluginColumnSlot(columnType);
+	const auto &values = m_directoryState.pluginColumnValues[slot];
+	auto itr = values.find(itemInternalIndex);
+
+	if (itr != values.end())
+	{
+		// The text can't be set while the listview is requesting it, so the cached value is
+		// delivered in the same way as any other result.
+		m_columnResults.GetSender().Send(
+			{ itemInternalIndex, columnType, itr->second.text, itr->second });
+		return;
+	}
+
+	// The column text will be set once the value has been retrieved.
+	RequestPluginColumnValue(slot, itemInternalIndex);
+}
+
+// Starts evaluating the plugin column for the specified item in the background, unless the value
+// has already been retrieved or requested. Plugin columns can take a significant amount of time to
+// evaluate, so they're never evaluated on the UI thread.
+void ShellBrowserImpl::RequestPluginColumnValue(int slot, int internalIndex)
+{
+	if (m_directoryState.pluginColumnValues[slot].contains(internalIndex)
+		|| m_directoryState.pendingPluginColumnValues[slot].contains(internalIndex))
+	{
+		return;
+	}
+
+	auto columnType = GetPluginColumnType(slot);
+	const auto *pluginColumn = m_pluginColumnRegistry->GetColumn(columnType);
+
+	if (!pluginColumn)
+	{
+		return;
+	}
+
+	int requestId = m_directoryState.nextColumnValueRequestId++;
+	m_directoryState.pendingPluginColumnValues[slot][internalIndex] = requestId;
+
+	m_pluginColumnRegistry->GetThreadPool().push(
+		[sender = m_columnResults.GetSender(), evaluator = pluginColumn->evaluator,
+			stopToken = m_pluginColumnStopSource->GetToken(),
+			path = m_itemInfoMap.at(internalIndex)->parsingName, internalIndex, columnType,
+			requestId](int id)
+		{
+			UNREFERENCED_PARAMETER(id);
+
+			if (stopToken.stop_requested())
+			{
+				return;
+			}
+
+			TRACE_SCOPE("columns", "EvaluatePluginColumn");
+
+			auto value = evaluator->Evaluate(path);
+			sender.Send({ internalIndex, columnType, value.text, value, requestId });
+		});
+}
+
+// Stores a plugin column value that was retrieved in the background. Returns false if the value is
+// out of date and should be ignored.
+bool ShellBrowserImpl::ProcessPluginColumnResult(const ColumnResult_t &result)
+{
+	if (!result.requestId)
+	{
+		// This is a value that was already cached.
+		return true;
+	}
+
+	int slot = GetPluginColumnSlot(result.columnType);
+	auto &pendingValues = m_directoryState.pendingPluginColumnValues[slot];
+	auto itr = pendingValues.find(result.itemInternalIndex);
+
+	if (itr == pendingValues.end() || itr->second != *result.requestId)
+	{
+		// The item has been removed or updated since the value was requested.
+		return false;
+	}
+
+	pendingValues.erase(itr);
+	m_directoryState.pluginColumnValues[slot].insert_or_assign(result.itemInternalIndex,
+		*result.pluginColumnValue);
+
+	if (pendingValues.empty())
+	{
+		OnColumnValuesRetrieved(GetPluginSortMode(slot));
+	}
+
+	return true;
+}
+
+// Returns the value of the plugin column for the specified item, or null if the value hasn't been
+// retrieved yet.
+const Plugins::PluginColumnValue *ShellBrowserImpl::GetPluginColumnValue(int slot,
+	int internalIndex) const
+{
+	const auto &values = m_directoryState.pluginColumnValues[slot];
+	auto itr = values.find(internalIndex);
+
+	if (itr == values.end())
+	{
+		return nullptr;
+	}
+
+	return &itr->second;
+}
+
+int ShellBrowserImpl::ComparePluginColumnValues(SortMode sortMode, int internalIndex1,
+	int internalIndex2) const
+{
+	int slot = GetPluginSortModeSlot(sortMode);
+	const auto *value1 = GetPluginColumnValue(slot, internalIndex1);
+	const auto *value2 = GetPluginColumnValue(slot, internalIndex2);
+
+	// Items whose values are still being retrieved are kept together at one end. They'll be moved
+	// into position once all the values have been retrieved.
+	if (!value1 || !value2)
+	{
+		return static_cast<int>(!value1) - static_cast<int>(!value2);
+	}
+
+	// Within a numeric column, items with a numeric value are placed before those without one.
+	if (value1->number && value2->number)
+	{
+		if (*value1->number < *value2->number)
+		{
+			return -1;
+		}
+		else if (*value1->number > *value2->number)
+		{
+			return 1;
+		}
+
+		return 0;
+	}
+	else if (value1->number)
+	{
+		return -1;
+	}
+	else if (value2->number)
+	{
+		return 1;
+	}
+
+	return StrCmpLogicalW(value1->text.c_str(), value2->text.c_str());
+}
+
+std::vector<ShellBrowserImpl::GroupInfo> ShellBrowserImpl::DeterminePluginColumnGroupInfos(
+	const std::vector<int> &internalIndexes) const
+{
+	int slot = GetPluginSortModeSlot(m_folderSettings.groupMode);
+
+	std::vector<GroupInfo> groupInfos;
+	groupInfos.reserve(internalIndexes.size());
+
+	for (int internalIndex : internalIndexes)
+	{
+		const auto *value = GetPluginColumnValue(slot, internalIndex);
+
+		// Items whose values are still being retrieved are temporarily placed in the unspecified
+		// group. The items will be regrouped once all the values have been retrieved.
+		if (!value || value->text.empty())
+		{
+			groupInfos.emplace_back(
+				ResourceHelper::LoadString(m_resourceInstance, IDS_GROUPBY_UNSPECIFIED),
+				ItemGroupSet::POSITION_FIRST);
+			continue;
+		}
+
+		groupInfos.emplace_back(value->text);
+	}
+
+	return groupInfos;
+}
+
+void ShellBrowserImpl::InvalidatePluginColumnValues(int internalIndex)
+{
+	for (int slot = 0; slot < NUM_PLUGIN_COLUMNS; slot++)
+	{
+		m_directoryState.pluginColumnValues[slot].erase(internalIndex);
+
+		// Any value that's still pending is for the previous state of the item, so it will be
+		// ignored when it arrives.
+		auto &pendingValues = m_directoryState.pendingPluginColumnValues[slot];
+
+		if (pendingValues.erase(internalIndex) > 0 && pendingValues.empty())
+		{
+			OnColumnValuesRetrieved(GetPluginSortMode(slot));
+		}
+	}
+}
+
+void ShellBrowserImpl::CancelPluginColumnTasks()
+{
+	// Replacing the stop source means that any evaluations for this tab that haven't started yet
+	// will be skipped. Since the results for those evaluations won't arrive, they're no longer
+	// tracked as pending.
+	m_pluginColumnStopSource = std::make_unique<ScopedStopSource>();
+
+	for (auto &pendingValues : m_directoryState.pendingPluginColumnValues)
+	{
+		pendingValues.clear();
+	}
+}
+
+void ShellBrowserImpl::OnPluginColumnsChanged()
+{
+	// A slot may now refer to a different column (or to no column at all), so any values that have
+	// been retrieved are no longer valid.
+	for (auto &values : m_directoryState.pluginColumnValues)
+	{
+		values.clear();
+	}
+
+	CancelPluginColumnTasks();
+
+	if (IsDormant() || m_navigationState != NavigationState::Committed)
+	{
+		return;
+	}
+
+	bool pluginColumnChecked = std::any_of(m_pActiveColumns->begin(), m_pActiveColumns->end(),
+		[](const Column_t &column) { return column.checked && IsPluginColumn(column.type); });
+	bool pluginSortModeUsed = IsPluginSortMode(m_folderSettings.sortMode)
+		|| IsPluginSortMode(m_folderSettings.groupMode)
+		|| std::any_of(m_folderSettings.secondarySortKeys.begin(),
+			m_folderSettings.secondarySortKeys.end(),
+			[](const auto &sortKey) { return IsPluginSortMode(sortKey.mode); });
+
+	if (!pluginColumnChecked && !pluginSortModeUsed)
+	{
+		return;
+	}
+
+	// The set of columns that are shown may have changed, so the simplest thing to do is to reload
+	// the folder. Any results that are still pending are discarded, as they may be for a column
+	// that's no longer in the same slot.
+	m_columnResults.Invalidate();
+	m_navigationController->Refresh();
+}
@@ -7,6 +7,7 @@
 #include <memory>
 #include <vector>
 
+struct FolderColumns;
 struct FolderSettings;
 class NavigationManager;
 class NavigationRequest;
@@ -20,6 +21,7 @@ public:
 	virtual ~ShellBrowser() = default;
 
 	virtual FolderSettings GetFolderSettings() const = 0;
+	virtual FolderColumns ExportAllColumns() = 0;
 	virtual ShellNavigationController *GetNavigationController() const = 0;
 
 	int GetId() const;
@@ -9,16 +9,20 @@
 #include "ColorRuleModel.h"
 #include "Config.h"
 #include "CoreInterface.h"
+#include "FolderPrefetcher.h"
 #include "FolderView.h"
 #include "IconFetcherImpl.h"
 #include "ItemData.h"
 #include "MainResource.h"
 #include "MassRenameDialog.h"
+#include "Plugins/PluginColumnRegistry.h"
 #include "PreservedFolderState.h"
+#include "RuntimeHelper.h"
 #include "ServiceProvider.h"
 #include "ShellEnumeratorImpl.h"
 #include "ShellNavigationController.h"
 #include "SortModes.h"
+#include "SortedInsertion.h"
 #include "ThemeManager.h"
 #include "ViewModeHelper.h"
 #include "ViewModes.h"
@@ -28,9 +32,25 @@
 #include "../Helper/FileOperations.h"
 #include "../Helper/ListViewHelper.h"
 #include "../Helper/ShellHelper.h"
+#include "../Helper/Tracing.h"
 #include <wil/com.h>
 #include <list>
 
+namespace
+{
+
+// Initializes each thread in a worker pool. The name is used to identify the thread in traces.
+std::function<void()> MakeWorkerThreadInitializer(const char *threadName)
+{
+	return [threadName]
+	{
+		CoInitializeEx(nullptr, COINIT_APARTMENTTHREADED);
+		GetTraceRecorder().SetCurrentThreadName(threadName);
+	};
+}
+
+}
+
 ShellBrowserImpl::ShellBrowserImpl(HWND hOwner, App *app, CoreInterface *coreInterface,
 	TabNavigationInterface *tabNavigation, FileActionHandler *fileActionHandler,
 	const std::vector<std::unique_ptr<PreservedHistoryEntry>> &history, int currentEntry,
@@ -40,6 +60,7 @@ ShellBrowserImpl::ShellBrowserImpl(HWND hOwner, App *app, CoreInterface *coreInt
 {
 	m_navigationController = std::make_unique<ShellNavigationController>(this, &m_navigationManager,
 		m_app->GetNavigationEvents(), tabNavigation, history, currentEntry);
+	m_navigationController->SetMaxEntries(m_config->maxHistoryEntriesPerTab);
 
 	ChangeToInitialFolder();
 }
@@ -53,6 +74,7 @@ ShellBrowserImpl::ShellBrowserImpl(HWND hOwner, App *app, CoreInterface *coreInt
 {
 	m_navigationController = std::make_unique<ShellNavigationController>(this, &m_navigationManager,
 		m_app->GetNavigationEvents(), tabNavigation, initialPidl);
+	m_navigationController->SetMaxEntries(m_config->maxHistoryEntriesPerTab);
 
 	ChangeToInitialFolder();
 }
@@ -80,16 +102,23 @@ ShellBrowserImpl::ShellBrowserImpl(HWND hOwner, App *app, CoreInterface *coreInt
 	m_fontSetter(GetHWND(), app->GetConfig()),
 	m_tooltipFontSetter(reinterpret_cast<HWND>(SendMessage(GetHWND(), LVM_GETTOOLTIPS, 0, 0)),
 		app->GetConfig()),
-	m_columnThreadPool(1, std::bind(CoInitializeEx, nullptr, COINIT_APARTMENTTHREADED),
-		CoUninitialize),
-	m_columnResultIDCounter(0),
+	m_columnThreadPool(1, MakeWorkerThreadInitializer("Column thread"), CoUninitialize),
+	m_columnResults(MakeUiThreadScheduler(app->GetRuntime()),
+		std::bind_front(&ShellBrowserImpl::ProcessColumnResult, this)),
+	m_pluginColumnRegistry(app->GetPluginColumnRegistry()),
+	m_pluginColumnStopSource(std::make_unique<ScopedStopSource>()),
+	m_fileHashService(app->GetFileHashService()),
+	m_hashColumnStopSource(std::make_unique<ScopedStopSource>()),
+	m_folderSnapshotCache(app->GetFolderSnapshotCache()),
+	m_snapshotRevalidationStopSource(std::make_unique<ScopedStopSource>()),
 	m_cachedIcons(coreInterface->GetCachedIcons()),
-	m_thumbnailThreadPool(1, std::bind(CoInitializeEx, nullptr, COINIT_APARTMENTTHREADED),
-		CoUninitialize),
-	m_thumbnailResultIDCounter(0),
-	m_infoTipsThreadPool(1, std::bind(CoInitializeEx, nullptr, COINIT_APARTMENTTHREADED),
-		CoUninitialize),
-	m_infoTipResultIDCounter(0),
+	m_thumbnailThreadPool(1, MakeWorkerThreadInitializer("Thumbnail thread"), CoUninitialize),
+	m_thumbnailResults(MakeUiThreadScheduler(app->GetRuntime()),
+		std::bind_front(&ShellBrowserImpl::ProcessThumbnailResult, this)),
+	m_infoTipsThreadPool(1, MakeWorkerThreadInitializer("Info tip thread"), CoUninitialize),
+	m_infoTipResults(MakeUiThreadScheduler(app->GetRuntime()),
+		std::bind_front(&ShellBrowserImpl::ProcessInfoTipResult, this)),
+	m_groupThreadPool(0, MakeWorkerThreadInitializer("Group thread"), CoUninitialize),
 	m_resourceInstance(coreInterface->GetResourceInstance()),
 	m_acceleratorManager(app->GetAcceleratorManager()),
 	m_config(app->GetConfig()),
@@ -103,7 +132,7 @@ ShellBrowserImpl::ShellBrowserImpl(HWND hOwner, App *app, CoreInterface *coreInt
 	m_weakPtrFactory(this)
 {
 	InitializeListView();
-	m_iconFetcher = std::make_unique<IconFetcherImpl>(m_hListView, m_cachedIcons);
+	m_iconFetcher = std::make_unique<IconFetcherImpl>(m_app->GetRuntime(), m_cachedIcons);
 
 	m_connections.push_back(m_app->GetNavigationEvents()->AddStartedObserver(
 		std::bind_front(&ShellBrowserImpl::OnNavigationStarted, this),
@@ -117,6 +146,22 @@ ShellBrowserImpl::ShellBrowserImpl(HWND hOwner, App *app, CoreInterface *coreInt
 		NavigationEventScope::ForShellBrowser(*this), boost::signals2::at_front,
 		NavigationEvents::SlotGroup::HighPriority));
 
+	m_navigationManager.SetSnapshotProvider(
+		std::bind_front(&ShellBrowserImpl::MaybeGetFolderSnapshot, this));
+
+	// Prefetching relies on enumerations taking place in the background. If they don't, a
+	// prefetch would block the UI thread.
+	if (m_config->prefetchFolders
+		&& app->GetFeatureList()->IsEnabled(Feature::BackgroundThreadEnumeration))
+	{
+		m_folderPrefetcher = std::make_unique<FolderPrefetcher>(m_shellEnumerator,
+			app->GetRuntime()->GetComStaExecutor(), app->GetRuntime()->GetUiThreadExecutor(),
+			app->GetSystemClock(), app->GetFolderPrefetchStats());
+
+		m_navigationManager.SetPrefetchProvider(
+			std::bind_front(&ShellBrowserImpl::MaybeTakeFolderPrefetch, this));
+	}
+
 	m_getDragImageMessage = RegisterWindowMessage(DI_GETDRAGIMAGE);
 
 	m_performingDrag = false;
@@ -138,6 +183,8 @@ ShellBrowserImpl::ShellBrowserImpl(HWND hOwner, App *app, CoreInterface *coreInt
 
 	m_connections.push_back(coreInterface->AddDeviceChangeObserver(
 		std::bind_front(&ShellBrowserImpl::OnDeviceChange, this)));
+	m_connections.push_back(m_pluginColumnRegistry->AddColumnsChangedObserver(
+		std::bind_front(&ShellBrowserImpl::OnPluginColumnsChanged, this)));
 
 	m_shellWindows = winrt::try_create_instance<IShellWindows>(CLSID_ShellWindows, CLSCTX_ALL);
 }
@@ -415,7 +462,12 @@ void ShellBrowserImpl::SetViewModeInternal(ViewMode viewMode)
 	if (viewMode != +ViewMode::Details)
 	{
 		m_columnThreadPool.clear_queue();
-		m_columnResults.clear();
+		CancelPluginColumnTasks();
+		CancelHashColumnTasks();
+		m_columnResults.Invalidate();
+
+		// Any values that are needed for sorting or grouping are still needed in this view mode.
+		RequestSortAndGroupColumnValues();
 	}
 
 	if (viewMode != +ViewMode::Details && viewMode != +ViewMode::Tiles)
@@ -504,6 +556,10 @@ void ShellBrowserImpl::SetSortMode(SortMode sortMode)
 
 	m_folderSettings.sortMode = sortMode;
 
+	// There's no need to retain a secondary key that matches the primary sort mode.
+	std::erase_if(m_folderSettings.secondarySortKeys,
+		[sortMode](const auto &sortKey) { return sortKey.mode == sortMode; });
+
 	SortFolder();
 }
 
@@ -558,7 +614,7 @@ void ShellBrowserImpl::SetGroupSortDirection(SortDirection direction)
 
 std::wstring ShellBrowserImpl::GetItemName(int index) const
 {
-	return GetItemByIndex(index).wfd.cFileName;
+	return GetItemByIndex(index).GetFileName();
 }
 
 // Returns the name of the item as it's shown to the user. Note that this name may not be unique.
@@ -581,13 +637,25 @@ std::wstring ShellBrowserImpl::GetItemFullName(int index) const
 	return GetItemByIndex(index).parsingName;
 }
 
+// A dormant browser hasn't started its pending navigation yet, so the folder it's going to show is
+// reported, rather than whichever folder was set up when the browser was created or released.
 std::wstring ShellBrowserImpl::GetDirectory() const
 {
+	if (IsDormant())
+	{
+		return GetDisplayNameWithFallback(m_dormantNavigation->pidl.Raw(), SHGDN_FORPARSING);
+	}
+
 	return m_directoryState.directory;
 }
 
 unique_pidl_absolute ShellBrowserImpl::GetDirectoryIdl() const
 {
+	if (IsDormant())
+	{
+		return unique_pidl_absolute(ILCloneFull(m_dormantNavigation->pidl.Raw()));
+	}
+
 	unique_pidl_absolute pidlDirectory(ILCloneFull(m_directoryState.pidlDirectory.Raw()));
 	return pidlDirectory;
 }
@@ -649,7 +717,7 @@ int ShellBrowserImpl::LocateFileItemInternalIndex(const TCHAR *szFileName) const
 	{
 		const auto &item = GetItemByIndex(i);
 
-		if (lstrcmp(item.wfd.cFileName, szFileName) == 0)
+		if (lstrcmp(item.GetFileName(), szFileName) == 0)
 		{
 			return GetItemInternalIndex(i);
 		}
@@ -673,7 +741,7 @@ std::optional<int> ShellBrowserImpl::GetItemIndexForPidl(PCIDLIST_ABSOLUTE pidl)
 std::optional<int> ShellBrowserImpl::GetItemInternalIndexForPidl(PCIDLIST_ABSOLUTE pidl) const
 {
 	auto itr = std::find_if(m_itemInfoMap.begin(), m_itemInfoMap.end(), [pidl](const auto &pair)
-		{ return ArePidlsEquivalent(pidl, pair.second.pidlComplete.Raw()); });
+		{ return ArePidlsEquivalent(pidl, pair.second->pidlComplete.Raw()); });
 
 	if (itr == m_itemInfoMap.end())
 	{
@@ -700,7 +768,8 @@ std::optional<int> ShellBrowserImpl::LocateItemByInternalIndex(int internalIndex
 
 WIN32_FIND_DATA ShellBrowserImpl::GetItemFileFindData(int index) const
 {
-	return GetItemByIndex(index).wfd;
+	const auto &item = GetItemByIndex(index);
+	return item.wfd.ToFindData(item.GetFileName());
 }
 
 unique_pidl_absolute ShellBrowserImpl::GetItemCompleteIdl(int index) const
@@ -710,7 +779,7 @@ unique_pidl_absolute ShellBrowserImpl::GetItemCompleteIdl(int index) const
 
 unique_pidl_child ShellBrowserImpl::GetItemChildIdl(int index) const
 {
-	return unique_pidl_child(ILCloneChild(GetItemByIndex(index).pridl.Raw()));
+	return unique_pidl_child(ILCloneChild(GetItemByIndex(index).GetChildPidl()));
 }
 
 bool ShellBrowserImpl::InVirtualFolder() const
@@ -769,48 +838,28 @@ int ShellBrowserImpl::GenerateUniqueItemId()
 	return m_directoryState.itemIDCounter++;
 }
 
-int ShellBrowserImpl::DetermineItemSortedPosition(LPARAM lParam) const
+// The items in the listview are already sorted, so the position of a new item can be found with a
+// binary search, rather than by comparing the item against every existing item. The item will be
+// inserted before the item currently at the returned position.
+int ShellBrowserImpl::DetermineItemSortedPosition(int internalIndex) const
 {
-	LVITEM lvItem;
-	BOOL bItem;
-	int res = 1;
-	int nItems = 0;
-	int i = 0;
-
-	nItems = ListView_GetItemCount(m_hListView);
-
-	while (res > 0 && i < nItems)
-	{
-		lvItem.mask = LVIF_PARAM;
-		lvItem.iItem = i;
-		lvItem.iSubItem = 0;
-		bItem = ListView_GetItem(m_hListView, &lvItem);
-
-		if (bItem)
-		{
-			res = Sort(static_cast<int>(lParam), static_cast<int>(lvItem.lParam));
-		}
-		else
-		{
-			res = 0;
-		}
-
-		i++;
-	}
-
-	/* The item will always be inserted BEFORE
-	the item at position i that we specify here.
-	For example, specifying 0, will place the item
-	at 0 (and push 0 to 1), specifying 1 will place
-	the item at 1 (and push 1 to 2).
-	Therefore, to place in the last position, need
-	to place AFTER last item. */
-	if ((i - 1) == nItems - 1 && res > 0)
-	{
-		i++;
-	}
+	return SortedInsertion::FindInsertPosition(0, ListView_GetItemCount(m_hListView),
+		[this, internalIndex](int index)
+		{ return Sort(internalIndex, GetItemInternalIndex(index)); });
+}
 
-	return i - 1;
+// Sorts the provided items and returns the position each one should be inserted at. The items
+// should be inserted in the returned order. This is used when adding a batch of items, so that the
+// new items can be merged into the existing set, without having to re-sort the entire listview.
+std::vector<int> ShellBrowserImpl::DetermineItemSortedPositions(
+	std::vector<int> &internalIndexes) const
+{
+	return SortedInsertion::MergeIntoSortedRange(internalIndexes,
+		ListView_GetItemCount(m_hListView),
+		[this](int internalIndex1, int internalIndex2)
+		{ return Sort(internalIndex1, internalIndex2); },
+		[this](int internalIndex, int index)
+		{ return Sort(internalIndex, GetItemInternalIndex(index)); });
 }
 
 int ShellBrowserImpl::GetNumItems() const
@@ -909,6 +958,12 @@ void ShellBrowserImpl::SetShowHidden(bool showHidden)
 	m_shellEnumerator->SetHiddenItemsPolicy(showHidden
 			? ShellEnumeratorImpl::HiddenItemsPolicy::IncludeHidden
 			: ShellEnumeratorImpl::HiddenItemsPolicy::ExcludeHidden);
+
+	// Any existing prefetches were made using the previous setting.
+	if (m_folderPrefetcher)
+	{
+		m_folderPrefetcher->CancelAll();
+	}
 }
 
 std::vector<SortMode> ShellBrowserImpl::GetAvailableSortModes() const
@@ -917,7 +972,7 @@ std::vector<SortMode> ShellBrowserImpl::GetAvailableSortModes() const
 
 	for (const auto &column : *m_pActiveColumns)
 	{
-		if (column.checked)
+		if (IsColumnShown(column))
 		{
 			sortModes.push_back(DetermineColumnSortMode(column.type));
 		}
@@ -1079,7 +1134,7 @@ void ShellBrowserImpl::UpdateDriveIcon(const TCHAR *szDrive)
 			ListView_GetItem(m_hListView, &lvItem);
 
 			if (ArePidlsEquivalent(pidlDrive.get(),
-					m_itemInfoMap.at((int) lvItem.lParam).pidlComplete.Raw()))
+					m_itemInfoMap.at((int) lvItem.lParam)->pidlComplete.Raw()))
 			{
 				iItem = i;
 				iItemInternal = (int) lvItem.lParam;
@@ -1093,7 +1148,9 @@ void ShellBrowserImpl::UpdateDriveIcon(const TCHAR *szDrive)
 	{
 		SHGetFileInfo(szDrive, 0, &shfi, sizeof(shfi), SHGFI_SYSICONINDEX);
 
-		m_itemInfoMap.at(iItemInternal).displayName = displayName;
+		auto updatedItem = std::make_shared<ItemInfo_t>(*m_itemInfoMap.at(iItemInternal));
+		updatedItem->displayName = displayName;
+		m_itemInfoMap[iItemInternal] = updatedItem;
 
 		/* Update the drives icon and display name. */
 		lvItem.mask = LVIF_TEXT | LVIF_IMAGE;
@@ -1118,9 +1175,9 @@ void ShellBrowserImpl::RemoveDrive(const TCHAR *szDrive)
 		lvItem.iSubItem = 0;
 		ListView_GetItem(m_hListView, &lvItem);
 
-		if (m_itemInfoMap.at((int) lvItem.lParam).bDrive)
+		if (m_itemInfoMap.at((int) lvItem.lParam)->bDrive)
 		{
-			if (lstrcmp(szDrive, m_itemInfoMap.at((int) lvItem.lParam).szDrive) == 0)
+			if (lstrcmp(szDrive, m_itemInfoMap.at((int) lvItem.lParam)->szDrive) == 0)
 			{
 				iItemInternal = (int) lvItem.lParam;
 				break;
@@ -1141,12 +1198,15 @@ int ShellBrowserImpl::GetUniqueFolderId() const
 
 BasicItemInfo_t ShellBrowserImpl::getBasicItemInfo(int internalIndex) const
 {
-	const ItemInfo_t &itemInfo = m_itemInfoMap.at(internalIndex);
+	return BuildBasicItemInfo(*m_itemInfoMap.at(internalIndex));
+}
 
+BasicItemInfo_t ShellBrowserImpl::BuildBasicItemInfo(const ItemInfo_t &itemInfo)
+{
 	BasicItemInfo_t basicItemInfo;
 	basicItemInfo.pidlComplete.reset(ILCloneFull(itemInfo.pidlComplete.Raw()));
-	basicItemInfo.pridl.reset(ILCloneChild(itemInfo.pridl.Raw()));
-	basicItemInfo.wfd = itemInfo.wfd;
+	basicItemInfo.pridl.reset(ILCloneChild(itemInfo.GetChildPidl()));
+	basicItemInfo.wfd = itemInfo.wfd.ToFindData(itemInfo.GetFileName());
 	basicItemInfo.isFindDataValid = itemInfo.isFindDataValid;
 	StringCchCopy(basicItemInfo.szDisplayName, std::size(basicItemInfo.szDisplayName),
 		itemInfo.displayName.c_str());
@@ -8,13 +8,19 @@
 #include "ColumnDataRetrieval.h"
 #include "Columns.h"
 #include "FolderSettings.h"
+#include "ItemData.h"
+#include "ItemGroupSet.h"
 #include "MainFontSetter.h"
+#include "NavigateParams.h"
 #include "NavigationManager.h"
+#include "Plugins/PluginColumnValue.h"
 #include "ServiceProvider.h"
 #include "ShellBrowser.h"
 #include "ShellChangeWatcher.h"
 #include "SortModes.h"
 #include "ViewModes.h"
+#include "../Helper/ContentHash.h"
+#include "../Helper/ResultChannel.h"
 #include "../Helper/ScopedStopSource.h"
 #include "../Helper/ShellDropTargetWindow.h"
 #include "../Helper/ShellHelper.h"
@@ -23,14 +29,13 @@
 #include "../Helper/WinRTBaseWrapper.h"
 #include "../ThirdParty/CTPL/cpl_stl.h"
 #include <boost/core/noncopyable.hpp>
-#include <boost/multi_index/hashed_index.hpp>
-#include <boost/multi_index/member.hpp>
-#include <boost/multi_index_container.hpp>
 #include <boost/signals2.hpp>
 #include <concurrencpp/concurrencpp.h>
 #include <wil/com.h>
 #include <wil/resource.h>
 #include <thumbcache.h>
+#include <array>
+#include <chrono>
 #include <future>
 #include <list>
 #include <memory>
@@ -49,6 +54,12 @@ class CachedIcons;
 struct Config;
 class CoreInterface;
 class FileActionHandler;
+class FileHashService;
+struct FolderPrefetch;
+class FolderPrefetcher;
+struct FolderSnapshot;
+class FolderSnapshotCache;
+struct FolderSnapshotDiff;
 class IconFetcher;
 class NavigationRequest;
 struct PreservedFolderState;
@@ -59,6 +70,11 @@ class ShellNavigationController;
 class TabNavigationInterface;
 class WindowSubclass;
 
+namespace Plugins
+{
+class PluginColumnRegistry;
+}
+
 typedef struct
 {
 	ULARGE_INTEGER TotalFolderSize;
@@ -85,6 +101,7 @@ public:
 
 	// ShellBrowser
 	FolderSettings GetFolderSettings() const override;
+	FolderColumns ExportAllColumns() override;
 	ShellNavigationController *GetNavigationController() const override;
 
 	WeakPtr<ShellBrowserImpl> GetWeakPtr();
@@ -136,6 +153,13 @@ public:
 	static SortMode DetermineColumnSortMode(ColumnType columnType);
 	static int LookupColumnNameStringIndex(ColumnType columnType);
 	static int LookupColumnDescriptionStringIndex(ColumnType columnType);
+	std::wstring GetColumnName(ColumnType columnType) const;
+	std::wstring GetColumnDescription(ColumnType columnType) const;
+
+	// Retrieves the same information that's retrieved for an item shown in the view. Note that this
+	// method can be called from a background thread.
+	static std::optional<BasicItemInfo_t> GetBasicItemInformation(IShellFolder *shellFolder,
+		PCIDLIST_ABSOLUTE pidlDirectory, PCITEMID_CHILD pidlChild);
 
 	/* Filtering. */
 	std::wstring GetFilterText() const;
@@ -171,41 +195,39 @@ public:
 
 	std::vector<SortMode> GetAvailableSortModes() const;
 	void ImportAllColumns(const FolderColumns &folderColumns);
-	FolderColumns ExportAllColumns();
 	void QueueRename(PCIDLIST_ABSOLUTE pidlItem);
 	void OnDeviceChange(UINT eventType, LONG_PTR eventData);
 	void AutoSizeColumns();
 
+	/* Dormant tabs. A dormant browser still represents its current folder (and retains its
+	history and folder settings), but holds no items and no worker threads. The pending navigation
+	is only started once the browser is activated. */
+	bool IsDormant() const;
+	void EnterDormantState(const NavigateParams &pendingNavigation);
+	bool ReleaseResources();
+	void ActivateIfDormant();
+
+	// Starts enumerating the specified folder in the background, on the basis that it's likely to
+	// be navigated to soon.
+	void PrefetchFolder(const PidlAbsolute &pidl);
+
 protected:
 	NavigationManager *GetNavigationManager() override;
 	const NavigationManager *GetNavigationManager() const override;
 
 private:
-	struct ItemInfo_t
-	{
-		PidlAbsolute pidlComplete;
-		PidlChild pridl;
-		WIN32_FIND_DATA wfd;
-		bool isFindDataValid;
-		std::wstring parsingName;
-		std::wstring displayName;
-		std::wstring editingName;
-
-		/* These are only used for drives. They are
-		needed for when a drive is removed from the
-		system, in which case the drive name is needed
-		so that the removed drive can be found. */
-		BOOL bDrive;
-		TCHAR szDrive[4];
-
-		/* Used for temporary sorting in details mode (i.e.
-		when items need to be rearranged). */
-		int iRelativeSort;
-
-		ItemInfo_t() : wfd({}), isFindDataValid(false), bDrive(FALSE)
-		{
-		}
-	};
+	// When a folder is shown from a snapshot, the changes found when the folder is enumerated
+	// again are applied to the view one at a time. That involves searching the existing items for
+	// each change and, when an item is added or updated, potentially sorting the view again. Past
+	// this number of changes, it's quicker to simply reload the folder.
+	static constexpr size_t MAX_INCREMENTAL_SNAPSHOT_CHANGES = 500;
+
+	// A folder is only prefetched once the mouse has rested over it for this long, so that moving
+	// the mouse across a set of folders doesn't result in each of them being prefetched.
+	static constexpr std::chrono::milliseconds HOVER_PREFETCH_DELAY{ 400 };
+
+	// The number of predicted folders that are prefetched after each navigation.
+	static constexpr size_t MAX_PREDICTED_PREFETCHES = 3;
 
 	struct AlteredFile_t
 	{
@@ -239,6 +261,14 @@ private:
 		int itemInternalIndex;
 		ColumnType columnType;
 		std::wstring columnText;
+
+		// Only set for plugin columns.
+		std::optional<Plugins::PluginColumnValue> pluginColumnValue;
+
+		// Only set for values that were computed in the background for a plugin or hash column.
+		// Identifies the request the value was computed for, so that a value computed for an item
+		// that has since changed can be discarded.
+		std::optional<int> requestId;
 	};
 
 	struct ThumbnailResult_t
@@ -253,41 +283,8 @@ private:
 		std::wstring infoTip;
 	};
 
-	struct GroupInfo
-	{
-		std::wstring name;
-		int relativeSortPosition;
-
-		explicit GroupInfo(const std::wstring &name) : name(name), relativeSortPosition(0)
-		{
-		}
-
-		GroupInfo(const std::wstring &name, int relativeSortPosition) :
-			name(name),
-			relativeSortPosition(relativeSortPosition)
-		{
-		}
-	};
-
-	struct ListViewGroup
-	{
-	public:
-		int id;
-		std::wstring name;
-		int relativeSortPosition;
-		int numItems;
-
-		ListViewGroup(const GroupInfo &groupInfo) :
-			id(idCounter++),
-			name(groupInfo.name),
-			relativeSortPosition(groupInfo.relativeSortPosition),
-			numItems(0)
-		{
-		}
-
-	private:
-		static inline int idCounter = 0;
-	};
+	using GroupInfo = ItemGroupSet::GroupInfo;
+	using ListViewGroup = ItemGroupSet::Group;
 
 	enum class GroupByDateType
 	{
@@ -296,19 +293,6 @@ private:
 		Accessed
 	};
 
-	// clang-format off
-	using ListViewGroupSet = boost::multi_index_container<ListViewGroup,
-		boost::multi_index::indexed_by<
-			boost::multi_index::hashed_unique<
-				boost::multi_index::member<ListViewGroup, int, &ListViewGroup::id>
-			>,
-			boost::multi_index::hashed_unique<
-				boost::multi_index::member<ListViewGroup, std::wstring, &ListViewGroup::name>
-			>
-		>
-	>;
-	// clang-format on
-
 	struct DirectoryState
 	{
 		PidlAbsolute pidlDirectory;
@@ -343,12 +327,30 @@ private:
 		/* Cached folder size data. */
 		mutable std::unordered_map<int, ULONGLONG> cachedFolderSizes;
 
+		// The values for each plugin column slot, keyed by item internal index. A value is removed
+		// whenever the item changes.
+		std::array<std::unordered_map<int, Plugins::PluginColumnValue>, NUM_PLUGIN_COLUMNS>
+			pluginColumnValues;
+
+		// The plugin column values that have been requested, but not yet retrieved. Each item
+		// internal index is mapped to the ID of the request.
+		std::array<std::unordered_map<int, int>, NUM_PLUGIN_COLUMNS> pendingPluginColumnValues;
+		int nextColumnValueRequestId = 0;
+
+		// The text shown in each hash column, keyed by item internal index. As with plugin
+		// columns, a value is removed whenever the item changes.
+		std::unordered_map<HashAlgorithm, std::unordered_map<int, std::wstring>> hashColumnValues;
+
+		// The files that are currently being hashed for each hash column. As with plugin columns,
+		// each item internal index is mapped to the ID of the request.
+		std::unordered_map<HashAlgorithm, std::unordered_map<int, int>> pendingHashColumnValues;
+
 		// Thumbnails
 		// The first imagelist will be used to retrieve item icons in thumbnails mode.
 		HIMAGELIST thumbnailsShellImageList = nullptr;
 		wil::unique_himagelist thumbnailsImageList;
 
-		ListViewGroupSet groups;
+		ItemGroupSet groups;
 
 		DirectoryState() :
 			virtualFolder(false),
@@ -369,10 +371,6 @@ private:
 		Committed
 	};
 
-	static const UINT WM_APP_COLUMN_RESULT_READY = WM_APP + 150;
-	static const UINT WM_APP_THUMBNAIL_RESULT_READY = WM_APP + 151;
-	static const UINT WM_APP_INFO_TIP_READY = WM_APP + 152;
-
 	ShellBrowserImpl(HWND hOwner, App *app, CoreInterface *coreInterface,
 		TabNavigationInterface *tabNavigation, FileActionHandler *fileActionHandler,
 		const FolderSettings &folderSettings, const FolderColumns *initialColumns);
@@ -397,19 +395,44 @@ private:
 	void OnNavigationComitted(const NavigationRequest *request);
 	void AddNavigationItems(const NavigationRequest *request,
 		const std::vector<PidlChild> &itemPidls);
+	void RestoreSelectionAfterNavigation(const NavigationRequest *request);
+	void StartDirectoryMonitoringIfNecessary();
 	std::vector<ItemInfo_t> GetItemInformationFromPidls(const NavigationRequest *request,
 		const std::vector<PidlChild> &itemPidls);
 	void InsertAwaitingItems();
 	BOOL IsFileFiltered(const ItemInfo_t &itemInfo) const;
 	std::optional<int> AddItemInternal(IShellFolder *shellFolder, PCIDLIST_ABSOLUTE pidlDirectory,
 		PCITEMID_CHILD pidlChild, int itemIndex, BOOL setPosition);
-	int AddItemInternal(int itemIndex, const ItemInfo_t &itemInfo, BOOL setPosition);
+	int AddItemInternal(int itemIndex, std::shared_ptr<const ItemInfo_t> itemInfo,
+		BOOL setPosition);
 	static HRESULT ExtractFindDataUsingPropertyStore(IShellFolder *shellFolder,
 		PCITEMID_CHILD pidlChild, WIN32_FIND_DATA &output);
 	void SetViewModeInternal(ViewMode viewMode);
 	void SetFirstColumnTextToCallback();
 	void SetFirstColumnTextToFilename();
 	void SetNavigationState(NavigationState navigationState);
+	void ExitDormantState();
+
+	// Folder snapshots
+	std::shared_ptr<const FolderSnapshot> MaybeGetFolderSnapshot(
+		const NavigateParams &navigateParams);
+	void SaveFolderSnapshot();
+	std::vector<SortKey> GetSortKeys() const;
+	void AddSnapshotItems(const NavigationRequest *request,
+		std::shared_ptr<const FolderSnapshot> snapshot);
+	void RestoreSnapshotScrollPosition(const FolderSnapshot &snapshot);
+	static concurrencpp::null_result RevalidateFolderSnapshot(WeakPtr<ShellBrowserImpl> weakSelf,
+		std::shared_ptr<const ShellEnumeratorImpl> shellEnumerator,
+		std::shared_ptr<const FolderSnapshot> snapshot, Runtime *runtime,
+		std::stop_token stopToken);
+	void ApplyFolderSnapshotDiff(const FolderSnapshot &snapshot,
+		const std::vector<PidlChild> &currentItems, const FolderSnapshotDiff &diff);
+
+	// Folder prefetching
+	std::shared_ptr<FolderPrefetch> MaybeTakeFolderPrefetch(const NavigateParams &navigateParams);
+	void PrefetchPredictedFolders();
+	void OnListViewMouseMove(const POINT &pt);
+	void OnHoverPrefetchTimer(int internalIndex);
 
 	// Shell window integration
 	void NotifyShellOfNavigation(PCIDLIST_ABSOLUTE pidl);
@@ -435,10 +458,10 @@ private:
 	LRESULT OnListViewGetInfoTip(NMLVGETINFOTIP *getInfoTip);
 	BOOL OnListViewGetEmptyMarkup(NMLVEMPTYMARKUP *emptyMarkup);
 	void QueueInfoTipTask(int internalIndex, const std::wstring &existingInfoTip);
-	static std::optional<InfoTipResult> GetInfoTipAsync(HWND listView, int infoTipResultId,
-		int internalIndex, const BasicItemInfo_t &basicItemInfo, const Config &config,
-		HINSTANCE resourceInstance, bool virtualFolder);
-	void ProcessInfoTipResult(int infoTipResultId);
+	static std::optional<InfoTipResult> GetInfoTipAsync(int internalIndex,
+		const BasicItemInfo_t &basicItemInfo, const Config &config, HINSTANCE resourceInstance,
+		bool virtualFolder);
+	void ProcessInfoTipResult(const InfoTipResult &result);
 	void OnListViewItemInserted(const NMLISTVIEW *itemData);
 	void OnListViewItemChanged(const NMLISTVIEW *changeData);
 	void UpdateFileSelectionInfo(int internalIndex, BOOL selected);
@@ -471,31 +494,63 @@ private:
 		const std::unordered_map<int, ColumnType> &menuItemMappings);
 
 	const ItemInfo_t &GetItemByIndex(int index) const;
-	ItemInfo_t &GetItemByIndex(int index);
 	int GetItemInternalIndex(int item) const;
 
 	BasicItemInfo_t getBasicItemInfo(int internalIndex) const;
+	static BasicItemInfo_t BuildBasicItemInfo(const ItemInfo_t &itemInfo);
 
 	/* Sorting. */
 	void SortFolder();
 	int CALLBACK Sort(int InternalIndex1, int InternalIndex2) const;
+	int CompareItems(SortMode sortMode, int internalIndex1, const BasicItemInfo_t &basicItemInfo1,
+		int internalIndex2, const BasicItemInfo_t &basicItemInfo2) const;
+	static int ApplySortDirection(int comparisonResult, SortDirection direction);
+	void UpdateSecondarySortKeys(SortMode clickedSortMode);
+	void RequestSortAndGroupColumnValues();
+	void RequestSortAndGroupColumnValues(const std::vector<int> &internalIndexes);
+	void OnColumnValuesRetrieved(SortMode sortMode);
 
 	/* Listview column support. */
 	void AddFirstColumn();
 	void SetUpListViewColumns();
 	void DeleteAllColumns();
 	void QueueColumnTask(int itemInternalIndex, ColumnType columnType);
-	static ColumnResult_t GetColumnTextAsync(HWND listView, int columnResultId,
-		ColumnType columnType, int internalIndex, const BasicItemInfo_t &basicItemInfo,
-		const GlobalFolderSettings &globalFolderSettings);
+	static ColumnResult_t GetColumnTextAsync(ColumnType columnType, int internalIndex,
+		const BasicItemInfo_t &basicItemInfo, const GlobalFolderSettings &globalFolderSettings);
 	void InsertColumn(ColumnType columnType, int columnIndex, int width);
 	void SetActiveColumnSet();
 	void GetColumnInternal(ColumnType columnType, Column_t *pci) const;
 	Column_t GetFirstCheckedColumn();
 	void SaveColumnWidths();
-	void ProcessColumnResult(int columnResultId);
+	void ProcessColumnResult(const ColumnResult_t &result);
 	std::optional<int> GetColumnIndexByType(ColumnType columnType) const;
 	std::optional<ColumnType> GetColumnTypeByIndex(int index) const;
+	bool IsColumnShown(const Column_t &column) const;
+	bool IsColumnAvailable(ColumnType columnType) const;
+
+	/* Plugin columns. */
+	void QueuePluginColumnTask(int itemInternalIndex, ColumnType columnType);
+	void RequestPluginColumnValue(int slot, int internalIndex);
+	bool ProcessPluginColumnResult(const ColumnResult_t &result);
+	const Plugins::PluginColumnValue *GetPluginColumnValue(int slot, int internalIndex) const;
+	int ComparePluginColumnValues(SortMode sortMode, int internalIndex1,
+		int internalIndex2) const;
+	std::vector<GroupInfo> DeterminePluginColumnGroupInfos(
+		const std::vector<int> &internalIndexes) const;
+	void InvalidatePluginColumnValues(int internalIndex);
+	void CancelPluginColumnTasks();
+	void OnPluginColumnsChanged();
+
+	/* Hash columns. */
+	void QueueHashColumnTask(int itemInternalIndex, ColumnType columnType);
+	void RequestHashColumnValue(HashAlgorithm algorithm, int internalIndex);
+	bool ProcessHashColumnResult(const ColumnResult_t &result);
+	const std::wstring *GetHashColumnValue(HashAlgorithm algorithm, int internalIndex) const;
+	int CompareHashColumnValues(SortMode sortMode, int internalIndex1, int internalIndex2) const;
+	std::vector<GroupInfo> DetermineHashColumnGroupInfos(
+		const std::vector<int> &internalIndexes) const;
+	void InvalidateHashColumnValues(int internalIndex);
+	void CancelHashColumnTasks();
 
 	/* Device change support. */
 	void UpdateDriveIcon(const TCHAR *szDrive);
@@ -515,7 +570,8 @@ private:
 	void OnItemRenamed(PCIDLIST_ABSOLUTE simplePidlOld, PCIDLIST_ABSOLUTE simplePidlNew);
 	void InvalidateAllColumnsForItem(int itemIndex);
 	void InvalidateIconForItem(int itemIndex);
-	int DetermineItemSortedPosition(LPARAM lParam) const;
+	int DetermineItemSortedPosition(int internalIndex) const;
+	std::vector<int> DetermineItemSortedPositions(std::vector<int> &internalIndexes) const;
 	static concurrencpp::null_result OnCurrentDirectoryRenamed(WeakPtr<ShellBrowserImpl> weakSelf,
 		PidlAbsolute simplePidlUpdated, Runtime *runtime);
 	static concurrencpp::null_result OnDirectoryPropertiesChanged(
@@ -533,14 +589,16 @@ private:
 	void UnfilterAllItems();
 	void UnfilterItem(int internalIndex);
 	void RestoreFilteredItem(int internalIndex);
+	void RestoreFilteredItems(std::vector<int> internalIndexes);
 
 	/* Listview group support. */
 	static int CALLBACK GroupComparisonStub(int id1, int id2, void *data);
 	int GroupComparison(int id1, int id2);
-	int GroupNameComparison(const ListViewGroup &group1, const ListViewGroup &group2);
-	int GroupRelativePositionComparison(const ListViewGroup &group1, const ListViewGroup &group2);
-	const ListViewGroup GetListViewGroupById(int groupId);
+	ItemGroupSet::Order GetGroupOrder() const;
+	const ListViewGroup &GetListViewGroupById(int groupId) const;
 	int DetermineItemGroup(int iItemInternal);
+	GroupInfo DetermineItemGroupInfo(const BasicItemInfo_t &basicItemInfo) const;
+	std::vector<GroupInfo> DetermineItemGroupInfos(const std::vector<int> &internalIndexes) const;
 	std::optional<GroupInfo> DetermineItemNameGroup(const BasicItemInfo_t &itemInfo) const;
 	std::optional<GroupInfo> DetermineItemSizeGroup(const BasicItemInfo_t &itemInfo) const;
 	std::optional<GroupInfo> DetermineItemTotalSizeGroup(const BasicItemInfo_t &itemInfo) const;
@@ -566,11 +624,14 @@ private:
 	void InsertItemIntoGroup(int index, int groupId);
 	void EnsureGroupExistsInListView(int groupId);
 	void InsertGroupIntoListView(const ListViewGroup &listViewGroup);
+	void AppendGroupToListView(const ListViewGroup &listViewGroup);
+	LVGROUP BuildListViewGroup(const ListViewGroup &listViewGroup, std::wstring &header);
 	void RemoveGroupFromListView(const ListViewGroup &listViewGroup);
 	void UpdateGroupHeader(const ListViewGroup &listViewGroup);
 	std::wstring GenerateGroupHeader(const ListViewGroup &listViewGroup);
 	void OnItemRemovedFromGroup(int groupId);
 	void OnItemAddedToGroup(int groupId);
+	void UpdateChangedGroupHeaders();
 	std::optional<int> GetItemGroupId(int index);
 
 	/* Listview icons. */
@@ -581,7 +642,7 @@ private:
 	std::optional<int> GetCachedThumbnailIndex(const ItemInfo_t &itemInfo);
 	static wil::unique_hbitmap GetThumbnail(PCIDLIST_ABSOLUTE pidl, UINT thumbnailSize,
 		WTS_FLAGS flags);
-	void ProcessThumbnailResult(int thumbnailResultId);
+	void ProcessThumbnailResult(const ThumbnailResult_t &result);
 	void SetupThumbnailsView(int shellImageListType);
 	void RemoveThumbnailsView();
 	void InvalidateAllItemImages();
@@ -629,6 +690,7 @@ private:
 	NavigationManager m_navigationManager;
 	std::unique_ptr<ShellNavigationController> m_navigationController;
 	NavigationState m_navigationState = NavigationState::NoFolderShown;
+	std::optional<NavigateParams> m_dormantNavigation;
 	const HCURSOR m_progressCursor;
 
 	TabNavigationInterface *m_tabNavigation;
@@ -646,29 +708,63 @@ private:
 
 	DirectoryState m_directoryState;
 
-	/* Stores various extra information on files, such
-	as display name. */
-	std::unordered_map<int, ItemInfo_t> m_itemInfoMap;
+	// Stores various extra information on files, such as display name. Items aren't modified once
+	// added (an item that changes is replaced instead), which allows them to be shared with folder
+	// snapshots, rather than being copied.
+	std::unordered_map<int, std::shared_ptr<const ItemInfo_t>> m_itemInfoMap;
+
+	// The positions used when items are rearranged via drag and drop in details mode, keyed by
+	// internal index. This is only used while the items are being sorted.
+	std::unordered_map<int, int> m_relativeSortPositions;
 
+	// Results from each of the thread pools below are delivered to the UI thread via a
+	// ResultChannel. Invalidating a channel discards any results that are still pending.
 	ctpl::thread_pool m_columnThreadPool;
-	std::unordered_map<int, std::future<ColumnResult_t>> m_columnResults;
-	int m_columnResultIDCounter;
+	ResultChannel<ColumnResult_t> m_columnResults;
+
+	// Plugin columns are evaluated on the thread pool owned by the registry, which is shared by all
+	// tabs. Results are delivered through m_columnResults. Any outstanding evaluations are
+	// cancelled when the folder changes.
+	Plugins::PluginColumnRegistry *const m_pluginColumnRegistry;
+	std::unique_ptr<ScopedStopSource> m_pluginColumnStopSource;
+
+	// Hash columns are calculated on the thread pool owned by the hash service, which is also
+	// shared by all tabs. Any outstanding hashing work is cancelled when the folder changes.
+	FileHashService *const m_fileHashService;
+	std::unique_ptr<ScopedStopSource> m_hashColumnStopSource;
+
+	// Snapshots are shared by all tabs. When a folder is shown from a snapshot, it's enumerated
+	// again in the background, which is cancelled if the folder changes in the meantime.
+	FolderSnapshotCache *const m_folderSnapshotCache;
+	std::unique_ptr<ScopedStopSource> m_snapshotRevalidationStopSource;
+
+	// Only set if prefetching is enabled. Prefetched results are specific to this tab, since
+	// they depend on the tab's hidden items setting, though the counters are shared.
+	std::unique_ptr<FolderPrefetcher> m_folderPrefetcher;
+	std::optional<int> m_hoverPrefetchItem;
+	concurrencpp::timer m_hoverPrefetchTimer;
 
 	std::unique_ptr<IconFetcher> m_iconFetcher;
 	CachedIcons *m_cachedIcons;
 
 	ctpl::thread_pool m_thumbnailThreadPool;
-	std::unordered_map<int, std::future<std::optional<ThumbnailResult_t>>> m_thumbnailResults;
-	int m_thumbnailResultIDCounter;
+	ResultChannel<ThumbnailResult_t> m_thumbnailResults;
 
 	ctpl::thread_pool m_infoTipsThreadPool;
-	std::unordered_map<int, std::future<std::optional<InfoTipResult>>> m_infoTipResults;
-	int m_infoTipResultIDCounter;
+	ResultChannel<InfoTipResult> m_infoTipResults;
+
+	// Used to determine the groups for large folders in parallel. The threads are only started the
+	// first time they're needed and are released when the browser becomes dormant.
+	mutable ctpl::thread_pool m_groupThreadPool;
 
 	/* Internal state. */
 	const HINSTANCE m_resourceInstance;
 	AcceleratorManager *const m_acceleratorManager;
 	bool m_folderVisited = false;
+
+	// Set while items are being inserted in bulk, in which case group headers are only updated once
+	// all items have been inserted.
+	bool m_deferGroupHeaderUpdates = false;
 	std::optional<int> m_dirMonitorId;
 	int m_iFolderIcon;
 	int m_iFileIcon;
@@ -182,10 +182,14 @@ void ShellNavigationController::Navigate(NavigateParams &navigateParams)
 	// the current tab, regardless of whether or not the tab is locked. The only exception is a
 	// navigation to a history entry, except the current history entry (navigating to the current
 	// history entry is an explicit refresh).
+	//
+	// As the purpose of a refresh is to show the current contents of the folder, cached items
+	// shouldn't be used in that case.
 	if (targetEntry == currentEntry && currentEntry->GetPidl() == navigateParams.pidl)
 	{
 		navigateParams.historyEntryType = HistoryEntryType::ReplaceCurrentEntry;
 		navigateParams.overrideNavigationTargetMode = true;
+		navigateParams.useCachedItems = false;
 	}
 
 	if (m_navigationTargetMode == NavigationTargetMode::ForceNewTab
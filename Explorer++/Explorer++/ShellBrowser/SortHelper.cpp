@@ -5,8 +5,11 @@
 #include "stdafx.h"
 #include "SortHelper.h"
 #include "ItemData.h"
+#include "../Helper/ShellHelper.h"
 #include <wil/common.h>
+#include <propkey.h>
 #include <propvarutil.h>
+#include <cassert>
 
 int SortByName(const BasicItemInfo_t &itemInfo1, const BasicItemInfo_t &itemInfo2,
 	const GlobalFolderSettings &globalFolderSettings)
@@ -369,3 +372,276 @@ int SortByMediaMetadata(const BasicItemInfo_t &itemInfo1, const BasicItemInfo_t
 
 	return StrCmpLogicalW(mediaMetadata1.c_str(), mediaMetadata2.c_str());
 }
+
+int CompareItemsBySortMode(SortMode sortMode, const BasicItemInfo_t &itemInfo1,
+	const BasicItemInfo_t &itemInfo2, const GlobalFolderSettings &globalFolderSettings)
+{
+	int comparisonResult = 0;
+
+	switch (sortMode)
+	{
+	case SortMode::Name:
+		comparisonResult = SortByName(itemInfo1, itemInfo2, globalFolderSettings);
+		break;
+
+	case SortMode::Type:
+		comparisonResult = SortByType(itemInfo1, itemInfo2);
+		break;
+
+	case SortMode::Size:
+		comparisonResult = SortBySize(itemInfo1, itemInfo2);
+		break;
+
+	case SortMode::DateModified:
+		comparisonResult = SortByDate(itemInfo1, itemInfo2, DateType::Modified);
+		break;
+
+	case SortMode::TotalSize:
+		comparisonResult = SortByTotalSize(itemInfo1, itemInfo2, TRUE);
+		break;
+
+	case SortMode::FreeSpace:
+		comparisonResult = SortByTotalSize(itemInfo1, itemInfo2, FALSE);
+		break;
+
+	case SortMode::DateDeleted:
+		comparisonResult = SortByItemDetails(itemInfo1, itemInfo2, &SCID_DATE_DELETED);
+		break;
+
+	case SortMode::OriginalLocation:
+		comparisonResult = SortByItemDetails(itemInfo1, itemInfo2, &SCID_ORIGINAL_LOCATION);
+		break;
+
+	case SortMode::Attributes:
+		comparisonResult = SortByAttributes(itemInfo1, itemInfo2);
+		break;
+
+	case SortMode::RealSize:
+		comparisonResult = SortByRealSize(itemInfo1, itemInfo2);
+		break;
+
+	case SortMode::ShortName:
+		comparisonResult = SortByShortName(itemInfo1, itemInfo2);
+		break;
+
+	case SortMode::Owner:
+		comparisonResult = SortByOwner(itemInfo1, itemInfo2);
+		break;
+
+	case SortMode::ProductName:
+		comparisonResult = SortByVersionInfo(itemInfo1, itemInfo2, VersionInfoType::ProductName);
+		break;
+
+	case SortMode::Company:
+		comparisonResult = SortByVersionInfo(itemInfo1, itemInfo2, VersionInfoType::Company);
+		break;
+
+	case SortMode::Description:
+		comparisonResult = SortByVersionInfo(itemInfo1, itemInfo2, VersionInfoType::Description);
+		break;
+
+	case SortMode::FileVersion:
+		comparisonResult = SortByVersionInfo(itemInfo1, itemInfo2, VersionInfoType::FileVersion);
+		break;
+
+	case SortMode::ProductVersion:
+		comparisonResult = SortByVersionInfo(itemInfo1, itemInfo2, VersionInfoType::ProductVersion);
+		break;
+
+	case SortMode::ShortcutTo:
+		comparisonResult = SortByShortcutTo(itemInfo1, itemInfo2);
+		break;
+
+	case SortMode::HardLinks:
+		comparisonResult = SortByHardlinks(itemInfo1, itemInfo2);
+		break;
+
+	case SortMode::Extension:
+		comparisonResult = SortByExtension(itemInfo1, itemInfo2);
+		break;
+
+	case SortMode::Created:
+		comparisonResult = SortByDate(itemInfo1, itemInfo2, DateType::Created);
+		break;
+
+	case SortMode::Accessed:
+		comparisonResult = SortByDate(itemInfo1, itemInfo2, DateType::Accessed);
+		break;
+
+	case SortMode::Title:
+		comparisonResult = SortByItemDetails(itemInfo1, itemInfo2, &PKEY_Title);
+		break;
+
+	case SortMode::Subject:
+		comparisonResult = SortByItemDetails(itemInfo1, itemInfo2, &PKEY_Subject);
+		break;
+
+	case SortMode::Authors:
+		comparisonResult = SortByItemDetails(itemInfo1, itemInfo2, &PKEY_Author);
+		break;
+
+	case SortMode::Keywords:
+		comparisonResult = SortByItemDetails(itemInfo1, itemInfo2, &PKEY_Keywords);
+		break;
+
+	case SortMode::Comments:
+		comparisonResult = SortByItemDetails(itemInfo1, itemInfo2, &PKEY_Comment);
+		break;
+
+	case SortMode::CameraModel:
+		comparisonResult = SortByImageProperty(itemInfo1, itemInfo2, PropertyTagEquipModel);
+		break;
+
+	case SortMode::DateTaken:
+		comparisonResult = SortByImageProperty(itemInfo1, itemInfo2, PropertyTagDateTime);
+		break;
+
+	case SortMode::Width:
+		comparisonResult = SortByImageProperty(itemInfo1, itemInfo2, PropertyTagImageWidth);
+		break;
+
+	case SortMode::Height:
+		comparisonResult = SortByImageProperty(itemInfo1, itemInfo2, PropertyTagImageHeight);
+		break;
+
+	case SortMode::VirtualComments:
+		comparisonResult = SortByVirtualComments(itemInfo1, itemInfo2);
+		break;
+
+	case SortMode::FileSystem:
+		comparisonResult = SortByFileSystem(itemInfo1, itemInfo2);
+		break;
+
+	case SortMode::NumPrinterDocuments:
+		comparisonResult = SortByPrinterProperty(itemInfo1, itemInfo2,
+			PrinterInformationType::NumJobs);
+		break;
+
+	case SortMode::PrinterStatus:
+		comparisonResult = SortByPrinterProperty(itemInfo1, itemInfo2,
+			PrinterInformationType::Status);
+		break;
+
+	case SortMode::PrinterComments:
+		comparisonResult = SortByPrinterProperty(itemInfo1, itemInfo2,
+			PrinterInformationType::Comments);
+		break;
+
+	case SortMode::PrinterLocation:
+		comparisonResult = SortByPrinterProperty(itemInfo1, itemInfo2,
+			PrinterInformationType::Location);
+		break;
+
+	case SortMode::NetworkAdapterStatus:
+		comparisonResult = SortByNetworkAdapterStatus(itemInfo1, itemInfo2);
+		break;
+
+	case SortMode::MediaBitrate:
+		comparisonResult = SortByMediaMetadata(itemInfo1, itemInfo2, MediaMetadataType::Bitrate);
+		break;
+
+	case SortMode::MediaCopyright:
+		comparisonResult = SortByMediaMetadata(itemInfo1, itemInfo2, MediaMetadataType::Copyright);
+		break;
+
+	case SortMode::MediaDuration:
+		comparisonResult = SortByMediaMetadata(itemInfo1, itemInfo2, MediaMetadataType::Duration);
+		break;
+
+	case SortMode::MediaProtected:
+		comparisonResult = SortByMediaMetadata(itemInfo1, itemInfo2, MediaMetadataType::Protected);
+		break;
+
+	case SortMode::MediaRating:
+		comparisonResult = SortByMediaMetadata(itemInfo1, itemInfo2, MediaMetadataType::Rating);
+		break;
+
+	case SortMode::MediaAlbumArtist:
+		comparisonResult =
+			SortByMediaMetadata(itemInfo1, itemInfo2, MediaMetadataType::AlbumArtist);
+		break;
+
+	case SortMode::MediaAlbum:
+		comparisonResult = SortByMediaMetadata(itemInfo1, itemInfo2, MediaMetadataType::AlbumTitle);
+		break;
+
+	case SortMode::MediaBeatsPerMinute:
+		comparisonResult = SortByMediaMetadata(itemInfo1, itemInfo2,
+			MediaMetadataType::BeatsPerMinute);
+		break;
+
+	case SortMode::MediaComposer:
+		comparisonResult = SortByMediaMetadata(itemInfo1, itemInfo2, MediaMetadataType::Composer);
+		break;
+
+	case SortMode::MediaConductor:
+		comparisonResult = SortByMediaMetadata(itemInfo1, itemInfo2, MediaMetadataType::Conductor);
+		break;
+
+	case SortMode::MediaDirector:
+		comparisonResult = SortByMediaMetadata(itemInfo1, itemInfo2, MediaMetadataType::Director);
+		break;
+
+	case SortMode::MediaGenre:
+		comparisonResult = SortByMediaMetadata(itemInfo1, itemInfo2, MediaMetadataType::Genre);
+		break;
+
+	case SortMode::MediaLanguage:
+		comparisonResult = SortByMediaMetadata(itemInfo1, itemInfo2, MediaMetadataType::Language);
+		break;
+
+	case SortMode::MediaBroadcastDate:
+		comparisonResult = SortByMediaMetadata(itemInfo1, itemInfo2,
+			MediaMetadataType::BroadcastDate);
+		break;
+
+	case SortMode::MediaChannel:
+		comparisonResult = SortByMediaMetadata(itemInfo1, itemInfo2, MediaMetadataType::Channel);
+		break;
+
+	case SortMode::MediaStationName:
+		comparisonResult =
+			SortByMediaMetadata(itemInfo1, itemInfo2, MediaMetadataType::StationName);
+		break;
+
+	case SortMode::MediaMood:
+		comparisonResult = SortByMediaMetadata(itemInfo1, itemInfo2, MediaMetadataType::Mood);
+		break;
+
+	case SortMode::MediaParentalRating:
+		comparisonResult = SortByMediaMetadata(itemInfo1, itemInfo2,
+			MediaMetadataType::ParentalRating);
+		break;
+
+	case SortMode::MediaParentalRatingReason:
+		comparisonResult = SortByMediaMetadata(itemInfo1, itemInfo2,
+			MediaMetadataType::ParentalRatingReason);
+		break;
+
+	case SortMode::MediaPeriod:
+		comparisonResult = SortByMediaMetadata(itemInfo1, itemInfo2, MediaMetadataType::Period);
+		break;
+
+	case SortMode::MediaProducer:
+		comparisonResult = SortByMediaMetadata(itemInfo1, itemInfo2, MediaMetadataType::Producer);
+		break;
+
+	case SortMode::MediaPublisher:
+		comparisonResult = SortByMediaMetadata(itemInfo1, itemInfo2, MediaMetadataType::Publisher);
+		break;
+
+	case SortMode::MediaWriter:
+		comparisonResult = SortByMediaMetadata(itemInfo1, itemInfo2, MediaMetadataType::Writer);
+		break;
+
+	case SortMode::MediaYear:
+		comparisonResult = SortByMediaMetadata(itemInfo1, itemInfo2, MediaMetadataType::Year);
+		break;
+
+	default:
+		assert(false);
+		break;
+	}
+
+	return comparisonResult;
+}
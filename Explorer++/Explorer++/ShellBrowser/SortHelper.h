@@ -44,3 +44,8 @@ int SortByPrinterProperty(const BasicItemInfo_t &itemInfo1, const BasicItemInfo_
 int SortByNetworkAdapterStatus(const BasicItemInfo_t &itemInfo1, const BasicItemInfo_t &itemInfo2);
 int SortByMediaMetadata(const BasicItemInfo_t &itemInfo1, const BasicItemInfo_t &itemInfo2,
 	MediaMetadataType mediaMetadataType);
+
+// Compares two items using the specified sort mode. Sort modes that rely on data held by the
+// ShellBrowserImpl instance (i.e. plugin columns) aren't supported here.
+int CompareItemsBySortMode(SortMode sortMode, const BasicItemInfo_t &itemInfo1,
+	const BasicItemInfo_t &itemInfo2, const GlobalFolderSettings &globalFolderSettings);
@@ -4,6 +4,8 @@
 
 #include "stdafx.h"
 #include "SortModes.h"
+#include "Columns.h"
+#include <sstream>
 
 SortDirection InvertSortDirection(SortDirection direction)
 {
@@ -16,3 +18,75 @@ SortDirection InvertSortDirection(SortDirection direction)
 		return SortDirection::Ascending;
 	}
 }
+
+bool IsPluginSortMode(SortMode sortMode)
+{
+	return sortMode._to_integral() >= (+SortMode::PluginColumn1)._to_integral()
+		&& sortMode._to_integral() < (+SortMode::PluginColumn1)._to_integral() + NUM_PLUGIN_COLUMNS;
+}
+
+int GetPluginSortModeSlot(SortMode sortMode)
+{
+	return sortMode._to_integral() - (+SortMode::PluginColumn1)._to_integral();
+}
+
+SortMode GetPluginSortMode(int slot)
+{
+	return SortMode::_from_integral((+SortMode::PluginColumn1)._to_integral() + slot);
+}
+
+bool IsHashSortMode(SortMode sortMode)
+{
+	return sortMode == +SortMode::HashCrc32 || sortMode == +SortMode::HashXxHash64
+		|| sortMode == +SortMode::HashSha256;
+}
+
+std::wstring EncodeSortKeys(const std::vector<SortKey> &sortKeys)
+{
+	std::wstring encodedSortKeys;
+
+	for (const auto &sortKey : sortKeys)
+	{
+		if (!encodedSortKeys.empty())
+		{
+			encodedSortKeys += L",";
+		}
+
+		encodedSortKeys += std::to_wstring(sortKey.mode._to_integral()) + L":"
+			+ std::to_wstring(sortKey.direction._to_integral());
+	}
+
+	return encodedSortKeys;
+}
+
+std::vector<SortKey> DecodeSortKeys(const std::wstring &encodedSortKeys)
+{
+	std::vector<SortKey> sortKeys;
+	std::wistringstream stream(encodedSortKeys);
+	std::wstring entry;
+
+	while (std::getline(stream, entry, L','))
+	{
+		int mode;
+		int direction;
+		wchar_t separator;
+		std::wistringstream entryStream(entry);
+
+		if (!(entryStream >> mode >> separator >> direction) || separator != L':')
+		{
+			continue;
+		}
+
+		auto sortMode = SortMode::_from_integral_nothrow(mode);
+		auto sortDirection = SortDirection::_from_integral_nothrow(direction);
+
+		if (!sortMode || !sortDirection)
+		{
+			continue;
+		}
+
+		sortKeys.push_back({ *sortMode, *sortDirection });
+	}
+
+	return sortKeys;
+}
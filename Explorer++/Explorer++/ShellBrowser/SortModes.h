@@ -5,6 +5,8 @@
 #pragma once
 
 #include "../Helper/BetterEnumsWrapper.h"
+#include <string>
+#include <vector>
 
 // These are used for both sorting and grouping. For example, it's possible to both sort a folder by
 // name and group a folder by name.
@@ -80,10 +82,30 @@ BETTER_ENUM(SortMode, int,
 	MediaProducer = 61,
 	MediaPublisher = 62,
 	MediaWriter = 63,
-	MediaYear = 64
+	MediaYear = 64,
+
+	PluginColumn1 = 65,
+	PluginColumn2 = 66,
+	PluginColumn3 = 67,
+	PluginColumn4 = 68,
+	PluginColumn5 = 69,
+	PluginColumn6 = 70,
+	PluginColumn7 = 71,
+	PluginColumn8 = 72,
+
+	HashCrc32 = 73,
+	HashXxHash64 = 74,
+	HashSha256 = 75
 )
 // clang-format on
 
+// Each plugin column slot has a corresponding sort mode.
+bool IsPluginSortMode(SortMode sortMode);
+int GetPluginSortModeSlot(SortMode sortMode);
+SortMode GetPluginSortMode(int slot);
+
+bool IsHashSortMode(SortMode sortMode);
+
 // clang-format off
 BETTER_ENUM(SortDirection, int,
 	Ascending = 0,
@@ -91,4 +113,19 @@ BETTER_ENUM(SortDirection, int,
 )
 // clang-format on
 
+// A single level of a multi-level sort.
+struct SortKey
+{
+	SortMode mode;
+	SortDirection direction;
+
+	// This is only used in tests.
+	bool operator==(const SortKey &) const = default;
+};
+
 SortDirection InvertSortDirection(SortDirection direction);
+
+// Converts a set of sort keys to and from a compact string representation (e.g. "4:0,2:1"), which
+// is used when saving folder settings. Invalid entries are skipped when decoding.
+std::wstring EncodeSortKeys(const std::vector<SortKey> &sortKeys);
+std::vector<SortKey> DecodeSortKeys(const std::wstring &encodedSortKeys);
@@ -0,0 +1,77 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#pragma once
+
+#include <algorithm>
+#include <vector>
+
+// Helpers for inserting items into a range that's already sorted, without having to re-sort the
+// entire range. The range itself isn't accessed directly; callers provide a function that compares
+// an item with the existing item at a particular index, which makes it possible to use these
+// functions with the listview, as well as with plain containers.
+//
+// Insertion is stable: an item that compares equal to one or more existing items is placed after
+// them and items inserted as part of a single batch retain their relative order.
+namespace SortedInsertion
+{
+
+// Returns the position within [begin, end) at which an item should be inserted, so that the range
+// remains sorted. compareWithItemAt(index) should return a value less than 0 if the new item should
+// appear before the existing item at the specified index.
+template <class CompareWithItemAt>
+int FindInsertPosition(int begin, int end, CompareWithItemAt compareWithItemAt)
+{
+	while (begin < end)
+	{
+		int middle = begin + ((end - begin) / 2);
+
+		if (compareWithItemAt(middle) < 0)
+		{
+			end = middle;
+		}
+		else
+		{
+			begin = middle + 1;
+		}
+	}
+
+	return begin;
+}
+
+// Sorts the new items, then determines where each one should be placed when merged into an
+// existing sorted range of numExistingItems items. The returned positions correspond to the
+// (sorted) new items and take the earlier new items into account, so inserting each new item at
+// its position, in order, will result in a sorted range.
+//
+// compareItems(item1, item2) compares two new items, while compareWithItemAt(item, index) compares
+// a new item with the existing item at the specified index. Because the new items are sorted
+// first, each search only has to consider the part of the existing range that follows the
+// previously inserted item.
+template <class T, class CompareItems, class CompareWithItemAt>
+std::vector<int> MergeIntoSortedRange(std::vector<T> &newItems, int numExistingItems,
+	CompareItems compareItems, CompareWithItemAt compareWithItemAt)
+{
+	std::stable_sort(newItems.begin(), newItems.end(),
+		[&compareItems](const T &item1, const T &item2) { return compareItems(item1, item2) < 0; });
+
+	std::vector<int> positions;
+	positions.reserve(newItems.size());
+
+	int previousPosition = 0;
+
+	for (const auto &newItem : newItems)
+	{
+		int position = FindInsertPosition(previousPosition, numExistingItems,
+			[&compareWithItemAt, &newItem](int index)
+			{ return compareWithItemAt(newItem, index); });
+
+		positions.push_back(position + static_cast<int>(positions.size()));
+		previousPosition = position;
+	}
+
+	return positions;
+}
+
+}
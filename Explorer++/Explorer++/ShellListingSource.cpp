@@ -0,0 +1,191 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "stdafx.h"
+#include "ShellListingSource.h"
+#include "Plugins/PluginColumnEvaluator.h"
+#include "ShellBrowser/ColumnDataRetrieval.h"
+#include "ShellBrowser/ItemData.h"
+#include "ShellBrowser/ShellBrowserImpl.h"
+#include "ShellBrowser/SortHelper.h"
+#include "../Helper/ShellHelper.h"
+#include <wil/com.h>
+#include <wil/common.h>
+#include <algorithm>
+#include <numeric>
+
+namespace
+{
+
+bool IsFolder(const BasicItemInfo_t &itemInfo)
+{
+	return WI_IsFlagSet(itemInfo.wfd.dwFileAttributes, FILE_ATTRIBUTE_DIRECTORY);
+}
+
+int ApplySortDirection(int comparisonResult, SortDirection direction)
+{
+	return direction == +SortDirection::Descending ? -comparisonResult : comparisonResult;
+}
+
+}
+
+ShellListingSource::ShellListingSource(HWND embedder, std::vector<Column> columns,
+	const FolderSettings &folderSettings, const GlobalFolderSettings &globalFolderSettings) :
+	m_shellEnumerator(embedder,
+		folderSettings.showHidden ? ShellEnumeratorImpl::HiddenItemsPolicy::IncludeHidden
+								  : ShellEnumeratorImpl::HiddenItemsPolicy::ExcludeHidden),
+	m_columns(std::move(columns)),
+	m_folderSettings(folderSettings),
+	m_globalFolderSettings(globalFolderSettings)
+{
+}
+
+bool ShellListingSource::EnumerateFolder(const std::wstring &path,
+	std::vector<ListingEntry> &entries, std::stop_token stopToken)
+{
+	PidlAbsolute pidlDirectory;
+	HRESULT hr =
+		SHParseDisplayName(path.c_str(), nullptr, PidlOutParam(pidlDirectory), 0, nullptr);
+
+	if (FAILED(hr))
+	{
+		return false;
+	}
+
+	wil::com_ptr_nothrow<IShellFolder> shellFolder;
+	hr = SHBindToObject(nullptr, pidlDirectory.Raw(), nullptr, IID_PPV_ARGS(&shellFolder));
+
+	if (FAILED(hr))
+	{
+		return false;
+	}
+
+	std::vector<PidlChild> childPidls;
+	hr = m_shellEnumerator.EnumerateDirectory(pidlDirectory.Raw(), childPidls, stopToken);
+
+	if (FAILED(hr))
+	{
+		return false;
+	}
+
+	std::vector<BasicItemInfo_t> itemInfos;
+	itemInfos.reserve(childPidls.size());
+
+	for (const auto &childPidl : childPidls)
+	{
+		if (stopToken.stop_requested())
+		{
+			return false;
+		}
+
+		auto itemInfo = ShellBrowserImpl::GetBasicItemInformation(shellFolder.get(),
+			pidlDirectory.Raw(), childPidl.Raw());
+
+		if (itemInfo)
+		{
+			itemInfos.push_back(std::move(*itemInfo));
+		}
+	}
+
+	// BasicItemInfo_t can't be move assigned, so the items are sorted indirectly.
+	std::vector<size_t> order(itemInfos.size());
+	std::iota(order.begin(), order.end(), size_t{ 0 });
+	std::stable_sort(order.begin(), order.end(),
+		[this, &itemInfos](size_t index1, size_t index2)
+		{ return CompareItems(itemInfos[index1], itemInfos[index2]) < 0; });
+
+	entries.reserve(entries.size() + itemInfos.size());
+
+	for (size_t index : order)
+	{
+		if (stopToken.stop_requested())
+		{
+			return false;
+		}
+
+		const auto &itemInfo = itemInfos[index];
+
+		ListingEntry entry;
+		entry.path = itemInfo.getFullPath();
+		entry.name = itemInfo.szDisplayName;
+
+		// Reparse points (e.g. junctions) aren't followed, since they can form cycles.
+		entry.isFolder = IsFolder(itemInfo)
+			&& WI_IsFlagClear(itemInfo.wfd.dwFileAttributes, FILE_ATTRIBUTE_REPARSE_POINT);
+
+		entry.values.reserve(m_columns.size());
+
+		for (const auto &column : m_columns)
+		{
+			entry.values.push_back(GetColumnText(column, itemInfo));
+		}
+
+		entries.push_back(std::move(entry));
+	}
+
+	return true;
+}
+
+// This mirrors ShellBrowserImpl::Sort(), so that items are listed in the same order they appear in
+// the view.
+int ShellListingSource::CompareItems(const BasicItemInfo_t &itemInfo1,
+	const BasicItemInfo_t &itemInfo2) const
+{
+	if (!m_globalFolderSettings.displayMixedFilesAndFolders)
+	{
+		bool isFolder1 = IsFolder(itemInfo1);
+		bool isFolder2 = IsFolder(itemInfo2);
+
+		if (isFolder1 != isFolder2)
+		{
+			return ApplySortDirection(isFolder1 ? -1 : 1, m_folderSettings.sortDirection);
+		}
+	}
+
+	// Plugin and hash column values aren't cached here, so sorting by either type of column falls
+	// back to the secondary keys (and then the name).
+	if (!IsPluginSortMode(m_folderSettings.sortMode) && !IsHashSortMode(m_folderSettings.sortMode))
+	{
+		int comparisonResult = CompareItemsBySortMode(m_folderSettings.sortMode, itemInfo1,
+			itemInfo2, m_globalFolderSettings);
+
+		if (comparisonResult != 0)
+		{
+			return ApplySortDirection(comparisonResult, m_folderSettings.sortDirection);
+		}
+	}
+
+	for (const auto &sortKey : m_folderSettings.secondarySortKeys)
+	{
+		if (IsPluginSortMode(sortKey.mode) || IsHashSortMode(sortKey.mode))
+		{
+			continue;
+		}
+
+		int comparisonResult =
+			CompareItemsBySortMode(sortKey.mode, itemInfo1, itemInfo2, m_globalFolderSettings);
+
+		if (comparisonResult != 0)
+		{
+			return ApplySortDirection(comparisonResult, sortKey.direction);
+		}
+	}
+
+	int comparisonResult = m_globalFolderSettings.useNaturalSortOrder
+		? StrCmpLogicalW(itemInfo1.szDisplayName, itemInfo2.szDisplayName)
+		: StrCmpIW(itemInfo1.szDisplayName, itemInfo2.szDisplayName);
+
+	return ApplySortDirection(comparisonResult, m_folderSettings.sortDirection);
+}
+
+std::wstring ShellListingSource::GetColumnText(const Column &column,
+	const BasicItemInfo_t &itemInfo) const
+{
+	if (column.pluginEvaluator)
+	{
+		return column.pluginEvaluator->Evaluate(itemInfo.getFullPath()).text;
+	}
+
+	return ::GetColumnText(column.type, itemInfo, m_globalFolderSettings);
+}
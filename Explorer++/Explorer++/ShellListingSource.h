@@ -0,0 +1,51 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#pragma once
+
+#include "ListingWalker.h"
+#include "ShellEnumeratorImpl.h"
+#include "ShellBrowser/Columns.h"
+#include "ShellBrowser/FolderSettings.h"
+#include <memory>
+
+struct BasicItemInfo_t;
+
+namespace Plugins
+{
+class PluginColumnEvaluator;
+}
+
+// Provides the contents of shell folders to ListingWalker, using the same column text and sort
+// order that's used when the folder is displayed in a tab.
+//
+// Everything this class needs is copied on construction, so it can be used on a background thread
+// (with COM initialized).
+class ShellListingSource : public ListingSource
+{
+public:
+	struct Column
+	{
+		ColumnType type;
+
+		// Set for plugin columns, which are evaluated directly, rather than via
+		// GetColumnText().
+		std::shared_ptr<Plugins::PluginColumnEvaluator> pluginEvaluator;
+	};
+
+	ShellListingSource(HWND embedder, std::vector<Column> columns,
+		const FolderSettings &folderSettings, const GlobalFolderSettings &globalFolderSettings);
+
+	bool EnumerateFolder(const std::wstring &path, std::vector<ListingEntry> &entries,
+		std::stop_token stopToken) override;
+
+private:
+	int CompareItems(const BasicItemInfo_t &itemInfo1, const BasicItemInfo_t &itemInfo2) const;
+	std::wstring GetColumnText(const Column &column, const BasicItemInfo_t &itemInfo) const;
+
+	ShellEnumeratorImpl m_shellEnumerator;
+	const std::vector<Column> m_columns;
+	const FolderSettings m_folderSettings;
+	const GlobalFolderSettings m_globalFolderSettings;
+};
@@ -692,6 +692,11 @@ void ShellTreeView::OnSelectionChanged(const NMTREEVIEW *eventInfo)
 	{
 		m_selectionChangedEventInfo = *eventInfo;
 
+		// The selected folder will likely be navigated to once the delay has elapsed (if the
+		// selection doesn't change again before then), so it can be enumerated in the meantime.
+		auto pidlDirectory = GetNodePidl(eventInfo->itemNew.hItem);
+		GetSelectedShellBrowser()->PrefetchFolder(pidlDirectory.get());
+
 		// This makes it possible to navigate in the treeview using the keyboard, without triggering
 		// a stream of navigations (in the case where a key is being held down and the selection is
 		// continuously changing).
@@ -29,8 +29,19 @@ SortMenuBuilder::SortMenus SortMenuBuilder::BuildMenus(const Tab &tab)
 		int sortById = DetermineSortModeMenuId(sortMode);
 		int groupById = DetermineGroupModeMenuId(sortMode);
 
-		UINT stringIndex = GetSortMenuItemStringIndex(sortById);
-		std::wstring menuText = ResourceHelper::LoadString(m_resourceInstance, stringIndex);
+		std::wstring menuText;
+
+		if (IsPluginSortMode(sortMode))
+		{
+			// Plugin columns don't have an associated string resource.
+			menuText = tab.GetShellBrowserImpl()->GetColumnName(
+				GetPluginColumnType(GetPluginSortModeSlot(sortMode)));
+		}
+		else
+		{
+			UINT stringIndex = GetSortMenuItemStringIndex(sortById);
+			menuText = ResourceHelper::LoadString(m_resourceInstance, stringIndex);
+		}
 
 		MenuHelper::AddStringItem(sortByMenu.get(), sortById, menuText, position, TRUE);
 		MenuHelper::AddStringItem(groupByMenu.get(), groupById, menuText, position, TRUE);
@@ -299,6 +310,15 @@ UINT SortMenuBuilder::GetSortMenuItemStringIndex(UINT uItemId)
 	case IDM_SORTBY_MEDIA_YEAR:
 		return IDS_COLUMN_NAME_YEAR;
 
+	case IDM_SORTBY_HASH_CRC32:
+		return IDS_COLUMN_NAME_HASH_CRC32;
+
+	case IDM_SORTBY_HASH_XXHASH64:
+		return IDS_COLUMN_NAME_HASH_XXHASH64;
+
+	case IDM_SORTBY_HASH_SHA256:
+		return IDS_COLUMN_NAME_HASH_SHA256;
+
 	default:
 		assert(false);
 		break;
@@ -497,6 +517,39 @@ int SortMenuBuilder::DetermineSortModeMenuId(SortMode sortMode)
 	case SortMode::MediaYear:
 		return IDM_SORTBY_MEDIA_YEAR;
 
+	case SortMode::PluginColumn1:
+		return IDM_SORTBY_PLUGIN_COLUMN_1;
+
+	case SortMode::PluginColumn2:
+		return IDM_SORTBY_PLUGIN_COLUMN_2;
+
+	case SortMode::PluginColumn3:
+		return IDM_SORTBY_PLUGIN_COLUMN_3;
+
+	case SortMode::PluginColumn4:
+		return IDM_SORTBY_PLUGIN_COLUMN_4;
+
+	case SortMode::PluginColumn5:
+		return IDM_SORTBY_PLUGIN_COLUMN_5;
+
+	case SortMode::PluginColumn6:
+		return IDM_SORTBY_PLUGIN_COLUMN_6;
+
+	case SortMode::PluginColumn7:
+		return IDM_SORTBY_PLUGIN_COLUMN_7;
+
+	case SortMode::PluginColumn8:
+		return IDM_SORTBY_PLUGIN_COLUMN_8;
+
+	case SortMode::HashCrc32:
+		return IDM_SORTBY_HASH_CRC32;
+
+	case SortMode::HashXxHash64:
+		return IDM_SORTBY_HASH_XXHASH64;
+
+	case SortMode::HashSha256:
+		return IDM_SORTBY_HASH_SHA256;
+
 	default:
 		assert(false);
 		break;
@@ -695,6 +748,39 @@ int SortMenuBuilder::DetermineGroupModeMenuId(SortMode sortMode)
 	case SortMode::MediaYear:
 		return IDM_GROUPBY_MEDIA_YEAR;
 
+	case SortMode::PluginColumn1:
+		return IDM_GROUPBY_PLUGIN_COLUMN_1;
+
+	case SortMode::PluginColumn2:
+		return IDM_GROUPBY_PLUGIN_COLUMN_2;
+
+	case SortMode::PluginColumn3:
+		return IDM_GROUPBY_PLUGIN_COLUMN_3;
+
+	case SortMode::PluginColumn4:
+		return IDM_GROUPBY_PLUGIN_COLUMN_4;
+
+	case SortMode::PluginColumn5:
+		return IDM_GROUPBY_PLUGIN_COLUMN_5;
+
+	case SortMode::PluginColumn6:
+		return IDM_GROUPBY_PLUGIN_COLUMN_6;
+
+	case SortMode::PluginColumn7:
+		return IDM_GROUPBY_PLUGIN_COLUMN_7;
+
+	case SortMode::PluginColumn8:
+		return IDM_GROUPBY_PLUGIN_COLUMN_8;
+
+	case SortMode::HashCrc32:
+		return IDM_GROUPBY_HASH_CRC32;
+
+	case SortMode::HashXxHash64:
+		return IDM_GROUPBY_HASH_XXHASH64;
+
+	case SortMode::HashSha256:
+		return IDM_GROUPBY_HASH_SHA256;
+
 	default:
 		assert(false);
 		break;
@@ -9,9 +9,11 @@
 #include "Explorer++_internal.h"
 #include "MainResource.h"
 #include "PasteSymLinksClient.h"
+#include "ProcessManager.h"
 #include "ResourceHelper.h"
 #include "Storage.h"
 #include "../Helper/SetDefaultFileManager.h"
+#include "../Helper/Tracing.h"
 
 namespace
 {
@@ -74,6 +76,24 @@ std::optional<ExitCode> Process(const CommandLine::Settings *commandLineSettings
 		FLAGS_minloglevel = google::GLOG_INFO;
 	}
 
+	if (commandLineSettings->enableTracing)
+	{
+		GetTraceRecorder().Start();
+	}
+
+	if (commandLineSettings->batchCommand)
+	{
+		return RunBatchCommand(*commandLineSettings->batchCommand, std::cout, std::cerr);
+	}
+
+	// This is done before the application is initialized, so that if there's an existing process,
+	// this process can exit without loading its settings or creating any windows. If the handoff
+	// fails, ProcessManager will fall back to notifying the existing process via WM_COPYDATA.
+	if (ProcessManager::AttemptHandOffToExistingProcess(commandLineSettings))
+	{
+		return EXIT_CODE_NORMAL_EXISTING_PROCESS;
+	}
+
 	return std::nullopt;
 }
 
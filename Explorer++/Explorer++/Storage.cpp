@@ -21,4 +21,22 @@ std::wstring GetConfigFilePath()
 	return configFilePath.c_str();
 }
 
+std::optional<std::wstring> GetFileNameIndexFilePath()
+{
+	wil::unique_cotaskmem_string localAppDataPath;
+	HRESULT hr =
+		SHGetKnownFolderPath(FOLDERID_LocalAppData, KF_FLAG_DEFAULT, nullptr, &localAppDataPath);
+
+	if (FAILED(hr))
+	{
+		return std::nullopt;
+	}
+
+	std::filesystem::path indexFilePath(localAppDataPath.get());
+	indexFilePath /= FILE_NAME_INDEX_FOLDER_NAME;
+	indexFilePath /= FILE_NAME_INDEX_FILENAME;
+
+	return indexFilePath.c_str();
+}
+
 }
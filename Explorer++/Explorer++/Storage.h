@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <optional>
 #include <string>
 
 namespace Storage
@@ -24,6 +25,14 @@ inline const wchar_t CONFIG_FILE_FILENAME[] = L"config.xml";
 inline const wchar_t CONFIG_FILE_ROOT_NODE_NAME[] = L"ExplorerPlusPlus";
 inline const wchar_t CONFIG_FILE_SETTINGS_NODE_NAME[] = L"Settings";
 
+inline const wchar_t FILE_NAME_INDEX_FOLDER_NAME[] = L"Explorer++";
+inline const wchar_t FILE_NAME_INDEX_FILENAME[] = L"FileNameIndex.dat";
+
 std::wstring GetConfigFilePath();
 
+// The filename index can be large and is rebuilt regularly, so it's stored in the local (rather
+// than roaming) application data folder. Returns an empty value if that folder can't be
+// retrieved.
+std::optional<std::wstring> GetFileNameIndexFilePath();
+
 }
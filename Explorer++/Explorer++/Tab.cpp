@@ -142,13 +142,16 @@ TabStorageData Tab::GetStorageData() const
 {
 	// The ShellBrowser instance can be null in tests, in which case, this method shouldn't be
 	// called.
-	CHECK(m_shellBrowserImpl);
+	CHECK(m_shellBrowser);
+
+	// The current entry is used, since a dormant tab won't have navigated to its folder yet.
+	const auto &pidl = m_shellBrowser->GetNavigationController()->GetCurrentEntry()->GetPidl();
 
 	TabStorageData storageData;
-	storageData.pidl = m_shellBrowserImpl->GetDirectoryIdl().get();
-	storageData.directory = m_shellBrowserImpl->GetDirectory();
-	storageData.folderSettings = m_shellBrowserImpl->GetFolderSettings();
-	storageData.columns = m_shellBrowserImpl->ExportAllColumns();
+	storageData.pidl = pidl;
+	storageData.directory = GetDisplayNameWithFallback(pidl.Raw(), SHGDN_FORPARSING);
+	storageData.folderSettings = m_shellBrowser->GetFolderSettings();
+	storageData.columns = m_shellBrowser->ExportAllColumns();
 
 	TabSettings tabSettings;
 
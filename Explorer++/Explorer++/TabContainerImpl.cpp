@@ -9,6 +9,7 @@
 #include "BrowserWindow.h"
 #include "Config.h"
 #include "CoreInterface.h"
+#include "FeatureList.h"
 #include "Icon.h"
 #include "IconResourceLoader.h"
 #include "MainResource.h"
@@ -29,6 +30,7 @@
 #include "../Helper/DpiCompatibility.h"
 #include "../Helper/ImageHelper.h"
 #include "../Helper/MenuHelper.h"
+#include "../Helper/ProcessHelper.h"
 #include "../Helper/ShellHelper.h"
 #include "../Helper/TabHelper.h"
 #include "../Helper/WindowHelper.h"
@@ -72,7 +74,7 @@ TabContainerImpl::TabContainerImpl(HWND parent, BrowserWindow *browser,
 	m_fontSetter(m_hwnd, config, GetDefaultSystemFontForDefaultDpi()),
 	m_tooltipFontSetter(TabCtrl_GetToolTips(m_hwnd), config),
 	m_timerManager(m_hwnd),
-	m_iconFetcher(m_hwnd, cachedIcons),
+	m_iconFetcher(m_app->GetRuntime(), cachedIcons),
 	m_cachedIcons(cachedIcons),
 	m_resourceInstance(resourceInstance),
 	m_config(config),
@@ -659,6 +661,8 @@ void TabContainerImpl::OnTabCreated(const Tab &tab, bool selected)
 
 void TabContainerImpl::OnTabRemoved(const Tab &tab)
 {
+	m_dormancyTimers.erase(tab.GetId());
+
 	if (!m_config->alwaysShowTabBar.get() && (GetNumTabs() == 1))
 	{
 		m_coreInterface->HideTabBar();
@@ -672,13 +676,78 @@ void TabContainerImpl::OnTabSelected(const Tab &tab)
 	if (m_iPreviousTabSelectionId != -1)
 	{
 		m_tabSelectionHistory.push_back(m_iPreviousTabSelectionId);
+
+		if (m_iPreviousTabSelectionId != tab.GetId())
+		{
+			StartDormancyTimer(m_iPreviousTabSelectionId);
+		}
 	}
 
 	m_iPreviousTabSelectionId = tab.GetId();
 
+	m_dormancyTimers.erase(tab.GetId());
+	tab.GetShellBrowserImpl()->ActivateIfDormant();
+
 	m_app->GetTabEvents()->NotifySelected(tab);
 }
 
+void TabContainerImpl::StartDormancyTimer(int tabId)
+{
+	if (!m_app->GetFeatureList()->IsEnabled(Feature::DormantTabs)
+		|| m_config->dormantTabTimeoutMinutes == 0)
+	{
+		return;
+	}
+
+	auto &timer = m_dormancyTimers[tabId];
+
+	if (!timer)
+	{
+		timer = std::make_unique<OneShotTimer>(&m_timerManager);
+	}
+
+	timer->Start(std::chrono::minutes(m_config->dormantTabTimeoutMinutes),
+		std::bind(&TabContainerImpl::OnDormancyTimerElapsed, this, tabId));
+}
+
+void TabContainerImpl::OnDormancyTimerElapsed(int tabId)
+{
+	m_dormancyTimers.erase(tabId);
+
+	auto *tab = GetTabOptional(tabId);
+
+	if (!tab || IsTabSelected(*tab))
+	{
+		return;
+	}
+
+	auto *shellBrowser = tab->GetShellBrowserImpl();
+	auto dirMonitorId = shellBrowser->GetDirMonitorId();
+	auto workingSetBefore = GetCurrentProcessWorkingSetSize();
+
+	if (!shellBrowser->ReleaseResources())
+	{
+		// The tab is still busy (e.g. because a navigation is in progress), so it can't be
+		// released yet.
+		StartDormancyTimer(tabId);
+		return;
+	}
+
+	if (dirMonitorId)
+	{
+		m_coreInterface->GetDirectoryMonitor()->StopDirectoryMonitor(*dirMonitorId);
+		shellBrowser->ClearDirMonitorId();
+	}
+
+	auto workingSetAfter = GetCurrentProcessWorkingSetSize();
+
+	if (workingSetBefore && workingSetAfter)
+	{
+		LOG(INFO) << "Released background tab " << tabId << "; working set went from "
+				  << (*workingSetBefore / 1024) << " KB to " << (*workingSetAfter / 1024) << " KB";
+	}
+}
+
 void TabContainerImpl::OnAlwaysShowTabBarUpdated(BOOL newValue)
 {
 	if (newValue)
@@ -985,6 +1054,17 @@ Tab &TabContainerImpl::SetUpNewTab(Tab &tab, NavigateParams &navigateParams,
 		OnTabSelected(tab);
 	}
 
+	if (!selected && tabSettings.dormant.value_or(false)
+		&& m_app->GetFeatureList()->IsEnabled(Feature::DormantTabs))
+	{
+		// The navigation will only start once the tab is selected. In the meantime, the tab will
+		// show the name set above, along with the folder icon.
+		tab.GetShellBrowserImpl()->EnterDormantState(navigateParams);
+		SetTabIcon(tab);
+
+		return tab;
+	}
+
 	tab.GetShellBrowserImpl()->GetNavigationController()->Navigate(navigateParams);
 
 	return tab;
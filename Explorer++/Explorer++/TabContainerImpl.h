@@ -40,6 +40,7 @@ BOOST_PARAMETER_NAME(name)
 BOOST_PARAMETER_NAME(index)
 BOOST_PARAMETER_NAME(selected)
 BOOST_PARAMETER_NAME(lockState)
+BOOST_PARAMETER_NAME(dormant)
 
 // The use of Boost Parameter here allows values to be set by name
 // during construction. It would be better (and simpler) for this to be
@@ -54,6 +55,7 @@ struct TabSettingsImpl
 		lockState = args[_lockState | std::nullopt];
 		index = args[_index | std::nullopt];
 		selected = args[_selected | std::nullopt];
+		dormant = args[_dormant | std::nullopt];
 	}
 
 	std::optional<std::wstring> name;
@@ -61,6 +63,9 @@ struct TabSettingsImpl
 	std::optional<int> index;
 	std::optional<bool> selected;
 
+	// If set and the tab isn't selected, the tab won't navigate until it's first selected.
+	std::optional<bool> dormant;
+
 	// This is only used in tests.
 	bool operator==(const TabSettingsImpl &) const = default;
 };
@@ -78,6 +83,7 @@ struct TabSettings : TabSettingsImpl
 			(lockState, (Tab::LockState))
 			(index, (int))
 			(selected, (bool))
+			(dormant, (bool))
 		)
 	)
 	// clang-format on
@@ -201,6 +207,10 @@ private:
 
 	void OnTabSelected(const Tab &tab);
 
+	// Dormant tabs
+	void StartDormancyTimer(int tabId);
+	void OnDormancyTimerElapsed(int tabId);
+
 	void OnAlwaysShowTabBarUpdated(BOOL newValue);
 
 	void OnNavigationCommitted(const NavigationRequest *request);
@@ -261,6 +271,9 @@ private:
 	std::vector<int> m_tabSelectionHistory;
 	int m_iPreviousTabSelectionId;
 
+	// Dormant tabs
+	std::unordered_map<int, std::unique_ptr<OneShotTimer>> m_dormancyTimers;
+
 	// Tab dragging
 	BOOL m_bTabBeenDragged;
 	int m_draggedTabStartIndex;
@@ -11,6 +11,8 @@
 #include "ShellBrowser/ShellBrowserImpl.h"
 #include "TabContainerImpl.h"
 #include "TabStorage.h"
+#include "../Helper/ProcessHelper.h"
+#include <glog/logging.h>
 
 void Explorerplusplus::InitializeTabs()
 {
@@ -152,6 +154,8 @@ void Explorerplusplus::CreateInitialTabs(const WindowStorageData *storageData)
 
 void Explorerplusplus::CreateTabsFromStorageData(const WindowStorageData &storageData)
 {
+	auto workingSetBefore = GetCurrentProcessWorkingSetSize();
+
 	int index = 0;
 
 	for (const auto &loadedTab : storageData.tabs)
@@ -164,6 +168,10 @@ void Explorerplusplus::CreateTabsFromStorageData(const WindowStorageData &storag
 		auto tabSettings = loadedTab.tabSettings;
 		tabSettings.index = index;
 
+		// Only the selected tab needs to be loaded immediately. The rest of the tabs will be loaded
+		// when they're first selected (if the DormantTabs feature is enabled).
+		tabSettings.dormant = true;
+
 		auto validatedColumns = loadedTab.columns;
 		ValidateColumns(validatedColumns);
 
@@ -187,6 +195,17 @@ void Explorerplusplus::CreateTabsFromStorageData(const WindowStorageData &storag
 	{
 		GetActivePane()->GetTabContainerImpl()->SelectTabAtIndex(storageData.selectedTab);
 	}
+
+	auto workingSetAfter = GetCurrentProcessWorkingSetSize();
+
+	if (workingSetBefore && workingSetAfter && *workingSetAfter > *workingSetBefore
+		&& !storageData.tabs.empty())
+	{
+		SIZE_T growthPerTab = (*workingSetAfter - *workingSetBefore) / storageData.tabs.size();
+		LOG(INFO) << "Restored " << storageData.tabs.size() << " tabs; working set went from "
+				  << (*workingSetBefore / 1024) << " KB to " << (*workingSetAfter / 1024)
+				  << " KB (" << (growthPerTab / 1024) << " KB per tab)";
+	}
 }
 
 void Explorerplusplus::CreateCommandLineTabs()
@@ -25,6 +25,7 @@ const wchar_t SETTING_DIRECTORY_PIDL[] = L"Directory";
 const wchar_t SETTING_VIEW_MODE[] = L"ViewMode";
 const wchar_t SETTING_SORT_MODE[] = L"SortMode";
 const wchar_t SETTING_SORT_ASCENDING[] = L"SortAscending";
+const wchar_t SETTING_SECONDARY_SORT_KEYS[] = L"SecondarySortKeys";
 const wchar_t SETTING_GROUP_MODE[] = L"GroupMode";
 const wchar_t SETTING_GROUP_SORT_DIRECTION[] = L"GroupSortDirection";
 const wchar_t SETTING_SHOW_IN_GROUPS[] = L"ShowInGroups";
@@ -74,6 +75,14 @@ FolderSettings LoadFolderSettings(HKEY key)
 	// always the same in previous versions.
 	folderSettings.groupSortDirection = folderSettings.sortDirection;
 
+	std::wstring secondarySortKeys;
+
+	if (RegistrySettings::ReadString(key, SETTING_SECONDARY_SORT_KEYS, secondarySortKeys)
+		== ERROR_SUCCESS)
+	{
+		folderSettings.secondarySortKeys = DecodeSortKeys(secondarySortKeys);
+	}
+
 	RegistrySettings::ReadBetterEnumValue(key, SETTING_GROUP_MODE, folderSettings.groupMode);
 	RegistrySettings::ReadBetterEnumValue(key, SETTING_GROUP_SORT_DIRECTION,
 		folderSettings.groupSortDirection);
@@ -164,6 +173,8 @@ void SaveFolderSettings(HKEY key, const FolderSettings &folderSettings)
 	RegistrySettings::SaveDword(key, SETTING_SORT_ASCENDING,
 		folderSettings.sortDirection == +SortDirection::Ascending);
 
+	RegistrySettings::SaveString(key, SETTING_SECONDARY_SORT_KEYS,
+		EncodeSortKeys(folderSettings.secondarySortKeys));
 	RegistrySettings::SaveDword(key, SETTING_GROUP_MODE, folderSettings.groupMode);
 	RegistrySettings::SaveDword(key, SETTING_GROUP_SORT_DIRECTION,
 		folderSettings.groupSortDirection);
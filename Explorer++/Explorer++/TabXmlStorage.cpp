@@ -28,6 +28,7 @@ const wchar_t SETTING_DIRECTORY[] = L"Directory";
 const wchar_t SETTING_VIEW_MODE[] = L"ViewMode";
 const wchar_t SETTING_SORT_MODE[] = L"SortMode";
 const wchar_t SETTING_SORT_ASCENDING[] = L"SortAscending";
+const wchar_t SETTING_SECONDARY_SORT_KEYS[] = L"SecondarySortKeys";
 const wchar_t SETTING_GROUP_MODE[] = L"GroupMode";
 const wchar_t SETTING_GROUP_SORT_DIRECTION[] = L"GroupSortDirection";
 const wchar_t SETTING_SHOW_IN_GROUPS[] = L"ShowInGroups";
@@ -100,6 +101,14 @@ FolderSettings LoadFolderSettings(IXMLDOMNode *tabNode)
 	LoadBooleanSortDirection(attributeMap.get(), SETTING_SORT_ASCENDING,
 		folderSettings.sortDirection);
 	folderSettings.groupSortDirection = folderSettings.sortDirection;
+	std::wstring secondarySortKeys;
+
+	if (SUCCEEDED(XMLSettings::GetStringFromMap(attributeMap.get(), SETTING_SECONDARY_SORT_KEYS,
+			secondarySortKeys)))
+	{
+		folderSettings.secondarySortKeys = DecodeSortKeys(secondarySortKeys);
+	}
+
 	XMLSettings::LoadBetterEnumValue(attributeMap.get(), SETTING_GROUP_MODE,
 		folderSettings.groupMode);
 	XMLSettings::LoadBetterEnumValue(attributeMap.get(), SETTING_GROUP_SORT_DIRECTION,
@@ -201,6 +210,8 @@ void SaveFolderSettings(IXMLDOMDocument *xmlDocument, IXMLDOMElement *tabNode,
 	XMLSettings::AddAttributeToNode(xmlDocument, tabNode, SETTING_SORT_ASCENDING,
 		XMLSettings::EncodeBoolValue(folderSettings.sortDirection == +SortDirection::Ascending));
 
+	XMLSettings::AddAttributeToNode(xmlDocument, tabNode, SETTING_SECONDARY_SORT_KEYS,
+		EncodeSortKeys(folderSettings.secondarySortKeys).c_str());
 	XMLSettings::AddAttributeToNode(xmlDocument, tabNode, SETTING_GROUP_MODE,
 		XMLSettings::EncodeIntValue(folderSettings.groupMode));
 	XMLSettings::AddAttributeToNode(xmlDocument, tabNode, SETTING_GROUP_SORT_DIRECTION,
@@ -17,6 +17,7 @@
 #include "ResourceHelper.h"
 #include "ShellBrowser/ShellBrowserImpl.h"
 #include "TabContainerImpl.h"
+#include "../Helper/ImageHelper.h"
 #include "../Helper/ProcessHelper.h"
 #include "../Helper/ShellHelper.h"
 #include "../Helper/WindowHelper.h"
@@ -37,6 +38,8 @@ TaskbarThumbnails::TaskbarThumbnails(App *app, BrowserWindow *browser,
 	m_app(app),
 	m_browser(browser),
 	m_tabContainerImpl(tabContainerImpl),
+	m_thumbnailCache(THUMBNAIL_CACHE_SIZE),
+	m_livePreviewCache(LIVE_PREVIEW_CACHE_SIZE),
 	m_enabled(app->GetConfig()->showTaskbarThumbnails)
 {
 	Initialize();
@@ -238,6 +241,9 @@ void TaskbarThumbnails::RemoveTabProxy(const Tab &tab)
 	DestroyTabProxy(*tabProxy);
 
 	m_TabProxyList.erase(tabProxy);
+
+	m_thumbnailCache.Remove(tab.GetId());
+	m_livePreviewCache.Remove(tab.GetId());
 }
 
 void TaskbarThumbnails::DestroyTabProxy(TabProxyInfo &tabProxy)
@@ -252,16 +258,32 @@ void TaskbarThumbnails::DestroyTabProxy(TabProxyInfo &tabProxy)
 		GetModuleHandle(nullptr));
 }
 
+TaskbarThumbnails::TabProxyInfo *TaskbarThumbnails::FindTabProxy(int tabId)
+{
+	auto itr = std::find_if(m_TabProxyList.begin(), m_TabProxyList.end(),
+		[tabId](const TabProxyInfo &tabProxy) { return tabProxy.iTabId == tabId; });
+
+	if (itr == m_TabProxyList.end())
+	{
+		return nullptr;
+	}
+
+	return &*itr;
+}
+
+// Note that this doesn't capture anything. The cached images for the tab are simply marked as out
+// of date and will only be replaced if DWM requests them again.
 void TaskbarThumbnails::InvalidateTaskbarThumbnailBitmap(const Tab &tab)
 {
-	for (auto itr = m_TabProxyList.begin(); itr != m_TabProxyList.end(); itr++)
+	auto *tabProxy = FindTabProxy(tab.GetId());
+
+	if (!tabProxy)
 	{
-		if (itr->iTabId == tab.GetId())
-		{
-			DwmInvalidateIconicBitmaps(itr->hProxy);
-			break;
-		}
+		return;
 	}
+
+	tabProxy->contentGeneration++;
+	DwmInvalidateIconicBitmaps(tabProxy->hProxy);
 }
 
 void TaskbarThumbnails::RegisterTab(HWND hTabProxy, const TCHAR *szDisplayName, BOOL bTabActive)
@@ -344,6 +366,7 @@ LRESULT CALLBACK TaskbarThumbnails::TabProxyWndProc(HWND hwnd, UINT Msg, WPARAM
 	2. Overlay a bitmap of the specified tab onto the main
 	window bitmap.
 	3. Shrink the resulting bitmap down to the correct thumbnail size.
+	4. Cache the thumbnail, so that it can be reused until the tab changes.
 
 	A thumbnail will be dynamically generated, provided the main window
 	is not currently minimized (as we won't be able to grab a screenshot
@@ -354,38 +377,8 @@ LRESULT CALLBACK TaskbarThumbnails::TabProxyWndProc(HWND hwnd, UINT Msg, WPARAM
 		return 0;
 
 	case WM_DWMSENDICONICLIVEPREVIEWBITMAP:
-	{
-		if (IsIconic(m_browser->GetHWND()))
-		{
-			/* TODO: Show an image here... */
-		}
-		else
-		{
-			wil::unique_hbitmap bitmap = GetTabLivePreviewBitmap(*tab);
-
-			RECT rcTab;
-			GetClientRect(tab->GetShellBrowserImpl()->GetListView(), &rcTab);
-			MapWindowPoints(tab->GetShellBrowserImpl()->GetListView(), m_browser->GetHWND(),
-				reinterpret_cast<LPPOINT>(&rcTab), 2);
-
-			MENUBARINFO mbi;
-			mbi.cbSize = sizeof(mbi);
-			GetMenuBarInfo(m_browser->GetHWND(), OBJID_MENU, 0, &mbi);
-
-			POINT ptOrigin;
-
-			/* The operating system will automatically draw the main window. Therefore,
-			we'll just shift the tab into it's proper position. */
-			ptOrigin.x = rcTab.left;
-
-			/* Need to include the menu bar in the offset. */
-			ptOrigin.y = rcTab.top + mbi.rcBar.bottom - mbi.rcBar.top;
-
-			DwmSetIconicLivePreviewBitmap(hwnd, bitmap.get(), &ptOrigin, 0);
-		}
-
+		OnDwmSendIconicLivePreviewBitmap(hwnd, *tab);
 		return 0;
-	}
 
 	case WM_CLOSE:
 	{
@@ -411,177 +404,290 @@ LRESULT CALLBACK TaskbarThumbnails::TabProxyWndProc(HWND hwnd, UINT Msg, WPARAM
 void TaskbarThumbnails::OnDwmSendIconicThumbnail(HWND tabProxy, const Tab &tab, int maxWidth,
 	int maxHeight)
 {
-	wil::unique_hbitmap hbmTab;
+	ImageSize maxSize = { maxWidth, maxHeight };
+	wil::unique_hbitmap thumbnailBitmap;
 
-	/* If the main window is minimized, it won't be possible
-	to generate a thumbnail for any of the tabs. In that
-	case, use a static 'No Preview Available' bitmap. */
-	if (IsIconic(m_browser->GetHWND()))
+	if (const auto *thumbnail = GetTabThumbnail(tab, maxSize))
 	{
-		hbmTab.reset(static_cast<HBITMAP>(LoadImage(GetModuleHandle(nullptr),
-			MAKEINTRESOURCE(IDB_NOPREVIEWAVAILABLE), IMAGE_BITMAP, 0, 0, 0)));
-
-		SetBitmapDimensionEx(hbmTab.get(), 223, 130, nullptr);
+		thumbnailBitmap = ImageHelper::PixelBufferToBitmap(*thumbnail);
 	}
 	else
 	{
-		hbmTab = CaptureTabScreenshot(tab);
+		thumbnailBitmap = CreateNoPreviewThumbnail(maxSize);
 	}
 
-	SIZE currentSize;
-	GetBitmapDimensionEx(hbmTab.get(), &currentSize);
+	if (!thumbnailBitmap)
+	{
+		return;
+	}
 
-	/* Shrink the bitmap. */
-	wil::unique_hdc_window hdc = wil::GetDC(m_browser->GetHWND());
-	wil::unique_hdc hdcSrc(CreateCompatibleDC(hdc.get()));
+	DwmSetIconicThumbnail(tabProxy, thumbnailBitmap.get(), 0);
+}
 
-	auto previousTabBitmap = wil::SelectObject(hdcSrc.get(), hbmTab.get());
+// Returns a thumbnail of the main window, with the specified tab shown. Thumbnails are cached, so
+// the window is only captured again once the cached thumbnail is out of date (as determined by
+// GetCapturePolicy()).
+const PixelBuffer *TaskbarThumbnails::GetTabThumbnail(const Tab &tab, ImageSize maxSize)
+{
+	auto *tabProxy = FindTabProxy(tab.GetId());
 
-	wil::unique_hdc hdcThumbnailSrc(CreateCompatibleDC(hdc.get()));
+	if (!tabProxy)
+	{
+		return nullptr;
+	}
 
-	int finalWidth;
-	int finalHeight;
+	const auto *entry = m_thumbnailCache.Find(tab.GetId());
 
-	/* If the current height of the main window
-	is less than the width, we'll create a thumbnail
-	of maximum width; else maximum height. */
-	if (((double) currentSize.cx / (double) maxWidth)
-		> ((double) currentSize.cy / (double) maxHeight))
+	/* If the main window is minimized, it won't be possible to capture
+	it. In that case, the last thumbnail captured (if there is one) will
+	be used, even if it's out of date. */
+	if (IsIconic(m_browser->GetHWND()))
 	{
-		finalWidth = maxWidth;
-		finalHeight = (int) ceil(maxWidth * ((double) currentSize.cy / (double) currentSize.cx));
+		if (entry && entry->image.width <= maxSize.width && entry->image.height <= maxSize.height)
+		{
+			return &entry->image;
+		}
+
+		return nullptr;
 	}
-	else
+
+	RECT rcMain;
+	GetClientRect(m_browser->GetHWND(), &rcMain);
+	ImageSize thumbnailSize =
+		FitImageSize({ GetRectWidth(&rcMain), GetRectHeight(&rcMain) }, maxSize);
+
+	auto now = ThumbnailCache::Clock::now();
+
+	// If the size of the main window has changed, the cached thumbnail can't be used, since its
+	// aspect ratio will be wrong.
+	if (entry && entry->image.width == thumbnailSize.width
+		&& entry->image.height == thumbnailSize.height
+		&& !ShouldRecaptureThumbnail(entry, tabProxy->contentGeneration, now,
+			GetCapturePolicy(tab)))
+	{
+		return &entry->image;
+	}
+
+	auto screenshot = CaptureTabScreenshot(tab);
+
+	if (!screenshot)
 	{
-		finalHeight = maxHeight;
-		finalWidth = (int) ceil(maxHeight * ((double) currentSize.cx / (double) currentSize.cy));
+		return nullptr;
 	}
 
-	wil::unique_hbitmap hbmThumbnail;
-	Gdiplus::Color color(0, 0, 0);
-	Gdiplus::Bitmap bmpThumbnail(finalWidth, finalHeight, PixelFormat32bppARGB);
-	bmpThumbnail.GetHBITMAP(color, &hbmThumbnail);
+	m_thumbnailCache.Insert(tab.GetId(), tabProxy->contentGeneration, now,
+		ResizeImageBoxFilter(*screenshot, thumbnailSize));
 
-	auto previousThumbnailBitmap = wil::SelectObject(hdcThumbnailSrc.get(), hbmThumbnail.get());
+	entry = m_thumbnailCache.Find(tab.GetId());
+	return entry ? &entry->image : nullptr;
+}
 
-	/* Finally, shrink the full-scale bitmap down into a thumbnail. */
-	POINT pt;
-	SetStretchBltMode(hdcThumbnailSrc.get(), HALFTONE);
-	SetBrushOrgEx(hdcThumbnailSrc.get(), 0, 0, &pt);
-	StretchBlt(hdcThumbnailSrc.get(), 0, 0, finalWidth, finalHeight, hdcSrc.get(), 0, 0,
-		currentSize.cx, currentSize.cy, SRCCOPY);
+wil::unique_hbitmap TaskbarThumbnails::CreateNoPreviewThumbnail(ImageSize maxSize)
+{
+	wil::unique_hbitmap noPreviewBitmap(static_cast<HBITMAP>(LoadImage(GetModuleHandle(nullptr),
+		MAKEINTRESOURCE(IDB_NOPREVIEWAVAILABLE), IMAGE_BITMAP, 0, 0, 0)));
+
+	if (!noPreviewBitmap)
+	{
+		return nullptr;
+	}
+
+	auto noPreviewImage = ImageHelper::BitmapToOpaquePixelBuffer(noPreviewBitmap.get());
+
+	if (!noPreviewImage)
+	{
+		return nullptr;
+	}
 
-	DwmSetIconicThumbnail(tabProxy, hbmThumbnail.get(), 0);
+	return ImageHelper::PixelBufferToBitmap(ResizeImageBoxFilter(*noPreviewImage,
+		FitImageSize({ noPreviewImage->width, noPreviewImage->height }, maxSize)));
 }
 
-wil::unique_hbitmap TaskbarThumbnails::CaptureTabScreenshot(const Tab &tab)
+/* Generates a full-scale image of the main window, with the
+specified tab overlaid on top of it (the tab may not be the
+one that's currently visible). */
+std::optional<PixelBuffer> TaskbarThumbnails::CaptureTabScreenshot(const Tab &tab)
 {
 	wil::unique_hdc_window hdc = wil::GetDC(m_browser->GetHWND());
-	wil::unique_hdc hdcSrc(CreateCompatibleDC(hdc.get()));
 
 	RECT rcMain;
 	GetClientRect(m_browser->GetHWND(), &rcMain);
 
-	/* Any bitmap sent back to the operating system will need to be in 32-bit
-	ARGB format. */
-	wil::unique_hbitmap hBitmap;
-	Gdiplus::Color color(0, 0, 0);
-	Gdiplus::Bitmap bi(GetRectWidth(&rcMain), GetRectHeight(&rcMain), PixelFormat32bppARGB);
-	bi.GetHBITMAP(color, &hBitmap);
+	wil::unique_hbitmap hBitmap(
+		CreateCompatibleBitmap(hdc.get(), GetRectWidth(&rcMain), GetRectHeight(&rcMain)));
 
-	/* Draw the main window into the bitmap. */
-	auto mainWindowPreviousBitmap = wil::SelectObject(hdcSrc.get(), hBitmap.get());
-	BitBlt(hdcSrc.get(), 0, 0, GetRectWidth(&rcMain), GetRectHeight(&rcMain), hdc.get(), 0, 0,
-		SRCCOPY);
+	if (!hBitmap)
+	{
+		return std::nullopt;
+	}
 
-	/* Now draw the tab onto the main window. */
-	RECT rcTab;
-	GetClientRect(tab.GetShellBrowserImpl()->GetListView(), &rcTab);
+	{
+		wil::unique_hdc hdcSrc(CreateCompatibleDC(hdc.get()));
+		auto mainWindowPreviousBitmap = wil::SelectObject(hdcSrc.get(), hBitmap.get());
 
-	wil::unique_hdc_window hdcTab = wil::GetDC(tab.GetShellBrowserImpl()->GetListView());
-	wil::unique_hdc hdcTabSrc(CreateCompatibleDC(hdcTab.get()));
-	wil::unique_hbitmap hbmTab(
-		CreateCompatibleBitmap(hdcTab.get(), GetRectWidth(&rcTab), GetRectHeight(&rcTab)));
+		/* Draw the main window into the bitmap. */
+		BitBlt(hdcSrc.get(), 0, 0, GetRectWidth(&rcMain), GetRectHeight(&rcMain), hdc.get(), 0,
+			0, SRCCOPY);
 
-	auto tabPreviousBitmap = wil::SelectObject(hdcTabSrc.get(), hbmTab.get());
+		/* Now draw the tab onto the main window. */
+		HWND listView = tab.GetShellBrowserImpl()->GetListView();
 
-	BOOL bVisible = IsWindowVisible(tab.GetShellBrowserImpl()->GetListView());
+		RECT rcTab;
+		GetClientRect(listView, &rcTab);
 
-	if (!bVisible)
+		wil::unique_hdc_window hdcTab = wil::GetDC(listView);
+		wil::unique_hdc hdcTabSrc(CreateCompatibleDC(hdcTab.get()));
+		wil::unique_hbitmap hbmTab(
+			CreateCompatibleBitmap(hdcTab.get(), GetRectWidth(&rcTab), GetRectHeight(&rcTab)));
+
+		auto tabPreviousBitmap = wil::SelectObject(hdcTabSrc.get(), hbmTab.get());
+
+		PrintTabListView(tab, hdcTabSrc.get());
+
+		MapWindowPoints(listView, m_browser->GetHWND(), reinterpret_cast<LPPOINT>(&rcTab), 2);
+		BitBlt(hdcSrc.get(), rcTab.left, rcTab.top, GetRectWidth(&rcTab), GetRectHeight(&rcTab),
+			hdcTabSrc.get(), 0, 0, SRCCOPY);
+	}
+
+	return ImageHelper::BitmapToOpaquePixelBuffer(hBitmap.get());
+}
+
+void TaskbarThumbnails::OnDwmSendIconicLivePreviewBitmap(HWND tabProxy, const Tab &tab)
+{
+	if (IsIconic(m_browser->GetHWND()))
 	{
-		ShowWindow(tab.GetShellBrowserImpl()->GetListView(), SW_SHOW);
+		/* TODO: Show an image here... */
+		return;
 	}
 
-	PrintWindow(tab.GetShellBrowserImpl()->GetListView(), hdcTabSrc.get(), PW_CLIENTONLY);
+	const auto *livePreview = GetTabLivePreview(tab);
 
-	if (!bVisible)
+	if (!livePreview)
 	{
-		ShowWindow(tab.GetShellBrowserImpl()->GetListView(), SW_HIDE);
+		return;
 	}
 
+	wil::unique_hbitmap bitmap = ImageHelper::PixelBufferToBitmap(*livePreview);
+
+	if (!bitmap)
+	{
+		return;
+	}
+
+	RECT rcTab;
+	GetClientRect(tab.GetShellBrowserImpl()->GetListView(), &rcTab);
 	MapWindowPoints(tab.GetShellBrowserImpl()->GetListView(), m_browser->GetHWND(),
 		reinterpret_cast<LPPOINT>(&rcTab), 2);
-	BitBlt(hdcSrc.get(), rcTab.left, rcTab.top, GetRectWidth(&rcTab), GetRectHeight(&rcTab),
-		hdcTabSrc.get(), 0, 0, SRCCOPY);
-
-	/* Shrink the bitmap. */
-	wil::unique_hdc hdcThumbnailSrc(CreateCompatibleDC(hdc.get()));
 
-	wil::unique_hbitmap hbmThumbnail;
-	Gdiplus::Bitmap bmpThumbnail(GetRectWidth(&rcMain), GetRectHeight(&rcMain),
-		PixelFormat32bppARGB);
-	bmpThumbnail.GetHBITMAP(color, &hbmThumbnail);
+	MENUBARINFO mbi;
+	mbi.cbSize = sizeof(mbi);
+	GetMenuBarInfo(m_browser->GetHWND(), OBJID_MENU, 0, &mbi);
 
-	auto thumbnailPreviousBitmap = wil::SelectObject(hdcThumbnailSrc.get(), hbmThumbnail.get());
+	POINT ptOrigin;
 
-	/* Finally, shrink the full-scale bitmap down into a thumbnail. */
-	POINT pt;
-	SetStretchBltMode(hdcThumbnailSrc.get(), HALFTONE);
-	SetBrushOrgEx(hdcThumbnailSrc.get(), 0, 0, &pt);
-	BitBlt(hdcThumbnailSrc.get(), 0, 0, GetRectWidth(&rcMain), GetRectHeight(&rcMain), hdcSrc.get(),
-		0, 0, SRCCOPY);
+	/* The operating system will automatically draw the main window. Therefore,
+	we'll just shift the tab into it's proper position. */
+	ptOrigin.x = rcTab.left;
 
-	SetBitmapDimensionEx(hbmThumbnail.get(), GetRectWidth(&rcMain), GetRectHeight(&rcMain),
-		nullptr);
+	/* Need to include the menu bar in the offset. */
+	ptOrigin.y = rcTab.top + mbi.rcBar.bottom - mbi.rcBar.top;
 
-	return hbmThumbnail;
+	DwmSetIconicLivePreviewBitmap(tabProxy, bitmap.get(), &ptOrigin, 0);
 }
 
-wil::unique_hbitmap TaskbarThumbnails::GetTabLivePreviewBitmap(const Tab &tab)
+// Returns a full-scale image of the tab's listview. As with thumbnails, these images are cached.
+const PixelBuffer *TaskbarThumbnails::GetTabLivePreview(const Tab &tab)
 {
-	wil::unique_hdc_window hdcTab = wil::GetDC(tab.GetShellBrowserImpl()->GetListView());
-	wil::unique_hdc hdcTabSrc(CreateCompatibleDC(hdcTab.get()));
+	auto *tabProxy = FindTabProxy(tab.GetId());
+
+	if (!tabProxy)
+	{
+		return nullptr;
+	}
 
 	RECT rcTab;
 	GetClientRect(tab.GetShellBrowserImpl()->GetListView(), &rcTab);
 
-	wil::unique_hbitmap hbmTab;
-	Gdiplus::Color color(0, 0, 0);
-	Gdiplus::Bitmap bi(GetRectWidth(&rcTab), GetRectHeight(&rcTab), PixelFormat32bppARGB);
-	bi.GetHBITMAP(color, &hbmTab);
+	const auto *entry = m_livePreviewCache.Find(tab.GetId());
+	auto now = ThumbnailCache::Clock::now();
 
-	auto tabPreviousBitmap = wil::SelectObject(hdcTabSrc.get(), hbmTab.get());
+	if (entry && entry->image.width == GetRectWidth(&rcTab)
+		&& entry->image.height == GetRectHeight(&rcTab)
+		&& !ShouldRecaptureThumbnail(entry, tabProxy->contentGeneration, now,
+			GetCapturePolicy(tab)))
+	{
+		return &entry->image;
+	}
+
+	auto livePreview = CaptureTabListView(tab);
+
+	if (!livePreview)
+	{
+		return nullptr;
+	}
+
+	m_livePreviewCache.Insert(tab.GetId(), tabProxy->contentGeneration, now,
+		std::move(*livePreview));
+
+	entry = m_livePreviewCache.Find(tab.GetId());
+	return entry ? &entry->image : nullptr;
+}
+
+std::optional<PixelBuffer> TaskbarThumbnails::CaptureTabListView(const Tab &tab)
+{
+	HWND listView = tab.GetShellBrowserImpl()->GetListView();
+
+	RECT rcTab;
+	GetClientRect(listView, &rcTab);
 
-	BOOL bVisible = IsWindowVisible(tab.GetShellBrowserImpl()->GetListView());
+	wil::unique_hdc_window hdcTab = wil::GetDC(listView);
+	wil::unique_hbitmap hbmTab(
+		CreateCompatibleBitmap(hdcTab.get(), GetRectWidth(&rcTab), GetRectHeight(&rcTab)));
+
+	if (!hbmTab)
+	{
+		return std::nullopt;
+	}
+
+	{
+		wil::unique_hdc hdcTabSrc(CreateCompatibleDC(hdcTab.get()));
+		auto tabPreviousBitmap = wil::SelectObject(hdcTabSrc.get(), hbmTab.get());
+
+		PrintTabListView(tab, hdcTabSrc.get());
+	}
+
+	return ImageHelper::BitmapToOpaquePixelBuffer(hbmTab.get());
+}
+
+void TaskbarThumbnails::PrintTabListView(const Tab &tab, HDC hdc)
+{
+	HWND listView = tab.GetShellBrowserImpl()->GetListView();
+
+	/* The listview for a background tab is hidden, so it needs to
+	be temporarily shown in order for it to be drawn. */
+	BOOL bVisible = IsWindowVisible(listView);
 
 	if (!bVisible)
 	{
-		ShowWindow(tab.GetShellBrowserImpl()->GetListView(), SW_SHOW);
+		ShowWindow(listView, SW_SHOW);
 	}
 
-	PrintWindow(tab.GetShellBrowserImpl()->GetListView(), hdcTabSrc.get(), PW_CLIENTONLY);
+	PrintWindow(listView, hdc, PW_CLIENTONLY);
 
 	if (!bVisible)
 	{
-		ShowWindow(tab.GetShellBrowserImpl()->GetListView(), SW_HIDE);
+		ShowWindow(listView, SW_HIDE);
 	}
+}
 
-	SetStretchBltMode(hdcTabSrc.get(), HALFTONE);
-	SetBrushOrgEx(hdcTabSrc.get(), 0, 0, nullptr);
-	StretchBlt(hdcTabSrc.get(), 0, 0, GetRectWidth(&rcTab), GetRectHeight(&rcTab), hdcTabSrc.get(),
-		0, 0, GetRectWidth(&rcTab), GetRectHeight(&rcTab), SRCCOPY);
+const ThumbnailCapturePolicy &TaskbarThumbnails::GetCapturePolicy(const Tab &tab) const
+{
+	if (m_tabContainerImpl->IsTabSelected(tab))
+	{
+		return SELECTED_TAB_CAPTURE_POLICY;
+	}
 
-	return hbmTab;
+	return BACKGROUND_TAB_CAPTURE_POLICY;
 }
 
 void TaskbarThumbnails::OnTabSelectionChanged(const Tab &tab)
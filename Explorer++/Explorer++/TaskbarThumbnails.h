@@ -5,11 +5,15 @@
 #pragma once
 
 #include "Tab.h"
+#include "../Helper/PixelBuffer.h"
+#include "../Helper/ThumbnailCache.h"
 #include <boost/core/noncopyable.hpp>
 #include <boost/signals2.hpp>
 #include <wil/com.h>
 #include <wil/resource.h>
+#include <chrono>
 #include <memory>
+#include <optional>
 
 class App;
 class BrowserWindow;
@@ -31,6 +35,27 @@ private:
 		HWND hProxy;
 		int iTabId;
 		wil::unique_hicon icon;
+
+		// Incremented each time the contents of the tab change. Cached thumbnails and live
+		// previews that were captured at an earlier generation are out of date.
+		uint64_t contentGeneration = 0;
+	};
+
+	// The maximum amount of memory used by the cached thumbnails and live previews. Thumbnails are
+	// small, so the first limit allows for a large number of tabs. Live previews are captured at
+	// full size, so only a handful of them will be cached at any one time.
+	static constexpr size_t THUMBNAIL_CACHE_SIZE = 16 * 1024 * 1024;
+	static constexpr size_t LIVE_PREVIEW_CACHE_SIZE = 64 * 1024 * 1024;
+
+	// The selected tab can change without any notification (e.g. when it's scrolled), so its
+	// thumbnail is only reused for a short period. Background tabs don't change visually unless
+	// they navigate (which is tracked via the content generation), so they're captured much less
+	// frequently.
+	static constexpr ThumbnailCapturePolicy SELECTED_TAB_CAPTURE_POLICY = {
+		std::chrono::milliseconds(250), std::chrono::seconds(1)
+	};
+	static constexpr ThumbnailCapturePolicy BACKGROUND_TAB_CAPTURE_POLICY = {
+		std::chrono::seconds(2), std::chrono::seconds(30)
 	};
 
 	LRESULT MainWndProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam);
@@ -47,9 +72,16 @@ private:
 	void RegisterTab(HWND hTabProxy, const TCHAR *szDisplayName, BOOL bTabActive);
 	void RemoveTabProxy(const Tab &tab);
 	void DestroyTabProxy(TabProxyInfo &tabProxy);
+	TabProxyInfo *FindTabProxy(int tabId);
 	void OnDwmSendIconicThumbnail(HWND tabProxy, const Tab &tab, int maxWidth, int maxHeight);
-	wil::unique_hbitmap CaptureTabScreenshot(const Tab &tab);
-	wil::unique_hbitmap GetTabLivePreviewBitmap(const Tab &tab);
+	const PixelBuffer *GetTabThumbnail(const Tab &tab, ImageSize maxSize);
+	wil::unique_hbitmap CreateNoPreviewThumbnail(ImageSize maxSize);
+	std::optional<PixelBuffer> CaptureTabScreenshot(const Tab &tab);
+	void OnDwmSendIconicLivePreviewBitmap(HWND tabProxy, const Tab &tab);
+	const PixelBuffer *GetTabLivePreview(const Tab &tab);
+	std::optional<PixelBuffer> CaptureTabListView(const Tab &tab);
+	void PrintTabListView(const Tab &tab, HDC hdc);
+	const ThumbnailCapturePolicy &GetCapturePolicy(const Tab &tab) const;
 	void OnTabSelectionChanged(const Tab &tab);
 	void OnNavigationCommitted(const NavigationRequest *request);
 	void OnDirectoryPropertiesChanged(const ShellBrowser *shellBrowser);
@@ -65,6 +97,8 @@ private:
 
 	wil::com_ptr_nothrow<ITaskbarList4> m_taskbarList;
 	std::list<TabProxyInfo> m_TabProxyList;
+	ThumbnailCache m_thumbnailCache;
+	ThumbnailCache m_livePreviewCache;
 	UINT m_uTaskbarButtonCreatedMessage;
 	BOOL m_enabled;
 };
@@ -0,0 +1,91 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "stdafx.h"
+#include "TraceExport.h"
+#include "App.h"
+#include "MainResource.h"
+#include "ResourceHelper.h"
+#include "RuntimeHelper.h"
+#include "../Helper/Tracing.h"
+#include <wil/com.h>
+#include <wil/resource.h>
+#include <filesystem>
+#include <fstream>
+
+namespace TraceExport
+{
+
+std::optional<std::wstring> PromptForDestination(HWND owner, HINSTANCE resourceInstance)
+{
+	wil::com_ptr_nothrow<IFileSaveDialog> dialog;
+	HRESULT hr = CoCreateInstance(CLSID_FileSaveDialog, nullptr, CLSCTX_INPROC_SERVER,
+		IID_PPV_ARGS(&dialog));
+
+	if (FAILED(hr))
+	{
+		return std::nullopt;
+	}
+
+	auto fileTypeName = ResourceHelper::LoadString(resourceInstance, IDS_TRACE_FILE_TYPE);
+	COMDLG_FILTERSPEC fileTypeSpec = { fileTypeName.c_str(), L"*.json" };
+	dialog->SetFileTypes(1, &fileTypeSpec);
+	dialog->SetDefaultExtension(L"json");
+
+	auto fileName = ResourceHelper::LoadString(resourceInstance, IDS_GENERAL_TRACE_FILENAME);
+	dialog->SetFileName(fileName.c_str());
+
+	hr = dialog->Show(owner);
+
+	if (FAILED(hr))
+	{
+		return std::nullopt;
+	}
+
+	wil::com_ptr_nothrow<IShellItem> result;
+	hr = dialog->GetResult(&result);
+
+	if (FAILED(hr))
+	{
+		return std::nullopt;
+	}
+
+	wil::unique_cotaskmem_string path;
+	hr = result->GetDisplayName(SIGDN_FILESYSPATH, &path);
+
+	if (FAILED(hr))
+	{
+		return std::nullopt;
+	}
+
+	return path.get();
+}
+
+concurrencpp::null_result SaveAsync(const TraceRecorder *recorder, std::wstring path, HWND owner,
+	HINSTANCE resourceInstance, const Runtime *runtime)
+{
+	co_await ResumeOnComStaThread(runtime);
+
+	bool succeeded;
+
+	{
+		std::ofstream stream(std::filesystem::path(path), std::ios::binary | std::ios::trunc);
+		recorder->WriteChromeTrace(stream);
+		stream.close();
+
+		succeeded = !stream.fail();
+	}
+
+	co_await ResumeOnUiThread(runtime);
+
+	if (succeeded)
+	{
+		co_return;
+	}
+
+	auto message = ResourceHelper::LoadString(resourceInstance, IDS_TRACE_SAVE_FAILED);
+	MessageBox(owner, message.c_str(), App::APP_NAME, MB_ICONWARNING | MB_OK);
+}
+
+}
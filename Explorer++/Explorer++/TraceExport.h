@@ -0,0 +1,25 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#pragma once
+
+#include <concurrencpp/concurrencpp.h>
+#include <optional>
+#include <string>
+
+class Runtime;
+class TraceRecorder;
+
+namespace TraceExport
+{
+
+// Asks the user where the trace should be saved. Returns an empty value if the user cancels.
+std::optional<std::wstring> PromptForDestination(HWND owner, HINSTANCE resourceInstance);
+
+// Writes the events held by the recorder to the specified file, in the Chrome trace event format.
+// The file is written on a background thread and a message is shown if the file can't be written.
+concurrencpp::null_result SaveAsync(const TraceRecorder *recorder, std::wstring path, HWND owner,
+	HINSTANCE resourceInstance, const Runtime *runtime);
+
+}
@@ -72,7 +72,7 @@ void Explorerplusplus::OnTreeViewCopyUniversalPaths() const
 	}
 }
 
-void Explorerplusplus::OnTreeViewSetFileAttributes() const
+void Explorerplusplus::OnTreeViewSetFileAttributes()
 {
 	std::list<NSetFileAttributesDialogExternal::SetFileAttributesInfo> sfaiList;
 	NSetFileAttributesDialogExternal::SetFileAttributesInfo sfai;
@@ -95,7 +95,8 @@ void Explorerplusplus::OnTreeViewSetFileAttributes() const
 			sfaiList.push_back(sfai);
 
 			SetFileAttributesDialog setFileAttributesDialog(m_app->GetResourceInstance(),
-				m_hContainer, m_app->GetThemeManager(), sfaiList);
+				m_hContainer, m_app->GetThemeManager(), m_app->GetRuntime(), &m_FileActionHandler,
+				sfaiList);
 			setFileAttributesDialog.ShowModalDialog();
 		}
 	}
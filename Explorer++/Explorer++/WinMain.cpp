@@ -7,6 +7,7 @@
 #include "CommandLine.h"
 #include "CrashHandlerHelper.h"
 #include "StartupCommandLineProcessor.h"
+#include "../Helper/Tracing.h"
 #include <boost/locale.hpp>
 #include <wil/result.h>
 #include <cstdlib>
@@ -41,6 +42,8 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine
 	InitializeCrashHandler();
 	InitializeLocale();
 
+	GetTraceRecorder().SetCurrentThreadName("UI thread");
+
 	auto commandLineInfo = CommandLine::Parse(GetCommandLine());
 
 	if (std::holds_alternative<CommandLine::ExitInfo>(commandLineInfo))
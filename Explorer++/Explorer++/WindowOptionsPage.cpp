@@ -62,7 +62,7 @@ std::unique_ptr<ResizableDialogHelper> WindowOptionsPage::InitializeResizeDialog
 
 void WindowOptionsPage::InitializeControls()
 {
-	if (m_config->allowMultipleInstances)
+	if (m_config->allowMultipleInstances.get())
 	{
 		CheckDlgButton(GetDialog(), IDC_OPTION_MULTIPLEINSTANCES, BST_CHECKED);
 	}
@@ -166,8 +166,8 @@ void WindowOptionsPage::OnCommand(WPARAM wParam, LPARAM lParam)
 
 void WindowOptionsPage::SaveSettings()
 {
-	m_config->allowMultipleInstances =
-		(IsDlgButtonChecked(GetDialog(), IDC_OPTION_MULTIPLEINSTANCES) == BST_CHECKED);
+	m_config->allowMultipleInstances.set(
+		IsDlgButtonChecked(GetDialog(), IDC_OPTION_MULTIPLEINSTANCES) == BST_CHECKED);
 
 	m_config->alwaysShowTabBar.set(
 		IsDlgButtonChecked(GetDialog(), IDC_OPTION_ALWAYSSHOWTABBAR) == BST_CHECKED);
@@ -205,6 +205,96 @@
 #define IDS_SEARCH_OPEN_ITEM_LOCATION_HELP_TEXT 401
 #define IDD_OPTIONS_STARTUP             402
 #define IDS_OPTIONS_CUSTOM_FOLDERS_TOOLTIP 403
+#define IDS_DIRECTORY_LISTING_FORMAT_CSV 404
+#define IDS_DIRECTORY_LISTING_FORMAT_TSV 405
+#define IDS_DIRECTORY_LISTING_FORMAT_JSON_LINES 406
+#define IDS_DIRECTORY_LISTING_FORMAT_XML 407
+#define IDS_DIRECTORY_LISTING_INCLUDE_SUBFOLDERS 408
+#define IDS_DIRECTORY_LISTING_COLUMN_FOLDER 409
+#define IDS_DIRECTORY_LISTING_PROGRESS_TITLE 410
+#define IDS_DIRECTORY_LISTING_PROGRESS  411
+#define IDS_DIRECTORY_LISTING_SAVE_FAILED 412
+#define IDS_COLUMN_NAME_HASH_CRC32      413
+#define IDS_COLUMN_NAME_HASH_XXHASH64   414
+#define IDS_COLUMN_NAME_HASH_SHA256     415
+#define IDS_COLUMN_DESCRIPTION_HASH_CRC32 416
+#define IDS_COLUMN_DESCRIPTION_HASH_XXHASH64 417
+#define IDS_COLUMN_DESCRIPTION_HASH_SHA256 418
+#define IDD_DUPLICATE_FILES             419
+#define IDS_DUPLICATE_FILES_COLUMN_NAME 420
+#define IDS_DUPLICATE_FILES_COLUMN_FOLDER 421
+#define IDS_DUPLICATE_FILES_COLUMN_SIZE 422
+#define IDS_DUPLICATE_FILES_STATUS_FINDING_FILES 423
+#define IDS_DUPLICATE_FILES_STATUS_COMPARING 424
+#define IDS_DUPLICATE_FILES_STATUS_FINISHED 425
+#define IDS_DUPLICATE_FILES_STATUS_STOPPED 426
+#define IDS_DUPLICATE_FILES_GROUP_HEADER 427
+#define IDD_COMPARE_FOLDERS             428
+#define IDS_COMPARE_FOLDERS_COLUMN_PATH 429
+#define IDS_COMPARE_FOLDERS_COLUMN_STATUS 430
+#define IDS_COMPARE_FOLDERS_COLUMN_LEFT_SIZE 431
+#define IDS_COMPARE_FOLDERS_COLUMN_LEFT_MODIFIED 432
+#define IDS_COMPARE_FOLDERS_COLUMN_RIGHT_SIZE 433
+#define IDS_COMPARE_FOLDERS_COLUMN_RIGHT_MODIFIED 434
+#define IDS_COMPARE_FOLDERS_STATUS_LEFT_ONLY 435
+#define IDS_COMPARE_FOLDERS_STATUS_RIGHT_ONLY 436
+#define IDS_COMPARE_FOLDERS_STATUS_LEFT_NEWER 437
+#define IDS_COMPARE_FOLDERS_STATUS_RIGHT_NEWER 438
+#define IDS_COMPARE_FOLDERS_STATUS_SIZE_DIFFERS 439
+#define IDS_COMPARE_FOLDERS_STATUS_CONTENT_DIFFERS 440
+#define IDS_COMPARE_FOLDERS_STATUS_TYPE_DIFFERS 441
+#define IDS_COMPARE_FOLDERS_STATUS_IDENTICAL 442
+#define IDS_COMPARE_FOLDERS_FILTER_ALL  443
+#define IDS_COMPARE_FOLDERS_FILTER_DIFFERENCES 444
+#define IDS_COMPARE_FOLDERS_FILTER_LEFT_ONLY 445
+#define IDS_COMPARE_FOLDERS_FILTER_RIGHT_ONLY 446
+#define IDS_COMPARE_FOLDERS_SYNC_LEFT_TO_RIGHT 447
+#define IDS_COMPARE_FOLDERS_SYNC_RIGHT_TO_LEFT 448
+#define IDS_COMPARE_FOLDERS_SYNC_TWO_WAY 449
+#define IDS_COMPARE_FOLDERS_COMPARING   450
+#define IDS_COMPARE_FOLDERS_FINISHED    451
+#define IDS_COMPARE_FOLDERS_FAILED      452
+#define IDS_COMPARE_FOLDERS_IN_SYNC     453
+#define IDS_COMPARE_FOLDERS_PLAN_SUMMARY 454
+#define IDS_COMPARE_FOLDERS_PLAN_TRUNCATED 455
+#define IDS_COMPARE_FOLDERS_SYNC_CONFIRMATION 456
+#define IDS_COMPARE_FOLDERS_SYNC_FAILED 457
+#define IDS_SETFILEATTRIBUTES_FAILURES  458
+#define IDS_SETFILEATTRIBUTES_FAILURES_TRUNCATED 459
+#define IDS_SEARCH_INDEX_NOT_READY      460
+#define IDD_ARCHIVE_BROWSER             461
+#define IDS_ARCHIVE_BROWSER_COLUMN_NAME 462
+#define IDS_ARCHIVE_BROWSER_COLUMN_SIZE 463
+#define IDS_ARCHIVE_BROWSER_COLUMN_PACKED_SIZE 464
+#define IDS_ARCHIVE_BROWSER_COLUMN_MODIFIED 465
+#define IDS_ARCHIVE_BROWSER_OPENING     466
+#define IDS_ARCHIVE_BROWSER_OPEN_FAILED 467
+#define IDS_ARCHIVE_BROWSER_FOLDER_SUMMARY 468
+#define IDS_ARCHIVE_BROWSER_EXTRACTING  469
+#define IDS_ARCHIVE_BROWSER_EXTRACTED   470
+#define IDS_ARCHIVE_BROWSER_EXTRACTED_WITH_FAILURES 471
+#define IDS_ARCHIVE_BROWSER_SELECT_DESTINATION 472
+#define IDS_ARCHIVE_BROWSER_OPEN_ENTRY_FAILED 473
+#define IDS_ARCHIVE_BROWSER_ENTRY_ENCRYPTED 474
+#define IDS_ARCHIVE_BROWSER_ENTRY_UNSUPPORTED 475
+#define IDS_ARCHIVE_BROWSER_ENTRY_CORRUPT 476
+#define IDS_PREVIEW_PANE_TITLE          477
+#define IDS_HIDE_PREVIEW_PANE           478
+#define IDS_PREVIEW_PANE_NO_FILE        479
+#define IDS_PREVIEW_PANE_OPENING        480
+#define IDS_PREVIEW_PANE_OPEN_FAILED    481
+#define IDS_PREVIEW_PANE_SEARCH_CUE     482
+#define IDS_PREVIEW_PANE_TEXT_VIEW      483
+#define IDS_PREVIEW_PANE_HEX_VIEW       484
+#define IDS_PREVIEW_PANE_TEXT_STATUS    485
+#define IDS_PREVIEW_PANE_TEXT_STATUS_INDEXING 486
+#define IDS_PREVIEW_PANE_HEX_STATUS     487
+#define IDS_PREVIEW_PANE_SEARCHING      488
+#define IDS_PREVIEW_PANE_NOT_FOUND      489
+#define IDS_PREVIEW_PANE_MATCH_FOUND    490
+#define IDS_TRACE_FILE_TYPE             491
+#define IDS_GENERAL_TRACE_FILENAME      492
+#define IDS_TRACE_SAVE_FAILED           493
 #define IDC_DEFAULTCOLUMNS_DESCRIPTION  1001
 #define IDC_COLUMNS_DESCRIPTION         1001
 #define IDC_SETTINGS_CHECK_EXTENSIONS   1002
@@ -430,6 +520,31 @@
 #define IDC_OPTIONS_MAIN_FONT           1373
 #define IDC_STARTUP_CUSTOM_FOLDERS      1374
 #define IDC_STARTUP_CUSTOM_FOLDERS_LIST 1375
+#define IDC_MANAGEBOOKMARKS_SEARCH      1376
+#define IDC_DUPLICATE_FILES_LIST        1377
+#define IDC_DUPLICATE_FILES_STATUS      1378
+#define IDC_DUPLICATE_FILES_STOP        1379
+#define IDC_COMPARE_FOLDERS_LEFT        1380
+#define IDC_COMPARE_FOLDERS_RIGHT       1381
+#define IDC_COMPARE_FOLDERS_COMPARE     1382
+#define IDC_COMPARE_FOLDERS_COMPARE_CONTENTS 1383
+#define IDC_COMPARE_FOLDERS_FILTER_LABEL 1384
+#define IDC_COMPARE_FOLDERS_FILTER      1385
+#define IDC_COMPARE_FOLDERS_LIST        1386
+#define IDC_COMPARE_FOLDERS_STATUS      1387
+#define IDC_COMPARE_FOLDERS_SYNC_LABEL  1388
+#define IDC_COMPARE_FOLDERS_SYNC_DIRECTION 1389
+#define IDC_COMPARE_FOLDERS_DELETE_EXTRA 1390
+#define IDC_COMPARE_FOLDERS_PREVIEW     1391
+#define IDC_COMPARE_FOLDERS_SYNC        1392
+#define IDC_SETFILEATTRIBUTES_RECURSIVE 1393
+#define IDC_SETFILEATTRIBUTES_PROGRESS  1394
+#define IDC_CHECK_SEARCHEVERYWHERE      1395
+#define IDC_ARCHIVE_BROWSER_PATH        1396
+#define IDC_ARCHIVE_BROWSER_TREE        1397
+#define IDC_ARCHIVE_BROWSER_LIST        1398
+#define IDC_ARCHIVE_BROWSER_STATUS      1399
+#define IDC_ARCHIVE_BROWSER_EXTRACT     1400
 #define IDS_COLUMN_DESCRIPTION_NAME     2000
 #define IDS_COLUMN_DESCRIPTION_TYPE     2001
 #define IDS_COLUMN_DESCRIPTION_SIZE     2002
@@ -836,6 +951,11 @@
 #define IDM_EDIT_PASTE_SYMBOLIC_LINK    40551
 #define IDM_FILE_NEW_WINDOW             40552
 #define IDM_GO_FREQUENT_LOCATIONS       40553
+#define IDM_BOOKMARKS_SEARCH_BOOKMARKS  40554
+#define IDM_TOOLS_FIND_DUPLICATE_FILES  40555
+#define IDM_TOOLS_COMPARE_FOLDERS       40556
+#define IDM_VIEW_PREVIEWPANE            40557
+#define IDM_TOOLS_RECORDTRACE           40558
 #define IDM_SORTBY_NAME                 50000
 #define IDM_SORTBY_SIZE                 50001
 #define IDM_SORTBY_TYPE                 50002
@@ -898,6 +1018,17 @@
 #define IDM_SORTBY_MEDIA_PUBLISHER      50061
 #define IDM_SORTBY_MEDIA_WRITER         50062
 #define IDM_SORTBY_MEDIA_YEAR           50063
+#define IDM_SORTBY_PLUGIN_COLUMN_1      50064
+#define IDM_SORTBY_PLUGIN_COLUMN_2      50065
+#define IDM_SORTBY_PLUGIN_COLUMN_3      50066
+#define IDM_SORTBY_PLUGIN_COLUMN_4      50067
+#define IDM_SORTBY_PLUGIN_COLUMN_5      50068
+#define IDM_SORTBY_PLUGIN_COLUMN_6      50069
+#define IDM_SORTBY_PLUGIN_COLUMN_7      50070
+#define IDM_SORTBY_PLUGIN_COLUMN_8      50071
+#define IDM_SORTBY_HASH_CRC32           50072
+#define IDM_SORTBY_HASH_XXHASH64        50073
+#define IDM_SORTBY_HASH_SHA256          50074
 #define IDM_GROUPBY_NAME                50100
 #define IDM_GROUPBY_SIZE                50101
 #define IDM_GROUPBY_TYPE                50102
@@ -960,6 +1091,17 @@
 #define IDM_GROUPBY_MEDIA_PUBLISHER     50161
 #define IDM_GROUPBY_MEDIA_WRITER        50162
 #define IDM_GROUPBY_MEDIA_YEAR          50163
+#define IDM_GROUPBY_PLUGIN_COLUMN_1     50164
+#define IDM_GROUPBY_PLUGIN_COLUMN_2     50165
+#define IDM_GROUPBY_PLUGIN_COLUMN_3     50166
+#define IDM_GROUPBY_PLUGIN_COLUMN_4     50167
+#define IDM_GROUPBY_PLUGIN_COLUMN_5     50168
+#define IDM_GROUPBY_PLUGIN_COLUMN_6     50169
+#define IDM_GROUPBY_PLUGIN_COLUMN_7     50170
+#define IDM_GROUPBY_PLUGIN_COLUMN_8     50171
+#define IDM_GROUPBY_HASH_CRC32          50172
+#define IDM_GROUPBY_HASH_XXHASH64       50173
+#define IDM_GROUPBY_HASH_SHA256         50174
 #define IDM_VIEW_EXTRALARGEICONS        60000
 #define IDM_VIEW_LARGEICONS             60001
 #define IDM_VIEW_ICONS                  60002
@@ -982,9 +1124,9 @@
 // 
 #ifdef APSTUDIO_INVOKED
 #ifndef APSTUDIO_READONLY_SYMBOLS
-#define _APS_NEXT_RESOURCE_VALUE        404
-#define _APS_NEXT_COMMAND_VALUE         40554
-#define _APS_NEXT_CONTROL_VALUE         1376
+#define _APS_NEXT_RESOURCE_VALUE        494
+#define _APS_NEXT_COMMAND_VALUE         40559
+#define _APS_NEXT_CONTROL_VALUE         1401
 #define _APS_NEXT_SYMED_VALUE           101
 #endif
 #endif
@@ -0,0 +1,194 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "stdafx.h"
+#include "ByteSearch.h"
+#include <algorithm>
+#include <bit>
+#include <cstring>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#define BYTE_SEARCH_USE_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+
+constexpr std::byte ASCII_CASE_BIT{ 0x20 };
+
+bool IsAsciiLetter(std::byte value)
+{
+	auto lower = std::to_integer<unsigned char>(value | ASCII_CASE_BIT);
+	return lower >= 'a' && lower <= 'z';
+}
+
+bool MatchesAt(const std::byte *data, std::span<const std::byte> pattern, bool caseSensitive)
+{
+	if (caseSensitive)
+	{
+		return std::memcmp(data, pattern.data(), pattern.size()) == 0;
+	}
+
+	for (size_t i = 0; i < pattern.size(); i++)
+	{
+		if (IsAsciiLetter(pattern[i]))
+		{
+			if ((data[i] | ASCII_CASE_BIT) != (pattern[i] | ASCII_CASE_BIT))
+			{
+				return false;
+			}
+		}
+		else if (data[i] != pattern[i])
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+#ifdef BYTE_SEARCH_USE_SSE2
+
+constexpr size_t BLOCK_SIZE = sizeof(__m128i);
+
+__m128i LoadBlock(const std::byte *data)
+{
+	return _mm_loadu_si128(reinterpret_cast<const __m128i *>(data));
+}
+
+#endif
+
+}
+
+size_t CountByte(std::span<const std::byte> data, std::byte value)
+{
+	size_t count = 0;
+	size_t i = 0;
+
+#ifdef BYTE_SEARCH_USE_SSE2
+	const __m128i target = _mm_set1_epi8(static_cast<char>(value));
+	const __m128i zero = _mm_setzero_si128();
+
+	// Each matching byte decrements its lane by 0xFF (i.e. increments it by 1), so the per-lane
+	// counts have to be summed before any of them can overflow.
+	constexpr size_t MAX_BLOCKS_PER_BATCH = 255;
+
+	while (data.size() - i >= BLOCK_SIZE)
+	{
+		size_t numBlocks = std::min((data.size() - i) / BLOCK_SIZE, MAX_BLOCKS_PER_BATCH);
+		__m128i laneCounts = zero;
+
+		for (size_t block = 0; block < numBlocks; block++, i += BLOCK_SIZE)
+		{
+			laneCounts = _mm_sub_epi8(laneCounts, _mm_cmpeq_epi8(LoadBlock(&data[i]), target));
+		}
+
+		__m128i sums = _mm_sad_epu8(laneCounts, zero);
+		count += static_cast<size_t>(_mm_cvtsi128_si32(sums) + _mm_extract_epi16(sums, 4));
+	}
+#endif
+
+	for (; i < data.size(); i++)
+	{
+		if (data[i] == value)
+		{
+			count++;
+		}
+	}
+
+	return count;
+}
+
+std::optional<size_t> FindByte(std::span<const std::byte> data, std::byte value)
+{
+	size_t i = 0;
+
+#ifdef BYTE_SEARCH_USE_SSE2
+	const __m128i target = _mm_set1_epi8(static_cast<char>(value));
+
+	for (; data.size() - i >= BLOCK_SIZE; i += BLOCK_SIZE)
+	{
+		auto mask = static_cast<unsigned int>(
+			_mm_movemask_epi8(_mm_cmpeq_epi8(LoadBlock(&data[i]), target)));
+
+		if (mask != 0)
+		{
+			return i + std::countr_zero(mask);
+		}
+	}
+#endif
+
+	for (; i < data.size(); i++)
+	{
+		if (data[i] == value)
+		{
+			return i;
+		}
+	}
+
+	return std::nullopt;
+}
+
+std::optional<size_t> FindPattern(std::span<const std::byte> data,
+	std::span<const std::byte> pattern, bool caseSensitive)
+{
+	if (pattern.empty())
+	{
+		return 0;
+	}
+
+	if (pattern.size() > data.size())
+	{
+		return std::nullopt;
+	}
+
+	size_t lastStart = data.size() - pattern.size();
+	size_t i = 0;
+
+#ifdef BYTE_SEARCH_USE_SSE2
+	// Candidate positions are those where both the first and last bytes of the pattern match,
+	// which are found 16 positions at a time. Only the candidates are then compared in full.
+	auto makeFold = [caseSensitive](std::byte value)
+	{ return (!caseSensitive && IsAsciiLetter(value)) ? ASCII_CASE_BIT : std::byte{ 0 }; };
+
+	std::byte firstFold = makeFold(pattern.front());
+	std::byte lastFold = makeFold(pattern.back());
+	const __m128i firstFoldMask = _mm_set1_epi8(static_cast<char>(firstFold));
+	const __m128i lastFoldMask = _mm_set1_epi8(static_cast<char>(lastFold));
+	const __m128i firstTarget = _mm_set1_epi8(static_cast<char>(pattern.front() | firstFold));
+	const __m128i lastTarget = _mm_set1_epi8(static_cast<char>(pattern.back() | lastFold));
+	size_t lastOffset = pattern.size() - 1;
+
+	for (; lastStart - i + 1 >= BLOCK_SIZE; i += BLOCK_SIZE)
+	{
+		__m128i firstBlock = _mm_or_si128(LoadBlock(&data[i]), firstFoldMask);
+		__m128i lastBlock = _mm_or_si128(LoadBlock(&data[i + lastOffset]), lastFoldMask);
+		auto mask = static_cast<unsigned int>(_mm_movemask_epi8(_mm_and_si128(
+			_mm_cmpeq_epi8(firstBlock, firstTarget), _mm_cmpeq_epi8(lastBlock, lastTarget))));
+
+		while (mask != 0)
+		{
+			size_t candidate = i + std::countr_zero(mask);
+
+			if (MatchesAt(&data[candidate], pattern, caseSensitive))
+			{
+				return candidate;
+			}
+
+			mask &= mask - 1;
+		}
+	}
+#endif
+
+	for (; i <= lastStart; i++)
+	{
+		if (MatchesAt(&data[i], pattern, caseSensitive))
+		{
+			return i;
+		}
+	}
+
+	return std::nullopt;
+}
@@ -0,0 +1,20 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <span>
+
+// These functions scan 16 bytes at a time using SSE2 where it's available (which it always is on
+// x86-64), falling back to a byte-by-byte scan elsewhere.
+
+size_t CountByte(std::span<const std::byte> data, std::byte value);
+std::optional<size_t> FindByte(std::span<const std::byte> data, std::byte value);
+
+// Returns the index of the first occurrence of the pattern within the data. If caseSensitive is
+// false, ASCII letters in the pattern match either case. An empty pattern matches at index 0.
+std::optional<size_t> FindPattern(std::span<const std::byte> data,
+	std::span<const std::byte> pattern, bool caseSensitive = true);
@@ -0,0 +1,104 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "stdafx.h"
+#include "CompactPathList.h"
+#include <algorithm>
+#include <limits>
+
+CompactPathList::CompactPathList() : m_data(1, L'\0')
+{
+}
+
+void CompactPathList::Reserve(size_t numPaths, size_t numCharacters)
+{
+	m_data.reserve(numCharacters + numPaths + 1);
+	m_offsets.reserve(numPaths);
+}
+
+void CompactPathList::Add(std::wstring_view path)
+{
+	DCHECK(path.find(L'\0') == std::wstring_view::npos);
+
+	// The path replaces the final null character, which is then added back after the path's own
+	// terminator.
+	size_t offset = m_data.size() - 1;
+	CHECK_LE(offset + path.size() + 1, std::numeric_limits<uint32_t>::max());
+
+	m_offsets.push_back(static_cast<uint32_t>(offset));
+
+	m_data.insert(m_data.end() - 1, path.begin(), path.end());
+	m_data.push_back(L'\0');
+}
+
+size_t CompactPathList::GetCount() const
+{
+	return m_offsets.size();
+}
+
+bool CompactPathList::IsEmpty() const
+{
+	return m_offsets.empty();
+}
+
+std::wstring_view CompactPathList::GetPath(size_t index) const
+{
+	CHECK_LT(index, m_offsets.size());
+
+	size_t start = m_offsets[index];
+
+	// Each path is followed by its terminator, then either the next path or the final null
+	// character.
+	size_t end = (index + 1 < m_offsets.size() ? m_offsets[index + 1] : m_data.size() - 1) - 1;
+
+	return { m_data.data() + start, end - start };
+}
+
+std::wstring_view CompactPathList::GetDoubleNullTerminatedData() const
+{
+	return { m_data.data(), m_data.size() };
+}
+
+size_t CompactPathList::GetJoinedLength(std::wstring_view separator) const
+{
+	if (m_offsets.empty())
+	{
+		return 0;
+	}
+
+	// The buffer contains a terminator after each path, plus the final null character.
+	size_t numPathCharacters = m_data.size() - m_offsets.size() - 1;
+
+	return numPathCharacters + (m_offsets.size() - 1) * separator.size();
+}
+
+void CompactPathList::WriteJoined(std::wstring_view separator, std::span<wchar_t> output) const
+{
+	CHECK_GE(output.size(), GetJoinedLength(separator));
+
+	auto outputIt = output.begin();
+
+	for (size_t i = 0; i < m_offsets.size(); i++)
+	{
+		if (i > 0)
+		{
+			outputIt = std::copy(separator.begin(), separator.end(), outputIt);
+		}
+
+		auto path = GetPath(i);
+		outputIt = std::copy(path.begin(), path.end(), outputIt);
+	}
+}
+
+std::wstring CompactPathList::Join(std::wstring_view separator) const
+{
+	std::wstring joined(GetJoinedLength(separator), L'\0');
+	WriteJoined(separator, joined);
+	return joined;
+}
+
+size_t CompactPathList::GetMemoryUsage() const
+{
+	return m_data.capacity() * sizeof(wchar_t) + m_offsets.capacity() * sizeof(uint32_t);
+}
@@ -0,0 +1,55 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Stores a list of paths in a single buffer, with each path followed by a null character and the
+// list as a whole followed by an additional null character. That's the layout used by CF_HDROP,
+// so the buffer can be copied into that format directly. When there are a large number of paths,
+// this also uses considerably less memory than a vector of strings, since each string would
+// otherwise need its own allocation.
+class CompactPathList
+{
+public:
+	CompactPathList();
+
+	// Reserves space for the specified number of paths, containing the specified total number of
+	// characters (excluding terminators).
+	void Reserve(size_t numPaths, size_t numCharacters);
+
+	// Paths can't contain null characters.
+	void Add(std::wstring_view path);
+
+	size_t GetCount() const;
+	bool IsEmpty() const;
+	std::wstring_view GetPath(size_t index) const;
+
+	// Returns the complete buffer, including the final null character.
+	std::wstring_view GetDoubleNullTerminatedData() const;
+
+	// Returns the number of characters needed to store the paths, with each pair of paths
+	// separated by the separator. The length doesn't include a terminating null character.
+	size_t GetJoinedLength(std::wstring_view separator) const;
+
+	// The output must contain at least GetJoinedLength() characters.
+	void WriteJoined(std::wstring_view separator, std::span<wchar_t> output) const;
+
+	std::wstring Join(std::wstring_view separator) const;
+
+	// Returns the amount of memory allocated by this instance, in bytes.
+	size_t GetMemoryUsage() const;
+
+private:
+	std::vector<wchar_t> m_data;
+
+	// The offset of each path within the buffer. 32-bit offsets are used to keep the list compact.
+	std::vector<uint32_t> m_offsets;
+};
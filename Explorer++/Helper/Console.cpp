@@ -4,9 +4,13 @@
 
 #include "stdafx.h"
 #include "Console.h"
+#include <fcntl.h>
+#include <io.h>
 #include <iostream>
 
 bool RedirectConsoleIO();
+HANDLE DuplicateRedirectedHandle(DWORD stdHandle);
+void RestoreRedirectedStream(FILE *stream, HANDLE handle);
 
 // The code in this file has been sourced from the following Stack Overflow
 // answer:
@@ -19,6 +23,12 @@ bool Console::AttachParentConsole()
 {
 	bool result = false;
 
+	// If output has been redirected to a file or pipe (e.g. when running a batch command from a
+	// script), that's where it should continue to go. The handles are duplicated, since they would
+	// otherwise be closed when the streams are redirected below.
+	HANDLE redirectedOutput = DuplicateRedirectedHandle(STD_OUTPUT_HANDLE);
+	HANDLE redirectedError = DuplicateRedirectedHandle(STD_ERROR_HANDLE);
+
 	// Release any current console and redirect IO to NUL
 	ReleaseConsole();
 
@@ -28,6 +38,9 @@ bool Console::AttachParentConsole()
 		result = RedirectConsoleIO();
 	}
 
+	RestoreRedirectedStream(stdout, redirectedOutput);
+	RestoreRedirectedStream(stderr, redirectedError);
+
 	return result;
 }
 
@@ -102,3 +115,57 @@ bool RedirectConsoleIO()
 
 	return result;
 }
+
+HANDLE DuplicateRedirectedHandle(DWORD stdHandle)
+{
+	HANDLE handle = GetStdHandle(stdHandle);
+
+	if (handle == nullptr || handle == INVALID_HANDLE_VALUE)
+	{
+		return nullptr;
+	}
+
+	DWORD fileType = GetFileType(handle);
+
+	if (fileType != FILE_TYPE_DISK && fileType != FILE_TYPE_PIPE)
+	{
+		return nullptr;
+	}
+
+	HANDLE duplicate;
+
+	if (!DuplicateHandle(GetCurrentProcess(), handle, GetCurrentProcess(), &duplicate, 0, FALSE,
+			DUPLICATE_SAME_ACCESS))
+	{
+		return nullptr;
+	}
+
+	return duplicate;
+}
+
+void RestoreRedirectedStream(FILE *stream, HANDLE handle)
+{
+	if (!handle)
+	{
+		return;
+	}
+
+	// Output written to a file or pipe is passed through as-is, without any line ending
+	// translation.
+	int fd = _open_osfhandle(reinterpret_cast<intptr_t>(handle), _O_WRONLY | _O_BINARY);
+
+	if (fd == -1)
+	{
+		CloseHandle(handle);
+		return;
+	}
+
+	fflush(stream);
+
+	if (_dup2(fd, _fileno(stream)) == 0)
+	{
+		setvbuf(stream, nullptr, _IONBF, 0);
+	}
+
+	_close(fd);
+}
@@ -0,0 +1,518 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "stdafx.h"
+#include "ContentHash.h"
+#include <glog/logging.h>
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+namespace
+{
+
+void AppendHex(std::string &output, const uint8_t *bytes, size_t size)
+{
+	static constexpr char HEX_DIGITS[] = "0123456789abcdef";
+
+	for (size_t i = 0; i < size; i++)
+	{
+		output += HEX_DIGITS[bytes[i] >> 4];
+		output += HEX_DIGITS[bytes[i] & 0xF];
+	}
+}
+
+template <typename T>
+void AppendHexBigEndian(std::string &output, T value)
+{
+	uint8_t bytes[sizeof(T)];
+
+	for (size_t i = 0; i < sizeof(T); i++)
+	{
+		bytes[i] = static_cast<uint8_t>(value >> (8 * (sizeof(T) - 1 - i)));
+	}
+
+	AppendHex(output, bytes, sizeof(T));
+}
+
+uint64_t ReadLittleEndian64(const uint8_t *data)
+{
+	uint64_t value = 0;
+
+	for (int i = 7; i >= 0; i--)
+	{
+		value = (value << 8) | data[i];
+	}
+
+	return value;
+}
+
+uint32_t ReadLittleEndian32(const uint8_t *data)
+{
+	return static_cast<uint32_t>(data[0]) | (static_cast<uint32_t>(data[1]) << 8)
+		| (static_cast<uint32_t>(data[2]) << 16) | (static_cast<uint32_t>(data[3]) << 24);
+}
+
+uint32_t ReadBigEndian32(const uint8_t *data)
+{
+	return (static_cast<uint32_t>(data[0]) << 24) | (static_cast<uint32_t>(data[1]) << 16)
+		| (static_cast<uint32_t>(data[2]) << 8) | static_cast<uint32_t>(data[3]);
+}
+
+}
+
+class ContentHasher::Function
+{
+public:
+	virtual ~Function() = default;
+
+	virtual void Update(const uint8_t *data, size_t size) = 0;
+	virtual std::string Finish() = 0;
+};
+
+namespace
+{
+
+// The reflected CRC-32 used by zip, PNG, etc. Data is processed 8 bytes at a time using the
+// slicing-by-8 technique, which needs eight lookup tables, but is several times faster than the
+// byte-at-a-time approach.
+class Crc32 : public ContentHasher::Function
+{
+public:
+	void Update(const uint8_t *data, size_t size) override
+	{
+		const auto &tables = GetTables();
+		uint32_t crc = m_crc;
+
+		while (size >= 8)
+		{
+			uint32_t low = ReadLittleEndian32(data) ^ crc;
+			uint32_t high = ReadLittleEndian32(data + 4);
+
+			crc = tables[7][low & 0xFF] ^ tables[6][(low >> 8) & 0xFF]
+				^ tables[5][(low >> 16) & 0xFF] ^ tables[4][low >> 24] ^ tables[3][high & 0xFF]
+				^ tables[2][(high >> 8) & 0xFF] ^ tables[1][(high >> 16) & 0xFF]
+				^ tables[0][high >> 24];
+
+			data += 8;
+			size -= 8;
+		}
+
+		for (size_t i = 0; i < size; i++)
+		{
+			crc = tables[0][(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+		}
+
+		m_crc = crc;
+	}
+
+	std::string Finish() override
+	{
+		std::string digest;
+		AppendHexBigEndian(digest, ~m_crc);
+		return digest;
+	}
+
+private:
+	using Tables = std::array<std::array<uint32_t, 256>, 8>;
+
+	static const Tables &GetTables()
+	{
+		static const Tables tables = []
+		{
+			Tables generatedTables;
+
+			for (uint32_t i = 0; i < 256; i++)
+			{
+				uint32_t crc = i;
+
+				for (int bit = 0; bit < 8; bit++)
+				{
+					crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320 : crc >> 1;
+				}
+
+				generatedTables[0][i] = crc;
+			}
+
+			for (uint32_t i = 0; i < 256; i++)
+			{
+				for (size_t table = 1; table < generatedTables.size(); table++)
+				{
+					uint32_t previous = generatedTables[table - 1][i];
+					generatedTables[table][i] =
+						(previous >> 8) ^ generatedTables[0][previous & 0xFF];
+				}
+			}
+
+			return generatedTables;
+		}();
+
+		return tables;
+	}
+
+	uint32_t m_crc = 0xFFFFFFFF;
+};
+
+// XXH64, with a seed of 0.
+class XxHash64 : public ContentHasher::Function
+{
+public:
+	XxHash64() :
+		m_accumulators{ PRIME1 + PRIME2, PRIME2, 0, 0 - PRIME1 }
+	{
+	}
+
+	void Update(const uint8_t *data, size_t size) override
+	{
+		m_totalSize += size;
+
+		if (m_bufferSize > 0)
+		{
+			size_t toCopy = std::min(size, STRIPE_SIZE - m_bufferSize);
+			std::memcpy(m_buffer + m_bufferSize, data, toCopy);
+			m_bufferSize += toCopy;
+			data += toCopy;
+			size -= toCopy;
+
+			if (m_bufferSize < STRIPE_SIZE)
+			{
+				return;
+			}
+
+			ProcessStripe(m_buffer);
+			m_bufferSize = 0;
+		}
+
+		while (size >= STRIPE_SIZE)
+		{
+			ProcessStripe(data);
+			data += STRIPE_SIZE;
+			size -= STRIPE_SIZE;
+		}
+
+		std::memcpy(m_buffer, data, size);
+		m_bufferSize = size;
+	}
+
+	std::string Finish() override
+	{
+		uint64_t hash;
+
+		if (m_totalSize >= STRIPE_SIZE)
+		{
+			hash = std::rotl(m_accumulators[0], 1) + std::rotl(m_accumulators[1], 7)
+				+ std::rotl(m_accumulators[2], 12) + std::rotl(m_accumulators[3], 18);
+
+			for (uint64_t accumulator : m_accumulators)
+			{
+				hash = (hash ^ Round(0, accumulator)) * PRIME1 + PRIME4;
+			}
+		}
+		else
+		{
+			hash = PRIME5;
+		}
+
+		hash += m_totalSize;
+
+		const uint8_t *data = m_buffer;
+		size_t remaining = m_bufferSize;
+
+		while (remaining >= 8)
+		{
+			hash ^= Round(0, ReadLittleEndian64(data));
+			hash = std::rotl(hash, 27) * PRIME1 + PRIME4;
+			data += 8;
+			remaining -= 8;
+		}
+
+		if (remaining >= 4)
+		{
+			hash ^= static_cast<uint64_t>(ReadLittleEndian32(data)) * PRIME1;
+			hash = std::rotl(hash, 23) * PRIME2 + PRIME3;
+			data += 4;
+			remaining -= 4;
+		}
+
+		while (remaining > 0)
+		{
+			hash ^= *data * PRIME5;
+			hash = std::rotl(hash, 11) * PRIME1;
+			data++;
+			remaining--;
+		}
+
+		hash ^= hash >> 33;
+		hash *= PRIME2;
+		hash ^= hash >> 29;
+		hash *= PRIME3;
+		hash ^= hash >> 32;
+
+		std::string digest;
+		AppendHexBigEndian(digest, hash);
+		return digest;
+	}
+
+private:
+	static constexpr uint64_t PRIME1 = 0x9E3779B185EBCA87ULL;
+	static constexpr uint64_t PRIME2 = 0xC2B2AE3D27D4EB4FULL;
+	static constexpr uint64_t PRIME3 = 0x165667B19E3779F9ULL;
+	static constexpr uint64_t PRIME4 = 0x85EBCA77C2B2AE63ULL;
+	static constexpr uint64_t PRIME5 = 0x27D4EB2F165667C5ULL;
+	static constexpr size_t STRIPE_SIZE = 32;
+
+	static uint64_t Round(uint64_t accumulator, uint64_t input)
+	{
+		accumulator += input * PRIME2;
+		accumulator = std::rotl(accumulator, 31);
+		return accumulator * PRIME1;
+	}
+
+	void ProcessStripe(const uint8_t *data)
+	{
+		for (size_t i = 0; i < m_accumulators.size(); i++)
+		{
+			m_accumulators[i] = Round(m_accumulators[i], ReadLittleEndian64(data + i * 8));
+		}
+	}
+
+	std::array<uint64_t, 4> m_accumulators;
+	uint8_t m_buffer[STRIPE_SIZE];
+	size_t m_bufferSize = 0;
+	uint64_t m_totalSize = 0;
+};
+
+// SHA-256, as specified in FIPS 180-4.
+class Sha256 : public ContentHasher::Function
+{
+public:
+	void Update(const uint8_t *data, size_t size) override
+	{
+		m_totalSize += size;
+
+		if (m_bufferSize > 0)
+		{
+			size_t toCopy = std::min(size, BLOCK_SIZE - m_bufferSize);
+			std::memcpy(m_buffer + m_bufferSize, data, toCopy);
+			m_bufferSize += toCopy;
+			data += toCopy;
+			size -= toCopy;
+
+			if (m_bufferSize < BLOCK_SIZE)
+			{
+				return;
+			}
+
+			ProcessBlock(m_buffer);
+			m_bufferSize = 0;
+		}
+
+		while (size >= BLOCK_SIZE)
+		{
+			ProcessBlock(data);
+			data += BLOCK_SIZE;
+			size -= BLOCK_SIZE;
+		}
+
+		std::memcpy(m_buffer, data, size);
+		m_bufferSize = size;
+	}
+
+	std::string Finish() override
+	{
+		uint64_t totalBits = m_totalSize * 8;
+
+		// The message is padded with a single set bit, then zeros, so that the length (as a 64-bit
+		// big-endian value) finishes the last block.
+		uint8_t padding[BLOCK_SIZE * 2] = { 0x80 };
+		size_t paddingSize = (m_bufferSize < BLOCK_SIZE - 8) ? BLOCK_SIZE - 8 - m_bufferSize
+															  : BLOCK_SIZE * 2 - 8 - m_bufferSize;
+
+		for (int i = 0; i < 8; i++)
+		{
+			padding[paddingSize + i] = static_cast<uint8_t>(totalBits >> (56 - i * 8));
+		}
+
+		Update(padding, paddingSize + 8);
+
+		std::string digest;
+
+		for (uint32_t word : m_state)
+		{
+			AppendHexBigEndian(digest, word);
+		}
+
+		return digest;
+	}
+
+private:
+	static constexpr size_t BLOCK_SIZE = 64;
+
+	static constexpr uint32_t ROUND_CONSTANTS[64] = { 0x428a2f98, 0x71374491, 0xb5c0fbcf,
+		0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5, 0xd807aa98, 0x12835b01,
+		0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174, 0xe49b69c1,
+		0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+		0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351,
+		0x14292967, 0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb,
+		0x81c2c92e, 0x92722c85, 0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819,
+		0xd6990624, 0xf40e3585, 0x106aa070, 0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5,
+		0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3, 0x748f82ee, 0x78a5636f, 0x84c87814,
+		0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2 };
+
+	void ProcessBlock(const uint8_t *data)
+	{
+		uint32_t schedule[64];
+
+		for (int i = 0; i < 16; i++)
+		{
+			schedule[i] = ReadBigEndian32(data + i * 4);
+		}
+
+		for (int i = 16; i < 64; i++)
+		{
+			uint32_t s0 = std::rotr(schedule[i - 15], 7) ^ std::rotr(schedule[i - 15], 18)
+				^ (schedule[i - 15] >> 3);
+			uint32_t s1 = std::rotr(schedule[i - 2], 17) ^ std::rotr(schedule[i - 2], 19)
+				^ (schedule[i - 2] >> 10);
+			schedule[i] = schedule[i - 16] + s0 + schedule[i - 7] + s1;
+		}
+
+		uint32_t a = m_state[0];
+		uint32_t b = m_state[1];
+		uint32_t c = m_state[2];
+		uint32_t d = m_state[3];
+		uint32_t e = m_state[4];
+		uint32_t f = m_state[5];
+		uint32_t g = m_state[6];
+		uint32_t h = m_state[7];
+
+		for (int i = 0; i < 64; i++)
+		{
+			uint32_t s1 = std::rotr(e, 6) ^ std::rotr(e, 11) ^ std::rotr(e, 25);
+			uint32_t choice = (e & f) ^ (~e & g);
+			uint32_t temp1 = h + s1 + choice + ROUND_CONSTANTS[i] + schedule[i];
+			uint32_t s0 = std::rotr(a, 2) ^ std::rotr(a, 13) ^ std::rotr(a, 22);
+			uint32_t majority = (a & b) ^ (a & c) ^ (b & c);
+			uint32_t temp2 = s0 + majority;
+
+			h = g;
+			g = f;
+			f = e;
+			e = d + temp1;
+			d = c;
+			c = b;
+			b = a;
+			a = temp1 + temp2;
+		}
+
+		m_state[0] += a;
+		m_state[1] += b;
+		m_state[2] += c;
+		m_state[3] += d;
+		m_state[4] += e;
+		m_state[5] += f;
+		m_state[6] += g;
+		m_state[7] += h;
+	}
+
+	std::array<uint32_t, 8> m_state = { 0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f,
+		0x9b05688c, 0x1f83d9ab, 0x5be0cd19 };
+	uint8_t m_buffer[BLOCK_SIZE];
+	size_t m_bufferSize = 0;
+	uint64_t m_totalSize = 0;
+};
+
+std::unique_ptr<ContentHasher::Function> CreateFunction(HashAlgorithm algorithm)
+{
+	switch (algorithm)
+	{
+	case HashAlgorithm::Crc32:
+		return std::make_unique<Crc32>();
+
+	case HashAlgorithm::XxHash64:
+		return std::make_unique<XxHash64>();
+
+	case HashAlgorithm::Sha256:
+		return std::make_unique<Sha256>();
+	}
+
+	LOG(FATAL) << "Unknown hash algorithm";
+	return nullptr;
+}
+
+}
+
+ContentHasher::ContentHasher(HashAlgorithm algorithm) : m_function(CreateFunction(algorithm))
+{
+}
+
+ContentHasher::~ContentHasher() = default;
+
+void ContentHasher::Update(const void *data, size_t size)
+{
+	m_function->Update(static_cast<const uint8_t *>(data), size);
+}
+
+std::string ContentHasher::Finish()
+{
+	return m_function->Finish();
+}
+
+std::optional<std::string> HashFile(const std::filesystem::path &path, HashAlgorithm algorithm,
+	std::stop_token stopToken, std::optional<uint64_t> maxBytes, uint64_t *bytesRead)
+{
+	// Each worker thread reuses a single buffer, rather than allocating a new one for every file.
+	thread_local std::vector<char> buffer(HASH_FILE_BLOCK_SIZE);
+
+	std::ifstream stream;
+
+	// The data is read in large blocks directly into the buffer above, so there's no need for the
+	// stream to do any buffering of its own.
+	stream.rdbuf()->pubsetbuf(nullptr, 0);
+	stream.open(path, std::ios::binary);
+
+	if (!stream)
+	{
+		return std::nullopt;
+	}
+
+	ContentHasher hasher(algorithm);
+	uint64_t remaining = maxBytes.value_or(UINT64_MAX);
+
+	while (remaining > 0)
+	{
+		if (stopToken.stop_requested())
+		{
+			return std::nullopt;
+		}
+
+		auto toRead = static_cast<std::streamsize>(std::min<uint64_t>(buffer.size(), remaining));
+		stream.read(buffer.data(), toRead);
+		auto numRead = stream.gcount();
+
+		if (bytesRead)
+		{
+			*bytesRead += static_cast<uint64_t>(numRead);
+		}
+
+		hasher.Update(buffer.data(), static_cast<size_t>(numRead));
+		remaining -= static_cast<uint64_t>(numRead);
+
+		if (numRead < toRead)
+		{
+			// Reaching the end of the file is expected. Anything else is a read error.
+			if (!stream.eof())
+			{
+				return std::nullopt;
+			}
+
+			break;
+		}
+	}
+
+	return hasher.Finish();
+}
@@ -0,0 +1,54 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#pragma once
+
+#include <boost/core/noncopyable.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <stop_token>
+#include <string>
+
+enum class HashAlgorithm
+{
+	Crc32,
+	XxHash64,
+	Sha256
+};
+
+// Incrementally computes a hash of a sequence of bytes. The digest is returned as a lowercase
+// hexadecimal string, in the same form that's conventionally displayed for each algorithm (e.g.
+// "cbf43926" for a CRC32).
+class ContentHasher : private boost::noncopyable
+{
+public:
+	class Function;
+
+	explicit ContentHasher(HashAlgorithm algorithm);
+	~ContentHasher();
+
+	void Update(const void *data, size_t size);
+
+	// No further data should be added once this has been called.
+	std::string Finish();
+
+private:
+	std::unique_ptr<Function> m_function;
+};
+
+// Files are read sequentially, in blocks of this size. Large blocks keep the number of reads (and
+// therefore the per-read overhead) low, while still being small enough that a cancellation request
+// is noticed quickly.
+inline constexpr size_t HASH_FILE_BLOCK_SIZE = 1024 * 1024;
+
+// Hashes the contents of the specified file. If maxBytes is set, only that many bytes from the
+// start of the file are hashed. Returns an empty value if the file couldn't be read, or if a stop
+// was requested before the file was fully read. If bytesRead is provided, the number of bytes read
+// from the file is added to it (whether or not hashing succeeds).
+std::optional<std::string> HashFile(const std::filesystem::path &path, HashAlgorithm algorithm,
+	std::stop_token stopToken, std::optional<uint64_t> maxBytes = std::nullopt,
+	uint64_t *bytesRead = nullptr);
@@ -4,6 +4,7 @@
 
 #include "stdafx.h"
 #include "DataExchangeHelper.h"
+#include "CompactPathList.h"
 #include "DragDropHelper.h"
 #include "GdiplusHelper.h"
 #include "Helper.h"
@@ -130,22 +131,27 @@ std::optional<std::vector<std::wstring>> ReadHDropDataFromGlobal(HGLOBAL global)
 
 wil::unique_hglobal WriteHDropDataToGlobal(const std::vector<std::wstring> &paths)
 {
-	if (paths.empty())
+	CompactPathList pathList;
+
+	for (const auto &path : paths)
 	{
-		// An empty list of filenames isn't valid.
-		return nullptr;
+		pathList.Add(path);
 	}
 
-	std::wstring concatenatedPaths;
+	return WriteHDropDataToGlobal(pathList);
+}
 
-	for (const auto &path : paths)
+wil::unique_hglobal WriteHDropDataToGlobal(const CompactPathList &paths)
+{
+	if (paths.IsEmpty())
 	{
-		concatenatedPaths.append(path);
-		concatenatedPaths.append(1, '\0');
+		// An empty list of filenames isn't valid.
+		return nullptr;
 	}
 
-	// The list of filenames needs to be double null-terminated.
-	concatenatedPaths.append(1, '\0');
+	// The list of filenames needs to be double null-terminated, which is the format the paths are
+	// already stored in.
+	auto concatenatedPaths = paths.GetDoubleNullTerminatedData();
 
 	size_t headerSize = sizeof(DROPFILES);
 	size_t concatenatedPathsSize = concatenatedPaths.size() * sizeof(WCHAR);
@@ -174,6 +180,31 @@ wil::unique_hglobal WriteHDropDataToGlobal(const std::vector<std::wstring> &path
 	return global;
 }
 
+wil::unique_hglobal WriteJoinedPathsToGlobal(const CompactPathList &paths,
+	std::wstring_view separator)
+{
+	size_t length = paths.GetJoinedLength(separator);
+
+	// GHND zero-initializes the memory, so the string will be null-terminated.
+	wil::unique_hglobal global(GlobalAlloc(GHND, (length + 1) * sizeof(WCHAR)));
+
+	if (!global)
+	{
+		return nullptr;
+	}
+
+	wil::unique_hglobal_locked mem(global.get());
+
+	if (!mem)
+	{
+		return nullptr;
+	}
+
+	paths.WriteJoined(separator, { static_cast<WCHAR *>(mem.get()), length });
+
+	return global;
+}
+
 std::unique_ptr<Gdiplus::Bitmap> ReadPngDataFromGlobal(HGLOBAL global)
 {
 	wil::com_ptr_nothrow<IStream> stream;
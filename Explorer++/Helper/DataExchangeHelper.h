@@ -8,8 +8,11 @@
 #include <gdiplus.h>
 #include <optional>
 #include <string>
+#include <string_view>
 #include <vector>
 
+class CompactPathList;
+
 // Represents a virtual file, for use with CFSTR_FILEDESCRIPTOR.
 struct VirtualFile
 {
@@ -28,6 +31,12 @@ wil::unique_hglobal WriteBinaryDataToGlobal(const std::string &data);
 wil::unique_hglobal WriteDataToGlobal(const void *data, size_t size);
 std::optional<std::vector<std::wstring>> ReadHDropDataFromGlobal(HGLOBAL global);
 wil::unique_hglobal WriteHDropDataToGlobal(const std::vector<std::wstring> &paths);
+wil::unique_hglobal WriteHDropDataToGlobal(const CompactPathList &paths);
+
+// Writes the paths as a single null-terminated string, with each pair of paths separated by the
+// separator. The text is written directly into the allocated memory, without an intermediate copy.
+wil::unique_hglobal WriteJoinedPathsToGlobal(const CompactPathList &paths,
+	std::wstring_view separator);
 std::unique_ptr<Gdiplus::Bitmap> ReadPngDataFromGlobal(HGLOBAL global);
 wil::unique_hglobal WritePngDataToGlobal(Gdiplus::Bitmap *bitmap);
 std::unique_ptr<Gdiplus::Bitmap> ReadDIBDataFromGlobal(HGLOBAL global);
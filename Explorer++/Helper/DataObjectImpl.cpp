@@ -7,6 +7,16 @@
 #include "EnumFormatEtcImpl.h"
 #include <list>
 
+void DataObjectImpl::SetDelayedData(const FORMATETC &format, DataRenderer renderer)
+{
+	CHECK(renderer);
+
+	ItemData itemData;
+	itemData.format = format;
+	itemData.renderer = std::move(renderer);
+	m_items.push_back(std::move(itemData));
+}
+
 // IDataObject
 IFACEMETHODIMP DataObjectImpl::GetData(FORMATETC *format, STGMEDIUM *stg)
 {
@@ -15,11 +25,24 @@ IFACEMETHODIMP DataObjectImpl::GetData(FORMATETC *format, STGMEDIUM *stg)
 		return E_INVALIDARG;
 	}
 
-	for (const auto &item : m_items)
+	for (auto &item : m_items)
 	{
 		if (item.format.cfFormat == format->cfFormat && item.format.tymed & format->tymed
 			&& item.format.dwAspect == format->dwAspect && item.format.lindex == format->lindex)
 		{
+			if (item.renderer)
+			{
+				auto renderedStg = item.renderer();
+
+				if (renderedStg.tymed == TYMED_NULL)
+				{
+					return E_UNEXPECTED;
+				}
+
+				item.stg = std::move(renderedStg);
+				item.renderer = nullptr;
+			}
+
 			auto duplicatedStg = DuplicateStorageMedium(&item.stg, &item.format);
 			*stg = duplicatedStg.release();
 
@@ -7,6 +7,7 @@
 #include "WinRTBaseWrapper.h"
 #include <wil/resource.h>
 #include <shlobj.h>
+#include <functional>
 #include <vector>
 
 class DataObjectImpl :
@@ -14,6 +15,14 @@ class DataObjectImpl :
 		winrt::non_agile>
 {
 public:
+	// Returns the rendered data, or an empty storage medium on failure.
+	using DataRenderer = std::function<wil::unique_stg_medium()>;
+
+	// Advertises the specified format without rendering it. The renderer will be invoked the
+	// first time the data is requested, with the result being cached. If rendering fails, it will
+	// be attempted again the next time the data is requested.
+	void SetDelayedData(const FORMATETC &format, DataRenderer renderer);
+
 	// IDataObject
 	IFACEMETHODIMP GetData(FORMATETC *format, STGMEDIUM *stg);
 	IFACEMETHODIMP GetDataHere(FORMATETC *format, STGMEDIUM *stg);
@@ -37,6 +46,9 @@ private:
 	{
 		FORMATETC format;
 		wil::unique_stg_medium stg;
+
+		// Set if the data hasn't been rendered yet.
+		DataRenderer renderer;
 	};
 
 	wil::unique_stg_medium DuplicateStorageMedium(const STGMEDIUM *stg, const FORMATETC *format);
@@ -4,6 +4,8 @@
 
 #include "stdafx.h"
 #include "DragDropHelper.h"
+#include "CompactPathList.h"
+#include "DataObjectImpl.h"
 #include "DataObjectWrapper.h"
 #include "Helper.h"
 #include "WinRTBaseWrapper.h"
@@ -91,6 +93,54 @@ HRESULT CreateDataObjectForShellTransfer(const std::vector<PCIDLIST_ABSOLUTE> &i
 	return S_OK;
 }
 
+// Returns an IDataObject instance that advertises the requested formats, without rendering them.
+// Each format is only rendered once it's requested, at which point the path list will be waited on
+// (if it's still being built). Since every format is rendered from the same compact list, the paths
+// are only ever stored once, no matter how many formats are requested.
+HRESULT CreateDataObjectForPaths(PendingPathList paths, PathDataFormats formats,
+	IDataObject **dataObjectOut)
+{
+	auto dataObject = winrt::make_self<DataObjectImpl>();
+
+	if (WI_IsFlagSet(formats, PathDataFormats::Text))
+	{
+		FORMATETC ftc = { CF_UNICODETEXT, nullptr, DVASPECT_CONTENT, -1, TYMED_HGLOBAL };
+		dataObject->SetDelayedData(ftc,
+			[paths]()
+			{
+				auto global = WriteJoinedPathsToGlobal(*paths.get(), L"\r\n");
+
+				if (!global)
+				{
+					return wil::unique_stg_medium();
+				}
+
+				return GetStgMediumForGlobal(std::move(global));
+			});
+	}
+
+	if (WI_IsFlagSet(formats, PathDataFormats::HDrop))
+	{
+		FORMATETC ftc = { CF_HDROP, nullptr, DVASPECT_CONTENT, -1, TYMED_HGLOBAL };
+		dataObject->SetDelayedData(ftc,
+			[paths]()
+			{
+				auto global = WriteHDropDataToGlobal(*paths.get());
+
+				if (!global)
+				{
+					return wil::unique_stg_medium();
+				}
+
+				return GetStgMediumForGlobal(std::move(global));
+			});
+	}
+
+	*dataObjectOut = dataObject.as<IDataObject>().detach();
+
+	return S_OK;
+}
+
 HRESULT SetBlobData(IDataObject *dataObject, CLIPFORMAT format, const void *data, size_t size)
 {
 	FORMATETC ftc = { format, nullptr, DVASPECT_CONTENT, -1, TYMED_HGLOBAL };
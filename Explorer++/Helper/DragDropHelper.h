@@ -10,6 +10,23 @@
 #include <wil/result.h>
 #include <ShlObj.h>
 #include <shtypes.h>
+#include <future>
+#include <memory>
+
+enum class PathDataFormats
+{
+	None = 0,
+
+	// The paths as text, one path per line.
+	Text = 1 << 0,
+
+	HDrop = 1 << 1
+};
+
+DEFINE_ENUM_FLAG_OPERATORS(PathDataFormats);
+
+// A list of paths that may still be being built on a background thread.
+using PendingPathList = std::shared_future<std::shared_ptr<const CompactPathList>>;
 
 wil::unique_stg_medium GetStgMediumForGlobal(wil::unique_hglobal global);
 HRESULT SetPreferredDropEffect(IDataObject *dataObject, DWORD effect);
@@ -21,6 +38,8 @@ HRESULT CreateDataObjectForShellTransfer(const std::vector<PidlAbsolute> &items,
 	IDataObject **dataObjectOut);
 HRESULT CreateDataObjectForShellTransfer(const std::vector<PCIDLIST_ABSOLUTE> &items,
 	IDataObject **dataObjectOut);
+HRESULT CreateDataObjectForPaths(PendingPathList paths, PathDataFormats formats,
+	IDataObject **dataObjectOut);
 HRESULT SetBlobData(IDataObject *dataObject, CLIPFORMAT format, const void *data, size_t size);
 HRESULT SetBlobData(IDataObject *dataObject, FORMATETC *ftc, const void *data, size_t size);
 HRESULT GetBlobData(IDataObject *dataObject, CLIPFORMAT format, std::string &outputData);
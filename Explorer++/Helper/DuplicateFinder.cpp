@@ -0,0 +1,315 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "stdafx.h"
+#include "DuplicateFinder.h"
+#include "FileHashCache.h"
+#include "ParallelFor.h"
+#include <algorithm>
+#include <map>
+
+std::vector<DuplicateFinderFile> CollectDuplicateFinderFiles(const std::filesystem::path &root,
+	std::stop_token stopToken)
+{
+	std::vector<DuplicateFinderFile> files;
+	std::error_code error;
+	std::filesystem::recursive_directory_iterator itr(root,
+		std::filesystem::directory_options::skip_permission_denied, error);
+
+	for (; !error && itr != std::filesystem::recursive_directory_iterator();
+		 itr.increment(error))
+	{
+		if (stopToken.stop_requested())
+		{
+			return {};
+		}
+
+		const auto &entry = *itr;
+		std::error_code entryError;
+
+		if (entry.is_symlink(entryError) || !entry.is_regular_file(entryError))
+		{
+			continue;
+		}
+
+		auto size = entry.file_size(entryError);
+
+		if (entryError)
+		{
+			continue;
+		}
+
+		auto lastWriteTime = entry.last_write_time(entryError);
+
+		if (entryError)
+		{
+			continue;
+		}
+
+		files.push_back({ entry.path(), size, lastWriteTime.time_since_epoch().count() });
+	}
+
+	return files;
+}
+
+DuplicateFinder::DuplicateFinder(const Options &options) : m_options(options)
+{
+}
+
+std::optional<std::vector<DuplicateGroup>> DuplicateFinder::Find(
+	std::vector<DuplicateFinderFile> files, std::stop_token stopToken)
+{
+	m_stage = Stage::GroupingBySize;
+	m_numFilesHashed = 0;
+	m_numBytesRead = 0;
+
+	auto sizeGroups = GroupBySize(files);
+
+	m_stage = Stage::HashingPartialContent;
+	auto partialGroups = HashPartialContent(sizeGroups, stopToken);
+
+	if (stopToken.stop_requested())
+	{
+		return std::nullopt;
+	}
+
+	m_stage = Stage::HashingFullContent;
+	auto fullGroups = HashFullContent(std::move(partialGroups), stopToken);
+
+	if (stopToken.stop_requested())
+	{
+		return std::nullopt;
+	}
+
+	std::vector<DuplicateGroup> duplicateGroups;
+
+	for (const auto &group : fullGroups)
+	{
+		DuplicateGroup duplicateGroup;
+		duplicateGroup.size = group[0].file->size;
+		duplicateGroup.hash = group[0].hash;
+
+		for (const auto &candidate : group)
+		{
+			duplicateGroup.paths.push_back(candidate.file->path);
+		}
+
+		std::sort(duplicateGroup.paths.begin(), duplicateGroup.paths.end());
+		duplicateGroups.push_back(std::move(duplicateGroup));
+	}
+
+	std::sort(duplicateGroups.begin(), duplicateGroups.end(),
+		[](const DuplicateGroup &group1, const DuplicateGroup &group2)
+		{
+			uint64_t redundantSize1 = group1.size * (group1.paths.size() - 1);
+			uint64_t redundantSize2 = group2.size * (group2.paths.size() - 1);
+
+			if (redundantSize1 != redundantSize2)
+			{
+				return redundantSize1 > redundantSize2;
+			}
+
+			return group1.paths[0] < group2.paths[0];
+		});
+
+	m_stage = Stage::Finished;
+
+	return duplicateGroups;
+}
+
+std::vector<std::vector<const DuplicateFinderFile *>> DuplicateFinder::GroupBySize(
+	const std::vector<DuplicateFinderFile> &files) const
+{
+	// An ordered map is used so that the groups are produced in a consistent order.
+	std::map<uint64_t, std::vector<const DuplicateFinderFile *>> filesBySize;
+
+	for (const auto &file : files)
+	{
+		if (file.size < m_options.minFileSize)
+		{
+			continue;
+		}
+
+		filesBySize[file.size].push_back(&file);
+	}
+
+	std::vector<std::vector<const DuplicateFinderFile *>> sizeGroups;
+
+	for (auto &[size, group] : filesBySize)
+	{
+		if (group.size() > 1)
+		{
+			sizeGroups.push_back(std::move(group));
+		}
+	}
+
+	return sizeGroups;
+}
+
+std::vector<std::vector<DuplicateFinder::Candidate>> DuplicateFinder::HashPartialContent(
+	const std::vector<std::vector<const DuplicateFinderFile *>> &sizeGroups,
+	std::stop_token stopToken)
+{
+	std::vector<Candidate> candidates;
+	std::vector<size_t> groupIndexes;
+
+	for (size_t i = 0; i < sizeGroups.size(); i++)
+	{
+		for (const auto *file : sizeGroups[i])
+		{
+			candidates.push_back({ file });
+			groupIndexes.push_back(i);
+		}
+	}
+
+	std::vector<bool> succeeded(candidates.size(), false);
+
+	ParallelFor(candidates.size(), m_options.numThreads, stopToken,
+		[this, &candidates, &succeeded, stopToken](size_t index)
+		{
+			auto &candidate = candidates[index];
+			std::optional<std::string> hash;
+
+			// For a file that fits entirely within the partial block, the partial hash would cover
+			// the whole file, so the full hash is calculated immediately, rather than reading the
+			// file a second time later on.
+			if (candidate.file->size <= m_options.partialHashSize)
+			{
+				hash = HashFullContent(*candidate.file, stopToken);
+				candidate.fullyHashed = true;
+			}
+			else
+			{
+				uint64_t numBytesRead = 0;
+				hash = HashFile(candidate.file->path, HashAlgorithm::XxHash64, stopToken,
+					m_options.partialHashSize, &numBytesRead);
+				AddBytesRead(numBytesRead);
+			}
+
+			m_numFilesHashed++;
+
+			if (hash)
+			{
+				candidate.hash = std::move(*hash);
+				succeeded[index] = true;
+			}
+		});
+
+	std::vector<std::vector<Candidate>> partialGroups;
+	size_t candidateIndex = 0;
+
+	for (size_t i = 0; i < sizeGroups.size(); i++)
+	{
+		std::map<std::string, std::vector<Candidate>> candidatesByHash;
+
+		for (; candidateIndex < candidates.size() && groupIndexes[candidateIndex] == i;
+			 candidateIndex++)
+		{
+			if (succeeded[candidateIndex])
+			{
+				auto &candidate = candidates[candidateIndex];
+				candidatesByHash[candidate.hash].push_back(std::move(candidate));
+			}
+		}
+
+		for (auto &[hash, group] : candidatesByHash)
+		{
+			if (group.size() > 1)
+			{
+				partialGroups.push_back(std::move(group));
+			}
+		}
+	}
+
+	return partialGroups;
+}
+
+std::vector<std::vector<DuplicateFinder::Candidate>> DuplicateFinder::HashFullContent(
+	std::vector<std::vector<Candidate>> partialGroups, std::stop_token stopToken)
+{
+	std::vector<Candidate *> pendingCandidates;
+
+	for (auto &group : partialGroups)
+	{
+		for (auto &candidate : group)
+		{
+			if (!candidate.fullyHashed)
+			{
+				pendingCandidates.push_back(&candidate);
+			}
+		}
+	}
+
+	// Starting with the largest files means that the threads are less likely to be left waiting
+	// on a single large file at the end.
+	std::stable_sort(pendingCandidates.begin(), pendingCandidates.end(),
+		[](const Candidate *candidate1, const Candidate *candidate2)
+		{ return candidate1->file->size > candidate2->file->size; });
+
+	ParallelFor(pendingCandidates.size(), m_options.numThreads, stopToken,
+		[this, &pendingCandidates, stopToken](size_t index)
+		{
+			auto *candidate = pendingCandidates[index];
+			auto hash = HashFullContent(*candidate->file, stopToken);
+			m_numFilesHashed++;
+
+			if (hash)
+			{
+				candidate->hash = std::move(*hash);
+				candidate->fullyHashed = true;
+			}
+			else
+			{
+				candidate->hash.clear();
+			}
+		});
+
+	std::vector<std::vector<Candidate>> fullGroups;
+
+	for (auto &group : partialGroups)
+	{
+		std::map<std::string, std::vector<Candidate>> candidatesByHash;
+
+		for (auto &candidate : group)
+		{
+			if (candidate.fullyHashed)
+			{
+				candidatesByHash[candidate.hash].push_back(std::move(candidate));
+			}
+		}
+
+		for (auto &[hash, fullGroup] : candidatesByHash)
+		{
+			if (fullGroup.size() > 1)
+			{
+				fullGroups.push_back(std::move(fullGroup));
+			}
+		}
+	}
+
+	return fullGroups;
+}
+
+std::optional<std::string> DuplicateFinder::HashFullContent(const DuplicateFinderFile &file,
+	std::stop_token stopToken)
+{
+	FileHashKey key = { file.path.wstring(), m_options.fullHashAlgorithm, file.size,
+		file.lastWriteTime };
+
+	uint64_t numBytesRead = 0;
+	auto hash = HashFileWithCache(m_options.cache, key, stopToken, &numBytesRead);
+	AddBytesRead(numBytesRead);
+
+	return hash;
+}
+
+void DuplicateFinder::AddBytesRead(uint64_t numBytesRead)
+{
+	m_numBytesRead += numBytesRead;
+}
+
+DuplicateFinder::Progress DuplicateFinder::GetProgress() const
+{
+	return { m_stage, m_numFilesHashed, m_numBytesRead };
+}
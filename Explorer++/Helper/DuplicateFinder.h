@@ -0,0 +1,119 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#pragma once
+
+#include "ContentHash.h"
+#include <boost/core/noncopyable.hpp>
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <stop_token>
+#include <string>
+#include <vector>
+
+class FileHashCache;
+
+struct DuplicateFinderFile
+{
+	std::filesystem::path path;
+	uint64_t size;
+
+	// Only used to look up and store hashes in the cache, so any value that changes whenever the
+	// file is modified will work.
+	int64_t lastWriteTime;
+};
+
+// A set of files that all have the same content.
+struct DuplicateGroup
+{
+	uint64_t size;
+	std::string hash;
+	std::vector<std::filesystem::path> paths;
+};
+
+// Finds the files below the specified folder. Symbolic links (and other reparse points) aren't
+// followed and folders that can't be read are skipped.
+std::vector<DuplicateFinderFile> CollectDuplicateFinderFiles(const std::filesystem::path &root,
+	std::stop_token stopToken);
+
+// Finds groups of files with identical content. Since reading files is by far the most expensive
+// part of the process, candidates are eliminated in stages, with each stage only reading the files
+// that remain:
+//
+// 1. Files are grouped by size. A file with a unique size can't have a duplicate.
+// 2. The remaining files have the first block of their content hashed. Files that differ will
+//    usually do so near the start (e.g. because of differing headers).
+// 3. Files that still match have their full content hashed.
+//
+// The hashing in the last two stages is spread across multiple threads.
+class DuplicateFinder : private boost::noncopyable
+{
+public:
+	enum class Stage
+	{
+		GroupingBySize,
+		HashingPartialContent,
+		HashingFullContent,
+		Finished
+	};
+
+	struct Options
+	{
+		int numThreads = 1;
+
+		// Files smaller than this are ignored. By default, that excludes empty files, which are
+		// all trivially identical.
+		uint64_t minFileSize = 1;
+
+		size_t partialHashSize = 64 * 1024;
+		HashAlgorithm fullHashAlgorithm = HashAlgorithm::Sha256;
+
+		// If set, full hashes are retrieved from, and stored in, this cache.
+		FileHashCache *cache = nullptr;
+	};
+
+	struct Progress
+	{
+		Stage stage;
+		size_t numFilesHashed;
+		uint64_t numBytesRead;
+	};
+
+	explicit DuplicateFinder(const Options &options);
+
+	// Returns the groups of duplicate files, ordered so that the groups taking up the most
+	// redundant space come first. Files that can't be read are left out. Returns an empty value
+	// if a stop is requested.
+	std::optional<std::vector<DuplicateGroup>> Find(std::vector<DuplicateFinderFile> files,
+		std::stop_token stopToken);
+
+	// Can be called from any thread while Find() is running.
+	Progress GetProgress() const;
+
+private:
+	struct Candidate
+	{
+		const DuplicateFinderFile *file;
+		std::string hash;
+		bool fullyHashed = false;
+	};
+
+	std::vector<std::vector<const DuplicateFinderFile *>> GroupBySize(
+		const std::vector<DuplicateFinderFile> &files) const;
+	std::vector<std::vector<Candidate>> HashPartialContent(
+		const std::vector<std::vector<const DuplicateFinderFile *>> &sizeGroups,
+		std::stop_token stopToken);
+	std::vector<std::vector<Candidate>> HashFullContent(
+		std::vector<std::vector<Candidate>> partialGroups, std::stop_token stopToken);
+	std::optional<std::string> HashFullContent(const DuplicateFinderFile &file,
+		std::stop_token stopToken);
+	void AddBytesRead(uint64_t numBytesRead);
+
+	const Options m_options;
+	std::atomic<Stage> m_stage = Stage::GroupingBySize;
+	std::atomic<size_t> m_numFilesHashed = 0;
+	std::atomic<uint64_t> m_numBytesRead = 0;
+};
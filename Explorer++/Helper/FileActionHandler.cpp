@@ -10,6 +10,8 @@
 #include "stdafx.h"
 #include "FileActionHandler.h"
 #include "FileOperations.h"
+#include "Win32FileMetadataStore.h"
+#include <thread>
 
 BOOL FileActionHandler::RenameFiles(const RenamedItems_t &itemList)
 {
@@ -72,6 +74,19 @@ HRESULT FileActionHandler::DeleteFiles(HWND hwnd, const DeletedItems_t &deletedI
 	return hr;
 }
 
+void FileActionHandler::AddMetadataChange(std::vector<FileMetadataJournalEntry> journal)
+{
+	if (journal.empty())
+	{
+		return;
+	}
+
+	UndoItem_t undoItem;
+	undoItem.type = UndoType::MetadataChanged;
+	undoItem.metadataJournal = std::move(journal);
+	m_stackFileActions.push(std::move(undoItem));
+}
+
 void FileActionHandler::Undo()
 {
 	if (!m_stackFileActions.empty())
@@ -93,6 +108,10 @@ void FileActionHandler::Undo()
 		case UndoType::Deleted:
 			UndoDeleteOperation(undoItem.deletedItems);
 			break;
+
+		case UndoType::MetadataChanged:
+			UndoMetadataChange(undoItem.metadataJournal);
+			break;
 		}
 
 		m_stackFileActions.pop();
@@ -128,6 +147,19 @@ void FileActionHandler::UndoDeleteOperation(const DeletedItems_t &deletedItemLis
 	 - Push delete action onto stack. */
 }
 
+void FileActionHandler::UndoMetadataChange(const std::vector<FileMetadataJournalEntry> &journal)
+{
+	/* Restoring the metadata only involves setting attributes and
+	timestamps (no file contents are touched), so this is quick
+	enough to do synchronously, even for a large journal. Any
+	items that can't be restored (e.g. because they've since been
+	deleted) are skipped. */
+	Win32FileMetadataStore store;
+	FileMetadataEditor editor(&store,
+		{ .numThreads = static_cast<int>(std::max(std::thread::hardware_concurrency(), 1u)) });
+	editor.Restore(journal, {});
+}
+
 BOOL FileActionHandler::CanUndo() const
 {
 	return !m_stackFileActions.empty();
@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include "FileMetadataEditor.h"
 #include <list>
 #include <stack>
 #include <vector>
@@ -23,6 +24,11 @@ public:
 	BOOL RenameFiles(const RenamedItems_t &itemList);
 	HRESULT DeleteFiles(HWND hwnd, const DeletedItems_t &deletedItems, bool permanent, bool silent);
 
+	// The attributes and timestamps of files are changed in the background (by
+	// FileMetadataEditor), so this method doesn't perform the change itself. It simply records the
+	// journal from the change, so that the change can be undone.
+	void AddMetadataChange(std::vector<FileMetadataJournalEntry> journal);
+
 	void Undo();
 	BOOL CanUndo() const;
 
@@ -32,7 +38,8 @@ private:
 		Renamed,
 		Copied,
 		Moved,
-		Deleted
+		Deleted,
+		MetadataChanged
 	};
 
 	struct UndoItem_t
@@ -41,10 +48,12 @@ private:
 
 		RenamedItems_t renamedItems;
 		DeletedItems_t deletedItems;
+		std::vector<FileMetadataJournalEntry> metadataJournal;
 	};
 
 	void UndoRenameOperation(const RenamedItems_t &renamedItemList);
 	void UndoDeleteOperation(const DeletedItems_t &deletedItemList);
+	void UndoMetadataChange(const std::vector<FileMetadataJournalEntry> &journal);
 
 	std::stack<UndoItem_t> m_stackFileActions;
 };
@@ -0,0 +1,99 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "stdafx.h"
+#include "FileHashCache.h"
+#include <algorithm>
+#include <functional>
+
+FileHashCache::FileHashCache(size_t capacity) : m_capacity(std::max(capacity, size_t{ 1 }))
+{
+}
+
+std::optional<std::string> FileHashCache::Get(const FileHashKey &key)
+{
+	std::scoped_lock lock(m_mutex);
+
+	auto itr = m_entryMap.find({ key.path, key.algorithm });
+
+	if (itr == m_entryMap.end())
+	{
+		return std::nullopt;
+	}
+
+	auto entryItr = itr->second;
+
+	if (entryItr->size != key.size || entryItr->lastWriteTime != key.lastWriteTime)
+	{
+		// The file has changed since the hash was stored, so the entry can't be used again.
+		m_entryMap.erase(itr);
+		m_entries.erase(entryItr);
+		return std::nullopt;
+	}
+
+	m_entries.splice(m_entries.begin(), m_entries, entryItr);
+
+	return entryItr->hash;
+}
+
+void FileHashCache::Put(const FileHashKey &key, const std::string &hash)
+{
+	std::scoped_lock lock(m_mutex);
+
+	EntryKey entryKey = { key.path, key.algorithm };
+	auto itr = m_entryMap.find(entryKey);
+
+	if (itr != m_entryMap.end())
+	{
+		auto entryItr = itr->second;
+		entryItr->size = key.size;
+		entryItr->lastWriteTime = key.lastWriteTime;
+		entryItr->hash = hash;
+		m_entries.splice(m_entries.begin(), m_entries, entryItr);
+		return;
+	}
+
+	if (m_entries.size() >= m_capacity)
+	{
+		m_entryMap.erase(m_entries.back().key);
+		m_entries.pop_back();
+	}
+
+	m_entries.push_front({ entryKey, key.size, key.lastWriteTime, hash });
+	m_entryMap.emplace(std::move(entryKey), m_entries.begin());
+}
+
+size_t FileHashCache::GetSize() const
+{
+	std::scoped_lock lock(m_mutex);
+	return m_entries.size();
+}
+
+size_t FileHashCache::EntryKeyHash::operator()(const EntryKey &key) const
+{
+	return std::hash<std::wstring>{}(key.path) ^ (static_cast<size_t>(key.algorithm) << 1);
+}
+
+std::optional<std::string> HashFileWithCache(FileHashCache *cache, const FileHashKey &key,
+	std::stop_token stopToken, uint64_t *bytesRead)
+{
+	if (cache)
+	{
+		auto cachedHash = cache->Get(key);
+
+		if (cachedHash)
+		{
+			return cachedHash;
+		}
+	}
+
+	auto hash = HashFile(key.path, key.algorithm, stopToken, std::nullopt, bytesRead);
+
+	if (hash && cache)
+	{
+		cache->Put(key, *hash);
+	}
+
+	return hash;
+}
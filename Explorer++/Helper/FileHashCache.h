@@ -0,0 +1,82 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#pragma once
+
+#include "ContentHash.h"
+#include <boost/core/noncopyable.hpp>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <stop_token>
+#include <string>
+#include <unordered_map>
+
+// Identifies the content of a file at a particular point in time. The size and last write time are
+// used to detect when a file has changed, in which case any hash stored for the previous content
+// is no longer valid.
+struct FileHashKey
+{
+	std::wstring path;
+	HashAlgorithm algorithm;
+	uint64_t size;
+	int64_t lastWriteTime;
+};
+
+// Caches file hashes, so that files don't have to be re-read each time their hash is needed (e.g.
+// when returning to a folder that's previously been viewed). The cache holds a fixed number of
+// entries, with the least recently used entry being evicted once that number is reached.
+//
+// This class is thread-safe.
+class FileHashCache : private boost::noncopyable
+{
+public:
+	static constexpr size_t DEFAULT_CAPACITY = 65536;
+
+	explicit FileHashCache(size_t capacity = DEFAULT_CAPACITY);
+
+	// Returns the stored hash, provided the file's size and last write time match those recorded
+	// when the hash was stored.
+	std::optional<std::string> Get(const FileHashKey &key);
+	void Put(const FileHashKey &key, const std::string &hash);
+
+	size_t GetSize() const;
+
+private:
+	struct EntryKey
+	{
+		std::wstring path;
+		HashAlgorithm algorithm;
+
+		bool operator==(const EntryKey &) const = default;
+	};
+
+	struct EntryKeyHash
+	{
+		size_t operator()(const EntryKey &key) const;
+	};
+
+	struct Entry
+	{
+		EntryKey key;
+		uint64_t size;
+		int64_t lastWriteTime;
+		std::string hash;
+	};
+
+	using EntryList = std::list<Entry>;
+
+	const size_t m_capacity;
+	mutable std::mutex m_mutex;
+
+	// Ordered from most to least recently used.
+	EntryList m_entries;
+	std::unordered_map<EntryKey, EntryList::iterator, EntryKeyHash> m_entryMap;
+};
+
+// Returns the hash of the file identified by the key. If a cache is provided, it's checked first,
+// with the file only being read if no valid hash is stored. A newly calculated hash is then added
+// to the cache. The bytesRead parameter is treated in the same way as in HashFile().
+std::optional<std::string> HashFileWithCache(FileHashCache *cache, const FileHashKey &key,
+	std::stop_token stopToken, uint64_t *bytesRead = nullptr);
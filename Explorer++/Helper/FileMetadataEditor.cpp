@@ -0,0 +1,188 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "stdafx.h"
+#include "FileMetadataEditor.h"
+#include "ParallelFor.h"
+#include "Tracing.h"
+
+FileMetadata ApplyFileMetadataChanges(const FileMetadata &metadata,
+	const FileMetadataChanges &changes)
+{
+	FileMetadata updatedMetadata = metadata;
+	updatedMetadata.attributes =
+		(metadata.attributes & ~changes.attributesToClear) | changes.attributesToSet;
+
+	// A timestamp is only updated if the store supports it (as indicated by the existing metadata
+	// containing a value for it).
+	auto applyTime = [](auto &time, const auto &newTime)
+	{
+		if (time && newTime)
+		{
+			time = newTime;
+		}
+	};
+
+	applyTime(updatedMetadata.creationTime, changes.creationTime);
+	applyTime(updatedMetadata.lastAccessTime, changes.lastAccessTime);
+	applyTime(updatedMetadata.lastWriteTime, changes.lastWriteTime);
+
+	return updatedMetadata;
+}
+
+FileMetadataEditor::FileMetadataEditor(FileMetadataStore *store, const Options &options) :
+	m_store(store),
+	m_options(options)
+{
+}
+
+FileMetadataEditResult FileMetadataEditor::Apply(const std::vector<std::filesystem::path> &paths,
+	const FileMetadataChanges &changes, std::stop_token stopToken)
+{
+	auto expandedPaths = m_options.recursive ? ExpandPaths(paths, stopToken) : paths;
+
+	if (stopToken.stop_requested())
+	{
+		return { .stopped = true };
+	}
+
+	return Process(
+		expandedPaths, [&changes](size_t, const FileMetadata &currentMetadata)
+		{
+			return ApplyFileMetadataChanges(currentMetadata, changes);
+		},
+		stopToken);
+}
+
+FileMetadataEditResult FileMetadataEditor::Restore(
+	const std::vector<FileMetadataJournalEntry> &journal, std::stop_token stopToken)
+{
+	std::vector<std::filesystem::path> paths;
+	paths.reserve(journal.size());
+
+	for (const auto &entry : journal)
+	{
+		paths.push_back(entry.path);
+	}
+
+	return Process(
+		paths, [&journal](size_t index, const FileMetadata &)
+		{
+			return journal[index].previousMetadata;
+		},
+		stopToken);
+}
+
+std::vector<std::filesystem::path> FileMetadataEditor::ExpandPaths(
+	const std::vector<std::filesystem::path> &paths, std::stop_token stopToken) const
+{
+	std::vector<std::filesystem::path> expandedPaths;
+
+	for (const auto &path : paths)
+	{
+		expandedPaths.push_back(path);
+
+		std::error_code error;
+
+		if (!std::filesystem::is_directory(std::filesystem::symlink_status(path, error)))
+		{
+			continue;
+		}
+
+		std::filesystem::recursive_directory_iterator itr(path,
+			std::filesystem::directory_options::skip_permission_denied, error);
+
+		if (error)
+		{
+			continue;
+		}
+
+		for (; itr != std::filesystem::recursive_directory_iterator(); itr.increment(error))
+		{
+			if (error || stopToken.stop_requested())
+			{
+				break;
+			}
+
+			expandedPaths.push_back(itr->path());
+		}
+	}
+
+	return expandedPaths;
+}
+
+template <typename GetNewMetadata>
+FileMetadataEditResult FileMetadataEditor::Process(const std::vector<std::filesystem::path> &paths,
+	GetNewMetadata getNewMetadata, std::stop_token stopToken)
+{
+	TraceScope traceScope("file_operations", "FileMetadataEditor::Process");
+	traceScope.SetArg("items", static_cast<int64_t>(paths.size()));
+
+	m_numItemsProcessed = 0;
+	m_numItems = paths.size();
+
+	// Each item has its own slot, which means that the threads don't need to synchronize when
+	// storing results, and that the results end up in the same order as the items.
+	std::vector<std::optional<FileMetadataJournalEntry>> journalSlots(paths.size());
+	std::vector<std::optional<FileMetadataFailure>> failureSlots(paths.size());
+
+	ParallelFor(paths.size(), m_options.numThreads, stopToken,
+		[this, &paths, &getNewMetadata, &journalSlots, &failureSlots](size_t index)
+		{
+			const auto &path = paths[index];
+			std::error_code error;
+			auto currentMetadata = m_store->GetMetadata(path, error);
+
+			if (!currentMetadata)
+			{
+				failureSlots[index] = FileMetadataFailure{ path, error };
+				m_numItemsProcessed++;
+				return;
+			}
+
+			auto newMetadata = getNewMetadata(index, *currentMetadata);
+
+			if (newMetadata != *currentMetadata)
+			{
+				// The previous metadata is recorded even if the change fails, since the change may
+				// have been partially applied.
+				journalSlots[index] = FileMetadataJournalEntry{ path, *currentMetadata };
+
+				error = m_store->SetMetadata(path, newMetadata);
+
+				if (error)
+				{
+					failureSlots[index] = FileMetadataFailure{ path, error };
+				}
+			}
+
+			m_numItemsProcessed++;
+		});
+
+	FileMetadataEditResult result;
+	result.stopped = m_numItemsProcessed < paths.size();
+
+	for (auto &entry : journalSlots)
+	{
+		if (entry)
+		{
+			result.journal.push_back(std::move(*entry));
+		}
+	}
+
+	for (auto &failure : failureSlots)
+	{
+		if (failure)
+		{
+			result.failures.push_back(std::move(*failure));
+		}
+	}
+
+	return result;
+}
+
+FileMetadataEditor::Progress FileMetadataEditor::GetProgress() const
+{
+	return { m_numItemsProcessed, m_numItems };
+}
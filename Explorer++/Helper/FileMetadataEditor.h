@@ -0,0 +1,107 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#pragma once
+
+#include "FileMetadataStore.h"
+#include <boost/core/noncopyable.hpp>
+#include <atomic>
+#include <filesystem>
+#include <optional>
+#include <stop_token>
+#include <system_error>
+#include <vector>
+
+// Describes a change to the metadata of a set of items. Attributes that are in neither mask keep
+// their existing value on each item.
+struct FileMetadataChanges
+{
+	uint32_t attributesToSet = 0;
+	uint32_t attributesToClear = 0;
+
+	std::optional<std::filesystem::file_time_type> creationTime;
+	std::optional<std::filesystem::file_time_type> lastAccessTime;
+	std::optional<std::filesystem::file_time_type> lastWriteTime;
+};
+
+FileMetadata ApplyFileMetadataChanges(const FileMetadata &metadata,
+	const FileMetadataChanges &changes);
+
+// Records the metadata an item had before it was changed, so that the change can be undone.
+struct FileMetadataJournalEntry
+{
+	std::filesystem::path path;
+	FileMetadata previousMetadata;
+};
+
+struct FileMetadataFailure
+{
+	std::filesystem::path path;
+	std::error_code error;
+};
+
+struct FileMetadataEditResult
+{
+	// Ordered in the same way as the items that were processed.
+	std::vector<FileMetadataJournalEntry> journal;
+	std::vector<FileMetadataFailure> failures;
+
+	// True if a stop was requested before every item had been processed. The journal still covers
+	// the items that were changed.
+	bool stopped = false;
+};
+
+// Changes the attributes and timestamps of a potentially large number of items. The items are
+// processed on multiple threads. A failure to change one item is recorded, but doesn't stop the
+// remaining items from being processed.
+class FileMetadataEditor : private boost::noncopyable
+{
+public:
+	struct Options
+	{
+		int numThreads = 1;
+
+		// If set, the contents of any folders are changed as well (recursively). Symbolic links
+		// aren't followed and folders that can't be read are skipped.
+		bool recursive = false;
+	};
+
+	struct Progress
+	{
+		size_t numItemsProcessed;
+
+		// Zero until the full list of items is known (which, when recursing, requires every
+		// folder to be enumerated).
+		size_t numItems;
+	};
+
+	FileMetadataEditor(FileMetadataStore *store, const Options &options);
+
+	// Applies the changes to each of the items. Items that wouldn't be affected by the changes are
+	// left alone and aren't included in the journal.
+	FileMetadataEditResult Apply(const std::vector<std::filesystem::path> &paths,
+		const FileMetadataChanges &changes, std::stop_token stopToken);
+
+	// Restores the metadata recorded in the journal. The journal in the result can, in turn, be
+	// used to reverse the restore. The recursive option is ignored here, since the journal already
+	// contains every item that was changed.
+	FileMetadataEditResult Restore(const std::vector<FileMetadataJournalEntry> &journal,
+		std::stop_token stopToken);
+
+	// Can be called from any thread while Apply() or Restore() is running.
+	Progress GetProgress() const;
+
+private:
+	std::vector<std::filesystem::path> ExpandPaths(const std::vector<std::filesystem::path> &paths,
+		std::stop_token stopToken) const;
+
+	template <typename GetNewMetadata>
+	FileMetadataEditResult Process(const std::vector<std::filesystem::path> &paths,
+		GetNewMetadata getNewMetadata, std::stop_token stopToken);
+
+	FileMetadataStore *const m_store;
+	const Options m_options;
+	std::atomic<size_t> m_numItemsProcessed = 0;
+	std::atomic<size_t> m_numItems = 0;
+};
@@ -0,0 +1,80 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "stdafx.h"
+#include "FileMetadataStore.h"
+
+namespace
+{
+
+constexpr auto WRITE_PERMISSIONS = std::filesystem::perms::owner_write
+	| std::filesystem::perms::group_write | std::filesystem::perms::others_write;
+
+}
+
+std::optional<FileMetadata> StdFileMetadataStore::GetMetadata(const std::filesystem::path &path,
+	std::error_code &error)
+{
+	auto status = std::filesystem::status(path, error);
+
+	if (error)
+	{
+		return std::nullopt;
+	}
+
+	FileMetadata metadata;
+
+	if (std::filesystem::is_directory(status))
+	{
+		metadata.attributes |= FileMetadataAttribute::DIRECTORY;
+	}
+
+	// This mirrors the way the read-only attribute is mapped to permissions on Windows.
+	if ((status.permissions() & std::filesystem::perms::owner_write)
+		== std::filesystem::perms::none)
+	{
+		metadata.attributes |= FileMetadataAttribute::READ_ONLY;
+	}
+
+	metadata.lastWriteTime = std::filesystem::last_write_time(path, error);
+
+	if (error)
+	{
+		return std::nullopt;
+	}
+
+	return metadata;
+}
+
+std::error_code StdFileMetadataStore::SetMetadata(const std::filesystem::path &path,
+	const FileMetadata &metadata)
+{
+	std::error_code error;
+
+	// The timestamp is set first, since a read-only item may not allow it to be changed.
+	if (metadata.lastWriteTime)
+	{
+		std::filesystem::last_write_time(path, *metadata.lastWriteTime, error);
+
+		if (error)
+		{
+			return error;
+		}
+	}
+
+	bool readOnly = (metadata.attributes & FileMetadataAttribute::READ_ONLY) != 0;
+
+	if (readOnly)
+	{
+		std::filesystem::permissions(path, WRITE_PERMISSIONS,
+			std::filesystem::perm_options::remove, error);
+	}
+	else
+	{
+		std::filesystem::permissions(path, std::filesystem::perms::owner_write,
+			std::filesystem::perm_options::add, error);
+	}
+
+	return error;
+}
@@ -0,0 +1,65 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <system_error>
+
+// The values here match the corresponding FILE_ATTRIBUTE_* values, which allows these to be used
+// on platforms where those constants aren't defined.
+namespace FileMetadataAttribute
+{
+
+inline constexpr uint32_t READ_ONLY = 0x1;
+inline constexpr uint32_t HIDDEN = 0x2;
+inline constexpr uint32_t SYSTEM = 0x4;
+inline constexpr uint32_t DIRECTORY = 0x10;
+inline constexpr uint32_t ARCHIVE = 0x20;
+inline constexpr uint32_t NOT_CONTENT_INDEXED = 0x2000;
+
+}
+
+struct FileMetadata
+{
+	// A combination of the FileMetadataAttribute values (along with any other FILE_ATTRIBUTE_*
+	// values on Windows).
+	uint32_t attributes = 0;
+
+	// Not every store supports every timestamp. Any timestamp that isn't supported is left empty.
+	std::optional<std::filesystem::file_time_type> creationTime;
+	std::optional<std::filesystem::file_time_type> lastAccessTime;
+	std::optional<std::filesystem::file_time_type> lastWriteTime;
+
+	bool operator==(const FileMetadata &) const = default;
+};
+
+// Reads and writes the attributes and timestamps of files and folders.
+class FileMetadataStore
+{
+public:
+	virtual ~FileMetadataStore() = default;
+
+	virtual std::optional<FileMetadata> GetMetadata(const std::filesystem::path &path,
+		std::error_code &error) = 0;
+
+	// Sets the attributes of the item, along with any timestamps that have a value. Attributes that
+	// can't be changed (e.g. FileMetadataAttribute::DIRECTORY) are ignored.
+	virtual std::error_code SetMetadata(const std::filesystem::path &path,
+		const FileMetadata &metadata) = 0;
+};
+
+// A store that's implemented using std::filesystem, so that it can be used on any platform. Only
+// the read-only attribute and last write time are supported. On Windows, Win32FileMetadataStore
+// should be used instead, since it supports everything.
+class StdFileMetadataStore : public FileMetadataStore
+{
+public:
+	std::optional<FileMetadata> GetMetadata(const std::filesystem::path &path,
+		std::error_code &error) override;
+	std::error_code SetMetadata(const std::filesystem::path &path,
+		const FileMetadata &metadata) override;
+};
@@ -0,0 +1,1145 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "stdafx.h"
+#include "FileNameIndex.h"
+#include "ParallelFor.h"
+#include <algorithm>
+#include <cstring>
+#include <cwctype>
+#include <filesystem>
+#include <numeric>
+#include <regex>
+
+struct FileNameIndex::Header
+{
+	uint32_t magic;
+	uint32_t version;
+	uint32_t charSize;
+	uint32_t restartInterval;
+	uint64_t numItems;
+	uint64_t numRoots;
+	uint64_t numRestarts;
+	uint64_t numNameChars;
+	uint64_t recordsOffset;
+	uint64_t rootsOffset;
+	uint64_t restartsOffset;
+	uint64_t namesOffset;
+};
+
+struct FileNameIndex::Record
+{
+	uint32_t parent;
+	uint32_t attributes;
+
+	// Set to FOLDER_SIZE for folders.
+	uint64_t size;
+
+	int64_t lastWriteTime;
+};
+
+namespace
+{
+
+constexpr uint32_t INDEX_MAGIC = 0x58494E46; // "FNIX"
+constexpr uint32_t INDEX_VERSION = 1;
+
+// A restart point is stored every this many items. At a restart point, the full name is stored,
+// rather than just the characters that differ from the previous name.
+constexpr uint32_t RESTART_INTERVAL = 16;
+
+constexpr uint64_t FOLDER_SIZE = UINT64_MAX;
+
+// Each section of the serialized data starts on a multiple of this.
+constexpr size_t SECTION_ALIGNMENT = 8;
+
+// Both lengths stored for each name (the length of the prefix shared with the previous name and
+// the length of the rest of the name) are stored as a single character. That's enough for any
+// name that can appear in a path.
+constexpr size_t MAX_NAME_LENGTH = (sizeof(wchar_t) == 2) ? 0xFFFF : 0xFFFFFFFF;
+
+wchar_t FoldChar(wchar_t c)
+{
+	if (c < 0x80)
+	{
+		return (c >= L'a' && c <= L'z') ? static_cast<wchar_t>(c - L'a' + L'A') : c;
+	}
+
+	return static_cast<wchar_t>(std::towupper(c));
+}
+
+std::wstring FoldName(std::wstring_view name)
+{
+	std::wstring foldedName(name.size(), L'\0');
+	std::transform(name.begin(), name.end(), foldedName.begin(), FoldChar);
+	return foldedName;
+}
+
+bool IsPathSeparator(wchar_t c)
+{
+	return c == L'/' || c == L'\\';
+}
+
+size_t AlignSectionOffset(size_t offset)
+{
+	return (offset + SECTION_ALIGNMENT - 1) / SECTION_ALIGNMENT * SECTION_ALIGNMENT;
+}
+
+// The data pointer for an empty vector can be null and passing a null pointer to std::memcpy is
+// undefined, even if no bytes are copied. So empty sections are skipped.
+template <typename T>
+void WriteSection(std::vector<std::byte> &data, size_t offset, const std::vector<T> &section)
+{
+	if (section.empty())
+	{
+		return;
+	}
+
+	std::memcpy(data.data() + offset, section.data(), section.size() * sizeof(T));
+}
+
+// Decodes the names of the items in [begin, end), passing each one (along with its folded form) to
+// the callback. begin has to be a restart point. The callback can return false to stop decoding.
+template <typename Callback>
+void DecodeNames(const wchar_t *names, const uint32_t *restarts, uint32_t begin, uint32_t end,
+	Callback callback)
+{
+	if (begin >= end)
+	{
+		return;
+	}
+
+	const wchar_t *current = names + restarts[begin / RESTART_INTERVAL];
+	std::wstring name;
+	std::wstring foldedName;
+
+	for (uint32_t id = begin; id < end; id++)
+	{
+		size_t sharedLength = static_cast<size_t>(current[0]);
+		size_t suffixLength = static_cast<size_t>(current[1]);
+		current += 2;
+
+		if (id % RESTART_INTERVAL == 0)
+		{
+			sharedLength = 0;
+		}
+
+		name.resize(sharedLength);
+		name.append(current, suffixLength);
+
+		foldedName.resize(sharedLength);
+
+		for (size_t i = 0; i < suffixLength; i++)
+		{
+			foldedName.push_back(FoldChar(current[i]));
+		}
+
+		current += suffixLength;
+
+		if (!callback(id, std::wstring_view(name), std::wstring_view(foldedName)))
+		{
+			return;
+		}
+	}
+}
+
+bool MatchWildcard(std::wstring_view pattern, std::wstring_view text)
+{
+	size_t patternIndex = 0;
+	size_t textIndex = 0;
+	std::optional<size_t> starPatternIndex;
+	size_t starTextIndex = 0;
+
+	while (textIndex < text.size())
+	{
+		if (patternIndex < pattern.size()
+			&& (pattern[patternIndex] == L'?' || pattern[patternIndex] == text[textIndex]))
+		{
+			patternIndex++;
+			textIndex++;
+		}
+		else if (patternIndex < pattern.size() && pattern[patternIndex] == L'*')
+		{
+			starPatternIndex = patternIndex++;
+			starTextIndex = textIndex;
+		}
+		else if (starPatternIndex)
+		{
+			// Let the last star consume one more character and try again from there.
+			patternIndex = *starPatternIndex + 1;
+			textIndex = ++starTextIndex;
+		}
+		else
+		{
+			return false;
+		}
+	}
+
+	while (patternIndex < pattern.size() && pattern[patternIndex] == L'*')
+	{
+		patternIndex++;
+	}
+
+	return patternIndex == pattern.size();
+}
+
+std::wstring_view TrimBlanks(std::wstring_view text)
+{
+	size_t start = text.find_first_not_of(L' ');
+
+	if (start == std::wstring_view::npos)
+	{
+		return {};
+	}
+
+	size_t end = text.find_last_not_of(L' ');
+	return text.substr(start, end - start + 1);
+}
+
+bool MatchesFilters(bool isFolder, uint32_t attributes, uint64_t size, int64_t lastWriteTime,
+	const FileNameQuery &query)
+{
+	if ((query.itemTypes == FileNameItemTypes::Files && isFolder)
+		|| (query.itemTypes == FileNameItemTypes::Folders && !isFolder))
+	{
+		return false;
+	}
+
+	if ((attributes & query.requiredAttributes) != query.requiredAttributes)
+	{
+		return false;
+	}
+
+	if ((query.minSize && size < *query.minSize) || (query.maxSize && size > *query.maxSize))
+	{
+		return false;
+	}
+
+	if ((query.modifiedAfter && lastWriteTime < *query.modifiedAfter)
+		|| (query.modifiedBefore && lastWriteTime > *query.modifiedBefore))
+	{
+		return false;
+	}
+
+	return true;
+}
+
+}
+
+class FileNameIndex::NameMatcher
+{
+public:
+	explicit NameMatcher(const FileNameQuery &query) :
+		m_matchType(query.matchType),
+		m_caseSensitive(query.caseSensitive)
+	{
+		switch (m_matchType)
+		{
+		case FileNameMatchType::Substring:
+			m_patterns.push_back(m_caseSensitive ? query.pattern : FoldName(query.pattern));
+			break;
+
+		case FileNameMatchType::Wildcard:
+		{
+			std::wstring_view remaining = query.pattern;
+
+			while (true)
+			{
+				size_t separator = remaining.find(L':');
+				auto pattern = TrimBlanks(remaining.substr(0, separator));
+
+				if (!pattern.empty())
+				{
+					m_patterns.emplace_back(m_caseSensitive ? std::wstring(pattern)
+															: FoldName(pattern));
+				}
+
+				if (separator == std::wstring_view::npos)
+				{
+					break;
+				}
+
+				remaining.remove_prefix(separator + 1);
+			}
+		}
+		break;
+
+		case FileNameMatchType::Regex:
+			if (!query.pattern.empty())
+			{
+				auto flags = std::regex_constants::ECMAScript | std::regex_constants::optimize;
+
+				if (!m_caseSensitive)
+				{
+					flags |= std::regex_constants::icase;
+				}
+
+				m_regex.emplace(query.pattern, flags);
+			}
+			break;
+		}
+
+		m_matchesEverything = (m_matchType == FileNameMatchType::Regex)
+			? !m_regex
+			: std::ranges::all_of(m_patterns, [](const auto &pattern) { return pattern.empty(); });
+	}
+
+	bool Matches(std::wstring_view name, std::wstring_view foldedName) const
+	{
+		if (m_matchesEverything)
+		{
+			return true;
+		}
+
+		auto text = m_caseSensitive ? name : foldedName;
+
+		switch (m_matchType)
+		{
+		case FileNameMatchType::Substring:
+			return text.find(m_patterns[0]) != std::wstring_view::npos;
+
+		case FileNameMatchType::Wildcard:
+			return std::ranges::any_of(m_patterns,
+				[text](const auto &pattern) { return MatchWildcard(pattern, text); });
+
+		case FileNameMatchType::Regex:
+			return std::regex_match(name.begin(), name.end(), *m_regex);
+		}
+
+		return false;
+	}
+
+private:
+	const FileNameMatchType m_matchType;
+	const bool m_caseSensitive;
+	std::vector<std::wstring> m_patterns;
+	std::optional<std::wregex> m_regex;
+	bool m_matchesEverything = false;
+};
+
+FileNameIndexBuilder::ItemId FileNameIndexBuilder::AddItem(ItemId parent, FileNameIndexItem item)
+{
+	auto id = static_cast<ItemId>(m_entries.size());
+	m_entries.emplace_back(parent, std::move(item));
+	return id;
+}
+
+size_t FileNameIndexBuilder::GetNumItems() const
+{
+	return m_entries.size();
+}
+
+std::vector<std::byte> FileNameIndexBuilder::Build() const
+{
+	auto numItems = static_cast<uint32_t>(m_entries.size());
+
+	std::vector<std::wstring> foldedNames;
+	foldedNames.reserve(numItems);
+
+	for (const auto &entry : m_entries)
+	{
+		foldedNames.push_back(FoldName(entry.item.name));
+	}
+
+	std::vector<uint32_t> order(numItems);
+	std::iota(order.begin(), order.end(), 0);
+	std::ranges::stable_sort(order,
+		[this, &foldedNames](uint32_t first, uint32_t second)
+		{
+			int result = foldedNames[first].compare(foldedNames[second]);
+
+			if (result != 0)
+			{
+				return result < 0;
+			}
+
+			return m_entries[first].item.name < m_entries[second].item.name;
+		});
+
+	std::vector<uint32_t> newIds(numItems);
+
+	for (uint32_t i = 0; i < numItems; i++)
+	{
+		newIds[order[i]] = i;
+	}
+
+	uint32_t numRestarts = (numItems + RESTART_INTERVAL - 1) / RESTART_INTERVAL;
+	std::vector<uint32_t> restarts;
+	restarts.reserve(numRestarts);
+
+	std::vector<uint32_t> roots;
+	std::vector<wchar_t> names;
+	std::wstring_view previousName;
+
+	for (uint32_t i = 0; i < numItems; i++)
+	{
+		const auto &entry = m_entries[order[i]];
+		std::wstring_view name = entry.item.name;
+		name = name.substr(0, MAX_NAME_LENGTH);
+
+		size_t sharedLength = 0;
+
+		if (i % RESTART_INTERVAL == 0)
+		{
+			restarts.push_back(static_cast<uint32_t>(names.size()));
+		}
+		else
+		{
+			auto [nameItr, previousItr] = std::ranges::mismatch(name, previousName);
+			sharedLength = static_cast<size_t>(nameItr - name.begin());
+		}
+
+		names.push_back(static_cast<wchar_t>(sharedLength));
+		names.push_back(static_cast<wchar_t>(name.size() - sharedLength));
+		names.insert(names.end(), name.begin() + sharedLength, name.end());
+
+		if (entry.parent == NO_PARENT)
+		{
+			roots.push_back(i);
+		}
+
+		previousName = name;
+	}
+
+	size_t recordsOffset = AlignSectionOffset(sizeof(FileNameIndex::Header));
+	size_t rootsOffset =
+		AlignSectionOffset(recordsOffset + numItems * sizeof(FileNameIndex::Record));
+	size_t restartsOffset = AlignSectionOffset(rootsOffset + roots.size() * sizeof(uint32_t));
+	size_t namesOffset = AlignSectionOffset(restartsOffset + restarts.size() * sizeof(uint32_t));
+	size_t totalSize = namesOffset + names.size() * sizeof(wchar_t);
+
+	std::vector<std::byte> data(totalSize);
+
+	FileNameIndex::Header header = {};
+	header.magic = INDEX_MAGIC;
+	header.version = INDEX_VERSION;
+	header.charSize = sizeof(wchar_t);
+	header.restartInterval = RESTART_INTERVAL;
+	header.numItems = numItems;
+	header.numRoots = roots.size();
+	header.numRestarts = restarts.size();
+	header.numNameChars = names.size();
+	header.recordsOffset = recordsOffset;
+	header.rootsOffset = rootsOffset;
+	header.restartsOffset = restartsOffset;
+	header.namesOffset = namesOffset;
+	std::memcpy(data.data(), &header, sizeof(header));
+
+	auto *records = reinterpret_cast<FileNameIndex::Record *>(data.data() + recordsOffset);
+
+	for (uint32_t i = 0; i < numItems; i++)
+	{
+		const auto &entry = m_entries[order[i]];
+		auto &record = records[i];
+		record.parent = (entry.parent == NO_PARENT) ? NO_PARENT : newIds[entry.parent];
+		record.attributes = entry.item.attributes;
+		record.size = entry.item.isFolder ? FOLDER_SIZE : entry.item.size;
+		record.lastWriteTime = entry.item.lastWriteTime;
+	}
+
+	WriteSection(data, rootsOffset, roots);
+	WriteSection(data, restartsOffset, restarts);
+	WriteSection(data, namesOffset, names);
+
+	return data;
+}
+
+std::unique_ptr<FileNameIndex> FileNameIndex::Load(std::span<const std::byte> data)
+{
+	std::unique_ptr<FileNameIndex> index(new FileNameIndex(data, {}));
+
+	if (!index->IsValid())
+	{
+		return nullptr;
+	}
+
+	return index;
+}
+
+std::unique_ptr<FileNameIndex> FileNameIndex::Load(std::vector<std::byte> data)
+{
+	std::span<const std::byte> dataView = data;
+	std::unique_ptr<FileNameIndex> index(new FileNameIndex(dataView, std::move(data)));
+
+	if (!index->IsValid())
+	{
+		return nullptr;
+	}
+
+	return index;
+}
+
+FileNameIndex::FileNameIndex(std::span<const std::byte> data, std::vector<std::byte> ownedData) :
+	m_ownedData(std::move(ownedData)),
+	m_data(data)
+{
+	if (m_data.size() < sizeof(Header))
+	{
+		return;
+	}
+
+	m_header = reinterpret_cast<const Header *>(m_data.data());
+
+	if (!IsValid())
+	{
+		return;
+	}
+
+	m_records = reinterpret_cast<const Record *>(m_data.data() + m_header->recordsOffset);
+	m_roots = reinterpret_cast<const uint32_t *>(m_data.data() + m_header->rootsOffset);
+	m_restarts = reinterpret_cast<const uint32_t *>(m_data.data() + m_header->restartsOffset);
+	m_names = reinterpret_cast<const wchar_t *>(m_data.data() + m_header->namesOffset);
+
+	m_changedBaseItems.resize(m_header->numItems);
+	m_nextId = static_cast<ItemId>(m_header->numItems);
+}
+
+// Only the structure of the data is checked here, since checking every item would mean reading the
+// entire index up front. The index files are written in full before being used, so they're not
+// expected to be partially written.
+bool FileNameIndex::IsValid() const
+{
+	if (!m_header || m_header->magic != INDEX_MAGIC || m_header->version != INDEX_VERSION
+		|| m_header->charSize != sizeof(wchar_t) || m_header->restartInterval != RESTART_INTERVAL
+		|| m_header->numItems >= NO_PARENT)
+	{
+		return false;
+	}
+
+	uint64_t expectedRestarts = (m_header->numItems + RESTART_INTERVAL - 1) / RESTART_INTERVAL;
+
+	if (m_header->numRestarts != expectedRestarts || m_header->numRoots > m_header->numItems)
+	{
+		return false;
+	}
+
+	auto isSectionValid = [this](uint64_t offset, uint64_t size)
+	{
+		return offset % SECTION_ALIGNMENT == 0 && offset <= m_data.size()
+			&& size <= m_data.size() - offset;
+	};
+
+	return isSectionValid(m_header->recordsOffset, m_header->numItems * sizeof(Record))
+		&& isSectionValid(m_header->rootsOffset, m_header->numRoots * sizeof(uint32_t))
+		&& isSectionValid(m_header->restartsOffset, m_header->numRestarts * sizeof(uint32_t))
+		&& isSectionValid(m_header->namesOffset, m_header->numNameChars * sizeof(wchar_t));
+}
+
+std::vector<std::wstring> FileNameIndex::GetRootPaths() const
+{
+	std::vector<std::wstring> rootPaths;
+
+	for (uint64_t i = 0; i < m_header->numRoots; i++)
+	{
+		if (IsLive(m_roots[i]))
+		{
+			rootPaths.push_back(GetBaseName(m_roots[i]));
+		}
+	}
+
+	for (auto id : m_addedRoots)
+	{
+		if (IsLive(id))
+		{
+			rootPaths.push_back(m_changedItems.at(id).item.name);
+		}
+	}
+
+	return rootPaths;
+}
+
+std::optional<FileNameIndex::ItemId> FileNameIndex::FindItem(std::wstring_view path) const
+{
+	std::optional<ItemId> bestRoot;
+	size_t bestRootLength = 0;
+
+	auto checkRoot = [path, &bestRoot, &bestRootLength](ItemId id, std::wstring_view rootPath)
+	{
+		if (rootPath.size() <= bestRootLength && bestRoot)
+		{
+			return;
+		}
+
+		if (path.size() < rootPath.size()
+			|| (path.size() > rootPath.size() && !IsPathSeparator(path[rootPath.size()])))
+		{
+			return;
+		}
+
+		if (FoldName(path.substr(0, rootPath.size())) != FoldName(rootPath))
+		{
+			return;
+		}
+
+		bestRoot = id;
+		bestRootLength = rootPath.size();
+	};
+
+	for (uint64_t i = 0; i < m_header->numRoots; i++)
+	{
+		ItemId id = m_roots[i];
+
+		if (!IsChanged(id) && IsLive(id))
+		{
+			checkRoot(id, GetBaseName(id));
+		}
+	}
+
+	for (const auto &[id, changedItem] : m_changedItems)
+	{
+		if (changedItem.parent == NO_PARENT && IsLive(id))
+		{
+			checkRoot(id, changedItem.item.name);
+		}
+	}
+
+	if (!bestRoot)
+	{
+		return std::nullopt;
+	}
+
+	ItemId current = *bestRoot;
+	std::wstring_view remaining = path.substr(bestRootLength);
+
+	while (!remaining.empty())
+	{
+		while (!remaining.empty() && IsPathSeparator(remaining.front()))
+		{
+			remaining.remove_prefix(1);
+		}
+
+		if (remaining.empty())
+		{
+			break;
+		}
+
+		auto separator = std::ranges::find_if(remaining, IsPathSeparator);
+		auto component = remaining.substr(0, separator - remaining.begin());
+		remaining.remove_prefix(component.size());
+
+		auto child = FindChild(current, component);
+
+		if (!child)
+		{
+			return std::nullopt;
+		}
+
+		current = *child;
+	}
+
+	return current;
+}
+
+std::optional<FileNameIndex::ItemId> FileNameIndex::FindChild(ItemId parent,
+	std::wstring_view name) const
+{
+	auto foldedName = FoldName(name);
+
+	auto [begin, end] = m_changedItemsByName.equal_range(foldedName);
+
+	for (auto itr = begin; itr != end; ++itr)
+	{
+		if (m_changedItems.at(itr->second).parent == parent
+			&& !m_removedItems.contains(itr->second))
+		{
+			return itr->second;
+		}
+	}
+
+	auto numItems = static_cast<uint32_t>(m_header->numItems);
+
+	if (numItems == 0)
+	{
+		return std::nullopt;
+	}
+
+	// Find the last restart point whose name is less than the target. Any matching items will come
+	// after that point.
+	uint32_t low = 0;
+	auto high = static_cast<uint32_t>(m_header->numRestarts);
+
+	while (high - low > 1)
+	{
+		uint32_t middle = low + (high - low) / 2;
+		// The full name is stored at a restart point, so it can be read directly. The name is
+		// preceded by the shared length (which is always 0 here) and the name length.
+		const wchar_t *restart = m_names + m_restarts[middle];
+		std::wstring_view restartName(restart + 2, static_cast<size_t>(restart[1]));
+
+		if (FoldName(restartName) < foldedName)
+		{
+			low = middle;
+		}
+		else
+		{
+			high = middle;
+		}
+	}
+
+	std::optional<ItemId> result;
+
+	DecodeNames(m_names, m_restarts, low * RESTART_INTERVAL, numItems,
+		[this, parent, &foldedName, &result](ItemId id, std::wstring_view,
+			std::wstring_view currentFoldedName)
+		{
+			int comparison = currentFoldedName.compare(foldedName);
+
+			if (comparison > 0)
+			{
+				return false;
+			}
+
+			if (comparison == 0 && m_records[id].parent == parent && !IsChanged(id)
+				&& !m_removedItems.contains(id))
+			{
+				result = id;
+				return false;
+			}
+
+			return true;
+		});
+
+	return result;
+}
+
+FileNameIndexItem FileNameIndex::GetItem(ItemId id) const
+{
+	if (auto itr = m_changedItems.find(id); itr != m_changedItems.end())
+	{
+		return itr->second.item;
+	}
+
+	const auto &record = GetRecord(id);
+
+	FileNameIndexItem item;
+	item.name = GetBaseName(id);
+	item.isFolder = (record.size == FOLDER_SIZE);
+	item.attributes = record.attributes;
+	item.size = item.isFolder ? 0 : record.size;
+	item.lastWriteTime = record.lastWriteTime;
+	return item;
+}
+
+std::wstring FileNameIndex::GetItemPath(ItemId id) const
+{
+	std::vector<std::wstring> names;
+
+	for (ItemId current = id; current != NO_PARENT; current = GetParent(current))
+	{
+		if (auto itr = m_changedItems.find(current); itr != m_changedItems.end())
+		{
+			names.push_back(itr->second.item.name);
+		}
+		else
+		{
+			names.push_back(GetBaseName(current));
+		}
+	}
+
+	std::wstring path;
+
+	for (auto itr = names.rbegin(); itr != names.rend(); ++itr)
+	{
+		if (!path.empty())
+		{
+			path += static_cast<wchar_t>(std::filesystem::path::preferred_separator);
+		}
+
+		path += *itr;
+	}
+
+	return path;
+}
+
+FileNameIndex::ItemId FileNameIndex::AddItem(ItemId parent, FileNameIndexItem item)
+{
+	std::optional<ItemId> existingId;
+
+	if (parent == NO_PARENT)
+	{
+		existingId = FindItem(item.name);
+
+		if (existingId && GetParent(*existingId) != NO_PARENT)
+		{
+			existingId.reset();
+		}
+	}
+	else
+	{
+		existingId = FindChild(parent, item.name);
+	}
+
+	auto foldedName = FoldName(item.name);
+
+	if (existingId)
+	{
+		if (auto itr = m_changedItems.find(*existingId); itr != m_changedItems.end())
+		{
+			// The name can only differ by case here, so the folded name doesn't need to be updated.
+			itr->second.item = std::move(item);
+		}
+		else
+		{
+			m_changedItems.emplace(*existingId,
+				ChangedItem{ parent, std::move(item), foldedName });
+			m_changedItemsByName.emplace(std::move(foldedName), *existingId);
+			m_changedBaseItems[*existingId] = true;
+		}
+
+		return *existingId;
+	}
+
+	ItemId id = m_nextId++;
+	m_changedItems.emplace(id, ChangedItem{ parent, std::move(item), foldedName });
+	m_changedItemsByName.emplace(std::move(foldedName), id);
+
+	if (parent == NO_PARENT)
+	{
+		m_addedRoots.push_back(id);
+	}
+
+	return id;
+}
+
+void FileNameIndex::RemoveItem(ItemId id)
+{
+	// Items within a removed folder are left in place, but are treated as removed, since one of
+	// their ancestors has been.
+	m_removedItems.insert(id);
+}
+
+std::vector<FileNameQueryResult> FileNameIndex::Query(const FileNameQuery &query,
+	std::stop_token stopToken) const
+{
+	NameMatcher matcher(query);
+
+	std::optional<ItemId> scope;
+
+	if (!query.scopePath.empty())
+	{
+		scope = FindItem(query.scopePath);
+
+		if (!scope)
+		{
+			return {};
+		}
+	}
+
+	std::vector<ItemId> ids;
+	QueryBaseItems(query, matcher, scope, stopToken, ids);
+	QueryChangedItems(query, matcher, scope, ids);
+
+	std::vector<std::pair<std::wstring, FileNameQueryResult>> sortableResults;
+	sortableResults.reserve(ids.size());
+
+	for (auto id : ids)
+	{
+		auto item = GetItem(id);
+		auto foldedName = FoldName(item.name);
+		sortableResults.emplace_back(std::move(foldedName),
+			FileNameQueryResult{ GetItemPath(id), std::move(item) });
+	}
+
+	std::ranges::sort(sortableResults,
+		[](const auto &first, const auto &second)
+		{
+			if (first.first != second.first)
+			{
+				return first.first < second.first;
+			}
+
+			return std::ranges::lexicographical_compare(first.second.path, second.second.path, {},
+				FoldChar, FoldChar);
+		});
+
+	std::vector<FileNameQueryResult> results;
+	results.reserve(std::min(sortableResults.size(), query.maxResults));
+
+	for (auto &sortableResult : sortableResults)
+	{
+		if (results.size() == query.maxResults)
+		{
+			break;
+		}
+
+		results.push_back(std::move(sortableResult.second));
+	}
+
+	return results;
+}
+
+void FileNameIndex::QueryBaseItems(const FileNameQuery &query, const NameMatcher &matcher,
+	std::optional<ItemId> scope, std::stop_token stopToken, std::vector<ItemId> &results) const
+{
+	auto numItems = static_cast<uint32_t>(m_header->numItems);
+	auto numBlocks = static_cast<uint32_t>(m_header->numRestarts);
+
+	// The blocks are split into more chunks than there are threads, so that a thread that finishes
+	// its chunk quickly (e.g. because most of the items in it are filtered out) can pick up more
+	// work.
+	auto numThreads = static_cast<uint32_t>(std::max(query.numThreads, 1));
+	uint32_t numChunks = std::min(numBlocks, numThreads * 8);
+	std::vector<std::vector<ItemId>> chunkResults(numChunks);
+
+	ParallelFor(numChunks, query.numThreads, stopToken,
+		[&](size_t chunk)
+		{
+			uint32_t firstBlock = static_cast<uint32_t>(chunk * numBlocks / numChunks);
+			uint32_t lastBlock = static_cast<uint32_t>((chunk + 1) * numBlocks / numChunks);
+			uint32_t begin = firstBlock * RESTART_INTERVAL;
+			uint32_t end = std::min(lastBlock * RESTART_INTERVAL, numItems);
+			auto &currentResults = chunkResults[chunk];
+
+			DecodeNames(m_names, m_restarts, begin, end,
+				[&](ItemId id, std::wstring_view name, std::wstring_view foldedName)
+				{
+					if (id % RESTART_INTERVAL == 0 && stopToken.stop_requested())
+					{
+						return false;
+					}
+
+					const auto &record = m_records[id];
+					bool isFolder = (record.size == FOLDER_SIZE);
+
+					if (m_changedBaseItems[id]
+						|| !MatchesFilters(isFolder, record.attributes, isFolder ? 0 : record.size,
+							record.lastWriteTime, query)
+						|| !matcher.Matches(name, foldedName))
+					{
+						return true;
+					}
+
+					if ((scope && !IsWithin(id, *scope)) || !IsLive(id))
+					{
+						return true;
+					}
+
+					currentResults.push_back(id);
+
+					// Items are scanned in name order, so once a chunk has found enough results,
+					// anything else it finds would be discarded.
+					return currentResults.size() < query.maxResults;
+				});
+		});
+
+	for (const auto &currentResults : chunkResults)
+	{
+		for (auto id : currentResults)
+		{
+			if (results.size() == query.maxResults)
+			{
+				return;
+			}
+
+			results.push_back(id);
+		}
+	}
+}
+
+void FileNameIndex::QueryChangedItems(const FileNameQuery &query, const NameMatcher &matcher,
+	std::optional<ItemId> scope, std::vector<ItemId> &results) const
+{
+	for (const auto &[id, changedItem] : m_changedItems)
+	{
+		const auto &item = changedItem.item;
+
+		if (!MatchesFilters(item.isFolder, item.attributes, item.size, item.lastWriteTime, query)
+			|| !matcher.Matches(item.name, changedItem.foldedName))
+		{
+			continue;
+		}
+
+		if ((scope && !IsWithin(id, *scope)) || !IsLive(id))
+		{
+			continue;
+		}
+
+		results.push_back(id);
+	}
+}
+
+size_t FileNameIndex::GetNumItems() const
+{
+	return m_nextId;
+}
+
+size_t FileNameIndex::GetNumChanges() const
+{
+	return m_changedItems.size() + m_removedItems.size();
+}
+
+std::vector<std::byte> FileNameIndex::Serialize() const
+{
+	// Whether each item is live, worked out from its ancestors.
+	enum class State : uint8_t
+	{
+		Unknown,
+		Live,
+		Removed
+	};
+
+	std::vector<State> states(m_nextId, State::Unknown);
+	std::vector<ItemId> ancestors;
+
+	for (ItemId id = 0; id < m_nextId; id++)
+	{
+		ItemId current = id;
+
+		while (current != NO_PARENT && states[current] == State::Unknown
+			&& !m_removedItems.contains(current))
+		{
+			ancestors.push_back(current);
+			current = GetParent(current);
+		}
+
+		State state = (current == NO_PARENT) ? State::Live
+			: (states[current] == State::Unknown) ? State::Removed
+												  : states[current];
+
+		for (auto ancestor : ancestors)
+		{
+			states[ancestor] = state;
+		}
+
+		ancestors.clear();
+
+		if (states[id] == State::Unknown)
+		{
+			states[id] = State::Removed;
+		}
+	}
+
+	// Items are added to the builder in id order, so their new ids can be determined up front,
+	// which means that an item can be added before its parent.
+	std::vector<ItemId> newIds(m_nextId, NO_PARENT);
+	ItemId nextNewId = 0;
+
+	for (ItemId id = 0; id < m_nextId; id++)
+	{
+		if (states[id] == State::Live)
+		{
+			newIds[id] = nextNewId++;
+		}
+	}
+
+	auto mapParent = [&newIds](ItemId parent)
+	{ return (parent == NO_PARENT) ? NO_PARENT : newIds[parent]; };
+
+	FileNameIndexBuilder builder;
+	auto numBaseItems = static_cast<uint32_t>(m_header->numItems);
+
+	DecodeNames(m_names, m_restarts, 0, numBaseItems,
+		[&](ItemId id, std::wstring_view name, std::wstring_view)
+		{
+			if (states[id] != State::Live)
+			{
+				return true;
+			}
+
+			if (auto itr = m_changedItems.find(id); itr != m_changedItems.end())
+			{
+				builder.AddItem(mapParent(itr->second.parent), itr->second.item);
+				return true;
+			}
+
+			const auto &record = m_records[id];
+
+			FileNameIndexItem item;
+			item.name = name;
+			item.isFolder = (record.size == FOLDER_SIZE);
+			item.attributes = record.attributes;
+			item.size = item.isFolder ? 0 : record.size;
+			item.lastWriteTime = record.lastWriteTime;
+			builder.AddItem(mapParent(record.parent), std::move(item));
+
+			return true;
+		});
+
+	for (ItemId id = numBaseItems; id < m_nextId; id++)
+	{
+		if (states[id] != State::Live)
+		{
+			continue;
+		}
+
+		const auto &changedItem = m_changedItems.at(id);
+		builder.AddItem(mapParent(changedItem.parent), changedItem.item);
+	}
+
+	return builder.Build();
+}
+
+const FileNameIndex::Record &FileNameIndex::GetRecord(ItemId id) const
+{
+	return m_records[id];
+}
+
+std::wstring FileNameIndex::GetBaseName(ItemId id) const
+{
+	std::wstring result;
+
+	DecodeNames(m_names, m_restarts, id - id % RESTART_INTERVAL, id + 1,
+		[id, &result](ItemId currentId, std::wstring_view name, std::wstring_view)
+		{
+			if (currentId == id)
+			{
+				result = name;
+			}
+
+			return true;
+		});
+
+	return result;
+}
+
+FileNameIndex::ItemId FileNameIndex::GetParent(ItemId id) const
+{
+	if (auto itr = m_changedItems.find(id); itr != m_changedItems.end())
+	{
+		return itr->second.parent;
+	}
+
+	return m_records[id].parent;
+}
+
+bool FileNameIndex::IsBaseItem(ItemId id) const
+{
+	return id < m_header->numItems;
+}
+
+bool FileNameIndex::IsChanged(ItemId id) const
+{
+	return IsBaseItem(id) ? m_changedBaseItems[id] : true;
+}
+
+bool FileNameIndex::IsLive(ItemId id) const
+{
+	if (m_removedItems.empty())
+	{
+		return true;
+	}
+
+	for (ItemId current = id; current != NO_PARENT; current = GetParent(current))
+	{
+		if (m_removedItems.contains(current))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool FileNameIndex::IsWithin(ItemId id, ItemId folder) const
+{
+	for (ItemId current = GetParent(id); current != NO_PARENT; current = GetParent(current))
+	{
+		if (current == folder)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
@@ -0,0 +1,228 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#pragma once
+
+#include <boost/core/noncopyable.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <span>
+#include <stop_token>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+// Matches FILE_ATTRIBUTE_REPARSE_POINT. The contents of folders with this attribute aren't indexed,
+// so that links can't result in the same items being indexed more than once (or in a cycle).
+inline constexpr uint32_t FILE_NAME_INDEX_REPARSE_POINT_ATTRIBUTE = 0x400;
+
+struct FileNameIndexItem
+{
+	std::wstring name;
+	bool isFolder = false;
+
+	// The item's attributes, in the same form as the Windows file attributes. Folder readers that
+	// don't have access to attributes leave this as 0.
+	uint32_t attributes = 0;
+
+	// Always 0 for a folder.
+	uint64_t size = 0;
+
+	// The units depend on the folder reader. On Windows, this is a FILETIME value.
+	int64_t lastWriteTime = 0;
+
+	bool operator==(const FileNameIndexItem &) const = default;
+};
+
+enum class FileNameMatchType
+{
+	Substring,
+
+	// Supports the * and ? wildcards. Multiple patterns can be separated by ':' (e.g. "*.h:*.cpp"),
+	// in which case an item only has to match one of them.
+	Wildcard,
+
+	// The whole name has to match the regular expression.
+	Regex
+};
+
+enum class FileNameItemTypes
+{
+	All,
+	Files,
+	Folders
+};
+
+struct FileNameQuery
+{
+	std::wstring pattern;
+	FileNameMatchType matchType = FileNameMatchType::Substring;
+	bool caseSensitive = false;
+
+	FileNameItemTypes itemTypes = FileNameItemTypes::All;
+
+	// Items only match if they have all of these attributes.
+	uint32_t requiredAttributes = 0;
+
+	// Inclusive bounds. Folders are only matched by the size filters if their bounds include 0.
+	std::optional<uint64_t> minSize;
+	std::optional<uint64_t> maxSize;
+	std::optional<int64_t> modifiedAfter;
+	std::optional<int64_t> modifiedBefore;
+
+	// If set, only items within this folder (at any depth) are returned.
+	std::wstring scopePath;
+
+	size_t maxResults = 1000;
+	int numThreads = 1;
+};
+
+struct FileNameQueryResult
+{
+	std::wstring path;
+	FileNameIndexItem item;
+};
+
+// Builds the serialized form of an index, which can then be loaded by FileNameIndex.
+class FileNameIndexBuilder : private boost::noncopyable
+{
+public:
+	using ItemId = uint32_t;
+	static constexpr ItemId NO_PARENT = UINT32_MAX;
+
+	// Ids are assigned sequentially, starting from 0. The parent can be any id that's been assigned
+	// by the time Build() is called. Root items (those without a parent) are named using their full
+	// path (e.g. "C:" or "/home/user"), without a trailing separator.
+	ItemId AddItem(ItemId parent, FileNameIndexItem item);
+
+	size_t GetNumItems() const;
+
+	std::vector<std::byte> Build() const;
+
+private:
+	struct Entry
+	{
+		ItemId parent;
+		FileNameIndexItem item;
+	};
+
+	std::vector<Entry> m_entries;
+};
+
+// A searchable index of file and folder names.
+//
+// The bulk of the index is a block of serialized data, which is used in place, so the index can be
+// loaded by mapping a file into memory, without any parsing. Within that data, items are sorted by
+// name, with names stored using prefix compression (each name only stores the characters that
+// differ from the previous name), with a restart point every few items, so that a name can be
+// found using a binary search. Each item has a fixed-size record that stores its metadata and a
+// link to its parent, which is how paths are reconstructed.
+//
+// Since the serialized data is read-only, changes are tracked separately, in memory, and only
+// merged in when the index is serialized again.
+//
+// Queries scan every name, which is fast because the names are stored contiguously and the scan
+// can be split across threads. Lookups by path use the sorted order, though all the items with a
+// particular name (e.g. every "readme.txt") are checked against the expected parent.
+//
+// Queries (and the other const methods) are safe to run concurrently, but changes need to be
+// synchronized with everything else.
+class FileNameIndex : private boost::noncopyable
+{
+public:
+	using ItemId = FileNameIndexBuilder::ItemId;
+	static constexpr ItemId NO_PARENT = FileNameIndexBuilder::NO_PARENT;
+
+	// The data is used in place, so it needs to outlive the index. Returns null if the data isn't
+	// a valid index (for example, because it was created by an incompatible version).
+	static std::unique_ptr<FileNameIndex> Load(std::span<const std::byte> data);
+
+	// Takes ownership of the data.
+	static std::unique_ptr<FileNameIndex> Load(std::vector<std::byte> data);
+
+	// The full paths of the root items.
+	std::vector<std::wstring> GetRootPaths() const;
+
+	std::optional<ItemId> FindItem(std::wstring_view path) const;
+	std::optional<ItemId> FindChild(ItemId parent, std::wstring_view name) const;
+	FileNameIndexItem GetItem(ItemId id) const;
+	std::wstring GetItemPath(ItemId id) const;
+
+	// Returns the id of the new item. If an item with the same name already exists in the parent,
+	// it's updated instead.
+	ItemId AddItem(ItemId parent, FileNameIndexItem item);
+
+	// Removes the item and, if it's a folder, everything within it.
+	void RemoveItem(ItemId id);
+
+	// Returns the matching items, ordered by name. Throws std::regex_error if the pattern is an
+	// invalid regular expression. Returns whatever has been found so far if a stop is requested.
+	std::vector<FileNameQueryResult> Query(const FileNameQuery &query,
+		std::stop_token stopToken = {}) const;
+
+	// Removed items continue to be counted here until the index is serialized again.
+	size_t GetNumItems() const;
+
+	// The number of items that have been added, changed or removed since the index was loaded.
+	size_t GetNumChanges() const;
+
+	// Serializes the index, including any changes that have been made.
+	std::vector<std::byte> Serialize() const;
+
+private:
+	// The builder writes the serialized form of these.
+	friend class FileNameIndexBuilder;
+
+	struct Header;
+	struct Record;
+	class NameMatcher;
+
+	struct ChangedItem
+	{
+		ItemId parent;
+		FileNameIndexItem item;
+		std::wstring foldedName;
+	};
+
+	FileNameIndex(std::span<const std::byte> data, std::vector<std::byte> ownedData);
+
+	bool IsValid() const;
+	const Record &GetRecord(ItemId id) const;
+	std::wstring GetBaseName(ItemId id) const;
+	ItemId GetParent(ItemId id) const;
+	bool IsBaseItem(ItemId id) const;
+	bool IsChanged(ItemId id) const;
+	bool IsLive(ItemId id) const;
+	bool IsWithin(ItemId id, ItemId folder) const;
+	void QueryBaseItems(const FileNameQuery &query, const NameMatcher &matcher,
+		std::optional<ItemId> scope, std::stop_token stopToken,
+		std::vector<ItemId> &results) const;
+	void QueryChangedItems(const FileNameQuery &query, const NameMatcher &matcher,
+		std::optional<ItemId> scope, std::vector<ItemId> &results) const;
+
+	std::vector<std::byte> m_ownedData;
+	std::span<const std::byte> m_data;
+	const Header *m_header = nullptr;
+	const Record *m_records = nullptr;
+	const uint32_t *m_roots = nullptr;
+	const uint32_t *m_restarts = nullptr;
+	const wchar_t *m_names = nullptr;
+
+	// Items that have been added, or whose details have changed, keyed by id. Added items are given
+	// ids after those of the serialized items.
+	std::unordered_map<ItemId, ChangedItem> m_changedItems;
+	std::unordered_multimap<std::wstring, ItemId> m_changedItemsByName;
+
+	// Serialized items that have changed (and so should be skipped when scanning the serialized
+	// names), stored as a bit per item.
+	std::vector<bool> m_changedBaseItems;
+
+	std::unordered_set<ItemId> m_removedItems;
+	std::vector<ItemId> m_addedRoots;
+	ItemId m_nextId = 0;
+};
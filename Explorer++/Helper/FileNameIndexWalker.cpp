@@ -0,0 +1,175 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "stdafx.h"
+#include "FileNameIndexWalker.h"
+#include "ParallelFor.h"
+#include <filesystem>
+
+namespace
+{
+
+bool IsPathSeparator(wchar_t c)
+{
+	return c == L'/' || c == L'\\';
+}
+
+std::wstring JoinPath(const std::wstring &folderPath, const std::wstring &name)
+{
+	std::wstring path = folderPath;
+
+	if (!path.empty() && !IsPathSeparator(path.back()))
+	{
+		path += static_cast<wchar_t>(std::filesystem::path::preferred_separator);
+	}
+
+	return path + name;
+}
+
+}
+
+bool ReadFolderForIndex(const std::wstring &path, std::vector<FileNameIndexItem> &items)
+{
+	std::error_code error;
+	std::filesystem::directory_iterator itr(path,
+		std::filesystem::directory_options::skip_permission_denied, error);
+
+	if (error)
+	{
+		return false;
+	}
+
+	for (; itr != std::filesystem::directory_iterator(); itr.increment(error))
+	{
+		if (error)
+		{
+			break;
+		}
+
+		const auto &entry = *itr;
+		std::error_code entryError;
+		auto status = entry.symlink_status(entryError);
+
+		if (entryError)
+		{
+			continue;
+		}
+
+		FileNameIndexItem item;
+		item.name = entry.path().filename().wstring();
+
+		if (std::filesystem::is_symlink(status))
+		{
+			item.attributes |= FILE_NAME_INDEX_REPARSE_POINT_ATTRIBUTE;
+			item.isFolder = entry.is_directory(entryError);
+		}
+		else
+		{
+			item.isFolder = std::filesystem::is_directory(status);
+		}
+
+		if (!item.isFolder)
+		{
+			auto size = entry.file_size(entryError);
+			item.size = entryError ? 0 : size;
+		}
+
+		auto lastWriteTime = entry.last_write_time(entryError);
+
+		if (!entryError)
+		{
+			item.lastWriteTime = lastWriteTime.time_since_epoch().count();
+		}
+
+		items.push_back(std::move(item));
+	}
+
+	return true;
+}
+
+bool WalkFoldersForIndex(std::vector<FileNameIndexFolder> folders,
+	const FileNameIndexFolderReader &reader, int numThreads, std::stop_token stopToken,
+	const FileNameIndexItemSink &sink)
+{
+	while (!folders.empty())
+	{
+		std::vector<std::vector<FileNameIndexItem>> listings(folders.size());
+
+		ParallelFor(folders.size(), numThreads, stopToken,
+			[&folders, &listings, &reader](size_t index)
+			{
+				if (!reader(folders[index].path, listings[index]))
+				{
+					listings[index].clear();
+				}
+			});
+
+		if (stopToken.stop_requested())
+		{
+			return false;
+		}
+
+		std::vector<FileNameIndexFolder> nextFolders;
+
+		for (size_t i = 0; i < folders.size(); i++)
+		{
+			for (auto &item : listings[i])
+			{
+				bool walkContents =
+					item.isFolder && !(item.attributes & FILE_NAME_INDEX_REPARSE_POINT_ATTRIBUTE);
+				auto itemPath = walkContents ? JoinPath(folders[i].path, item.name) : L"";
+				auto id = sink(folders[i].id, std::move(item));
+
+				if (walkContents)
+				{
+					nextFolders.emplace_back(std::move(itemPath), id);
+				}
+			}
+		}
+
+		folders = std::move(nextFolders);
+	}
+
+	return true;
+}
+
+std::optional<std::vector<std::byte>> BuildFileNameIndex(const std::vector<std::wstring> &rootPaths,
+	const FileNameIndexFolderReader &reader, int numThreads, std::stop_token stopToken)
+{
+	FileNameIndexBuilder builder;
+	std::vector<FileNameIndexFolder> roots;
+
+	for (const auto &rootPath : rootPaths)
+	{
+		FileNameIndexItem rootItem;
+		rootItem.name = GetFileNameIndexRootName(rootPath);
+		rootItem.isFolder = true;
+		auto id = builder.AddItem(FileNameIndexBuilder::NO_PARENT, std::move(rootItem));
+		roots.emplace_back(rootPath, id);
+	}
+
+	bool completed = WalkFoldersForIndex(std::move(roots), reader, numThreads, stopToken,
+		[&builder](FileNameIndex::ItemId parent, FileNameIndexItem item)
+		{ return builder.AddItem(parent, std::move(item)); });
+
+	if (!completed)
+	{
+		return std::nullopt;
+	}
+
+	return builder.Build();
+}
+
+std::wstring GetFileNameIndexRootName(const std::wstring &rootPath)
+{
+	std::wstring name = rootPath;
+
+	// A root of "/" is left as-is, since removing the separator would leave nothing.
+	while (name.size() > 1 && IsPathSeparator(name.back()))
+	{
+		name.pop_back();
+	}
+
+	return name;
+}
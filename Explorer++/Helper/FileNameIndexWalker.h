@@ -0,0 +1,47 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#pragma once
+
+#include "FileNameIndex.h"
+#include <functional>
+#include <optional>
+#include <stop_token>
+#include <string>
+#include <vector>
+
+// Reads the items directly within a folder. Returns false if the folder can't be read. This will be
+// called from multiple threads at once.
+using FileNameIndexFolderReader =
+	std::function<bool(const std::wstring &path, std::vector<FileNameIndexItem> &items)>;
+
+// Called for each item found during a walk, with the id of the folder the item is in. Returns the
+// id assigned to the item. This is always called on the thread that started the walk.
+using FileNameIndexItemSink =
+	std::function<FileNameIndex::ItemId(FileNameIndex::ItemId parent, FileNameIndexItem item)>;
+
+struct FileNameIndexFolder
+{
+	std::wstring path;
+	FileNameIndex::ItemId id;
+};
+
+// A folder reader based on std::filesystem. Attributes aren't available, other than the reparse
+// point attribute, which is set for symbolic links.
+bool ReadFolderForIndex(const std::wstring &path, std::vector<FileNameIndexItem> &items);
+
+// Walks everything within the folders, passing each item to the sink. The walk is breadth-first,
+// with the folders at each level read in parallel. Folders that can't be read are skipped. Returns
+// false if a stop was requested.
+bool WalkFoldersForIndex(std::vector<FileNameIndexFolder> folders,
+	const FileNameIndexFolderReader &reader, int numThreads, std::stop_token stopToken,
+	const FileNameIndexItemSink &sink);
+
+// Builds a serialized index containing the roots and everything within them. Returns an empty value
+// if a stop was requested.
+std::optional<std::vector<std::byte>> BuildFileNameIndex(const std::vector<std::wstring> &rootPaths,
+	const FileNameIndexFolderReader &reader, int numThreads, std::stop_token stopToken);
+
+// Returns the name used for a root item (the path, without any trailing separators).
+std::wstring GetFileNameIndexRootName(const std::wstring &rootPath);
@@ -6,18 +6,21 @@
 #include "FileOperations.h"
 #include "DragDropHelper.h"
 #include "DriveInfo.h"
+#include "FolderComparison.h"
 #include "Helper.h"
 #include "ShellHelper.h"
 #include "StringHelper.h"
+#include "Tracing.h"
 #include <wil/com.h>
 #include <filesystem>
 #include <list>
-#include <sstream>
 
 BOOL GetFileClusterSize(const std::wstring &strFilename, PLARGE_INTEGER lpRealFileSize);
 
 HRESULT FileOperations::RenameFile(IShellItem *item, const std::wstring &newName)
 {
+	TRACE_SCOPE("file_operations", "RenameFile");
+
 	wil::com_ptr_nothrow<IFileOperation> fo;
 	HRESULT hr = CoCreateInstance(CLSID_FileOperation, nullptr, CLSCTX_ALL, IID_PPV_ARGS(&fo));
 
@@ -48,6 +51,9 @@ HRESULT FileOperations::RenameFile(IShellItem *item, const std::wstring &newName
 HRESULT FileOperations::DeleteFiles(HWND hwnd, const std::vector<PCIDLIST_ABSOLUTE> &pidls,
 	bool permanent, bool silent)
 {
+	TraceScope traceScope("file_operations", "DeleteFiles");
+	traceScope.SetArg("items", static_cast<int64_t>(pidls.size()));
+
 	wil::com_ptr_nothrow<IFileOperation> fo;
 	HRESULT hr = CoCreateInstance(CLSID_FileOperation, nullptr, CLSCTX_ALL, IID_PPV_ARGS(&fo));
 
@@ -145,6 +151,9 @@ HRESULT FileOperations::CopyFilesToFolder(HWND hOwner, const std::wstring &strTi
 HRESULT FileOperations::CopyFiles(HWND hwnd, IShellItem *destinationFolder,
 	std::vector<PCIDLIST_ABSOLUTE> &pidls, bool move)
 {
+	TraceScope traceScope("file_operations", move ? "MoveFiles" : "CopyFiles");
+	traceScope.SetArg("items", static_cast<int64_t>(pidls.size()));
+
 	wil::com_ptr_nothrow<IFileOperation> fo;
 	HRESULT hr = CoCreateInstance(CLSID_FileOperation, nullptr, CLSCTX_ALL, IID_PPV_ARGS(&fo));
 
@@ -228,9 +237,12 @@ TCHAR *FileOperations::BuildFilenameList(const std::list<std::wstring> &Filename
 
 // Creates a new folder. Note that IFileOperation will take care of
 // renaming the folder if one with that name already exists.
-HRESULT FileOperations::CreateNewFolder(IShellItem *destinationFolder,
-	const std::wstring &newFolderName, IFileOperationProgressSink *progressSink)
+HRESULT FileOperations::PerformSyncPlan(HWND hwnd, const std::wstring &leftRoot,
+	const std::wstring &rightRoot, const std::vector<SyncAction> &plan)
 {
+	TraceScope traceScope("file_operations", "PerformSyncPlan");
+	traceScope.SetArg("actions", static_cast<int64_t>(plan.size()));
+
 	wil::com_ptr_nothrow<IFileOperation> fo;
 	HRESULT hr = CoCreateInstance(CLSID_FileOperation, nullptr, CLSCTX_ALL, IID_PPV_ARGS(&fo));
 
@@ -239,153 +251,100 @@ HRESULT FileOperations::CreateNewFolder(IShellItem *destinationFolder,
 		return hr;
 	}
 
-	hr = fo->SetOperationFlags(FOF_ALLOWUNDO | FOF_SILENT);
+	hr = fo->SetOwnerWindow(hwnd);
 
 	if (FAILED(hr))
 	{
 		return hr;
 	}
 
-	hr = fo->NewItem(destinationFolder, FILE_ATTRIBUTE_DIRECTORY, newFolderName.c_str(), nullptr,
-		progressSink);
+	hr = fo->SetOperationFlags(FOF_ALLOWUNDO | FOF_NOCONFIRMATION | FOF_NOCONFIRMMKDIR);
 
 	if (FAILED(hr))
 	{
 		return hr;
 	}
 
-	hr = fo->PerformOperations();
-
-	return hr;
-}
-
-BOOL FileOperations::SaveDirectoryListing(const std::wstring &strDirectory,
-	const std::wstring &strFilename)
-{
-	std::wstring strContents = _T("Directory\r\n---------\r\n") + strDirectory + _T("\r\n\r\n");
-
-	SYSTEMTIME st;
-	FILETIME ft;
-	FILETIME lft;
-	GetLocalTime(&st);
-	SystemTimeToFileTime(&st, &ft);
-	LocalFileTimeToFileTime(&ft, &lft);
-
-	TCHAR szTime[128];
-	CreateFileTimeString(&lft, szTime, std::size(szTime), FALSE);
-	strContents += _T("Date\r\n----\r\n") + std::wstring(szTime) + _T("\r\n\r\n");
+	for (const auto &action : plan)
+	{
+		if (action.type == SyncActionType::Conflict)
+		{
+			continue;
+		}
 
-	std::wstring strSearch = strDirectory + _T("\\*");
+		const auto &sideRoot = (action.side == SyncSide::Left) ? leftRoot : rightRoot;
+		const auto &otherSideRoot = (action.side == SyncSide::Left) ? rightRoot : leftRoot;
+		auto path = std::filesystem::path(sideRoot) / action.relativePath;
 
-	WIN32_FIND_DATA wfd;
-	HANDLE hFirstFile = FindFirstFile(strSearch.c_str(), &wfd);
+		wil::com_ptr_nothrow<IShellItem> item;
+		hr = SHCreateItemFromParsingName(path.c_str(), nullptr, IID_PPV_ARGS(&item));
 
-	std::list<std::wstring> folderList;
-	std::list<std::wstring> fileList;
-	ULARGE_INTEGER ulTotalSize;
+		if (FAILED(hr))
+		{
+			return hr;
+		}
 
-	ulTotalSize.QuadPart = 0;
+		if (action.type == SyncActionType::Delete)
+		{
+			hr = fo->DeleteItem(item.get(), nullptr);
+		}
+		else
+		{
+			auto destinationPath = std::filesystem::path(otherSideRoot) / action.relativePath;
 
-	if (hFirstFile != INVALID_HANDLE_VALUE)
-	{
-		ULARGE_INTEGER ulFileSize;
+			wil::com_ptr_nothrow<IShellItem> destinationFolder;
+			hr = SHCreateItemFromParsingName(destinationPath.parent_path().c_str(), nullptr,
+				IID_PPV_ARGS(&destinationFolder));
 
-		if (lstrcmpi(wfd.cFileName, _T(".")) != 0 && lstrcmpi(wfd.cFileName, _T("..")) != 0)
-		{
-			if ((wfd.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) == FILE_ATTRIBUTE_DIRECTORY)
+			if (FAILED(hr))
 			{
-				folderList.emplace_back(wfd.cFileName);
+				return hr;
 			}
-			else
-			{
-				fileList.emplace_back(wfd.cFileName);
 
-				ulFileSize.LowPart = wfd.nFileSizeLow;
-				ulFileSize.HighPart = wfd.nFileSizeHigh;
-
-				ulTotalSize.QuadPart += ulFileSize.QuadPart;
-			}
+			hr = fo->CopyItem(item.get(), destinationFolder.get(),
+				destinationPath.filename().c_str(), nullptr);
 		}
 
-		while (FindNextFile(hFirstFile, &wfd) != 0)
+		if (FAILED(hr))
 		{
-			if (lstrcmpi(wfd.cFileName, _T(".")) != 0 && lstrcmpi(wfd.cFileName, _T("..")) != 0)
-			{
-				if ((wfd.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) == FILE_ATTRIBUTE_DIRECTORY)
-				{
-					folderList.emplace_back(wfd.cFileName);
-				}
-				else
-				{
-					fileList.emplace_back(wfd.cFileName);
-
-					ulFileSize.LowPart = wfd.nFileSizeLow;
-					ulFileSize.HighPart = wfd.nFileSizeHigh;
-
-					ulTotalSize.QuadPart += ulFileSize.QuadPart;
-				}
-			}
+			return hr;
 		}
-
-		FindClose(hFirstFile);
 	}
 
-	std::wstringstream ss;
-	ss.imbue(std::locale(""));
-	ss.precision(0);
-
-	strContents += _T("Statistics\r\n----------\r\n");
-
-	ss << std::fixed << folderList.size();
-	strContents += _T("Number of folders: ") + ss.str() + std::wstring(_T("\r\n"));
-
-	ss.str(_T(""));
-	ss << std::fixed << fileList.size();
-	strContents += _T("Number of files: ") + ss.str() + std::wstring(_T("\r\n"));
+	return fo->PerformOperations();
+}
 
-	auto totalSizeText = FormatSizeString(ulTotalSize.QuadPart);
-	strContents += _T("Total size (not including subfolders): ") + totalSizeText + _T("\r\n");
+HRESULT FileOperations::CreateNewFolder(IShellItem *destinationFolder,
+	const std::wstring &newFolderName, IFileOperationProgressSink *progressSink)
+{
+	TRACE_SCOPE("file_operations", "CreateNewFolder");
 
-	strContents += _T("\r\nFolders\r\n-------\r\n");
+	wil::com_ptr_nothrow<IFileOperation> fo;
+	HRESULT hr = CoCreateInstance(CLSID_FileOperation, nullptr, CLSCTX_ALL, IID_PPV_ARGS(&fo));
 
-	for (const auto &folder : folderList)
+	if (FAILED(hr))
 	{
-		strContents += folder + _T("\r\n");
+		return hr;
 	}
 
-	strContents += _T("\r\nFiles\r\n-----\r\n");
+	hr = fo->SetOperationFlags(FOF_ALLOWUNDO | FOF_SILENT);
 
-	for (const auto &file : fileList)
+	if (FAILED(hr))
 	{
-		strContents += file + _T("\r\n");
+		return hr;
 	}
 
-	/* Remove the trailing newline. */
-	strContents = strContents.substr(0, strContents.size() - 2);
-
-	HANDLE hFile = CreateFile(strFilename.c_str(), FILE_WRITE_DATA, 0, nullptr, CREATE_ALWAYS,
-		FILE_ATTRIBUTE_NORMAL, nullptr);
+	hr = fo->NewItem(destinationFolder, FILE_ATTRIBUTE_DIRECTORY, newFolderName.c_str(), nullptr,
+		progressSink);
 
-	if (hFile != INVALID_HANDLE_VALUE)
+	if (FAILED(hr))
 	{
-		DWORD nBytesWritten;
-
-		/* Write out the BOM for UTF-16 LE data.
-		See http://en.wikipedia.org/wiki/Byte-order_mark */
-		WriteFile(hFile, reinterpret_cast<LPCVOID>("\xFF\xFE"), 2, &nBytesWritten, nullptr);
-
-		WriteFile(hFile, reinterpret_cast<LPCVOID>(strContents.c_str()),
-			static_cast<DWORD>(strContents.size() * sizeof(WCHAR)), &nBytesWritten, nullptr);
-
-		if (nBytesWritten == strContents.size())
-		{
-			return TRUE;
-		}
-
-		CloseHandle(hFile);
+		return hr;
 	}
 
-	return FALSE;
+	hr = fo->PerformOperations();
+
+	return hr;
 }
 
 HRESULT CopyFiles(const std::vector<PidlAbsolute> &items, IDataObject **dataObjectOut)
@@ -559,6 +518,8 @@ BOOL GetFileClusterSize(const std::wstring &strFilename, PLARGE_INTEGER lpRealFi
 void FileOperations::DeleteFileSecurely(const std::wstring &strFilename,
 	OverwriteMethod overwriteMethod)
 {
+	TRACE_SCOPE("file_operations", "DeleteFileSecurely");
+
 	HANDLE hFile;
 	WIN32_FIND_DATA wfd;
 	HANDLE hFindFile;
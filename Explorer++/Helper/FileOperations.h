@@ -6,8 +6,11 @@
 
 #include "PidlHelper.h"
 #include <list>
+#include <string>
 #include <vector>
 
+struct SyncAction;
+
 namespace FileOperations
 {
 
@@ -26,13 +29,18 @@ HRESULT CopyFilesToFolder(HWND hOwner, const std::wstring &strTitle,
 HRESULT CopyFiles(HWND hwnd, IShellItem *destinationFolder, std::vector<PCIDLIST_ABSOLUTE> &pidls,
 	bool move);
 
+// Carries out the copies and deletions in a sync plan (see BuildSyncPlan()) as a single file
+// operation, so that progress is shown in the usual way and the operation can be undone. Existing
+// items are replaced without confirmation, since the plan has already been reviewed. Conflicts are
+// skipped.
+HRESULT PerformSyncPlan(HWND hwnd, const std::wstring &leftRoot, const std::wstring &rightRoot,
+	const std::vector<SyncAction> &plan);
+
 HRESULT CreateNewFolder(IShellItem *destinationFolder, const std::wstring &newFolderName,
 	IFileOperationProgressSink *progressSink);
 
 TCHAR *BuildFilenameList(const std::list<std::wstring> &FilenameList);
 
-BOOL SaveDirectoryListing(const std::wstring &strDirectory, const std::wstring &strFilename);
-
 HRESULT CreateLinkToFile(const std::wstring &strTargetFilename, const std::wstring &strLinkFilename,
 	const std::wstring &strLinkDescription);
 HRESULT ResolveLink(HWND hwnd, DWORD fFlags, const TCHAR *szLinkFilename, TCHAR *szResolvedPath,
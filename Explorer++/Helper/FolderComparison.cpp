@@ -0,0 +1,531 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "stdafx.h"
+#include "FolderComparison.h"
+#include "FileHashCache.h"
+#include "ParallelFor.h"
+#include <algorithm>
+#include <cwctype>
+#include <thread>
+
+namespace
+{
+
+wchar_t GetPathComparisonChar(wchar_t c)
+{
+	if (c == L'/' || c == L'\\')
+	{
+		return 0;
+	}
+
+	if (c < 0x80)
+	{
+		return (c >= L'a' && c <= L'z') ? static_cast<wchar_t>(c - L'a' + L'A') : c;
+	}
+
+	return static_cast<wchar_t>(std::towupper(c));
+}
+
+bool IsPathSeparator(wchar_t c)
+{
+	return c == L'/' || c == L'\\';
+}
+
+// Returns true if the path is within the folder (at any depth).
+bool IsPathWithinFolder(const std::wstring &path, const std::wstring &folder)
+{
+	return path.size() > folder.size() && IsPathSeparator(path[folder.size()])
+		&& CompareRelativePaths(path.substr(0, folder.size()), folder) == 0;
+}
+
+FolderComparisonStatus CompareItems(const FolderItemProperties &left,
+	const FolderItemProperties &right, const FolderComparisonOptions &options)
+{
+	if (left.isFolder != right.isFolder)
+	{
+		return FolderComparisonStatus::TypeDiffers;
+	}
+
+	// Folders are only compared by their contents, which are represented by their own entries.
+	if (left.isFolder)
+	{
+		return FolderComparisonStatus::Identical;
+	}
+
+	auto timeDifference = left.lastWriteTime - right.lastWriteTime;
+
+	if (timeDifference > options.timeTolerance)
+	{
+		return FolderComparisonStatus::LeftNewer;
+	}
+	else if (-timeDifference > options.timeTolerance)
+	{
+		return FolderComparisonStatus::RightNewer;
+	}
+
+	if (left.size != right.size)
+	{
+		return FolderComparisonStatus::SizeDiffers;
+	}
+
+	return FolderComparisonStatus::Identical;
+}
+
+bool ShouldCompareContents(const FolderComparisonEntry &entry)
+{
+	if (!entry.left || !entry.right || entry.left->isFolder || entry.right->isFolder
+		|| entry.left->size != entry.right->size)
+	{
+		return false;
+	}
+
+	return entry.status == FolderComparisonStatus::LeftNewer
+		|| entry.status == FolderComparisonStatus::RightNewer
+		|| entry.status == FolderComparisonStatus::Identical;
+}
+
+std::optional<std::string> HashTreeFile(const std::filesystem::path &root,
+	const std::wstring &relativePath, const FolderItemProperties &properties,
+	HashAlgorithm algorithm, FileHashCache *cache, std::stop_token stopToken)
+{
+	FileHashKey key = { (root / relativePath).wstring(), algorithm, properties.size,
+		properties.lastWriteTime.time_since_epoch().count() };
+	return HashFileWithCache(cache, key, stopToken);
+}
+
+// An item that's a folder on only one side is copied or deleted as a whole (or is in conflict), so
+// the items within it don't need their own actions.
+bool DoesActionCoverContents(const FolderComparisonEntry &entry)
+{
+	bool leftIsFolder = entry.left && entry.left->isFolder;
+	bool rightIsFolder = entry.right && entry.right->isFolder;
+	return leftIsFolder != rightIsFolder;
+}
+
+SyncSide GetOppositeSide(SyncSide side)
+{
+	return (side == SyncSide::Left) ? SyncSide::Right : SyncSide::Left;
+}
+
+const wchar_t *GetSyncSideText(SyncSide side)
+{
+	return (side == SyncSide::Left) ? L"left" : L"right";
+}
+
+}
+
+std::optional<std::vector<FolderTreeItem>> ListFolderTree(const std::filesystem::path &root,
+	std::stop_token stopToken)
+{
+	std::error_code error;
+	std::filesystem::recursive_directory_iterator itr(root,
+		std::filesystem::directory_options::skip_permission_denied, error);
+
+	if (error)
+	{
+		return std::nullopt;
+	}
+
+	std::wstring rootPath = root.wstring();
+	size_t prefixLength = rootPath.size();
+
+	if (!rootPath.empty() && !IsPathSeparator(rootPath.back()))
+	{
+		prefixLength++;
+	}
+
+	std::vector<FolderTreeItem> items;
+
+	for (; !error && itr != std::filesystem::recursive_directory_iterator(); itr.increment(error))
+	{
+		if (stopToken.stop_requested())
+		{
+			return std::nullopt;
+		}
+
+		const auto &entry = *itr;
+		std::error_code entryError;
+
+		if (entry.is_symlink(entryError))
+		{
+			if (entry.is_directory(entryError))
+			{
+				itr.disable_recursion_pending();
+			}
+
+			continue;
+		}
+
+		FolderItemProperties properties;
+		properties.isFolder = entry.is_directory(entryError);
+
+		if (entryError)
+		{
+			continue;
+		}
+
+		properties.size = properties.isFolder ? 0 : entry.file_size(entryError);
+
+		if (entryError)
+		{
+			continue;
+		}
+
+		properties.lastWriteTime = entry.last_write_time(entryError);
+
+		if (entryError)
+		{
+			continue;
+		}
+
+		items.push_back({ entry.path().wstring().substr(prefixLength), properties });
+	}
+
+	std::sort(items.begin(), items.end(),
+		[](const FolderTreeItem &item1, const FolderTreeItem &item2)
+		{ return CompareRelativePaths(item1.relativePath, item2.relativePath) < 0; });
+
+	return items;
+}
+
+int CompareRelativePaths(const std::wstring &path1, const std::wstring &path2)
+{
+	size_t length = std::min(path1.size(), path2.size());
+
+	for (size_t i = 0; i < length; i++)
+	{
+		wchar_t c1 = GetPathComparisonChar(path1[i]);
+		wchar_t c2 = GetPathComparisonChar(path2[i]);
+
+		if (c1 != c2)
+		{
+			return (c1 < c2) ? -1 : 1;
+		}
+	}
+
+	if (path1.size() == path2.size())
+	{
+		return 0;
+	}
+
+	return (path1.size() < path2.size()) ? -1 : 1;
+}
+
+std::vector<FolderComparisonEntry> CompareFolderListings(std::vector<FolderTreeItem> left,
+	std::vector<FolderTreeItem> right, const FolderComparisonOptions &options)
+{
+	std::vector<FolderComparisonEntry> entries;
+	entries.reserve(std::max(left.size(), right.size()));
+
+	size_t leftIndex = 0;
+	size_t rightIndex = 0;
+
+	while (leftIndex < left.size() || rightIndex < right.size())
+	{
+		int comparison;
+
+		if (leftIndex == left.size())
+		{
+			comparison = 1;
+		}
+		else if (rightIndex == right.size())
+		{
+			comparison = -1;
+		}
+		else
+		{
+			comparison = CompareRelativePaths(left[leftIndex].relativePath,
+				right[rightIndex].relativePath);
+		}
+
+		if (comparison < 0)
+		{
+			auto &item = left[leftIndex++];
+			entries.push_back({ std::move(item.relativePath), FolderComparisonStatus::LeftOnly,
+				item.properties, std::nullopt });
+		}
+		else if (comparison > 0)
+		{
+			auto &item = right[rightIndex++];
+			entries.push_back({ std::move(item.relativePath), FolderComparisonStatus::RightOnly,
+				std::nullopt, item.properties });
+		}
+		else
+		{
+			auto &leftItem = left[leftIndex++];
+			auto &rightItem = right[rightIndex++];
+			auto status = CompareItems(leftItem.properties, rightItem.properties, options);
+			entries.push_back({ std::move(leftItem.relativePath), status, leftItem.properties,
+				rightItem.properties });
+		}
+	}
+
+	return entries;
+}
+
+bool CompareFolderContents(std::vector<FolderComparisonEntry> &entries,
+	const std::filesystem::path &leftRoot, const std::filesystem::path &rightRoot,
+	const FolderComparisonOptions &options, std::stop_token stopToken)
+{
+	if (!options.contentHashAlgorithm)
+	{
+		return true;
+	}
+
+	std::vector<FolderComparisonEntry *> candidates;
+
+	for (auto &entry : entries)
+	{
+		if (!ShouldCompareContents(entry))
+		{
+			continue;
+		}
+
+		// Empty files always have the same content.
+		if (entry.left->size == 0)
+		{
+			entry.status = FolderComparisonStatus::Identical;
+			continue;
+		}
+
+		candidates.push_back(&entry);
+	}
+
+	ParallelFor(candidates.size(), options.numThreads, stopToken,
+		[&candidates, &leftRoot, &rightRoot, &options, stopToken](size_t index)
+		{
+			auto *entry = candidates[index];
+			auto leftHash = HashTreeFile(leftRoot, entry->relativePath, *entry->left,
+				*options.contentHashAlgorithm, options.cache, stopToken);
+			auto rightHash = HashTreeFile(rightRoot, entry->relativePath, *entry->right,
+				*options.contentHashAlgorithm, options.cache, stopToken);
+
+			if (!leftHash || !rightHash)
+			{
+				return;
+			}
+
+			if (*leftHash == *rightHash)
+			{
+				entry->status = FolderComparisonStatus::Identical;
+			}
+			else if (entry->status == FolderComparisonStatus::Identical)
+			{
+				entry->status = FolderComparisonStatus::ContentDiffers;
+			}
+		});
+
+	return !stopToken.stop_requested();
+}
+
+std::optional<std::vector<FolderComparisonEntry>> CompareFolders(
+	const std::filesystem::path &leftRoot, const std::filesystem::path &rightRoot,
+	const FolderComparisonOptions &options, std::stop_token stopToken)
+{
+	std::optional<std::vector<FolderTreeItem>> rightItems;
+
+	std::jthread rightThread([&rightItems, &rightRoot, stopToken]
+		{ rightItems = ListFolderTree(rightRoot, stopToken); });
+
+	auto leftItems = ListFolderTree(leftRoot, stopToken);
+	rightThread.join();
+
+	if (!leftItems || !rightItems)
+	{
+		return std::nullopt;
+	}
+
+	auto entries =
+		CompareFolderListings(std::move(*leftItems), std::move(*rightItems), options);
+
+	if (!CompareFolderContents(entries, leftRoot, rightRoot, options, stopToken))
+	{
+		return std::nullopt;
+	}
+
+	return entries;
+}
+
+bool IsFolderComparisonDifference(FolderComparisonStatus status)
+{
+	return status != FolderComparisonStatus::Identical;
+}
+
+std::vector<SyncAction> BuildSyncPlan(const std::vector<FolderComparisonEntry> &entries,
+	const SyncOptions &options)
+{
+	std::vector<SyncAction> deletions;
+	std::vector<SyncAction> copies;
+	std::vector<SyncAction> conflicts;
+
+	auto addCopy = [&copies](const FolderComparisonEntry &entry, SyncSide from)
+	{
+		const auto &properties = (from == SyncSide::Left) ? entry.left : entry.right;
+		copies.push_back({ SyncActionType::Copy, entry.relativePath, properties->isFolder, from });
+	};
+
+	auto addDeletion = [&deletions](const FolderComparisonEntry &entry, SyncSide from)
+	{
+		const auto &properties = (from == SyncSide::Left) ? entry.left : entry.right;
+		deletions.push_back(
+			{ SyncActionType::Delete, entry.relativePath, properties->isFolder, from });
+	};
+
+	auto addConflict = [&conflicts](const FolderComparisonEntry &entry)
+	{
+		bool isFolder = (entry.left && entry.left->isFolder) || (entry.right && entry.right->isFolder);
+		conflicts.push_back({ SyncActionType::Conflict, entry.relativePath, isFolder, {} });
+	};
+
+	const FolderComparisonEntry *coveringEntry = nullptr;
+
+	for (const auto &entry : entries)
+	{
+		// Entries are ordered so that the contents of a folder directly follow the folder itself.
+		if (coveringEntry && IsPathWithinFolder(entry.relativePath, coveringEntry->relativePath))
+		{
+			continue;
+		}
+
+		coveringEntry = DoesActionCoverContents(entry) ? &entry : nullptr;
+
+		if (options.direction == SyncDirection::TwoWay)
+		{
+			switch (entry.status)
+			{
+			case FolderComparisonStatus::LeftOnly:
+			case FolderComparisonStatus::LeftNewer:
+				addCopy(entry, SyncSide::Left);
+				break;
+
+			case FolderComparisonStatus::RightOnly:
+			case FolderComparisonStatus::RightNewer:
+				addCopy(entry, SyncSide::Right);
+				break;
+
+			case FolderComparisonStatus::SizeDiffers:
+			case FolderComparisonStatus::ContentDiffers:
+			case FolderComparisonStatus::TypeDiffers:
+				addConflict(entry);
+				break;
+
+			case FolderComparisonStatus::Identical:
+				break;
+			}
+
+			continue;
+		}
+
+		SyncSide source =
+			(options.direction == SyncDirection::LeftToRight) ? SyncSide::Left : SyncSide::Right;
+		SyncSide destination = GetOppositeSide(source);
+		bool existsInSource = (source == SyncSide::Left) ? entry.left.has_value()
+														  : entry.right.has_value();
+
+		if (entry.status == FolderComparisonStatus::Identical)
+		{
+			continue;
+		}
+
+		if (!existsInSource)
+		{
+			if (options.deleteExtraneousItems)
+			{
+				addDeletion(entry, destination);
+			}
+
+			continue;
+		}
+
+		if (entry.status == FolderComparisonStatus::TypeDiffers)
+		{
+			addDeletion(entry, destination);
+		}
+
+		// In a one-way sync, the destination is made to match the source, so the source wins even
+		// if the destination item is newer.
+		addCopy(entry, source);
+	}
+
+	std::vector<SyncAction> plan = std::move(deletions);
+	plan.insert(plan.end(), std::make_move_iterator(copies.begin()),
+		std::make_move_iterator(copies.end()));
+	plan.insert(plan.end(), std::make_move_iterator(conflicts.begin()),
+		std::make_move_iterator(conflicts.end()));
+	return plan;
+}
+
+std::wstring FormatSyncPlan(const std::vector<SyncAction> &plan)
+{
+	auto getDisplayPath = [](const SyncAction &action)
+	{
+		std::wstring path = action.relativePath;
+
+		if (action.isFolder)
+		{
+			path += static_cast<wchar_t>(std::filesystem::path::preferred_separator);
+		}
+
+		return path;
+	};
+
+	size_t pathWidth = 0;
+
+	for (const auto &action : plan)
+	{
+		pathWidth = std::max(pathWidth, getDisplayPath(action).size());
+	}
+
+	std::wstring output;
+
+	for (const auto &action : plan)
+	{
+		std::wstring line;
+
+		switch (action.type)
+		{
+		case SyncActionType::Copy:
+			line = L"copy      ";
+			break;
+
+		case SyncActionType::Delete:
+			line = L"delete    ";
+			break;
+
+		case SyncActionType::Conflict:
+			line = L"conflict  ";
+			break;
+		}
+
+		std::wstring path = getDisplayPath(action);
+		line += path;
+
+		if (action.type != SyncActionType::Conflict)
+		{
+			line.append(pathWidth - path.size() + 4, L' ');
+		}
+
+		switch (action.type)
+		{
+		case SyncActionType::Copy:
+			line += GetSyncSideText(action.side);
+			line += L" -> ";
+			line += GetSyncSideText(GetOppositeSide(action.side));
+			break;
+
+		case SyncActionType::Delete:
+			line += GetSyncSideText(action.side);
+			break;
+
+		case SyncActionType::Conflict:
+			break;
+		}
+
+		output += line;
+		output += L'\n';
+	}
+
+	return output;
+}
@@ -0,0 +1,175 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#pragma once
+
+#include "ContentHash.h"
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <stop_token>
+#include <string>
+#include <vector>
+
+class FileHashCache;
+
+struct FolderItemProperties
+{
+	bool isFolder;
+
+	// Always 0 for a folder.
+	uint64_t size;
+
+	std::filesystem::file_time_type lastWriteTime;
+};
+
+// A single file or folder within a tree, identified by its path relative to the root of the tree.
+struct FolderTreeItem
+{
+	std::wstring relativePath;
+	FolderItemProperties properties;
+};
+
+// Returns the items below the specified folder, sorted by CompareRelativePaths(). As with
+// CollectDuplicateFinderFiles(), symbolic links aren't followed and folders that can't be read are
+// skipped. Returns an empty value if the root folder can't be read, or a stop is requested.
+std::optional<std::vector<FolderTreeItem>> ListFolderTree(const std::filesystem::path &root,
+	std::stop_token stopToken);
+
+// Orders relative paths so that a folder comes directly before its contents (i.e. path separators
+// sort before every other character). Since paths on Windows are case-insensitive, the comparison
+// is as well. Returns a negative value, zero or a positive value, in the same way as
+// std::wstring::compare().
+int CompareRelativePaths(const std::wstring &path1, const std::wstring &path2);
+
+enum class FolderComparisonStatus
+{
+	LeftOnly,
+	RightOnly,
+	LeftNewer,
+	RightNewer,
+
+	// The items were last modified at the same time, but have different sizes.
+	SizeDiffers,
+
+	// The items were last modified at the same time and have the same size, but their contents
+	// differ. Only reported when content comparison is enabled.
+	ContentDiffers,
+
+	// One side has a file and the other a folder.
+	TypeDiffers,
+
+	Identical
+};
+
+struct FolderComparisonEntry
+{
+	std::wstring relativePath;
+	FolderComparisonStatus status;
+
+	// Only set for the sides the item exists on.
+	std::optional<FolderItemProperties> left;
+	std::optional<FolderItemProperties> right;
+};
+
+struct FolderComparisonOptions
+{
+	// Timestamps this close together are treated as equal. The default allows for the two second
+	// resolution of timestamps on FAT volumes.
+	std::filesystem::file_time_type::duration timeTolerance = std::chrono::seconds(2);
+
+	// If set, files of the same size have their contents compared. Files with identical contents
+	// are then reported as identical, regardless of their timestamps.
+	std::optional<HashAlgorithm> contentHashAlgorithm;
+
+	int numThreads = 1;
+	FileHashCache *cache = nullptr;
+};
+
+// Merges two listings (each sorted by CompareRelativePaths()) into a single list of entries, in the
+// same order. The listings are taken by value, so that the paths can be moved into the entries,
+// rather than copied. Only metadata is compared here; content comparison is handled by
+// CompareFolderContents().
+std::vector<FolderComparisonEntry> CompareFolderListings(std::vector<FolderTreeItem> left,
+	std::vector<FolderTreeItem> right, const FolderComparisonOptions &options);
+
+// Compares the contents of files that exist on both sides with the same size, updating the status
+// of each such entry. Files that can't be read keep their existing status. Returns false if a stop
+// was requested.
+bool CompareFolderContents(std::vector<FolderComparisonEntry> &entries,
+	const std::filesystem::path &leftRoot, const std::filesystem::path &rightRoot,
+	const FolderComparisonOptions &options, std::stop_token stopToken);
+
+// Lists both trees (concurrently) and compares them. Returns an empty value if either tree can't be
+// listed, or a stop is requested.
+std::optional<std::vector<FolderComparisonEntry>> CompareFolders(
+	const std::filesystem::path &leftRoot, const std::filesystem::path &rightRoot,
+	const FolderComparisonOptions &options, std::stop_token stopToken);
+
+bool IsFolderComparisonDifference(FolderComparisonStatus status);
+
+enum class SyncDirection
+{
+	LeftToRight,
+	RightToLeft,
+	TwoWay
+};
+
+struct SyncOptions
+{
+	SyncDirection direction = SyncDirection::LeftToRight;
+
+	// For a one-way sync, deletes items that only exist in the destination, so that it ends up
+	// mirroring the source. Ignored for a two-way sync, where an item that only exists on one side
+	// is always copied to the other.
+	bool deleteExtraneousItems = false;
+};
+
+enum class SyncSide
+{
+	Left,
+	Right
+};
+
+enum class SyncActionType
+{
+	// Copies the item (and, for a folder, everything within it) from one side to the other,
+	// replacing any existing item.
+	Copy,
+
+	Delete,
+
+	// The item differs, but there's no way to tell which side should win (e.g. in a two-way sync,
+	// the items have the same timestamp but different contents). Nothing is done.
+	Conflict
+};
+
+struct SyncAction
+{
+	SyncActionType type;
+	std::wstring relativePath;
+	bool isFolder;
+
+	// For Copy, the side the item is copied from. For Delete, the side the item is deleted from.
+	// Unused for Conflict.
+	SyncSide side;
+
+	bool operator==(const SyncAction &) const = default;
+};
+
+// Builds the smallest set of actions that brings the two sides into sync. An item that only exists
+// on one side results in a single action, even if it's a folder, so entries within a folder that's
+// being copied or deleted don't generate their own actions. Deletions are ordered before copies,
+// so that an item that's being replaced with one of a different type (e.g. a file with a folder) is
+// removed first.
+std::vector<SyncAction> BuildSyncPlan(const std::vector<FolderComparisonEntry> &entries,
+	const SyncOptions &options);
+
+// Describes the plan, one action per line, without making any changes. For example:
+//
+// delete    build\             right
+// copy      docs\readme.txt    left -> right
+// conflict  notes.txt
+std::wstring FormatSyncPlan(const std::vector<SyncAction> &plan);
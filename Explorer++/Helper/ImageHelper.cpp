@@ -162,4 +162,67 @@ wil::unique_hicon GdiplusBitmapToIcon(Gdiplus::Bitmap *gdiplusBitmap)
 	return hicon;
 }
 
+std::optional<PixelBuffer> BitmapToOpaquePixelBuffer(HBITMAP bitmap)
+{
+	BITMAP bitmapDetails;
+
+	if (GetObject(bitmap, sizeof(bitmapDetails), &bitmapDetails) == 0
+		|| bitmapDetails.bmWidth <= 0 || bitmapDetails.bmHeight == 0)
+	{
+		return std::nullopt;
+	}
+
+	PixelBuffer pixelBuffer(bitmapDetails.bmWidth, std::abs(bitmapDetails.bmHeight));
+
+	BITMAPINFO bitmapInfo = {};
+	bitmapInfo.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
+	bitmapInfo.bmiHeader.biWidth = pixelBuffer.width;
+	bitmapInfo.bmiHeader.biHeight = -pixelBuffer.height; // Retrieve the rows top-down.
+	bitmapInfo.bmiHeader.biPlanes = 1;
+	bitmapInfo.bmiHeader.biBitCount = 32;
+	bitmapInfo.bmiHeader.biCompression = BI_RGB;
+
+	wil::unique_hdc_window hdc = wil::GetDC(nullptr);
+	int res = GetDIBits(hdc.get(), bitmap, 0, pixelBuffer.height, pixelBuffer.pixels.data(),
+		&bitmapInfo, DIB_RGB_COLORS);
+
+	if (res != pixelBuffer.height)
+	{
+		return std::nullopt;
+	}
+
+	for (auto &pixel : pixelBuffer.pixels)
+	{
+		pixel |= 0xFF000000;
+	}
+
+	return pixelBuffer;
+}
+
+wil::unique_hbitmap PixelBufferToBitmap(const PixelBuffer &pixelBuffer)
+{
+	BITMAPINFO bitmapInfo = {};
+	bitmapInfo.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
+	bitmapInfo.bmiHeader.biWidth = pixelBuffer.width;
+	bitmapInfo.bmiHeader.biHeight = -pixelBuffer.height; // Create a top-down DIB.
+	bitmapInfo.bmiHeader.biPlanes = 1;
+	bitmapInfo.bmiHeader.biBitCount = 32;
+	bitmapInfo.bmiHeader.biCompression = BI_RGB;
+
+	void *bitmapBits = nullptr;
+	wil::unique_hbitmap bitmap(
+		CreateDIBSection(nullptr, &bitmapInfo, DIB_RGB_COLORS, &bitmapBits, nullptr, 0));
+
+	if (!bitmap)
+	{
+		return nullptr;
+	}
+
+	// A 32-bit DIB has no padding between rows, so the layout matches the buffer exactly.
+	std::copy(pixelBuffer.pixels.begin(), pixelBuffer.pixels.end(),
+		static_cast<uint32_t *>(bitmapBits));
+
+	return bitmap;
+}
+
 }
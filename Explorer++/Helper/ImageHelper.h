@@ -4,12 +4,14 @@
 
 #pragma once
 
+#include "PixelBuffer.h"
 #include <wil/resource.h>
 #include <CommCtrl.h>
 #include <commoncontrols.h>
 #include <gdiplus.h>
 #include <wincodec.h>
 #include <memory>
+#include <optional>
 
 namespace ImageHelper
 {
@@ -28,4 +30,12 @@ int CopyImageListIcon(HIMAGELIST destination, HIMAGELIST source, int sourceIconI
 wil::unique_hbitmap GdiplusBitmapToBitmap(Gdiplus::Bitmap *gdiplusBitmap);
 wil::unique_hicon GdiplusBitmapToIcon(Gdiplus::Bitmap *gdiplusBitmap);
 
+// Copies the pixels out of the bitmap, which shouldn't be selected into a device context. GDI
+// generally doesn't preserve alpha values, so every pixel in the returned buffer is marked as
+// opaque.
+std::optional<PixelBuffer> BitmapToOpaquePixelBuffer(HBITMAP bitmap);
+
+// Creates a 32-bit top-down DIB containing the pixels in the buffer.
+wil::unique_hbitmap PixelBufferToBitmap(const PixelBuffer &pixelBuffer);
+
 }
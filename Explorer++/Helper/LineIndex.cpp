@@ -0,0 +1,332 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "stdafx.h"
+#include "LineIndex.h"
+#include "ByteSearch.h"
+#include "MappedFile.h"
+#include <algorithm>
+
+namespace
+{
+
+constexpr std::byte LINE_FEED{ '\n' };
+constexpr std::byte CARRIAGE_RETURN{ '\r' };
+
+}
+
+LineIndex::LineIndex(std::shared_ptr<const MappedFile> file, TextEncoding encoding,
+	uint64_t startOffset) :
+	m_file(std::move(file)),
+	m_encoding(encoding),
+	m_startOffset(startOffset),
+	m_checkpoints({ startOffset }),
+	m_numBytesScanned(startOffset)
+{
+}
+
+void LineIndex::Build(std::stop_token stopToken)
+{
+	uint64_t fileSize = m_file->GetSize();
+	uint64_t position = m_startOffset;
+	uint64_t numNewlines = 0;
+
+	while (position < fileSize)
+	{
+		if (stopToken.stop_requested())
+		{
+			return;
+		}
+
+		// The chunk size is even, so a UTF-16 code unit will never be split across chunks.
+		auto view = m_file->MapView(position, SCAN_CHUNK_SIZE);
+
+		if (!view)
+		{
+			return;
+		}
+
+		auto data = view->GetData();
+
+		for (size_t blockStart = 0; blockStart < data.size(); blockStart += COUNT_BLOCK_SIZE)
+		{
+			auto block =
+				data.subspan(blockStart, std::min(COUNT_BLOCK_SIZE, data.size() - blockStart));
+			ScanBlock(block, position + blockStart, numNewlines);
+		}
+
+		position += data.size();
+
+		m_numNewlines = numNewlines;
+		m_numBytesScanned = position;
+	}
+
+	m_complete = true;
+}
+
+void LineIndex::ScanBlock(std::span<const std::byte> block, uint64_t blockOffset,
+	uint64_t &numNewlines)
+{
+	// In a single-byte encoding, every line feed byte is a newline, so unless the block contains a
+	// checkpoint, all that's needed is a count.
+	if (GetCodeUnitSize(m_encoding) == 1)
+	{
+		size_t count = CountByte(block, LINE_FEED);
+
+		if (numNewlines % CHECKPOINT_INTERVAL + count < CHECKPOINT_INTERVAL)
+		{
+			numNewlines += count;
+			return;
+		}
+	}
+
+	ScanBlockForNewlines(block, blockOffset, numNewlines);
+}
+
+void LineIndex::ScanBlockForNewlines(std::span<const std::byte> block, uint64_t blockOffset,
+	uint64_t &numNewlines)
+{
+	size_t unitSize = GetCodeUnitSize(m_encoding);
+	size_t index = 0;
+
+	while (auto newline = FindNewline(block.subspan(index), blockOffset + index))
+	{
+		uint64_t lineStart = *newline + unitSize;
+		numNewlines++;
+
+		if (numNewlines % CHECKPOINT_INTERVAL == 0)
+		{
+			AddCheckpoint(lineStart);
+		}
+
+		index = static_cast<size_t>(lineStart - blockOffset);
+	}
+}
+
+void LineIndex::AddCheckpoint(uint64_t offset)
+{
+	std::scoped_lock lock(m_checkpointsMutex);
+	m_checkpoints.push_back(offset);
+}
+
+// Returns the offset of the first code unit of the first newline in the data. The data must start
+// on a code unit boundary.
+std::optional<uint64_t> LineIndex::FindNewline(std::span<const std::byte> data,
+	uint64_t dataOffset) const
+{
+	size_t index = 0;
+
+	while (index < data.size())
+	{
+		auto found = FindByte(data.subspan(index), LINE_FEED);
+
+		if (!found)
+		{
+			return std::nullopt;
+		}
+
+		index += *found;
+
+		if (IsNewlineAt(data, index, dataOffset))
+		{
+			return dataOffset + index - (m_encoding == TextEncoding::Utf16BE ? 1 : 0);
+		}
+
+		index++;
+	}
+
+	return std::nullopt;
+}
+
+// In UTF-16, a line feed byte can also be one half of an unrelated character (e.g. U+4E0A), so the
+// byte's position within its code unit, along with the other half of the unit, has to be checked.
+bool LineIndex::IsNewlineAt(std::span<const std::byte> data, size_t index,
+	uint64_t dataOffset) const
+{
+	uint64_t relativeOffset = dataOffset + index - m_startOffset;
+
+	switch (m_encoding)
+	{
+	case TextEncoding::Utf16LE:
+		return relativeOffset % 2 == 0 && index + 1 < data.size()
+			&& data[index + 1] == std::byte{ 0 };
+
+	case TextEncoding::Utf16BE:
+		return relativeOffset % 2 == 1 && index >= 1 && data[index - 1] == std::byte{ 0 };
+
+	default:
+		return true;
+	}
+}
+
+std::optional<uint64_t> LineIndex::FindNextNewline(uint64_t offset, uint64_t endOffset,
+	MappedFileReader &reader) const
+{
+	while (offset < endOffset)
+	{
+		auto data = reader.Read(offset,
+			static_cast<size_t>(std::min<uint64_t>(MappedFileReader::MAX_READ_SIZE,
+				endOffset - offset)));
+
+		if (data.empty())
+		{
+			return std::nullopt;
+		}
+
+		if (auto newline = FindNewline(data, offset))
+		{
+			return newline;
+		}
+
+		offset += data.size();
+	}
+
+	return std::nullopt;
+}
+
+LineRange LineIndex::MakeLineRange(uint64_t lineStart, std::optional<uint64_t> newlineOffset,
+	MappedFileReader &reader) const
+{
+	size_t unitSize = GetCodeUnitSize(m_encoding);
+	uint64_t lineEnd = newlineOffset.value_or(m_file->GetSize());
+
+	if (lineEnd - lineStart >= unitSize)
+	{
+		auto lastUnit = reader.Read(lineEnd - unitSize, unitSize);
+		bool isCarriageReturn = lastUnit.size() == unitSize
+			&& lastUnit[m_encoding == TextEncoding::Utf16BE ? 1 : 0] == CARRIAGE_RETURN
+			&& (unitSize == 1 || lastUnit[m_encoding == TextEncoding::Utf16BE ? 0 : 1]
+					== std::byte{ 0 });
+
+		if (isCarriageReturn)
+		{
+			lineEnd -= unitSize;
+		}
+	}
+
+	return { lineStart, lineEnd - lineStart };
+}
+
+bool LineIndex::IsComplete() const
+{
+	return m_complete;
+}
+
+uint64_t LineIndex::GetNumBytesScanned() const
+{
+	return m_numBytesScanned;
+}
+
+uint64_t LineIndex::GetNumLines() const
+{
+	// m_complete is only set once m_numNewlines has its final value, so it needs to be read first.
+	bool complete = m_complete;
+	uint64_t numNewlines = m_numNewlines;
+	return complete ? numNewlines + 1 : numNewlines;
+}
+
+std::vector<LineRange> LineIndex::GetLines(uint64_t firstLine, size_t maxLines,
+	MappedFileReader &reader) const
+{
+	bool complete = m_complete;
+	uint64_t numNewlines = m_numNewlines;
+	uint64_t numLines = complete ? numNewlines + 1 : numNewlines;
+
+	if (firstLine >= numLines)
+	{
+		return {};
+	}
+
+	uint64_t line = firstLine - firstLine % CHECKPOINT_INTERVAL;
+	uint64_t lineStart;
+
+	{
+		std::scoped_lock lock(m_checkpointsMutex);
+		lineStart = m_checkpoints[firstLine / CHECKPOINT_INTERVAL];
+	}
+
+	size_t unitSize = GetCodeUnitSize(m_encoding);
+	uint64_t fileSize = m_file->GetSize();
+	uint64_t endLine = std::min(numLines, firstLine + maxLines);
+	std::vector<LineRange> lines;
+
+	for (; line < endLine; line++)
+	{
+		// Every line other than the last one is known to be followed by a newline.
+		std::optional<uint64_t> newline;
+
+		if (line < numNewlines)
+		{
+			newline = FindNextNewline(lineStart, fileSize, reader);
+
+			if (!newline)
+			{
+				break;
+			}
+		}
+
+		if (line >= firstLine)
+		{
+			lines.push_back(MakeLineRange(lineStart, newline, reader));
+		}
+
+		if (newline)
+		{
+			lineStart = *newline + unitSize;
+		}
+	}
+
+	return lines;
+}
+
+std::optional<uint64_t> LineIndex::GetLineForOffset(uint64_t offset,
+	MappedFileReader &reader) const
+{
+	if (offset < m_startOffset)
+	{
+		return 0;
+	}
+
+	uint64_t fileSize = m_file->GetSize();
+
+	if (!m_complete && offset >= m_numBytesScanned)
+	{
+		return std::nullopt;
+	}
+
+	uint64_t line;
+	uint64_t position;
+
+	{
+		std::scoped_lock lock(m_checkpointsMutex);
+		auto itr = std::upper_bound(m_checkpoints.begin(), m_checkpoints.end(), offset);
+		auto index = static_cast<uint64_t>(std::distance(m_checkpoints.begin(), itr) - 1);
+		line = index * CHECKPOINT_INTERVAL;
+		position = m_checkpoints[index];
+	}
+
+	// The search range is extended by a code unit, so that a newline that starts just before the
+	// offset is still found in full.
+	size_t unitSize = GetCodeUnitSize(m_encoding);
+	uint64_t searchEnd = std::min(offset + unitSize, fileSize);
+
+	while (auto newline = FindNextNewline(position, searchEnd, reader))
+	{
+		if (*newline >= offset)
+		{
+			break;
+		}
+
+		line++;
+		position = *newline + unitSize;
+	}
+
+	return line;
+}
+
+size_t LineIndex::GetNumCheckpoints() const
+{
+	std::scoped_lock lock(m_checkpointsMutex);
+	return m_checkpoints.size();
+}
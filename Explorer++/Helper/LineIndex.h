@@ -0,0 +1,101 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#pragma once
+
+#include "TextEncoding.h"
+#include <boost/core/noncopyable.hpp>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <stop_token>
+#include <vector>
+
+class MappedFile;
+class MappedFileReader;
+
+struct LineRange
+{
+	uint64_t offset;
+
+	// The length, in bytes, of the line, excluding the line terminator ("\n" or "\r\n").
+	uint64_t length;
+};
+
+// An index of the lines in a text file, built by scanning the file in the background.
+//
+// To keep memory usage bounded, regardless of how many lines the file has, only the offset of
+// every CHECKPOINT_INTERVAL-th line is stored. The offset of any other line is found by scanning
+// forward from the preceding checkpoint. Lines can be looked up while the index is still being
+// built, as long as they're within the part of the file that's already been scanned.
+class LineIndex : private boost::noncopyable
+{
+public:
+	static constexpr uint64_t CHECKPOINT_INTERVAL = 1024;
+
+	// The first line starts at startOffset, which allows a byte order mark to be skipped.
+	LineIndex(std::shared_ptr<const MappedFile> file, TextEncoding encoding, uint64_t startOffset);
+
+	// Scans the file, adding checkpoints as it goes. This should be called once, typically on a
+	// background thread. All other methods can be called from any thread while the scan is in
+	// progress.
+	void Build(std::stop_token stopToken = {});
+
+	// True once the entire file has been scanned.
+	bool IsComplete() const;
+
+	uint64_t GetNumBytesScanned() const;
+
+	// Returns the number of lines that are currently known. Until the index is complete, this only
+	// includes lines whose terminator has been found. Once complete, this is the total number of
+	// lines, which includes the (possibly empty) line after the last terminator.
+	uint64_t GetNumLines() const;
+
+	// Returns up to maxLines lines, starting from firstLine. Fewer lines are returned if the end of
+	// the known lines is reached.
+	std::vector<LineRange> GetLines(uint64_t firstLine, size_t maxLines,
+		MappedFileReader &reader) const;
+
+	// Returns the line that contains the specified offset, provided that part of the file has been
+	// scanned.
+	std::optional<uint64_t> GetLineForOffset(uint64_t offset, MappedFileReader &reader) const;
+
+	size_t GetNumCheckpoints() const;
+
+private:
+	static constexpr size_t SCAN_CHUNK_SIZE = 16 * 1024 * 1024;
+
+	// Newlines are counted a block at a time, with individual newlines only located in a block
+	// that contains a checkpoint.
+	static constexpr size_t COUNT_BLOCK_SIZE = 4096;
+
+	void ScanBlock(std::span<const std::byte> block, uint64_t blockOffset, uint64_t &numNewlines);
+	void ScanBlockForNewlines(std::span<const std::byte> block, uint64_t blockOffset,
+		uint64_t &numNewlines);
+	void AddCheckpoint(uint64_t offset);
+
+	std::optional<uint64_t> FindNewline(std::span<const std::byte> data,
+		uint64_t dataOffset) const;
+	std::optional<uint64_t> FindNextNewline(uint64_t offset, uint64_t endOffset,
+		MappedFileReader &reader) const;
+	LineRange MakeLineRange(uint64_t lineStart, std::optional<uint64_t> newlineOffset,
+		MappedFileReader &reader) const;
+	bool IsNewlineAt(std::span<const std::byte> data, size_t index, uint64_t dataOffset) const;
+
+	const std::shared_ptr<const MappedFile> m_file;
+	const TextEncoding m_encoding;
+	const uint64_t m_startOffset;
+
+	mutable std::mutex m_checkpointsMutex;
+
+	// m_checkpoints[i] is the offset of line i * CHECKPOINT_INTERVAL.
+	std::vector<uint64_t> m_checkpoints;
+
+	std::atomic<uint64_t> m_numNewlines = 0;
+	std::atomic<uint64_t> m_numBytesScanned = 0;
+	std::atomic<bool> m_complete = false;
+};
@@ -0,0 +1,550 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "stdafx.h"
+#include "LocalPipe.h"
+#include <algorithm>
+#include <optional>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#endif
+
+#ifdef _WIN32
+
+namespace
+{
+
+constexpr DWORD PIPE_BUFFER_SIZE = 64 * 1024;
+
+std::wstring GetPipePath(const std::wstring &name)
+{
+	return L"\\\\.\\pipe\\" + name;
+}
+
+wil::unique_hfile CreatePipeInstance(const std::wstring &path, bool firstInstance)
+{
+	DWORD openMode = PIPE_ACCESS_DUPLEX | FILE_FLAG_OVERLAPPED;
+
+	// Creating the first instance will fail if a pipe with the same name already exists, which is
+	// what allows only a single server to own the name.
+	if (firstInstance)
+	{
+		openMode |= FILE_FLAG_FIRST_PIPE_INSTANCE;
+	}
+
+	return wil::unique_hfile(CreateNamedPipe(path.c_str(), openMode,
+		PIPE_TYPE_BYTE | PIPE_READMODE_BYTE | PIPE_WAIT | PIPE_REJECT_REMOTE_CLIENTS,
+		PIPE_UNLIMITED_INSTANCES, PIPE_BUFFER_SIZE, PIPE_BUFFER_SIZE, 0, nullptr));
+}
+
+DWORD GetTimeoutMilliseconds(std::chrono::milliseconds timeout)
+{
+	return static_cast<DWORD>(
+		std::clamp<std::chrono::milliseconds::rep>(timeout.count(), 0, INFINITE - 1));
+}
+
+// Waits for an overlapped operation that's already been started. If the operation doesn't finish
+// within the timeout, or the stop event is signaled first, the operation is cancelled.
+std::optional<DWORD> WaitForOverlappedResult(HANDLE handle, OVERLAPPED *overlapped, DWORD timeout,
+	HANDLE stopEvent = nullptr)
+{
+	HANDLE events[] = { overlapped->hEvent, stopEvent };
+	DWORD waitResult =
+		WaitForMultipleObjects(stopEvent ? 2 : 1, events, FALSE, timeout);
+
+	DWORD numBytesTransferred;
+
+	if (waitResult != WAIT_OBJECT_0)
+	{
+		CancelIoEx(handle, overlapped);
+
+		// The OVERLAPPED structure can't be freed until the operation has actually finished.
+		GetOverlappedResult(handle, overlapped, &numBytesTransferred, TRUE);
+		return std::nullopt;
+	}
+
+	if (!GetOverlappedResult(handle, overlapped, &numBytesTransferred, FALSE))
+	{
+		return std::nullopt;
+	}
+
+	return numBytesTransferred;
+}
+
+template <typename StartOperation>
+std::optional<DWORD> RunOverlappedOperation(HANDLE handle, std::chrono::milliseconds timeout,
+	StartOperation startOperation)
+{
+	wil::unique_event_failfast event;
+	event.create(wil::EventOptions::ManualReset);
+
+	OVERLAPPED overlapped = {};
+	overlapped.hEvent = event.get();
+
+	// The number of bytes transferred is always retrieved from the OVERLAPPED structure, even if
+	// the operation finishes immediately.
+	if (!startOperation(&overlapped) && GetLastError() != ERROR_IO_PENDING)
+	{
+		return std::nullopt;
+	}
+
+	return WaitForOverlappedResult(handle, &overlapped, GetTimeoutMilliseconds(timeout));
+}
+
+}
+
+std::unique_ptr<LocalPipeConnection> LocalPipeConnection::Connect(const std::wstring &name,
+	std::chrono::milliseconds timeout)
+{
+	auto path = GetPipePath(name);
+	auto deadline = std::chrono::steady_clock::now() + timeout;
+
+	while (true)
+	{
+		// The server only needs to identify the client, not impersonate it.
+		wil::unique_hfile pipe(CreateFile(path.c_str(), GENERIC_READ | GENERIC_WRITE, 0, nullptr,
+			OPEN_EXISTING,
+			FILE_FLAG_OVERLAPPED | SECURITY_SQOS_PRESENT | SECURITY_IDENTIFICATION, nullptr));
+
+		if (pipe)
+		{
+			return std::unique_ptr<LocalPipeConnection>(
+				new LocalPipeConnection(std::move(pipe), false));
+		}
+
+		if (GetLastError() != ERROR_PIPE_BUSY)
+		{
+			return nullptr;
+		}
+
+		// Every instance of the pipe is in use. The server creates a new instance each time a
+		// client connects, so one should become available shortly.
+		auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+			deadline - std::chrono::steady_clock::now());
+
+		if (remaining.count() <= 0
+			|| !WaitNamedPipe(path.c_str(), GetTimeoutMilliseconds(remaining)))
+		{
+			return nullptr;
+		}
+	}
+}
+
+LocalPipeConnection::LocalPipeConnection(wil::unique_hfile pipe, bool isServerEnd) :
+	m_pipe(std::move(pipe)),
+	m_isServerEnd(isServerEnd)
+{
+}
+
+LocalPipeConnection::~LocalPipeConnection() = default;
+
+bool LocalPipeConnection::Write(std::span<const std::byte> data, std::chrono::milliseconds timeout)
+{
+	while (!data.empty())
+	{
+		auto numBytesToWrite = static_cast<DWORD>(std::min<size_t>(data.size(), PIPE_BUFFER_SIZE));
+		auto numBytesWritten = RunOverlappedOperation(m_pipe.get(), timeout,
+			[this, data, numBytesToWrite](OVERLAPPED *overlapped) {
+				return WriteFile(m_pipe.get(), data.data(), numBytesToWrite, nullptr, overlapped);
+			});
+
+		if (!numBytesWritten || *numBytesWritten == 0)
+		{
+			return false;
+		}
+
+		data = data.subspan(*numBytesWritten);
+	}
+
+	return true;
+}
+
+size_t LocalPipeConnection::Read(std::span<std::byte> data, std::chrono::milliseconds timeout)
+{
+	auto numBytesToRead = static_cast<DWORD>(std::min<size_t>(data.size(), PIPE_BUFFER_SIZE));
+	auto numBytesRead = RunOverlappedOperation(m_pipe.get(), timeout,
+		[this, data, numBytesToRead](OVERLAPPED *overlapped)
+		{ return ReadFile(m_pipe.get(), data.data(), numBytesToRead, nullptr, overlapped); });
+
+	return numBytesRead.value_or(0);
+}
+
+uint32_t LocalPipeConnection::GetPeerProcessId() const
+{
+	ULONG processId;
+	BOOL res = m_isServerEnd ? GetNamedPipeClientProcessId(m_pipe.get(), &processId)
+							 : GetNamedPipeServerProcessId(m_pipe.get(), &processId);
+
+	return res ? processId : 0;
+}
+
+std::unique_ptr<LocalPipeServer> LocalPipeServer::Create(const std::wstring &name)
+{
+	auto path = GetPipePath(name);
+	auto pipe = CreatePipeInstance(path, true);
+
+	if (!pipe)
+	{
+		return nullptr;
+	}
+
+	return std::unique_ptr<LocalPipeServer>(new LocalPipeServer(path, std::move(pipe)));
+}
+
+LocalPipeServer::LocalPipeServer(std::wstring path, wil::unique_hfile pendingPipe) :
+	m_path(std::move(path)),
+	m_pendingPipe(std::move(pendingPipe))
+{
+	m_stopEvent.create(wil::EventOptions::ManualReset);
+}
+
+LocalPipeServer::~LocalPipeServer() = default;
+
+std::unique_ptr<LocalPipeConnection> LocalPipeServer::Accept()
+{
+	while (WaitForSingleObject(m_stopEvent.get(), 0) != WAIT_OBJECT_0)
+	{
+		if (!m_pendingPipe)
+		{
+			m_pendingPipe = CreatePipeInstance(m_path, false);
+
+			if (!m_pendingPipe)
+			{
+				return nullptr;
+			}
+		}
+
+		wil::unique_event_failfast connectEvent;
+		connectEvent.create(wil::EventOptions::ManualReset);
+
+		OVERLAPPED overlapped = {};
+		overlapped.hEvent = connectEvent.get();
+
+		bool connected = false;
+		ConnectNamedPipe(m_pendingPipe.get(), &overlapped);
+
+		switch (GetLastError())
+		{
+		// A client connected between the instance being created and the call above.
+		case ERROR_PIPE_CONNECTED:
+			connected = true;
+			break;
+
+		case ERROR_IO_PENDING:
+			connected = WaitForOverlappedResult(m_pendingPipe.get(), &overlapped, INFINITE,
+				m_stopEvent.get())
+							.has_value();
+			break;
+
+		// The client closed its end of the pipe before the connection was completed.
+		case ERROR_NO_DATA:
+			break;
+
+		default:
+			return nullptr;
+		}
+
+		if (connected)
+		{
+			auto connection = std::unique_ptr<LocalPipeConnection>(
+				new LocalPipeConnection(std::move(m_pendingPipe), true));
+
+			// If this fails, another attempt will be made the next time this method is called.
+			m_pendingPipe = CreatePipeInstance(m_path, false);
+
+			return connection;
+		}
+
+		// The instance can't be used for another connection until it's been disconnected.
+		DisconnectNamedPipe(m_pendingPipe.get());
+	}
+
+	return nullptr;
+}
+
+void LocalPipeServer::Stop()
+{
+	m_stopEvent.SetEvent();
+}
+
+#else
+
+namespace
+{
+
+std::filesystem::path GetSocketPath(const std::wstring &name)
+{
+	return std::filesystem::temp_directory_path() / (name + L".sock");
+}
+
+bool GetSocketAddress(const std::filesystem::path &path, sockaddr_un &address)
+{
+	const auto &nativePath = path.native();
+
+	if (nativePath.size() >= sizeof(address.sun_path))
+	{
+		return false;
+	}
+
+	address = {};
+	address.sun_family = AF_UNIX;
+	std::memcpy(address.sun_path, nativePath.c_str(), nativePath.size() + 1);
+
+	return true;
+}
+
+int ConnectSocket(const std::filesystem::path &path, std::chrono::milliseconds timeout)
+{
+	sockaddr_un address;
+
+	if (!GetSocketAddress(path, address))
+	{
+		return -1;
+	}
+
+	int socketFd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+
+	if (socketFd == -1)
+	{
+		return -1;
+	}
+
+	// Connecting will only block if the server's backlog is full. The send timeout limits how long
+	// that can take.
+	timeval sendTimeout = {};
+	sendTimeout.tv_sec = static_cast<time_t>(timeout.count() / 1000);
+	sendTimeout.tv_usec = static_cast<suseconds_t>((timeout.count() % 1000) * 1000);
+	setsockopt(socketFd, SOL_SOCKET, SO_SNDTIMEO, &sendTimeout, sizeof(sendTimeout));
+
+	if (connect(socketFd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0)
+	{
+		close(socketFd);
+		return -1;
+	}
+
+	return socketFd;
+}
+
+bool WaitForSocket(int socketFd, short events, std::chrono::milliseconds timeout)
+{
+	pollfd pollFd = { socketFd, events, 0 };
+	int res;
+
+	do
+	{
+		res = poll(&pollFd, 1, static_cast<int>(timeout.count()));
+	} while (res == -1 && errno == EINTR);
+
+	return res > 0;
+}
+
+}
+
+std::unique_ptr<LocalPipeConnection> LocalPipeConnection::Connect(const std::wstring &name,
+	std::chrono::milliseconds timeout)
+{
+	int socketFd = ConnectSocket(GetSocketPath(name), timeout);
+
+	if (socketFd == -1)
+	{
+		return nullptr;
+	}
+
+	return std::unique_ptr<LocalPipeConnection>(new LocalPipeConnection(socketFd));
+}
+
+LocalPipeConnection::LocalPipeConnection(int socket) : m_socket(socket)
+{
+}
+
+LocalPipeConnection::~LocalPipeConnection()
+{
+	close(m_socket);
+}
+
+bool LocalPipeConnection::Write(std::span<const std::byte> data, std::chrono::milliseconds timeout)
+{
+	while (!data.empty())
+	{
+		if (!WaitForSocket(m_socket, POLLOUT, timeout))
+		{
+			return false;
+		}
+
+		// MSG_NOSIGNAL stops the process from being sent SIGPIPE if the other end has closed the
+		// connection.
+		ssize_t res = send(m_socket, data.data(), data.size(), MSG_NOSIGNAL);
+
+		if (res == -1 && errno == EINTR)
+		{
+			continue;
+		}
+
+		if (res <= 0)
+		{
+			return false;
+		}
+
+		data = data.subspan(static_cast<size_t>(res));
+	}
+
+	return true;
+}
+
+size_t LocalPipeConnection::Read(std::span<std::byte> data, std::chrono::milliseconds timeout)
+{
+	if (!WaitForSocket(m_socket, POLLIN, timeout))
+	{
+		return 0;
+	}
+
+	ssize_t res;
+
+	do
+	{
+		res = recv(m_socket, data.data(), data.size(), 0);
+	} while (res == -1 && errno == EINTR);
+
+	return res > 0 ? static_cast<size_t>(res) : 0;
+}
+
+uint32_t LocalPipeConnection::GetPeerProcessId() const
+{
+#ifdef SO_PEERCRED
+	ucred credentials;
+	socklen_t credentialsSize = sizeof(credentials);
+
+	if (getsockopt(m_socket, SOL_SOCKET, SO_PEERCRED, &credentials, &credentialsSize) != 0)
+	{
+		return 0;
+	}
+
+	return static_cast<uint32_t>(credentials.pid);
+#else
+	return 0;
+#endif
+}
+
+std::unique_ptr<LocalPipeServer> LocalPipeServer::Create(const std::wstring &name)
+{
+	auto path = GetSocketPath(name);
+	sockaddr_un address;
+
+	if (!GetSocketAddress(path, address))
+	{
+		return nullptr;
+	}
+
+	int listenSocket = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+
+	if (listenSocket == -1)
+	{
+		return nullptr;
+	}
+
+	int res = bind(listenSocket, reinterpret_cast<sockaddr *>(&address), sizeof(address));
+
+	if (res != 0 && errno == EADDRINUSE)
+	{
+		// The socket file isn't removed if the process that created it exits unexpectedly. If
+		// nothing is listening on the socket, it's stale and can be replaced. Note that if there
+		// is a server, it will see this as a connection that's closed without any data being
+		// sent.
+		int existingSocket = ConnectSocket(path, std::chrono::milliseconds(100));
+
+		if (existingSocket != -1)
+		{
+			close(existingSocket);
+			close(listenSocket);
+			return nullptr;
+		}
+
+		unlink(path.c_str());
+		res = bind(listenSocket, reinterpret_cast<sockaddr *>(&address), sizeof(address));
+	}
+
+	if (res != 0 || listen(listenSocket, SOMAXCONN) != 0)
+	{
+		close(listenSocket);
+		return nullptr;
+	}
+
+	// Accept() waits on the read end of this pipe, which allows Stop() to interrupt it.
+	int stopFds[2];
+
+	if (pipe2(stopFds, O_CLOEXEC) != 0)
+	{
+		close(listenSocket);
+		unlink(path.c_str());
+		return nullptr;
+	}
+
+	return std::unique_ptr<LocalPipeServer>(
+		new LocalPipeServer(path, listenSocket, stopFds[0], stopFds[1]));
+}
+
+LocalPipeServer::LocalPipeServer(std::filesystem::path path, int listenSocket, int stopReadFd,
+	int stopWriteFd) :
+	m_path(std::move(path)),
+	m_listenSocket(listenSocket),
+	m_stopReadFd(stopReadFd),
+	m_stopWriteFd(stopWriteFd)
+{
+}
+
+LocalPipeServer::~LocalPipeServer()
+{
+	close(m_listenSocket);
+	close(m_stopReadFd);
+	close(m_stopWriteFd);
+	unlink(m_path.c_str());
+}
+
+std::unique_ptr<LocalPipeConnection> LocalPipeServer::Accept()
+{
+	while (true)
+	{
+		pollfd pollFds[] = { { m_listenSocket, POLLIN, 0 }, { m_stopReadFd, POLLIN, 0 } };
+		int res = poll(pollFds, std::size(pollFds), -1);
+
+		if (res == -1 && errno == EINTR)
+		{
+			continue;
+		}
+
+		// The stop pipe is never read from, so once Stop() has been called, this will return
+		// immediately.
+		if (res == -1 || pollFds[1].revents != 0)
+		{
+			return nullptr;
+		}
+
+		int socketFd = accept4(m_listenSocket, nullptr, nullptr, SOCK_CLOEXEC);
+
+		if (socketFd != -1)
+		{
+			return std::unique_ptr<LocalPipeConnection>(new LocalPipeConnection(socketFd));
+		}
+
+		if (errno != EINTR && errno != ECONNABORTED && errno != EAGAIN)
+		{
+			return nullptr;
+		}
+	}
+}
+
+void LocalPipeServer::Stop()
+{
+	char value = 0;
+	[[maybe_unused]] auto res = write(m_stopWriteFd, &value, sizeof(value));
+}
+
+#endif
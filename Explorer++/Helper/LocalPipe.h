@@ -0,0 +1,93 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#pragma once
+
+#include <boost/core/noncopyable.hpp>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+
+#ifdef _WIN32
+#include <wil/resource.h>
+#else
+#include <filesystem>
+#endif
+
+// A bidirectional byte stream between two processes on the same machine. On Windows, this is a
+// named pipe that rejects remote clients. Elsewhere, it's a Unix domain socket (which allows the
+// code that uses it to be tested on any platform).
+class LocalPipeConnection : private boost::noncopyable
+{
+public:
+	// Returns null if there's no server listening on the specified pipe, or if the connection
+	// couldn't be established within the timeout.
+	static std::unique_ptr<LocalPipeConnection> Connect(const std::wstring &name,
+		std::chrono::milliseconds timeout);
+
+	~LocalPipeConnection();
+
+	// Writes all of the data, returning false on failure.
+	bool Write(std::span<const std::byte> data, std::chrono::milliseconds timeout);
+
+	// Reads up to data.size() bytes. Returns the number of bytes read, which will be 0 if the other
+	// end closed the connection, an error occurred, or no data arrived within the timeout.
+	size_t Read(std::span<std::byte> data, std::chrono::milliseconds timeout);
+
+	// Returns 0 if the process ID can't be retrieved.
+	uint32_t GetPeerProcessId() const;
+
+private:
+	friend class LocalPipeServer;
+
+#ifdef _WIN32
+	LocalPipeConnection(wil::unique_hfile pipe, bool isServerEnd);
+
+	const wil::unique_hfile m_pipe;
+	const bool m_isServerEnd;
+#else
+	explicit LocalPipeConnection(int socket);
+
+	const int m_socket;
+#endif
+};
+
+class LocalPipeServer : private boost::noncopyable
+{
+public:
+	// Returns null if the pipe couldn't be created, which includes the case where another server
+	// is already listening on it.
+	static std::unique_ptr<LocalPipeServer> Create(const std::wstring &name);
+
+	~LocalPipeServer();
+
+	// Blocks until a client connects. Returns null once Stop() has been called.
+	std::unique_ptr<LocalPipeConnection> Accept();
+
+	// Causes any current and future calls to Accept() to return. Can be called from any thread.
+	void Stop();
+
+private:
+#ifdef _WIN32
+	LocalPipeServer(std::wstring path, wil::unique_hfile pendingPipe);
+
+	const std::wstring m_path;
+
+	// An instance of the pipe is always kept available, so that the name stays owned by this
+	// server between connections.
+	wil::unique_hfile m_pendingPipe;
+
+	wil::unique_event_failfast m_stopEvent;
+#else
+	LocalPipeServer(std::filesystem::path path, int listenSocket, int stopReadFd, int stopWriteFd);
+
+	const std::filesystem::path m_path;
+	const int m_listenSocket;
+	const int m_stopReadFd;
+	const int m_stopWriteFd;
+#endif
+};
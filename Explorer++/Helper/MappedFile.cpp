@@ -0,0 +1,246 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "stdafx.h"
+#include "MappedFile.h"
+#include <algorithm>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+
+std::shared_ptr<MappedFile> MappedFile::Open(const std::filesystem::path &path)
+{
+	// Other processes are still allowed to write to the file (e.g. a log file that's in use), since
+	// the file is only being viewed.
+	wil::unique_hfile file(CreateFile(path.c_str(), GENERIC_READ,
+		FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING,
+		FILE_ATTRIBUTE_NORMAL, nullptr));
+
+	if (!file)
+	{
+		return nullptr;
+	}
+
+	LARGE_INTEGER size;
+
+	if (!GetFileSizeEx(file.get(), &size))
+	{
+		return nullptr;
+	}
+
+	wil::unique_handle mapping;
+
+	if (size.QuadPart > 0)
+	{
+		mapping.reset(CreateFileMapping(file.get(), nullptr, PAGE_READONLY, 0, 0, nullptr));
+
+		if (!mapping)
+		{
+			return nullptr;
+		}
+	}
+
+	return std::shared_ptr<MappedFile>(
+		new MappedFile(std::move(file), std::move(mapping), size.QuadPart));
+}
+
+MappedFile::MappedFile(wil::unique_hfile file, wil::unique_handle mapping, uint64_t size) :
+	m_file(std::move(file)),
+	m_mapping(std::move(mapping)),
+	m_size(size)
+{
+}
+
+MappedFile::~MappedFile() = default;
+
+size_t MappedFile::GetAllocationGranularity()
+{
+	SYSTEM_INFO systemInfo;
+	GetSystemInfo(&systemInfo);
+	return systemInfo.dwAllocationGranularity;
+}
+
+#else
+
+std::shared_ptr<MappedFile> MappedFile::Open(const std::filesystem::path &path)
+{
+	int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+
+	if (fd == -1)
+	{
+		return nullptr;
+	}
+
+	struct stat fileInfo;
+
+	if (fstat(fd, &fileInfo) != 0 || !S_ISREG(fileInfo.st_mode))
+	{
+		close(fd);
+		return nullptr;
+	}
+
+	return std::shared_ptr<MappedFile>(new MappedFile(fd, fileInfo.st_size));
+}
+
+MappedFile::MappedFile(int fd, uint64_t size) : m_fd(fd), m_size(size)
+{
+}
+
+MappedFile::~MappedFile()
+{
+	close(m_fd);
+}
+
+size_t MappedFile::GetAllocationGranularity()
+{
+	return static_cast<size_t>(sysconf(_SC_PAGESIZE));
+}
+
+#endif
+
+uint64_t MappedFile::GetSize() const
+{
+	return m_size;
+}
+
+std::unique_ptr<MappedFileView> MappedFile::MapView(uint64_t offset, size_t length) const
+{
+	if (offset >= m_size || length == 0)
+	{
+		return std::unique_ptr<MappedFileView>(new MappedFileView(nullptr, 0, offset, {}));
+	}
+
+	size_t clampedLength = static_cast<size_t>(std::min<uint64_t>(length, m_size - offset));
+	uint64_t alignedOffset = offset - offset % GetAllocationGranularity();
+	auto leadingSize = static_cast<size_t>(offset - alignedOffset);
+	size_t mappedSize = leadingSize + clampedLength;
+
+#ifdef _WIN32
+	void *base = MapViewOfFile(m_mapping.get(), FILE_MAP_READ,
+		static_cast<DWORD>(alignedOffset >> 32), static_cast<DWORD>(alignedOffset), mappedSize);
+
+	if (!base)
+	{
+		return nullptr;
+	}
+#else
+	void *base = mmap(nullptr, mappedSize, PROT_READ, MAP_SHARED, m_fd,
+		static_cast<off_t>(alignedOffset));
+
+	if (base == MAP_FAILED)
+	{
+		return nullptr;
+	}
+#endif
+
+	std::span<const std::byte> data(static_cast<const std::byte *>(base) + leadingSize,
+		clampedLength);
+	return std::unique_ptr<MappedFileView>(new MappedFileView(base, mappedSize, offset, data));
+}
+
+MappedFileView::MappedFileView(void *base, size_t mappedSize, uint64_t offset,
+	std::span<const std::byte> data) :
+	m_base(base),
+	m_mappedSize(mappedSize),
+	m_offset(offset),
+	m_data(data)
+{
+}
+
+MappedFileView::~MappedFileView()
+{
+	if (!m_base)
+	{
+		return;
+	}
+
+#ifdef _WIN32
+	UnmapViewOfFile(m_base);
+#else
+	munmap(m_base, m_mappedSize);
+#endif
+}
+
+uint64_t MappedFileView::GetOffset() const
+{
+	return m_offset;
+}
+
+std::span<const std::byte> MappedFileView::GetData() const
+{
+	return m_data;
+}
+
+MappedFileReader::MappedFileReader(std::shared_ptr<const MappedFile> file, size_t windowSize,
+	size_t maxWindows) :
+	m_file(std::move(file)),
+	m_windowSize(windowSize),
+	m_maxWindows(std::max(maxWindows, size_t{ 1 }))
+{
+	DCHECK_EQ(m_windowSize % MappedFile::GetAllocationGranularity(), 0u);
+}
+
+const MappedFile &MappedFileReader::GetFile() const
+{
+	return *m_file;
+}
+
+std::span<const std::byte> MappedFileReader::Read(uint64_t offset, size_t length)
+{
+	DCHECK_LE(length, MAX_READ_SIZE);
+
+	if (offset >= m_file->GetSize())
+	{
+		return {};
+	}
+
+	const auto *window = GetWindow(offset / m_windowSize);
+
+	if (!window)
+	{
+		return {};
+	}
+
+	auto data = window->GetData();
+	auto start = static_cast<size_t>(offset - window->GetOffset());
+	return data.subspan(start, std::min(length, data.size() - start));
+}
+
+const MappedFileView *MappedFileReader::GetWindow(uint64_t index)
+{
+	auto itr = std::find_if(m_windows.begin(), m_windows.end(),
+		[index](const Window &window) { return window.index == index; });
+
+	if (itr != m_windows.end())
+	{
+		std::rotate(itr, itr + 1, m_windows.end());
+		return m_windows.back().view.get();
+	}
+
+	auto view = m_file->MapView(index * m_windowSize, m_windowSize + MAX_READ_SIZE);
+
+	if (!view)
+	{
+		return nullptr;
+	}
+
+	if (m_windows.size() == m_maxWindows)
+	{
+		m_windows.erase(m_windows.begin());
+	}
+
+	m_windows.push_back({ index, std::move(view) });
+	return m_windows.back().view.get();
+}
+
+size_t MappedFileReader::GetNumMappedWindows() const
+{
+	return m_windows.size();
+}
@@ -0,0 +1,122 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#pragma once
+
+#include <boost/core/noncopyable.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <span>
+#include <vector>
+
+#ifdef _WIN32
+#include <wil/resource.h>
+#endif
+
+class MappedFileView;
+
+// A read-only memory mapping of a file. Rather than mapping the entire file at once (which, for a
+// multi-gigabyte file, would use a large amount of address space), individual views of the file
+// are mapped as needed.
+//
+// Note that, outside of Windows, truncating the file while a view is mapped will cause accesses
+// beyond the new end of the file to fault. On Windows, a file can't be truncated while it's mapped.
+class MappedFile : private boost::noncopyable
+{
+public:
+	// Returns null if the file can't be opened.
+	static std::shared_ptr<MappedFile> Open(const std::filesystem::path &path);
+
+	~MappedFile();
+
+	uint64_t GetSize() const;
+
+	// Maps the specified range, which is clamped to the end of the file. The offset doesn't need to
+	// be aligned. Returns null if the view couldn't be mapped. This can be called from multiple
+	// threads at once.
+	std::unique_ptr<MappedFileView> MapView(uint64_t offset, size_t length) const;
+
+	// Views are mapped at offsets that are a multiple of this value.
+	static size_t GetAllocationGranularity();
+
+private:
+#ifdef _WIN32
+	MappedFile(wil::unique_hfile file, wil::unique_handle mapping, uint64_t size);
+
+	const wil::unique_hfile m_file;
+
+	// Empty files can't be mapped, so this will be null if the file is empty.
+	const wil::unique_handle m_mapping;
+#else
+	MappedFile(int fd, uint64_t size);
+
+	const int m_fd;
+#endif
+
+	const uint64_t m_size;
+};
+
+class MappedFileView : private boost::noncopyable
+{
+public:
+	~MappedFileView();
+
+	uint64_t GetOffset() const;
+	std::span<const std::byte> GetData() const;
+
+private:
+	friend MappedFile;
+
+	MappedFileView(void *base, size_t mappedSize, uint64_t offset, std::span<const std::byte> data);
+
+	void *const m_base;
+	const size_t m_mappedSize;
+	const uint64_t m_offset;
+	const std::span<const std::byte> m_data;
+};
+
+// Provides access to arbitrary ranges of a mapped file, while keeping the amount of address space
+// that's in use bounded. The file is divided into fixed-size windows, each of which is mapped
+// along with an overlap into the next window, so that any range of up to MAX_READ_SIZE bytes can
+// be returned as a single span. Only the most recently used windows are kept mapped.
+//
+// A reader isn't thread-safe; each thread should use its own reader.
+class MappedFileReader : private boost::noncopyable
+{
+public:
+	static constexpr size_t MAX_READ_SIZE = 64 * 1024;
+	static constexpr size_t DEFAULT_WINDOW_SIZE = 16 * 1024 * 1024;
+	static constexpr size_t DEFAULT_MAX_WINDOWS = 4;
+
+	// The window size must be a multiple of the allocation granularity.
+	explicit MappedFileReader(std::shared_ptr<const MappedFile> file,
+		size_t windowSize = DEFAULT_WINDOW_SIZE, size_t maxWindows = DEFAULT_MAX_WINDOWS);
+
+	const MappedFile &GetFile() const;
+
+	// Returns the bytes in the range [offset, offset + length), clamped to the end of the file. The
+	// length can be at most MAX_READ_SIZE. The returned data remains valid until the next call.
+	// Returns an empty span if the range is beyond the end of the file, or couldn't be mapped.
+	std::span<const std::byte> Read(uint64_t offset, size_t length);
+
+	size_t GetNumMappedWindows() const;
+
+private:
+	struct Window
+	{
+		uint64_t index;
+		std::unique_ptr<MappedFileView> view;
+	};
+
+	const MappedFileView *GetWindow(uint64_t index);
+
+	const std::shared_ptr<const MappedFile> m_file;
+	const size_t m_windowSize;
+	const size_t m_maxWindows;
+
+	// Ordered from least to most recently used.
+	std::vector<Window> m_windows;
+};
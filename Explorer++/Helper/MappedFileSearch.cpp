@@ -0,0 +1,112 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "stdafx.h"
+#include "MappedFileSearch.h"
+#include "ByteSearch.h"
+#include "MappedFile.h"
+#include "ParallelFor.h"
+#include <algorithm>
+
+namespace
+{
+
+constexpr uint64_t SEARCH_CHUNK_SIZE = 32 * 1024 * 1024;
+
+bool IsAligned(uint64_t offset, const MappedFileSearchOptions &options)
+{
+	return offset >= options.alignmentBase
+		&& (offset - options.alignmentBase) % options.alignment == 0;
+}
+
+std::optional<uint64_t> SearchChunk(const MappedFile &file, std::span<const std::byte> pattern,
+	uint64_t chunkStart, uint64_t chunkEnd, const MappedFileSearchOptions &options)
+{
+	// The view extends past the end of the chunk, so that a match that starts within the chunk,
+	// but ends after it, can still be found.
+	auto chunkSize = static_cast<size_t>(chunkEnd - chunkStart);
+	auto view = file.MapView(chunkStart, chunkSize + pattern.size() - 1);
+
+	if (!view)
+	{
+		return std::nullopt;
+	}
+
+	auto data = view->GetData();
+	size_t index = 0;
+
+	while (index < chunkSize)
+	{
+		auto found = FindPattern(data.subspan(index), pattern, options.caseSensitive);
+
+		if (!found || index + *found >= chunkSize)
+		{
+			return std::nullopt;
+		}
+
+		uint64_t matchOffset = chunkStart + index + *found;
+
+		if (IsAligned(matchOffset, options))
+		{
+			return matchOffset;
+		}
+
+		index += *found + 1;
+	}
+
+	return std::nullopt;
+}
+
+}
+
+std::optional<uint64_t> SearchMappedFile(const MappedFile &file,
+	std::span<const std::byte> pattern, uint64_t startOffset, uint64_t endOffset,
+	const MappedFileSearchOptions &options, int numThreads, std::stop_token stopToken)
+{
+	endOffset = std::min(endOffset, file.GetSize());
+
+	if (startOffset >= endOffset)
+	{
+		return std::nullopt;
+	}
+
+	if (pattern.empty())
+	{
+		return startOffset;
+	}
+
+	uint64_t numChunks = (endOffset - startOffset + SEARCH_CHUNK_SIZE - 1) / SEARCH_CHUNK_SIZE;
+	auto batchSize = static_cast<uint64_t>(std::max(numThreads, 1));
+
+	// Chunks are searched in batches, with each batch covering one chunk per thread. Since the
+	// first match is wanted, there's no need to search any further once a batch contains a match.
+	for (uint64_t batchStart = 0; batchStart < numChunks; batchStart += batchSize)
+	{
+		auto numChunksInBatch = static_cast<size_t>(std::min(batchSize, numChunks - batchStart));
+		std::vector<std::optional<uint64_t>> results(numChunksInBatch);
+
+		ParallelFor(numChunksInBatch, numThreads, stopToken,
+			[&file, pattern, startOffset, endOffset, &options, batchStart, &results](size_t index)
+			{
+				uint64_t chunkStart = startOffset + (batchStart + index) * SEARCH_CHUNK_SIZE;
+				uint64_t chunkEnd = std::min(chunkStart + SEARCH_CHUNK_SIZE, endOffset);
+				results[index] = SearchChunk(file, pattern, chunkStart, chunkEnd, options);
+			});
+
+		if (stopToken.stop_requested())
+		{
+			return std::nullopt;
+		}
+
+		for (const auto &result : results)
+		{
+			if (result)
+			{
+				return result;
+			}
+		}
+	}
+
+	return std::nullopt;
+}
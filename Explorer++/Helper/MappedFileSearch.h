@@ -0,0 +1,32 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <stop_token>
+
+class MappedFile;
+
+struct MappedFileSearchOptions
+{
+	// If false, ASCII letters match either case.
+	bool caseSensitive = true;
+
+	// Only matches that start at alignmentBase + (n * alignment) are returned. This allows
+	// matches in UTF-16 text to be restricted to code unit boundaries.
+	size_t alignment = 1;
+	uint64_t alignmentBase = 0;
+};
+
+// Returns the offset of the first match of the pattern that starts within [startOffset, endOffset).
+// The file is split into chunks, which are searched in parallel using the specified number of
+// threads, with only the chunks currently being searched mapped at any one time. Returns an empty
+// value if there's no match, or the search was stopped.
+std::optional<uint64_t> SearchMappedFile(const MappedFile &file,
+	std::span<const std::byte> pattern, uint64_t startOffset, uint64_t endOffset,
+	const MappedFileSearchOptions &options, int numThreads, std::stop_token stopToken = {});
@@ -0,0 +1,87 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "stdafx.h"
+#include "PackedPidlList.h"
+
+PackedPidlList::PackedPidlList(PCIDLIST_ABSOLUTE parent, const std::vector<PidlAbsolute> &pidls)
+{
+	for (const auto &pidl : pidls)
+	{
+		if (!pidl.HasValue())
+		{
+			continue;
+		}
+
+		auto storageType = StorageType::Absolute;
+		auto *storedPidl = reinterpret_cast<const BYTE *>(pidl.Raw());
+
+		if (parent)
+		{
+			// Note that ILFindChild() returns a pointer into the original pidl, so nothing needs to
+			// be freed here.
+			if (auto *child = ILFindChild(parent, pidl.Raw()))
+			{
+				storageType = StorageType::Relative;
+				storedPidl = reinterpret_cast<const BYTE *>(child);
+			}
+		}
+
+		m_data.push_back(static_cast<BYTE>(storageType));
+		m_data.insert(m_data.end(), storedPidl,
+			storedPidl + ILGetSize(reinterpret_cast<PCUIDLIST_RELATIVE>(storedPidl)));
+		m_numPidls++;
+	}
+
+	m_data.shrink_to_fit();
+}
+
+std::vector<PidlAbsolute> PackedPidlList::Unpack(PCIDLIST_ABSOLUTE parent) const
+{
+	std::vector<PidlAbsolute> pidls;
+	pidls.reserve(m_numPidls);
+
+	size_t offset = 0;
+
+	while (offset < m_data.size())
+	{
+		auto storageType = static_cast<StorageType>(m_data[offset]);
+		offset++;
+
+		// Item IDs are byte-packed, so there are no alignment requirements here.
+		auto *storedPidl = reinterpret_cast<PCUIDLIST_RELATIVE>(m_data.data() + offset);
+		offset += ILGetSize(storedPidl);
+
+		PidlAbsolute pidl;
+
+		if (storageType == StorageType::Relative)
+		{
+			DCHECK(parent);
+			pidl.TakeOwnership(ILCombine(parent, storedPidl));
+		}
+		else
+		{
+			pidl.TakeOwnership(ILCloneFull(reinterpret_cast<PCIDLIST_ABSOLUTE>(storedPidl)));
+		}
+
+		pidls.push_back(std::move(pidl));
+	}
+
+	return pidls;
+}
+
+bool PackedPidlList::IsEmpty() const
+{
+	return m_numPidls == 0;
+}
+
+size_t PackedPidlList::GetNumPidls() const
+{
+	return m_numPidls;
+}
+
+size_t PackedPidlList::GetSizeInBytes() const
+{
+	return m_data.size();
+}
@@ -0,0 +1,39 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#pragma once
+
+#include "PidlHelper.h"
+#include <cstdint>
+#include <vector>
+
+// Stores a list of pidls in a single, contiguous buffer. Pidls that are contained within the
+// specified parent folder are stored relative to that folder, meaning that the parent portion of
+// each pidl doesn't need to be stored at all. This is substantially more compact than a vector of
+// individually allocated pidls, at the cost of having to unpack the list before it can be used.
+//
+// The same parent that was used to pack the list should be passed in when unpacking it.
+class PackedPidlList
+{
+public:
+	PackedPidlList() = default;
+	PackedPidlList(PCIDLIST_ABSOLUTE parent, const std::vector<PidlAbsolute> &pidls);
+
+	std::vector<PidlAbsolute> Unpack(PCIDLIST_ABSOLUTE parent) const;
+
+	bool IsEmpty() const;
+	size_t GetNumPidls() const;
+	size_t GetSizeInBytes() const;
+
+private:
+	// Each pidl in the buffer is preceded by one of these values.
+	enum class StorageType : uint8_t
+	{
+		Relative,
+		Absolute
+	};
+
+	std::vector<BYTE> m_data;
+	size_t m_numPidls = 0;
+};
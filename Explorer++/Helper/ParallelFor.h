@@ -0,0 +1,50 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <stop_token>
+#include <thread>
+#include <vector>
+
+// Calls the function once for each index in [0, count), spreading the calls across the specified
+// number of threads (including the calling thread). Indexes are handed out one at a time, so a
+// thread that's working on an expensive item doesn't hold up the others. Returns once all the calls
+// have completed, or a stop has been requested and the calls in progress have finished.
+template <typename Function>
+void ParallelFor(size_t count, int numThreads, std::stop_token stopToken, Function function)
+{
+	std::atomic<size_t> nextIndex = 0;
+
+	auto worker = [&nextIndex, count, &stopToken, &function]
+	{
+		while (!stopToken.stop_requested())
+		{
+			size_t index = nextIndex++;
+
+			if (index >= count)
+			{
+				return;
+			}
+
+			function(index);
+		}
+	};
+
+	size_t numWorkers = std::min(static_cast<size_t>(std::max(numThreads, 1)), count);
+	std::vector<std::jthread> threads;
+
+	for (size_t i = 1; i < numWorkers; i++)
+	{
+		threads.emplace_back(worker);
+	}
+
+	if (numWorkers > 0)
+	{
+		worker();
+	}
+}
@@ -0,0 +1,100 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "stdafx.h"
+#include "PidlInternTable.h"
+#include <boost/container_hash/hash.hpp>
+
+PidlInternTable::PidlInternTable() : m_state(std::make_shared<State>())
+{
+}
+
+PidlInternTable &PidlInternTable::GetInstance()
+{
+	static PidlInternTable internTable;
+	return internTable;
+}
+
+PidlInternTable::InternedPidl PidlInternTable::Intern(PCIDLIST_ABSOLUTE pidl)
+{
+	if (!pidl)
+	{
+		return std::make_shared<const PidlAbsolute>();
+	}
+
+	UINT size = ILGetSize(pidl);
+	size_t hash = HashPidl(pidl, size);
+
+	std::scoped_lock lock(m_state->mutex);
+
+	auto [first, last] = m_state->entries.equal_range(hash);
+
+	for (auto itr = first; itr != last; ++itr)
+	{
+		// The pidl can only be deleted once its entry has been removed, which requires the mutex,
+		// so it's safe to access the pidl here. Note that the weak pointer is only locked once a
+		// match has been found. If a non-matching pidl were locked, releasing it could result in
+		// its deleter being run while the mutex is held.
+		const auto *existingPidl = itr->second.pidl->Raw();
+
+		if (ILGetSize(existingPidl) != size || std::memcmp(existingPidl, pidl, size) != 0)
+		{
+			continue;
+		}
+
+		// If this fails, the pidl has been released and is waiting to be removed, in which case a
+		// new copy will be added below.
+		if (auto interned = itr->second.weakPidl.lock())
+		{
+			return interned;
+		}
+	}
+
+	auto *newPidl = new PidlAbsolute(pidl);
+	InternedPidl interned(newPidl,
+		[weakState = std::weak_ptr<State>(m_state), hash](const PidlAbsolute *internedPidl)
+		{ Release(weakState, hash, internedPidl); });
+
+	m_state->entries.emplace(hash, Entry{ newPidl, interned });
+	m_state->totalSize += size;
+
+	return interned;
+}
+
+size_t PidlInternTable::HashPidl(PCIDLIST_ABSOLUTE pidl, UINT size)
+{
+	const auto *bytes = reinterpret_cast<const BYTE *>(pidl);
+	return boost::hash_range(bytes, bytes + size);
+}
+
+void PidlInternTable::Release(const std::weak_ptr<State> &weakState, size_t hash,
+	const PidlAbsolute *pidl)
+{
+	if (auto state = weakState.lock())
+	{
+		std::scoped_lock lock(state->mutex);
+
+		auto [first, last] = state->entries.equal_range(hash);
+		auto itr = std::find_if(first, last,
+			[pidl](const auto &entry) { return entry.second.pidl == pidl; });
+		CHECK(itr != last);
+
+		state->totalSize -= ILGetSize(pidl->Raw());
+		state->entries.erase(itr);
+	}
+
+	delete pidl;
+}
+
+size_t PidlInternTable::GetNumPidls() const
+{
+	std::scoped_lock lock(m_state->mutex);
+	return m_state->entries.size();
+}
+
+size_t PidlInternTable::GetTotalSize() const
+{
+	std::scoped_lock lock(m_state->mutex);
+	return m_state->totalSize;
+}
@@ -0,0 +1,59 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#pragma once
+
+#include "PidlHelper.h"
+#include <boost/core/noncopyable.hpp>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+// Stores a single, shared copy of each distinct pidl. For example, when the same folder appears in
+// the history of many tabs, each history entry can refer to the same interned pidl, rather than
+// holding its own copy.
+//
+// Interned pidls are reference counted and are removed from the table once the last reference to
+// them is released, so the table only ever contains pidls that are in use. Pidls are compared by
+// their binary representation.
+//
+// This class is thread-safe.
+class PidlInternTable : private boost::noncopyable
+{
+public:
+	using InternedPidl = std::shared_ptr<const PidlAbsolute>;
+
+	PidlInternTable();
+
+	static PidlInternTable &GetInstance();
+
+	InternedPidl Intern(PCIDLIST_ABSOLUTE pidl);
+
+	size_t GetNumPidls() const;
+
+	// Returns the combined size, in bytes, of the pidls that are currently interned.
+	size_t GetTotalSize() const;
+
+private:
+	struct Entry
+	{
+		const PidlAbsolute *pidl;
+		std::weak_ptr<const PidlAbsolute> weakPidl;
+	};
+
+	// This state is shared with the deleter of each interned pidl, which allows interned pidls to
+	// safely outlive the table.
+	struct State
+	{
+		mutable std::mutex mutex;
+		std::unordered_multimap<size_t, Entry> entries;
+		size_t totalSize = 0;
+	};
+
+	static size_t HashPidl(PCIDLIST_ABSOLUTE pidl, UINT size);
+	static void Release(const std::weak_ptr<State> &weakState, size_t hash,
+		const PidlAbsolute *pidl);
+
+	const std::shared_ptr<State> m_state;
+};
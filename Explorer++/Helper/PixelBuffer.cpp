@@ -0,0 +1,143 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "stdafx.h"
+#include "PixelBuffer.h"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+
+struct SourceRange
+{
+	int start;
+	int end;
+};
+
+// Calculates, for each destination coordinate along one axis, the range of source coordinates it
+// covers. Each range contains at least one coordinate, so that enlarging works as well.
+std::vector<SourceRange> CalculateSourceRanges(int sourceLength, int destinationLength)
+{
+	std::vector<SourceRange> ranges;
+	ranges.reserve(destinationLength);
+
+	for (int i = 0; i < destinationLength; i++)
+	{
+		auto start = static_cast<int>(static_cast<int64_t>(i) * sourceLength / destinationLength);
+		auto end = static_cast<int>(static_cast<int64_t>(i + 1) * sourceLength / destinationLength);
+		end = std::max(end, start + 1);
+		ranges.push_back({ start, std::min(end, sourceLength) });
+	}
+
+	return ranges;
+}
+
+}
+
+PixelBuffer::PixelBuffer(int width, int height) :
+	width(width),
+	height(height),
+	pixels(static_cast<size_t>(width) * height)
+{
+}
+
+uint32_t PixelBuffer::GetPixel(int x, int y) const
+{
+	return pixels[static_cast<size_t>(y) * width + x];
+}
+
+void PixelBuffer::SetPixel(int x, int y, uint32_t pixel)
+{
+	pixels[static_cast<size_t>(y) * width + x] = pixel;
+}
+
+size_t PixelBuffer::GetSizeInBytes() const
+{
+	return sizeof(*this) + pixels.size() * sizeof(uint32_t);
+}
+
+ImageSize FitImageSize(ImageSize sourceSize, ImageSize maxSize)
+{
+	if (sourceSize.width <= 0 || sourceSize.height <= 0 || maxSize.width <= 0
+		|| maxSize.height <= 0)
+	{
+		return { 1, 1 };
+	}
+
+	double widthRatio = static_cast<double>(maxSize.width) / sourceSize.width;
+	double heightRatio = static_cast<double>(maxSize.height) / sourceSize.height;
+
+	if (widthRatio < heightRatio)
+	{
+		auto height = static_cast<int>(std::lround(sourceSize.height * widthRatio));
+		return { maxSize.width, std::clamp(height, 1, maxSize.height) };
+	}
+	else
+	{
+		auto width = static_cast<int>(std::lround(sourceSize.width * heightRatio));
+		return { std::clamp(width, 1, maxSize.width), maxSize.height };
+	}
+}
+
+PixelBuffer ResizeImageBoxFilter(const PixelBuffer &source, ImageSize destinationSize)
+{
+	if (source.width <= 0 || source.height <= 0 || destinationSize.width <= 0
+		|| destinationSize.height <= 0)
+	{
+		return {};
+	}
+
+	PixelBuffer destination(destinationSize.width, destinationSize.height);
+
+	auto columnRanges = CalculateSourceRanges(source.width, destinationSize.width);
+	auto rowRanges = CalculateSourceRanges(source.height, destinationSize.height);
+
+	// Holds the per-channel totals for each destination pixel in the current row.
+	std::vector<uint64_t> totals(static_cast<size_t>(destinationSize.width) * 4);
+
+	for (int y = 0; y < destinationSize.height; y++)
+	{
+		std::fill(totals.begin(), totals.end(), 0);
+
+		const auto &rowRange = rowRanges[y];
+
+		// The source rows are read in order, which keeps the memory access pattern sequential.
+		for (int sourceY = rowRange.start; sourceY < rowRange.end; sourceY++)
+		{
+			const uint32_t *sourceRow = &source.pixels[static_cast<size_t>(sourceY) * source.width];
+
+			for (int x = 0; x < destinationSize.width; x++)
+			{
+				uint64_t *pixelTotals = &totals[static_cast<size_t>(x) * 4];
+
+				for (int sourceX = columnRanges[x].start; sourceX < columnRanges[x].end; sourceX++)
+				{
+					uint32_t pixel = sourceRow[sourceX];
+					pixelTotals[0] += pixel & 0xFF;
+					pixelTotals[1] += (pixel >> 8) & 0xFF;
+					pixelTotals[2] += (pixel >> 16) & 0xFF;
+					pixelTotals[3] += pixel >> 24;
+				}
+			}
+		}
+
+		for (int x = 0; x < destinationSize.width; x++)
+		{
+			const uint64_t *pixelTotals = &totals[static_cast<size_t>(x) * 4];
+			uint64_t count = static_cast<uint64_t>(rowRange.end - rowRange.start)
+				* (columnRanges[x].end - columnRanges[x].start);
+
+			// Rounds each channel to the nearest value.
+			auto average = [count](uint64_t total)
+			{ return static_cast<uint32_t>((total + count / 2) / count); };
+
+			destination.SetPixel(x, y,
+				average(pixelTotals[0]) | (average(pixelTotals[1]) << 8)
+					| (average(pixelTotals[2]) << 16) | (average(pixelTotals[3]) << 24));
+		}
+	}
+
+	return destination;
+}
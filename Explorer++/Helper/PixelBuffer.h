@@ -0,0 +1,45 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+// A 32-bit image, stored top-down, with no padding between rows. Each pixel is stored in the same
+// byte order used by 32-bit Windows DIBs (i.e. blue, green, red, alpha), though the functions
+// below treat each of the four channels identically, so the order doesn't actually matter to them.
+struct PixelBuffer
+{
+	int width = 0;
+	int height = 0;
+	std::vector<uint32_t> pixels;
+
+	PixelBuffer() = default;
+	PixelBuffer(int width, int height);
+
+	uint32_t GetPixel(int x, int y) const;
+	void SetPixel(int x, int y, uint32_t pixel);
+
+	// The approximate amount of memory used by the buffer.
+	size_t GetSizeInBytes() const;
+};
+
+struct ImageSize
+{
+	int width;
+	int height;
+
+	bool operator==(const ImageSize &) const = default;
+};
+
+// Returns the largest size that fits within the maximum size, while retaining the aspect ratio of
+// the source size. The returned width and height are always at least 1.
+ImageSize FitImageSize(ImageSize sourceSize, ImageSize maxSize);
+
+// Resizes the image using a box filter. That is, each destination pixel is the average of the block
+// of source pixels it covers. That's much cheaper than a filter like bicubic, but still gives good
+// results when shrinking an image, which is the main intended use. When enlarging an image, each
+// destination pixel simply takes the value of the source pixel it falls within.
+PixelBuffer ResizeImageBoxFilter(const PixelBuffer &source, ImageSize destinationSize);
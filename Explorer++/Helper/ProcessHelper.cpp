@@ -87,3 +87,16 @@ bool IsProcessElevated()
 
 	return tokenElevation.TokenIsElevated;
 }
+
+std::optional<SIZE_T> GetCurrentProcessWorkingSetSize()
+{
+	PROCESS_MEMORY_COUNTERS memoryCounters = {};
+	BOOL res = GetProcessMemoryInfo(GetCurrentProcess(), &memoryCounters, sizeof(memoryCounters));
+
+	if (!res)
+	{
+		return std::nullopt;
+	}
+
+	return memoryCounters.WorkingSetSize;
+}
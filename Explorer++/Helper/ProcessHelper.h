@@ -5,7 +5,11 @@
 #pragma once
 
 #include <windows.h>
+#include <optional>
 
 DWORD GetProcessImageName(DWORD dwProcessId, TCHAR *szImageName, DWORD nSize);
 BOOL GetProcessOwner(DWORD dwProcessId, TCHAR *szOwner, size_t cchMax);
 bool IsProcessElevated();
+
+// Returns the current working set size (in bytes) of this process.
+std::optional<SIZE_T> GetCurrentProcessWorkingSetSize();
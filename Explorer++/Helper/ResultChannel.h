@@ -0,0 +1,262 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#pragma once
+
+#include <boost/core/noncopyable.hpp>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+
+// Delivers results produced on any number of background threads to a single consumer thread (in
+// practice, the UI thread).
+//
+// Results are pushed onto a lock-free, multi-producer single-consumer queue. Rather than notifying
+// the consumer once per result, the channel only schedules a drain when one isn't already pending,
+// so a burst of results will result in a single wake-up. Each drain processes results until the
+// queue is empty or the time budget has been exceeded, in which case another drain is scheduled.
+// That ensures that a large number of results won't block the consumer thread for an extended
+// period.
+//
+// Results are tagged with the generation that was current when the associated task was queued.
+// Calling Invalidate() moves the channel to a new generation and any results from earlier
+// generations will then be discarded when they're drained. That means there's no need to track
+// pending tasks individually.
+//
+// Apart from Sender::Send(), all methods should only be called on the consumer thread.
+template <class T>
+class ResultChannel : private boost::noncopyable
+{
+private:
+	struct State;
+
+public:
+	using Generation = uint64_t;
+
+	// Schedules the provided task to run on the consumer thread. This can be invoked from any
+	// thread.
+	using Scheduler = std::function<void(std::function<void()> task)>;
+	using Processor = std::function<void(T &&result)>;
+
+	static constexpr std::chrono::milliseconds DEFAULT_DRAIN_BUDGET{ 8 };
+
+	// A copyable handle that background tasks can use to submit their results. The handle keeps
+	// the underlying queue alive, so it's safe to continue using it after the channel itself has
+	// been destroyed (results will simply be discarded in that case).
+	class Sender
+	{
+	public:
+		void Send(T result) const
+		{
+			m_state->Push(m_generation, std::move(result));
+		}
+
+		Generation GetGeneration() const
+		{
+			return m_generation;
+		}
+
+	private:
+		friend class ResultChannel;
+
+		Sender(std::shared_ptr<State> state, Generation generation) :
+			m_state(std::move(state)),
+			m_generation(generation)
+		{
+		}
+
+		std::shared_ptr<State> m_state;
+		Generation m_generation;
+	};
+
+	ResultChannel(Scheduler scheduler, Processor processor,
+		std::chrono::steady_clock::duration drainBudget = DEFAULT_DRAIN_BUDGET) :
+		m_state(std::make_shared<State>(std::move(scheduler), std::move(processor), drainBudget))
+	{
+	}
+
+	~ResultChannel()
+	{
+		m_state->Close();
+	}
+
+	// Returns a sender for the current generation.
+	Sender GetSender() const
+	{
+		return Sender(m_state, m_state->generation);
+	}
+
+	Generation GetGeneration() const
+	{
+		return m_state->generation;
+	}
+
+	// Discards all results from the current generation (including any that have already been
+	// submitted, but not yet processed).
+	void Invalidate()
+	{
+		m_state->generation++;
+	}
+
+private:
+	struct Node
+	{
+		std::atomic<Node *> next = nullptr;
+		Generation generation = 0;
+		std::optional<T> result;
+	};
+
+	// This is an intrusive MPSC queue, based on the design by Dmitry Vyukov. Producers only
+	// perform a single atomic exchange to append a node. The consumer owns the tail and never
+	// contends with producers.
+	struct State : public std::enable_shared_from_this<State>
+	{
+		State(Scheduler scheduler, Processor processor,
+			std::chrono::steady_clock::duration drainBudget) :
+			scheduler(std::move(scheduler)),
+			processor(std::move(processor)),
+			drainBudget(drainBudget),
+			head(&stub),
+			tail(&stub)
+		{
+		}
+
+		~State()
+		{
+			while (Pop())
+			{
+			}
+
+			if (tail != &stub)
+			{
+				delete tail;
+			}
+		}
+
+		void Push(Generation resultGeneration, T result)
+		{
+			if (closed.load(std::memory_order_acquire))
+			{
+				return;
+			}
+
+			auto *node = new Node;
+			node->generation = resultGeneration;
+			node->result.emplace(std::move(result));
+
+			Node *previous = head.exchange(node, std::memory_order_acq_rel);
+			previous->next.store(node, std::memory_order_release);
+
+			// The node is fully linked at this point, so if a drain is already pending, it's
+			// guaranteed to see the node.
+			if (!drainScheduled.exchange(true, std::memory_order_acq_rel))
+			{
+				ScheduleDrain();
+			}
+		}
+
+		void ScheduleDrain()
+		{
+			scheduler([weakSelf = this->weak_from_this()]()
+				{
+					if (auto self = weakSelf.lock())
+					{
+						self->Drain();
+					}
+				});
+		}
+
+		void Drain()
+		{
+			if (closed.load(std::memory_order_acquire))
+			{
+				return;
+			}
+
+			// This is reset before the queue is read, so that any result pushed from this point
+			// onwards will schedule another drain if it's missed by the loop below.
+			drainScheduled.store(false, std::memory_order_seq_cst);
+
+			auto start = std::chrono::steady_clock::now();
+
+			while (auto *node = Pop())
+			{
+				auto result = std::move(node->result);
+				node->result.reset();
+
+				if (node->generation == generation)
+				{
+					processor(std::move(*result));
+
+					// The processor might destroy the channel (e.g. by closing the tab that owns
+					// it).
+					if (closed.load(std::memory_order_acquire))
+					{
+						return;
+					}
+				}
+
+				if (std::chrono::steady_clock::now() - start >= drainBudget)
+				{
+					if (tail->next.load(std::memory_order_acquire)
+						&& !drainScheduled.exchange(true, std::memory_order_acq_rel))
+					{
+						ScheduleDrain();
+					}
+
+					return;
+				}
+			}
+		}
+
+		// Advances the queue by one node and returns that node, which holds the next result. The
+		// returned node becomes the new sentinel, so it remains owned by the queue. The previous
+		// sentinel is freed.
+		Node *Pop()
+		{
+			Node *currentTail = tail;
+			Node *next = currentTail->next.load(std::memory_order_acquire);
+
+			if (!next)
+			{
+				return nullptr;
+			}
+
+			tail = next;
+
+			if (currentTail != &stub)
+			{
+				delete currentTail;
+			}
+
+			return next;
+		}
+
+		// Note that the processor isn't reset here, since this may be called while the processor
+		// is running.
+		void Close()
+		{
+			closed.store(true, std::memory_order_release);
+		}
+
+		const Scheduler scheduler;
+		Processor processor;
+		const std::chrono::steady_clock::duration drainBudget;
+
+		// Only accessed on the consumer thread.
+		Generation generation = 0;
+
+		std::atomic_bool closed = false;
+		std::atomic_bool drainScheduled = false;
+
+		Node stub;
+		std::atomic<Node *> head;
+		Node *tail;
+	};
+
+	const std::shared_ptr<State> m_state;
+};
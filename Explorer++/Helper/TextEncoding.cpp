@@ -0,0 +1,434 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "stdafx.h"
+#include "TextEncoding.h"
+#include <optional>
+
+namespace
+{
+
+constexpr char32_t REPLACEMENT_CHARACTER = 0xFFFD;
+
+struct Utf8Sequence
+{
+	// Empty if the sequence is invalid.
+	std::optional<char32_t> codePoint;
+
+	size_t length = 0;
+
+	// True if the sequence was valid, but the input ended before the sequence was complete.
+	bool truncated = false;
+};
+
+std::string_view AsStringView(std::span<const std::byte> data)
+{
+	return { reinterpret_cast<const char *>(data.data()), data.size() };
+}
+
+Utf8Sequence ReadUtf8Sequence(std::string_view input, size_t index)
+{
+	auto lead = static_cast<unsigned char>(input[index]);
+	size_t length;
+	char32_t codePoint;
+
+	if (lead < 0x80)
+	{
+		return { lead, 1 };
+	}
+	else if ((lead & 0xE0) == 0xC0)
+	{
+		length = 2;
+		codePoint = lead & 0x1F;
+	}
+	else if ((lead & 0xF0) == 0xE0)
+	{
+		length = 3;
+		codePoint = lead & 0x0F;
+	}
+	else if ((lead & 0xF8) == 0xF0)
+	{
+		length = 4;
+		codePoint = lead & 0x07;
+	}
+	else
+	{
+		return { std::nullopt, 1 };
+	}
+
+	size_t consumed = 1;
+
+	for (; consumed < length && index + consumed < input.size(); consumed++)
+	{
+		auto continuation = static_cast<unsigned char>(input[index + consumed]);
+
+		if ((continuation & 0xC0) != 0x80)
+		{
+			break;
+		}
+
+		codePoint = (codePoint << 6) | (continuation & 0x3F);
+	}
+
+	if (consumed != length)
+	{
+		return { std::nullopt, consumed, index + consumed == input.size() };
+	}
+
+	constexpr char32_t minimumValues[] = { 0, 0, 0x80, 0x800, 0x10000 };
+
+	if (codePoint < minimumValues[length] || codePoint > 0x10FFFF
+		|| (codePoint >= 0xD800 && codePoint <= 0xDFFF))
+	{
+		return { std::nullopt, consumed };
+	}
+
+	return { codePoint, length };
+}
+
+// A sequence that's cut off by the end of the input is allowed, since the input is typically only
+// a sample of a larger file.
+bool IsValidUtf8(std::string_view input)
+{
+	size_t i = 0;
+
+	while (i < input.size())
+	{
+		auto sequence = ReadUtf8Sequence(input, i);
+
+		if (!sequence.codePoint)
+		{
+			return sequence.truncated;
+		}
+
+		i += sequence.length;
+	}
+
+	return true;
+}
+
+void AppendCodePoint(std::wstring &output, char32_t codePoint)
+{
+	if constexpr (sizeof(wchar_t) == 2)
+	{
+		if (codePoint >= 0x10000)
+		{
+			codePoint -= 0x10000;
+			output.push_back(static_cast<wchar_t>(0xD800 + (codePoint >> 10)));
+			output.push_back(static_cast<wchar_t>(0xDC00 + (codePoint & 0x3FF)));
+			return;
+		}
+	}
+
+	output.push_back(static_cast<wchar_t>(codePoint));
+}
+
+// Reads the code point at the specified index, combining surrogate pairs if wchar_t is 16 bits.
+char32_t ReadCodePoint(std::wstring_view text, size_t &index)
+{
+	auto unit = static_cast<char32_t>(text[index++]);
+
+	if constexpr (sizeof(wchar_t) == 2)
+	{
+		if (unit >= 0xD800 && unit <= 0xDBFF && index < text.size()
+			&& text[index] >= 0xDC00 && text[index] <= 0xDFFF)
+		{
+			auto low = static_cast<char32_t>(text[index++]);
+			return 0x10000 + ((unit - 0xD800) << 10) + (low - 0xDC00);
+		}
+	}
+
+	if (unit >= 0xD800 && unit <= 0xDFFF)
+	{
+		return REPLACEMENT_CHARACTER;
+	}
+
+	return unit;
+}
+
+// Control characters other than these rarely appear in text files.
+bool IsTextControlCharacter(unsigned char c)
+{
+	return c == '\t' || c == '\n' || c == '\r' || c == '\f' || c == '\v' || c == '\b'
+		|| c == 0x1B;
+}
+
+std::wstring DecodeUtf16(std::span<const std::byte> data, bool bigEndian)
+{
+	auto readUnit = [data, bigEndian](size_t index)
+	{
+		auto first = std::to_integer<char32_t>(data[index * 2]);
+		auto second = std::to_integer<char32_t>(data[index * 2 + 1]);
+		return bigEndian ? ((first << 8) | second) : (first | (second << 8));
+	};
+
+	size_t numUnits = data.size() / 2;
+	std::wstring output;
+	output.reserve(numUnits);
+
+	for (size_t i = 0; i < numUnits; i++)
+	{
+		char32_t unit = readUnit(i);
+
+		if (unit >= 0xD800 && unit <= 0xDBFF && i + 1 < numUnits)
+		{
+			char32_t low = readUnit(i + 1);
+
+			if (low >= 0xDC00 && low <= 0xDFFF)
+			{
+				AppendCodePoint(output, 0x10000 + ((unit - 0xD800) << 10) + (low - 0xDC00));
+				i++;
+				continue;
+			}
+		}
+
+		if (unit >= 0xD800 && unit <= 0xDFFF)
+		{
+			unit = REPLACEMENT_CHARACTER;
+		}
+
+		output.push_back(static_cast<wchar_t>(unit));
+	}
+
+	return output;
+}
+
+std::wstring DecodeAnsi(std::span<const std::byte> data)
+{
+#ifdef _WIN32
+	if (data.empty())
+	{
+		return {};
+	}
+
+	int length = MultiByteToWideChar(CP_ACP, 0, reinterpret_cast<const char *>(data.data()),
+		static_cast<int>(data.size()), nullptr, 0);
+	std::wstring output(length, '\0');
+	MultiByteToWideChar(CP_ACP, 0, reinterpret_cast<const char *>(data.data()),
+		static_cast<int>(data.size()), output.data(), length);
+	return output;
+#else
+	std::wstring output;
+	output.reserve(data.size());
+
+	for (auto byte : data)
+	{
+		output.push_back(std::to_integer<wchar_t>(byte));
+	}
+
+	return output;
+#endif
+}
+
+void EncodeUtf8(char32_t codePoint, std::vector<std::byte> &output)
+{
+	auto append = [&output](char32_t value) { output.push_back(static_cast<std::byte>(value)); };
+
+	if (codePoint < 0x80)
+	{
+		append(codePoint);
+	}
+	else if (codePoint < 0x800)
+	{
+		append(0xC0 | (codePoint >> 6));
+		append(0x80 | (codePoint & 0x3F));
+	}
+	else if (codePoint < 0x10000)
+	{
+		append(0xE0 | (codePoint >> 12));
+		append(0x80 | ((codePoint >> 6) & 0x3F));
+		append(0x80 | (codePoint & 0x3F));
+	}
+	else
+	{
+		append(0xF0 | (codePoint >> 18));
+		append(0x80 | ((codePoint >> 12) & 0x3F));
+		append(0x80 | ((codePoint >> 6) & 0x3F));
+		append(0x80 | (codePoint & 0x3F));
+	}
+}
+
+void EncodeUtf16(char32_t codePoint, bool bigEndian, std::vector<std::byte> &output)
+{
+	auto appendUnit = [&output, bigEndian](char32_t unit)
+	{
+		auto high = static_cast<std::byte>(unit >> 8);
+		auto low = static_cast<std::byte>(unit & 0xFF);
+		output.push_back(bigEndian ? high : low);
+		output.push_back(bigEndian ? low : high);
+	};
+
+	if (codePoint >= 0x10000)
+	{
+		codePoint -= 0x10000;
+		appendUnit(0xD800 + (codePoint >> 10));
+		appendUnit(0xDC00 + (codePoint & 0x3FF));
+	}
+	else
+	{
+		appendUnit(codePoint);
+	}
+}
+
+std::vector<std::byte> EncodeAnsi(std::wstring_view text)
+{
+#ifdef _WIN32
+	if (text.empty())
+	{
+		return {};
+	}
+
+	int length = WideCharToMultiByte(CP_ACP, WC_NO_BEST_FIT_CHARS, text.data(),
+		static_cast<int>(text.size()), nullptr, 0, nullptr, nullptr);
+	std::vector<std::byte> output(length);
+	WideCharToMultiByte(CP_ACP, WC_NO_BEST_FIT_CHARS, text.data(),
+		static_cast<int>(text.size()), reinterpret_cast<char *>(output.data()), length, nullptr,
+		nullptr);
+	return output;
+#else
+	std::vector<std::byte> output;
+	size_t index = 0;
+
+	while (index < text.size())
+	{
+		char32_t codePoint = ReadCodePoint(text, index);
+		output.push_back(static_cast<std::byte>(codePoint <= 0xFF ? codePoint : U'?'));
+	}
+
+	return output;
+#endif
+}
+
+}
+
+DetectedTextEncoding DetectTextEncoding(std::span<const std::byte> sample)
+{
+	auto bytes = AsStringView(sample);
+
+	if (bytes.starts_with("\xEF\xBB\xBF"))
+	{
+		return { TextEncoding::Utf8, 3, false };
+	}
+	else if (bytes.starts_with("\xFF\xFE"))
+	{
+		return { TextEncoding::Utf16LE, 2, false };
+	}
+	else if (bytes.starts_with("\xFE\xFF"))
+	{
+		return { TextEncoding::Utf16BE, 2, false };
+	}
+
+	size_t evenNulls = 0;
+	size_t oddNulls = 0;
+	size_t otherControlCharacters = 0;
+
+	for (size_t i = 0; i < bytes.size(); i++)
+	{
+		auto c = static_cast<unsigned char>(bytes[i]);
+
+		if (c == 0)
+		{
+			(i % 2 == 0 ? evenNulls : oddNulls)++;
+		}
+		else if (c < 0x20 && !IsTextControlCharacter(c))
+		{
+			otherControlCharacters++;
+		}
+	}
+
+	// Text that's mostly ASCII will, when encoded as UTF-16, have a null byte in every other
+	// position.
+	size_t numPairs = bytes.size() / 2;
+
+	auto looksLikeUtf16 = [numPairs](size_t expectedNulls, size_t unexpectedNulls)
+	{
+		return expectedNulls > 0 && expectedNulls * 10 >= numPairs * 4
+			&& unexpectedNulls * 20 <= numPairs;
+	};
+
+	if (looksLikeUtf16(oddNulls, evenNulls))
+	{
+		return { TextEncoding::Utf16LE, 0, false };
+	}
+	else if (looksLikeUtf16(evenNulls, oddNulls))
+	{
+		return { TextEncoding::Utf16BE, 0, false };
+	}
+
+	if (evenNulls + oddNulls > 0 || otherControlCharacters > bytes.size() / 10)
+	{
+		return { TextEncoding::Ansi, 0, true };
+	}
+
+	return { IsValidUtf8(bytes) ? TextEncoding::Utf8 : TextEncoding::Ansi, 0, false };
+}
+
+size_t GetCodeUnitSize(TextEncoding encoding)
+{
+	return (encoding == TextEncoding::Utf16LE || encoding == TextEncoding::Utf16BE) ? 2 : 1;
+}
+
+std::wstring DecodeUtf8(std::string_view input)
+{
+	std::wstring output;
+	output.reserve(input.size());
+
+	size_t i = 0;
+
+	while (i < input.size())
+	{
+		auto sequence = ReadUtf8Sequence(input, i);
+		AppendCodePoint(output, sequence.codePoint.value_or(REPLACEMENT_CHARACTER));
+		i += sequence.length;
+	}
+
+	return output;
+}
+
+std::wstring DecodeText(std::span<const std::byte> data, TextEncoding encoding)
+{
+	switch (encoding)
+	{
+	case TextEncoding::Utf8:
+		return DecodeUtf8(AsStringView(data));
+
+	case TextEncoding::Utf16LE:
+		return DecodeUtf16(data, false);
+
+	case TextEncoding::Utf16BE:
+		return DecodeUtf16(data, true);
+
+	case TextEncoding::Ansi:
+		return DecodeAnsi(data);
+	}
+
+	return {};
+}
+
+std::vector<std::byte> EncodeText(std::wstring_view text, TextEncoding encoding)
+{
+	if (encoding == TextEncoding::Ansi)
+	{
+		return EncodeAnsi(text);
+	}
+
+	std::vector<std::byte> output;
+	size_t index = 0;
+
+	while (index < text.size())
+	{
+		char32_t codePoint = ReadCodePoint(text, index);
+
+		if (encoding == TextEncoding::Utf8)
+		{
+			EncodeUtf8(codePoint, output);
+		}
+		else
+		{
+			EncodeUtf16(codePoint, encoding == TextEncoding::Utf16BE, output);
+		}
+	}
+
+	return output;
+}
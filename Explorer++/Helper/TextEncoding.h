@@ -0,0 +1,52 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#pragma once
+
+#include <cstddef>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+enum class TextEncoding
+{
+	Utf8,
+	Utf16LE,
+	Utf16BE,
+
+	// The system's ANSI code page on Windows and ISO-8859-1 elsewhere.
+	Ansi
+};
+
+struct DetectedTextEncoding
+{
+	TextEncoding encoding = TextEncoding::Utf8;
+
+	// The size of the byte order mark at the start of the data, if there is one.
+	size_t bomSize = 0;
+
+	// True if the data doesn't appear to be text at all (e.g. it contains null bytes, without
+	// being UTF-16).
+	bool isBinary = false;
+};
+
+// Detects the encoding from a sample of data taken from the start of a file. A byte order mark is
+// used if present. Otherwise, the encoding is guessed from the distribution of null bytes (which
+// indicates UTF-16) and whether the data is valid UTF-8. The sample can end in the middle of a
+// character.
+DetectedTextEncoding DetectTextEncoding(std::span<const std::byte> sample);
+
+// Returns the size, in bytes, of a single code unit in the encoding.
+size_t GetCodeUnitSize(TextEncoding encoding);
+
+// Invalid sequences are replaced with U+FFFD, rather than causing the conversion to fail.
+std::wstring DecodeUtf8(std::string_view input);
+
+// As with DecodeUtf8, invalid data is replaced with U+FFFD. For UTF-16, a trailing odd byte is
+// ignored.
+std::wstring DecodeText(std::span<const std::byte> data, TextEncoding encoding);
+
+// Characters that can't be represented in the encoding are replaced with '?'.
+std::vector<std::byte> EncodeText(std::wstring_view text, TextEncoding encoding);
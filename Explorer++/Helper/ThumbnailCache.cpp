@@ -0,0 +1,98 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "stdafx.h"
+#include "ThumbnailCache.h"
+
+ThumbnailCache::ThumbnailCache(size_t maxSizeInBytes) : m_maxSizeInBytes(maxSizeInBytes)
+{
+}
+
+const ThumbnailCache::Entry *ThumbnailCache::Find(int id)
+{
+	auto &idIndex = m_entries.get<ById>();
+	auto itr = idIndex.find(id);
+
+	if (itr == idIndex.end())
+	{
+		return nullptr;
+	}
+
+	m_entries.relocate(m_entries.begin(), m_entries.project<0>(itr));
+
+	return &*itr;
+}
+
+void ThumbnailCache::Insert(int id, uint64_t generation, Clock::time_point captureTime,
+	PixelBuffer image)
+{
+	Remove(id);
+
+	size_t imageSize = image.GetSizeInBytes();
+
+	if (imageSize > m_maxSizeInBytes)
+	{
+		return;
+	}
+
+	auto [itr, inserted] = m_entries.push_front({ id, generation, captureTime, std::move(image) });
+	DCHECK(inserted);
+
+	m_sizeInBytes += imageSize;
+
+	EvictEntries();
+}
+
+void ThumbnailCache::Remove(int id)
+{
+	auto &idIndex = m_entries.get<ById>();
+	auto itr = idIndex.find(id);
+
+	if (itr == idIndex.end())
+	{
+		return;
+	}
+
+	m_sizeInBytes -= itr->image.GetSizeInBytes();
+	idIndex.erase(itr);
+}
+
+void ThumbnailCache::EvictEntries()
+{
+	// The entry at the front is the one that was most recently inserted, which is never evicted
+	// here (Insert() has already checked that it fits).
+	while (m_sizeInBytes > m_maxSizeInBytes && m_entries.size() > 1)
+	{
+		m_sizeInBytes -= m_entries.back().image.GetSizeInBytes();
+		m_entries.pop_back();
+	}
+}
+
+size_t ThumbnailCache::GetSizeInBytes() const
+{
+	return m_sizeInBytes;
+}
+
+size_t ThumbnailCache::GetNumEntries() const
+{
+	return m_entries.size();
+}
+
+bool ShouldRecaptureThumbnail(const ThumbnailCache::Entry *entry, uint64_t currentGeneration,
+	ThumbnailCache::Clock::time_point now, const ThumbnailCapturePolicy &policy)
+{
+	if (!entry)
+	{
+		return true;
+	}
+
+	auto age = now - entry->captureTime;
+
+	if (age < policy.minCaptureInterval)
+	{
+		return false;
+	}
+
+	return entry->generation != currentGeneration || age >= policy.maxAge;
+}
@@ -0,0 +1,93 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#pragma once
+
+#include "PixelBuffer.h"
+#include <boost/core/noncopyable.hpp>
+#include <boost/multi_index/hashed_index.hpp>
+#include <boost/multi_index/member.hpp>
+#include <boost/multi_index/sequenced_index.hpp>
+#include <boost/multi_index_container.hpp>
+#include <chrono>
+
+// Determines when a cached thumbnail should be replaced with a freshly captured one.
+struct ThumbnailCapturePolicy
+{
+	// A thumbnail won't be recaptured if it was captured less than this amount of time ago, even if
+	// it's out of date. This limits how often capturing can occur.
+	std::chrono::steady_clock::duration minCaptureInterval;
+
+	// A thumbnail that's up to date will still be recaptured once it's this old. That's useful
+	// when the content can change without the generation being updated (e.g. when the selected tab
+	// is scrolled).
+	std::chrono::steady_clock::duration maxAge;
+};
+
+// Caches thumbnail images, each identified by an integer ID (e.g. a tab ID). Each thumbnail is
+// stored along with the generation of the content it was captured from. Thumbnails aren't removed
+// when the content changes - the generation is only checked when the thumbnail is next needed, so
+// content that changes repeatedly doesn't result in any extra work.
+//
+// The total size of the cached images is bounded, with the least recently used thumbnails being
+// evicted once the limit is exceeded.
+class ThumbnailCache : private boost::noncopyable
+{
+public:
+	using Clock = std::chrono::steady_clock;
+
+	struct Entry
+	{
+		int id;
+		uint64_t generation;
+		Clock::time_point captureTime;
+		PixelBuffer image;
+	};
+
+	explicit ThumbnailCache(size_t maxSizeInBytes);
+
+	// Returns the cached thumbnail with the specified ID (regardless of its generation), marking it
+	// as the most recently used. The returned pointer remains valid until the cache is next
+	// modified.
+	const Entry *Find(int id);
+
+	// Adds the thumbnail, replacing any existing thumbnail with the same ID. If the image is larger
+	// than the whole cache, it won't be stored.
+	void Insert(int id, uint64_t generation, Clock::time_point captureTime, PixelBuffer image);
+
+	void Remove(int id);
+
+	size_t GetSizeInBytes() const;
+	size_t GetNumEntries() const;
+
+private:
+	struct ById
+	{
+	};
+
+	// clang-format off
+	using EntrySet = boost::multi_index_container<Entry,
+		boost::multi_index::indexed_by<
+			// Ordered from most to least recently used.
+			boost::multi_index::sequenced<>,
+
+			boost::multi_index::hashed_unique<
+				boost::multi_index::tag<ById>,
+				boost::multi_index::member<Entry, int, &Entry::id>
+			>
+		>
+	>;
+	// clang-format on
+
+	void EvictEntries();
+
+	const size_t m_maxSizeInBytes;
+	EntrySet m_entries;
+	size_t m_sizeInBytes = 0;
+};
+
+// Returns true if the cached thumbnail (which may be null) should be replaced by capturing the
+// content again.
+bool ShouldRecaptureThumbnail(const ThumbnailCache::Entry *entry, uint64_t currentGeneration,
+	ThumbnailCache::Clock::time_point now, const ThumbnailCapturePolicy &policy);
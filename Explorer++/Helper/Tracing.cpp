@@ -0,0 +1,393 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "stdafx.h"
+#include "Tracing.h"
+#include <algorithm>
+#include <utility>
+
+namespace
+{
+
+// Each recorder has a distinct ID, so that a thread's cached buffer is never mistaken for a buffer
+// belonging to a different recorder (even one that's created at the same address).
+std::atomic<uint64_t> g_nextRecorderId = 1;
+
+// The process ID is irrelevant when viewing a trace, so a fixed value is used.
+constexpr int TRACE_PROCESS_ID = 1;
+
+char GetPhase(TraceEventType type)
+{
+	switch (type)
+	{
+	case TraceEventType::Complete:
+		return 'X';
+
+	case TraceEventType::Instant:
+		return 'i';
+
+	case TraceEventType::Counter:
+		return 'C';
+
+	case TraceEventType::AsyncBegin:
+		return 'b';
+
+	case TraceEventType::AsyncEnd:
+		return 'e';
+
+	case TraceEventType::FlowBegin:
+		return 's';
+
+	case TraceEventType::FlowStep:
+		return 't';
+
+	case TraceEventType::FlowEnd:
+		return 'f';
+	}
+
+	LOG(FATAL) << "Unknown trace event type";
+	return 'i';
+}
+
+void WriteJsonString(std::ostream &stream, std::string_view value)
+{
+	static constexpr char HEX_DIGITS[] = "0123456789abcdef";
+
+	stream << '"';
+
+	for (char c : value)
+	{
+		switch (c)
+		{
+		case '"':
+			stream << "\\\"";
+			break;
+
+		case '\\':
+			stream << "\\\\";
+			break;
+
+		case '\n':
+			stream << "\\n";
+			break;
+
+		case '\r':
+			stream << "\\r";
+			break;
+
+		case '\t':
+			stream << "\\t";
+			break;
+
+		default:
+			if (static_cast<unsigned char>(c) < 0x20)
+			{
+				stream << "\\u00" << HEX_DIGITS[(c >> 4) & 0xF] << HEX_DIGITS[c & 0xF];
+			}
+			else
+			{
+				stream << c;
+			}
+			break;
+		}
+	}
+
+	stream << '"';
+}
+
+// Trace timestamps are in microseconds. They're written out with a fixed number of decimal places,
+// independent of the current locale.
+void WriteMicroseconds(std::ostream &stream, uint64_t nanoseconds)
+{
+	auto fraction = static_cast<int>(nanoseconds % 1000);
+	char fractionDigits[] = { static_cast<char>('0' + fraction / 100),
+		static_cast<char>('0' + (fraction / 10) % 10), static_cast<char>('0' + fraction % 10),
+		'\0' };
+
+	stream << nanoseconds / 1000 << '.' << fractionDigits;
+}
+
+void WriteEvent(std::ostream &stream, uint32_t threadId, const TraceEvent &event)
+{
+	stream << "{\"name\":";
+	WriteJsonString(stream, event.name);
+	stream << ",\"cat\":";
+	WriteJsonString(stream, event.category);
+	stream << ",\"ph\":\"" << GetPhase(event.type) << "\",\"ts\":";
+	WriteMicroseconds(stream, event.timestamp);
+	stream << ",\"pid\":" << TRACE_PROCESS_ID << ",\"tid\":" << threadId;
+
+	switch (event.type)
+	{
+	case TraceEventType::Complete:
+		stream << ",\"dur\":";
+		WriteMicroseconds(stream, event.duration);
+		break;
+
+	case TraceEventType::Instant:
+		// Instant events are scoped to the thread they occurred on.
+		stream << ",\"s\":\"t\"";
+		break;
+
+	case TraceEventType::AsyncBegin:
+	case TraceEventType::AsyncEnd:
+		stream << ",\"id\":\"0x" << std::hex << event.id << std::dec << '"';
+		break;
+
+	case TraceEventType::FlowBegin:
+	case TraceEventType::FlowStep:
+	case TraceEventType::FlowEnd:
+		// Binding each flow event to the enclosing span means that the event should be recorded
+		// from within a span.
+		stream << ",\"id\":\"0x" << std::hex << event.id << std::dec << "\",\"bp\":\"e\"";
+		break;
+
+	case TraceEventType::Counter:
+		// Counters are displayed using the names of their arguments, so there always needs to be
+		// at least one argument.
+		stream << ",\"args\":{";
+		WriteJsonString(stream, event.argName ? event.argName : "value");
+		stream << ':' << event.argValue << '}';
+		break;
+	}
+
+	if (event.argName && event.type != TraceEventType::Counter)
+	{
+		stream << ",\"args\":{";
+		WriteJsonString(stream, event.argName);
+		stream << ':' << event.argValue << '}';
+	}
+
+	stream << '}';
+}
+
+}
+
+TraceRecorder::TraceRecorder(size_t eventsPerThread) :
+	m_recorderId(g_nextRecorderId++),
+	m_eventsPerThread(std::max<size_t>(eventsPerThread, 1)),
+	m_epoch(std::chrono::steady_clock::now())
+{
+}
+
+void TraceRecorder::Start()
+{
+	std::scoped_lock lock(m_buffersMutex);
+
+	// A buffer that's only referenced here belongs to a thread that has exited. Those buffers are
+	// kept until the next recording starts, so that the events they contain can still be exported.
+	std::erase_if(m_buffers, [](const auto &buffer) { return buffer.use_count() == 1; });
+
+	for (auto &buffer : m_buffers)
+	{
+		std::scoped_lock bufferLock(buffer->mutex);
+		buffer->events.clear();
+		buffer->numRecorded = 0;
+	}
+
+	m_enabled = true;
+}
+
+void TraceRecorder::Stop()
+{
+	m_enabled = false;
+}
+
+void TraceRecorder::SetCurrentThreadName(const std::string &name)
+{
+	auto *buffer = GetCurrentThreadBuffer();
+
+	std::scoped_lock lock(buffer->mutex);
+	buffer->threadName = name;
+}
+
+uint64_t TraceRecorder::NewId()
+{
+	return m_nextId.fetch_add(1, std::memory_order_relaxed);
+}
+
+uint64_t TraceRecorder::GetTimestamp() const
+{
+	auto elapsed = std::chrono::steady_clock::now() - m_epoch;
+	return static_cast<uint64_t>(
+		std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+}
+
+void TraceRecorder::RecordEvent(const TraceEvent &event)
+{
+	auto *buffer = GetCurrentThreadBuffer();
+
+	std::scoped_lock lock(buffer->mutex);
+
+	// The buffer only grows as events are recorded, so threads that record few events use little
+	// memory.
+	if (buffer->events.size() < m_eventsPerThread)
+	{
+		buffer->events.push_back(event);
+	}
+	else
+	{
+		buffer->events[buffer->numRecorded % m_eventsPerThread] = event;
+	}
+
+	buffer->numRecorded++;
+}
+
+void TraceRecorder::RecordSimpleEvent(TraceEventType type, const char *category,
+	const char *name, uint64_t id, const char *argName, int64_t argValue)
+{
+	TraceEvent event;
+	event.category = category;
+	event.name = name;
+	event.type = type;
+	event.timestamp = GetTimestamp();
+	event.id = id;
+	event.argName = argName;
+	event.argValue = argValue;
+	RecordEvent(event);
+}
+
+TraceRecorder::ThreadBuffer *TraceRecorder::GetCurrentThreadBuffer()
+{
+	// In practice, there's only a single recorder, so this will almost always contain a single
+	// item.
+	thread_local std::vector<std::pair<uint64_t, std::shared_ptr<ThreadBuffer>>> threadBuffers;
+
+	for (const auto &[recorderId, buffer] : threadBuffers)
+	{
+		if (recorderId == m_recorderId)
+		{
+			return buffer.get();
+		}
+	}
+
+	auto buffer = std::make_shared<ThreadBuffer>();
+
+	{
+		std::scoped_lock lock(m_buffersMutex);
+
+		// Threads name themselves when they start, regardless of whether a recording is in
+		// progress, so buffers for threads that have exited without recording anything are removed
+		// here, to stop them from accumulating.
+		std::erase_if(m_buffers,
+			[](const auto &existingBuffer)
+			{
+				std::scoped_lock bufferLock(existingBuffer->mutex);
+				return existingBuffer.use_count() == 1 && existingBuffer->numRecorded == 0;
+			});
+
+		buffer->threadId = m_nextThreadId++;
+		m_buffers.push_back(buffer);
+	}
+
+	threadBuffers.emplace_back(m_recorderId, buffer);
+
+	return buffer.get();
+}
+
+std::vector<ThreadTraceEvents> TraceRecorder::GetEvents() const
+{
+	std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+
+	{
+		std::scoped_lock lock(m_buffersMutex);
+		buffers = m_buffers;
+	}
+
+	std::vector<ThreadTraceEvents> threadEvents;
+
+	for (const auto &buffer : buffers)
+	{
+		std::scoped_lock lock(buffer->mutex);
+
+		ThreadTraceEvents current;
+		current.threadId = buffer->threadId;
+		current.threadName = buffer->threadName;
+		current.events.reserve(buffer->events.size());
+
+		// Once the buffer has wrapped around, the oldest event is the one that will be overwritten
+		// next.
+		size_t oldest = buffer->numRecorded > buffer->events.size()
+			? static_cast<size_t>(buffer->numRecorded % m_eventsPerThread)
+			: 0;
+		current.events.insert(current.events.end(), buffer->events.begin() + oldest,
+			buffer->events.end());
+		current.events.insert(current.events.end(), buffer->events.begin(),
+			buffer->events.begin() + oldest);
+
+		threadEvents.push_back(std::move(current));
+	}
+
+	return threadEvents;
+}
+
+uint64_t TraceRecorder::GetNumDroppedEvents() const
+{
+	std::scoped_lock lock(m_buffersMutex);
+
+	uint64_t numDropped = 0;
+
+	for (const auto &buffer : m_buffers)
+	{
+		std::scoped_lock bufferLock(buffer->mutex);
+		numDropped += buffer->numRecorded - buffer->events.size();
+	}
+
+	return numDropped;
+}
+
+void TraceRecorder::WriteChromeTrace(std::ostream &stream) const
+{
+	auto threadEvents = GetEvents();
+
+	// The application sets a global locale, which could otherwise result in numbers being written
+	// with digit separators.
+	auto originalLocale = stream.imbue(std::locale::classic());
+
+	stream << "{\"traceEvents\":[";
+
+	bool first = true;
+
+	auto writeSeparator = [&stream, &first]()
+	{
+		if (!first)
+		{
+			stream << ",\n";
+		}
+		else
+		{
+			stream << '\n';
+		}
+
+		first = false;
+	};
+
+	for (const auto &current : threadEvents)
+	{
+		if (current.threadName.empty())
+		{
+			continue;
+		}
+
+		writeSeparator();
+		stream << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << TRACE_PROCESS_ID
+			   << ",\"tid\":" << current.threadId << ",\"args\":{\"name\":";
+		WriteJsonString(stream, current.threadName);
+		stream << "}}";
+	}
+
+	for (const auto &current : threadEvents)
+	{
+		for (const auto &event : current.events)
+		{
+			writeSeparator();
+			WriteEvent(stream, current.threadId, event);
+		}
+	}
+
+	stream << "\n],\"displayTimeUnit\":\"ms\",\"otherData\":{\"droppedEvents\":"
+		   << GetNumDroppedEvents() << "}}\n";
+
+	stream.imbue(originalLocale);
+}
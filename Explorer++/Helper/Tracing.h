@@ -0,0 +1,227 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#pragma once
+
+#include <boost/core/noncopyable.hpp>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// A lightweight tracing facility, used to find out where time goes (e.g. when a folder is slow to
+// open). Events are recorded into a bounded ring buffer per thread and can be exported in the
+// Chrome trace event format, which can be loaded into chrome://tracing or Perfetto.
+//
+// Recording is off by default. While it's off, each trace point costs a single relaxed atomic
+// load and nothing is allocated.
+//
+// Only pointers to the category, name and argument name strings are stored, so they should be
+// string literals.
+
+enum class TraceEventType : uint8_t
+{
+	// A span with a start time and a duration.
+	Complete,
+	Instant,
+	Counter,
+
+	// Async events mark the start and end of an operation that isn't tied to a single thread
+	// (e.g. a navigation). The begin and end events are matched by their ID.
+	AsyncBegin,
+	AsyncEnd,
+
+	// Flow events link spans on different threads together (e.g. a task being queued on one
+	// thread and run on another). They're attached to the span that encloses them.
+	FlowBegin,
+	FlowStep,
+	FlowEnd
+};
+
+struct TraceEvent
+{
+	const char *category = nullptr;
+	const char *name = nullptr;
+	TraceEventType type = TraceEventType::Instant;
+
+	// Both of these are in nanoseconds, with the timestamp being relative to the creation of the
+	// recorder.
+	uint64_t timestamp = 0;
+	uint64_t duration = 0;
+
+	// Used to match up async and flow events.
+	uint64_t id = 0;
+
+	// A single, optional, numeric argument. For counters, this is the counter value.
+	const char *argName = nullptr;
+	int64_t argValue = 0;
+};
+
+struct ThreadTraceEvents
+{
+	uint32_t threadId;
+	std::string threadName;
+	std::vector<TraceEvent> events;
+};
+
+class TraceRecorder : private boost::noncopyable
+{
+public:
+	static constexpr size_t DEFAULT_EVENTS_PER_THREAD = 16 * 1024;
+
+	explicit TraceRecorder(size_t eventsPerThread = DEFAULT_EVENTS_PER_THREAD);
+
+	bool IsEnabled() const
+	{
+		return m_enabled.load(std::memory_order_relaxed);
+	}
+
+	// Starting a recording discards any events from a previous recording.
+	void Start();
+	void Stop();
+
+	// Names the calling thread in exported traces. This can be called regardless of whether
+	// recording is enabled.
+	void SetCurrentThreadName(const std::string &name);
+
+	// Returns a process-wide unique ID, for use with async and flow events.
+	uint64_t NewId();
+
+	uint64_t GetTimestamp() const;
+
+	void RecordEvent(const TraceEvent &event);
+
+	void RecordInstant(const char *category, const char *name)
+	{
+		if (IsEnabled())
+		{
+			RecordSimpleEvent(TraceEventType::Instant, category, name, 0, nullptr, 0);
+		}
+	}
+
+	void RecordCounter(const char *category, const char *name, int64_t value)
+	{
+		if (IsEnabled())
+		{
+			RecordSimpleEvent(TraceEventType::Counter, category, name, 0, nullptr, value);
+		}
+	}
+
+	void RecordAsyncBegin(const char *category, const char *name, uint64_t id)
+	{
+		if (IsEnabled())
+		{
+			RecordSimpleEvent(TraceEventType::AsyncBegin, category, name, id, nullptr, 0);
+		}
+	}
+
+	void RecordAsyncEnd(const char *category, const char *name, uint64_t id)
+	{
+		if (IsEnabled())
+		{
+			RecordSimpleEvent(TraceEventType::AsyncEnd, category, name, id, nullptr, 0);
+		}
+	}
+
+	void RecordFlow(TraceEventType type, const char *category, const char *name, uint64_t id)
+	{
+		if (IsEnabled())
+		{
+			RecordSimpleEvent(type, category, name, id, nullptr, 0);
+		}
+	}
+
+	// Returns the events currently held by each thread's buffer, oldest first.
+	std::vector<ThreadTraceEvents> GetEvents() const;
+
+	// The number of events that were overwritten because a thread's buffer was full.
+	uint64_t GetNumDroppedEvents() const;
+
+	void WriteChromeTrace(std::ostream &stream) const;
+
+private:
+	struct ThreadBuffer
+	{
+		std::mutex mutex;
+		uint32_t threadId = 0;
+		std::string threadName;
+		std::vector<TraceEvent> events;
+		uint64_t numRecorded = 0;
+	};
+
+	void RecordSimpleEvent(TraceEventType type, const char *category, const char *name,
+		uint64_t id, const char *argName, int64_t argValue);
+	ThreadBuffer *GetCurrentThreadBuffer();
+
+	const uint64_t m_recorderId;
+	const size_t m_eventsPerThread;
+	const std::chrono::steady_clock::time_point m_epoch;
+	std::atomic<bool> m_enabled = false;
+	std::atomic<uint64_t> m_nextId = 1;
+
+	mutable std::mutex m_buffersMutex;
+	std::vector<std::shared_ptr<ThreadBuffer>> m_buffers;
+	uint32_t m_nextThreadId = 1;
+};
+
+// The recorder used by the application's trace points.
+inline TraceRecorder &GetTraceRecorder()
+{
+	static TraceRecorder recorder;
+	return recorder;
+}
+
+// Records a span covering the lifetime of the object. If recording is disabled when the object is
+// constructed, nothing is recorded.
+class TraceScope : private boost::noncopyable
+{
+public:
+	TraceScope(const char *category, const char *name,
+		TraceRecorder &recorder = GetTraceRecorder()) :
+		m_recorder(recorder.IsEnabled() ? &recorder : nullptr)
+	{
+		if (m_recorder)
+		{
+			m_event.category = category;
+			m_event.name = name;
+			m_event.type = TraceEventType::Complete;
+			m_event.timestamp = m_recorder->GetTimestamp();
+		}
+	}
+
+	~TraceScope()
+	{
+		if (m_recorder)
+		{
+			m_event.duration = m_recorder->GetTimestamp() - m_event.timestamp;
+			m_recorder->RecordEvent(m_event);
+		}
+	}
+
+	bool IsRecording() const
+	{
+		return m_recorder != nullptr;
+	}
+
+	void SetArg(const char *name, int64_t value)
+	{
+		m_event.argName = name;
+		m_event.argValue = value;
+	}
+
+private:
+	TraceRecorder *const m_recorder;
+	TraceEvent m_event;
+};
+
+#define TRACE_CONCATENATE_(a, b) a##b
+#define TRACE_CONCATENATE(a, b) TRACE_CONCATENATE_(a, b)
+
+// Traces the enclosing scope using the application's recorder.
+#define TRACE_SCOPE(category, name) \
+	TraceScope TRACE_CONCATENATE(traceScope, __LINE__)(category, name)
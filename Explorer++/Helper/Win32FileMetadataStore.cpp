@@ -0,0 +1,125 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "stdafx.h"
+#include "Win32FileMetadataStore.h"
+
+namespace
+{
+
+// The attributes that SetFileAttributes() is able to change. Passing any other attributes to that
+// function either has no effect, or causes it to fail.
+constexpr DWORD SETTABLE_ATTRIBUTES = FILE_ATTRIBUTE_ARCHIVE | FILE_ATTRIBUTE_HIDDEN
+	| FILE_ATTRIBUTE_NOT_CONTENT_INDEXED | FILE_ATTRIBUTE_OFFLINE | FILE_ATTRIBUTE_READONLY
+	| FILE_ATTRIBUTE_SYSTEM | FILE_ATTRIBUTE_TEMPORARY;
+
+std::error_code GetLastErrorCode()
+{
+	return std::error_code(static_cast<int>(GetLastError()), std::system_category());
+}
+
+}
+
+// On Windows, file_time_type has the same epoch and resolution as a FILETIME.
+std::filesystem::file_time_type FileTimeToFileTimeType(const FILETIME &fileTime)
+{
+	ULARGE_INTEGER ticks;
+	ticks.LowPart = fileTime.dwLowDateTime;
+	ticks.HighPart = fileTime.dwHighDateTime;
+	return std::filesystem::file_time_type(
+		std::filesystem::file_time_type::duration(static_cast<int64_t>(ticks.QuadPart)));
+}
+
+FILETIME FileTimeTypeToFileTime(std::filesystem::file_time_type time)
+{
+	ULARGE_INTEGER ticks;
+	ticks.QuadPart = static_cast<uint64_t>(time.time_since_epoch().count());
+
+	FILETIME fileTime;
+	fileTime.dwLowDateTime = ticks.LowPart;
+	fileTime.dwHighDateTime = ticks.HighPart;
+	return fileTime;
+}
+
+std::optional<FileMetadata> Win32FileMetadataStore::GetMetadata(const std::filesystem::path &path,
+	std::error_code &error)
+{
+	WIN32_FILE_ATTRIBUTE_DATA attributeData;
+	BOOL res = GetFileAttributesEx(path.c_str(), GetFileExInfoStandard, &attributeData);
+
+	if (!res)
+	{
+		error = GetLastErrorCode();
+		return std::nullopt;
+	}
+
+	error.clear();
+
+	FileMetadata metadata;
+	metadata.attributes = attributeData.dwFileAttributes;
+	metadata.creationTime = FileTimeToFileTimeType(attributeData.ftCreationTime);
+	metadata.lastAccessTime = FileTimeToFileTimeType(attributeData.ftLastAccessTime);
+	metadata.lastWriteTime = FileTimeToFileTimeType(attributeData.ftLastWriteTime);
+	return metadata;
+}
+
+std::error_code Win32FileMetadataStore::SetMetadata(const std::filesystem::path &path,
+	const FileMetadata &metadata)
+{
+	DWORD attributes = metadata.attributes & SETTABLE_ATTRIBUTES;
+
+	if (attributes == 0)
+	{
+		attributes = FILE_ATTRIBUTE_NORMAL;
+	}
+
+	if (!SetFileAttributes(path.c_str(), attributes))
+	{
+		return GetLastErrorCode();
+	}
+
+	if (!metadata.creationTime && !metadata.lastAccessTime && !metadata.lastWriteTime)
+	{
+		return {};
+	}
+
+	// Opening the item with FILE_WRITE_ATTRIBUTES works even when it's read-only.
+	wil::unique_hfile file(CreateFile(path.c_str(), FILE_WRITE_ATTRIBUTES,
+		FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING,
+		FILE_FLAG_BACKUP_SEMANTICS, nullptr));
+
+	if (!file)
+	{
+		return GetLastErrorCode();
+	}
+
+	std::optional<FILETIME> creationTime;
+	std::optional<FILETIME> lastAccessTime;
+	std::optional<FILETIME> lastWriteTime;
+
+	if (metadata.creationTime)
+	{
+		creationTime = FileTimeTypeToFileTime(*metadata.creationTime);
+	}
+
+	if (metadata.lastAccessTime)
+	{
+		lastAccessTime = FileTimeTypeToFileTime(*metadata.lastAccessTime);
+	}
+
+	if (metadata.lastWriteTime)
+	{
+		lastWriteTime = FileTimeTypeToFileTime(*metadata.lastWriteTime);
+	}
+
+	BOOL res = SetFileTime(file.get(), creationTime ? &*creationTime : nullptr,
+		lastAccessTime ? &*lastAccessTime : nullptr, lastWriteTime ? &*lastWriteTime : nullptr);
+
+	if (!res)
+	{
+		return GetLastErrorCode();
+	}
+
+	return {};
+}
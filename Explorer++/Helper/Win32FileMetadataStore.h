@@ -0,0 +1,21 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#pragma once
+
+#include "FileMetadataStore.h"
+
+// Supports every attribute that can be set through SetFileAttributes(), along with all three
+// timestamps.
+class Win32FileMetadataStore : public FileMetadataStore
+{
+public:
+	std::optional<FileMetadata> GetMetadata(const std::filesystem::path &path,
+		std::error_code &error) override;
+	std::error_code SetMetadata(const std::filesystem::path &path,
+		const FileMetadata &metadata) override;
+};
+
+std::filesystem::file_time_type FileTimeToFileTimeType(const FILETIME &fileTime);
+FILETIME FileTimeTypeToFileTime(std::filesystem::file_time_type time);
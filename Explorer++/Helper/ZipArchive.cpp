@@ -0,0 +1,1242 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "stdafx.h"
+#include "ZipArchive.h"
+#include "ParallelFor.h"
+#include "TextEncoding.h"
+#include <zlib.h>
+#include <algorithm>
+#include <cstring>
+#include <ctime>
+#include <limits>
+
+namespace
+{
+
+constexpr uint32_t LOCAL_HEADER_SIGNATURE = 0x04034b50;
+constexpr uint32_t CENTRAL_HEADER_SIGNATURE = 0x02014b50;
+constexpr uint32_t END_OF_CENTRAL_DIRECTORY_SIGNATURE = 0x06054b50;
+constexpr uint32_t ZIP64_END_OF_CENTRAL_DIRECTORY_SIGNATURE = 0x06064b50;
+constexpr uint32_t ZIP64_LOCATOR_SIGNATURE = 0x07064b50;
+
+constexpr size_t LOCAL_HEADER_SIZE = 30;
+constexpr size_t CENTRAL_HEADER_SIZE = 46;
+constexpr size_t END_OF_CENTRAL_DIRECTORY_SIZE = 22;
+constexpr size_t ZIP64_END_OF_CENTRAL_DIRECTORY_SIZE = 56;
+constexpr size_t ZIP64_LOCATOR_SIZE = 20;
+constexpr size_t MAX_COMMENT_SIZE = 0xFFFF;
+
+constexpr uint16_t ZIP64_EXTRA_FIELD_ID = 0x0001;
+constexpr uint16_t NTFS_EXTRA_FIELD_ID = 0x000a;
+constexpr uint16_t EXTENDED_TIMESTAMP_EXTRA_FIELD_ID = 0x5455;
+constexpr uint16_t UNICODE_PATH_EXTRA_FIELD_ID = 0x7075;
+
+constexpr uint16_t FLAG_ENCRYPTED = 0x0001;
+constexpr uint16_t FLAG_UTF8 = 0x0800;
+
+constexpr uint16_t METHOD_STORED = 0;
+constexpr uint16_t METHOD_DEFLATED = 8;
+
+constexpr uint32_t DOS_DIRECTORY_ATTRIBUTE = 0x10;
+constexpr uint8_t HOST_SYSTEM_UNIX = 3;
+constexpr uint32_t UNIX_FILE_TYPE_MASK = 0170000;
+constexpr uint32_t UNIX_DIRECTORY_TYPE = 0040000;
+
+// The number of 100-nanosecond intervals between 1601-01-01 (the FILETIME epoch) and 1970-01-01.
+constexpr int64_t FILETIME_UNIX_EPOCH_DIFFERENCE = 116444736000000000;
+
+// The characters 0x80-0xFF of code page 437, which is the encoding used for names that aren't
+// flagged as being UTF-8.
+constexpr char16_t CP437_HIGH_CHARACTERS[128] = { 0x00C7, 0x00FC, 0x00E9, 0x00E2, 0x00E4, 0x00E0,
+	0x00E5, 0x00E7, 0x00EA, 0x00EB, 0x00E8, 0x00EF, 0x00EE, 0x00EC, 0x00C4, 0x00C5, 0x00C9, 0x00E6,
+	0x00C6, 0x00F4, 0x00F6, 0x00F2, 0x00FB, 0x00F9, 0x00FF, 0x00D6, 0x00DC, 0x00A2, 0x00A3, 0x00A5,
+	0x20A7, 0x0192, 0x00E1, 0x00ED, 0x00F3, 0x00FA, 0x00F1, 0x00D1, 0x00AA, 0x00BA, 0x00BF, 0x2310,
+	0x00AC, 0x00BD, 0x00BC, 0x00A1, 0x00AB, 0x00BB, 0x2591, 0x2592, 0x2593, 0x2502, 0x2524, 0x2561,
+	0x2562, 0x2556, 0x2555, 0x2563, 0x2551, 0x2557, 0x255D, 0x255C, 0x255B, 0x2510, 0x2514, 0x2534,
+	0x252C, 0x251C, 0x2500, 0x253C, 0x255E, 0x255F, 0x255A, 0x2554, 0x2569, 0x2566, 0x2560, 0x2550,
+	0x256C, 0x2567, 0x2568, 0x2564, 0x2565, 0x2559, 0x2558, 0x2552, 0x2553, 0x256B, 0x256A, 0x2518,
+	0x250C, 0x2588, 0x2584, 0x258C, 0x2590, 0x2580, 0x03B1, 0x00DF, 0x0393, 0x03C0, 0x03A3, 0x03C3,
+	0x00B5, 0x03C4, 0x03A6, 0x0398, 0x03A9, 0x03B4, 0x221E, 0x03C6, 0x03B5, 0x2229, 0x2261, 0x00B1,
+	0x2265, 0x2264, 0x2320, 0x2321, 0x00F7, 0x2248, 0x00B0, 0x2219, 0x00B7, 0x221A, 0x207F, 0x00B2,
+	0x25A0, 0x00A0 };
+
+uint16_t ReadUInt16(std::span<const std::byte> data, size_t offset)
+{
+	return static_cast<uint16_t>(std::to_integer<uint16_t>(data[offset])
+		| (std::to_integer<uint16_t>(data[offset + 1]) << 8));
+}
+
+uint32_t ReadUInt32(std::span<const std::byte> data, size_t offset)
+{
+	return static_cast<uint32_t>(ReadUInt16(data, offset))
+		| (static_cast<uint32_t>(ReadUInt16(data, offset + 2)) << 16);
+}
+
+uint64_t ReadUInt64(std::span<const std::byte> data, size_t offset)
+{
+	return static_cast<uint64_t>(ReadUInt32(data, offset))
+		| (static_cast<uint64_t>(ReadUInt32(data, offset + 4)) << 32);
+}
+
+std::wstring DecodeCp437(std::string_view input)
+{
+	std::wstring output;
+	output.reserve(input.size());
+
+	for (char c : input)
+	{
+		auto value = static_cast<unsigned char>(c);
+		output.push_back(
+			value < 0x80 ? static_cast<wchar_t>(value) : CP437_HIGH_CHARACTERS[value - 0x80]);
+	}
+
+	return output;
+}
+
+uint32_t CalculateCrc32(uint32_t crc, std::span<const std::byte> data)
+{
+	return static_cast<uint32_t>(::crc32(crc, reinterpret_cast<const Bytef *>(data.data()),
+		static_cast<uInt>(data.size())));
+}
+
+struct ExtraFields
+{
+	std::optional<std::chrono::sys_seconds> utcModifiedTime;
+	std::optional<std::string> unicodePath;
+};
+
+// Fills in any of the 32-bit fields that were saturated in the central directory header, using the
+// ZIP64 extra field. Returns false if a saturated field is missing from the extra field.
+bool ApplyZip64ExtraField(std::span<const std::byte> field, ZipEntry &entry)
+{
+	size_t offset = 0;
+
+	auto readField = [&field, &offset](uint64_t &value)
+	{
+		if (offset + 8 > field.size())
+		{
+			return false;
+		}
+
+		value = ReadUInt64(field, offset);
+		offset += 8;
+		return true;
+	};
+
+	if (entry.uncompressedSize == UINT32_MAX && !readField(entry.uncompressedSize))
+	{
+		return false;
+	}
+
+	if (entry.compressedSize == UINT32_MAX && !readField(entry.compressedSize))
+	{
+		return false;
+	}
+
+	if (entry.localHeaderOffset == UINT32_MAX && !readField(entry.localHeaderOffset))
+	{
+		return false;
+	}
+
+	return true;
+}
+
+std::optional<ExtraFields> ParseExtraFields(std::span<const std::byte> data,
+	std::string_view rawName, ZipEntry &entry)
+{
+	ExtraFields fields;
+	size_t offset = 0;
+
+	while (offset + 4 <= data.size())
+	{
+		uint16_t id = ReadUInt16(data, offset);
+		uint16_t size = ReadUInt16(data, offset + 2);
+		offset += 4;
+
+		if (offset + size > data.size())
+		{
+			// Some tools pad the extra data, so a truncated field is ignored rather than causing
+			// the entry to be rejected.
+			break;
+		}
+
+		auto field = data.subspan(offset, size);
+		offset += size;
+
+		switch (id)
+		{
+		case ZIP64_EXTRA_FIELD_ID:
+			if (!ApplyZip64ExtraField(field, entry))
+			{
+				return std::nullopt;
+			}
+			break;
+
+		case NTFS_EXTRA_FIELD_ID:
+			// A 4-byte reserved value, followed by a set of tagged attributes. Tag 1 contains the
+			// modification, access and creation times, as FILETIME values.
+			for (size_t tagOffset = 4; tagOffset + 4 <= field.size();)
+			{
+				uint16_t tag = ReadUInt16(field, tagOffset);
+				uint16_t tagSize = ReadUInt16(field, tagOffset + 2);
+				tagOffset += 4;
+
+				if (tag == 1 && tagSize >= 8 && tagOffset + 8 <= field.size())
+				{
+					auto fileTime = static_cast<int64_t>(ReadUInt64(field, tagOffset));
+					fields.utcModifiedTime = std::chrono::sys_seconds(std::chrono::seconds(
+						(fileTime - FILETIME_UNIX_EPOCH_DIFFERENCE) / 10'000'000));
+					break;
+				}
+
+				tagOffset += tagSize;
+			}
+			break;
+
+		case EXTENDED_TIMESTAMP_EXTRA_FIELD_ID:
+			// A set of flags, indicating which times are present, followed by the times themselves,
+			// as signed Unix timestamps. The NTFS field is preferred, if both are present.
+			if (field.size() >= 5 && (std::to_integer<uint8_t>(field[0]) & 1)
+				&& !fields.utcModifiedTime)
+			{
+				auto unixTime = static_cast<int32_t>(ReadUInt32(field, 1));
+				fields.utcModifiedTime = std::chrono::sys_seconds(std::chrono::seconds(unixTime));
+			}
+			break;
+
+		case UNICODE_PATH_EXTRA_FIELD_ID:
+			// A version, followed by the checksum of the name in the header and then the UTF-8
+			// name. The checksum ensures the name is ignored if the header was changed by a tool
+			// that didn't know about this field.
+			if (field.size() > 5 && std::to_integer<uint8_t>(field[0]) == 1
+				&& ReadUInt32(field, 1)
+					== CalculateCrc32(0, std::as_bytes(std::span(rawName.data(), rawName.size()))))
+			{
+				auto unicodePath = field.subspan(5);
+				fields.unicodePath.emplace(reinterpret_cast<const char *>(unicodePath.data()),
+					unicodePath.size());
+			}
+			break;
+		}
+	}
+
+	return fields;
+}
+
+// Splits the path into its components, returning an empty value if the path is absolute, or
+// contains a component that refers to a parent folder.
+std::optional<std::vector<std::wstring_view>> SplitEntryPath(std::wstring_view path)
+{
+	if (path.empty() || path[0] == '/' || path.find(':') != std::wstring_view::npos)
+	{
+		return std::nullopt;
+	}
+
+	std::vector<std::wstring_view> components;
+	size_t start = 0;
+
+	while (start <= path.size())
+	{
+		size_t end = path.find('/', start);
+
+		if (end == std::wstring_view::npos)
+		{
+			end = path.size();
+		}
+
+		auto component = path.substr(start, end - start);
+
+		if (component == L"..")
+		{
+			return std::nullopt;
+		}
+
+		if (!component.empty() && component != L".")
+		{
+			components.push_back(component);
+		}
+
+		start = end + 1;
+	}
+
+	if (components.empty())
+	{
+		return std::nullopt;
+	}
+
+	return components;
+}
+
+class InflateStream : private boost::noncopyable
+{
+public:
+	InflateStream()
+	{
+		// A negative window size indicates raw deflate data, without a zlib header.
+		m_initialized = (inflateInit2(&m_stream, -MAX_WBITS) == Z_OK);
+	}
+
+	~InflateStream()
+	{
+		if (m_initialized)
+		{
+			inflateEnd(&m_stream);
+		}
+	}
+
+	bool IsInitialized() const
+	{
+		return m_initialized;
+	}
+
+	z_stream *Get()
+	{
+		return &m_stream;
+	}
+
+private:
+	z_stream m_stream = {};
+	bool m_initialized = false;
+};
+
+}
+
+ZipMemorySource::ZipMemorySource(std::vector<std::byte> data) : m_data(std::move(data))
+{
+}
+
+uint64_t ZipMemorySource::GetSize() const
+{
+	return m_data.size();
+}
+
+bool ZipMemorySource::Read(uint64_t offset, std::span<std::byte> buffer) const
+{
+	if (offset > m_data.size() || buffer.size() > m_data.size() - offset)
+	{
+		return false;
+	}
+
+	// The data pointers can be null when either buffer is empty, which std::memcpy doesn't allow.
+	if (buffer.empty())
+	{
+		return true;
+	}
+
+	std::memcpy(buffer.data(), m_data.data() + offset, buffer.size());
+	return true;
+}
+
+std::unique_ptr<ZipFileSource> ZipFileSource::Open(const std::filesystem::path &path)
+{
+	auto stream = std::make_unique<std::ifstream>(path, std::ios::binary);
+
+	if (!stream->is_open())
+	{
+		return nullptr;
+	}
+
+	std::error_code error;
+	auto size = std::filesystem::file_size(path, error);
+
+	if (error)
+	{
+		return nullptr;
+	}
+
+	return std::unique_ptr<ZipFileSource>(new ZipFileSource(path, std::move(stream), size));
+}
+
+ZipFileSource::ZipFileSource(const std::filesystem::path &path,
+	std::unique_ptr<std::ifstream> stream, uint64_t size) :
+	m_path(path),
+	m_size(size)
+{
+	m_freeStreams.push_back(std::move(stream));
+}
+
+uint64_t ZipFileSource::GetSize() const
+{
+	return m_size;
+}
+
+bool ZipFileSource::Read(uint64_t offset, std::span<std::byte> buffer) const
+{
+	if (offset > m_size || buffer.size() > m_size - offset)
+	{
+		return false;
+	}
+
+	auto stream = AcquireStream();
+
+	if (!stream)
+	{
+		return false;
+	}
+
+	stream->clear();
+	stream->seekg(static_cast<std::streamoff>(offset));
+	stream->read(reinterpret_cast<char *>(buffer.data()),
+		static_cast<std::streamsize>(buffer.size()));
+	bool success = stream->good()
+		&& static_cast<size_t>(stream->gcount()) == buffer.size();
+
+	ReleaseStream(std::move(stream));
+
+	return success;
+}
+
+std::unique_ptr<std::ifstream> ZipFileSource::AcquireStream() const
+{
+	{
+		std::scoped_lock lock(m_mutex);
+
+		if (!m_freeStreams.empty())
+		{
+			auto stream = std::move(m_freeStreams.back());
+			m_freeStreams.pop_back();
+			return stream;
+		}
+	}
+
+	auto stream = std::make_unique<std::ifstream>(m_path, std::ios::binary);
+
+	if (!stream->is_open())
+	{
+		return nullptr;
+	}
+
+	return stream;
+}
+
+void ZipFileSource::ReleaseStream(std::unique_ptr<std::ifstream> stream) const
+{
+	std::scoped_lock lock(m_mutex);
+	m_freeStreams.push_back(std::move(stream));
+}
+
+std::unique_ptr<ZipArchive> ZipArchive::Open(std::unique_ptr<ZipSource> source)
+{
+	std::unique_ptr<ZipArchive> archive(new ZipArchive(std::move(source)));
+
+	if (!archive->ReadCentralDirectory())
+	{
+		return nullptr;
+	}
+
+	return archive;
+}
+
+ZipArchive::ZipArchive(std::unique_ptr<ZipSource> source) : m_source(std::move(source))
+{
+}
+
+bool ZipArchive::ReadCentralDirectory()
+{
+	uint64_t archiveSize = m_source->GetSize();
+
+	if (archiveSize < END_OF_CENTRAL_DIRECTORY_SIZE)
+	{
+		return false;
+	}
+
+	// The end of central directory record is at the end of the archive, followed only by the
+	// archive comment, so it's found by scanning backwards through the largest possible comment.
+	auto tailSize = static_cast<size_t>(
+		std::min<uint64_t>(archiveSize, END_OF_CENTRAL_DIRECTORY_SIZE + MAX_COMMENT_SIZE));
+	uint64_t tailOffset = archiveSize - tailSize;
+	std::vector<std::byte> tail(tailSize);
+
+	if (!m_source->Read(tailOffset, tail))
+	{
+		return false;
+	}
+
+	std::optional<size_t> recordPosition;
+
+	for (size_t i = tailSize - END_OF_CENTRAL_DIRECTORY_SIZE + 1; i-- > 0;)
+	{
+		if (ReadUInt32(tail, i) == END_OF_CENTRAL_DIRECTORY_SIGNATURE
+			&& i + END_OF_CENTRAL_DIRECTORY_SIZE + ReadUInt16(tail, i + 20) <= tailSize)
+		{
+			recordPosition = i;
+			break;
+		}
+	}
+
+	if (!recordPosition)
+	{
+		return false;
+	}
+
+	auto record = std::span<const std::byte>(tail).subspan(*recordPosition);
+	uint64_t recordOffset = tailOffset + *recordPosition;
+	uint64_t numEntries = ReadUInt16(record, 10);
+	uint64_t directorySize = ReadUInt32(record, 12);
+	uint64_t directoryOffset = ReadUInt32(record, 16);
+
+	// The offset at which the central directory is expected to end. Data can be prepended to an
+	// archive (as in a self-extracting archive), in which case the stored offsets will all be off
+	// by the same amount.
+	uint64_t directoryEnd = recordOffset;
+
+	if (numEntries == UINT16_MAX || directorySize == UINT32_MAX || directoryOffset == UINT32_MAX)
+	{
+		if (recordOffset < ZIP64_LOCATOR_SIZE + ZIP64_END_OF_CENTRAL_DIRECTORY_SIZE)
+		{
+			return false;
+		}
+
+		std::byte locator[ZIP64_LOCATOR_SIZE];
+		uint64_t locatorOffset = recordOffset - ZIP64_LOCATOR_SIZE;
+
+		if (!m_source->Read(locatorOffset, locator)
+			|| ReadUInt32(locator, 0) != ZIP64_LOCATOR_SIGNATURE)
+		{
+			return false;
+		}
+
+		// The ZIP64 record can be followed by extensible data, but almost never is, so its expected
+		// position is right before the locator.
+		uint64_t zip64RecordOffset = ReadUInt64(locator, 8);
+		uint64_t expectedRecordOffset = locatorOffset - ZIP64_END_OF_CENTRAL_DIRECTORY_SIZE;
+		std::byte zip64Record[ZIP64_END_OF_CENTRAL_DIRECTORY_SIZE];
+
+		if (!m_source->Read(zip64RecordOffset, zip64Record)
+			|| ReadUInt32(zip64Record, 0) != ZIP64_END_OF_CENTRAL_DIRECTORY_SIGNATURE)
+		{
+			zip64RecordOffset = expectedRecordOffset;
+
+			if (!m_source->Read(zip64RecordOffset, zip64Record)
+				|| ReadUInt32(zip64Record, 0) != ZIP64_END_OF_CENTRAL_DIRECTORY_SIGNATURE)
+			{
+				return false;
+			}
+		}
+
+		numEntries = ReadUInt64(zip64Record, 32);
+		directorySize = ReadUInt64(zip64Record, 40);
+		directoryOffset = ReadUInt64(zip64Record, 48);
+		directoryEnd = zip64RecordOffset;
+	}
+
+	if (directorySize > directoryEnd || directoryOffset > directoryEnd - directorySize)
+	{
+		return false;
+	}
+
+	m_offsetBias = directoryEnd - directorySize - directoryOffset;
+
+	// Each entry takes up at least the size of the fixed header, so this rejects a corrupt count
+	// before it's used to reserve memory.
+	if (numEntries > directorySize / CENTRAL_HEADER_SIZE
+		|| numEntries >= std::numeric_limits<EntryId>::max() / 2)
+	{
+		return false;
+	}
+
+	std::vector<std::byte> directory(static_cast<size_t>(directorySize));
+
+	if (!m_source->Read(directoryOffset + m_offsetBias, directory))
+	{
+		return false;
+	}
+
+	return ParseCentralDirectory(directory, numEntries);
+}
+
+bool ZipArchive::ParseCentralDirectory(std::span<const std::byte> data, uint64_t numEntries)
+{
+	m_entries.reserve(static_cast<size_t>(numEntries) + 1);
+
+	ZipEntry root;
+	root.isFolder = true;
+	m_entries.push_back(std::move(root));
+
+	size_t offset = 0;
+
+	for (uint64_t i = 0; i < numEntries; i++)
+	{
+		if (offset + CENTRAL_HEADER_SIZE > data.size()
+			|| ReadUInt32(data, offset) != CENTRAL_HEADER_SIGNATURE)
+		{
+			return false;
+		}
+
+		auto header = data.subspan(offset);
+		uint16_t versionMadeBy = ReadUInt16(header, 4);
+		uint16_t flags = ReadUInt16(header, 8);
+		uint16_t nameLength = ReadUInt16(header, 28);
+		uint16_t extraLength = ReadUInt16(header, 30);
+		uint16_t commentLength = ReadUInt16(header, 32);
+		uint32_t externalAttributes = ReadUInt32(header, 38);
+
+		size_t recordSize = CENTRAL_HEADER_SIZE + nameLength + extraLength + commentLength;
+
+		if (recordSize > header.size())
+		{
+			return false;
+		}
+
+		ZipEntry entry;
+		entry.isEncrypted = (flags & FLAG_ENCRYPTED) != 0;
+		entry.compressionMethod = ReadUInt16(header, 10);
+		entry.dosDateTime = (static_cast<uint32_t>(ReadUInt16(header, 14)) << 16)
+			| ReadUInt16(header, 12);
+		entry.crc32 = ReadUInt32(header, 16);
+		entry.compressedSize = ReadUInt32(header, 20);
+		entry.uncompressedSize = ReadUInt32(header, 24);
+		entry.localHeaderOffset = ReadUInt32(header, 42);
+
+		uint32_t unixMode = externalAttributes >> 16;
+		entry.isFolder = (externalAttributes & DOS_DIRECTORY_ATTRIBUTE)
+			|| ((versionMadeBy >> 8) == HOST_SYSTEM_UNIX
+				&& (unixMode & UNIX_FILE_TYPE_MASK) == UNIX_DIRECTORY_TYPE);
+
+		std::string_view rawName(
+			reinterpret_cast<const char *>(header.data() + CENTRAL_HEADER_SIZE), nameLength);
+		auto extraFields = ParseExtraFields(
+			header.subspan(CENTRAL_HEADER_SIZE + nameLength, extraLength), rawName, entry);
+
+		offset += recordSize;
+
+		if (!extraFields)
+		{
+			return false;
+		}
+
+		entry.utcModifiedTime = extraFields->utcModifiedTime;
+
+		std::wstring path;
+
+		if (extraFields->unicodePath)
+		{
+			path = DecodeUtf8(*extraFields->unicodePath);
+		}
+		else if (flags & FLAG_UTF8)
+		{
+			path = DecodeUtf8(rawName);
+		}
+		else
+		{
+			path = DecodeCp437(rawName);
+		}
+
+		AddEntry(path, std::move(entry));
+	}
+
+	m_folderIds = {};
+	m_lastParent.reset();
+	m_lastParentPath.clear();
+
+	BuildChildLists();
+
+	return true;
+}
+
+void ZipArchive::AddEntry(std::wstring path, ZipEntry entry)
+{
+	std::replace(path.begin(), path.end(), L'\\', L'/');
+
+	if (!path.empty() && path.back() == '/')
+	{
+		entry.isFolder = true;
+	}
+
+	if (entry.isFolder)
+	{
+		entry.compressedSize = 0;
+		entry.uncompressedSize = 0;
+	}
+
+	auto components = SplitEntryPath(path);
+
+	if (!components)
+	{
+		return;
+	}
+
+	auto parentComponents = std::span(*components).first(components->size() - 1);
+	std::wstring parentPath;
+
+	for (auto component : parentComponents)
+	{
+		if (!parentPath.empty())
+		{
+			parentPath += '/';
+		}
+
+		parentPath += component;
+	}
+
+	// Entries are usually grouped by folder, so the parent is typically the same as the parent of
+	// the previous entry.
+	if (!m_lastParent || parentPath != m_lastParentPath)
+	{
+		m_lastParent = FindOrAddFolder(parentComponents);
+		m_lastParentPath = std::move(parentPath);
+	}
+
+	entry.name = components->back();
+	entry.parent = *m_lastParent;
+
+	if (entry.isFolder)
+	{
+		std::wstring folderPath = m_lastParentPath.empty()
+			? entry.name
+			: m_lastParentPath + L'/' + entry.name;
+		auto [itr, inserted] = m_folderIds.try_emplace(std::move(folderPath),
+			static_cast<EntryId>(m_entries.size()));
+
+		if (!inserted)
+		{
+			// The folder has already been added, either explicitly or because it was implied by the
+			// path of an earlier entry.
+			m_entries[itr->second] = std::move(entry);
+			return;
+		}
+	}
+
+	m_entries.push_back(std::move(entry));
+}
+
+ZipArchive::EntryId ZipArchive::FindOrAddFolder(std::span<const std::wstring_view> components)
+{
+	EntryId folder = ROOT_ID;
+	std::wstring path;
+
+	for (auto component : components)
+	{
+		if (!path.empty())
+		{
+			path += '/';
+		}
+
+		path += component;
+
+		auto [itr, inserted] =
+			m_folderIds.try_emplace(path, static_cast<EntryId>(m_entries.size()));
+
+		if (inserted)
+		{
+			ZipEntry impliedFolder;
+			impliedFolder.name = component;
+			impliedFolder.parent = folder;
+			impliedFolder.isFolder = true;
+			impliedFolder.isImplied = true;
+			m_entries.push_back(std::move(impliedFolder));
+		}
+
+		folder = itr->second;
+	}
+
+	return folder;
+}
+
+void ZipArchive::BuildChildLists()
+{
+	std::vector<uint32_t> offsets(m_entries.size() + 1, 0);
+
+	for (EntryId id = 1; id < m_entries.size(); id++)
+	{
+		offsets[m_entries[id].parent + 1]++;
+	}
+
+	for (size_t i = 1; i < offsets.size(); i++)
+	{
+		offsets[i] += offsets[i - 1];
+	}
+
+	std::vector<EntryId> children(m_entries.size() - 1);
+	std::vector<uint32_t> positions(offsets.begin(), offsets.end() - 1);
+
+	for (EntryId id = 1; id < m_entries.size(); id++)
+	{
+		children[positions[m_entries[id].parent]++] = id;
+	}
+
+	auto compareEntries = [this](EntryId first, EntryId second)
+	{
+		const auto &firstName = m_entries[first].name;
+		const auto &secondName = m_entries[second].name;
+		return firstName < secondName || (firstName == secondName && first < second);
+	};
+
+	m_children.reserve(children.size());
+	m_childOffsets.resize(m_entries.size() + 1);
+
+	for (size_t i = 0; i < m_entries.size(); i++)
+	{
+		auto begin = children.begin() + offsets[i];
+		auto end = children.begin() + offsets[i + 1];
+		std::sort(begin, end, compareEntries);
+
+		m_childOffsets[i] = static_cast<uint32_t>(m_children.size());
+
+		// An archive can contain the same path more than once. If that's the case, only one of
+		// the entries is kept. A folder takes precedence over a file (so that the folder's
+		// contents are still accessible); otherwise, the last entry is kept, since that's
+		// typically the result of a file being updated within the archive.
+		for (auto itr = begin; itr != end;)
+		{
+			auto runEnd = std::find_if(itr, end,
+				[this, itr](EntryId id) { return m_entries[id].name != m_entries[*itr].name; });
+			auto folder =
+				std::find_if(itr, runEnd, [this](EntryId id) { return m_entries[id].isFolder; });
+			m_children.push_back(folder != runEnd ? *folder : *(runEnd - 1));
+			itr = runEnd;
+		}
+	}
+
+	m_childOffsets[m_entries.size()] = static_cast<uint32_t>(m_children.size());
+}
+
+const ZipEntry &ZipArchive::GetEntry(EntryId id) const
+{
+	return m_entries.at(id);
+}
+
+std::span<const ZipArchive::EntryId> ZipArchive::GetChildren(EntryId folder) const
+{
+	if (folder >= m_entries.size())
+	{
+		return {};
+	}
+
+	return std::span(m_children)
+		.subspan(m_childOffsets[folder], m_childOffsets[folder + 1] - m_childOffsets[folder]);
+}
+
+std::optional<ZipArchive::EntryId> ZipArchive::FindChild(EntryId parent,
+	std::wstring_view name) const
+{
+	auto children = GetChildren(parent);
+	auto itr = std::lower_bound(children.begin(), children.end(), name,
+		[this](EntryId id, std::wstring_view target) { return m_entries[id].name < target; });
+
+	if (itr == children.end() || m_entries[*itr].name != name)
+	{
+		return std::nullopt;
+	}
+
+	return *itr;
+}
+
+std::optional<ZipArchive::EntryId> ZipArchive::FindEntry(std::wstring_view path) const
+{
+	EntryId current = ROOT_ID;
+	size_t start = 0;
+
+	while (start < path.size())
+	{
+		size_t end = path.find_first_of(L"/\\", start);
+
+		if (end == std::wstring_view::npos)
+		{
+			end = path.size();
+		}
+
+		if (end > start)
+		{
+			auto child = FindChild(current, path.substr(start, end - start));
+
+			if (!child)
+			{
+				return std::nullopt;
+			}
+
+			current = *child;
+		}
+
+		start = end + 1;
+	}
+
+	return current;
+}
+
+std::wstring ZipArchive::GetEntryPath(EntryId id) const
+{
+	std::vector<const std::wstring *> names;
+
+	for (EntryId current = id; current != ROOT_ID; current = m_entries.at(current).parent)
+	{
+		names.push_back(&m_entries[current].name);
+	}
+
+	std::wstring path;
+
+	for (auto itr = names.rbegin(); itr != names.rend(); ++itr)
+	{
+		if (!path.empty())
+		{
+			path += '/';
+		}
+
+		path += **itr;
+	}
+
+	return path;
+}
+
+size_t ZipArchive::GetNumEntries() const
+{
+	return m_entries.size();
+}
+
+ZipExtractResult ZipArchive::ExtractEntry(EntryId id, const ZipDataSink &sink,
+	std::stop_token stopToken) const
+{
+	const ZipEntry &entry = GetEntry(id);
+
+	if (entry.isFolder)
+	{
+		return ZipExtractResult::Folder;
+	}
+
+	if (entry.isEncrypted)
+	{
+		return ZipExtractResult::Encrypted;
+	}
+
+	if (entry.compressionMethod != METHOD_STORED && entry.compressionMethod != METHOD_DEFLATED)
+	{
+		return ZipExtractResult::UnsupportedMethod;
+	}
+
+	auto dataOffset = GetDataOffset(entry);
+
+	if (!dataOffset)
+	{
+		return ZipExtractResult::CorruptData;
+	}
+
+	uint32_t crc = CalculateCrc32(0, {});
+	ZipExtractResult result;
+
+	if (entry.compressionMethod == METHOD_STORED)
+	{
+		result = CopyStoredData(entry, *dataOffset, sink, stopToken, crc);
+	}
+	else
+	{
+		result = InflateData(entry, *dataOffset, sink, stopToken, crc);
+	}
+
+	if (result != ZipExtractResult::Success)
+	{
+		return result;
+	}
+
+	if (crc != entry.crc32)
+	{
+		return ZipExtractResult::CorruptData;
+	}
+
+	return ZipExtractResult::Success;
+}
+
+std::optional<uint64_t> ZipArchive::GetDataOffset(const ZipEntry &entry) const
+{
+	// The local header repeats most of the information in the central directory, which is
+	// preferred, since the local header can be incomplete (e.g. when the sizes are stored in a data
+	// descriptor that follows the data). Only the length of the variable fields is needed here.
+	uint64_t headerOffset = entry.localHeaderOffset + m_offsetBias;
+	std::byte header[LOCAL_HEADER_SIZE];
+
+	if (!m_source->Read(headerOffset, header)
+		|| ReadUInt32(header, 0) != LOCAL_HEADER_SIGNATURE)
+	{
+		return std::nullopt;
+	}
+
+	uint64_t dataOffset =
+		headerOffset + LOCAL_HEADER_SIZE + ReadUInt16(header, 26) + ReadUInt16(header, 28);
+	uint64_t archiveSize = m_source->GetSize();
+
+	if (dataOffset > archiveSize || entry.compressedSize > archiveSize - dataOffset)
+	{
+		return std::nullopt;
+	}
+
+	return dataOffset;
+}
+
+ZipExtractResult ZipArchive::CopyStoredData(const ZipEntry &entry, uint64_t dataOffset,
+	const ZipDataSink &sink, std::stop_token stopToken, uint32_t &crc) const
+{
+	if (entry.compressedSize != entry.uncompressedSize)
+	{
+		return ZipExtractResult::CorruptData;
+	}
+
+	std::vector<std::byte> buffer(
+		static_cast<size_t>(std::min<uint64_t>(entry.compressedSize, READ_CHUNK_SIZE)));
+	uint64_t remaining = entry.compressedSize;
+
+	while (remaining > 0)
+	{
+		if (stopToken.stop_requested())
+		{
+			return ZipExtractResult::Stopped;
+		}
+
+		auto chunk = std::span(buffer).first(
+			static_cast<size_t>(std::min<uint64_t>(remaining, buffer.size())));
+
+		if (!m_source->Read(dataOffset + (entry.compressedSize - remaining), chunk))
+		{
+			return ZipExtractResult::ReadError;
+		}
+
+		crc = CalculateCrc32(crc, chunk);
+
+		if (!sink(chunk))
+		{
+			return ZipExtractResult::WriteError;
+		}
+
+		remaining -= chunk.size();
+	}
+
+	return ZipExtractResult::Success;
+}
+
+ZipExtractResult ZipArchive::InflateData(const ZipEntry &entry, uint64_t dataOffset,
+	const ZipDataSink &sink, std::stop_token stopToken, uint32_t &crc) const
+{
+	InflateStream inflateStream;
+
+	if (!inflateStream.IsInitialized())
+	{
+		return ZipExtractResult::CorruptData;
+	}
+
+	z_stream *stream = inflateStream.Get();
+
+	std::vector<std::byte> input(
+		static_cast<size_t>(std::min<uint64_t>(entry.compressedSize, READ_CHUNK_SIZE)));
+	std::vector<std::byte> output(READ_CHUNK_SIZE);
+	uint64_t inputRemaining = entry.compressedSize;
+	uint64_t totalOutput = 0;
+	int status = Z_OK;
+
+	while (status != Z_STREAM_END)
+	{
+		if (stopToken.stop_requested())
+		{
+			return ZipExtractResult::Stopped;
+		}
+
+		if (stream->avail_in == 0)
+		{
+			if (inputRemaining == 0)
+			{
+				// The compressed data ended before the end of the deflate stream.
+				return ZipExtractResult::CorruptData;
+			}
+
+			auto chunk = std::span(input).first(
+				static_cast<size_t>(std::min<uint64_t>(inputRemaining, input.size())));
+
+			if (!m_source->Read(dataOffset + (entry.compressedSize - inputRemaining), chunk))
+			{
+				return ZipExtractResult::ReadError;
+			}
+
+			inputRemaining -= chunk.size();
+			stream->next_in = reinterpret_cast<Bytef *>(chunk.data());
+			stream->avail_in = static_cast<uInt>(chunk.size());
+		}
+
+		stream->next_out = reinterpret_cast<Bytef *>(output.data());
+		stream->avail_out = static_cast<uInt>(output.size());
+
+		status = inflate(stream, Z_NO_FLUSH);
+
+		if (status != Z_OK && status != Z_STREAM_END)
+		{
+			return ZipExtractResult::CorruptData;
+		}
+
+		auto produced = std::span(output).first(output.size() - stream->avail_out);
+		totalOutput += produced.size();
+
+		// This stops a corrupt (or malicious) entry from producing far more data than its header
+		// claims.
+		if (totalOutput > entry.uncompressedSize)
+		{
+			return ZipExtractResult::CorruptData;
+		}
+
+		if (!produced.empty())
+		{
+			crc = CalculateCrc32(crc, produced);
+
+			if (!sink(produced))
+			{
+				return ZipExtractResult::WriteError;
+			}
+		}
+	}
+
+	if (totalOutput != entry.uncompressedSize)
+	{
+		return ZipExtractResult::CorruptData;
+	}
+
+	return ZipExtractResult::Success;
+}
+
+std::chrono::sys_seconds GetZipEntryModifiedTime(const ZipEntry &entry)
+{
+	if (entry.utcModifiedTime)
+	{
+		return *entry.utcModifiedTime;
+	}
+
+	uint32_t date = entry.dosDateTime >> 16;
+	uint32_t time = entry.dosDateTime & 0xFFFF;
+
+	std::tm localTime = {};
+	localTime.tm_year = static_cast<int>(((date >> 9) & 0x7F) + 1980 - 1900);
+	localTime.tm_mon = static_cast<int>(((date >> 5) & 0x0F)) - 1;
+	localTime.tm_mday = static_cast<int>(date & 0x1F);
+	localTime.tm_hour = static_cast<int>(time >> 11);
+	localTime.tm_min = static_cast<int>((time >> 5) & 0x3F);
+	localTime.tm_sec = static_cast<int>((time & 0x1F) * 2);
+	localTime.tm_isdst = -1;
+
+	std::time_t unixTime = std::mktime(&localTime);
+
+	if (unixTime == -1)
+	{
+		return {};
+	}
+
+	return std::chrono::sys_seconds(std::chrono::seconds(unixTime));
+}
+
+ZipExtractionSummary ExtractZipEntries(const ZipArchive &archive,
+	const std::vector<ZipArchive::EntryId> &ids, const std::filesystem::path &destination,
+	int numThreads, std::stop_token stopToken, const ZipFileExtractedCallback &onFileExtracted)
+{
+	ZipExtractionSummary summary;
+	std::vector<std::pair<ZipArchive::EntryId, std::filesystem::path>> files;
+
+	// Folders are created up front (on this thread), so that the files can then be extracted in
+	// any order.
+	std::vector<std::pair<ZipArchive::EntryId, std::filesystem::path>> pendingFolders;
+
+	for (auto id : ids)
+	{
+		const ZipEntry &entry = archive.GetEntry(id);
+
+		if (entry.isFolder)
+		{
+			pendingFolders.emplace_back(id,
+				id == ZipArchive::ROOT_ID ? destination : destination / entry.name);
+		}
+		else
+		{
+			files.emplace_back(id, destination / entry.name);
+		}
+	}
+
+	while (!pendingFolders.empty())
+	{
+		auto [id, path] = std::move(pendingFolders.back());
+		pendingFolders.pop_back();
+
+		std::error_code error;
+		std::filesystem::create_directories(path, error);
+
+		if (error)
+		{
+			summary.failures.emplace_back(id, ZipExtractResult::WriteError);
+			continue;
+		}
+
+		for (auto childId : archive.GetChildren(id))
+		{
+			const ZipEntry &child = archive.GetEntry(childId);
+
+			if (child.isFolder)
+			{
+				pendingFolders.emplace_back(childId, path / child.name);
+			}
+			else
+			{
+				files.emplace_back(childId, path / child.name);
+			}
+		}
+	}
+
+	std::mutex summaryMutex;
+
+	ParallelFor(files.size(), numThreads, stopToken,
+		[&archive, &files, &stopToken, &onFileExtracted, &summary, &summaryMutex](size_t index)
+		{
+			const auto &[id, path] = files[index];
+			ZipExtractResult result;
+			uint64_t bytesWritten = 0;
+
+			{
+				std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+
+				if (!stream.is_open())
+				{
+					result = ZipExtractResult::WriteError;
+				}
+				else
+				{
+					result = archive.ExtractEntry(
+						id,
+						[&stream, &bytesWritten](std::span<const std::byte> data)
+						{
+							stream.write(reinterpret_cast<const char *>(data.data()),
+								static_cast<std::streamsize>(data.size()));
+							bytesWritten += data.size();
+							return stream.good();
+						},
+						stopToken);
+
+					stream.close();
+
+					if (result == ZipExtractResult::Success && stream.fail())
+					{
+						result = ZipExtractResult::WriteError;
+					}
+				}
+			}
+
+			if (result != ZipExtractResult::Success)
+			{
+				// Partially extracted files are removed, so that they can't be mistaken for
+				// complete copies.
+				std::error_code error;
+				std::filesystem::remove(path, error);
+			}
+			else if (onFileExtracted)
+			{
+				onFileExtracted(path, archive.GetEntry(id));
+			}
+
+			std::scoped_lock lock(summaryMutex);
+
+			if (result == ZipExtractResult::Success)
+			{
+				summary.numFilesExtracted++;
+				summary.numBytesExtracted += bytesWritten;
+			}
+			else if (result != ZipExtractResult::Stopped)
+			{
+				summary.failures.emplace_back(id, result);
+			}
+		});
+
+	summary.stopped = stopToken.stop_requested();
+
+	return summary;
+}
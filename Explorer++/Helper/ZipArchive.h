@@ -0,0 +1,217 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#pragma once
+
+#include <boost/core/noncopyable.hpp>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <stop_token>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// Provides random access to the bytes of an archive.
+class ZipSource
+{
+public:
+	virtual ~ZipSource() = default;
+
+	virtual uint64_t GetSize() const = 0;
+
+	// Reads exactly buffer.size() bytes, returning false if that's not possible. This can be called
+	// from multiple threads at once.
+	virtual bool Read(uint64_t offset, std::span<std::byte> buffer) const = 0;
+};
+
+class ZipMemorySource : public ZipSource
+{
+public:
+	explicit ZipMemorySource(std::vector<std::byte> data);
+
+	uint64_t GetSize() const override;
+	bool Read(uint64_t offset, std::span<std::byte> buffer) const override;
+
+private:
+	const std::vector<std::byte> m_data;
+};
+
+// Reads from a file on disk. Each concurrent read uses its own stream, so that entries can be
+// extracted in parallel without the reads being serialized.
+class ZipFileSource : public ZipSource, private boost::noncopyable
+{
+public:
+	// Returns null if the file can't be opened.
+	static std::unique_ptr<ZipFileSource> Open(const std::filesystem::path &path);
+
+	uint64_t GetSize() const override;
+	bool Read(uint64_t offset, std::span<std::byte> buffer) const override;
+
+private:
+	ZipFileSource(const std::filesystem::path &path, std::unique_ptr<std::ifstream> stream,
+		uint64_t size);
+
+	std::unique_ptr<std::ifstream> AcquireStream() const;
+	void ReleaseStream(std::unique_ptr<std::ifstream> stream) const;
+
+	const std::filesystem::path m_path;
+	const uint64_t m_size;
+
+	mutable std::mutex m_mutex;
+	mutable std::vector<std::unique_ptr<std::ifstream>> m_freeStreams;
+};
+
+struct ZipEntry
+{
+	// The last component of the entry's path.
+	std::wstring name;
+
+	uint32_t parent = 0;
+	bool isFolder = false;
+
+	// Entries that are only implied by the paths of other entries (e.g. "a/" when the archive only
+	// contains "a/b.txt") have no data of their own.
+	bool isImplied = false;
+
+	bool isEncrypted = false;
+	uint16_t compressionMethod = 0;
+	uint32_t crc32 = 0;
+	uint64_t compressedSize = 0;
+	uint64_t uncompressedSize = 0;
+	uint64_t localHeaderOffset = 0;
+
+	// The modification time, as stored in the entry's header. This is in local time, with a
+	// resolution of 2 seconds.
+	uint32_t dosDateTime = 0;
+
+	// The modification time, in UTC, taken from the NTFS or extended timestamp extra fields, if the
+	// entry has either of them.
+	std::optional<std::chrono::sys_seconds> utcModifiedTime;
+};
+
+enum class ZipExtractResult
+{
+	Success,
+	Folder,
+	UnsupportedMethod,
+	Encrypted,
+	CorruptData,
+	ReadError,
+	WriteError,
+	Stopped
+};
+
+// Called with each chunk of decompressed data. Returns false to abort the extraction.
+using ZipDataSink = std::function<bool(std::span<const std::byte> data)>;
+
+// A read-only view of a ZIP archive (including ZIP64 archives).
+//
+// The central directory is read once, when the archive is opened, and turned into a tree, so that
+// the contents of any folder can be retrieved immediately, without having to scan every entry.
+// Entry data is only read when an entry is extracted. Only the stored and deflate compression
+// methods are supported, which covers almost all archives in practice.
+//
+// Entry paths that try to escape the archive (e.g. "../a.txt", or absolute paths) are skipped.
+//
+// All const methods are safe to call concurrently.
+class ZipArchive : private boost::noncopyable
+{
+public:
+	using EntryId = uint32_t;
+
+	// The root folder of the archive, which has no name and is its own parent.
+	static constexpr EntryId ROOT_ID = 0;
+
+	// Returns null if the source doesn't contain a valid archive.
+	static std::unique_ptr<ZipArchive> Open(std::unique_ptr<ZipSource> source);
+
+	const ZipEntry &GetEntry(EntryId id) const;
+	std::span<const EntryId> GetChildren(EntryId folder) const;
+
+	// Paths can use either '/' or '\' as a separator. The empty path refers to the root.
+	std::optional<EntryId> FindEntry(std::wstring_view path) const;
+
+	// Returns the path of the entry within the archive, using '/' as the separator.
+	std::wstring GetEntryPath(EntryId id) const;
+
+	// Includes the root and any implied folders, as well as any entries that were hidden because
+	// they had the same path as another entry.
+	size_t GetNumEntries() const;
+
+	// Decompresses the entry, passing the data to the sink, and verifies the checksum once all the
+	// data has been decompressed.
+	ZipExtractResult ExtractEntry(EntryId id, const ZipDataSink &sink,
+		std::stop_token stopToken = {}) const;
+
+private:
+	static constexpr size_t READ_CHUNK_SIZE = 256 * 1024;
+
+	explicit ZipArchive(std::unique_ptr<ZipSource> source);
+
+	bool ReadCentralDirectory();
+	bool ParseCentralDirectory(std::span<const std::byte> data, uint64_t numEntries);
+	void AddEntry(std::wstring path, ZipEntry entry);
+	EntryId FindOrAddFolder(std::span<const std::wstring_view> components);
+	void BuildChildLists();
+	std::optional<EntryId> FindChild(EntryId parent, std::wstring_view name) const;
+	std::optional<uint64_t> GetDataOffset(const ZipEntry &entry) const;
+	ZipExtractResult CopyStoredData(const ZipEntry &entry, uint64_t dataOffset,
+		const ZipDataSink &sink, std::stop_token stopToken, uint32_t &crc) const;
+	ZipExtractResult InflateData(const ZipEntry &entry, uint64_t dataOffset,
+		const ZipDataSink &sink, std::stop_token stopToken, uint32_t &crc) const;
+
+	const std::unique_ptr<ZipSource> m_source;
+
+	// The number of bytes that precede the archive within the source (e.g. the executable part of
+	// a self-extracting archive). The offsets stored in the archive don't include this.
+	uint64_t m_offsetBias = 0;
+
+	std::vector<ZipEntry> m_entries;
+
+	// The children of each folder are stored contiguously, sorted by name, with m_childOffsets[i]
+	// giving the index in m_children of the first child of entry i.
+	std::vector<EntryId> m_children;
+	std::vector<uint32_t> m_childOffsets;
+
+	// Only used while the archive is being opened, to find folders that have already been added.
+	std::unordered_map<std::wstring, EntryId> m_folderIds;
+	std::optional<EntryId> m_lastParent;
+	std::wstring m_lastParentPath;
+};
+
+// Returns the entry's modification time in UTC. If the entry only has a DOS timestamp, that's
+// converted from local time.
+std::chrono::sys_seconds GetZipEntryModifiedTime(const ZipEntry &entry);
+
+struct ZipExtractionSummary
+{
+	size_t numFilesExtracted = 0;
+	uint64_t numBytesExtracted = 0;
+
+	// The entries that couldn't be extracted, along with the reason.
+	std::vector<std::pair<ZipArchive::EntryId, ZipExtractResult>> failures;
+
+	bool stopped = false;
+};
+
+// Called on the extracting thread once a file has been written and closed.
+using ZipFileExtractedCallback =
+	std::function<void(const std::filesystem::path &path, const ZipEntry &entry)>;
+
+// Extracts the entries (including the contents of any folders) into the destination folder, with
+// each entry placed relative to its parent. That is, extracting "a/b" creates "b" within the
+// destination. Files are extracted using several threads at once, each with its own stream.
+ZipExtractionSummary ExtractZipEntries(const ZipArchive &archive,
+	const std::vector<ZipArchive::EntryId> &ids, const std::filesystem::path &destination,
+	int numThreads, std::stop_token stopToken,
+	const ZipFileExtractedCallback &onFileExtracted = {});
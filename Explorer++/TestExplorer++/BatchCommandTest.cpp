@@ -0,0 +1,353 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "pch.h"
+#include "BatchCommand.h"
+#include "TemporaryPathTestHelper.h"
+#include <gtest/gtest.h>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+using namespace testing;
+
+namespace
+{
+
+// 2024-05-01T13:45:30Z
+const std::chrono::sys_seconds TEST_TIME{ std::chrono::seconds(1714571130) };
+
+std::filesystem::file_time_type ToFileTime(std::chrono::sys_seconds time)
+{
+#if __cpp_lib_chrono >= 201907L
+	return std::chrono::clock_cast<std::filesystem::file_time_type::clock>(time);
+#else
+	return std::filesystem::file_time_type::clock::from_sys(time);
+#endif
+}
+
+std::string ToUtf8(const std::filesystem::path &path)
+{
+	std::string output;
+	ListingWriter::AppendUtf8(output, path.wstring());
+	return output;
+}
+
+struct BatchCommandResult
+{
+	ExitCode exitCode;
+	std::string output;
+	std::string error;
+};
+
+BatchCommandResult RunCommand(const BatchCommand &command)
+{
+	std::ostringstream output;
+	std::ostringstream error;
+	auto exitCode = RunBatchCommand(command, output, error);
+	return { exitCode, output.str(), error.str() };
+}
+
+}
+
+class BatchCommandTest : public Test
+{
+protected:
+	BatchCommandTest() : m_tempFolder("BatchCommandTest"), m_root(m_tempFolder.GetPath())
+	{
+		CreateTestFile(m_root / "a.txt", "hello");
+		CreateTestFile(m_root / "b.log", "12345678");
+		CreateTestFile(m_root / "sub" / "c.txt", "abc");
+		CreateTestFile(m_root / "sub" / "deeper" / "d.TXT", "");
+
+		for (const auto &folder : { m_root / "sub" / "deeper", m_root / "sub" })
+		{
+			std::filesystem::last_write_time(folder, ToFileTime(TEST_TIME));
+		}
+	}
+
+	static void CreateTestFile(const std::filesystem::path &path, const std::string &contents)
+	{
+		std::filesystem::create_directories(path.parent_path());
+		std::ofstream(path, std::ios::binary).write(contents.data(), contents.size());
+		std::filesystem::last_write_time(path, ToFileTime(TEST_TIME));
+	}
+
+	std::string GetPath(const std::filesystem::path &relativePath) const
+	{
+		return ToUtf8((m_root / relativePath).make_preferred());
+	}
+
+	const TemporaryTestFolder m_tempFolder;
+	const std::filesystem::path m_root;
+};
+
+TEST(FormatBatchTimestampTest, Format)
+{
+	EXPECT_EQ(FormatBatchTimestamp(ToFileTime(TEST_TIME).time_since_epoch().count()),
+		L"2024-05-01T13:45:30Z");
+}
+
+TEST_F(BatchCommandTest, List)
+{
+	BatchCommand command;
+	command.type = BatchCommandType::List;
+	command.paths = { m_root.wstring() };
+
+	auto result = RunCommand(command);
+	EXPECT_EQ(result.exitCode, EXIT_CODE_NORMAL);
+	EXPECT_EQ(result.error, "");
+	EXPECT_EQ(result.output,
+		"File  5  2024-05-01T13:45:30Z  " + GetPath("a.txt") + "\n"
+		"File  8  2024-05-01T13:45:30Z  " + GetPath("b.log") + "\n"
+		"Folder    2024-05-01T13:45:30Z  " + GetPath("sub") + "\n");
+}
+
+TEST_F(BatchCommandTest, ListRecursiveSorted)
+{
+	BatchCommand command;
+	command.type = BatchCommandType::List;
+	command.paths = { m_root.wstring() };
+	command.recursive = true;
+	command.itemTypes = FileNameItemTypes::Files;
+	command.sortField = BatchSortField::Size;
+	command.sortDescending = true;
+	command.format = ListingFormat::Csv;
+
+	auto result = RunCommand(command);
+	EXPECT_EQ(result.exitCode, EXIT_CODE_NORMAL);
+	EXPECT_EQ(result.output,
+		"\xEF\xBB\xBFType,Size,Modified,Path\r\n"
+		"File,8,2024-05-01T13:45:30Z,"
+			+ GetPath("b.log") + "\r\n" + "File,5,2024-05-01T13:45:30Z," + GetPath("a.txt")
+			+ "\r\n" + "File,3,2024-05-01T13:45:30Z," + GetPath("sub/c.txt") + "\r\n"
+			+ "File,0,2024-05-01T13:45:30Z," + GetPath("sub/deeper/d.TXT") + "\r\n");
+}
+
+TEST_F(BatchCommandTest, Search)
+{
+	BatchCommand command;
+	command.type = BatchCommandType::Search;
+	command.paths = { m_root.wstring() };
+	command.pattern = L"*.txt";
+	command.sortField = BatchSortField::Path;
+	command.format = ListingFormat::JsonLines;
+
+	auto result = RunCommand(command);
+	EXPECT_EQ(result.exitCode, EXIT_CODE_NORMAL);
+
+	auto expectedLine = [this](const std::string &size, const std::string &relativePath)
+	{
+		std::string escapedPath;
+
+		for (char c : GetPath(relativePath))
+		{
+			if (c == '\\')
+			{
+				escapedPath += '\\';
+			}
+
+			escapedPath += c;
+		}
+
+		return "{\"Type\":\"File\",\"Size\":\"" + size
+			+ "\",\"Modified\":\"2024-05-01T13:45:30Z\",\"Path\":\"" + escapedPath + "\"}\n";
+	};
+
+	// Matching is case-insensitive by default.
+	EXPECT_EQ(result.output,
+		expectedLine("5", "a.txt") + expectedLine("3", "sub/c.txt")
+			+ expectedLine("0", "sub/deeper/d.TXT"));
+
+	command.caseSensitive = true;
+	command.format = ListingFormat::Text;
+	result = RunCommand(command);
+	EXPECT_EQ(result.output,
+		"File  5  2024-05-01T13:45:30Z  " + GetPath("a.txt") + "\n"
+			+ "File  3  2024-05-01T13:45:30Z  " + GetPath("sub/c.txt") + "\n");
+
+	command.pattern = L"^[ab]\\..*";
+	command.matchType = FileNameMatchType::Regex;
+	command.sortField = BatchSortField::Name;
+	result = RunCommand(command);
+	EXPECT_EQ(result.output,
+		"File  5  2024-05-01T13:45:30Z  " + GetPath("a.txt") + "\n"
+			+ "File  8  2024-05-01T13:45:30Z  " + GetPath("b.log") + "\n");
+}
+
+TEST_F(BatchCommandTest, Size)
+{
+	BatchCommand command;
+	command.type = BatchCommandType::Size;
+	command.paths = { m_root.wstring(), (m_root / "a.txt").wstring() };
+	command.numThreads = 2;
+
+	auto result = RunCommand(command);
+	EXPECT_EQ(result.exitCode, EXIT_CODE_NORMAL);
+	EXPECT_EQ(result.output,
+		"16  4  2  " + ToUtf8(m_root) + "\n" + "5  1  0  " + GetPath("a.txt") + "\n");
+}
+
+TEST_F(BatchCommandTest, Hash)
+{
+	BatchCommand command;
+	command.type = BatchCommandType::Hash;
+	command.paths = { (m_root / "sub").wstring() };
+	command.recursive = true;
+
+	auto result = RunCommand(command);
+	EXPECT_EQ(result.exitCode, EXIT_CODE_NORMAL);
+	EXPECT_EQ(result.output,
+		"ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad  "
+			+ GetPath("sub/c.txt") + "\n"
+			+ "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855  "
+			+ GetPath("sub/deeper/d.TXT") + "\n");
+
+	// Without the recursive flag, only the files directly within a folder are hashed.
+	command.recursive = false;
+	command.hashAlgorithm = HashAlgorithm::Crc32;
+	command.paths.push_back((m_root / "a.txt").wstring());
+	result = RunCommand(command);
+	EXPECT_EQ(result.output,
+		"352441c2  " + GetPath("sub/c.txt") + "\n" + "3610a686  " + GetPath("a.txt") + "\n");
+}
+
+TEST_F(BatchCommandTest, Export)
+{
+	BatchCommand command;
+	command.type = BatchCommandType::Export;
+	command.paths = { m_root.wstring() };
+	command.recursive = true;
+
+	auto result = RunCommand(command);
+	EXPECT_EQ(result.exitCode, EXIT_CODE_NORMAL);
+
+	// Folders are listed first and each folder's contents follow the folder itself.
+	EXPECT_EQ(result.output,
+		"\xEF\xBB\xBF"
+		"Folder,Name,Type,Size,Modified\r\n"
+		",sub,Folder,,2024-05-01T13:45:30Z\r\n"
+		",a.txt,File,5,2024-05-01T13:45:30Z\r\n"
+		",b.log,File,8,2024-05-01T13:45:30Z\r\n"
+		"sub,deeper,Folder,,2024-05-01T13:45:30Z\r\n"
+		"sub,c.txt,File,3,2024-05-01T13:45:30Z\r\n"
+		"sub\\deeper,d.TXT,File,0,2024-05-01T13:45:30Z\r\n");
+}
+
+TEST_F(BatchCommandTest, Compare)
+{
+	auto right = m_root / "right";
+	std::filesystem::copy(m_root / "sub", right, std::filesystem::copy_options::recursive);
+	std::filesystem::last_write_time(right / "c.txt", ToFileTime(TEST_TIME));
+	std::filesystem::last_write_time(right / "deeper" / "d.TXT", ToFileTime(TEST_TIME));
+
+	BatchCommand command;
+	command.type = BatchCommandType::Compare;
+	command.paths = { (m_root / "sub").wstring(), right.wstring() };
+
+	auto result = RunCommand(command);
+	EXPECT_EQ(result.exitCode, EXIT_CODE_NORMAL);
+	EXPECT_EQ(result.output,
+		"identical  3  3  c.txt\n"
+		"identical      deeper\n"
+		"identical  0  0  "
+			+ ToUtf8(std::filesystem::path("deeper") / "d.TXT") + "\n");
+
+	CreateTestFile(right / "c.txt", "abd");
+	CreateTestFile(right / "e.txt", "new");
+
+	command.differencesOnly = true;
+	command.compareContents = HashAlgorithm::XxHash64;
+	command.format = ListingFormat::Csv;
+	result = RunCommand(command);
+	EXPECT_EQ(result.exitCode, EXIT_CODE_DIFFERENCES_FOUND);
+	EXPECT_EQ(result.output,
+		"\xEF\xBB\xBF"
+		"Status,Left Size,Right Size,Path\r\n"
+		"content-differs,3,3,c.txt\r\n"
+		"right-only,,3,e.txt\r\n");
+}
+
+TEST_F(BatchCommandTest, Errors)
+{
+	BatchCommand command;
+	command.type = BatchCommandType::List;
+	command.paths = { (m_root / "missing").wstring(), m_root.wstring() };
+	command.itemTypes = FileNameItemTypes::Folders;
+
+	// The other folders are still listed.
+	auto result = RunCommand(command);
+	EXPECT_EQ(result.exitCode, EXIT_CODE_ERROR);
+	EXPECT_EQ(result.error, "Not a folder: " + GetPath("missing") + "\n");
+	EXPECT_EQ(result.output, "Folder    2024-05-01T13:45:30Z  " + GetPath("sub") + "\n");
+
+	command.type = BatchCommandType::Search;
+	command.paths = { m_root.wstring() };
+	command.pattern = L"[";
+	command.matchType = FileNameMatchType::Regex;
+	result = RunCommand(command);
+	EXPECT_EQ(result.exitCode, EXIT_CODE_ERROR);
+	EXPECT_EQ(result.output, "");
+	EXPECT_EQ(result.error, "Invalid regular expression: [\n");
+
+	command.type = BatchCommandType::Compare;
+	command.paths = { m_root.wstring(), (m_root / "missing").wstring() };
+	result = RunCommand(command);
+	EXPECT_EQ(result.exitCode, EXIT_CODE_ERROR);
+	EXPECT_EQ(result.error, "Not a folder: " + GetPath("missing") + "\n");
+}
+
+// Runs the commands over a generated tree, using a single thread and then a thread per processor,
+// so that the results can be compared between runs and between changes to the underlying code.
+TEST(BatchCommandBenchmarkTest, DISABLED_GeneratedTree)
+{
+	constexpr int NUM_FOLDERS = 50;
+	constexpr int FILES_PER_FOLDER = 100;
+
+	TemporaryTestFolder tempFolder("BatchCommandBenchmarkTest");
+	const auto &root = tempFolder.GetPath();
+
+	for (int i = 0; i < NUM_FOLDERS; i++)
+	{
+		auto folder = root / ("folder" + std::to_string(i));
+		std::filesystem::create_directories(folder);
+
+		for (int j = 0; j < FILES_PER_FOLDER; j++)
+		{
+			std::string contents(static_cast<size_t>(j * 100), static_cast<char>('a' + j % 26));
+			std::ofstream(folder / ("file" + std::to_string(j) + ".dat"), std::ios::binary)
+				.write(contents.data(), contents.size());
+		}
+	}
+
+	int numProcessorThreads = static_cast<int>(std::max(std::thread::hardware_concurrency(), 1u));
+
+	auto measure = [&root](BatchCommandType type, int numThreads)
+	{
+		BatchCommand command;
+		command.type = type;
+		command.paths = { root.wstring() };
+		command.recursive = true;
+		command.numThreads = numThreads;
+
+		auto start = std::chrono::steady_clock::now();
+		auto result = RunCommand(command);
+		auto end = std::chrono::steady_clock::now();
+
+		EXPECT_EQ(result.exitCode, EXIT_CODE_NORMAL);
+
+		return std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+	};
+
+	for (auto [type, name] : { std::pair(BatchCommandType::List, "List"),
+			 std::pair(BatchCommandType::Size, "Size"),
+			 std::pair(BatchCommandType::Hash, "Hash") })
+	{
+		RecordProperty(std::string(name) + "SingleThreadMs", std::to_string(measure(type, 1)));
+		RecordProperty(std::string(name) + "MultiThreadMs",
+			std::to_string(measure(type, numProcessorThreads)));
+	}
+}
@@ -0,0 +1,247 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "pch.h"
+#include "Bookmarks/BookmarkSearchIndex.h"
+#include "Bookmarks/BookmarkItem.h"
+#include "Bookmarks/BookmarkTree.h"
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <chrono>
+#include <format>
+
+using namespace testing;
+
+class BookmarkSearchIndexTest : public Test
+{
+protected:
+	BookmarkItem *AddBookmark(const std::wstring &name, const std::wstring &location)
+	{
+		auto bookmark = std::make_unique<BookmarkItem>(std::nullopt, name, location);
+		auto *rawBookmark = bookmark.get();
+		m_index.AddItem(rawBookmark);
+		m_items.push_back(std::move(bookmark));
+		return rawBookmark;
+	}
+
+	BookmarkItem *AddFolder(const std::wstring &name)
+	{
+		auto folder = std::make_unique<BookmarkItem>(std::nullopt, name, std::nullopt);
+		auto *rawFolder = folder.get();
+		m_index.AddItem(rawFolder);
+		m_items.push_back(std::move(folder));
+		return rawFolder;
+	}
+
+	BookmarkSearchIndex m_index;
+	std::vector<std::unique_ptr<BookmarkItem>> m_items;
+};
+
+TEST(BookmarkSearchIndexTokenizeTest, Tokenize)
+{
+	EXPECT_THAT(BookmarkSearchIndex::Tokenize(L"https://www.Example.com/Docs?q=1"),
+		ElementsAre(L"https", L"www", L"example", L"com", L"docs", L"q", L"1"));
+	EXPECT_THAT(BookmarkSearchIndex::Tokenize(L"C:\\Users\\Public"),
+		ElementsAre(L"c", L"users", L"public"));
+	EXPECT_THAT(BookmarkSearchIndex::Tokenize(L"  --  "), IsEmpty());
+	EXPECT_THAT(BookmarkSearchIndex::Tokenize(L""), IsEmpty());
+}
+
+TEST_F(BookmarkSearchIndexTest, PrefixMatch)
+{
+	auto *bookmark1 = AddBookmark(L"Project notes", L"C:\\notes");
+	AddBookmark(L"Photos", L"D:\\photos");
+	auto *folder = AddFolder(L"Programs");
+
+	EXPECT_THAT(m_index.Search(L"pro", 10), ElementsAre(bookmark1, folder));
+
+	// Matching should be case-insensitive.
+	EXPECT_THAT(m_index.Search(L"PROJ", 10), ElementsAre(bookmark1));
+
+	// Prefixes can match any token, not just the first.
+	EXPECT_THAT(m_index.Search(L"not", 10), ElementsAre(bookmark1));
+}
+
+TEST_F(BookmarkSearchIndexTest, SubstringMatch)
+{
+	auto *bookmark = AddBookmark(L"Documentation", L"https://example.com");
+
+	EXPECT_THAT(m_index.Search(L"ment", 10), ElementsAre(bookmark));
+	EXPECT_THAT(m_index.Search(L"ample", 10), ElementsAre(bookmark));
+
+	// Terms that are shorter than MIN_SUBSTRING_TERM_LENGTH only match by prefix, since they would
+	// otherwise match a large proportion of items.
+	EXPECT_THAT(m_index.Search(L"um", 10), IsEmpty());
+	EXPECT_THAT(m_index.Search(L"do", 10), ElementsAre(bookmark));
+}
+
+TEST_F(BookmarkSearchIndexTest, MultipleTerms)
+{
+	auto *bookmark1 = AddBookmark(L"Rust book", L"https://doc.rust-lang.org/book");
+	AddBookmark(L"Rust reference", L"https://doc.rust-lang.org/reference");
+	AddBookmark(L"Python book", L"https://example.com/python");
+
+	// Every term needs to match.
+	EXPECT_THAT(m_index.Search(L"rust book", 10), ElementsAre(bookmark1));
+	EXPECT_THAT(m_index.Search(L"book rust", 10), ElementsAre(bookmark1));
+	EXPECT_THAT(m_index.Search(L"rust missing", 10), IsEmpty());
+}
+
+TEST_F(BookmarkSearchIndexTest, Ranking)
+{
+	auto *locationSubstringMatch = AddBookmark(L"First", L"C:\\oldmedia");
+	auto *locationPrefixMatch = AddBookmark(L"Second", L"C:\\media");
+	auto *nameSubstringMatch = AddBookmark(L"Multimedia", L"C:\\");
+	auto *namePrefixMatch = AddBookmark(L"Media player", L"C:\\");
+
+	EXPECT_THAT(m_index.Search(L"media", 10),
+		ElementsAre(namePrefixMatch, nameSubstringMatch, locationPrefixMatch,
+			locationSubstringMatch));
+
+	// Only the best matches should be returned when the number of results is limited.
+	EXPECT_THAT(m_index.Search(L"media", 2), ElementsAre(namePrefixMatch, nameSubstringMatch));
+}
+
+TEST_F(BookmarkSearchIndexTest, FolderLocationIgnored)
+{
+	AddFolder(L"Folder");
+
+	// Folders don't have a location, so only the name is indexed.
+	EXPECT_THAT(m_index.Search(L"folder", 10), SizeIs(1));
+	EXPECT_EQ(m_index.GetNumItems(), 1u);
+}
+
+TEST_F(BookmarkSearchIndexTest, UpdateItem)
+{
+	auto *bookmark = AddBookmark(L"Original", L"C:\\original");
+
+	bookmark->SetName(L"Updated");
+	bookmark->SetLocation(L"C:\\updated");
+	m_index.UpdateItem(bookmark);
+
+	EXPECT_THAT(m_index.Search(L"original", 10), IsEmpty());
+	EXPECT_THAT(m_index.Search(L"updated", 10), ElementsAre(bookmark));
+	EXPECT_EQ(m_index.GetNumItems(), 1u);
+}
+
+TEST_F(BookmarkSearchIndexTest, RemoveItem)
+{
+	auto *bookmark1 = AddBookmark(L"Bookmark", L"C:\\");
+	auto *bookmark2 = AddBookmark(L"Bookmark", L"D:\\");
+
+	m_index.RemoveItem(bookmark1);
+	EXPECT_THAT(m_index.Search(L"bookmark", 10), ElementsAre(bookmark2));
+	EXPECT_EQ(m_index.GetNumItems(), 1u);
+
+	// Removing an item that isn't in the index should have no effect.
+	m_index.RemoveItem(bookmark1);
+	EXPECT_EQ(m_index.GetNumItems(), 1u);
+}
+
+TEST_F(BookmarkSearchIndexTest, Compaction)
+{
+	constexpr int NUM_ITEMS = 5000;
+
+	std::vector<BookmarkItem *> bookmarks;
+
+	for (int i = 0; i < NUM_ITEMS; i++)
+	{
+		bookmarks.push_back(AddBookmark(std::format(L"Item {}", i), L"C:\\"));
+	}
+
+	// Removing most of the items will cause the index to be compacted (potentially more than
+	// once). The remaining items should still be found.
+	for (int i = 0; i < NUM_ITEMS; i++)
+	{
+		if (i % 10 != 0)
+		{
+			m_index.RemoveItem(bookmarks[i]);
+		}
+	}
+
+	EXPECT_EQ(m_index.GetNumItems(), static_cast<size_t>(NUM_ITEMS / 10));
+	EXPECT_THAT(m_index.Search(L"item", NUM_ITEMS), SizeIs(NUM_ITEMS / 10));
+	EXPECT_THAT(m_index.Search(L"4990", 10), ElementsAre(bookmarks[4990]));
+	EXPECT_THAT(m_index.Search(L"4991", 10), IsEmpty());
+}
+
+// Builds a synthetic tree containing 100,000 bookmarks and measures the time taken to look up
+// items by ID and to run a variety of searches. The times are recorded as test properties.
+TEST(BookmarkSearchIndexBenchmarkTest, DISABLED_LargeTree)
+{
+	constexpr int NUM_FOLDERS = 1000;
+	constexpr int BOOKMARKS_PER_FOLDER = 100;
+	constexpr int NUM_GUID_LOOKUPS = 100'000;
+
+	const std::vector<std::wstring> sites = { L"example", L"github", L"wikipedia", L"microsoft",
+		L"stackoverflow", L"mozilla", L"python", L"rust-lang" };
+	const std::vector<std::wstring> topics = { L"Documentation", L"Reference", L"Tutorial",
+		L"Release notes", L"Issue tracker", L"Forum", L"Blog", L"Downloads" };
+
+	BookmarkTree bookmarkTree;
+	std::vector<std::wstring> guids;
+
+	for (int i = 0; i < NUM_FOLDERS; i++)
+	{
+		auto folder = std::make_unique<BookmarkItem>(std::nullopt, std::format(L"Folder {}", i),
+			std::nullopt);
+
+		for (int j = 0; j < BOOKMARKS_PER_FOLDER; j++)
+		{
+			int index = (i * BOOKMARKS_PER_FOLDER) + j;
+			const auto &site = sites[index % sites.size()];
+			const auto &topic = topics[(index / sites.size()) % topics.size()];
+
+			auto bookmark = std::make_unique<BookmarkItem>(std::nullopt,
+				std::format(L"{} {} {}", site, topic, index),
+				std::format(L"https://www.{}.com/{}/page{}", site, i, index));
+			guids.push_back(bookmark->GetGUID());
+			folder->AddChild(std::move(bookmark));
+		}
+
+		bookmarkTree.AddBookmarkItem(bookmarkTree.GetOtherBookmarksFolder(), std::move(folder), i);
+	}
+
+	auto start = std::chrono::steady_clock::now();
+
+	for (int i = 0; i < NUM_GUID_LOOKUPS; i++)
+	{
+		ASSERT_NE(bookmarkTree.GetBookmarkItemById(guids[(i * 7919) % guids.size()]), nullptr);
+	}
+
+	auto end = std::chrono::steady_clock::now();
+	testing::Test::RecordProperty("GuidLookupsMs",
+		static_cast<int>(
+			std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count()));
+
+	struct SearchCase
+	{
+		std::string name;
+		std::wstring query;
+	};
+
+	const std::vector<SearchCase> searchCases = { { "ShortPrefix", L"g" }, { "Prefix", L"wiki" },
+		{ "Substring", L"overflow" }, { "MultipleTerms", L"python tutorial" },
+		{ "Number", L"99999" }, { "NoMatch", L"zzzz" } };
+
+	for (const auto &searchCase : searchCases)
+	{
+		start = std::chrono::steady_clock::now();
+		auto results = bookmarkTree.SearchBookmarks(searchCase.query, 500);
+		end = std::chrono::steady_clock::now();
+
+		testing::Test::RecordProperty(searchCase.name + "Us",
+			static_cast<int>(
+				std::chrono::duration_cast<std::chrono::microseconds>(end - start).count()));
+
+		if (searchCase.name == "NoMatch")
+		{
+			EXPECT_THAT(results, IsEmpty());
+		}
+		else
+		{
+			EXPECT_THAT(results, Not(IsEmpty())) << searchCase.name;
+		}
+	}
+}
@@ -139,6 +139,66 @@ TEST(BookmarkTreeTest, RemoveChildren)
 	EXPECT_EQ(bookmarkTree.GetOtherBookmarksFolder()->GetChildren().size(), 0U);
 }
 
+TEST(BookmarkTreeTest, GetBookmarkItemById)
+{
+	BookmarkTree bookmarkTree;
+
+	EXPECT_EQ(bookmarkTree.GetBookmarkItemById(bookmarkTree.GetRoot()->GetGUID()),
+		bookmarkTree.GetRoot());
+	EXPECT_EQ(bookmarkTree.GetBookmarkItemById(bookmarkTree.GetOtherBookmarksFolder()->GetGUID()),
+		bookmarkTree.GetOtherBookmarksFolder());
+
+	auto folder = std::make_unique<BookmarkItem>(std::nullopt, L"Test folder", std::nullopt);
+	auto rawFolder = folder.get();
+
+	auto bookmark = std::make_unique<BookmarkItem>(std::nullopt, L"Test bookmark", L"C:\\");
+	auto rawBookmark = bookmark.get();
+	folder->AddChild(std::move(bookmark));
+
+	// Items nested within an added folder should be indexed as well.
+	bookmarkTree.AddBookmarkItem(bookmarkTree.GetBookmarksMenuFolder(), std::move(folder), 0);
+	EXPECT_EQ(bookmarkTree.GetBookmarkItemById(rawFolder->GetGUID()), rawFolder);
+	EXPECT_EQ(bookmarkTree.GetBookmarkItemById(rawBookmark->GetGUID()), rawBookmark);
+
+	// Moving an item shouldn't affect the lookup.
+	bookmarkTree.MoveBookmarkItem(rawBookmark, bookmarkTree.GetBookmarksToolbarFolder(), 0);
+	EXPECT_EQ(bookmarkTree.GetBookmarkItemById(rawBookmark->GetGUID()), rawBookmark);
+
+	std::wstring folderGuid = rawFolder->GetGUID();
+	bookmarkTree.RemoveBookmarkItem(rawFolder);
+	EXPECT_EQ(bookmarkTree.GetBookmarkItemById(folderGuid), nullptr);
+	EXPECT_EQ(bookmarkTree.GetBookmarkItemById(L"not-a-guid"), nullptr);
+}
+
+TEST(BookmarkTreeTest, SearchBookmarks)
+{
+	BookmarkTree bookmarkTree;
+
+	auto folder = std::make_unique<BookmarkItem>(std::nullopt, L"Projects", std::nullopt);
+	auto rawFolder = folder.get();
+
+	auto bookmark = std::make_unique<BookmarkItem>(std::nullopt, L"Sources", L"C:\\Projects\\src");
+	auto rawBookmark = bookmark.get();
+	folder->AddChild(std::move(bookmark));
+
+	bookmarkTree.AddBookmarkItem(bookmarkTree.GetOtherBookmarksFolder(), std::move(folder), 0);
+
+	EXPECT_THAT(bookmarkTree.SearchBookmarks(L"proj", 10), ElementsAre(rawFolder, rawBookmark));
+
+	// The permanent folders shouldn't be returned.
+	auto otherBookmarksName = bookmarkTree.GetOtherBookmarksFolder()->GetName();
+	EXPECT_THAT(bookmarkTree.SearchBookmarks(otherBookmarksName, 10), IsEmpty());
+
+	// Renaming an item should update the index.
+	rawBookmark->SetName(L"Build output");
+	EXPECT_THAT(bookmarkTree.SearchBookmarks(L"output", 10), ElementsAre(rawBookmark));
+	EXPECT_THAT(bookmarkTree.SearchBookmarks(L"sources", 10), IsEmpty());
+
+	// Removing a folder should remove its children from the index as well.
+	bookmarkTree.RemoveBookmarkItem(rawFolder);
+	EXPECT_THAT(bookmarkTree.SearchBookmarks(L"proj", 10), IsEmpty());
+}
+
 TEST_F(BookmarkTreeObserverTest, Add)
 {
 	m_bookmarkTree.bookmarkItemAddedSignal.AddObserver(
@@ -0,0 +1,124 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "pch.h"
+#include "../Helper/ByteSearch.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <random>
+
+namespace
+{
+
+std::vector<std::byte> MakeRandomData(size_t size, int numDistinctValues, unsigned int seed)
+{
+	std::mt19937 generator(seed);
+	std::uniform_int_distribution<int> distribution('a', 'a' + numDistinctValues - 1);
+	std::vector<std::byte> data(size);
+	std::generate(data.begin(), data.end(),
+		[&generator, &distribution] { return static_cast<std::byte>(distribution(generator)); });
+	return data;
+}
+
+std::span<const std::byte> AsBytes(std::string_view text)
+{
+	return std::as_bytes(std::span(text.data(), text.size()));
+}
+
+std::optional<size_t> NaiveFind(std::span<const std::byte> data,
+	std::span<const std::byte> pattern)
+{
+	auto itr = std::search(data.begin(), data.end(), pattern.begin(), pattern.end());
+
+	if (itr == data.end() && !pattern.empty())
+	{
+		return std::nullopt;
+	}
+
+	return static_cast<size_t>(itr - data.begin());
+}
+
+}
+
+// The vectorized paths process 16 bytes at a time, so the results are compared against simple
+// implementations for a range of sizes and offsets, to cover partial blocks at either end.
+TEST(ByteSearchTest, CountAndFindByte)
+{
+	auto data = MakeRandomData(1000, 20, 1);
+
+	for (size_t start = 0; start < 20; start++)
+	{
+		for (size_t size : { 0, 1, 15, 16, 17, 100, 500, 980 })
+		{
+			auto slice = std::span<const std::byte>(data).subspan(start, size);
+
+			for (auto value : { std::byte{ 'a' }, std::byte{ 'k' }, std::byte{ 'z' } })
+			{
+				EXPECT_EQ(CountByte(slice, value),
+					static_cast<size_t>(std::count(slice.begin(), slice.end(), value)));
+
+				auto itr = std::find(slice.begin(), slice.end(), value);
+				auto expected = itr == slice.end()
+					? std::nullopt
+					: std::optional<size_t>(static_cast<size_t>(itr - slice.begin()));
+				EXPECT_EQ(FindByte(slice, value), expected);
+			}
+		}
+	}
+}
+
+TEST(ByteSearchTest, CountLargeBuffer)
+{
+	// Large enough that the per-lane counts have to be flushed several times.
+	std::vector<std::byte> data(100'000, std::byte{ '\n' });
+	EXPECT_EQ(CountByte(data, std::byte{ '\n' }), data.size());
+}
+
+TEST(ByteSearchTest, FindPattern)
+{
+	auto data = MakeRandomData(5000, 3, 2);
+
+	for (size_t patternSize : { 1, 2, 3, 5, 8, 16, 17, 40 })
+	{
+		for (size_t patternStart : { 0, 7, 1000, 4990 })
+		{
+			if (patternStart + patternSize > data.size())
+			{
+				continue;
+			}
+
+			auto pattern = std::span<const std::byte>(data).subspan(patternStart, patternSize);
+
+			for (size_t start : { 0, 3, 16, 31 })
+			{
+				auto haystack = std::span<const std::byte>(data).subspan(start);
+				EXPECT_EQ(FindPattern(haystack, pattern), NaiveFind(haystack, pattern));
+			}
+		}
+	}
+}
+
+TEST(ByteSearchTest, FindPatternEdgeCases)
+{
+	EXPECT_EQ(FindPattern(AsBytes("abc"), {}), 0u);
+	EXPECT_EQ(FindPattern(AsBytes("ab"), AsBytes("abc")), std::nullopt);
+	EXPECT_EQ(FindPattern(AsBytes("abc"), AsBytes("abc")), 0u);
+
+	// A match that ends on the very last byte.
+	std::string text(100, 'x');
+	text += "needle";
+	EXPECT_EQ(FindPattern(AsBytes(text), AsBytes("needle")), 100u);
+}
+
+TEST(ByteSearchTest, FindPatternCaseInsensitive)
+{
+	std::string text = std::string(37, '-') + "The Quick [Brown] Fox" + std::string(20, '-');
+
+	EXPECT_EQ(FindPattern(AsBytes(text), AsBytes("quick [brown]"), false), 41u);
+	EXPECT_EQ(FindPattern(AsBytes(text), AsBytes("quick [brown]"), true), std::nullopt);
+	EXPECT_EQ(FindPattern(AsBytes(text), AsBytes("FOX"), false), 55u);
+
+	// Only letters are folded, so '{' (which differs from '[' only in the case bit) doesn't match.
+	EXPECT_EQ(FindPattern(AsBytes(text), AsBytes("{brown}"), false), std::nullopt);
+}
@@ -60,6 +60,12 @@ TEST_F(CommandLineTest, Options)
 	commandLineSettings = ParseCommandLine(L"explorer++.exe --enable-logging");
 	EXPECT_TRUE(commandLineSettings.enableLogging);
 
+	commandLineSettings = ParseCommandLine(L"explorer++.exe");
+	EXPECT_FALSE(commandLineSettings.enableTracing);
+
+	commandLineSettings = ParseCommandLine(L"explorer++.exe --enable-tracing");
+	EXPECT_TRUE(commandLineSettings.enableTracing);
+
 	commandLineSettings = ParseCommandLine(L"explorer++.exe");
 	EXPECT_THAT(commandLineSettings.featuresToEnable, IsEmpty());
 
@@ -67,6 +73,57 @@ TEST_F(CommandLineTest, Options)
 	EXPECT_THAT(commandLineSettings.featuresToEnable, ElementsAre(Feature::Plugins));
 }
 
+TEST_F(CommandLineTest, BatchCommands)
+{
+	auto commandLineSettings = ParseCommandLine(L"explorer++.exe c:\\path");
+	EXPECT_FALSE(commandLineSettings.batchCommand.has_value());
+
+	commandLineSettings = ParseCommandLine(
+		L"explorer++.exe batch list c:\\path1 d:\\path2 -r --pattern *.txt --type files "
+		L"--sort size --descending --format json --threads 4");
+	ASSERT_TRUE(commandLineSettings.batchCommand.has_value());
+	EXPECT_EQ(commandLineSettings.batchCommand->type, BatchCommandType::List);
+	EXPECT_THAT(commandLineSettings.batchCommand->paths, ElementsAre(L"c:\\path1", L"d:\\path2"));
+	EXPECT_TRUE(commandLineSettings.batchCommand->recursive);
+	EXPECT_EQ(commandLineSettings.batchCommand->pattern, L"*.txt");
+	EXPECT_EQ(commandLineSettings.batchCommand->itemTypes, FileNameItemTypes::Files);
+	EXPECT_EQ(commandLineSettings.batchCommand->sortField, BatchSortField::Size);
+	EXPECT_TRUE(commandLineSettings.batchCommand->sortDescending);
+	EXPECT_EQ(commandLineSettings.batchCommand->format, ListingFormat::JsonLines);
+	EXPECT_EQ(commandLineSettings.batchCommand->numThreads, 4);
+	EXPECT_THAT(commandLineSettings.directories, IsEmpty());
+
+	commandLineSettings = ParseCommandLine(
+		L"explorer++.exe batch search c:\\path \"report ?.doc\" --match wildcard");
+	ASSERT_TRUE(commandLineSettings.batchCommand.has_value());
+	EXPECT_EQ(commandLineSettings.batchCommand->type, BatchCommandType::Search);
+	EXPECT_THAT(commandLineSettings.batchCommand->paths, ElementsAre(L"c:\\path"));
+	EXPECT_EQ(commandLineSettings.batchCommand->pattern, L"report ?.doc");
+
+	commandLineSettings =
+		ParseCommandLine(L"explorer++.exe batch hash c:\\file.txt --algorithm crc32 --format csv");
+	ASSERT_TRUE(commandLineSettings.batchCommand.has_value());
+	EXPECT_EQ(commandLineSettings.batchCommand->type, BatchCommandType::Hash);
+	EXPECT_EQ(commandLineSettings.batchCommand->hashAlgorithm, HashAlgorithm::Crc32);
+	EXPECT_EQ(commandLineSettings.batchCommand->format, ListingFormat::Csv);
+
+	commandLineSettings = ParseCommandLine(
+		L"explorer++.exe batch compare c:\\left d:\\right --content xxhash64 --differences-only");
+	ASSERT_TRUE(commandLineSettings.batchCommand.has_value());
+	EXPECT_EQ(commandLineSettings.batchCommand->type, BatchCommandType::Compare);
+	EXPECT_THAT(commandLineSettings.batchCommand->paths, ElementsAre(L"c:\\left", L"d:\\right"));
+	EXPECT_EQ(commandLineSettings.batchCommand->compareContents, HashAlgorithm::XxHash64);
+	EXPECT_TRUE(commandLineSettings.batchCommand->differencesOnly);
+}
+
+TEST_F(CommandLineTest, BatchCommandNamesAsDirectories)
+{
+	// Without the batch prefix, the command names should be treated as relative directories.
+	auto commandLineSettings = ParseCommandLine(L"explorer++.exe list compare");
+	EXPECT_FALSE(commandLineSettings.batchCommand.has_value());
+	EXPECT_THAT(commandLineSettings.directories, ElementsAre(L"list", L"compare"));
+}
+
 TEST_F(CommandLineTest, CrashedData)
 {
 	CrashedData crashedData;
@@ -0,0 +1,229 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "pch.h"
+#include "ShellBrowser/CompactItemStore.h"
+#include <gtest/gtest.h>
+#include <format>
+
+namespace
+{
+
+struct TestItem
+{
+	std::vector<std::byte> pidl;
+	std::wstring parsingName;
+	std::wstring displayName;
+	std::wstring editingName;
+	uint64_t size;
+	uint64_t creationTime;
+	uint64_t lastAccessTime;
+	uint64_t lastWriteTime;
+	uint32_t attributes;
+
+	CompactItemStore::ItemData GetItemData() const
+	{
+		return { pidl, parsingName, displayName, editingName, size, creationTime, lastAccessTime,
+			lastWriteTime, attributes };
+	}
+};
+
+TestItem BuildTestItem(size_t index)
+{
+	TestItem item;
+
+	// Roughly approximates the size of a single-level relative PIDL for a file.
+	auto pidlSize = 60 + (index % 40);
+
+	for (size_t i = 0; i < pidlSize; i++)
+	{
+		item.pidl.push_back(static_cast<std::byte>((index + i) & 0xFF));
+	}
+
+	item.displayName = std::format(L"File {}.txt", index);
+	item.parsingName = item.displayName;
+	item.editingName = item.displayName;
+	item.size = index * 1024;
+	item.creationTime = index + 1;
+	item.lastAccessTime = index + 2;
+	item.lastWriteTime = index + 3;
+	item.attributes = static_cast<uint32_t>(index % 64);
+	return item;
+}
+
+void VerifyItem(const CompactItemStore &store, CompactItemStore::ItemId id,
+	const TestItem &expectedItem)
+{
+	ASSERT_TRUE(store.HasItem(id));
+
+	auto item = store.GetItem(id);
+	EXPECT_EQ(item.GetId(), id);
+	EXPECT_TRUE(std::ranges::equal(item.GetPidl(), expectedItem.pidl));
+	EXPECT_EQ(item.GetParsingName(), expectedItem.parsingName);
+	EXPECT_EQ(item.GetDisplayName(), expectedItem.displayName);
+	EXPECT_EQ(item.GetEditingName(), expectedItem.editingName);
+	EXPECT_EQ(item.GetSize(), expectedItem.size);
+	EXPECT_EQ(item.GetCreationTime(), expectedItem.creationTime);
+	EXPECT_EQ(item.GetLastAccessTime(), expectedItem.lastAccessTime);
+	EXPECT_EQ(item.GetLastWriteTime(), expectedItem.lastWriteTime);
+	EXPECT_EQ(item.GetAttributes(), expectedItem.attributes);
+}
+
+}
+
+TEST(CompactItemStoreTest, AddItem)
+{
+	CompactItemStore store;
+	EXPECT_EQ(store.GetNumItems(), 0u);
+
+	auto item1 = BuildTestItem(1);
+	auto item2 = BuildTestItem(2);
+	item2.parsingName = L"C:\\Folder\\File 2.txt";
+	item2.displayName = L"File 2";
+	item2.editingName = L"File 2.txt";
+
+	auto id1 = store.AddItem(item1.GetItemData());
+	auto id2 = store.AddItem(item2.GetItemData());
+	EXPECT_NE(id1, id2);
+	EXPECT_EQ(store.GetNumItems(), 2u);
+
+	VerifyItem(store, id1, item1);
+	VerifyItem(store, id2, item2);
+}
+
+TEST(CompactItemStoreTest, UpdateItem)
+{
+	CompactItemStore store;
+
+	auto item = BuildTestItem(1);
+	auto id = store.AddItem(item.GetItemData());
+
+	auto updatedItem = BuildTestItem(2);
+	updatedItem.editingName = L"Updated name";
+	store.UpdateItem(id, updatedItem.GetItemData());
+	EXPECT_EQ(store.GetNumItems(), 1u);
+
+	VerifyItem(store, id, updatedItem);
+}
+
+TEST(CompactItemStoreTest, RemoveItem)
+{
+	CompactItemStore store;
+
+	auto item1 = BuildTestItem(1);
+	auto item2 = BuildTestItem(2);
+	auto id1 = store.AddItem(item1.GetItemData());
+	auto id2 = store.AddItem(item2.GetItemData());
+
+	store.RemoveItem(id1);
+	EXPECT_FALSE(store.HasItem(id1));
+	EXPECT_EQ(store.GetNumItems(), 1u);
+	VerifyItem(store, id2, item2);
+
+	// The ID of the removed item should be reused.
+	auto item3 = BuildTestItem(3);
+	auto id3 = store.AddItem(item3.GetItemData());
+	EXPECT_EQ(id3, id1);
+	VerifyItem(store, id3, item3);
+}
+
+TEST(CompactItemStoreTest, Clear)
+{
+	CompactItemStore store;
+
+	auto id = store.AddItem(BuildTestItem(1).GetItemData());
+	store.Clear();
+
+	EXPECT_EQ(store.GetNumItems(), 0u);
+	EXPECT_FALSE(store.HasItem(id));
+}
+
+TEST(CompactItemStoreTest, Compact)
+{
+	CompactItemStore store;
+	std::vector<std::pair<CompactItemStore::ItemId, TestItem>> items;
+
+	for (size_t i = 0; i < 10000; i++)
+	{
+		auto item = BuildTestItem(i);
+		auto id = store.AddItem(item.GetItemData());
+		items.emplace_back(id, std::move(item));
+	}
+
+	// Removing every other item will result in a large amount of unused space, which should be
+	// reclaimed automatically.
+	std::vector<std::pair<CompactItemStore::ItemId, TestItem>> remainingItems;
+
+	for (size_t i = 0; i < items.size(); i++)
+	{
+		if (i % 2 == 0)
+		{
+			store.RemoveItem(items[i].first);
+		}
+		else
+		{
+			remainingItems.push_back(std::move(items[i]));
+		}
+	}
+
+	store.Compact();
+
+	EXPECT_EQ(store.GetNumItems(), remainingItems.size());
+
+	for (const auto &[id, item] : remainingItems)
+	{
+		VerifyItem(store, id, item);
+	}
+}
+
+TEST(CompactItemStoreTest, CompactWithEmptyName)
+{
+	CompactItemStore store;
+
+	// An empty display name occupies no space in the arena, so it starts at the same offset as the
+	// parsing name that's added after it. The two names shouldn't be treated as shared.
+	auto item = BuildTestItem(1);
+	item.displayName = L"";
+	item.editingName = L"";
+	auto id = store.AddItem(item.GetItemData());
+
+	auto otherItem = BuildTestItem(2);
+	otherItem.displayName = L"";
+	otherItem.editingName = L"Editing name";
+	auto otherId = store.AddItem(otherItem.GetItemData());
+
+	store.Compact();
+	VerifyItem(store, id, item);
+	VerifyItem(store, otherId, otherItem);
+
+	// Removing the other item and compacting again should also leave the remaining item intact.
+	store.RemoveItem(otherId);
+	store.Compact();
+	VerifyItem(store, id, item);
+}
+
+// Acts as a benchmark for the memory used by a large folder. The equivalent
+// ShellBrowserImpl::ItemInfo_t representation uses several hundred bytes per item (mostly for the
+// full parsing path), spread across several separate heap allocations.
+TEST(CompactItemStoreTest, DISABLED_MemoryUsageForLargeFolder)
+{
+	constexpr size_t NUM_ITEMS = 1'000'000;
+
+	CompactItemStore store;
+
+	for (size_t i = 0; i < NUM_ITEMS; i++)
+	{
+		store.AddItem(BuildTestItem(i).GetItemData());
+	}
+
+	EXPECT_EQ(store.GetNumItems(), NUM_ITEMS);
+
+	// Each item has a PIDL of around 80 bytes and a name of around 15 characters. Everything else
+	// should add less than 100 bytes on top of that, even accounting for vector growth.
+	auto bytesPerItem = store.GetMemoryUsage() / NUM_ITEMS;
+	EXPECT_LT(bytesPerItem, 300u);
+
+	VerifyItem(store, 0, BuildTestItem(0));
+	VerifyItem(store, NUM_ITEMS - 1, BuildTestItem(NUM_ITEMS - 1));
+}
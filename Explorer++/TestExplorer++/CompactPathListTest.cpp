@@ -0,0 +1,179 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "pch.h"
+#include "../Helper/CompactPathList.h"
+#include <gtest/gtest.h>
+#include <chrono>
+
+using namespace std::string_view_literals;
+
+namespace
+{
+
+std::vector<std::wstring> BuildSyntheticPaths(int numPaths)
+{
+	std::vector<std::wstring> paths;
+	paths.reserve(numPaths);
+
+	for (int i = 0; i < numPaths; i++)
+	{
+		paths.push_back(L"C:\\Projects\\Project " + std::to_wstring(i / 1000) + L"\\Module "
+			+ std::to_wstring((i / 100) % 10) + L"\\source file " + std::to_wstring(i) + L".cpp");
+	}
+
+	return paths;
+}
+
+}
+
+TEST(CompactPathListTest, Empty)
+{
+	CompactPathList pathList;
+	EXPECT_TRUE(pathList.IsEmpty());
+	EXPECT_EQ(pathList.GetCount(), 0u);
+	EXPECT_EQ(pathList.GetDoubleNullTerminatedData(), L"\0"sv);
+	EXPECT_EQ(pathList.GetJoinedLength(L"\r\n"), 0u);
+	EXPECT_EQ(pathList.Join(L"\r\n"), L"");
+}
+
+TEST(CompactPathListTest, AddAndGet)
+{
+	CompactPathList pathList;
+	pathList.Add(L"C:\\Windows");
+	pathList.Add(L"");
+	pathList.Add(L"D:\\file.txt");
+
+	EXPECT_FALSE(pathList.IsEmpty());
+	ASSERT_EQ(pathList.GetCount(), 3u);
+	EXPECT_EQ(pathList.GetPath(0), L"C:\\Windows");
+	EXPECT_EQ(pathList.GetPath(1), L"");
+	EXPECT_EQ(pathList.GetPath(2), L"D:\\file.txt");
+}
+
+TEST(CompactPathListTest, DoubleNullTerminatedData)
+{
+	CompactPathList pathList;
+	pathList.Add(L"C:\\a");
+	pathList.Add(L"C:\\b");
+
+	EXPECT_EQ(pathList.GetDoubleNullTerminatedData(), L"C:\\a\0C:\\b\0\0"sv);
+}
+
+TEST(CompactPathListTest, Join)
+{
+	CompactPathList pathList;
+	pathList.Add(L"C:\\a");
+	EXPECT_EQ(pathList.Join(L"\r\n"), L"C:\\a");
+
+	pathList.Add(L"C:\\bb");
+	pathList.Add(L"C:\\ccc");
+	EXPECT_EQ(pathList.GetJoinedLength(L"\r\n"), 19u);
+	EXPECT_EQ(pathList.Join(L"\r\n"), L"C:\\a\r\nC:\\bb\r\nC:\\ccc");
+	EXPECT_EQ(pathList.Join(L""), L"C:\\aC:\\bbC:\\ccc");
+}
+
+TEST(CompactPathListTest, LargeList)
+{
+	auto paths = BuildSyntheticPaths(100'000);
+
+	CompactPathList pathList;
+
+	for (const auto &path : paths)
+	{
+		pathList.Add(path);
+	}
+
+	ASSERT_EQ(pathList.GetCount(), paths.size());
+
+	for (size_t i = 0; i < paths.size(); i++)
+	{
+		ASSERT_EQ(pathList.GetPath(i), paths[i]);
+	}
+
+	std::wstring expectedJoined;
+
+	for (const auto &path : paths)
+	{
+		if (!expectedJoined.empty())
+		{
+			expectedJoined += L"\r\n";
+		}
+
+		expectedJoined += path;
+	}
+
+	EXPECT_EQ(pathList.Join(L"\r\n"), expectedJoined);
+}
+
+// Compares the memory used by a CompactPathList to the memory used by an equivalent vector of
+// strings and records how long it takes to produce the clipboard text from each.
+TEST(CompactPathListTest, DISABLED_Benchmark)
+{
+	constexpr int NUM_PATHS = 100'000;
+
+	auto paths = BuildSyntheticPaths(NUM_PATHS);
+
+	size_t numCharacters = 0;
+	size_t vectorMemoryUsage = paths.capacity() * sizeof(std::wstring);
+
+	for (const auto &path : paths)
+	{
+		numCharacters += path.size();
+
+		// Short strings are stored inline, so only account for the heap allocation when there is
+		// one.
+		if (path.capacity() >= sizeof(std::wstring) / sizeof(wchar_t))
+		{
+			vectorMemoryUsage += (path.capacity() + 1) * sizeof(wchar_t);
+		}
+	}
+
+	auto buildStart = std::chrono::steady_clock::now();
+
+	CompactPathList pathList;
+	pathList.Reserve(paths.size(), numCharacters);
+
+	for (const auto &path : paths)
+	{
+		pathList.Add(path);
+	}
+
+	auto buildEnd = std::chrono::steady_clock::now();
+
+	EXPECT_LT(pathList.GetMemoryUsage(), vectorMemoryUsage);
+
+	auto vectorJoinStart = std::chrono::steady_clock::now();
+
+	std::wstring vectorJoined;
+
+	for (const auto &path : paths)
+	{
+		vectorJoined += path;
+		vectorJoined += L"\r\n";
+	}
+
+	auto vectorJoinEnd = std::chrono::steady_clock::now();
+
+	auto compactJoinStart = std::chrono::steady_clock::now();
+	auto compactJoined = pathList.Join(L"\r\n");
+	auto compactJoinEnd = std::chrono::steady_clock::now();
+
+	EXPECT_EQ(compactJoined.size() + 2, vectorJoined.size());
+
+	testing::Test::RecordProperty("VectorMemoryBytes", static_cast<int>(vectorMemoryUsage));
+	testing::Test::RecordProperty("CompactMemoryBytes",
+		static_cast<int>(pathList.GetMemoryUsage()));
+	testing::Test::RecordProperty("CompactBuildUs",
+		static_cast<int>(
+			std::chrono::duration_cast<std::chrono::microseconds>(buildEnd - buildStart).count()));
+	testing::Test::RecordProperty("VectorJoinUs",
+		static_cast<int>(std::chrono::duration_cast<std::chrono::microseconds>(
+			vectorJoinEnd - vectorJoinStart)
+				.count()));
+	testing::Test::RecordProperty("CompactJoinUs",
+		static_cast<int>(std::chrono::duration_cast<std::chrono::microseconds>(
+			compactJoinEnd - compactJoinStart)
+				.count()));
+}
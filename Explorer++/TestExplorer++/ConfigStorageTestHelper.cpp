@@ -15,6 +15,13 @@ Config BuildReference()
 	config.language = MAKELANGID(LANG_FRENCH, SUBLANG_FRENCH);
 	config.defaultTabDirectory = L"C:\\";
 	config.alwaysOpenNewTab = true;
+	config.dormantTabTimeoutMinutes = 5;
+	config.maxHistoryEntriesPerTab = 20;
+	config.maxGlobalHistoryItems = 100;
+	config.folderSnapshotCacheSizeMB = 16;
+	config.prefetchFolders = false;
+	config.indexFileNames = true;
+	config.openZipFilesInArchiveBrowser = true;
 	config.infoTipType = InfoTipType::Custom;
 	config.displayWindowCentreColor = RGB(255, 0, 0);
 	config.displayWindowSurroundColor = RGB(0, 255, 0);
@@ -0,0 +1,155 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "pch.h"
+#include "../Helper/ContentHash.h"
+#include "TemporaryPathTestHelper.h"
+#include <gtest/gtest.h>
+#include <chrono>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <string>
+#include <string_view>
+
+namespace
+{
+
+std::string Hash(HashAlgorithm algorithm, std::string_view data)
+{
+	ContentHasher hasher(algorithm);
+	hasher.Update(data.data(), data.size());
+	return hasher.Finish();
+}
+
+std::string HashInChunks(HashAlgorithm algorithm, std::string_view data, size_t chunkSize)
+{
+	ContentHasher hasher(algorithm);
+
+	for (size_t i = 0; i < data.size(); i += chunkSize)
+	{
+		auto chunk = data.substr(i, chunkSize);
+		hasher.Update(chunk.data(), chunk.size());
+	}
+
+	return hasher.Finish();
+}
+
+std::string GenerateData(size_t size)
+{
+	std::string data(size, '\0');
+	uint32_t state = 12345;
+
+	for (auto &c : data)
+	{
+		state = state * 1103515245 + 12345;
+		c = static_cast<char>(state >> 16);
+	}
+
+	return data;
+}
+
+}
+
+TEST(ContentHashTest, Crc32)
+{
+	EXPECT_EQ(Hash(HashAlgorithm::Crc32, ""), "00000000");
+	EXPECT_EQ(Hash(HashAlgorithm::Crc32, "123456789"), "cbf43926");
+	EXPECT_EQ(Hash(HashAlgorithm::Crc32, "The quick brown fox jumps over the lazy dog"),
+		"414fa339");
+}
+
+TEST(ContentHashTest, XxHash64)
+{
+	EXPECT_EQ(Hash(HashAlgorithm::XxHash64, ""), "ef46db3751d8e999");
+	EXPECT_EQ(Hash(HashAlgorithm::XxHash64, "a"), "d24ec4f1a98c6e5b");
+	EXPECT_EQ(Hash(HashAlgorithm::XxHash64, "abc"), "44bc2cf5ad770999");
+	EXPECT_EQ(Hash(HashAlgorithm::XxHash64, "The quick brown fox jumps over the lazy dog"),
+		"0b242d361fda71bc");
+}
+
+TEST(ContentHashTest, Sha256)
+{
+	EXPECT_EQ(Hash(HashAlgorithm::Sha256, ""),
+		"e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855");
+	EXPECT_EQ(Hash(HashAlgorithm::Sha256, "abc"),
+		"ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+	EXPECT_EQ(Hash(HashAlgorithm::Sha256,
+				  "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq"),
+		"248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1");
+	EXPECT_EQ(Hash(HashAlgorithm::Sha256, std::string(1000000, 'a')),
+		"cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0");
+}
+
+// The result shouldn't depend on how the data is split up between calls to Update().
+TEST(ContentHashTest, IncrementalUpdates)
+{
+	auto data = GenerateData(10000);
+
+	for (auto algorithm : { HashAlgorithm::Crc32, HashAlgorithm::XxHash64, HashAlgorithm::Sha256 })
+	{
+		auto expected = Hash(algorithm, data);
+
+		for (size_t chunkSize : { 1, 3, 7, 31, 32, 33, 63, 64, 65, 4096 })
+		{
+			EXPECT_EQ(HashInChunks(algorithm, data, chunkSize), expected);
+		}
+	}
+}
+
+TEST(ContentHashTest, HashFile)
+{
+	// The data spans several read blocks.
+	auto data = GenerateData(HASH_FILE_BLOCK_SIZE * 2 + 123);
+	TemporaryTestFile tempFile("ContentHashTest");
+	std::ofstream(tempFile.GetPath(), std::ios::binary).write(data.data(), data.size());
+
+	uint64_t bytesRead = 0;
+	auto hash = HashFile(tempFile.GetPath(), HashAlgorithm::Sha256, {}, std::nullopt, &bytesRead);
+	auto partialHash = HashFile(tempFile.GetPath(), HashAlgorithm::XxHash64, {}, 1000);
+
+	EXPECT_EQ(hash, Hash(HashAlgorithm::Sha256, data));
+	EXPECT_EQ(bytesRead, data.size());
+	EXPECT_EQ(partialHash, Hash(HashAlgorithm::XxHash64, std::string_view(data).substr(0, 1000)));
+}
+
+TEST(ContentHashTest, HashMissingFile)
+{
+	EXPECT_EQ(HashFile(GetUniqueTempPath("ContentHashTest"), HashAlgorithm::Crc32, {}),
+		std::nullopt);
+}
+
+TEST(ContentHashTest, HashFileCancelled)
+{
+	TemporaryTestFile tempFile("ContentHashTest");
+	std::ofstream(tempFile.GetPath(), std::ios::binary) << "data";
+
+	std::stop_source stopSource;
+	stopSource.request_stop();
+	auto hash = HashFile(tempFile.GetPath(), HashAlgorithm::Crc32, stopSource.get_token());
+
+	EXPECT_EQ(hash, std::nullopt);
+}
+
+// Measures the throughput of each algorithm over in-memory data, which gives an upper bound on the
+// rate at which files can be hashed.
+TEST(ContentHashTest, DISABLED_Throughput)
+{
+	auto data = GenerateData(64 * 1024 * 1024);
+
+	for (auto [algorithm, name] : { std::pair{ HashAlgorithm::Crc32, "Crc32" },
+			 std::pair{ HashAlgorithm::XxHash64, "XxHash64" },
+			 std::pair{ HashAlgorithm::Sha256, "Sha256" } })
+	{
+		auto start = std::chrono::steady_clock::now();
+		auto hash = HashInChunks(algorithm, data, HASH_FILE_BLOCK_SIZE);
+		auto elapsed = std::chrono::steady_clock::now() - start;
+		auto elapsedMs = std::max(
+			std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count(), int64_t{ 1 });
+
+		EXPECT_FALSE(hash.empty());
+		testing::Test::RecordProperty(std::format("{}MBPerSecond", name),
+			static_cast<int>(data.size() / 1024 / 1024 * 1000 / elapsedMs));
+	}
+}
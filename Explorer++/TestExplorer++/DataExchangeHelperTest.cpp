@@ -5,6 +5,7 @@
 #include "pch.h"
 #include "../Helper/DataExchangeHelper.h"
 #include "ImageTestHelper.h"
+#include "../Helper/CompactPathList.h"
 #include "../Helper/DataObjectImpl.h"
 #include <gtest/gtest.h>
 
@@ -103,3 +104,45 @@ TEST(DataExchangeHelperTest, ReadWriteVirtualFiles)
 
 	EXPECT_EQ(retrievedVirtualFiles, virtualFiles);
 }
+
+TEST(DataExchangeHelperTest, ReadWriteHDropData)
+{
+	CompactPathList pathList;
+	std::vector<std::wstring> paths;
+
+	for (int i = 0; i < 10'000; i++)
+	{
+		auto path = L"C:\\Projects\\Folder " + std::to_wstring(i / 100) + L"\\file "
+			+ std::to_wstring(i) + L".txt";
+		pathList.Add(path);
+		paths.push_back(path);
+	}
+
+	auto global = WriteHDropDataToGlobal(pathList);
+	ASSERT_NE(global, nullptr);
+
+	auto retrievedPaths = ReadHDropDataFromGlobal(global.get());
+	ASSERT_TRUE(retrievedPaths.has_value());
+	EXPECT_EQ(*retrievedPaths, paths);
+
+	EXPECT_EQ(WriteHDropDataToGlobal(CompactPathList()), nullptr);
+}
+
+TEST(DataExchangeHelperTest, WriteJoinedPaths)
+{
+	CompactPathList pathList;
+	pathList.Add(L"C:\\Windows");
+	pathList.Add(L"D:\\file.txt");
+
+	auto global = WriteJoinedPathsToGlobal(pathList, L"\r\n");
+	ASSERT_NE(global, nullptr);
+
+	auto text = ReadStringFromGlobal(global.get());
+	EXPECT_EQ(text, L"C:\\Windows\r\nD:\\file.txt");
+
+	global = WriteJoinedPathsToGlobal(CompactPathList(), L"\r\n");
+	ASSERT_NE(global, nullptr);
+
+	text = ReadStringFromGlobal(global.get());
+	EXPECT_EQ(text, L"");
+}
@@ -81,3 +81,71 @@ TEST_F(DataObjectImplTest, SetDataAndGetDataTakeOwnership)
 {
 	PerformSetDataGetDataCheck(true);
 }
+
+TEST(DataObjectImplDelayedDataTest, RenderedOnDemand)
+{
+	auto dataObject = winrt::make_self<DataObjectImpl>();
+
+	FORMATETC formatEtc = { CF_UNICODETEXT, nullptr, DVASPECT_CONTENT, -1, TYMED_HGLOBAL };
+	std::wstring text = L"Delayed text";
+	int numRenders = 0;
+
+	dataObject->SetDelayedData(formatEtc,
+		[&text, &numRenders]()
+		{
+			numRenders++;
+			return GetStgMediumForGlobal(WriteStringToGlobal(text));
+		});
+
+	// Querying the available formats shouldn't result in the data being rendered.
+	EXPECT_HRESULT_SUCCEEDED(dataObject->QueryGetData(&formatEtc));
+
+	wil::com_ptr_nothrow<IEnumFORMATETC> enumFormatEtc;
+	ASSERT_HRESULT_SUCCEEDED(dataObject->EnumFormatEtc(DATADIR_GET, &enumFormatEtc));
+
+	FORMATETC enumeratedFormat;
+	ULONG numFetched;
+	ASSERT_EQ(enumFormatEtc->Next(1, &enumeratedFormat, &numFetched), S_OK);
+	EXPECT_EQ(enumeratedFormat.cfFormat, CF_UNICODETEXT);
+
+	EXPECT_EQ(numRenders, 0);
+
+	for (int i = 0; i < 3; i++)
+	{
+		wil::unique_stg_medium stgMedium;
+		ASSERT_HRESULT_SUCCEEDED(dataObject->GetData(&formatEtc, &stgMedium));
+		EXPECT_EQ(ReadStringFromGlobal(stgMedium.hGlobal), text);
+	}
+
+	// The result should be cached after the first request.
+	EXPECT_EQ(numRenders, 1);
+}
+
+TEST(DataObjectImplDelayedDataTest, RenderingFailure)
+{
+	auto dataObject = winrt::make_self<DataObjectImpl>();
+
+	FORMATETC formatEtc = { CF_UNICODETEXT, nullptr, DVASPECT_CONTENT, -1, TYMED_HGLOBAL };
+	int numRenders = 0;
+
+	dataObject->SetDelayedData(formatEtc,
+		[&numRenders]()
+		{
+			numRenders++;
+
+			if (numRenders == 1)
+			{
+				return wil::unique_stg_medium();
+			}
+
+			return GetStgMediumForGlobal(WriteStringToGlobal(L"Second attempt"));
+		});
+
+	wil::unique_stg_medium stgMedium;
+	EXPECT_HRESULT_FAILED(dataObject->GetData(&formatEtc, &stgMedium));
+
+	// A failure shouldn't be cached, so the data should be rendered again.
+	ASSERT_HRESULT_SUCCEEDED(dataObject->GetData(&formatEtc, &stgMedium));
+	EXPECT_EQ(ReadStringFromGlobal(stgMedium.hGlobal), L"Second attempt");
+	EXPECT_EQ(numRenders, 2);
+}
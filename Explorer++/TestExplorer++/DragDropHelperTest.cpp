@@ -5,6 +5,7 @@
 #include "pch.h"
 #include "../Helper/DragDropHelper.h"
 #include "DragDropTestHelper.h"
+#include "../Helper/CompactPathList.h"
 #include <gtest/gtest.h>
 
 using namespace testing;
@@ -29,3 +30,58 @@ TEST_P(PreferredDropEffectTestSuite, PreferredDropEffect)
 
 INSTANTIATE_TEST_SUITE_P(CopyAndMoveEffects, PreferredDropEffectTestSuite,
 	Values(DROPEFFECT_COPY, DROPEFFECT_MOVE));
+
+TEST(CreateDataObjectForPathsTest, DelayedRendering)
+{
+	std::promise<std::shared_ptr<const CompactPathList>> pathsPromise;
+
+	wil::com_ptr_nothrow<IDataObject> dataObject;
+	ASSERT_HRESULT_SUCCEEDED(CreateDataObjectForPaths(pathsPromise.get_future().share(),
+		PathDataFormats::Text | PathDataFormats::HDrop, &dataObject));
+
+	// The formats should be advertised before the list of paths has been built.
+	FORMATETC textFormat = { CF_UNICODETEXT, nullptr, DVASPECT_CONTENT, -1, TYMED_HGLOBAL };
+	EXPECT_HRESULT_SUCCEEDED(dataObject->QueryGetData(&textFormat));
+
+	FORMATETC hdropFormat = { CF_HDROP, nullptr, DVASPECT_CONTENT, -1, TYMED_HGLOBAL };
+	EXPECT_HRESULT_SUCCEEDED(dataObject->QueryGetData(&hdropFormat));
+
+	std::vector<std::wstring> paths;
+	auto pathList = std::make_shared<CompactPathList>();
+
+	for (int i = 0; i < 100'000; i++)
+	{
+		auto path = L"C:\\Projects\\Folder " + std::to_wstring(i / 1000) + L"\\file "
+			+ std::to_wstring(i) + L".txt";
+		paths.push_back(path);
+		pathList->Add(path);
+	}
+
+	pathsPromise.set_value(pathList);
+
+	wil::unique_stg_medium stgMedium;
+	ASSERT_HRESULT_SUCCEEDED(dataObject->GetData(&textFormat, &stgMedium));
+	EXPECT_EQ(ReadStringFromGlobal(stgMedium.hGlobal), pathList->Join(L"\r\n"));
+
+	ASSERT_HRESULT_SUCCEEDED(dataObject->GetData(&hdropFormat, &stgMedium));
+	EXPECT_EQ(ReadHDropDataFromGlobal(stgMedium.hGlobal), paths);
+}
+
+TEST(CreateDataObjectForPathsTest, RequestedFormatsOnly)
+{
+	auto pathList = std::make_shared<CompactPathList>();
+	pathList->Add(L"C:\\file.txt");
+
+	std::promise<std::shared_ptr<const CompactPathList>> pathsPromise;
+	pathsPromise.set_value(pathList);
+
+	wil::com_ptr_nothrow<IDataObject> dataObject;
+	ASSERT_HRESULT_SUCCEEDED(CreateDataObjectForPaths(pathsPromise.get_future().share(),
+		PathDataFormats::Text, &dataObject));
+
+	FORMATETC textFormat = { CF_UNICODETEXT, nullptr, DVASPECT_CONTENT, -1, TYMED_HGLOBAL };
+	EXPECT_HRESULT_SUCCEEDED(dataObject->QueryGetData(&textFormat));
+
+	FORMATETC hdropFormat = { CF_HDROP, nullptr, DVASPECT_CONTENT, -1, TYMED_HGLOBAL };
+	EXPECT_EQ(dataObject->QueryGetData(&hdropFormat), DV_E_FORMATETC);
+}
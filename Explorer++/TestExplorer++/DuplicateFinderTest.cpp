@@ -0,0 +1,205 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "pch.h"
+#include "../Helper/DuplicateFinder.h"
+#include "../Helper/FileHashCache.h"
+#include "TemporaryPathTestHelper.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <thread>
+
+class DuplicateFinderTest : public testing::Test
+{
+protected:
+	DuplicateFinderTest() : m_tempFolder("DuplicateFinderTest"), m_root(m_tempFolder.GetPath())
+	{
+	}
+
+	std::filesystem::path CreateTestFile(const std::filesystem::path &relativePath,
+		const std::string &contents)
+	{
+		auto path = m_root / relativePath;
+		std::filesystem::create_directories(path.parent_path());
+		std::ofstream(path, std::ios::binary).write(contents.data(), contents.size());
+		return path;
+	}
+
+	std::vector<DuplicateGroup> FindDuplicates(DuplicateFinder::Options options = {})
+	{
+		DuplicateFinder finder(options);
+		auto groups = finder.Find(CollectDuplicateFinderFiles(m_root, {}), {});
+		EXPECT_TRUE(groups.has_value());
+		return groups.value_or(std::vector<DuplicateGroup>{});
+	}
+
+	const TemporaryTestFolder m_tempFolder;
+	const std::filesystem::path m_root;
+};
+
+TEST_F(DuplicateFinderTest, NoDuplicates)
+{
+	CreateTestFile("a.txt", "a");
+	CreateTestFile("b.txt", "bb");
+
+	// Same size, different content.
+	CreateTestFile("c.txt", "cc");
+
+	EXPECT_TRUE(FindDuplicates().empty());
+}
+
+TEST_F(DuplicateFinderTest, Duplicates)
+{
+	auto path1 = CreateTestFile("a.txt", "content");
+	auto path2 = CreateTestFile("sub/b.txt", "content");
+	auto path3 = CreateTestFile("sub/nested/c.txt", "content");
+	auto path4 = CreateTestFile("d.txt", "1234567890");
+	auto path5 = CreateTestFile("e.txt", "1234567890");
+	CreateTestFile("f.txt", "other");
+
+	auto groups = FindDuplicates();
+	ASSERT_EQ(groups.size(), 2u);
+
+	// The group that wastes the most space comes first.
+	EXPECT_EQ(groups[0].size, 7u);
+	EXPECT_EQ(groups[0].paths,
+		(std::vector<std::filesystem::path>{ path1, path2, path3 }));
+
+	EXPECT_EQ(groups[1].size, 10u);
+	EXPECT_EQ(groups[1].paths, (std::vector<std::filesystem::path>{ path4, path5 }));
+}
+
+TEST_F(DuplicateFinderTest, EmptyFilesIgnored)
+{
+	CreateTestFile("a.txt", "");
+	CreateTestFile("b.txt", "");
+
+	EXPECT_TRUE(FindDuplicates().empty());
+}
+
+TEST_F(DuplicateFinderTest, DifferenceAfterPartialBlock)
+{
+	std::string contents(1000, 'x');
+	CreateTestFile("a.bin", contents + "1");
+	CreateTestFile("b.bin", contents + "2");
+
+	DuplicateFinder::Options options;
+	options.partialHashSize = 100;
+
+	// The files share the same prefix, so they should only be told apart once their full content
+	// is hashed.
+	DuplicateFinder finder(options);
+	auto groups = finder.Find(CollectDuplicateFinderFiles(m_root, {}), {});
+	ASSERT_TRUE(groups.has_value());
+	EXPECT_TRUE(groups->empty());
+	EXPECT_EQ(finder.GetProgress().numBytesRead, 100u * 2 + 1001u * 2);
+}
+
+TEST_F(DuplicateFinderTest, DifferenceWithinPartialBlock)
+{
+	std::string contents(1000, 'x');
+	CreateTestFile("a.bin", "1" + contents);
+	CreateTestFile("b.bin", "2" + contents);
+
+	DuplicateFinder::Options options;
+	options.partialHashSize = 100;
+
+	// The partial hashes differ, so the full content shouldn't be read.
+	DuplicateFinder finder(options);
+	auto groups = finder.Find(CollectDuplicateFinderFiles(m_root, {}), {});
+	ASSERT_TRUE(groups.has_value());
+	EXPECT_TRUE(groups->empty());
+	EXPECT_EQ(finder.GetProgress().numBytesRead, 100u * 2);
+}
+
+TEST_F(DuplicateFinderTest, MultipleThreads)
+{
+	std::vector<std::filesystem::path> expectedPaths;
+
+	for (int i = 0; i < 20; i++)
+	{
+		CreateTestFile(std::format("unique{}.bin", i),
+			std::string(5000, static_cast<char>('a' + i)));
+		expectedPaths.push_back(
+			CreateTestFile(std::format("dup{}.bin", i), std::string(3000, 'z')));
+	}
+
+	DuplicateFinder::Options options;
+	options.numThreads = 4;
+	options.partialHashSize = 1024;
+
+	auto groups = FindDuplicates(options);
+	ASSERT_EQ(groups.size(), 1u);
+	std::sort(expectedPaths.begin(), expectedPaths.end());
+	EXPECT_EQ(groups[0].paths, expectedPaths);
+}
+
+TEST_F(DuplicateFinderTest, CachedHashesReused)
+{
+	CreateTestFile("a.bin", std::string(5000, 'a'));
+	CreateTestFile("b.bin", std::string(5000, 'a'));
+
+	FileHashCache cache;
+	DuplicateFinder::Options options;
+	options.partialHashSize = 1024;
+	options.cache = &cache;
+
+	DuplicateFinder finder1(options);
+	auto groups1 = finder1.Find(CollectDuplicateFinderFiles(m_root, {}), {});
+	EXPECT_EQ(cache.GetSize(), 2u);
+
+	// Only the partial blocks need to be read the second time around.
+	DuplicateFinder finder2(options);
+	auto groups2 = finder2.Find(CollectDuplicateFinderFiles(m_root, {}), {});
+	ASSERT_TRUE(groups1.has_value());
+	ASSERT_TRUE(groups2.has_value());
+	ASSERT_EQ(groups2->size(), 1u);
+	EXPECT_EQ(groups1->at(0).hash, groups2->at(0).hash);
+	EXPECT_EQ(finder2.GetProgress().numBytesRead, 1024u * 2);
+}
+
+TEST_F(DuplicateFinderTest, Cancelled)
+{
+	CreateTestFile("a.txt", "content");
+	CreateTestFile("b.txt", "content");
+
+	std::stop_source stopSource;
+	stopSource.request_stop();
+
+	DuplicateFinder finder({});
+	EXPECT_EQ(finder.Find(CollectDuplicateFinderFiles(m_root, {}), stopSource.get_token()),
+		std::nullopt);
+}
+
+// Measures how long it takes to find the duplicates within a tree of 1,000 files. Every file has
+// another file of the same size, and half of the files have a duplicate.
+TEST_F(DuplicateFinderTest, DISABLED_Benchmark)
+{
+	for (int i = 0; i < 1000; i++)
+	{
+		char fill = static_cast<char>((i < 500) ? (i % 250) : i);
+		std::string contents(16 * 1024 + (i % 250) * 64, fill);
+		CreateTestFile(std::format("{}/{}.bin", i % 10, i), contents);
+	}
+
+	DuplicateFinder::Options options;
+	options.numThreads = std::max(static_cast<int>(std::thread::hardware_concurrency()), 1);
+
+	auto start = std::chrono::steady_clock::now();
+	DuplicateFinder finder(options);
+	auto groups = finder.Find(CollectDuplicateFinderFiles(m_root, {}), {});
+	auto elapsed = std::chrono::steady_clock::now() - start;
+
+	ASSERT_TRUE(groups.has_value());
+	EXPECT_FALSE(groups->empty());
+
+	testing::Test::RecordProperty("ElapsedMs",
+		static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count()));
+	testing::Test::RecordProperty("BytesRead",
+		std::to_string(finder.GetProgress().numBytesRead));
+}
@@ -0,0 +1,65 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "pch.h"
+#include "../Helper/FileHashCache.h"
+#include <gtest/gtest.h>
+
+TEST(FileHashCacheTest, GetAndPut)
+{
+	FileHashCache cache;
+	FileHashKey key = { L"c:\\file.txt", HashAlgorithm::Sha256, 100, 200 };
+	EXPECT_EQ(cache.Get(key), std::nullopt);
+
+	cache.Put(key, "hash");
+	EXPECT_EQ(cache.Get(key), "hash");
+
+	// Hashes for different algorithms are stored separately.
+	EXPECT_EQ(cache.Get({ L"c:\\file.txt", HashAlgorithm::Crc32, 100, 200 }), std::nullopt);
+}
+
+TEST(FileHashCacheTest, ModifiedFile)
+{
+	FileHashCache cache;
+	cache.Put({ L"c:\\file.txt", HashAlgorithm::Crc32, 100, 200 }, "hash");
+
+	EXPECT_EQ(cache.Get({ L"c:\\file.txt", HashAlgorithm::Crc32, 101, 200 }), std::nullopt);
+
+	// The stale entry should have been removed.
+	EXPECT_EQ(cache.GetSize(), 0u);
+
+	cache.Put({ L"c:\\file.txt", HashAlgorithm::Crc32, 100, 200 }, "hash");
+	EXPECT_EQ(cache.Get({ L"c:\\file.txt", HashAlgorithm::Crc32, 100, 201 }), std::nullopt);
+}
+
+TEST(FileHashCacheTest, Update)
+{
+	FileHashCache cache;
+	cache.Put({ L"c:\\file.txt", HashAlgorithm::Crc32, 100, 200 }, "hash1");
+	cache.Put({ L"c:\\file.txt", HashAlgorithm::Crc32, 150, 300 }, "hash2");
+
+	EXPECT_EQ(cache.GetSize(), 1u);
+	EXPECT_EQ(cache.Get({ L"c:\\file.txt", HashAlgorithm::Crc32, 150, 300 }), "hash2");
+}
+
+TEST(FileHashCacheTest, LeastRecentlyUsedEvicted)
+{
+	FileHashCache cache(2);
+	FileHashKey key1 = { L"c:\\1", HashAlgorithm::Crc32, 1, 1 };
+	FileHashKey key2 = { L"c:\\2", HashAlgorithm::Crc32, 1, 1 };
+	FileHashKey key3 = { L"c:\\3", HashAlgorithm::Crc32, 1, 1 };
+
+	cache.Put(key1, "1");
+	cache.Put(key2, "2");
+
+	// This makes the second entry the least recently used.
+	EXPECT_EQ(cache.Get(key1), "1");
+
+	cache.Put(key3, "3");
+
+	EXPECT_EQ(cache.GetSize(), 2u);
+	EXPECT_EQ(cache.Get(key1), "1");
+	EXPECT_EQ(cache.Get(key2), std::nullopt);
+	EXPECT_EQ(cache.Get(key3), "3");
+}
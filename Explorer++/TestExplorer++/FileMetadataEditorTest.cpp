@@ -0,0 +1,358 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "pch.h"
+#include "../Helper/FileMetadataEditor.h"
+#include "TemporaryPathTestHelper.h"
+#include <gtest/gtest.h>
+#include <chrono>
+#include <format>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <set>
+
+using namespace std::chrono_literals;
+
+namespace
+{
+
+const auto BASE_TIME = std::filesystem::file_time_type::clock::now() - 24h;
+
+// An in-memory store, which supports every timestamp and allows failures to be simulated.
+class FakeFileMetadataStore : public FileMetadataStore
+{
+public:
+	void AddItem(const std::filesystem::path &path, const FileMetadata &metadata)
+	{
+		m_items[path] = metadata;
+	}
+
+	void FailWrites(const std::filesystem::path &path)
+	{
+		m_failingPaths.insert(path);
+	}
+
+	FileMetadata GetItem(const std::filesystem::path &path) const
+	{
+		std::scoped_lock lock(m_mutex);
+		return m_items.at(path);
+	}
+
+	std::optional<FileMetadata> GetMetadata(const std::filesystem::path &path,
+		std::error_code &error) override
+	{
+		std::scoped_lock lock(m_mutex);
+		auto itr = m_items.find(path);
+
+		if (itr == m_items.end())
+		{
+			error = std::make_error_code(std::errc::no_such_file_or_directory);
+			return std::nullopt;
+		}
+
+		error.clear();
+		return itr->second;
+	}
+
+	std::error_code SetMetadata(const std::filesystem::path &path,
+		const FileMetadata &metadata) override
+	{
+		std::scoped_lock lock(m_mutex);
+
+		if (m_failingPaths.contains(path))
+		{
+			return std::make_error_code(std::errc::permission_denied);
+		}
+
+		// As with a real store, the directory attribute can't be changed.
+		auto &item = m_items.at(path);
+		uint32_t directoryAttribute = item.attributes & FileMetadataAttribute::DIRECTORY;
+		item.attributes = (metadata.attributes & ~FileMetadataAttribute::DIRECTORY)
+			| directoryAttribute;
+		item.creationTime = metadata.creationTime.value_or(*item.creationTime);
+		item.lastAccessTime = metadata.lastAccessTime.value_or(*item.lastAccessTime);
+		item.lastWriteTime = metadata.lastWriteTime.value_or(*item.lastWriteTime);
+		m_numWrites++;
+
+		return {};
+	}
+
+	int GetNumWrites() const
+	{
+		return m_numWrites;
+	}
+
+private:
+	mutable std::mutex m_mutex;
+	std::map<std::filesystem::path, FileMetadata> m_items;
+	std::set<std::filesystem::path> m_failingPaths;
+	int m_numWrites = 0;
+};
+
+FileMetadata MakeMetadata(uint32_t attributes)
+{
+	return { attributes, BASE_TIME, BASE_TIME, BASE_TIME };
+}
+
+}
+
+TEST(ApplyFileMetadataChangesTest, Attributes)
+{
+	FileMetadataChanges changes;
+	changes.attributesToSet = FileMetadataAttribute::HIDDEN;
+	changes.attributesToClear = FileMetadataAttribute::READ_ONLY;
+
+	auto updated = ApplyFileMetadataChanges(
+		MakeMetadata(FileMetadataAttribute::READ_ONLY | FileMetadataAttribute::ARCHIVE), changes);
+	EXPECT_EQ(updated.attributes, FileMetadataAttribute::HIDDEN | FileMetadataAttribute::ARCHIVE);
+	EXPECT_EQ(updated.lastWriteTime, BASE_TIME);
+}
+
+TEST(ApplyFileMetadataChangesTest, Times)
+{
+	FileMetadataChanges changes;
+	changes.lastWriteTime = BASE_TIME + 1h;
+	changes.creationTime = BASE_TIME + 2h;
+
+	auto updated = ApplyFileMetadataChanges(MakeMetadata(0), changes);
+	EXPECT_EQ(updated.lastWriteTime, BASE_TIME + 1h);
+	EXPECT_EQ(updated.creationTime, BASE_TIME + 2h);
+	EXPECT_EQ(updated.lastAccessTime, BASE_TIME);
+
+	// Timestamps that aren't supported by the store shouldn't be set.
+	FileMetadata metadata;
+	metadata.lastWriteTime = BASE_TIME;
+	updated = ApplyFileMetadataChanges(metadata, changes);
+	EXPECT_EQ(updated.creationTime, std::nullopt);
+}
+
+class FileMetadataEditorFakeStoreTest : public testing::Test
+{
+protected:
+	FileMetadataEditorFakeStoreTest()
+	{
+		for (int i = 0; i < 100; i++)
+		{
+			m_paths.push_back(std::format("file{}", i));
+			m_store.AddItem(m_paths.back(), MakeMetadata(FileMetadataAttribute::ARCHIVE));
+		}
+	}
+
+	FakeFileMetadataStore m_store;
+	std::vector<std::filesystem::path> m_paths;
+};
+
+TEST_F(FileMetadataEditorFakeStoreTest, ApplyAndRestore)
+{
+	FileMetadataEditor editor(&m_store, { .numThreads = 4 });
+
+	FileMetadataChanges changes;
+	changes.attributesToSet = FileMetadataAttribute::HIDDEN;
+	changes.lastWriteTime = BASE_TIME + 1h;
+
+	auto result = editor.Apply(m_paths, changes, {});
+	EXPECT_FALSE(result.stopped);
+	EXPECT_TRUE(result.failures.empty());
+	ASSERT_EQ(result.journal.size(), m_paths.size());
+
+	for (size_t i = 0; i < m_paths.size(); i++)
+	{
+		// The journal should be in the same order as the input.
+		EXPECT_EQ(result.journal[i].path, m_paths[i]);
+		EXPECT_EQ(result.journal[i].previousMetadata,
+			MakeMetadata(FileMetadataAttribute::ARCHIVE));
+
+		auto metadata = m_store.GetItem(m_paths[i]);
+		EXPECT_EQ(metadata.attributes,
+			FileMetadataAttribute::ARCHIVE | FileMetadataAttribute::HIDDEN);
+		EXPECT_EQ(metadata.lastWriteTime, BASE_TIME + 1h);
+		EXPECT_EQ(metadata.creationTime, BASE_TIME);
+	}
+
+	auto progress = editor.GetProgress();
+	EXPECT_EQ(progress.numItemsProcessed, m_paths.size());
+	EXPECT_EQ(progress.numItems, m_paths.size());
+
+	auto restoreResult = editor.Restore(result.journal, {});
+	EXPECT_TRUE(restoreResult.failures.empty());
+	EXPECT_EQ(restoreResult.journal.size(), m_paths.size());
+
+	for (const auto &path : m_paths)
+	{
+		EXPECT_EQ(m_store.GetItem(path), MakeMetadata(FileMetadataAttribute::ARCHIVE));
+	}
+
+	// The journal from the restore should allow the original change to be redone.
+	editor.Restore(restoreResult.journal, {});
+	EXPECT_EQ(m_store.GetItem(m_paths[0]).attributes,
+		FileMetadataAttribute::ARCHIVE | FileMetadataAttribute::HIDDEN);
+}
+
+TEST_F(FileMetadataEditorFakeStoreTest, UnchangedItemsSkipped)
+{
+	m_store.AddItem(m_paths[0], MakeMetadata(FileMetadataAttribute::HIDDEN));
+
+	FileMetadataEditor editor(&m_store, {});
+
+	FileMetadataChanges changes;
+	changes.attributesToSet = FileMetadataAttribute::HIDDEN;
+	auto result = editor.Apply({ m_paths[0], m_paths[1] }, changes, {});
+
+	ASSERT_EQ(result.journal.size(), 1u);
+	EXPECT_EQ(result.journal[0].path, m_paths[1]);
+	EXPECT_EQ(m_store.GetNumWrites(), 1);
+}
+
+TEST_F(FileMetadataEditorFakeStoreTest, FailuresDontAbort)
+{
+	m_store.FailWrites(m_paths[10]);
+	m_store.FailWrites(m_paths[50]);
+
+	std::vector<std::filesystem::path> paths = m_paths;
+	paths.push_back("missing");
+
+	FileMetadataEditor editor(&m_store, { .numThreads = 4 });
+
+	FileMetadataChanges changes;
+	changes.attributesToSet = FileMetadataAttribute::READ_ONLY;
+	auto result = editor.Apply(paths, changes, {});
+
+	EXPECT_FALSE(result.stopped);
+	ASSERT_EQ(result.failures.size(), 3u);
+	EXPECT_EQ(result.failures[0].path, m_paths[10]);
+	EXPECT_EQ(result.failures[0].error, std::errc::permission_denied);
+	EXPECT_EQ(result.failures[1].path, m_paths[50]);
+	EXPECT_EQ(result.failures[2].path, "missing");
+	EXPECT_EQ(result.failures[2].error, std::errc::no_such_file_or_directory);
+
+	// Items that couldn't be written are still in the journal, since a failed change may have been
+	// partially applied.
+	EXPECT_EQ(result.journal.size(), m_paths.size());
+
+	EXPECT_EQ(m_store.GetItem(m_paths[11]).attributes,
+		FileMetadataAttribute::ARCHIVE | FileMetadataAttribute::READ_ONLY);
+}
+
+TEST_F(FileMetadataEditorFakeStoreTest, Stop)
+{
+	FileMetadataEditor editor(&m_store, {});
+
+	std::stop_source stopSource;
+	stopSource.request_stop();
+
+	FileMetadataChanges changes;
+	changes.attributesToSet = FileMetadataAttribute::HIDDEN;
+	auto result = editor.Apply(m_paths, changes, stopSource.get_token());
+
+	EXPECT_TRUE(result.stopped);
+	EXPECT_TRUE(result.journal.empty());
+	EXPECT_EQ(m_store.GetNumWrites(), 0);
+}
+
+class FileMetadataEditorTest : public testing::Test
+{
+protected:
+	FileMetadataEditorTest() :
+		m_tempFolder("FileMetadataEditorTest"),
+		m_root(m_tempFolder.GetPath())
+	{
+	}
+
+	~FileMetadataEditorTest()
+	{
+		// Some of the tests make files read-only, which would otherwise prevent the temp folder
+		// from being deleted.
+		std::error_code error;
+
+		for (const auto &entry : std::filesystem::recursive_directory_iterator(m_root, error))
+		{
+			std::filesystem::permissions(entry.path(), std::filesystem::perms::owner_all,
+				std::filesystem::perm_options::add, error);
+		}
+	}
+
+	void CreateTestFile(const std::filesystem::path &path)
+	{
+		std::filesystem::create_directories(path.parent_path());
+		std::ofstream(path, std::ios::binary) << "test";
+		std::filesystem::last_write_time(path, BASE_TIME);
+	}
+
+	std::filesystem::file_time_type GetLastWriteTime(const std::filesystem::path &path)
+	{
+		return std::filesystem::last_write_time(path);
+	}
+
+	const TemporaryTestFolder m_tempFolder;
+	const std::filesystem::path m_root;
+	StdFileMetadataStore m_store;
+};
+
+TEST_F(FileMetadataEditorTest, RecursiveApplyAndUndo)
+{
+	CreateTestFile(m_root / "folder" / "file1");
+	CreateTestFile(m_root / "folder" / "nested" / "file2");
+	CreateTestFile(m_root / "other");
+
+	FileMetadataEditor editor(&m_store, { .numThreads = 2, .recursive = true });
+
+	FileMetadataChanges changes;
+	changes.lastWriteTime = BASE_TIME + 1h;
+	changes.attributesToSet = FileMetadataAttribute::READ_ONLY;
+
+	auto result = editor.Apply({ m_root / "folder" / "file1", m_root / "folder" / "nested" },
+		changes, {});
+	EXPECT_FALSE(result.stopped);
+	EXPECT_TRUE(result.failures.empty());
+	EXPECT_EQ(result.journal.size(), 3u);
+
+	EXPECT_EQ(GetLastWriteTime(m_root / "folder" / "file1"), BASE_TIME + 1h);
+	EXPECT_EQ(GetLastWriteTime(m_root / "folder" / "nested" / "file2"), BASE_TIME + 1h);
+	EXPECT_EQ(GetLastWriteTime(m_root / "other"), BASE_TIME);
+
+	std::error_code error;
+	auto metadata = m_store.GetMetadata(m_root / "folder" / "nested" / "file2", error);
+	ASSERT_TRUE(metadata);
+	EXPECT_NE(metadata->attributes & FileMetadataAttribute::READ_ONLY, 0u);
+
+	auto undoResult = editor.Restore(result.journal, {});
+	EXPECT_TRUE(undoResult.failures.empty());
+
+	EXPECT_EQ(GetLastWriteTime(m_root / "folder" / "file1"), BASE_TIME);
+	EXPECT_EQ(GetLastWriteTime(m_root / "folder" / "nested" / "file2"), BASE_TIME);
+
+	metadata = m_store.GetMetadata(m_root / "folder" / "nested" / "file2", error);
+	ASSERT_TRUE(metadata);
+	EXPECT_EQ(metadata->attributes & FileMetadataAttribute::READ_ONLY, 0u);
+}
+
+TEST_F(FileMetadataEditorTest, NonRecursive)
+{
+	CreateTestFile(m_root / "folder" / "file");
+
+	FileMetadataEditor editor(&m_store, {});
+
+	FileMetadataChanges changes;
+	changes.lastWriteTime = BASE_TIME + 1h;
+	auto result = editor.Apply({ m_root / "folder" }, changes, {});
+
+	EXPECT_EQ(result.journal.size(), 1u);
+	EXPECT_EQ(GetLastWriteTime(m_root / "folder"), BASE_TIME + 1h);
+	EXPECT_EQ(GetLastWriteTime(m_root / "folder" / "file"), BASE_TIME);
+}
+
+TEST_F(FileMetadataEditorTest, MissingItem)
+{
+	FileMetadataEditor editor(&m_store, {});
+
+	FileMetadataChanges changes;
+	changes.attributesToSet = FileMetadataAttribute::READ_ONLY;
+	auto result = editor.Apply({ m_root / "missing" }, changes, {});
+
+	ASSERT_EQ(result.failures.size(), 1u);
+	EXPECT_EQ(result.failures[0].path, m_root / "missing");
+	EXPECT_TRUE(result.failures[0].error);
+	EXPECT_TRUE(result.journal.empty());
+}
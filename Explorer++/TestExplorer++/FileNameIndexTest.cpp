@@ -0,0 +1,573 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "pch.h"
+#include "../Helper/FileNameIndex.h"
+#include "../Helper/FileNameIndexWalker.h"
+#include "TemporaryPathTestHelper.h"
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <chrono>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <map>
+#include <regex>
+#include <thread>
+
+using namespace testing;
+
+namespace
+{
+
+std::wstring MakePath(std::initializer_list<std::wstring> components)
+{
+	std::wstring path;
+
+	for (const auto &component : components)
+	{
+		if (!path.empty())
+		{
+			path += static_cast<wchar_t>(std::filesystem::path::preferred_separator);
+		}
+
+		path += component;
+	}
+
+	return path;
+}
+
+FileNameIndexItem MakeFile(const std::wstring &name, uint64_t size = 0,
+	int64_t lastWriteTime = 0, uint32_t attributes = 0)
+{
+	return { name, false, attributes, size, lastWriteTime };
+}
+
+FileNameIndexItem MakeFolder(const std::wstring &name)
+{
+	return { name, true, 0, 0, 0 };
+}
+
+std::vector<std::wstring> GetPaths(const std::vector<FileNameQueryResult> &results)
+{
+	std::vector<std::wstring> paths;
+
+	for (const auto &result : results)
+	{
+		paths.push_back(result.path);
+	}
+
+	return paths;
+}
+
+FileNameQuery MakeQuery(const std::wstring &pattern,
+	FileNameMatchType matchType = FileNameMatchType::Substring)
+{
+	FileNameQuery query;
+	query.pattern = pattern;
+	query.matchType = matchType;
+	return query;
+}
+
+}
+
+class FileNameIndexTest : public Test
+{
+protected:
+	void SetUp() override
+	{
+		FileNameIndexBuilder builder;
+		auto root = builder.AddItem(FileNameIndexBuilder::NO_PARENT, MakeFolder(L"C:"));
+		auto documents = builder.AddItem(root, MakeFolder(L"Documents"));
+		builder.AddItem(documents, MakeFile(L"Report.docx", 2000, 100));
+		builder.AddItem(documents, MakeFile(L"notes.txt", 50, 200, 0x2));
+		auto projects = builder.AddItem(documents, MakeFolder(L"Projects"));
+		builder.AddItem(projects, MakeFile(L"notes.txt", 75, 300));
+		builder.AddItem(projects, MakeFile(L"main.cpp", 4000, 400));
+		auto windows = builder.AddItem(root, MakeFolder(L"Windows"));
+		builder.AddItem(windows, MakeFile(L"explorer.exe", 1'000'000, 500, 0x4));
+
+		m_index = FileNameIndex::Load(builder.Build());
+		ASSERT_NE(m_index, nullptr);
+	}
+
+	std::unique_ptr<FileNameIndex> m_index;
+};
+
+TEST_F(FileNameIndexTest, FindItem)
+{
+	auto id = m_index->FindItem(MakePath({ L"C:", L"Documents", L"Projects", L"main.cpp" }));
+	ASSERT_TRUE(id.has_value());
+	EXPECT_EQ(m_index->GetItem(*id), MakeFile(L"main.cpp", 4000, 400));
+	EXPECT_EQ(m_index->GetItemPath(*id),
+		MakePath({ L"C:", L"Documents", L"Projects", L"main.cpp" }));
+
+	// Lookups are case-insensitive and accept either separator.
+	auto sameId = m_index->FindItem(L"c:/documents\\PROJECTS/Main.CPP");
+	EXPECT_EQ(sameId, id);
+
+	auto folderId = m_index->FindItem(MakePath({ L"C:", L"Windows" }));
+	ASSERT_TRUE(folderId.has_value());
+	EXPECT_EQ(m_index->GetItem(*folderId), MakeFolder(L"Windows"));
+
+	EXPECT_EQ(m_index->FindItem(MakePath({ L"C:", L"Documents", L"missing.txt" })), std::nullopt);
+	EXPECT_EQ(m_index->FindItem(MakePath({ L"D:", L"Documents" })), std::nullopt);
+
+	EXPECT_THAT(m_index->GetRootPaths(), ElementsAre(L"C:"));
+	EXPECT_EQ(m_index->GetNumItems(), 9u);
+}
+
+TEST_F(FileNameIndexTest, ItemsWithTheSameName)
+{
+	auto first = m_index->FindItem(MakePath({ L"C:", L"Documents", L"notes.txt" }));
+	auto second = m_index->FindItem(MakePath({ L"C:", L"Documents", L"Projects", L"notes.txt" }));
+	ASSERT_TRUE(first.has_value());
+	ASSERT_TRUE(second.has_value());
+	EXPECT_NE(*first, *second);
+	EXPECT_EQ(m_index->GetItem(*first).size, 50u);
+	EXPECT_EQ(m_index->GetItem(*second).size, 75u);
+}
+
+TEST_F(FileNameIndexTest, SubstringQuery)
+{
+	EXPECT_THAT(GetPaths(m_index->Query(MakeQuery(L"NOTES"))),
+		ElementsAre(MakePath({ L"C:", L"Documents", L"notes.txt" }),
+			MakePath({ L"C:", L"Documents", L"Projects", L"notes.txt" })));
+
+	auto query = MakeQuery(L"NOTES");
+	query.caseSensitive = true;
+	EXPECT_THAT(m_index->Query(query), IsEmpty());
+
+	query.pattern = L"ort";
+	EXPECT_THAT(GetPaths(m_index->Query(query)),
+		ElementsAre(MakePath({ L"C:", L"Documents", L"Report.docx" })));
+}
+
+TEST_F(FileNameIndexTest, WildcardQuery)
+{
+	EXPECT_THAT(GetPaths(m_index->Query(MakeQuery(L"*.CPP", FileNameMatchType::Wildcard))),
+		ElementsAre(MakePath({ L"C:", L"Documents", L"Projects", L"main.cpp" })));
+
+	EXPECT_THAT(GetPaths(m_index->Query(MakeQuery(L"*.exe: *.docx", FileNameMatchType::Wildcard))),
+		ElementsAre(MakePath({ L"C:", L"Windows", L"explorer.exe" }),
+			MakePath({ L"C:", L"Documents", L"Report.docx" })));
+
+	EXPECT_THAT(GetPaths(m_index->Query(MakeQuery(L"m??n.*", FileNameMatchType::Wildcard))),
+		ElementsAre(MakePath({ L"C:", L"Documents", L"Projects", L"main.cpp" })));
+
+	// Unlike a substring query, a wildcard pattern has to match the whole name.
+	EXPECT_THAT(m_index->Query(MakeQuery(L"main", FileNameMatchType::Wildcard)), IsEmpty());
+}
+
+TEST_F(FileNameIndexTest, RegexQuery)
+{
+	auto query = MakeQuery(L"[a-z]+\\.(cpp|exe)", FileNameMatchType::Regex);
+	EXPECT_THAT(GetPaths(m_index->Query(query)),
+		ElementsAre(MakePath({ L"C:", L"Windows", L"explorer.exe" }),
+			MakePath({ L"C:", L"Documents", L"Projects", L"main.cpp" })));
+
+	EXPECT_THROW(m_index->Query(MakeQuery(L"(", FileNameMatchType::Regex)), std::regex_error);
+}
+
+TEST_F(FileNameIndexTest, EmptyPatternMatchesEverything)
+{
+	EXPECT_EQ(m_index->Query(MakeQuery(L"")).size(), 9u);
+	EXPECT_EQ(m_index->Query(MakeQuery(L"", FileNameMatchType::Wildcard)).size(), 9u);
+	EXPECT_EQ(m_index->Query(MakeQuery(L"", FileNameMatchType::Regex)).size(), 9u);
+}
+
+TEST_F(FileNameIndexTest, Filters)
+{
+	auto query = MakeQuery(L"");
+	query.itemTypes = FileNameItemTypes::Folders;
+	EXPECT_THAT(GetPaths(m_index->Query(query)),
+		ElementsAre(L"C:", MakePath({ L"C:", L"Documents" }),
+			MakePath({ L"C:", L"Documents", L"Projects" }), MakePath({ L"C:", L"Windows" })));
+
+	query = MakeQuery(L"");
+	query.itemTypes = FileNameItemTypes::Files;
+	query.minSize = 1000;
+	query.maxSize = 5000;
+	EXPECT_THAT(GetPaths(m_index->Query(query)),
+		ElementsAre(MakePath({ L"C:", L"Documents", L"Projects", L"main.cpp" }),
+			MakePath({ L"C:", L"Documents", L"Report.docx" })));
+
+	query = MakeQuery(L"");
+	query.modifiedAfter = 200;
+	query.modifiedBefore = 300;
+	EXPECT_THAT(GetPaths(m_index->Query(query)),
+		ElementsAre(MakePath({ L"C:", L"Documents", L"notes.txt" }),
+			MakePath({ L"C:", L"Documents", L"Projects", L"notes.txt" })));
+
+	query = MakeQuery(L"");
+	query.requiredAttributes = 0x4;
+	EXPECT_THAT(GetPaths(m_index->Query(query)),
+		ElementsAre(MakePath({ L"C:", L"Windows", L"explorer.exe" })));
+}
+
+TEST_F(FileNameIndexTest, Scope)
+{
+	auto query = MakeQuery(L"notes");
+	query.scopePath = MakePath({ L"C:", L"Documents", L"Projects" });
+	EXPECT_THAT(GetPaths(m_index->Query(query)),
+		ElementsAre(MakePath({ L"C:", L"Documents", L"Projects", L"notes.txt" })));
+
+	// The scope folder itself isn't included.
+	query = MakeQuery(L"Documents");
+	query.scopePath = MakePath({ L"C:", L"Documents" });
+	EXPECT_THAT(m_index->Query(query), IsEmpty());
+
+	query = MakeQuery(L"");
+	query.scopePath = MakePath({ L"C:", L"Missing" });
+	EXPECT_THAT(m_index->Query(query), IsEmpty());
+}
+
+TEST_F(FileNameIndexTest, MaxResults)
+{
+	auto query = MakeQuery(L"");
+	query.maxResults = 3;
+	EXPECT_THAT(GetPaths(m_index->Query(query)),
+		ElementsAre(L"C:", MakePath({ L"C:", L"Documents" }),
+			MakePath({ L"C:", L"Windows", L"explorer.exe" })));
+}
+
+TEST_F(FileNameIndexTest, AddItems)
+{
+	auto projects = m_index->FindItem(MakePath({ L"C:", L"Documents", L"Projects" }));
+	ASSERT_TRUE(projects.has_value());
+
+	auto folder = m_index->AddItem(*projects, MakeFolder(L"Build"));
+	auto file = m_index->AddItem(folder, MakeFile(L"main.obj", 8000, 600));
+
+	EXPECT_EQ(m_index->FindItem(MakePath({ L"C:", L"Documents", L"Projects", L"Build",
+				  L"main.obj" })),
+		file);
+	EXPECT_THAT(GetPaths(m_index->Query(MakeQuery(L"main"))),
+		ElementsAre(MakePath({ L"C:", L"Documents", L"Projects", L"main.cpp" }),
+			MakePath({ L"C:", L"Documents", L"Projects", L"Build", L"main.obj" })));
+	EXPECT_EQ(m_index->GetNumChanges(), 2u);
+
+	// Adding an item that already exists updates it.
+	auto updatedFile = m_index->AddItem(*projects, MakeFile(L"MAIN.cpp", 5000, 700));
+	EXPECT_EQ(m_index->FindItem(MakePath({ L"C:", L"Documents", L"Projects", L"main.cpp" })),
+		updatedFile);
+	EXPECT_EQ(m_index->GetItem(updatedFile), MakeFile(L"MAIN.cpp", 5000, 700));
+
+	auto query = MakeQuery(L"main.cpp");
+	auto results = m_index->Query(query);
+	ASSERT_EQ(results.size(), 1u);
+	EXPECT_EQ(results[0].item.size, 5000u);
+}
+
+TEST_F(FileNameIndexTest, RemoveItems)
+{
+	auto documents = m_index->FindItem(MakePath({ L"C:", L"Documents" }));
+	ASSERT_TRUE(documents.has_value());
+	m_index->RemoveItem(*documents);
+
+	// Everything within the folder is removed as well.
+	EXPECT_EQ(m_index->FindItem(MakePath({ L"C:", L"Documents" })), std::nullopt);
+	EXPECT_THAT(GetPaths(m_index->Query(MakeQuery(L""))),
+		ElementsAre(L"C:", MakePath({ L"C:", L"Windows", L"explorer.exe" }),
+			MakePath({ L"C:", L"Windows" })));
+
+	// A folder with the same name can then be added again.
+	auto root = m_index->FindItem(L"C:");
+	ASSERT_TRUE(root.has_value());
+	auto newDocuments = m_index->AddItem(*root, MakeFolder(L"Documents"));
+	m_index->AddItem(newDocuments, MakeFile(L"notes.txt", 10, 800));
+	EXPECT_THAT(GetPaths(m_index->Query(MakeQuery(L"notes"))),
+		ElementsAre(MakePath({ L"C:", L"Documents", L"notes.txt" })));
+}
+
+TEST_F(FileNameIndexTest, SerializeWithChanges)
+{
+	auto projects = m_index->FindItem(MakePath({ L"C:", L"Documents", L"Projects" }));
+	ASSERT_TRUE(projects.has_value());
+	m_index->AddItem(*projects, MakeFile(L"util.cpp", 300, 900));
+
+	auto windows = m_index->FindItem(MakePath({ L"C:", L"Windows" }));
+	ASSERT_TRUE(windows.has_value());
+	m_index->RemoveItem(*windows);
+
+	auto reloadedIndex = FileNameIndex::Load(m_index->Serialize());
+	ASSERT_NE(reloadedIndex, nullptr);
+	EXPECT_EQ(reloadedIndex->GetNumChanges(), 0u);
+	EXPECT_EQ(reloadedIndex->GetNumItems(), 8u);
+
+	auto query = MakeQuery(L"");
+	auto expectedResults = m_index->Query(query);
+	auto actualResults = reloadedIndex->Query(query);
+	EXPECT_EQ(GetPaths(actualResults), GetPaths(expectedResults));
+
+	ASSERT_EQ(actualResults.size(), expectedResults.size());
+
+	for (size_t i = 0; i < actualResults.size(); i++)
+	{
+		EXPECT_EQ(actualResults[i].item, expectedResults[i].item);
+	}
+}
+
+TEST(FileNameIndexLoadTest, InvalidData)
+{
+	EXPECT_EQ(FileNameIndex::Load(std::vector<std::byte>()), nullptr);
+	EXPECT_EQ(FileNameIndex::Load(std::vector<std::byte>(256, std::byte{ 0x1 })), nullptr);
+
+	FileNameIndexBuilder builder;
+	auto root = builder.AddItem(FileNameIndexBuilder::NO_PARENT, MakeFolder(L"C:"));
+	builder.AddItem(root, MakeFile(L"file.txt"));
+	auto data = builder.Build();
+
+	// A truncated index should be rejected.
+	data.resize(data.size() - 4);
+	EXPECT_EQ(FileNameIndex::Load(std::move(data)), nullptr);
+}
+
+TEST(FileNameIndexLoadTest, EmptyIndex)
+{
+	auto index = FileNameIndex::Load(FileNameIndexBuilder().Build());
+	ASSERT_NE(index, nullptr);
+	EXPECT_EQ(index->GetNumItems(), 0u);
+	EXPECT_THAT(index->Query(MakeQuery(L"")), IsEmpty());
+	EXPECT_EQ(index->FindItem(L"C:"), std::nullopt);
+}
+
+// Exercises the prefix compression, with many names that share long prefixes, spread across
+// several restart points.
+TEST(FileNameIndexLoadTest, SharedPrefixes)
+{
+	FileNameIndexBuilder builder;
+	auto root = builder.AddItem(FileNameIndexBuilder::NO_PARENT, MakeFolder(L"C:"));
+	std::vector<std::wstring> names;
+
+	for (int i = 0; i < 100; i++)
+	{
+		names.push_back(std::format(L"shared prefix {} {}", 100 + i, std::wstring(i % 7, L'x')));
+		builder.AddItem(root, MakeFile(names.back(), i));
+	}
+
+	auto index = FileNameIndex::Load(builder.Build());
+	ASSERT_NE(index, nullptr);
+
+	for (size_t i = 0; i < names.size(); i++)
+	{
+		auto id = index->FindItem(MakePath({ L"C:", names[i] }));
+		ASSERT_TRUE(id.has_value()) << i;
+		EXPECT_EQ(index->GetItem(*id), MakeFile(names[i], i));
+	}
+
+	auto query = MakeQuery(L"shared prefix 15");
+	EXPECT_EQ(index->Query(query).size(), 10u);
+}
+
+TEST(FileNameIndexLoadTest, ParallelQueryMatchesSerialQuery)
+{
+	FileNameIndexBuilder builder;
+	auto root = builder.AddItem(FileNameIndexBuilder::NO_PARENT, MakeFolder(L"C:"));
+
+	for (int i = 0; i < 100; i++)
+	{
+		auto folder = builder.AddItem(root, MakeFolder(std::format(L"folder {}", i)));
+
+		for (int j = 0; j < 50; j++)
+		{
+			builder.AddItem(folder, MakeFile(std::format(L"file {} {}.txt", j, i % 10)));
+		}
+	}
+
+	auto index = FileNameIndex::Load(builder.Build());
+	ASSERT_NE(index, nullptr);
+
+	auto query = MakeQuery(L"3.txt");
+	query.maxResults = 200;
+	auto serialResults = GetPaths(index->Query(query));
+
+	query.numThreads = 4;
+	auto parallelResults = GetPaths(index->Query(query));
+
+	EXPECT_EQ(serialResults.size(), 200u);
+	EXPECT_EQ(parallelResults, serialResults);
+}
+
+TEST(FileNameIndexWalkerTest, BuildFromReader)
+{
+	std::map<std::wstring, std::vector<FileNameIndexItem>> folders = {
+		{ MakePath({ L"root" }), { MakeFolder(L"a"), MakeFile(L"b.txt", 10) } },
+		{ MakePath({ L"root", L"a" }), { MakeFolder(L"c"), MakeFile(L"d.txt", 20) } },
+		{ MakePath({ L"root", L"a", L"c" }), { MakeFile(L"e.txt", 30) } }
+	};
+
+	auto reader = [&folders](const std::wstring &path, std::vector<FileNameIndexItem> &items)
+	{
+		auto itr = folders.find(path);
+
+		if (itr == folders.end())
+		{
+			return false;
+		}
+
+		items = itr->second;
+		return true;
+	};
+
+	auto data = BuildFileNameIndex({ L"root" }, reader, 2, {});
+	ASSERT_TRUE(data.has_value());
+
+	auto index = FileNameIndex::Load(std::move(*data));
+	ASSERT_NE(index, nullptr);
+	EXPECT_EQ(index->GetNumItems(), 6u);
+
+	auto id = index->FindItem(MakePath({ L"root", L"a", L"c", L"e.txt" }));
+	ASSERT_TRUE(id.has_value());
+	EXPECT_EQ(index->GetItem(*id), MakeFile(L"e.txt", 30));
+}
+
+TEST(FileNameIndexWalkerTest, LinkedFoldersNotWalked)
+{
+	int numReads = 0;
+
+	auto reader = [&numReads](const std::wstring &path, std::vector<FileNameIndexItem> &items)
+	{
+		numReads++;
+
+		if (path == L"root")
+		{
+			auto link = MakeFolder(L"link");
+			link.attributes = FILE_NAME_INDEX_REPARSE_POINT_ATTRIBUTE;
+			items.push_back(link);
+		}
+
+		return true;
+	};
+
+	auto data = BuildFileNameIndex({ L"root" }, reader, 1, {});
+	ASSERT_TRUE(data.has_value());
+	EXPECT_EQ(numReads, 1);
+}
+
+TEST(FileNameIndexWalkerTest, Stop)
+{
+	std::stop_source stopSource;
+
+	auto reader = [&stopSource](const std::wstring &, std::vector<FileNameIndexItem> &items)
+	{
+		stopSource.request_stop();
+		items.push_back(MakeFolder(L"folder"));
+		return true;
+	};
+
+	EXPECT_EQ(BuildFileNameIndex({ L"root" }, reader, 1, stopSource.get_token()), std::nullopt);
+}
+
+TEST(FileNameIndexWalkerTest, ReadFolder)
+{
+	TemporaryTestFolder tempFolder("FileNameIndexTest");
+	const auto &root = tempFolder.GetPath();
+	std::filesystem::create_directories(root / "folder");
+	std::ofstream(root / "folder" / "file.txt") << "contents";
+
+	auto data = BuildFileNameIndex({ root.wstring() }, ReadFolderForIndex, 2, {});
+	ASSERT_TRUE(data.has_value());
+
+	auto index = FileNameIndex::Load(std::move(*data));
+	ASSERT_NE(index, nullptr);
+
+	auto id = index->FindItem((root / "folder" / "file.txt").wstring());
+	ASSERT_TRUE(id.has_value());
+
+	auto item = index->GetItem(*id);
+	EXPECT_EQ(item.name, L"file.txt");
+	EXPECT_FALSE(item.isFolder);
+	EXPECT_EQ(item.size, 8u);
+
+	auto folderId = index->FindItem((root / "folder").wstring());
+	ASSERT_TRUE(folderId.has_value());
+	EXPECT_TRUE(index->GetItem(*folderId).isFolder);
+}
+
+// Builds an index of 2,000,000 items and measures the time taken to build it, serialize it and run
+// a variety of queries over it. The times are recorded as test properties.
+TEST(FileNameIndexBenchmarkTest, DISABLED_TwoMillionItems)
+{
+	constexpr int NUM_TOP_LEVEL_FOLDERS = 100;
+	constexpr int NUM_SECOND_LEVEL_FOLDERS = 100;
+	constexpr int NUM_FILES_PER_FOLDER = 199;
+
+	const std::vector<std::wstring> extensions = { L"txt", L"cpp", L"h", L"png", L"docx" };
+
+	auto start = std::chrono::steady_clock::now();
+
+	FileNameIndexBuilder builder;
+	auto root = builder.AddItem(FileNameIndexBuilder::NO_PARENT, MakeFolder(L"C:"));
+
+	for (int i = 0; i < NUM_TOP_LEVEL_FOLDERS; i++)
+	{
+		auto topLevelFolder = builder.AddItem(root, MakeFolder(std::format(L"Project {}", i)));
+
+		for (int j = 0; j < NUM_SECOND_LEVEL_FOLDERS; j++)
+		{
+			auto folder =
+				builder.AddItem(topLevelFolder, MakeFolder(std::format(L"Module {}", j)));
+
+			for (int k = 0; k < NUM_FILES_PER_FOLDER; k++)
+			{
+				int fileIndex = (((i * NUM_SECOND_LEVEL_FOLDERS) + j) * NUM_FILES_PER_FOLDER) + k;
+				builder.AddItem(folder,
+					MakeFile(std::format(L"source file {}.{}", k,
+								 extensions[fileIndex % extensions.size()]),
+						fileIndex % 100'000, fileIndex));
+			}
+		}
+	}
+
+	auto data = builder.Build();
+	auto built = std::chrono::steady_clock::now();
+
+	auto index = FileNameIndex::Load(std::move(data));
+	ASSERT_NE(index, nullptr);
+	ASSERT_EQ(index->GetNumItems(),
+		1u + NUM_TOP_LEVEL_FOLDERS
+			+ (NUM_TOP_LEVEL_FOLDERS * NUM_SECOND_LEVEL_FOLDERS * (1u + NUM_FILES_PER_FOLDER)));
+
+	testing::Test::RecordProperty("BuildMs",
+		static_cast<int>(
+			std::chrono::duration_cast<std::chrono::milliseconds>(built - start).count()));
+
+	struct QueryCase
+	{
+		std::string name;
+		FileNameQuery query;
+	};
+
+	auto sizeQuery = MakeQuery(L".cpp");
+	sizeQuery.minSize = 99'000;
+
+	auto scopeQuery = MakeQuery(L"file 1");
+	scopeQuery.scopePath = MakePath({ L"C:", L"Project 42" });
+
+	const std::vector<QueryCase> queryCases = { { "Substring", MakeQuery(L"file 123.") },
+		{ "Wildcard", MakeQuery(L"*9.docx", FileNameMatchType::Wildcard) },
+		{ "Regex", MakeQuery(L"source file 1[0-9]\\.png", FileNameMatchType::Regex) },
+		{ "SizeFilter", sizeQuery }, { "Scope", scopeQuery }, { "NoMatch", MakeQuery(L"zzz") } };
+
+	for (auto queryCase : queryCases)
+	{
+		queryCase.query.numThreads =
+			std::max(static_cast<int>(std::thread::hardware_concurrency()), 1);
+
+		auto queryStart = std::chrono::steady_clock::now();
+		auto results = index->Query(queryCase.query);
+		auto queryEnd = std::chrono::steady_clock::now();
+
+		if (queryCase.name != "NoMatch")
+		{
+			EXPECT_FALSE(results.empty()) << queryCase.name;
+		}
+
+		testing::Test::RecordProperty(queryCase.name + "QueryUs",
+			static_cast<int>(
+				std::chrono::duration_cast<std::chrono::microseconds>(queryEnd - queryStart)
+					.count()));
+	}
+}
@@ -0,0 +1,323 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "pch.h"
+#include "../Helper/FolderComparison.h"
+#include "TemporaryPathTestHelper.h"
+#include <gtest/gtest.h>
+#include <chrono>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <map>
+
+using namespace std::chrono_literals;
+
+namespace
+{
+
+const auto BASE_TIME = std::filesystem::file_time_type::clock::now() - 24h;
+
+FolderTreeItem MakeFile(const std::wstring &relativePath, uint64_t size,
+	std::filesystem::file_time_type lastWriteTime = BASE_TIME)
+{
+	return { relativePath, { false, size, lastWriteTime } };
+}
+
+FolderTreeItem MakeFolder(const std::wstring &relativePath)
+{
+	return { relativePath, { true, 0, BASE_TIME } };
+}
+
+std::map<std::wstring, FolderComparisonStatus> GetStatuses(
+	const std::vector<FolderComparisonEntry> &entries)
+{
+	std::map<std::wstring, FolderComparisonStatus> statuses;
+
+	for (const auto &entry : entries)
+	{
+		statuses[std::filesystem::path(entry.relativePath).generic_wstring()] = entry.status;
+	}
+
+	return statuses;
+}
+
+}
+
+class FolderComparisonTest : public testing::Test
+{
+protected:
+	FolderComparisonTest() :
+		m_tempFolder("FolderComparisonTest"),
+		m_root(m_tempFolder.GetPath()),
+		m_left(m_root / "left"),
+		m_right(m_root / "right")
+	{
+		std::filesystem::create_directories(m_left);
+		std::filesystem::create_directories(m_right);
+	}
+
+	void CreateTestFile(const std::filesystem::path &path, const std::string &contents,
+		std::filesystem::file_time_type lastWriteTime = BASE_TIME)
+	{
+		std::filesystem::create_directories(path.parent_path());
+		std::ofstream(path, std::ios::binary).write(contents.data(), contents.size());
+		std::filesystem::last_write_time(path, lastWriteTime);
+	}
+
+	const TemporaryTestFolder m_tempFolder;
+	const std::filesystem::path m_root;
+	const std::filesystem::path m_left;
+	const std::filesystem::path m_right;
+};
+
+TEST(CompareRelativePathsTest, Order)
+{
+	EXPECT_LT(CompareRelativePaths(L"a", L"a/b"), 0);
+	EXPECT_LT(CompareRelativePaths(L"a/b", L"a b"), 0);
+	EXPECT_LT(CompareRelativePaths(L"a\\z", L"a.txt"), 0);
+	EXPECT_LT(CompareRelativePaths(L"abc", L"abd"), 0);
+	EXPECT_GT(CompareRelativePaths(L"b", L"a/z"), 0);
+}
+
+TEST(CompareRelativePathsTest, CaseInsensitive)
+{
+	EXPECT_EQ(CompareRelativePaths(L"Folder/File.TXT", L"folder\\file.txt"), 0);
+}
+
+TEST(CompareFolderListingsTest, Statuses)
+{
+	std::vector<FolderTreeItem> left = { MakeFile(L"identical.txt", 10),
+		MakeFile(L"left-newer.txt", 10, BASE_TIME + 1h), MakeFile(L"left-only.txt", 5),
+		MakeFile(L"right-newer.txt", 10), MakeFile(L"size.txt", 10), MakeFile(L"type", 1),
+		MakeFile(L"within-tolerance.txt", 10, BASE_TIME + 1s) };
+	std::vector<FolderTreeItem> right = { MakeFile(L"identical.txt", 10),
+		MakeFile(L"left-newer.txt", 10), MakeFile(L"right-newer.txt", 10, BASE_TIME + 1h),
+		MakeFile(L"right-only.txt", 5), MakeFile(L"size.txt", 20), MakeFolder(L"type"),
+		MakeFile(L"within-tolerance.txt", 10) };
+
+	auto entries = CompareFolderListings(left, right, {});
+
+	std::map<std::wstring, FolderComparisonStatus> expectedStatuses = {
+		{ L"identical.txt", FolderComparisonStatus::Identical },
+		{ L"left-newer.txt", FolderComparisonStatus::LeftNewer },
+		{ L"left-only.txt", FolderComparisonStatus::LeftOnly },
+		{ L"right-newer.txt", FolderComparisonStatus::RightNewer },
+		{ L"right-only.txt", FolderComparisonStatus::RightOnly },
+		{ L"size.txt", FolderComparisonStatus::SizeDiffers },
+		{ L"type", FolderComparisonStatus::TypeDiffers },
+		{ L"within-tolerance.txt", FolderComparisonStatus::Identical }
+	};
+	EXPECT_EQ(GetStatuses(entries), expectedStatuses);
+
+	ASSERT_EQ(entries.size(), 8u);
+	EXPECT_EQ(entries[2].relativePath, L"left-only.txt");
+	EXPECT_TRUE(entries[2].left.has_value());
+	EXPECT_FALSE(entries[2].right.has_value());
+}
+
+TEST_F(FolderComparisonTest, CompareTrees)
+{
+	CreateTestFile(m_left / "same.txt", "same");
+	CreateTestFile(m_right / "same.txt", "same");
+	CreateTestFile(m_left / "left-only" / "nested" / "file.txt", "left");
+	CreateTestFile(m_right / "right-only.txt", "right");
+	CreateTestFile(m_left / "docs" / "newer.txt", "newer", BASE_TIME + 1h);
+	CreateTestFile(m_right / "docs" / "newer.txt", "older");
+	CreateTestFile(m_left / "type", "file");
+	CreateTestFile(m_right / "type" / "child.txt", "child");
+
+	auto entries = CompareFolders(m_left, m_right, {}, {});
+	ASSERT_TRUE(entries.has_value());
+
+	std::map<std::wstring, FolderComparisonStatus> expectedStatuses = {
+		{ L"docs", FolderComparisonStatus::Identical },
+		{ L"docs/newer.txt", FolderComparisonStatus::LeftNewer },
+		{ L"left-only", FolderComparisonStatus::LeftOnly },
+		{ L"left-only/nested", FolderComparisonStatus::LeftOnly },
+		{ L"left-only/nested/file.txt", FolderComparisonStatus::LeftOnly },
+		{ L"right-only.txt", FolderComparisonStatus::RightOnly },
+		{ L"same.txt", FolderComparisonStatus::Identical },
+		{ L"type", FolderComparisonStatus::TypeDiffers },
+		{ L"type/child.txt", FolderComparisonStatus::RightOnly }
+	};
+	EXPECT_EQ(GetStatuses(*entries), expectedStatuses);
+
+	// The contents of a folder should directly follow it.
+	ASSERT_EQ(entries->size(), 9u);
+	EXPECT_EQ(std::filesystem::path((*entries)[7].relativePath).generic_wstring(), L"type");
+	EXPECT_EQ(std::filesystem::path((*entries)[8].relativePath).generic_wstring(),
+		L"type/child.txt");
+}
+
+TEST_F(FolderComparisonTest, MissingRoot)
+{
+	EXPECT_FALSE(CompareFolders(m_left, m_root / "missing", {}, {}).has_value());
+}
+
+TEST_F(FolderComparisonTest, CompareContents)
+{
+	// Same size and timestamp, but different content.
+	CreateTestFile(m_left / "modified.txt", "abc");
+	CreateTestFile(m_right / "modified.txt", "xyz");
+
+	// Same content, but different timestamps.
+	CreateTestFile(m_left / "touched.txt", "same", BASE_TIME + 1h);
+	CreateTestFile(m_right / "touched.txt", "same");
+
+	// Different content and timestamps.
+	CreateTestFile(m_left / "edited.txt", "1234", BASE_TIME + 1h);
+	CreateTestFile(m_right / "edited.txt", "5678");
+
+	auto entries = CompareFolders(m_left, m_right, {}, {});
+	ASSERT_TRUE(entries.has_value());
+
+	std::map<std::wstring, FolderComparisonStatus> expectedStatuses = {
+		{ L"edited.txt", FolderComparisonStatus::LeftNewer },
+		{ L"modified.txt", FolderComparisonStatus::Identical },
+		{ L"touched.txt", FolderComparisonStatus::LeftNewer }
+	};
+	EXPECT_EQ(GetStatuses(*entries), expectedStatuses);
+
+	FolderComparisonOptions options;
+	options.contentHashAlgorithm = HashAlgorithm::XxHash64;
+	options.numThreads = 2;
+	entries = CompareFolders(m_left, m_right, options, {});
+	ASSERT_TRUE(entries.has_value());
+
+	expectedStatuses = { { L"edited.txt", FolderComparisonStatus::LeftNewer },
+		{ L"modified.txt", FolderComparisonStatus::ContentDiffers },
+		{ L"touched.txt", FolderComparisonStatus::Identical } };
+	EXPECT_EQ(GetStatuses(*entries), expectedStatuses);
+}
+
+class SyncPlanTest : public testing::Test
+{
+protected:
+	SyncPlanTest()
+	{
+		std::vector<FolderTreeItem> left = { MakeFile(L"changed.txt", 10, BASE_TIME + 1h),
+			MakeFolder(L"left-folder"), MakeFile(L"left-folder/a.txt", 1),
+			MakeFile(L"left-folder/b.txt", 1), MakeFile(L"left.txt", 1),
+			MakeFile(L"older.txt", 10), MakeFile(L"same.txt", 1), MakeFile(L"size.txt", 1),
+			MakeFolder(L"type"), MakeFile(L"type/child.txt", 1) };
+		std::vector<FolderTreeItem> right = { MakeFile(L"changed.txt", 10),
+			MakeFile(L"older.txt", 10, BASE_TIME + 1h), MakeFolder(L"right-folder"),
+			MakeFile(L"right-folder/c.txt", 1), MakeFile(L"same.txt", 1),
+			MakeFile(L"size.txt", 2), MakeFile(L"type", 1) };
+		m_entries = CompareFolderListings(left, right, {});
+	}
+
+	std::vector<FolderComparisonEntry> m_entries;
+};
+
+TEST_F(SyncPlanTest, LeftToRight)
+{
+	auto plan = BuildSyncPlan(m_entries, { SyncDirection::LeftToRight, false });
+
+	std::vector<SyncAction> expectedPlan = {
+		{ SyncActionType::Delete, L"type", false, SyncSide::Right },
+		{ SyncActionType::Copy, L"changed.txt", false, SyncSide::Left },
+		{ SyncActionType::Copy, L"left-folder", true, SyncSide::Left },
+		{ SyncActionType::Copy, L"left.txt", false, SyncSide::Left },
+		{ SyncActionType::Copy, L"older.txt", false, SyncSide::Left },
+		{ SyncActionType::Copy, L"size.txt", false, SyncSide::Left },
+		{ SyncActionType::Copy, L"type", true, SyncSide::Left }
+	};
+	EXPECT_EQ(plan, expectedPlan);
+}
+
+TEST_F(SyncPlanTest, Mirror)
+{
+	auto plan = BuildSyncPlan(m_entries, { SyncDirection::RightToLeft, true });
+
+	std::vector<SyncAction> expectedPlan = {
+		{ SyncActionType::Delete, L"left-folder", true, SyncSide::Left },
+		{ SyncActionType::Delete, L"left.txt", false, SyncSide::Left },
+		{ SyncActionType::Delete, L"type", true, SyncSide::Left },
+		{ SyncActionType::Copy, L"changed.txt", false, SyncSide::Right },
+		{ SyncActionType::Copy, L"older.txt", false, SyncSide::Right },
+		{ SyncActionType::Copy, L"right-folder", true, SyncSide::Right },
+		{ SyncActionType::Copy, L"size.txt", false, SyncSide::Right },
+		{ SyncActionType::Copy, L"type", false, SyncSide::Right }
+	};
+	EXPECT_EQ(plan, expectedPlan);
+}
+
+TEST_F(SyncPlanTest, TwoWay)
+{
+	auto plan = BuildSyncPlan(m_entries, { SyncDirection::TwoWay, true });
+
+	std::vector<SyncAction> expectedPlan = {
+		{ SyncActionType::Copy, L"changed.txt", false, SyncSide::Left },
+		{ SyncActionType::Copy, L"left-folder", true, SyncSide::Left },
+		{ SyncActionType::Copy, L"left.txt", false, SyncSide::Left },
+		{ SyncActionType::Copy, L"older.txt", false, SyncSide::Right },
+		{ SyncActionType::Copy, L"right-folder", true, SyncSide::Right },
+		{ SyncActionType::Conflict, L"size.txt", false, {} },
+		{ SyncActionType::Conflict, L"type", true, {} }
+	};
+	EXPECT_EQ(plan, expectedPlan);
+}
+
+TEST_F(SyncPlanTest, IdenticalTreesNeedNoActions)
+{
+	std::vector<FolderTreeItem> items = { MakeFolder(L"a"), MakeFile(L"a/b.txt", 1) };
+	auto entries = CompareFolderListings(items, items, {});
+
+	EXPECT_TRUE(BuildSyncPlan(entries, { SyncDirection::TwoWay, false }).empty());
+	EXPECT_TRUE(BuildSyncPlan(entries, { SyncDirection::LeftToRight, true }).empty());
+}
+
+TEST(FormatSyncPlanTest, Format)
+{
+	std::vector<SyncAction> plan = { { SyncActionType::Delete, L"build", true, SyncSide::Right },
+		{ SyncActionType::Copy, L"readme.txt", false, SyncSide::Left },
+		{ SyncActionType::Conflict, L"notes.txt", false, {} } };
+
+	std::wstring folderPath = L"build";
+	folderPath += static_cast<wchar_t>(std::filesystem::path::preferred_separator);
+	std::wstring expected = L"delete    " + folderPath + L"        right\n"
+		+ L"copy      readme.txt    left -> right\n" + L"conflict  notes.txt\n";
+	EXPECT_EQ(FormatSyncPlan(plan), expected);
+}
+
+// Measures how long it takes to compare two listings of 1,000,000 entries each and build a sync
+// plan from the result. One in every ten files differs.
+TEST(FolderComparisonBenchmark, DISABLED_CompareOneMillionEntries)
+{
+	constexpr int NUM_FOLDERS = 1000;
+	constexpr int NUM_FILES_PER_FOLDER = 999;
+
+	std::vector<FolderTreeItem> left;
+	std::vector<FolderTreeItem> right;
+
+	for (int i = 0; i < NUM_FOLDERS; i++)
+	{
+		auto folder = std::format(L"folder{:04}", i);
+		left.push_back(MakeFolder(folder));
+		right.push_back(MakeFolder(folder));
+
+		for (int j = 0; j < NUM_FILES_PER_FOLDER; j++)
+		{
+			auto path = std::format(L"{}/file{:04}.dat", folder, j);
+			left.push_back(MakeFile(path, 1000));
+			right.push_back(MakeFile(path, (j % 10 == 0) ? 2000 : 1000,
+				(j % 10 == 0) ? BASE_TIME + 1h : BASE_TIME));
+		}
+	}
+
+	ASSERT_EQ(left.size(), 1'000'000u);
+
+	auto start = std::chrono::steady_clock::now();
+	auto entries = CompareFolderListings(std::move(left), std::move(right), {});
+	auto plan = BuildSyncPlan(entries, { SyncDirection::TwoWay, false });
+	auto elapsed = std::chrono::steady_clock::now() - start;
+
+	EXPECT_EQ(entries.size(), 1'000'000u);
+	EXPECT_EQ(plan.size(), 100'000u);
+
+	testing::Test::RecordProperty("ElapsedMs",
+		static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count()));
+}
@@ -0,0 +1,88 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "pch.h"
+#include "FolderModelWorkload.h"
+#include "ShellBrowser/FolderModel.h"
+#include <gtest/gtest.h>
+#include <cctype>
+
+using namespace testing;
+
+namespace
+{
+
+void RecordLatencies(const FolderModelReplayResult &result)
+{
+	for (const auto &[type, summary] : result)
+	{
+		auto name = FolderModelReplayer::GetOperationTypeName(type);
+		name[0] = static_cast<char>(std::toupper(static_cast<unsigned char>(name[0])));
+
+		Test::RecordProperty(name + "Count", static_cast<int>(summary.count));
+		Test::RecordProperty(name + "P50Us", static_cast<int>(summary.p50.count()));
+		Test::RecordProperty(name + "P90Us", static_cast<int>(summary.p90.count()));
+		Test::RecordProperty(name + "P99Us", static_cast<int>(summary.p99.count()));
+		Test::RecordProperty(name + "MaxUs", static_cast<int>(summary.max.count()));
+	}
+}
+
+}
+
+// These tests replay synthetic workloads against a FolderModel, recording the latency
+// distribution for each type of operation. The workloads are sized to reflect very large folders.
+TEST(FolderModelBenchmarkTest, DISABLED_MillionItemEnumeration)
+{
+	FolderModel model;
+	FolderModelReplayer replayer(&model);
+	auto result = replayer.Replay(GenerateEnumerationWorkload(1'000'000));
+
+	EXPECT_EQ(model.GetNumItems(), 1'000'000u);
+	RecordLatencies(result);
+}
+
+TEST(FolderModelBenchmarkTest, DISABLED_ChangeStorm)
+{
+	FolderModel model;
+	FolderModelReplayer replayer(&model);
+	auto result = replayer.Replay(GenerateChangeStormWorkload(1'000'000, 20'000, 1));
+
+	EXPECT_EQ(model.CreateSnapshot().items.size(), model.GetNumItems());
+	RecordLatencies(result);
+}
+
+TEST(FolderModelBenchmarkTest, DISABLED_RapidSortToggles)
+{
+	FolderModel model;
+	FolderModelReplayer replayer(&model);
+	auto result = replayer.Replay(GenerateSortToggleWorkload(1'000'000, 30));
+
+	EXPECT_EQ(model.GetNumItems(), 1'000'000u);
+	RecordLatencies(result);
+}
+
+// Checks that a workload survives being recorded and parsed back in, then replays the recorded
+// copy.
+TEST(FolderModelBenchmarkTest, DISABLED_RecordedWorkload)
+{
+	auto workload = GenerateChangeStormWorkload(100'000, 10'000, 2);
+
+	auto parsedWorkload = ParseFolderModelWorkload(SerializeFolderModelWorkload(workload));
+	ASSERT_TRUE(parsedWorkload.has_value());
+
+	FolderModel model;
+	FolderModelReplayer replayer(&model);
+	auto result = replayer.Replay(*parsedWorkload);
+
+	FolderModel referenceModel;
+	FolderModelReplayer referenceReplayer(&referenceModel);
+	referenceReplayer.Replay(workload);
+
+	auto snapshot = model.CreateSnapshot();
+	auto referenceSnapshot = referenceModel.CreateSnapshot();
+	EXPECT_EQ(snapshot.items, referenceSnapshot.items);
+	EXPECT_EQ(snapshot.selectedItems, referenceSnapshot.selectedItems);
+
+	RecordLatencies(result);
+}
@@ -0,0 +1,400 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "pch.h"
+#include "ShellBrowser/FolderModel.h"
+#include "FolderModelWorkload.h"
+#include <gtest/gtest.h>
+#include <format>
+#include <random>
+
+using namespace testing;
+
+namespace
+{
+
+FolderModel::ItemData MakeItemData(const std::wstring &name, uint64_t size)
+{
+	FolderModel::ItemData itemData;
+	itemData.parsingName = name;
+	itemData.displayName = name;
+	itemData.editingName = name;
+	itemData.size = size;
+	return itemData;
+}
+
+int CompareByName(const FolderModel::ItemView &item1, const FolderModel::ItemView &item2)
+{
+	return item1.GetDisplayName().compare(item2.GetDisplayName());
+}
+
+int CompareBySize(const FolderModel::ItemView &item1, const FolderModel::ItemView &item2)
+{
+	return (item1.GetSize() < item2.GetSize()) ? -1 : ((item1.GetSize() > item2.GetSize()) ? 1 : 0);
+}
+
+std::vector<std::wstring> GetNames(const FolderModel &model)
+{
+	std::vector<std::wstring> names;
+
+	for (size_t i = 0; i < model.GetNumItems(); i++)
+	{
+		names.emplace_back(model.GetItem(model.GetItemAtIndex(i)).GetDisplayName());
+	}
+
+	return names;
+}
+
+}
+
+class FolderModelTest : public Test
+{
+protected:
+	FolderModelTest()
+	{
+		m_model.SetSort(CompareByName, false);
+	}
+
+	FolderModel::ItemId AddItem(const std::wstring &name, uint64_t size = 0)
+	{
+		return m_model.InsertItem(MakeItemData(name, size));
+	}
+
+	FolderModel m_model;
+};
+
+TEST_F(FolderModelTest, InsertItem)
+{
+	std::vector<std::pair<size_t, FolderModel::ItemId>> insertions;
+	m_model.AddItemInsertedObserver([&insertions](size_t index, FolderModel::ItemId id)
+		{ insertions.emplace_back(index, id); });
+
+	auto idB = AddItem(L"b");
+	auto idA = AddItem(L"a");
+	auto idC = AddItem(L"c");
+
+	EXPECT_EQ(GetNames(m_model), (std::vector<std::wstring>{ L"a", L"b", L"c" }));
+	EXPECT_EQ(insertions,
+		(std::vector<std::pair<size_t, FolderModel::ItemId>>{
+			{ 0, idB }, { 0, idA }, { 2, idC } }));
+
+	EXPECT_EQ(m_model.GetNumItems(), 3u);
+	EXPECT_EQ(m_model.GetItemIndex(idA), 0u);
+	EXPECT_EQ(m_model.GetItemIndex(idB), 1u);
+	EXPECT_EQ(m_model.GetItemIndex(idC), 2u);
+}
+
+TEST_F(FolderModelTest, InsertItems)
+{
+	AddItem(L"m");
+
+	int numResets = 0;
+	m_model.AddOrderResetObserver([&numResets]() { numResets++; });
+
+	std::vector<std::wstring> names = { L"z", L"a", L"q", L"b" };
+	std::vector<FolderModel::ItemData> items;
+
+	for (const auto &name : names)
+	{
+		items.push_back(MakeItemData(name, 0));
+	}
+
+	auto ids = m_model.InsertItems(items);
+	ASSERT_EQ(ids.size(), names.size());
+	EXPECT_EQ(m_model.GetItem(ids[0]).GetDisplayName(), L"z");
+
+	EXPECT_EQ(GetNames(m_model), (std::vector<std::wstring>{ L"a", L"b", L"m", L"q", L"z" }));
+	EXPECT_EQ(numResets, 1);
+}
+
+TEST_F(FolderModelTest, RemoveItem)
+{
+	AddItem(L"a");
+	auto idB = AddItem(L"b");
+	AddItem(L"c");
+
+	m_model.SelectItem(idB, true);
+
+	std::vector<std::pair<size_t, FolderModel::ItemId>> removals;
+	m_model.AddItemRemovedObserver([&removals](size_t index, FolderModel::ItemId id)
+		{ removals.emplace_back(index, id); });
+
+	m_model.RemoveItem(idB);
+
+	EXPECT_EQ(GetNames(m_model), (std::vector<std::wstring>{ L"a", L"c" }));
+	EXPECT_EQ(removals, (std::vector<std::pair<size_t, FolderModel::ItemId>>{ { 1, idB } }));
+	EXPECT_FALSE(m_model.HasItem(idB));
+	EXPECT_EQ(m_model.GetNumSelectedItems(), 0u);
+}
+
+TEST_F(FolderModelTest, RemoveItems)
+{
+	auto idA = AddItem(L"a");
+	AddItem(L"b");
+	auto idC = AddItem(L"c");
+	AddItem(L"d");
+
+	m_model.SelectAll();
+
+	std::vector<FolderModel::ItemId> idsToRemove = { idC, idA };
+	m_model.RemoveItems(idsToRemove);
+
+	EXPECT_EQ(GetNames(m_model), (std::vector<std::wstring>{ L"b", L"d" }));
+	EXPECT_EQ(m_model.GetNumItems(), 2u);
+	EXPECT_EQ(m_model.GetNumSelectedItems(), 2u);
+}
+
+TEST_F(FolderModelTest, UpdateItem)
+{
+	m_model.SetSort(CompareBySize, false);
+
+	auto idA = AddItem(L"a", 10);
+	auto idB = AddItem(L"b", 20);
+	AddItem(L"c", 30);
+
+	std::vector<std::string> events;
+	m_model.AddItemUpdatedObserver([&events](size_t index, FolderModel::ItemId id)
+		{ events.push_back(std::format("updated {} {}", index, id)); });
+	m_model.AddItemRemovedObserver([&events](size_t index, FolderModel::ItemId id)
+		{ events.push_back(std::format("removed {} {}", index, id)); });
+	m_model.AddItemInsertedObserver([&events](size_t index, FolderModel::ItemId id)
+		{ events.push_back(std::format("inserted {} {}", index, id)); });
+
+	// The item's position doesn't change here.
+	m_model.UpdateItem(idB, MakeItemData(L"b", 25));
+	EXPECT_EQ(events, (std::vector<std::string>{ std::format("updated 1 {}", idB) }));
+
+	events.clear();
+
+	// Here, the item will move to the end.
+	m_model.UpdateItem(idA, MakeItemData(L"a", 40));
+	EXPECT_EQ(events,
+		(std::vector<std::string>{ std::format("removed 0 {}", idA),
+			std::format("inserted 2 {}", idA) }));
+	EXPECT_EQ(GetNames(m_model), (std::vector<std::wstring>{ L"b", L"c", L"a" }));
+}
+
+TEST_F(FolderModelTest, RenameItem)
+{
+	auto idA = AddItem(L"a", 123);
+	AddItem(L"b");
+	AddItem(L"c");
+
+	m_model.RenameItem(idA, L"d", L"d", L"d");
+
+	EXPECT_EQ(GetNames(m_model), (std::vector<std::wstring>{ L"b", L"c", L"d" }));
+
+	auto item = m_model.GetItem(idA);
+	EXPECT_EQ(item.GetParsingName(), L"d");
+	EXPECT_EQ(item.GetSize(), 123u);
+}
+
+TEST_F(FolderModelTest, SortDirection)
+{
+	m_model.SetSort(CompareBySize, false);
+
+	// Items with the same size are ordered by ID, so that the order is always well-defined.
+	for (int i = 0; i < 20; i++)
+	{
+		AddItem(std::format(L"{}", i), i % 4);
+	}
+
+	m_model.SetSortDescending(true);
+	auto reversedNames = GetNames(m_model);
+
+	m_model.SetSort(CompareBySize, true);
+	EXPECT_EQ(GetNames(m_model), reversedNames);
+
+	m_model.SetSortDescending(false);
+	auto names = GetNames(m_model);
+	std::reverse(names.begin(), names.end());
+	EXPECT_EQ(names, reversedNames);
+}
+
+TEST_F(FolderModelTest, Selection)
+{
+	auto idC = AddItem(L"c");
+	auto idA = AddItem(L"a");
+	auto idB = AddItem(L"b");
+
+	int numSelectionChanges = 0;
+	m_model.AddSelectionChangedObserver([&numSelectionChanges]() { numSelectionChanges++; });
+
+	m_model.SelectItem(idC, true);
+	m_model.SelectItem(idA, true);
+
+	// Selecting an item that's already selected shouldn't have any effect.
+	m_model.SelectItem(idA, true);
+
+	EXPECT_EQ(numSelectionChanges, 2);
+	EXPECT_TRUE(m_model.IsSelected(idA));
+	EXPECT_FALSE(m_model.IsSelected(idB));
+	EXPECT_EQ(m_model.GetSelectedItems(), (std::vector<FolderModel::ItemId>{ idA, idC }));
+
+	m_model.SelectAll();
+	EXPECT_EQ(m_model.GetNumSelectedItems(), 3u);
+
+	m_model.ClearSelection();
+	EXPECT_EQ(m_model.GetNumSelectedItems(), 0u);
+	EXPECT_TRUE(m_model.GetSelectedItems().empty());
+	EXPECT_EQ(numSelectionChanges, 4);
+}
+
+TEST_F(FolderModelTest, Snapshot)
+{
+	auto idB = AddItem(L"b");
+	auto idA = AddItem(L"a");
+	m_model.SelectItem(idB, true);
+
+	auto snapshot = m_model.CreateSnapshot();
+
+	// The snapshot should be independent of subsequent changes.
+	AddItem(L"c");
+	m_model.RemoveItem(idA);
+
+	EXPECT_EQ(snapshot.items, (std::vector<FolderModel::ItemId>{ idA, idB }));
+	EXPECT_EQ(snapshot.selectedItems, (std::vector<FolderModel::ItemId>{ idB }));
+}
+
+TEST_F(FolderModelTest, Clear)
+{
+	auto id = AddItem(L"a");
+	m_model.SelectItem(id, true);
+
+	m_model.Clear();
+
+	EXPECT_EQ(m_model.GetNumItems(), 0u);
+	EXPECT_EQ(m_model.GetNumSelectedItems(), 0u);
+
+	AddItem(L"b");
+	EXPECT_EQ(GetNames(m_model), (std::vector<std::wstring>{ L"b" }));
+}
+
+// Applies a random sequence of operations, checking after each one that the model's order matches
+// an order calculated from scratch.
+TEST_F(FolderModelTest, RandomOperations)
+{
+	std::mt19937 generator(1);
+	std::vector<FolderModel::ItemId> liveIds;
+
+	auto verifyOrder = [this]()
+	{
+		std::vector<FolderModel::ItemId> expectedOrder;
+
+		for (size_t i = 0; i < m_model.GetNumItems(); i++)
+		{
+			expectedOrder.push_back(m_model.GetItemAtIndex(i));
+		}
+
+		auto actualOrder = expectedOrder;
+		std::sort(expectedOrder.begin(), expectedOrder.end(),
+			[this](FolderModel::ItemId id1, FolderModel::ItemId id2)
+			{
+				auto item1 = m_model.GetItem(id1);
+				auto item2 = m_model.GetItem(id2);
+
+				if (item1.GetSize() != item2.GetSize())
+				{
+					return item1.GetSize() > item2.GetSize();
+				}
+
+				return id1 > id2;
+			});
+
+		ASSERT_EQ(actualOrder, expectedOrder);
+
+		for (size_t i = 0; i < actualOrder.size(); i++)
+		{
+			ASSERT_EQ(m_model.GetItemIndex(actualOrder[i]), i);
+		}
+	};
+
+	m_model.SetSort(CompareBySize, true);
+
+	const wchar_t *extensions[] = { L"txt", L"png", L"cpp" };
+
+	for (int i = 0; i < 2000; i++)
+	{
+		auto operation = liveIds.empty() ? 0 : generator() % 5;
+
+		if (operation <= 1)
+		{
+			liveIds.push_back(AddItem(
+				std::format(L"{}.{}", i, extensions[generator() % std::size(extensions)]),
+				generator() % 50));
+		}
+		else
+		{
+			size_t index = generator() % liveIds.size();
+			auto id = liveIds[index];
+
+			if (operation == 2)
+			{
+				m_model.RemoveItem(id);
+				liveIds.erase(liveIds.begin() + index);
+			}
+			else if (operation == 3)
+			{
+				auto name =
+					std::format(L"{}.{}", i, extensions[generator() % std::size(extensions)]);
+				m_model.RenameItem(id, name, name, name);
+			}
+			else
+			{
+				std::wstring name(m_model.GetItem(id).GetDisplayName());
+				m_model.UpdateItem(id, MakeItemData(name, generator() % 50));
+			}
+		}
+
+		verifyOrder();
+	}
+}
+
+TEST(FolderModelWorkloadTest, SerializeAndParse)
+{
+	auto workload = GenerateChangeStormWorkload(100, 500, 1);
+	workload.push_back({ .type = FolderModelOperationType::Insert, .name = L"café", .value = 1 });
+	workload.push_back({ .type = FolderModelOperationType::SetSortDirection, .descending = true });
+	workload.push_back({ .type = FolderModelOperationType::ClearSelection });
+
+	auto text = SerializeFolderModelWorkload(workload);
+	auto parsedWorkload = ParseFolderModelWorkload(text);
+	ASSERT_TRUE(parsedWorkload.has_value());
+	EXPECT_EQ(*parsedWorkload, workload);
+}
+
+TEST(FolderModelWorkloadTest, ParseRecordedWorkload)
+{
+	std::string text = "# A recorded workload\r\n"
+					   "sort\tname\tasc\r\n"
+					   "populate\t10\r\n"
+					   "insert\tnew file.txt\t100\r\n"
+					   "rename\tfile 1.cpp\trenamed.cpp\r\n"
+					   "remove\tfile 2.h\r\n"
+					   "\r\n"
+					   "select\trenamed.cpp\r\n"
+					   "snapshot\r\n";
+
+	auto workload = ParseFolderModelWorkload(text);
+	ASSERT_TRUE(workload.has_value());
+	ASSERT_EQ(workload->size(), 7u);
+
+	FolderModel model;
+	FolderModelReplayer replayer(&model);
+	auto result = replayer.Replay(*workload);
+
+	EXPECT_EQ(model.GetNumItems(), 10u);
+	EXPECT_EQ(model.GetNumSelectedItems(), 1u);
+	EXPECT_EQ(result[FolderModelOperationType::Populate].count, 1u);
+	EXPECT_EQ(model.GetItem(model.GetItemAtIndex(0)).GetDisplayName(), L"file 0.txt");
+	EXPECT_EQ(model.GetItem(model.GetItemAtIndex(9)).GetDisplayName(), L"renamed.cpp");
+}
+
+TEST(FolderModelWorkloadTest, ParseInvalidWorkload)
+{
+	EXPECT_EQ(ParseFolderModelWorkload("unknown\n"), std::nullopt);
+	EXPECT_EQ(ParseFolderModelWorkload("populate\tabc\n"), std::nullopt);
+	EXPECT_EQ(ParseFolderModelWorkload("sort\tname\n"), std::nullopt);
+	EXPECT_EQ(ParseFolderModelWorkload("direction\tup\n"), std::nullopt);
+}
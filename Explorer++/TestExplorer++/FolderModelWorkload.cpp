@@ -0,0 +1,649 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "pch.h"
+#include "FolderModelWorkload.h"
+#include "../Helper/TextEncoding.h"
+#include <algorithm>
+#include <charconv>
+#include <random>
+#include <sstream>
+
+namespace
+{
+
+constexpr const wchar_t *GENERATED_EXTENSIONS[] = { L"txt", L"cpp", L"h", L"png", L"docx", L"zip" };
+
+struct OperationTypeName
+{
+	FolderModelOperationType type;
+	const char *name;
+};
+
+constexpr OperationTypeName OPERATION_TYPE_NAMES[] = {
+	{ FolderModelOperationType::Populate, "populate" },
+	{ FolderModelOperationType::Insert, "insert" },
+	{ FolderModelOperationType::Remove, "remove" },
+	{ FolderModelOperationType::Rename, "rename" },
+	{ FolderModelOperationType::Update, "update" },
+	{ FolderModelOperationType::Sort, "sort" },
+	{ FolderModelOperationType::SetSortDirection, "direction" },
+	{ FolderModelOperationType::Select, "select" },
+	{ FolderModelOperationType::SelectAll, "selectall" },
+	{ FolderModelOperationType::ClearSelection, "clearselection" },
+	{ FolderModelOperationType::Snapshot, "snapshot" }
+};
+
+std::wstring GetGeneratedItemName(uint64_t index)
+{
+	return L"file " + std::to_wstring(index) + L"."
+		+ GENERATED_EXTENSIONS[index % std::size(GENERATED_EXTENSIONS)];
+}
+
+uint64_t GetGeneratedItemSize(uint64_t index)
+{
+	return (index * 7919) % 1'000'000;
+}
+
+std::string EncodeName(const std::wstring &name)
+{
+	auto encoded = EncodeText(name, TextEncoding::Utf8);
+	return { reinterpret_cast<const char *>(encoded.data()), encoded.size() };
+}
+
+const char *GetSortKeyName(FolderModelSortKey sortKey)
+{
+	switch (sortKey)
+	{
+	case FolderModelSortKey::Name:
+		return "name";
+
+	case FolderModelSortKey::Size:
+		return "size";
+
+	case FolderModelSortKey::Modified:
+		return "modified";
+	}
+
+	LOG(FATAL) << "Unknown sort key";
+	return "";
+}
+
+const char *GetDirectionName(bool descending)
+{
+	return descending ? "desc" : "asc";
+}
+
+std::vector<std::string> SplitFields(const std::string &line)
+{
+	std::vector<std::string> fields;
+	size_t start = 0;
+
+	while (true)
+	{
+		auto end = line.find('\t', start);
+
+		if (end == std::string::npos)
+		{
+			fields.push_back(line.substr(start));
+			break;
+		}
+
+		fields.push_back(line.substr(start, end - start));
+		start = end + 1;
+	}
+
+	return fields;
+}
+
+std::optional<uint64_t> ParseNumber(const std::string &field)
+{
+	uint64_t value;
+	auto [ptr, ec] = std::from_chars(field.data(), field.data() + field.size(), value);
+
+	if (ec != std::errc() || ptr != field.data() + field.size())
+	{
+		return std::nullopt;
+	}
+
+	return value;
+}
+
+std::optional<bool> ParseDirection(const std::string &field)
+{
+	if (field == "asc")
+	{
+		return false;
+	}
+	else if (field == "desc")
+	{
+		return true;
+	}
+
+	return std::nullopt;
+}
+
+std::optional<FolderModelOperation> ParseOperation(const std::string &line)
+{
+	auto fields = SplitFields(line);
+
+	auto itr = std::find_if(std::begin(OPERATION_TYPE_NAMES), std::end(OPERATION_TYPE_NAMES),
+		[&fields](const OperationTypeName &typeName) { return fields[0] == typeName.name; });
+
+	if (itr == std::end(OPERATION_TYPE_NAMES))
+	{
+		return std::nullopt;
+	}
+
+	FolderModelOperation operation;
+	operation.type = itr->type;
+
+	switch (operation.type)
+	{
+	case FolderModelOperationType::Populate:
+	{
+		if (fields.size() != 2)
+		{
+			return std::nullopt;
+		}
+
+		auto count = ParseNumber(fields[1]);
+
+		if (!count)
+		{
+			return std::nullopt;
+		}
+
+		operation.value = *count;
+	}
+	break;
+
+	case FolderModelOperationType::Insert:
+	case FolderModelOperationType::Update:
+	{
+		if (fields.size() != 3)
+		{
+			return std::nullopt;
+		}
+
+		auto size = ParseNumber(fields[2]);
+
+		if (!size)
+		{
+			return std::nullopt;
+		}
+
+		operation.name = DecodeUtf8(fields[1]);
+		operation.value = *size;
+	}
+	break;
+
+	case FolderModelOperationType::Remove:
+	case FolderModelOperationType::Select:
+		if (fields.size() != 2)
+		{
+			return std::nullopt;
+		}
+
+		operation.name = DecodeUtf8(fields[1]);
+		break;
+
+	case FolderModelOperationType::Rename:
+		if (fields.size() != 3)
+		{
+			return std::nullopt;
+		}
+
+		operation.name = DecodeUtf8(fields[1]);
+		operation.newName = DecodeUtf8(fields[2]);
+		break;
+
+	case FolderModelOperationType::Sort:
+	{
+		if (fields.size() != 3)
+		{
+			return std::nullopt;
+		}
+
+		if (fields[1] == "name")
+		{
+			operation.sortKey = FolderModelSortKey::Name;
+		}
+		else if (fields[1] == "size")
+		{
+			operation.sortKey = FolderModelSortKey::Size;
+		}
+		else if (fields[1] == "modified")
+		{
+			operation.sortKey = FolderModelSortKey::Modified;
+		}
+		else
+		{
+			return std::nullopt;
+		}
+
+		auto descending = ParseDirection(fields[2]);
+
+		if (!descending)
+		{
+			return std::nullopt;
+		}
+
+		operation.descending = *descending;
+	}
+	break;
+
+	case FolderModelOperationType::SetSortDirection:
+	{
+		if (fields.size() != 2)
+		{
+			return std::nullopt;
+		}
+
+		auto descending = ParseDirection(fields[1]);
+
+		if (!descending)
+		{
+			return std::nullopt;
+		}
+
+		operation.descending = *descending;
+	}
+	break;
+
+	case FolderModelOperationType::SelectAll:
+	case FolderModelOperationType::ClearSelection:
+	case FolderModelOperationType::Snapshot:
+		if (fields.size() != 1)
+		{
+			return std::nullopt;
+		}
+		break;
+	}
+
+	return operation;
+}
+
+FolderModel::Comparator GetComparator(FolderModelSortKey sortKey)
+{
+	switch (sortKey)
+	{
+	case FolderModelSortKey::Name:
+		return [](const FolderModel::ItemView &item1, const FolderModel::ItemView &item2)
+		{ return item1.GetDisplayName().compare(item2.GetDisplayName()); };
+
+	case FolderModelSortKey::Size:
+		return [](const FolderModel::ItemView &item1, const FolderModel::ItemView &item2)
+		{
+			auto size1 = item1.GetSize();
+			auto size2 = item2.GetSize();
+			return (size1 < size2) ? -1 : ((size1 > size2) ? 1 : 0);
+		};
+
+	case FolderModelSortKey::Modified:
+		return [](const FolderModel::ItemView &item1, const FolderModel::ItemView &item2)
+		{
+			auto time1 = item1.GetLastWriteTime();
+			auto time2 = item2.GetLastWriteTime();
+			return (time1 < time2) ? -1 : ((time1 > time2) ? 1 : 0);
+		};
+	}
+
+	LOG(FATAL) << "Unknown sort key";
+	return nullptr;
+}
+
+FolderModel::ItemData BuildItemData(const std::wstring &name, uint64_t size, uint64_t modified)
+{
+	FolderModel::ItemData itemData;
+	itemData.parsingName = name;
+	itemData.displayName = name;
+	itemData.editingName = name;
+	itemData.size = size;
+	itemData.lastWriteTime = modified;
+	return itemData;
+}
+
+std::chrono::microseconds GetPercentile(
+	const std::vector<std::chrono::nanoseconds> &sortedDurations, int percentile)
+{
+	// Uses the nearest-rank method.
+	size_t rank = (sortedDurations.size() * percentile + 99) / 100;
+	size_t index = std::clamp<size_t>(rank, 1, sortedDurations.size()) - 1;
+	return std::chrono::duration_cast<std::chrono::microseconds>(sortedDurations[index]);
+}
+
+}
+
+std::string SerializeFolderModelWorkload(const FolderModelWorkload &workload)
+{
+	std::ostringstream stream;
+
+	for (const auto &operation : workload)
+	{
+		stream << FolderModelReplayer::GetOperationTypeName(operation.type);
+
+		switch (operation.type)
+		{
+		case FolderModelOperationType::Populate:
+			stream << '\t' << operation.value;
+			break;
+
+		case FolderModelOperationType::Insert:
+		case FolderModelOperationType::Update:
+			stream << '\t' << EncodeName(operation.name) << '\t' << operation.value;
+			break;
+
+		case FolderModelOperationType::Remove:
+		case FolderModelOperationType::Select:
+			stream << '\t' << EncodeName(operation.name);
+			break;
+
+		case FolderModelOperationType::Rename:
+			stream << '\t' << EncodeName(operation.name) << '\t' << EncodeName(operation.newName);
+			break;
+
+		case FolderModelOperationType::Sort:
+			stream << '\t' << GetSortKeyName(operation.sortKey) << '\t'
+				   << GetDirectionName(operation.descending);
+			break;
+
+		case FolderModelOperationType::SetSortDirection:
+			stream << '\t' << GetDirectionName(operation.descending);
+			break;
+
+		case FolderModelOperationType::SelectAll:
+		case FolderModelOperationType::ClearSelection:
+		case FolderModelOperationType::Snapshot:
+			break;
+		}
+
+		stream << '\n';
+	}
+
+	return stream.str();
+}
+
+std::optional<FolderModelWorkload> ParseFolderModelWorkload(const std::string &text)
+{
+	FolderModelWorkload workload;
+	std::istringstream stream(text);
+	std::string line;
+
+	while (std::getline(stream, line))
+	{
+		if (!line.empty() && line.back() == '\r')
+		{
+			line.pop_back();
+		}
+
+		// Blank lines and comments are ignored.
+		if (line.empty() || line[0] == '#')
+		{
+			continue;
+		}
+
+		auto operation = ParseOperation(line);
+
+		if (!operation)
+		{
+			return std::nullopt;
+		}
+
+		workload.push_back(*operation);
+	}
+
+	return workload;
+}
+
+FolderModelWorkload GenerateEnumerationWorkload(uint64_t numItems)
+{
+	FolderModelWorkload workload;
+	workload.push_back({ .type = FolderModelOperationType::Sort,
+		.sortKey = FolderModelSortKey::Name });
+	workload.push_back({ .type = FolderModelOperationType::Populate, .value = numItems });
+	workload.push_back({ .type = FolderModelOperationType::Snapshot });
+	return workload;
+}
+
+FolderModelWorkload GenerateChangeStormWorkload(uint64_t numItems, int numChanges, uint32_t seed)
+{
+	auto workload = GenerateEnumerationWorkload(numItems);
+
+	std::vector<std::wstring> liveNames;
+	liveNames.reserve(numItems);
+
+	for (uint64_t i = 0; i < numItems; i++)
+	{
+		liveNames.push_back(GetGeneratedItemName(i));
+	}
+
+	std::mt19937 generator(seed);
+	uint64_t nextIndex = numItems;
+
+	for (int i = 0; i < numChanges; i++)
+	{
+		FolderModelOperation operation;
+		auto changeType = generator() % 4;
+
+		if (liveNames.empty())
+		{
+			changeType = 0;
+		}
+
+		if (changeType == 0)
+		{
+			operation.type = FolderModelOperationType::Insert;
+			operation.name = GetGeneratedItemName(nextIndex);
+			operation.value = GetGeneratedItemSize(nextIndex);
+			liveNames.push_back(operation.name);
+			nextIndex++;
+		}
+		else
+		{
+			size_t liveIndex = generator() % liveNames.size();
+			operation.name = liveNames[liveIndex];
+
+			if (changeType == 1)
+			{
+				operation.type = FolderModelOperationType::Remove;
+				liveNames[liveIndex] = std::move(liveNames.back());
+				liveNames.pop_back();
+			}
+			else if (changeType == 2)
+			{
+				operation.type = FolderModelOperationType::Rename;
+				operation.newName = L"renamed " + GetGeneratedItemName(nextIndex++);
+				liveNames[liveIndex] = operation.newName;
+			}
+			else
+			{
+				operation.type = FolderModelOperationType::Update;
+				operation.value = generator() % 1'000'000;
+			}
+		}
+
+		workload.push_back(operation);
+
+		// Selection changes are interleaved with the changes, since items are often selected while
+		// a folder is changing.
+		if (i % 100 == 0 && !liveNames.empty())
+		{
+			workload.push_back({ .type = FolderModelOperationType::Select,
+				.name = liveNames[generator() % liveNames.size()] });
+		}
+	}
+
+	workload.push_back({ .type = FolderModelOperationType::Snapshot });
+
+	return workload;
+}
+
+FolderModelWorkload GenerateSortToggleWorkload(uint64_t numItems, int numToggles)
+{
+	auto workload = GenerateEnumerationWorkload(numItems);
+
+	const FolderModelSortKey sortKeys[] = { FolderModelSortKey::Size, FolderModelSortKey::Modified,
+		FolderModelSortKey::Name };
+
+	for (int i = 0; i < numToggles; i++)
+	{
+		// Most toggles simply reverse the direction (e.g. from clicking the same column header
+		// twice), with the sort key changing less frequently.
+		if (i % 3 == 2)
+		{
+			workload.push_back({ .type = FolderModelOperationType::Sort,
+				.sortKey = sortKeys[(i / 3) % std::size(sortKeys)] });
+		}
+		else
+		{
+			workload.push_back({ .type = FolderModelOperationType::SetSortDirection,
+				.descending = (i % 3 == 0) });
+		}
+	}
+
+	workload.push_back({ .type = FolderModelOperationType::SelectAll });
+	workload.push_back({ .type = FolderModelOperationType::SetSortDirection, .descending = true });
+	workload.push_back({ .type = FolderModelOperationType::Snapshot });
+
+	return workload;
+}
+
+FolderModelReplayer::FolderModelReplayer(FolderModel *model) : m_model(model)
+{
+}
+
+FolderModelReplayResult FolderModelReplayer::Replay(const FolderModelWorkload &workload)
+{
+	std::map<FolderModelOperationType, std::vector<std::chrono::nanoseconds>> durations;
+
+	for (const auto &operation : workload)
+	{
+		auto start = std::chrono::steady_clock::now();
+		ApplyOperation(operation);
+		auto end = std::chrono::steady_clock::now();
+
+		durations[operation.type].push_back(end - start);
+	}
+
+	FolderModelReplayResult result;
+
+	for (auto &[type, operationDurations] : durations)
+	{
+		std::sort(operationDurations.begin(), operationDurations.end());
+
+		FolderModelLatencySummary summary;
+		summary.count = operationDurations.size();
+		summary.p50 = GetPercentile(operationDurations, 50);
+		summary.p90 = GetPercentile(operationDurations, 90);
+		summary.p99 = GetPercentile(operationDurations, 99);
+		summary.max = GetPercentile(operationDurations, 100);
+		result[type] = summary;
+	}
+
+	return result;
+}
+
+std::string FolderModelReplayer::GetOperationTypeName(FolderModelOperationType type)
+{
+	auto itr = std::find_if(std::begin(OPERATION_TYPE_NAMES), std::end(OPERATION_TYPE_NAMES),
+		[type](const OperationTypeName &typeName) { return typeName.type == type; });
+	CHECK(itr != std::end(OPERATION_TYPE_NAMES));
+	return itr->name;
+}
+
+void FolderModelReplayer::ApplyOperation(const FolderModelOperation &operation)
+{
+	switch (operation.type)
+	{
+	case FolderModelOperationType::Populate:
+	{
+		std::vector<std::wstring> names;
+		names.reserve(operation.value);
+
+		for (uint64_t i = 0; i < operation.value; i++)
+		{
+			names.push_back(GetGeneratedItemName(m_nextPopulateIndex + i));
+		}
+
+		std::vector<FolderModel::ItemData> items;
+		items.reserve(operation.value);
+
+		for (uint64_t i = 0; i < operation.value; i++)
+		{
+			uint64_t index = m_nextPopulateIndex + i;
+			items.push_back(BuildItemData(names[i], GetGeneratedItemSize(index), index * 31));
+		}
+
+		auto ids = m_model->InsertItems(items);
+
+		for (size_t i = 0; i < ids.size(); i++)
+		{
+			m_itemIds[std::move(names[i])] = ids[i];
+		}
+
+		m_nextPopulateIndex += operation.value;
+	}
+	break;
+
+	case FolderModelOperationType::Insert:
+		m_itemIds[operation.name] = m_model->InsertItem(
+			BuildItemData(operation.name, operation.value, operation.value * 31));
+		break;
+
+	case FolderModelOperationType::Remove:
+		m_model->RemoveItem(GetItemId(operation.name));
+		m_itemIds.erase(operation.name);
+		break;
+
+	case FolderModelOperationType::Rename:
+	{
+		auto id = GetItemId(operation.name);
+		m_model->RenameItem(id, operation.newName, operation.newName, operation.newName);
+		m_itemIds.erase(operation.name);
+		m_itemIds[operation.newName] = id;
+	}
+	break;
+
+	case FolderModelOperationType::Update:
+	{
+		auto id = GetItemId(operation.name);
+		auto item = m_model->GetItem(id);
+		m_model->UpdateItem(id,
+			BuildItemData(operation.name, operation.value, item.GetLastWriteTime() + 1));
+	}
+	break;
+
+	case FolderModelOperationType::Sort:
+		m_model->SetSort(GetComparator(operation.sortKey), operation.descending);
+		break;
+
+	case FolderModelOperationType::SetSortDirection:
+		m_model->SetSortDescending(operation.descending);
+		break;
+
+	case FolderModelOperationType::Select:
+		m_model->SelectItem(GetItemId(operation.name), true);
+		break;
+
+	case FolderModelOperationType::SelectAll:
+		m_model->SelectAll();
+		break;
+
+	case FolderModelOperationType::ClearSelection:
+		m_model->ClearSelection();
+		break;
+
+	case FolderModelOperationType::Snapshot:
+		m_model->CreateSnapshot();
+		break;
+	}
+}
+
+FolderModel::ItemId FolderModelReplayer::GetItemId(const std::wstring &name) const
+{
+	auto itr = m_itemIds.find(name);
+	CHECK(itr != m_itemIds.end()) << "Unknown item in workload";
+	return itr->second;
+}
@@ -0,0 +1,104 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#pragma once
+
+#include "ShellBrowser/FolderModel.h"
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// A sequence of operations that can be replayed against a FolderModel, with the time taken by each
+// operation being measured. Workloads can either be generated, or recorded in a simple text format
+// (one tab-separated operation per line) and parsed back in.
+enum class FolderModelOperationType
+{
+	// Adds a set of generated items in a single batch.
+	Populate,
+	Insert,
+	Remove,
+	Rename,
+	Update,
+	Sort,
+	SetSortDirection,
+	Select,
+	SelectAll,
+	ClearSelection,
+	Snapshot
+};
+
+enum class FolderModelSortKey
+{
+	Name,
+	Size,
+	Modified
+};
+
+struct FolderModelOperation
+{
+	FolderModelOperationType type;
+
+	// The item the operation applies to. Generated items are named "file <index>.<extension>".
+	std::wstring name;
+
+	// The new name, when renaming an item.
+	std::wstring newName;
+
+	// The number of items to add when populating, or the item size when inserting/updating.
+	uint64_t value = 0;
+
+	FolderModelSortKey sortKey = FolderModelSortKey::Name;
+	bool descending = false;
+
+	bool operator==(const FolderModelOperation &) const = default;
+};
+
+using FolderModelWorkload = std::vector<FolderModelOperation>;
+
+std::string SerializeFolderModelWorkload(const FolderModelWorkload &workload);
+std::optional<FolderModelWorkload> ParseFolderModelWorkload(const std::string &text);
+
+// Populates the model with the specified number of items, then sorts by name.
+FolderModelWorkload GenerateEnumerationWorkload(uint64_t numItems);
+
+// Populates the model, then applies a burst of changes (creations, deletions, renames and
+// modifications), as would be seen when a large number of files in a folder change at once.
+FolderModelWorkload GenerateChangeStormWorkload(uint64_t numItems, int numChanges, uint32_t seed);
+
+// Populates the model, then repeatedly switches between sort modes and directions.
+FolderModelWorkload GenerateSortToggleWorkload(uint64_t numItems, int numToggles);
+
+struct FolderModelLatencySummary
+{
+	size_t count = 0;
+	std::chrono::microseconds p50{ 0 };
+	std::chrono::microseconds p90{ 0 };
+	std::chrono::microseconds p99{ 0 };
+	std::chrono::microseconds max{ 0 };
+};
+
+// Returns the latency summary for each operation type that was replayed.
+using FolderModelReplayResult = std::map<FolderModelOperationType, FolderModelLatencySummary>;
+
+class FolderModelReplayer
+{
+public:
+	explicit FolderModelReplayer(FolderModel *model);
+
+	FolderModelReplayResult Replay(const FolderModelWorkload &workload);
+
+	static std::string GetOperationTypeName(FolderModelOperationType type);
+
+private:
+	void ApplyOperation(const FolderModelOperation &operation);
+	FolderModel::ItemId GetItemId(const std::wstring &name) const;
+
+	FolderModel *const m_model;
+	std::unordered_map<std::wstring, FolderModel::ItemId> m_itemIds;
+	uint64_t m_nextPopulateIndex = 0;
+};
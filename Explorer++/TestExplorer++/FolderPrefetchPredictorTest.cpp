@@ -0,0 +1,114 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "pch.h"
+#include "FolderPrefetchPredictor.h"
+#include "FakeSystemClock.h"
+#include "FrequentLocationsModel.h"
+#include "HistoryModel.h"
+#include "ShellTestHelper.h"
+#include <gtest/gtest.h>
+
+using namespace testing;
+
+class FolderPrefetchPredictorTest : public Test
+{
+protected:
+	FolderPrefetchPredictorTest() :
+		m_frequentLocationsModel(&m_systemClock),
+		m_current(CreateSimplePidlForTest(L"C:\\Current", nullptr, ShellItemType::Folder)),
+		m_folder1(CreateSimplePidlForTest(L"C:\\Folder1", nullptr, ShellItemType::Folder)),
+		m_folder2(CreateSimplePidlForTest(L"C:\\Folder2", nullptr, ShellItemType::Folder)),
+		m_folder3(CreateSimplePidlForTest(L"C:\\Folder3", nullptr, ShellItemType::Folder))
+	{
+	}
+
+	void AddHistory(const std::vector<PidlAbsolute> &pidls)
+	{
+		for (const auto &pidl : pidls)
+		{
+			m_historyModel.AddHistoryItem(pidl);
+		}
+	}
+
+	std::vector<PidlAbsolute> Predict(size_t maxPredictions = 10)
+	{
+		return PredictNextFolders(m_current, &m_historyModel, &m_frequentLocationsModel,
+			maxPredictions);
+	}
+
+	FakeSystemClock m_systemClock;
+	HistoryModel m_historyModel;
+	FrequentLocationsModel m_frequentLocationsModel;
+
+	const PidlAbsolute m_current;
+	const PidlAbsolute m_folder1;
+	const PidlAbsolute m_folder2;
+	const PidlAbsolute m_folder3;
+};
+
+TEST_F(FolderPrefetchPredictorTest, NoData)
+{
+	EXPECT_THAT(Predict(), IsEmpty());
+}
+
+TEST_F(FolderPrefetchPredictorTest, HistorySuccessors)
+{
+	// The current folder has been followed by folder 1 twice and folders 2 and 3 once each.
+	// Folder 3 was visited after the current folder more recently than folder 2 was.
+	AddHistory({ m_current, m_folder1, m_current, m_folder2, m_folder3, m_current, m_folder1,
+		m_current, m_folder3 });
+
+	EXPECT_THAT(Predict(), ElementsAre(m_folder1, m_folder3, m_folder2));
+}
+
+TEST_F(FolderPrefetchPredictorTest, CurrentFolderVisitedLast)
+{
+	AddHistory({ m_current, m_folder1, m_current });
+
+	EXPECT_THAT(Predict(), ElementsAre(m_folder1));
+}
+
+TEST_F(FolderPrefetchPredictorTest, FrequentChildLocations)
+{
+	auto child1 = CreateSimplePidlForTest(L"C:\\Current\\Child1", nullptr, ShellItemType::Folder);
+	auto child2 = CreateSimplePidlForTest(L"C:\\Current\\Child2", nullptr, ShellItemType::Folder);
+	auto grandchild =
+		CreateSimplePidlForTest(L"C:\\Current\\Child1\\Grandchild", nullptr, ShellItemType::Folder);
+
+	m_frequentLocationsModel.RegisterLocationVisit(child1);
+	m_frequentLocationsModel.RegisterLocationVisit(child2);
+	m_frequentLocationsModel.RegisterLocationVisit(child2);
+	m_frequentLocationsModel.RegisterLocationVisit(grandchild);
+	m_frequentLocationsModel.RegisterLocationVisit(grandchild);
+	m_frequentLocationsModel.RegisterLocationVisit(grandchild);
+	m_frequentLocationsModel.RegisterLocationVisit(m_folder1);
+
+	// Only direct children of the current folder should be included, ordered by visit count.
+	EXPECT_THAT(Predict(), ElementsAre(child2, child1));
+}
+
+TEST_F(FolderPrefetchPredictorTest, HistoryRankedFirst)
+{
+	auto child = CreateSimplePidlForTest(L"C:\\Current\\Child", nullptr, ShellItemType::Folder);
+
+	AddHistory({ m_current, m_folder1, m_current, child });
+	m_frequentLocationsModel.RegisterLocationVisit(child);
+	m_frequentLocationsModel.RegisterLocationVisit(child);
+
+	// The child folder was also a history successor, so it should only appear once.
+	EXPECT_THAT(Predict(), ElementsAre(child, m_folder1));
+}
+
+TEST_F(FolderPrefetchPredictorTest, MaxPredictions)
+{
+	auto child = CreateSimplePidlForTest(L"C:\\Current\\Child", nullptr, ShellItemType::Folder);
+
+	AddHistory({ m_current, m_folder1, m_current, m_folder2 });
+	m_frequentLocationsModel.RegisterLocationVisit(child);
+
+	EXPECT_THAT(Predict(1), ElementsAre(m_folder2));
+	EXPECT_THAT(Predict(2), ElementsAre(m_folder2, m_folder1));
+	EXPECT_THAT(Predict(3), ElementsAre(m_folder2, m_folder1, child));
+}
@@ -0,0 +1,327 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "pch.h"
+#include "ShellBrowser/FolderPrefetcher.h"
+#include "ShellEnumeratorFake.h"
+#include "ShellTestHelper.h"
+#include <gtest/gtest.h>
+
+using namespace std::chrono_literals;
+using namespace testing;
+
+namespace
+{
+
+class ManualSystemClock : public SystemClock
+{
+public:
+	TimePoint Now() override
+	{
+		return m_now;
+	}
+
+	void Advance(std::chrono::seconds duration)
+	{
+		m_now += duration;
+	}
+
+private:
+	TimePoint m_now;
+};
+
+}
+
+class FolderPrefetcherTest : public Test
+{
+protected:
+	FolderPrefetcherTest() :
+		m_shellEnumerator(std::make_shared<ShellEnumeratorFake>()),
+		m_manualExecutorBackground(std::make_shared<concurrencpp::manual_executor>()),
+		m_manualExecutorCurrent(std::make_shared<concurrencpp::manual_executor>())
+	{
+	}
+
+	~FolderPrefetcherTest()
+	{
+		m_manualExecutorBackground->shutdown();
+		m_manualExecutorCurrent->shutdown();
+	}
+
+	std::unique_ptr<FolderPrefetcher> MakePrefetcher(const FolderPrefetchLimits &limits = {})
+	{
+		return std::make_unique<FolderPrefetcher>(m_shellEnumerator, m_manualExecutorBackground,
+			m_manualExecutorCurrent, &m_systemClock, &m_stats, limits);
+	}
+
+	PidlAbsolute CreateFolder(const std::wstring &path, int numItems = 2)
+	{
+		auto pidlDirectory = CreateSimplePidlForTest(path, nullptr, ShellItemType::Folder);
+		std::vector<PidlChild> items;
+
+		for (int i = 0; i < numItems; i++)
+		{
+			auto pidlItem = CreateSimplePidlForTest(path + L"\\item" + std::to_wstring(i));
+			items.push_back(ILFindLastID(pidlItem.Raw()));
+		}
+
+		m_shellEnumerator->SetItems(pidlDirectory, items);
+
+		return pidlDirectory;
+	}
+
+	// Completing a prefetch can result in another prefetch being started, so the executors are
+	// run until there's no more work left.
+	void RunExecutors()
+	{
+		while (!m_manualExecutorBackground->empty() || !m_manualExecutorCurrent->empty())
+		{
+			m_manualExecutorBackground->loop(std::numeric_limits<size_t>::max());
+			m_manualExecutorCurrent->loop(std::numeric_limits<size_t>::max());
+		}
+	}
+
+	const std::shared_ptr<ShellEnumeratorFake> m_shellEnumerator;
+	const std::shared_ptr<concurrencpp::manual_executor> m_manualExecutorBackground;
+	const std::shared_ptr<concurrencpp::manual_executor> m_manualExecutorCurrent;
+	ManualSystemClock m_systemClock;
+	FolderPrefetchStats m_stats;
+};
+
+TEST_F(FolderPrefetcherTest, TakeCompletedPrefetch)
+{
+	auto prefetcher = MakePrefetcher();
+	auto folder = CreateFolder(L"C:\\Fake", 3);
+
+	prefetcher->Prefetch(folder);
+	EXPECT_EQ(prefetcher->GetNumInProgress(), 1u);
+
+	RunExecutors();
+	EXPECT_EQ(prefetcher->GetNumInProgress(), 0u);
+	EXPECT_EQ(prefetcher->GetNumResults(), 1u);
+
+	auto prefetch = prefetcher->TakePrefetch(folder);
+	ASSERT_NE(prefetch, nullptr);
+	ASSERT_EQ(prefetch->result.status(), concurrencpp::result_status::value);
+
+	const auto &prefetchedFolder = prefetch->result.get();
+	EXPECT_HRESULT_SUCCEEDED(prefetchedFolder.hr);
+	EXPECT_EQ(prefetchedFolder.pidlDirectory, folder);
+	EXPECT_EQ(prefetchedFolder.items.size(), 3u);
+
+	EXPECT_EQ(prefetcher->GetNumResults(), 0u);
+	EXPECT_EQ(m_shellEnumerator->GetNumEnumerations(), 1);
+	EXPECT_EQ(m_stats.numStarted, 1);
+	EXPECT_EQ(m_stats.numHits, 1);
+	EXPECT_EQ(m_stats.numPartialHits, 0);
+	EXPECT_EQ(m_stats.numMisses, 0);
+}
+
+TEST_F(FolderPrefetcherTest, TakeInProgressPrefetch)
+{
+	auto prefetcher = MakePrefetcher();
+	auto folder = CreateFolder(L"C:\\Fake");
+
+	prefetcher->Prefetch(folder);
+
+	auto prefetch = prefetcher->TakePrefetch(folder);
+	ASSERT_NE(prefetch, nullptr);
+	EXPECT_EQ(prefetch->result.status(), concurrencpp::result_status::idle);
+	EXPECT_EQ(m_stats.numPartialHits, 1);
+
+	// The enumeration should continue, even though the prefetcher no longer owns the prefetch.
+	RunExecutors();
+	ASSERT_EQ(prefetch->result.status(), concurrencpp::result_status::value);
+	EXPECT_EQ(prefetch->result.get().items.size(), 2u);
+	EXPECT_EQ(prefetcher->GetNumResults(), 0u);
+}
+
+TEST_F(FolderPrefetcherTest, Miss)
+{
+	auto prefetcher = MakePrefetcher();
+	auto folder1 = CreateFolder(L"C:\\Fake1");
+	auto folder2 = CreateFolder(L"C:\\Fake2");
+
+	prefetcher->Prefetch(folder1);
+	RunExecutors();
+
+	EXPECT_EQ(prefetcher->TakePrefetch(folder2), nullptr);
+	EXPECT_EQ(m_stats.numMisses, 1);
+	EXPECT_DOUBLE_EQ(m_stats.GetHitRate(), 0);
+
+	EXPECT_NE(prefetcher->TakePrefetch(folder1), nullptr);
+	EXPECT_DOUBLE_EQ(m_stats.GetHitRate(), 0.5);
+}
+
+TEST_F(FolderPrefetcherTest, DuplicateRequestsIgnored)
+{
+	auto prefetcher = MakePrefetcher();
+	auto folder = CreateFolder(L"C:\\Fake");
+
+	prefetcher->Prefetch(folder);
+	prefetcher->Prefetch(folder);
+	RunExecutors();
+
+	prefetcher->Prefetch(folder);
+	RunExecutors();
+
+	EXPECT_EQ(m_shellEnumerator->GetNumEnumerations(), 1);
+	EXPECT_EQ(m_stats.numStarted, 1);
+}
+
+TEST_F(FolderPrefetcherTest, CancelAll)
+{
+	auto prefetcher = MakePrefetcher();
+	auto folder1 = CreateFolder(L"C:\\Fake1");
+	auto folder2 = CreateFolder(L"C:\\Fake2");
+
+	prefetcher->Prefetch(folder1);
+	RunExecutors();
+
+	prefetcher->Prefetch(folder2);
+	prefetcher->CancelAll();
+	EXPECT_EQ(prefetcher->GetNumInProgress(), 0u);
+	EXPECT_EQ(prefetcher->GetNumResults(), 0u);
+
+	// The in-progress prefetch should have been stopped before the folder was enumerated.
+	RunExecutors();
+	EXPECT_EQ(m_shellEnumerator->GetNumEnumerations(), 1);
+	EXPECT_EQ(m_stats.numCancelled, 1);
+	EXPECT_EQ(m_stats.numDiscarded, 1);
+	EXPECT_EQ(prefetcher->GetNumResults(), 0u);
+}
+
+TEST_F(FolderPrefetcherTest, ConcurrencyLimit)
+{
+	auto prefetcher = MakePrefetcher({ .maxConcurrentPrefetches = 1 });
+	auto folder1 = CreateFolder(L"C:\\Fake1");
+	auto folder2 = CreateFolder(L"C:\\Fake2");
+
+	prefetcher->Prefetch(folder1);
+	prefetcher->Prefetch(folder2);
+	EXPECT_EQ(prefetcher->GetNumInProgress(), 1u);
+	EXPECT_EQ(prefetcher->GetNumQueued(), 1u);
+
+	// Once the first prefetch finishes, the second should be started.
+	RunExecutors();
+	EXPECT_EQ(prefetcher->GetNumQueued(), 0u);
+	EXPECT_EQ(prefetcher->GetNumResults(), 2u);
+	EXPECT_EQ(m_shellEnumerator->GetNumEnumerations(), 2);
+}
+
+TEST_F(FolderPrefetcherTest, QueueLimit)
+{
+	auto prefetcher =
+		MakePrefetcher({ .maxConcurrentPrefetches = 1, .maxQueuedPrefetches = 2 });
+	auto folder1 = CreateFolder(L"C:\\Fake1");
+	auto folder2 = CreateFolder(L"C:\\Fake2");
+	auto folder3 = CreateFolder(L"C:\\Fake3");
+	auto folder4 = CreateFolder(L"C:\\Fake4");
+
+	prefetcher->Prefetch(folder1);
+	prefetcher->Prefetch(folder2);
+	prefetcher->Prefetch(folder3);
+	prefetcher->Prefetch(folder4);
+	EXPECT_EQ(prefetcher->GetNumQueued(), 2u);
+
+	RunExecutors();
+
+	// The most recent requests take priority, so the oldest queued request should have been
+	// dropped.
+	EXPECT_EQ(prefetcher->TakePrefetch(folder2), nullptr);
+	EXPECT_NE(prefetcher->TakePrefetch(folder1), nullptr);
+	EXPECT_NE(prefetcher->TakePrefetch(folder3), nullptr);
+	EXPECT_NE(prefetcher->TakePrefetch(folder4), nullptr);
+	EXPECT_EQ(m_shellEnumerator->GetNumEnumerations(), 3);
+}
+
+TEST_F(FolderPrefetcherTest, BatchPriority)
+{
+	auto prefetcher =
+		MakePrefetcher({ .maxConcurrentPrefetches = 1, .maxQueuedPrefetches = 1 });
+	auto folder1 = CreateFolder(L"C:\\Fake1");
+	auto folder2 = CreateFolder(L"C:\\Fake2");
+	auto folder3 = CreateFolder(L"C:\\Fake3");
+
+	// Only the first folder (which has the highest priority) should fit.
+	prefetcher->Prefetch({ folder1, folder2, folder3 });
+	RunExecutors();
+
+	EXPECT_EQ(prefetcher->GetNumResults(), 1u);
+	EXPECT_NE(prefetcher->TakePrefetch(folder1), nullptr);
+}
+
+TEST_F(FolderPrefetcherTest, ResultsExpire)
+{
+	auto prefetcher = MakePrefetcher({ .maxResultAge = 5s });
+	auto folder = CreateFolder(L"C:\\Fake");
+
+	prefetcher->Prefetch(folder);
+	RunExecutors();
+
+	m_systemClock.Advance(6s);
+
+	EXPECT_EQ(prefetcher->TakePrefetch(folder), nullptr);
+	EXPECT_EQ(m_stats.numDiscarded, 1);
+	EXPECT_EQ(m_stats.numMisses, 1);
+}
+
+TEST_F(FolderPrefetcherTest, ResultLimit)
+{
+	auto prefetcher = MakePrefetcher({ .maxResults = 1 });
+	auto folder1 = CreateFolder(L"C:\\Fake1");
+	auto folder2 = CreateFolder(L"C:\\Fake2");
+
+	prefetcher->Prefetch(folder1);
+	RunExecutors();
+
+	m_systemClock.Advance(1s);
+
+	prefetcher->Prefetch(folder2);
+	RunExecutors();
+
+	EXPECT_EQ(prefetcher->GetNumResults(), 1u);
+	EXPECT_EQ(m_stats.numDiscarded, 1);
+	EXPECT_NE(prefetcher->TakePrefetch(folder2), nullptr);
+}
+
+TEST_F(FolderPrefetcherTest, LargeFoldersNotRetained)
+{
+	auto prefetcher = MakePrefetcher({ .maxItemsPerFolder = 5 });
+	auto smallFolder = CreateFolder(L"C:\\Small", 5);
+	auto largeFolder = CreateFolder(L"C:\\Large", 6);
+
+	prefetcher->Prefetch({ smallFolder, largeFolder });
+	RunExecutors();
+
+	EXPECT_EQ(prefetcher->GetNumResults(), 1u);
+	EXPECT_NE(prefetcher->TakePrefetch(smallFolder), nullptr);
+	EXPECT_EQ(prefetcher->TakePrefetch(largeFolder), nullptr);
+}
+
+TEST_F(FolderPrefetcherTest, FailedEnumerationNotRetained)
+{
+	auto prefetcher = MakePrefetcher();
+	auto folder = CreateFolder(L"C:\\Fake");
+
+	m_shellEnumerator->SetShouldSucceed(false);
+	prefetcher->Prefetch(folder);
+	RunExecutors();
+
+	EXPECT_EQ(prefetcher->GetNumResults(), 0u);
+	EXPECT_EQ(prefetcher->TakePrefetch(folder), nullptr);
+}
+
+TEST_F(FolderPrefetcherTest, DestroyedWhileInProgress)
+{
+	auto prefetcher = MakePrefetcher();
+	auto folder = CreateFolder(L"C:\\Fake");
+
+	prefetcher->Prefetch(folder);
+	prefetcher.reset();
+
+	RunExecutors();
+	EXPECT_EQ(m_shellEnumerator->GetNumEnumerations(), 0);
+	EXPECT_EQ(m_stats.numCancelled, 1);
+}
@@ -0,0 +1,338 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "pch.h"
+#include "ShellBrowser/FolderSnapshotCache.h"
+#include "ShellEnumeratorFake.h"
+#include "ShellTestHelper.h"
+#include <gtest/gtest.h>
+#include <format>
+
+using namespace testing;
+
+class FolderSnapshotTest : public Test
+{
+protected:
+	PidlChild CreateChild(const PidlAbsolute &pidlDirectory, const std::wstring &name,
+		ShellItemType shellItemType = ShellItemType::File)
+	{
+		std::wstring directoryPath;
+		HRESULT hr = GetDisplayName(pidlDirectory.Raw(), SHGDN_FORPARSING, directoryPath);
+		EXPECT_HRESULT_SUCCEEDED(hr);
+
+		auto pidl = CreateSimplePidlForTest(directoryPath + L"\\" + name, nullptr, shellItemType);
+		return ILFindLastID(pidl.Raw());
+	}
+
+	std::vector<PidlChild> Enumerate(const PidlAbsolute &pidlDirectory)
+	{
+		std::vector<PidlChild> items;
+		HRESULT hr = m_shellEnumerator.EnumerateDirectory(pidlDirectory.Raw(), items, {});
+		EXPECT_HRESULT_SUCCEEDED(hr);
+		return items;
+	}
+
+	// Builds a snapshot from the current contents of the directory, in the same way the items
+	// would be retrieved when showing the directory.
+	std::shared_ptr<FolderSnapshot> BuildSnapshot(const PidlAbsolute &pidlDirectory)
+	{
+		auto snapshot = std::make_shared<FolderSnapshot>();
+		snapshot->pidlDirectory = pidlDirectory;
+
+		for (const auto &child : Enumerate(pidlDirectory))
+		{
+			ItemInfo_t item;
+			item.pidlComplete.TakeOwnership(ILCombine(pidlDirectory.Raw(), child.Raw()));
+
+			HRESULT hr =
+				GetDisplayName(item.pidlComplete.Raw(), SHGDN_FORPARSING, item.parsingName);
+			EXPECT_HRESULT_SUCCEEDED(hr);
+
+			item.displayName = item.parsingName;
+			snapshot->items.push_back(std::make_shared<const ItemInfo_t>(std::move(item)));
+		}
+
+		return snapshot;
+	}
+
+	FolderSnapshotDiff Diff(const FolderSnapshot &snapshot,
+		const std::vector<PidlChild> &currentItems)
+	{
+		return DiffFolderSnapshot(snapshot, currentItems,
+			[this, &snapshot](PCITEMID_CHILD pidl) -> std::optional<std::wstring>
+			{
+				m_numNamesResolved++;
+
+				PidlAbsolute fullPidl;
+				fullPidl.TakeOwnership(ILCombine(snapshot.pidlDirectory.Raw(), pidl));
+
+				std::wstring parsingName;
+				HRESULT hr = GetDisplayName(fullPidl.Raw(), SHGDN_FORPARSING, parsingName);
+
+				if (FAILED(hr))
+				{
+					return std::nullopt;
+				}
+
+				return parsingName;
+			});
+	}
+
+	ShellEnumeratorFake m_shellEnumerator;
+	int m_numNamesResolved = 0;
+};
+
+TEST_F(FolderSnapshotTest, DiffUnchanged)
+{
+	auto pidlDirectory = CreateSimplePidlForTest(L"C:\\Fake", nullptr, ShellItemType::Folder);
+	m_shellEnumerator.SetItems(pidlDirectory,
+		{ CreateChild(pidlDirectory, L"file1.txt"), CreateChild(pidlDirectory, L"file2.txt"),
+			CreateChild(pidlDirectory, L"folder", ShellItemType::Folder) });
+
+	auto snapshot = BuildSnapshot(pidlDirectory);
+	auto diff = Diff(*snapshot, Enumerate(pidlDirectory));
+
+	EXPECT_TRUE(diff.IsEmpty());
+
+	// Every item should have been matched by its pidl, so there should have been no need to
+	// retrieve any names.
+	EXPECT_EQ(m_numNamesResolved, 0);
+}
+
+TEST_F(FolderSnapshotTest, DiffAddedAndRemoved)
+{
+	auto pidlDirectory = CreateSimplePidlForTest(L"C:\\Fake", nullptr, ShellItemType::Folder);
+	auto file1 = CreateChild(pidlDirectory, L"file1.txt");
+	auto file2 = CreateChild(pidlDirectory, L"file2.txt");
+	auto file3 = CreateChild(pidlDirectory, L"file3.txt");
+	m_shellEnumerator.SetItems(pidlDirectory, { file1, file2, file3 });
+
+	auto snapshot = BuildSnapshot(pidlDirectory);
+
+	auto file4 = CreateChild(pidlDirectory, L"file4.txt");
+	auto file5 = CreateChild(pidlDirectory, L"file5.txt");
+	m_shellEnumerator.SetItems(pidlDirectory, { file3, file4, file1, file5 });
+
+	auto diff = Diff(*snapshot, Enumerate(pidlDirectory));
+	EXPECT_THAT(diff.addedItems, ElementsAre(1, 3));
+	EXPECT_THAT(diff.removedItems, ElementsAre(1));
+	EXPECT_THAT(diff.modifiedItems, IsEmpty());
+
+	// Names should only be retrieved for the items that weren't in the snapshot.
+	EXPECT_EQ(m_numNamesResolved, 2);
+}
+
+TEST_F(FolderSnapshotTest, DiffModified)
+{
+	auto pidlDirectory = CreateSimplePidlForTest(L"C:\\Fake", nullptr, ShellItemType::Folder);
+	m_shellEnumerator.SetItems(pidlDirectory,
+		{ CreateChild(pidlDirectory, L"file1.txt"), CreateChild(pidlDirectory, L"item") });
+
+	auto snapshot = BuildSnapshot(pidlDirectory);
+
+	// The item keeps the same name, but its pidl changes. That's what happens when a file is
+	// written to, since the pidl includes the size and timestamps of the item.
+	m_shellEnumerator.SetItems(pidlDirectory,
+		{ CreateChild(pidlDirectory, L"file1.txt"),
+			CreateChild(pidlDirectory, L"item", ShellItemType::Folder) });
+
+	auto diff = Diff(*snapshot, Enumerate(pidlDirectory));
+	EXPECT_THAT(diff.addedItems, IsEmpty());
+	EXPECT_THAT(diff.removedItems, IsEmpty());
+	EXPECT_THAT(diff.modifiedItems, ElementsAre(std::pair<size_t, size_t>(1, 1)));
+	EXPECT_EQ(m_numNamesResolved, 1);
+}
+
+TEST_F(FolderSnapshotTest, DiffUnresolvedNameTreatedAsAdded)
+{
+	auto pidlDirectory = CreateSimplePidlForTest(L"C:\\Fake", nullptr, ShellItemType::Folder);
+	m_shellEnumerator.SetItems(pidlDirectory, { CreateChild(pidlDirectory, L"item") });
+
+	auto snapshot = BuildSnapshot(pidlDirectory);
+
+	m_shellEnumerator.SetItems(pidlDirectory,
+		{ CreateChild(pidlDirectory, L"item", ShellItemType::Folder) });
+
+	auto diff = DiffFolderSnapshot(*snapshot, Enumerate(pidlDirectory),
+		[](PCITEMID_CHILD) { return std::nullopt; });
+	EXPECT_THAT(diff.addedItems, ElementsAre(0));
+	EXPECT_THAT(diff.removedItems, ElementsAre(0));
+	EXPECT_THAT(diff.modifiedItems, IsEmpty());
+}
+
+TEST_F(FolderSnapshotTest, DiffEmptyFolder)
+{
+	auto pidlDirectory = CreateSimplePidlForTest(L"C:\\Fake", nullptr, ShellItemType::Folder);
+	m_shellEnumerator.SetItems(pidlDirectory,
+		{ CreateChild(pidlDirectory, L"file1.txt"), CreateChild(pidlDirectory, L"file2.txt") });
+
+	auto snapshot = BuildSnapshot(pidlDirectory);
+
+	m_shellEnumerator.SetItems(pidlDirectory, {});
+
+	auto diff = Diff(*snapshot, Enumerate(pidlDirectory));
+	EXPECT_THAT(diff.addedItems, IsEmpty());
+	EXPECT_THAT(diff.removedItems, ElementsAre(0, 1));
+	EXPECT_EQ(m_numNamesResolved, 0);
+}
+
+class FolderSnapshotCacheTest : public FolderSnapshotTest
+{
+protected:
+	std::shared_ptr<FolderSnapshot> BuildSnapshotForPath(const std::wstring &path,
+		int numItems = 10)
+	{
+		auto pidlDirectory = CreateSimplePidlForTest(path, nullptr, ShellItemType::Folder);
+		std::vector<PidlChild> items;
+
+		for (int i = 0; i < numItems; i++)
+		{
+			items.push_back(CreateChild(pidlDirectory, std::format(L"file{}.txt", i)));
+		}
+
+		m_shellEnumerator.SetItems(pidlDirectory, items);
+
+		return BuildSnapshot(pidlDirectory);
+	}
+};
+
+TEST_F(FolderSnapshotCacheTest, Find)
+{
+	FolderSnapshotCache cache(1024 * 1024);
+
+	auto snapshot = BuildSnapshotForPath(L"C:\\Fake1");
+	cache.Insert(snapshot);
+
+	EXPECT_EQ(cache.Find(snapshot->pidlDirectory), snapshot);
+	EXPECT_EQ(cache.Find(CreateSimplePidlForTest(L"C:\\Fake2", nullptr, ShellItemType::Folder)),
+		nullptr);
+	EXPECT_EQ(cache.GetNumEntries(), 1u);
+	EXPECT_EQ(cache.GetSizeInBytes(), snapshot->GetMemoryUsage());
+}
+
+TEST_F(FolderSnapshotCacheTest, MemoryUsageIncludesItemData)
+{
+	auto snapshot = BuildSnapshotForPath(L"C:\\Fake");
+
+	// The pidls and names are held in separate allocations, which should be counted, along with
+	// the items themselves.
+	size_t minimumItemMemoryUsage = 0;
+
+	for (const auto &item : snapshot->items)
+	{
+		minimumItemMemoryUsage += sizeof(ItemInfo_t) + ILGetSize(item->pidlComplete.Raw())
+			+ item->parsingName.size() * sizeof(wchar_t);
+	}
+
+	EXPECT_GE(snapshot->GetMemoryUsage(), minimumItemMemoryUsage);
+}
+
+TEST_F(FolderSnapshotCacheTest, Replace)
+{
+	FolderSnapshotCache cache(1024 * 1024);
+
+	auto snapshot1 = BuildSnapshotForPath(L"C:\\Fake", 10);
+	cache.Insert(snapshot1);
+
+	auto snapshot2 = BuildSnapshotForPath(L"C:\\Fake", 20);
+	cache.Insert(snapshot2);
+
+	EXPECT_EQ(cache.Find(snapshot1->pidlDirectory), snapshot2);
+	EXPECT_EQ(cache.GetNumEntries(), 1u);
+	EXPECT_EQ(cache.GetSizeInBytes(), snapshot2->GetMemoryUsage());
+}
+
+TEST_F(FolderSnapshotCacheTest, Remove)
+{
+	FolderSnapshotCache cache(1024 * 1024);
+
+	auto snapshot = BuildSnapshotForPath(L"C:\\Fake");
+	cache.Insert(snapshot);
+	cache.Remove(snapshot->pidlDirectory);
+
+	EXPECT_EQ(cache.Find(snapshot->pidlDirectory), nullptr);
+	EXPECT_EQ(cache.GetNumEntries(), 0u);
+	EXPECT_EQ(cache.GetSizeInBytes(), 0u);
+}
+
+TEST_F(FolderSnapshotCacheTest, EvictLeastRecentlyUsed)
+{
+	auto snapshot1 = BuildSnapshotForPath(L"C:\\Fake1");
+	auto snapshot2 = BuildSnapshotForPath(L"C:\\Fake2");
+	auto snapshot3 = BuildSnapshotForPath(L"C:\\Fake3");
+
+	// There's only enough space for two of the snapshots.
+	FolderSnapshotCache cache(snapshot1->GetMemoryUsage() + snapshot2->GetMemoryUsage()
+		+ snapshot3->GetMemoryUsage() - 1);
+
+	cache.Insert(snapshot1);
+	cache.Insert(snapshot2);
+
+	// Accessing the first snapshot should mean that the second snapshot is now the least recently
+	// used one.
+	EXPECT_NE(cache.Find(snapshot1->pidlDirectory), nullptr);
+
+	cache.Insert(snapshot3);
+
+	EXPECT_EQ(cache.Find(snapshot1->pidlDirectory), snapshot1);
+	EXPECT_EQ(cache.Find(snapshot2->pidlDirectory), nullptr);
+	EXPECT_EQ(cache.Find(snapshot3->pidlDirectory), snapshot3);
+	EXPECT_EQ(cache.GetNumEntries(), 2u);
+	EXPECT_EQ(cache.GetSizeInBytes(),
+		snapshot1->GetMemoryUsage() + snapshot3->GetMemoryUsage());
+}
+
+TEST_F(FolderSnapshotCacheTest, EvictMultiple)
+{
+	auto smallSnapshot1 = BuildSnapshotForPath(L"C:\\Small1", 5);
+	auto smallSnapshot2 = BuildSnapshotForPath(L"C:\\Small2", 5);
+	auto largeSnapshot = BuildSnapshotForPath(L"C:\\Large", 50);
+
+	FolderSnapshotCache cache(largeSnapshot->GetMemoryUsage() + 1);
+	cache.Insert(smallSnapshot1);
+	cache.Insert(smallSnapshot2);
+	EXPECT_EQ(cache.GetNumEntries(), 2u);
+
+	// Both of the smaller snapshots need to be evicted to make space for this one.
+	cache.Insert(largeSnapshot);
+	EXPECT_EQ(cache.GetNumEntries(), 1u);
+	EXPECT_EQ(cache.Find(largeSnapshot->pidlDirectory), largeSnapshot);
+}
+
+TEST_F(FolderSnapshotCacheTest, SnapshotLargerThanCache)
+{
+	auto smallSnapshot = BuildSnapshotForPath(L"C:\\Small", 1);
+	auto largeSnapshot = BuildSnapshotForPath(L"C:\\Large", 100);
+
+	FolderSnapshotCache cache(largeSnapshot->GetMemoryUsage() - 1);
+	cache.Insert(smallSnapshot);
+	cache.Insert(largeSnapshot);
+
+	// The large snapshot won't fit at all, so it shouldn't be stored and shouldn't result in any
+	// existing snapshots being evicted.
+	EXPECT_EQ(cache.Find(largeSnapshot->pidlDirectory), nullptr);
+	EXPECT_EQ(cache.Find(smallSnapshot->pidlDirectory), smallSnapshot);
+}
+
+TEST_F(FolderSnapshotCacheTest, SetMaxSize)
+{
+	FolderSnapshotCache cache(1024 * 1024);
+
+	auto snapshot1 = BuildSnapshotForPath(L"C:\\Fake1");
+	auto snapshot2 = BuildSnapshotForPath(L"C:\\Fake2");
+	cache.Insert(snapshot1);
+	cache.Insert(snapshot2);
+
+	cache.SetMaxSizeInBytes(snapshot2->GetMemoryUsage());
+	EXPECT_EQ(cache.GetNumEntries(), 1u);
+	EXPECT_EQ(cache.Find(snapshot2->pidlDirectory), snapshot2);
+
+	// Disabling the cache should remove everything.
+	cache.SetMaxSizeInBytes(0);
+	EXPECT_EQ(cache.GetNumEntries(), 0u);
+	EXPECT_EQ(cache.GetSizeInBytes(), 0u);
+
+	cache.Insert(snapshot1);
+	EXPECT_EQ(cache.GetNumEntries(), 0u);
+}
@@ -216,3 +216,32 @@ TEST_F(FrequentLocationsModelTest, SetLocationVisits)
 	// counts.
 	EXPECT_THAT(m_frequentLocationsModel.GetVisits(), ElementsAre(location2, location3, location1));
 }
+
+TEST(FrequentLocationsModelLimitTest, MaxLocations)
+{
+	FakeSystemClock systemClock;
+	FrequentLocationsModel frequentLocationsModel(&systemClock, 2);
+
+	PidlAbsolute fake1 = CreateSimplePidlForTest(L"C:\\Fake1");
+	frequentLocationsModel.RegisterLocationVisit(fake1);
+	frequentLocationsModel.RegisterLocationVisit(fake1);
+
+	PidlAbsolute fake2 = CreateSimplePidlForTest(L"C:\\Fake2");
+	frequentLocationsModel.RegisterLocationVisit(fake2);
+
+	PidlAbsolute fake3 = CreateSimplePidlForTest(L"C:\\Fake3");
+	frequentLocationsModel.RegisterLocationVisit(fake3);
+
+	// fake2 was the least frequently visited location when fake3 was added, so it should have been
+	// removed.
+	std::vector<LocationVisitInfo> expectedVisits = { { fake1, 2, SystemClock::TimePoint(1s) },
+		{ fake3, 1, SystemClock::TimePoint(3s) } };
+	EXPECT_THAT(frequentLocationsModel.GetVisits(), ElementsAreArray(expectedVisits));
+
+	// Visiting an existing location shouldn't result in any location being removed.
+	frequentLocationsModel.RegisterLocationVisit(fake3);
+
+	expectedVisits = { { fake3, 2, SystemClock::TimePoint(4s) },
+		{ fake1, 2, SystemClock::TimePoint(1s) } };
+	EXPECT_THAT(frequentLocationsModel.GetVisits(), ElementsAreArray(expectedVisits));
+}
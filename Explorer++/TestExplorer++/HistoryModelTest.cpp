@@ -27,3 +27,31 @@ TEST(HistoryModelTest, RepeatedNavigation)
 	historyModel.AddHistoryItem(pidl);
 	EXPECT_EQ(history.size(), 1U);
 }
+
+TEST(HistoryModelTest, MaxItems)
+{
+	HistoryModel historyModel;
+	const auto &history = historyModel.GetHistoryItems();
+
+	PidlAbsolute fake1 = CreateSimplePidlForTest(L"C:\\Fake1");
+	historyModel.AddHistoryItem(fake1);
+
+	PidlAbsolute fake2 = CreateSimplePidlForTest(L"C:\\Fake2");
+	historyModel.AddHistoryItem(fake2);
+
+	PidlAbsolute fake3 = CreateSimplePidlForTest(L"C:\\Fake3");
+	historyModel.AddHistoryItem(fake3);
+
+	// Lowering the limit should remove the oldest items.
+	historyModel.SetMaxItems(2);
+	EXPECT_THAT(history, ElementsAre(fake3, fake2));
+
+	PidlAbsolute fake4 = CreateSimplePidlForTest(L"C:\\Fake4");
+	historyModel.AddHistoryItem(fake4);
+	EXPECT_THAT(history, ElementsAre(fake4, fake3));
+
+	// Removing the limit should allow the history to grow again.
+	historyModel.SetMaxItems(0);
+	historyModel.AddHistoryItem(fake1);
+	EXPECT_THAT(history, ElementsAre(fake1, fake4, fake3));
+}
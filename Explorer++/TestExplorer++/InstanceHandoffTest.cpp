@@ -0,0 +1,469 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "pch.h"
+#include "InstanceHandoff.h"
+#include "../Helper/LocalPipe.h"
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <random>
+#include <thread>
+
+using namespace testing;
+using namespace std::chrono_literals;
+
+namespace
+{
+
+std::wstring CreateUniquePipeName()
+{
+	// Each test uses its own pipe, so that tests don't interfere with each other, or with a running
+	// instance of the application.
+	std::random_device randomDevice;
+	std::uniform_int_distribution<uint64_t> distribution;
+	return L"InstanceHandoffTest-" + std::to_wstring(distribution(randomDevice));
+}
+
+class BatchCollector
+{
+public:
+	InstanceHandoffServer::BatchCallback GetCallback()
+	{
+		return [this](std::vector<InstanceHandoffRequest> batch)
+		{
+			std::scoped_lock lock(m_mutex);
+			m_batches.push_back(std::move(batch));
+			m_batchAddedCondition.notify_all();
+		};
+	}
+
+	std::vector<std::vector<InstanceHandoffRequest>> WaitForBatches(size_t numBatches)
+	{
+		std::unique_lock lock(m_mutex);
+		m_batchAddedCondition.wait_for(lock, 5s,
+			[this, numBatches] { return m_batches.size() >= numBatches; });
+		return m_batches;
+	}
+
+private:
+	std::mutex m_mutex;
+	std::condition_variable m_batchAddedCondition;
+	std::vector<std::vector<InstanceHandoffRequest>> m_batches;
+};
+
+InstanceHandoffRequest DecodeRequest(std::span<const std::byte> payload)
+{
+	InstanceHandoffRequest request;
+	EXPECT_EQ(DecodeInstanceHandoffRequest(payload, request), InstanceHandoffStatus::Accepted);
+	return request;
+}
+
+}
+
+TEST(InstanceHandoffProtocolTest, RequestRoundTrip)
+{
+	InstanceHandoffRequest request;
+	request.directories = { L"C:\\", L"C:\\Users\\Default\\Documents", L"",
+		L"C:\\\u00e9\u4e2d\\\U0001F600" };
+	EXPECT_EQ(DecodeRequest(EncodeInstanceHandoffRequest(request)), request);
+
+	InstanceHandoffRequest jumplistRequest;
+	jumplistRequest.jumplistNewTab = true;
+	EXPECT_EQ(DecodeRequest(EncodeInstanceHandoffRequest(jumplistRequest)), jumplistRequest);
+}
+
+TEST(InstanceHandoffProtocolTest, RequestEncoding)
+{
+	InstanceHandoffRequest request;
+	request.directories = { L"C:", L"\U0001F600" };
+	request.jumplistNewTab = true;
+
+	// Strings are written as UTF-16LE, so the encoding is the same regardless of the size of
+	// wchar_t.
+	std::vector<uint8_t> expected = { 'E', 'X', 'P', 'H', 1, 0, 1, 0, 2, 0, 0, 0, 2, 0, 0, 0, 'C',
+		0, ':', 0, 2, 0, 0, 0, 0x3D, 0xD8, 0x00, 0xDE };
+
+	auto encoded = EncodeInstanceHandoffRequest(request);
+	std::vector<uint8_t> actual;
+
+	for (auto byte : encoded)
+	{
+		actual.push_back(static_cast<uint8_t>(byte));
+	}
+
+	EXPECT_EQ(actual, expected);
+}
+
+TEST(InstanceHandoffProtocolTest, UnpairedSurrogate)
+{
+	// Windows paths can contain unpaired surrogates, which should be preserved.
+	InstanceHandoffRequest request;
+	request.directories = { std::wstring(1, static_cast<wchar_t>(0xD800)) + L"a" };
+	EXPECT_EQ(DecodeRequest(EncodeInstanceHandoffRequest(request)), request);
+}
+
+TEST(InstanceHandoffProtocolTest, MalformedRequests)
+{
+	InstanceHandoffRequest request;
+	request.directories = { L"C:\\Windows" };
+	auto encoded = EncodeInstanceHandoffRequest(request);
+
+	InstanceHandoffRequest decoded;
+	decoded.directories = { L"unchanged" };
+
+	EXPECT_EQ(DecodeInstanceHandoffRequest({}, decoded), InstanceHandoffStatus::Malformed);
+
+	for (size_t size = 1; size < encoded.size(); size++)
+	{
+		EXPECT_EQ(DecodeInstanceHandoffRequest(std::span(encoded).first(size), decoded),
+			InstanceHandoffStatus::Malformed);
+	}
+
+	auto trailingData = encoded;
+	trailingData.push_back(std::byte { 0 });
+	EXPECT_EQ(DecodeInstanceHandoffRequest(trailingData, decoded),
+		InstanceHandoffStatus::Malformed);
+
+	auto invalidMagic = encoded;
+	invalidMagic[0] = std::byte { 'X' };
+	EXPECT_EQ(DecodeInstanceHandoffRequest(invalidMagic, decoded),
+		InstanceHandoffStatus::Malformed);
+
+	// A directory count that's larger than the payload could possibly contain.
+	auto invalidCount = encoded;
+	invalidCount[11] = std::byte { 0xFF };
+	EXPECT_EQ(DecodeInstanceHandoffRequest(invalidCount, decoded),
+		InstanceHandoffStatus::Malformed);
+
+	// The output shouldn't be modified when decoding fails.
+	EXPECT_THAT(decoded.directories, ElementsAre(L"unchanged"));
+}
+
+TEST(InstanceHandoffProtocolTest, UnsupportedVersion)
+{
+	InstanceHandoffRequest request;
+	request.directories = { L"C:\\" };
+
+	InstanceHandoffRequest decoded;
+	EXPECT_EQ(DecodeInstanceHandoffRequest(
+				  EncodeInstanceHandoffRequest(request, INSTANCE_HANDOFF_PROTOCOL_VERSION + 1),
+				  decoded),
+		InstanceHandoffStatus::UnsupportedVersion);
+}
+
+TEST(InstanceHandoffProtocolTest, Responses)
+{
+	for (auto status : { InstanceHandoffStatus::Accepted, InstanceHandoffStatus::Declined,
+			 InstanceHandoffStatus::UnsupportedVersion, InstanceHandoffStatus::Malformed })
+	{
+		EXPECT_EQ(DecodeInstanceHandoffResponse(EncodeInstanceHandoffResponse(status)), status);
+	}
+
+	auto encoded = EncodeInstanceHandoffResponse(InstanceHandoffStatus::Accepted);
+	EXPECT_EQ(DecodeInstanceHandoffResponse(std::span(encoded).first(encoded.size() - 1)),
+		std::nullopt);
+
+	auto invalidStatus = encoded;
+	invalidStatus.back() = std::byte { 0xFF };
+	EXPECT_EQ(DecodeInstanceHandoffResponse(invalidStatus), std::nullopt);
+}
+
+TEST(InstanceHandoffBatcherTest, QuietPeriod)
+{
+	InstanceHandoffBatcher batcher({ .quietPeriod = 30ms, .maxDelay = 200ms });
+	EXPECT_EQ(batcher.GetDeadline(), std::nullopt);
+
+	InstanceHandoffBatcher::Clock::time_point start;
+
+	InstanceHandoffRequest request1;
+	request1.directories = { L"C:\\1" };
+	batcher.Add(request1, start);
+	EXPECT_EQ(batcher.GetDeadline(), start + 30ms);
+
+	// Each request that arrives within the quiet period extends the batch.
+	InstanceHandoffRequest request2;
+	request2.directories = { L"C:\\2" };
+	batcher.Add(request2, start + 20ms);
+	EXPECT_EQ(batcher.GetDeadline(), start + 50ms);
+
+	EXPECT_THAT(batcher.TakeBatchIfDue(start + 49ms), IsEmpty());
+	EXPECT_THAT(batcher.TakeBatchIfDue(start + 50ms), ElementsAre(request1, request2));
+	EXPECT_EQ(batcher.GetDeadline(), std::nullopt);
+	EXPECT_THAT(batcher.TakeBatchIfDue(start + 100ms), IsEmpty());
+
+	// Requests that arrive after a batch has been taken start a new batch.
+	batcher.Add(request1, start + 100ms);
+	EXPECT_EQ(batcher.GetDeadline(), start + 130ms);
+	EXPECT_THAT(batcher.TakeBatchIfDue(start + 130ms), ElementsAre(request1));
+}
+
+TEST(InstanceHandoffBatcherTest, MaxDelay)
+{
+	InstanceHandoffBatcher batcher({ .quietPeriod = 30ms, .maxDelay = 100ms });
+
+	InstanceHandoffBatcher::Clock::time_point start;
+
+	// A steady stream of requests can't hold up the batch indefinitely.
+	for (int i = 0; i < 5; i++)
+	{
+		batcher.Add({}, start + i * 25ms);
+	}
+
+	EXPECT_EQ(batcher.GetDeadline(), start + 100ms);
+	EXPECT_THAT(batcher.TakeBatchIfDue(start + 99ms), IsEmpty());
+	EXPECT_THAT(batcher.TakeBatchIfDue(start + 100ms), SizeIs(5));
+}
+
+TEST(LocalPipeTest, SingleServer)
+{
+	auto pipeName = CreateUniquePipeName();
+
+	EXPECT_EQ(LocalPipeConnection::Connect(pipeName, 100ms), nullptr);
+
+	auto server = LocalPipeServer::Create(pipeName);
+	ASSERT_NE(server, nullptr);
+
+	std::jthread clientThread(
+		[&pipeName]
+		{
+			auto client = LocalPipeConnection::Connect(pipeName, 1s);
+			ASSERT_NE(client, nullptr);
+
+			std::byte data[] = { std::byte { 1 }, std::byte { 2 }, std::byte { 3 } };
+			EXPECT_TRUE(client->Write(data, 1s));
+
+			std::byte response[1];
+			EXPECT_EQ(client->Read(response, 1s), 1u);
+			EXPECT_EQ(response[0], std::byte { 4 });
+		});
+
+	auto connection = server->Accept();
+	ASSERT_NE(connection, nullptr);
+	EXPECT_NE(connection->GetPeerProcessId(), 0u);
+
+	std::vector<std::byte> received;
+
+	while (received.size() < 3)
+	{
+		std::byte buffer[3];
+		size_t numBytesRead = connection->Read(buffer, 1s);
+		ASSERT_NE(numBytesRead, 0u);
+		received.insert(received.end(), buffer, buffer + numBytesRead);
+	}
+
+	EXPECT_THAT(received, ElementsAre(std::byte { 1 }, std::byte { 2 }, std::byte { 3 }));
+
+	std::byte response[] = { std::byte { 4 } };
+	EXPECT_TRUE(connection->Write(response, 1s));
+	clientThread.join();
+
+	// The client has closed its end, so there's nothing further to read.
+	std::byte buffer[1];
+	EXPECT_EQ(connection->Read(buffer, 1s), 0u);
+
+	// Only a single server can own the pipe.
+	EXPECT_EQ(LocalPipeServer::Create(pipeName), nullptr);
+
+	// Once the server has been destroyed, the name can be reused.
+	server.reset();
+	EXPECT_NE(LocalPipeServer::Create(pipeName), nullptr);
+}
+
+TEST(LocalPipeTest, Stop)
+{
+	auto server = LocalPipeServer::Create(CreateUniquePipeName());
+	ASSERT_NE(server, nullptr);
+
+	std::jthread stopThread(
+		[&server]
+		{
+			std::this_thread::sleep_for(50ms);
+			server->Stop();
+		});
+
+	EXPECT_EQ(server->Accept(), nullptr);
+	stopThread.join();
+
+	// Accept() should continue to fail once the server has been stopped.
+	EXPECT_EQ(server->Accept(), nullptr);
+}
+
+TEST(InstanceHandoffServerTest, RequestsAreBatched)
+{
+	auto pipeName = CreateUniquePipeName();
+	BatchCollector collector;
+	auto server = InstanceHandoffServer::Create(pipeName, nullptr, collector.GetCallback(),
+		{ .quietPeriod = 500ms, .maxDelay = 5s });
+	ASSERT_NE(server, nullptr);
+
+	std::vector<InstanceHandoffRequest> requests(3);
+	requests[0].directories = { L"C:\\1" };
+	requests[1].directories = { L"C:\\2", L"C:\\3" };
+	requests[2].jumplistNewTab = true;
+
+	std::vector<std::jthread> clients;
+
+	for (const auto &request : requests)
+	{
+		clients.emplace_back(
+			[&pipeName, &request]
+			{
+				uint32_t serverProcessId = 0;
+				auto status = SendInstanceHandoffRequest(pipeName, request, 2s,
+					[&serverProcessId](uint32_t processId) { serverProcessId = processId; });
+				EXPECT_EQ(status, InstanceHandoffStatus::Accepted);
+				EXPECT_NE(serverProcessId, 0u);
+			});
+	}
+
+	for (auto &client : clients)
+	{
+		client.join();
+	}
+
+	// The requests are acknowledged before being delivered, so all of them are acknowledged well
+	// within the quiet period.
+	auto batches = collector.WaitForBatches(1);
+	ASSERT_THAT(batches, SizeIs(1));
+	EXPECT_THAT(batches[0], UnorderedElementsAreArray(requests));
+}
+
+TEST(InstanceHandoffServerTest, SeparateBatches)
+{
+	auto pipeName = CreateUniquePipeName();
+	BatchCollector collector;
+	auto server = InstanceHandoffServer::Create(pipeName, nullptr, collector.GetCallback(),
+		{ .quietPeriod = 10ms, .maxDelay = 20ms });
+	ASSERT_NE(server, nullptr);
+
+	InstanceHandoffRequest request1;
+	request1.directories = { L"C:\\1" };
+	EXPECT_EQ(SendInstanceHandoffRequest(pipeName, request1, 2s),
+		InstanceHandoffStatus::Accepted);
+	EXPECT_THAT(collector.WaitForBatches(1), ElementsAre(ElementsAre(request1)));
+
+	InstanceHandoffRequest request2;
+	request2.directories = { L"C:\\2" };
+	EXPECT_EQ(SendInstanceHandoffRequest(pipeName, request2, 2s),
+		InstanceHandoffStatus::Accepted);
+	EXPECT_THAT(collector.WaitForBatches(2),
+		ElementsAre(ElementsAre(request1), ElementsAre(request2)));
+}
+
+TEST(InstanceHandoffServerTest, DeclinedRequests)
+{
+	auto pipeName = CreateUniquePipeName();
+	BatchCollector collector;
+	auto server = InstanceHandoffServer::Create(
+		pipeName, [](const InstanceHandoffRequest &request) { return request.jumplistNewTab; },
+		collector.GetCallback(), { .quietPeriod = 10ms, .maxDelay = 20ms });
+	ASSERT_NE(server, nullptr);
+
+	InstanceHandoffRequest declinedRequest;
+	declinedRequest.directories = { L"C:\\" };
+	EXPECT_EQ(SendInstanceHandoffRequest(pipeName, declinedRequest, 2s),
+		InstanceHandoffStatus::Declined);
+
+	InstanceHandoffRequest acceptedRequest;
+	acceptedRequest.jumplistNewTab = true;
+	EXPECT_EQ(SendInstanceHandoffRequest(pipeName, acceptedRequest, 2s),
+		InstanceHandoffStatus::Accepted);
+
+	EXPECT_THAT(collector.WaitForBatches(1), ElementsAre(ElementsAre(acceptedRequest)));
+}
+
+TEST(InstanceHandoffServerTest, InvalidFrames)
+{
+	auto pipeName = CreateUniquePipeName();
+	BatchCollector collector;
+	auto server = InstanceHandoffServer::Create(pipeName, nullptr, collector.GetCallback());
+	ASSERT_NE(server, nullptr);
+
+	auto sendPayload = [&pipeName](std::span<const std::byte> payload)
+	{
+		auto connection = LocalPipeConnection::Connect(pipeName, 1s);
+		EXPECT_NE(connection, nullptr);
+		EXPECT_TRUE(WriteInstanceHandoffFrame(*connection, payload, 1s));
+
+		auto response = ReadInstanceHandoffFrame(*connection, 2s);
+		EXPECT_NE(response, std::nullopt);
+		return DecodeInstanceHandoffResponse(response.value_or(std::vector<std::byte>()));
+	};
+
+	std::byte garbage[] = { std::byte { 1 }, std::byte { 2 } };
+	EXPECT_EQ(sendPayload(garbage), InstanceHandoffStatus::Malformed);
+
+	EXPECT_EQ(sendPayload(EncodeInstanceHandoffRequest({}, INSTANCE_HANDOFF_PROTOCOL_VERSION + 1)),
+		InstanceHandoffStatus::UnsupportedVersion);
+
+	// A frame that's too large is rejected without a response.
+	{
+		auto connection = LocalPipeConnection::Connect(pipeName, 1s);
+		ASSERT_NE(connection, nullptr);
+
+		std::byte oversizedHeader[] = { std::byte { 0xFF }, std::byte { 0xFF },
+			std::byte { 0xFF }, std::byte { 0xFF } };
+		EXPECT_TRUE(connection->Write(oversizedHeader, 1s));
+		EXPECT_EQ(ReadInstanceHandoffFrame(*connection, 2s), std::nullopt);
+	}
+
+	// A client that never sends anything shouldn't stop later clients from being served.
+	auto idleConnection = LocalPipeConnection::Connect(pipeName, 1s);
+	ASSERT_NE(idleConnection, nullptr);
+
+	EXPECT_EQ(SendInstanceHandoffRequest(pipeName, {}, 5s), InstanceHandoffStatus::Accepted);
+	EXPECT_THAT(collector.WaitForBatches(1), ElementsAre(ElementsAre(InstanceHandoffRequest())));
+}
+
+TEST(InstanceHandoffServerTest, NoServer)
+{
+	EXPECT_EQ(SendInstanceHandoffRequest(CreateUniquePipeName(), {}, 500ms), std::nullopt);
+}
+
+TEST(InstanceHandoffServerTest, SingleServer)
+{
+	auto pipeName = CreateUniquePipeName();
+	auto server = InstanceHandoffServer::Create(pipeName, nullptr, [](auto) {});
+	ASSERT_NE(server, nullptr);
+	EXPECT_EQ(InstanceHandoffServer::Create(pipeName, nullptr, [](auto) {}), nullptr);
+}
+
+// Measures how long it takes for a client to have its request acknowledged, which is how long a
+// new process has to wait before it can exit.
+TEST(InstanceHandoffBenchmarkTest, DISABLED_AcknowledgementLatency)
+{
+	constexpr int NUM_REQUESTS = 200;
+
+	auto pipeName = CreateUniquePipeName();
+	BatchCollector collector;
+	auto server = InstanceHandoffServer::Create(pipeName, nullptr, collector.GetCallback());
+	ASSERT_NE(server, nullptr);
+
+	InstanceHandoffRequest request;
+	request.directories = { L"C:\\Users\\Default\\Documents", L"C:\\Windows\\System32" };
+
+	auto start = std::chrono::steady_clock::now();
+
+	for (int i = 0; i < NUM_REQUESTS; i++)
+	{
+		ASSERT_EQ(SendInstanceHandoffRequest(pipeName, request, 2s),
+			InstanceHandoffStatus::Accepted);
+	}
+
+	auto end = std::chrono::steady_clock::now();
+
+	server.reset();
+
+	size_t numDelivered = 0;
+
+	for (const auto &batch : collector.WaitForBatches(0))
+	{
+		numDelivered += batch.size();
+	}
+
+	testing::Test::RecordProperty("AcknowledgementUs",
+		std::to_string(std::chrono::duration_cast<std::chrono::microseconds>(end - start).count()
+			/ NUM_REQUESTS));
+	testing::Test::RecordProperty("DeliveredBeforeShutdown", std::to_string(numDelivered));
+}
@@ -0,0 +1,249 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "pch.h"
+#include "ShellBrowser/ItemGroupSet.h"
+#include <gtest/gtest.h>
+#include <chrono>
+#include <format>
+#include <functional>
+
+using GroupInfo = ItemGroupSet::GroupInfo;
+
+namespace
+{
+
+std::vector<std::wstring> GetGroupNames(const ItemGroupSet &groupSet,
+	const std::vector<int> &groupIds)
+{
+	std::vector<std::wstring> names;
+
+	for (int groupId : groupIds)
+	{
+		names.push_back(groupSet.GetGroup(groupId).name);
+	}
+
+	return names;
+}
+
+}
+
+TEST(ItemGroupSetTest, GetOrCreateGroup)
+{
+	ItemGroupSet groupSet;
+
+	int id1 = groupSet.GetOrCreateGroup(GroupInfo(L"A"));
+	int id2 = groupSet.GetOrCreateGroup(GroupInfo(L"B"));
+	EXPECT_NE(id1, id2);
+
+	// A group with the same name should be returned.
+	EXPECT_EQ(groupSet.GetOrCreateGroup(GroupInfo(L"A")), id1);
+	EXPECT_EQ(groupSet.GetNumGroups(), 2u);
+
+	const auto &group = groupSet.GetGroup(id1);
+	EXPECT_EQ(group.id, id1);
+	EXPECT_EQ(group.name, L"A");
+	EXPECT_EQ(group.numItems, 0);
+}
+
+TEST(ItemGroupSetTest, AddAndRemoveItems)
+{
+	ItemGroupSet groupSet;
+
+	int groupId = groupSet.GetOrCreateGroup(GroupInfo(L"A"));
+	EXPECT_TRUE(groupSet.AddItem(groupId));
+	EXPECT_FALSE(groupSet.AddItem(groupId));
+	EXPECT_EQ(groupSet.GetGroup(groupId).numItems, 2);
+
+	EXPECT_FALSE(groupSet.RemoveItem(groupId));
+	EXPECT_TRUE(groupSet.RemoveItem(groupId));
+	EXPECT_EQ(groupSet.GetGroup(groupId).numItems, 0);
+}
+
+TEST(ItemGroupSetTest, AddItemsInBulk)
+{
+	ItemGroupSet groupSet;
+
+	auto groupIds = groupSet.AddItems({ GroupInfo(L"A"), GroupInfo(L"A"), GroupInfo(L"B"),
+		GroupInfo(L"A"), GroupInfo(L"C"), GroupInfo(L"B") });
+	ASSERT_EQ(groupIds.size(), 6u);
+
+	EXPECT_EQ(groupIds[0], groupIds[1]);
+	EXPECT_EQ(groupIds[0], groupIds[3]);
+	EXPECT_EQ(groupIds[2], groupIds[5]);
+	EXPECT_NE(groupIds[0], groupIds[2]);
+	EXPECT_NE(groupIds[0], groupIds[4]);
+
+	EXPECT_EQ(groupSet.GetGroup(groupIds[0]).numItems, 3);
+	EXPECT_EQ(groupSet.GetGroup(groupIds[2]).numItems, 2);
+	EXPECT_EQ(groupSet.GetGroup(groupIds[4]).numItems, 1);
+}
+
+TEST(ItemGroupSetTest, ChangedGroups)
+{
+	ItemGroupSet groupSet;
+
+	int id1 = groupSet.GetOrCreateGroup(GroupInfo(L"A"));
+	int id2 = groupSet.GetOrCreateGroup(GroupInfo(L"B"));
+	groupSet.GetOrCreateGroup(GroupInfo(L"C"));
+
+	groupSet.AddItem(id1);
+	groupSet.AddItem(id1);
+	groupSet.AddItem(id2);
+
+	// Only the groups that were actually changed should be returned, each one once.
+	auto changedGroups = groupSet.TakeChangedGroups();
+	EXPECT_THAT(changedGroups, testing::UnorderedElementsAre(id1, id2));
+
+	EXPECT_TRUE(groupSet.TakeChangedGroups().empty());
+
+	groupSet.RemoveItem(id2);
+	EXPECT_THAT(groupSet.TakeChangedGroups(), testing::ElementsAre(id2));
+}
+
+TEST(ItemGroupSetTest, OrderByName)
+{
+	ItemGroupSet groupSet;
+	groupSet.AddItems({ GroupInfo(L"C"), GroupInfo(L"A"), GroupInfo(L"B"),
+		GroupInfo(L"Other", ItemGroupSet::POSITION_LAST),
+		GroupInfo(L"Unspecified", ItemGroupSet::POSITION_FIRST) });
+
+	// Empty groups shouldn't be included.
+	groupSet.GetOrCreateGroup(GroupInfo(L"D"));
+
+	auto orderedGroups = groupSet.GetNonEmptyGroupsInOrder(ItemGroupSet::Order::Name, false);
+	EXPECT_EQ(GetGroupNames(groupSet, orderedGroups),
+		(std::vector<std::wstring>{ L"Unspecified", L"A", L"B", L"C", L"Other" }));
+
+	orderedGroups = groupSet.GetNonEmptyGroupsInOrder(ItemGroupSet::Order::Name, true);
+	EXPECT_EQ(GetGroupNames(groupSet, orderedGroups),
+		(std::vector<std::wstring>{ L"Other", L"C", L"B", L"A", L"Unspecified" }));
+}
+
+TEST(ItemGroupSetTest, OrderByRelativePosition)
+{
+	ItemGroupSet groupSet;
+	groupSet.AddItems({ GroupInfo(L"Large", 3), GroupInfo(L"Small", 1), GroupInfo(L"Medium", 2),
+		GroupInfo(L"Unspecified", ItemGroupSet::POSITION_FIRST) });
+
+	auto orderedGroups =
+		groupSet.GetNonEmptyGroupsInOrder(ItemGroupSet::Order::RelativePosition, false);
+	EXPECT_EQ(GetGroupNames(groupSet, orderedGroups),
+		(std::vector<std::wstring>{ L"Unspecified", L"Small", L"Medium", L"Large" }));
+
+	// When ordering by name, the relative position should be ignored.
+	orderedGroups = groupSet.GetNonEmptyGroupsInOrder(ItemGroupSet::Order::Name, false);
+	EXPECT_EQ(GetGroupNames(groupSet, orderedGroups),
+		(std::vector<std::wstring>{ L"Unspecified", L"Large", L"Medium", L"Small" }));
+}
+
+TEST(ItemGroupSetTest, Clear)
+{
+	ItemGroupSet groupSet;
+
+	int originalId = groupSet.GetOrCreateGroup(GroupInfo(L"A"));
+	groupSet.AddItem(originalId);
+	groupSet.Clear();
+
+	EXPECT_EQ(groupSet.GetNumGroups(), 0u);
+	EXPECT_EQ(groupSet.MaybeGetGroup(originalId), nullptr);
+	EXPECT_TRUE(groupSet.TakeChangedGroups().empty());
+
+	// IDs shouldn't be reused.
+	EXPECT_NE(groupSet.GetOrCreateGroup(GroupInfo(L"A")), originalId);
+}
+
+// Measures the time taken to bucket a large folder and calculate the group order, using key
+// distributions that approximate several of the group modes. The time taken for each mode is
+// recorded as a test property.
+TEST(ItemGroupSetTest, DISABLED_BulkAssignmentBenchmark)
+{
+	constexpr int NUM_ITEMS = 200'000;
+
+	struct GroupModeCase
+	{
+		std::string name;
+		ItemGroupSet::Order order;
+		std::function<GroupInfo(int index)> getGroupInfo;
+	};
+
+	std::vector<GroupModeCase> groupModeCases = {
+		// Items are grouped by the first character of their name.
+		{ "Name", ItemGroupSet::Order::Name,
+			[](int index) { return GroupInfo(std::wstring(1, L'A' + (index % 26))); } },
+
+		// Items are divided into a small number of size ranges.
+		{ "Size", ItemGroupSet::Order::RelativePosition,
+			[](int index)
+			{
+				int bucket = index % 7;
+				return GroupInfo(std::format(L"Size {}", bucket), bucket + 1);
+			} },
+
+		// Items are grouped by date, with folders sorted by name tending to cluster by date.
+		{ "DateModified", ItemGroupSet::Order::RelativePosition,
+			[](int index)
+			{
+				int bucket = (index / 1000) % 12;
+				return GroupInfo(std::format(L"Date {}", bucket), bucket);
+			} },
+
+		// There can be a large number of distinct extensions.
+		{ "Extension", ItemGroupSet::Order::Name,
+			[](int index) { return GroupInfo(std::format(L"EXT{}", (index * 7919) % 500)); } },
+
+		// Most items have no value (e.g. no camera model).
+		{ "CameraModel", ItemGroupSet::Order::Name,
+			[](int index)
+			{
+				if (index % 10 != 0)
+				{
+					return GroupInfo(L"Unspecified", ItemGroupSet::POSITION_FIRST);
+				}
+
+				return GroupInfo(std::format(L"Camera {}", index % 4));
+			} },
+	};
+
+	for (const auto &groupModeCase : groupModeCases)
+	{
+		std::vector<GroupInfo> groupInfos;
+		groupInfos.reserve(NUM_ITEMS);
+
+		for (int i = 0; i < NUM_ITEMS; i++)
+		{
+			groupInfos.push_back(groupModeCase.getGroupInfo(i));
+		}
+
+		ItemGroupSet groupSet;
+
+		auto start = std::chrono::steady_clock::now();
+		auto groupIds = groupSet.AddItems(groupInfos);
+		auto orderedGroups = groupSet.GetNonEmptyGroupsInOrder(groupModeCase.order, false);
+		auto end = std::chrono::steady_clock::now();
+
+		testing::Test::RecordProperty(groupModeCase.name + "Ms",
+			static_cast<int>(
+				std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count()));
+
+		ASSERT_EQ(groupIds.size(), static_cast<size_t>(NUM_ITEMS));
+
+		int totalItems = 0;
+
+		for (int groupId : orderedGroups)
+		{
+			totalItems += groupSet.GetGroup(groupId).numItems;
+		}
+
+		EXPECT_EQ(totalItems, NUM_ITEMS) << groupModeCase.name;
+
+		for (size_t i = 1; i < orderedGroups.size(); i++)
+		{
+			EXPECT_LT(groupSet.CompareGroups(orderedGroups[i - 1], orderedGroups[i],
+						  groupModeCase.order, false),
+				0)
+				<< groupModeCase.name;
+		}
+	}
+}
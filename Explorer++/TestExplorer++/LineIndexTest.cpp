@@ -0,0 +1,298 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "pch.h"
+#include "../Helper/LineIndex.h"
+#include "../Helper/MappedFile.h"
+#include "../Helper/MappedFileSearch.h"
+#include "SparseFileTestHelper.h"
+#include "TemporaryPathTestHelper.h"
+#include <gtest/gtest.h>
+#include <format>
+#include <fstream>
+#include <random>
+#include <thread>
+
+using namespace testing;
+
+namespace
+{
+
+constexpr uint64_t GIGABYTE = 1024 * 1024 * 1024;
+
+class LineIndexTest : public Test
+{
+protected:
+	LineIndexTest() : m_tempFile("LineIndexTest")
+	{
+	}
+
+	// Writes the contents, then builds an index of them.
+	void BuildIndex(const std::string &contents, TextEncoding encoding, uint64_t startOffset = 0)
+	{
+		CreateSparseFile(m_tempFile.GetPath(), contents.size(), { { 0, contents } });
+		BuildIndexForFile(encoding, startOffset);
+	}
+
+	void BuildIndexForFile(TextEncoding encoding, uint64_t startOffset = 0)
+	{
+		m_file = MappedFile::Open(m_tempFile.GetPath());
+		ASSERT_NE(m_file, nullptr);
+
+		m_index = std::make_unique<LineIndex>(m_file, encoding, startOffset);
+		m_index->Build();
+		ASSERT_TRUE(m_index->IsComplete());
+
+		m_reader = std::make_unique<MappedFileReader>(m_file);
+	}
+
+	std::string GetLineText(const LineRange &range)
+	{
+		auto data = m_reader->Read(range.offset, static_cast<size_t>(range.length));
+		return { reinterpret_cast<const char *>(data.data()), data.size() };
+	}
+
+	std::vector<std::string> GetLineTexts(uint64_t firstLine, size_t maxLines)
+	{
+		std::vector<std::string> texts;
+
+		for (const auto &range : m_index->GetLines(firstLine, maxLines, *m_reader))
+		{
+			texts.push_back(GetLineText(range));
+		}
+
+		return texts;
+	}
+
+	TemporaryTestFile m_tempFile;
+	std::shared_ptr<MappedFile> m_file;
+	std::unique_ptr<LineIndex> m_index;
+	std::unique_ptr<MappedFileReader> m_reader;
+};
+
+}
+
+TEST_F(LineIndexTest, Empty)
+{
+	BuildIndex("", TextEncoding::Utf8);
+	EXPECT_EQ(m_index->GetNumLines(), 1u);
+	EXPECT_THAT(GetLineTexts(0, 10), ElementsAre(""));
+}
+
+TEST_F(LineIndexTest, LineTerminators)
+{
+	BuildIndex("first\nsecond\r\n\nlast", TextEncoding::Utf8);
+	EXPECT_EQ(m_index->GetNumLines(), 4u);
+	EXPECT_THAT(GetLineTexts(0, 10), ElementsAre("first", "second", "", "last"));
+	EXPECT_THAT(GetLineTexts(1, 2), ElementsAre("second", ""));
+	EXPECT_THAT(GetLineTexts(4, 2), IsEmpty());
+
+	// A trailing newline is followed by an empty line.
+	BuildIndex("only\r\n", TextEncoding::Utf8);
+	EXPECT_THAT(GetLineTexts(0, 10), ElementsAre("only", ""));
+}
+
+TEST_F(LineIndexTest, ByteOrderMarkSkipped)
+{
+	BuildIndex("\xEF\xBB\xBFone\ntwo", TextEncoding::Utf8, 3);
+	EXPECT_THAT(GetLineTexts(0, 10), ElementsAre("one", "two"));
+	EXPECT_EQ(m_index->GetLineForOffset(0, *m_reader), 0u);
+}
+
+TEST_F(LineIndexTest, Utf16)
+{
+	// U+4E0A contains a line feed byte, which shouldn't be treated as a newline.
+	std::wstring text = L"a\x4E0A\r\n\x0A4E\nend";
+
+	for (auto encoding : { TextEncoding::Utf16LE, TextEncoding::Utf16BE })
+	{
+		auto encoded = EncodeText(text, encoding);
+		BuildIndex(std::string(reinterpret_cast<const char *>(encoded.data()), encoded.size()),
+			encoding);
+
+		ASSERT_EQ(m_index->GetNumLines(), 3u);
+
+		auto lines = m_index->GetLines(0, 10, *m_reader);
+		ASSERT_EQ(lines.size(), 3u);
+		EXPECT_EQ(lines[0].offset, 0u);
+		EXPECT_EQ(lines[0].length, 4u);
+		EXPECT_EQ(lines[1].offset, 8u);
+		EXPECT_EQ(lines[1].length, 2u);
+		EXPECT_EQ(lines[2].offset, 12u);
+		EXPECT_EQ(lines[2].length, 6u);
+
+		EXPECT_EQ(m_index->GetLineForOffset(3, *m_reader), 0u);
+		EXPECT_EQ(m_index->GetLineForOffset(10, *m_reader), 1u);
+		EXPECT_EQ(m_index->GetLineForOffset(12, *m_reader), 2u);
+	}
+}
+
+TEST_F(LineIndexTest, Checkpoints)
+{
+	std::string contents;
+	std::vector<std::string> expectedLines;
+	std::vector<uint64_t> lineOffsets;
+
+	for (int i = 0; i < 5000; i++)
+	{
+		expectedLines.push_back(std::string(i % 37, 'x') + std::to_string(i));
+		lineOffsets.push_back(contents.size());
+		contents += expectedLines.back() + (i % 3 == 0 ? "\r\n" : "\n");
+	}
+
+	BuildIndex(contents, TextEncoding::Utf8);
+
+	// The final newline is followed by an empty line.
+	EXPECT_EQ(m_index->GetNumLines(), 5001u);
+	EXPECT_EQ(m_index->GetNumCheckpoints(), 5000 / LineIndex::CHECKPOINT_INTERVAL + 1);
+
+	for (uint64_t firstLine : { 0, 1, 1023, 1024, 1025, 2047, 4990 })
+	{
+		auto lines = GetLineTexts(firstLine, 20);
+		std::vector<std::string> expected(expectedLines.begin() + firstLine,
+			expectedLines.begin() + std::min<uint64_t>(firstLine + 20, expectedLines.size()));
+
+		if (firstLine + 20 > expectedLines.size())
+		{
+			expected.push_back("");
+		}
+
+		EXPECT_EQ(lines, expected);
+	}
+
+	for (uint64_t line : { 0, 5, 1023, 1024, 3000, 4999 })
+	{
+		EXPECT_EQ(m_index->GetLineForOffset(lineOffsets[line], *m_reader), line);
+		EXPECT_EQ(m_index->GetLineForOffset(lineOffsets[line] + 1, *m_reader), line);
+	}
+
+	EXPECT_EQ(m_index->GetLineForOffset(contents.size(), *m_reader), 5000u);
+}
+
+TEST_F(LineIndexTest, LookupsBeforeBuild)
+{
+	CreateSparseFile(m_tempFile.GetPath(), 10, { { 0, "one\ntwo\n" } });
+	auto file = MappedFile::Open(m_tempFile.GetPath());
+	ASSERT_NE(file, nullptr);
+
+	LineIndex index(file, TextEncoding::Utf8, 0);
+	MappedFileReader reader(file);
+	EXPECT_FALSE(index.IsComplete());
+	EXPECT_EQ(index.GetNumLines(), 0u);
+	EXPECT_THAT(index.GetLines(0, 10, reader), IsEmpty());
+	EXPECT_EQ(index.GetLineForOffset(5, reader), std::nullopt);
+
+	std::stop_source stopSource;
+	stopSource.request_stop();
+	index.Build(stopSource.get_token());
+	EXPECT_FALSE(index.IsComplete());
+}
+
+// A file larger than 4 GiB, most of which is a sparse (i.e. all zero) region, so that lines have
+// offsets that don't fit in 32 bits and some lines are gigabytes long.
+TEST_F(LineIndexTest, MultiGigabyteSparseFile)
+{
+	uint64_t size = 4 * GIGABYTE + 4096;
+	CreateSparseFile(m_tempFile.GetPath(), size,
+		{ { 0, "first\nsecond\n" }, { 3 * GIGABYTE, "\nmiddle\n" }, { size - 10, "\nlast line" } });
+	BuildIndexForFile(TextEncoding::Utf8);
+
+	EXPECT_EQ(m_index->GetNumLines(), 6u);
+	EXPECT_EQ(m_index->GetNumBytesScanned(), size);
+
+	auto lines = m_index->GetLines(0, 10, *m_reader);
+	ASSERT_EQ(lines.size(), 6u);
+	EXPECT_EQ(GetLineText(lines[0]), "first");
+	EXPECT_EQ(GetLineText(lines[1]), "second");
+	EXPECT_EQ(lines[2].offset, 13u);
+	EXPECT_EQ(lines[2].length, 3 * GIGABYTE - 13);
+	EXPECT_EQ(GetLineText(lines[3]), "middle");
+	EXPECT_EQ(lines[4].offset, 3 * GIGABYTE + 8);
+	EXPECT_EQ(GetLineText(lines[5]), "last line");
+
+	EXPECT_EQ(m_index->GetLineForOffset(3 * GIGABYTE + 3, *m_reader), 3u);
+	EXPECT_EQ(m_index->GetLineForOffset(size - 1, *m_reader), 5u);
+}
+
+// Indexes, reads and searches a 256 MiB log file.
+TEST(LineIndexBenchmarkTest, DISABLED_LargeLogFile)
+{
+	constexpr size_t TARGET_SIZE = 256 * 1024 * 1024;
+
+	TemporaryTestFile tempFile("LineIndexBenchmarkTest");
+	uint64_t numLinesWritten = 0;
+
+	{
+		std::ofstream stream(tempFile.GetPath(), std::ios::binary);
+		std::string buffer;
+		size_t totalSize = 0;
+
+		while (totalSize < TARGET_SIZE)
+		{
+			buffer.clear();
+
+			for (int i = 0; i < 10000; i++, numLinesWritten++)
+			{
+				buffer += std::format(
+					"2024-01-01 12:00:{:02} [worker-{}] request {} completed in {} ms\n",
+					numLinesWritten % 60, numLinesWritten % 16, numLinesWritten,
+					(numLinesWritten * 2654435761u) % 1000);
+			}
+
+			stream.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+			totalSize += buffer.size();
+		}
+	}
+
+	auto file = MappedFile::Open(tempFile.GetPath());
+	ASSERT_NE(file, nullptr);
+
+	LineIndex index(file, TextEncoding::Utf8, 0);
+
+	auto indexStart = std::chrono::steady_clock::now();
+	index.Build();
+	auto indexEnd = std::chrono::steady_clock::now();
+
+	ASSERT_EQ(index.GetNumLines(), numLinesWritten + 1);
+
+	// Simulates scrolling to random positions, with a screenful of lines retrieved each time.
+	constexpr int NUM_LOOKUPS = 2000;
+	constexpr size_t LINES_PER_SCREEN = 60;
+	MappedFileReader reader(file);
+	std::mt19937 generator(1);
+	std::uniform_int_distribution<uint64_t> lineDistribution(0, numLinesWritten - 1);
+
+	auto lookupStart = std::chrono::steady_clock::now();
+
+	for (int i = 0; i < NUM_LOOKUPS; i++)
+	{
+		auto lines = index.GetLines(lineDistribution(generator), LINES_PER_SCREEN, reader);
+		ASSERT_FALSE(lines.empty());
+	}
+
+	auto lookupEnd = std::chrono::steady_clock::now();
+
+	MappedFileSearchOptions options;
+	int numThreads = static_cast<int>(std::max(std::thread::hardware_concurrency(), 1u));
+	std::string pattern = "request 999999999 completed";
+
+	auto searchStart = std::chrono::steady_clock::now();
+	auto match = SearchMappedFile(*file, std::as_bytes(std::span(pattern)), 0, file->GetSize(),
+		options, numThreads);
+	auto searchEnd = std::chrono::steady_clock::now();
+
+	EXPECT_EQ(match, std::nullopt);
+
+	auto toMilliseconds = [](auto duration)
+	{ return std::chrono::duration_cast<std::chrono::milliseconds>(duration).count(); };
+	auto toMicroseconds = [](auto duration)
+	{ return std::chrono::duration_cast<std::chrono::microseconds>(duration).count(); };
+
+	testing::Test::RecordProperty("IndexMs", toMilliseconds(indexEnd - indexStart));
+	testing::Test::RecordProperty("ScreenLookupUs",
+		toMicroseconds(lookupEnd - lookupStart) / NUM_LOOKUPS);
+	testing::Test::RecordProperty("SearchMs", toMilliseconds(searchEnd - searchStart));
+	testing::Test::RecordProperty("CheckpointBytes",
+		static_cast<int64_t>(index.GetNumCheckpoints() * sizeof(uint64_t)));
+}
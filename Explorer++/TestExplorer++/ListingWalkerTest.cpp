@@ -0,0 +1,327 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "pch.h"
+#include "ListingWalker.h"
+#include "ListingWriter.h"
+#include "TemporaryPathTestHelper.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <streambuf>
+
+namespace
+{
+
+// An in-memory tree, where each folder path maps to the names of its children. Child names ending
+// in a backslash are folders.
+class FakeListingSource : public ListingSource
+{
+public:
+	void AddFolder(const std::wstring &path, std::vector<std::wstring> children)
+	{
+		m_folders[path] = std::move(children);
+	}
+
+	bool EnumerateFolder(const std::wstring &path, std::vector<ListingEntry> &entries,
+		std::stop_token stopToken) override
+	{
+		UNREFERENCED_PARAMETER(stopToken);
+
+		m_enumeratedFolders.push_back(path);
+
+		auto itr = m_folders.find(path);
+
+		if (itr == m_folders.end())
+		{
+			return false;
+		}
+
+		for (const auto &child : itr->second)
+		{
+			bool isFolder = child.ends_with(L"\\");
+			std::wstring name = isFolder ? child.substr(0, child.size() - 1) : child;
+			entries.push_back({ path + L"\\" + name, name, isFolder, { name } });
+		}
+
+		return true;
+	}
+
+	const std::vector<std::wstring> &GetEnumeratedFolders() const
+	{
+		return m_enumeratedFolders;
+	}
+
+private:
+	std::map<std::wstring, std::vector<std::wstring>> m_folders;
+	std::vector<std::wstring> m_enumeratedFolders;
+};
+
+// Produces a tree with a fixed number of folders and files per folder, without storing anything.
+class GeneratedListingSource : public ListingSource
+{
+public:
+	GeneratedListingSource(int depth, int foldersPerFolder, int filesPerFolder) :
+		m_depth(depth),
+		m_foldersPerFolder(foldersPerFolder),
+		m_filesPerFolder(filesPerFolder)
+	{
+	}
+
+	bool EnumerateFolder(const std::wstring &path, std::vector<ListingEntry> &entries,
+		std::stop_token stopToken) override
+	{
+		UNREFERENCED_PARAMETER(stopToken);
+
+		auto level = std::count(path.begin(), path.end(), L'\\');
+
+		if (level < m_depth)
+		{
+			for (int i = 0; i < m_foldersPerFolder; i++)
+			{
+				auto name = std::format(L"folder {}", i);
+				entries.push_back(
+					{ path + L"\\" + name, name, true, { name, L"", L"File folder" } });
+			}
+		}
+
+		for (int i = 0; i < m_filesPerFolder; i++)
+		{
+			auto name = std::format(L"file {}.txt", i);
+			entries.push_back({ path + L"\\" + name, name, false,
+				{ name, std::format(L"{} KB", i), L"Text Document" } });
+		}
+
+		return true;
+	}
+
+private:
+	const int m_depth;
+	const int m_foldersPerFolder;
+	const int m_filesPerFolder;
+};
+
+// Discards everything written to it, while keeping track of the number of bytes.
+class CountingStreamBuffer : public std::streambuf
+{
+public:
+	size_t GetNumBytes() const
+	{
+		return m_numBytes;
+	}
+
+protected:
+	std::streamsize xsputn(const char *data, std::streamsize size) override
+	{
+		UNREFERENCED_PARAMETER(data);
+
+		m_numBytes += static_cast<size_t>(size);
+		return size;
+	}
+
+	int_type overflow(int_type character) override
+	{
+		m_numBytes++;
+		return traits_type::not_eof(character);
+	}
+
+private:
+	size_t m_numBytes = 0;
+};
+
+class FileSystemListingSource : public ListingSource
+{
+public:
+	bool EnumerateFolder(const std::wstring &path, std::vector<ListingEntry> &entries,
+		std::stop_token stopToken) override
+	{
+		UNREFERENCED_PARAMETER(stopToken);
+
+		std::error_code error;
+		std::filesystem::directory_iterator itr(path, error);
+
+		if (error)
+		{
+			return false;
+		}
+
+		for (const auto &directoryEntry : itr)
+		{
+			bool isFolder = directoryEntry.is_directory() && !directoryEntry.is_symlink();
+			auto name = directoryEntry.path().filename().wstring();
+			auto size = isFolder ? std::wstring() : std::to_wstring(directoryEntry.file_size());
+			entries.push_back({ directoryEntry.path().wstring(), name, isFolder, { name, size } });
+		}
+
+		std::ranges::sort(entries, {}, &ListingEntry::name);
+
+		return true;
+	}
+};
+
+}
+
+TEST(ListingWalkerTest, NonRecursive)
+{
+	FakeListingSource source;
+	source.AddFolder(L"c:", { L"b.txt", L"folder\\", L"a.txt" });
+	source.AddFolder(L"c:\\folder", { L"nested.txt" });
+
+	std::ostringstream stream;
+	ListingWriter writer(stream, ListingFormat::JsonLines, { L"Name" });
+	ListingWalker walker(&source, &writer, {});
+	EXPECT_EQ(walker.Walk(L"c:", {}), ListingWalker::Result::Completed);
+
+	EXPECT_EQ(stream.str(),
+		"{\"Name\":\"b.txt\"}\n"
+		"{\"Name\":\"folder\"}\n"
+		"{\"Name\":\"a.txt\"}\n");
+	EXPECT_EQ(source.GetEnumeratedFolders(), std::vector<std::wstring>{ L"c:" });
+}
+
+TEST(ListingWalkerTest, Recursive)
+{
+	FakeListingSource source;
+	source.AddFolder(L"c:", { L"folder1\\", L"folder2\\", L"file.txt" });
+	source.AddFolder(L"c:\\folder1", { L"nested\\", L"file1.txt" });
+	source.AddFolder(L"c:\\folder1\\nested", { L"file2.txt" });
+	source.AddFolder(L"c:\\folder2", { L"file3.txt" });
+
+	std::ostringstream stream;
+	ListingWriter writer(stream, ListingFormat::Csv, { L"Folder", L"Name" });
+	ListingWalker walker(&source, &writer, { .recursive = true, .includeRelativeFolder = true });
+	EXPECT_EQ(walker.Walk(L"c:", {}), ListingWalker::Result::Completed);
+
+	EXPECT_EQ(stream.str(),
+		"\xEF\xBB\xBF"
+		"Folder,Name\r\n"
+		",folder1\r\n"
+		",folder2\r\n"
+		",file.txt\r\n"
+		"folder1,nested\r\n"
+		"folder1,file1.txt\r\n"
+		"folder1\\nested,file2.txt\r\n"
+		"folder2,file3.txt\r\n");
+
+	const auto &progress = walker.GetProgress();
+	EXPECT_EQ(progress.numItems, 7U);
+	EXPECT_EQ(progress.numFolders, 4U);
+	EXPECT_EQ(progress.numFoldersSkipped, 0U);
+}
+
+TEST(ListingWalkerTest, UnreadableFolderSkipped)
+{
+	FakeListingSource source;
+	source.AddFolder(L"c:", { L"denied\\", L"allowed\\" });
+	source.AddFolder(L"c:\\allowed", { L"file.txt" });
+
+	std::ostringstream stream;
+	ListingWriter writer(stream, ListingFormat::JsonLines, { L"Name" });
+	ListingWalker walker(&source, &writer, { .recursive = true });
+	EXPECT_EQ(walker.Walk(L"c:", {}), ListingWalker::Result::Completed);
+
+	EXPECT_EQ(walker.GetProgress().numItems, 3U);
+	EXPECT_EQ(walker.GetProgress().numFoldersSkipped, 1U);
+}
+
+TEST(ListingWalkerTest, Cancel)
+{
+	FakeListingSource source;
+	source.AddFolder(L"c:", { L"folder1\\", L"folder2\\" });
+	source.AddFolder(L"c:\\folder1", { L"file1.txt" });
+	source.AddFolder(L"c:\\folder2", { L"file2.txt" });
+
+	std::ostringstream stream;
+	ListingWriter writer(stream, ListingFormat::JsonLines, { L"Name" });
+	ListingWalker walker(&source, &writer, { .recursive = true });
+
+	std::stop_source stopSource;
+	auto result = walker.Walk(L"c:", stopSource.get_token(),
+		[&stopSource](const ListingWalker::Progress &progress)
+		{
+			if (progress.numFolders == 2)
+			{
+				stopSource.request_stop();
+			}
+		});
+
+	EXPECT_EQ(result, ListingWalker::Result::Cancelled);
+	EXPECT_EQ(source.GetEnumeratedFolders(),
+		(std::vector<std::wstring>{ L"c:", L"c:\\folder1" }));
+}
+
+TEST(ListingWalkerTest, WriteFailure)
+{
+	FakeListingSource source;
+	source.AddFolder(L"c:", { L"file.txt" });
+
+	std::ostringstream stream;
+	ListingWriter writer(stream, ListingFormat::JsonLines, { L"Name" }, 1);
+	stream.setstate(std::ios::badbit);
+
+	ListingWalker walker(&source, &writer, {});
+	EXPECT_EQ(walker.Walk(L"c:", {}), ListingWalker::Result::WriteFailed);
+}
+
+TEST(ListingWalkerTest, FileSystem)
+{
+	TemporaryTestFolder tempFolder("ListingWalkerTest");
+	const auto &root = tempFolder.GetPath();
+	std::filesystem::create_directories(root / "sub");
+	std::ofstream(root / "a.txt") << "12345";
+	std::ofstream(root / "sub" / "b.txt") << "1";
+
+	FileSystemListingSource source;
+	std::ostringstream stream;
+	ListingWriter writer(stream, ListingFormat::Tsv, { L"Folder", L"Name", L"Size" });
+	ListingWalker walker(&source, &writer, { .recursive = true, .includeRelativeFolder = true });
+	auto result = walker.Walk(root.wstring(), {});
+
+	EXPECT_EQ(result, ListingWalker::Result::Completed);
+	EXPECT_EQ(stream.str(),
+		"\xEF\xBB\xBF"
+		"Folder\tName\tSize\r\n"
+		"\ta.txt\t5\r\n"
+		"\tsub\t\r\n"
+		"sub\tb.txt\t1\r\n");
+}
+
+// Exports a generated tree of roughly a million items, to measure throughput and confirm that the
+// memory used for buffering doesn't grow with the size of the tree.
+TEST(ListingWalkerTest, DISABLED_LargeTreeThroughput)
+{
+	// 1 + 10 + 100 + 1000 folders, each containing 10 subfolders (except for the last level) and
+	// 900 files.
+	GeneratedListingSource source(3, 10, 900);
+
+	CountingStreamBuffer streamBuffer;
+	std::ostream stream(&streamBuffer);
+	ListingWriter writer(stream, ListingFormat::Csv, { L"Folder", L"Name", L"Size", L"Type" });
+	ListingWalker walker(&source, &writer, { .recursive = true, .includeRelativeFolder = true });
+
+	auto start = std::chrono::steady_clock::now();
+	auto result = walker.Walk(L"c:", {});
+	auto end = std::chrono::steady_clock::now();
+
+	EXPECT_EQ(result, ListingWalker::Result::Completed);
+
+	constexpr size_t NUM_FOLDERS = 1 + 10 + 100 + 1000;
+	constexpr size_t NUM_ITEMS = NUM_FOLDERS * 900 + (NUM_FOLDERS - 1);
+	EXPECT_EQ(walker.GetProgress().numItems, NUM_ITEMS);
+	EXPECT_EQ(walker.GetProgress().numFolders, NUM_FOLDERS);
+
+	auto elapsedMs = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+	testing::Test::RecordProperty("Items", static_cast<int>(NUM_ITEMS));
+	testing::Test::RecordProperty("ElapsedMs", static_cast<int>(elapsedMs));
+	testing::Test::RecordProperty("OutputBytes", static_cast<int>(streamBuffer.GetNumBytes()));
+	testing::Test::RecordProperty("PeakBufferBytes",
+		static_cast<int>(writer.GetPeakBufferSize()));
+
+	EXPECT_LT(writer.GetPeakBufferSize(), ListingWriter::DEFAULT_BUFFER_SIZE + 1024);
+}
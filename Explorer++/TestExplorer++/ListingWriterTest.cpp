@@ -0,0 +1,152 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "pch.h"
+#include "ListingWriter.h"
+#include <gtest/gtest.h>
+#include <sstream>
+
+namespace
+{
+
+const std::string UTF8_BOM = "\xEF\xBB\xBF";
+
+std::string WriteListing(ListingFormat format, const std::vector<std::wstring> &columnNames,
+	const std::vector<std::vector<std::wstring>> &items)
+{
+	std::ostringstream stream;
+	ListingWriter writer(stream, format, columnNames);
+
+	for (const auto &item : items)
+	{
+		EXPECT_TRUE(writer.WriteItem(item));
+	}
+
+	EXPECT_TRUE(writer.Finish());
+	EXPECT_EQ(writer.GetNumItemsWritten(), items.size());
+
+	return stream.str();
+}
+
+}
+
+TEST(ListingWriterTest, Csv)
+{
+	auto output = WriteListing(ListingFormat::Csv, { L"Name", L"Size" },
+		{ { L"file.txt", L"1 KB" }, { L"a,b", L"say \"hi\"" }, { L"line\nbreak", L" padded" } });
+
+	EXPECT_EQ(output,
+		UTF8_BOM
+			+ "Name,Size\r\n"
+			  "file.txt,1 KB\r\n"
+			  "\"a,b\",\"say \"\"hi\"\"\"\r\n"
+			  "\"line\nbreak\",\" padded\"\r\n");
+}
+
+TEST(ListingWriterTest, Tsv)
+{
+	auto output = WriteListing(ListingFormat::Tsv, { L"Name", L"Comment" },
+		{ { L"file.txt", L"a\tb" }, { L"c:\\path", L"line\r\nbreak" } });
+
+	EXPECT_EQ(output,
+		UTF8_BOM
+			+ "Name\tComment\r\n"
+			  "file.txt\ta\\tb\r\n"
+			  "c:\\\\path\tline\\r\\nbreak\r\n");
+}
+
+TEST(ListingWriterTest, JsonLines)
+{
+	auto output = WriteListing(ListingFormat::JsonLines, { L"Name", L"Size" },
+		{ { L"file.txt", L"1 KB" }, { L"c:\\\"quoted\"", std::wstring(1, L'\x01') } });
+
+	EXPECT_EQ(output,
+		"{\"Name\":\"file.txt\",\"Size\":\"1 KB\"}\n"
+		"{\"Name\":\"c:\\\\\\\"quoted\\\"\",\"Size\":\"\\u0001\"}\n");
+}
+
+TEST(ListingWriterTest, Xml)
+{
+	auto output = WriteListing(ListingFormat::Xml, { L"Name" },
+		{ { L"a&b <c>" }, { std::wstring(L"bad") + L'\x01' + L"char" } });
+
+	EXPECT_EQ(output,
+		"<?xml version=\"1.0\" encoding=\"UTF-8\"?>\r\n"
+		"<listing>\r\n"
+		"\t<item>\r\n"
+		"\t\t<value name=\"Name\">a&amp;b &lt;c&gt;</value>\r\n"
+		"\t</item>\r\n"
+		"\t<item>\r\n"
+		"\t\t<value name=\"Name\">badchar</value>\r\n"
+		"\t</item>\r\n"
+		"</listing>\r\n");
+}
+
+TEST(ListingWriterTest, Text)
+{
+	auto output = WriteListing(ListingFormat::Text, { L"Hash", L"Path" },
+		{ { L"0123", L"c:\\a b.txt" }, { L"4567", L"\u00e9" } });
+
+	EXPECT_EQ(output,
+		"0123  c:\\a b.txt\n"
+		"4567  \xC3\xA9\n");
+}
+
+TEST(ListingWriterTest, Empty)
+{
+	EXPECT_EQ(WriteListing(ListingFormat::JsonLines, { L"Name" }, {}), "");
+	EXPECT_EQ(WriteListing(ListingFormat::Csv, { L"Name" }, {}), UTF8_BOM + "Name\r\n");
+}
+
+TEST(ListingWriterTest, Utf8)
+{
+	std::string output;
+
+	ListingWriter::AppendUtf8(output, L"\u00e9\u4e2d");
+	EXPECT_EQ(output, "\xC3\xA9\xE4\xB8\xAD");
+
+	output.clear();
+	ListingWriter::AppendUtf8(output, L"\U0001F600");
+	EXPECT_EQ(output, "\xF0\x9F\x98\x80");
+
+	if constexpr (sizeof(wchar_t) == 2)
+	{
+		// An unpaired surrogate is valid in a Windows file name, but can't be encoded as UTF-8.
+		output.clear();
+		ListingWriter::AppendUtf8(output, std::wstring(1, static_cast<wchar_t>(0xD800)));
+		EXPECT_EQ(output, "\xEF\xBF\xBD");
+	}
+}
+
+TEST(ListingWriterTest, BufferIsBounded)
+{
+	constexpr size_t BUFFER_SIZE = 1024;
+
+	std::ostringstream stream;
+	ListingWriter writer(stream, ListingFormat::Csv, { L"Name" }, BUFFER_SIZE);
+
+	std::wstring name(100, 'a');
+
+	for (int i = 0; i < 10'000; i++)
+	{
+		ASSERT_TRUE(writer.WriteItem({ name }));
+	}
+
+	ASSERT_TRUE(writer.Finish());
+
+	// The buffer is only flushed once it's full, so it can exceed the limit by at most one item.
+	EXPECT_LT(writer.GetPeakBufferSize(), BUFFER_SIZE + name.size() + 3);
+	EXPECT_EQ(stream.str().size(), UTF8_BOM.size() + 6 + 10'000 * (name.size() + 2));
+}
+
+TEST(ListingWriterTest, WriteFailure)
+{
+	std::ostringstream stream;
+	ListingWriter writer(stream, ListingFormat::Csv, { L"Name" }, 16);
+
+	stream.setstate(std::ios::badbit);
+
+	EXPECT_FALSE(writer.WriteItem({ L"a long enough name to flush the buffer" }));
+	EXPECT_FALSE(writer.Finish());
+}
@@ -0,0 +1,108 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "pch.h"
+#include "Plugins/LuaExecutionBudget.h"
+#include <gtest/gtest.h>
+#include <sol/sol.hpp>
+#include <limits>
+
+using namespace Plugins;
+
+class LuaExecutionBudgetTest : public testing::Test
+{
+protected:
+	LuaExecutionBudgetTest() : m_budget(m_lua.lua_state())
+	{
+		m_lua.open_libraries(sol::lib::base);
+	}
+
+	LuaExecutionBudget::Outcome RunScript(const std::string &script,
+		const LuaExecutionBudget::Limits &limits = DEFAULT_LIMITS)
+	{
+		return m_budget.Run(limits,
+			[this, &script]
+			{ return m_lua.safe_script(script, sol::script_pass_on_error).valid(); });
+	}
+
+	static constexpr LuaExecutionBudget::Limits DEFAULT_LIMITS = { 1'000'000,
+		std::chrono::seconds(10) };
+
+	sol::state m_lua;
+	LuaExecutionBudget m_budget;
+};
+
+TEST_F(LuaExecutionBudgetTest, Completed)
+{
+	auto outcome = RunScript("local total = 0 for i = 1, 1000 do total = total + i end "
+							 "result = total");
+	EXPECT_EQ(outcome, LuaExecutionBudget::Outcome::Completed);
+	EXPECT_EQ(m_lua["result"].get<int>(), 500500);
+}
+
+TEST_F(LuaExecutionBudgetTest, Failed)
+{
+	auto outcome = RunScript("error('failed')");
+	EXPECT_EQ(outcome, LuaExecutionBudget::Outcome::Failed);
+}
+
+TEST_F(LuaExecutionBudgetTest, InstructionLimitExceeded)
+{
+	auto outcome = RunScript("while true do end");
+	EXPECT_EQ(outcome, LuaExecutionBudget::Outcome::InstructionLimitExceeded);
+	EXPECT_GE(m_budget.GetLastInstructionCount(), DEFAULT_LIMITS.maxInstructions);
+}
+
+TEST_F(LuaExecutionBudgetTest, TimeoutExceeded)
+{
+	auto outcome = RunScript("while true do end",
+		{ std::numeric_limits<uint64_t>::max(), std::chrono::milliseconds(50) });
+	EXPECT_EQ(outcome, LuaExecutionBudget::Outcome::TimeoutExceeded);
+}
+
+TEST_F(LuaExecutionBudgetTest, ErrorCantBeCaught)
+{
+	// The error raised when the limit is exceeded will be caught by pcall here. However, the
+	// error should be raised again as soon as the script continues.
+	auto outcome = RunScript("while true do pcall(function() while true do end end) end");
+	EXPECT_EQ(outcome, LuaExecutionBudget::Outcome::InstructionLimitExceeded);
+}
+
+TEST_F(LuaExecutionBudgetTest, Aborted)
+{
+	m_budget.RequestAbort();
+
+	auto outcome = RunScript("while true do end");
+	EXPECT_EQ(outcome, LuaExecutionBudget::Outcome::Aborted);
+
+	// Once an abort has been requested, all subsequent calls should also be stopped.
+	outcome = RunScript("while true do end");
+	EXPECT_EQ(outcome, LuaExecutionBudget::Outcome::Aborted);
+}
+
+TEST_F(LuaExecutionBudgetTest, BudgetResetBetweenCalls)
+{
+	LuaExecutionBudget::Limits limits = { 100'000, std::chrono::seconds(10) };
+
+	auto outcome = RunScript("while true do end", limits);
+	EXPECT_EQ(outcome, LuaExecutionBudget::Outcome::InstructionLimitExceeded);
+
+	// Each call should be given its own budget, so a call that exceeded its limit shouldn't affect
+	// the next one.
+	for (int i = 0; i < 10; i++)
+	{
+		outcome = RunScript("local total = 0 for i = 1, 1000 do total = total + i end", limits);
+		EXPECT_EQ(outcome, LuaExecutionBudget::Outcome::Completed);
+	}
+}
+
+TEST_F(LuaExecutionBudgetTest, CodeOutsideBudget)
+{
+	// Lua code run outside of a call to Run() shouldn't be limited.
+	auto result = m_lua.safe_script("local total = 0 for i = 1, 2000000 do total = total + 1 end "
+									"return total",
+		sol::script_pass_on_error);
+	ASSERT_TRUE(result.valid());
+	EXPECT_EQ(result.get<int>(), 2000000);
+}
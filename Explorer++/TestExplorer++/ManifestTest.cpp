@@ -27,3 +27,43 @@ TEST(ManifestTest, TestParsing)
 	EXPECT_EQ(manifest.version, L"1.0");
 	EXPECT_EQ(manifest.author, L"John Smith");
 }
+
+TEST(ManifestTest, ExecutionLimits)
+{
+	// clang-format off
+	nlohmann::json json = {
+		{"name", "Test plugin"},
+		{"description", "Test description"},
+		{"file", "plugin.lua"},
+		{"version", "1.0"},
+		{"author", "John Smith"},
+		{"execution_limits", {
+			{"max_instructions", 5000000},
+			{"timeout_ms", 250}
+		}}
+	};
+	// clang-format on
+
+	Plugins::Manifest manifest = json.get<Plugins::Manifest>();
+
+	EXPECT_EQ(manifest.executionLimits.maxInstructions, 5000000u);
+	EXPECT_EQ(manifest.executionLimits.timeout, std::chrono::milliseconds(250));
+}
+
+TEST(ManifestTest, DefaultExecutionLimits)
+{
+	// clang-format off
+	nlohmann::json json = {
+		{"name", "Test plugin"},
+		{"description", "Test description"},
+		{"file", "plugin.lua"},
+		{"version", "1.0"},
+		{"author", "John Smith"}
+	};
+	// clang-format on
+
+	Plugins::Manifest manifest = json.get<Plugins::Manifest>();
+
+	EXPECT_EQ(manifest.executionLimits.maxInstructions, std::nullopt);
+	EXPECT_EQ(manifest.executionLimits.timeout, std::nullopt);
+}
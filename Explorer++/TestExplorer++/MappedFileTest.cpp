@@ -0,0 +1,188 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "pch.h"
+#include "../Helper/MappedFile.h"
+#include "../Helper/MappedFileSearch.h"
+#include "../Helper/TextEncoding.h"
+#include "SparseFileTestHelper.h"
+#include "TemporaryPathTestHelper.h"
+#include <gtest/gtest.h>
+#include <thread>
+
+namespace
+{
+
+constexpr uint64_t GIGABYTE = 1024 * 1024 * 1024;
+
+std::string ToString(std::span<const std::byte> data)
+{
+	return { reinterpret_cast<const char *>(data.data()), data.size() };
+}
+
+std::span<const std::byte> AsBytes(std::string_view text)
+{
+	return std::as_bytes(std::span(text.data(), text.size()));
+}
+
+int GetNumSearchThreads()
+{
+	return static_cast<int>(std::max(std::thread::hardware_concurrency(), 1u));
+}
+
+}
+
+TEST(MappedFileTest, OpenFailure)
+{
+	EXPECT_EQ(MappedFile::Open(std::filesystem::temp_directory_path() / "MappedFileTest-missing"),
+		nullptr);
+}
+
+TEST(MappedFileTest, EmptyFile)
+{
+	TemporaryTestFile tempFile("MappedFileTest");
+	CreateSparseFile(tempFile.GetPath(), 0, {});
+
+	auto file = MappedFile::Open(tempFile.GetPath());
+	ASSERT_NE(file, nullptr);
+	EXPECT_EQ(file->GetSize(), 0u);
+
+	auto view = file->MapView(0, 100);
+	ASSERT_NE(view, nullptr);
+	EXPECT_TRUE(view->GetData().empty());
+
+	MappedFileReader reader(file);
+	EXPECT_TRUE(reader.Read(0, 10).empty());
+}
+
+TEST(MappedFileTest, MapUnalignedView)
+{
+	TemporaryTestFile tempFile("MappedFileTest");
+	CreateSparseFile(tempFile.GetPath(), 1'000'000, { { 123'457, "unaligned" } });
+
+	auto file = MappedFile::Open(tempFile.GetPath());
+	ASSERT_NE(file, nullptr);
+	EXPECT_EQ(file->GetSize(), 1'000'000u);
+
+	auto view = file->MapView(123'457, 9);
+	ASSERT_NE(view, nullptr);
+	EXPECT_EQ(view->GetOffset(), 123'457u);
+	EXPECT_EQ(ToString(view->GetData()), "unaligned");
+
+	// The view is clamped to the end of the file.
+	view = file->MapView(999'990, 100);
+	ASSERT_NE(view, nullptr);
+	EXPECT_EQ(view->GetData().size(), 10u);
+
+	view = file->MapView(1'000'000, 100);
+	ASSERT_NE(view, nullptr);
+	EXPECT_TRUE(view->GetData().empty());
+}
+
+TEST(MappedFileTest, ReaderCrossesWindowBoundaries)
+{
+	size_t windowSize = MappedFile::GetAllocationGranularity();
+
+	TemporaryTestFile tempFile("MappedFileTest");
+	CreateSparseFile(tempFile.GetPath(), windowSize * 10,
+		{ { windowSize - 3, "boundary" }, { windowSize * 5 + 1, "middle" },
+			{ windowSize * 10 - 4, "tail" } });
+
+	auto file = MappedFile::Open(tempFile.GetPath());
+	ASSERT_NE(file, nullptr);
+
+	MappedFileReader reader(file, windowSize, 2);
+
+	// A read that starts just before the end of a window is still returned in full.
+	EXPECT_EQ(ToString(reader.Read(windowSize - 3, 8)), "boundary");
+	EXPECT_EQ(ToString(reader.Read(windowSize * 5 + 1, 6)), "middle");
+	EXPECT_EQ(ToString(reader.Read(windowSize * 10 - 4, 100)), "tail");
+	EXPECT_TRUE(reader.Read(windowSize * 10, 1).empty());
+
+	// Only the most recently used windows stay mapped.
+	EXPECT_EQ(reader.GetNumMappedWindows(), 2u);
+	EXPECT_EQ(ToString(reader.Read(windowSize - 3, 8)), "boundary");
+	EXPECT_EQ(reader.GetNumMappedWindows(), 2u);
+}
+
+TEST(MappedFileTest, SearchSmallFile)
+{
+	TemporaryTestFile tempFile("MappedFileTest");
+	CreateSparseFile(tempFile.GetPath(), 1000,
+		{ { 100, "first Needle" }, { 500, "second needle" }, { 994, "needle" } });
+
+	auto file = MappedFile::Open(tempFile.GetPath());
+	ASSERT_NE(file, nullptr);
+
+	MappedFileSearchOptions options;
+	EXPECT_EQ(SearchMappedFile(*file, AsBytes("needle"), 0, 1000, options, 2), 507u);
+	EXPECT_EQ(SearchMappedFile(*file, AsBytes("needle"), 508, 1000, options, 2), 994u);
+
+	// The match has to start within the range, but can extend beyond it.
+	EXPECT_EQ(SearchMappedFile(*file, AsBytes("needle"), 508, 995, options, 2), 994u);
+	EXPECT_EQ(SearchMappedFile(*file, AsBytes("needle"), 508, 994, options, 2), std::nullopt);
+
+	options.caseSensitive = false;
+	EXPECT_EQ(SearchMappedFile(*file, AsBytes("needle"), 0, 1000, options, 2), 106u);
+}
+
+TEST(MappedFileTest, SearchAlignment)
+{
+	// The bytes of U+6120 U+6200 U+2000 contain the encoding of "ab" at an odd offset, even though
+	// the text doesn't contain those characters.
+	auto text = EncodeText(L"\x6120\x6200\x2000 ab", TextEncoding::Utf16LE);
+	std::string contents(reinterpret_cast<const char *>(text.data()), text.size());
+
+	TemporaryTestFile tempFile("MappedFileTest");
+	CreateSparseFile(tempFile.GetPath(), contents.size() + 2, { { 2, contents } });
+
+	auto file = MappedFile::Open(tempFile.GetPath());
+	ASSERT_NE(file, nullptr);
+
+	auto pattern = EncodeText(L"ab", TextEncoding::Utf16LE);
+	MappedFileSearchOptions options;
+	EXPECT_EQ(SearchMappedFile(*file, pattern, 0, file->GetSize(), options, 1), 3u);
+
+	options.alignment = 2;
+	EXPECT_EQ(SearchMappedFile(*file, pattern, 0, file->GetSize(), options, 1), 10u);
+}
+
+// Searches a file that's larger than 4 GiB (so that offsets don't fit in 32 bits), with matches
+// placed across a chunk boundary and close to the end.
+TEST(MappedFileTest, SearchMultiGigabyteSparseFile)
+{
+	uint64_t size = 4 * GIGABYTE + 12345;
+	uint64_t chunkBoundary = 32 * 1024 * 1024;
+
+	TemporaryTestFile tempFile("MappedFileTest");
+	CreateSparseFile(tempFile.GetPath(), size,
+		{ { chunkBoundary - 3, "marker-1" }, { 3 * GIGABYTE, "marker-2" },
+			{ size - 8, "marker-3" } });
+
+	auto file = MappedFile::Open(tempFile.GetPath());
+	ASSERT_NE(file, nullptr);
+	EXPECT_EQ(file->GetSize(), size);
+
+	MappedFileSearchOptions options;
+	int numThreads = GetNumSearchThreads();
+	auto pattern = AsBytes("marker");
+
+	auto match = SearchMappedFile(*file, pattern, 0, size, options, numThreads);
+	EXPECT_EQ(match, chunkBoundary - 3);
+
+	match = SearchMappedFile(*file, pattern, chunkBoundary - 2, size, options, numThreads);
+	EXPECT_EQ(match, 3 * GIGABYTE);
+
+	match = SearchMappedFile(*file, pattern, 3 * GIGABYTE + 1, size, options, numThreads);
+	EXPECT_EQ(match, size - 8);
+
+	EXPECT_EQ(SearchMappedFile(*file, AsBytes("absent"), 0, size, options, numThreads),
+		std::nullopt);
+
+	std::stop_source stopSource;
+	stopSource.request_stop();
+	EXPECT_EQ(SearchMappedFile(*file, pattern, 0, size, options, numThreads,
+				  stopSource.get_token()),
+		std::nullopt);
+}
@@ -6,10 +6,13 @@
 #include "ShellBrowser/NavigationManager.h"
 #include "GeneratorTestHelper.h"
 #include "NavigationRequestTestHelper.h"
+#include "ShellBrowser/FolderPrefetcher.h"
+#include "ShellBrowser/FolderSnapshotCache.h"
 #include "ShellBrowser/NavigationEvents.h"
 #include "ShellEnumeratorFake.h"
 #include "ShellTestHelper.h"
 #include "../Helper/UniqueThreadId.h"
+#include <gmock/gmock.h>
 #include <gtest/gtest.h>
 #include <future>
 
@@ -557,3 +560,28 @@ TEST_F(NavigationManagerLatestNavigationLifetimeTest, CancelledNavigation)
 	m_navigationManager->StopLoading();
 	RunExecutors();
 }
+
+TEST_F(NavigationManagerTest, CachedItemProviders)
+{
+	MockFunction<std::shared_ptr<const FolderSnapshot>(const NavigateParams &)> snapshotProvider;
+	MockFunction<std::shared_ptr<FolderPrefetch>(const NavigateParams &)> prefetchProvider;
+	m_navigationManager->SetSnapshotProvider(snapshotProvider.AsStdFunction());
+	m_navigationManager->SetPrefetchProvider(prefetchProvider.AsStdFunction());
+
+	PidlAbsolute pidl = CreateSimplePidlForTest(L"c:\\");
+	auto navigateParams = NavigateParams::Normal(pidl.Raw());
+
+	// When there's no snapshot, the prefetch provider should be queried.
+	EXPECT_CALL(snapshotProvider, Call(NavigateParamsMatch(navigateParams)))
+		.WillOnce(Return(nullptr));
+	EXPECT_CALL(prefetchProvider, Call(NavigateParamsMatch(navigateParams)))
+		.WillOnce(Return(nullptr));
+	CompleteNavigation(navigateParams);
+
+	// Neither provider should be queried if cached items can't be used (e.g. because the
+	// navigation is a refresh).
+	navigateParams.useCachedItems = false;
+	EXPECT_CALL(snapshotProvider, Call(_)).Times(0);
+	EXPECT_CALL(prefetchProvider, Call(_)).Times(0);
+	CompleteNavigation(navigateParams);
+}
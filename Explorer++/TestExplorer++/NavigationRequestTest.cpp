@@ -4,7 +4,10 @@
 
 #include "pch.h"
 #include "ShellBrowser/NavigationRequest.h"
+#include "FakeSystemClock.h"
 #include "NavigationRequestDelegateMock.h"
+#include "ShellBrowser/FolderPrefetcher.h"
+#include "ShellBrowser/FolderSnapshotCache.h"
 #include "ShellBrowser/NavigationEvents.h"
 #include "ShellBrowser/NavigationRequestDelegate.h"
 #include "ShellEnumeratorFake.h"
@@ -30,11 +33,13 @@ protected:
 		m_manualExecutorCurrent->shutdown();
 	}
 
-	std::unique_ptr<NavigationRequest> MakeNavigationRequest(const NavigateParams &navigateParams)
+	std::unique_ptr<NavigationRequest> MakeNavigationRequest(const NavigateParams &navigateParams,
+		std::shared_ptr<const FolderSnapshot> snapshot = nullptr,
+		std::shared_ptr<FolderPrefetch> prefetch = nullptr)
 	{
 		return std::make_unique<NavigationRequest>(nullptr, &m_navigationEvents, GetDelegate(),
 			m_shellEnumerator, m_manualExecutorBackground, m_manualExecutorCurrent, navigateParams,
-			m_stopSource.get_token());
+			m_stopSource.get_token(), snapshot, prefetch);
 	}
 
 	std::unique_ptr<NavigationRequest> MakeNavigationRequestForStateTest()
@@ -225,3 +230,112 @@ TEST_F(NavigationRequestSignalTest, CancelledNavigation)
 
 	request->Cancel();
 }
+
+TEST_F(NavigationRequestSignalTest, SnapshotNavigation)
+{
+	PidlAbsolute pidl = CreateSimplePidlForTest(L"c:\\");
+	auto navigateParams = NavigateParams::Normal(pidl.Raw());
+
+	auto snapshot = std::make_shared<FolderSnapshot>();
+	snapshot->pidlDirectory = pidl;
+
+	auto request = MakeNavigationRequest(navigateParams, snapshot);
+	EXPECT_EQ(request->GetSnapshot(), snapshot);
+
+	{
+		InSequence seq;
+
+		EXPECT_CALL(m_navigationStartedCallback, Call(request.get()));
+		EXPECT_CALL(m_strictDelegate, OnEnumerationCompleted(request.get()));
+		EXPECT_CALL(m_navigationWillCommitCallback, Call(request.get()));
+		EXPECT_CALL(m_navigationCommittedCallback, Call(request.get()));
+		EXPECT_CALL(m_strictDelegate, OnFinished(request.get()));
+	}
+
+	// When a snapshot is used, the folder shouldn't be enumerated as part of the navigation, so
+	// the navigation should succeed, even though enumerating the folder would fail.
+	m_shellEnumerator->SetShouldSucceed(false);
+	request->Start();
+	RunExecutors();
+
+	request->Commit();
+
+	EXPECT_EQ(m_shellEnumerator->GetNumEnumerations(), 0);
+}
+
+class NavigationRequestPrefetchTest : public NavigationRequestTest
+{
+protected:
+	NavigationRequestPrefetchTest() :
+		m_prefetcher(m_shellEnumerator, m_manualExecutorBackground, m_manualExecutorCurrent,
+			&m_systemClock, &m_stats),
+		m_pidlDirectory(CreateSimplePidlForTest(L"C:\\Fake", nullptr, ShellItemType::Folder))
+	{
+		auto pidlItem = CreateSimplePidlForTest(L"C:\\Fake\\item");
+		m_items.push_back(ILFindLastID(pidlItem.Raw()));
+		m_shellEnumerator->SetItems(m_pidlDirectory, m_items);
+	}
+
+	FakeSystemClock m_systemClock;
+	FolderPrefetchStats m_stats;
+	FolderPrefetcher m_prefetcher;
+	const PidlAbsolute m_pidlDirectory;
+	std::vector<PidlChild> m_items;
+};
+
+TEST_F(NavigationRequestPrefetchTest, CompletedPrefetch)
+{
+	m_prefetcher.Prefetch(m_pidlDirectory);
+	RunExecutors();
+
+	auto prefetch = m_prefetcher.TakePrefetch(m_pidlDirectory);
+	ASSERT_NE(prefetch, nullptr);
+
+	auto request =
+		MakeNavigationRequest(NavigateParams::Normal(m_pidlDirectory.Raw()), nullptr, prefetch);
+	request->Start();
+	RunExecutors();
+
+	EXPECT_EQ(request->GetState(), NavigationRequest::State::EnumerationFinished);
+	EXPECT_EQ(request->GetItems().size(), m_items.size());
+
+	// The navigation should have used the prefetched items, rather than enumerating the folder
+	// again.
+	EXPECT_EQ(m_shellEnumerator->GetNumEnumerations(), 1);
+}
+
+TEST_F(NavigationRequestPrefetchTest, InProgressPrefetch)
+{
+	m_prefetcher.Prefetch(m_pidlDirectory);
+
+	auto prefetch = m_prefetcher.TakePrefetch(m_pidlDirectory);
+	ASSERT_NE(prefetch, nullptr);
+
+	auto request =
+		MakeNavigationRequest(NavigateParams::Normal(m_pidlDirectory.Raw()), nullptr, prefetch);
+	request->Start();
+	RunExecutors();
+
+	EXPECT_EQ(request->GetState(), NavigationRequest::State::EnumerationFinished);
+	EXPECT_EQ(request->GetItems().size(), m_items.size());
+	EXPECT_EQ(m_shellEnumerator->GetNumEnumerations(), 1);
+}
+
+TEST_F(NavigationRequestPrefetchTest, StoppingNavigationStopsPrefetch)
+{
+	m_prefetcher.Prefetch(m_pidlDirectory);
+
+	auto prefetch = m_prefetcher.TakePrefetch(m_pidlDirectory);
+	ASSERT_NE(prefetch, nullptr);
+
+	auto request =
+		MakeNavigationRequest(NavigateParams::Normal(m_pidlDirectory.Raw()), nullptr, prefetch);
+	request->Start();
+	m_stopSource.request_stop();
+
+	EXPECT_TRUE(prefetch->stopSource.stop_requested());
+
+	RunExecutors();
+	EXPECT_TRUE(request->Stopped());
+	EXPECT_EQ(m_shellEnumerator->GetNumEnumerations(), 0);
+}
@@ -0,0 +1,63 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "pch.h"
+#include "../Helper/PackedPidlList.h"
+#include "ShellTestHelper.h"
+#include <gtest/gtest.h>
+
+TEST(PackedPidlListTest, Empty)
+{
+	PackedPidlList packedList;
+	EXPECT_TRUE(packedList.IsEmpty());
+	EXPECT_EQ(packedList.GetNumPidls(), 0u);
+	EXPECT_TRUE(packedList.Unpack(nullptr).empty());
+}
+
+TEST(PackedPidlListTest, ChildItems)
+{
+	PidlAbsolute parent = CreateSimplePidlForTest(L"C:\\Fake", nullptr, ShellItemType::Folder);
+	std::vector<PidlAbsolute> pidls = { CreateSimplePidlForTest(L"C:\\Fake\\item1"),
+		CreateSimplePidlForTest(L"C:\\Fake\\item2"),
+		CreateSimplePidlForTest(L"C:\\Fake\\item3") };
+
+	PackedPidlList packedList(parent.Raw(), pidls);
+	EXPECT_EQ(packedList.GetNumPidls(), pidls.size());
+	EXPECT_EQ(packedList.Unpack(parent.Raw()), pidls);
+
+	// Since each item is contained within the parent, only the child portion of each item should
+	// have been stored.
+	size_t totalSize = 0;
+
+	for (const auto &pidl : pidls)
+	{
+		totalSize += ILGetSize(pidl.Raw());
+	}
+
+	EXPECT_LT(packedList.GetSizeInBytes(), totalSize);
+}
+
+TEST(PackedPidlListTest, ItemsOutsideParent)
+{
+	PidlAbsolute parent = CreateSimplePidlForTest(L"C:\\Fake", nullptr, ShellItemType::Folder);
+	std::vector<PidlAbsolute> pidls = { CreateSimplePidlForTest(L"C:\\Fake\\item1"),
+		CreateSimplePidlForTest(L"C:\\Other\\item2"),
+		CreateSimplePidlForTest(L"C:\\Fake\\Subfolder\\item3"),
+		CreateSimplePidlForTest(L"D:\\item4") };
+
+	// Items that aren't within the parent should be stored in full and items nested further down
+	// should be stored relative to the parent.
+	PackedPidlList packedList(parent.Raw(), pidls);
+	EXPECT_EQ(packedList.GetNumPidls(), pidls.size());
+	EXPECT_EQ(packedList.Unpack(parent.Raw()), pidls);
+}
+
+TEST(PackedPidlListTest, NoParent)
+{
+	std::vector<PidlAbsolute> pidls = { CreateSimplePidlForTest(L"C:\\Fake\\item1"),
+		CreateSimplePidlForTest(L"D:\\item2") };
+
+	PackedPidlList packedList(nullptr, pidls);
+	EXPECT_EQ(packedList.Unpack(nullptr), pidls);
+}
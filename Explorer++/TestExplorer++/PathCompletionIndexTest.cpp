@@ -0,0 +1,266 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "pch.h"
+#include "PathCompletionIndex.h"
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <chrono>
+#include <format>
+
+using namespace testing;
+using Source = PathCompletionIndex::Source;
+
+namespace
+{
+
+std::vector<std::wstring> GetPaths(const std::vector<PathCompletionIndex::Match> &matches)
+{
+	std::vector<std::wstring> paths;
+
+	for (const auto &match : matches)
+	{
+		paths.push_back(match.path);
+	}
+
+	return paths;
+}
+
+}
+
+class PathCompletionIndexTest : public Test
+{
+protected:
+	std::vector<std::wstring> Query(std::wstring_view text, size_t maxResults = 100)
+	{
+		return GetPaths(m_index.Query(text, maxResults));
+	}
+
+	PathCompletionIndex m_index;
+};
+
+TEST_F(PathCompletionIndexTest, PrefixMatch)
+{
+	m_index.SetSourceScore(L"C:\\Users\\Public", Source::History, 1);
+	m_index.SetSourceScore(L"C:\\Users\\Default", Source::History, 2);
+	m_index.SetSourceScore(L"C:\\Windows", Source::History, 3);
+	m_index.SetSourceScore(L"D:\\Data", Source::History, 4);
+
+	EXPECT_THAT(Query(L"C:\\Users\\p"), ElementsAre(L"C:\\Users\\Public"));
+
+	// Matching should be case-insensitive and the original case should be returned.
+	EXPECT_THAT(Query(L"c:\\USERS\\P"), ElementsAre(L"C:\\Users\\Public"));
+
+	// Forward slashes should be treated as separators.
+	EXPECT_THAT(Query(L"c:/users/p"), ElementsAre(L"C:\\Users\\Public"));
+
+	// Everything under a directory should be returned once the separator has been entered.
+	EXPECT_THAT(Query(L"C:\\"), ElementsAre(L"C:\\Windows", L"C:\\Users\\Default",
+									L"C:\\Users\\Public"));
+
+	EXPECT_THAT(Query(L"C:\\Users\\x"), IsEmpty());
+	EXPECT_THAT(Query(L"E:\\"), IsEmpty());
+}
+
+TEST_F(PathCompletionIndexTest, DriveAndNetworkPaths)
+{
+	m_index.SetSourceScore(L"C:\\", Source::History, 2);
+	m_index.SetSourceScore(L"\\\\server\\share", Source::History, 1);
+
+	EXPECT_TRUE(m_index.ContainsPath(L"C:"));
+	EXPECT_TRUE(m_index.ContainsPath(L"C:\\"));
+	EXPECT_THAT(Query(L"c"), ElementsAre(L"C:\\"));
+	EXPECT_THAT(Query(L"\\\\ser"), ElementsAre(L"\\\\server\\share"));
+	EXPECT_THAT(Query(L""), ElementsAre(L"C:\\", L"\\\\server\\share"));
+}
+
+TEST_F(PathCompletionIndexTest, Ranking)
+{
+	m_index.SetSourceScore(L"C:\\a\\b\\c", Source::History, 5);
+	m_index.SetSourceScore(L"C:\\a", Source::History, 1);
+	m_index.SetSourceScore(L"C:\\a\\b", Source::History, 3);
+	m_index.SetSourceScore(L"C:\\x\\y", Source::History, 4);
+	m_index.SetSourceScore(L"C:\\x", Source::History, 2);
+
+	EXPECT_THAT(Query(L"C:\\"),
+		ElementsAre(L"C:\\a\\b\\c", L"C:\\x\\y", L"C:\\a\\b", L"C:\\x", L"C:\\a"));
+
+	// Only the best results should be returned when the number of results is limited.
+	EXPECT_THAT(Query(L"C:\\", 2), ElementsAre(L"C:\\a\\b\\c", L"C:\\x\\y"));
+
+	// Lowering a score should be reflected in the results.
+	m_index.SetSourceScore(L"C:\\a\\b\\c", Source::History, 0);
+	EXPECT_THAT(Query(L"C:\\", 2), ElementsAre(L"C:\\x\\y", L"C:\\a\\b"));
+}
+
+TEST_F(PathCompletionIndexTest, MultipleSources)
+{
+	m_index.SetSourceScore(L"C:\\Folder", Source::History, 1);
+	m_index.SetSourceScore(L"C:\\Folder", Source::Bookmark, 1);
+	m_index.SetSourceScore(L"C:\\Other", Source::History, 1.5f);
+
+	// The scores from each source should be combined, so the bookmarked folder should rank first.
+	auto matches = m_index.Query(L"C:\\", 10);
+	ASSERT_EQ(matches.size(), 2u);
+	EXPECT_EQ(matches[0].path, L"C:\\Folder");
+	EXPECT_FLOAT_EQ(matches[0].score, PathCompletionIndex::CombineScores(1, 1));
+
+	EXPECT_THAT(m_index.GetSourceScore(L"C:\\Folder", Source::Bookmark), Optional(1.0f));
+	EXPECT_EQ(m_index.GetSourceScore(L"C:\\Folder", Source::EnumeratedFolder), std::nullopt);
+
+	// The path should remain until every source has been removed.
+	m_index.ClearSourceScore(L"C:\\Folder", Source::History);
+	EXPECT_TRUE(m_index.ContainsPath(L"C:\\Folder"));
+	EXPECT_THAT(Query(L"C:\\"), ElementsAre(L"C:\\Other", L"C:\\Folder"));
+
+	m_index.ClearSourceScore(L"C:\\Folder", Source::Bookmark);
+	EXPECT_FALSE(m_index.ContainsPath(L"C:\\Folder"));
+	EXPECT_THAT(Query(L"C:\\"), ElementsAre(L"C:\\Other"));
+	EXPECT_EQ(m_index.GetNumPaths(), 1u);
+}
+
+TEST_F(PathCompletionIndexTest, AddToSourceScore)
+{
+	m_index.AddToSourceScore(L"C:\\Folder", Source::History, 1);
+	m_index.AddToSourceScore(L"C:\\Folder", Source::History, 1);
+
+	EXPECT_THAT(m_index.GetSourceScore(L"C:\\Folder", Source::History),
+		Optional(FloatEq(PathCompletionIndex::CombineScores(1, 1))));
+}
+
+TEST_F(PathCompletionIndexTest, RemovePaths)
+{
+	m_index.SetSourceScore(L"C:\\a\\b\\c", Source::History, 3);
+	m_index.SetSourceScore(L"C:\\a\\d", Source::History, 2);
+
+	m_index.ClearSourceScore(L"C:\\a\\b\\c", Source::History);
+	EXPECT_THAT(Query(L"C:\\a\\"), ElementsAre(L"C:\\a\\d"));
+
+	// Intermediate nodes that no longer lead anywhere should have been removed.
+	EXPECT_THAT(Query(L"C:\\a\\b\\"), IsEmpty());
+
+	// Clearing a path that doesn't exist should have no effect.
+	m_index.ClearSourceScore(L"C:\\missing", Source::History);
+	EXPECT_EQ(m_index.GetNumPaths(), 1u);
+
+	// Paths can be added again after they've been removed.
+	m_index.SetSourceScore(L"C:\\a\\b\\e", Source::History, 1);
+	EXPECT_THAT(Query(L"C:\\a\\"), ElementsAre(L"C:\\a\\d", L"C:\\a\\b\\e"));
+}
+
+TEST(PathCompletionIndexFrecencyTest, CalculateFrecency)
+{
+	auto now = std::chrono::system_clock::now();
+
+	// Later visits should be worth more.
+	EXPECT_GT(PathCompletionIndex::CalculateFrecency(1, now),
+		PathCompletionIndex::CalculateFrecency(1, now - std::chrono::days(1)));
+
+	// A visit should be worth half as much after each half-life.
+	EXPECT_NEAR(PathCompletionIndex::CalculateFrecency(1, now),
+		PathCompletionIndex::CalculateFrecency(2, now - PathCompletionIndex::FRECENCY_HALF_LIFE),
+		0.001);
+
+	// Two visits at the same time should be worth the same as a single visit with twice the
+	// weight.
+	float singleVisit = PathCompletionIndex::CalculateFrecency(1, now);
+	EXPECT_NEAR(PathCompletionIndex::CombineScores(singleVisit, singleVisit),
+		PathCompletionIndex::CalculateFrecency(2, now), 0.001);
+}
+
+TEST_F(PathCompletionIndexTest, TimeBudget)
+{
+	for (int i = 0; i < 1000; i++)
+	{
+		m_index.SetSourceScore(std::format(L"C:\\{}", i), Source::History, static_cast<float>(i));
+	}
+
+	// Whatever is returned when the budget runs out should still be the best matches, in order.
+	auto paths = GetPaths(m_index.Query(L"C:\\", 1000, std::chrono::microseconds(0)));
+	ASSERT_LE(paths.size(), 1000u);
+
+	for (size_t i = 0; i < paths.size(); i++)
+	{
+		EXPECT_EQ(paths[i], std::format(L"C:\\{}", 999 - i));
+	}
+}
+
+// Builds an index containing 1,000,000 paths and measures the time taken to build the index and to
+// run a variety of queries. The times are recorded as test properties.
+TEST(PathCompletionIndexBenchmarkTest, DISABLED_MillionPaths)
+{
+	constexpr int NUM_TOP_LEVEL_FOLDERS = 100;
+	constexpr int NUM_SECOND_LEVEL_FOLDERS = 100;
+	constexpr int NUM_THIRD_LEVEL_FOLDERS = 100;
+	constexpr size_t MAX_RESULTS = 50;
+
+	const std::vector<std::wstring> drives = { L"C:", L"D:", L"E:" };
+	auto now = std::chrono::system_clock::now();
+
+	PathCompletionIndex index;
+
+	auto start = std::chrono::steady_clock::now();
+
+	for (int i = 0; i < NUM_TOP_LEVEL_FOLDERS; i++)
+	{
+		for (int j = 0; j < NUM_SECOND_LEVEL_FOLDERS; j++)
+		{
+			for (int k = 0; k < NUM_THIRD_LEVEL_FOLDERS; k++)
+			{
+				int pathIndex =
+					(((i * NUM_SECOND_LEVEL_FOLDERS) + j) * NUM_THIRD_LEVEL_FOLDERS) + k;
+				auto path = std::format(L"{}\\Projects {}\\Module {}\\Folder {}",
+					drives[pathIndex % drives.size()], i, j, k);
+
+				// Give the paths a spread of visit times, so that the ranking isn't trivial.
+				auto visitTime = now - std::chrono::hours((pathIndex * 7919) % 10000);
+				index.SetSourceScore(path, Source::EnumeratedFolder,
+					PathCompletionIndex::CalculateFrecency(1, visitTime));
+			}
+		}
+	}
+
+	auto end = std::chrono::steady_clock::now();
+	testing::Test::RecordProperty("BuildMs",
+		static_cast<int>(
+			std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count()));
+
+	ASSERT_EQ(index.GetNumPaths(),
+		static_cast<size_t>(
+			NUM_TOP_LEVEL_FOLDERS * NUM_SECOND_LEVEL_FOLDERS * NUM_THIRD_LEVEL_FOLDERS));
+
+	struct QueryCase
+	{
+		std::string name;
+		std::wstring text;
+	};
+
+	const std::vector<QueryCase> queryCases = { { "Root", L"" }, { "Drive", L"C:\\" },
+		{ "PartialTopLevel", L"D:\\Projects 1" }, { "SecondLevel", L"E:\\Projects 42\\" },
+		{ "Deep", L"C:\\Projects 99\\Module 3\\Folder 1" }, { "NoMatch", L"Z:\\" } };
+
+	for (const auto &queryCase : queryCases)
+	{
+		start = std::chrono::steady_clock::now();
+		auto matches = index.Query(queryCase.text, MAX_RESULTS);
+		end = std::chrono::steady_clock::now();
+
+		testing::Test::RecordProperty(queryCase.name + "Us",
+			static_cast<int>(
+				std::chrono::duration_cast<std::chrono::microseconds>(end - start).count()));
+
+		if (queryCase.name == "NoMatch")
+		{
+			EXPECT_THAT(matches, IsEmpty());
+			continue;
+		}
+
+		EXPECT_THAT(matches, Not(IsEmpty())) << queryCase.name;
+
+		for (size_t i = 1; i < matches.size(); i++)
+		{
+			EXPECT_GE(matches[i - 1].score, matches[i].score) << queryCase.name;
+		}
+	}
+}
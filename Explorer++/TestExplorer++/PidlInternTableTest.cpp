@@ -0,0 +1,89 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "pch.h"
+#include "../Helper/PidlInternTable.h"
+#include "ShellTestHelper.h"
+#include <gtest/gtest.h>
+
+TEST(PidlInternTableTest, SamePidlShared)
+{
+	PidlInternTable internTable;
+
+	PidlAbsolute pidl1 = CreateSimplePidlForTest(L"C:\\Fake");
+	PidlAbsolute pidl2 = CreateSimplePidlForTest(L"C:\\Fake");
+
+	auto interned1 = internTable.Intern(pidl1.Raw());
+	auto interned2 = internTable.Intern(pidl2.Raw());
+
+	// Although the original pidls are separate copies, the interned pidls should be the same.
+	EXPECT_EQ(interned1, interned2);
+	EXPECT_NE(interned1->Raw(), pidl1.Raw());
+	EXPECT_EQ(*interned1, pidl1);
+	EXPECT_EQ(internTable.GetNumPidls(), 1u);
+	EXPECT_EQ(internTable.GetTotalSize(), ILGetSize(pidl1.Raw()));
+}
+
+TEST(PidlInternTableTest, DifferentPidls)
+{
+	PidlInternTable internTable;
+
+	PidlAbsolute pidl1 = CreateSimplePidlForTest(L"C:\\Fake1");
+	PidlAbsolute pidl2 = CreateSimplePidlForTest(L"C:\\Fake2");
+
+	auto interned1 = internTable.Intern(pidl1.Raw());
+	auto interned2 = internTable.Intern(pidl2.Raw());
+
+	EXPECT_NE(interned1, interned2);
+	EXPECT_EQ(*interned1, pidl1);
+	EXPECT_EQ(*interned2, pidl2);
+	EXPECT_EQ(internTable.GetNumPidls(), 2u);
+}
+
+TEST(PidlInternTableTest, Release)
+{
+	PidlInternTable internTable;
+
+	PidlAbsolute pidl = CreateSimplePidlForTest(L"C:\\Fake");
+	auto interned1 = internTable.Intern(pidl.Raw());
+	auto interned2 = internTable.Intern(pidl.Raw());
+
+	// The pidl should only be removed once the last reference is released.
+	interned1.reset();
+	EXPECT_EQ(internTable.GetNumPidls(), 1u);
+
+	interned2.reset();
+	EXPECT_EQ(internTable.GetNumPidls(), 0u);
+	EXPECT_EQ(internTable.GetTotalSize(), 0u);
+
+	// The pidl should be added again when next interned.
+	auto interned3 = internTable.Intern(pidl.Raw());
+	EXPECT_EQ(*interned3, pidl);
+	EXPECT_EQ(internTable.GetNumPidls(), 1u);
+}
+
+TEST(PidlInternTableTest, OutlivesTable)
+{
+	PidlInternTable::InternedPidl interned;
+	PidlAbsolute pidl = CreateSimplePidlForTest(L"C:\\Fake");
+
+	{
+		PidlInternTable internTable;
+		interned = internTable.Intern(pidl.Raw());
+	}
+
+	// An interned pidl should remain valid after the table has been destroyed.
+	EXPECT_EQ(*interned, pidl);
+	interned.reset();
+}
+
+TEST(PidlInternTableTest, NullPidl)
+{
+	PidlInternTable internTable;
+
+	auto interned = internTable.Intern(nullptr);
+	ASSERT_NE(interned, nullptr);
+	EXPECT_FALSE(interned->HasValue());
+	EXPECT_EQ(internTable.GetNumPidls(), 0u);
+}
@@ -0,0 +1,88 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "pch.h"
+#include "../Helper/PixelBuffer.h"
+#include <gtest/gtest.h>
+
+TEST(FitImageSizeTest, Landscape)
+{
+	EXPECT_EQ(FitImageSize({ 1600, 900 }, { 200, 200 }), (ImageSize{ 200, 113 }));
+	EXPECT_EQ(FitImageSize({ 1600, 900 }, { 400, 100 }), (ImageSize{ 178, 100 }));
+}
+
+TEST(FitImageSizeTest, Portrait)
+{
+	EXPECT_EQ(FitImageSize({ 300, 1200 }, { 200, 200 }), (ImageSize{ 50, 200 }));
+}
+
+TEST(FitImageSizeTest, Enlarge)
+{
+	EXPECT_EQ(FitImageSize({ 10, 5 }, { 100, 100 }), (ImageSize{ 100, 50 }));
+}
+
+TEST(FitImageSizeTest, Degenerate)
+{
+	EXPECT_EQ(FitImageSize({ 0, 100 }, { 200, 200 }), (ImageSize{ 1, 1 }));
+	EXPECT_EQ(FitImageSize({ 10000, 1 }, { 200, 200 }), (ImageSize{ 200, 1 }));
+}
+
+TEST(ResizeImageBoxFilterTest, AveragesBlocks)
+{
+	PixelBuffer source(4, 2);
+
+	// Left 2x2 block.
+	source.SetPixel(0, 0, 0xFF000000);
+	source.SetPixel(1, 0, 0xFF000010);
+	source.SetPixel(0, 1, 0xFF000020);
+	source.SetPixel(1, 1, 0xFF000030);
+
+	// Right 2x2 block.
+	source.SetPixel(2, 0, 0x00FF0000);
+	source.SetPixel(3, 0, 0x00FF0000);
+	source.SetPixel(2, 1, 0x00000000);
+	source.SetPixel(3, 1, 0x00000000);
+
+	auto destination = ResizeImageBoxFilter(source, { 2, 1 });
+	ASSERT_EQ(destination.width, 2);
+	ASSERT_EQ(destination.height, 1);
+	EXPECT_EQ(destination.GetPixel(0, 0), 0xFF000018u);
+
+	// 0xFF / 2 = 127.5, which rounds to 128.
+	EXPECT_EQ(destination.GetPixel(1, 0), 0x00800000u);
+}
+
+TEST(ResizeImageBoxFilterTest, UniformImage)
+{
+	PixelBuffer source(1920, 1080);
+	std::fill(source.pixels.begin(), source.pixels.end(), 0x80406020);
+
+	auto destination = ResizeImageBoxFilter(source, FitImageSize({ 1920, 1080 }, { 200, 200 }));
+	ASSERT_EQ(destination.width, 200);
+	ASSERT_EQ(destination.height, 113);
+
+	for (uint32_t pixel : destination.pixels)
+	{
+		EXPECT_EQ(pixel, 0x80406020u);
+	}
+}
+
+TEST(ResizeImageBoxFilterTest, Enlarge)
+{
+	PixelBuffer source(2, 1);
+	source.SetPixel(0, 0, 1);
+	source.SetPixel(1, 0, 2);
+
+	auto destination = ResizeImageBoxFilter(source, { 4, 2 });
+	ASSERT_EQ(destination.width, 4);
+	ASSERT_EQ(destination.height, 2);
+	EXPECT_THAT(destination.pixels, testing::ElementsAre(1, 1, 2, 2, 1, 1, 2, 2));
+}
+
+TEST(ResizeImageBoxFilterTest, Empty)
+{
+	auto destination = ResizeImageBoxFilter({}, { 10, 10 });
+	EXPECT_EQ(destination.width, 0);
+	EXPECT_TRUE(destination.pixels.empty());
+}
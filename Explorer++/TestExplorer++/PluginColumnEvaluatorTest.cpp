@@ -0,0 +1,228 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "pch.h"
+#include "Plugins/PluginColumnEvaluator.h"
+#include "../ThirdParty/CTPL/cpl_stl.h"
+#include <gtest/gtest.h>
+#include <sol/sol.hpp>
+#include <algorithm>
+#include <chrono>
+#include <format>
+#include <limits>
+#include <thread>
+
+using namespace Plugins;
+
+class PluginColumnEvaluatorTest : public testing::Test
+{
+protected:
+	PluginColumnEvaluatorTest()
+	{
+		m_lua.open_libraries(sol::lib::base, sol::lib::string);
+	}
+
+	std::optional<std::string> DumpScriptFunction(const std::string &script)
+	{
+		sol::protected_function function = m_lua.safe_script(script);
+		return PluginColumnEvaluator::DumpFunction(function);
+	}
+
+	std::unique_ptr<PluginColumnEvaluator> BuildEvaluator(const std::string &script,
+		PluginColumnSortType sortType = PluginColumnSortType::Text,
+		const LuaExecutionBudget::Limits &limits = DEFAULT_LIMITS)
+	{
+		auto bytecode = DumpScriptFunction(script);
+
+		if (!bytecode)
+		{
+			return nullptr;
+		}
+
+		return std::make_unique<PluginColumnEvaluator>(*bytecode,
+			std::vector<sol::lib>{ sol::lib::base, sol::lib::string }, sortType, limits);
+	}
+
+	static constexpr LuaExecutionBudget::Limits DEFAULT_LIMITS = { 1'000'000,
+		std::chrono::seconds(10) };
+
+	sol::state m_lua;
+};
+
+TEST_F(PluginColumnEvaluatorTest, DumpFunction)
+{
+	EXPECT_NE(DumpScriptFunction("return function(path) return #path end"), std::nullopt);
+
+	// Global values are fine, since they're looked up through _ENV.
+	EXPECT_NE(DumpScriptFunction("return function(path) return string.upper(path) end"),
+		std::nullopt);
+}
+
+TEST_F(PluginColumnEvaluatorTest, DumpFunctionWithUpvalue)
+{
+	// A local captured by the function won't exist in the isolated state, so the function should
+	// be rejected.
+	EXPECT_EQ(DumpScriptFunction("local suffix = '!' return function(path) return path .. suffix "
+								 "end"),
+		std::nullopt);
+}
+
+TEST_F(PluginColumnEvaluatorTest, DumpCFunction)
+{
+	EXPECT_EQ(DumpScriptFunction("return print"), std::nullopt);
+}
+
+TEST_F(PluginColumnEvaluatorTest, TextResult)
+{
+	auto evaluator = BuildEvaluator("return function(path) return string.upper(path) end");
+	ASSERT_NE(evaluator, nullptr);
+
+	auto value = evaluator->Evaluate(L"c:\\folder\\file.txt");
+	EXPECT_EQ(value.text, L"C:\\FOLDER\\FILE.TXT");
+	EXPECT_EQ(value.number, std::nullopt);
+}
+
+TEST_F(PluginColumnEvaluatorTest, NumberResult)
+{
+	auto evaluator = BuildEvaluator("return function(path) return #path end",
+		PluginColumnSortType::Number);
+	ASSERT_NE(evaluator, nullptr);
+
+	auto value = evaluator->Evaluate(L"c:\\file");
+	EXPECT_EQ(value.text, L"7");
+	EXPECT_EQ(value.number, 7.0);
+}
+
+TEST_F(PluginColumnEvaluatorTest, NumericStringResult)
+{
+	auto evaluator = BuildEvaluator(
+		"return function(path) if path == 'a' then return '12.5' else return 'abc' end end",
+		PluginColumnSortType::Number);
+	ASSERT_NE(evaluator, nullptr);
+
+	EXPECT_EQ(evaluator->Evaluate(L"a").number, 12.5);
+
+	// A string that can't be parsed as a number should still be shown, but won't be sorted
+	// numerically.
+	auto value = evaluator->Evaluate(L"b");
+	EXPECT_EQ(value.text, L"abc");
+	EXPECT_EQ(value.number, std::nullopt);
+}
+
+TEST_F(PluginColumnEvaluatorTest, NoResult)
+{
+	auto evaluator = BuildEvaluator("return function(path) end");
+	ASSERT_NE(evaluator, nullptr);
+
+	EXPECT_EQ(evaluator->Evaluate(L"c:\\file"), PluginColumnValue());
+}
+
+TEST_F(PluginColumnEvaluatorTest, Error)
+{
+	auto evaluator = BuildEvaluator("return function(path) error('failed') end");
+	ASSERT_NE(evaluator, nullptr);
+
+	EXPECT_EQ(evaluator->Evaluate(L"c:\\file"), PluginColumnValue());
+
+	// The state should remain usable after an error.
+	EXPECT_EQ(evaluator->GetNumStates(), 1U);
+	EXPECT_EQ(evaluator->Evaluate(L"c:\\file"), PluginColumnValue());
+	EXPECT_EQ(evaluator->GetNumStates(), 1U);
+}
+
+TEST_F(PluginColumnEvaluatorTest, BudgetExceeded)
+{
+	auto evaluator = BuildEvaluator("return function(path) while true do end end",
+		PluginColumnSortType::Text, { 100'000, std::chrono::seconds(10) });
+	ASSERT_NE(evaluator, nullptr);
+
+	EXPECT_EQ(evaluator->Evaluate(L"c:\\file"), PluginColumnValue());
+}
+
+TEST_F(PluginColumnEvaluatorTest, EvaluateBatch)
+{
+	auto evaluator = BuildEvaluator("return function(path) return #path end",
+		PluginColumnSortType::Number);
+	ASSERT_NE(evaluator, nullptr);
+
+	std::vector<std::wstring> paths;
+
+	for (int i = 0; i < 1000; i++)
+	{
+		paths.push_back(std::wstring(i % 50, 'a'));
+	}
+
+	ctpl::thread_pool threadPool(4);
+	auto values = evaluator->EvaluateBatch(paths, threadPool);
+	ASSERT_EQ(values.size(), paths.size());
+
+	for (size_t i = 0; i < paths.size(); i++)
+	{
+		EXPECT_EQ(values[i].number, static_cast<double>(paths[i].size()));
+	}
+
+	EXPECT_LE(evaluator->GetNumStates(), 4U);
+}
+
+TEST_F(PluginColumnEvaluatorTest, EvaluateBatchThroughput)
+{
+	constexpr int NUM_ITEMS = 100'000;
+
+	std::vector<std::wstring> paths;
+	paths.reserve(NUM_ITEMS);
+
+	for (int i = 0; i < NUM_ITEMS; i++)
+	{
+		paths.push_back(std::format(L"c:\\folder {}\\file {}.txt", i % 100, i));
+	}
+
+	// Each call does a non-trivial amount of work, so that the cost of evaluating the function
+	// dominates the cost of handing items between threads.
+	const std::string script = "return function(path) local total = 0 "
+							   "for i = 1, #path do total = total + string.byte(path, i) end "
+							   "return total end";
+
+	auto measure = [this, &paths, &script](int numThreads, size_t &numStates)
+	{
+		auto evaluator = BuildEvaluator(script, PluginColumnSortType::Number);
+		CHECK(evaluator);
+
+		ctpl::thread_pool threadPool(numThreads);
+
+		auto start = std::chrono::steady_clock::now();
+		auto values = evaluator->EvaluateBatch(paths, threadPool);
+		auto end = std::chrono::steady_clock::now();
+
+		EXPECT_EQ(values.size(), paths.size());
+		EXPECT_TRUE(std::ranges::all_of(values, [](const auto &value) { return value.number; }));
+
+		numStates = evaluator->GetNumStates();
+
+		return std::chrono::duration<double>(end - start).count();
+	};
+
+	int numCores = std::max(static_cast<int>(std::thread::hardware_concurrency()), 1);
+
+	size_t singleThreadStates;
+	double singleThreadSeconds = measure(1, singleThreadStates);
+
+	size_t multiThreadStates;
+	double multiThreadSeconds = measure(numCores, multiThreadStates);
+
+	testing::Test::RecordProperty("Cores", numCores);
+	testing::Test::RecordProperty("SingleThreadItemsPerSec",
+		static_cast<int>(NUM_ITEMS / std::max(singleThreadSeconds, 1e-6)));
+	testing::Test::RecordProperty("MultiThreadItemsPerSec",
+		static_cast<int>(NUM_ITEMS / std::max(multiThreadSeconds, 1e-6)));
+	testing::Test::RecordProperty("SpeedupPercent",
+		static_cast<int>(100 * singleThreadSeconds / std::max(multiThreadSeconds, 1e-6)));
+	testing::Test::RecordProperty("MultiThreadStates", static_cast<int>(multiThreadStates));
+
+	// A single thread should only ever need a single state. With multiple threads, a state is
+	// created for each thread that runs concurrently, so the number of states indicates how many
+	// cores were kept busy.
+	EXPECT_EQ(singleThreadStates, 1U);
+	EXPECT_GE(multiThreadStates, 1U);
+	EXPECT_LE(multiThreadStates, static_cast<size_t>(numCores));
+}
@@ -0,0 +1,186 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "pch.h"
+#include "Plugins/PluginColumnRegistry.h"
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <format>
+
+using namespace Plugins;
+using namespace testing;
+
+class PluginColumnRegistryTest : public Test
+{
+protected:
+	PluginColumnRegistryTest() : m_registry(1)
+	{
+	}
+
+	static PluginColumnDefinition BuildDefinition(const std::wstring &key,
+		const std::wstring &name = L"Name")
+	{
+		return { key, name, L"Description", nullptr };
+	}
+
+	PluginColumnRegistry m_registry;
+};
+
+TEST_F(PluginColumnRegistryTest, SlotsAssignedInKeyOrder)
+{
+	EXPECT_TRUE(m_registry.RegisterColumn(BuildDefinition(L"plugin-c/column")));
+	EXPECT_TRUE(m_registry.RegisterColumn(BuildDefinition(L"plugin-a/column")));
+	EXPECT_TRUE(m_registry.RegisterColumn(BuildDefinition(L"plugin-b/column")));
+
+	// Slots shouldn't be assigned until all plugins have loaded.
+	EXPECT_EQ(m_registry.GetColumnType(L"plugin-a/column"), std::nullopt);
+	EXPECT_THAT(m_registry.GetAssignedColumnTypes(), IsEmpty());
+
+	m_registry.AssignPendingSlots();
+
+	EXPECT_EQ(m_registry.GetColumnType(L"plugin-a/column"), +ColumnType::PluginColumn1);
+	EXPECT_EQ(m_registry.GetColumnType(L"plugin-b/column"), +ColumnType::PluginColumn2);
+	EXPECT_EQ(m_registry.GetColumnType(L"plugin-c/column"), +ColumnType::PluginColumn3);
+	EXPECT_THAT(m_registry.GetAssignedColumnTypes(),
+		ElementsAre(+ColumnType::PluginColumn1, +ColumnType::PluginColumn2,
+			+ColumnType::PluginColumn3));
+
+	const auto *column = m_registry.GetColumn(ColumnType::PluginColumn2);
+	ASSERT_NE(column, nullptr);
+	EXPECT_EQ(column->key, L"plugin-b/column");
+}
+
+TEST_F(PluginColumnRegistryTest, SlotAssignedImmediatelyAfterPendingSlots)
+{
+	m_registry.AssignPendingSlots();
+
+	MockFunction<void()> callback;
+	m_registry.AddColumnsChangedObserver(callback.AsStdFunction());
+	EXPECT_CALL(callback, Call());
+
+	EXPECT_TRUE(m_registry.RegisterColumn(BuildDefinition(L"plugin/column")));
+	EXPECT_EQ(m_registry.GetColumnType(L"plugin/column"), +ColumnType::PluginColumn1);
+}
+
+TEST_F(PluginColumnRegistryTest, NonPluginColumn)
+{
+	m_registry.RegisterColumn(BuildDefinition(L"plugin/column"));
+	m_registry.AssignPendingSlots();
+
+	EXPECT_EQ(m_registry.GetColumn(ColumnType::Name), nullptr);
+	EXPECT_EQ(m_registry.GetColumn(ColumnType::PluginColumn2), nullptr);
+}
+
+TEST_F(PluginColumnRegistryTest, NameConflict)
+{
+	EXPECT_TRUE(m_registry.RegisterColumn(BuildDefinition(L"plugin/column", L"Name 1")));
+	EXPECT_FALSE(m_registry.RegisterColumn(BuildDefinition(L"plugin/column", L"Name 2")));
+	EXPECT_TRUE(m_registry.RegisterColumn(BuildDefinition(L"plugin/column", L"Name 1")));
+}
+
+TEST_F(PluginColumnRegistryTest, SharedRegistration)
+{
+	m_registry.AssignPendingSlots();
+
+	m_registry.RegisterColumn(BuildDefinition(L"plugin/column"));
+	m_registry.RegisterColumn(BuildDefinition(L"plugin/column"));
+	EXPECT_EQ(m_registry.GetAssignedColumnTypes().size(), 1U);
+
+	MockFunction<void()> callback;
+	m_registry.AddColumnsChangedObserver(callback.AsStdFunction());
+
+	{
+		InSequence seq;
+
+		EXPECT_CALL(callback, Call()).Times(0);
+		m_registry.UnregisterColumn(L"plugin/column");
+		EXPECT_EQ(m_registry.GetColumnType(L"plugin/column"), +ColumnType::PluginColumn1);
+
+		// The slot should only be released once every registration has been removed.
+		EXPECT_CALL(callback, Call());
+		m_registry.UnregisterColumn(L"plugin/column");
+		EXPECT_EQ(m_registry.GetColumnType(L"plugin/column"), std::nullopt);
+		EXPECT_EQ(m_registry.GetColumn(ColumnType::PluginColumn1), nullptr);
+	}
+}
+
+TEST_F(PluginColumnRegistryTest, ReleasedSlotReserved)
+{
+	m_registry.RegisterColumn(BuildDefinition(L"plugin/column1"));
+	m_registry.RegisterColumn(BuildDefinition(L"plugin/column2"));
+	m_registry.AssignPendingSlots();
+
+	m_registry.UnregisterColumn(L"plugin/column1");
+
+	// The slot previously used by column1 should be kept for it, even though column1 is no longer
+	// registered.
+	m_registry.RegisterColumn(BuildDefinition(L"plugin/column3"));
+	EXPECT_EQ(m_registry.GetColumnType(L"plugin/column3"), +ColumnType::PluginColumn3);
+	EXPECT_EQ(m_registry.GetColumnType(L"plugin/column2"), +ColumnType::PluginColumn2);
+
+	m_registry.RegisterColumn(BuildDefinition(L"plugin/column1"));
+	EXPECT_EQ(m_registry.GetColumnType(L"plugin/column1"), +ColumnType::PluginColumn1);
+}
+
+TEST_F(PluginColumnRegistryTest, SlotsExhausted)
+{
+	for (int i = 0; i < NUM_PLUGIN_COLUMNS + 1; i++)
+	{
+		EXPECT_TRUE(m_registry.RegisterColumn(BuildDefinition(std::format(L"plugin/{:02}", i))));
+	}
+
+	m_registry.AssignPendingSlots();
+
+	EXPECT_EQ(m_registry.GetAssignedColumnTypes().size(),
+		static_cast<size_t>(NUM_PLUGIN_COLUMNS));
+	EXPECT_EQ(m_registry.GetColumnType(std::format(L"plugin/{:02}", NUM_PLUGIN_COLUMNS)),
+		std::nullopt);
+}
+
+TEST_F(PluginColumnRegistryTest, SavedSlotsUsed)
+{
+	m_registry.SetSlotAssignments({ { L"plugin-a/column", 2 }, { L"plugin-c/column", 0 } });
+
+	m_registry.RegisterColumn(BuildDefinition(L"plugin-a/column"));
+	m_registry.RegisterColumn(BuildDefinition(L"plugin-b/column"));
+	m_registry.RegisterColumn(BuildDefinition(L"plugin-c/column"));
+	m_registry.AssignPendingSlots();
+
+	EXPECT_EQ(m_registry.GetColumnType(L"plugin-a/column"), +ColumnType::PluginColumn3);
+	EXPECT_EQ(m_registry.GetColumnType(L"plugin-b/column"), +ColumnType::PluginColumn2);
+	EXPECT_EQ(m_registry.GetColumnType(L"plugin-c/column"), +ColumnType::PluginColumn1);
+	EXPECT_THAT(m_registry.GetSlotAssignments(),
+		UnorderedElementsAre(Pair(L"plugin-a/column", 2), Pair(L"plugin-b/column", 1),
+			Pair(L"plugin-c/column", 0)));
+}
+
+TEST_F(PluginColumnRegistryTest, InvalidSavedSlotsIgnored)
+{
+	m_registry.SetSlotAssignments({ { L"plugin-a/column", -1 },
+		{ L"plugin-b/column", NUM_PLUGIN_COLUMNS }, { L"plugin-c/column", 1 },
+		{ L"plugin-d/column", 1 } });
+
+	EXPECT_THAT(m_registry.GetSlotAssignments(), ElementsAre(Pair(L"plugin-c/column", 1)));
+}
+
+TEST_F(PluginColumnRegistryTest, ReservedSlotTakenWhenNoOtherSlotsFree)
+{
+	PluginColumnRegistry::SlotAssignments savedAssignments;
+
+	for (int i = 0; i < NUM_PLUGIN_COLUMNS; i++)
+	{
+		savedAssignments[std::format(L"old/{:02}", i)] = i;
+	}
+
+	m_registry.SetSlotAssignments(savedAssignments);
+	m_registry.AssignPendingSlots();
+
+	m_registry.RegisterColumn(BuildDefinition(L"plugin/column"));
+	EXPECT_EQ(m_registry.GetColumnType(L"plugin/column"), +ColumnType::PluginColumn1);
+
+	auto slotAssignments = m_registry.GetSlotAssignments();
+	EXPECT_EQ(slotAssignments.size(), static_cast<size_t>(NUM_PLUGIN_COLUMNS));
+	EXPECT_FALSE(slotAssignments.contains(L"old/00"));
+	EXPECT_EQ(slotAssignments[L"plugin/column"], 0);
+}
@@ -0,0 +1,29 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "pch.h"
+#include "PluginColumnSlotRegistryStorage.h"
+#include "Plugins/PluginColumnRegistry.h"
+#include "RegistryStorageTestHelper.h"
+#include <gtest/gtest.h>
+
+using namespace Plugins;
+
+class PluginColumnSlotRegistryStorageTest : public RegistryStorageTest
+{
+};
+
+TEST_F(PluginColumnSlotRegistryStorageTest, SaveLoad)
+{
+	PluginColumnRegistry referenceRegistry(1);
+	referenceRegistry.SetSlotAssignments(
+		{ { L"plugin-a/column", 2 }, { L"plugin-b/column", 0 }, { L"plugin-c/column", 5 } });
+
+	PluginColumnSlotRegistryStorage::Save(m_applicationTestKey.get(), &referenceRegistry);
+
+	PluginColumnRegistry loadedRegistry(1);
+	PluginColumnSlotRegistryStorage::Load(m_applicationTestKey.get(), &loadedRegistry);
+
+	EXPECT_EQ(loadedRegistry.GetSlotAssignments(), referenceRegistry.GetSlotAssignments());
+}
@@ -0,0 +1,32 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "pch.h"
+#include "PluginColumnSlotXmlStorage.h"
+#include "Plugins/PluginColumnRegistry.h"
+#include "XmlStorageTestHelper.h"
+#include <gtest/gtest.h>
+
+using namespace Plugins;
+
+class PluginColumnSlotXmlStorageTest : public XmlStorageTest
+{
+};
+
+TEST_F(PluginColumnSlotXmlStorageTest, SaveLoad)
+{
+	PluginColumnRegistry referenceRegistry(1);
+	referenceRegistry.SetSlotAssignments(
+		{ { L"plugin-a/column", 2 }, { L"plugin-b/column", 0 }, { L"plugin-c/column", 5 } });
+
+	auto xmlDocumentData = CreateXmlDocument();
+
+	PluginColumnSlotXmlStorage::Save(xmlDocumentData.xmlDocument.get(),
+		xmlDocumentData.rootNode.get(), &referenceRegistry);
+
+	PluginColumnRegistry loadedRegistry(1);
+	PluginColumnSlotXmlStorage::Load(xmlDocumentData.rootNode.get(), &loadedRegistry);
+
+	EXPECT_EQ(loadedRegistry.GetSlotAssignments(), referenceRegistry.GetSlotAssignments());
+}
@@ -8,6 +8,7 @@
 #include "BrowserWindowMock.h"
 #include "CommandLine.h"
 #include "Config.h"
+#include "MessageLoop.h"
 #include "../Helper/Helper.h"
 #include <gtest/gtest.h>
 
@@ -115,3 +116,93 @@ TEST_F(ProcessManagerTest, ExistingProcessOpenDirectories)
 	res = processData2.Initialize(windowName);
 	EXPECT_FALSE(res);
 }
+
+TEST_F(ProcessManagerTest, HandOffNoExistingProcess)
+{
+	CommandLine::Settings settings;
+	EXPECT_FALSE(
+		ProcessManager::AttemptHandOffToExistingProcess(&settings, CreateUniqueWindowName()));
+}
+
+TEST_F(ProcessManagerTest, HandOffOpenDirectories)
+{
+	auto windowName = CreateUniqueWindowName();
+
+	ProcessData processData;
+	processData.config.allowMultipleInstances = false;
+	auto res = processData.Initialize(windowName);
+	ASSERT_TRUE(res);
+
+	std::vector<std::wstring> directories = { L"c:\\", L"c:\\windows", L"c:\\users\\default" };
+
+	BrowserWindowMock browser;
+	processData.browserList.AddBrowser(&browser);
+
+	for (const auto &directory : directories)
+	{
+		EXPECT_CALL(browser, OpenItem(directory, OpenFolderDisposition::NewTabDefault));
+	}
+
+	// The request is acknowledged before the directories are opened, which then happens on this
+	// thread. The directories are opened together, so the window is only activated once.
+	MessageLoop messageLoop;
+	EXPECT_CALL(browser, Activate()).WillOnce([&messageLoop] { messageLoop.Stop(); });
+
+	CommandLine::Settings settings;
+	settings.directories = directories;
+	EXPECT_TRUE(ProcessManager::AttemptHandOffToExistingProcess(&settings, windowName));
+
+	messageLoop.Run();
+}
+
+TEST_F(ProcessManagerTest, HandOffMultipleInstancesAllowed)
+{
+	auto windowName = CreateUniqueWindowName();
+
+	ProcessData processData;
+	processData.config.allowMultipleInstances = true;
+	auto res = processData.Initialize(windowName);
+	ASSERT_TRUE(res);
+
+	BrowserWindowMock browser;
+	processData.browserList.AddBrowser(&browser);
+
+	CommandLine::Settings settings;
+	settings.directories = { L"c:\\" };
+	EXPECT_FALSE(ProcessManager::AttemptHandOffToExistingProcess(&settings, windowName));
+
+	// Requests from the jump list are always handled by the existing process.
+	MessageLoop messageLoop;
+	EXPECT_CALL(browser, OpenDefaultItem(OpenFolderDisposition::NewTabDefault));
+	EXPECT_CALL(browser, Activate()).WillOnce([&messageLoop] { messageLoop.Stop(); });
+
+	settings.jumplistNewTab = true;
+	EXPECT_TRUE(ProcessManager::AttemptHandOffToExistingProcess(&settings, windowName));
+
+	messageLoop.Run();
+}
+
+TEST_F(ProcessManagerTest, HandOffSettingChanged)
+{
+	auto windowName = CreateUniqueWindowName();
+
+	ProcessData processData;
+	processData.config.allowMultipleInstances = true;
+	auto res = processData.Initialize(windowName);
+	ASSERT_TRUE(res);
+
+	BrowserWindowMock browser;
+	processData.browserList.AddBrowser(&browser);
+
+	// Changes to the setting should be picked up by the existing process.
+	processData.config.allowMultipleInstances = false;
+
+	MessageLoop messageLoop;
+	EXPECT_CALL(browser, OpenDefaultItem(OpenFolderDisposition::NewTabDefault));
+	EXPECT_CALL(browser, Activate()).WillOnce([&messageLoop] { messageLoop.Stop(); });
+
+	CommandLine::Settings settings;
+	EXPECT_TRUE(ProcessManager::AttemptHandOffToExistingProcess(&settings, windowName));
+
+	messageLoop.Run();
+}
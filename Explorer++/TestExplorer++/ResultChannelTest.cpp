@@ -0,0 +1,329 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "pch.h"
+#include "../Helper/ResultChannel.h"
+#include <gtest/gtest.h>
+#include <mutex>
+#include <queue>
+#include <thread>
+
+using namespace std::chrono_literals;
+
+namespace
+{
+
+// Runs scheduled tasks on the thread that calls RunPendingTasks(), which acts as the consumer
+// thread.
+class TestScheduler
+{
+public:
+	ResultChannel<int>::Scheduler GetScheduler()
+	{
+		return [this](std::function<void()> task)
+		{
+			std::scoped_lock lock(m_mutex);
+			m_tasks.push(std::move(task));
+			m_numScheduled++;
+		};
+	}
+
+	void RunPendingTasks()
+	{
+		while (auto task = GetNextTask())
+		{
+			task();
+		}
+	}
+
+	int GetNumScheduled()
+	{
+		std::scoped_lock lock(m_mutex);
+		return m_numScheduled;
+	}
+
+private:
+	std::function<void()> GetNextTask()
+	{
+		std::scoped_lock lock(m_mutex);
+
+		if (m_tasks.empty())
+		{
+			return {};
+		}
+
+		auto task = std::move(m_tasks.front());
+		m_tasks.pop();
+		return task;
+	}
+
+	std::mutex m_mutex;
+	std::queue<std::function<void()>> m_tasks;
+	int m_numScheduled = 0;
+};
+
+}
+
+TEST(ResultChannelTest, SendAndProcess)
+{
+	TestScheduler scheduler;
+	std::vector<int> results;
+	ResultChannel<int> channel(scheduler.GetScheduler(),
+		[&results](int &&result) { results.push_back(result); });
+
+	auto sender = channel.GetSender();
+	sender.Send(1);
+	sender.Send(2);
+	sender.Send(3);
+
+	// Results shouldn't be processed until the scheduled task runs.
+	EXPECT_TRUE(results.empty());
+
+	scheduler.RunPendingTasks();
+	EXPECT_EQ(results, (std::vector<int>{ 1, 2, 3 }));
+}
+
+TEST(ResultChannelTest, CoalescedWakeUps)
+{
+	TestScheduler scheduler;
+	int numProcessed = 0;
+	ResultChannel<int> channel(scheduler.GetScheduler(),
+		[&numProcessed](int &&) { numProcessed++; });
+
+	auto sender = channel.GetSender();
+
+	for (int i = 0; i < 100; i++)
+	{
+		sender.Send(i);
+	}
+
+	// Only a single drain should be scheduled, regardless of how many results are sent.
+	EXPECT_EQ(scheduler.GetNumScheduled(), 1);
+
+	scheduler.RunPendingTasks();
+	EXPECT_EQ(numProcessed, 100);
+
+	// Once the queue has been drained, the next result should trigger another drain.
+	sender.Send(100);
+	EXPECT_EQ(scheduler.GetNumScheduled(), 2);
+
+	scheduler.RunPendingTasks();
+	EXPECT_EQ(numProcessed, 101);
+}
+
+TEST(ResultChannelTest, Invalidate)
+{
+	TestScheduler scheduler;
+	std::vector<int> results;
+	ResultChannel<int> channel(scheduler.GetScheduler(),
+		[&results](int &&result) { results.push_back(result); });
+
+	auto originalSender = channel.GetSender();
+	originalSender.Send(1);
+
+	channel.Invalidate();
+	EXPECT_NE(channel.GetGeneration(), originalSender.GetGeneration());
+
+	// Results from the previous generation should be discarded, regardless of whether they were
+	// sent before or after the channel was invalidated.
+	originalSender.Send(2);
+
+	auto updatedSender = channel.GetSender();
+	updatedSender.Send(3);
+
+	scheduler.RunPendingTasks();
+	EXPECT_EQ(results, (std::vector<int>{ 3 }));
+}
+
+TEST(ResultChannelTest, DrainBudget)
+{
+	TestScheduler scheduler;
+	std::vector<int> results;
+
+	// With a budget of zero, each drain will process a single result, before scheduling another
+	// drain.
+	ResultChannel<int> channel(
+		scheduler.GetScheduler(), [&results](int &&result) { results.push_back(result); }, 0ms);
+
+	auto sender = channel.GetSender();
+	sender.Send(1);
+	sender.Send(2);
+	sender.Send(3);
+
+	scheduler.RunPendingTasks();
+	EXPECT_EQ(results, (std::vector<int>{ 1, 2, 3 }));
+	EXPECT_EQ(scheduler.GetNumScheduled(), 3);
+}
+
+TEST(ResultChannelTest, MoveOnlyResult)
+{
+	std::vector<std::function<void()>> tasks;
+	std::vector<int> results;
+	ResultChannel<std::unique_ptr<int>> channel(
+		[&tasks](std::function<void()> task) { tasks.push_back(std::move(task)); },
+		[&results](std::unique_ptr<int> &&result) { results.push_back(*result); });
+
+	channel.GetSender().Send(std::make_unique<int>(42));
+
+	ASSERT_EQ(tasks.size(), 1u);
+	tasks[0]();
+	EXPECT_EQ(results, (std::vector<int>{ 42 }));
+}
+
+TEST(ResultChannelTest, SendAfterDestruction)
+{
+	TestScheduler scheduler;
+	int numProcessed = 0;
+	auto channel = std::make_unique<ResultChannel<int>>(scheduler.GetScheduler(),
+		[&numProcessed](int &&) { numProcessed++; });
+
+	auto sender = channel->GetSender();
+	sender.Send(1);
+
+	channel.reset();
+
+	// The sender keeps the queue alive, so this is safe, though the result will be ignored, as will
+	// the result sent above.
+	sender.Send(2);
+
+	scheduler.RunPendingTasks();
+	EXPECT_EQ(numProcessed, 0);
+}
+
+TEST(ResultChannelTest, DestroyedDuringProcessing)
+{
+	TestScheduler scheduler;
+	std::unique_ptr<ResultChannel<int>> channel;
+	int numProcessed = 0;
+	channel = std::make_unique<ResultChannel<int>>(scheduler.GetScheduler(),
+		[&channel, &numProcessed](int &&)
+		{
+			numProcessed++;
+			channel.reset();
+		});
+
+	auto sender = channel->GetSender();
+	sender.Send(1);
+	sender.Send(2);
+
+	scheduler.RunPendingTasks();
+	EXPECT_EQ(numProcessed, 1);
+}
+
+TEST(ResultChannelTest, MultipleProducersStress)
+{
+	constexpr int NUM_PRODUCERS = 8;
+	constexpr int RESULTS_PER_PRODUCER = 50000;
+
+	TestScheduler scheduler;
+	std::vector<int> lastValues(NUM_PRODUCERS, -1);
+	int numProcessed = 0;
+	bool inOrder = true;
+
+	// Each result encodes the producer and a per-producer sequence number, so that it's possible to
+	// check that every result is delivered exactly once and that results from a single producer
+	// are delivered in order.
+	ResultChannel<int> channel(scheduler.GetScheduler(),
+		[&](int &&result)
+		{
+			int producer = result / RESULTS_PER_PRODUCER;
+			int value = result % RESULTS_PER_PRODUCER;
+
+			if (value != lastValues[producer] + 1)
+			{
+				inOrder = false;
+			}
+
+			lastValues[producer] = value;
+			numProcessed++;
+		},
+		100us);
+
+	std::atomic_int numProducersFinished = 0;
+	std::vector<std::jthread> producers;
+
+	for (int i = 0; i < NUM_PRODUCERS; i++)
+	{
+		producers.emplace_back(
+			[sender = channel.GetSender(), i, &numProducersFinished]()
+			{
+				for (int j = 0; j < RESULTS_PER_PRODUCER; j++)
+				{
+					sender.Send((i * RESULTS_PER_PRODUCER) + j);
+				}
+
+				numProducersFinished++;
+			});
+	}
+
+	while (numProducersFinished < NUM_PRODUCERS)
+	{
+		scheduler.RunPendingTasks();
+	}
+
+	producers.clear();
+	scheduler.RunPendingTasks();
+
+	EXPECT_EQ(numProcessed, NUM_PRODUCERS * RESULTS_PER_PRODUCER);
+	EXPECT_TRUE(inOrder);
+
+	for (int lastValue : lastValues)
+	{
+		EXPECT_EQ(lastValue, RESULTS_PER_PRODUCER - 1);
+	}
+
+	// Results are coalesced, so there should be substantially fewer wake-ups than results.
+	EXPECT_LT(scheduler.GetNumScheduled(), NUM_PRODUCERS * RESULTS_PER_PRODUCER);
+}
+
+TEST(ResultChannelTest, InvalidateWhileProducing)
+{
+	constexpr int NUM_PRODUCERS = 4;
+	constexpr int RESULTS_PER_PRODUCER = 20000;
+
+	TestScheduler scheduler;
+	ResultChannel<int>::Generation currentGeneration = 0;
+	int numStaleResults = 0;
+
+	// Each result is the generation of the sender that produced it, so any result that doesn't
+	// match the current generation shouldn't have been processed.
+	ResultChannel<int> channel(scheduler.GetScheduler(),
+		[&](int &&result)
+		{
+			if (static_cast<ResultChannel<int>::Generation>(result) != currentGeneration)
+			{
+				numStaleResults++;
+			}
+		});
+
+	std::atomic_int numProducersFinished = 0;
+	std::vector<std::jthread> producers;
+
+	for (int i = 0; i < NUM_PRODUCERS; i++)
+	{
+		producers.emplace_back(
+			[sender = channel.GetSender(), &numProducersFinished]()
+			{
+				for (int j = 0; j < RESULTS_PER_PRODUCER; j++)
+				{
+					sender.Send(static_cast<int>(sender.GetGeneration()));
+				}
+
+				numProducersFinished++;
+			});
+	}
+
+	channel.Invalidate();
+	currentGeneration = channel.GetGeneration();
+
+	while (numProducersFinished < NUM_PRODUCERS)
+	{
+		scheduler.RunPendingTasks();
+	}
+
+	producers.clear();
+	scheduler.RunPendingTasks();
+
+	EXPECT_EQ(numStaleResults, 0);
+}
@@ -15,11 +15,15 @@ TEST(RuntimeTest, RetrievalMethods)
 	auto rawUiThreadExecutor = uiThreadExecutor.get();
 	auto comStaExecutor = std::make_shared<ComStaThreadPoolExecutor>(1);
 	auto rawComStaExecutor = comStaExecutor.get();
+	auto backgroundJobExecutor = std::make_shared<ComStaThreadPoolExecutor>(1);
+	auto rawBackgroundJobExecutor = backgroundJobExecutor.get();
 
-	Runtime runtime(std::move(uiThreadExecutor), std::move(comStaExecutor));
+	Runtime runtime(std::move(uiThreadExecutor), std::move(comStaExecutor),
+		std::move(backgroundJobExecutor));
 
 	EXPECT_EQ(runtime.GetUiThreadExecutor().get(), rawUiThreadExecutor);
 	EXPECT_EQ(runtime.GetComStaExecutor().get(), rawComStaExecutor);
+	EXPECT_EQ(runtime.GetBackgroundJobExecutor().get(), rawBackgroundJobExecutor);
 	EXPECT_TRUE(runtime.IsUiThread());
 
 	RunTaskOnExecutorForTest(runtime.GetComStaExecutor(),
@@ -11,5 +11,6 @@
 Runtime BuildRuntimeForTest()
 {
 	return Runtime(std::make_unique<UIThreadExecutor>(),
+		std::make_unique<ComStaThreadPoolExecutor>(1),
 		std::make_unique<ComStaThreadPoolExecutor>(1));
 }
@@ -71,6 +71,11 @@ FolderSettings ShellBrowserFake::GetFolderSettings() const
 	return {};
 }
 
+FolderColumns ShellBrowserFake::ExportAllColumns()
+{
+	return {};
+}
+
 ShellNavigationController *ShellBrowserFake::GetNavigationController() const
 {
 	return m_navigationController.get();
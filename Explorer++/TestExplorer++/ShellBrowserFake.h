@@ -35,6 +35,7 @@ public:
 
 	// ShellBrowser
 	FolderSettings GetFolderSettings() const override;
+	FolderColumns ExportAllColumns() override;
 	ShellNavigationController *GetNavigationController() const override;
 
 protected:
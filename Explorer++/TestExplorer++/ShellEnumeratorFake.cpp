@@ -4,18 +4,45 @@
 
 #include "pch.h"
 #include "ShellEnumeratorFake.h"
+#include <algorithm>
 
 HRESULT ShellEnumeratorFake::EnumerateDirectory(PCIDLIST_ABSOLUTE pidlDirectory,
 	std::vector<PidlChild> &outputItems, std::stop_token stopToken) const
 {
-	UNREFERENCED_PARAMETER(pidlDirectory);
-	UNREFERENCED_PARAMETER(outputItems);
 	UNREFERENCED_PARAMETER(stopToken);
 
-	return m_shouldSucceed ? S_OK : E_FAIL;
+	m_numEnumerations++;
+
+	if (!m_shouldSucceed)
+	{
+		return E_FAIL;
+	}
+
+	auto itr = std::ranges::find_if(m_directoryItems, [pidlDirectory](const auto &directoryItems)
+		{ return ArePidlsEquivalent(directoryItems.first.Raw(), pidlDirectory); });
+
+	if (itr != m_directoryItems.end())
+	{
+		outputItems = itr->second;
+	}
+
+	return S_OK;
 }
 
 void ShellEnumeratorFake::SetShouldSucceed(bool shouldSucceed)
 {
 	m_shouldSucceed = shouldSucceed;
 }
+
+void ShellEnumeratorFake::SetItems(const PidlAbsolute &pidlDirectory,
+	const std::vector<PidlChild> &items)
+{
+	std::erase_if(m_directoryItems, [&pidlDirectory](const auto &directoryItems)
+		{ return directoryItems.first == pidlDirectory; });
+	m_directoryItems.emplace_back(pidlDirectory, items);
+}
+
+int ShellEnumeratorFake::GetNumEnumerations() const
+{
+	return m_numEnumerations;
+}
@@ -5,6 +5,8 @@
 #pragma once
 
 #include "ShellEnumerator.h"
+#include <utility>
+#include <vector>
 
 class ShellEnumeratorFake : public ShellEnumerator
 {
@@ -14,6 +16,14 @@ public:
 
 	void SetShouldSucceed(bool shouldSucceed);
 
+	// Sets the items that will be returned when the specified directory is enumerated. A directory
+	// that hasn't been set up here contains no items.
+	void SetItems(const PidlAbsolute &pidlDirectory, const std::vector<PidlChild> &items);
+
+	int GetNumEnumerations() const;
+
 private:
 	bool m_shouldSucceed = true;
+	std::vector<std::pair<PidlAbsolute, std::vector<PidlChild>>> m_directoryItems;
+	mutable int m_numEnumerations = 0;
 };
@@ -11,9 +11,11 @@
 #include "TabNavigationMock.h"
 #include "../Explorer++/ShellBrowser/HistoryEntry.h"
 #include "../Explorer++/ShellBrowser/PreservedHistoryEntry.h"
+#include "../Helper/PidlInternTable.h"
 #include "../Helper/ShellHelper.h"
 #include <gtest/gtest.h>
 #include <ShlObj.h>
+#include <format>
 
 using namespace testing;
 
@@ -176,6 +178,118 @@ TEST_F(ShellNavigationControllerTest, BackForwardItemSelection)
 	EXPECT_EQ(currentEntry->GetSelectedItems(), selectedItems2);
 }
 
+TEST_F(ShellNavigationControllerTest, MaxEntries)
+{
+	std::vector<PidlAbsolute> pidls;
+
+	for (int i = 0; i < 5; i++)
+	{
+		PidlAbsolute pidl;
+		m_shellBrowser.NavigateToPath(std::format(L"C:\\Fake{}", i), HistoryEntryType::AddEntry,
+			&pidl);
+		pidls.push_back(pidl);
+	}
+
+	auto *navigationController = GetNavigationController();
+
+	// The oldest entries should be removed.
+	navigationController->SetMaxEntries(3);
+	ASSERT_EQ(navigationController->GetNumHistoryEntries(), 3);
+	EXPECT_EQ(navigationController->GetCurrentIndex(), 2);
+	EXPECT_EQ(navigationController->GetEntryAtIndex(0)->GetPidl(), pidls[2]);
+
+	// Additional entries should then result in the oldest entry being removed.
+	PidlAbsolute pidl;
+	m_shellBrowser.NavigateToPath(L"C:\\Fake5", HistoryEntryType::AddEntry, &pidl);
+	pidls.push_back(pidl);
+	ASSERT_EQ(navigationController->GetNumHistoryEntries(), 3);
+	EXPECT_EQ(navigationController->GetCurrentIndex(), 2);
+	EXPECT_EQ(navigationController->GetEntryAtIndex(0)->GetPidl(), pidls[3]);
+
+	navigationController->GoBack();
+	navigationController->GoBack();
+	ASSERT_EQ(navigationController->GetCurrentIndex(), 0);
+
+	// There are no back entries here, so the most distant forward entry should be removed instead.
+	// The current entry should always be retained.
+	navigationController->SetMaxEntries(2);
+	ASSERT_EQ(navigationController->GetNumHistoryEntries(), 2);
+	EXPECT_EQ(navigationController->GetCurrentIndex(), 0);
+	EXPECT_EQ(navigationController->GetCurrentEntry()->GetPidl(), pidls[3]);
+	EXPECT_EQ(navigationController->GetEntryAtIndex(1)->GetPidl(), pidls[4]);
+}
+
+// Performs 100,000 navigations, storing a set of selected items for each entry, and records the
+// memory used by the retained history. The figures are recorded as test properties.
+TEST_F(ShellNavigationControllerTest, DISABLED_HistoryMemoryUsage)
+{
+	constexpr int NUM_NAVIGATIONS = 100'000;
+	constexpr int NUM_FOLDERS = 100;
+	constexpr int NUM_SELECTED_ITEMS = 10;
+	constexpr int MAX_ENTRIES = 500;
+
+	auto *navigationController = GetNavigationController();
+	navigationController->SetMaxEntries(MAX_ENTRIES);
+
+	std::vector<std::vector<PidlAbsolute>> selectedItemsPerFolder;
+
+	for (int i = 0; i < NUM_FOLDERS; i++)
+	{
+		std::vector<PidlAbsolute> selectedItems;
+
+		for (int j = 0; j < NUM_SELECTED_ITEMS; j++)
+		{
+			selectedItems.push_back(
+				CreateSimplePidlForTest(std::format(L"C:\\Folder{}\\Item{}", i, j)));
+		}
+
+		selectedItemsPerFolder.push_back(std::move(selectedItems));
+	}
+
+	// A limited set of folders is used, so that many entries share the same folder, as would
+	// happen when repeatedly navigating between a small set of folders.
+	for (int i = 0; i < NUM_NAVIGATIONS; i++)
+	{
+		int folderIndex = (i * 7) % NUM_FOLDERS;
+		m_shellBrowser.NavigateToPath(std::format(L"C:\\Folder{}", folderIndex));
+		navigationController->GetCurrentEntry()->SetSelectedItems(
+			selectedItemsPerFolder[folderIndex]);
+	}
+
+	ASSERT_EQ(navigationController->GetNumHistoryEntries(), MAX_ENTRIES);
+
+	size_t entryBytes = 0;
+	size_t unsharedBytes = 0;
+
+	for (int i = 0; i < navigationController->GetNumHistoryEntries(); i++)
+	{
+		auto *entry = navigationController->GetEntryAtIndex(i);
+		entryBytes += entry->GetMemoryUsage();
+
+		// The amount of memory that would be used if each entry stored its own pidl, along with a
+		// separately allocated pidl for each selected item.
+		unsharedBytes += sizeof(HistoryEntry) + ILGetSize(entry->GetPidl().Raw());
+
+		for (const auto &selectedItem : entry->GetSelectedItems())
+		{
+			unsharedBytes += sizeof(PidlAbsolute) + ILGetSize(selectedItem.Raw());
+		}
+	}
+
+	const auto &internTable = PidlInternTable::GetInstance();
+
+	// Each folder should only be stored once, regardless of how many entries refer to it.
+	EXPECT_LE(internTable.GetNumPidls(), static_cast<size_t>(NUM_FOLDERS));
+
+	testing::Test::RecordProperty("NumEntries", navigationController->GetNumHistoryEntries());
+	testing::Test::RecordProperty("NumInternedPidls", static_cast<int>(internTable.GetNumPidls()));
+	testing::Test::RecordProperty("EntryBytes",
+		static_cast<int>(entryBytes + internTable.GetTotalSize()));
+	testing::Test::RecordProperty("UnsharedBytes", static_cast<int>(unsharedBytes));
+
+	EXPECT_LT(entryBytes + internTable.GetTotalSize(), unsharedBytes);
+}
+
 TEST_F(ShellNavigationControllerTest, RetrieveHistory)
 {
 	m_shellBrowser.NavigateToPath(L"C:\\Fake1");
@@ -0,0 +1,31 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "pch.h"
+#include "ShellBrowser/SortModes.h"
+#include <gtest/gtest.h>
+
+TEST(SortModesTest, EncodeDecodeSortKeys)
+{
+	std::vector<SortKey> sortKeys = { { SortMode::Type, SortDirection::Ascending },
+		{ SortMode::DateModified, SortDirection::Descending } };
+
+	auto encodedSortKeys = EncodeSortKeys(sortKeys);
+	EXPECT_EQ(encodedSortKeys, L"4:0,2:1");
+	EXPECT_EQ(DecodeSortKeys(encodedSortKeys), sortKeys);
+}
+
+TEST(SortModesTest, DecodeEmptySortKeys)
+{
+	EXPECT_TRUE(EncodeSortKeys({}).empty());
+	EXPECT_TRUE(DecodeSortKeys(L"").empty());
+}
+
+TEST(SortModesTest, DecodeInvalidSortKeys)
+{
+	// Invalid entries should be skipped.
+	auto sortKeys = DecodeSortKeys(L"4:0,abc,1000:0,2:7,1-1,3:1");
+	EXPECT_EQ(sortKeys, (std::vector<SortKey>{ { SortMode::Type, SortDirection::Ascending },
+							{ SortMode::Size, SortDirection::Descending } }));
+}
@@ -0,0 +1,244 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "pch.h"
+#include "ShellBrowser/SortedInsertion.h"
+#include <gtest/gtest.h>
+#include <chrono>
+#include <random>
+#include <string>
+
+namespace
+{
+
+struct TestItem
+{
+	int type;
+	std::wstring name;
+	int date;
+
+	// Used to check that items that compare equal retain their original order.
+	int sequence;
+};
+
+int Compare(int value1, int value2)
+{
+	return (value1 > value2) - (value1 < value2);
+}
+
+// Sorts by type, then by name, then by date (descending), which mirrors the way a set of secondary
+// sort keys is applied.
+int CompareMultiKey(const TestItem &item1, const TestItem &item2)
+{
+	if (int result = Compare(item1.type, item2.type); result != 0)
+	{
+		return result;
+	}
+
+	if (int result = item1.name.compare(item2.name); result != 0)
+	{
+		return result;
+	}
+
+	return -Compare(item1.date, item2.date);
+}
+
+std::vector<TestItem> InsertIntoSortedItems(const std::vector<TestItem> &existingItems,
+	std::vector<TestItem> newItems)
+{
+	auto positions = SortedInsertion::MergeIntoSortedRange(newItems,
+		static_cast<int>(existingItems.size()), CompareMultiKey,
+		[&existingItems](const TestItem &item, int index)
+		{ return CompareMultiKey(item, existingItems[index]); });
+
+	auto items = existingItems;
+
+	for (size_t i = 0; i < newItems.size(); i++)
+	{
+		items.insert(items.begin() + positions[i], newItems[i]);
+	}
+
+	return items;
+}
+
+std::vector<int> GetSequences(const std::vector<TestItem> &items)
+{
+	std::vector<int> sequences;
+
+	for (const auto &item : items)
+	{
+		sequences.push_back(item.sequence);
+	}
+
+	return sequences;
+}
+
+std::vector<TestItem> BuildRandomItems(int numItems, int firstSequence, std::mt19937 &generator)
+{
+	std::uniform_int_distribution<int> typeDistribution(0, 9);
+	std::uniform_int_distribution<int> nameDistribution(0, 999);
+	std::uniform_int_distribution<int> dateDistribution(0, 99);
+
+	std::vector<TestItem> items;
+	items.reserve(numItems);
+
+	for (int i = 0; i < numItems; i++)
+	{
+		items.push_back({ typeDistribution(generator),
+			L"item" + std::to_wstring(nameDistribution(generator)), dateDistribution(generator),
+			firstSequence + i });
+	}
+
+	return items;
+}
+
+}
+
+TEST(SortedInsertionTest, FindInsertPosition)
+{
+	std::vector<int> values = { 1, 3, 5, 7 };
+
+	auto findPosition = [&values](int value)
+	{
+		return SortedInsertion::FindInsertPosition(0, static_cast<int>(values.size()),
+			[&values, value](int index) { return Compare(value, values[index]); });
+	};
+
+	EXPECT_EQ(findPosition(0), 0);
+	EXPECT_EQ(findPosition(2), 1);
+	EXPECT_EQ(findPosition(6), 3);
+	EXPECT_EQ(findPosition(8), 4);
+
+	// An equal item should be placed after the existing item.
+	EXPECT_EQ(findPosition(3), 2);
+}
+
+TEST(SortedInsertionTest, FindInsertPositionEmpty)
+{
+	EXPECT_EQ(SortedInsertion::FindInsertPosition(0, 0, [](int) { return 0; }), 0);
+}
+
+TEST(SortedInsertionTest, InsertionIsStable)
+{
+	std::vector<TestItem> existingItems = { { 1, L"a", 5, 0 }, { 1, L"a", 5, 1 },
+		{ 2, L"b", 5, 2 } };
+
+	// All of these items are equal to the first two existing items and should be placed after them,
+	// in their original order.
+	std::vector<TestItem> newItems = { { 1, L"a", 5, 3 }, { 1, L"a", 5, 4 }, { 1, L"a", 5, 5 } };
+
+	auto items = InsertIntoSortedItems(existingItems, newItems);
+	EXPECT_EQ(GetSequences(items), (std::vector<int>{ 0, 1, 3, 4, 5, 2 }));
+}
+
+TEST(SortedInsertionTest, MultiKeyOrder)
+{
+	std::vector<TestItem> existingItems = { { 1, L"a", 1, 0 }, { 1, L"b", 9, 1 },
+		{ 1, L"b", 2, 2 }, { 2, L"a", 5, 3 } };
+
+	std::vector<TestItem> newItems = { { 2, L"a", 7, 4 }, { 1, L"b", 5, 5 }, { 0, L"z", 0, 6 },
+		{ 1, L"a", 3, 7 } };
+
+	auto items = InsertIntoSortedItems(existingItems, newItems);
+	EXPECT_EQ(GetSequences(items), (std::vector<int>{ 6, 7, 0, 1, 5, 2, 4, 3 }));
+}
+
+TEST(SortedInsertionTest, MatchesStableSort)
+{
+	std::mt19937 generator(1);
+
+	for (int round = 0; round < 20; round++)
+	{
+		auto existingItems = BuildRandomItems(500, 0, generator);
+		std::stable_sort(existingItems.begin(), existingItems.end(),
+			[](const TestItem &item1, const TestItem &item2)
+			{ return CompareMultiKey(item1, item2) < 0; });
+
+		auto newItems = BuildRandomItems(50, 500, generator);
+
+		// Inserting the new items should give the same result as appending them and performing a
+		// stable sort of the entire set.
+		auto expectedItems = existingItems;
+		expectedItems.insert(expectedItems.end(), newItems.begin(), newItems.end());
+		std::stable_sort(expectedItems.begin(), expectedItems.end(),
+			[](const TestItem &item1, const TestItem &item2)
+			{ return CompareMultiKey(item1, item2) < 0; });
+
+		auto items = InsertIntoSortedItems(existingItems, newItems);
+		EXPECT_EQ(GetSequences(items), GetSequences(expectedItems));
+	}
+}
+
+// Measures the time taken to insert 10,000 items into a sorted set of 500,000 items, both by
+// merging the new items and by re-sorting the entire set. The times are recorded as test
+// properties.
+TEST(SortedInsertionTest, DISABLED_InsertionBenchmark)
+{
+	constexpr int NUM_EXISTING_ITEMS = 500'000;
+	constexpr int NUM_NEW_ITEMS = 10'000;
+
+	std::mt19937 generator(1);
+	auto existingItems = BuildRandomItems(NUM_EXISTING_ITEMS, 0, generator);
+	std::stable_sort(existingItems.begin(), existingItems.end(),
+		[](const TestItem &item1, const TestItem &item2)
+		{ return CompareMultiKey(item1, item2) < 0; });
+
+	auto newItems = BuildRandomItems(NUM_NEW_ITEMS, NUM_EXISTING_ITEMS, generator);
+
+	auto mergeStart = std::chrono::steady_clock::now();
+
+	auto sortedNewItems = newItems;
+	int numComparisons = 0;
+	auto positions = SortedInsertion::MergeIntoSortedRange(sortedNewItems, NUM_EXISTING_ITEMS,
+		CompareMultiKey,
+		[&existingItems, &numComparisons](const TestItem &item, int index)
+		{
+			numComparisons++;
+			return CompareMultiKey(item, existingItems[index]);
+		});
+
+	// Builds the merged set in a single pass, which is equivalent to inserting each item at its
+	// position.
+	std::vector<TestItem> mergedItems;
+	mergedItems.reserve(NUM_EXISTING_ITEMS + NUM_NEW_ITEMS);
+	size_t existingIndex = 0;
+
+	for (size_t i = 0; i < sortedNewItems.size(); i++)
+	{
+		while (mergedItems.size() < static_cast<size_t>(positions[i]))
+		{
+			mergedItems.push_back(existingItems[existingIndex++]);
+		}
+
+		mergedItems.push_back(sortedNewItems[i]);
+	}
+
+	mergedItems.insert(mergedItems.end(), existingItems.begin() + existingIndex,
+		existingItems.end());
+
+	auto mergeEnd = std::chrono::steady_clock::now();
+
+	auto resortStart = std::chrono::steady_clock::now();
+
+	auto resortedItems = existingItems;
+	resortedItems.insert(resortedItems.end(), newItems.begin(), newItems.end());
+	std::stable_sort(resortedItems.begin(), resortedItems.end(),
+		[](const TestItem &item1, const TestItem &item2)
+		{ return CompareMultiKey(item1, item2) < 0; });
+
+	auto resortEnd = std::chrono::steady_clock::now();
+
+	testing::Test::RecordProperty("MergeMs",
+		static_cast<int>(
+			std::chrono::duration_cast<std::chrono::milliseconds>(mergeEnd - mergeStart).count()));
+	auto resortDuration =
+		std::chrono::duration_cast<std::chrono::milliseconds>(resortEnd - resortStart);
+	testing::Test::RecordProperty("ResortMs", static_cast<int>(resortDuration.count()));
+	testing::Test::RecordProperty("MergeComparisons", numComparisons);
+
+	EXPECT_EQ(GetSequences(mergedItems), GetSequences(resortedItems));
+
+	// Each new item requires at most a binary search of the existing items.
+	EXPECT_LE(numComparisons, NUM_NEW_ITEMS * 20);
+}
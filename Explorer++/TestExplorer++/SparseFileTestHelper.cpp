@@ -0,0 +1,35 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "pch.h"
+#include "SparseFileTestHelper.h"
+#include <fstream>
+
+void CreateSparseFile(const std::filesystem::path &path, uint64_t size,
+	const std::vector<std::pair<uint64_t, std::string>> &writes)
+{
+	{
+		std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+	}
+
+#ifdef _WIN32
+	// NTFS files aren't sparse by default, so writing near the end of the file would otherwise
+	// require everything before it to be filled with zeroes.
+	wil::unique_hfile file(CreateFile(path.c_str(), GENERIC_READ | GENERIC_WRITE, 0, nullptr,
+		OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr));
+	DWORD bytesReturned;
+	DeviceIoControl(file.get(), FSCTL_SET_SPARSE, nullptr, 0, nullptr, 0, &bytesReturned, nullptr);
+	file.reset();
+#endif
+
+	std::filesystem::resize_file(path, size);
+
+	std::fstream stream(path, std::ios::binary | std::ios::in | std::ios::out);
+
+	for (const auto &[offset, data] : writes)
+	{
+		stream.seekp(static_cast<std::streamoff>(offset));
+		stream.write(data.data(), static_cast<std::streamsize>(data.size()));
+	}
+}
@@ -0,0 +1,17 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Creates a sparse file of the specified size, with each piece of data written at its offset. The
+// rest of the file reads as zeroes, without taking up any space on disk, which allows tests to use
+// multi-gigabyte files.
+void CreateSparseFile(const std::filesystem::path &path, uint64_t size,
+	const std::vector<std::pair<uint64_t, std::string>> &writes);
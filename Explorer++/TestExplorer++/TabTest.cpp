@@ -5,12 +5,15 @@
 #include "pch.h"
 #include "Tab.h"
 #include "BrowserWindowMock.h"
+#include "ShellBrowser/FolderSettings.h"
 #include "ShellBrowser/NavigationEvents.h"
+#include "ShellBrowser/PreservedHistoryEntry.h"
 #include "ShellBrowser/ShellNavigationController.h"
 #include "ShellBrowserFake.h"
 #include "ShellTestHelper.h"
 #include "TabEvents.h"
 #include "TabNavigationMock.h"
+#include "TabStorage.h"
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
@@ -129,3 +132,39 @@ TEST_F(TabTest, GetBrowser)
 
 	EXPECT_EQ(tab.GetBrowser(), &m_browser);
 }
+
+TEST_F(TabTest, GetStorageData)
+{
+	Tab::InitialData initialData;
+	initialData.useCustomName = true;
+	initialData.customName = L"Custom tab name";
+	initialData.lockState = Tab::LockState::Locked;
+	auto tab = BuildTab(initialData);
+
+	PidlAbsolute pidl = CreateSimplePidlForTest(L"c:\\fake");
+	auto navigateParams = NavigateParams::Normal(pidl.Raw());
+	tab.GetShellBrowser()->GetNavigationController()->Navigate(navigateParams);
+
+	auto storageData = tab.GetStorageData();
+	EXPECT_EQ(storageData.pidl, pidl);
+	EXPECT_EQ(storageData.directory, L"c:\\fake");
+	EXPECT_EQ(storageData.tabSettings.name, initialData.customName);
+	EXPECT_EQ(storageData.tabSettings.lockState, initialData.lockState);
+}
+
+TEST_F(TabTest, GetStorageDataWithoutNavigation)
+{
+	// This mirrors a restored tab that's dormant. The browser is set up with the folder the tab
+	// should show, but no navigation has taken place yet.
+	std::vector<std::unique_ptr<PreservedHistoryEntry>> preservedEntries;
+	PidlAbsolute pidl = CreateSimplePidlForTest(L"c:\\restored");
+	preservedEntries.push_back(std::make_unique<PreservedHistoryEntry>(pidl));
+
+	auto shellBrowser = std::make_unique<ShellBrowserFake>(&m_navigationEvents, &m_tabNavigation,
+		preservedEntries, 0);
+	Tab tab(std::move(shellBrowser), &m_browser, nullptr, &m_tabEvents);
+
+	auto storageData = tab.GetStorageData();
+	EXPECT_EQ(storageData.pidl, pidl);
+	EXPECT_EQ(storageData.directory, L"c:\\restored");
+}
@@ -0,0 +1,65 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "pch.h"
+#include "Plugins/TabsApi/TabsApi.h"
+#include "BrowserWindowMock.h"
+#include "ShellBrowser/NavigationEvents.h"
+#include "ShellBrowser/PreservedHistoryEntry.h"
+#include "ShellBrowser/ShellNavigationController.h"
+#include "ShellBrowserFake.h"
+#include "ShellTestHelper.h"
+#include "TabEvents.h"
+#include "TabNavigationMock.h"
+#include <gtest/gtest.h>
+
+using namespace testing;
+
+class TabsApiTest : public Test
+{
+protected:
+	NavigationEvents m_navigationEvents;
+	TabNavigationMock m_tabNavigation;
+	BrowserWindowMock m_browser;
+	TabEvents m_tabEvents;
+};
+
+TEST_F(TabsApiTest, TabProperties)
+{
+	Tab::InitialData initialData;
+	initialData.useCustomName = true;
+	initialData.customName = L"Custom tab name";
+	initialData.lockState = Tab::LockState::AddressLocked;
+
+	::Tab tabInternal(std::make_unique<ShellBrowserFake>(&m_navigationEvents, &m_tabNavigation),
+		&m_browser, nullptr, &m_tabEvents, initialData);
+
+	PidlAbsolute pidl = CreateSimplePidlForTest(L"c:\\fake");
+	auto navigateParams = NavigateParams::Normal(pidl.Raw());
+	tabInternal.GetShellBrowser()->GetNavigationController()->Navigate(navigateParams);
+
+	Plugins::TabsApi::Tab tab(tabInternal);
+	EXPECT_EQ(tab.id, tabInternal.GetId());
+	EXPECT_EQ(tab.location, L"c:\\fake");
+	EXPECT_EQ(tab.name, initialData.customName);
+	EXPECT_FALSE(tab.locked);
+	EXPECT_TRUE(tab.addressLocked);
+}
+
+TEST_F(TabsApiTest, LocationWithoutNavigation)
+{
+	// This mirrors a restored tab that's dormant. The browser is set up with the folder the tab
+	// should show, but no navigation has taken place yet.
+	std::vector<std::unique_ptr<PreservedHistoryEntry>> preservedEntries;
+	PidlAbsolute pidl = CreateSimplePidlForTest(L"c:\\restored");
+	preservedEntries.push_back(std::make_unique<PreservedHistoryEntry>(pidl));
+
+	auto shellBrowser = std::make_unique<ShellBrowserFake>(&m_navigationEvents, &m_tabNavigation,
+		preservedEntries, 0);
+	::Tab tabInternal(std::move(shellBrowser), &m_browser, nullptr, &m_tabEvents);
+
+	Plugins::TabsApi::Tab tab(tabInternal);
+	EXPECT_EQ(tab.location, L"c:\\restored");
+	EXPECT_EQ(tab.name, L"restored");
+}
@@ -0,0 +1,77 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "pch.h"
+#include "TemporaryPathTestHelper.h"
+#include <atomic>
+#include <cstdint>
+#include <format>
+#include <random>
+
+namespace
+{
+
+uint64_t GenerateProcessToken()
+{
+	std::random_device randomDevice;
+	return (static_cast<uint64_t>(randomDevice()) << 32) | randomDevice();
+}
+
+}
+
+std::filesystem::path GetUniqueTempPath(std::string_view prefix)
+{
+	static const uint64_t processToken = GenerateProcessToken();
+	static std::atomic<uint64_t> counter = 0;
+
+	return std::filesystem::temp_directory_path()
+		/ std::format("{}-{}-{}", prefix, processToken, counter++);
+}
+
+TemporaryTestFile::TemporaryTestFile(std::string_view prefix) : m_path(GetUniqueTempPath(prefix))
+{
+}
+
+TemporaryTestFile::~TemporaryTestFile()
+{
+	std::error_code error;
+	std::filesystem::remove(m_path, error);
+}
+
+const std::filesystem::path &TemporaryTestFile::GetPath() const
+{
+	return m_path;
+}
+
+TemporaryTestFolder::TemporaryTestFolder(std::string_view prefix) :
+	m_path(CreateUniqueFolder(prefix))
+{
+}
+
+TemporaryTestFolder::~TemporaryTestFolder()
+{
+	std::error_code error;
+	std::filesystem::remove_all(m_path, error);
+}
+
+const std::filesystem::path &TemporaryTestFolder::GetPath() const
+{
+	return m_path;
+}
+
+std::filesystem::path TemporaryTestFolder::CreateUniqueFolder(std::string_view prefix)
+{
+	// create_directory() only returns true if the folder didn't previously exist. So, even in the
+	// unlikely event that a path is reused (e.g. by a process left over from a previous run), a
+	// folder will never be shared.
+	while (true)
+	{
+		auto path = GetUniqueTempPath(prefix);
+
+		if (std::filesystem::create_directory(path))
+		{
+			return path;
+		}
+	}
+}
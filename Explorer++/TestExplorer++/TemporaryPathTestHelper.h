@@ -0,0 +1,43 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#pragma once
+
+#include <boost/core/noncopyable.hpp>
+#include <filesystem>
+#include <string_view>
+
+// Returns a path within the temp folder that no other call will return. Each path contains a
+// random value chosen once per process, along with a per-process counter, so that tests running in
+// parallel (whether in the same process or in separate processes) won't use the same path.
+std::filesystem::path GetUniqueTempPath(std::string_view prefix);
+
+// A file within the temp folder, which is deleted when this object is destroyed.
+class TemporaryTestFile : private boost::noncopyable
+{
+public:
+	explicit TemporaryTestFile(std::string_view prefix);
+	~TemporaryTestFile();
+
+	const std::filesystem::path &GetPath() const;
+
+private:
+	const std::filesystem::path m_path;
+};
+
+// A folder within the temp folder. The folder is created when this object is constructed and is
+// deleted, along with its contents, when this object is destroyed.
+class TemporaryTestFolder : private boost::noncopyable
+{
+public:
+	explicit TemporaryTestFolder(std::string_view prefix);
+	~TemporaryTestFolder();
+
+	const std::filesystem::path &GetPath() const;
+
+private:
+	static std::filesystem::path CreateUniqueFolder(std::string_view prefix);
+
+	const std::filesystem::path m_path;
+};
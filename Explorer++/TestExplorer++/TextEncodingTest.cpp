@@ -0,0 +1,113 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "pch.h"
+#include "../Helper/TextEncoding.h"
+#include <gtest/gtest.h>
+
+namespace
+{
+
+std::span<const std::byte> AsBytes(std::string_view text)
+{
+	return std::as_bytes(std::span(text.data(), text.size()));
+}
+
+std::vector<std::byte> ToBytes(std::string_view text)
+{
+	auto bytes = AsBytes(text);
+	return { bytes.begin(), bytes.end() };
+}
+
+}
+
+TEST(TextEncodingTest, DetectByteOrderMarks)
+{
+	auto detected = DetectTextEncoding(AsBytes("\xEF\xBB\xBFtext"));
+	EXPECT_EQ(detected.encoding, TextEncoding::Utf8);
+	EXPECT_EQ(detected.bomSize, 3u);
+	EXPECT_FALSE(detected.isBinary);
+
+	detected = DetectTextEncoding(AsBytes(std::string_view("\xFF\xFEt\0e\0", 6)));
+	EXPECT_EQ(detected.encoding, TextEncoding::Utf16LE);
+	EXPECT_EQ(detected.bomSize, 2u);
+
+	detected = DetectTextEncoding(AsBytes(std::string_view("\xFE\xFF\0t\0e", 6)));
+	EXPECT_EQ(detected.encoding, TextEncoding::Utf16BE);
+	EXPECT_EQ(detected.bomSize, 2u);
+}
+
+TEST(TextEncodingTest, DetectUtf16WithoutByteOrderMark)
+{
+	auto littleEndian = EncodeText(L"plain text\r\nwith a second line", TextEncoding::Utf16LE);
+	auto detected = DetectTextEncoding(littleEndian);
+	EXPECT_EQ(detected.encoding, TextEncoding::Utf16LE);
+	EXPECT_EQ(detected.bomSize, 0u);
+	EXPECT_FALSE(detected.isBinary);
+
+	auto bigEndian = EncodeText(L"plain text\r\nwith a second line", TextEncoding::Utf16BE);
+	detected = DetectTextEncoding(bigEndian);
+	EXPECT_EQ(detected.encoding, TextEncoding::Utf16BE);
+	EXPECT_FALSE(detected.isBinary);
+}
+
+TEST(TextEncodingTest, DetectUtf8AndAnsi)
+{
+	EXPECT_EQ(DetectTextEncoding(AsBytes("ascii only\n")).encoding, TextEncoding::Utf8);
+	EXPECT_EQ(DetectTextEncoding(AsBytes("caf\xC3\xA9\n")).encoding, TextEncoding::Utf8);
+
+	// The sample can end in the middle of a character.
+	EXPECT_EQ(DetectTextEncoding(AsBytes("caf\xC3")).encoding, TextEncoding::Utf8);
+
+	auto detected = DetectTextEncoding(AsBytes("caf\xE9 au lait\n"));
+	EXPECT_EQ(detected.encoding, TextEncoding::Ansi);
+	EXPECT_FALSE(detected.isBinary);
+}
+
+TEST(TextEncodingTest, DetectBinary)
+{
+	std::string executable("MZ\x90\0\x03\0\0\0\x04\0\0\0\xFF\xFF\0\0\xB8\0\0\0\0\0\0\0", 24);
+	EXPECT_TRUE(DetectTextEncoding(AsBytes(executable)).isBinary);
+
+	std::string controlCharacters = "\x01\x02\x03\x04text\x05\x06\x07\x0E";
+	EXPECT_TRUE(DetectTextEncoding(AsBytes(controlCharacters)).isBinary);
+
+	EXPECT_FALSE(DetectTextEncoding({}).isBinary);
+}
+
+TEST(TextEncodingTest, DecodeInvalidUtf8)
+{
+	EXPECT_EQ(DecodeUtf8("a\xFF!"), L"a\xFFFD!");
+
+	// Overlong encoding.
+	EXPECT_EQ(DecodeUtf8("\xC0\xAF"), L"\xFFFD");
+
+	// Truncated sequence.
+	EXPECT_EQ(DecodeUtf8("x\xE2\x82"), L"x\xFFFD");
+}
+
+TEST(TextEncodingTest, DecodeUtf16)
+{
+	// U+1F600 is outside the BMP, so is encoded as a surrogate pair.
+	std::string littleEndian("h\0i\0\x3D\xD8\x00\xDE!", 9);
+	std::wstring decoded = DecodeText(AsBytes(littleEndian), TextEncoding::Utf16LE);
+	EXPECT_EQ(decoded, DecodeUtf8("hi\xF0\x9F\x98\x80"));
+
+	// An unpaired surrogate is replaced.
+	std::string bigEndian("\xD8\x3D\0!", 4);
+	EXPECT_EQ(DecodeText(AsBytes(bigEndian), TextEncoding::Utf16BE), L"\xFFFD!");
+}
+
+TEST(TextEncodingTest, EncodeRoundTrip)
+{
+	std::wstring text = DecodeUtf8("plain, caf\xC3\xA9, \xE4\xB8\x8A, \xF0\x9F\x98\x80");
+
+	for (auto encoding : { TextEncoding::Utf8, TextEncoding::Utf16LE, TextEncoding::Utf16BE })
+	{
+		EXPECT_EQ(DecodeText(EncodeText(text, encoding), encoding), text);
+	}
+
+	EXPECT_EQ(EncodeText(L"ascii", TextEncoding::Ansi), ToBytes("ascii"));
+	EXPECT_EQ(DecodeText(AsBytes("ascii"), TextEncoding::Ansi), L"ascii");
+}
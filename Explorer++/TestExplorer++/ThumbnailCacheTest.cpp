@@ -0,0 +1,168 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "pch.h"
+#include "../Helper/ThumbnailCache.h"
+#include <gtest/gtest.h>
+
+using namespace std::chrono_literals;
+
+namespace
+{
+
+PixelBuffer MakeImage(int width, int height)
+{
+	return PixelBuffer(width, height);
+}
+
+}
+
+class ThumbnailCacheTest : public testing::Test
+{
+protected:
+	ThumbnailCacheTest() : m_imageSize(MakeImage(10, 10).GetSizeInBytes())
+	{
+	}
+
+	const size_t m_imageSize;
+	const ThumbnailCache::Clock::time_point m_now = ThumbnailCache::Clock::now();
+};
+
+TEST_F(ThumbnailCacheTest, InsertAndFind)
+{
+	ThumbnailCache cache(m_imageSize * 4);
+
+	EXPECT_EQ(cache.Find(1), nullptr);
+
+	cache.Insert(1, 5, m_now, MakeImage(10, 10));
+
+	const auto *entry = cache.Find(1);
+	ASSERT_NE(entry, nullptr);
+	EXPECT_EQ(entry->id, 1);
+	EXPECT_EQ(entry->generation, 5u);
+	EXPECT_EQ(entry->captureTime, m_now);
+	EXPECT_EQ(entry->image.width, 10);
+	EXPECT_EQ(cache.GetSizeInBytes(), m_imageSize);
+}
+
+TEST_F(ThumbnailCacheTest, Replace)
+{
+	ThumbnailCache cache(m_imageSize * 4);
+
+	cache.Insert(1, 1, m_now, MakeImage(10, 10));
+	cache.Insert(1, 2, m_now, MakeImage(5, 5));
+
+	EXPECT_EQ(cache.GetNumEntries(), 1u);
+	EXPECT_EQ(cache.GetSizeInBytes(), MakeImage(5, 5).GetSizeInBytes());
+
+	const auto *entry = cache.Find(1);
+	ASSERT_NE(entry, nullptr);
+	EXPECT_EQ(entry->generation, 2u);
+	EXPECT_EQ(entry->image.width, 5);
+}
+
+TEST_F(ThumbnailCacheTest, Remove)
+{
+	ThumbnailCache cache(m_imageSize * 4);
+
+	cache.Insert(1, 1, m_now, MakeImage(10, 10));
+	cache.Remove(1);
+
+	EXPECT_EQ(cache.Find(1), nullptr);
+	EXPECT_EQ(cache.GetNumEntries(), 0u);
+	EXPECT_EQ(cache.GetSizeInBytes(), 0u);
+
+	// Removing an item that doesn't exist should have no effect.
+	cache.Remove(2);
+}
+
+TEST_F(ThumbnailCacheTest, LeastRecentlyUsedEvicted)
+{
+	ThumbnailCache cache(m_imageSize * 3);
+
+	cache.Insert(1, 1, m_now, MakeImage(10, 10));
+	cache.Insert(2, 1, m_now, MakeImage(10, 10));
+	cache.Insert(3, 1, m_now, MakeImage(10, 10));
+
+	// Accessing the first item makes the second item the least recently used.
+	EXPECT_NE(cache.Find(1), nullptr);
+
+	cache.Insert(4, 1, m_now, MakeImage(10, 10));
+
+	EXPECT_EQ(cache.GetNumEntries(), 3u);
+	EXPECT_LE(cache.GetSizeInBytes(), m_imageSize * 3);
+	EXPECT_NE(cache.Find(1), nullptr);
+	EXPECT_EQ(cache.Find(2), nullptr);
+	EXPECT_NE(cache.Find(3), nullptr);
+	EXPECT_NE(cache.Find(4), nullptr);
+}
+
+TEST_F(ThumbnailCacheTest, LargeImageEvictsSeveral)
+{
+	ThumbnailCache cache(m_imageSize * 3);
+
+	cache.Insert(1, 1, m_now, MakeImage(10, 10));
+	cache.Insert(2, 1, m_now, MakeImage(10, 10));
+	cache.Insert(3, 1, m_now, MakeImage(10, 30));
+
+	EXPECT_EQ(cache.Find(1), nullptr);
+	EXPECT_EQ(cache.Find(2), nullptr);
+	EXPECT_NE(cache.Find(3), nullptr);
+}
+
+TEST_F(ThumbnailCacheTest, ImageTooLarge)
+{
+	ThumbnailCache cache(m_imageSize);
+
+	cache.Insert(1, 1, m_now, MakeImage(10, 10));
+	cache.Insert(2, 1, m_now, MakeImage(100, 100));
+
+	EXPECT_EQ(cache.Find(2), nullptr);
+
+	// The existing item shouldn't have been affected.
+	EXPECT_NE(cache.Find(1), nullptr);
+}
+
+class ShouldRecaptureThumbnailTest : public testing::Test
+{
+protected:
+	ShouldRecaptureThumbnailTest() : m_cache(SIZE_MAX)
+	{
+		m_cache.Insert(1, 1, m_captureTime, MakeImage(1, 1));
+		m_entry = m_cache.Find(1);
+	}
+
+	static constexpr ThumbnailCapturePolicy POLICY = { 1s, 10s };
+
+	ThumbnailCache m_cache;
+	const ThumbnailCache::Entry *m_entry = nullptr;
+	const ThumbnailCache::Clock::time_point m_captureTime = ThumbnailCache::Clock::now();
+};
+
+TEST_F(ShouldRecaptureThumbnailTest, NoEntry)
+{
+	EXPECT_TRUE(ShouldRecaptureThumbnail(nullptr, 1, m_captureTime, POLICY));
+}
+
+TEST_F(ShouldRecaptureThumbnailTest, UpToDate)
+{
+	EXPECT_FALSE(ShouldRecaptureThumbnail(m_entry, 1, m_captureTime + 5s, POLICY));
+}
+
+TEST_F(ShouldRecaptureThumbnailTest, Stale)
+{
+	EXPECT_TRUE(ShouldRecaptureThumbnail(m_entry, 2, m_captureTime + 2s, POLICY));
+}
+
+TEST_F(ShouldRecaptureThumbnailTest, RateLimited)
+{
+	// Although the content has changed, the thumbnail was captured too recently to be captured
+	// again.
+	EXPECT_FALSE(ShouldRecaptureThumbnail(m_entry, 2, m_captureTime + 500ms, POLICY));
+}
+
+TEST_F(ShouldRecaptureThumbnailTest, Expired)
+{
+	EXPECT_TRUE(ShouldRecaptureThumbnail(m_entry, 1, m_captureTime + 10s, POLICY));
+}
@@ -0,0 +1,308 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "pch.h"
+#include "../Helper/Tracing.h"
+#include <gtest/gtest.h>
+#include <sstream>
+#include <thread>
+
+using namespace testing;
+
+namespace
+{
+
+std::vector<const char *> GetEventNames(const ThreadTraceEvents &threadEvents)
+{
+	std::vector<const char *> names;
+
+	for (const auto &event : threadEvents.events)
+	{
+		names.push_back(event.name);
+	}
+
+	return names;
+}
+
+std::vector<int64_t> GetEventValues(const ThreadTraceEvents &threadEvents)
+{
+	std::vector<int64_t> values;
+
+	for (const auto &event : threadEvents.events)
+	{
+		values.push_back(event.argValue);
+	}
+
+	return values;
+}
+
+}
+
+TEST(TracingTest, DisabledByDefault)
+{
+	TraceRecorder recorder;
+	EXPECT_FALSE(recorder.IsEnabled());
+
+	{
+		TraceScope scope("test", "scope", recorder);
+		EXPECT_FALSE(scope.IsRecording());
+	}
+
+	recorder.RecordCounter("test", "counter", 1);
+	recorder.RecordInstant("test", "instant");
+
+	EXPECT_THAT(recorder.GetEvents(), IsEmpty());
+}
+
+TEST(TracingTest, Scope)
+{
+	TraceRecorder recorder;
+	recorder.Start();
+
+	{
+		TraceScope scope("test", "scope", recorder);
+		EXPECT_TRUE(scope.IsRecording());
+		scope.SetArg("items", 42);
+
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+
+	recorder.Stop();
+
+	{
+		// Scopes that start once recording has stopped aren't recorded.
+		TraceScope scope("test", "ignored", recorder);
+	}
+
+	auto threadEvents = recorder.GetEvents();
+	ASSERT_EQ(threadEvents.size(), 1u);
+	ASSERT_EQ(threadEvents[0].events.size(), 1u);
+
+	const auto &event = threadEvents[0].events[0];
+	EXPECT_EQ(event.type, TraceEventType::Complete);
+	EXPECT_STREQ(event.category, "test");
+	EXPECT_STREQ(event.name, "scope");
+	EXPECT_STREQ(event.argName, "items");
+	EXPECT_EQ(event.argValue, 42);
+	EXPECT_GE(event.duration, 1'000'000u);
+}
+
+TEST(TracingTest, RingBufferKeepsMostRecentEvents)
+{
+	TraceRecorder recorder(4);
+	recorder.Start();
+
+	for (int i = 0; i < 10; i++)
+	{
+		recorder.RecordCounter("test", "counter", i);
+	}
+
+	auto threadEvents = recorder.GetEvents();
+	ASSERT_EQ(threadEvents.size(), 1u);
+	EXPECT_THAT(GetEventValues(threadEvents[0]), ElementsAre(6, 7, 8, 9));
+	EXPECT_EQ(recorder.GetNumDroppedEvents(), 6u);
+
+	// Starting a new recording discards the previous events.
+	recorder.Start();
+	recorder.RecordCounter("test", "counter", 10);
+
+	threadEvents = recorder.GetEvents();
+	ASSERT_EQ(threadEvents.size(), 1u);
+	EXPECT_THAT(GetEventValues(threadEvents[0]), ElementsAre(10));
+	EXPECT_EQ(recorder.GetNumDroppedEvents(), 0u);
+}
+
+TEST(TracingTest, PerThreadBuffers)
+{
+	TraceRecorder recorder;
+	recorder.SetCurrentThreadName("main");
+	recorder.Start();
+
+	recorder.RecordInstant("test", "main-event");
+
+	std::jthread thread(
+		[&recorder]
+		{
+			recorder.SetCurrentThreadName("worker");
+			TraceScope scope("test", "worker-event", recorder);
+		});
+	thread.join();
+
+	recorder.Stop();
+
+	// The worker thread has exited, but its events are kept.
+	auto threadEvents = recorder.GetEvents();
+	ASSERT_EQ(threadEvents.size(), 2u);
+	EXPECT_EQ(threadEvents[0].threadName, "main");
+	EXPECT_THAT(GetEventNames(threadEvents[0]), ElementsAre(StrEq("main-event")));
+	EXPECT_EQ(threadEvents[1].threadName, "worker");
+	EXPECT_THAT(GetEventNames(threadEvents[1]), ElementsAre(StrEq("worker-event")));
+	EXPECT_NE(threadEvents[0].threadId, threadEvents[1].threadId);
+
+	// Once a new recording starts, the buffer for the exited thread is discarded.
+	recorder.Start();
+	EXPECT_EQ(recorder.GetEvents().size(), 1u);
+	recorder.Stop();
+
+	// Buffers for threads that exit without recording anything are discarded when other threads
+	// start using the recorder.
+	std::jthread([&recorder] { recorder.SetCurrentThreadName("idle"); }).join();
+	EXPECT_EQ(recorder.GetEvents().size(), 2u);
+
+	std::jthread([&recorder] { recorder.SetCurrentThreadName("idle"); }).join();
+	EXPECT_EQ(recorder.GetEvents().size(), 2u);
+}
+
+TEST(TracingTest, FlowAndAsyncEvents)
+{
+	TraceRecorder recorder;
+	recorder.Start();
+
+	uint64_t id = recorder.NewId();
+	EXPECT_NE(recorder.NewId(), id);
+
+	recorder.RecordAsyncBegin("test", "operation", id);
+
+	{
+		TraceScope scope("test", "queue", recorder);
+		recorder.RecordFlow(TraceEventType::FlowBegin, "test", "task", id);
+	}
+
+	std::jthread thread(
+		[&recorder, id]
+		{
+			TraceScope scope("test", "run", recorder);
+			recorder.RecordFlow(TraceEventType::FlowEnd, "test", "task", id);
+		});
+	thread.join();
+
+	recorder.RecordAsyncEnd("test", "operation", id);
+
+	auto threadEvents = recorder.GetEvents();
+	ASSERT_EQ(threadEvents.size(), 2u);
+
+	ASSERT_EQ(threadEvents[0].events.size(), 4u);
+	EXPECT_EQ(threadEvents[0].events[0].type, TraceEventType::AsyncBegin);
+	EXPECT_EQ(threadEvents[0].events[1].type, TraceEventType::FlowBegin);
+	EXPECT_EQ(threadEvents[0].events[1].id, id);
+	EXPECT_EQ(threadEvents[0].events[2].type, TraceEventType::Complete);
+	EXPECT_EQ(threadEvents[0].events[3].type, TraceEventType::AsyncEnd);
+
+	ASSERT_EQ(threadEvents[1].events.size(), 2u);
+	EXPECT_EQ(threadEvents[1].events[0].type, TraceEventType::FlowEnd);
+	EXPECT_EQ(threadEvents[1].events[0].id, id);
+}
+
+TEST(TracingTest, ChromeTrace)
+{
+	TraceRecorder recorder;
+	recorder.SetCurrentThreadName("UI \"main\"");
+	recorder.Start();
+
+	{
+		TraceScope scope("navigation", "Enumerate", recorder);
+		scope.SetArg("items", 3);
+		recorder.RecordFlow(TraceEventType::FlowStep, "navigation", "Navigate", 255);
+	}
+
+	recorder.RecordCounter("icons", "Queued", 12);
+	recorder.Stop();
+
+	std::ostringstream stream;
+	recorder.WriteChromeTrace(stream);
+	std::string trace = stream.str();
+
+	EXPECT_THAT(trace, StartsWith("{\"traceEvents\":["));
+	EXPECT_THAT(trace,
+		HasSubstr("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1,"
+				  "\"args\":{\"name\":\"UI \\\"main\\\"\"}}"));
+	EXPECT_THAT(trace,
+		ContainsRegex("\\{\"name\":\"Enumerate\",\"cat\":\"navigation\",\"ph\":\"X\","
+					  "\"ts\":[0-9]+\\.[0-9][0-9][0-9],\"pid\":1,\"tid\":1,"
+					  "\"dur\":[0-9]+\\.[0-9][0-9][0-9],\"args\":\\{\"items\":3\\}\\}"));
+	EXPECT_THAT(trace,
+		ContainsRegex("\\{\"name\":\"Navigate\",\"cat\":\"navigation\",\"ph\":\"t\",\"ts\":[0-9.]+,"
+					  "\"pid\":1,\"tid\":1,\"id\":\"0xff\",\"bp\":\"e\"\\}"));
+	EXPECT_THAT(trace,
+		ContainsRegex("\\{\"name\":\"Queued\",\"cat\":\"icons\",\"ph\":\"C\",\"ts\":[0-9.]+,"
+					  "\"pid\":1,\"tid\":1,\"args\":\\{\"value\":12\\}\\}"));
+	EXPECT_THAT(trace, HasSubstr("\"otherData\":{\"droppedEvents\":0}"));
+}
+
+TEST(TracingTest, ChromeTraceIgnoresStreamLocale)
+{
+	class GroupingNumPunct : public std::numpunct<char>
+	{
+	protected:
+		char do_thousands_sep() const override
+		{
+			return ',';
+		}
+
+		std::string do_grouping() const override
+		{
+			return "\3";
+		}
+	};
+
+	TraceRecorder recorder;
+	recorder.Start();
+	recorder.RecordCounter("test", "counter", 1234567);
+	recorder.Stop();
+
+	std::ostringstream stream;
+	auto locale = std::locale(std::locale::classic(), new GroupingNumPunct);
+	stream.imbue(locale);
+	recorder.WriteChromeTrace(stream);
+
+	EXPECT_THAT(stream.str(), HasSubstr("\"args\":{\"value\":1234567}"));
+	EXPECT_EQ(stream.getloc(), locale);
+}
+
+// Measures the cost of a trace point, both while recording is disabled (which is the normal state)
+// and while it's enabled.
+TEST(TracingBenchmarkTest, DISABLED_Overhead)
+{
+	constexpr int NUM_ITERATIONS = 1'000'000;
+
+	TraceRecorder recorder;
+	volatile int sink = 0;
+
+	auto measure = [&recorder, &sink]()
+	{
+		auto start = std::chrono::steady_clock::now();
+
+		for (int i = 0; i < NUM_ITERATIONS; i++)
+		{
+			TraceScope scope("benchmark", "scope", recorder);
+			sink = sink + 1;
+		}
+
+		auto end = std::chrono::steady_clock::now();
+
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count()
+			/ static_cast<double>(NUM_ITERATIONS);
+	};
+
+	double disabledNs = measure();
+	EXPECT_THAT(recorder.GetEvents(), IsEmpty());
+
+	recorder.Start();
+	double enabledNs = measure();
+	recorder.Stop();
+
+	EXPECT_EQ(recorder.GetEvents()[0].events.size(), TraceRecorder::DEFAULT_EVENTS_PER_THREAD);
+	EXPECT_EQ(recorder.GetNumDroppedEvents(),
+		NUM_ITERATIONS - TraceRecorder::DEFAULT_EVENTS_PER_THREAD);
+
+	std::ostringstream stream;
+	auto exportStart = std::chrono::steady_clock::now();
+	recorder.WriteChromeTrace(stream);
+	auto exportEnd = std::chrono::steady_clock::now();
+
+	testing::Test::RecordProperty("DisabledScopeNs", std::to_string(disabledNs));
+	testing::Test::RecordProperty("EnabledScopeNs", std::to_string(enabledNs));
+	testing::Test::RecordProperty("ExportMs",
+		std::chrono::duration_cast<std::chrono::milliseconds>(exportEnd - exportStart).count());
+}
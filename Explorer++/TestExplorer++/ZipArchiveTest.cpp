@@ -0,0 +1,698 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "pch.h"
+#include "../Helper/ZipArchive.h"
+#include "TemporaryPathTestHelper.h"
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <zlib.h>
+#include <chrono>
+#include <ctime>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+using namespace testing;
+
+namespace
+{
+
+struct TestEntryOptions
+{
+	bool deflate = false;
+	uint16_t flags = 0;
+	uint16_t method = 0;
+	uint32_t dosDateTime = 0;
+	std::optional<int32_t> unixModifiedTime;
+
+	// Stores the sizes and offset in the ZIP64 extra field, even though they'd fit in the header.
+	bool zip64 = false;
+
+	bool corruptCrc = false;
+};
+
+// Writes archives in memory, so that the reader can be tested against archives with specific
+// properties (e.g. ZIP64 records), without having to check in binary test data.
+class TestZipWriter
+{
+public:
+	void AddFile(const std::string &name, const std::string &contents,
+		const TestEntryOptions &options = {})
+	{
+		auto contentBytes = std::as_bytes(std::span(contents.data(), contents.size()));
+		auto crc = static_cast<uint32_t>(crc32(0, reinterpret_cast<const Bytef *>(contents.data()),
+			static_cast<uInt>(contents.size())));
+
+		if (options.corruptCrc)
+		{
+			crc ^= 1;
+		}
+
+		std::vector<std::byte> data;
+		uint16_t method = options.method;
+
+		if (options.deflate)
+		{
+			data = Deflate(contentBytes);
+			method = 8;
+		}
+		else
+		{
+			data.assign(contentBytes.begin(), contentBytes.end());
+		}
+
+		AddEntry(name, data, contents.size(), crc, method, 0, options);
+	}
+
+	void AddFolder(const std::string &name)
+	{
+		AddEntry(name, {}, 0, 0, 0, 0x10, {});
+	}
+
+	// Data that appears before the archive, as in a self-extracting archive. This has to be called
+	// before any entries are added.
+	void AddPrefix(const std::string &prefix)
+	{
+		auto bytes = std::as_bytes(std::span(prefix.data(), prefix.size()));
+		m_prefix.assign(bytes.begin(), bytes.end());
+	}
+
+	std::vector<std::byte> Finish(bool forceZip64 = false)
+	{
+		// The entry count in the standard end record is limited to 16 bits.
+		bool zip64 = forceZip64 || m_numEntries >= UINT16_MAX;
+
+		std::vector<std::byte> archive = m_prefix;
+		archive.insert(archive.end(), m_data.begin(), m_data.end());
+
+		uint64_t directoryOffset = m_data.size();
+		archive.insert(archive.end(), m_centralDirectory.begin(), m_centralDirectory.end());
+
+		if (zip64)
+		{
+			uint64_t zip64RecordOffset = archive.size() - m_prefix.size();
+
+			WriteUInt32(archive, 0x06064b50);
+			WriteUInt64(archive, 44);
+			WriteUInt16(archive, 45);
+			WriteUInt16(archive, 45);
+			WriteUInt32(archive, 0);
+			WriteUInt32(archive, 0);
+			WriteUInt64(archive, m_numEntries);
+			WriteUInt64(archive, m_numEntries);
+			WriteUInt64(archive, m_centralDirectory.size());
+			WriteUInt64(archive, directoryOffset);
+
+			WriteUInt32(archive, 0x07064b50);
+			WriteUInt32(archive, 0);
+			WriteUInt64(archive, zip64RecordOffset);
+			WriteUInt32(archive, 1);
+		}
+
+		WriteUInt32(archive, 0x06054b50);
+		WriteUInt16(archive, 0);
+		WriteUInt16(archive, 0);
+		WriteUInt16(archive, zip64 ? 0xFFFF : static_cast<uint16_t>(m_numEntries));
+		WriteUInt16(archive, zip64 ? 0xFFFF : static_cast<uint16_t>(m_numEntries));
+		WriteUInt32(archive,
+			zip64 ? 0xFFFFFFFF : static_cast<uint32_t>(m_centralDirectory.size()));
+		WriteUInt32(archive, zip64 ? 0xFFFFFFFF : static_cast<uint32_t>(directoryOffset));
+
+		std::string comment = "test archive";
+		WriteUInt16(archive, static_cast<uint16_t>(comment.size()));
+		WriteString(archive, comment);
+
+		return archive;
+	}
+
+private:
+	static void WriteUInt16(std::vector<std::byte> &output, uint16_t value)
+	{
+		output.push_back(static_cast<std::byte>(value & 0xFF));
+		output.push_back(static_cast<std::byte>(value >> 8));
+	}
+
+	static void WriteUInt32(std::vector<std::byte> &output, uint32_t value)
+	{
+		WriteUInt16(output, static_cast<uint16_t>(value & 0xFFFF));
+		WriteUInt16(output, static_cast<uint16_t>(value >> 16));
+	}
+
+	static void WriteUInt64(std::vector<std::byte> &output, uint64_t value)
+	{
+		WriteUInt32(output, static_cast<uint32_t>(value & 0xFFFFFFFF));
+		WriteUInt32(output, static_cast<uint32_t>(value >> 32));
+	}
+
+	static void WriteString(std::vector<std::byte> &output, const std::string &value)
+	{
+		auto bytes = std::as_bytes(std::span(value.data(), value.size()));
+		output.insert(output.end(), bytes.begin(), bytes.end());
+	}
+
+	static std::vector<std::byte> Deflate(std::span<const std::byte> input)
+	{
+		z_stream stream = {};
+		deflateInit2(&stream, Z_BEST_SPEED, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY);
+
+		std::vector<std::byte> output(deflateBound(&stream, static_cast<uLong>(input.size())));
+		stream.next_in = reinterpret_cast<Bytef *>(const_cast<std::byte *>(input.data()));
+		stream.avail_in = static_cast<uInt>(input.size());
+		stream.next_out = reinterpret_cast<Bytef *>(output.data());
+		stream.avail_out = static_cast<uInt>(output.size());
+		deflate(&stream, Z_FINISH);
+		output.resize(stream.total_out);
+		deflateEnd(&stream);
+
+		return output;
+	}
+
+	void AddEntry(const std::string &name, const std::vector<std::byte> &data,
+		uint64_t uncompressedSize, uint32_t crc, uint16_t method, uint32_t externalAttributes,
+		const TestEntryOptions &options)
+	{
+		uint64_t localHeaderOffset = m_data.size();
+
+		std::vector<std::byte> extra;
+
+		if (options.zip64)
+		{
+			WriteUInt16(extra, 0x0001);
+			WriteUInt16(extra, 24);
+			WriteUInt64(extra, uncompressedSize);
+			WriteUInt64(extra, data.size());
+			WriteUInt64(extra, localHeaderOffset);
+		}
+
+		if (options.unixModifiedTime)
+		{
+			WriteUInt16(extra, 0x5455);
+			WriteUInt16(extra, 5);
+			extra.push_back(std::byte { 1 });
+			WriteUInt32(extra, static_cast<uint32_t>(*options.unixModifiedTime));
+		}
+
+		auto sizeField = [&options](uint64_t value)
+		{ return options.zip64 ? 0xFFFFFFFF : static_cast<uint32_t>(value); };
+
+		WriteUInt32(m_data, 0x04034b50);
+		WriteUInt16(m_data, 20);
+		WriteUInt16(m_data, options.flags);
+		WriteUInt16(m_data, method);
+		WriteUInt32(m_data, options.dosDateTime);
+		WriteUInt32(m_data, crc);
+		WriteUInt32(m_data, sizeField(data.size()));
+		WriteUInt32(m_data, sizeField(uncompressedSize));
+		WriteUInt16(m_data, static_cast<uint16_t>(name.size()));
+		WriteUInt16(m_data, 0);
+		WriteString(m_data, name);
+		m_data.insert(m_data.end(), data.begin(), data.end());
+
+		WriteUInt32(m_centralDirectory, 0x02014b50);
+		WriteUInt16(m_centralDirectory, 20);
+		WriteUInt16(m_centralDirectory, 20);
+		WriteUInt16(m_centralDirectory, options.flags);
+		WriteUInt16(m_centralDirectory, method);
+		WriteUInt32(m_centralDirectory, options.dosDateTime);
+		WriteUInt32(m_centralDirectory, crc);
+		WriteUInt32(m_centralDirectory, sizeField(data.size()));
+		WriteUInt32(m_centralDirectory, sizeField(uncompressedSize));
+		WriteUInt16(m_centralDirectory, static_cast<uint16_t>(name.size()));
+		WriteUInt16(m_centralDirectory, static_cast<uint16_t>(extra.size()));
+		WriteUInt16(m_centralDirectory, 0);
+		WriteUInt16(m_centralDirectory, 0);
+		WriteUInt16(m_centralDirectory, 0);
+		WriteUInt32(m_centralDirectory, externalAttributes);
+		WriteUInt32(m_centralDirectory, sizeField(localHeaderOffset));
+		WriteString(m_centralDirectory, name);
+		m_centralDirectory.insert(m_centralDirectory.end(), extra.begin(), extra.end());
+
+		m_numEntries++;
+	}
+
+	std::vector<std::byte> m_prefix;
+	std::vector<std::byte> m_data;
+	std::vector<std::byte> m_centralDirectory;
+	uint64_t m_numEntries = 0;
+};
+
+std::unique_ptr<ZipArchive> OpenArchive(std::vector<std::byte> data)
+{
+	return ZipArchive::Open(std::make_unique<ZipMemorySource>(std::move(data)));
+}
+
+std::vector<std::wstring> GetChildNames(const ZipArchive &archive, ZipArchive::EntryId folder)
+{
+	std::vector<std::wstring> names;
+
+	for (auto id : archive.GetChildren(folder))
+	{
+		names.push_back(archive.GetEntry(id).name);
+	}
+
+	return names;
+}
+
+std::pair<ZipExtractResult, std::string> ExtractToString(const ZipArchive &archive,
+	ZipArchive::EntryId id)
+{
+	std::string output;
+	auto result = archive.ExtractEntry(id,
+		[&output](std::span<const std::byte> data)
+		{
+			output.append(reinterpret_cast<const char *>(data.data()), data.size());
+			return true;
+		});
+
+	return { result, output };
+}
+
+std::string ReadFile(const std::filesystem::path &path)
+{
+	std::ifstream stream(path, std::ios::binary);
+	std::stringstream contents;
+	contents << stream.rdbuf();
+	return contents.str();
+}
+
+// Returns data that compresses reasonably well, but not so well that it fits in a single chunk.
+std::string MakeLargeContents(size_t size)
+{
+	std::string contents;
+	contents.reserve(size);
+
+	for (size_t i = 0; contents.size() < size; i++)
+	{
+		contents += std::format("line {} {}\n", i, (i * 2654435761u) % 1000003);
+	}
+
+	contents.resize(size);
+	return contents;
+}
+
+}
+
+TEST(ZipArchiveTest, EmptyArchive)
+{
+	TestZipWriter writer;
+	auto archive = OpenArchive(writer.Finish());
+	ASSERT_NE(archive, nullptr);
+
+	EXPECT_EQ(archive->GetNumEntries(), 1u);
+	EXPECT_TRUE(archive->GetEntry(ZipArchive::ROOT_ID).isFolder);
+	EXPECT_TRUE(archive->GetChildren(ZipArchive::ROOT_ID).empty());
+}
+
+TEST(ZipArchiveTest, InvalidData)
+{
+	EXPECT_EQ(OpenArchive({}), nullptr);
+
+	std::string text = "This is not an archive, although it's long enough to be one.";
+	auto bytes = std::as_bytes(std::span(text.data(), text.size()));
+	EXPECT_EQ(OpenArchive({ bytes.begin(), bytes.end() }), nullptr);
+
+	TestZipWriter writer;
+	writer.AddFile("file.txt", "contents");
+	auto data = writer.Finish();
+
+	// The central directory is no longer where the end record says it is.
+	auto truncated = data;
+	truncated.erase(truncated.begin(), truncated.begin() + 60);
+	EXPECT_EQ(OpenArchive(truncated), nullptr);
+
+	// The central directory header signature is corrupted.
+	auto corrupted = data;
+	corrupted[46] = std::byte { 0 };
+	EXPECT_EQ(OpenArchive(corrupted), nullptr);
+}
+
+TEST(ZipArchiveTest, Tree)
+{
+	TestZipWriter writer;
+	writer.AddFile("folder/subfolder/file1.txt", "1");
+	writer.AddFile("folder/file2.txt", "22");
+	writer.AddFile("file3.txt", "333");
+	writer.AddFolder("empty/");
+	writer.AddFolder("folder/");
+	auto archive = OpenArchive(writer.Finish());
+	ASSERT_NE(archive, nullptr);
+
+	// The root, 3 files and 3 folders ("subfolder" is only implied).
+	EXPECT_EQ(archive->GetNumEntries(), 7u);
+	EXPECT_THAT(GetChildNames(*archive, ZipArchive::ROOT_ID),
+		ElementsAre(L"empty", L"file3.txt", L"folder"));
+
+	auto folder = archive->FindEntry(L"folder");
+	ASSERT_TRUE(folder.has_value());
+	EXPECT_TRUE(archive->GetEntry(*folder).isFolder);
+	EXPECT_FALSE(archive->GetEntry(*folder).isImplied);
+	EXPECT_THAT(GetChildNames(*archive, *folder), ElementsAre(L"file2.txt", L"subfolder"));
+
+	auto subfolder = archive->FindEntry(L"folder/subfolder");
+	ASSERT_TRUE(subfolder.has_value());
+	EXPECT_TRUE(archive->GetEntry(*subfolder).isFolder);
+	EXPECT_TRUE(archive->GetEntry(*subfolder).isImplied);
+
+	auto file = archive->FindEntry(L"folder\\subfolder\\file1.txt");
+	ASSERT_TRUE(file.has_value());
+	EXPECT_EQ(archive->GetEntry(*file).parent, *subfolder);
+	EXPECT_EQ(archive->GetEntryPath(*file), L"folder/subfolder/file1.txt");
+	EXPECT_EQ(archive->FindEntry(L""), ZipArchive::ROOT_ID);
+	EXPECT_EQ(archive->FindEntry(L"folder/missing.txt"), std::nullopt);
+	EXPECT_EQ(archive->FindEntry(L"file3.txt/child"), std::nullopt);
+}
+
+TEST(ZipArchiveTest, Extract)
+{
+	auto largeContents = MakeLargeContents(3 * 1024 * 1024);
+
+	TestZipWriter writer;
+	writer.AddFile("stored.txt", "stored contents");
+	writer.AddFile("deflated.txt", "deflated contents deflated contents", { .deflate = true });
+	writer.AddFile("large.txt", largeContents, { .deflate = true });
+	writer.AddFile("large-stored.txt", largeContents);
+	writer.AddFile("empty.txt", "");
+	writer.AddFolder("folder/");
+	auto archive = OpenArchive(writer.Finish());
+	ASSERT_NE(archive, nullptr);
+
+	EXPECT_EQ(ExtractToString(*archive, *archive->FindEntry(L"stored.txt")),
+		std::pair(ZipExtractResult::Success, std::string("stored contents")));
+	EXPECT_EQ(ExtractToString(*archive, *archive->FindEntry(L"deflated.txt")),
+		std::pair(ZipExtractResult::Success,
+			std::string("deflated contents deflated contents")));
+	EXPECT_EQ(ExtractToString(*archive, *archive->FindEntry(L"large.txt")),
+		std::pair(ZipExtractResult::Success, largeContents));
+	EXPECT_EQ(ExtractToString(*archive, *archive->FindEntry(L"large-stored.txt")),
+		std::pair(ZipExtractResult::Success, largeContents));
+	EXPECT_EQ(ExtractToString(*archive, *archive->FindEntry(L"empty.txt")),
+		std::pair(ZipExtractResult::Success, std::string()));
+	EXPECT_EQ(ExtractToString(*archive, *archive->FindEntry(L"folder")).first,
+		ZipExtractResult::Folder);
+
+	const auto &largeEntry = archive->GetEntry(*archive->FindEntry(L"large.txt"));
+	EXPECT_EQ(largeEntry.uncompressedSize, largeContents.size());
+	EXPECT_LT(largeEntry.compressedSize, largeEntry.uncompressedSize);
+	EXPECT_EQ(largeEntry.compressionMethod, 8);
+}
+
+TEST(ZipArchiveTest, Zip64)
+{
+	TestZipWriter writer;
+	writer.AddFile("first.txt", "first", { .zip64 = true });
+	writer.AddFile("folder/second.txt", "second second second", { .deflate = true, .zip64 = true });
+	auto archive = OpenArchive(writer.Finish(true));
+	ASSERT_NE(archive, nullptr);
+
+	EXPECT_THAT(GetChildNames(*archive, ZipArchive::ROOT_ID), ElementsAre(L"first.txt", L"folder"));
+
+	auto second = archive->FindEntry(L"folder/second.txt");
+	ASSERT_TRUE(second.has_value());
+	EXPECT_EQ(archive->GetEntry(*second).uncompressedSize, 20u);
+	EXPECT_EQ(ExtractToString(*archive, *second),
+		std::pair(ZipExtractResult::Success, std::string("second second second")));
+	EXPECT_EQ(ExtractToString(*archive, *archive->FindEntry(L"first.txt")),
+		std::pair(ZipExtractResult::Success, std::string("first")));
+}
+
+TEST(ZipArchiveTest, PrependedData)
+{
+	TestZipWriter writer;
+	writer.AddPrefix(std::string(1000, 'x'));
+	writer.AddFile("file.txt", "contents");
+	auto archive = OpenArchive(writer.Finish());
+	ASSERT_NE(archive, nullptr);
+
+	EXPECT_EQ(ExtractToString(*archive, *archive->FindEntry(L"file.txt")),
+		std::pair(ZipExtractResult::Success, std::string("contents")));
+}
+
+TEST(ZipArchiveTest, ExtractFailures)
+{
+	TestZipWriter writer;
+	writer.AddFile("crc.txt", "contents", { .corruptCrc = true });
+	writer.AddFile("deflated-crc.txt", "contents", { .deflate = true, .corruptCrc = true });
+	writer.AddFile("encrypted.txt", "contents", { .flags = 1 });
+	writer.AddFile("bzip2.txt", "contents", { .method = 12 });
+	auto archive = OpenArchive(writer.Finish());
+	ASSERT_NE(archive, nullptr);
+
+	EXPECT_EQ(ExtractToString(*archive, *archive->FindEntry(L"crc.txt")).first,
+		ZipExtractResult::CorruptData);
+	EXPECT_EQ(ExtractToString(*archive, *archive->FindEntry(L"deflated-crc.txt")).first,
+		ZipExtractResult::CorruptData);
+	EXPECT_EQ(ExtractToString(*archive, *archive->FindEntry(L"encrypted.txt")).first,
+		ZipExtractResult::Encrypted);
+	EXPECT_EQ(ExtractToString(*archive, *archive->FindEntry(L"bzip2.txt")).first,
+		ZipExtractResult::UnsupportedMethod);
+	EXPECT_TRUE(archive->GetEntry(*archive->FindEntry(L"encrypted.txt")).isEncrypted);
+
+	auto result = archive->ExtractEntry(*archive->FindEntry(L"deflated-crc.txt"),
+		[](std::span<const std::byte>) { return false; });
+	EXPECT_EQ(result, ZipExtractResult::WriteError);
+
+	std::stop_source stopSource;
+	stopSource.request_stop();
+	result = archive->ExtractEntry(*archive->FindEntry(L"crc.txt"),
+		[](std::span<const std::byte>) { return true; }, stopSource.get_token());
+	EXPECT_EQ(result, ZipExtractResult::Stopped);
+}
+
+TEST(ZipArchiveTest, UnsafePaths)
+{
+	TestZipWriter writer;
+	writer.AddFile("../outside.txt", "1");
+	writer.AddFile("folder/../../outside.txt", "2");
+	writer.AddFile("/absolute.txt", "3");
+	writer.AddFile("C:/drive.txt", "4");
+	writer.AddFile("folder\\.\\inside.txt", "5");
+	auto archive = OpenArchive(writer.Finish());
+	ASSERT_NE(archive, nullptr);
+
+	EXPECT_THAT(GetChildNames(*archive, ZipArchive::ROOT_ID), ElementsAre(L"folder"));
+	EXPECT_THAT(GetChildNames(*archive, *archive->FindEntry(L"folder")),
+		ElementsAre(L"inside.txt"));
+}
+
+TEST(ZipArchiveTest, DuplicatePaths)
+{
+	TestZipWriter writer;
+	writer.AddFile("file.txt", "old");
+	writer.AddFile("file.txt", "new");
+	writer.AddFile("conflict", "file");
+	writer.AddFile("conflict/child.txt", "child");
+	auto archive = OpenArchive(writer.Finish());
+	ASSERT_NE(archive, nullptr);
+
+	EXPECT_THAT(GetChildNames(*archive, ZipArchive::ROOT_ID),
+		ElementsAre(L"conflict", L"file.txt"));
+	EXPECT_EQ(ExtractToString(*archive, *archive->FindEntry(L"file.txt")).second, "new");
+	EXPECT_TRUE(archive->GetEntry(*archive->FindEntry(L"conflict")).isFolder);
+	EXPECT_THAT(GetChildNames(*archive, *archive->FindEntry(L"conflict")),
+		ElementsAre(L"child.txt"));
+}
+
+TEST(ZipArchiveTest, NameEncodings)
+{
+	TestZipWriter writer;
+	writer.AddFile("caf\xC3\xA9.txt", "utf-8", { .flags = 0x800 });
+	writer.AddFile("caf\x82 (cp437).txt", "cp437");
+	writer.AddFile("\xF0\x9F\x98\x80.txt", "emoji", { .flags = 0x800 });
+	writer.AddFile("bad\xFF.txt", "invalid", { .flags = 0x800 });
+	auto archive = OpenArchive(writer.Finish());
+	ASSERT_NE(archive, nullptr);
+
+	std::wstring emojiName = sizeof(wchar_t) == 2 ? L"\xD83D\xDE00.txt" : L"\U0001F600.txt";
+
+	EXPECT_THAT(GetChildNames(*archive, ZipArchive::ROOT_ID),
+		UnorderedElementsAre(L"caf\x00E9.txt", L"caf\x00E9 (cp437).txt", emojiName,
+			L"bad\xFFFD.txt"));
+}
+
+TEST(ZipArchiveTest, ModifiedTime)
+{
+	// 2021-06-15 13:45:30, in local time.
+	uint32_t dosDateTime = ((((2021 - 1980) << 9) | (6 << 5) | 15) << 16)
+		| ((13 << 11) | (45 << 5) | (30 / 2));
+
+	TestZipWriter writer;
+	writer.AddFile("dos.txt", "", { .dosDateTime = dosDateTime });
+	writer.AddFile("utc.txt", "", { .dosDateTime = dosDateTime, .unixModifiedTime = 1600000000 });
+	auto archive = OpenArchive(writer.Finish());
+	ASSERT_NE(archive, nullptr);
+
+	const auto &utcEntry = archive->GetEntry(*archive->FindEntry(L"utc.txt"));
+	EXPECT_EQ(GetZipEntryModifiedTime(utcEntry).time_since_epoch().count(), 1600000000);
+
+	const auto &dosEntry = archive->GetEntry(*archive->FindEntry(L"dos.txt"));
+	EXPECT_EQ(dosEntry.dosDateTime, dosDateTime);
+	EXPECT_FALSE(dosEntry.utcModifiedTime.has_value());
+
+	std::time_t unixTime = GetZipEntryModifiedTime(dosEntry).time_since_epoch().count();
+	std::tm localTime = *std::localtime(&unixTime);
+	EXPECT_EQ(localTime.tm_year + 1900, 2021);
+	EXPECT_EQ(localTime.tm_mon + 1, 6);
+	EXPECT_EQ(localTime.tm_mday, 15);
+	EXPECT_EQ(localTime.tm_hour, 13);
+	EXPECT_EQ(localTime.tm_min, 45);
+	EXPECT_EQ(localTime.tm_sec, 30);
+}
+
+TEST(ZipArchiveTest, ExtractToFolder)
+{
+	TemporaryTestFolder tempFolder("ZipArchiveTest");
+	const auto &root = tempFolder.GetPath();
+
+	TestZipWriter writer;
+	writer.AddFile("folder/subfolder/file1.txt", "file 1", { .deflate = true });
+	writer.AddFile("folder/file2.txt", "file 2");
+	writer.AddFolder("folder/empty/");
+	writer.AddFile("file3.txt", "file 3");
+	writer.AddFile("bad.txt", "bad", { .corruptCrc = true });
+	auto data = writer.Finish();
+
+	auto archivePath = root / "archive.zip";
+	std::ofstream(archivePath, std::ios::binary)
+		.write(reinterpret_cast<const char *>(data.data()), data.size());
+
+	auto source = ZipFileSource::Open(archivePath);
+	ASSERT_NE(source, nullptr);
+	auto archive = ZipArchive::Open(std::move(source));
+	ASSERT_NE(archive, nullptr);
+
+	std::atomic<int> numCallbacks = 0;
+	auto destination = root / "output";
+	auto summary = ExtractZipEntries(*archive,
+		{ *archive->FindEntry(L"folder"), *archive->FindEntry(L"file3.txt"),
+			*archive->FindEntry(L"bad.txt") },
+		destination, 4, {},
+		[&numCallbacks](const std::filesystem::path &, const ZipEntry &) { numCallbacks++; });
+
+	EXPECT_EQ(summary.numFilesExtracted, 3u);
+	EXPECT_EQ(summary.numBytesExtracted, 18u);
+	EXPECT_FALSE(summary.stopped);
+	EXPECT_EQ(numCallbacks, 3);
+	ASSERT_EQ(summary.failures.size(), 1u);
+	EXPECT_EQ(summary.failures[0].first, *archive->FindEntry(L"bad.txt"));
+	EXPECT_EQ(summary.failures[0].second, ZipExtractResult::CorruptData);
+
+	EXPECT_EQ(ReadFile(destination / "folder" / "subfolder" / "file1.txt"), "file 1");
+	EXPECT_EQ(ReadFile(destination / "folder" / "file2.txt"), "file 2");
+	EXPECT_EQ(ReadFile(destination / "file3.txt"), "file 3");
+	EXPECT_TRUE(std::filesystem::is_directory(destination / "folder" / "empty"));
+	EXPECT_FALSE(std::filesystem::exists(destination / "bad.txt"));
+
+	// Extracting the root extracts everything directly into the destination.
+	auto rootDestination = root / "root";
+	summary = ExtractZipEntries(*archive, { ZipArchive::ROOT_ID }, rootDestination, 2, {});
+	EXPECT_EQ(summary.numFilesExtracted, 3u);
+	EXPECT_EQ(ReadFile(rootDestination / "folder" / "file2.txt"), "file 2");
+
+}
+
+// Builds an archive with 500,000 entries and measures the time taken to open it, enumerate every
+// folder and extract a selection of entries in parallel. The times are recorded as test properties.
+TEST(ZipArchiveBenchmarkTest, DISABLED_FiveHundredThousandEntries)
+{
+	constexpr int NUM_FOLDERS = 1000;
+	constexpr int NUM_FILES_PER_FOLDER = 500;
+	constexpr int NUM_FOLDERS_TO_EXTRACT = 20;
+
+	TemporaryTestFolder tempFolder("ZipArchiveTest");
+	const auto &root = tempFolder.GetPath();
+
+	{
+		TestZipWriter writer;
+
+		for (int i = 0; i < NUM_FOLDERS; i++)
+		{
+			for (int j = 0; j < NUM_FILES_PER_FOLDER; j++)
+			{
+				// Every tenth file is deflated, which keeps the time taken to generate the archive
+				// down, while still exercising both methods.
+				writer.AddFile(std::format("project {}/module {}/file {}.txt", i / 10, i % 10, j),
+					std::format("contents of file {} in folder {}\n", j, i),
+					{ .deflate = (j % 10 == 0) });
+			}
+		}
+
+		auto data = writer.Finish();
+		std::ofstream(root / "archive.zip", std::ios::binary)
+			.write(reinterpret_cast<const char *>(data.data()), data.size());
+	}
+
+	auto start = std::chrono::steady_clock::now();
+
+	auto source = ZipFileSource::Open(root / "archive.zip");
+	ASSERT_NE(source, nullptr);
+	auto archive = ZipArchive::Open(std::move(source));
+	ASSERT_NE(archive, nullptr);
+
+	auto opened = std::chrono::steady_clock::now();
+
+	size_t numFiles = 0;
+	std::vector<ZipArchive::EntryId> pendingFolders = { ZipArchive::ROOT_ID };
+
+	while (!pendingFolders.empty())
+	{
+		auto folder = pendingFolders.back();
+		pendingFolders.pop_back();
+
+		for (auto child : archive->GetChildren(folder))
+		{
+			if (archive->GetEntry(child).isFolder)
+			{
+				pendingFolders.push_back(child);
+			}
+			else
+			{
+				numFiles++;
+			}
+		}
+	}
+
+	auto enumerated = std::chrono::steady_clock::now();
+
+	EXPECT_EQ(numFiles, static_cast<size_t>(NUM_FOLDERS * NUM_FILES_PER_FOLDER));
+
+	auto lookupStart = std::chrono::steady_clock::now();
+	auto entry = archive->FindEntry(L"project 57/module 3/file 499.txt");
+	auto lookupEnd = std::chrono::steady_clock::now();
+	ASSERT_TRUE(entry.has_value());
+
+	std::vector<ZipArchive::EntryId> selection;
+
+	for (int i = 0; i < NUM_FOLDERS_TO_EXTRACT; i++)
+	{
+		selection.push_back(
+			*archive->FindEntry(std::format(L"project {}/module {}", i / 10, i % 10)));
+	}
+
+	auto extractStart = std::chrono::steady_clock::now();
+	auto summary = ExtractZipEntries(*archive, selection, root / "output",
+		std::max(static_cast<int>(std::thread::hardware_concurrency()), 1), {});
+	auto extractEnd = std::chrono::steady_clock::now();
+
+	EXPECT_EQ(summary.numFilesExtracted,
+		static_cast<size_t>(NUM_FOLDERS_TO_EXTRACT * NUM_FILES_PER_FOLDER));
+	EXPECT_TRUE(summary.failures.empty());
+
+	auto toMilliseconds = [](auto duration)
+	{
+		return static_cast<int>(
+			std::chrono::duration_cast<std::chrono::milliseconds>(duration).count());
+	};
+
+	testing::Test::RecordProperty("OpenMs", toMilliseconds(opened - start));
+	testing::Test::RecordProperty("EnumerateMs", toMilliseconds(enumerated - opened));
+	testing::Test::RecordProperty("LookupUs",
+		static_cast<int>(
+			std::chrono::duration_cast<std::chrono::microseconds>(lookupEnd - lookupStart)
+				.count()));
+	testing::Test::RecordProperty("ExtractMs", toMilliseconds(extractEnd - extractStart));
+
+}